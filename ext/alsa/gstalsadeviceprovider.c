@@ -41,30 +41,82 @@ static GstStaticCaps alsa_caps = GST_STATIC_CAPS ("audio/x-raw, "
     "rate = (int) [ 1, MAX ], " "channels = (int) [ 1, MAX ]; "
     PASSTHROUGH_CAPS);
 
+/* Opening the PCM and probing its formats is the slow part of the
+ * enumeration, so the caps are kept per card identity. The card index is not
+ * part of the key as it can change when cards are plugged in or removed */
+static GstCaps *
+probe_device_caps (GstAlsaDeviceProvider * self, snd_ctl_card_info_t * card_info,
+    const gchar * device_name, snd_pcm_stream_t stream, gint dev)
+{
+  GstCaps *caps = NULL, *template;
+  snd_pcm_t *handle;
+  gchar *key;
+
+  key = g_strdup_printf ("%s/%s/%s/%d/%d",
+      snd_ctl_card_info_get_id (card_info),
+      snd_ctl_card_info_get_driver (card_info),
+      snd_ctl_card_info_get_components (card_info), dev, stream);
+
+  g_mutex_lock (&self->caps_lock);
+  if ((caps = g_hash_table_lookup (self->caps_cache, key)))
+    gst_caps_ref (caps);
+  g_mutex_unlock (&self->caps_lock);
+
+  if (caps) {
+    GST_DEBUG_OBJECT (self, "using cached caps for %s (%s)", device_name, key);
+    g_free (key);
+    return caps;
+  }
+
+  if (snd_pcm_open (&handle, device_name, stream, SND_PCM_NONBLOCK) < 0) {
+    GST_ERROR_OBJECT (self, "Could not open device %s for inspection!",
+        device_name);
+    g_free (key);
+    return NULL;
+  }
+
+  template = gst_static_caps_get (&alsa_caps);
+  caps = gst_alsa_probe_supported_formats (GST_OBJECT (self),
+      device_name, handle, template);
+  gst_caps_unref (template);
+
+  snd_pcm_close (handle);
+
+  if (caps) {
+    g_mutex_lock (&self->caps_lock);
+    g_hash_table_insert (self->caps_cache, key, gst_caps_ref (caps));
+    g_mutex_unlock (&self->caps_lock);
+  } else {
+    g_free (key);
+  }
+
+  return caps;
+}
+
 static GstDevice *
 add_device (GstDeviceProvider * provider, snd_ctl_t * info,
     snd_pcm_stream_t stream, gint card, gint dev)
 {
-  GstCaps *caps, *template;
+  GstCaps *caps;
   GstDevice *device;
-  snd_pcm_t *handle;
   snd_ctl_card_info_t *card_info;
   GstStructure *props;
   gchar *card_name, *longname = NULL;
   gchar *device_name = g_strdup_printf ("hw:%d,%d", card, dev);
 
-  if (snd_pcm_open (&handle, device_name, stream, SND_PCM_NONBLOCK) < 0) {
-    GST_ERROR_OBJECT (provider, "Could not open device %s for inspection!",
-        device_name);
+  snd_ctl_card_info_alloca (&card_info);
+  if (snd_ctl_card_info (info, card_info) < 0) {
+    GST_ERROR_OBJECT (provider, "Could not get card info of %s", device_name);
     g_free (device_name);
-
     return NULL;
   }
 
-  template = gst_static_caps_get (&alsa_caps);
-  caps = gst_alsa_probe_supported_formats (GST_OBJECT (provider),
-      device_name, handle, template);
-  gst_caps_unref (template);
+  caps = probe_device_caps (GST_ALSA_DEVICE_PROVIDER (provider), card_info,
+      device_name, stream, dev);
+  if (caps == NULL) {
+    g_free (device_name);
+    return NULL;
+  }
 
   snd_card_get_name (card, &card_name);
   props = gst_structure_new ("alsa-proplist",
@@ -74,23 +126,18 @@ add_device (GstDeviceProvider * provider, snd_ctl_t * info,
       "alsa.card_name", G_TYPE_STRING, card_name, NULL);
   g_free (card_name);
 
-  snd_ctl_card_info_alloca (&card_info);
-  if (snd_ctl_card_info (info, card_info) == 0) {
-    gst_structure_set (props,
-        "alsa.driver_name", G_TYPE_STRING,
-        snd_ctl_card_info_get_driver (card_info), "alsa.name", G_TYPE_STRING,
-        snd_ctl_card_info_get_name (card_info), "alsa.id", G_TYPE_STRING,
-        snd_ctl_card_info_get_id (card_info), "alsa.mixername", G_TYPE_STRING,
-        snd_ctl_card_info_get_mixername (card_info), "alsa.components",
-        G_TYPE_STRING, snd_ctl_card_info_get_components (card_info), NULL);
-
-    snd_ctl_card_info_clear (card_info);
-  }
+  gst_structure_set (props,
+      "alsa.driver_name", G_TYPE_STRING,
+      snd_ctl_card_info_get_driver (card_info), "alsa.name", G_TYPE_STRING,
+      snd_ctl_card_info_get_name (card_info), "alsa.id", G_TYPE_STRING,
+      snd_ctl_card_info_get_id (card_info), "alsa.mixername", G_TYPE_STRING,
+      snd_ctl_card_info_get_mixername (card_info), "alsa.components",
+      G_TYPE_STRING, snd_ctl_card_info_get_components (card_info), NULL);
 
   snd_card_get_longname (card, &longname);
   device = gst_alsa_device_new (longname, caps, device_name, stream, props);
-
-  snd_pcm_close (handle);
+  g_free (device_name);
+  g_free (longname);
 
   gst_device_provider_device_add (provider, gst_object_ref (device));
 
@@ -100,6 +147,7 @@ add_device (GstDeviceProvider * provider, snd_ctl_t * info,
 static GList *
 gst_alsa_device_provider_probe (GstDeviceProvider * provider)
 {
+  GstAlsaDeviceProvider *self = GST_ALSA_DEVICE_PROVIDER (provider);
   snd_ctl_t *handle;
   int card, dev;
   snd_ctl_card_info_t *info;
@@ -126,6 +174,9 @@ gst_alsa_device_provider_probe (GstDeviceProvider * provider)
     while (card >= 0) {
       gchar name[32];
 
+      if (g_atomic_int_get (&self->probe_cancelled))
+        goto beach;
+
       g_snprintf (name, sizeof (name), "hw:%d", card);
       if (snd_ctl_open (&handle, name, 0) < 0)
         goto next_card;
@@ -169,12 +220,35 @@ beach:
 }
 
 
-static gboolean
-gst_alsa_device_provider_start (GstDeviceProvider * provider)
+static gpointer
+gst_alsa_device_provider_probe_thread (GstDeviceProvider * provider)
 {
+  /* the devices are added to the provider as they are found */
   g_list_free_full (gst_alsa_device_provider_probe (provider),
       gst_object_unref);
 
+  GST_INFO_OBJECT (provider, "done probing alsa devices");
+
+  return NULL;
+}
+
+static gboolean
+gst_alsa_device_provider_start (GstDeviceProvider * provider)
+{
+  GstAlsaDeviceProvider *self = GST_ALSA_DEVICE_PROVIDER (provider);
+  GError *err = NULL;
+
+  /* probing all cards can take a while, don't block the caller for it */
+  self->probe_thread = g_thread_try_new ("alsa-device-probe",
+      (GThreadFunc) gst_alsa_device_provider_probe_thread, provider, &err);
+
+  if (self->probe_thread == NULL) {
+    GST_WARNING_OBJECT (self, "could not start probe thread: %s",
+        err->message);
+    g_clear_error (&err);
+    gst_alsa_device_provider_probe_thread (provider);
+  }
+
   /* TODO - Implement monitoring support */
 
   return TRUE;
@@ -183,7 +257,25 @@ gst_alsa_device_provider_start (GstDeviceProvider * provider)
 static void
 gst_alsa_device_provider_stop (GstDeviceProvider * provider)
 {
-  return;
+  GstAlsaDeviceProvider *self = GST_ALSA_DEVICE_PROVIDER (provider);
+
+  if (self->probe_thread) {
+    g_atomic_int_set (&self->probe_cancelled, TRUE);
+    g_thread_join (self->probe_thread);
+    self->probe_thread = NULL;
+    g_atomic_int_set (&self->probe_cancelled, FALSE);
+  }
+}
+
+static void
+gst_alsa_device_provider_finalize (GObject * object)
+{
+  GstAlsaDeviceProvider *self = GST_ALSA_DEVICE_PROVIDER (object);
+
+  g_hash_table_unref (self->caps_cache);
+  g_mutex_clear (&self->caps_lock);
+
+  G_OBJECT_CLASS (gst_alsa_device_provider_parent_class)->finalize (object);
 }
 
 enum
@@ -197,6 +289,9 @@ static void
 gst_alsa_device_provider_class_init (GstAlsaDeviceProviderClass * klass)
 {
   GstDeviceProviderClass *dm_class = GST_DEVICE_PROVIDER_CLASS (klass);
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gst_alsa_device_provider_finalize;
 
   dm_class->probe = gst_alsa_device_provider_probe;
   dm_class->start = gst_alsa_device_provider_start;
@@ -211,6 +306,9 @@ gst_alsa_device_provider_class_init (GstAlsaDeviceProviderClass * klass)
 static void
 gst_alsa_device_provider_init (GstAlsaDeviceProvider * self)
 {
+  g_mutex_init (&self->caps_lock);
+  self->caps_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify) gst_caps_unref);
 }
 
 /*** GstAlsaDevice implementation ******/
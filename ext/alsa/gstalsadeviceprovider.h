@@ -45,6 +45,14 @@ typedef struct _GstAlsaDeviceProviderClass GstAlsaDeviceProviderClass;
 
 struct _GstAlsaDeviceProvider {
   GstDeviceProvider         parent;
+
+  /* probed caps of the devices, keyed by card identity, device and stream */
+  GMutex                    caps_lock;
+  GHashTable               *caps_cache;
+
+  /* enumeration thread started by start() */
+  GThread                  *probe_thread;
+  volatile gint             probe_cancelled;
 };
 
 struct _GstAlsaDeviceProviderClass {
@@ -36,6 +36,11 @@
  *  This pipeline will listen for events from the sequencer device at port 129:0,
  * and generate notes using the fluiddec element.
  *
+ * Events are timestamped with the time the sequencer received them. By
+ * default every event is output in its own buffer. For dense controller
+ * streams, #GstAlsaMidiSrc:aggregate-time can be set to put the events
+ * received within that time of each other into one buffer.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -293,11 +298,13 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS ("audio/x-midi-event"));
 
 #define DEFAULT_PORTS           NULL
+#define DEFAULT_AGGREGATE_TIME  0
 
 enum
 {
   PROP_0,
   PROP_PORTS,
+  PROP_AGGREGATE_TIME,
   PROP_LAST,
 };
 
@@ -343,6 +350,22 @@ gst_alsa_midi_src_class_init (GstAlsaMidiSrcClass * klass)
           "Comma separated list of sequencer ports (e.g. client:port,...)",
           DEFAULT_PORTS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAlsaMidiSrc:aggregate-time:
+   *
+   * Events that are available at the same time and are at most this far
+   * apart from the first event of a buffer are added to that buffer, instead
+   * of each being output in its own buffer. The buffer has the timestamp of
+   * its first event and lasts until its last one.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_AGGREGATE_TIME,
+      g_param_spec_uint64 ("aggregate-time", "Aggregate time",
+          "Maximum time between the first and last event put in one buffer "
+          "(0 = one buffer per event)", 0, G_MAXUINT64,
+          DEFAULT_AGGREGATE_TIME, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "AlsaMidi Source",
       "Source",
@@ -363,6 +386,7 @@ static void
 gst_alsa_midi_src_init (GstAlsaMidiSrc * alsamidisrc)
 {
   alsamidisrc->ports = DEFAULT_PORTS;
+  alsamidisrc->aggregate_time = DEFAULT_AGGREGATE_TIME;
 
   gst_base_src_set_format (GST_BASE_SRC (alsamidisrc), GST_FORMAT_TIME);
   gst_base_src_set_live (GST_BASE_SRC (alsamidisrc), TRUE);
@@ -381,6 +405,11 @@ gst_alsa_midi_src_set_property (GObject * object, guint prop_id,
       g_free (src->ports);
       src->ports = g_value_dup_string (value);
       break;
+    case PROP_AGGREGATE_TIME:
+      GST_OBJECT_LOCK (src);
+      src->aggregate_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -401,6 +430,11 @@ gst_alsa_midi_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_PORTS:
       g_value_set_string (value, src->ports);
       break;
+    case PROP_AGGREGATE_TIME:
+      GST_OBJECT_LOCK (src);
+      g_value_set_uint64 (value, src->aggregate_time);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -413,19 +447,41 @@ push_buffer (GstAlsaMidiSrc * alsamidisrc, gpointer data, guint size,
 {
   gpointer local_data;
   GstBuffer *buffer;
+  GstMemory *mem;
+  GstClockTime aggregate_time;
+  guint len;
+
+  local_data = g_memdup (data, size);
+  mem = gst_memory_new_wrapped (0, local_data, size, 0, size, local_data,
+      g_free);
+
+  GST_MEMDUMP_OBJECT (alsamidisrc, "MIDI data:", local_data, size);
+
+  GST_OBJECT_LOCK (alsamidisrc);
+  aggregate_time = alsamidisrc->aggregate_time;
+  GST_OBJECT_UNLOCK (alsamidisrc);
+
+  /* add the event to the previous buffer if it is close enough to its
+   * first event */
+  len = gst_buffer_list_length (buffer_list);
+  if (aggregate_time > 0 && len > 0) {
+    buffer = gst_buffer_list_get (buffer_list, len - 1);
+
+    if (time >= GST_BUFFER_PTS (buffer)
+        && time - GST_BUFFER_PTS (buffer) <= aggregate_time) {
+      buffer = gst_buffer_list_get_writable (buffer_list, len - 1);
+      gst_buffer_append_memory (buffer, mem);
+      GST_BUFFER_DURATION (buffer) = time - GST_BUFFER_PTS (buffer);
+      return;
+    }
+  }
 
   buffer = gst_buffer_new ();
 
   GST_BUFFER_DTS (buffer) = time;
   GST_BUFFER_PTS (buffer) = time;
 
-  local_data = g_memdup (data, size);
-
-  gst_buffer_append_memory (buffer,
-      gst_memory_new_wrapped (0, local_data, size, 0, size, local_data,
-          g_free));
-
-  GST_MEMDUMP_OBJECT (alsamidisrc, "MIDI data:", local_data, size);
+  gst_buffer_append_memory (buffer, mem);
 
   gst_buffer_list_add (buffer_list, buffer);
 }
@@ -52,6 +52,7 @@ struct _GstAlsaMidiSrc
   GstPushSrc element;
 
   gchar *ports;
+  GstClockTime aggregate_time;
 
   /*< private > */
   snd_seq_t *seq;
@@ -60,6 +60,8 @@
 #define DEFAULT_DEVICE		"default"
 #define DEFAULT_DEVICE_NAME	""
 #define DEFAULT_CARD_NAME	""
+#define DEFAULT_USE_MMAP	FALSE
+#define DEFAULT_TIMER_SCHEDULING	FALSE
 #define SPDIF_PERIOD_SIZE 1536
 #define SPDIF_BUFFER_SIZE 15360
 
@@ -69,6 +71,8 @@ enum
   PROP_DEVICE,
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
+  PROP_USE_MMAP,
+  PROP_TIMER_SCHEDULING,
   PROP_LAST
 };
 
@@ -121,6 +125,11 @@ gst_alsasink_finalise (GObject * object)
 {
   GstAlsaSink *sink = GST_ALSA_SINK (object);
 
+  if (sink->payload_pool) {
+    gst_buffer_pool_set_active (sink->payload_pool, FALSE);
+    gst_object_unref (sink->payload_pool);
+  }
+
   g_free (sink->device);
   g_mutex_clear (&sink->alsa_lock);
   g_mutex_clear (&sink->delay_lock);
@@ -202,6 +211,38 @@ gst_alsasink_class_init (GstAlsaSinkClass * klass)
           "Human-readable name of the sound card", DEFAULT_CARD_NAME,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_DOC_SHOW_DEFAULT));
+
+  /**
+   * GstAlsaSink:use-mmap:
+   *
+   * Transfer samples by writing them directly into the device buffer with
+   * snd_pcm_mmap_begin() and snd_pcm_mmap_commit() instead of using
+   * snd_pcm_writei(). Falls back to the latter when the device doesn't
+   * support mmap access.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Write samples directly into the mmapped device buffer",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSink:timer-scheduling:
+   *
+   * Instead of waking up for every period, sleep until the device buffer
+   * has drained to a watermark and then fill it up completely. Combined
+   * with a large #GstAudioBaseSink:buffer-time this needs far fewer
+   * wakeups. The watermark is raised after every underrun and slowly
+   * lowered again while playback is stable.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_TIMER_SCHEDULING,
+      g_param_spec_boolean ("timer-scheduling", "Timer scheduling",
+          "Wake up based on the device delay instead of every period",
+          DEFAULT_TIMER_SCHEDULING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -221,6 +262,12 @@ gst_alsasink_set_property (GObject * object, guint prop_id,
         sink->device = g_strdup (DEFAULT_DEVICE);
       }
       break;
+    case PROP_USE_MMAP:
+      sink->use_mmap = g_value_get_boolean (value);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      sink->timer_scheduling = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -249,6 +296,12 @@ gst_alsasink_get_property (GObject * object, guint prop_id,
           gst_alsa_find_card_name (GST_OBJECT_CAST (sink),
               sink->device, SND_PCM_STREAM_PLAYBACK));
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, sink->use_mmap);
+      break;
+    case PROP_TIMER_SCHEDULING:
+      g_value_set_boolean (value, sink->timer_scheduling);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -266,6 +319,8 @@ gst_alsasink_init (GstAlsaSink * alsasink)
   alsasink->is_paused = FALSE;
   alsasink->after_paused = FALSE;
   alsasink->hw_support_pause = FALSE;
+  alsasink->use_mmap = DEFAULT_USE_MMAP;
+  alsasink->timer_scheduling = DEFAULT_TIMER_SCHEDULING;
   g_mutex_init (&alsasink->alsa_lock);
   g_mutex_init (&alsasink->delay_lock);
 
@@ -450,7 +505,12 @@ set_hwparams (GstAlsaSink * alsa)
 retry:
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
-  /* set the interleaved read/write format */
+  /* set the interleaved read/write format, mmap access is optional */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not available, using writei");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
   /* set the sample format */
@@ -540,6 +600,14 @@ retry:
             &period_size, NULL), period_size);
   }
 
+#if GST_CHECK_ALSA_VERSION(1,0,24)
+  /* with timer scheduling we decide ourselves when to wake up, the
+   * interrupt for every period is not needed */
+  if (alsa->tsched &&
+      snd_pcm_hw_params_set_period_wakeup (alsa->handle, params, 0) < 0)
+    GST_DEBUG_OBJECT (alsa, "can't disable period wakeups");
+#endif
+
   /* write the parameters to device */
   CHECK (snd_pcm_hw_params (alsa->handle, params), set_hw_params);
 
@@ -831,7 +899,8 @@ alsasink_parse_spec (GstAlsaSink * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SINK
@@ -899,9 +968,22 @@ gst_alsasink_prepare (GstAudioSink * asink, GstAudioRingBufferSpec * spec)
   if (!alsasink_parse_spec (alsa, spec))
     goto spec_parse;
 
+  alsa->tsched = alsa->timer_scheduling && !alsa->iec958;
+
   CHECK (set_hwparams (alsa), hw_params_failed);
   CHECK (set_swparams (alsa), sw_params_failed);
 
+  if (alsa->tsched) {
+    /* start with waking up when 20ms or a period is left, whatever is
+     * larger, and leave room for at least one period to be written */
+    alsa->tsched_watermark = MAX (alsa->period_size, alsa->rate / 50);
+    alsa->tsched_watermark = MIN (alsa->tsched_watermark,
+        alsa->buffer_size - MIN (alsa->buffer_size, alsa->period_size));
+    alsa->tsched_stable = 0;
+    GST_DEBUG_OBJECT (alsa, "timer scheduling, watermark %lu",
+        alsa->tsched_watermark);
+  }
+
   alsa->bpf = GST_AUDIO_INFO_BPF (&spec->info);
   spec->segsize = alsa->period_size * alsa->bpf;
   spec->segtotal = alsa->buffer_size / alsa->period_size;
@@ -995,6 +1077,14 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   GST_WARNING_OBJECT (alsa, "xrun recovery %d: %s", err, g_strerror (-err));
 
   if (err == -EPIPE) {          /* under-run */
+    if (alsa->tsched) {
+      /* we woke up too late, wake up earlier from now on */
+      alsa->tsched_watermark = MIN (alsa->tsched_watermark * 2,
+          alsa->buffer_size - MIN (alsa->buffer_size, alsa->period_size));
+      alsa->tsched_stable = 0;
+      GST_DEBUG_OBJECT (alsa, "raised watermark to %lu",
+          alsa->tsched_watermark);
+    }
     err = snd_pcm_prepare (handle);
     if (err < 0)
       GST_WARNING_OBJECT (alsa,
@@ -1020,6 +1110,88 @@ xrun_recovery (GstAlsaSink * alsa, snd_pcm_t * handle, gint err)
   return err;
 }
 
+/* Write up to @frames frames straight into the device buffer, returns
+ * the number of frames written or a negative error like snd_pcm_writei() */
+static snd_pcm_sframes_t
+gst_alsasink_mmap_write (GstAlsaSink * alsa, const guint8 * ptr,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail, res;
+  gint err;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+  if (avail == 0)
+    return -EAGAIN;
+
+  size = MIN (frames, avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* all channels are interleaved in the first area */
+  memcpy ((guint8 *) areas[0].addr + (areas[0].first +
+          offset * areas[0].step) / 8, ptr,
+      snd_pcm_frames_to_bytes (alsa->handle, size));
+
+  res = snd_pcm_mmap_commit (alsa->handle, offset, size);
+  if (res < 0)
+    return res;
+  if (res != size)
+    return -EPIPE;
+
+  /* unlike snd_pcm_writei(), committing doesn't start the device once the
+   * start threshold is reached, do it ourselves */
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED &&
+      alsa->buffer_size - (avail - res) >=
+      (alsa->buffer_size / alsa->period_size) * alsa->period_size) {
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      return err;
+  }
+
+  return res;
+}
+
+/* Timer scheduling replacement for snd_pcm_wait(). Returns right away
+ * when there is room in the device buffer, else sleeps until the device
+ * has drained to the watermark. Called with the alsa lock, which is
+ * released while sleeping */
+static gint
+gst_alsasink_tsched_wait (GstAlsaSink * alsa)
+{
+  snd_pcm_sframes_t avail, delay, sleep_frames;
+  gint err;
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+  if (avail > 0)
+    return 0;
+
+  GST_DELAY_SINK_LOCK (alsa);
+  err = snd_pcm_delay (alsa->handle, &delay);
+  GST_DELAY_SINK_UNLOCK (alsa);
+  if (err < 0)
+    return err;
+
+  if (delay > (snd_pcm_sframes_t) alsa->tsched_watermark)
+    sleep_frames = delay - alsa->tsched_watermark;
+  else
+    sleep_frames = alsa->period_size;
+
+  GST_LOG_OBJECT (alsa, "delay %ld, sleeping for %ld frames", delay,
+      sleep_frames);
+
+  GST_ALSA_SINK_UNLOCK (alsa);
+  g_usleep (gst_util_uint64_scale_int (sleep_frames, G_USEC_PER_SEC,
+          alsa->rate));
+  GST_ALSA_SINK_LOCK (alsa);
+
+  return 0;
+}
+
 static gint
 gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 {
@@ -1030,16 +1202,6 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 
   alsa = GST_ALSA_SINK (asink);
 
-  if (alsa->iec958 && alsa->need_swap) {
-    guint i;
-    guint16 *ptr_tmp = (guint16 *) ptr;
-
-    GST_DEBUG_OBJECT (asink, "swapping bytes");
-    for (i = 0; i < length / 2; i++) {
-      ptr_tmp[i] = GUINT16_SWAP_LE_BE (ptr_tmp[i]);
-    }
-  }
-
   GST_LOG_OBJECT (asink, "received audio samples buffer of %u bytes", length);
 
   cptr = length / alsa->bpf;
@@ -1048,12 +1210,18 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
   while (cptr > 0) {
     /* start by doing a blocking wait for free space. Set the timeout
      * to 4 times the period time */
-    err = snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+    if (alsa->tsched)
+      err = gst_alsasink_tsched_wait (alsa);
+    else
+      err = snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
     if (err < 0) {
       GST_DEBUG_OBJECT (asink, "wait error, %d", err);
     } else {
       GST_DELAY_SINK_LOCK (asink);
-      err = snd_pcm_writei (alsa->handle, ptr, cptr);
+      if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+        err = gst_alsasink_mmap_write (alsa, ptr, cptr);
+      else
+        err = snd_pcm_writei (alsa->handle, ptr, cptr);
       GST_DELAY_SINK_UNLOCK (asink);
     }
 
@@ -1072,6 +1240,19 @@ gst_alsasink_write (GstAudioSink * asink, gpointer data, guint length)
 
     ptr += snd_pcm_frames_to_bytes (alsa->handle, err);
     cptr -= err;
+
+    if (alsa->tsched) {
+      /* after 10 seconds without underruns, wake up a bit later */
+      alsa->tsched_stable += err;
+      if (alsa->tsched_stable >= 10 * alsa->rate &&
+          alsa->tsched_watermark > alsa->period_size) {
+        alsa->tsched_watermark = MAX (alsa->period_size,
+            alsa->tsched_watermark - alsa->tsched_watermark / 4);
+        alsa->tsched_stable = 0;
+        GST_DEBUG_OBJECT (alsa, "lowered watermark to %lu",
+            alsa->tsched_watermark);
+      }
+    }
   }
   GST_ALSA_SINK_UNLOCK (asink);
 
@@ -1221,6 +1402,40 @@ prepare_error:
   }
 }
 
+static GstBuffer *
+gst_alsasink_acquire_payload_buffer (GstAlsaSink * alsa, gint size)
+{
+  GstBuffer *out = NULL;
+
+  if (alsa->payload_pool == NULL || alsa->payload_size != size) {
+    GstStructure *config;
+
+    if (alsa->payload_pool) {
+      gst_buffer_pool_set_active (alsa->payload_pool, FALSE);
+      gst_object_unref (alsa->payload_pool);
+    }
+
+    alsa->payload_pool = gst_buffer_pool_new ();
+    alsa->payload_size = size;
+
+    config = gst_buffer_pool_get_config (alsa->payload_pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    if (!gst_buffer_pool_set_config (alsa->payload_pool, config) ||
+        !gst_buffer_pool_set_active (alsa->payload_pool, TRUE)) {
+      GST_WARNING_OBJECT (alsa, "failed to set up payload buffer pool");
+      gst_object_unref (alsa->payload_pool);
+      alsa->payload_pool = NULL;
+    }
+  }
+
+  if (alsa->payload_pool == NULL ||
+      gst_buffer_pool_acquire_buffer (alsa->payload_pool, &out,
+          NULL) != GST_FLOW_OK)
+    out = gst_buffer_new_and_alloc (size);
+
+  return out;
+}
+
 static GstBuffer *
 gst_alsasink_payload (GstAudioBaseSink * sink, GstBuffer * buf)
 {
@@ -1232,18 +1447,23 @@ gst_alsasink_payload (GstAudioBaseSink * sink, GstBuffer * buf)
     GstBuffer *out;
     gint framesize;
     GstMapInfo iinfo, oinfo;
+    gint endianness;
 
     framesize = gst_audio_iec61937_frame_size (&sink->ringbuffer->spec);
     if (framesize <= 0)
       return NULL;
 
-    out = gst_buffer_new_and_alloc (framesize);
+    out = gst_alsasink_acquire_payload_buffer (alsa, framesize);
 
     gst_buffer_map (buf, &iinfo, GST_MAP_READ);
     gst_buffer_map (out, &oinfo, GST_MAP_WRITE);
 
+    /* payload directly in the byte order the device was opened with, so the
+     * data does not need to be swapped again when it is written */
+    endianness = alsa->need_swap ? G_LITTLE_ENDIAN : G_BIG_ENDIAN;
+
     if (!gst_audio_iec61937_payload (iinfo.data, iinfo.size,
-            oinfo.data, oinfo.size, &sink->ringbuffer->spec, G_BIG_ENDIAN)) {
+            oinfo.data, oinfo.size, &sink->ringbuffer->spec, endianness)) {
       gst_buffer_unmap (buf, &iinfo);
       gst_buffer_unmap (out, &oinfo);
       gst_buffer_unref (out);
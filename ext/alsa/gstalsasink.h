@@ -59,6 +59,8 @@ struct _GstAlsaSink {
 
   snd_pcm_t             *handle;
 
+  gboolean use_mmap;
+  gboolean timer_scheduling;
   snd_pcm_access_t access;
   snd_pcm_format_t format;
   guint rate;
@@ -67,6 +69,10 @@ struct _GstAlsaSink {
   gboolean iec958;
   gboolean need_swap;
 
+  /* burst sized buffers for IEC 61937 payloading */
+  GstBufferPool *payload_pool;
+  gint payload_size;
+
   guint buffer_time;
   guint period_time;
   snd_pcm_uframes_t buffer_size;
@@ -79,6 +85,11 @@ struct _GstAlsaSink {
   gboolean hw_support_pause;
   snd_pcm_sframes_t pos_in_buffer;
 
+  /* timer scheduling */
+  gboolean tsched;
+  snd_pcm_uframes_t tsched_watermark;
+  guint64 tsched_stable;
+
   GMutex alsa_lock;
   GMutex delay_lock;
 };
@@ -57,6 +57,7 @@
 #define DEFAULT_PROP_DEVICE_NAME	  ""
 #define DEFAULT_PROP_CARD_NAME	          ""
 #define DEFAULT_PROP_USE_DRIVER_TIMESTAMP TRUE
+#define DEFAULT_PROP_USE_MMAP             FALSE
 
 enum
 {
@@ -65,6 +66,7 @@ enum
   PROP_DEVICE_NAME,
   PROP_CARD_NAME,
   PROP_USE_DRIVER_TIMESTAMP,
+  PROP_USE_MMAP,
   PROP_LAST
 };
 
@@ -179,6 +181,21 @@ gst_alsasrc_class_init (GstAlsaSrcClass * klass)
           "Use driver timestamps or the pipeline clock timestamps",
           DEFAULT_PROP_USE_DRIVER_TIMESTAMP,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAlsaSrc:use-mmap:
+   *
+   * Transfer samples by reading them directly from the device buffer with
+   * snd_pcm_mmap_begin() and snd_pcm_mmap_commit() instead of using
+   * snd_pcm_readi(). Falls back to the latter when the device doesn't
+   * support mmap access.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Read samples directly from the mmapped device buffer",
+          DEFAULT_PROP_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -202,6 +219,9 @@ gst_alsasrc_set_property (GObject * object, guint prop_id,
       src->use_driver_timestamps = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (src);
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -235,6 +255,9 @@ gst_alsasrc_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, src->use_driver_timestamps);
       GST_OBJECT_UNLOCK (src);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -296,6 +319,7 @@ gst_alsasrc_init (GstAlsaSrc * alsasrc)
   alsasrc->cached_caps = NULL;
   alsasrc->driver_timestamps = FALSE;
   alsasrc->use_driver_timestamps = DEFAULT_PROP_USE_DRIVER_TIMESTAMP;
+  alsasrc->use_mmap = DEFAULT_PROP_USE_MMAP;
 
   g_mutex_init (&alsasrc->alsa_lock);
 }
@@ -371,7 +395,12 @@ set_hwparams (GstAlsaSrc * alsa)
 
   /* choose all parameters */
   CHECK (snd_pcm_hw_params_any (alsa->handle, params), no_config);
-  /* set the interleaved read/write format */
+  /* set the interleaved read/write format, mmap access is optional */
+  if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED &&
+      snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access) < 0) {
+    GST_WARNING_OBJECT (alsa, "mmap access not available, using readi");
+    alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  }
   CHECK (snd_pcm_hw_params_set_access (alsa->handle, params, alsa->access),
       wrong_access);
   /* set the sample format */
@@ -728,7 +757,8 @@ alsasrc_parse_spec (GstAlsaSrc * alsa, GstAudioRingBufferSpec * spec)
   alsa->channels = GST_AUDIO_INFO_CHANNELS (&spec->info);
   alsa->buffer_time = spec->buffer_time;
   alsa->period_time = spec->latency_time;
-  alsa->access = SND_PCM_ACCESS_RW_INTERLEAVED;
+  alsa->access = alsa->use_mmap ? SND_PCM_ACCESS_MMAP_INTERLEAVED :
+      SND_PCM_ACCESS_RW_INTERLEAVED;
 
   if (spec->type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW && alsa->channels < 9)
     gst_audio_ring_buffer_set_channel_positions (GST_AUDIO_BASE_SRC
@@ -970,6 +1000,52 @@ gst_alsasrc_get_timestamp (GstAlsaSrc * asrc)
   return timestamp;
 }
 
+/* Read up to @frames frames straight from the device buffer, returns
+ * the number of frames read or a negative error like snd_pcm_readi() */
+static snd_pcm_sframes_t
+gst_alsasrc_mmap_read (GstAlsaSrc * alsa, guint8 * ptr,
+    snd_pcm_uframes_t frames)
+{
+  const snd_pcm_channel_area_t *areas;
+  snd_pcm_uframes_t offset, size;
+  snd_pcm_sframes_t avail, res;
+  gint err;
+
+  /* unlike snd_pcm_readi(), mmap access doesn't start capturing by
+   * itself */
+  if (snd_pcm_state (alsa->handle) == SND_PCM_STATE_PREPARED) {
+    if ((err = snd_pcm_start (alsa->handle)) < 0)
+      return err;
+  }
+
+  avail = snd_pcm_avail_update (alsa->handle);
+  if (avail < 0)
+    return avail;
+  if (avail == 0) {
+    /* wait for the next period, set the timeout to 4 times the period
+     * time */
+    err = snd_pcm_wait (alsa->handle, (4 * alsa->period_time / 1000));
+    return err < 0 ? err : -EAGAIN;
+  }
+
+  size = MIN (frames, avail);
+  if ((err = snd_pcm_mmap_begin (alsa->handle, &areas, &offset, &size)) < 0)
+    return err;
+
+  /* all channels are interleaved in the first area */
+  memcpy (ptr, (guint8 *) areas[0].addr + (areas[0].first +
+          offset * areas[0].step) / 8,
+      snd_pcm_frames_to_bytes (alsa->handle, size));
+
+  res = snd_pcm_mmap_commit (alsa->handle, offset, size);
+  if (res < 0)
+    return res;
+  if (res != size)
+    return -EPIPE;
+
+  return res;
+}
+
 static guint
 gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
     GstClockTime * timestamp)
@@ -985,7 +1061,12 @@ gst_alsasrc_read (GstAudioSrc * asrc, gpointer data, guint length,
 
   GST_ALSA_SRC_LOCK (asrc);
   while (cptr > 0) {
-    if ((err = snd_pcm_readi (alsa->handle, ptr, cptr)) < 0) {
+    if (alsa->access == SND_PCM_ACCESS_MMAP_INTERLEAVED)
+      err = gst_alsasrc_mmap_read (alsa, ptr, cptr);
+    else
+      err = snd_pcm_readi (alsa->handle, ptr, cptr);
+
+    if (err < 0) {
       if (err == -EAGAIN) {
         GST_DEBUG_OBJECT (asrc, "Read error: %s", snd_strerror (err));
         continue;
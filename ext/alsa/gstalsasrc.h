@@ -65,6 +65,7 @@ struct _GstAlsaSrc {
   gint                  bpf;
   gboolean              driver_timestamps;
   gboolean              use_driver_timestamps;
+  gboolean              use_mmap;
 
   guint                 buffer_time;
   guint                 period_time;
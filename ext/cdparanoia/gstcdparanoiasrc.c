@@ -45,7 +45,8 @@ enum
   PROP_PARANOIA_MODE,
   PROP_SEARCH_OVERLAP,
   PROP_GENERIC_DEVICE,
-  PROP_CACHE_SIZE
+  PROP_CACHE_SIZE,
+  PROP_READ_AHEAD
 };
 
 #define DEFAULT_READ_SPEED              -1
@@ -53,6 +54,7 @@ enum
 #define DEFAULT_PARANOIA_MODE            PARANOIA_MODE_FRAGMENT
 #define DEFAULT_GENERIC_DEVICE           NULL
 #define DEFAULT_CACHE_SIZE              -1
+#define DEFAULT_READ_AHEAD               0
 
 GST_DEBUG_CATEGORY_STATIC (gst_cd_paranoia_src_debug);
 #define GST_CAT_DEFAULT gst_cd_paranoia_src_debug
@@ -70,6 +72,7 @@ static GstBuffer *gst_cd_paranoia_src_read_sector (GstAudioCdSrc * src,
 static gboolean gst_cd_paranoia_src_open (GstAudioCdSrc * src,
     const gchar * device);
 static void gst_cd_paranoia_src_close (GstAudioCdSrc * src);
+static void gst_cd_paranoia_src_stop_read_ahead (GstCdParanoiaSrc * src);
 
 /* We use these to serialize calls to paranoia_read() among several
  * cdparanoiasrc instances. We do this because it's the only reasonably
@@ -115,6 +118,11 @@ gst_cd_paranoia_src_init (GstCdParanoiaSrc * src)
   src->read_speed = DEFAULT_READ_SPEED;
   src->generic_device = g_strdup (DEFAULT_GENERIC_DEVICE);
   src->cache_size = DEFAULT_CACHE_SIZE;
+  src->read_ahead = DEFAULT_READ_AHEAD;
+
+  g_mutex_init (&src->ra_lock);
+  g_cond_init (&src->ra_cond);
+  g_queue_init (&src->ra_queue);
 }
 
 static void
@@ -165,6 +173,25 @@ gst_cd_paranoia_src_class_init (GstCdParanoiaSrcClass * klass)
           "Set CD cache size to n sectors (-1 = auto)", -1,
           G_MAXINT, DEFAULT_CACHE_SIZE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstCdParanoiaSrc:read-ahead:
+   *
+   * Number of sectors to read and verify ahead of playback in a background
+   * thread, so that paranoia verification and drive I/O overlap with
+   * downstream processing (0 = disabled, read from the streaming thread).
+   * Changes take effect the next time the device is opened.
+   *
+   * Note that the #GstCdParanoiaSrc::transport-error and
+   * #GstCdParanoiaSrc::uncorrected-error signals are emitted from the
+   * read-ahead thread when this is enabled.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_READ_AHEAD,
+      g_param_spec_int ("read-ahead", "Read ahead",
+          "Number of sectors to read ahead in a background thread "
+          "(0 = disabled)", 0, G_MAXINT, DEFAULT_READ_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   /* FIXME: we don't really want signals for this, but messages on the bus,
    * but then we can't check any longer whether anyone is interested in them */
@@ -268,6 +295,12 @@ gst_cd_paranoia_src_open (GstAudioCdSrc * audiocdsrc, const gchar * device)
 
   src->next_sector = -1;
 
+  GST_OBJECT_LOCK (src);
+  src->ra_size = src->read_ahead;
+  GST_OBJECT_UNLOCK (src);
+  src->ra_last = cdda_disc_lastsector (src->d);
+  GST_INFO_OBJECT (src, "read-ahead of %d sectors", src->ra_size);
+
   return TRUE;
 
   /* ERRORS */
@@ -298,6 +331,8 @@ gst_cd_paranoia_src_close (GstAudioCdSrc * audiocdsrc)
 {
   GstCdParanoiaSrc *src = GST_CD_PARANOIA_SRC (audiocdsrc);
 
+  gst_cd_paranoia_src_stop_read_ahead (src);
+
   if (src->p) {
     paranoia_free (src->p);
     src->p = NULL;
@@ -343,34 +378,15 @@ gst_cd_paranoia_src_signal_is_being_watched (GstCdParanoiaSrc * src, gint sig)
   return g_signal_has_handler_pending (src, cdpsrc_signals[sig], 0, FALSE);
 }
 
+/* reads the sector the paranoia handle is positioned at, returns NULL if
+ * the read failed */
 static GstBuffer *
-gst_cd_paranoia_src_read_sector (GstAudioCdSrc * audiocdsrc, gint sector)
+gst_cd_paranoia_src_read_current (GstCdParanoiaSrc * src)
 {
-  GstCdParanoiaSrc *src = GST_CD_PARANOIA_SRC (audiocdsrc);
   GstBuffer *buf;
   gboolean do_serialize;
   gint16 *cdda_buf;
 
-#if 0
-  /* Do we really need to output this? (tpm) */
-  /* Due to possible autocorrections of start sectors of audio tracks on 
-   * multisession cds, we can maybe not compute the correct discid.
-   * So issue a warning.
-   * See cdparanoia/interface/common-interface.c:FixupTOC */
-  if (src->d && src->d->cd_extra) {
-    g_message
-        ("DiscID on multisession discs might be broken. Use at own risk.");
-  }
-#endif
-
-  if (src->next_sector == -1 || src->next_sector != sector) {
-    if (paranoia_seek (src->p, sector, SEEK_SET) == -1)
-      goto seek_failed;
-
-    GST_DEBUG_OBJECT (src, "successfully seeked to sector %d", sector);
-    src->next_sector = sector;
-  }
-
   do_serialize =
       gst_cd_paranoia_src_signal_is_being_watched (src, TRANSPORT_ERROR) ||
       gst_cd_paranoia_src_signal_is_being_watched (src, UNCORRECTED_ERROR);
@@ -391,11 +407,178 @@ gst_cd_paranoia_src_read_sector (GstAudioCdSrc * audiocdsrc, gint sector)
   }
 
   if (cdda_buf == NULL)
-    goto read_failed;
+    return NULL;
 
   buf = gst_buffer_new_and_alloc (CD_FRAMESIZE_RAW);
   gst_buffer_fill (buf, 0, cdda_buf, CD_FRAMESIZE_RAW);
 
+  return buf;
+}
+
+/* The read-ahead thread owns the paranoia handle while it is running: it
+ * reads sequentially from ra_next and queues up to ra_size sectors. Seeks
+ * are done by the streaming thread after stopping it. */
+static gpointer
+gst_cd_paranoia_src_read_ahead_func (GstCdParanoiaSrc * src)
+{
+  GstBuffer *buf;
+
+  g_mutex_lock (&src->ra_lock);
+  while (src->ra_running) {
+    if (g_queue_get_length (&src->ra_queue) >= src->ra_size
+        || src->ra_next > src->ra_last) {
+      g_cond_wait (&src->ra_cond, &src->ra_lock);
+      continue;
+    }
+    g_mutex_unlock (&src->ra_lock);
+
+    buf = gst_cd_paranoia_src_read_current (src);
+
+    g_mutex_lock (&src->ra_lock);
+    if (buf == NULL) {
+      src->ra_error = TRUE;
+      g_cond_broadcast (&src->ra_cond);
+      break;
+    }
+    g_queue_push_tail (&src->ra_queue, buf);
+    src->ra_next++;
+    g_cond_broadcast (&src->ra_cond);
+  }
+  g_mutex_unlock (&src->ra_lock);
+
+  return NULL;
+}
+
+static void
+gst_cd_paranoia_src_stop_read_ahead (GstCdParanoiaSrc * src)
+{
+  if (src->ra_thread == NULL)
+    return;
+
+  g_mutex_lock (&src->ra_lock);
+  src->ra_running = FALSE;
+  g_cond_broadcast (&src->ra_cond);
+  g_mutex_unlock (&src->ra_lock);
+
+  g_thread_join (src->ra_thread);
+  src->ra_thread = NULL;
+
+  g_queue_foreach (&src->ra_queue, (GFunc) gst_buffer_unref, NULL);
+  g_queue_clear (&src->ra_queue);
+  src->ra_error = FALSE;
+
+  /* the handle is positioned at whatever the thread read last */
+  src->next_sector = -1;
+}
+
+static GstBuffer *
+gst_cd_paranoia_src_read_sector_ahead (GstCdParanoiaSrc * src, gint sector)
+{
+  GstBuffer *buf;
+
+  if (sector > src->ra_last)
+    goto read_failed;
+
+  g_mutex_lock (&src->ra_lock);
+  if (src->ra_thread == NULL || sector < src->ra_first
+      || sector > src->ra_next) {
+    g_mutex_unlock (&src->ra_lock);
+
+    gst_cd_paranoia_src_stop_read_ahead (src);
+
+    if (paranoia_seek (src->p, sector, SEEK_SET) == -1)
+      goto seek_failed;
+
+    GST_DEBUG_OBJECT (src, "successfully seeked to sector %d, starting "
+        "read-ahead", sector);
+
+    src->ra_first = src->ra_next = sector;
+    src->ra_running = TRUE;
+    src->ra_thread = g_thread_new ("cdparanoia-read-ahead",
+        (GThreadFunc) gst_cd_paranoia_src_read_ahead_func, src);
+
+    g_mutex_lock (&src->ra_lock);
+  }
+
+  for (;;) {
+    if (!g_queue_is_empty (&src->ra_queue)) {
+      if (src->ra_first == sector)
+        break;
+      /* drop the sectors that were skipped over */
+      gst_buffer_unref (g_queue_pop_head (&src->ra_queue));
+      src->ra_first++;
+      g_cond_broadcast (&src->ra_cond);
+      continue;
+    }
+    if (src->ra_error)
+      break;
+    g_cond_wait (&src->ra_cond, &src->ra_lock);
+  }
+
+  buf = g_queue_pop_head (&src->ra_queue);
+  if (buf != NULL) {
+    src->ra_first++;
+    g_cond_broadcast (&src->ra_cond);
+  }
+  g_mutex_unlock (&src->ra_lock);
+
+  if (buf == NULL)
+    goto read_failed;
+
+  return buf;
+
+  /* ERRORS */
+seek_failed:
+  {
+    GST_WARNING_OBJECT (src, "seek to sector %d failed!", sector);
+    GST_ELEMENT_ERROR (src, RESOURCE, SEEK,
+        (_("Could not seek CD.")),
+        ("paranoia_seek to %d failed: %s", sector, g_strerror (errno)));
+    return NULL;
+  }
+read_failed:
+  {
+    GST_WARNING_OBJECT (src, "read at sector %d failed!", sector);
+    GST_ELEMENT_ERROR (src, RESOURCE, READ,
+        (_("Could not read CD.")),
+        ("paranoia_read at %d failed", sector));
+    return NULL;
+  }
+}
+
+static GstBuffer *
+gst_cd_paranoia_src_read_sector (GstAudioCdSrc * audiocdsrc, gint sector)
+{
+  GstCdParanoiaSrc *src = GST_CD_PARANOIA_SRC (audiocdsrc);
+  GstBuffer *buf;
+
+#if 0
+  /* Do we really need to output this? (tpm) */
+  /* Due to possible autocorrections of start sectors of audio tracks on 
+   * multisession cds, we can maybe not compute the correct discid.
+   * So issue a warning.
+   * See cdparanoia/interface/common-interface.c:FixupTOC */
+  if (src->d && src->d->cd_extra) {
+    g_message
+        ("DiscID on multisession discs might be broken. Use at own risk.");
+  }
+#endif
+
+  if (src->ra_size > 0)
+    return gst_cd_paranoia_src_read_sector_ahead (src, sector);
+
+  if (src->next_sector == -1 || src->next_sector != sector) {
+    if (paranoia_seek (src->p, sector, SEEK_SET) == -1)
+      goto seek_failed;
+
+    GST_DEBUG_OBJECT (src, "successfully seeked to sector %d", sector);
+    src->next_sector = sector;
+  }
+
+  buf = gst_cd_paranoia_src_read_current (src);
+  if (buf == NULL)
+    goto read_failed;
+
   /* cdda base class will take care of timestamping etc. */
   ++src->next_sector;
 
@@ -427,6 +610,9 @@ gst_cd_paranoia_src_finalize (GObject * obj)
 
   g_free (src->generic_device);
 
+  g_mutex_clear (&src->ra_lock);
+  g_cond_clear (&src->ra_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
 
@@ -466,6 +652,10 @@ gst_cd_paranoia_src_set_property (GObject * object, guint prop_id,
       src->cache_size = g_value_get_int (value);
       break;
     }
+    case PROP_READ_AHEAD:{
+      src->read_ahead = g_value_get_int (value);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -498,6 +688,9 @@ gst_cd_paranoia_src_get_property (GObject * object, guint prop_id,
     case PROP_CACHE_SIZE:
       g_value_set_int (value, src->cache_size);
       break;
+    case PROP_READ_AHEAD:
+      g_value_set_int (value, src->read_ahead);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -68,6 +68,20 @@ struct _GstCdParanoiaSrc {
   gint             cache_size;
 
   gchar           *generic_device;
+
+  gint             read_ahead;
+
+  /* read-ahead thread, only used when read-ahead was > 0 on open */
+  gint             ra_size;
+  GThread         *ra_thread;
+  GMutex           ra_lock;
+  GCond            ra_cond;
+  GQueue           ra_queue;    /* buffers for sectors ra_first ...     */
+  gint             ra_first;    /* sector of the head of ra_queue       */
+  gint             ra_next;     /* next sector the thread will read     */
+  gint             ra_last;     /* last sector on the disc              */
+  gboolean         ra_running;
+  gboolean         ra_error;    /* reading ra_next failed               */
 };
 
 struct _GstCdParanoiaSrcClass {
@@ -41,11 +41,26 @@ static void gst_gl_base_mixer_set_context (GstElement * element,
 static GstStateChangeReturn gst_gl_base_mixer_change_state (GstElement *
     element, GstStateChange transition);
 
+/* number of output frames that can be in flight on the GPU while timing */
+#define GPU_TIMER_RING_SIZE 4
+
 struct _GstGLBaseMixerPrivate
 {
   gboolean negotiated;
 
   GstGLContext *other_context;
+
+  /* GPU timing, the queries are only accessed from the GL thread and the
+   * statistics with the object lock */
+  gint gpu_timing;
+  GstGLQuery *gpu_queries[GPU_TIMER_RING_SIZE][2];
+  guint gpu_head;
+  guint gpu_n_pending;
+  gboolean gpu_started;
+  guint64 gpu_frames;
+  guint64 gpu_last;
+  guint64 gpu_total;
+  guint64 gpu_max;
 };
 
 #define gst_gl_base_mixer_parent_class parent_class
@@ -220,7 +235,9 @@ enum
 enum
 {
   PROP_0,
-  PROP_CONTEXT
+  PROP_CONTEXT,
+  PROP_GPU_TIMING,
+  PROP_GPU_STATS
 };
 
 static gboolean gst_gl_base_mixer_src_query (GstAggregator * agg,
@@ -239,6 +256,8 @@ static void gst_gl_base_mixer_get_property (GObject * object, guint prop_id,
 
 static gboolean gst_gl_base_mixer_decide_allocation (GstAggregator * agg,
     GstQuery * query);
+static GstFlowReturn gst_gl_base_mixer_aggregate (GstAggregator * agg,
+    gboolean timeout);
 
 static void
 gst_gl_base_mixer_class_init (GstGLBaseMixerClass * klass)
@@ -266,6 +285,7 @@ gst_gl_base_mixer_class_init (GstGLBaseMixerClass * klass)
   agg_class->start = gst_gl_base_mixer_start;
   agg_class->decide_allocation = gst_gl_base_mixer_decide_allocation;
   agg_class->propose_allocation = gst_gl_base_mixer_propose_allocation;
+  agg_class->aggregate = gst_gl_base_mixer_aggregate;
 
   g_object_class_install_property (gobject_class, PROP_CONTEXT,
       g_param_spec_object ("context",
@@ -273,6 +293,33 @@ gst_gl_base_mixer_class_init (GstGLBaseMixerClass * klass)
           "Get OpenGL context",
           GST_TYPE_GL_CONTEXT, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGLBaseMixer:gpu-timing:
+   *
+   * Measure the GPU time spent on producing each output buffer. Requires
+   * timestamp query support in the OpenGL implementation.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_GPU_TIMING,
+      g_param_spec_boolean ("gpu-timing", "GPU timing",
+          "Measure the GPU time spent on each output buffer", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGLBaseMixer:gpu-stats:
+   *
+   * Statistics of the GPU time measurements, as a structure named
+   * `application/x-gl-gpu-stats` with the #guint64 fields `frames`, and
+   * `last`, `average` and `max` in nanoseconds.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_GPU_STATS,
+      g_param_spec_boxed ("gpu-stats", "GPU statistics",
+          "Statistics of the GPU time measurements", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /* Register the pad class */
   g_type_class_ref (GST_TYPE_GL_BASE_MIXER_PAD);
 
@@ -369,6 +416,119 @@ gst_gl_base_mixer_decide_allocation (GstAggregator * agg, GstQuery * query)
   return TRUE;
 }
 
+/* The results of timestamp queries are read back a few frames later, once
+ * the GPU is done with them, so measuring never blocks the pipeline */
+static void
+_gpu_timer_collect (GstGLBaseMixer * mix)
+{
+  GstGLBaseMixerPrivate *priv = mix->priv;
+
+  while (priv->gpu_n_pending > 0) {
+    guint idx = (priv->gpu_head + GPU_TIMER_RING_SIZE - priv->gpu_n_pending)
+        % GPU_TIMER_RING_SIZE;
+    guint64 start, end, elapsed;
+
+    if (!gst_gl_query_result_available (priv->gpu_queries[idx][1]))
+      break;
+
+    start = gst_gl_query_result (priv->gpu_queries[idx][0]);
+    end = gst_gl_query_result (priv->gpu_queries[idx][1]);
+    elapsed = end > start ? end - start : 0;
+    priv->gpu_n_pending--;
+
+    GST_LOG_OBJECT (mix, "frame took %" GST_TIME_FORMAT " on the GPU",
+        GST_TIME_ARGS (elapsed));
+
+    GST_OBJECT_LOCK (mix);
+    priv->gpu_frames++;
+    priv->gpu_last = elapsed;
+    priv->gpu_total += elapsed;
+    priv->gpu_max = MAX (priv->gpu_max, elapsed);
+    GST_OBJECT_UNLOCK (mix);
+  }
+}
+
+static void
+_gpu_timer_start (GstGLContext * context, GstGLBaseMixer * mix)
+{
+  GstGLBaseMixerPrivate *priv = mix->priv;
+  guint i;
+
+  if (!context->gl_vtable->QueryCounter
+      || !context->gl_vtable->GetQueryObjectuiv)
+    return;
+
+  if (!priv->gpu_queries[0][0]) {
+    for (i = 0; i < GPU_TIMER_RING_SIZE; i++) {
+      priv->gpu_queries[i][0] =
+          gst_gl_query_new (context, GST_GL_QUERY_TIMESTAMP);
+      priv->gpu_queries[i][1] =
+          gst_gl_query_new (context, GST_GL_QUERY_TIMESTAMP);
+    }
+  }
+
+  _gpu_timer_collect (mix);
+
+  /* skip the frame rather than wait if all the queries are busy */
+  priv->gpu_started = priv->gpu_n_pending < GPU_TIMER_RING_SIZE;
+  if (priv->gpu_started)
+    gst_gl_query_counter (priv->gpu_queries[priv->gpu_head][0]);
+}
+
+static void
+_gpu_timer_end (GstGLContext * context, GstGLBaseMixer * mix)
+{
+  GstGLBaseMixerPrivate *priv = mix->priv;
+
+  if (!priv->gpu_started)
+    return;
+
+  gst_gl_query_counter (priv->gpu_queries[priv->gpu_head][1]);
+  priv->gpu_head = (priv->gpu_head + 1) % GPU_TIMER_RING_SIZE;
+  priv->gpu_n_pending++;
+  priv->gpu_started = FALSE;
+}
+
+static void
+_gpu_timer_free (GstGLContext * context, GstGLBaseMixer * mix)
+{
+  GstGLBaseMixerPrivate *priv = mix->priv;
+  guint i;
+
+  for (i = 0; i < GPU_TIMER_RING_SIZE; i++) {
+    if (priv->gpu_queries[i][0]) {
+      gst_gl_query_free (priv->gpu_queries[i][0]);
+      gst_gl_query_free (priv->gpu_queries[i][1]);
+      priv->gpu_queries[i][0] = priv->gpu_queries[i][1] = NULL;
+    }
+  }
+  priv->gpu_head = 0;
+  priv->gpu_n_pending = 0;
+  priv->gpu_started = FALSE;
+}
+
+static GstFlowReturn
+gst_gl_base_mixer_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstGLBaseMixer *mix = GST_GL_BASE_MIXER (agg);
+  GstGLContext *context = mix->context;
+  gboolean timing;
+  GstFlowReturn ret;
+
+  timing = context && g_atomic_int_get (&mix->priv->gpu_timing);
+  if (timing)
+    gst_gl_context_thread_add (context,
+        (GstGLContextThreadFunc) _gpu_timer_start, mix);
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->aggregate (agg, timeout);
+
+  if (timing)
+    gst_gl_context_thread_add (context,
+        (GstGLContextThreadFunc) _gpu_timer_end, mix);
+
+  return ret;
+}
+
 static void
 gst_gl_base_mixer_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
@@ -379,6 +539,22 @@ gst_gl_base_mixer_get_property (GObject * object,
     case PROP_CONTEXT:
       g_value_set_object (value, mixer->context);
       break;
+    case PROP_GPU_TIMING:
+      g_value_set_boolean (value, g_atomic_int_get (&mixer->priv->gpu_timing));
+      break;
+    case PROP_GPU_STATS:{
+      GstGLBaseMixerPrivate *priv = mixer->priv;
+
+      GST_OBJECT_LOCK (mixer);
+      g_value_take_boxed (value, gst_structure_new ("application/x-gl-gpu-stats",
+              "frames", G_TYPE_UINT64, priv->gpu_frames,
+              "last", G_TYPE_UINT64, priv->gpu_last,
+              "average", G_TYPE_UINT64, priv->gpu_frames ?
+              priv->gpu_total / priv->gpu_frames : (guint64) 0,
+              "max", G_TYPE_UINT64, priv->gpu_max, NULL));
+      GST_OBJECT_UNLOCK (mixer);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -389,7 +565,12 @@ static void
 gst_gl_base_mixer_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
 {
+  GstGLBaseMixer *mixer = GST_GL_BASE_MIXER (object);
+
   switch (prop_id) {
+    case PROP_GPU_TIMING:
+      g_atomic_int_set (&mixer->priv->gpu_timing, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -399,6 +580,15 @@ gst_gl_base_mixer_set_property (GObject * object,
 static gboolean
 gst_gl_base_mixer_start (GstAggregator * agg)
 {
+  GstGLBaseMixer *mix = GST_GL_BASE_MIXER (agg);
+
+  GST_OBJECT_LOCK (mix);
+  mix->priv->gpu_frames = 0;
+  mix->priv->gpu_last = 0;
+  mix->priv->gpu_total = 0;
+  mix->priv->gpu_max = 0;
+  GST_OBJECT_UNLOCK (mix);
+
   return GST_AGGREGATOR_CLASS (parent_class)->start (agg);;
 }
 
@@ -408,6 +598,8 @@ gst_gl_base_mixer_stop (GstAggregator * agg)
   GstGLBaseMixer *mix = GST_GL_BASE_MIXER (agg);
 
   if (mix->context) {
+    gst_gl_context_thread_add (mix->context,
+        (GstGLContextThreadFunc) _gpu_timer_free, mix);
     gst_object_unref (mix->context);
     mix->context = NULL;
   }
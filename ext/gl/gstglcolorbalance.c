@@ -54,6 +54,16 @@ GST_DEBUG_CATEGORY_STATIC (glcolorbalance_debug);
 #define DEFAULT_PROP_HUE            0.0
 #define DEFAULT_PROP_SATURATION	    1.0
 
+/* formats that are only accepted in passthrough mode, so that YUV can reach
+ * a sink that samples it directly when no balance is applied */
+#define GST_GL_COLOR_BALANCE_PASSTHROUGH_CAPS(features) \
+    "video/x-raw(" features "), "                                       \
+    "format = (string) { NV12, I420 }, "                                \
+    "width = " GST_VIDEO_SIZE_RANGE ", "                                \
+    "height = " GST_VIDEO_SIZE_RANGE ", "                               \
+    "framerate = " GST_VIDEO_FPS_RANGE ", "                             \
+    "texture-target = (string) 2D"
+
 #define GST_GL_COLOR_BALANCE_VIDEO_CAPS \
     "video/x-raw(" GST_CAPS_FEATURE_MEMORY_GL_MEMORY "), "              \
     "format = (string) RGBA, "              \
@@ -68,7 +78,12 @@ GST_DEBUG_CATEGORY_STATIC (glcolorbalance_debug);
     "width = " GST_VIDEO_SIZE_RANGE ", "                                \
     "height = " GST_VIDEO_SIZE_RANGE ", "                               \
     "framerate = " GST_VIDEO_FPS_RANGE ", "                             \
-    "texture-target = (string) { 2D, external-oes }"
+    "texture-target = (string) { 2D, external-oes }"                    \
+    " ; "                                                               \
+    GST_GL_COLOR_BALANCE_PASSTHROUGH_CAPS (GST_CAPS_FEATURE_MEMORY_GL_MEMORY) \
+    " ; "                                                               \
+    GST_GL_COLOR_BALANCE_PASSTHROUGH_CAPS (GST_CAPS_FEATURE_MEMORY_GL_MEMORY "," \
+        GST_CAPS_FEATURE_META_GST_VIDEO_OVERLAY_COMPOSITION)
 
 static GstStaticPadTemplate gst_gl_color_balance_element_src_pad_template =
 GST_STATIC_PAD_TEMPLATE ("src",
@@ -179,11 +194,13 @@ gcb_transform_internal_caps (GstGLFilter * filter,
   GstCaps *tmp = gst_caps_copy (caps);
   gint i;
   /* If we're not in passthrough mode, we can only output 2D textures,
-   * but can always receive any compatible texture.
+   * but can always receive any compatible texture. Both sides are RGBA.
    * This function is not called in passthrough mode, so we can do the
    * transform unconditionally */
   for (i = 0; i < gst_caps_get_size (tmp); i++) {
     GstStructure *outs = gst_caps_get_structure (tmp, i);
+
+    gst_structure_set (outs, "format", G_TYPE_STRING, "RGBA", NULL);
     if (direction == GST_PAD_SINK) {
       gst_structure_set (outs, "texture-target", G_TYPE_STRING,
           gst_gl_texture_target_to_string (GST_GL_TEXTURE_TARGET_2D), NULL);
@@ -214,8 +231,11 @@ gst_gl_color_balance_update_properties (GstGLColorBalance * glcolorbalance)
   current_passthrough = gst_base_transform_is_passthrough (base);
 
   gst_base_transform_set_passthrough (base, passthrough);
-  if (current_passthrough != passthrough)
+  if (current_passthrough != passthrough) {
+    /* upstream has to switch between RGBA and the passthrough formats */
+    gst_base_transform_reconfigure_sink (base);
     gst_base_transform_reconfigure_src (base);
+  }
 }
 
 static gboolean
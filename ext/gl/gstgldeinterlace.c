@@ -28,6 +28,9 @@
  * |[
  * gst-launch-1.0 videotestsrc ! glupload ! gldeinterlace ! glimagesink
  * ]|
+ * |[
+ * gst-launch-1.0 filesrc location=1080i.ts ! decodebin ! glupload ! gldeinterlace method=yadif field-rate=true ! glimagesink
+ * ]| The yadif method with field-rate output turns 1080i50 into 1080p50.
  * FBO (Frame Buffer Object) and GLSL (OpenGL Shading Language) are required.
  *
  */
@@ -46,7 +49,8 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 enum
 {
   PROP_0,
-  PROP_METHOD
+  PROP_METHOD,
+  PROP_FIELD_RATE
 };
 
 #define DEBUG_INIT \
@@ -62,6 +66,8 @@ static void gst_gl_deinterlace_get_property (GObject * object,
 
 static gboolean gst_gl_deinterlace_start (GstBaseTransform * trans);
 static gboolean gst_gl_deinterlace_reset (GstBaseTransform * trans);
+static GstFlowReturn gst_gl_deinterlace_generate_output (GstBaseTransform *
+    trans, GstBuffer ** outbuf);
 static GstCaps *gst_gl_deinterlace_transform_internal_caps (GstGLFilter *
     filter, GstPadDirection direction, GstCaps * caps, GstCaps * caps_filter);
 static gboolean gst_gl_deinterlace_init_fbo (GstGLFilter * filter);
@@ -73,6 +79,8 @@ static gboolean gst_gl_deinterlace_vfir_callback (GstGLFilter * filter,
     GstGLMemory * in_tex, gpointer stuff);
 static gboolean gst_gl_deinterlace_greedyh_callback (GstGLFilter * filter,
     GstGLMemory * in_tex, gpointer stuff);
+static gboolean gst_gl_deinterlace_yadif_callback (GstGLFilter * filter,
+    GstGLMemory * in_tex, gpointer stuff);
 
 /* *INDENT-OFF* */
 static const gchar *greedyh_fragment_source =
@@ -177,13 +185,61 @@ const gchar *vfir_fragment_source =
   "  bot_color = texture2D(tex, botcoord);\n"
   "  gl_FragColor = 0.5*cur_color + 0.25*top_color + 0.25*bot_color;\n"
   "}";
+
+/* spatial prediction along the best of three edge directions, clamped to
+ * the range allowed by the temporal neighbours as in yadif. The opposite
+ * field of the current frame stands in for the next field as there is no
+ * lookahead. */
+static const gchar *yadif_fragment_source =
+  "uniform sampler2D tex;\n"
+  "uniform sampler2D tex_prev;\n"
+  "uniform float field;\n"
+  "uniform float width;\n"
+  "uniform float height;\n"
+  "varying vec2 v_texcoord;\n"
+  "const vec3 luma = vec3 (0.299011, 0.586987, 0.114001);\n"
+
+  "vec3 fetch (sampler2D t, float dx, float dy) {\n"
+  "  return texture2D (t, v_texcoord + vec2 (dx / width, dy / height)).rgb;\n"
+  "}\n"
+
+  "float edge_score (float j) {\n"
+  "  return abs (dot (fetch (tex, j - 1.0, -1.0) - fetch (tex, -j - 1.0, 1.0), luma))\n"
+  "      + abs (dot (fetch (tex, j, -1.0) - fetch (tex, -j, 1.0), luma))\n"
+  "      + abs (dot (fetch (tex, j + 1.0, -1.0) - fetch (tex, 1.0 - j, 1.0), luma));\n"
+  "}\n"
+
+  "void main () {\n"
+  "  float line = floor (v_texcoord.y * height);\n"
+  "  if (mod (line, 2.0) == field) {\n"
+  "    gl_FragColor = vec4 (texture2D (tex, v_texcoord).rgb, 1.0);\n"
+  "  } else {\n"
+  "    vec3 c = fetch (tex, 0.0, -1.0);\n"
+  "    vec3 e = fetch (tex, 0.0, 1.0);\n"
+  "    vec3 p = fetch (tex_prev, 0.0, 0.0);\n"
+  "    vec3 n = fetch (tex, 0.0, 0.0);\n"
+  "    vec3 d = (p + n) * 0.5;\n"
+  "    vec3 diff = max (abs (p - n) * 0.5,\n"
+  "        (abs (fetch (tex_prev, 0.0, -1.0) - c) + abs (fetch (tex_prev, 0.0, 1.0) - e)) * 0.5);\n"
+  "    float score_m = edge_score (-1.0);\n"
+  "    float score_0 = edge_score (0.0);\n"
+  "    float score_p = edge_score (1.0);\n"
+  "    vec3 spatial = (c + e) * 0.5;\n"
+  "    if (score_m < score_0 && score_m <= score_p)\n"
+  "      spatial = (fetch (tex, -1.0, -1.0) + fetch (tex, 1.0, 1.0)) * 0.5;\n"
+  "    else if (score_p < score_0)\n"
+  "      spatial = (fetch (tex, 1.0, -1.0) + fetch (tex, -1.0, 1.0)) * 0.5;\n"
+  "    gl_FragColor = vec4 (clamp (spatial, d - diff, d + diff), 1.0);\n"
+  "  }\n"
+  "}\n";
 /* *INDENT-ON* */
 
 /* dont' forget to edit the following when a new method is added */
 typedef enum
 {
   GST_GL_DEINTERLACE_VFIR,
-  GST_GL_DEINTERLACE_GREEDYH
+  GST_GL_DEINTERLACE_GREEDYH,
+  GST_GL_DEINTERLACE_YADIF
 } GstGLDeinterlaceMethod;
 
 static const GEnumValue *
@@ -193,6 +249,8 @@ gst_gl_deinterlace_get_methods (void)
     {GST_GL_DEINTERLACE_VFIR, "Blur Vertical", "vfir"},
     {GST_GL_DEINTERLACE_GREEDYH, "Motion Adaptive: Advanced Detection",
         "greedyh"},
+    {GST_GL_DEINTERLACE_YADIF, "Motion Adaptive: Edge Directed Interpolation",
+        "yadif"},
     {0, NULL, NULL}
   };
   return method_types;
@@ -224,6 +282,10 @@ gst_gl_deinterlace_set_method (GstGLDeinterlace * deinterlace,
       deinterlace->deinterlacefunc = gst_gl_deinterlace_greedyh_callback;
       deinterlace->current_method = method_types;
       break;
+    case GST_GL_DEINTERLACE_YADIF:
+      deinterlace->deinterlacefunc = gst_gl_deinterlace_yadif_callback;
+      deinterlace->current_method = method_types;
+      break;
     default:
       g_assert_not_reached ();
       break;
@@ -257,8 +319,25 @@ gst_gl_deinterlace_class_init (GstGLDeinterlaceClass * klass)
           GST_TYPE_GL_DEINTERLACE_METHODS,
           GST_GL_DEINTERLACE_VFIR, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGLDeinterlace:field-rate:
+   *
+   * Output one frame per field instead of one per input frame, doubling
+   * the framerate.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_FIELD_RATE,
+      g_param_spec_boolean ("field-rate",
+          "Field Rate",
+          "Output a frame for each field, at twice the input framerate",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_BASE_TRANSFORM_CLASS (klass)->start = gst_gl_deinterlace_start;
   GST_BASE_TRANSFORM_CLASS (klass)->stop = gst_gl_deinterlace_reset;
+  GST_BASE_TRANSFORM_CLASS (klass)->generate_output =
+      gst_gl_deinterlace_generate_output;
 
   GST_GL_FILTER_CLASS (klass)->transform_internal_caps =
       gst_gl_deinterlace_transform_internal_caps;
@@ -279,6 +358,8 @@ gst_gl_deinterlace_init (GstGLDeinterlace * filter)
   filter->current_method = GST_GL_DEINTERLACE_VFIR;
   filter->prev_buffer = NULL;
   filter->prev_tex = NULL;
+  filter->pending_field = NULL;
+  filter->field_rate = FALSE;
 }
 
 static gboolean
@@ -308,6 +389,8 @@ gst_gl_deinterlace_reset (GstBaseTransform * trans)
   GstGLDeinterlace *deinterlace_filter = GST_GL_DEINTERLACE (trans);
 
   gst_buffer_replace (&deinterlace_filter->prev_buffer, NULL);
+  deinterlace_filter->prev_tex = NULL;
+  gst_buffer_replace (&deinterlace_filter->pending_field, NULL);
 
   //blocking call, wait the opengl thread has destroyed the shader
   if (deinterlace_filter->shaderstable) {
@@ -325,14 +408,59 @@ gst_gl_deinterlace_reset (GstBaseTransform * trans)
   return GST_BASE_TRANSFORM_CLASS (parent_class)->stop (trans);
 }
 
+static void
+gst_gl_deinterlace_scale_framerate (GstStructure * s, gint num, gint denom)
+{
+  const GValue *val = gst_structure_get_value (s, "framerate");
+  gint n, d;
+
+  if (!val)
+    return;
+
+  if (GST_VALUE_HOLDS_FRACTION (val)) {
+    n = gst_value_get_fraction_numerator (val);
+    d = gst_value_get_fraction_denominator (val);
+    if (n > 0 && gst_util_fraction_multiply (n, d, num, denom, &n, &d))
+      gst_structure_set (s, "framerate", GST_TYPE_FRACTION, n, d, NULL);
+    return;
+  }
+
+  if (GST_VALUE_HOLDS_FRACTION_RANGE (val)) {
+    const GValue *min = gst_value_get_fraction_range_min (val);
+    const GValue *max = gst_value_get_fraction_range_max (val);
+    gint min_n, min_d, max_n, max_d;
+
+    if (gst_util_fraction_multiply (gst_value_get_fraction_numerator (min),
+            gst_value_get_fraction_denominator (min), num, denom, &min_n,
+            &min_d)
+        && gst_util_fraction_multiply (gst_value_get_fraction_numerator (max),
+            gst_value_get_fraction_denominator (max), num, denom, &max_n,
+            &max_d)) {
+      gst_structure_set (s, "framerate", GST_TYPE_FRACTION_RANGE, min_n, min_d,
+          max_n, max_d, NULL);
+      return;
+    }
+  }
+
+  /* lists or overflows, accept anything */
+  gst_structure_set (s, "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT,
+      1, NULL);
+}
+
 static GstCaps *
 gst_gl_deinterlace_transform_internal_caps (GstGLFilter * filter,
     GstPadDirection direction, GstCaps * caps, GstCaps * caps_filter)
 {
+  GstGLDeinterlace *deinterlace_filter = GST_GL_DEINTERLACE (filter);
+  gboolean field_rate;
   gint len;
   GstCaps *res;
   GstStructure *s;
 
+  GST_OBJECT_LOCK (filter);
+  field_rate = deinterlace_filter->field_rate;
+  GST_OBJECT_UNLOCK (filter);
+
   res = gst_caps_copy (caps);
 
   for (len = gst_caps_get_size (res); len > 0; len--) {
@@ -340,6 +468,12 @@ gst_gl_deinterlace_transform_internal_caps (GstGLFilter * filter,
     if (direction == GST_PAD_SINK) {
       gst_structure_remove_field (s, "interlace-mode");
     }
+    if (field_rate) {
+      if (direction == GST_PAD_SINK)
+        gst_gl_deinterlace_scale_framerate (s, 2, 1);
+      else
+        gst_gl_deinterlace_scale_framerate (s, 1, 2);
+    }
   }
 
   return res;
@@ -355,6 +489,12 @@ gst_gl_deinterlace_set_property (GObject * object, guint prop_id,
     case PROP_METHOD:
       gst_gl_deinterlace_set_method (filter, g_value_get_enum (value));
       break;
+    case PROP_FIELD_RATE:
+      GST_OBJECT_LOCK (filter);
+      filter->field_rate = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (filter);
+      gst_base_transform_reconfigure_src (GST_BASE_TRANSFORM (filter));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -371,6 +511,11 @@ gst_gl_deinterlace_get_property (GObject * object, guint prop_id,
     case PROP_METHOD:
       g_value_set_enum (value, filter->current_method);
       break;
+    case PROP_FIELD_RATE:
+      GST_OBJECT_LOCK (filter);
+      g_value_set_boolean (value, filter->field_rate);
+      GST_OBJECT_UNLOCK (filter);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -401,14 +546,96 @@ gst_gl_deinterlace_filter (GstGLFilter * filter, GstBuffer * inbuf,
     GstBuffer * outbuf)
 {
   GstGLDeinterlace *deinterlace_filter = GST_GL_DEINTERLACE (filter);
+  gboolean field_rate;
+  gint first_field;
+
+  GST_OBJECT_LOCK (filter);
+  field_rate = deinterlace_filter->field_rate;
+  GST_OBJECT_UNLOCK (filter);
+
+  first_field = GST_BUFFER_FLAG_IS_SET (inbuf, GST_VIDEO_BUFFER_FLAG_TFF) ||
+      GST_VIDEO_INFO_FIELD_ORDER (&filter->in_info) ==
+      GST_VIDEO_FIELD_ORDER_TOP_FIELD_FIRST ? 0 : 1;
+  deinterlace_filter->field = deinterlace_filter->second_field ?
+      1 - first_field : first_field;
 
   gst_gl_filter_filter_texture (filter, inbuf, outbuf);
 
+  if (field_rate && !deinterlace_filter->second_field) {
+    /* the previous frame is still needed for the second field */
+    gst_buffer_replace (&deinterlace_filter->pending_field, inbuf);
+    return TRUE;
+  }
+
+  /* keep the previous frame around so that its texture can be used
+   * without uploading it again */
   gst_buffer_replace (&deinterlace_filter->prev_buffer, inbuf);
+  deinterlace_filter->prev_tex =
+      GST_GL_MEMORY_CAST (gst_buffer_peek_memory (inbuf, 0));
 
   return TRUE;
 }
 
+static GstFlowReturn
+gst_gl_deinterlace_generate_output (GstBaseTransform * trans,
+    GstBuffer ** outbuf)
+{
+  GstGLDeinterlace *deinterlace_filter = GST_GL_DEINTERLACE (trans);
+  GstBaseTransformClass *bclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+  GstVideoInfo *in_info = &GST_GL_FILTER (trans)->in_info;
+  GstClockTime duration;
+  GstBuffer *inbuf;
+  GstFlowReturn ret;
+
+  if (!deinterlace_filter->pending_field) {
+    ret = GST_BASE_TRANSFORM_CLASS (parent_class)->generate_output (trans,
+        outbuf);
+
+    /* the first field of a frame covers the first half of its duration */
+    if (ret == GST_FLOW_OK && *outbuf && deinterlace_filter->pending_field
+        && GST_BUFFER_DURATION_IS_VALID (*outbuf))
+      GST_BUFFER_DURATION (*outbuf) /= 2;
+
+    return ret;
+  }
+
+  inbuf = deinterlace_filter->pending_field;
+  deinterlace_filter->pending_field = NULL;
+
+  ret = bclass->prepare_output_buffer (trans, inbuf, outbuf);
+  if (ret != GST_FLOW_OK || !*outbuf)
+    goto done;
+
+  deinterlace_filter->second_field = TRUE;
+  ret = bclass->transform (trans, inbuf, *outbuf);
+  deinterlace_filter->second_field = FALSE;
+
+  if (ret != GST_FLOW_OK) {
+    gst_buffer_replace (outbuf, NULL);
+    goto done;
+  }
+
+  if (GST_BUFFER_DURATION_IS_VALID (inbuf))
+    duration = GST_BUFFER_DURATION (inbuf) / 2;
+  else if (GST_VIDEO_INFO_FPS_N (in_info) > 0)
+    duration = gst_util_uint64_scale_int (GST_SECOND,
+        GST_VIDEO_INFO_FPS_D (in_info), 2 * GST_VIDEO_INFO_FPS_N (in_info));
+  else
+    duration = GST_CLOCK_TIME_NONE;
+
+  if (GST_BUFFER_PTS_IS_VALID (inbuf) && GST_CLOCK_TIME_IS_VALID (duration))
+    GST_BUFFER_PTS (*outbuf) = GST_BUFFER_PTS (inbuf) + duration;
+  else
+    GST_BUFFER_PTS (*outbuf) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DTS (*outbuf) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DURATION (*outbuf) = duration;
+
+done:
+  gst_buffer_unref (inbuf);
+
+  return ret;
+}
+
 static GstGLShader *
 gst_gl_deinterlace_get_fragment_shader (GstGLFilter * filter,
     const gchar * shader_name, const gchar * shader_source)
@@ -535,8 +762,54 @@ gst_gl_deinterlace_greedyh_callback (GstGLFilter * filter, GstGLMemory * in_tex,
 
   gst_gl_filter_draw_fullscreen_quad (filter);
 
-  /* we keep the previous buffer around so this is safe */
-  deinterlace_filter->prev_tex = in_tex;
+  return TRUE;
+}
+
+static gboolean
+gst_gl_deinterlace_yadif_callback (GstGLFilter * filter, GstGLMemory * in_tex,
+    gpointer user_data)
+{
+  GstGLShader *shader;
+  GstGLDeinterlace *deinterlace_filter = GST_GL_DEINTERLACE (filter);
+  GstGLContext *context = GST_GL_BASE_FILTER (filter)->context;
+  GstGLFuncs *gl = context->gl_vtable;
+  GstGLMemory *prev_tex;
+
+  shader =
+      gst_gl_deinterlace_get_fragment_shader (filter, "yadif",
+      yadif_fragment_source);
+
+  if (!shader)
+    return FALSE;
+
+#if GST_GL_HAVE_OPENGL
+  if (USING_OPENGL (context)) {
+    gl->MatrixMode (GL_PROJECTION);
+    gl->LoadIdentity ();
+  }
+#endif
+
+  gst_gl_shader_use (shader);
+
+  /* without history, the current frame is its own temporal neighbour */
+  prev_tex = deinterlace_filter->prev_tex ? deinterlace_filter->prev_tex :
+      in_tex;
+
+  gl->ActiveTexture (GL_TEXTURE1);
+  gl->BindTexture (GL_TEXTURE_2D, gst_gl_memory_get_texture_id (prev_tex));
+  gst_gl_shader_set_uniform_1i (shader, "tex_prev", 1);
+
+  gl->ActiveTexture (GL_TEXTURE0);
+  gl->BindTexture (GL_TEXTURE_2D, gst_gl_memory_get_texture_id (in_tex));
+
+  gst_gl_shader_set_uniform_1i (shader, "tex", 0);
+  gst_gl_shader_set_uniform_1f (shader, "field", deinterlace_filter->field);
+  gst_gl_shader_set_uniform_1f (shader, "width",
+      GST_VIDEO_INFO_WIDTH (&filter->out_info));
+  gst_gl_shader_set_uniform_1f (shader, "height",
+      GST_VIDEO_INFO_HEIGHT (&filter->out_info));
+
+  gst_gl_filter_draw_fullscreen_quad (filter);
 
   return TRUE;
 }
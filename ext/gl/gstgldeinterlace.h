@@ -46,7 +46,14 @@ struct _GstGLDeinterlace
   GstBuffer                *prev_buffer;
   GstGLMemory *             prev_tex;
 
+  /* input whose second field still has to be output in field-rate mode */
+  GstBuffer                *pending_field;
+  gboolean                  second_field;
+  /* parity of the lines kept from the input, 0 for the top field */
+  gint                      field;
+
   gint	                    current_method;
+  gboolean                  field_rate;
 };
 
 struct _GstGLDeinterlaceClass
@@ -372,6 +372,11 @@ _try_export_dmabuf (GstGLDownloadElement * download, GstBuffer * inbuf)
   gsize total_offset;
   GstVideoAlignment *alig = NULL;
 
+  for (i = 0; i < gst_buffer_n_memory (inbuf); i++) {
+    if (!gst_is_gl_memory (gst_buffer_peek_memory (inbuf, i)))
+      return NULL;
+  }
+
   glmem = GST_GL_MEMORY_CAST (gst_buffer_peek_memory (inbuf, 0));
   if (glmem) {
     GstGLContext *context = GST_GL_BASE_MEMORY_CAST (glmem)->context;
@@ -387,6 +392,8 @@ _try_export_dmabuf (GstGLDownloadElement * download, GstBuffer * inbuf)
     struct DmabufInfo *info;
 
     glmem = GST_GL_MEMORY_CAST (gst_buffer_peek_memory (inbuf, i));
+    /* the dmabuf exported from a texture stays valid for the texture's
+     * lifetime, so pooled textures are only exported once */
     info = _get_cached_dmabuf_info (glmem);
     if (!info) {
       GstGLContext *context = GST_GL_BASE_MEMORY_CAST (glmem)->context;
@@ -417,6 +424,7 @@ _try_export_dmabuf (GstGLDownloadElement * download, GstBuffer * inbuf)
 
   src_caps = gst_pad_get_current_caps (GST_BASE_TRANSFORM (download)->srcpad);
   gst_video_info_from_caps (&out_info, src_caps);
+  gst_caps_unref (src_caps);
 
   if (download->add_videometa) {
     GstVideoMeta *meta;
@@ -466,9 +474,12 @@ gst_gl_download_element_prepare_output_buffer (GstBaseTransform * bt,
       GstGLContext *context = GST_GL_BASE_FILTER (bt)->context;
       GstGLSyncMeta *in_sync_meta;
 
+      /* the dmabuf is read outside of GL, e.g. by a hardware encoder, so
+       * the rendering has to be complete, not only queued before any
+       * later GL command */
       in_sync_meta = gst_buffer_get_gl_sync_meta (inbuf);
       if (in_sync_meta)
-        gst_gl_sync_meta_wait (in_sync_meta, context);
+        gst_gl_sync_meta_wait_cpu (in_sync_meta, context);
 
       if (GST_BASE_TRANSFORM_GET_CLASS (bt)->copy_metadata)
         if (!GST_BASE_TRANSFORM_GET_CLASS (bt)->copy_metadata (bt, inbuf,
@@ -100,6 +100,7 @@ GST_DEBUG_CATEGORY (gst_debug_glimage_sink);
 #define DEFAULT_HANDLE_EVENTS       TRUE
 #define DEFAULT_FORCE_ASPECT_RATIO  TRUE
 #define DEFAULT_IGNORE_ALPHA        TRUE
+#define DEFAULT_MOTION_COALESCE_WINDOW 0
 
 #define DEFAULT_MULTIVIEW_MODE GST_VIDEO_MULTIVIEW_MODE_MONO
 #define DEFAULT_MULTIVIEW_FLAGS GST_VIDEO_MULTIVIEW_FLAGS_NONE
@@ -123,6 +124,7 @@ enum
   PROP_BIN_OUTPUT_MULTIVIEW_LAYOUT,
   PROP_BIN_OUTPUT_MULTIVIEW_FLAGS,
   PROP_BIN_OUTPUT_MULTIVIEW_DOWNMIX_MODE,
+  PROP_BIN_MOTION_COALESCE_WINDOW,
   PROP_BIN_LAST
 };
 
@@ -265,6 +267,12 @@ gst_gl_image_sink_bin_class_init (GstGLImageSinkBinClass * klass)
           "Whether to render video frames during preroll",
           DEFAULT_SHOW_PREROLL_FRAME,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class,
+      PROP_BIN_MOTION_COALESCE_WINDOW,
+      g_param_spec_uint64 ("motion-coalesce-window", "Motion coalesce window",
+          "Minimum time between two mouse-move events (0 = no limit)",
+          0, G_MAXUINT64, DEFAULT_MOTION_COALESCE_WINDOW,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   g_object_class_install_property (gobject_class,
       PROP_BIN_OUTPUT_MULTIVIEW_LAYOUT,
@@ -359,6 +367,17 @@ static void gst_glimage_sink_handle_events (GstVideoOverlay * overlay,
     gboolean handle_events);
 static gboolean update_output_format (GstGLImageSink * glimage_sink);
 
+/* formats whose planes the redisplay shader samples directly */
+#define GST_GL_SINK_YUV_FORMATS "{ NV12, I420 }"
+
+#define GST_GL_SINK_YUV_CAPS(features) \
+    "video/x-raw(" features "), "                                       \
+    "format = (string) " GST_GL_SINK_YUV_FORMATS ", "                   \
+    "width = " GST_VIDEO_SIZE_RANGE ", "                                \
+    "height = " GST_VIDEO_SIZE_RANGE ", "                               \
+    "framerate = " GST_VIDEO_FPS_RANGE ", "                             \
+    "texture-target = (string) 2D "
+
 #define GST_GL_SINK_CAPS \
     "video/x-raw(" GST_CAPS_FEATURE_MEMORY_GL_MEMORY "), "              \
     "format = (string) RGBA, "                                          \
@@ -373,7 +392,12 @@ static gboolean update_output_format (GstGLImageSink * glimage_sink);
     "width = " GST_VIDEO_SIZE_RANGE ", "                                \
     "height = " GST_VIDEO_SIZE_RANGE ", "                               \
     "framerate = " GST_VIDEO_FPS_RANGE ", "                             \
-    "texture-target = (string) { 2D, external-oes } "
+    "texture-target = (string) { 2D, external-oes } "                   \
+    " ; "                                                               \
+    GST_GL_SINK_YUV_CAPS (GST_CAPS_FEATURE_MEMORY_GL_MEMORY)            \
+    " ; "                                                               \
+    GST_GL_SINK_YUV_CAPS (GST_CAPS_FEATURE_MEMORY_GL_MEMORY ","         \
+        GST_CAPS_FEATURE_META_GST_VIDEO_OVERLAY_COMPOSITION)
 
 static GstStaticPadTemplate gst_glimage_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
@@ -407,6 +431,61 @@ enum
 
 static guint gst_glimage_sink_signals[LAST_SIGNAL] = { 0 };
 
+/* BT. 601 and BT. 709 YUV to RGB matrices, with
+ * Y = [16..235] (of 255) and Cb/Cr = [16..240] (of 255),
+ * the ones used by glcolorconvert */
+static const gfloat from_yuv_offset[] = { -0.0625f, -0.5f, -0.5f };
+
+static const gfloat from_yuv_bt601_rcoeff[] = { 1.164f, 0.000f, 1.596f };
+static const gfloat from_yuv_bt601_gcoeff[] = { 1.164f, -0.391f, -0.813f };
+static const gfloat from_yuv_bt601_bcoeff[] = { 1.164f, 2.018f, 0.000f };
+
+static const gfloat from_yuv_bt709_rcoeff[] = { 1.164f, 0.000f, 1.787f };
+static const gfloat from_yuv_bt709_gcoeff[] = { 1.164f, -0.213f, -0.531f };
+static const gfloat from_yuv_bt709_bcoeff[] = { 1.164f, 2.112f, 0.000f };
+
+/* *INDENT-OFF* */
+static const gchar yuv_fragment_body[] =
+    "varying vec2 v_texcoord;\n"
+    "uniform sampler2D Ytex, Utex, Vtex;\n"
+    "uniform vec2 tex_scale0, tex_scale1, tex_scale2;\n"
+    "uniform vec3 offset, coeff1, coeff2, coeff3;\n"
+    "void main()\n"
+    "{\n"
+    "  vec3 yuv;\n"
+    "  yuv.x = texture2D(Ytex, v_texcoord * tex_scale0).r;\n"
+    "%s"
+    "  yuv += offset;\n"
+    "  gl_FragColor = vec4(dot(yuv, coeff1), dot(yuv, coeff2),\n"
+    "      dot(yuv, coeff3), 1.0);\n"
+    "}\n";
+
+static const gchar yuv_fragment_planar_chroma[] =
+    "  yuv.y = texture2D(Utex, v_texcoord * tex_scale1).r;\n"
+    "  yuv.z = texture2D(Vtex, v_texcoord * tex_scale2).r;\n";
+
+/* the UV plane of NV12 is either RG or LUMINANCE_ALPHA */
+static const gchar yuv_fragment_semi_planar_chroma[] =
+    "  yuv.yz = texture2D(Utex, v_texcoord * tex_scale1).%c%c;\n";
+/* *INDENT-ON* */
+
+/* whether the application draws the frames itself, in which case it
+ * expects RGBA textures */
+static gboolean
+_has_client_draw_handler (GstGLImageSink * gl_sink)
+{
+  GstElement *parent = GST_ELEMENT_PARENT (gl_sink);
+
+  if (parent && G_TYPE_CHECK_INSTANCE_TYPE (parent,
+          gst_gl_image_sink_bin_get_type ()))
+    return g_signal_handler_find (parent, G_SIGNAL_MATCH_ID,
+        gst_gl_image_sink_bin_signals[SIGNAL_BIN_CLIENT_DRAW], 0, NULL, NULL,
+        NULL) != 0;
+
+  return g_signal_handler_find (gl_sink, G_SIGNAL_MATCH_ID,
+      gst_glimage_sink_signals[CLIENT_DRAW_SIGNAL], 0, NULL, NULL, NULL) != 0;
+}
+
 static void
 _display_size_to_stream_size (GstGLImageSink * gl_sink, gdouble x,
     gdouble y, gdouble * stream_x, gdouble * stream_y)
@@ -903,6 +982,8 @@ gst_glimage_sink_key_event_cb (GstGLWindow * window, char *event_name, char
     *key_string, GstGLImageSink * gl_sink)
 {
   GST_DEBUG_OBJECT (gl_sink, "event %s key %s pressed", event_name, key_string);
+  /* keep the order of pointer motion and other events */
+  gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (gl_sink), TRUE);
   gst_navigation_send_key_event (GST_NAVIGATION (gl_sink),
       event_name, key_string);
 }
@@ -911,7 +992,13 @@ static void
 gst_glimage_sink_mouse_event_cb (GstGLWindow * window, char *event_name,
     int button, double posx, double posy, GstGLImageSink * gl_sink)
 {
+  if (g_strcmp0 (event_name, "mouse-move") == 0) {
+    gst_video_sink_send_mouse_move (GST_VIDEO_SINK (gl_sink), posx, posy);
+    return;
+  }
+
   GST_DEBUG_OBJECT (gl_sink, "event %s at %g, %g", event_name, posx, posy);
+  gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (gl_sink), TRUE);
   gst_navigation_send_mouse_event (GST_NAVIGATION (gl_sink),
       event_name, button, posx, posy);
 }
@@ -1297,6 +1384,21 @@ gst_glimage_sink_get_caps (GstBaseSink * bsink, GstCaps * filter)
 
   tmp = gst_pad_get_pad_template_caps (GST_BASE_SINK_PAD (bsink));
 
+  if (_has_client_draw_handler (GST_GLIMAGE_SINK (bsink))) {
+    GstCaps *rgba = gst_caps_new_empty ();
+    guint i;
+
+    for (i = 0; i < gst_caps_get_size (tmp); i++) {
+      GstStructure *s = gst_caps_get_structure (tmp, i);
+
+      if (g_strcmp0 (gst_structure_get_string (s, "format"), "RGBA") == 0)
+        gst_caps_append_structure_full (rgba, gst_structure_copy (s),
+            gst_caps_features_copy (gst_caps_get_features (tmp, i)));
+    }
+    gst_caps_unref (tmp);
+    tmp = rgba;
+  }
+
   if (filter) {
     GST_DEBUG_OBJECT (bsink, "intersecting with filter caps %" GST_PTR_FORMAT,
         filter);
@@ -1402,10 +1504,11 @@ update_output_format (GstGLImageSink * glimage_sink)
   GstStructure *s;
   const gchar *target_str;
   GstCaps *out_caps;
-  gboolean ret;
+  gboolean ret, previous_yuv;
 
   *out_info = glimage_sink->in_info;
   previous_target = glimage_sink->texture_target;
+  previous_yuv = glimage_sink->sample_yuv;
 
   mv_mode = GST_VIDEO_INFO_MULTIVIEW_MODE (&glimage_sink->in_info);
 
@@ -1427,6 +1530,12 @@ update_output_format (GstGLImageSink * glimage_sink)
     }
   }
 
+  glimage_sink->sample_yuv = GST_VIDEO_INFO_IS_YUV (out_info);
+  if (glimage_sink->sample_yuv && glimage_sink->convert_views) {
+    GST_ERROR_OBJECT (glimage_sink, "multiview conversion needs RGBA input");
+    return FALSE;
+  }
+
   ret = configure_display_from_info (glimage_sink, out_info);
 
   if (glimage_sink->convert_views) {
@@ -1498,8 +1607,9 @@ update_output_format (GstGLImageSink * glimage_sink)
   glimage_sink->out_caps = out_caps;
 
   if (previous_target != GST_GL_TEXTURE_TARGET_NONE &&
-      glimage_sink->texture_target != previous_target) {
-    /* regenerate the shader for the changed target */
+      (glimage_sink->texture_target != previous_target ||
+          glimage_sink->sample_yuv != previous_yuv)) {
+    /* regenerate the shader for the changed target or format */
     GstGLWindow *window = gst_gl_context_get_window (glimage_sink->context);
     gst_gl_window_send_message (window,
         GST_GL_WINDOW_CB (gst_glimage_sink_cleanup_glthread), glimage_sink);
@@ -2013,7 +2123,33 @@ gst_glimage_sink_thread_init_redisplay (GstGLImageSink * gl_sink)
       GL_VERTEX_SHADER, GST_GLSL_VERSION_NONE,
       GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY,
       gst_gl_shader_string_vertex_mat4_vertex_transform);
-  if (gl_sink->texture_target == GST_GL_TEXTURE_TARGET_EXTERNAL_OES) {
+  if (gl_sink->sample_yuv) {
+    gchar *chroma, *body, *frag_str;
+
+    if (GST_VIDEO_INFO_N_PLANES (&gl_sink->out_info) == 2) {
+      GstGLFormat uv_format = gst_gl_format_from_video_info (gl_sink->context,
+          &gl_sink->out_info, 1);
+
+      if (uv_format == GST_GL_LUMINANCE_ALPHA)
+        chroma = g_strdup_printf (yuv_fragment_semi_planar_chroma, 'r', 'a');
+      else
+        chroma = g_strdup_printf (yuv_fragment_semi_planar_chroma, 'r', 'g');
+    } else {
+      chroma = g_strdup (yuv_fragment_planar_chroma);
+    }
+    body = g_strdup_printf (yuv_fragment_body, chroma);
+    frag_str = g_strconcat (gst_gl_shader_string_get_highest_precision
+        (gl_sink->context, GST_GLSL_VERSION_NONE,
+            GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY), body, NULL);
+
+    frag_stage = gst_glsl_stage_new_with_string (gl_sink->context,
+        GL_FRAGMENT_SHADER, GST_GLSL_VERSION_NONE,
+        GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY, frag_str);
+
+    g_free (frag_str);
+    g_free (body);
+    g_free (chroma);
+  } else if (gl_sink->texture_target == GST_GL_TEXTURE_TARGET_EXTERNAL_OES) {
     gchar *frag_str;
     frag_str =
         gst_gl_shader_string_fragment_external_oes_get_default
@@ -2201,6 +2337,54 @@ gst_glimage_sink_on_resize (GstGLImageSink * gl_sink, gint width, gint height)
   GST_GLIMAGE_SINK_UNLOCK (gl_sink);
 }
 
+/* Bind the planes of the stored YUV buffer and set the conversion
+ * uniforms of the redisplay shader */
+static void
+_bind_yuv_planes (GstGLImageSink * gl_sink)
+{
+  static const gchar *samplers[] = { "Ytex", "Utex", "Vtex" };
+  static const gchar *scales[] = { "tex_scale0", "tex_scale1", "tex_scale2" };
+  const GstGLFuncs *gl = gl_sink->context->gl_vtable;
+  GstBuffer *buffer = gl_sink->stored_buffer[0];
+  guint i, n_planes;
+
+  n_planes = MIN (GST_VIDEO_INFO_N_PLANES (&gl_sink->out_info),
+      gst_buffer_n_memory (buffer));
+
+  for (i = 0; i < n_planes; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+
+    if (!gst_is_gl_memory (mem))
+      break;
+
+    gl->ActiveTexture (GL_TEXTURE0 + i);
+    gl->BindTexture (GL_TEXTURE_2D,
+        gst_gl_memory_get_texture_id ((GstGLMemory *) mem));
+    gst_gl_shader_set_uniform_1i (gl_sink->redisplay_shader, samplers[i], i);
+    gst_gl_shader_set_uniform_2fv (gl_sink->redisplay_shader, scales[i], 1,
+        ((GstGLMemory *) mem)->tex_scaling);
+  }
+
+  gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "offset", 1,
+      from_yuv_offset);
+  if (GST_VIDEO_INFO_COLORIMETRY (&gl_sink->out_info).matrix ==
+      GST_VIDEO_COLOR_MATRIX_BT709) {
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff1", 1,
+        from_yuv_bt709_rcoeff);
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff2", 1,
+        from_yuv_bt709_gcoeff);
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff3", 1,
+        from_yuv_bt709_bcoeff);
+  } else {
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff1", 1,
+        from_yuv_bt601_rcoeff);
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff2", 1,
+        from_yuv_bt601_gcoeff);
+    gst_gl_shader_set_uniform_3fv (gl_sink->redisplay_shader, "coeff3", 1,
+        from_yuv_bt601_bcoeff);
+  }
+}
+
 static void
 gst_glimage_sink_on_draw (GstGLImageSink * gl_sink)
 {
@@ -2218,6 +2402,10 @@ gst_glimage_sink_on_draw (GstGLImageSink * gl_sink)
 
   g_return_if_fail (GST_IS_GLIMAGE_SINK (gl_sink));
 
+  /* pointer motion held back by the coalescing window, the window only
+   * reports new motion */
+  gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (gl_sink), FALSE);
+
   gl = gl_sink->context->gl_vtable;
 
   GST_GLIMAGE_SINK_LOCK (gl_sink);
@@ -2292,9 +2480,13 @@ gst_glimage_sink_on_draw (GstGLImageSink * gl_sink)
       gl->BindVertexArray (gl_sink->vao);
     _bind_buffer (gl_sink);
 
-    gl->ActiveTexture (GL_TEXTURE0);
-    gl->BindTexture (gl_target, gl_sink->redisplay_texture);
-    gst_gl_shader_set_uniform_1i (gl_sink->redisplay_shader, "tex", 0);
+    if (gl_sink->sample_yuv) {
+      _bind_yuv_planes (gl_sink);
+    } else {
+      gl->ActiveTexture (GL_TEXTURE0);
+      gl->BindTexture (gl_target, gl_sink->redisplay_texture);
+      gst_gl_shader_set_uniform_1i (gl_sink->redisplay_shader, "tex", 0);
+    }
     {
       GstVideoAffineTransformationMeta *af_meta;
       gfloat matrix[16];
@@ -2318,7 +2510,16 @@ gst_glimage_sink_on_draw (GstGLImageSink * gl_sink)
 
     gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
 
-    gl->BindTexture (gl_target, 0);
+    if (gl_sink->sample_yuv) {
+      guint i;
+
+      for (i = GST_VIDEO_INFO_N_PLANES (&gl_sink->out_info); i > 0; i--) {
+        gl->ActiveTexture (GL_TEXTURE0 + i - 1);
+        gl->BindTexture (GL_TEXTURE_2D, 0);
+      }
+    } else {
+      gl->BindTexture (gl_target, 0);
+    }
     gst_gl_context_clear_shader (gl_sink->context);
 
     if (gl->GenVertexArrays)
@@ -84,6 +84,8 @@ struct _GstGLImageSink
     GstVideoInfo out_info;
     GstCaps *out_caps;
     GstGLTextureTarget texture_target;
+    /* out_info is YUV, planes are converted to RGB by the redisplay shader */
+    gboolean sample_yuv;
 
     GstGLDisplay *display;
     GstGLContext *context;
@@ -482,16 +482,20 @@ static gboolean gst_gl_video_mixer_callback (gpointer stuff);
 
 /* *INDENT-OFF* */
 
-/* fragment source */
-static const gchar *video_mixer_f_src =
-    "uniform sampler2D texture;                     \n"
-    "uniform float alpha;\n"
-    "varying vec2 v_texcoord;                            \n"
-    "void main()                                         \n"
-    "{                                                   \n"
-    "  vec4 rgba = texture2D(texture, v_texcoord);\n"
-    "  gl_FragColor = vec4(rgba.rgb, rgba.a * alpha);\n"
-    "}                                                   \n";
+/* tile vertex source, positions are transformed on the CPU so that tiles
+ * can be drawn together */
+static const gchar *video_mixer_v_src =
+    "attribute vec4 a_position;\n"
+    "attribute vec2 a_texcoord;\n"
+    "attribute vec2 a_tile;\n"
+    "varying vec2 v_texcoord;\n"
+    "varying vec2 v_tile;\n"
+    "void main()\n"
+    "{\n"
+    "   gl_Position = a_position;\n"
+    "   v_texcoord = a_texcoord;\n"
+    "   v_tile = a_tile;\n"
+    "}\n";
 
 /* checker vertex source */
 static const gchar *checker_v_src =
@@ -522,6 +526,11 @@ static const gchar *checker_f_src =
     "}\n";
 /* *INDENT-ON* */
 
+/* the most tiles, and so texture units, used by a single draw call */
+#define MAX_BATCH_TILES 8
+/* position (4), texture coordinate (2), alpha and texture unit */
+#define TILE_VERTEX_SIZE 8
+
 #define GST_TYPE_GL_VIDEO_MIXER_PAD (gst_gl_video_mixer_pad_get_type())
 #define GST_GL_VIDEO_MIXER_PAD(obj) \
         (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_GL_VIDEO_MIXER_PAD, GstGLVideoMixerPad))
@@ -562,7 +571,6 @@ struct _GstGLVideoMixerPad
   gdouble blend_constant_color_alpha;
 
   gboolean geometry_change;
-  GLuint vertex_buffer;
   gfloat m_matrix[16];
 };
 
@@ -615,6 +623,7 @@ gst_gl_video_mixer_pad_init (GstGLVideoMixerPad * pad)
   pad->m_matrix[5] = 1.0;
   pad->m_matrix[10] = 1.0;
   pad->m_matrix[15] = 1.0;
+  pad->geometry_change = TRUE;
 }
 
 static void
@@ -835,12 +844,6 @@ gst_gl_video_mixer_pad_set_property (GObject * object, guint prop_id,
   gst_object_unref (mix);
 }
 
-static void
-_del_buffer (GstGLContext * context, GLuint * pBuffer)
-{
-  context->gl_vtable->DeleteBuffers (1, pBuffer);
-}
-
 static GstPad *
 gst_gl_video_mixer_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
@@ -874,19 +877,8 @@ gst_gl_video_mixer_release_pad (GstElement * element, GstPad * p)
   gst_child_proxy_child_removed (GST_CHILD_PROXY (element), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
-  /* we call the base class first as this will remove the pad from
-   * the aggregator, thus stopping misc callbacks from being called,
-   * one of which (process_textures) will recreate the vertex_buffer
-   * if it is destroyed */
   GST_ELEMENT_CLASS (g_type_class_peek_parent (G_OBJECT_GET_CLASS (element)))
       ->release_pad (element, p);
-
-  if (pad->vertex_buffer) {
-    GstGLBaseMixer *mix = GST_GL_BASE_MIXER (element);
-    gst_gl_context_thread_add (mix->context, (GstGLContextThreadFunc)
-        _del_buffer, &pad->vertex_buffer);
-    pad->vertex_buffer = 0;
-  }
 }
 
 static void
@@ -1143,20 +1135,6 @@ _fixate_caps (GstAggregator * agg, GstCaps * caps)
   return ret;
 }
 
-static gboolean
-_reset_pad_gl (GstElement * agg, GstPad * aggpad, gpointer udata)
-{
-  const GstGLFuncs *gl = GST_GL_BASE_MIXER (agg)->context->gl_vtable;
-  GstGLVideoMixerPad *pad = GST_GL_VIDEO_MIXER_PAD (aggpad);
-
-  if (pad->vertex_buffer) {
-    gl->DeleteBuffers (1, &pad->vertex_buffer);
-    pad->vertex_buffer = 0;
-  }
-
-  return TRUE;
-}
-
 static void
 _reset_gl (GstGLContext * context, GstGLVideoMixer * video_mixer)
 {
@@ -1177,7 +1155,10 @@ _reset_gl (GstGLContext * context, GstGLVideoMixer * video_mixer)
     video_mixer->checker_vbo = 0;
   }
 
-  gst_element_foreach_sink_pad (GST_ELEMENT (video_mixer), _reset_pad_gl, NULL);
+  if (video_mixer->tiles_vbo) {
+    gl->DeleteBuffers (1, &video_mixer->tiles_vbo);
+    video_mixer->tiles_vbo = 0;
+  }
 }
 
 static void
@@ -1220,16 +1201,38 @@ _video_mixer_process_gl (GstGLContext * context, GstGLVideoMixer * video_mixer)
   GstGLMixer *mixer = GST_GL_MIXER (video_mixer);
 
   if (!video_mixer->shader) {
-    gchar *frag_str = g_strdup_printf ("%s%s",
-        gst_gl_shader_string_get_highest_precision (GST_GL_BASE_MIXER
-            (mixer)->context, GST_GLSL_VERSION_NONE,
-            GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY),
-        video_mixer_f_src);
-
-    gst_gl_context_gen_shader (GST_GL_BASE_MIXER (mixer)->context,
-        gst_gl_shader_string_vertex_mat4_vertex_transform,
-        frag_str, &video_mixer->shader);
-    g_free (frag_str);
+    const GstGLFuncs *gl = context->gl_vtable;
+    GString *frag_str = g_string_new (NULL);
+    GLint max_units = 0;
+    guint i;
+
+    gl->GetIntegerv (GL_MAX_TEXTURE_IMAGE_UNITS, &max_units);
+    video_mixer->batch_size = CLAMP (max_units, 1, MAX_BATCH_TILES);
+
+    g_string_append (frag_str,
+        gst_gl_shader_string_get_highest_precision (context,
+            GST_GLSL_VERSION_NONE,
+            GST_GLSL_PROFILE_ES | GST_GLSL_PROFILE_COMPATIBILITY));
+    for (i = 0; i < video_mixer->batch_size; i++)
+      g_string_append_printf (frag_str, "uniform sampler2D tex%u;\n", i);
+    g_string_append (frag_str, "varying vec2 v_texcoord;\n"
+        "varying vec2 v_tile;\n"
+        "void main()\n"
+        "{\n"
+        "  vec4 rgba;\n");
+    /* GLSL ES 1.0 can't index samplers dynamically */
+    for (i = 0; i + 1 < video_mixer->batch_size; i++)
+      g_string_append_printf (frag_str, "  %sif (v_tile.y < %u.5)\n"
+          "    rgba = texture2D(tex%u, v_texcoord);\n", i ? "else " : "", i,
+          i);
+    g_string_append_printf (frag_str, "  %s\n"
+        "    rgba = texture2D(tex%u, v_texcoord);\n"
+        "  gl_FragColor = vec4(rgba.rgb, rgba.a * v_tile.x);\n"
+        "}\n", i ? "else" : "", i);
+
+    gst_gl_context_gen_shader (context, video_mixer_v_src, frag_str->str,
+        &video_mixer->shader);
+    g_string_free (frag_str, TRUE);
   }
 
   gst_gl_framebuffer_draw_to_texture (mixer->fbo, video_mixer->out_tex,
@@ -1252,16 +1255,26 @@ gst_gl_video_mixer_process_textures (GstGLMixer * mix, GstGLMemory * out_tex)
 
 static const GLushort indices[] = { 0, 1, 2, 0, 2, 3 };
 
+/* the indices of MAX_BATCH_TILES quads, the first one is also used for the
+ * background */
 static void
 _init_vbo_indices (GstGLVideoMixer * mixer)
 {
   const GstGLFuncs *gl = GST_GL_BASE_MIXER (mixer)->context->gl_vtable;
 
   if (!mixer->vbo_indices) {
+    GLushort batch_indices[MAX_BATCH_TILES * G_N_ELEMENTS (indices)];
+    guint i, j;
+
+    for (i = 0; i < MAX_BATCH_TILES; i++) {
+      for (j = 0; j < G_N_ELEMENTS (indices); j++)
+        batch_indices[i * G_N_ELEMENTS (indices) + j] = i * 4 + indices[j];
+    }
+
     gl->GenBuffers (1, &mixer->vbo_indices);
     gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, mixer->vbo_indices);
-    gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (indices), indices,
-        GL_STATIC_DRAW);
+    gl->BufferData (GL_ELEMENT_ARRAY_BUFFER, sizeof (batch_indices),
+        batch_indices, GL_STATIC_DRAW);
   }
 }
 
@@ -1475,7 +1488,86 @@ _set_blend_state (GstGLVideoMixer * video_mixer, GstGLVideoMixerPad * mix_pad)
   return TRUE;
 }
 
-/* opengl scene, params: input texture (not the output mixer->texture) */
+static gboolean
+_blend_state_equal (GstGLVideoMixerPad * a, GstGLVideoMixerPad * b)
+{
+  return a->blend_equation_rgb == b->blend_equation_rgb
+      && a->blend_equation_alpha == b->blend_equation_alpha
+      && a->blend_function_src_rgb == b->blend_function_src_rgb
+      && a->blend_function_src_alpha == b->blend_function_src_alpha
+      && a->blend_function_dst_rgb == b->blend_function_dst_rgb
+      && a->blend_function_dst_alpha == b->blend_function_dst_alpha
+      && a->blend_constant_color_red == b->blend_constant_color_red
+      && a->blend_constant_color_green == b->blend_constant_color_green
+      && a->blend_constant_color_blue == b->blend_constant_color_blue
+      && a->blend_constant_color_alpha == b->blend_constant_color_alpha;
+}
+
+struct tile_batch
+{
+  guint n_tiles;
+  guint textures[MAX_BATCH_TILES];
+  gfloat vertices[MAX_BATCH_TILES * 4 * TILE_VERTEX_SIZE];
+};
+
+static void
+_add_tile (struct tile_batch *batch, guint tex, const gfloat * matrix,
+    gfloat alpha)
+{
+  /* *INDENT-OFF* */
+  static const gfloat quad[] = {
+    -1.0,-1.0, 0.0f, 0.0f,
+     1.0,-1.0, 1.0f, 0.0f,
+     1.0, 1.0, 1.0f, 1.0f,
+    -1.0, 1.0, 0.0f, 1.0f,
+  };
+  /* *INDENT-ON* */
+  gfloat *v = &batch->vertices[batch->n_tiles * 4 * TILE_VERTEX_SIZE];
+  guint i, j;
+
+  for (i = 0; i < 4; i++, v += TILE_VERTEX_SIZE) {
+    /* the transformation the tile shader applied to (x, y, 0, 1) */
+    for (j = 0; j < 4; j++)
+      v[j] = matrix[j] * quad[i * 4] + matrix[4 + j] * quad[i * 4 + 1]
+          + matrix[12 + j];
+    v[4] = quad[i * 4 + 2];
+    v[5] = quad[i * 4 + 3];
+    v[6] = alpha;
+    v[7] = batch->n_tiles;
+  }
+
+  batch->textures[batch->n_tiles++] = tex;
+}
+
+static void
+_draw_batch (GstGLVideoMixer * video_mixer, struct tile_batch *batch)
+{
+  const GstGLFuncs *gl = GST_GL_BASE_MIXER (video_mixer)->context->gl_vtable;
+  guint i;
+
+  if (batch->n_tiles == 0)
+    return;
+
+  for (i = 0; i < batch->n_tiles; i++) {
+    gl->ActiveTexture (GL_TEXTURE0 + i);
+    gl->BindTexture (GL_TEXTURE_2D, batch->textures[i]);
+  }
+
+  gl->BufferData (GL_ARRAY_BUFFER,
+      batch->n_tiles * 4 * TILE_VERTEX_SIZE * sizeof (GLfloat),
+      batch->vertices, GL_STREAM_DRAW);
+  gl->DrawElements (GL_TRIANGLES, batch->n_tiles * 6, GL_UNSIGNED_SHORT, 0);
+
+  GST_TRACE_OBJECT (video_mixer, "drew %u tiles", batch->n_tiles);
+  batch->n_tiles = 0;
+}
+
+/* opengl scene, params: input texture (not the output mixer->texture)
+ *
+ * Consecutive pads with the same blend state are drawn together with a
+ * single draw call, each tile sampling from its own texture unit. As
+ * primitives are blended in order this gives the same result as drawing
+ * each pad on its own. */
 static gboolean
 gst_gl_video_mixer_callback (gpointer stuff)
 {
@@ -1483,10 +1575,14 @@ gst_gl_video_mixer_callback (gpointer stuff)
   GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (stuff);
   GstGLMixer *mixer = GST_GL_MIXER (video_mixer);
   GstGLFuncs *gl = GST_GL_BASE_MIXER (mixer)->context->gl_vtable;
+  GstGLVideoMixerPad *batch_pad = NULL;
+  struct tile_batch batch;
   GLint attr_position_loc = 0;
   GLint attr_texture_loc = 0;
+  GLint attr_tile_loc = 0;
   guint out_width, out_height;
   GList *walk;
+  guint i;
 
   out_width = GST_VIDEO_INFO_WIDTH (&vagg->info);
   out_height = GST_VIDEO_INFO_HEIGHT (&vagg->info);
@@ -1512,9 +1608,39 @@ gst_gl_video_mixer_callback (gpointer stuff)
       gst_gl_shader_get_attribute_location (video_mixer->shader, "a_position");
   attr_texture_loc =
       gst_gl_shader_get_attribute_location (video_mixer->shader, "a_texcoord");
+  attr_tile_loc =
+      gst_gl_shader_get_attribute_location (video_mixer->shader, "a_tile");
+
+  for (i = 0; i < video_mixer->batch_size; i++) {
+    gchar *name = g_strdup_printf ("tex%u", i);
+    gst_gl_shader_set_uniform_1i (video_mixer->shader, name, i);
+    g_free (name);
+  }
+
+  _init_vbo_indices (video_mixer);
+
+  if (!video_mixer->tiles_vbo)
+    gl->GenBuffers (1, &video_mixer->tiles_vbo);
+  gl->BindBuffer (GL_ARRAY_BUFFER, video_mixer->tiles_vbo);
+  gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, video_mixer->vbo_indices);
+
+  gl->EnableVertexAttribArray (attr_position_loc);
+  gl->EnableVertexAttribArray (attr_texture_loc);
+  gl->EnableVertexAttribArray (attr_tile_loc);
+
+  gl->VertexAttribPointer (attr_position_loc, 4, GL_FLOAT,
+      GL_FALSE, TILE_VERTEX_SIZE * sizeof (GLfloat), (void *) 0);
+  gl->VertexAttribPointer (attr_texture_loc, 2, GL_FLOAT,
+      GL_FALSE, TILE_VERTEX_SIZE * sizeof (GLfloat),
+      (void *) (4 * sizeof (GLfloat)));
+  gl->VertexAttribPointer (attr_tile_loc, 2, GL_FLOAT,
+      GL_FALSE, TILE_VERTEX_SIZE * sizeof (GLfloat),
+      (void *) (6 * sizeof (GLfloat)));
 
   gl->Enable (GL_BLEND);
 
+  batch.n_tiles = 0;
+
   GST_OBJECT_LOCK (video_mixer);
   walk = GST_ELEMENT (video_mixer)->sinkpads;
   while (walk) {
@@ -1525,15 +1651,6 @@ gst_gl_video_mixer_callback (gpointer stuff)
     guint in_tex;
     guint in_width, in_height;
 
-    /* *INDENT-OFF* */
-    gfloat v_vertices[] = {
-      -1.0,-1.0, 0.0f, 0.0f, 0.0f,
-       1.0,-1.0, 0.0f, 1.0f, 0.0f,
-       1.0, 1.0, 0.0f, 1.0f, 1.0f,
-      -1.0, 1.0, 0.0f, 0.0f, 1.0f,
-    };
-    /* *INDENT-ON* */
-
     v_info = &GST_VIDEO_AGGREGATOR_PAD (pad)->info;
     in_width = GST_VIDEO_INFO_WIDTH (v_info);
     in_height = GST_VIDEO_INFO_HEIGHT (v_info);
@@ -1546,18 +1663,24 @@ gst_gl_video_mixer_callback (gpointer stuff)
       continue;
     }
 
-    if (!_set_blend_state (video_mixer, pad)) {
-      GST_FIXME_OBJECT (pad, "skipping due to incorrect blend parameters");
-      walk = g_list_next (walk);
-      continue;
+    if (!batch_pad || batch.n_tiles == video_mixer->batch_size
+        || !_blend_state_equal (batch_pad, pad)) {
+      _draw_batch (video_mixer, &batch);
+
+      if (!batch_pad || !_blend_state_equal (batch_pad, pad)) {
+        if (!_set_blend_state (video_mixer, pad)) {
+          GST_FIXME_OBJECT (pad, "skipping due to incorrect blend parameters");
+          batch_pad = NULL;
+          walk = g_list_next (walk);
+          continue;
+        }
+        batch_pad = pad;
+      }
     }
 
     in_tex = mix_pad->current_texture;
 
-    _init_vbo_indices (video_mixer);
-
-    if (video_mixer->output_geo_change
-        || pad->geometry_change || !pad->vertex_buffer) {
+    if (video_mixer->output_geo_change || pad->geometry_change) {
       gint pad_width, pad_height;
       gfloat w, h;
 
@@ -1579,23 +1702,8 @@ gst_gl_video_mixer_callback (gpointer stuff)
           "alpha:%f", in_tex, in_width, in_height, pad->m_matrix[12],
           pad->m_matrix[13], pad->m_matrix[0], pad->m_matrix[5], pad->alpha);
 
-      if (!pad->vertex_buffer)
-        gl->GenBuffers (1, &pad->vertex_buffer);
-
-      gl->BindBuffer (GL_ARRAY_BUFFER, pad->vertex_buffer);
-      gl->BufferData (GL_ARRAY_BUFFER, 4 * 5 * sizeof (GLfloat), v_vertices,
-          GL_STATIC_DRAW);
-
       pad->geometry_change = FALSE;
-    } else {
-      gl->BindBuffer (GL_ARRAY_BUFFER, pad->vertex_buffer);
     }
-    gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, video_mixer->vbo_indices);
-
-    gl->ActiveTexture (GL_TEXTURE0);
-    gl->BindTexture (GL_TEXTURE_2D, in_tex);
-    gst_gl_shader_set_uniform_1i (video_mixer->shader, "texture", 0);
-    gst_gl_shader_set_uniform_1f (video_mixer->shader, "alpha", pad->alpha);
 
     {
       GstVideoAffineTransformationMeta *af_meta;
@@ -1607,24 +1715,15 @@ gst_gl_video_mixer_callback (gpointer stuff)
       af_meta = gst_buffer_get_video_affine_transformation_meta (buffer);
       gst_gl_get_affine_transformation_meta_as_ndc_ext (af_meta, af_matrix);
       gst_gl_multiply_matrix4 (af_matrix, pad->m_matrix, matrix);
-      gst_gl_shader_set_uniform_matrix_4fv (video_mixer->shader,
-          "u_transformation", 1, FALSE, matrix);
-    }
-
-    gl->EnableVertexAttribArray (attr_position_loc);
-    gl->EnableVertexAttribArray (attr_texture_loc);
-
-    gl->VertexAttribPointer (attr_position_loc, 3, GL_FLOAT,
-        GL_FALSE, 5 * sizeof (GLfloat), (void *) 0);
 
-    gl->VertexAttribPointer (attr_texture_loc, 2, GL_FLOAT,
-        GL_FALSE, 5 * sizeof (GLfloat), (void *) (3 * sizeof (GLfloat)));
-
-    gl->DrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0);
+      _add_tile (&batch, in_tex, matrix, pad->alpha);
+    }
 
     walk = g_list_next (walk);
   }
 
+  _draw_batch (video_mixer, &batch);
+
   video_mixer->output_geo_change = FALSE;
   GST_OBJECT_UNLOCK (video_mixer);
 
@@ -1633,9 +1732,14 @@ gst_gl_video_mixer_callback (gpointer stuff)
   } else {
     gl->DisableVertexAttribArray (attr_position_loc);
     gl->DisableVertexAttribArray (attr_texture_loc);
+    gl->DisableVertexAttribArray (attr_tile_loc);
 
     gl->BindBuffer (GL_ELEMENT_ARRAY_BUFFER, 0);
     gl->BindBuffer (GL_ARRAY_BUFFER, 0);
+  }
+
+  for (i = video_mixer->batch_size; i > 0; i--) {
+    gl->ActiveTexture (GL_TEXTURE0 + i - 1);
     gl->BindTexture (GL_TEXTURE_2D, 0);
   }
 
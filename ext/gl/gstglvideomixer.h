@@ -125,6 +125,8 @@ struct _GstGLVideoMixer
     GLuint vao;
     GLuint vbo_indices;
     GLuint checker_vbo;
+    GLuint tiles_vbo;
+    guint batch_size;
     GstGLMemory *out_tex;
 
     gboolean output_geo_change;
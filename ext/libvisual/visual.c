@@ -24,12 +24,11 @@
 
 #include "visual.h"
 
+#include <string.h>
+
 GST_DEBUG_CATEGORY_EXTERN (libvisual_debug);
 #define GST_CAT_DEFAULT (libvisual_debug)
 
-/* amounf of samples before we can feed libvisual */
-#define VISUAL_SAMPLES  512
-
 #if G_BYTE_ORDER == G_BIG_ENDIAN
 #define RGB_ORDER_CAPS "xRGB, RGB"
 #else
@@ -122,12 +121,89 @@ gst_visual_class_init (gpointer g_class, gpointer class_data)
 static void
 gst_visual_init (GstVisual * visual)
 {
-  /* do nothing */
+  g_mutex_init (&visual->render_lock);
+  g_cond_init (&visual->render_cond);
+}
+
+/* runs the actor on the newest audio handed over by gst_visual_render() */
+static gpointer
+gst_visual_render_loop (GstVisual * visual)
+{
+  guint16 ldata[VISUAL_SAMPLES], rdata[VISUAL_SAMPLES];
+  VisBuffer *lbuf, *rbuf;
+  guint8 *tmp;
+
+  g_mutex_lock (&visual->render_lock);
+  while (TRUE) {
+    while (visual->render_running && !visual->audio_pending)
+      g_cond_wait (&visual->render_cond, &visual->render_lock);
+    if (!visual->render_running)
+      break;
+
+    memcpy (ldata, visual->ldata, sizeof (ldata));
+    memcpy (rdata, visual->rdata, sizeof (rdata));
+    visual->audio_pending = FALSE;
+    g_mutex_unlock (&visual->render_lock);
+
+    lbuf = visual_buffer_new_with_buffer (ldata, sizeof (ldata), NULL);
+    rbuf = visual_buffer_new_with_buffer (rdata, sizeof (rdata), NULL);
+
+    visual_audio_samplepool_input_channel (visual->audio->samplepool,
+        lbuf,
+        visual->vrate, VISUAL_AUDIO_SAMPLE_FORMAT_S16,
+        (char *) VISUAL_AUDIO_CHANNEL_LEFT);
+    visual_audio_samplepool_input_channel (visual->audio->samplepool, rbuf,
+        visual->vrate, VISUAL_AUDIO_SAMPLE_FORMAT_S16,
+        (char *) VISUAL_AUDIO_CHANNEL_RIGHT);
+
+    visual_object_unref (VISUAL_OBJECT (lbuf));
+    visual_object_unref (VISUAL_OBJECT (rbuf));
+
+    visual_video_set_buffer (visual->video, visual->back);
+    visual_audio_analyze (visual->audio);
+    visual_actor_run (visual->actor, visual->audio);
+    visual_video_set_buffer (visual->video, NULL);
+
+    GST_DEBUG_OBJECT (visual, "rendered one frame");
+
+    g_mutex_lock (&visual->render_lock);
+    tmp = visual->front;
+    visual->front = visual->back;
+    visual->back = tmp;
+    visual->have_front = TRUE;
+    g_cond_broadcast (&visual->render_cond);
+  }
+  g_mutex_unlock (&visual->render_lock);
+
+  return NULL;
+}
+
+static void
+gst_visual_stop_render_thread (GstVisual * visual)
+{
+  if (visual->render_thread) {
+    g_mutex_lock (&visual->render_lock);
+    visual->render_running = FALSE;
+    g_cond_broadcast (&visual->render_cond);
+    g_mutex_unlock (&visual->render_lock);
+
+    g_thread_join (visual->render_thread);
+    visual->render_thread = NULL;
+  }
+
+  g_free (visual->front);
+  visual->front = NULL;
+  g_free (visual->back);
+  visual->back = NULL;
+  visual->have_front = FALSE;
+  visual->audio_pending = FALSE;
 }
 
 static void
 gst_visual_clear_actors (GstVisual * visual)
 {
+  gst_visual_stop_render_thread (visual);
+
   if (visual->actor) {
     visual_object_unref (VISUAL_OBJECT (visual->actor));
     visual->actor = NULL;
@@ -149,6 +225,9 @@ gst_visual_finalize (GObject * object)
 
   gst_visual_clear_actors (visual);
 
+  g_mutex_clear (&visual->render_lock);
+  g_cond_clear (&visual->render_cond);
+
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
 
@@ -156,10 +235,36 @@ static gboolean
 gst_visual_setup (GstAudioVisualizer * bscope)
 {
   GstVisual *visual = GST_VISUAL (bscope);
-  gint depth;
+  gint depth, height;
 
   gst_visual_clear_actors (visual);
 
+  switch (bscope->ainfo.rate) {
+    case 8000:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_8000;
+      break;
+    case 11250:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_11250;
+      break;
+    case 22500:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_22500;
+      break;
+    case 32000:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_32000;
+      break;
+    case 44100:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_44100;
+      break;
+    case 48000:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_48000;
+      break;
+    case 96000:
+      visual->vrate = VISUAL_AUDIO_SAMPLE_RATE_96000;
+      break;
+    default:
+      goto unsupported_rate;
+  }
+
   /* FIXME: we need to know how many bits we actually have in memory */
   depth = bscope->vinfo.finfo->pixel_stride[0];
   if (bscope->vinfo.finfo->bits >= 8) {
@@ -190,8 +295,25 @@ gst_visual_setup (GstAudioVisualizer * bscope)
       GST_VIDEO_INFO_WIDTH (&bscope->vinfo),
       GST_VIDEO_INFO_HEIGHT (&bscope->vinfo), visual->video->bpp, depth);
 
+  /* the actor draws into our own frames, copied into the output buffers once
+   * they are finished */
+  height = GST_VIDEO_INFO_HEIGHT (&bscope->vinfo);
+  visual->pitch = GST_VIDEO_INFO_WIDTH (&bscope->vinfo) * visual->video->bpp;
+  visual_video_set_pitch (visual->video, visual->pitch);
+  visual->front = g_malloc0 (visual->pitch * height);
+  visual->back = g_malloc0 (visual->pitch * height);
+
+  visual->render_running = TRUE;
+  visual->render_thread = g_thread_new ("visual-render",
+      (GThreadFunc) gst_visual_render_loop, visual);
+
   return TRUE;
   /* ERRORS */
+unsupported_rate:
+  {
+    GST_ERROR_OBJECT (visual, "unsupported rate %d", bscope->ainfo.rate);
+    return FALSE;
+  }
 no_actors:
   {
     GST_ELEMENT_ERROR (visual, LIBRARY, INIT, (NULL),
@@ -215,86 +337,48 @@ gst_visual_render (GstAudioVisualizer * bscope, GstBuffer * audio,
   GstVisual *visual = GST_VISUAL (bscope);
   GstMapInfo amap;
   const guint16 *adata;
-  gint i, channels;
-  gboolean res = TRUE;
-  VisBuffer *lbuf, *rbuf;
-  guint16 ldata[VISUAL_SAMPLES], rdata[VISUAL_SAMPLES];
-  VisAudioSampleRateType vrate;
-
-  visual_video_set_buffer (visual->video, GST_VIDEO_FRAME_PLANE_DATA (video,
-          0));
-  visual_video_set_pitch (visual->video, GST_VIDEO_FRAME_PLANE_STRIDE (video,
-          0));
+  gint i, channels, height, stride;
+  guint8 *dest;
 
   channels = GST_AUDIO_INFO_CHANNELS (&bscope->ainfo);
 
   gst_buffer_map (audio, &amap, GST_MAP_READ);
   adata = (const guint16 *) amap.data;
 
-  lbuf = visual_buffer_new_with_buffer (ldata, sizeof (ldata), NULL);
-  rbuf = visual_buffer_new_with_buffer (rdata, sizeof (rdata), NULL);
-
+  /* hand the newest audio to the render thread. Audio it did not get to yet
+   * is replaced, so a slow actor skips frames instead of holding up the
+   * streaming thread */
+  g_mutex_lock (&visual->render_lock);
   if (channels == 2) {
     for (i = 0; i < VISUAL_SAMPLES; i++) {
-      ldata[i] = *adata++;
-      rdata[i] = *adata++;
+      visual->ldata[i] = *adata++;
+      visual->rdata[i] = *adata++;
     }
   } else {
     for (i = 0; i < VISUAL_SAMPLES; i++) {
-      ldata[i] = *adata;
-      rdata[i] = *adata++;
+      visual->ldata[i] = *adata;
+      visual->rdata[i] = *adata++;
     }
   }
+  visual->audio_pending = TRUE;
+  g_cond_broadcast (&visual->render_cond);
 
-  /* TODO(ensonic): move to setup */
-  switch (bscope->ainfo.rate) {
-    case 8000:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_8000;
-      break;
-    case 11250:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_11250;
-      break;
-    case 22500:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_22500;
-      break;
-    case 32000:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_32000;
-      break;
-    case 44100:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_44100;
-      break;
-    case 48000:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_48000;
-      break;
-    case 96000:
-      vrate = VISUAL_AUDIO_SAMPLE_RATE_96000;
-      break;
-    default:
-      visual_object_unref (VISUAL_OBJECT (lbuf));
-      visual_object_unref (VISUAL_OBJECT (rbuf));
-      GST_ERROR_OBJECT (visual, "unsupported rate %d", bscope->ainfo.rate);
-      res = FALSE;
-      goto done;
-  }
-
-  visual_audio_samplepool_input_channel (visual->audio->samplepool,
-      lbuf,
-      vrate, VISUAL_AUDIO_SAMPLE_FORMAT_S16,
-      (char *) VISUAL_AUDIO_CHANNEL_LEFT);
-  visual_audio_samplepool_input_channel (visual->audio->samplepool, rbuf,
-      vrate, VISUAL_AUDIO_SAMPLE_FORMAT_S16,
-      (char *) VISUAL_AUDIO_CHANNEL_RIGHT);
+  /* only the very first frame waits for the actor */
+  while (!visual->have_front && visual->render_running)
+    g_cond_wait (&visual->render_cond, &visual->render_lock);
 
-  visual_object_unref (VISUAL_OBJECT (lbuf));
-  visual_object_unref (VISUAL_OBJECT (rbuf));
+  if (visual->have_front) {
+    height = GST_VIDEO_FRAME_HEIGHT (video);
+    stride = GST_VIDEO_FRAME_PLANE_STRIDE (video, 0);
+    dest = GST_VIDEO_FRAME_PLANE_DATA (video, 0);
 
-  visual_audio_analyze (visual->audio);
-  visual_actor_run (visual->actor, visual->audio);
-  visual_video_set_buffer (visual->video, NULL);
+    for (i = 0; i < height; i++)
+      memcpy (dest + i * stride, visual->front + i * visual->pitch,
+          visual->pitch);
+  }
+  g_mutex_unlock (&visual->render_lock);
 
-  GST_DEBUG_OBJECT (visual, "rendered one frame");
-done:
   gst_buffer_unmap (audio, &amap);
 
-  return res;
+  return TRUE;
 }
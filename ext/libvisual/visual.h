@@ -39,6 +39,9 @@ G_BEGIN_DECLS
 #define GST_VISUAL_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_VISUAL,GstVisualClass))
 #define GST_VISUAL_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_VISUAL, GstVisualClass))
 
+/* amounf of samples before we can feed libvisual */
+#define VISUAL_SAMPLES  512
+
 typedef struct _GstVisual GstVisual;
 typedef struct _GstVisualClass GstVisualClass;
 
@@ -50,6 +53,24 @@ struct _GstVisual
   VisAudio *audio;
   VisVideo *video;
   VisActor *actor;
+  VisAudioSampleRateType vrate;
+
+  /* the actor runs in its own thread, protected by render_lock */
+  GThread *render_thread;
+  GMutex render_lock;
+  GCond render_cond;
+  gboolean render_running;
+
+  /* newest audio, not picked up by the render thread yet */
+  gboolean audio_pending;
+  guint16 ldata[VISUAL_SAMPLES];
+  guint16 rdata[VISUAL_SAMPLES];
+
+  /* the actor draws into back, front holds the last finished frame */
+  guint8 *front;
+  guint8 *back;
+  gboolean have_front;
+  gint pitch;
 };
 
 struct _GstVisualClass
@@ -47,6 +47,8 @@
 #include "gstoggdemux.h"
 
 #define CHUNKSIZE (8500)        /* this is out of vorbisfile */
+/* bisecting only needs a few pages per seek, this is plenty */
+#define MAX_SEEK_POINTS (4096)
 
 /* we hope we get a granpos within this many bytes off the end */
 #define DURATION_CHUNK_OFFSET (128*1024)
@@ -275,7 +277,10 @@ gst_ogg_pad_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
       if (format != GST_FORMAT_TIME)
         goto wrong_format;
 
-      if (ogg->total_time != -1) {
+      if (!ogg->chains_complete && ogg->estimated_time != -1) {
+        /* later chains are not known yet, use the estimate */
+        total_time = ogg->estimated_time;
+      } else if (ogg->total_time != -1) {
         /* we can return the total length */
         total_time = ogg->total_time;
       } else {
@@ -2128,6 +2133,7 @@ gst_ogg_chain_new (GstOggDemux * ogg)
   chain->bytes = -1;
   chain->have_bos = FALSE;
   chain->streams = g_array_new (FALSE, TRUE, sizeof (GstOggPad *));
+  chain->seek_points = g_array_new (FALSE, FALSE, sizeof (GstOggSeekPoint));
   chain->begin_time = GST_CLOCK_TIME_NONE;
   chain->segment_start = GST_CLOCK_TIME_NONE;
   chain->segment_stop = GST_CLOCK_TIME_NONE;
@@ -2147,6 +2153,7 @@ gst_ogg_chain_free (GstOggChain * chain)
     gst_object_unref (pad);
   }
   g_array_free (chain->streams, TRUE);
+  g_array_free (chain->seek_points, TRUE);
   g_slice_free (GstOggChain, chain);
 }
 
@@ -2277,6 +2284,7 @@ static GstFlowReturn gst_ogg_demux_read_chain (GstOggDemux * ogg,
     GstOggChain ** chain);
 static GstFlowReturn gst_ogg_demux_read_end_chain (GstOggDemux * ogg,
     GstOggChain * chain);
+static GstFlowReturn gst_ogg_demux_discover_next_chain (GstOggDemux * ogg);
 
 static gboolean gst_ogg_demux_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
@@ -2339,6 +2347,8 @@ gst_ogg_demux_init (GstOggDemux * ogg)
   g_cond_init (&ogg->thread_started_cond);
 
   ogg->chains = g_array_new (FALSE, TRUE, sizeof (GstOggChain *));
+  ogg->chains_complete = TRUE;
+  ogg->estimated_time = -1;
 
   ogg->stats_nbisections = 0;
   ogg->stats_bisection_steps[0] = 0;
@@ -3090,6 +3100,83 @@ gst_ogg_demux_activate_chain (GstOggDemux * ogg, GstOggChain * chain,
   return TRUE;
 }
 
+/* returns the index of the first seek point at or after @time */
+static guint
+gst_ogg_chain_find_seek_point (GstOggChain * chain, GstClockTime time)
+{
+  guint lo = 0, hi = chain->seek_points->len;
+
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (chain->seek_points, GstOggSeekPoint, mid).time < time)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+static void
+gst_ogg_chain_add_seek_point (GstOggChain * chain, gint64 offset,
+    gint64 next_offset, GstClockTime time)
+{
+  GstOggSeekPoint point = { offset, next_offset, time };
+  guint idx, i;
+
+  if (chain->seek_points->len >= MAX_SEEK_POINTS)
+    return;
+
+  idx = gst_ogg_chain_find_seek_point (chain, time);
+
+  /* pages with the same time are next to each other */
+  for (i = idx; i < chain->seek_points->len; i++) {
+    GstOggSeekPoint *p = &g_array_index (chain->seek_points,
+        GstOggSeekPoint, i);
+
+    if (p->time != time)
+      break;
+    if (p->offset == offset)
+      return;
+  }
+
+  g_array_insert_val (chain->seek_points, idx, point);
+}
+
+/* Use the pages seen in earlier searches to shrink the range to bisect */
+static void
+gst_ogg_chain_narrow_search (GstOggChain * chain, gint64 target,
+    gint64 * begin, gint64 * end, gint64 * begintime, gint64 * endtime,
+    gint64 * best)
+{
+  GstOggSeekPoint *p;
+  guint idx;
+
+  idx = gst_ogg_chain_find_seek_point (chain, target);
+
+  /* the last page before the target */
+  if (idx > 0) {
+    p = &g_array_index (chain->seek_points, GstOggSeekPoint, idx - 1);
+    if (p->next_offset > *begin && p->next_offset <= *end
+        && (gint64) p->time >= *begintime) {
+      *best = p->offset;
+      *begin = p->next_offset;
+      *begintime = p->time;
+    }
+  }
+
+  /* the first page at or after it */
+  if (idx < chain->seek_points->len) {
+    p = &g_array_index (chain->seek_points, GstOggSeekPoint, idx);
+    if (p->offset >= *begin && p->offset < *end
+        && (gint64) p->time <= *endtime) {
+      *end = p->offset;
+      *endtime = p->time;
+    }
+  }
+}
+
 static gboolean
 do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
     gint64 end, gint64 begintime, gint64 endtime, gint64 target,
@@ -3101,6 +3188,13 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
 
   best = begin;
 
+  /* the pages seen are those of all streams, so they only help when
+   * looking at all streams. Repeating a seek to the same target then only
+   * reads the page found the last time */
+  if (!only_serial_no)
+    gst_ogg_chain_narrow_search (chain, target, &begin, &end, &begintime,
+        &endtime, &best);
+
   GST_DEBUG_OBJECT (ogg,
       "chain offset %" G_GINT64_FORMAT ", end offset %" G_GINT64_FORMAT,
       begin, end);
@@ -3194,6 +3288,8 @@ do_binary_search (GstOggDemux * ogg, GstOggChain * chain, gint64 begin,
             "found page with granule %" G_GINT64_FORMAT " and time %"
             GST_TIME_FORMAT, granulepos, GST_TIME_ARGS (granuletime));
 
+        gst_ogg_chain_add_seek_point (chain, result, ogg->offset, granuletime);
+
         if (granuletime < target) {
           best = result;        /* raw offset of packet with granulepos */
           begin = ogg->offset;  /* raw offset of next page */
@@ -3297,6 +3393,13 @@ gst_ogg_demux_do_seek (GstOggDemux * ogg, GstSegment * segment,
 
   position = segment->position;
 
+  /* make sure we know the chain containing the position */
+  while (!ogg->chains_complete && position >= ogg->total_time) {
+    ret = gst_ogg_demux_discover_next_chain (ogg);
+    if (ret != GST_FLOW_OK)
+      goto seek_error;
+  }
+
   /* first find the chain to search in */
   total = ogg->total_time;
   if (ogg->chains->len == 0)
@@ -4031,25 +4134,25 @@ gst_ogg_demux_perform_seek (GstOggDemux * ogg, GstEvent * event)
 }
 
 
-/* finds each bitstream link one at a time using a bisection search
- * (has to begin by knowing the offset of the lb's initial page).
- * Recurses for each link so it can alloc the link storage after
- * finding them all, then unroll and fill the cache at the same time
+/* finds the end of @chain using a bisection search between @searched, the
+ * end of the last page known to be in the chain, and @end. @next is set to
+ * the offset of the first page of the following chain, or @end when there is
+ * none. The last pages of the chain are then read to get its end time.
  */
 static GstFlowReturn
-gst_ogg_demux_bisect_forward_serialno (GstOggDemux * ogg,
-    gint64 begin, gint64 searched, gint64 end, GstOggChain * chain, glong m)
+gst_ogg_demux_find_chain_end (GstOggDemux * ogg, gint64 searched,
+    gint64 end, GstOggChain * chain, gint64 * next)
 {
   gint64 endsearched = end;
-  gint64 next = end;
   ogg_page og;
   GstFlowReturn ret;
   gint64 offset;
-  GstOggChain *nextchain;
 
   GST_LOG_OBJECT (ogg,
-      "bisect begin: %" G_GINT64_FORMAT ", searched: %" G_GINT64_FORMAT
-      ", end %" G_GINT64_FORMAT ", chain: %p", begin, searched, end, chain);
+      "bisect searched: %" G_GINT64_FORMAT ", end %" G_GINT64_FORMAT
+      ", chain: %p", searched, end, chain);
+
+  *next = end;
 
   /* the below guards against garbage separating the last and
    * first pages of two links. */
@@ -4072,7 +4175,7 @@ gst_ogg_demux_bisect_forward_serialno (GstOggDemux * ogg,
 
       if (!gst_ogg_chain_has_stream (chain, serial)) {
         endsearched = bisect;
-        next = offset;
+        *next = offset;
       } else {
         searched = offset + og.header_len + og.body_len;
       }
@@ -4087,28 +4190,93 @@ gst_ogg_demux_bisect_forward_serialno (GstOggDemux * ogg,
   if (ret != GST_FLOW_OK)
     return ret;
 
-  GST_LOG_OBJECT (ogg, "found begin at %" G_GINT64_FORMAT, next);
+  GST_LOG_OBJECT (ogg, "found begin at %" G_GINT64_FORMAT, *next);
+
+  return GST_FLOW_OK;
+}
+
+/* estimate the total time of the file from the chains found so far by
+ * assuming the rest of the file has the same average bitrate */
+static void
+gst_ogg_demux_update_estimated_time (GstOggDemux * ogg)
+{
+  GstOggChain *last;
+  GstClockTime estimated_time = ogg->total_time;
+
+  if (!ogg->chains_complete && ogg->chains->len > 0 &&
+      GST_CLOCK_TIME_IS_VALID (ogg->total_time)) {
+    last = g_array_index (ogg->chains, GstOggChain *, ogg->chains->len - 1);
+    if (last->end_offset > 0)
+      estimated_time = gst_util_uint64_scale (ogg->total_time, ogg->length,
+          last->end_offset);
+  }
+
+  if (estimated_time == ogg->estimated_time)
+    return;
+
+  GST_DEBUG_OBJECT (ogg, "estimated total time %" GST_TIME_FORMAT
+      " after %u chains", GST_TIME_ARGS (estimated_time), ogg->chains->len);
 
-  gst_ogg_demux_seek (ogg, next);
-  ret = gst_ogg_demux_read_chain (ogg, &nextchain);
+  ogg->estimated_time = estimated_time;
+  ogg->segment.duration = estimated_time;
+}
+
+/* find the chain starting at ogg->next_chain_offset and append it to the
+ * known chains. Later chains of a chained file are only looked up when
+ * playback or a seek reaches them, so that playback can start as soon as
+ * the first chain is known. */
+static GstFlowReturn
+gst_ogg_demux_discover_next_chain (GstOggDemux * ogg)
+{
+  GstOggChain *chain;
+  GstFlowReturn ret;
+  gint64 next;
+  GstClockTime old_estimate;
+
+  g_return_val_if_fail (!ogg->chains_complete, GST_FLOW_ERROR);
+
+  GST_CHAIN_LOCK (ogg);
+  GST_DEBUG_OBJECT (ogg, "looking for chain at %" G_GINT64_FORMAT,
+      ogg->next_chain_offset);
+
+  gst_ogg_demux_seek (ogg, ogg->next_chain_offset);
+  ret = gst_ogg_demux_read_chain (ogg, &chain);
   if (ret == GST_FLOW_EOS) {
-    nextchain = NULL;
-    ret = GST_FLOW_OK;
     GST_LOG_OBJECT (ogg, "no next chain");
+    ogg->chains_complete = TRUE;
+    ret = GST_FLOW_OK;
+    goto done;
   } else if (ret != GST_FLOW_OK)
     goto done;
 
-  if (searched < end && nextchain != NULL) {
-    ret = gst_ogg_demux_bisect_forward_serialno (ogg, next, ogg->offset,
-        end, nextchain, m + 1);
-    if (ret != GST_FLOW_OK)
-      goto done;
+  ret = gst_ogg_demux_find_chain_end (ogg, ogg->offset, ogg->length, chain,
+      &next);
+  if (ret != GST_FLOW_OK) {
+    gst_ogg_chain_free (chain);
+    goto done;
   }
+
   GST_LOG_OBJECT (ogg, "adding chain %p", chain);
+  g_array_append_val (ogg->chains, chain);
 
-  g_array_insert_val (ogg->chains, 0, chain);
+  chain->begin_time = ogg->total_time;
+  gst_ogg_demux_collect_chain_info (ogg, chain);
+  ogg->total_time += chain->total_time;
+
+  if (chain->end_offset >= ogg->length || next >= ogg->length)
+    ogg->chains_complete = TRUE;
+  else
+    ogg->next_chain_offset = next;
 
 done:
+  old_estimate = ogg->estimated_time;
+  gst_ogg_demux_update_estimated_time (ogg);
+  GST_CHAIN_UNLOCK (ogg);
+
+  if (old_estimate != ogg->estimated_time)
+    gst_element_post_message (GST_ELEMENT_CAST (ogg),
+        gst_message_new_duration_changed (GST_OBJECT_CAST (ogg)));
+
   return ret;
 }
 
@@ -4425,9 +4593,11 @@ gst_ogg_demux_collect_info (GstOggDemux * ogg)
   ogg->segment.duration = ogg->total_time;
 }
 
-/* find all the chains in the ogg file, this reads the first and
+/* find the chains in the ogg file, this reads the first and
  * last page of the ogg stream, if they match then the ogg file has
- * just one chain, else we do a binary search for all chains.
+ * just one chain, else we do a binary search for the end of the first
+ * chain. The following chains are discovered when playback or a seek
+ * reaches them, meanwhile the duration is estimated from the known chains.
  */
 static GstFlowReturn
 gst_ogg_demux_find_chains (GstOggDemux * ogg)
@@ -4438,6 +4608,7 @@ gst_ogg_demux_find_chains (GstOggDemux * ogg)
   guint32 serialno;
   GstOggChain *chain;
   GstFlowReturn ret;
+  gint64 next;
 
   /* get peer to figure out length */
   if ((peer = gst_pad_get_peer (ogg->sinkpad)) == NULL)
@@ -4473,23 +4644,28 @@ gst_ogg_demux_find_chains (GstOggDemux * ogg)
   serialno = ogg_page_serialno (&og);
 
   if (!gst_ogg_chain_has_stream (chain, serialno)) {
-    /* the last page is not in the first stream, this means we should
-     * find all the chains in this chained ogg. */
-    ret =
-        gst_ogg_demux_bisect_forward_serialno (ogg, 0, 0, ogg->length, chain,
-        0);
+    /* the last page is not in the first stream, this means this is a
+     * chained ogg. Only find where the first chain ends for now. */
+    ret = gst_ogg_demux_find_chain_end (ogg, 0, ogg->length, chain, &next);
   } else {
     /* we still call this function here but with an empty range so that
      * we can reuse the setup code in this routine. */
-    ret =
-        gst_ogg_demux_bisect_forward_serialno (ogg, 0, ogg->length,
-        ogg->length, chain, 0);
+    ret = gst_ogg_demux_find_chain_end (ogg, ogg->length, ogg->length, chain,
+        &next);
   }
-  if (ret != GST_FLOW_OK)
+  if (ret != GST_FLOW_OK) {
+    gst_ogg_chain_free (chain);
     goto done;
+  }
+
+  g_array_append_val (ogg->chains, chain);
+  ogg->chains_complete = (chain->end_offset >= ogg->length
+      || next >= ogg->length);
+  ogg->next_chain_offset = next;
 
   /* all fine, collect and print */
   gst_ogg_demux_collect_info (ogg);
+  gst_ogg_demux_update_estimated_time (ogg);
 
   /* dump our chains and streams */
   gst_ogg_print (ogg);
@@ -4593,9 +4769,21 @@ gst_ogg_demux_handle_page (GstOggDemux * ogg, ogg_page * page, gboolean discont)
       GstClockTime chain_time;
       gint64 current_time;
 
-      /* this can only happen in push mode */
-      if (ogg->pullmode)
-        goto unknown_chain;
+      /* in pull mode, this happens when reaching a chain that was not
+       * discovered yet: find it and read this page again once it's known */
+      if (ogg->pullmode) {
+        gint64 offset = ogg->next_chain_offset;
+
+        if (ogg->chains_complete)
+          goto unknown_chain;
+
+        result = gst_ogg_demux_discover_next_chain (ogg);
+        if (result != GST_FLOW_OK)
+          return result;
+
+        gst_ogg_demux_seek (ogg, offset);
+        return GST_FLOW_OK;
+      }
 
       current_time = ogg->segment.position;
 
@@ -4897,7 +5085,8 @@ gst_ogg_demux_loop (GstOggPad * pad)
 
   if (ogg->need_chains) {
 
-    /* this is the only place where we write chains and thus need to lock. */
+    /* we write chains here and when discovering later chains, thus need
+     * to lock. */
     GST_CHAIN_LOCK (ogg);
     ret = gst_ogg_demux_find_chains (ogg);
     GST_CHAIN_UNLOCK (ogg);
@@ -5214,6 +5403,8 @@ gst_ogg_demux_change_state (GstElement * element, GstStateChange transition)
       ogg->running = FALSE;
       ogg->bitrate = 0;
       ogg->total_time = -1;
+      ogg->chains_complete = TRUE;
+      ogg->estimated_time = -1;
       GST_PUSH_LOCK (ogg);
       ogg->push_byte_offset = 0;
       ogg->push_byte_length = -1;
@@ -52,6 +52,14 @@ typedef struct _GstOggDemux GstOggDemux;
 typedef struct _GstOggDemuxClass GstOggDemuxClass;
 typedef struct _GstOggChain GstOggChain;
 
+/* a page seen while seeking, to narrow down later searches */
+typedef struct
+{
+  gint64 offset;                /* offset of the page */
+  gint64 next_offset;           /* offset of the page after it */
+  GstClockTime time;            /* time of the page in the chain */
+} GstOggSeekPoint;
+
 /* all information needed for one ogg chain (relevant for chained bitstreams) */
 struct _GstOggChain
 {
@@ -73,6 +81,8 @@ struct _GstOggChain
                                    the start times of all streams. */
   GstClockTime segment_stop;    /* the timestamp of the last page, this is the MAX of the
                                    streams. */
+
+  GArray *seek_points;          /* GstOggSeekPoint, sorted by time */
 };
 
 /* all information needed for one ogg stream */
@@ -154,6 +164,9 @@ struct _GstOggDemux
   GMutex chain_lock;           /* we need the lock to protect the chains */
   GArray *chains;               /* list of chains we know */
   GstClockTime total_time;
+  gboolean chains_complete;     /* FALSE while later chains are still unknown */
+  gint64 next_chain_offset;     /* start of the first unknown chain */
+  GstClockTime estimated_time;  /* total time estimated from the known chains */
   gint bitrate;                 /* bitrate of the current chain */
 
   GstOggChain *current_chain;
@@ -248,6 +248,16 @@ gst_ogg_mux_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+static void
+gst_ogg_mux_pad_clear_packets (GstOggPadData * oggpad)
+{
+  GstBuffer *buf;
+
+  while ((buf = g_queue_pop_head (&oggpad->packets)) != NULL)
+    gst_buffer_unref (buf);
+  oggpad->packet_offset = 0;
+}
+
 static void
 gst_ogg_mux_ogg_pad_destroy_notify (GstCollectData * data)
 {
@@ -255,6 +265,7 @@ gst_ogg_mux_ogg_pad_destroy_notify (GstCollectData * data)
   GstBuffer *buf;
 
   ogg_stream_clear (&oggpad->map.stream);
+  gst_ogg_mux_pad_clear_packets (oggpad);
   gst_caps_replace (&oggpad->map.caps, NULL);
 
   if (oggpad->pagebuffers) {
@@ -383,6 +394,7 @@ gst_ogg_pad_data_reset (GstOggMux * ogg_mux, GstOggPadData * oggpad)
   oggpad->keyframe_granule = -1;
   ogg_stream_clear (&oggpad->map.stream);
   ogg_stream_init (&oggpad->map.stream, oggpad->map.serialno);
+  gst_ogg_mux_pad_clear_packets (oggpad);
 
   if (oggpad->pagebuffers) {
     GstBuffer *buf;
@@ -571,6 +583,61 @@ gst_ogg_mux_buffer_from_page (GstOggMux * mux, ogg_page * page, gboolean delta)
   return buffer;
 }
 
+/* like gst_ogg_mux_buffer_from_page() but for pages of data packets: the
+ * buffer only holds a copy of the page header, followed by memories shared
+ * with the packet buffers the page body was made of. libogg already
+ * computed the CRC of the page, so the payload is not copied again. */
+static GstBuffer *
+gst_ogg_mux_buffer_from_packets (GstOggMux * mux, GstOggPadData * pad,
+    ogg_page * page, gboolean delta)
+{
+  GstBuffer *buffer;
+  gsize left = page->body_len;
+
+  buffer = gst_buffer_new_and_alloc (page->header_len);
+  gst_buffer_fill (buffer, 0, page->header, page->header_len);
+
+  while (left > 0) {
+    GstBuffer *packet = g_queue_peek_head (&pad->packets);
+    gsize size;
+
+    if (G_UNLIKELY (packet == NULL)) {
+      GstBuffer *rest;
+
+      /* should not happen, but copy what we can't account for */
+      GST_WARNING_OBJECT (pad->collect.pad, "missing %" G_GSIZE_FORMAT
+          " bytes of packet data, copying page", left);
+      rest = gst_buffer_new_and_alloc (left);
+      gst_buffer_fill (rest, 0, page->body + page->body_len - left, left);
+      buffer = gst_buffer_append (buffer, rest);
+      break;
+    }
+
+    size = MIN (gst_buffer_get_size (packet) - pad->packet_offset, left);
+    if (size > 0)
+      gst_buffer_copy_into (buffer, packet, GST_BUFFER_COPY_MEMORY,
+          pad->packet_offset, size);
+    pad->packet_offset += size;
+    left -= size;
+
+    if (pad->packet_offset == gst_buffer_get_size (packet)) {
+      gst_buffer_unref (g_queue_pop_head (&pad->packets));
+      pad->packet_offset = 0;
+    }
+  }
+
+  GST_BUFFER_OFFSET_END (buffer) = ogg_page_granulepos (page);
+  if (delta)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  GST_LOG_OBJECT (mux, GST_GP_FORMAT
+      " created buffer %p with %u memories from ogg page",
+      GST_GP_CAST (ogg_page_granulepos (page)), buffer,
+      gst_buffer_n_memory (buffer));
+
+  return buffer;
+}
+
 static GstFlowReturn
 gst_ogg_mux_push_buffer (GstOggMux * mux, GstBuffer * buffer,
     GstOggPadData * oggpad)
@@ -718,7 +785,7 @@ gst_ogg_mux_pad_queue_page (GstOggMux * mux, GstOggPadData * pad,
     ogg_page * page, gboolean delta)
 {
   GstFlowReturn ret;
-  GstBuffer *buffer = gst_ogg_mux_buffer_from_page (mux, page, delta);
+  GstBuffer *buffer = gst_ogg_mux_buffer_from_packets (mux, pad, page, delta);
 
   /* take the timestamp of the first packet on this page */
   GST_BUFFER_TIMESTAMP (buffer) = pad->timestamp;
@@ -1902,6 +1969,9 @@ gst_ogg_mux_process_best_pad (GstOggMux * ogg_mux, GstOggPadData * best)
     gst_buffer_unmap (buf, &map);
     pad->data_pushed = TRUE;
 
+    /* keep the packet around, the pages are made of its memory */
+    g_queue_push_tail (&pad->packets, gst_buffer_ref (buf));
+
     gp_time = GST_BUFFER_OFFSET (pad->buffer);
     granulepos = GST_BUFFER_OFFSET_END (pad->buffer);
     timestamp = GST_BUFFER_TIMESTAMP (pad->buffer);
@@ -2190,6 +2260,7 @@ gst_ogg_mux_clear_collectpads (GstCollectPads * collect)
     GstBuffer *buf;
 
     ogg_stream_clear (&oggpad->map.stream);
+    gst_ogg_mux_pad_clear_packets (oggpad);
 
     while ((buf = g_queue_pop_head (oggpad->pagebuffers)) != NULL) {
       GST_LOG ("flushing buffer : %p", buf);
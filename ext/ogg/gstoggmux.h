@@ -73,6 +73,10 @@ typedef struct
   GstOggPadState state;         /* state of the pad */
 
   GQueue *pagebuffers;          /* List of pages in buffers ready for pushing */
+  GQueue packets;               /* data packets whose bytes are not all on
+                                   a page yet */
+  gsize packet_offset;          /* bytes of the first packet already on a
+                                   page */
 
   gboolean new_page;            /* starting a new page */
   gboolean first_delta;         /* was the first packet in the page a delta */
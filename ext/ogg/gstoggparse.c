@@ -33,6 +33,7 @@
 #include "config.h"
 #endif
 #include <gst/gst.h>
+#include <gst/base/gstadapter.h>
 #include <ogg/ogg.h>
 #include <string.h>
 
@@ -69,7 +70,7 @@ struct _GstOggParse
 
   gboolean last_page_not_bos;   /* Set if we've seen a non-BOS page */
 
-  ogg_sync_state sync;          /* Ogg page synchronisation */
+  GstAdapter *adapter;          /* Input data not parsed into pages yet */
 
   GstCaps *caps;                /* Our src caps */
 
@@ -269,6 +270,7 @@ gst_ogg_parse_init (GstOggParse * ogg)
   gst_element_add_pad (GST_ELEMENT (ogg), ogg->srcpad);
 
   ogg->oggstreams = NULL;
+  ogg->adapter = gst_adapter_new ();
 }
 
 static void
@@ -278,7 +280,10 @@ gst_ogg_parse_dispose (GObject * object)
 
   GST_LOG_OBJECT (ogg, "Disposing of object %p", ogg);
 
-  ogg_sync_clear (&ogg->sync);
+  if (ogg->adapter) {
+    g_object_unref (ogg->adapter);
+    ogg->adapter = NULL;
+  }
   gst_ogg_parse_delete_all_streams (ogg);
 
   if (ogg->caps) {
@@ -290,39 +295,125 @@ gst_ogg_parse_dispose (GObject * object)
     G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
-/* submit the given buffer to the ogg sync */
-static GstFlowReturn
-gst_ogg_parse_submit_buffer (GstOggParse * ogg, GstBuffer * buffer)
+#define OGG_CAPTURE_PATTERN 0x4f676753      /* "OggS" */
+#define OGG_PAGE_HEADER_SIZE 27
+
+/* CRC-32 with polynomial 0x04c11db7, processed 8 bytes at a time */
+static guint32 crc_lookup[8][256];
+
+static void
+gst_ogg_parse_init_crc (void)
 {
-  gsize size;
-  gchar *oggbuffer;
-  GstFlowReturn ret = GST_FLOW_OK;
-
-  size = gst_buffer_get_size (buffer);
-
-  GST_DEBUG_OBJECT (ogg, "submitting %" G_GSIZE_FORMAT " bytes", size);
-  if (G_UNLIKELY (size == 0))
-    goto done;
-
-  oggbuffer = ogg_sync_buffer (&ogg->sync, size);
-  if (G_UNLIKELY (oggbuffer == NULL)) {
-    GST_ELEMENT_ERROR (ogg, STREAM, DECODE,
-        (NULL), ("failed to get ogg sync buffer"));
-    ret = GST_FLOW_ERROR;
-    goto done;
+  static gsize init = 0;
+
+  if (g_once_init_enter (&init)) {
+    guint i, j;
+
+    for (i = 0; i < 256; i++) {
+      guint32 r = i << 24;
+
+      for (j = 0; j < 8; j++)
+        r = (r & 0x80000000U) ? (r << 1) ^ 0x04c11db7U : (r << 1);
+      crc_lookup[0][i] = r;
+    }
+    for (j = 1; j < 8; j++) {
+      for (i = 0; i < 256; i++)
+        crc_lookup[j][i] = (crc_lookup[j - 1][i] << 8) ^
+            crc_lookup[0][crc_lookup[j - 1][i] >> 24];
+    }
+    g_once_init_leave (&init, 1);
   }
+}
 
-  size = gst_buffer_extract (buffer, 0, oggbuffer, size);
-  if (G_UNLIKELY (ogg_sync_wrote (&ogg->sync, size) < 0)) {
-    GST_ELEMENT_ERROR (ogg, STREAM, DECODE, (NULL),
-        ("failed to write %" G_GSIZE_FORMAT " bytes to the sync buffer", size));
-    ret = GST_FLOW_ERROR;
+static guint32
+gst_ogg_parse_crc (guint32 crc, const guint8 * data, gsize size)
+{
+  while (size >= 8) {
+    crc ^= GST_READ_UINT32_BE (data);
+    crc = crc_lookup[7][crc >> 24] ^ crc_lookup[6][(crc >> 16) & 0xff] ^
+        crc_lookup[5][(crc >> 8) & 0xff] ^ crc_lookup[4][crc & 0xff] ^
+        crc_lookup[3][data[4]] ^ crc_lookup[2][data[5]] ^
+        crc_lookup[1][data[6]] ^ crc_lookup[0][data[7]];
+    data += 8;
+    size -= 8;
   }
+  while (size--)
+    crc = (crc << 8) ^ crc_lookup[0][(crc >> 24) ^ *data++];
 
-done:
-  gst_buffer_unref (buffer);
+  return crc;
+}
 
-  return ret;
+/* drop bytes that are not part of a page, they still count for the offset */
+static void
+gst_ogg_parse_skip (GstOggParse * ogg, gsize size)
+{
+  GST_LOG_OBJECT (ogg, "skipping %" G_GSIZE_FORMAT " bytes", size);
+  gst_adapter_flush (ogg->adapter, size);
+  ogg->offset += size;
+}
+
+/* Finds the next complete page with a valid checksum and moves it to the
+ * start of the adapter. Returns the size of the page, or 0 when more data is
+ * needed. */
+static gsize
+gst_ogg_parse_scan_page (GstOggParse * ogg)
+{
+  GstAdapter *adapter = ogg->adapter;
+  guint8 header[OGG_PAGE_HEADER_SIZE + 255];
+  const guint8 *data;
+  gsize avail, size;
+  gssize pos;
+  guint i, n_segments;
+  guint32 crc;
+  static const guint8 zero_crc[4] = { 0, };
+
+  gst_ogg_parse_init_crc ();
+
+  while (TRUE) {
+    avail = gst_adapter_available (adapter);
+    if (avail < OGG_PAGE_HEADER_SIZE)
+      return 0;
+
+    pos = gst_adapter_masked_scan_uint32 (adapter, 0xffffffff,
+        OGG_CAPTURE_PATTERN, 0, avail);
+    if (pos < 0) {
+      /* the last bytes might be the start of the next capture pattern */
+      gst_ogg_parse_skip (ogg, avail - 3);
+      return 0;
+    }
+    if (pos > 0) {
+      gst_ogg_parse_skip (ogg, pos);
+      continue;
+    }
+
+    /* header and segment table */
+    gst_adapter_copy (adapter, header, 0, OGG_PAGE_HEADER_SIZE);
+    n_segments = header[26];
+    size = OGG_PAGE_HEADER_SIZE + n_segments;
+    if (avail < size)
+      return 0;
+    gst_adapter_copy (adapter, header + OGG_PAGE_HEADER_SIZE,
+        OGG_PAGE_HEADER_SIZE, n_segments);
+    for (i = 0; i < n_segments; i++)
+      size += header[OGG_PAGE_HEADER_SIZE + i];
+    if (avail < size)
+      return 0;
+
+    /* the checksum is calculated with the checksum field set to 0 */
+    data = gst_adapter_map (adapter, size);
+    crc = gst_ogg_parse_crc (0, data, 22);
+    crc = gst_ogg_parse_crc (crc, zero_crc, 4);
+    crc = gst_ogg_parse_crc (crc, data + 26, size - 26);
+    gst_adapter_unmap (adapter);
+
+    if (crc == GST_READ_UINT32_LE (header + 22))
+      return size;
+
+    /* not a page, look for the next capture pattern */
+    GST_DEBUG_OBJECT (ogg, "checksum mismatch at offset %" G_GINT64_FORMAT,
+        ogg->offset);
+    gst_ogg_parse_skip (ogg, 1);
+  }
 }
 
 static void
@@ -332,6 +423,9 @@ gst_ogg_parse_append_header (GValue * array, GstBuffer * buf)
   /* We require a copy to avoid circular refcounts */
   GstBuffer *buffer = gst_buffer_copy (buf);
 
+  /* @buf shares its memory with the input but is our own buffer, see
+   * gst_ogg_parse_chain(). Its only refs are the ones of the stream lists, so
+   * the flag can be set even though it is not writable. */
   GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_HEADER);
 
   g_value_init (&value, GST_TYPE_BUFFER);
@@ -367,350 +461,376 @@ gst_ogg_parse_is_header (GstOggParse * ogg, GstOggStream * stream,
     return PAGE_HEADER;
 }
 
-static GstBuffer *
-gst_ogg_parse_buffer_from_page (ogg_page * page,
+static void
+gst_ogg_parse_buffer_set_page_meta (GstBuffer * buf, ogg_page * page,
     guint64 offset, GstClockTime timestamp)
 {
   int size = page->header_len + page->body_len;
-  GstBuffer *buf = gst_buffer_new_and_alloc (size);
 
-  gst_buffer_fill (buf, 0, page->header, page->header_len);
-  gst_buffer_fill (buf, page->header_len, page->body, page->body_len);
+  g_return_if_fail (gst_buffer_is_writable (buf));
 
+  /* the buffer shares the memory of the input, but none of its metadata */
+  GST_BUFFER_FLAGS (buf) = 0;
+  GST_BUFFER_DTS (buf) = GST_CLOCK_TIME_NONE;
+  GST_BUFFER_DURATION (buf) = GST_CLOCK_TIME_NONE;
   GST_BUFFER_TIMESTAMP (buf) = timestamp;
   GST_BUFFER_OFFSET (buf) = offset;
   GST_BUFFER_OFFSET_END (buf) = offset + size;
-
-  return buf;
 }
 
-
-/* Reads in buffers, parses them, reframes into one-buffer-per-ogg-page, submits
- * pages to output pad.
- */
+/* Handles one page, takes ownership of @pagebuffer, which holds the data of
+ * @page */
 static GstFlowReturn
-gst_ogg_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+gst_ogg_parse_handle_page (GstOggParse * ogg, ogg_page * page,
+    GstBuffer * pagebuffer)
 {
-  GstOggParse *ogg;
   GstFlowReturn result = GST_FLOW_OK;
-  gint ret = -1;
   guint32 serialno;
-  GstBuffer *pagebuffer;
-  GstClockTime buffertimestamp = GST_BUFFER_TIMESTAMP (buffer);
+  GstClockTime buffertimestamp = GST_CLOCK_TIME_NONE;
+  gint64 granule = ogg_page_granulepos (page);
+#ifndef GST_DISABLE_GST_DEBUG
+  int bos = ogg_page_bos (page);
+#endif
+  guint64 startoffset = ogg->offset;
+  GstOggStream *stream;
+  gboolean keyframe;
 
-  ogg = GST_OGG_PARSE (parent);
+  serialno = ogg_page_serialno (page);
+  stream = gst_ogg_parse_find_stream (ogg, serialno);
+
+  GST_LOG_OBJECT (ogg, "Timestamping outgoing buffer as %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (buffertimestamp));
+
+  if (stream) {
+    buffertimestamp = gst_ogg_stream_get_end_time_for_granulepos (stream,
+        granule);
+    if (ogg->video_stream) {
+      if (stream == ogg->video_stream) {
+        keyframe = gst_ogg_stream_granulepos_is_key_frame (stream, granule);
+      } else {
+        keyframe = FALSE;
+      }
+    } else {
+      keyframe = TRUE;
+    }
+  } else {
+    buffertimestamp = GST_CLOCK_TIME_NONE;
+    keyframe = TRUE;
+  }
+  gst_ogg_parse_buffer_set_page_meta (pagebuffer, page, startoffset,
+      buffertimestamp);
+
+  /* We read out the page, so we set the next offset appropriately */
+  ogg->offset += gst_buffer_get_size (pagebuffer);
 
   GST_LOG_OBJECT (ogg,
-      "Chain function received buffer of size %" G_GSIZE_FORMAT,
-      gst_buffer_get_size (buffer));
+      "processing ogg page (serial %08x, pageno %ld, "
+      "granule pos %" G_GUINT64_FORMAT ", bos %d, offset %"
+      G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT ") keyframe=%d",
+      serialno, ogg_page_pageno (page),
+      granule, bos, startoffset, ogg->offset, keyframe);
+
+  if (ogg_page_bos (page)) {
+    /* If we've seen this serialno before, this is technically an error,
+     * we log this case but accept it - this one replaces the previous
+     * stream with this serialno. We can do this since we're streaming, and
+     * not supporting seeking...
+     */
+    GstOggStream *stream = gst_ogg_parse_find_stream (ogg, serialno);
 
-  gst_ogg_parse_submit_buffer (ogg, buffer);
+    if (stream != NULL) {
+      GST_LOG_OBJECT (ogg, "Incorrect stream; repeats serial number %08x "
+          "at offset %" G_GINT64_FORMAT, serialno, ogg->offset);
+    }
 
-  while (ret != 0 && result == GST_FLOW_OK) {
-    ogg_page page;
+    if (ogg->last_page_not_bos) {
+      GST_LOG_OBJECT (ogg, "Deleting all referenced streams, found a new "
+          "chain starting with serial %u", serialno);
+      gst_ogg_parse_delete_all_streams (ogg);
+    }
+
+    stream = gst_ogg_parse_new_stream (ogg, page);
+    if (!stream) {
+      GST_LOG_OBJECT (ogg, "Incorrect page");
+      goto failure;
+    }
+
+    ogg->last_page_not_bos = FALSE;
+
+    gst_buffer_ref (pagebuffer);
+    stream->headers = g_list_append (stream->headers, pagebuffer);
+
+    if (!ogg->in_headers) {
+      GST_LOG_OBJECT (ogg,
+          "Found start of new chain at offset %" G_GUINT64_FORMAT,
+          startoffset);
+      ogg->in_headers = 1;
+    }
 
-    /* We use ogg_sync_pageseek() rather than ogg_sync_pageout() so that we can
-     * track how many bytes the ogg layer discarded (in the case of sync errors,
-     * etc.); this allows us to accurately track the current stream offset
+    /* For now, we just keep the header buffer in the stream->headers list;
+     * it actually gets output once we've collected the entire set
      */
-    ret = ogg_sync_pageseek (&ogg->sync, &page);
-    if (ret == 0) {
-      /* need more data, that's fine... */
-      break;
-    } else if (ret < 0) {
-      /* discontinuity; track how many bytes we skipped (-ret) */
-      ogg->offset -= ret;
-    } else {
-      gint64 granule = ogg_page_granulepos (&page);
-#ifndef GST_DISABLE_GST_DEBUG
-      int bos = ogg_page_bos (&page);
-#endif
-      guint64 startoffset = ogg->offset;
-      GstOggStream *stream;
-      gboolean keyframe;
-
-      serialno = ogg_page_serialno (&page);
-      stream = gst_ogg_parse_find_stream (ogg, serialno);
-
-      GST_LOG_OBJECT (ogg, "Timestamping outgoing buffer as %" GST_TIME_FORMAT,
-          GST_TIME_ARGS (buffertimestamp));
-
-      if (stream) {
-        buffertimestamp = gst_ogg_stream_get_end_time_for_granulepos (stream,
-            granule);
-        if (ogg->video_stream) {
-          if (stream == ogg->video_stream) {
-            keyframe = gst_ogg_stream_granulepos_is_key_frame (stream, granule);
-          } else {
-            keyframe = FALSE;
-          }
-        } else {
-          keyframe = TRUE;
-        }
+  } else {
+    /* Non-BOS page. Either: we're outside headers, and this isn't a 
+     * header (normal data), outside headers and this is (error!), inside
+     * headers, this is (append header), or inside headers and this isn't 
+     * (we've found the end of headers; flush the lot!)
+     *
+     * Before that, we flag that the last page seen (this one) was not a 
+     * BOS page; that way we know that when we next see a BOS page it's a
+     * new chain, and we can flush all existing streams.
+     */
+    page_type type;
+    GstOggStream *stream = gst_ogg_parse_find_stream (ogg, serialno);
+
+    if (!stream) {
+      GST_LOG_OBJECT (ogg,
+          "Non-BOS page unexpectedly found at %" G_GINT64_FORMAT,
+          ogg->offset);
+      goto failure;
+    }
+
+    ogg->last_page_not_bos = TRUE;
+
+    type = gst_ogg_parse_is_header (ogg, stream, page);
+
+    if (type == PAGE_PENDING && ogg->in_headers) {
+      gst_buffer_ref (pagebuffer);
+
+      stream->unknown_pages = g_list_append (stream->unknown_pages,
+          pagebuffer);
+    } else if (type == PAGE_HEADER) {
+      if (!ogg->in_headers) {
+        GST_LOG_OBJECT (ogg, "Header page unexpectedly found outside "
+            "headers at offset %" G_GINT64_FORMAT, ogg->offset);
+        goto failure;
       } else {
-        buffertimestamp = GST_CLOCK_TIME_NONE;
-        keyframe = TRUE;
+        /* Append the header to the buffer list, after any unknown previous
+         * pages
+         */
+        stream->headers = g_list_concat (stream->headers,
+            stream->unknown_pages);
+        g_list_free (stream->unknown_pages);
+        gst_buffer_ref (pagebuffer);
+        stream->headers = g_list_append (stream->headers, pagebuffer);
       }
-      pagebuffer = gst_ogg_parse_buffer_from_page (&page, startoffset,
-          buffertimestamp);
+    } else {                /* PAGE_DATA, or PAGE_PENDING but outside headers */
+      if (ogg->in_headers) {
+        /* First non-header page... set caps, flush headers.
+         *
+         * First up, we build a single GValue list of all the pagebuffers
+         * we're using for the headers, in order.
+         * Then we set this on the caps structure. Then we can start pushing
+         * buffers for the headers, and finally we send this non-header
+         * page.
+         */
+        GstCaps *caps;
+        GstStructure *structure;
+        GValue array = { 0 };
+        gint count = 0;
+        gboolean found_pending_headers = FALSE;
+        GSList *l;
 
-      /* We read out 'ret' bytes, so we set the next offset appropriately */
-      ogg->offset += ret;
+        g_value_init (&array, GST_TYPE_ARRAY);
 
-      GST_LOG_OBJECT (ogg,
-          "processing ogg page (serial %08x, pageno %ld, "
-          "granule pos %" G_GUINT64_FORMAT ", bos %d, offset %"
-          G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT ") keyframe=%d",
-          serialno, ogg_page_pageno (&page),
-          granule, bos, startoffset, ogg->offset, keyframe);
-
-      if (ogg_page_bos (&page)) {
-        /* If we've seen this serialno before, this is technically an error,
-         * we log this case but accept it - this one replaces the previous
-         * stream with this serialno. We can do this since we're streaming, and
-         * not supporting seeking...
-         */
-        GstOggStream *stream = gst_ogg_parse_find_stream (ogg, serialno);
+        for (l = ogg->oggstreams; l != NULL; l = l->next) {
+          GstOggStream *stream = (GstOggStream *) l->data;
 
-        if (stream != NULL) {
-          GST_LOG_OBJECT (ogg, "Incorrect stream; repeats serial number %08x "
-              "at offset %" G_GINT64_FORMAT, serialno, ogg->offset);
-        }
+          if (g_list_length (stream->headers) == 0) {
+            GST_LOG_OBJECT (ogg, "No primary header found for stream %08x",
+                stream->serialno);
+            goto failure;
+          }
 
-        if (ogg->last_page_not_bos) {
-          GST_LOG_OBJECT (ogg, "Deleting all referenced streams, found a new "
-              "chain starting with serial %u", serialno);
-          gst_ogg_parse_delete_all_streams (ogg);
+          gst_ogg_parse_append_header (&array,
+              GST_BUFFER (stream->headers->data));
+          count++;
         }
 
-        stream = gst_ogg_parse_new_stream (ogg, &page);
-        if (!stream) {
-          GST_LOG_OBJECT (ogg, "Incorrect page");
-          goto failure;
+        for (l = ogg->oggstreams; l != NULL; l = l->next) {
+          GstOggStream *stream = (GstOggStream *) l->data;
+          GList *j;
+
+          /* already appended the first header, now do headers 2-N */
+          for (j = stream->headers->next; j != NULL; j = j->next) {
+            gst_ogg_parse_append_header (&array, GST_BUFFER (j->data));
+            count++;
+          }
         }
 
-        ogg->last_page_not_bos = FALSE;
+        caps = gst_pad_query_caps (ogg->srcpad, NULL);
+        caps = gst_caps_make_writable (caps);
 
-        gst_buffer_ref (pagebuffer);
-        stream->headers = g_list_append (stream->headers, pagebuffer);
+        structure = gst_caps_get_structure (caps, 0);
+        gst_structure_take_value (structure, "streamheader", &array);
+
+        gst_pad_set_caps (ogg->srcpad, caps);
 
-        if (!ogg->in_headers) {
-          GST_LOG_OBJECT (ogg,
-              "Found start of new chain at offset %" G_GUINT64_FORMAT,
-              startoffset);
-          ogg->in_headers = 1;
+        if (ogg->caps)
+          gst_caps_unref (ogg->caps);
+        ogg->caps = caps;
+
+        GST_LOG_OBJECT (ogg, "Set \"streamheader\" caps with %d buffers "
+            "(one per page)", count);
+
+        /* Now, we do the same thing, but push buffers... */
+        for (l = ogg->oggstreams; l != NULL; l = l->next) {
+          GstOggStream *stream = (GstOggStream *) l->data;
+          GstBuffer *buf = GST_BUFFER (stream->headers->data);
+
+          result = gst_pad_push (ogg->srcpad, buf);
+          if (result != GST_FLOW_OK)
+            goto done;
         }
+        for (l = ogg->oggstreams; l != NULL; l = l->next) {
+          GstOggStream *stream = (GstOggStream *) l->data;
+          GList *j;
 
-        /* For now, we just keep the header buffer in the stream->headers list;
-         * it actually gets output once we've collected the entire set
-         */
-      } else {
-        /* Non-BOS page. Either: we're outside headers, and this isn't a 
-         * header (normal data), outside headers and this is (error!), inside
-         * headers, this is (append header), or inside headers and this isn't 
-         * (we've found the end of headers; flush the lot!)
-         *
-         * Before that, we flag that the last page seen (this one) was not a 
-         * BOS page; that way we know that when we next see a BOS page it's a
-         * new chain, and we can flush all existing streams.
-         */
-        page_type type;
-        GstOggStream *stream = gst_ogg_parse_find_stream (ogg, serialno);
-
-        if (!stream) {
-          GST_LOG_OBJECT (ogg,
-              "Non-BOS page unexpectedly found at %" G_GINT64_FORMAT,
-              ogg->offset);
-          goto failure;
+          /* pushed the first one for each stream already, now do 2-N */
+          for (j = stream->headers->next; j != NULL; j = j->next) {
+            GstBuffer *buf = GST_BUFFER (j->data);
+
+            result = gst_pad_push (ogg->srcpad, buf);
+            if (result != GST_FLOW_OK)
+              goto done;
+          }
         }
 
-        ogg->last_page_not_bos = TRUE;
+        ogg->in_headers = 0;
 
-        type = gst_ogg_parse_is_header (ogg, stream, &page);
+        /* And finally the pending data pages */
+        for (l = ogg->oggstreams; l != NULL; l = l->next) {
+          GstOggStream *stream = (GstOggStream *) l->data;
+          GList *k;
 
-        if (type == PAGE_PENDING && ogg->in_headers) {
-          gst_buffer_ref (pagebuffer);
+          if (stream->unknown_pages == NULL)
+            continue;
 
-          stream->unknown_pages = g_list_append (stream->unknown_pages,
-              pagebuffer);
-        } else if (type == PAGE_HEADER) {
-          if (!ogg->in_headers) {
-            GST_LOG_OBJECT (ogg, "Header page unexpectedly found outside "
-                "headers at offset %" G_GINT64_FORMAT, ogg->offset);
-            goto failure;
-          } else {
-            /* Append the header to the buffer list, after any unknown previous
-             * pages
-             */
-            stream->headers = g_list_concat (stream->headers,
-                stream->unknown_pages);
-            g_list_free (stream->unknown_pages);
-            gst_buffer_ref (pagebuffer);
-            stream->headers = g_list_append (stream->headers, pagebuffer);
+          if (found_pending_headers) {
+            GST_WARNING_OBJECT (ogg, "Incorrectly muxed headers found at "
+                "approximate offset %" G_GINT64_FORMAT, ogg->offset);
           }
-        } else {                /* PAGE_DATA, or PAGE_PENDING but outside headers */
-          if (ogg->in_headers) {
-            /* First non-header page... set caps, flush headers.
-             *
-             * First up, we build a single GValue list of all the pagebuffers
-             * we're using for the headers, in order.
-             * Then we set this on the caps structure. Then we can start pushing
-             * buffers for the headers, and finally we send this non-header
-             * page.
-             */
-            GstCaps *caps;
-            GstStructure *structure;
-            GValue array = { 0 };
-            gint count = 0;
-            gboolean found_pending_headers = FALSE;
-            GSList *l;
-
-            g_value_init (&array, GST_TYPE_ARRAY);
-
-            for (l = ogg->oggstreams; l != NULL; l = l->next) {
-              GstOggStream *stream = (GstOggStream *) l->data;
-
-              if (g_list_length (stream->headers) == 0) {
-                GST_LOG_OBJECT (ogg, "No primary header found for stream %08x",
-                    stream->serialno);
-                goto failure;
-              }
-
-              gst_ogg_parse_append_header (&array,
-                  GST_BUFFER (stream->headers->data));
-              count++;
-            }
-
-            for (l = ogg->oggstreams; l != NULL; l = l->next) {
-              GstOggStream *stream = (GstOggStream *) l->data;
-              GList *j;
-
-              /* already appended the first header, now do headers 2-N */
-              for (j = stream->headers->next; j != NULL; j = j->next) {
-                gst_ogg_parse_append_header (&array, GST_BUFFER (j->data));
-                count++;
-              }
-            }
-
-            caps = gst_pad_query_caps (ogg->srcpad, NULL);
-            caps = gst_caps_make_writable (caps);
-
-            structure = gst_caps_get_structure (caps, 0);
-            gst_structure_take_value (structure, "streamheader", &array);
-
-            gst_pad_set_caps (ogg->srcpad, caps);
-
-            if (ogg->caps)
-              gst_caps_unref (ogg->caps);
-            ogg->caps = caps;
-
-            GST_LOG_OBJECT (ogg, "Set \"streamheader\" caps with %d buffers "
-                "(one per page)", count);
-
-            /* Now, we do the same thing, but push buffers... */
-            for (l = ogg->oggstreams; l != NULL; l = l->next) {
-              GstOggStream *stream = (GstOggStream *) l->data;
-              GstBuffer *buf = GST_BUFFER (stream->headers->data);
-
-              result = gst_pad_push (ogg->srcpad, buf);
-              if (result != GST_FLOW_OK)
-                return result;
-            }
-            for (l = ogg->oggstreams; l != NULL; l = l->next) {
-              GstOggStream *stream = (GstOggStream *) l->data;
-              GList *j;
-
-              /* pushed the first one for each stream already, now do 2-N */
-              for (j = stream->headers->next; j != NULL; j = j->next) {
-                GstBuffer *buf = GST_BUFFER (j->data);
-
-                result = gst_pad_push (ogg->srcpad, buf);
-                if (result != GST_FLOW_OK)
-                  return result;
-              }
-            }
-
-            ogg->in_headers = 0;
-
-            /* And finally the pending data pages */
-            for (l = ogg->oggstreams; l != NULL; l = l->next) {
-              GstOggStream *stream = (GstOggStream *) l->data;
-              GList *k;
-
-              if (stream->unknown_pages == NULL)
-                continue;
-
-              if (found_pending_headers) {
-                GST_WARNING_OBJECT (ogg, "Incorrectly muxed headers found at "
-                    "approximate offset %" G_GINT64_FORMAT, ogg->offset);
-              }
-              found_pending_headers = TRUE;
-
-              GST_LOG_OBJECT (ogg, "Pushing %d pending pages after headers",
-                  g_list_length (stream->unknown_pages) + 1);
-
-              for (k = stream->unknown_pages; k != NULL; k = k->next) {
-                GstBuffer *buf = GST_BUFFER (k->data);
-
-                result = gst_pad_push (ogg->srcpad, buf);
-                if (result != GST_FLOW_OK)
-                  return result;
-              }
-              g_list_foreach (stream->unknown_pages,
-                  (GFunc) gst_mini_object_unref, NULL);
-              g_list_free (stream->unknown_pages);
-              stream->unknown_pages = NULL;
-            }
+          found_pending_headers = TRUE;
+
+          GST_LOG_OBJECT (ogg, "Pushing %d pending pages after headers",
+              g_list_length (stream->unknown_pages) + 1);
+
+          for (k = stream->unknown_pages; k != NULL; k = k->next) {
+            GstBuffer *buf = GST_BUFFER (k->data);
+
+            result = gst_pad_push (ogg->srcpad, buf);
+            if (result != GST_FLOW_OK)
+              goto done;
           }
+          g_list_foreach (stream->unknown_pages,
+              (GFunc) gst_mini_object_unref, NULL);
+          g_list_free (stream->unknown_pages);
+          stream->unknown_pages = NULL;
+        }
+      }
+
+      if (granule == -1) {
+        stream->stored_buffers = g_list_append (stream->stored_buffers,
+            pagebuffer);
+      } else {
+        while (stream->stored_buffers) {
+          GstBuffer *buf = stream->stored_buffers->data;
 
-          if (granule == -1) {
-            stream->stored_buffers = g_list_append (stream->stored_buffers,
-                pagebuffer);
+          buf = gst_buffer_make_writable (buf);
+
+          GST_BUFFER_TIMESTAMP (buf) = buffertimestamp;
+          if (!keyframe) {
+            GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
           } else {
-            while (stream->stored_buffers) {
-              GstBuffer *buf = stream->stored_buffers->data;
-
-              buf = gst_buffer_make_writable (buf);
-
-              GST_BUFFER_TIMESTAMP (buf) = buffertimestamp;
-              if (!keyframe) {
-                GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
-              } else {
-                keyframe = FALSE;
-              }
-
-              result = gst_pad_push (ogg->srcpad, buf);
-              if (result != GST_FLOW_OK)
-                return result;
-
-              stream->stored_buffers =
-                  g_list_delete_link (stream->stored_buffers,
-                  stream->stored_buffers);
-            }
-
-            pagebuffer = gst_buffer_make_writable (pagebuffer);
-            if (!keyframe) {
-              GST_BUFFER_FLAG_SET (pagebuffer, GST_BUFFER_FLAG_DELTA_UNIT);
-            } else {
-              keyframe = FALSE;
-            }
-
-            result = gst_pad_push (ogg->srcpad, pagebuffer);
-            if (result != GST_FLOW_OK)
-              return result;
+            keyframe = FALSE;
           }
+
+          result = gst_pad_push (ogg->srcpad, buf);
+          if (result != GST_FLOW_OK)
+            goto done;
+
+          stream->stored_buffers =
+              g_list_delete_link (stream->stored_buffers,
+              stream->stored_buffers);
         }
+
+        pagebuffer = gst_buffer_make_writable (pagebuffer);
+        if (!keyframe) {
+          GST_BUFFER_FLAG_SET (pagebuffer, GST_BUFFER_FLAG_DELTA_UNIT);
+        } else {
+          keyframe = FALSE;
+        }
+
+        result = gst_pad_push (ogg->srcpad, pagebuffer);
+        if (result != GST_FLOW_OK)
+          return result;
       }
     }
   }
 
   return result;
 
+done:
+  gst_buffer_unref (pagebuffer);
+  return result;
+
 failure:
+  gst_buffer_unref (pagebuffer);
   gst_pad_push_event (GST_PAD (ogg->srcpad), gst_event_new_eos ());
   return GST_FLOW_ERROR;
 }
 
+/* Reads in buffers, parses them, reframes into one-buffer-per-ogg-page, submits
+ * pages to output pad.
+ */
+static GstFlowReturn
+gst_ogg_parse_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstOggParse *ogg;
+  GstFlowReturn result = GST_FLOW_OK;
+
+  ogg = GST_OGG_PARSE (parent);
+
+  GST_LOG_OBJECT (ogg,
+      "Chain function received buffer of size %" G_GSIZE_FORMAT,
+      gst_buffer_get_size (buffer));
+
+  gst_adapter_push (ogg->adapter, buffer);
+
+  while (result == GST_FLOW_OK) {
+    GstBuffer *pagebuffer;
+    const guint8 *data;
+    ogg_page page;
+    gsize size;
+
+    size = gst_ogg_parse_scan_page (ogg);
+    if (size == 0) {
+      /* need more data, that's fine... */
+      break;
+    }
+
+    data = gst_adapter_map (ogg->adapter, size);
+    page.header = (unsigned char *) data;
+    page.header_len = OGG_PAGE_HEADER_SIZE + data[26];
+    page.body = (unsigned char *) data + page.header_len;
+    page.body_len = size - page.header_len;
+
+    /* the outgoing page references the memory of the input buffers. When the
+     * page is a whole input buffer this is a ref to that buffer, which the
+     * adapter and upstream still hold, so make our own before flags and
+     * timestamps are set on it. That only copies the metadata. */
+    pagebuffer = gst_adapter_get_buffer_fast (ogg->adapter, size);
+    pagebuffer = gst_buffer_make_writable (pagebuffer);
+
+    result = gst_ogg_parse_handle_page (ogg, &page, pagebuffer);
+
+    gst_adapter_unmap (ogg->adapter);
+    gst_adapter_flush (ogg->adapter, size);
+  }
+
+  return result;
+}
+
 static GstStateChangeReturn
 gst_ogg_parse_change_state (GstElement * element, GstStateChange transition)
 {
@@ -721,10 +841,9 @@ gst_ogg_parse_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_NULL_TO_READY:
-      ogg_sync_init (&ogg->sync);
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
-      ogg_sync_reset (&ogg->sync);
+      gst_adapter_clear (ogg->adapter);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
       break;
@@ -740,7 +859,6 @@ gst_ogg_parse_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
-      ogg_sync_clear (&ogg->sync);
       break;
     default:
       break;
@@ -168,6 +168,7 @@ gst_opus_dec_reset (GstOpusDec * dec)
     opus_multistream_decoder_destroy (dec->state);
     dec->state = NULL;
   }
+  dec->decoder_gain = 0;
 
   gst_buffer_replace (&dec->streamheader, NULL);
   gst_buffer_replace (&dec->vorbiscomment, NULL);
@@ -468,6 +469,7 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
   gint16 *out_data;
   int n, err;
   int samples;
+  gint gain;
   unsigned int packet_size;
   GstBuffer *buf;
   GstMapInfo map, omap;
@@ -527,6 +529,18 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
 #endif
   }
 
+  /* let the decoder apply the output gain, which is much cheaper than
+   * scaling the samples afterwards */
+  gain = dec->apply_gain ? dec->r128_gain : 0;
+  if (gain != dec->decoder_gain) {
+    err = opus_multistream_decoder_ctl (dec->state, OPUS_SET_GAIN (gain));
+    if (err == OPUS_OK)
+      dec->decoder_gain = gain;
+    else
+      GST_WARNING_OBJECT (dec, "Could not configure decoder gain: %s",
+          opus_strerror (err));
+  }
+
   if (buffer) {
     GST_DEBUG_OBJECT (dec, "Received buffer of size %" G_GSIZE_FORMAT,
         gst_buffer_get_size (buffer));
@@ -619,9 +633,13 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
         GST_TIME_ARGS (aligned_missing_duration), samples,
         GST_TIME_ARGS (dec->leftover_plc_duration));
   } else {
-    /* use maximum size (120 ms) as the number of returned samples is
-       not constant over the stream. */
-    samples = 120 * dec->sample_rate / 1000;
+    /* the number of returned samples is not constant over the stream, ask
+     * the packet so that the output buffer has the right size. Fall back to
+     * the maximum size (120 ms) for packets it can't tell about. */
+    samples = data ? opus_packet_get_nb_samples (data, size,
+        dec->sample_rate) : OPUS_BAD_ARG;
+    if (samples <= 0)
+      samples = 120 * dec->sample_rate / 1000;
   }
   packet_size = samples * dec->n_channels * 2;
 
@@ -743,8 +761,10 @@ opus_dec_chain_parse_data (GstOpusDec * dec, GstBuffer * buffer)
      a naive conversion that does too many int/float conversions.
      However, we don't have control over the pipeline...
      So make it optional if the user program wants to use a volume,
-     but do it by default so the correct volume goes out by default */
-  if (dec->apply_gain && outbuf && dec->r128_gain) {
+     but do it by default so the correct volume goes out by default.
+     This is only needed when the decoder could not apply it itself. */
+  if (dec->apply_gain && outbuf && dec->r128_gain
+      && dec->decoder_gain != dec->r128_gain) {
     gsize rsize;
     unsigned int i, nsamples;
     double volume = dec->r128_gain_volume;
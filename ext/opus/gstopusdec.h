@@ -67,6 +67,7 @@ struct _GstOpusDec {
 
   gboolean apply_gain;
   double r128_gain_volume;
+  gint decoder_gain;            /* gain applied by the decoder state */
 
   gboolean use_inband_fec;
   GstBuffer *last_buffer;
@@ -649,6 +649,11 @@ gst_base_text_overlay_finalize (GObject * object)
     overlay->text_image = NULL;
   }
 
+  if (overlay->glyph_cache) {
+    g_hash_table_unref (overlay->glyph_cache);
+    overlay->glyph_cache = NULL;
+  }
+
   if (overlay->layout) {
     g_object_unref (overlay->layout);
     overlay->layout = NULL;
@@ -753,6 +758,8 @@ gst_base_text_overlay_init (GstBaseTextOverlay * overlay,
   overlay->default_text = g_strdup (DEFAULT_PROP_TEXT);
   overlay->need_render = TRUE;
   overlay->text_image = NULL;
+  overlay->cache_glyphs = FALSE;
+  overlay->glyph_cache = NULL;
   overlay->use_vertical_render = DEFAULT_PROP_VERTICAL_RENDER;
   overlay->scale_mode = DEFAULT_PROP_SCALE_MODE;
   overlay->scale_par_n = DEFAULT_PROP_SCALE_PAR_N;
@@ -1693,6 +1700,269 @@ gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
   }
 }
 
+/* Rendering of plain text glyph by glyph, with the shadow, outline and fill of
+ * each glyph rasterized once and kept around. Text that keeps changing a few
+ * characters per frame, like the time and clock overlays, then only needs its
+ * layout redone and the cached images composited again instead of stroking
+ * the outline path of the whole string every time. */
+
+/* maximum number of cached glyph images before the cache is flushed */
+#define GLYPH_CACHE_MAX_SIZE 1024
+/* glyphs are positioned on a quarter pixel grid */
+#define GLYPH_PHASES 4
+
+typedef enum
+{
+  GLYPH_KIND_SHADOW,
+  GLYPH_KIND_OUTLINE,
+  GLYPH_KIND_FILL
+} GlyphKind;
+
+typedef struct
+{
+  PangoFont *font;
+  PangoGlyph glyph;
+  GlyphKind kind;
+  gint phase_x, phase_y;
+} GlyphKey;
+
+typedef struct
+{
+  GlyphKey key;
+  /* NULL for glyphs without ink */
+  cairo_surface_t *surface;
+  /* position of the surface relative to the integer glyph origin */
+  gint x, y;
+} GlyphImage;
+
+static guint
+glyph_key_hash (gconstpointer data)
+{
+  const GlyphKey *key = data;
+
+  return g_direct_hash (key->font) ^ (key->glyph * 16777619) ^
+      (key->kind << 28) ^ (key->phase_x << 24) ^ (key->phase_y << 20);
+}
+
+static gboolean
+glyph_key_equal (gconstpointer a, gconstpointer b)
+{
+  const GlyphKey *ka = a, *kb = b;
+
+  return ka->font == kb->font && ka->glyph == kb->glyph
+      && ka->kind == kb->kind && ka->phase_x == kb->phase_x
+      && ka->phase_y == kb->phase_y;
+}
+
+static void
+glyph_image_free (GlyphImage * image)
+{
+  if (image->surface)
+    cairo_surface_destroy (image->surface);
+  g_object_unref (image->key.font);
+  g_slice_free (GlyphImage, image);
+}
+
+static GlyphImage *
+gst_base_text_overlay_get_glyph (GstBaseTextOverlay * overlay,
+    const cairo_matrix_t * matrix, PangoFont * font, PangoGlyph glyph,
+    GlyphKind kind, gint phase_x, gint phase_y)
+{
+  GlyphKey key = { font, glyph, kind, phase_x, phase_y };
+  GlyphImage *image;
+  PangoGlyphString *glyphs;
+  PangoRectangle ink;
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  gdouble pad, x0, y0, x1, y1;
+  gint left, top, width, height;
+  gint a, r, g, b;
+
+  image = g_hash_table_lookup (overlay->glyph_cache, &key);
+  if (image)
+    return image;
+
+  if (g_hash_table_size (overlay->glyph_cache) >= GLYPH_CACHE_MAX_SIZE) {
+    GST_DEBUG_OBJECT (overlay, "glyph cache full, flushing");
+    g_hash_table_remove_all (overlay->glyph_cache);
+  }
+
+  image = g_slice_new0 (GlyphImage);
+  image->key = key;
+  image->key.font = g_object_ref (font);
+  g_hash_table_insert (overlay->glyph_cache, &image->key, image);
+
+  pango_font_get_glyph_extents (font, glyph, &ink, NULL);
+  if (ink.width == 0 || ink.height == 0)
+    return image;
+
+  /* leave room for the outline and antialiasing around the ink */
+  pad = (kind == GLYPH_KIND_OUTLINE ? overlay->outline_offset / 2.0 : 0) + 1;
+  x0 = (gdouble) ink.x / PANGO_SCALE - pad;
+  y0 = (gdouble) ink.y / PANGO_SCALE - pad;
+  x1 = (gdouble) (ink.x + ink.width) / PANGO_SCALE + pad;
+  y1 = (gdouble) (ink.y + ink.height) / PANGO_SCALE + pad;
+
+  left = floor (x0 * matrix->xx + (gdouble) phase_x / GLYPH_PHASES);
+  top = floor (y0 * matrix->yy + (gdouble) phase_y / GLYPH_PHASES);
+  width = ceil (x1 * matrix->xx + (gdouble) phase_x / GLYPH_PHASES) - left;
+  height = ceil (y1 * matrix->yy + (gdouble) phase_y / GLYPH_PHASES) - top;
+  if (width <= 0 || height <= 0)
+    return image;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+  cr = cairo_create (surface);
+  cairo_translate (cr, (gdouble) phase_x / GLYPH_PHASES - left,
+      (gdouble) phase_y / GLYPH_PHASES - top);
+  cairo_scale (cr, matrix->xx, matrix->yy);
+
+  glyphs = pango_glyph_string_new ();
+  pango_glyph_string_set_size (glyphs, 1);
+  glyphs->glyphs[0].glyph = glyph;
+  glyphs->glyphs[0].geometry.width = 0;
+  glyphs->glyphs[0].geometry.x_offset = 0;
+  glyphs->glyphs[0].geometry.y_offset = 0;
+  glyphs->glyphs[0].attr.is_cluster_start = 1;
+  glyphs->log_clusters[0] = 0;
+
+  switch (kind) {
+    case GLYPH_KIND_SHADOW:
+      cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 0.5);
+      pango_cairo_show_glyph_string (cr, font, glyphs);
+      break;
+    case GLYPH_KIND_OUTLINE:
+      a = (overlay->outline_color >> 24) & 0xff;
+      r = (overlay->outline_color >> 16) & 0xff;
+      g = (overlay->outline_color >> 8) & 0xff;
+      b = (overlay->outline_color >> 0) & 0xff;
+      cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+      cairo_set_line_width (cr, overlay->outline_offset);
+      pango_cairo_glyph_string_path (cr, font, glyphs);
+      cairo_stroke (cr);
+      break;
+    case GLYPH_KIND_FILL:
+      a = (overlay->color >> 24) & 0xff;
+      r = (overlay->color >> 16) & 0xff;
+      g = (overlay->color >> 8) & 0xff;
+      b = (overlay->color >> 0) & 0xff;
+      cairo_set_source_rgba (cr, r / 255.0, g / 255.0, b / 255.0, a / 255.0);
+      pango_cairo_show_glyph_string (cr, font, glyphs);
+      break;
+  }
+
+  pango_glyph_string_free (glyphs);
+  cairo_destroy (cr);
+
+  image->surface = surface;
+  image->x = left;
+  image->y = top;
+
+  return image;
+}
+
+static void
+gst_base_text_overlay_draw_glyphs_pass (GstBaseTextOverlay * overlay,
+    cairo_t * cr, const cairo_matrix_t * matrix, GlyphKind kind)
+{
+  PangoLayoutIter *iter;
+  gdouble offset = 0.0;
+
+  if (kind == GLYPH_KIND_SHADOW)
+    offset = overlay->shadow_offset;
+
+  iter = pango_layout_get_iter (overlay->layout);
+  do {
+    PangoLayoutRun *run = pango_layout_iter_get_run_readonly (iter);
+    PangoRectangle logical;
+    gint baseline, x, i;
+
+    if (!run)
+      continue;
+
+    baseline = pango_layout_iter_get_baseline (iter);
+    pango_layout_iter_get_run_extents (iter, NULL, &logical);
+    x = logical.x;
+
+    for (i = 0; i < run->glyphs->num_glyphs; i++) {
+      PangoGlyphInfo *info = &run->glyphs->glyphs[i];
+      GlyphImage *image;
+      gdouble dx, dy;
+      gint ix, iy, phase_x, phase_y;
+
+      dx = (gdouble) (x + info->geometry.x_offset) / PANGO_SCALE + offset;
+      dy = (gdouble) (baseline + info->geometry.y_offset) / PANGO_SCALE +
+          offset;
+      x += info->geometry.width;
+
+      if (info->glyph == PANGO_GLYPH_EMPTY)
+        continue;
+
+      cairo_matrix_transform_point (matrix, &dx, &dy);
+
+      ix = floor (dx);
+      iy = floor (dy);
+      phase_x = (gint) floor ((dx - ix) * GLYPH_PHASES + 0.5);
+      phase_y = (gint) floor ((dy - iy) * GLYPH_PHASES + 0.5);
+      if (phase_x == GLYPH_PHASES) {
+        ix++;
+        phase_x = 0;
+      }
+      if (phase_y == GLYPH_PHASES) {
+        iy++;
+        phase_y = 0;
+      }
+
+      image = gst_base_text_overlay_get_glyph (overlay, matrix,
+          run->item->analysis.font, info->glyph, kind, phase_x, phase_y);
+      if (image->surface) {
+        cairo_set_source_surface (cr, image->surface, ix + image->x,
+            iy + image->y);
+        cairo_paint (cr);
+      }
+    }
+  } while (pango_layout_iter_next_run (iter));
+  pango_layout_iter_free (iter);
+}
+
+/* Draws the current layout with @matrix (a scale and translation only) into
+ * @cr, in the same order as the full layout rendering: all shadows, then all
+ * outlines, then the text itself */
+static void
+gst_base_text_overlay_draw_glyphs (GstBaseTextOverlay * overlay, cairo_t * cr,
+    const cairo_matrix_t * matrix)
+{
+  if (overlay->glyph_cache == NULL) {
+    overlay->glyph_cache = g_hash_table_new_full (glyph_key_hash,
+        glyph_key_equal, NULL, (GDestroyNotify) glyph_image_free);
+  } else if (overlay->glyph_cache_scale_x != matrix->xx
+      || overlay->glyph_cache_scale_y != matrix->yy
+      || overlay->glyph_cache_color != overlay->color
+      || overlay->glyph_cache_outline_color != overlay->outline_color
+      || overlay->glyph_cache_outline_offset != overlay->outline_offset) {
+    GST_DEBUG_OBJECT (overlay, "rendering parameters changed, flushing "
+        "glyph cache");
+    g_hash_table_remove_all (overlay->glyph_cache);
+  }
+
+  overlay->glyph_cache_scale_x = matrix->xx;
+  overlay->glyph_cache_scale_y = matrix->yy;
+  overlay->glyph_cache_color = overlay->color;
+  overlay->glyph_cache_outline_color = overlay->outline_color;
+  overlay->glyph_cache_outline_offset = overlay->outline_offset;
+
+  cairo_save (cr);
+  cairo_identity_matrix (cr);
+  if (overlay->draw_shadow)
+    gst_base_text_overlay_draw_glyphs_pass (overlay, cr, matrix,
+        GLYPH_KIND_SHADOW);
+  if (overlay->draw_outline)
+    gst_base_text_overlay_draw_glyphs_pass (overlay, cr, matrix,
+        GLYPH_KIND_OUTLINE);
+  gst_base_text_overlay_draw_glyphs_pass (overlay, cr, matrix,
+      GLYPH_KIND_FILL);
+  cairo_restore (cr);
+}
+
 static void
 gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
     const gchar * string, gint textlen)
@@ -1939,6 +2209,14 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   /* apply transformations */
   cairo_set_matrix (cr, &cairo_matrix);
 
+  /* text without markup is all drawn with the same attributes, which the
+   * glyph cache relies on */
+  if (overlay->cache_glyphs && !overlay->use_vertical_render
+      && memchr (string, '<', textlen) == NULL) {
+    gst_base_text_overlay_draw_glyphs (overlay, cr, &cairo_matrix);
+    goto done;
+  }
+
   /* FIXME: We use show_layout everywhere except for the surface
    * because it's really faster and internally does all kinds of
    * caching. Unfortunately we have to paint to a cairo path for
@@ -2003,6 +2281,7 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   pango_cairo_show_layout (cr, overlay->layout);
   cairo_restore (cr);
 
+done:
   cairo_destroy (cr);
   cairo_surface_destroy (surface);
   gst_buffer_unmap (buffer, &map);
@@ -200,6 +200,17 @@ struct _GstBaseTextOverlay {
     gboolean                 need_render;
     GstBuffer               *text_image;
 
+    /* rendered glyphs, reused for plain text when cache_glyphs is set by the
+     * subclass; flushed if any of the parameters they were drawn with
+     * changes */
+    gboolean                 cache_glyphs;
+    GHashTable              *glyph_cache;
+    gdouble                  glyph_cache_scale_x;
+    gdouble                  glyph_cache_scale_y;
+    guint                    glyph_cache_color;
+    guint                    glyph_cache_outline_color;
+    gdouble                  glyph_cache_outline_offset;
+
     /* dimension relative to witch the render is done, this is the stream size
      * or a portion of the window_size (adapted to aspect ratio) */
     gint                     render_width;
@@ -184,6 +184,8 @@ gst_clock_overlay_init (GstClockOverlay * overlay)
   textoverlay = GST_BASE_TEXT_OVERLAY (overlay);
 
   textoverlay->valign = GST_BASE_TEXT_OVERLAY_VALIGN_TOP;
+  /* only a few characters change from frame to frame */
+  textoverlay->cache_glyphs = TRUE;
   textoverlay->halign = GST_BASE_TEXT_OVERLAY_HALIGN_LEFT;
 
   overlay->format = g_strdup (DEFAULT_PROP_TIMEFORMAT);
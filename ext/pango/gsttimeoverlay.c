@@ -249,6 +249,8 @@ gst_time_overlay_init (GstTimeOverlay * overlay)
   textoverlay = GST_BASE_TEXT_OVERLAY (overlay);
 
   textoverlay->valign = GST_BASE_TEXT_OVERLAY_VALIGN_TOP;
+  /* only a few characters change from frame to frame */
+  textoverlay->cache_glyphs = TRUE;
   textoverlay->halign = GST_BASE_TEXT_OVERLAY_HALIGN_LEFT;
 
   overlay->time_line = DEFAULT_TIME_LINE;
@@ -106,6 +106,8 @@ static GstFlowReturn theora_dec_parse (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame, GstAdapter * adapter, gboolean at_eos);
 static GstFlowReturn theora_dec_handle_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
+static void theora_dec_stripe_decoded (void *ctx, th_ycbcr_buffer buf,
+    int yfrag0, int yfrag_end);
 static gboolean theora_dec_decide_allocation (GstVideoDecoder * decoder,
     GstQuery * query);
 
@@ -488,6 +490,19 @@ theora_handle_type_packet (GstTheoraDec * dec)
     GST_WARNING_OBJECT (dec, "Could not enable BITS mode visualisation");
   }
 
+  /* the visualisations are only drawn on the frame returned by
+   * th_decode_ycbcr_out() */
+  if (!dec->telemetry_mv && !dec->telemetry_mbmode && !dec->telemetry_qi
+      && !dec->telemetry_bits) {
+    th_stripe_callback cb;
+
+    cb.ctx = dec;
+    cb.stripe_decoded = theora_dec_stripe_decoded;
+    if (th_decode_ctl (dec->decoder, TH_DECCTL_SET_STRIPE_CB, &cb,
+            sizeof (cb)) != 0)
+      GST_DEBUG_OBJECT (dec, "Could not enable striped decoding");
+  }
+
   /* Create the output state */
   dec->output_state = state =
       gst_video_decoder_set_output_state (GST_VIDEO_DECODER (dec), fmt,
@@ -641,19 +656,13 @@ null_buffer:
   }
 }
 
-/* Allocate buffer and copy image data into Y444 format */
+/* Allocate the output buffer and figure out which part of the decoded
+ * frame is copied into it */
 static GstFlowReturn
-theora_handle_image (GstTheoraDec * dec, th_ycbcr_buffer buf,
-    GstVideoCodecFrame * frame)
+theora_dec_prepare_output (GstTheoraDec * dec, GstVideoCodecFrame * frame)
 {
   GstVideoDecoder *decoder = GST_VIDEO_DECODER (dec);
-  gint width, height, stride;
   GstFlowReturn result;
-  gint i, comp;
-  guint8 *dest, *src;
-  GstVideoFrame vframe;
-  gint pic_width, pic_height;
-  gint offset_x, offset_y;
 
   result = gst_video_decoder_allocate_output_frame (decoder, frame);
 
@@ -665,23 +674,23 @@ theora_handle_image (GstTheoraDec * dec, th_ycbcr_buffer buf,
 
   if (!dec->can_crop) {
     /* we need to crop the hard way */
-    offset_x = dec->info.pic_x;
-    offset_y = dec->info.pic_y;
-    pic_width = dec->info.pic_width;
-    pic_height = dec->info.pic_height;
+    dec->offset_x = dec->info.pic_x;
+    dec->offset_y = dec->info.pic_y;
+    dec->pic_width = dec->info.pic_width;
+    dec->pic_height = dec->info.pic_height;
     /* Ensure correct offsets in chroma for formats that need it
      * by rounding the offset. libtheora will add proper pixels,
      * so no need to handle them ourselves. */
-    if (offset_x & 1 && dec->info.pixel_fmt != TH_PF_444)
-      offset_x--;
-    if (offset_y & 1 && dec->info.pixel_fmt == TH_PF_420)
-      offset_y--;
+    if (dec->offset_x & 1 && dec->info.pixel_fmt != TH_PF_444)
+      dec->offset_x--;
+    if (dec->offset_y & 1 && dec->info.pixel_fmt == TH_PF_420)
+      dec->offset_y--;
   } else {
     /* copy the whole frame */
-    offset_x = 0;
-    offset_y = 0;
-    pic_width = dec->info.frame_width;
-    pic_height = dec->info.frame_height;
+    dec->offset_x = 0;
+    dec->offset_y = 0;
+    dec->pic_width = dec->info.frame_width;
+    dec->pic_height = dec->info.frame_height;
 
     if (dec->info.pic_width != dec->info.frame_width ||
         dec->info.pic_height != dec->info.frame_height ||
@@ -716,35 +725,95 @@ theora_handle_image (GstTheoraDec * dec, th_ycbcr_buffer buf,
     }
   }
 
-  /* if only libtheora would allow us to give it a destination frame */
-  GST_CAT_TRACE_OBJECT (CAT_PERFORMANCE, dec,
-      "doing unavoidable video frame copy");
+  return GST_FLOW_OK;
+}
 
-  if (G_UNLIKELY (!gst_video_frame_map (&vframe, &dec->uncropped_info,
-              frame->output_buffer, GST_MAP_WRITE)))
-    goto invalid_frame;
+/* copy the rows @y0 to @y1 (exclusive, in luma rows of the decoded frame)
+ * of the image data into the output frame */
+static void
+theora_dec_copy_rows (GstTheoraDec * dec, GstVideoFrame * vframe,
+    th_ycbcr_buffer buf, gint y0, gint y1)
+{
+  gint width, height, stride;
+  gint i, comp;
+  gint offset_x, offset_y, first, last;
+  guint8 *dest, *src;
 
   for (comp = 0; comp < 3; comp++) {
     width =
-        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (vframe.info.finfo, comp, pic_width);
+        GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (vframe->info.finfo, comp,
+        dec->pic_width);
     height =
-        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vframe.info.finfo, comp,
-        pic_height);
-    stride = GST_VIDEO_FRAME_COMP_STRIDE (&vframe, comp);
-    dest = GST_VIDEO_FRAME_COMP_DATA (&vframe, comp);
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (vframe->info.finfo, comp,
+        dec->pic_height);
+    stride = GST_VIDEO_FRAME_COMP_STRIDE (vframe, comp);
+
+    offset_x = (width == dec->pic_width) ? dec->offset_x : dec->offset_x / 2;
+    if (height == dec->pic_height) {
+      offset_y = dec->offset_y;
+      first = y0;
+      last = y1;
+    } else {
+      offset_y = dec->offset_y / 2;
+      first = y0 / 2;
+      last = y1 / 2;
+    }
 
-    src = buf[comp].data;
-    src += ((height == pic_height) ? offset_y : offset_y / 2)
-        * buf[comp].stride;
-    src += (width == pic_width) ? offset_x : offset_x / 2;
+    /* only copy the rows that are part of the picture */
+    first = MAX (first, offset_y);
+    last = MIN (last, offset_y + height);
 
-    for (i = 0; i < height; i++) {
+    dest = GST_VIDEO_FRAME_COMP_DATA (vframe, comp);
+    dest += (first - offset_y) * stride;
+    src = buf[comp].data + first * buf[comp].stride + offset_x;
+
+    for (i = first; i < last; i++) {
       memcpy (dest, src, width);
 
       dest += stride;
       src += buf[comp].stride;
     }
   }
+}
+
+/* called by libtheora while decoding a packet, each time a stripe of the
+ * frame is done, including post-processing. Copying the stripe to the output
+ * frame right away does so while it's still in the cache. */
+static void
+theora_dec_stripe_decoded (void *ctx, th_ycbcr_buffer buf, int yfrag0,
+    int yfrag_end)
+{
+  GstTheoraDec *dec = ctx;
+
+  if (!dec->stripe_mapped)
+    return;
+
+  theora_dec_copy_rows (dec, &dec->stripe_frame, buf, yfrag0 * 8,
+      yfrag_end * 8);
+  dec->stripe_rows += (yfrag_end - yfrag0) * 8;
+}
+
+/* Allocate buffer and copy image data into Y444 format */
+static GstFlowReturn
+theora_handle_image (GstTheoraDec * dec, th_ycbcr_buffer buf,
+    GstVideoCodecFrame * frame)
+{
+  GstFlowReturn result;
+  GstVideoFrame vframe;
+
+  result = theora_dec_prepare_output (dec, frame);
+  if (G_UNLIKELY (result != GST_FLOW_OK))
+    return result;
+
+  /* if only libtheora would allow us to give it a destination frame */
+  GST_CAT_TRACE_OBJECT (CAT_PERFORMANCE, dec,
+      "doing unavoidable video frame copy");
+
+  if (G_UNLIKELY (!gst_video_frame_map (&vframe, &dec->uncropped_info,
+              frame->output_buffer, GST_MAP_WRITE)))
+    goto invalid_frame;
+
+  theora_dec_copy_rows (dec, &vframe, buf, 0, dec->info.frame_height);
   gst_video_frame_unmap (&vframe);
 
   return GST_FLOW_OK;
@@ -755,6 +824,15 @@ invalid_frame:
   }
 }
 
+static void
+theora_dec_unmap_stripe_frame (GstTheoraDec * dec)
+{
+  if (dec->stripe_mapped) {
+    gst_video_frame_unmap (&dec->stripe_frame);
+    dec->stripe_mapped = FALSE;
+  }
+}
+
 static GstFlowReturn
 theora_handle_data_packet (GstTheoraDec * dec, ogg_packet * packet,
     GstVideoCodecFrame * frame)
@@ -783,15 +861,39 @@ theora_handle_data_packet (GstTheoraDec * dec, ogg_packet * packet,
 
   GST_DEBUG_OBJECT (dec, "parsing data packet");
 
+  /* get the output frame first, so that the stripes of the frame can be
+   * written to it while libtheora decodes them */
+  dec->stripe_rows = 0;
+  if (frame && gst_video_decoder_get_max_decode_time (GST_VIDEO_DECODER (dec),
+          frame) >= 0) {
+    result = theora_dec_prepare_output (dec, frame);
+    if (G_UNLIKELY (result != GST_FLOW_OK))
+      return result;
+
+    dec->stripe_mapped = gst_video_frame_map (&dec->stripe_frame,
+        &dec->uncropped_info, frame->output_buffer, GST_MAP_WRITE);
+    if (G_UNLIKELY (!dec->stripe_mapped))
+      goto invalid_frame;
+  }
+
   /* this does the decoding */
-  if (G_UNLIKELY (th_decode_packetin (dec->decoder, packet, &gp) < 0))
+  if (G_UNLIKELY (th_decode_packetin (dec->decoder, packet, &gp) < 0)) {
+    theora_dec_unmap_stripe_frame (dec);
     goto decode_error;
+  }
+
+  theora_dec_unmap_stripe_frame (dec);
 
   if (frame &&
       (gst_video_decoder_get_max_decode_time (GST_VIDEO_DECODER (dec),
               frame) < 0))
     goto dropping_qos;
 
+  /* the whole frame was copied while decoding */
+  if (frame && frame->output_buffer
+      && dec->stripe_rows >= dec->info.frame_height)
+    return GST_FLOW_OK;
+
   /* this does postprocessing and set up the decoded frame
    * pointers in our yuv variable */
   if (G_UNLIKELY (th_decode_ycbcr_out (dec->decoder, buf) < 0))
@@ -801,6 +903,20 @@ theora_handle_data_packet (GstTheoraDec * dec, ogg_packet * packet,
           || (buf[0].height != dec->info.frame_height)))
     goto wrong_dimensions;
 
+  if (frame && frame->output_buffer) {
+    GstVideoFrame vframe;
+
+    /* libtheora did not decode anything, e.g. for a dropped frame packet,
+     * copy the image data it kept */
+    if (G_UNLIKELY (!gst_video_frame_map (&vframe, &dec->uncropped_info,
+                frame->output_buffer, GST_MAP_WRITE)))
+      goto invalid_frame;
+    theora_dec_copy_rows (dec, &vframe, buf, 0, dec->info.frame_height);
+    gst_video_frame_unmap (&vframe);
+
+    return GST_FLOW_OK;
+  }
+
   result = theora_handle_image (dec, buf, frame);
 
   return result;
@@ -828,6 +944,11 @@ decode_error:
         (NULL), ("theora decoder did not decode data packet"));
     return GST_FLOW_ERROR;
   }
+invalid_frame:
+  {
+    GST_DEBUG_OBJECT (dec, "could not map video frame");
+    return GST_FLOW_ERROR;
+  }
 no_yuv:
   {
     GST_ELEMENT_ERROR (GST_ELEMENT (dec), STREAM, DECODE,
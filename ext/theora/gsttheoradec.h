@@ -78,6 +78,15 @@ struct _GstTheoraDec
 
   gboolean can_crop;
   GstVideoInfo uncropped_info;
+
+  /* region of the decoded frame copied to the output */
+  gint offset_x, offset_y;
+  gint pic_width, pic_height;
+
+  /* output frame written to while decoding a packet */
+  GstVideoFrame stripe_frame;
+  gboolean stripe_mapped;
+  gint stripe_rows;
 };
 
 struct _GstTheoraDecClass
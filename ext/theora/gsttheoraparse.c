@@ -110,6 +110,62 @@ static gboolean theora_parse_sink_event (GstPad * pad, GstObject * parent,
 static gboolean theora_parse_src_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
 
+/* The stream info of the last few header sets, keyed by a checksum of the
+ * header packets, so chained streams repeating the same headers don't have
+ * to decode the setup header (huffman and quantisation tables) again */
+typedef struct
+{
+  gchar *checksum;
+  th_info info;
+} TheoraParseCachedInfo;
+
+#define THEORA_PARSE_INFO_CACHE_SIZE 8
+
+static GMutex info_cache_lock;
+static GQueue info_cache = G_QUEUE_INIT;        /* most recent first */
+
+static gboolean
+theora_parse_lookup_info (const gchar * checksum, th_info * info)
+{
+  gboolean found = FALSE;
+  GList *l;
+
+  g_mutex_lock (&info_cache_lock);
+  for (l = info_cache.head; l; l = l->next) {
+    TheoraParseCachedInfo *cached = l->data;
+
+    if (g_str_equal (cached->checksum, checksum)) {
+      g_queue_unlink (&info_cache, l);
+      g_queue_push_head_link (&info_cache, l);
+      *info = cached->info;
+      found = TRUE;
+      break;
+    }
+  }
+  g_mutex_unlock (&info_cache_lock);
+
+  return found;
+}
+
+static void
+theora_parse_cache_info (const gchar * checksum, const th_info * info)
+{
+  TheoraParseCachedInfo *cached;
+
+  cached = g_slice_new (TheoraParseCachedInfo);
+  cached->checksum = g_strdup (checksum);
+  cached->info = *info;
+
+  g_mutex_lock (&info_cache_lock);
+  g_queue_push_head (&info_cache, cached);
+  while (info_cache.length > THEORA_PARSE_INFO_CACHE_SIZE) {
+    cached = g_queue_pop_tail (&info_cache);
+    g_free (cached->checksum);
+    g_slice_free (TheoraParseCachedInfo, cached);
+  }
+  g_mutex_unlock (&info_cache_lock);
+}
+
 static void
 gst_theora_parse_class_init (GstTheoraParseClass * klass)
 {
@@ -295,6 +351,8 @@ theora_parse_set_streamheader (GstTheoraParse * parse)
   gint i;
   guint32 bitstream_version;
   th_setup_info *setup = NULL;
+  GChecksum *checksum;
+  gboolean cacheable = TRUE;
 
   g_assert (!parse->streamheader_received);
 
@@ -304,6 +362,25 @@ theora_parse_set_streamheader (GstTheoraParse * parse)
   gst_pad_set_caps (parse->srcpad, caps);
   gst_caps_unref (caps);
 
+  checksum = g_checksum_new (G_CHECKSUM_SHA1);
+  for (i = 0; i < 3; i++) {
+    GstMapInfo map;
+
+    if (parse->streamheader[i] == NULL) {
+      cacheable = FALSE;
+      continue;
+    }
+    gst_buffer_map (parse->streamheader[i], &map, GST_MAP_READ);
+    g_checksum_update (checksum, map.data, map.size);
+    gst_buffer_unmap (parse->streamheader[i], &map);
+  }
+
+  if (cacheable && theora_parse_lookup_info (g_checksum_get_string (checksum),
+          &parse->info)) {
+    GST_DEBUG_OBJECT (parse, "reusing parsed stream info");
+    goto done;
+  }
+
   for (i = 0; i < 3; i++) {
     ogg_packet packet;
     GstBuffer *buf;
@@ -326,12 +403,19 @@ theora_parse_set_streamheader (GstTheoraParse * parse)
     if (ret < 0) {
       GST_WARNING_OBJECT (parse, "Failed to decode Theora header %d: %d",
           i + 1, ret);
+      cacheable = FALSE;
     }
   }
   if (setup) {
     th_setup_free (setup);
   }
 
+  if (cacheable)
+    theora_parse_cache_info (g_checksum_get_string (checksum), &parse->info);
+
+done:
+  g_checksum_free (checksum);
+
   parse->fps_n = parse->info.fps_numerator;
   parse->fps_d = parse->info.fps_denominator;
   parse->shift = parse->info.keyframe_granule_shift;
@@ -79,6 +79,9 @@ static GstFlowReturn vorbis_dec_handle_frame (GstAudioDecoder * dec,
 static void vorbis_dec_flush (GstAudioDecoder * dec, gboolean hard);
 static gboolean vorbis_dec_set_format (GstAudioDecoder * dec, GstCaps * caps);
 static void vorbis_dec_reset (GstAudioDecoder * dec);
+#ifndef TREMOR
+static void vorbis_dec_clear_pool (GstVorbisDec * vd);
+#endif
 
 static void
 gst_vorbis_dec_class_init (GstVorbisDecClass * klass)
@@ -158,6 +161,9 @@ vorbis_dec_stop (GstAudioDecoder * dec)
   vorbis_dsp_clear (&vd->vd);
   vorbis_comment_clear (&vd->vc);
   vorbis_info_clear (&vd->vi);
+#ifndef TREMOR
+  vorbis_dec_clear_pool (vd);
+#endif
   if (vd->pending_headers) {
     g_list_free_full (vd->pending_headers, (GDestroyNotify) gst_buffer_unref);
     vd->pending_headers = NULL;
@@ -166,6 +172,111 @@ vorbis_dec_stop (GstAudioDecoder * dec)
   return TRUE;
 }
 
+#ifndef TREMOR
+static void
+vorbis_dec_clear_pool (GstVorbisDec * vd)
+{
+  if (vd->pool) {
+    gst_buffer_pool_set_active (vd->pool, FALSE);
+    gst_object_unref (vd->pool);
+    vd->pool = NULL;
+  }
+  vd->pool_size = 0;
+}
+
+/* Set up a pool of buffers big enough for the output of any packet of the
+ * stream, using the allocator negotiated by the base class */
+static void
+vorbis_dec_setup_pool (GstVorbisDec * vd)
+{
+  GstAllocator *allocator;
+  GstAllocationParams params;
+  GstStructure *config;
+  glong blocksize;
+
+  blocksize = vorbis_info_blocksize (&vd->vi, 1);
+  if (blocksize <= 0)
+    return;
+
+  vd->pool_size = (blocksize / 2) * vd->info.bpf;
+  vd->pool = gst_buffer_pool_new ();
+
+  gst_audio_decoder_get_allocator (GST_AUDIO_DECODER (vd), &allocator,
+      &params);
+  config = gst_buffer_pool_get_config (vd->pool);
+  gst_buffer_pool_config_set_params (config, NULL, vd->pool_size, 0, 0);
+  gst_buffer_pool_config_set_allocator (config, allocator, &params);
+  if (allocator)
+    gst_object_unref (allocator);
+
+  if (!gst_buffer_pool_set_config (vd->pool, config)
+      || !gst_buffer_pool_set_active (vd->pool, TRUE)) {
+    GST_WARNING_OBJECT (vd, "failed to set up output buffer pool");
+    gst_object_unref (vd->pool);
+    vd->pool = NULL;
+    return;
+  }
+
+  GST_DEBUG_OBJECT (vd, "using output buffer pool of %" G_GSIZE_FORMAT
+      " bytes", vd->pool_size);
+}
+
+static GstBuffer *
+vorbis_dec_allocate_output_buffer (GstVorbisDec * vd, gsize size)
+{
+  GstBuffer *out = NULL;
+
+  if (G_UNLIKELY (vd->pool_size == 0)) {
+    /* the first allocation negotiates the allocator */
+    out = gst_audio_decoder_allocate_output_buffer (GST_AUDIO_DECODER (vd),
+        size);
+    vorbis_dec_setup_pool (vd);
+    return out;
+  }
+
+  if (vd->pool && size <= vd->pool_size &&
+      gst_buffer_pool_acquire_buffer (vd->pool, &out, NULL) == GST_FLOW_OK) {
+    gst_buffer_resize (out, 0, size);
+    return out;
+  }
+
+  return gst_audio_decoder_allocate_output_buffer (GST_AUDIO_DECODER (vd),
+      size);
+}
+
+/* Only output non-interleaved audio if downstream prefers it, for example
+ * because of a capsfilter with layout=non-interleaved */
+static GstAudioLayout
+vorbis_dec_get_output_layout (GstVorbisDec * vd)
+{
+  GstAudioLayout layout = GST_AUDIO_LAYOUT_INTERLEAVED;
+  GstPad *srcpad = GST_AUDIO_DECODER_SRC_PAD (vd);
+  GstCaps *peercaps, *templ;
+
+  templ = gst_pad_get_pad_template_caps (srcpad);
+  peercaps = gst_pad_peer_query_caps (srcpad, templ);
+  gst_caps_unref (templ);
+
+  if (peercaps && !gst_caps_is_empty (peercaps)) {
+    GstStructure *s;
+    const gchar *str;
+
+    peercaps = gst_caps_make_writable (peercaps);
+    s = gst_caps_get_structure (peercaps, 0);
+    if (gst_structure_has_field (s, "layout")) {
+      gst_structure_fixate_field_string (s, "layout", "interleaved");
+      str = gst_structure_get_string (s, "layout");
+      if (g_strcmp0 (str, "non-interleaved") == 0)
+        layout = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+    }
+  }
+  if (peercaps)
+    gst_caps_unref (peercaps);
+
+  return layout;
+}
+#endif
+
 static GstFlowReturn
 vorbis_handle_identification_packet (GstVorbisDec * vd)
 {
@@ -202,12 +313,27 @@ vorbis_handle_identification_packet (GstVorbisDec * vd)
     }
   }
 
+#ifndef TREMOR
+  info.layout = vorbis_dec_get_output_layout (vd);
+  GST_DEBUG_OBJECT (vd, "using %s output",
+      info.layout == GST_AUDIO_LAYOUT_INTERLEAVED ? "interleaved" :
+      "non-interleaved");
+
+  /* the block sizes might have changed too */
+  vorbis_dec_clear_pool (vd);
+#endif
+
   gst_audio_decoder_set_output_format (GST_AUDIO_DECODER (vd), &info);
 
   vd->info = info;
   /* select a copy_samples function, this way we can have specialized versions
    * for mono/stereo and avoid the depth switch in tremor case */
-  vd->copy_samples = gst_vorbis_get_copy_sample_func (info.channels);
+#ifndef TREMOR
+  if (info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    vd->copy_samples = gst_vorbis_get_copy_sample_planar_func (info.channels);
+  else
+#endif
+    vd->copy_samples = gst_vorbis_get_copy_sample_func (info.channels);
 
   return GST_FLOW_OK;
 }
@@ -492,7 +618,11 @@ vorbis_handle_data_packet (GstVorbisDec * vd, ogg_packet * packet,
       sample_count, size);
 
   /* alloc buffer for it */
+#ifndef TREMOR
+  out = vorbis_dec_allocate_output_buffer (vd, size);
+#else
   out = gst_audio_decoder_allocate_output_buffer (GST_AUDIO_DECODER (vd), size);
+#endif
 
   gst_buffer_map (out, &map, GST_MAP_WRITE);
   /* get samples ready for reading now, should be sample_count */
@@ -518,6 +648,11 @@ vorbis_handle_data_packet (GstVorbisDec * vd, ogg_packet * packet,
   GST_LOG_OBJECT (vd, "have output size of %" G_GSIZE_FORMAT, size);
   gst_buffer_unmap (out, &map);
 
+#ifndef TREMOR
+  if (vd->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    gst_buffer_add_audio_meta (out, &vd->info, sample_count, NULL);
+#endif
+
 done:
   /* whether or not data produced, consume one frame and advance time */
   result = gst_audio_decoder_finish_frame (GST_AUDIO_DECODER (vd), out, 1);
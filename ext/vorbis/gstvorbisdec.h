@@ -66,6 +66,12 @@ struct _GstVorbisDec {
 
   CopySampleFunc    copy_samples;
 
+#ifndef TREMOR
+  /* output buffers sized for the longest block of the stream */
+  GstBufferPool    *pool;
+  gsize             pool_size;
+#endif
+
   GList            *pending_headers;
 };
 
@@ -32,7 +32,12 @@
 
 #ifndef TREMOR
 /* These samples can be outside of the float -1.0 -- 1.0 range, this
- * is allowed, downstream elements are supposed to clip */
+ * is allowed, downstream elements are supposed to clip.
+ *
+ * The interleaving functions for the common channel counts load the
+ * (reordered) channel pointers once and write a whole frame per iteration
+ * so the compiler can keep everything in registers and vectorise the loop,
+ * instead of indexing through the reorder map for every sample. */
 static void
 copy_samples_m (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
     gint channels)
@@ -44,63 +49,121 @@ static void
 copy_samples_s (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
     gint channels)
 {
-#ifdef GST_VORBIS_DEC_SEQUENTIAL
-  memcpy (out, in[0], samples * sizeof (float));
-  out += samples;
-  memcpy (out, in[1], samples * sizeof (float));
-#else
-  gint j;
+  const vorbis_sample_t *c0 = in[0], *c1 = in[1];
+  guint j;
 
   for (j = 0; j < samples; j++) {
-    *out++ = in[0][j];
-    *out++ = in[1][j];
+    out[0] = c0[j];
+    out[1] = c1[j];
+    out += 2;
+  }
+}
+
+static void
+copy_samples_6 (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
+    gint channels)
+{
+  const gint *map = gst_vorbis_reorder_map[5];
+  const vorbis_sample_t *c0 = in[map[0]], *c1 = in[map[1]], *c2 = in[map[2]];
+  const vorbis_sample_t *c3 = in[map[3]], *c4 = in[map[4]], *c5 = in[map[5]];
+  guint j;
+
+  for (j = 0; j < samples; j++) {
+    out[0] = c0[j];
+    out[1] = c1[j];
+    out[2] = c2[j];
+    out[3] = c3[j];
+    out[4] = c4[j];
+    out[5] = c5[j];
+    out += 6;
+  }
+}
+
+static void
+copy_samples_8 (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
+    gint channels)
+{
+  const gint *map = gst_vorbis_reorder_map[7];
+  const vorbis_sample_t *c0 = in[map[0]], *c1 = in[map[1]], *c2 = in[map[2]];
+  const vorbis_sample_t *c3 = in[map[3]], *c4 = in[map[4]], *c5 = in[map[5]];
+  const vorbis_sample_t *c6 = in[map[6]], *c7 = in[map[7]];
+  guint j;
+
+  for (j = 0; j < samples; j++) {
+    out[0] = c0[j];
+    out[1] = c1[j];
+    out[2] = c2[j];
+    out[3] = c3[j];
+    out[4] = c4[j];
+    out[5] = c5[j];
+    out[6] = c6[j];
+    out[7] = c7[j];
+    out += 8;
   }
-#endif
 }
 
 static void
 copy_samples (vorbis_sample_t * out, vorbis_sample_t ** in, guint samples,
     gint channels)
 {
-#ifdef GST_VORBIS_DEC_SEQUENTIAL
+  const gint *map = gst_vorbis_reorder_map[channels - 1];
   gint i;
+  guint j;
 
+  /* one channel at a time, strided writes into the output */
   for (i = 0; i < channels; i++) {
-    memcpy (out, in[gst_vorbis_reorder_map[channels - 1][i]],
-        samples * sizeof (float));
-    out += samples;
-  }
-#else
-  gint i, j;
+    const vorbis_sample_t *c = in[map[i]];
+    vorbis_sample_t *o = out + i;
 
-  for (j = 0; j < samples; j++) {
-    for (i = 0; i < channels; i++) {
-      *out++ = in[gst_vorbis_reorder_map[channels - 1][i]][j];
+    for (j = 0; j < samples; j++) {
+      *o = c[j];
+      o += channels;
     }
   }
-#endif
 }
 
 static void
 copy_samples_no_reorder (vorbis_sample_t * out, vorbis_sample_t ** in,
     guint samples, gint channels)
 {
-#ifdef GST_VORBIS_DEC_SEQUENTIAL
   gint i;
+  guint j;
 
   for (i = 0; i < channels; i++) {
-    memcpy (out, in[i], samples * sizeof (float));
+    const vorbis_sample_t *c = in[i];
+    vorbis_sample_t *o = out + i;
+
+    for (j = 0; j < samples; j++) {
+      *o = c[j];
+      o += channels;
+    }
+  }
+}
+
+/* non-interleaved output, the planes are stored one after the other */
+static void
+copy_samples_planar (vorbis_sample_t * out, vorbis_sample_t ** in,
+    guint samples, gint channels)
+{
+  gint i;
+
+  for (i = 0; i < channels; i++) {
+    memcpy (out, in[gst_vorbis_reorder_map[channels - 1][i]],
+        samples * sizeof (float));
     out += samples;
   }
-#else
-  gint i, j;
+}
 
-  for (j = 0; j < samples; j++) {
-    for (i = 0; i < channels; i++) {
-      *out++ = in[i][j];
-    }
+static void
+copy_samples_planar_no_reorder (vorbis_sample_t * out, vorbis_sample_t ** in,
+    guint samples, gint channels)
+{
+  gint i;
+
+  for (i = 0; i < channels; i++) {
+    memcpy (out, in[i], samples * sizeof (float));
+    out += samples;
   }
-#endif
 }
 
 CopySampleFunc
@@ -115,12 +178,16 @@ gst_vorbis_get_copy_sample_func (gint channels)
     case 2:
       f = copy_samples_s;
       break;
+    case 6:
+      f = copy_samples_6;
+      break;
+    case 8:
+      f = copy_samples_8;
+      break;
     case 3:
     case 4:
     case 5:
-    case 6:
     case 7:
-    case 8:
       f = copy_samples;
       break;
     default:
@@ -131,6 +198,15 @@ gst_vorbis_get_copy_sample_func (gint channels)
   return f;
 }
 
+CopySampleFunc
+gst_vorbis_get_copy_sample_planar_func (gint channels)
+{
+  if (channels >= 3 && channels <= 8)
+    return copy_samples_planar;
+
+  return copy_samples_planar_no_reorder;
+}
+
 #else
 
 /* Taken from Tremor, misc.h */
@@ -39,7 +39,8 @@
     GST_STATIC_CAPS ("audio/x-raw, "  \
         "format = (string)" GST_VORBIS_AUDIO_FORMAT_STR ", "     \
         "rate = (int) [ 1, MAX ], "   \
-        "channels = (int) [ 1, 256 ]")
+        "channels = (int) [ 1, 256 ], " \
+        "layout = (string) { interleaved, non-interleaved }")
 
 #define GST_VORBIS_DEC_DEFAULT_SAMPLE_WIDTH           (32)
 
@@ -190,4 +191,8 @@ typedef void (*CopySampleFunc)(vorbis_sample_t *out, vorbis_sample_t **in,
 
 CopySampleFunc gst_vorbis_get_copy_sample_func (gint channels);
 
+#ifndef TREMOR
+CopySampleFunc gst_vorbis_get_copy_sample_planar_func (gint channels);
+#endif
+
 #endif /* __GST_VORBIS_DEC_LIB_H__ */
@@ -88,6 +88,125 @@ static gboolean vorbis_parse_convert (GstPad * pad, GstFormat src_format,
 static GstFlowReturn vorbis_parse_parse_packet (GstVorbisParse * parse,
     GstBuffer * buf);
 
+/* Parsed header state, keyed by a checksum of the three header packets.
+ * Decoding the setup header builds all the codebooks, which is expensive for
+ * chained streams where every chain repeats the same headers, so the last
+ * few parsed sets are kept around and shared (read-only) between instances */
+struct _GstVorbisParseHeaders
+{
+  gint refcount;
+  gchar *checksum;
+  vorbis_info vi;
+  vorbis_comment vc;
+};
+
+#define VORBIS_PARSE_HEADER_CACHE_SIZE 8
+
+static GMutex header_cache_lock;
+static GQueue header_cache = G_QUEUE_INIT;      /* most recent first */
+
+static GstVorbisParseHeaders *
+vorbis_parse_headers_ref (GstVorbisParseHeaders * headers)
+{
+  g_atomic_int_inc (&headers->refcount);
+  return headers;
+}
+
+static void
+vorbis_parse_headers_unref (GstVorbisParseHeaders * headers)
+{
+  if (g_atomic_int_dec_and_test (&headers->refcount)) {
+    vorbis_info_clear (&headers->vi);
+    vorbis_comment_clear (&headers->vc);
+    g_free (headers->checksum);
+    g_slice_free (GstVorbisParseHeaders, headers);
+  }
+}
+
+static GstVorbisParseHeaders *
+vorbis_parse_lookup_headers (const gchar * checksum)
+{
+  GstVorbisParseHeaders *headers = NULL;
+  GList *l;
+
+  g_mutex_lock (&header_cache_lock);
+  for (l = header_cache.head; l; l = l->next) {
+    GstVorbisParseHeaders *h = l->data;
+
+    if (g_str_equal (h->checksum, checksum)) {
+      g_queue_unlink (&header_cache, l);
+      g_queue_push_head_link (&header_cache, l);
+      headers = vorbis_parse_headers_ref (h);
+      break;
+    }
+  }
+  g_mutex_unlock (&header_cache_lock);
+
+  return headers;
+}
+
+static void
+vorbis_parse_cache_headers (GstVorbisParseHeaders * headers)
+{
+  g_mutex_lock (&header_cache_lock);
+  g_queue_push_head (&header_cache, vorbis_parse_headers_ref (headers));
+  while (header_cache.length > VORBIS_PARSE_HEADER_CACHE_SIZE)
+    vorbis_parse_headers_unref (g_queue_pop_tail (&header_cache));
+  g_mutex_unlock (&header_cache_lock);
+}
+
+static GstVorbisParseHeaders *
+vorbis_parse_decode_headers (GstVorbisParse * parse, GstBuffer ** bufs)
+{
+  GstVorbisParseHeaders *headers;
+  GChecksum *checksum;
+  gboolean ok = TRUE;
+  GstMapInfo map;
+  gint i;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA1);
+  for (i = 0; i < 3; i++) {
+    gst_buffer_map (bufs[i], &map, GST_MAP_READ);
+    g_checksum_update (checksum, map.data, map.size);
+    gst_buffer_unmap (bufs[i], &map);
+  }
+
+  headers = vorbis_parse_lookup_headers (g_checksum_get_string (checksum));
+  if (headers) {
+    GST_DEBUG_OBJECT (parse, "reusing parsed headers %s", headers->checksum);
+    g_checksum_free (checksum);
+    return headers;
+  }
+
+  headers = g_slice_new0 (GstVorbisParseHeaders);
+  headers->refcount = 1;
+  headers->checksum = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+  vorbis_info_init (&headers->vi);
+  vorbis_comment_init (&headers->vc);
+
+  for (i = 0; i < 3; i++) {
+    ogg_packet packet;
+
+    gst_buffer_map (bufs[i], &map, GST_MAP_READ);
+    packet.packet = map.data;
+    packet.bytes = map.size;
+    packet.granulepos = GST_BUFFER_OFFSET_END (bufs[i]);
+    packet.packetno = i + 1;
+    packet.e_o_s = 0;
+    packet.b_o_s = (i == 0);
+    if (vorbis_synthesis_headerin (&headers->vi, &headers->vc, &packet) < 0)
+      ok = FALSE;
+    gst_buffer_unmap (bufs[i], &map);
+  }
+
+  /* only share headers libvorbis fully accepted */
+  if (ok)
+    vorbis_parse_cache_headers (headers);
+
+  return headers;
+}
+
 static void
 gst_vorbis_parse_class_init (GstVorbisParseClass * klass)
 {
@@ -197,9 +316,7 @@ vorbis_parse_push_headers (GstVorbisParse * parse)
 {
   /* mark and put on caps */
   GstCaps *caps;
-  GstBuffer *outbuf, *outbuf1, *outbuf2, *outbuf3;
-  ogg_packet packet;
-  GstMapInfo map;
+  GstBuffer *bufs[3];
   const gchar *hdr_name;
 
   /* Check we have enough header packets, and the right ones */
@@ -215,43 +332,15 @@ vorbis_parse_push_headers (GstVorbisParse * parse)
   if (!vorbis_parse_have_header_packet (parse, 5))
     goto missing_header;
 
-  outbuf = GST_BUFFER_CAST (parse->streamheader->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 1;
-  packet.e_o_s = 0;
-  packet.b_o_s = 1;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  parse->sample_rate = parse->vi.rate;
-  parse->channels = parse->vi.channels;
-  outbuf1 = outbuf;
-
-  outbuf = GST_BUFFER_CAST (parse->streamheader->next->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 2;
-  packet.e_o_s = 0;
-  packet.b_o_s = 0;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  outbuf2 = outbuf;
+  bufs[0] = GST_BUFFER_CAST (parse->streamheader->data);
+  bufs[1] = GST_BUFFER_CAST (parse->streamheader->next->data);
+  bufs[2] = GST_BUFFER_CAST (parse->streamheader->next->next->data);
 
-  outbuf = GST_BUFFER_CAST (parse->streamheader->next->next->data);
-  gst_buffer_map (outbuf, &map, GST_MAP_READ);
-  packet.packet = map.data;
-  packet.bytes = map.size;
-  packet.granulepos = GST_BUFFER_OFFSET_END (outbuf);
-  packet.packetno = 3;
-  packet.e_o_s = 0;
-  packet.b_o_s = 0;
-  vorbis_synthesis_headerin (&parse->vi, &parse->vc, &packet);
-  gst_buffer_unmap (outbuf, &map);
-  outbuf3 = outbuf;
+  if (parse->headers)
+    vorbis_parse_headers_unref (parse->headers);
+  parse->headers = vorbis_parse_decode_headers (parse, bufs);
+  parse->sample_rate = parse->headers->vi.rate;
+  parse->channels = parse->headers->vi.channels;
 
   /* get the headers into the caps, passing them to vorbis as we go */
   caps = gst_caps_new_simple ("audio/x-vorbis",
@@ -266,9 +355,9 @@ vorbis_parse_push_headers (GstVorbisParse * parse)
   vorbis_parse_drain_event_queue (parse);
 
   /* push out buffers, ignoring return value... */
-  gst_pad_push (parse->srcpad, outbuf1);
-  gst_pad_push (parse->srcpad, outbuf2);
-  gst_pad_push (parse->srcpad, outbuf3);
+  gst_pad_push (parse->srcpad, bufs[0]);
+  gst_pad_push (parse->srcpad, bufs[1]);
+  gst_pad_push (parse->srcpad, bufs[2]);
 
   g_list_free (parse->streamheader);
   parse->streamheader = NULL;
@@ -403,7 +492,7 @@ vorbis_parse_queue_buffer (GstVorbisParse * parse, GstBuffer * buf)
   packet.packetno = parse->packetno + parse->buffer_queue->length;
   packet.e_o_s = 0;
 
-  blocksize = vorbis_packet_blocksize (&parse->vi, &packet);
+  blocksize = vorbis_packet_blocksize (&parse->headers->vi, &packet);
   gst_buffer_unmap (buf, &map);
 
   /* temporarily store the sample count in OFFSET -- we overwrite this later */
@@ -549,10 +638,10 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_TIME:
       switch (*dest_format) {
         case GST_FORMAT_BYTES:
-          scale = sizeof (float) * parse->vi.channels;
+          scale = sizeof (float) * parse->channels;
         case GST_FORMAT_DEFAULT:
           *dest_value =
-              scale * gst_util_uint64_scale_int (src_value, parse->vi.rate,
+              scale * gst_util_uint64_scale_int (src_value, parse->sample_rate,
               GST_SECOND);
           break;
         default:
@@ -562,11 +651,12 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_DEFAULT:
       switch (*dest_format) {
         case GST_FORMAT_BYTES:
-          *dest_value = src_value * sizeof (float) * parse->vi.channels;
+          *dest_value = src_value * sizeof (float) * parse->channels;
           break;
         case GST_FORMAT_TIME:
           *dest_value =
-              gst_util_uint64_scale_int (src_value, GST_SECOND, parse->vi.rate);
+              gst_util_uint64_scale_int (src_value, GST_SECOND,
+              parse->sample_rate);
           break;
         default:
           res = FALSE;
@@ -575,11 +665,11 @@ vorbis_parse_convert (GstPad * pad,
     case GST_FORMAT_BYTES:
       switch (*dest_format) {
         case GST_FORMAT_DEFAULT:
-          *dest_value = src_value / (sizeof (float) * parse->vi.channels);
+          *dest_value = src_value / (sizeof (float) * parse->channels);
           break;
         case GST_FORMAT_TIME:
           *dest_value = gst_util_uint64_scale_int (src_value, GST_SECOND,
-              parse->vi.rate * sizeof (float) * parse->vi.channels);
+              parse->sample_rate * sizeof (float) * parse->channels);
           break;
         default:
           res = FALSE;
@@ -676,8 +766,6 @@ vorbis_parse_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_READY_TO_PAUSED:
-      vorbis_info_init (&parse->vi);
-      vorbis_comment_init (&parse->vc);
       parse->prev_granulepos = -1;
       parse->prev_blocksize = -1;
       parse->packetno = 0;
@@ -693,8 +781,10 @@ vorbis_parse_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
-      vorbis_info_clear (&parse->vi);
-      vorbis_comment_clear (&parse->vc);
+      if (parse->headers) {
+        vorbis_parse_headers_unref (parse->headers);
+        parse->headers = NULL;
+      }
       vorbis_parse_clear_queue (parse);
       g_queue_free (parse->buffer_queue);
       parse->buffer_queue = NULL;
@@ -41,6 +41,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstVorbisParse GstVorbisParse;
 typedef struct _GstVorbisParseClass GstVorbisParseClass;
+typedef struct _GstVorbisParseHeaders GstVorbisParseHeaders;
 
 /**
  * GstVorbisParse:
@@ -60,8 +61,8 @@ struct _GstVorbisParse {
   GQueue *		event_queue;
   GQueue *		buffer_queue;
 
-  vorbis_info		vi;
-  vorbis_comment	vc;
+  /* parsed headers, shared with other instances */
+  GstVorbisParseHeaders *headers;
 
   gint64		prev_granulepos;
   gint32		prev_blocksize;
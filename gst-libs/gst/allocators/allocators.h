@@ -25,6 +25,7 @@
 #include <gst/allocators/allocators-prelude.h>
 
 #include <gst/allocators/gstdmabuf.h>
+#include <gst/allocators/gstdmabufheap.h>
 #include <gst/allocators/gstfdmemory.h>
 #include <gst/allocators/gstphysmemory.h>
 
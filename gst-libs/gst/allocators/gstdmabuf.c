@@ -31,9 +31,23 @@
  * @short_description: Memory wrapper for Linux dmabuf memory
  * @see_also: #GstMemory
  *
+ * Since 1.18, dmabuf memory can carry an explicit fence in the form of a
+ * sync_file file descriptor, set by the producer with
+ * gst_dmabuf_memory_set_fence() once it has queued the work that writes the
+ * memory. Mapping the memory waits for that fence, and for the implicit fences
+ * the kernel tracks on the dmabuf itself. Consumers that don't want to block
+ * can instead check with gst_dmabuf_memory_wait() and a zero timeout, or poll
+ * the fence returned by gst_dmabuf_memory_get_fence() from their own main loop.
+ *
  * Since: 1.2
  */
 
+#include <errno.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
 #ifdef HAVE_LINUX_DMA_BUF_H
 #include <sys/ioctl.h>
 #include <linux/dma-buf.h>
@@ -49,6 +63,91 @@ GST_DEBUG_CATEGORY_STATIC (dmabuf_debug);
 G_DEFINE_TYPE_WITH_CODE (GstDmaBufAllocator, gst_dmabuf_allocator,
     GST_TYPE_FD_ALLOCATOR, _do_init);
 
+static GQuark
+gst_dmabuf_fence_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstDmaBufMemoryFence");
+
+  return quark;
+}
+
+/* shared memories all refer to the dmabuf of their root parent, which is
+ * where the fence is stored */
+static GstMemory *
+gst_dmabuf_memory_get_root (GstMemory * mem)
+{
+  while (mem->parent)
+    mem = mem->parent;
+
+  return mem;
+}
+
+static void
+gst_dmabuf_fence_close (gpointer data)
+{
+#ifdef HAVE_UNISTD_H
+  close (GPOINTER_TO_INT (data) - 1);
+#endif
+}
+
+static gint
+gst_dmabuf_get_fence_unlocked (GstMemory * root)
+{
+  return GPOINTER_TO_INT (gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST
+          (root), gst_dmabuf_fence_quark ())) - 1;
+}
+
+static gboolean
+gst_dmabuf_poll (gint fd, gushort events, gint timeout_ms)
+{
+  GPollFD pfd;
+  gint ret;
+
+  pfd.fd = fd;
+  pfd.events = events;
+  pfd.revents = 0;
+
+  do {
+    ret = g_poll (&pfd, 1, timeout_ms);
+  } while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+
+  if (ret < 0) {
+    GST_WARNING ("Failed to poll fd %d: %s", fd, g_strerror (errno));
+    /* don't block forever on a broken fence */
+    return TRUE;
+  }
+
+  return ret > 0;
+}
+
+static gboolean
+gst_dmabuf_memory_wait_internal (GstMemory * mem, GstMapFlags flags,
+    gint timeout_ms)
+{
+  GstMemory *root = gst_dmabuf_memory_get_root (mem);
+  gint fence;
+
+  fence = gst_dmabuf_get_fence_unlocked (root);
+  if (fence >= 0) {
+    if (!gst_dmabuf_poll (fence, G_IO_IN, timeout_ms))
+      return FALSE;
+
+    /* a signalled fence stays signalled, no need to keep it around, unless
+     * it was replaced meanwhile */
+    if (gst_dmabuf_get_fence_unlocked (root) == fence)
+      gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (root),
+          gst_dmabuf_fence_quark (), NULL, NULL);
+  }
+
+  /* the dmabuf fd itself is readable once pending writes are done and
+   * writable once all pending accesses are */
+  return gst_dmabuf_poll (gst_fd_memory_get_fd (root),
+      (flags & GST_MAP_WRITE) ? G_IO_OUT : G_IO_IN, timeout_ms);
+}
+
 static gpointer
 gst_dmabuf_mem_map (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
 {
@@ -57,6 +156,14 @@ gst_dmabuf_mem_map (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
 
 #ifdef HAVE_LINUX_DMA_BUF_H
   struct dma_buf_sync sync = { DMA_BUF_SYNC_START };
+#endif
+
+  /* the kernel only knows about implicit fences, wait for the explicit one
+   * before handing out the data */
+  if (gst_dmabuf_get_fence_unlocked (gst_dmabuf_memory_get_root (gmem)) >= 0)
+    gst_dmabuf_memory_wait_internal (gmem, info->flags, -1);
+
+#ifdef HAVE_LINUX_DMA_BUF_H
 
   if (info->flags & GST_MAP_READ)
     sync.flags |= DMA_BUF_SYNC_READ;
@@ -223,3 +330,87 @@ gst_is_dmabuf_memory (GstMemory * mem)
 
   return GST_IS_DMABUF_ALLOCATOR (mem->allocator);
 }
+
+/**
+ * gst_dmabuf_memory_set_fence:
+ * @mem: a dmabuf #GstMemory
+ * @fence_fd: a sync_file file descriptor, or -1
+ *
+ * Attach the fence @fence_fd to @mem. It has to signal once all the pending
+ * work writing to @mem is finished. @mem takes ownership of @fence_fd and
+ * closes it once the fence has been waited for or replaced. Any previous
+ * fence of @mem is released, so @fence_fd has to include it if it didn't
+ * signal yet. Passing -1 removes the fence.
+ *
+ * Fences set on shared memory apply to the whole dmabuf.
+ *
+ * Since: 1.18
+ */
+void
+gst_dmabuf_memory_set_fence (GstMemory * mem, gint fence_fd)
+{
+  g_return_if_fail (gst_is_dmabuf_memory (mem));
+
+  if (fence_fd < 0) {
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (gst_dmabuf_memory_get_root
+            (mem)), gst_dmabuf_fence_quark (), NULL, NULL);
+  } else {
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (gst_dmabuf_memory_get_root
+            (mem)), gst_dmabuf_fence_quark (), GINT_TO_POINTER (fence_fd + 1),
+        gst_dmabuf_fence_close);
+  }
+}
+
+/**
+ * gst_dmabuf_memory_get_fence:
+ * @mem: a dmabuf #GstMemory
+ *
+ * Get the fence that was set on @mem with gst_dmabuf_memory_set_fence() and
+ * that hasn't been waited for yet. It can be polled for reading, waited for on
+ * the GPU, or merged into the fence of a new producer.
+ *
+ * Returns: the sync_file file descriptor of the fence of @mem, or -1. It is
+ *     still owned by @mem, use dup to keep it beyond the lifetime of the fence.
+ *
+ * Since: 1.18
+ */
+gint
+gst_dmabuf_memory_get_fence (GstMemory * mem)
+{
+  g_return_val_if_fail (gst_is_dmabuf_memory (mem), -1);
+
+  return gst_dmabuf_get_fence_unlocked (gst_dmabuf_memory_get_root (mem));
+}
+
+/**
+ * gst_dmabuf_memory_wait:
+ * @mem: a dmabuf #GstMemory
+ * @flags: the #GstMapFlags of the access to wait for
+ * @timeout: maximum time to wait, or %GST_CLOCK_TIME_NONE
+ *
+ * Wait until @mem can be accessed with @flags without blocking, that is until
+ * its explicit fence and the implicit fences of the dmabuf signalled. Reading
+ * has to wait for pending writes only, writing for all pending accesses.
+ *
+ * With a @timeout of 0, this only checks if @mem is ready, which lets
+ * elements postpone their work instead of stalling in gst_memory_map().
+ *
+ * Returns: %TRUE if @mem is ready, %FALSE if @timeout expired
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_dmabuf_memory_wait (GstMemory * mem, GstMapFlags flags,
+    GstClockTime timeout)
+{
+  gint timeout_ms;
+
+  g_return_val_if_fail (gst_is_dmabuf_memory (mem), FALSE);
+
+  if (!GST_CLOCK_TIME_IS_VALID (timeout))
+    timeout_ms = -1;
+  else
+    timeout_ms = MIN ((timeout + GST_MSECOND - 1) / GST_MSECOND, G_MAXINT);
+
+  return gst_dmabuf_memory_wait_internal (mem, flags, timeout_ms);
+}
@@ -113,6 +113,15 @@ gint           gst_dmabuf_memory_get_fd (GstMemory * mem);
 GST_ALLOCATORS_API
 gboolean       gst_is_dmabuf_memory (GstMemory * mem);
 
+GST_ALLOCATORS_API
+void           gst_dmabuf_memory_set_fence (GstMemory * mem, gint fence_fd);
+
+GST_ALLOCATORS_API
+gint           gst_dmabuf_memory_get_fence (GstMemory * mem);
+
+GST_ALLOCATORS_API
+gboolean       gst_dmabuf_memory_wait (GstMemory * mem, GstMapFlags flags, GstClockTime timeout);
+
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstDmaBufAllocator, gst_object_unref)
 
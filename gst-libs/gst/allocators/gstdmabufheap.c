@@ -0,0 +1,288 @@
+/* GStreamer dmabuf heap allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* for memfd_create () and F_ADD_SEALS */
+#define _GNU_SOURCE
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstdmabufheap.h"
+
+/**
+ * SECTION:gstdmabufheap
+ * @title: GstDmaBufHeapAllocator
+ * @short_description: Allocator for new dmabuf memory
+ * @see_also: #GstDmaBufAllocator, #GstMemory
+ *
+ * #GstDmaBufAllocator only wraps dmabuf file descriptors created elsewhere.
+ * #GstDmaBufHeapAllocator creates them itself, from a Linux dma-buf heap in
+ * /dev/dma_heap or, when no heap is available, from memfd memory turned into
+ * dmabufs with /dev/udmabuf. The memory it returns is regular dmabuf memory,
+ * so it is mappable and can be recognized with gst_is_dmabuf_memory().
+ *
+ * Setting it as the allocator of a #GstBufferPool, for instance a
+ * #GstVideoBufferPool with gst_buffer_pool_config_set_allocator(), lets
+ * elements that produce frames with the CPU output dmabufs, which importers
+ * like GL upload or hardware encoders can then use without copying.
+ *
+ * Since: 1.18
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#if defined (HAVE_LINUX_DMA_HEAP_H) || defined (HAVE_LINUX_UDMABUF_H)
+#include <sys/ioctl.h>
+#endif
+
+#ifdef HAVE_LINUX_DMA_HEAP_H
+#include <linux/dma-heap.h>
+#endif
+
+#if defined (HAVE_LINUX_UDMABUF_H) && defined (HAVE_MEMFD_CREATE)
+#include <sys/mman.h>
+#include <linux/udmabuf.h>
+#define HAVE_UDMABUF
+#endif
+
+#if defined (HAVE_LINUX_DMA_HEAP_H) || defined (HAVE_UDMABUF)
+#define HAVE_DMABUF_ALLOCATION
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (dmabufheap_debug);
+#define GST_CAT_DEFAULT dmabufheap_debug
+
+#define DEFAULT_HEAP "system"
+
+#define _do_init                                        \
+    GST_DEBUG_CATEGORY_INIT (dmabufheap_debug,          \
+    "dmabufheap", 0, "dmabuf heap allocator");
+
+G_DEFINE_TYPE_WITH_CODE (GstDmaBufHeapAllocator, gst_dmabuf_heap_allocator,
+    GST_TYPE_DMABUF_ALLOCATOR, _do_init);
+
+static gint
+gst_dmabuf_heap_allocator_alloc_fd (GstDmaBufHeapAllocator * self,
+    gsize size)
+{
+#ifdef HAVE_LINUX_DMA_HEAP_H
+  if (self->heap_fd >= 0) {
+    struct dma_heap_allocation_data data = { 0, };
+
+    data.len = size;
+    data.fd_flags = O_RDWR | O_CLOEXEC;
+
+    if (ioctl (self->heap_fd, DMA_HEAP_IOCTL_ALLOC, &data) < 0) {
+      GST_WARNING_OBJECT (self, "failed to allocate %" G_GSIZE_FORMAT
+          " bytes from heap: %s", size, g_strerror (errno));
+      return -1;
+    }
+
+    return data.fd;
+  }
+#endif
+
+#ifdef HAVE_UDMABUF
+  if (self->udmabuf_fd >= 0) {
+    struct udmabuf_create create = { 0, };
+    gint memfd, fd;
+
+    memfd = memfd_create ("gst-dmabuf", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (memfd < 0) {
+      GST_WARNING_OBJECT (self, "memfd_create failed: %s",
+          g_strerror (errno));
+      return -1;
+    }
+
+    /* udmabuf only accepts memfds that can't shrink */
+    if (ftruncate (memfd, size) < 0
+        || fcntl (memfd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+      GST_WARNING_OBJECT (self, "failed to set up memfd of %" G_GSIZE_FORMAT
+          " bytes: %s", size, g_strerror (errno));
+      close (memfd);
+      return -1;
+    }
+
+    create.memfd = memfd;
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = 0;
+    create.size = size;
+
+    fd = ioctl (self->udmabuf_fd, UDMABUF_CREATE, &create);
+    if (fd < 0)
+      GST_WARNING_OBJECT (self, "failed to create udmabuf: %s",
+          g_strerror (errno));
+
+    /* the dmabuf keeps its own reference on the pages */
+    close (memfd);
+
+    return fd;
+  }
+#endif
+
+  return -1;
+}
+
+static GstMemory *
+gst_dmabuf_heap_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstDmaBufHeapAllocator *self = GST_DMABUF_HEAP_ALLOCATOR (allocator);
+  GstMemory *mem;
+  gsize maxsize, page_size = 4096;
+  gint fd;
+
+#if defined (HAVE_UNISTD_H) && defined (_SC_PAGESIZE)
+  page_size = sysconf (_SC_PAGESIZE);
+#endif
+
+  /* dmabufs are page aligned, which covers any alignment asked for up to a
+   * page; both heaps and udmabuf work in whole pages */
+  if (params->align >= page_size) {
+    GST_WARNING_OBJECT (self, "alignment %" G_GSIZE_FORMAT " larger than "
+        "the page size is not supported", params->align);
+    return NULL;
+  }
+
+  maxsize = GST_ROUND_UP_N (params->prefix + size + params->padding,
+      page_size);
+
+  fd = gst_dmabuf_heap_allocator_alloc_fd (self, maxsize);
+  if (fd < 0)
+    return NULL;
+
+  mem = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      GST_FD_MEMORY_FLAG_NONE);
+  if (mem == NULL) {
+#ifdef HAVE_DMABUF_ALLOCATION
+    close (fd);
+#endif
+    return NULL;
+  }
+
+  /* freshly allocated pages are always zeroed */
+  gst_memory_resize (mem, params->prefix, size);
+  GST_MINI_OBJECT_FLAG_SET (mem, GST_MEMORY_FLAG_ZERO_PREFIXED |
+      GST_MEMORY_FLAG_ZERO_PADDED);
+
+  GST_DEBUG_OBJECT (self, "allocated fd %d of %" G_GSIZE_FORMAT " bytes", fd,
+      maxsize);
+
+  return mem;
+}
+
+static void
+gst_dmabuf_heap_allocator_finalize (GObject * object)
+{
+#ifdef HAVE_DMABUF_ALLOCATION
+  GstDmaBufHeapAllocator *self = GST_DMABUF_HEAP_ALLOCATOR (object);
+
+  if (self->heap_fd >= 0)
+    close (self->heap_fd);
+  if (self->udmabuf_fd >= 0)
+    close (self->udmabuf_fd);
+#endif
+
+  G_OBJECT_CLASS (gst_dmabuf_heap_allocator_parent_class)->finalize (object);
+}
+
+static void
+gst_dmabuf_heap_allocator_class_init (GstDmaBufHeapAllocatorClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  gobject_class->finalize = gst_dmabuf_heap_allocator_finalize;
+
+  allocator_class->alloc = gst_dmabuf_heap_allocator_alloc;
+}
+
+static void
+gst_dmabuf_heap_allocator_init (GstDmaBufHeapAllocator * allocator)
+{
+  allocator->heap_fd = -1;
+  allocator->udmabuf_fd = -1;
+
+  /* unlike its parents, this allocator can be used with
+   * gst_allocator_alloc() */
+  GST_OBJECT_FLAG_UNSET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+/**
+ * gst_dmabuf_heap_allocator_new:
+ * @heap: (nullable): name of the heap in /dev/dma_heap, or %NULL for the
+ *     "system" heap
+ *
+ * Return a new allocator creating dmabuf memory from the dma-buf heap
+ * @heap. If that heap can't be opened, memfd memory exported through
+ * /dev/udmabuf is used instead.
+ *
+ * Returns: (transfer full) (nullable): a new dmabuf heap allocator, or %NULL
+ *    if neither @heap nor udmabuf are available. Use gst_object_unref() to
+ *    release the allocator after usage
+ *
+ * Since: 1.18
+ */
+GstAllocator *
+gst_dmabuf_heap_allocator_new (const gchar * heap)
+{
+  GstDmaBufHeapAllocator *alloc;
+
+  alloc = g_object_new (GST_TYPE_DMABUF_HEAP_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+#ifdef HAVE_LINUX_DMA_HEAP_H
+  {
+    gchar *path;
+
+    path = g_build_filename ("/dev/dma_heap", heap ? heap : DEFAULT_HEAP,
+        NULL);
+    alloc->heap_fd = open (path, O_RDWR | O_CLOEXEC);
+    if (alloc->heap_fd < 0)
+      GST_INFO_OBJECT (alloc, "can't open %s: %s", path, g_strerror (errno));
+    else
+      GST_DEBUG_OBJECT (alloc, "allocating from %s", path);
+    g_free (path);
+  }
+#endif
+
+#ifdef HAVE_UDMABUF
+  if (alloc->heap_fd < 0) {
+    alloc->udmabuf_fd = open ("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+    if (alloc->udmabuf_fd < 0)
+      GST_INFO_OBJECT (alloc, "can't open /dev/udmabuf: %s",
+          g_strerror (errno));
+    else
+      GST_DEBUG_OBJECT (alloc, "allocating memfd through udmabuf");
+  }
+#endif
+
+  if (alloc->heap_fd < 0 && alloc->udmabuf_fd < 0) {
+    gst_object_unref (alloc);
+    return NULL;
+  }
+
+  return GST_ALLOCATOR_CAST (alloc);
+}
@@ -0,0 +1,75 @@
+/* GStreamer dmabuf heap allocator
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_DMABUF_HEAP_H__
+#define __GST_DMABUF_HEAP_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/gstdmabuf.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_DMABUF_HEAP_ALLOCATOR              (gst_dmabuf_heap_allocator_get_type())
+#define GST_IS_DMABUF_HEAP_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DMABUF_HEAP_ALLOCATOR))
+#define GST_IS_DMABUF_HEAP_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_DMABUF_HEAP_ALLOCATOR))
+#define GST_DMABUF_HEAP_ALLOCATOR_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_DMABUF_HEAP_ALLOCATOR, GstDmaBufHeapAllocatorClass))
+#define GST_DMABUF_HEAP_ALLOCATOR(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_DMABUF_HEAP_ALLOCATOR, GstDmaBufHeapAllocator))
+#define GST_DMABUF_HEAP_ALLOCATOR_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_DMABUF_HEAP_ALLOCATOR, GstDmaBufHeapAllocatorClass))
+#define GST_DMABUF_HEAP_ALLOCATOR_CAST(obj)         ((GstDmaBufHeapAllocator *)(obj))
+
+typedef struct _GstDmaBufHeapAllocator GstDmaBufHeapAllocator;
+typedef struct _GstDmaBufHeapAllocatorClass GstDmaBufHeapAllocatorClass;
+
+/**
+ * GstDmaBufHeapAllocator:
+ *
+ * Allocator creating new dmabuf-backed memory
+ *
+ * Since: 1.18
+ */
+struct _GstDmaBufHeapAllocator
+{
+  GstDmaBufAllocator parent;
+
+  /*< private >*/
+  gint heap_fd;
+  gint udmabuf_fd;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+struct _GstDmaBufHeapAllocatorClass
+{
+  GstDmaBufAllocatorClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+
+GST_ALLOCATORS_API
+GType          gst_dmabuf_heap_allocator_get_type (void);
+
+GST_ALLOCATORS_API
+GstAllocator * gst_dmabuf_heap_allocator_new (const gchar * heap);
+
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstDmaBufHeapAllocator, gst_object_unref)
+
+G_END_DECLS
+#endif /* __GST_DMABUF_HEAP_H__ */
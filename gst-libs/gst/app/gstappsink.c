@@ -1662,13 +1662,53 @@ not_started:
 GstSample *
 gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
 {
-  GstAppSinkPrivate *priv;
   GstSample *sample = NULL;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  gst_app_sink_try_pull_samples (appsink, &sample, 1, timeout);
+
+  return sample;
+}
+
+/**
+ * gst_app_sink_try_pull_samples:
+ * @appsink: a #GstAppSink
+ * @samples: (out caller-allocates) (array length=n_samples) (transfer full):
+ *   an array of at least @n_samples entries to store the samples in
+ * @n_samples: the maximum number of samples to pull
+ * @timeout: the maximum amount of time to wait for the first sample
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state or the timeout expires, like
+ * gst_app_sink_try_pull_sample().
+ *
+ * Once a sample is available, it and all other queued samples, up to
+ * @n_samples, are dequeued at once without waiting any further. This
+ * avoids taking the internal lock for every single sample when many small
+ * samples need to be consumed.
+ *
+ * Returns: the number of samples stored in @samples. 0 when the appsink is
+ * stopped or EOS or the timeout expires. Call gst_sample_unref() on each of
+ * the returned samples after usage.
+ *
+ * Since: 1.18
+ */
+guint
+gst_app_sink_try_pull_samples (GstAppSink * appsink, GstSample ** samples,
+    guint n_samples, GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
   GstMiniObject *obj;
   gboolean timeout_valid;
   gint64 end_time;
+  guint n = 0;
 
-  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), 0);
+  g_return_val_if_fail (samples != NULL || n_samples == 0, 0);
+
+  if (n_samples == 0)
+    return 0;
 
   timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
 
@@ -1704,28 +1744,31 @@ gst_app_sink_try_pull_sample (GstAppSink * appsink, GstClockTime timeout)
     priv->wait_status &= ~APP_WAITING;
   }
 
-  obj = dequeue_buffer (appsink);
-  if (GST_IS_BUFFER (obj)) {
-    GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
-    priv->sample = gst_sample_make_writable (priv->sample);
-    gst_sample_set_buffer_list (priv->sample, NULL);
-    gst_sample_set_buffer (priv->sample, GST_BUFFER_CAST (obj));
-    sample = gst_sample_ref (priv->sample);
-  } else {
-    GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
-    priv->sample = gst_sample_make_writable (priv->sample);
-    gst_sample_set_buffer (priv->sample, NULL);
-    gst_sample_set_buffer_list (priv->sample, GST_BUFFER_LIST_CAST (obj));
-    sample = gst_sample_ref (priv->sample);
-  }
-  gst_mini_object_unref (obj);
+  do {
+    obj = dequeue_buffer (appsink);
+    if (GST_IS_BUFFER (obj)) {
+      GST_DEBUG_OBJECT (appsink, "we have a buffer %p", obj);
+      priv->sample = gst_sample_make_writable (priv->sample);
+      gst_sample_set_buffer_list (priv->sample, NULL);
+      gst_sample_set_buffer (priv->sample, GST_BUFFER_CAST (obj));
+    } else {
+      GST_DEBUG_OBJECT (appsink, "we have a list %p", obj);
+      priv->sample = gst_sample_make_writable (priv->sample);
+      gst_sample_set_buffer (priv->sample, NULL);
+      gst_sample_set_buffer_list (priv->sample, GST_BUFFER_LIST_CAST (obj));
+    }
+    samples[n++] = gst_sample_ref (priv->sample);
+    gst_mini_object_unref (obj);
+  } while (n < n_samples && priv->num_buffers > 0);
 
   if ((priv->wait_status & STREAM_WAITING))
     g_cond_signal (&priv->cond);
 
   g_mutex_unlock (&priv->mutex);
 
-  return sample;
+  GST_LOG_OBJECT (appsink, "pulled %u samples", n);
+
+  return n;
 
   /* special conditions */
 expired:
@@ -1733,19 +1776,19 @@ expired:
     GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
     priv->wait_status &= ~APP_WAITING;
     g_mutex_unlock (&priv->mutex);
-    return NULL;
+    return 0;
   }
 eos:
   {
     GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
     g_mutex_unlock (&priv->mutex);
-    return NULL;
+    return 0;
   }
 not_started:
   {
     GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
     g_mutex_unlock (&priv->mutex);
-    return NULL;
+    return 0;
   }
 }
 
@@ -79,6 +79,13 @@
  * buffer of exactly the amount of bytes given by the need-data signal should be
  * pushed into appsrc.
  *
+ * In the "random-access" stream-type, the application can instead install a
+ * get_range callback with gst_app_src_set_callbacks(). appsrc then reads the
+ * requested ranges synchronously from the streaming thread, without going
+ * through the need-data and seek-data round trip, and keeps the last few
+ * ranges it read so that small reads close to each other, as done by demuxers
+ * parsing headers, are served without calling the application again.
+ *
  * In all modes, the size property on appsrc should contain the total stream
  * size in bytes. Setting this property is mandatory in the random-access mode.
  * For the stream and seekable modes, setting this property is optional but
@@ -108,6 +115,11 @@ typedef enum
   APP_WAITING = 1 << 1,         /* application thread is waiting for streaming thread */
 } GstAppSrcWaitStatus;
 
+/* minimum amount of bytes read through the get_range callback and the number
+ * of ranges kept around for later reads */
+#define RANGE_PREFETCH_SIZE (64 * 1024)
+#define RANGE_CACHE_SIZE 4
+
 typedef struct
 {
   GstAppSrcCallbacks callbacks;
@@ -136,6 +148,380 @@ callbacks_unref (Callbacks * callbacks)
   g_free (callbacks);
 }
 
+/* Wrapping of externally owned memory.
+ *
+ * Memory handed to gst_app_src_wrap_memory() and the registered regions are
+ * wrapped in AppSrcMemory objects, and those are placed in plain GstBuffers.
+ * Both the memory and the buffer objects are recycled through a
+ * refcounted AppSrcWrapPool when they are released downstream, so that
+ * pushing wrapped memory does not need any allocations in the steady state.
+ *
+ * Every object that is handed out holds a ref on the pool. The appsrc holds
+ * another one, so the pool stays valid until the element is gone and all
+ * wrapped memory was released. */
+#define WRAP_POOL_MAX_FREE 64
+
+typedef struct _AppSrcWrapPool AppSrcWrapPool;
+
+typedef struct
+{
+  GstMemory mem;
+
+  gpointer data;
+  /* NULL for sub-memories, which are not recycled */
+  AppSrcWrapPool *pool;
+  /* -1 for memory that is not a registered region */
+  gint region;
+  gpointer user_data;
+  GDestroyNotify notify;
+} AppSrcMemory;
+
+typedef struct
+{
+  AppSrcMemory *mem;
+  gboolean busy;
+} AppSrcRegion;
+
+struct _AppSrcWrapPool
+{
+  gint refcount;
+
+  GMutex lock;
+  gboolean shutdown;
+  GstAllocator *allocator;
+  GstQueueArray *free_mems;
+  GstQueueArray *free_buffers;
+
+  AppSrcRegion *regions;
+  guint n_regions;
+  GstAppSrcRegionReleaseFunc region_release;
+  gpointer region_user_data;
+  GDestroyNotify region_notify;
+};
+
+static GQuark wrap_pool_quark;
+
+typedef GstAllocator AppSrcAllocator;
+typedef GstAllocatorClass AppSrcAllocatorClass;
+
+static GType app_src_allocator_get_type (void);
+G_DEFINE_TYPE (AppSrcAllocator, app_src_allocator, GST_TYPE_ALLOCATOR);
+
+static gpointer
+app_src_memory_map (AppSrcMemory * mem, gsize maxsize, GstMapFlags flags)
+{
+  return mem->data;
+}
+
+static void
+app_src_memory_unmap (AppSrcMemory * mem)
+{
+}
+
+static AppSrcMemory *
+app_src_memory_share (AppSrcMemory * mem, gssize offset, gsize size)
+{
+  AppSrcMemory *sub;
+  GstMemory *parent;
+
+  if ((parent = mem->mem.parent) == NULL)
+    parent = (GstMemory *) mem;
+
+  if (size == -1)
+    size = mem->mem.size - offset;
+
+  sub = g_slice_new0 (AppSrcMemory);
+  gst_memory_init (GST_MEMORY_CAST (sub),
+      GST_MINI_OBJECT_FLAGS (parent) | GST_MINI_OBJECT_FLAG_LOCK_READONLY,
+      mem->mem.allocator, parent, mem->mem.maxsize, mem->mem.align,
+      mem->mem.offset + offset, size);
+  sub->data = mem->data;
+  sub->region = -1;
+
+  return sub;
+}
+
+static gboolean
+app_src_memory_is_span (AppSrcMemory * mem1, AppSrcMemory * mem2,
+    gsize * offset)
+{
+  if (offset) {
+    AppSrcMemory *parent = (AppSrcMemory *) mem1->mem.parent;
+
+    *offset = mem1->mem.offset - parent->mem.offset;
+  }
+
+  return (guint8 *) mem1->data + mem1->mem.offset + mem1->mem.size ==
+      (guint8 *) mem2->data + mem2->mem.offset;
+}
+
+static GstMemory *
+app_src_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  g_warning ("use gst_app_src_wrap_memory() to wrap memory");
+  return NULL;
+}
+
+static void
+app_src_allocator_free (GstAllocator * allocator, GstMemory * mem)
+{
+  g_slice_free (AppSrcMemory, (AppSrcMemory *) mem);
+}
+
+static void
+app_src_allocator_class_init (AppSrcAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = GST_ALLOCATOR_CLASS (klass);
+
+  allocator_class->alloc = app_src_allocator_alloc;
+  allocator_class->free = app_src_allocator_free;
+}
+
+static void
+app_src_allocator_init (AppSrcAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = "AppSrcMemory";
+  alloc->mem_map = (GstMemoryMapFunction) app_src_memory_map;
+  alloc->mem_unmap = (GstMemoryUnmapFunction) app_src_memory_unmap;
+  alloc->mem_share = (GstMemoryShareFunction) app_src_memory_share;
+  alloc->mem_is_span = (GstMemoryIsSpanFunction) app_src_memory_is_span;
+
+  GST_OBJECT_FLAG_SET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+
+static GstAllocator *
+app_src_allocator_get (void)
+{
+  static GstAllocator *allocator = NULL;
+
+  if (g_once_init_enter (&allocator)) {
+    GstAllocator *alloc = g_object_new (app_src_allocator_get_type (), NULL);
+
+    gst_object_ref_sink (alloc);
+    GST_OBJECT_FLAG_SET (alloc, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+    g_once_init_leave (&allocator, alloc);
+  }
+  return gst_object_ref (allocator);
+}
+
+static AppSrcWrapPool *
+wrap_pool_new (void)
+{
+  AppSrcWrapPool *pool = g_slice_new0 (AppSrcWrapPool);
+
+  pool->refcount = 1;
+  g_mutex_init (&pool->lock);
+  pool->allocator = app_src_allocator_get ();
+  pool->free_mems = gst_queue_array_new (16);
+  pool->free_buffers = gst_queue_array_new (16);
+
+  return pool;
+}
+
+static AppSrcWrapPool *
+wrap_pool_ref (AppSrcWrapPool * pool)
+{
+  g_atomic_int_inc (&pool->refcount);
+  return pool;
+}
+
+/* drops a recycled object for good, without running our dispose again */
+static void
+wrap_pool_drop (GstMiniObject * obj)
+{
+  obj->dispose = NULL;
+  gst_mini_object_unref (obj);
+}
+
+/* must be called with the pool lock or the last ref, all regions must be
+ * free. The destroy notify of the regions is returned in @notify and
+ * @user_data, call it after releasing the lock */
+static void
+wrap_pool_clear_regions (AppSrcWrapPool * pool, GDestroyNotify * notify,
+    gpointer * user_data)
+{
+  guint i;
+
+  for (i = 0; i < pool->n_regions; i++) {
+    if (pool->regions[i].mem)
+      wrap_pool_drop (GST_MINI_OBJECT_CAST (pool->regions[i].mem));
+  }
+  g_free (pool->regions);
+  pool->regions = NULL;
+  pool->n_regions = 0;
+
+  *notify = pool->region_notify;
+  *user_data = pool->region_user_data;
+  pool->region_release = NULL;
+  pool->region_user_data = NULL;
+  pool->region_notify = NULL;
+}
+
+static void
+wrap_pool_unref (AppSrcWrapPool * pool)
+{
+  GDestroyNotify notify;
+  gpointer user_data;
+
+  if (!g_atomic_int_dec_and_test (&pool->refcount))
+    return;
+
+  while (!gst_queue_array_is_empty (pool->free_mems))
+    wrap_pool_drop (gst_queue_array_pop_head (pool->free_mems));
+  while (!gst_queue_array_is_empty (pool->free_buffers))
+    wrap_pool_drop (gst_queue_array_pop_head (pool->free_buffers));
+  gst_queue_array_free (pool->free_mems);
+  gst_queue_array_free (pool->free_buffers);
+
+  wrap_pool_clear_regions (pool, &notify, &user_data);
+  if (notify)
+    notify (user_data);
+
+  gst_object_unref (pool->allocator);
+  g_mutex_clear (&pool->lock);
+  g_slice_free (AppSrcWrapPool, pool);
+}
+
+/* stops recycling, objects that are still out are freed when released */
+static void
+wrap_pool_shutdown (AppSrcWrapPool * pool)
+{
+  g_mutex_lock (&pool->lock);
+  pool->shutdown = TRUE;
+  while (!gst_queue_array_is_empty (pool->free_mems))
+    wrap_pool_drop (gst_queue_array_pop_head (pool->free_mems));
+  while (!gst_queue_array_is_empty (pool->free_buffers))
+    wrap_pool_drop (gst_queue_array_pop_head (pool->free_buffers));
+  g_mutex_unlock (&pool->lock);
+
+  wrap_pool_unref (pool);
+}
+
+/* called when the last ref to a pooled memory is dropped */
+static gboolean
+app_src_memory_dispose (AppSrcMemory * mem)
+{
+  AppSrcWrapPool *pool = mem->pool;
+  gboolean keep = FALSE;
+
+  if (mem->notify)
+    mem->notify (mem->user_data);
+  mem->notify = NULL;
+  mem->user_data = NULL;
+
+  if (mem->region >= 0)
+    pool->region_release (mem->region, pool->region_user_data);
+
+  g_mutex_lock (&pool->lock);
+  if (mem->region >= 0) {
+    if (pool->shutdown) {
+      pool->regions[mem->region].mem = NULL;
+    } else {
+      pool->regions[mem->region].busy = FALSE;
+      keep = TRUE;
+    }
+  } else if (!pool->shutdown &&
+      gst_queue_array_get_length (pool->free_mems) < WRAP_POOL_MAX_FREE) {
+    gst_queue_array_push_tail (pool->free_mems, mem);
+    keep = TRUE;
+  }
+  /* revive the object before anyone can take it from the pool */
+  if (keep)
+    gst_memory_ref (GST_MEMORY_CAST (mem));
+  g_mutex_unlock (&pool->lock);
+
+  wrap_pool_unref (pool);
+
+  return !keep;
+}
+
+static gboolean
+remove_meta_foreach (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
+{
+  GST_META_FLAG_UNSET (*meta, GST_META_FLAG_LOCKED);
+  *meta = NULL;
+  return TRUE;
+}
+
+/* called when the last ref to a pooled buffer is dropped */
+static gboolean
+app_src_buffer_dispose (GstBuffer * buffer)
+{
+  AppSrcWrapPool *pool;
+  gboolean keep;
+
+  pool = gst_mini_object_get_qdata (GST_MINI_OBJECT_CAST (buffer),
+      wrap_pool_quark);
+
+  g_mutex_lock (&pool->lock);
+  keep = !pool->shutdown &&
+      gst_queue_array_get_length (pool->free_buffers) < WRAP_POOL_MAX_FREE;
+  g_mutex_unlock (&pool->lock);
+
+  if (keep) {
+    /* make the buffer writable again and reset it, this releases the
+     * wrapped memory */
+    gst_buffer_ref (buffer);
+    gst_buffer_remove_all_memory (buffer);
+    gst_buffer_foreach_meta (buffer, remove_meta_foreach, NULL);
+    GST_MINI_OBJECT_FLAGS (buffer) = 0;
+    GST_BUFFER_PTS (buffer) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_DURATION (buffer) = GST_CLOCK_TIME_NONE;
+    GST_BUFFER_OFFSET (buffer) = GST_BUFFER_OFFSET_NONE;
+    GST_BUFFER_OFFSET_END (buffer) = GST_BUFFER_OFFSET_NONE;
+
+    g_mutex_lock (&pool->lock);
+    gst_queue_array_push_tail (pool->free_buffers, buffer);
+    g_mutex_unlock (&pool->lock);
+  }
+
+  wrap_pool_unref (pool);
+
+  return !keep;
+}
+
+static GstBuffer *
+wrap_pool_acquire_buffer (AppSrcWrapPool * pool, GstMemory * mem)
+{
+  GstBuffer *buffer;
+
+  g_mutex_lock (&pool->lock);
+  buffer = gst_queue_array_pop_head (pool->free_buffers);
+  g_mutex_unlock (&pool->lock);
+
+  if (buffer == NULL) {
+    buffer = gst_buffer_new ();
+    gst_mini_object_set_qdata (GST_MINI_OBJECT_CAST (buffer), wrap_pool_quark,
+        pool, NULL);
+    GST_MINI_OBJECT_CAST (buffer)->dispose =
+        (GstMiniObjectDisposeFunction) app_src_buffer_dispose;
+  }
+  wrap_pool_ref (pool);
+
+  gst_buffer_append_memory (buffer, mem);
+
+  return buffer;
+}
+
+static AppSrcMemory *
+wrap_pool_new_memory (AppSrcWrapPool * pool)
+{
+  AppSrcMemory *mem = g_slice_new0 (AppSrcMemory);
+
+  gst_memory_init (GST_MEMORY_CAST (mem), 0, pool->allocator, NULL, 0, 0, 0,
+      0);
+  GST_MINI_OBJECT_CAST (mem)->dispose =
+      (GstMiniObjectDisposeFunction) app_src_memory_dispose;
+  mem->pool = pool;
+  mem->region = -1;
+
+  return mem;
+}
+
 
 struct _GstAppSrcPrivate
 {
@@ -151,6 +537,9 @@ struct _GstAppSrcPrivate
   GstClockTime duration;
   GstAppStreamType stream_type;
   guint64 max_bytes;
+  guint64 max_buffers;
+  GstClockTime max_time;
+  GstAppLeakyType leaky_type;
   GstFormat format;
   gboolean block;
   gchar *uri;
@@ -159,6 +548,11 @@ struct _GstAppSrcPrivate
   gboolean started;
   gboolean is_eos;
   guint64 queued_bytes;
+  guint64 queued_buffers;
+  GstClockTime queued_time;
+  GstClockTime last_in_ts;
+  GstClockTime last_out_ts;
+  guint64 dropped;
   guint64 offset;
   GstAppStreamType current_type;
 
@@ -168,6 +562,12 @@ struct _GstAppSrcPrivate
   guint min_percent;
 
   Callbacks *callbacks;
+
+  AppSrcWrapPool *wrap_pool;
+
+  /* recently read ranges of the get_range callback, most recent first. Only
+   * used from the streaming thread */
+  GQueue range_cache;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_src_debug);
@@ -201,6 +601,9 @@ enum
 #define DEFAULT_PROP_MIN_PERCENT   0
 #define DEFAULT_PROP_CURRENT_LEVEL_BYTES   0
 #define DEFAULT_PROP_DURATION      GST_CLOCK_TIME_NONE
+#define DEFAULT_PROP_MAX_BUFFERS   0
+#define DEFAULT_PROP_MAX_TIME      0
+#define DEFAULT_PROP_LEAKY_TYPE    GST_APP_LEAKY_TYPE_NONE
 
 enum
 {
@@ -218,6 +621,10 @@ enum
   PROP_MIN_PERCENT,
   PROP_CURRENT_LEVEL_BYTES,
   PROP_DURATION,
+  PROP_MAX_BUFFERS,
+  PROP_MAX_TIME,
+  PROP_LEAKY_TYPE,
+  PROP_DROPPED,
   PROP_LAST
 };
 
@@ -281,6 +688,8 @@ gst_app_src_class_init (GstAppSrcClass * klass)
 
   GST_DEBUG_CATEGORY_INIT (app_src_debug, "appsrc", 0, "appsrc element");
 
+  wrap_pool_quark = g_quark_from_static_string ("GstAppSrcWrapPool");
+
   gobject_class->dispose = gst_app_src_dispose;
   gobject_class->finalize = gst_app_src_finalize;
 
@@ -438,6 +847,66 @@ gst_app_src_class_init (GstAppSrcClass * klass)
           0, G_MAXUINT64, DEFAULT_PROP_DURATION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAppSrc::max-buffers:
+   *
+   * The maximum number of buffers that can be queued internally. After the
+   * maximum amount of buffers are queued, appsrc will emit the "enough-data"
+   * signal.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BUFFERS,
+      g_param_spec_uint64 ("max-buffers", "Max buffers",
+          "The maximum number of buffers to queue internally (0 = unlimited)",
+          0, G_MAXUINT64, DEFAULT_PROP_MAX_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAppSrc::max-time:
+   *
+   * The maximum amount of time that can be queued internally, measured as
+   * the distance between the timestamps of the newest and the oldest queued
+   * buffer. After the maximum amount of time is queued, appsrc will emit the
+   * "enough-data" signal.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_TIME,
+      g_param_spec_uint64 ("max-time", "Max time",
+          "The maximum amount of time to queue internally (0 = unlimited)",
+          0, G_MAXUINT64, DEFAULT_PROP_MAX_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAppSrc::leaky-type:
+   *
+   * When set to any other value than GST_APP_LEAKY_TYPE_NONE then the appsrc
+   * will drop any buffers that are pushed into it once its internal queue is
+   * full. The selected type defines whether to drop the oldest or newest
+   * buffers. This takes precedence over the block property.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_LEAKY_TYPE,
+      g_param_spec_enum ("leaky-type", "Leaky Type",
+          "Whether to drop buffers once the internal queue is full",
+          GST_TYPE_APP_LEAKY_TYPE,
+          DEFAULT_PROP_LEAKY_TYPE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAppSrc::dropped:
+   *
+   * The number of buffers that were dropped because of the leaky-type.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "The number of buffers dropped because the queue was full",
+          0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAppSrc::need-data:
    * @appsrc: the appsrc element that emitted the signal
@@ -608,6 +1077,11 @@ gst_app_src_init (GstAppSrc * appsrc)
   priv->duration = DEFAULT_PROP_DURATION;
   priv->stream_type = DEFAULT_PROP_STREAM_TYPE;
   priv->max_bytes = DEFAULT_PROP_MAX_BYTES;
+  priv->max_buffers = DEFAULT_PROP_MAX_BUFFERS;
+  priv->max_time = DEFAULT_PROP_MAX_TIME;
+  priv->leaky_type = DEFAULT_PROP_LEAKY_TYPE;
+  priv->last_in_ts = GST_CLOCK_TIME_NONE;
+  priv->last_out_ts = GST_CLOCK_TIME_NONE;
   priv->format = DEFAULT_PROP_FORMAT;
   priv->block = DEFAULT_PROP_BLOCK;
   priv->min_latency = DEFAULT_PROP_MIN_LATENCY;
@@ -615,6 +1089,8 @@ gst_app_src_init (GstAppSrc * appsrc)
   priv->emit_signals = DEFAULT_PROP_EMIT_SIGNALS;
   priv->min_percent = DEFAULT_PROP_MIN_PERCENT;
 
+  priv->wrap_pool = wrap_pool_new ();
+
   gst_base_src_set_live (GST_BASE_SRC (appsrc), DEFAULT_PROP_IS_LIVE);
 }
 
@@ -641,6 +1117,167 @@ gst_app_src_flush_queued (GstAppSrc * src, gboolean retain_last_caps)
   }
 
   priv->queued_bytes = 0;
+  priv->queued_buffers = 0;
+  priv->queued_time = 0;
+  priv->last_in_ts = GST_CLOCK_TIME_NONE;
+  priv->last_out_ts = GST_CLOCK_TIME_NONE;
+}
+
+static GstClockTime
+gst_app_src_get_timestamp (GstMiniObject * obj)
+{
+  GstBuffer *buffer;
+
+  if (GST_IS_BUFFER_LIST (obj)) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+
+    if (gst_buffer_list_length (list) == 0)
+      return GST_CLOCK_TIME_NONE;
+    buffer = gst_buffer_list_get (list, 0);
+  } else {
+    buffer = GST_BUFFER_CAST (obj);
+  }
+
+  return GST_BUFFER_DTS_OR_PTS (buffer);
+}
+
+/* Must be called with priv->mutex */
+static void
+gst_app_src_update_queued_time (GstAppSrc * appsrc)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+
+  if (GST_CLOCK_TIME_IS_VALID (priv->last_in_ts) &&
+      GST_CLOCK_TIME_IS_VALID (priv->last_out_ts) &&
+      priv->last_in_ts > priv->last_out_ts)
+    priv->queued_time = priv->last_in_ts - priv->last_out_ts;
+  else
+    priv->queued_time = 0;
+}
+
+/* Must be called with priv->mutex, @obj is a buffer or buffer list that was
+ * added to the queue */
+static void
+gst_app_src_queued_add (GstAppSrc * appsrc, GstMiniObject * obj)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  GstClockTime ts;
+
+  if (GST_IS_BUFFER_LIST (obj)) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+    guint len = gst_buffer_list_length (list);
+
+    priv->queued_bytes += gst_buffer_list_calculate_size (list);
+    priv->queued_buffers += len;
+    ts = len ? GST_BUFFER_DTS_OR_PTS (gst_buffer_list_get (list, len - 1)) :
+        GST_CLOCK_TIME_NONE;
+  } else {
+    priv->queued_bytes += gst_buffer_get_size (GST_BUFFER_CAST (obj));
+    priv->queued_buffers++;
+    ts = GST_BUFFER_DTS_OR_PTS (GST_BUFFER_CAST (obj));
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    priv->last_in_ts = ts;
+    if (!GST_CLOCK_TIME_IS_VALID (priv->last_out_ts))
+      priv->last_out_ts = gst_app_src_get_timestamp (obj);
+    gst_app_src_update_queued_time (appsrc);
+  }
+}
+
+/* Must be called with priv->mutex, @obj is a buffer or buffer list that was
+ * removed from the queue. Returns the size of @obj in bytes */
+static guint
+gst_app_src_queued_remove (GstAppSrc * appsrc, GstMiniObject * obj)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  GstClockTime ts;
+  guint size;
+
+  if (GST_IS_BUFFER_LIST (obj)) {
+    GstBufferList *list = GST_BUFFER_LIST_CAST (obj);
+
+    size = gst_buffer_list_calculate_size (list);
+    priv->queued_buffers -= gst_buffer_list_length (list);
+  } else {
+    size = gst_buffer_get_size (GST_BUFFER_CAST (obj));
+    priv->queued_buffers--;
+  }
+  priv->queued_bytes -= size;
+
+  ts = gst_app_src_get_timestamp (obj);
+  if (GST_CLOCK_TIME_IS_VALID (ts)) {
+    priv->last_out_ts = ts;
+    gst_app_src_update_queued_time (appsrc);
+  }
+
+  return size;
+}
+
+/* Must be called with priv->mutex */
+static gboolean
+gst_app_src_is_full (GstAppSrc * appsrc)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+
+  return (priv->max_bytes && priv->queued_bytes >= priv->max_bytes) ||
+      (priv->max_buffers && priv->queued_buffers >= priv->max_buffers) ||
+      (priv->max_time && priv->queued_time >= priv->max_time);
+}
+
+/* Must be called with priv->mutex. Drops the oldest buffer or buffer list
+ * from the queue, caps are kept so that the following buffers are still
+ * pushed with the right caps. */
+static gboolean
+gst_app_src_drop_oldest (GstAppSrc * appsrc)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  guint i, len;
+
+  len = gst_queue_array_get_length (priv->queue);
+  for (i = 0; i < len; i++) {
+    GstMiniObject *obj = gst_queue_array_peek_nth (priv->queue, i);
+
+    if (GST_IS_CAPS (obj))
+      continue;
+
+    gst_queue_array_drop_element (priv->queue, i);
+    if (GST_IS_BUFFER_LIST (obj))
+      priv->dropped += gst_buffer_list_length (GST_BUFFER_LIST_CAST (obj));
+    else
+      priv->dropped++;
+    gst_app_src_queued_remove (appsrc, obj);
+
+    GST_DEBUG_OBJECT (appsrc, "dropped old %" GST_PTR_FORMAT, obj);
+    gst_mini_object_unref (obj);
+
+    /* the queued time now starts at the next buffer */
+    for (len--; i < len; i++) {
+      GstClockTime ts;
+
+      obj = gst_queue_array_peek_nth (priv->queue, i);
+      if (GST_IS_CAPS (obj))
+        continue;
+
+      ts = gst_app_src_get_timestamp (obj);
+      if (GST_CLOCK_TIME_IS_VALID (ts)) {
+        priv->last_out_ts = ts;
+        gst_app_src_update_queued_time (appsrc);
+      }
+      break;
+    }
+    return TRUE;
+  }
+  return FALSE;
+}
+
+static void
+gst_app_src_clear_range_cache (GstAppSrc * appsrc)
+{
+  GstBuffer *range;
+
+  while ((range = g_queue_pop_head (&appsrc->priv->range_cache)))
+    gst_buffer_unref (range);
 }
 
 static void
@@ -669,6 +1306,8 @@ gst_app_src_dispose (GObject * obj)
 
   g_clear_pointer (&callbacks, callbacks_unref);
 
+  gst_app_src_clear_range_cache (appsrc);
+
   G_OBJECT_CLASS (parent_class)->dispose (obj);
 }
 
@@ -681,6 +1320,7 @@ gst_app_src_finalize (GObject * obj)
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
   gst_queue_array_free (priv->queue);
+  wrap_pool_shutdown (priv->wrap_pool);
 
   g_free (priv->uri);
 
@@ -760,6 +1400,15 @@ gst_app_src_set_property (GObject * object, guint prop_id,
     case PROP_DURATION:
       gst_app_src_set_duration (appsrc, g_value_get_uint64 (value));
       break;
+    case PROP_MAX_BUFFERS:
+      gst_app_src_set_max_buffers (appsrc, g_value_get_uint64 (value));
+      break;
+    case PROP_MAX_TIME:
+      gst_app_src_set_max_time (appsrc, g_value_get_uint64 (value));
+      break;
+    case PROP_LEAKY_TYPE:
+      gst_app_src_set_leaky_type (appsrc, g_value_get_enum (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -823,6 +1472,20 @@ gst_app_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_DURATION:
       g_value_set_uint64 (value, gst_app_src_get_duration (appsrc));
       break;
+    case PROP_MAX_BUFFERS:
+      g_value_set_uint64 (value, gst_app_src_get_max_buffers (appsrc));
+      break;
+    case PROP_MAX_TIME:
+      g_value_set_uint64 (value, gst_app_src_get_max_time (appsrc));
+      break;
+    case PROP_LEAKY_TYPE:
+      g_value_set_enum (value, gst_app_src_get_leaky_type (appsrc));
+      break;
+    case PROP_DROPPED:
+      g_mutex_lock (&priv->mutex);
+      g_value_set_uint64 (value, priv->dropped);
+      g_mutex_unlock (&priv->mutex);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -914,6 +1577,8 @@ gst_app_src_stop (GstBaseSrc * bsrc)
   g_cond_broadcast (&priv->cond);
   g_mutex_unlock (&priv->mutex);
 
+  gst_app_src_clear_range_cache (appsrc);
+
   return TRUE;
 }
 
@@ -1163,6 +1828,99 @@ gst_app_src_negotiate (GstBaseSrc * basesrc)
   return result;
 }
 
+/* returns the part of @range starting at @offset, at most @size bytes */
+static GstBuffer *
+gst_app_src_range_region (GstBuffer * range, guint64 offset, guint size)
+{
+  GstBuffer *res;
+  gsize skip, avail;
+
+  skip = offset - GST_BUFFER_OFFSET (range);
+  avail = gst_buffer_get_size (range) - skip;
+
+  res = gst_buffer_copy_region (range, GST_BUFFER_COPY_ALL, skip,
+      MIN (avail, size));
+  GST_BUFFER_OFFSET (res) = offset;
+  GST_BUFFER_OFFSET_END (res) = offset + gst_buffer_get_size (res);
+
+  return res;
+}
+
+/* called without the lock from the streaming thread */
+static GstFlowReturn
+gst_app_src_read_range (GstAppSrc * appsrc, Callbacks * callbacks,
+    gint64 stream_size, guint64 offset, guint size, GstBuffer ** buf)
+{
+  GstAppSrcPrivate *priv = appsrc->priv;
+  GstBuffer *range = NULL;
+  GstFlowReturn ret;
+  guint64 read_size;
+  GList *l;
+
+  if (stream_size >= 0 && offset >= (guint64) stream_size)
+    goto eos;
+
+  /* serve the read from a recently read range if it contains all of it, or
+   * the rest of the stream */
+  for (l = priv->range_cache.head; l; l = l->next) {
+    GstBuffer *cached = l->data;
+    guint64 start = GST_BUFFER_OFFSET (cached);
+    guint64 end = start + gst_buffer_get_size (cached);
+
+    if (offset >= start && offset < end && (offset + size <= end
+            || (stream_size >= 0 && end >= (guint64) stream_size))) {
+      GST_LOG_OBJECT (appsrc, "read of %u bytes at %" G_GUINT64_FORMAT
+          " from cached range %" G_GUINT64_FORMAT "-%" G_GUINT64_FORMAT,
+          size, offset, start, end);
+      g_queue_unlink (&priv->range_cache, l);
+      g_queue_push_head_link (&priv->range_cache, l);
+      *buf = gst_app_src_range_region (cached, offset, size);
+      return GST_FLOW_OK;
+    }
+  }
+
+  read_size = MAX (size, RANGE_PREFETCH_SIZE);
+  if (stream_size >= 0)
+    read_size = MIN (read_size, stream_size - offset);
+
+  GST_LOG_OBJECT (appsrc, "reading %" G_GUINT64_FORMAT " bytes at %"
+      G_GUINT64_FORMAT " for a read of %u bytes", read_size, offset, size);
+
+  ret = callbacks->callbacks.get_range (appsrc, offset, read_size, &range,
+      callbacks->user_data);
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    GST_DEBUG_OBJECT (appsrc, "get_range returned %s",
+        gst_flow_get_name (ret));
+    if (range)
+      gst_buffer_unref (range);
+    return ret;
+  }
+
+  if (range == NULL || gst_buffer_get_size (range) == 0) {
+    if (range)
+      gst_buffer_unref (range);
+    goto eos;
+  }
+
+  range = gst_buffer_make_writable (range);
+  GST_BUFFER_OFFSET (range) = offset;
+  GST_BUFFER_OFFSET_END (range) = offset + gst_buffer_get_size (range);
+
+  *buf = gst_app_src_range_region (range, offset, size);
+
+  g_queue_push_head (&priv->range_cache, range);
+  if (g_queue_get_length (&priv->range_cache) > RANGE_CACHE_SIZE)
+    gst_buffer_unref (g_queue_pop_tail (&priv->range_cache));
+
+  return GST_FLOW_OK;
+
+eos:
+  {
+    GST_DEBUG_OBJECT (appsrc, "no data at offset %" G_GUINT64_FORMAT, offset);
+    return GST_FLOW_EOS;
+  }
+}
+
 static GstFlowReturn
 gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
     GstBuffer ** buf)
@@ -1201,6 +1959,20 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
   if (G_UNLIKELY (priv->flushing))
     goto flushing;
 
+  if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS
+      && priv->callbacks && priv->callbacks->callbacks.get_range) {
+    Callbacks *callbacks = callbacks_ref (priv->callbacks);
+    gint64 stream_size = priv->size;
+
+    g_mutex_unlock (&priv->mutex);
+
+    ret = gst_app_src_read_range (appsrc, callbacks, stream_size, offset,
+        size, buf);
+    callbacks_unref (callbacks);
+
+    return ret;
+  }
+
   if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS) {
     /* if we are dealing with a random-access stream, issue a seek if the offset
      * changed. */
@@ -1254,9 +2026,10 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         continue;
       }
 
+      buf_size = gst_app_src_queued_remove (appsrc, obj);
+
       if (GST_IS_BUFFER (obj)) {
         *buf = GST_BUFFER (obj);
-        buf_size = gst_buffer_get_size (*buf);
         GST_LOG_OBJECT (appsrc, "have buffer %p of size %u", *buf, buf_size);
       } else {
         GstBufferList *buffer_list;
@@ -1265,8 +2038,6 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
 
         buffer_list = GST_BUFFER_LIST (obj);
 
-        buf_size = gst_buffer_list_calculate_size (buffer_list);
-
         GST_LOG_OBJECT (appsrc, "have buffer list %p of size %u, %u buffers",
             buffer_list, buf_size, gst_buffer_list_length (buffer_list));
 
@@ -1274,8 +2045,6 @@ gst_app_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
         *buf = NULL;
       }
 
-      priv->queued_bytes -= buf_size;
-
       /* only update the offset when in random_access mode */
       if (priv->stream_type == GST_APP_STREAM_TYPE_RANDOM_ACCESS)
         priv->offset += buf_size;
@@ -1631,6 +2400,182 @@ gst_app_src_get_max_bytes (GstAppSrc * appsrc)
   return result;
 }
 
+/**
+ * gst_app_src_set_max_buffers:
+ * @appsrc: a #GstAppSrc
+ * @max: the maximum number of buffers to queue
+ *
+ * Set the maximum amount of buffers that can be queued in @appsrc.
+ * After the maximum amount of buffers are queued, @appsrc will emit the
+ * "enough-data" signal.
+ *
+ * Since: 1.18
+ */
+void
+gst_app_src_set_max_buffers (GstAppSrc * appsrc, guint64 max)
+{
+  GstAppSrcPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SRC (appsrc));
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  if (max != priv->max_buffers) {
+    GST_DEBUG_OBJECT (appsrc, "setting max-buffers to %" G_GUINT64_FORMAT,
+        max);
+    priv->max_buffers = max;
+    /* signal the change */
+    g_cond_broadcast (&priv->cond);
+  }
+  g_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * gst_app_src_get_max_buffers:
+ * @appsrc: a #GstAppSrc
+ *
+ * Get the maximum amount of buffers that can be queued in @appsrc.
+ *
+ * Returns: The maximum amount of buffers that can be queued.
+ *
+ * Since: 1.18
+ */
+guint64
+gst_app_src_get_max_buffers (GstAppSrc * appsrc)
+{
+  guint64 result;
+  GstAppSrcPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), 0);
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  result = priv->max_buffers;
+  GST_DEBUG_OBJECT (appsrc, "getting max-buffers of %" G_GUINT64_FORMAT,
+      result);
+  g_mutex_unlock (&priv->mutex);
+
+  return result;
+}
+
+/**
+ * gst_app_src_set_max_time:
+ * @appsrc: a #GstAppSrc
+ * @max: the maximum amount of time to queue
+ *
+ * Set the maximum amount of time that can be queued in @appsrc.
+ * After the maximum amount of time are queued, @appsrc will emit the
+ * "enough-data" signal.
+ *
+ * Since: 1.18
+ */
+void
+gst_app_src_set_max_time (GstAppSrc * appsrc, GstClockTime max)
+{
+  GstAppSrcPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SRC (appsrc));
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  if (max != priv->max_time) {
+    GST_DEBUG_OBJECT (appsrc, "setting max-time to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (max));
+    priv->max_time = max;
+    /* signal the change */
+    g_cond_broadcast (&priv->cond);
+  }
+  g_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * gst_app_src_get_max_time:
+ * @appsrc: a #GstAppSrc
+ *
+ * Get the maximum amount of time that can be queued in @appsrc.
+ *
+ * Returns: The maximum amount of time that can be queued.
+ *
+ * Since: 1.18
+ */
+GstClockTime
+gst_app_src_get_max_time (GstAppSrc * appsrc)
+{
+  GstClockTime result;
+  GstAppSrcPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), 0);
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  result = priv->max_time;
+  GST_DEBUG_OBJECT (appsrc, "getting max-time of %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (result));
+  g_mutex_unlock (&priv->mutex);
+
+  return result;
+}
+
+/**
+ * gst_app_src_set_leaky_type:
+ * @appsrc: a #GstAppSrc
+ * @leaky: the #GstAppLeakyType
+ *
+ * When set to any other value than GST_APP_LEAKY_TYPE_NONE then the appsrc
+ * will drop any buffers that are pushed into it once its internal queue is
+ * full. The selected type defines whether to drop the oldest or newest
+ * buffers.
+ *
+ * Since: 1.18
+ */
+void
+gst_app_src_set_leaky_type (GstAppSrc * appsrc, GstAppLeakyType leaky)
+{
+  GstAppSrcPrivate *priv;
+
+  g_return_if_fail (GST_IS_APP_SRC (appsrc));
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  priv->leaky_type = leaky;
+  /* wake up pushers that are blocked on a full queue */
+  g_cond_broadcast (&priv->cond);
+  g_mutex_unlock (&priv->mutex);
+}
+
+/**
+ * gst_app_src_get_leaky_type:
+ * @appsrc: a #GstAppSrc
+ *
+ * Returns the currently set #GstAppLeakyType. See gst_app_src_set_leaky_type()
+ * for more details.
+ *
+ * Returns: The currently set #GstAppLeakyType.
+ *
+ * Since: 1.18
+ */
+GstAppLeakyType
+gst_app_src_get_leaky_type (GstAppSrc * appsrc)
+{
+  GstAppLeakyType result;
+  GstAppSrcPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_APP_LEAKY_TYPE_NONE);
+
+  priv = appsrc->priv;
+
+  g_mutex_lock (&priv->mutex);
+  result = priv->leaky_type;
+  g_mutex_unlock (&priv->mutex);
+
+  return result;
+}
+
 /**
  * gst_app_src_get_current_level_bytes:
  * @appsrc: a #GstAppSrc
@@ -1852,10 +2797,11 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     if (priv->is_eos)
       goto eos;
 
-    if (priv->max_bytes && priv->queued_bytes >= priv->max_bytes) {
+    if (gst_app_src_is_full (appsrc)) {
       GST_DEBUG_OBJECT (appsrc,
-          "queue filled (%" G_GUINT64_FORMAT " >= %" G_GUINT64_FORMAT ")",
-          priv->queued_bytes, priv->max_bytes);
+          "queue filled (%" G_GUINT64_FORMAT " bytes, %" G_GUINT64_FORMAT
+          " buffers, %" GST_TIME_FORMAT ")", priv->queued_bytes,
+          priv->queued_buffers, GST_TIME_ARGS (priv->queued_time));
 
       if (first) {
         Callbacks *callbacks = NULL;
@@ -1880,7 +2826,15 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
         first = FALSE;
         continue;
       }
-      if (priv->block) {
+      if (priv->leaky_type == GST_APP_LEAKY_TYPE_UPSTREAM) {
+        goto dropped;
+      } else if (priv->leaky_type == GST_APP_LEAKY_TYPE_DOWNSTREAM) {
+        /* make room by dropping the oldest data, stop when there is nothing
+         * else left to drop */
+        if (gst_app_src_drop_oldest (appsrc))
+          continue;
+        break;
+      } else if (priv->block) {
         GST_DEBUG_OBJECT (appsrc, "waiting for free space");
         /* we are filled, wait until a buffer gets popped or when we
          * flush. */
@@ -1902,13 +2856,13 @@ gst_app_src_push_internal (GstAppSrc * appsrc, GstBuffer * buffer,
     if (!steal_ref)
       gst_buffer_list_ref (buflist);
     gst_queue_array_push_tail (priv->queue, buflist);
-    priv->queued_bytes += gst_buffer_list_calculate_size (buflist);
+    gst_app_src_queued_add (appsrc, GST_MINI_OBJECT_CAST (buflist));
   } else {
     GST_DEBUG_OBJECT (appsrc, "queueing buffer %p", buffer);
     if (!steal_ref)
       gst_buffer_ref (buffer);
     gst_queue_array_push_tail (priv->queue, buffer);
-    priv->queued_bytes += gst_buffer_get_size (buffer);
+    gst_app_src_queued_add (appsrc, GST_MINI_OBJECT_CAST (buffer));
   }
 
   if ((priv->wait_status & STREAM_WAITING))
@@ -1935,6 +2889,23 @@ eos:
     g_mutex_unlock (&priv->mutex);
     return GST_FLOW_EOS;
   }
+dropped:
+  {
+    if (buflist != NULL) {
+      GST_DEBUG_OBJECT (appsrc, "dropped new buffer list %p, we are full",
+          buflist);
+      priv->dropped += gst_buffer_list_length (buflist);
+      if (steal_ref)
+        gst_buffer_list_unref (buflist);
+    } else {
+      GST_DEBUG_OBJECT (appsrc, "dropped new buffer %p, we are full", buffer);
+      priv->dropped++;
+      if (steal_ref)
+        gst_buffer_unref (buffer);
+    }
+    g_mutex_unlock (&priv->mutex);
+    return GST_FLOW_OK;
+  }
 }
 
 static GstFlowReturn
@@ -2047,6 +3018,250 @@ gst_app_src_push_sample (GstAppSrc * appsrc, GstSample * sample)
   return gst_app_src_push_sample_internal (appsrc, sample);
 }
 
+/**
+ * gst_app_src_wrap_memory:
+ * @appsrc: a #GstAppSrc
+ * @data: (array length=size) (element-type guint8) (transfer none): data to
+ *   wrap
+ * @size: size of @data in bytes
+ * @user_data: (allow-none): user data to pass to @notify
+ * @notify: (allow-none) (scope async) (closure user_data): called with
+ *   @user_data when the memory is no longer used
+ *
+ * Wraps @data in a #GstBuffer without copying it. @notify is called when
+ * the wrapped memory was released by all its users, after which @data can
+ * be reused by the application.
+ *
+ * Contrary to gst_buffer_new_wrapped_full(), the buffer and memory objects
+ * are recycled by @appsrc once they are released, so wrapping memory does
+ * not allocate in the steady state.
+ *
+ * The returned buffer can be timestamped by the caller before it is
+ * pushed with gst_app_src_push_buffer().
+ *
+ * Returns: (transfer full): a new #GstBuffer wrapping @data.
+ *
+ * Since: 1.18
+ */
+GstBuffer *
+gst_app_src_wrap_memory (GstAppSrc * appsrc, gpointer data, gsize size,
+    gpointer user_data, GDestroyNotify notify)
+{
+  AppSrcWrapPool *pool;
+  AppSrcMemory *mem;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), NULL);
+  g_return_val_if_fail (data != NULL, NULL);
+
+  pool = appsrc->priv->wrap_pool;
+
+  g_mutex_lock (&pool->lock);
+  mem = gst_queue_array_pop_head (pool->free_mems);
+  g_mutex_unlock (&pool->lock);
+
+  if (mem == NULL)
+    mem = wrap_pool_new_memory (pool);
+  wrap_pool_ref (pool);
+
+  GST_MINI_OBJECT_FLAGS (mem) = 0;
+  mem->data = data;
+  mem->mem.maxsize = size;
+  mem->mem.offset = 0;
+  mem->mem.size = size;
+  mem->user_data = user_data;
+  mem->notify = notify;
+
+  return wrap_pool_acquire_buffer (pool, GST_MEMORY_CAST (mem));
+}
+
+/**
+ * gst_app_src_push_memory:
+ * @appsrc: a #GstAppSrc
+ * @data: (array length=size) (element-type guint8) (transfer none): data to
+ *   push
+ * @size: size of @data in bytes
+ * @user_data: (allow-none): user data to pass to @notify
+ * @notify: (allow-none) (scope async) (closure user_data): called with
+ *   @user_data when the memory is no longer used
+ *
+ * Wraps @data with gst_app_src_wrap_memory() and pushes the resulting
+ * buffer with gst_app_src_push_buffer(). @notify is also called when the
+ * buffer could not be queued.
+ *
+ * Returns: #GST_FLOW_OK when the buffer was successfully queued.
+ * #GST_FLOW_FLUSHING when @appsrc is not PAUSED or PLAYING.
+ * #GST_FLOW_EOS when EOS occurred.
+ *
+ * Since: 1.18
+ */
+GstFlowReturn
+gst_app_src_push_memory (GstAppSrc * appsrc, gpointer data, gsize size,
+    gpointer user_data, GDestroyNotify notify)
+{
+  GstBuffer *buffer;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), GST_FLOW_ERROR);
+
+  buffer = gst_app_src_wrap_memory (appsrc, data, size, user_data, notify);
+  if (buffer == NULL)
+    return GST_FLOW_ERROR;
+
+  return gst_app_src_push_buffer_full (appsrc, buffer, TRUE);
+}
+
+/**
+ * gst_app_src_set_memory_regions:
+ * @appsrc: a #GstAppSrc
+ * @n_regions: the number of regions
+ * @regions: (array length=n_regions) (allow-none): the start of each region
+ * @sizes: (array length=n_regions) (allow-none): the size of each region
+ * @func: (allow-none) (scope notified): called when a region is released
+ * @user_data: (allow-none): user data to pass to @func
+ * @notify: (allow-none): called with @user_data when the regions are
+ *   replaced or @appsrc is destroyed
+ *
+ * Registers a fixed set of memory regions, such as the slots in a capture
+ * ring buffer. Buffers for the regions are then obtained with
+ * gst_app_src_acquire_region_buffer() and @func is called with the index of
+ * the region when it was released by all its users.
+ *
+ * The memory objects of the regions are created once here and reused for
+ * all buffers of the region. Pass 0 @n_regions to remove the regions.
+ *
+ * Returns: %FALSE if a previously registered region is still in use.
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_app_src_set_memory_regions (GstAppSrc * appsrc, guint n_regions,
+    const gpointer * regions, const gsize * sizes,
+    GstAppSrcRegionReleaseFunc func, gpointer user_data,
+    GDestroyNotify notify)
+{
+  AppSrcWrapPool *pool;
+  GDestroyNotify old_notify;
+  gpointer old_user_data;
+  guint i;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), FALSE);
+  g_return_val_if_fail (n_regions == 0 || (regions != NULL && sizes != NULL
+          && func != NULL), FALSE);
+
+  pool = appsrc->priv->wrap_pool;
+
+  g_mutex_lock (&pool->lock);
+  for (i = 0; i < pool->n_regions; i++) {
+    if (pool->regions[i].busy)
+      goto busy;
+  }
+  wrap_pool_clear_regions (pool, &old_notify, &old_user_data);
+
+  if (n_regions > 0) {
+    pool->regions = g_new0 (AppSrcRegion, n_regions);
+    for (i = 0; i < n_regions; i++) {
+      AppSrcMemory *mem = wrap_pool_new_memory (pool);
+
+      mem->data = regions[i];
+      mem->mem.maxsize = mem->mem.size = sizes[i];
+      mem->region = i;
+      pool->regions[i].mem = mem;
+    }
+    pool->n_regions = n_regions;
+    pool->region_release = func;
+    pool->region_user_data = user_data;
+    pool->region_notify = notify;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  /* the notify may call back into appsrc */
+  if (old_notify)
+    old_notify (old_user_data);
+
+  GST_DEBUG_OBJECT (appsrc, "registered %u memory regions", n_regions);
+
+  return TRUE;
+
+  /* ERRORS */
+busy:
+  {
+    g_mutex_unlock (&pool->lock);
+    GST_WARNING_OBJECT (appsrc, "region %u is still in use", i);
+    return FALSE;
+  }
+}
+
+/**
+ * gst_app_src_acquire_region_buffer:
+ * @appsrc: a #GstAppSrc
+ * @index: the index of the region
+ * @offset: the offset of the data in the region
+ * @size: the size of the data, or -1 to use the rest of the region
+ *
+ * Gets a buffer for @size bytes at @offset in the region @index that was
+ * registered with gst_app_src_set_memory_regions(). The region can't be
+ * acquired again until the release function was called for it.
+ *
+ * Returns: (transfer full) (nullable): a #GstBuffer for the region, or
+ * %NULL when the region is still in use.
+ *
+ * Since: 1.18
+ */
+GstBuffer *
+gst_app_src_acquire_region_buffer (GstAppSrc * appsrc, guint index,
+    gsize offset, gssize size)
+{
+  AppSrcWrapPool *pool;
+  AppSrcMemory *mem;
+
+  g_return_val_if_fail (GST_IS_APP_SRC (appsrc), NULL);
+
+  pool = appsrc->priv->wrap_pool;
+
+  g_mutex_lock (&pool->lock);
+  if (index >= pool->n_regions)
+    goto invalid_index;
+  if (pool->regions[index].busy)
+    goto busy;
+
+  mem = pool->regions[index].mem;
+  if (size == -1)
+    size = mem->mem.maxsize - offset;
+  if (offset + size > mem->mem.maxsize)
+    goto invalid_size;
+
+  pool->regions[index].busy = TRUE;
+  g_mutex_unlock (&pool->lock);
+
+  wrap_pool_ref (pool);
+
+  GST_MINI_OBJECT_FLAGS (mem) = 0;
+  mem->mem.offset = offset;
+  mem->mem.size = size;
+
+  return wrap_pool_acquire_buffer (pool, GST_MEMORY_CAST (mem));
+
+  /* ERRORS */
+invalid_index:
+  {
+    g_mutex_unlock (&pool->lock);
+    g_critical ("invalid region index %u", index);
+    return NULL;
+  }
+busy:
+  {
+    g_mutex_unlock (&pool->lock);
+    GST_DEBUG_OBJECT (appsrc, "region %u is still in use", index);
+    return NULL;
+  }
+invalid_size:
+  {
+    g_mutex_unlock (&pool->lock);
+    g_critical ("invalid offset %" G_GSIZE_FORMAT " and size %" G_GSSIZE_FORMAT
+        " for region %u", offset, size, index);
+    return NULL;
+  }
+}
+
 /* push a buffer without stealing the ref of the buffer. This is used for the
  * action signal. */
 static GstFlowReturn
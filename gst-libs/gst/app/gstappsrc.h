@@ -57,6 +57,10 @@ typedef struct _GstAppSrcPrivate GstAppSrcPrivate;
  * @seek_data: Called when a seek should be performed to the offset.
  *    The next push-buffer should produce buffers from the new @offset.
  *    This callback is only called for seekable stream types.
+ * @get_range: Called from the streaming thread in the random-access stream
+ *    type to read @size bytes at @offset into @buffer. Fewer bytes can be
+ *    returned at the end of the stream. When set, need_data and seek_data are
+ *    not called and buffers pushed into appsrc are not used. Since: 1.18
  *
  * A set of callbacks that can be installed on the appsrc with
  * gst_app_src_set_callbacks().
@@ -65,9 +69,11 @@ typedef struct {
   void      (*need_data)    (GstAppSrc *src, guint length, gpointer user_data);
   void      (*enough_data)  (GstAppSrc *src, gpointer user_data);
   gboolean  (*seek_data)    (GstAppSrc *src, guint64 offset, gpointer user_data);
+  GstFlowReturn (*get_range) (GstAppSrc *src, guint64 offset, guint size,
+                              GstBuffer **buffer, gpointer user_data);
 
   /*< private >*/
-  gpointer     _gst_reserved[GST_PADDING];
+  gpointer     _gst_reserved[GST_PADDING - 1];
 } GstAppSrcCallbacks;
 
 /**
@@ -88,6 +94,36 @@ typedef enum
   GST_APP_STREAM_TYPE_RANDOM_ACCESS
 } GstAppStreamType;
 
+/**
+ * GstAppLeakyType:
+ * @GST_APP_LEAKY_TYPE_NONE: Not Leaky
+ * @GST_APP_LEAKY_TYPE_UPSTREAM: Leaky on upstream (new buffers)
+ * @GST_APP_LEAKY_TYPE_DOWNSTREAM: Leaky on downstream (old buffers)
+ *
+ * Buffer dropping scheme to avoid the element's internal queue to block when
+ * full.
+ *
+ * Since: 1.18
+ */
+typedef enum {
+  GST_APP_LEAKY_TYPE_NONE,
+  GST_APP_LEAKY_TYPE_UPSTREAM,
+  GST_APP_LEAKY_TYPE_DOWNSTREAM
+} GstAppLeakyType;
+
+/**
+ * GstAppSrcRegionReleaseFunc:
+ * @index: the index of the released region
+ * @user_data: the user data passed to gst_app_src_set_memory_regions()
+ *
+ * Called when the memory of a region registered with
+ * gst_app_src_set_memory_regions() is no longer used and the region can be
+ * filled again.
+ *
+ * Since: 1.18
+ */
+typedef void (*GstAppSrcRegionReleaseFunc) (guint index, gpointer user_data);
+
 struct _GstAppSrc
 {
   GstBaseSrc basesrc;
@@ -151,6 +187,24 @@ void             gst_app_src_set_max_bytes           (GstAppSrc *appsrc, guint64
 GST_APP_API
 guint64          gst_app_src_get_max_bytes           (GstAppSrc *appsrc);
 
+GST_APP_API
+void             gst_app_src_set_max_buffers         (GstAppSrc *appsrc, guint64 max);
+
+GST_APP_API
+guint64          gst_app_src_get_max_buffers         (GstAppSrc *appsrc);
+
+GST_APP_API
+void             gst_app_src_set_max_time            (GstAppSrc *appsrc, GstClockTime max);
+
+GST_APP_API
+GstClockTime     gst_app_src_get_max_time            (GstAppSrc *appsrc);
+
+GST_APP_API
+void             gst_app_src_set_leaky_type          (GstAppSrc *appsrc, GstAppLeakyType leaky);
+
+GST_APP_API
+GstAppLeakyType  gst_app_src_get_leaky_type          (GstAppSrc *appsrc);
+
 GST_APP_API
 guint64          gst_app_src_get_current_level_bytes (GstAppSrc *appsrc);
 
@@ -178,6 +232,24 @@ GstFlowReturn    gst_app_src_end_of_stream           (GstAppSrc *appsrc);
 GST_APP_API
 GstFlowReturn    gst_app_src_push_sample             (GstAppSrc *appsrc, GstSample *sample);
 
+GST_APP_API
+GstBuffer *      gst_app_src_wrap_memory             (GstAppSrc *appsrc, gpointer data, gsize size,
+                                                      gpointer user_data, GDestroyNotify notify);
+
+GST_APP_API
+GstFlowReturn    gst_app_src_push_memory             (GstAppSrc *appsrc, gpointer data, gsize size,
+                                                      gpointer user_data, GDestroyNotify notify);
+
+GST_APP_API
+gboolean         gst_app_src_set_memory_regions      (GstAppSrc *appsrc, guint n_regions,
+                                                      const gpointer *regions, const gsize *sizes,
+                                                      GstAppSrcRegionReleaseFunc func,
+                                                      gpointer user_data, GDestroyNotify notify);
+
+GST_APP_API
+GstBuffer *      gst_app_src_acquire_region_buffer   (GstAppSrc *appsrc, guint index,
+                                                      gsize offset, gssize size);
+
 GST_APP_API
 void             gst_app_src_set_callbacks           (GstAppSrc * appsrc,
                                                       GstAppSrcCallbacks *callbacks,
@@ -57,6 +57,15 @@ ensure_debug_category (void)
 typedef void (*MixerFunc) (GstAudioChannelMixer * mix, const gpointer src[],
     gpointer dst[], gint samples);
 
+/* the input channels contributing to one output channel */
+typedef struct
+{
+  gint n_taps;
+  gint *in;
+  gfloat *coeff;
+  gint *coeff_int;
+} MixerTaps;
+
 struct _GstAudioChannelMixer
 {
   gint in_channels;
@@ -70,6 +79,9 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* the non-zero matrix entries for each of the out_channels */
+  MixerTaps *taps;
+
   MixerFunc func;
 };
 
@@ -95,6 +107,14 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  for (i = 0; i < mix->out_channels; i++) {
+    g_free (mix->taps[i].in);
+    g_free (mix->taps[i].coeff);
+    g_free (mix->taps[i].coeff_int);
+  }
+  g_free (mix->taps);
+  mix->taps = NULL;
+
   g_slice_free (GstAudioChannelMixer, mix);
 }
 
@@ -673,6 +693,44 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* only call after mix->matrix and mix->matrix_int are set up. Collects
+ * the non-zero coefficients per output channel so that the mix functions
+ * don't have to go over the zeroes, which are the majority for most down-
+ * and upmixes. Returns %TRUE if every output is a plain copy of one input
+ * or silent, then the samples only need to be reordered */
+static gboolean
+gst_audio_channel_mixer_setup_taps (GstAudioChannelMixer * mix)
+{
+  gboolean reorder = TRUE;
+  gint i, j, n;
+
+  mix->taps = g_new0 (MixerTaps, mix->out_channels);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    MixerTaps *taps = &mix->taps[j];
+
+    taps->in = g_new (gint, mix->in_channels);
+    taps->coeff = g_new (gfloat, mix->in_channels);
+    taps->coeff_int = g_new (gint, mix->in_channels);
+
+    for (i = 0, n = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0f)
+        continue;
+
+      taps->in[n] = i;
+      taps->coeff[n] = mix->matrix[i][j];
+      taps->coeff_int[n] = mix->matrix_int[i][j];
+      n++;
+    }
+    taps->n_taps = n;
+
+    if (n > 1 || (n == 1 && taps->coeff[0] != 1.0f))
+      reorder = FALSE;
+  }
+
+  return reorder;
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -731,21 +789,23 @@ gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const gint##bits * in_data[], \
     gint##bits * out_data[], gint samples) \
 { \
-  gint in, out, n; \
+  gint t, out, n; \
   gint##resbits res; \
   gint inchannels, outchannels; \
+  const MixerTaps *taps; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
   for (n = 0; n < samples; n++) { \
     for (out = 0; out < outchannels; out++) { \
-      /* convert */ \
+      taps = &mix->taps[out]; \
+      /* convert, only the inputs with non-zero coefficients */ \
       res = 0; \
-      for (in = 0; in < inchannels; in++) \
+      for (t = 0; t < taps->n_taps; t++) \
         res += \
-          _get_in_data_##inlayout##_gint##bits (in_data, n, in, inchannels) * \
-          (gint##resbits) mix->matrix_int[in][out]; \
+          _get_in_data_##inlayout##_gint##bits (in_data, n, taps->in[t], \
+              inchannels) * (gint##resbits) taps->coeff_int[t]; \
       \
       /* remove factor from int matrix */ \
       res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
@@ -761,46 +821,86 @@ gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const g##type * in_data[], \
     g##type * out_data[], gint samples) \
 { \
-  gint in, out, n; \
+  gint t, out, n; \
   g##type res; \
   gint inchannels, outchannels; \
+  const MixerTaps *taps; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
   \
   for (n = 0; n < samples; n++) { \
     for (out = 0; out < outchannels; out++) { \
-      /* convert */ \
+      taps = &mix->taps[out]; \
+      /* convert, only the inputs with non-zero coefficients */ \
       res = 0.0; \
-      for (in = 0; in < inchannels; in++) \
+      for (t = 0; t < taps->n_taps; t++) \
         res += \
-          _get_in_data_##inlayout##_g##type (in_data, n, in, inchannels) * \
-          mix->matrix[in][out]; \
+          _get_in_data_##inlayout##_g##type (in_data, n, taps->in[t], \
+              inchannels) * taps->coeff[t]; \
       \
       *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = res; \
     } \
   } \
 }
 
+/* all outputs are copies of a single input or silent, go over the outputs
+ * one by one so that a plain copy remains per channel */
+#define DEFINE_REORDER_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_reorder_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint samples) \
+{ \
+  gint in, out, n; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (out = 0; out < outchannels; out++) { \
+    if (mix->taps[out].n_taps == 0) { \
+      for (n = 0; n < samples; n++) \
+        *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = 0; \
+      continue; \
+    } \
+    \
+    in = mix->taps[out].in[0]; \
+    for (n = 0; n < samples; n++) \
+      *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = \
+          _get_in_data_##inlayout##_##type (in_data, n, in, inchannels); \
+  } \
+}
+
+#define DEFINE_REORDER_FUNCS(type) \
+DEFINE_REORDER_FUNC (type, interleaved, interleaved); \
+DEFINE_REORDER_FUNC (type, interleaved, planar); \
+DEFINE_REORDER_FUNC (type, planar, interleaved); \
+DEFINE_REORDER_FUNC (type, planar, planar)
+
 DEFINE_GET_DATA_FUNCS (gint16);
+DEFINE_REORDER_FUNCS (gint16);
 DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (16, 32, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gint32);
+DEFINE_REORDER_FUNCS (gint32);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, interleaved, planar);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, interleaved);
 DEFINE_INTEGER_MIX_FUNC (32, 64, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gfloat);
+DEFINE_REORDER_FUNCS (gfloat);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (float, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (float, planar, planar);
 
 DEFINE_GET_DATA_FUNCS (gdouble);
+DEFINE_REORDER_FUNCS (gdouble);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (double, planar, interleaved);
@@ -829,6 +929,7 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, gint out_channels, gfloat ** matrix)
 {
   GstAudioChannelMixer *mix;
+  gboolean reorder;
 
   g_return_val_if_fail (format == GST_AUDIO_FORMAT_S16
       || format == GST_AUDIO_FORMAT_S32
@@ -886,87 +987,67 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   }
 #endif
 
+  reorder = gst_audio_channel_mixer_setup_taps (mix);
+
+#ifndef GST_DISABLE_GST_DEBUG
+  {
+    gint j, n_taps = 0;
+
+    for (j = 0; j < mix->out_channels; j++)
+      n_taps += mix->taps[j].n_taps;
+
+    GST_DEBUG ("%s, %d of %d coefficients non-zero",
+        reorder ? "reordering channels" : "mixing non-zero coefficients",
+        n_taps, mix->in_channels * mix->out_channels);
+  }
+#endif
+
+#define SELECT_MIX_FUNC(prefix) G_STMT_START { \
+    if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) { \
+      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) \
+        mix->func = (MixerFunc) prefix##_planar_planar; \
+      else \
+        mix->func = (MixerFunc) prefix##_planar_interleaved; \
+    } else { \
+      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) \
+        mix->func = (MixerFunc) prefix##_interleaved_planar; \
+      else \
+        mix->func = (MixerFunc) prefix##_interleaved_interleaved; \
+    } \
+} G_STMT_END
+
   switch (format) {
     case GST_AUDIO_FORMAT_S16:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int16_interleaved_interleaved;
-        }
-      }
+      if (reorder)
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_reorder_gint16);
+      else
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_mix_int16);
       break;
     case GST_AUDIO_FORMAT_S32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_int32_interleaved_interleaved;
-        }
-      }
+      if (reorder)
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_reorder_gint32);
+      else
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_mix_int32);
       break;
     case GST_AUDIO_FORMAT_F32:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_float_interleaved_interleaved;
-        }
-      }
+      if (reorder)
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_reorder_gfloat);
+      else
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_mix_float);
       break;
     case GST_AUDIO_FORMAT_F64:
-      if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_planar_interleaved;
-        }
-      } else {
-        if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_planar;
-        } else {
-          mix->func = (MixerFunc)
-              gst_audio_channel_mixer_mix_double_interleaved_interleaved;
-        }
-      }
+      if (reorder)
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_reorder_gdouble);
+      else
+        SELECT_MIX_FUNC (gst_audio_channel_mixer_mix_double);
       break;
     default:
       g_assert_not_reached ();
       break;
   }
+
+#undef SELECT_MIX_FUNC
+
   return mix;
 }
 
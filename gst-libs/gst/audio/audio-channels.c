@@ -182,6 +182,28 @@ check_valid_channel_positions (const GstAudioChannelPosition * position,
   return TRUE;
 }
 
+#define DEFINE_REORDER_FUNC(type)                                       \
+static void                                                             \
+reorder_channels_##type (type * ptr, gint n, gint channels,             \
+    const gint * reorder_map)                                           \
+{                                                                       \
+  type tmp[64];                                                         \
+  gint i, j;                                                            \
+                                                                        \
+  for (i = 0; i < n; i++) {                                             \
+    for (j = 0; j < channels; j++)                                      \
+      tmp[reorder_map[j]] = ptr[j];                                     \
+    for (j = 0; j < channels; j++)                                      \
+      ptr[j] = tmp[j];                                                  \
+    ptr += channels;                                                    \
+  }                                                                     \
+}
+
+DEFINE_REORDER_FUNC (guint8);
+DEFINE_REORDER_FUNC (guint16);
+DEFINE_REORDER_FUNC (guint32);
+DEFINE_REORDER_FUNC (guint64);
+
 /**
  * gst_audio_reorder_channels:
  * @data: (array length=size) (element-type guint8): The pointer to
@@ -238,6 +260,28 @@ gst_audio_reorder_channels (gpointer data, gsize size, GstAudioFormat format,
   ptr = data;
 
   n = size / bpf;
+
+  /* copy whole samples instead of calling memcpy() for each of them when
+   * the data is suitably aligned */
+  if (((guintptr) data) % bps == 0) {
+    switch (bps) {
+      case 1:
+        reorder_channels_guint8 (data, n, channels, reorder_map);
+        return TRUE;
+      case 2:
+        reorder_channels_guint16 (data, n, channels, reorder_map);
+        return TRUE;
+      case 4:
+        reorder_channels_guint32 (data, n, channels, reorder_map);
+        return TRUE;
+      case 8:
+        reorder_channels_guint64 (data, n, channels, reorder_map);
+        return TRUE;
+      default:
+        break;
+    }
+  }
+
   for (i = 0; i < n; i++) {
 
     memcpy (tmp, ptr, bpf);
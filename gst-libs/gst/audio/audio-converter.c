@@ -145,6 +145,9 @@ struct _GstAudioConverter
   /* endian swap */
   AudioConvertEndianFunc swap_endian;
 
+  /* frames the generic chain processes at once */
+  gsize chunk_frames;
+
   AudioConvertSamplesFunc convert;
 };
 
@@ -409,6 +412,8 @@ get_output_samples (AudioChain * chain, gsize num_samples, gpointer user_data)
   return convert->out_data;
 }
 
+#define CHUNK_SIZE (32 * 1024)
+
 #define MEM_ALIGN(m,a) ((gint8 *)((guintptr)((gint8 *)(m) + ((a)-1)) & ~((a)-1)))
 #define ALIGN 16
 
@@ -1254,7 +1259,7 @@ converter_endian (GstAudioConverter * convert,
 }
 
 static gboolean
-converter_generic (GstAudioConverter * convert,
+converter_generic_chunk (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
     gpointer out[], gsize out_frames)
 {
@@ -1284,6 +1289,67 @@ converter_generic (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* Run the chain on blocks of chunk_frames instead of on all frames at once,
+ * so that each stage reads the samples written by the previous one while
+ * they are still in the cache and the temporary buffers stay small */
+static gboolean
+converter_generic (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  gpointer *in_chunk, *out_chunk;
+  gint i, in_blocks, out_blocks;
+  gsize in_stride, out_stride, in_done, out_done;
+
+  if (in_frames <= convert->chunk_frames)
+    return converter_generic_chunk (convert, flags, in, in_frames, out,
+        out_frames);
+
+  if (convert->in.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    in_blocks = convert->in.channels;
+    in_stride = GST_AUDIO_INFO_WIDTH (&convert->in) / 8;
+  } else {
+    in_blocks = 1;
+    in_stride = convert->in.bpf;
+  }
+  if (convert->out.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
+    out_blocks = convert->out.channels;
+    out_stride = GST_AUDIO_INFO_WIDTH (&convert->out) / 8;
+  } else {
+    out_blocks = 1;
+    out_stride = convert->out.bpf;
+  }
+
+  in_chunk = in ? g_newa (gpointer, in_blocks) : NULL;
+  out_chunk = g_newa (gpointer, out_blocks);
+
+  for (in_done = 0, out_done = 0; in_done < in_frames;) {
+    gsize in_len, out_len;
+
+    in_len = MIN (convert->chunk_frames, in_frames - in_done);
+    if (in_done + in_len == in_frames)
+      out_len = out_frames - out_done;
+    else if (convert->resampler)
+      out_len = MIN (gst_audio_resampler_get_out_frames (convert->resampler,
+              in_len), out_frames - out_done);
+    else
+      out_len = in_len;
+
+    for (i = 0; in && i < in_blocks; i++)
+      in_chunk[i] = (guint8 *) in[i] + in_done * in_stride;
+    for (i = 0; i < out_blocks; i++)
+      out_chunk[i] = (guint8 *) out[i] + out_done * out_stride;
+
+    if (!converter_generic_chunk (convert, flags, in_chunk, in_len, out_chunk,
+            out_len))
+      return FALSE;
+
+    in_done += in_len;
+    out_done += out_len;
+  }
+  return TRUE;
+}
+
 static gboolean
 converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -1377,6 +1443,11 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
   convert->in_place = FALSE;
   convert->passthrough = FALSE;
 
+  /* intermediate samples are at most F64, keep a block of them within
+   * CHUNK_SIZE bytes */
+  convert->chunk_frames = MAX (CHUNK_SIZE / (sizeof (gdouble) *
+          MAX (in_info->channels, out_info->channels)), 64);
+
   /* optimize */
   if (convert->mix_passthrough) {
     if (out_info->finfo->format == in_info->finfo->format) {
@@ -1665,3 +1736,90 @@ gst_audio_converter_is_passthrough (GstAudioConverter * convert)
 {
   return convert->passthrough;
 }
+
+/* conversions run by gst_audio_converter_precompile(), format and channels */
+static const struct
+{
+  GstAudioFormat in_format;
+  gint in_channels;
+  GstAudioFormat out_format;
+  gint out_channels;
+} precompile_conversions[] = {
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_F32, 2},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_S32, 2, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_S24, 2, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_S32, 2},
+  {GST_AUDIO_FORMAT_F64, 2, GST_AUDIO_FORMAT_F32, 2},
+  {GST_AUDIO_FORMAT_S16, 2, GST_AUDIO_FORMAT_S16, 1},
+  {GST_AUDIO_FORMAT_S16, 1, GST_AUDIO_FORMAT_S16, 2},
+  {GST_AUDIO_FORMAT_F32, 2, GST_AUDIO_FORMAT_F32, 1},
+  {GST_AUDIO_FORMAT_F32, 6, GST_AUDIO_FORMAT_F32, 2},
+};
+
+#define PRECOMPILE_FRAMES 64
+
+static gpointer
+precompile_func (gpointer data)
+{
+  GstClockTime start = gst_util_get_timestamp ();
+  GstAudioInfo in_info, out_info;
+  GstAudioConverter *convert;
+  gpointer in[1], out[1];
+  guint i;
+
+  /* big enough for 64 frames of 6 channels F64 */
+  in[0] = g_malloc0 (PRECOMPILE_FRAMES * 6 * 8);
+  out[0] = g_malloc0 (PRECOMPILE_FRAMES * 6 * 8);
+
+  for (i = 0; i < G_N_ELEMENTS (precompile_conversions); i++) {
+    gst_audio_info_set_format (&in_info, precompile_conversions[i].in_format,
+        48000, precompile_conversions[i].in_channels, NULL);
+    gst_audio_info_set_format (&out_info, precompile_conversions[i].out_format,
+        48000, precompile_conversions[i].out_channels, NULL);
+
+    convert = gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_NONE,
+        &in_info, &out_info, NULL);
+    if (convert == NULL)
+      continue;
+
+    gst_audio_converter_samples (convert, GST_AUDIO_CONVERTER_FLAG_NONE, in,
+        PRECOMPILE_FRAMES, out, PRECOMPILE_FRAMES);
+    gst_audio_converter_free (convert);
+  }
+
+  g_free (in[0]);
+  g_free (out[0]);
+
+  GST_DEBUG ("precompiled conversions in %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (gst_util_get_timestamp () - start));
+
+  return NULL;
+}
+
+/**
+ * gst_audio_converter_precompile:
+ * @async: %TRUE to return immediately and do the work from a new thread
+ *
+ * Converts a few samples between the most common audio formats and channel
+ * layouts once. The Orc programs used by these conversions are compiled when
+ * they are first run, which otherwise happens on the streaming thread while
+ * converting the first buffers of a pipeline.
+ *
+ * Only the first call does something, later calls return immediately.
+ *
+ * Since: 1.18
+ */
+void
+gst_audio_converter_precompile (gboolean async)
+{
+  static gsize precompiled = 0;
+
+  if (g_once_init_enter (&precompiled)) {
+    if (async)
+      g_thread_unref (g_thread_new ("audio-precompile", precompile_func, NULL));
+    else
+      precompile_func (NULL);
+    g_once_init_leave (&precompiled, 1);
+  }
+}
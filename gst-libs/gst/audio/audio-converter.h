@@ -168,6 +168,9 @@ gboolean             gst_audio_converter_convert          (GstAudioConverter * c
                                                            gpointer in, gsize in_size,
                                                            gpointer *out, gsize *out_size);
 
+GST_AUDIO_API
+void                 gst_audio_converter_precompile       (gboolean async);
+
 G_END_DECLS
 
 #endif /* __GST_AUDIO_CONVERTER_H__ */
@@ -179,17 +179,39 @@ gst_audio_info_set_format (GstAudioInfo * info, GstAudioFormat format,
     info->position[i] = GST_AUDIO_CHANNEL_POSITION_NONE;
 }
 
-/**
- * gst_audio_info_from_caps:
- * @info: a #GstAudioInfo
- * @caps: a #GstCaps
- *
- * Parse @caps and update @info.
- *
- * Returns: TRUE if @caps could be parsed
- */
-gboolean
-gst_audio_info_from_caps (GstAudioInfo * info, const GstCaps * caps)
+/* parsed #GstAudioInfo cached on shared caps, together with a copy of the
+ * caps it was parsed from. Caps that are shared now can become writable
+ * again when the other refs go away, and be modified in place, so the copy
+ * is compared before the cached info is used. */
+typedef struct
+{
+  GstCaps *caps;
+  GstAudioInfo info;
+} AudioInfoCache;
+
+static GMutex audio_info_cache_lock;
+
+static void
+audio_info_cache_free (AudioInfoCache * cache)
+{
+  gst_caps_unref (cache->caps);
+  g_slice_free (AudioInfoCache, cache);
+}
+
+static GQuark
+audio_info_cache_quark (void)
+{
+  static gsize quark = 0;
+
+  if (g_once_init_enter (&quark)) {
+    gsize q = g_quark_from_static_string ("GstAudioInfoCache");
+    g_once_init_leave (&quark, q);
+  }
+  return (GQuark) quark;
+}
+
+static gboolean
+audio_info_parse_caps (GstAudioInfo * info, const GstCaps * caps)
 {
   GstStructure *str;
   const gchar *s;
@@ -202,10 +224,6 @@ gst_audio_info_from_caps (GstAudioInfo * info, const GstCaps * caps)
   GstAudioFlags flags;
   GstAudioLayout layout = GST_AUDIO_LAYOUT_INTERLEAVED;
 
-  g_return_val_if_fail (info != NULL, FALSE);
-  g_return_val_if_fail (caps != NULL, FALSE);
-  g_return_val_if_fail (gst_caps_is_fixed (caps), FALSE);
-
   GST_DEBUG ("parsing caps %" GST_PTR_FORMAT, caps);
 
   flags = 0;
@@ -320,6 +338,62 @@ invalid_channel_mask:
   }
 }
 
+/**
+ * gst_audio_info_from_caps:
+ * @info: a #GstAudioInfo
+ * @caps: a #GstCaps
+ *
+ * Parse @caps and update @info.
+ *
+ * Parsing results of caps that are not writable are cached on the caps, so
+ * repeated calls with the same unchanged shared caps are cheap.
+ *
+ * Returns: TRUE if @caps could be parsed
+ */
+gboolean
+gst_audio_info_from_caps (GstAudioInfo * info, const GstCaps * caps)
+{
+  GstMiniObject *obj = GST_MINI_OBJECT_CAST (caps);
+  AudioInfoCache *cache;
+  gboolean cached = FALSE;
+  gboolean res;
+
+  g_return_val_if_fail (info != NULL, FALSE);
+  g_return_val_if_fail (caps != NULL, FALSE);
+  g_return_val_if_fail (gst_caps_is_fixed (caps), FALSE);
+
+  /* Writable caps are about to be modified by their owner, only shared caps
+   * keep the parsed info around for the next caller */
+  if (gst_mini_object_is_writable (obj))
+    return audio_info_parse_caps (info, caps);
+
+  g_mutex_lock (&audio_info_cache_lock);
+  cache = gst_mini_object_get_qdata (obj, audio_info_cache_quark ());
+  if (cache && gst_caps_is_strictly_equal (cache->caps, caps)) {
+    *info = cache->info;
+    cached = TRUE;
+  }
+  g_mutex_unlock (&audio_info_cache_lock);
+
+  if (cached)
+    return TRUE;
+
+  res = audio_info_parse_caps (info, caps);
+  if (res) {
+    cache = g_slice_new (AudioInfoCache);
+    cache->caps = gst_caps_copy (caps);
+    cache->info = *info;
+
+    /* replaces, and frees, an outdated entry */
+    g_mutex_lock (&audio_info_cache_lock);
+    gst_mini_object_set_qdata (obj, audio_info_cache_quark (), cache,
+        (GDestroyNotify) audio_info_cache_free);
+    g_mutex_unlock (&audio_info_cache_lock);
+  }
+
+  return res;
+}
+
 /**
  * gst_audio_info_to_caps:
  * @info: a #GstAudioInfo
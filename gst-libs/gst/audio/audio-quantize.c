@@ -36,6 +36,9 @@
 #include "gstaudiopack.h"
 #include "audio-quantize.h"
 
+/* number of random numbers generated in parallel */
+#define RANDOM_LANES 4
+
 typedef void (*QuantizeFunc) (GstAudioQuantize * quant, const gpointer src,
     gpointer dst, gint count);
 
@@ -52,6 +55,11 @@ struct _GstAudioQuantize
   guint shift;
   guint32 mask, bias;
 
+  /* state of the random number generator, the last RANDOM_LANES values */
+  guint32 random_state[RANDOM_LANES];
+  /* scratch buffer for random numbers */
+  guint random_size;
+  gpointer random_buf;
   /* last random number generated per channel for hifreq TPDF dither */
   gpointer last_random;
   /* contains the past quantization errors, error[channels][count] */
@@ -67,13 +75,12 @@ struct _GstAudioQuantize
   QuantizeFunc quantize;
 };
 
-#define ADDSS(res,val) \
-        if (val > 0 && res > 0 && G_MAXINT32 - res <= val){             \
-          res = G_MAXINT32;                                             \
-        } else if (val < 0 && res < 0 && G_MININT32 - res >= val){      \
-          res = G_MININT32;                                             \
-        } else                                                          \
-          res += val;
+/* saturating add, written without branches so that the loops using it
+ * can be vectorized */
+#define ADDSS(res,val) G_STMT_START {                                   \
+          gint64 _tmp = (gint64) (res) + (val);                         \
+          res = CLAMP (_tmp, G_MININT32, G_MAXINT32);                   \
+        } G_STMT_END
 
 static void
 gst_audio_quantize_quantize_memcpy (GstAudioQuantize * quant,
@@ -92,27 +99,70 @@ gst_audio_quantize_quantize_int_none_none (GstAudioQuantize * quant,
       samples * quant->stride);
 }
 
-/* This is the base function, implementing a linear congruential generator
- * and returning a pseudo random number between 0 and 2^32 - 1.
- */
-static inline guint32
-gst_fast_random_uint32 (void)
+/* The random numbers come from a linear congruential generator,
+ * x[n+1] = x[n] * RANDOM_A + RANDOM_C. To generate them in independent lanes
+ * we keep the last RANDOM_LANES values and advance each of them by
+ * RANDOM_LANES steps at once, which yields exactly the same sequence. */
+#define RANDOM_SEED 0xdeadbeef
+#define RANDOM_A 1103515245U
+#define RANDOM_C 12345U
+/* RANDOM_A^4 and RANDOM_C * (RANDOM_A^3 + RANDOM_A^2 + RANDOM_A + 1) */
+#define RANDOM_A4 (RANDOM_A * RANDOM_A * RANDOM_A * RANDOM_A)
+#define RANDOM_C4 (RANDOM_C * (RANDOM_A * RANDOM_A * RANDOM_A + \
+    RANDOM_A * RANDOM_A + RANDOM_A + 1))
+
+static void
+gst_audio_quantize_init_random (GstAudioQuantize * quant)
+{
+  guint32 state = RANDOM_SEED;
+  gint i;
+
+  for (i = 0; i < RANDOM_LANES; i++)
+    quant->random_state[i] = state = state * RANDOM_A + RANDOM_C;
+}
+
+/* fill @r with the next @len pseudo random numbers between 0 and 2^32 - 1 */
+static void
+gst_audio_quantize_fill_random (GstAudioQuantize * quant, guint32 * r,
+    gint len)
 {
-  static guint32 state = 0xdeadbeef;
-  return (state = state * 1103515245 + 12345);
+  guint32 *state = quant->random_state;
+  gint i, k;
+
+  for (i = 0; i + RANDOM_LANES <= len; i += RANDOM_LANES) {
+    for (k = 0; k < RANDOM_LANES; k++)
+      r[i + k] = state[k] = state[k] * RANDOM_A4 + RANDOM_C4;
+  }
+  if (i < len) {
+    guint32 next[RANDOM_LANES];
+    gint rem = len - i;
+
+    for (k = 0; k < rem; k++)
+      r[i + k] = next[k] = state[k] * RANDOM_A4 + RANDOM_C4;
+
+    /* keep the last RANDOM_LANES values in order */
+    memmove (state, state + rem, (RANDOM_LANES - rem) * sizeof (guint32));
+    memcpy (state + RANDOM_LANES - rem, next, rem * sizeof (guint32));
+  }
 }
 
-static inline gint32
-gst_fast_random_int32 (void)
+static guint32 *
+setup_random_buf (GstAudioQuantize * quant, gint len)
 {
-  return (gint32) gst_fast_random_uint32 ();
+  if (quant->random_size < len) {
+    quant->random_size = len;
+    quant->random_buf = g_realloc (quant->random_buf, len * sizeof (guint32));
+  }
+  gst_audio_quantize_fill_random (quant, quant->random_buf, len);
+
+  return quant->random_buf;
 }
 
-/* Assuming dither == 2^n,
- * returns one of 2^(n+1) possible random values:
+/* Assuming dither == 2^n, maps the random number @r to
+ * one of 2^(n+1) possible random values:
  * -dither <= retval < dither */
-#define RANDOM_INT_DITHER(dither)                                       \
-  (- dither + (gst_fast_random_int32 () & ((dither << 1) - 1)))
+#define RANDOM_INT_DITHER(r,dither)                                     \
+  (- dither + (gint32) ((r) & ((dither << 1) - 1)))
 
 static void
 setup_dither_buf (GstAudioQuantize * quant, gint samples)
@@ -121,7 +171,7 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
   gint stride = quant->stride;
   gint i, len = samples * stride;
   guint shift = quant->shift;
-  guint32 bias;
+  guint32 bias, *r;
   gint32 dither, *d;
 
   if (quant->dither_size < len) {
@@ -143,26 +193,35 @@ setup_dither_buf (GstAudioQuantize * quant, gint samples)
 
     case GST_AUDIO_DITHER_RPDF:
       dither = 1 << (shift);
+      r = setup_random_buf (quant, len);
       for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither);
+        d[i] = bias + RANDOM_INT_DITHER (r[i], dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF:
       dither = 1 << (shift - 1);
+      r = setup_random_buf (quant, 2 * len);
       for (i = 0; i < len; i++)
-        d[i] = bias + RANDOM_INT_DITHER (dither) + RANDOM_INT_DITHER (dither);
+        d[i] = bias + RANDOM_INT_DITHER (r[2 * i], dither) +
+            RANDOM_INT_DITHER (r[2 * i + 1], dither);
       break;
 
     case GST_AUDIO_DITHER_TPDF_HF:
     {
-      gint32 tmp, *last_random = quant->last_random;
+      gint32 *tmp, *last_random = quant->last_random;
 
       dither = 1 << (shift - 1);
-      for (i = 0; i < len; i++) {
-        tmp = RANDOM_INT_DITHER (dither);
-        d[i] = bias + tmp - last_random[i % stride];
-        last_random[i % stride] = tmp;
-      }
+      r = setup_random_buf (quant, len);
+      /* convert the random numbers in place, then subtract the value of
+       * the previous sample of the same channel */
+      tmp = (gint32 *) r;
+      for (i = 0; i < len; i++)
+        tmp[i] = RANDOM_INT_DITHER (r[i], dither);
+      for (i = 0; i < stride; i++)
+        d[i] = bias + tmp[i] - last_random[i];
+      for (; i < len; i++)
+        d[i] = bias + tmp[i] - tmp[i - stride];
+      memcpy (last_random, &tmp[len - stride], stride * sizeof (gint32));
       break;
     }
   }
@@ -197,7 +256,7 @@ gst_audio_quantize_quantize_int_dither_feedback (GstAudioQuantize * quant,
     const gpointer src, gpointer dst, gint samples)
 {
   guint32 mask;
-  gint i, len, stride;
+  gint i, n, c, len, stride;
   const gint32 *s = src;
   gint32 *dith, *d = dst, v, o, *e, err;
 
@@ -210,18 +269,23 @@ gst_audio_quantize_quantize_int_dither_feedback (GstAudioQuantize * quant,
   e = quant->error_buf;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    o = v = s[i];
-    /* add dither */
-    err = dith[i];
-    /* remove error */
-    err -= e[i];
-    ADDSS (v, err);
-    v &= mask;
-    /* store new error */
-    e[i + stride] = e[i] + (v - o);
-    /* store result */
-    d[i] = v;
+  /* the error of a sample only depends on the previous sample of the same
+   * channel, so all channels of a frame can be processed in parallel */
+  for (n = 0; n < len; n += stride) {
+    for (c = 0; c < stride; c++) {
+      i = n + c;
+      o = v = s[i];
+      /* add dither */
+      err = dith[i];
+      /* remove error */
+      err -= e[i];
+      ADDSS (v, err);
+      v &= mask;
+      /* store new error */
+      e[i + stride] = e[i] + (v - o);
+      /* store result */
+      d[i] = v;
+    }
   }
   memmove (e, &e[len], sizeof (gint32) * stride);
 }
@@ -237,7 +301,7 @@ gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
     const gpointer src, gpointer dst, gint samples)
 {
   guint32 mask;
-  gint i, j, k, len, stride, nc;
+  gint i, j, k, n, ch, len, stride, nc;
   const gint32 *s = src;
   gint32 *c, *dith, *d = dst, v, o, *e, err;
 
@@ -253,24 +317,28 @@ gst_audio_quantize_quantize_int_dither_noise_shape (GstAudioQuantize * quant,
   c = quant->coeffs;
   mask = ~quant->mask;
 
-  for (i = 0; i < len; i++) {
-    v = s[i];
-    /* combine and remove error */
-    err = 0;
-    for (j = 0, k = i; j < nc; j++, k += stride)
-      err -= e[k] * c[j];
-    err = (err + SROUND) >> (SREDUCE);
-    ADDSS (v, err);
-    o = v;
-    /* add dither */
-    err = dith[i];
-    ADDSS (v, err);
-    /* quantize */
-    v &= mask;
-    /* store new error with reduced precision */
-    e[k] = (v - o + RROUND) >> REDUCE;
-    /* store result */
-    d[i] = v;
+  /* like for error feedback, the channels of a frame are independent */
+  for (n = 0; n < len; n += stride) {
+    for (ch = 0; ch < stride; ch++) {
+      i = n + ch;
+      v = s[i];
+      /* combine and remove error */
+      err = 0;
+      for (j = 0, k = i; j < nc; j++, k += stride)
+        err -= e[k] * c[j];
+      err = (err + SROUND) >> (SREDUCE);
+      ADDSS (v, err);
+      o = v;
+      /* add dither */
+      err = dith[i];
+      ADDSS (v, err);
+      /* quantize */
+      v &= mask;
+      /* store new error with reduced precision */
+      e[k] = (v - o + RROUND) >> REDUCE;
+      /* store result */
+      d[i] = v;
+    }
   }
   memmove (e, &e[len], sizeof (gint32) * stride * nc);
 }
@@ -460,6 +528,7 @@ gst_audio_quantize_new (GstAudioDitherMethod dither,
     quant->bias = 0;
   quant->mask = (1U << quant->shift) - 1;
 
+  gst_audio_quantize_init_random (quant);
   gst_audio_quantize_setup_dither (quant);
   gst_audio_quantize_setup_noise_shaping (quant);
   gst_audio_quantize_setup_quantize_func (quant);
@@ -482,6 +551,7 @@ gst_audio_quantize_free (GstAudioQuantize * quant)
   g_free (quant->coeffs);
   g_free (quant->last_random);
   g_free (quant->dither_buf);
+  g_free (quant->random_buf);
 
   g_slice_free (GstAudioQuantize, quant);
 }
@@ -60,6 +60,9 @@ resample_ ##type## _ ##inter## _ ##channels## _ ##arch (GstAudioResampler * resa
     gpointer in[], gsize in_len,  gpointer out[], gsize out_len,        \
     gsize * consumed)
 
+/* The taps for an output sample are looked up once and then applied to all
+ * blocks, so that with many blocks (e.g. many non-interleaved mono streams
+ * resampled together) the taps are computed once and stay in cache. */
 #define MAKE_RESAMPLE_FUNC(type,inter,channels,arch)            \
 DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
 {                                                               \
@@ -68,30 +71,31 @@ DECL_RESAMPLE_FUNC (type, inter, channels, arch)                \
   gint blocks = resampler->blocks;                              \
   gint ostride = resampler->ostride;                            \
   gint taps_stride = resampler->taps_stride;                    \
-  gint samp_index = 0;                                          \
-  gint samp_phase = 0;                                          \
+  gint samp_index = resampler->samp_index;                      \
+  gint samp_phase = resampler->samp_phase;                      \
                                                                 \
-  for (c = 0; c < blocks; c++) {                                \
-    type *ip = in[c];                                           \
-    type *op = ostride == 1 ? out[c] : (type *)out[0] + c;      \
+  for (di = 0; di < out_len; di++) {                            \
+    type icoeff[4], *taps;                                      \
+    gint index = samp_index;                                    \
                                                                 \
-    samp_index = resampler->samp_index;                         \
-    samp_phase = resampler->samp_phase;                         \
+    taps = get_taps_ ##type##_##inter                           \
+            (resampler, &samp_index, &samp_phase, icoeff);      \
                                                                 \
-    for (di = 0; di < out_len; di++) {                          \
-      type *ipp, icoeff[4], *taps;                              \
+    for (c = 0; c < blocks; c++) {                              \
+      type *ipp = (type *) in[c] + index * channels;            \
+      type *op = ostride == 1 ? (type *) out[c] + di :          \
+          (type *) out[0] + c + di * ostride;                   \
                                                                 \
-      ipp = &ip[samp_index * channels];                         \
-                                                                \
-      taps = get_taps_ ##type##_##inter                         \
-              (resampler, &samp_index, &samp_phase, icoeff);    \
       inner_product_ ##type##_##inter##_##channels##_##arch     \
               (op, ipp, taps, n_taps, icoeff, taps_stride);     \
-      op += ostride;                                            \
     }                                                           \
-    if (in_len > samp_index)                                    \
+  }                                                             \
+  if (in_len > samp_index) {                                    \
+    for (c = 0; c < blocks; c++) {                              \
+      type *ip = in[c];                                         \
       memmove (ip, &ip[samp_index * channels],                  \
           (in_len - samp_index) * sizeof(type) * channels);     \
+    }                                                           \
   }                                                             \
   *consumed = samp_index - resampler->samp_index;               \
                                                                 \
@@ -40,6 +40,8 @@
  *   - dynamic samplerate changes
  *   - x86 and neon optimizations
  */
+typedef struct _GstAudioResamplerTaps GstAudioResamplerTaps;
+
 typedef void (*ConvertTapsFunc) (gdouble * tmp_taps, gpointer taps,
     gdouble weight, gint n_taps);
 typedef void (*InterpolateFunc) (gpointer o, const gpointer a, gint len,
@@ -79,11 +81,9 @@ struct _GstAudioResampler
   gint oversample;
   gint n_taps;
   gpointer taps;
-  gpointer taps_mem;
+  GstAudioResamplerTaps *taps_table;
   gsize taps_stride;
   gint n_phases;
-  gint alloc_taps;
-  gint alloc_phases;
 
   /* cached taps */
   gpointer *cached_phases;
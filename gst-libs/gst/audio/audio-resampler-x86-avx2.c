@@ -0,0 +1,347 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX2__) && defined (__FMA__)
+#include <immintrin.h>
+
+/* Sum the two 128 bit lanes, the result is then reduced further like in the
+ * SSE versions */
+#define FOLD_SI256(v) \
+    _mm_add_epi32 (_mm256_castsi256_si128 (v), _mm256_extracti128_si256 (v, 1))
+#define FOLD_PS256(v) \
+    _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1))
+#define FOLD_PD256(v) \
+    _mm_add_pd (_mm256_castpd256_pd128 (v), _mm256_extractf128_pd (v, 1))
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256;
+  __m128i sum;
+
+  sum256 = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 16) {
+    sum256 =
+        _mm256_add_epi32 (sum256,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  sum = FOLD_SI256 (sum256);
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (2, 3, 2, 3)));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  sum = _mm_add_epi32 (sum, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum = _mm_srai_epi32 (sum, PRECISION_S16);
+  sum = _mm_packs_epi32 (sum, sum);
+  *o = _mm_extract_epi16 (sum, 0);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256[2], t;
+  __m128i sum[2];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum256[0] = sum256[1] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = _mm256_add_epi32 (sum256[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum256[1] = _mm256_add_epi32 (sum256[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  sum[0] = _mm_srai_epi32 (FOLD_SI256 (sum256[0]), PRECISION_S16);
+  sum[1] = _mm_srai_epi32 (FOLD_SI256 (sum256[1]), PRECISION_S16);
+
+  sum[0] =
+      _mm_madd_epi16 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_madd_epi16 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi32 (sum[0], sum[1]);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256[4], ta;
+  __m128i sum[4], t[4];
+  __m128i f = _mm_set_epi64x (0, *((long long *) icoeff));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum256[0] = sum256[1] = sum256[2] = sum256[3] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = _mm256_add_epi32 (sum256[0], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum256[1] = _mm256_add_epi32 (sum256[1], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum256[2] = _mm256_add_epi32 (sum256[2], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum256[3] = _mm256_add_epi32 (sum256[3], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  sum[0] = FOLD_SI256 (sum256[0]);
+  sum[1] = FOLD_SI256 (sum256[1]);
+  sum[2] = FOLD_SI256 (sum256[2]);
+  sum[3] = FOLD_SI256 (sum256[3]);
+
+  t[0] = _mm_unpacklo_epi32 (sum[0], sum[1]);
+  t[1] = _mm_unpacklo_epi32 (sum[2], sum[3]);
+  t[2] = _mm_unpackhi_epi32 (sum[0], sum[1]);
+  t[3] = _mm_unpackhi_epi32 (sum[2], sum[3]);
+
+  sum[0] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (t[0], t[1]), _mm_unpackhi_epi64 (t[0],
+          t[1]));
+  sum[2] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (t[2], t[3]), _mm_unpackhi_epi64 (t[2],
+          t[3]));
+  sum[0] = _mm_add_epi32 (sum[0], sum[2]);
+
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_madd_epi16 (sum[0], f);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum256[2];
+  __m128 sum;
+
+  sum256[0] = sum256[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    sum256[0] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 0),
+        _mm256_loadu_ps (b + i + 0), sum256[0]);
+    sum256[1] = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), sum256[1]);
+  }
+  sum256[0] = _mm256_add_ps (sum256[0], sum256[1]);
+  sum = FOLD_PS256 (sum256[0]);
+  sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+  sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 0x55));
+  _mm_store_ss (o, sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum256[2], t;
+  __m128 sum;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum256[0] = sum256[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum256[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum256[0]);
+    sum256[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum256[1]);
+  }
+  sum256[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum256[0], sum256[1]),
+      _mm256_set1_ps (icoeff[0]), sum256[1]);
+  sum = FOLD_PS256 (sum256[0]);
+  sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+  sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 0x55));
+  _mm_store_ss (o, sum);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum256[4], t;
+  __m128 sum;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum256[0] = sum256[1] = sum256[2] = sum256[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum256[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum256[0]);
+    sum256[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum256[1]);
+    sum256[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum256[2]);
+    sum256[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum256[3]);
+  }
+  sum256[0] = _mm256_mul_ps (sum256[0], _mm256_set1_ps (icoeff[0]));
+  sum256[0] =
+      _mm256_fmadd_ps (sum256[1], _mm256_set1_ps (icoeff[1]), sum256[0]);
+  sum256[0] =
+      _mm256_fmadd_ps (sum256[2], _mm256_set1_ps (icoeff[2]), sum256[0]);
+  sum256[0] =
+      _mm256_fmadd_ps (sum256[3], _mm256_set1_ps (icoeff[3]), sum256[0]);
+  sum = FOLD_PS256 (sum256[0]);
+  sum = _mm_add_ps (sum, _mm_movehl_ps (sum, sum));
+  sum = _mm_add_ss (sum, _mm_shuffle_ps (sum, sum, 0x55));
+  _mm_store_ss (o, sum);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum256[2];
+  __m128d sum;
+
+  sum256[0] = sum256[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    sum256[0] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 0),
+        _mm256_loadu_pd (b + i + 0), sum256[0]);
+    sum256[1] = _mm256_fmadd_pd (_mm256_loadu_pd (a + i + 4),
+        _mm256_loadu_pd (b + i + 4), sum256[1]);
+  }
+  sum256[0] = _mm256_add_pd (sum256[0], sum256[1]);
+  sum = FOLD_PD256 (sum256[0]);
+  sum = _mm_add_sd (sum, _mm_unpackhi_pd (sum, sum));
+  _mm_store_sd (o, sum);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum256[2], t;
+  __m128d sum;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum256[0] = sum256[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum256[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum256[0]);
+    sum256[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum256[1]);
+  }
+  sum256[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum256[0], sum256[1]),
+      _mm256_set1_pd (icoeff[0]), sum256[1]);
+  sum = FOLD_PD256 (sum256[0]);
+  sum = _mm_add_sd (sum, _mm_unpackhi_pd (sum, sum));
+  _mm_store_sd (o, sum);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum256[4], t;
+  __m128d sum;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum256[0] = sum256[1] = sum256[2] = sum256[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum256[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum256[0]);
+    sum256[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum256[1]);
+    sum256[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum256[2]);
+    sum256[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum256[3]);
+  }
+  sum256[0] = _mm256_mul_pd (sum256[0], _mm256_set1_pd (icoeff[0]));
+  sum256[0] =
+      _mm256_fmadd_pd (sum256[1], _mm256_set1_pd (icoeff[1]), sum256[0]);
+  sum256[0] =
+      _mm256_fmadd_pd (sum256[2], _mm256_set1_pd (icoeff[2]), sum256[0]);
+  sum256[0] =
+      _mm256_fmadd_pd (sum256[3], _mm256_set1_pd (icoeff[3]), sum256[0]);
+  sum = FOLD_PD256 (sum256[0]);
+  sum = _mm_add_sd (sum, _mm_unpackhi_pd (sum, sum));
+  _mm_store_sd (o, sum);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+#endif
@@ -0,0 +1,180 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (HAVE_IMMINTRIN_H) && defined (__AVX512F__)
+#include <immintrin.h>
+
+/* The taps are only rounded up to a multiple of 8, load the last ones of a
+ * row with a mask instead of reading 16 floats past them */
+#define LOAD_MASK_PS(n) ((__mmask16) ((n) >= 16 ? 0xffff : (1 << (n)) - 1))
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    __mmask16 m = LOAD_MASK_PS (len - i);
+
+    sum = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, a + i),
+        _mm512_maskz_loadu_ps (m, b + i), sum);
+  }
+
+  *o = _mm512_reduce_add_ps (sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    __mmask16 m = LOAD_MASK_PS (len - i);
+
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m512 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    __mmask16 m = LOAD_MASK_PS (len - i);
+
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[3] + i), sum[3]);
+  }
+  sum[0] = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  sum[0] = _mm512_fmadd_ps (sum[1], _mm512_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[2], _mm512_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[3], _mm512_set1_ps (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8)
+    sum = _mm512_fmadd_pd (_mm512_loadu_pd (a + i), _mm512_loadu_pd (b + i),
+        sum);
+
+  *o = _mm512_reduce_add_pd (sum);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_pd (_mm512_sub_pd (sum[0], sum[1]),
+      _mm512_set1_pd (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m512d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm512_loadu_pd (a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_pd (t, _mm512_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm512_mul_pd (sum[0], _mm512_set1_pd (icoeff[0]));
+  sum[0] = _mm512_fmadd_pd (sum[1], _mm512_set1_pd (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[2], _mm512_set1_pd (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[3], _mm512_set1_pd (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx512);
+
+#endif
@@ -21,6 +21,8 @@
 #include "audio-resampler-x86-sse.h"
 #include "audio-resampler-x86-sse2.h"
 #include "audio-resampler-x86-sse41.h"
+#include "audio-resampler-x86-avx2.h"
+#include "audio-resampler-x86-avx512.h"
 
 static void
 audio_resampler_check_x86 (const gchar *option)
@@ -69,3 +71,50 @@ audio_resampler_check_x86 (const gchar *option)
 #endif
   }
 }
+
+/* Orc has no flags for AVX, so the CPU is queried directly. This is called
+ * after the Orc flags were checked so that the wider variants replace the
+ * SSE ones. */
+static void
+audio_resampler_check_x86_avx (void)
+{
+#if defined (__GNUC__) && (defined (HAVE_AVX2) || defined (HAVE_AVX512))
+  __builtin_cpu_init ();
+#endif
+
+#if defined (__GNUC__) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX2
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma")) {
+    GST_DEBUG ("enable AVX2 optimisations");
+    resample_gint16_full_1 = resample_gint16_full_1_avx2;
+    resample_gint16_linear_1 = resample_gint16_linear_1_avx2;
+    resample_gint16_cubic_1 = resample_gint16_cubic_1_avx2;
+
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx2;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx2;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx2;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx2;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx2;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx2;
+  }
+#else
+  GST_DEBUG ("AVX2 optimisations not enabled");
+#endif
+
+#if defined (__GNUC__) && defined (HAVE_IMMINTRIN_H) && HAVE_AVX512
+  if (__builtin_cpu_supports ("avx512f")) {
+    GST_DEBUG ("enable AVX512 optimisations");
+    /* gint16 keeps the AVX2 version, the 16 bit multiply-add needs
+     * AVX512BW */
+    resample_gfloat_full_1 = resample_gfloat_full_1_avx512;
+    resample_gfloat_linear_1 = resample_gfloat_linear_1_avx512;
+    resample_gfloat_cubic_1 = resample_gfloat_cubic_1_avx512;
+
+    resample_gdouble_full_1 = resample_gdouble_full_1_avx512;
+    resample_gdouble_linear_1 = resample_gdouble_linear_1_avx512;
+    resample_gdouble_cubic_1 = resample_gdouble_cubic_1_avx512;
+  }
+#else
+  GST_DEBUG ("AVX512 optimisations not enabled");
+#endif
+}
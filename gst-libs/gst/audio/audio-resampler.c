@@ -48,6 +48,12 @@ GST_DEBUG_CATEGORY_STATIC (audio_resampler_debug);
  * #GstAudioResampler is a structure which holds the information
  * required to perform various kinds of resampling filtering.
  *
+ * Many independent mono streams with the same rates can be resampled in one
+ * call by passing them as the channels of a single resampler created with
+ * %GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN and
+ * %GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT. The filter taps are then
+ * shared by all streams and computed only once per output sample.
+ *
  */
 
 static const gint oversample_qualities[] = {
@@ -874,6 +880,9 @@ audio_resampler_init (void)
         }
       }
     }
+#ifdef CHECK_X86
+    audio_resampler_check_x86_avx ();
+#endif
 #endif
     g_once_init_leave (&init_gonce, 1);
   }
@@ -967,26 +976,167 @@ calculate_kaiser_params (GstAudioResampler * resampler)
       resampler->n_taps, resampler->cutoff);
 }
 
+/* Interpolated filter tables only depend on the filter parameters, they are
+ * immutable once built and shared between all resamplers that use the same
+ * parameters. */
+struct _GstAudioResamplerTaps
+{
+  gint refcount;
+
+  /* parameters */
+  GstAudioResamplerMethod method;
+  GstAudioFormat format;
+  gint n_taps;
+  gint n_phases;
+  gint oversample;
+  gdouble cutoff;
+  gdouble kaiser_beta;
+  gdouble b, c;
+
+  gsize taps_stride;
+  gpointer taps;
+  gpointer taps_mem;
+};
+
+static GMutex taps_cache_lock;
+static GList *taps_cache = NULL;
+
+static gboolean
+taps_table_matches (GstAudioResamplerTaps * table,
+    GstAudioResampler * resampler, gint n_taps, gint n_phases)
+{
+  return table->method == resampler->method &&
+      table->format == resampler->format &&
+      table->n_taps == n_taps &&
+      table->n_phases == n_phases &&
+      table->oversample == resampler->oversample &&
+      table->cutoff == resampler->cutoff &&
+      table->kaiser_beta == resampler->kaiser_beta &&
+      table->b == resampler->b && table->c == resampler->c;
+}
+
 static void
-alloc_taps_mem (GstAudioResampler * resampler, gint bps, gint n_taps,
-    gint n_phases)
+taps_table_free (GstAudioResamplerTaps * table)
+{
+  GST_DEBUG ("free filter table %p", table);
+  g_free (table->taps_mem);
+  g_slice_free (GstAudioResamplerTaps, table);
+}
+
+static void
+taps_table_unref (GstAudioResamplerTaps * table)
 {
-  if (resampler->alloc_taps >= n_taps && resampler->alloc_phases >= n_phases)
+  g_mutex_lock (&taps_cache_lock);
+  if (--table->refcount > 0) {
+    g_mutex_unlock (&taps_cache_lock);
     return;
+  }
+  taps_cache = g_list_remove (taps_cache, table);
+  g_mutex_unlock (&taps_cache_lock);
+
+  taps_table_free (table);
+}
+
+static void
+release_taps_table (GstAudioResampler * resampler)
+{
+  if (resampler->taps_table) {
+    taps_table_unref (resampler->taps_table);
+    resampler->taps_table = NULL;
+  }
+  resampler->taps = NULL;
+}
+
+/* with taps_cache_lock, returns a new ref to a cached table matching the
+ * parameters or NULL */
+static GstAudioResamplerTaps *
+taps_cache_lookup (GstAudioResampler * resampler, gint n_taps, gint n_phases)
+{
+  GList *l;
+
+  for (l = taps_cache; l; l = l->next) {
+    GstAudioResamplerTaps *table = l->data;
+
+    if (taps_table_matches (table, resampler, n_taps, n_phases)) {
+      table->refcount++;
+      return table;
+    }
+  }
+  return NULL;
+}
+
+/* get a shared filter table of @n_phases rows of @n_taps taps, the table is
+ * built when no other resampler uses one with the same parameters */
+static void
+acquire_taps_table (GstAudioResampler * resampler, gint n_taps, gint n_phases)
+{
+  GstAudioResamplerTaps *table, *cached, *old = resampler->taps_table;
+  gint oversample = resampler->oversample;
+  gint bps = resampler->bps;
+  gint i;
+
+  g_mutex_lock (&taps_cache_lock);
+  table = taps_cache_lookup (resampler, n_taps, n_phases);
+  g_mutex_unlock (&taps_cache_lock);
 
+  if (table) {
+    GST_DEBUG ("reusing filter table %p", table);
+    goto done;
+  }
+
+  /* building a table takes a while, don't block the other resamplers
+   * meanwhile */
   GST_DEBUG ("allocate bps %d n_taps %d n_phases %d", bps, n_taps, n_phases);
 
   resampler->tmp_taps =
       g_realloc_n (resampler->tmp_taps, n_taps, sizeof (gdouble));
 
-  resampler->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+  table = g_slice_new0 (GstAudioResamplerTaps);
+  table->refcount = 1;
+  table->method = resampler->method;
+  table->format = resampler->format;
+  table->n_taps = n_taps;
+  table->n_phases = n_phases;
+  table->oversample = oversample;
+  table->cutoff = resampler->cutoff;
+  table->kaiser_beta = resampler->kaiser_beta;
+  table->b = resampler->b;
+  table->c = resampler->c;
+
+  table->taps_stride = GST_ROUND_UP_32 (bps * (n_taps + TAPS_OVERREAD));
+  table->taps_mem = g_malloc0 (n_phases * table->taps_stride + ALIGN - 1);
+  table->taps = MEM_ALIGN ((gint8 *) table->taps_mem, ALIGN);
+
+  for (i = 0; i < n_phases; i++) {
+    gdouble x = -(n_taps / 2) + i / (gdouble) oversample;
+    gpointer taps = (gint8 *) table->taps + i * table->taps_stride;
+
+    make_taps (resampler, taps, x, n_taps);
+  }
+
+  /* another resampler may have added the same table meanwhile, keep the
+   * cached one then. Only complete tables are added so that others never
+   * see partial ones */
+  g_mutex_lock (&taps_cache_lock);
+  cached = taps_cache_lookup (resampler, n_taps, n_phases);
+  if (cached == NULL)
+    taps_cache = g_list_prepend (taps_cache, table);
+  g_mutex_unlock (&taps_cache_lock);
+
+  if (cached) {
+    taps_table_free (table);
+    table = cached;
+  }
+
+done:
+  /* unref the old one after getting the new one, so that a table that is
+   * used again after an update is not rebuilt */
+  if (old)
+    taps_table_unref (old);
 
-  g_free (resampler->taps_mem);
-  resampler->taps_mem =
-      g_malloc0 (n_phases * resampler->taps_stride + ALIGN - 1);
-  resampler->taps = MEM_ALIGN ((gint8 *) resampler->taps_mem, ALIGN);
-  resampler->alloc_taps = n_taps;
-  resampler->alloc_phases = n_phases;
+  resampler->taps_table = table;
+  resampler->taps = table->taps;
+  resampler->taps_stride = table->taps_stride;
 }
 
 static void
@@ -1184,9 +1334,7 @@ resampler_calculate_taps (GstAudioResampler * resampler)
 
   if (resampler->filter_interpolation !=
       GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE) {
-    gint i, isize;
-    gdouble x;
-    gpointer taps;
+    gint isize;
 
     switch (resampler->filter_interpolation) {
       default:
@@ -1200,13 +1348,9 @@ resampler_calculate_taps (GstAudioResampler * resampler)
         break;
     }
 
-    alloc_taps_mem (resampler, bps, n_taps, oversample + isize);
-
-    for (i = 0; i < oversample + isize; i++) {
-      x = -(n_taps / 2) + i / (gdouble) oversample;
-      taps = (gint8 *) resampler->taps + i * resampler->taps_stride;
-      make_taps (resampler, taps, x, n_taps);
-    }
+    acquire_taps_table (resampler, n_taps, oversample + isize);
+  } else {
+    release_taps_table (resampler);
   }
 }
 
@@ -1631,7 +1775,7 @@ gst_audio_resampler_free (GstAudioResampler * resampler)
   g_return_if_fail (resampler != NULL);
 
   g_free (resampler->cached_taps_mem);
-  g_free (resampler->taps_mem);
+  release_taps_table (resampler);
   g_free (resampler->tmp_taps);
   g_free (resampler->samples);
   g_free (resampler->sbuf);
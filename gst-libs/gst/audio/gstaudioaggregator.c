@@ -68,6 +68,7 @@
 #endif
 
 #include "gstaudioaggregator.h"
+#include <gst/gstprocessingstats-private.h>
 
 #include <string.h>
 
@@ -254,6 +255,18 @@ gst_audio_aggregator_convert_pad_convert_buffer (GstAudioAggregatorPad *
         GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
         GST_BUFFER_COPY_META, 0, -1);
 
+    /* Silence converts to silence, only the resampler needs to see it to
+     * keep its history */
+    if (GST_BUFFER_FLAG_IS_SET (input_buffer, GST_BUFFER_FLAG_GAP)
+        && GST_AUDIO_INFO_RATE (in_info) == GST_AUDIO_INFO_RATE (out_info)) {
+      gst_buffer_map (res, &outmap, GST_MAP_WRITE);
+      gst_audio_format_fill_silence (out_info->finfo, outmap.data,
+          outmap.size);
+      gst_buffer_unmap (res, &outmap);
+
+      return res;
+    }
+
     gst_buffer_map (input_buffer, &inmap, GST_MAP_READ);
     gst_buffer_map (res, &outmap, GST_MAP_WRITE);
 
@@ -380,15 +393,43 @@ struct _GstAudioAggregatorPrivate
   guint current_blocksize;
 
   /* Protected by srcpad stream clock */
+  /* TRUE once current_blocksize was picked for the output buffer at offset */
+  gboolean have_block;
   /* Output buffer starting at offset containing blocksize frames (calculated
-   * from output_buffer_duration) */
+   * from output_buffer_duration). May stay NULL until something is mixed
+   * into it, see gst_audio_aggregator_ensure_output_buffer() */
   GstBuffer *current_buffer;
+  /* Silence shared by all output buffers nothing was mixed into */
+  GstBuffer *silence_buffer;
+  GstAudioFormat silence_format;
+  /* Recycles the memory of the output buffers, only used from the aggregate
+   * function and reset */
+  GstBufferPool *output_pool;
+  gsize output_pool_size;
+  GstAllocator *output_pool_allocator;
 
   /* counters to keep track of timestamps */
   /* Readable with object lock, writable with both aag lock and object lock */
 
   /* Sample offset starting from 0 at aggregator.segment.start */
   gint64 offset;
+
+  /* Protected by the object lock */
+  guint max_threads;
+
+  /* statistics, protected by the object lock */
+  GstProcessingStats aggregate_stats;
+
+  /* Only used from the aggregate function */
+  gboolean defer_mix;
+  GArray *mix_jobs;
+  GArray *conversions;
+
+  /* Threads running mixing and conversion tasks */
+  GThreadPool *task_pool;
+  GMutex task_lock;
+  GCond task_cond;
+  guint tasks_pending;
 };
 
 #define GST_AUDIO_AGGREGATOR_LOCK(self)   g_mutex_lock (&(self)->priv->mutex);
@@ -415,6 +456,10 @@ static GstFlowReturn gst_audio_aggregator_flush (GstAggregator * agg);
 
 static GstBuffer *gst_audio_aggregator_create_output_buffer (GstAudioAggregator
     * aagg, guint num_frames);
+static GstBuffer *gst_audio_aggregator_ensure_output_buffer (GstAudioAggregator
+    * aagg);
+static GstBuffer *gst_audio_aggregator_get_silence_buffer (GstAudioAggregator *
+    aagg, guint num_frames);
 static GstBuffer *gst_audio_aggregator_do_clip (GstAggregator * agg,
     GstAggregatorPad * bpad, GstBuffer * buffer);
 static GstFlowReturn gst_audio_aggregator_aggregate (GstAggregator * agg,
@@ -433,6 +478,7 @@ static GstCaps *gst_audio_aggregator_fixate_src_caps (GstAggregator * agg,
 #define DEFAULT_DISCONT_WAIT (1 * GST_SECOND)
 #define DEFAULT_OUTPUT_BUFFER_DURATION_N (1)
 #define DEFAULT_OUTPUT_BUFFER_DURATION_D (100)
+#define DEFAULT_MAX_THREADS 1
 
 enum
 {
@@ -441,6 +487,8 @@ enum
   PROP_ALIGNMENT_THRESHOLD,
   PROP_DISCONT_WAIT,
   PROP_OUTPUT_BUFFER_DURATION_FRACTION,
+  PROP_MAX_THREADS,
+  PROP_STATS,
 };
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstAudioAggregator, gst_audio_aggregator,
@@ -601,6 +649,84 @@ gst_audio_aggregator_class_init (GstAudioAggregatorClass * klass)
           "creating a discontinuity", 0,
           G_MAXUINT64 - 1, DEFAULT_DISCONT_WAIT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioAggregator:max-threads:
+   *
+   * Maximum number of threads used for converting and mixing the input
+   * buffers. The conversions of the pads are distributed over the threads
+   * and the output buffer is split into ranges of frames that are mixed in
+   * parallel, each of them adding all pads in the same order as when mixing
+   * from a single thread. Output buffers with few samples to mix are always
+   * mixed from a single thread.
+   *
+   * With more than one thread, #GstAudioAggregatorClass.aggregate_one_buffer
+   * is called concurrently for disjoint parts of the output buffer.
+   *
+   * 0 uses as many threads as there are processors.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of converting and mixing threads "
+          "(0 = number of processors)", 0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioAggregator:stats:
+   *
+   * Various statistics, reset when starting. This property returns a
+   * #GstStructure with name `application/x-gst-audio-aggregator-stats`
+   * with the following fields:
+   *
+   * - "aggregate-time" G_TYPE_UINT64: total time spent converting and
+   *   mixing output buffers, not counting the time spent pushing them
+   * - "aggregate-time-max" G_TYPE_UINT64: the longest time spent on a
+   *   single output buffer
+   * - "aggregated" G_TYPE_UINT64: the number of output buffers produced
+   * - "aggregate-time-histogram" GST_TYPE_ARRAY of G_TYPE_UINT64: entry n
+   *   counts the output buffers that took less than 2^(n+1) microseconds,
+   *   the last entry also counts all slower buffers
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Aggregation statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+}
+
+typedef struct
+{
+  GstAudioAggregatorPad *pad;
+  GstBuffer *inbuf;
+  guint in_offset;
+  guint out_offset;
+  guint num_frames;
+} AudioAggregatorMixJob;
+
+typedef struct
+{
+  GstAudioAggregatorPad *pad;
+  GstBuffer *input_buffer;
+  GstBuffer *buffer;
+} AudioAggregatorConversion;
+
+static void
+clear_mix_job (AudioAggregatorMixJob * job)
+{
+  gst_object_unref (job->pad);
+  gst_buffer_unref (job->inbuf);
+}
+
+static void
+clear_conversion (AudioAggregatorConversion * conv)
+{
+  gst_object_unref (conv->pad);
+  gst_buffer_unref (conv->input_buffer);
+  if (conv->buffer)
+    gst_buffer_unref (conv->buffer);
 }
 
 static void
@@ -609,9 +735,21 @@ gst_audio_aggregator_init (GstAudioAggregator * aagg)
   aagg->priv = gst_audio_aggregator_get_instance_private (aagg);
 
   g_mutex_init (&aagg->priv->mutex);
+  g_mutex_init (&aagg->priv->task_lock);
+  g_cond_init (&aagg->priv->task_cond);
 
   aagg->priv->alignment_threshold = DEFAULT_ALIGNMENT_THRESHOLD;
   aagg->priv->discont_wait = DEFAULT_DISCONT_WAIT;
+  aagg->priv->max_threads = DEFAULT_MAX_THREADS;
+
+  aagg->priv->mix_jobs = g_array_new (FALSE, FALSE,
+      sizeof (AudioAggregatorMixJob));
+  g_array_set_clear_func (aagg->priv->mix_jobs,
+      (GDestroyNotify) clear_mix_job);
+  aagg->priv->conversions = g_array_new (FALSE, FALSE,
+      sizeof (AudioAggregatorConversion));
+  g_array_set_clear_func (aagg->priv->conversions,
+      (GDestroyNotify) clear_conversion);
 
   gst_audio_aggregator_translate_output_buffer_duration (aagg,
       DEFAULT_OUTPUT_BUFFER_DURATION);
@@ -620,14 +758,47 @@ gst_audio_aggregator_init (GstAudioAggregator * aagg)
   aagg->current_caps = NULL;
 }
 
+static void
+gst_audio_aggregator_clear_output_pool (GstAudioAggregator * aagg)
+{
+  if (aagg->priv->output_pool) {
+    gst_buffer_pool_set_active (aagg->priv->output_pool, FALSE);
+    gst_object_unref (aagg->priv->output_pool);
+    aagg->priv->output_pool = NULL;
+  }
+  if (aagg->priv->output_pool_allocator) {
+    gst_object_unref (aagg->priv->output_pool_allocator);
+    aagg->priv->output_pool_allocator = NULL;
+  }
+  aagg->priv->output_pool_size = 0;
+}
+
 static void
 gst_audio_aggregator_dispose (GObject * object)
 {
   GstAudioAggregator *aagg = GST_AUDIO_AGGREGATOR (object);
 
   gst_caps_replace (&aagg->current_caps, NULL);
+  gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  gst_buffer_replace (&aagg->priv->silence_buffer, NULL);
+  gst_audio_aggregator_clear_output_pool (aagg);
+
+  if (aagg->priv->task_pool) {
+    g_thread_pool_free (aagg->priv->task_pool, FALSE, TRUE);
+    aagg->priv->task_pool = NULL;
+  }
+  if (aagg->priv->mix_jobs) {
+    g_array_unref (aagg->priv->mix_jobs);
+    aagg->priv->mix_jobs = NULL;
+  }
+  if (aagg->priv->conversions) {
+    g_array_unref (aagg->priv->conversions);
+    aagg->priv->conversions = NULL;
+  }
 
   g_mutex_clear (&aagg->priv->mutex);
+  g_mutex_clear (&aagg->priv->task_lock);
+  g_cond_clear (&aagg->priv->task_cond);
 
   G_OBJECT_CLASS (gst_audio_aggregator_parent_class)->dispose (object);
 }
@@ -659,6 +830,11 @@ gst_audio_aggregator_set_property (GObject * object, guint prop_id,
       g_object_notify (object, "output-buffer-duration");
       gst_audio_aggregator_recalculate_latency (aagg);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (aagg);
+      aagg->priv->max_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (aagg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -687,6 +863,23 @@ gst_audio_aggregator_get_property (GObject * object, guint prop_id,
       gst_value_set_fraction (value, aagg->priv->output_buffer_duration_n,
           aagg->priv->output_buffer_duration_d);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (aagg);
+      g_value_set_uint (value, aagg->priv->max_threads);
+      GST_OBJECT_UNLOCK (aagg);
+      break;
+    case PROP_STATS:{
+      GstStructure *s;
+
+      s = gst_structure_new_empty ("application/x-gst-audio-aggregator-stats");
+      GST_OBJECT_LOCK (aagg);
+      gst_processing_stats_set_fields (&aagg->priv->aggregate_stats, s,
+          "aggregate", "aggregated");
+      GST_OBJECT_UNLOCK (aagg);
+
+      g_value_take_boxed (value, s);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1459,6 +1652,9 @@ gst_audio_aggregator_reset (GstAudioAggregator * aagg)
   gst_audio_info_init (&GST_AUDIO_AGGREGATOR_PAD (agg->srcpad)->info);
   gst_caps_replace (&aagg->current_caps, NULL);
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  gst_buffer_replace (&aagg->priv->silence_buffer, NULL);
+  gst_audio_aggregator_clear_output_pool (aagg);
+  aagg->priv->have_block = FALSE;
   aagg->priv->accumulated_error = 0;
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
@@ -1471,6 +1667,10 @@ gst_audio_aggregator_start (GstAggregator * agg)
 
   gst_audio_aggregator_reset (aagg);
 
+  GST_OBJECT_LOCK (aagg);
+  gst_processing_stats_reset (&aagg->priv->aggregate_stats);
+  GST_OBJECT_UNLOCK (aagg);
+
   return TRUE;
 }
 
@@ -1495,6 +1695,7 @@ gst_audio_aggregator_flush (GstAggregator * agg)
   aagg->priv->offset = -1;
   aagg->priv->accumulated_error = 0;
   gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+  aagg->priv->have_block = FALSE;
   GST_OBJECT_UNLOCK (aagg);
   GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
 
@@ -1744,9 +1945,9 @@ done:
 
 static gboolean
 gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * pad, GstBuffer * inbuf, GstBuffer * outbuf,
-    guint blocksize)
+    GstAudioAggregatorPad * pad, GstBuffer * inbuf, guint blocksize)
 {
+  GstBuffer *outbuf;
   guint overlap;
   guint out_start;
   gboolean filled;
@@ -1774,25 +1975,41 @@ gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
     return FALSE;
   }
 
-  gst_buffer_ref (inbuf);
   in_offset = pad->priv->position;
-  GST_OBJECT_UNLOCK (pad);
-  GST_OBJECT_UNLOCK (aagg);
 
-  filled = GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->aggregate_one_buffer (aagg,
-      pad, inbuf, in_offset, outbuf, out_start, overlap);
+  if (aagg->priv->defer_mix) {
+    AudioAggregatorMixJob job;
+
+    /* mixed from several threads once all pads are handled, see
+     * gst_audio_aggregator_run_mix_jobs() */
+    job.pad = gst_object_ref (pad);
+    job.inbuf = gst_buffer_ref (inbuf);
+    job.in_offset = in_offset;
+    job.out_offset = out_start;
+    job.num_frames = overlap;
+    g_array_append_val (aagg->priv->mix_jobs, job);
+  } else {
+    gst_buffer_ref (inbuf);
+    GST_OBJECT_UNLOCK (pad);
+    GST_OBJECT_UNLOCK (aagg);
 
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (pad);
+    outbuf = gst_audio_aggregator_ensure_output_buffer (aagg);
+    filled =
+        GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->aggregate_one_buffer (aagg,
+        pad, inbuf, in_offset, outbuf, out_start, overlap);
 
-  pad_changed = (inbuf != pad->priv->buffer);
-  gst_buffer_unref (inbuf);
+    GST_OBJECT_LOCK (aagg);
+    GST_OBJECT_LOCK (pad);
 
-  if (filled)
-    GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+    pad_changed = (inbuf != pad->priv->buffer);
+    gst_buffer_unref (inbuf);
 
-  if (pad_changed)
-    return FALSE;
+    if (filled)
+      GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+
+    if (pad_changed)
+      return FALSE;
+  }
 
   pad->priv->position += overlap;
   pad->priv->output_offset += overlap;
@@ -1808,24 +2025,315 @@ gst_audio_aggregator_mix_buffer (GstAudioAggregator * aagg,
   return TRUE;
 }
 
+/* Output buffers with less than this many samples to mix in total are not
+ * worth the overhead of waking up other threads */
+#define PARALLEL_MIX_MIN_SAMPLES (64 * 1024)
+/* Minimum number of output frames mixed by one thread */
+#define PARALLEL_MIX_MIN_FRAMES 64
+
+typedef void (*AudioAggregatorTaskFunc) (gpointer task);
+
+typedef struct
+{
+  AudioAggregatorTaskFunc func;
+  GstAudioAggregator *aagg;
+} AudioAggregatorTask;
+
+typedef struct
+{
+  AudioAggregatorTask task;
+  GstBuffer *outbuf;
+  guint start, end;
+  gboolean filled;
+} AudioAggregatorMixSlice;
+
+typedef struct
+{
+  AudioAggregatorTask task;
+  guint first, step;
+} AudioAggregatorConvertTask;
+
+/* Called with the object lock held */
+static guint
+gst_audio_aggregator_get_n_threads (GstAudioAggregator * aagg)
+{
+  guint n_threads = aagg->priv->max_threads;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  return MAX (n_threads, 1);
+}
+
+static void
+gst_audio_aggregator_task_func (gpointer data, gpointer user_data)
+{
+  AudioAggregatorTask *task = data;
+  GstAudioAggregator *aagg = task->aagg;
+
+  task->func (task);
+
+  g_mutex_lock (&aagg->priv->task_lock);
+  if (--aagg->priv->tasks_pending == 0)
+    g_cond_signal (&aagg->priv->task_cond);
+  g_mutex_unlock (&aagg->priv->task_lock);
+}
+
+/* runs the @n_tasks tasks of @task_size bytes in @tasks and waits for them
+ * to finish, the first one is run from the calling thread */
+static void
+gst_audio_aggregator_run_tasks (GstAudioAggregator * aagg, gpointer tasks,
+    gsize task_size, guint n_tasks)
+{
+  AudioAggregatorTask *first = tasks;
+  guint i;
+
+  if (n_tasks == 0)
+    return;
+
+  if (n_tasks > 1) {
+    if (aagg->priv->task_pool == NULL) {
+      aagg->priv->task_pool =
+          g_thread_pool_new (gst_audio_aggregator_task_func, NULL, -1, FALSE,
+          NULL);
+    }
+
+    aagg->priv->tasks_pending = n_tasks - 1;
+    for (i = 1; i < n_tasks; i++)
+      g_thread_pool_push (aagg->priv->task_pool,
+          (guint8 *) tasks + i * task_size, NULL);
+  }
+
+  first->func (first);
+
+  if (n_tasks > 1) {
+    g_mutex_lock (&aagg->priv->task_lock);
+    while (aagg->priv->tasks_pending > 0)
+      g_cond_wait (&aagg->priv->task_cond, &aagg->priv->task_lock);
+    g_mutex_unlock (&aagg->priv->task_lock);
+  }
+}
+
+static void
+gst_audio_aggregator_convert_task (AudioAggregatorConvertTask * task)
+{
+  GstAudioAggregator *aagg = task->task.aagg;
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  GArray *conversions = aagg->priv->conversions;
+  guint i;
+
+  for (i = task->first; i < conversions->len; i += task->step) {
+    AudioAggregatorConversion *conv =
+        &g_array_index (conversions, AudioAggregatorConversion, i);
+
+    GST_OBJECT_LOCK (conv->pad);
+    conv->buffer = gst_audio_aggregator_convert_buffer (aagg,
+        GST_PAD (conv->pad), &conv->pad->info, &srcpad->info,
+        conv->input_buffer);
+    GST_OBJECT_UNLOCK (conv->pad);
+  }
+}
+
+/* Converts the next input buffer of all pads that need a new one from
+ * @n_threads threads. The main loop of the aggregate function picks up the
+ * results from the conversions array.
+ *
+ * Called with the object lock held */
+static void
+gst_audio_aggregator_run_conversions (GstAudioAggregator * aagg,
+    guint n_threads)
+{
+  AudioAggregatorConvertTask *tasks;
+  GArray *conversions = aagg->priv->conversions;
+  GList *iter;
+  guint i, n_tasks;
+
+  for (iter = GST_ELEMENT (aagg)->sinkpads; iter; iter = iter->next) {
+    GstAudioAggregatorPad *pad = iter->data;
+    AudioAggregatorConversion conv;
+    GstBuffer *input_buffer;
+
+    if (!GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer)
+      continue;
+
+    input_buffer = gst_aggregator_pad_peek_buffer (GST_AGGREGATOR_PAD (pad));
+    if (!input_buffer)
+      continue;
+
+    GST_OBJECT_LOCK (pad);
+    if (pad->priv->buffer || !GST_AUDIO_INFO_IS_VALID (&pad->info)) {
+      GST_OBJECT_UNLOCK (pad);
+      gst_buffer_unref (input_buffer);
+      continue;
+    }
+    GST_OBJECT_UNLOCK (pad);
+
+    conv.pad = gst_object_ref (pad);
+    conv.input_buffer = input_buffer;
+    conv.buffer = NULL;
+    g_array_append_val (conversions, conv);
+  }
+
+  /* a single conversion is done by the main loop as usual */
+  if (conversions->len < 2) {
+    g_array_set_size (conversions, 0);
+    return;
+  }
+
+  n_tasks = MIN (n_threads, conversions->len);
+  tasks = g_newa (AudioAggregatorConvertTask, n_tasks);
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].task.func = (AudioAggregatorTaskFunc)
+        gst_audio_aggregator_convert_task;
+    tasks[i].task.aagg = aagg;
+    tasks[i].first = i;
+    tasks[i].step = n_tasks;
+  }
+
+  GST_LOG_OBJECT (aagg, "Converting %u buffers from %u threads",
+      conversions->len, n_tasks);
+
+  gst_audio_aggregator_run_tasks (aagg, tasks,
+      sizeof (AudioAggregatorConvertTask), n_tasks);
+}
+
+/* mixes the parts of all jobs that fall into the output range of @slice */
+static void
+gst_audio_aggregator_mix_slice (AudioAggregatorMixSlice * slice)
+{
+  GstAudioAggregator *aagg = slice->task.aagg;
+  GstAudioAggregatorClass *klass = GST_AUDIO_AGGREGATOR_GET_CLASS (aagg);
+  GArray *jobs = aagg->priv->mix_jobs;
+  guint i;
+
+  for (i = 0; i < jobs->len; i++) {
+    AudioAggregatorMixJob *job =
+        &g_array_index (jobs, AudioAggregatorMixJob, i);
+    guint start = MAX (job->out_offset, slice->start);
+    guint end = MIN (job->out_offset + job->num_frames, slice->end);
+
+    if (start >= end)
+      continue;
+
+    if (klass->aggregate_one_buffer (aagg, job->pad, job->inbuf,
+            job->in_offset + (start - job->out_offset), slice->outbuf, start,
+            end - start))
+      slice->filled = TRUE;
+  }
+}
+
+/* Mixes all jobs collected by gst_audio_aggregator_mix_buffer() into
+ * @outbuf. Every thread mixes a different range of output frames, adding
+ * the pads in the same order as when mixing from a single thread.
+ *
+ * Called without the object lock */
+static void
+gst_audio_aggregator_run_mix_jobs (GstAudioAggregator * aagg,
+    guint blocksize, guint n_threads)
+{
+  GstBuffer *outbuf;
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  GArray *jobs = aagg->priv->mix_jobs;
+  AudioAggregatorMixSlice *slices;
+  guint64 samples = 0;
+  guint i, n_slices, slice_size;
+  gboolean filled = FALSE;
+  GstMapInfo outmap;
+
+  if (jobs->len == 0)
+    return;
+
+  outbuf = gst_audio_aggregator_ensure_output_buffer (aagg);
+
+  for (i = 0; i < jobs->len; i++)
+    samples += g_array_index (jobs, AudioAggregatorMixJob, i).num_frames;
+  samples *= GST_AUDIO_INFO_CHANNELS (&srcpad->info);
+
+  if (samples < PARALLEL_MIX_MIN_SAMPLES)
+    n_slices = 1;
+  else
+    n_slices = CLAMP (blocksize / PARALLEL_MIX_MIN_FRAMES, 1, n_threads);
+  slice_size = (blocksize + n_slices - 1) / n_slices;
+
+  slices = g_newa (AudioAggregatorMixSlice, n_slices);
+  for (i = 0; i < n_slices; i++) {
+    slices[i].task.func = (AudioAggregatorTaskFunc)
+        gst_audio_aggregator_mix_slice;
+    slices[i].task.aagg = aagg;
+    slices[i].outbuf = outbuf;
+    slices[i].start = MIN (i * slice_size, blocksize);
+    slices[i].end = MIN ((i + 1) * slice_size, blocksize);
+    slices[i].filled = FALSE;
+  }
+
+  GST_LOG_OBJECT (aagg, "Mixing %u buffers from %u threads", jobs->len,
+      n_slices);
+
+  /* Keep the output buffer mapped while the threads map it on their own, so
+   * that it is not merged or replaced under them */
+  if (n_slices > 1)
+    gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+
+  gst_audio_aggregator_run_tasks (aagg, slices,
+      sizeof (AudioAggregatorMixSlice), n_slices);
+
+  if (n_slices > 1)
+    gst_buffer_unmap (outbuf, &outmap);
+
+  for (i = 0; i < n_slices; i++)
+    filled |= slices[i].filled;
+  if (filled)
+    GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+
+  g_array_set_size (jobs, 0);
+}
+
 static GstBuffer *
 gst_audio_aggregator_create_output_buffer (GstAudioAggregator * aagg,
     guint num_frames)
 {
   GstAllocator *allocator;
   GstAllocationParams params;
-  GstBuffer *outbuf;
+  GstBuffer *outbuf = NULL;
   GstMapInfo outmap;
   GstAggregator *agg = GST_AGGREGATOR (aagg);
   GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  gsize size = num_frames * GST_AUDIO_INFO_BPF (&srcpad->info);
 
   gst_aggregator_get_allocator (GST_AGGREGATOR (aagg), &allocator, &params);
 
-  GST_DEBUG ("Creating output buffer with size %d",
-      num_frames * GST_AUDIO_INFO_BPF (&srcpad->info));
+  GST_DEBUG ("Creating output buffer with size %" G_GSIZE_FORMAT, size);
+
+  /* Output buffers nearly always have the same size, recycle their memory
+   * instead of allocating it again for every output period */
+  if (aagg->priv->output_pool_size != size
+      || aagg->priv->output_pool_allocator != allocator) {
+    GstStructure *config;
+
+    gst_audio_aggregator_clear_output_pool (aagg);
+
+    aagg->priv->output_pool = gst_buffer_pool_new ();
+    aagg->priv->output_pool_size = size;
+    aagg->priv->output_pool_allocator =
+        allocator ? gst_object_ref (allocator) : NULL;
+
+    config = gst_buffer_pool_get_config (aagg->priv->output_pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+    if (!gst_buffer_pool_set_config (aagg->priv->output_pool, config)
+        || !gst_buffer_pool_set_active (aagg->priv->output_pool, TRUE)) {
+      GST_WARNING_OBJECT (aagg, "Failed to set up output buffer pool");
+      gst_object_unref (aagg->priv->output_pool);
+      aagg->priv->output_pool = NULL;
+    }
+  }
 
-  outbuf = gst_buffer_new_allocate (allocator, num_frames *
-      GST_AUDIO_INFO_BPF (&srcpad->info), &params);
+  if (aagg->priv->output_pool)
+    gst_buffer_pool_acquire_buffer (aagg->priv->output_pool, &outbuf, NULL);
+  if (outbuf == NULL)
+    outbuf = gst_buffer_new_allocate (allocator, size, &params);
 
   if (allocator)
     gst_object_unref (allocator);
@@ -1837,6 +2345,59 @@ gst_audio_aggregator_create_output_buffer (GstAudioAggregator * aagg,
   return outbuf;
 }
 
+/* Called without the object lock */
+static GstBuffer *
+gst_audio_aggregator_ensure_output_buffer (GstAudioAggregator * aagg)
+{
+  if (aagg->priv->current_buffer == NULL) {
+    aagg->priv->current_buffer =
+        GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer (aagg,
+        aagg->priv->current_blocksize);
+    GST_BUFFER_FLAG_SET (aagg->priv->current_buffer, GST_BUFFER_FLAG_GAP);
+  }
+
+  return aagg->priv->current_buffer;
+}
+
+/* Returns a GAP buffer of @num_frames frames of silence, sharing its memory
+ * with all other silent output buffers instead of allocating and filling
+ * new memory every time */
+static GstBuffer *
+gst_audio_aggregator_get_silence_buffer (GstAudioAggregator * aagg,
+    guint num_frames)
+{
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (aagg));
+  gsize size = num_frames * GST_AUDIO_INFO_BPF (&srcpad->info);
+  GstBuffer *outbuf;
+
+  if (aagg->priv->silence_buffer == NULL
+      || aagg->priv->silence_format != GST_AUDIO_INFO_FORMAT (&srcpad->info)
+      || gst_buffer_get_size (aagg->priv->silence_buffer) < size) {
+    GstMapInfo map;
+
+    gst_buffer_replace (&aagg->priv->silence_buffer, NULL);
+
+    /* leave room for the blocks that are one frame larger */
+    aagg->priv->silence_buffer = gst_buffer_new_allocate (NULL,
+        size + GST_AUDIO_INFO_BPF (&srcpad->info), NULL);
+    aagg->priv->silence_format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+
+    gst_buffer_map (aagg->priv->silence_buffer, &map, GST_MAP_WRITE);
+    gst_audio_format_fill_silence (srcpad->info.finfo, map.data, map.size);
+    gst_buffer_unmap (aagg->priv->silence_buffer, &map);
+
+    GST_DEBUG_OBJECT (aagg, "Created silence buffer of size %" G_GSIZE_FORMAT,
+        gst_buffer_get_size (aagg->priv->silence_buffer));
+  }
+
+  outbuf = gst_buffer_copy_region (aagg->priv->silence_buffer,
+      GST_BUFFER_COPY_MEMORY, 0, size);
+  GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
+
+  return outbuf;
+}
+
 static gboolean
 sync_pad_values (GstElement * aagg, GstPad * pad, gpointer user_data)
 {
@@ -1900,11 +2461,14 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
   gboolean is_eos = TRUE;
   gboolean is_done = TRUE;
   guint blocksize;
+  guint n_threads, conv_idx = 0;
   GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
   GstSegment *agg_segment = &GST_AGGREGATOR_PAD (agg->srcpad)->segment;
+  GstClockTime start_time, elapsed;
 
   element = GST_ELEMENT (agg);
   aagg = GST_AUDIO_AGGREGATOR (agg);
+  start_time = gst_util_get_timestamp ();
 
   /* Sync pad properties to the stream time */
   gst_element_foreach_sink_pad (element, sync_pad_values, NULL);
@@ -1974,7 +2538,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
         aagg->priv->offset);
   }
 
-  if (aagg->priv->current_buffer == NULL) {
+  if (!aagg->priv->have_block) {
     blocksize = aagg->priv->samples_per_buffer;
 
     if (aagg->priv->error_per_buffer + aagg->priv->accumulated_error >=
@@ -1987,13 +2551,17 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
         (aagg->priv->accumulated_error +
         aagg->priv->error_per_buffer) % aagg->priv->output_buffer_duration_d;
 
-    GST_OBJECT_UNLOCK (agg);
-    aagg->priv->current_buffer =
-        GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer (aagg,
-        blocksize);
-    /* Be careful, some things could have changed ? */
-    GST_OBJECT_LOCK (agg);
-    GST_BUFFER_FLAG_SET (aagg->priv->current_buffer, GST_BUFFER_FLAG_GAP);
+    aagg->priv->have_block = TRUE;
+
+    /* Output buffers of subclasses with their own allocation are created
+     * upfront, ours only once something is mixed into them */
+    if (GST_AUDIO_AGGREGATOR_GET_CLASS (aagg)->create_output_buffer !=
+        gst_audio_aggregator_create_output_buffer) {
+      GST_OBJECT_UNLOCK (agg);
+      gst_audio_aggregator_ensure_output_buffer (aagg);
+      /* Be careful, some things could have changed ? */
+      GST_OBJECT_LOCK (agg);
+    }
   } else {
     blocksize = aagg->priv->current_blocksize;
   }
@@ -2010,17 +2578,31 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
       agg_segment->start + gst_util_uint64_scale (next_offset, GST_SECOND,
       rate);
 
-  outbuf = aagg->priv->current_buffer;
-
   GST_LOG_OBJECT (agg,
       "Starting to mix %u samples for offset %" G_GINT64_FORMAT
       " with timestamp %" GST_TIME_FORMAT, blocksize,
       aagg->priv->offset, GST_TIME_ARGS (agg_segment->position));
 
+  n_threads = gst_audio_aggregator_get_n_threads (aagg);
+  aagg->priv->defer_mix = (n_threads > 1);
+  if (n_threads > 1)
+    gst_audio_aggregator_run_conversions (aagg, n_threads);
+
   for (iter = element->sinkpads; iter; iter = iter->next) {
     GstAudioAggregatorPad *pad = (GstAudioAggregatorPad *) iter->data;
     GstAggregatorPad *aggpad = (GstAggregatorPad *) iter->data;
     gboolean pad_eos = gst_aggregator_pad_is_eos (aggpad);
+    AudioAggregatorConversion *conv = NULL;
+
+    /* conversions are in the same order as the pads */
+    if (conv_idx < aagg->priv->conversions->len) {
+      conv = &g_array_index (aagg->priv->conversions,
+          AudioAggregatorConversion, conv_idx);
+      if (conv->pad == pad)
+        conv_idx++;
+      else
+        conv = NULL;
+    }
 
     if (!pad_eos)
       is_eos = FALSE;
@@ -2050,13 +2632,17 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
     /* New buffer? */
     if (!pad->priv->buffer) {
-      if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer)
+      if (conv && conv->input_buffer == pad->priv->input_buffer) {
+        pad->priv->buffer = conv->buffer;
+        conv->buffer = NULL;
+      } else if (GST_AUDIO_AGGREGATOR_PAD_GET_CLASS (pad)->convert_buffer) {
         pad->priv->buffer =
             gst_audio_aggregator_convert_buffer
             (aagg, GST_PAD (pad), &pad->info, &srcpad->info,
             pad->priv->input_buffer);
-      else
+      } else {
         pad->priv->buffer = gst_buffer_ref (pad->priv->input_buffer);
+      }
 
       if (!gst_audio_aggregator_fill_buffer (aagg, pad)) {
         gst_buffer_replace (&pad->priv->buffer, NULL);
@@ -2114,7 +2700,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
       GST_LOG_OBJECT (aggpad, "Mixing buffer for current offset");
       drop_buf = !gst_audio_aggregator_mix_buffer (aagg, pad, pad->priv->buffer,
-          outbuf, blocksize);
+          blocksize);
       if (pad->priv->output_offset >= next_offset) {
         GST_LOG_OBJECT (pad,
             "Pad is at or after current offset: %" G_GUINT64_FORMAT " >= %"
@@ -2131,8 +2717,12 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
     GST_OBJECT_UNLOCK (pad);
   }
+  g_array_set_size (aagg->priv->conversions, 0);
+  aagg->priv->defer_mix = FALSE;
   GST_OBJECT_UNLOCK (agg);
 
+  gst_audio_aggregator_run_mix_jobs (aagg, blocksize, n_threads);
+
   if (dropped) {
     /* We dropped a buffer, retry */
     GST_LOG_OBJECT (aagg, "A pad dropped a buffer, wait for the next one");
@@ -2148,6 +2738,12 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     return GST_AGGREGATOR_FLOW_NEED_DATA;
   }
 
+  /* Nothing was mixed in, all inputs were silent */
+  if (aagg->priv->current_buffer == NULL)
+    aagg->priv->current_buffer =
+        gst_audio_aggregator_get_silence_buffer (aagg, blocksize);
+  outbuf = aagg->priv->current_buffer;
+
   if (is_eos) {
     gint64 max_offset = 0;
 
@@ -2164,6 +2760,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     /* This means EOS or nothing mixed in at all */
     if (aagg->priv->offset == max_offset) {
       gst_buffer_replace (&aagg->priv->current_buffer, NULL);
+      aagg->priv->have_block = FALSE;
       GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
       return GST_FLOW_EOS;
     }
@@ -2196,6 +2793,9 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
     GST_BUFFER_DURATION (outbuf) = agg_segment->position - next_timestamp;
   }
 
+  elapsed = gst_util_get_timestamp () - start_time;
+  gst_processing_stats_add (&aagg->priv->aggregate_stats, elapsed);
+
   GST_OBJECT_UNLOCK (agg);
 
   /* send it out */
@@ -2208,6 +2808,7 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
   ret = gst_aggregator_finish_buffer (agg, outbuf);
   aagg->priv->current_buffer = NULL;
+  aagg->priv->have_block = FALSE;
 
   GST_LOG_OBJECT (aagg, "pushed outbuf, result = %s", gst_flow_get_name (ret));
 
@@ -2236,6 +2837,9 @@ gst_audio_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
   /* ERRORS */
 not_negotiated:
   {
+    g_array_set_size (aagg->priv->conversions, 0);
+    g_array_set_size (aagg->priv->mix_jobs, 0);
+    aagg->priv->defer_mix = FALSE;
     GST_AUDIO_AGGREGATOR_UNLOCK (aagg);
     GST_ELEMENT_ERROR (aagg, STREAM, FORMAT, (NULL),
         ("Unknown data received, not negotiated"));
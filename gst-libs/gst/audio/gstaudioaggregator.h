@@ -193,7 +193,9 @@ struct _GstAudioAggregator
  * @aggregate_one_buffer: Aggregates one input buffer to the output
  *  buffer.  The in_offset and out_offset are in "frames", which is
  *  the size of a sample times the number of channels. Returns TRUE if
- *  any non-silence was added to the buffer
+ *  any non-silence was added to the buffer. When #GstAudioAggregator:max-threads
+ *  is not 1, this can be called from several threads at once for disjoint
+ *  parts of the output buffer.
  *
  * Since: 1.14
  */
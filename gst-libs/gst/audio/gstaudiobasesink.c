@@ -75,6 +75,11 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* variable rate converter and integrated drift (in seconds) for the
+   * resample slave method, only used from the streaming thread */
+  GstAudioConverter *resampler;
+  gdouble resample_drift;
 };
 
 /* BaseAudioSink signals and args */
@@ -90,6 +95,17 @@ enum
 #define DEFAULT_PROVIDE_CLOCK   TRUE
 #define DEFAULT_SLAVE_METHOD    GST_AUDIO_BASE_SINK_SLAVE_SKEW
 
+/* gains of the PI controller of the resample slave method. The error is the
+ * distance in seconds between where samples should be written according to
+ * the master clock and where they continue the previous buffer, the output
+ * is a relative correction of the resampling ratio. */
+#define RESAMPLE_SLAVE_KP          0.01
+#define RESAMPLE_SLAVE_KI          0.001
+#define RESAMPLE_SLAVE_MAX_ADJUST  0.005
+/* upper bound of the scaled rates configured on the resampler, see
+ * audioresample */
+#define RESAMPLE_SLAVE_MAX_RATE    (1 << 22)
+
 /* FIXME, enable pull mode when clock slaving and trick modes are figured out */
 #define DEFAULT_CAN_ACTIVATE_PULL FALSE
 
@@ -326,6 +342,11 @@ gst_audio_base_sink_dispose (GObject * object)
     sink->ringbuffer = NULL;
   }
 
+  if (sink->priv->resampler) {
+    gst_audio_converter_free (sink->priv->resampler);
+    sink->priv->resampler = NULL;
+  }
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -958,6 +979,12 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   /* We need to resync since the ringbuffer restarted */
   gst_audio_base_sink_reset_sync (sink);
 
+  /* the resampler is recreated for the new format when needed */
+  if (sink->priv->resampler) {
+    gst_audio_converter_free (sink->priv->resampler);
+    sink->priv->resampler = NULL;
+  }
+
   gst_audio_base_sink_custom_cb_report_discont (sink,
       GST_AUDIO_BASE_SINK_DISCONT_REASON_NEW_CAPS);
 
@@ -1041,6 +1068,9 @@ gst_audio_base_sink_reset_sync (GstAudioBaseSink * sink)
   sink->priv->discont_time = -1;
   sink->priv->avg_skew = -1;
   sink->priv->last_align = 0;
+  sink->priv->resample_drift = 0.0;
+  if (sink->priv->resampler)
+    gst_audio_converter_reset (sink->priv->resampler);
 }
 
 static void
@@ -1546,6 +1576,92 @@ gst_audio_base_sink_none_slaving (GstAudioBaseSink * sink,
   *srender_stop = render_stop;
 }
 
+/* resample @samples samples of @buf starting at byte @offset for the
+ * resample slave method. The ratio follows the calibration of the provided
+ * clock against the master, corrected by a PI controller on @align, the
+ * number of samples between the ideal position of the buffer and the end of
+ * the previous one. Returns a new buffer with the resampled data. */
+static GstBuffer *
+gst_audio_base_sink_resample_slaved (GstAudioBaseSink * sink, GstBuffer * buf,
+    gsize offset, guint samples, gint64 align, gboolean discont)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstAudioInfo *info = &sink->ringbuffer->spec.info;
+  GstClockTime crate_num, crate_denom;
+  gint rate = GST_AUDIO_INFO_RATE (info);
+  gint bpf = GST_AUDIO_INFO_BPF (info);
+  gdouble ratio, error, adjust;
+  gint scale;
+  gsize out_samples;
+  GstMapInfo in_map, out_map;
+  GstBuffer *outbuf;
+  gpointer in[1], out[1];
+
+  if (priv->resampler == NULL) {
+    GstStructure *options;
+
+    options = gst_structure_new_empty ("resampler-options");
+    gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, rate, rate, options);
+    /* the ratio changes with every buffer, only the interpolated filter table
+     * does not depend on it */
+    gst_structure_set (options,
+        GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+        GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+        GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED, NULL);
+
+    priv->resampler =
+        gst_audio_converter_new (GST_AUDIO_CONVERTER_FLAG_VARIABLE_RATE, info,
+        info, options);
+    if (priv->resampler == NULL)
+      return NULL;
+    priv->resample_drift = 0.0;
+  } else if (discont) {
+    gst_audio_converter_reset (priv->resampler);
+    priv->resample_drift = 0.0;
+  }
+
+  gst_clock_get_calibration (sink->provided_clock, NULL, NULL, &crate_num,
+      &crate_denom);
+  if (crate_num == 0 || crate_denom == 0)
+    crate_num = crate_denom = 1;
+
+  /* a positive align means the buffer continues later than the master clock
+   * wants it, produce fewer samples to catch up */
+  error = (gdouble) align / rate;
+  priv->resample_drift += error * samples / rate;
+  adjust = -(RESAMPLE_SLAVE_KP * error +
+      RESAMPLE_SLAVE_KI * priv->resample_drift);
+  adjust = CLAMP (adjust, -RESAMPLE_SLAVE_MAX_ADJUST,
+      RESAMPLE_SLAVE_MAX_ADJUST);
+
+  ratio = gst_guint64_to_gdouble (crate_denom) /
+      gst_guint64_to_gdouble (crate_num) * (1.0 + adjust);
+  ratio = CLAMP (ratio, 0.9, 1.1);
+
+  GST_LOG_OBJECT (sink, "align %" G_GINT64_FORMAT ", drift %f, ratio %.9f",
+      align, priv->resample_drift, ratio);
+
+  scale = MAX (RESAMPLE_SLAVE_MAX_RATE / (rate + rate / 10), 1);
+  gst_audio_converter_update_config (priv->resampler, rate * scale,
+      (gint) (rate * scale * ratio + 0.5), NULL);
+
+  out_samples = gst_audio_converter_get_out_frames (priv->resampler, samples);
+  outbuf = gst_buffer_new_allocate (NULL, out_samples * bpf, NULL);
+  gst_buffer_copy_into (outbuf, buf, GST_BUFFER_COPY_FLAGS, 0, -1);
+
+  gst_buffer_map (buf, &in_map, GST_MAP_READ);
+  gst_buffer_map (outbuf, &out_map, GST_MAP_WRITE);
+  in[0] = in_map.data + offset;
+  out[0] = out_map.data;
+  gst_audio_converter_samples (priv->resampler, 0, in, samples, out,
+      out_samples);
+  gst_buffer_unmap (outbuf, &out_map);
+  gst_buffer_unmap (buf, &in_map);
+
+  return outbuf;
+}
+
 /* converts render_start and render_stop to their slaved values */
 static void
 gst_audio_base_sink_handle_slaving (GstAudioBaseSink * sink,
@@ -1802,7 +1918,7 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   GstAudioBaseSinkClass *bclass;
   GstAudioBaseSink *sink;
   GstAudioRingBuffer *ringbuf;
-  gint64 diff, align;
+  gint64 diff, align = 0;
   guint64 ctime, cstop;
   gsize offset;
   GstMapInfo info;
@@ -1823,6 +1939,7 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   bclass = GST_AUDIO_BASE_SINK_GET_CLASS (sink);
 
   ringbuf = sink->ringbuffer;
+  slaved = FALSE;
 
   /* can't do anything when we don't have the device */
   if (G_UNLIKELY (!gst_audio_ring_buffer_is_acquired (ringbuf)))
@@ -2130,6 +2247,27 @@ no_align:
   else
     sample_offset = render_stop;
 
+  /* when slaved with the resample method, resample the data with a variable
+   * ratio instead of letting the ringbuffer drop or repeat samples */
+  if (G_UNLIKELY (slaved
+          && sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE
+          && bsink->segment.rate == 1.0 && samples > 0
+          && ringbuf->spec.type == GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW)) {
+    GstBuffer *resampled;
+
+    resampled = gst_audio_base_sink_resample_slaved (sink, buf, offset,
+        samples, align, sink->next_sample == -1
+        || GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT));
+    if (resampled) {
+      if (out)
+        gst_buffer_unref (out);
+      buf = out = resampled;
+      offset = 0;
+      samples = out_samples = gst_buffer_get_size (buf) / bpf;
+      render_stop = render_start + out_samples;
+    }
+  }
+
   GST_DEBUG_OBJECT (sink, "rendering at %" G_GUINT64_FORMAT " %d/%d",
       sample_offset, samples, out_samples);
 
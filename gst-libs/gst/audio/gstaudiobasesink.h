@@ -82,7 +82,10 @@ G_BEGIN_DECLS
 
 /**
  * GstAudioBaseSinkSlaveMethod:
- * @GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE: Resample to match the master clock
+ * @GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE: Resample to match the master clock.
+ * Since 1.18, raw audio played at normal rate is resampled with a variable
+ * ratio that follows the master clock, corrected by a PI controller,
+ * instead of dropping or repeating samples.
  * @GST_AUDIO_BASE_SINK_SLAVE_SKEW: Adjust playout pointer when master clock
  * drifts too much.
  * @GST_AUDIO_BASE_SINK_SLAVE_NONE: No adjustment is done.
@@ -49,6 +49,9 @@ struct _GstAudioBaseSrcPrivate
 {
   /* the clock slaving algorithm in use */
   GstAudioBaseSrcSlaveMethod slave_method;
+
+  /* the most segments read into one buffer when catching up */
+  guint max_segments;
 };
 
 /* BaseAudioSrc signals and args */
@@ -65,6 +68,7 @@ enum
 #define DEFAULT_ACTUAL_LATENCY_TIME    -1
 #define DEFAULT_PROVIDE_CLOCK   TRUE
 #define DEFAULT_SLAVE_METHOD    GST_AUDIO_BASE_SRC_SLAVE_SKEW
+#define DEFAULT_MAX_SEGMENTS    1
 
 enum
 {
@@ -75,6 +79,7 @@ enum
   PROP_ACTUAL_LATENCY_TIME,
   PROP_PROVIDE_CLOCK,
   PROP_SLAVE_METHOD,
+  PROP_MAX_SEGMENTS,
   PROP_LAST
 };
 
@@ -189,6 +194,24 @@ gst_audio_base_src_class_init (GstAudioBaseSrcClass * klass)
           GST_TYPE_AUDIO_BASE_SRC_SLAVE_METHOD, DEFAULT_SLAVE_METHOD,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioBaseSrc:max-segments:
+   *
+   * When more than one segment was captured already, read up to this many
+   * of them into one output buffer instead of producing one buffer per
+   * segment. This only happens when the source is behind, for example after
+   * downstream blocked for a while or with very short segments, and reduces
+   * the overhead per captured segment. The timestamp and duration cover all
+   * segments of the buffer.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_SEGMENTS,
+      g_param_spec_uint ("max-segments", "Max Segments",
+          "Maximum number of already captured segments to read into one "
+          "buffer", 1, G_MAXINT, DEFAULT_MAX_SEGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_base_src_change_state);
   gstelement_class->provide_clock =
@@ -222,6 +245,7 @@ gst_audio_base_src_init (GstAudioBaseSrc * audiobasesrc)
   else
     GST_OBJECT_FLAG_UNSET (audiobasesrc, GST_ELEMENT_FLAG_PROVIDE_CLOCK);
   audiobasesrc->priv->slave_method = DEFAULT_SLAVE_METHOD;
+  audiobasesrc->priv->max_segments = DEFAULT_MAX_SEGMENTS;
   /* reset blocksize we use latency time to calculate a more useful
    * value based on negotiated format. */
   GST_BASE_SRC (audiobasesrc)->blocksize = 0;
@@ -435,6 +459,11 @@ gst_audio_base_src_set_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       gst_audio_base_src_set_slave_method (src, g_value_get_enum (value));
       break;
+    case PROP_MAX_SEGMENTS:
+      GST_OBJECT_LOCK (src);
+      src->priv->max_segments = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -478,6 +507,11 @@ gst_audio_base_src_get_property (GObject * object, guint prop_id,
     case PROP_SLAVE_METHOD:
       g_value_set_enum (value, gst_audio_base_src_get_slave_method (src));
       break;
+    case PROP_MAX_SEGMENTS:
+      GST_OBJECT_LOCK (src);
+      g_value_set_uint (value, src->priv->max_segments);
+      GST_OBJECT_UNLOCK (src);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -757,6 +791,7 @@ gst_audio_base_src_create (GstBaseSrc * bsrc, guint64 offset, guint length,
   GstClock *clock;
   gboolean first;
   gboolean first_sample = src->next_sample == -1;
+  guint max_segments, n_segments = 1;
 
   ringbuffer = src->ringbuffer;
   spec = &ringbuffer->spec;
@@ -787,8 +822,31 @@ gst_audio_base_src_create (GstBaseSrc * bsrc, guint64 offset, guint length,
     sample = gst_audio_base_src_get_offset (src);
   }
 
-  GST_DEBUG_OBJECT (src, "reading from sample %" G_GUINT64_FORMAT " length %u",
-      sample, length);
+  GST_OBJECT_LOCK (src);
+  max_segments = src->priv->max_segments;
+  GST_OBJECT_UNLOCK (src);
+
+  /* when reading whole segments and we are behind, take all segments that
+   * are readable already, up to max-segments and less than the ringbuffer
+   * size, into this buffer */
+  if (max_segments > 1 && length == spec->segsize && !first_sample) {
+    gint segdone;
+    gint64 ready;
+
+    segdone = g_atomic_int_get (&ringbuffer->segdone) - ringbuffer->segbase;
+    ready = (gint64) segdone * ringbuffer->samples_per_seg - (gint64) sample;
+
+    if (ready > 0) {
+      n_segments = ready / ringbuffer->samples_per_seg;
+      n_segments = MIN (n_segments, max_segments);
+      n_segments = MIN (n_segments, MAX (spec->segtotal - 1, 1));
+      n_segments = MAX (n_segments, 1);
+      length *= n_segments;
+    }
+  }
+
+  GST_DEBUG_OBJECT (src, "reading from sample %" G_GUINT64_FORMAT " length %u"
+      " (%u segments)", sample, length, n_segments);
 
   /* get the number of samples to read */
   total_samples = samples = length / bpf;
@@ -798,6 +856,16 @@ gst_audio_base_src_create (GstBaseSrc * bsrc, guint64 offset, guint length,
   if (G_UNLIKELY (ret != GST_FLOW_OK))
     goto alloc_failed;
 
+  if (n_segments > 1) {
+    /* pool buffers are sized for one segment */
+    if (gst_buffer_get_size (buf) < length) {
+      gst_buffer_unref (buf);
+      buf = gst_buffer_new_allocate (NULL, length, NULL);
+    } else {
+      gst_buffer_set_size (buf, length);
+    }
+  }
+
   gst_buffer_map (buf, &info, GST_MAP_WRITE);
   ptr = info.data;
   first = TRUE;
@@ -30,6 +30,15 @@
  * simply need to provide a function that returns the current clock time.
  *
  * This object is internally used to implement the clock in #GstAudioBaseSink.
+ *
+ * Calling the time function can be expensive when it has to query the
+ * device, for example for the current delay. When the
+ * #GstAudioClock:refresh-interval property is set, the clock only calls the
+ * time function once per interval and interpolates the time in between
+ * using the system monotonic clock. The interpolated time is never more
+ * than the refresh interval ahead of the last time reported by the time
+ * function, so the refresh interval is also the maximum error of the
+ * interpolation, for example when the device stalls.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -41,12 +50,41 @@
 GST_DEBUG_CATEGORY_STATIC (gst_audio_clock_debug);
 #define GST_CAT_DEFAULT gst_audio_clock_debug
 
+#define DEFAULT_REFRESH_INTERVAL        0
+
+enum
+{
+  PROP_0,
+  PROP_REFRESH_INTERVAL
+};
+
+struct _GstAudioClockPrivate
+{
+  GMutex lock;
+
+  GstClockTime refresh_interval;
+
+  /* last time reported by the time function and the monotonic time in
+   * nanoseconds at which it was reported */
+  GstClockTime sample_time;
+  gint64 sample_mono;
+  /* if the last two reported times were increasing. We only interpolate
+   * while the device is running */
+  gboolean running;
+};
+
 static void gst_audio_clock_dispose (GObject * object);
+static void gst_audio_clock_finalize (GObject * object);
+static void gst_audio_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_audio_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static GstClockTime gst_audio_clock_get_internal_time (GstClock * clock);
 
 #define parent_class gst_audio_clock_parent_class
-G_DEFINE_TYPE (GstAudioClock, gst_audio_clock, GST_TYPE_SYSTEM_CLOCK);
+G_DEFINE_TYPE_WITH_PRIVATE (GstAudioClock, gst_audio_clock,
+    GST_TYPE_SYSTEM_CLOCK);
 
 static void
 gst_audio_clock_class_init (GstAudioClockClass * klass)
@@ -58,8 +96,29 @@ gst_audio_clock_class_init (GstAudioClockClass * klass)
   gstclock_class = (GstClockClass *) klass;
 
   gobject_class->dispose = gst_audio_clock_dispose;
+  gobject_class->finalize = gst_audio_clock_finalize;
+  gobject_class->set_property = gst_audio_clock_set_property;
+  gobject_class->get_property = gst_audio_clock_get_property;
   gstclock_class->get_internal_time = gst_audio_clock_get_internal_time;
 
+  /**
+   * GstAudioClock:refresh-interval:
+   *
+   * Minimum interval in nanoseconds between two calls of the
+   * #GstAudioClockGetTimeFunc. In between, the time is interpolated with the
+   * system monotonic clock and can be at most this interval ahead of the
+   * time reported by the time function. 0 calls the time function every time
+   * the clock is read.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_REFRESH_INTERVAL,
+      g_param_spec_uint64 ("refresh-interval", "Refresh Interval",
+          "Minimum interval in nanoseconds between two queries of the time "
+          "function (0 = query on every clock read)", 0, G_MAXUINT64 - 1,
+          DEFAULT_REFRESH_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_DEBUG_CATEGORY_INIT (gst_audio_clock_debug, "audioclock", 0,
       "audioclock");
 }
@@ -70,6 +129,12 @@ gst_audio_clock_init (GstAudioClock * clock)
   GST_DEBUG_OBJECT (clock, "init");
   clock->last_time = 0;
   clock->time_offset = 0;
+  clock->priv = gst_audio_clock_get_instance_private (clock);
+  g_mutex_init (&clock->priv->lock);
+  clock->priv->refresh_interval = DEFAULT_REFRESH_INTERVAL;
+  clock->priv->sample_time = GST_CLOCK_TIME_NONE;
+  clock->priv->sample_mono = 0;
+  clock->priv->running = FALSE;
   GST_OBJECT_FLAG_SET (clock, GST_CLOCK_FLAG_CAN_SET_MASTER);
 }
 
@@ -86,6 +151,65 @@ gst_audio_clock_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_audio_clock_finalize (GObject * object)
+{
+  GstAudioClock *clock = GST_AUDIO_CLOCK (object);
+
+  g_mutex_clear (&clock->priv->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_audio_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioClock *clock = GST_AUDIO_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_REFRESH_INTERVAL:
+      g_mutex_lock (&clock->priv->lock);
+      clock->priv->refresh_interval = g_value_get_uint64 (value);
+      clock->priv->sample_time = GST_CLOCK_TIME_NONE;
+      clock->priv->running = FALSE;
+      g_mutex_unlock (&clock->priv->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audio_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAudioClock *clock = GST_AUDIO_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_REFRESH_INTERVAL:
+      g_mutex_lock (&clock->priv->lock);
+      g_value_set_uint64 (value, clock->priv->refresh_interval);
+      g_mutex_unlock (&clock->priv->lock);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* forget the last sample of the time function so that the next clock read
+ * calls it again */
+static void
+gst_audio_clock_flush_sample (GstAudioClock * clock)
+{
+  g_mutex_lock (&clock->priv->lock);
+  clock->priv->sample_time = GST_CLOCK_TIME_NONE;
+  clock->priv->running = FALSE;
+  g_mutex_unlock (&clock->priv->lock);
+}
+
 /**
  * gst_audio_clock_new:
  * @name: the name of the clock
@@ -138,6 +262,8 @@ gst_audio_clock_reset (GstAudioClock * clock, GstClockTime time)
 
   clock->time_offset = time_offset;
 
+  gst_audio_clock_flush_sample (clock);
+
   GST_DEBUG_OBJECT (clock,
       "reset clock to %" GST_TIME_FORMAT ", last %" GST_TIME_FORMAT
       ", offset %" GST_STIME_FORMAT, GST_TIME_ARGS (time),
@@ -150,6 +276,49 @@ gst_audio_clock_func_invalid (GstClock * clock, gpointer user_data)
   return GST_CLOCK_TIME_NONE;
 }
 
+/* Returns the time of the time function, interpolated from its last sample
+ * when that was taken less than refresh-interval ago */
+static GstClockTime
+gst_audio_clock_get_func_time (GstAudioClock * aclock)
+{
+  GstAudioClockPrivate *priv = aclock->priv;
+  GstClockTime result, interval;
+  gint64 now;
+
+  g_mutex_lock (&priv->lock);
+  interval = priv->refresh_interval;
+  if (interval == 0) {
+    g_mutex_unlock (&priv->lock);
+    return aclock->func (GST_CLOCK_CAST (aclock), aclock->user_data);
+  }
+
+  now = g_get_monotonic_time () * GST_USECOND;
+  if (priv->running && (GstClockTime) (now - priv->sample_mono) < interval) {
+    result = priv->sample_time + (now - priv->sample_mono);
+    g_mutex_unlock (&priv->lock);
+
+    GST_LOG_OBJECT (aclock, "interpolated %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (result));
+    return result;
+  }
+  g_mutex_unlock (&priv->lock);
+
+  result = aclock->func (GST_CLOCK_CAST (aclock), aclock->user_data);
+
+  g_mutex_lock (&priv->lock);
+  if (result != GST_CLOCK_TIME_NONE) {
+    priv->running = GST_CLOCK_TIME_IS_VALID (priv->sample_time)
+        && result > priv->sample_time;
+    priv->sample_time = result;
+    priv->sample_mono = now;
+  } else {
+    priv->running = FALSE;
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
 static GstClockTime
 gst_audio_clock_get_internal_time (GstClock * clock)
 {
@@ -158,7 +327,7 @@ gst_audio_clock_get_internal_time (GstClock * clock)
 
   aclock = GST_AUDIO_CLOCK_CAST (clock);
 
-  result = aclock->func (clock, aclock->user_data);
+  result = gst_audio_clock_get_func_time (aclock);
   if (result == GST_CLOCK_TIME_NONE) {
     result = aclock->last_time;
   } else {
@@ -238,4 +407,5 @@ void
 gst_audio_clock_invalidate (GstAudioClock * clock)
 {
   clock->func = gst_audio_clock_func_invalid;
+  gst_audio_clock_flush_sample (clock);
 }
@@ -126,6 +126,7 @@
 #include "gstaudiodecoder.h"
 #include "gstaudioutilsprivate.h"
 #include <gst/pbutils/descriptions.h>
+#include <gst/gstoutputqueue-private.h>
 
 #include <string.h>
 
@@ -142,12 +143,17 @@ enum
   PROP_0,
   PROP_LATENCY,
   PROP_TOLERANCE,
-  PROP_PLC
+  PROP_PLC,
+  PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+  PROP_OUTPUT_QUEUE_MAX_TIME,
+  PROP_STATS
 };
 
 #define DEFAULT_LATENCY    0
 #define DEFAULT_TOLERANCE  0
 #define DEFAULT_PLC        FALSE
+#define DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS 0
+#define DEFAULT_OUTPUT_QUEUE_MAX_TIME 0
 #define DEFAULT_DRAINABLE  TRUE
 #define DEFAULT_NEEDS_FORMAT  FALSE
 
@@ -182,6 +188,10 @@ typedef struct _GstAudioDecoderContext
 
   GstAllocator *allocator;
   GstAllocationParams params;
+  /* pool for gst_audio_decoder_allocate_output_buffer(), its buffers
+   * are pool_size bytes large and resized to what is asked for */
+  GstBufferPool *pool;
+  gsize pool_size;
 } GstAudioDecoderContext;
 
 struct _GstAudioDecoderPrivate
@@ -201,8 +211,10 @@ struct _GstAudioDecoderPrivate
   guint64 prev_distance;
   /* frames obtained from input */
   GQueue frames;
-  /* collected output data */
-  GstAdapter *adapter_out;
+  /* collected output data, copied into a buffer from out_pool */
+  GstBufferPool *out_pool;
+  GstBuffer *out_buf;
+  gsize out_size;
   /* ts and duration for output data collected above */
   GstClockTime out_ts, out_dur;
   /* mark outgoing discont */
@@ -265,6 +277,20 @@ struct _GstAudioDecoderPrivate
 
   /* flags */
   gboolean use_default_pad_acceptcaps;
+
+  /* output queue */
+  guint output_queue_max_buffers;       /* OBJECT_LOCK */
+  GstClockTime output_queue_max_time;   /* OBJECT_LOCK */
+  gboolean output_queue_active;
+  GstOutputQueue output_queue;
+
+  /* statistics, OBJECT_LOCK */
+  GstClockTime decode_time;
+  GstClockTime push_time;
+  guint64 frames_decoded;
+  guint64 buffers_pushed;
+  /* time spent outputting by the decoding thread, STREAM_LOCK */
+  GstClockTime output_time;
 };
 
 static void gst_audio_decoder_finalize (GObject * object);
@@ -317,6 +343,13 @@ static GstFlowReturn
 gst_audio_decoder_finish_frame_or_subframe (GstAudioDecoder * dec,
     GstBuffer * buf, gint frames);
 
+static gboolean gst_audio_decoder_src_activate_mode (GstPad * pad,
+    GstObject * parent, GstPadMode mode, gboolean active);
+static GstFlowReturn gst_audio_decoder_push_timed (GstAudioDecoder * dec,
+    GstBuffer * buf);
+static GstFlowReturn gst_audio_decoder_output_queue_push (GstAudioDecoder *
+    dec, GstMiniObject * item);
+
 static GstElementClass *parent_class = NULL;
 static gint private_offset = 0;
 
@@ -404,6 +437,64 @@ gst_audio_decoder_class_init (GstAudioDecoderClass * klass)
           "Perform packet loss concealment (if supported)",
           DEFAULT_PLC, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioDecoder:output-queue-max-buffers:
+   *
+   * If not 0, decoded buffers are pushed downstream from a separate thread,
+   * queueing up to this many buffers, so that decoding doesn't stall while
+   * downstream is busy.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+      g_param_spec_uint ("output-queue-max-buffers",
+          "Output queue max buffers",
+          "Number of buffers to queue for pushing from a separate thread "
+          "(0 = push from the decoding thread)", 0, G_MAXUINT,
+          DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioDecoder:output-queue-max-time:
+   *
+   * If not 0, decoded buffers are pushed downstream from a separate thread,
+   * queueing buffers up to this duration. Combined with
+   * #GstAudioDecoder:output-queue-max-buffers, whichever limit is hit first
+   * applies.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_QUEUE_MAX_TIME,
+      g_param_spec_uint64 ("output-queue-max-time",
+          "Output queue max time",
+          "Duration of buffers to queue for pushing from a separate thread, "
+          "in nanoseconds (0 = push from the decoding thread)", 0,
+          G_MAXUINT64, DEFAULT_OUTPUT_QUEUE_MAX_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioDecoder:stats:
+   *
+   * Various decoder statistics. This property returns a #GstStructure
+   * with name `application/x-gst-audio-decoder-stats` with the following
+   * fields:
+   *
+   * - "decode-time" G_TYPE_UINT64: total time spent decoding frames, not
+   *   counting the time spent pushing them
+   * - "push-time" G_TYPE_UINT64: total time spent pushing buffers downstream
+   * - "decoded" G_TYPE_UINT64: the number of frames handed to the subclass
+   * - "pushed" G_TYPE_UINT64: the number of buffers pushed downstream
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Decoding and output statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   audiodecoder_class->sink_event =
       GST_DEBUG_FUNCPTR (gst_audio_decoder_sink_eventfunc);
   audiodecoder_class->src_event =
@@ -456,21 +547,28 @@ gst_audio_decoder_init (GstAudioDecoder * dec, GstAudioDecoderClass * klass)
       GST_DEBUG_FUNCPTR (gst_audio_decoder_src_event));
   gst_pad_set_query_function (dec->srcpad,
       GST_DEBUG_FUNCPTR (gst_audio_decoder_src_query));
+  gst_pad_set_activatemode_function (dec->srcpad,
+      GST_DEBUG_FUNCPTR (gst_audio_decoder_src_activate_mode));
   gst_element_add_pad (GST_ELEMENT (dec), dec->srcpad);
   GST_DEBUG_OBJECT (dec, "srcpad created");
 
   dec->priv->adapter = gst_adapter_new ();
-  dec->priv->adapter_out = gst_adapter_new ();
   g_queue_init (&dec->priv->frames);
 
   g_rec_mutex_init (&dec->stream_lock);
 
+  gst_output_queue_init (&dec->priv->output_queue, GST_OBJECT (dec),
+      dec->srcpad, (GstOutputQueuePushFunc) gst_audio_decoder_push_timed,
+      GST_CAT_DEFAULT);
+
   /* property default */
   dec->priv->latency = DEFAULT_LATENCY;
   dec->priv->tolerance = DEFAULT_TOLERANCE;
   dec->priv->plc = DEFAULT_PLC;
   dec->priv->drainable = DEFAULT_DRAINABLE;
   dec->priv->needs_format = DEFAULT_NEEDS_FORMAT;
+  dec->priv->output_queue_max_buffers = DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS;
+  dec->priv->output_queue_max_time = DEFAULT_OUTPUT_QUEUE_MAX_TIME;
 
   /* init state */
   dec->priv->ctx.min_latency = 0;
@@ -517,6 +615,10 @@ gst_audio_decoder_reset (GstAudioDecoder * dec, gboolean full)
 
     if (dec->priv->ctx.allocator)
       gst_object_unref (dec->priv->ctx.allocator);
+    if (dec->priv->ctx.pool) {
+      gst_buffer_pool_set_active (dec->priv->ctx.pool, FALSE);
+      gst_object_unref (dec->priv->ctx.pool);
+    }
 
     GST_OBJECT_LOCK (dec);
     gst_caps_replace (&dec->priv->ctx.input_caps, NULL);
@@ -530,12 +632,20 @@ gst_audio_decoder_reset (GstAudioDecoder * dec, gboolean full)
     dec->priv->ctx.max_errors = GST_AUDIO_DECODER_MAX_ERRORS;
     dec->priv->ctx.had_output_data = FALSE;
     dec->priv->ctx.had_input_data = FALSE;
+
+    gst_buffer_replace (&dec->priv->out_buf, NULL);
+    if (dec->priv->out_pool) {
+      gst_buffer_pool_set_active (dec->priv->out_pool, FALSE);
+      gst_object_unref (dec->priv->out_pool);
+      dec->priv->out_pool = NULL;
+    }
   }
 
   g_queue_foreach (&dec->priv->frames, (GFunc) gst_buffer_unref, NULL);
   g_queue_clear (&dec->priv->frames);
   gst_adapter_clear (dec->priv->adapter);
-  gst_adapter_clear (dec->priv->adapter_out);
+  gst_buffer_replace (&dec->priv->out_buf, NULL);
+  dec->priv->out_size = 0;
   dec->priv->out_ts = GST_CLOCK_TIME_NONE;
   dec->priv->out_dur = 0;
   dec->priv->prev_ts = GST_CLOCK_TIME_NONE;
@@ -560,11 +670,9 @@ gst_audio_decoder_finalize (GObject * object)
   if (dec->priv->adapter) {
     g_object_unref (dec->priv->adapter);
   }
-  if (dec->priv->adapter_out) {
-    g_object_unref (dec->priv->adapter_out);
-  }
 
   g_rec_mutex_clear (&dec->stream_lock);
+  gst_output_queue_clear (&dec->priv->output_queue);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -617,6 +725,15 @@ gst_audio_decoder_push_event (GstAudioDecoder * dec, GstEvent * event)
       break;
   }
 
+  /* keep serialized events in order with the queued buffers */
+  if (dec->priv->output_queue_active && GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    GST_DEBUG_OBJECT (dec, "queueing event %s", GST_EVENT_TYPE_NAME (event));
+
+    return gst_audio_decoder_output_queue_push (dec,
+        GST_MINI_OBJECT_CAST (event)) != GST_FLOW_FLUSHING;
+  }
+
   return gst_pad_push_event (dec->srcpad, event);
 }
 
@@ -630,6 +747,7 @@ gst_audio_decoder_negotiate_default (GstAudioDecoder * dec)
   GstQuery *query = NULL;
   GstAllocator *allocator;
   GstAllocationParams params;
+  GstBufferPool *pool;
 
   g_return_val_if_fail (GST_IS_AUDIO_DECODER (dec), FALSE);
   g_return_val_if_fail (GST_AUDIO_INFO_IS_VALID (&dec->priv->ctx.info), FALSE);
@@ -664,6 +782,11 @@ gst_audio_decoder_negotiate_default (GstAudioDecoder * dec)
     }
   }
 
+  /* caps are set directly on the pad, after everything still queued for
+   * output with the previous caps */
+  if (dec->priv->output_queue_active)
+    gst_output_queue_drain (&dec->priv->output_queue);
+
   prevcaps = gst_pad_get_current_caps (dec->srcpad);
   if (!prevcaps || !gst_caps_is_equal (prevcaps, caps))
     res = gst_pad_set_caps (dec->srcpad, caps);
@@ -702,6 +825,29 @@ gst_audio_decoder_negotiate_default (GstAudioDecoder * dec)
   dec->priv->ctx.allocator = allocator;
   dec->priv->ctx.params = params;
 
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, NULL, NULL, NULL);
+  else
+    pool = NULL;
+
+  if (dec->priv->ctx.pool) {
+    gst_buffer_pool_set_active (dec->priv->ctx.pool, FALSE);
+    gst_object_unref (dec->priv->ctx.pool);
+  }
+  dec->priv->ctx.pool = pool;
+  dec->priv->ctx.pool_size = 0;
+
+  if (pool) {
+    GstStructure *config;
+    guint size;
+
+    /* a pool left unconfigured is sized by the first output buffer */
+    config = gst_buffer_pool_get_config (pool);
+    if (gst_buffer_pool_config_get_params (config, NULL, &size, NULL, NULL))
+      dec->priv->ctx.pool_size = size;
+    gst_structure_free (config);
+  }
+
 done:
 
   if (query)
@@ -936,7 +1082,7 @@ gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
   GstAudioDecoderPrivate *priv;
   GstAudioDecoderContext *ctx;
   GstFlowReturn ret = GST_FLOW_OK;
-  GstClockTime ts;
+  GstClockTime ts, start;
 
   klass = GST_AUDIO_DECODER_GET_CLASS (dec);
   priv = dec->priv;
@@ -1009,14 +1155,150 @@ gst_audio_decoder_push_forward (GstAudioDecoder * dec, GstBuffer * buf)
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)),
       GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-  ret = gst_pad_push (dec->srcpad, buf);
+  start = gst_util_get_timestamp ();
+  if (priv->output_queue_active)
+    ret = gst_audio_decoder_output_queue_push (dec, GST_MINI_OBJECT_CAST (buf));
+  else
+    ret = gst_audio_decoder_push_timed (dec, buf);
+  priv->output_time += gst_util_get_timestamp () - start;
 
 exit:
   return ret;
 }
 
+/* pushes @buf downstream, accounting for the time it took */
+static GstFlowReturn
+gst_audio_decoder_push_timed (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstClockTime start, elapsed;
+  GstFlowReturn ret;
+
+  start = gst_util_get_timestamp ();
+  ret = gst_pad_push (dec->srcpad, buf);
+  elapsed = gst_util_get_timestamp () - start;
+
+  GST_OBJECT_LOCK (dec);
+  priv->push_time += elapsed;
+  priv->buffers_pushed++;
+  GST_OBJECT_UNLOCK (dec);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_audio_decoder_output_queue_push (GstAudioDecoder * dec,
+    GstMiniObject * item)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  guint max_buffers;
+  GstClockTime max_time;
+
+  GST_OBJECT_LOCK (dec);
+  max_buffers = priv->output_queue_max_buffers;
+  max_time = priv->output_queue_max_time;
+  GST_OBJECT_UNLOCK (dec);
+
+  return gst_output_queue_push (&priv->output_queue, item, max_buffers,
+      max_time);
+}
+
+static gboolean
+gst_audio_decoder_src_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstAudioDecoder *dec = GST_AUDIO_DECODER (parent);
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  if (active)
+    gst_output_queue_set_flushing (&dec->priv->output_queue, FALSE);
+  else
+    gst_output_queue_stop (&dec->priv->output_queue);
+
+  return TRUE;
+}
+
 /* mini aggregator combining output buffers into fewer larger ones,
  * if so allowed/configured */
+/* Get a buffer from out_pool, large enough for twice the aggregation
+ * latency, to collect decoded data into, starting with @buf's metadata.
+ * Returns FALSE if @buf should be output on its own. */
+static gboolean
+gst_audio_decoder_start_fragment (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstAudioInfo *info = &priv->ctx.info;
+  GstFlowReturn ret;
+  gsize size;
+
+  if (info->rate <= 0 || info->bpf <= 0)
+    return FALSE;
+
+  size = info->bpf * gst_util_uint64_scale_ceil (2 * priv->latency,
+      info->rate, GST_SECOND);
+  if (gst_buffer_get_size (buf) > size)
+    return FALSE;
+
+  if (priv->out_pool) {
+    GstStructure *config;
+    guint pool_size;
+
+    config = gst_buffer_pool_get_config (priv->out_pool);
+    gst_buffer_pool_config_get_params (config, NULL, &pool_size, NULL, NULL);
+    gst_structure_free (config);
+
+    /* the format or latency changed meanwhile */
+    if (pool_size != size) {
+      gst_buffer_pool_set_active (priv->out_pool, FALSE);
+      gst_object_unref (priv->out_pool);
+      priv->out_pool = NULL;
+    }
+  }
+
+  if (!priv->out_pool) {
+    GstStructure *config;
+
+    priv->out_pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (priv->out_pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, priv->ctx.allocator,
+        &priv->ctx.params);
+    if (!gst_buffer_pool_set_config (priv->out_pool, config)
+        || !gst_buffer_pool_set_active (priv->out_pool, TRUE)) {
+      GST_WARNING_OBJECT (dec, "failed to set up output aggregation pool");
+      gst_object_unref (priv->out_pool);
+      priv->out_pool = NULL;
+      return FALSE;
+    }
+    GST_DEBUG_OBJECT (dec, "aggregating output into buffers of %"
+        G_GSIZE_FORMAT " bytes", size);
+  }
+
+  ret = gst_buffer_pool_acquire_buffer (priv->out_pool, &priv->out_buf, NULL);
+  if (ret != GST_FLOW_OK)
+    return FALSE;
+
+  gst_buffer_copy_into (priv->out_buf, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+  priv->out_size = 0;
+
+  return TRUE;
+}
+
+static void
+gst_audio_decoder_copy_to_fragment (GstAudioDecoder * dec, GstBuffer * buf)
+{
+  GstAudioDecoderPrivate *priv = dec->priv;
+  GstMapInfo map;
+
+  gst_buffer_map (buf, &map, GST_MAP_READ);
+  gst_buffer_fill (priv->out_buf, priv->out_size, map.data, map.size);
+  gst_buffer_unmap (buf, &map);
+
+  priv->out_size += map.size;
+}
+
 static GstFlowReturn
 gst_audio_decoder_output (GstAudioDecoder * dec, GstBuffer * buf)
 {
@@ -1041,12 +1323,15 @@ again:
   inbuf = NULL;
   if (priv->agg && dec->priv->latency > 0 &&
       priv->ctx.info.layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
-    gint av;
+    gsize av, size = 0;
     gboolean assemble = FALSE;
     const GstClockTimeDiff tol = 10 * GST_MSECOND;
     GstClockTimeDiff diff = -100 * GST_MSECOND;
 
-    av = gst_adapter_available (priv->adapter_out);
+    av = priv->out_size;
+    if (buf)
+      size = gst_buffer_get_size (buf);
+
     if (G_UNLIKELY (!buf)) {
       /* forcibly send current */
       assemble = TRUE;
@@ -1058,7 +1343,10 @@ again:
       assemble = TRUE;
       GST_LOG_OBJECT (dec, "buffer %d ms apart from current fragment",
           (gint) (diff / GST_MSECOND));
-    } else {
+    } else if (av && av + size > gst_buffer_get_size (priv->out_buf)) {
+      assemble = TRUE;
+      GST_LOG_OBJECT (dec, "fragment full");
+    } else if (av || gst_audio_decoder_start_fragment (dec, buf)) {
       /* add or start collecting */
       if (!av) {
         GST_LOG_OBJECT (dec, "starting new fragment");
@@ -1066,9 +1354,10 @@ again:
       } else {
         GST_LOG_OBJECT (dec, "adding to fragment");
       }
-      gst_adapter_push (priv->adapter_out, buf);
+      gst_audio_decoder_copy_to_fragment (dec, buf);
       priv->out_dur += GST_BUFFER_DURATION (buf);
-      av += gst_buffer_get_size (buf);
+      av += size;
+      gst_buffer_unref (buf);
       buf = NULL;
     }
     if (priv->out_dur > dec->priv->latency)
@@ -1076,9 +1365,12 @@ again:
     if (av && assemble) {
       GST_LOG_OBJECT (dec, "assembling fragment");
       inbuf = buf;
-      buf = gst_adapter_take_buffer (priv->adapter_out, av);
+      buf = priv->out_buf;
+      priv->out_buf = NULL;
+      gst_buffer_resize (buf, 0, av);
       GST_BUFFER_TIMESTAMP (buf) = priv->out_ts;
       GST_BUFFER_DURATION (buf) = priv->out_dur;
+      priv->out_size = 0;
       priv->out_ts = GST_CLOCK_TIME_NONE;
       priv->out_dur = 0;
     }
@@ -1561,6 +1853,9 @@ static GstFlowReturn
 gst_audio_decoder_handle_frame (GstAudioDecoder * dec,
     GstAudioDecoderClass * klass, GstBuffer * buffer)
 {
+  GstClockTime start, output_time, elapsed;
+  GstFlowReturn ret;
+
   /* Skip decoding and send a GAP instead if
    * GST_SEGMENT_FLAG_TRICKMODE_NO_AUDIO is set and we have timestamps
    * FIXME: We only do this for forward playback atm, because reverse
@@ -1597,7 +1892,19 @@ gst_audio_decoder_handle_frame (GstAudioDecoder * dec,
     GST_LOG_OBJECT (dec, "providing subclass with NULL frame");
   }
 
-  return klass->handle_frame (dec, buffer);
+  output_time = dec->priv->output_time;
+  start = gst_util_get_timestamp ();
+  ret = klass->handle_frame (dec, buffer);
+  /* don't account for frames finished and pushed from handle_frame */
+  elapsed = gst_util_get_timestamp () - start;
+  elapsed -= MIN (elapsed, dec->priv->output_time - output_time);
+
+  GST_OBJECT_LOCK (dec);
+  dec->priv->decode_time += elapsed;
+  dec->priv->frames_decoded++;
+  GST_OBJECT_UNLOCK (dec);
+
+  return ret;
 }
 
 /* maybe subclass configurable instead, but this allows for a whole lot of
@@ -2499,12 +2806,27 @@ gst_audio_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (dec, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* unblock the streaming thread if it waits for room in the output queue */
+  if (dec->priv->output_queue_active
+      && GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+    gst_output_queue_set_flushing (&dec->priv->output_queue, TRUE);
+
   if (klass->sink_event)
     ret = klass->sink_event (dec, event);
   else {
     gst_event_unref (event);
     ret = FALSE;
   }
+
+  /* FLUSH_START is forwarded now, so the output task can't be blocked
+   * downstream anymore */
+  if (dec->priv->output_queue_active) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+      gst_pad_pause_task (dec->srcpad);
+    else if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+      gst_output_queue_set_flushing (&dec->priv->output_queue, FALSE);
+  }
+
   return ret;
 }
 
@@ -2661,6 +2983,10 @@ gst_audio_decoder_decide_allocation_default (GstAudioDecoder * dec,
   GstAllocator *allocator = NULL;
   GstAllocationParams params;
   gboolean update_allocator;
+  GstBufferPool *pool = NULL;
+  guint size, min, max;
+  gboolean update_pool;
+  GstCaps *caps;
 
   /* we got configuration from our peer or the decide_allocation method,
    * parse them */
@@ -2674,6 +3000,40 @@ gst_audio_decoder_decide_allocation_default (GstAudioDecoder * dec,
     update_allocator = FALSE;
   }
 
+  if (gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    update_pool = TRUE;
+  } else {
+    pool = NULL;
+    size = min = max = 0;
+    update_pool = FALSE;
+  }
+
+  if (pool == NULL) {
+    /* no pool, we can make our own; frame sizes are only known once
+     * decoding starts, so it gets configured by the first output buffer */
+    GST_DEBUG_OBJECT (dec, "no pool, making new pool");
+    pool = gst_buffer_pool_new ();
+    size = min = max = 0;
+  }
+
+  if (size > 0) {
+    GstStructure *config;
+
+    gst_query_parse_allocation (query, &caps, NULL);
+
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, caps, size, min, max);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_DEBUG_OBJECT (dec, "failed to configure downstream pool, "
+          "making new pool");
+      gst_object_unref (pool);
+      pool = gst_buffer_pool_new ();
+      size = 0;
+    }
+  }
+
   if (update_allocator)
     gst_query_set_nth_allocation_param (query, 0, allocator, &params);
   else
@@ -2681,6 +3041,12 @@ gst_audio_decoder_decide_allocation_default (GstAudioDecoder * dec,
   if (allocator)
     gst_object_unref (allocator);
 
+  if (update_pool)
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+  else
+    gst_query_add_allocation_pool (query, pool, size, min, max);
+  gst_object_unref (pool);
+
   return TRUE;
 }
 
@@ -3068,6 +3434,26 @@ gst_audio_decoder_get_property (GObject * object, guint prop_id,
     case PROP_PLC:
       g_value_set_boolean (value, dec->priv->plc);
       break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint (value, dec->priv->output_queue_max_buffers);
+      GST_OBJECT_UNLOCK (dec);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint64 (value, dec->priv->output_queue_max_time);
+      GST_OBJECT_UNLOCK (dec);
+      break;
+    case PROP_STATS:
+      GST_OBJECT_LOCK (dec);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-gst-audio-decoder-stats",
+              "decode-time", G_TYPE_UINT64, dec->priv->decode_time,
+              "push-time", G_TYPE_UINT64, dec->priv->push_time,
+              "decoded", G_TYPE_UINT64, dec->priv->frames_decoded,
+              "pushed", G_TYPE_UINT64, dec->priv->buffers_pushed, NULL));
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3092,6 +3478,16 @@ gst_audio_decoder_set_property (GObject * object, guint prop_id,
     case PROP_PLC:
       dec->priv->plc = g_value_get_boolean (value);
       break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (dec);
+      dec->priv->output_queue_max_buffers = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (dec);
+      dec->priv->output_queue_max_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3116,6 +3512,16 @@ gst_audio_decoder_change_state (GstElement * element, GstStateChange transition)
       }
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_OBJECT_LOCK (codec);
+      codec->priv->output_queue_active =
+          codec->priv->output_queue_max_buffers != 0
+          || codec->priv->output_queue_max_time != 0;
+      codec->priv->decode_time = 0;
+      codec->priv->push_time = 0;
+      codec->priv->frames_decoded = 0;
+      codec->priv->buffers_pushed = 0;
+      GST_OBJECT_UNLOCK (codec);
+
       if (!gst_audio_decoder_start (codec)) {
         goto start_failed;
       }
@@ -3666,6 +4072,58 @@ gst_audio_decoder_merge_tags (GstAudioDecoder * dec,
   GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
 }
 
+/* Make sure ctx.pool hands out buffers of at least @size bytes. A pool
+ * that is too small is replaced by a larger one rather than reconfigured,
+ * as buffers of the old one may still be around downstream. A pool that
+ * was never configured is set up in place */
+static gboolean
+gst_audio_decoder_ensure_pool (GstAudioDecoder * dec, gsize size)
+{
+  GstAudioDecoderContext *ctx = &dec->priv->ctx;
+
+  if (size > ctx->pool_size) {
+    GstBufferPool *pool;
+    GstStructure *config;
+    gsize pool_size;
+
+    /* leave some room so that slowly growing frames don't cause a new pool
+     * for every buffer */
+    pool_size = MAX (size, ctx->pool_size + ctx->pool_size / 2);
+
+    if (ctx->pool_size == 0 && !gst_buffer_pool_is_active (ctx->pool))
+      pool = gst_object_ref (ctx->pool);
+    else
+      pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, ctx->caps, pool_size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, ctx->allocator,
+        &ctx->params);
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_INFO_OBJECT (dec, "failed to configure pool of %" G_GSIZE_FORMAT
+          " bytes", pool_size);
+      gst_object_unref (pool);
+      return FALSE;
+    }
+
+    GST_DEBUG_OBJECT (dec, "new output pool of %" G_GSIZE_FORMAT " bytes",
+        pool_size);
+
+    if (pool != ctx->pool)
+      gst_buffer_pool_set_active (ctx->pool, FALSE);
+    gst_object_unref (ctx->pool);
+    ctx->pool = pool;
+    ctx->pool_size = pool_size;
+  }
+
+  if (!gst_buffer_pool_is_active (ctx->pool)
+      && !gst_buffer_pool_set_active (ctx->pool, TRUE)) {
+    GST_INFO_OBJECT (dec, "failed to activate output pool");
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_audio_decoder_allocate_output_buffer:
  * @dec: a #GstAudioDecoder
@@ -3699,6 +4157,17 @@ gst_audio_decoder_allocate_output_buffer (GstAudioDecoder * dec, gsize size)
     }
   }
 
+  /* pool buffers are all the same size, smaller frames only use the
+   * start of one */
+  if (dec->priv->ctx.pool && gst_audio_decoder_ensure_pool (dec, size)
+      && gst_buffer_pool_acquire_buffer (dec->priv->ctx.pool, &buffer,
+          NULL) == GST_FLOW_OK) {
+    gst_buffer_resize (buffer, 0, size);
+    GST_AUDIO_DECODER_STREAM_UNLOCK (dec);
+
+    return buffer;
+  }
+
   buffer =
       gst_buffer_new_allocate (dec->priv->ctx.allocator, size,
       &dec->priv->ctx.params);
@@ -129,6 +129,8 @@
 #include <gst/base/gstadapter.h>
 #include <gst/audio/audio.h>
 #include <gst/pbutils/descriptions.h>
+#include <gst/gstoutputqueue-private.h>
+#include <gst/gstprocessingstats-private.h>
 
 #include <stdlib.h>
 #include <string.h>
@@ -143,7 +145,10 @@ enum
   PROP_PERFECT_TS,
   PROP_GRANULE,
   PROP_HARD_RESYNC,
-  PROP_TOLERANCE
+  PROP_TOLERANCE,
+  PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+  PROP_OUTPUT_QUEUE_MAX_TIME,
+  PROP_STATS
 };
 
 #define DEFAULT_PERFECT_TS   FALSE
@@ -152,6 +157,8 @@ enum
 #define DEFAULT_TOLERANCE    40000000
 #define DEFAULT_HARD_MIN     FALSE
 #define DEFAULT_DRAINABLE    TRUE
+#define DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS 0
+#define DEFAULT_OUTPUT_QUEUE_MAX_TIME 0
 
 typedef struct _GstAudioEncoderContext
 {
@@ -177,6 +184,10 @@ typedef struct _GstAudioEncoderContext
 
   GstAllocator *allocator;
   GstAllocationParams params;
+  /* pool for gst_audio_encoder_allocate_output_buffer(), its buffers
+   * are pool_size bytes large and resized to what is asked for */
+  GstBufferPool *pool;
+  gsize pool_size;
 } GstAudioEncoderContext;
 
 struct _GstAudioEncoderPrivate
@@ -239,6 +250,19 @@ struct _GstAudioEncoderPrivate
 
   /* pending serialized sink events, will be sent from finish_frame() */
   GList *pending_events;
+
+  /* output queue */
+  guint output_queue_max_buffers;       /* OBJECT_LOCK */
+  GstClockTime output_queue_max_time;   /* OBJECT_LOCK */
+  gboolean output_queue_active;
+  GstOutputQueue output_queue;
+
+  /* statistics, OBJECT_LOCK */
+  GstProcessingStats encode_stats;
+  GstClockTime push_time;
+  guint64 buffers_pushed;
+  /* time spent pushing by the encoding thread, STREAM_LOCK */
+  GstClockTime output_time;
 };
 
 
@@ -301,6 +325,14 @@ static void gst_audio_encoder_get_property (GObject * object,
 
 static gboolean gst_audio_encoder_sink_activate_mode (GstPad * pad,
     GstObject * parent, GstPadMode mode, gboolean active);
+static gboolean gst_audio_encoder_src_activate_mode (GstPad * pad,
+    GstObject * parent, GstPadMode mode, gboolean active);
+static GstFlowReturn gst_audio_encoder_push_timed (GstAudioEncoder * enc,
+    GstBuffer * buf);
+static GstFlowReturn gst_audio_encoder_push_output (GstAudioEncoder * enc,
+    GstBuffer * buf);
+static GstFlowReturn gst_audio_encoder_output_queue_push (GstAudioEncoder *
+    enc, GstMiniObject * item);
 
 static GstCaps *gst_audio_encoder_getcaps_default (GstAudioEncoder * enc,
     GstCaps * filter);
@@ -379,6 +411,68 @@ gst_audio_encoder_class_init (GstAudioEncoderClass * klass)
           0, G_MAXINT64, DEFAULT_TOLERANCE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioEncoder:output-queue-max-buffers:
+   *
+   * If not 0, encoded buffers are pushed downstream from a separate thread,
+   * queueing up to this many buffers, so that encoding the next frames
+   * overlaps with pushing the previous ones.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+      g_param_spec_uint ("output-queue-max-buffers",
+          "Output queue max buffers",
+          "Number of buffers to queue for pushing from a separate thread "
+          "(0 = push from the encoding thread)", 0, G_MAXUINT,
+          DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioEncoder:output-queue-max-time:
+   *
+   * If not 0, encoded buffers are pushed downstream from a separate thread,
+   * queueing buffers up to this duration. Combined with
+   * #GstAudioEncoder:output-queue-max-buffers, whichever limit is hit first
+   * applies.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_QUEUE_MAX_TIME,
+      g_param_spec_uint64 ("output-queue-max-time",
+          "Output queue max time",
+          "Duration of buffers to queue for pushing from a separate thread, "
+          "in nanoseconds (0 = push from the encoding thread)", 0,
+          G_MAXUINT64, DEFAULT_OUTPUT_QUEUE_MAX_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioEncoder:stats:
+   *
+   * Various statistics, reset when going to PAUSED. This property returns
+   * a #GstStructure with name `application/x-gst-audio-encoder-stats` with
+   * the following fields:
+   *
+   * - "encode-time" G_TYPE_UINT64: total time spent in handle_frame, not
+   *   counting the time spent pushing buffers from it
+   * - "push-time" G_TYPE_UINT64: total time spent pushing buffers downstream
+   * - "encoded" G_TYPE_UINT64: the number of times handle_frame was called
+   * - "pushed" G_TYPE_UINT64: the number of buffers pushed downstream
+   * - "encode-time-max" G_TYPE_UINT64: the longest single handle_frame call
+   * - "encode-time-histogram" GST_TYPE_ARRAY of G_TYPE_UINT64: entry n
+   *   counts the handle_frame calls that took less than 2^(n+1)
+   *   microseconds, the last entry also counts all slower calls
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Encoding and output statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_audio_encoder_change_state);
 
@@ -428,6 +522,8 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
       GST_DEBUG_FUNCPTR (gst_audio_encoder_src_event));
   gst_pad_set_query_function (enc->srcpad,
       GST_DEBUG_FUNCPTR (gst_audio_encoder_src_query));
+  gst_pad_set_activatemode_function (enc->srcpad,
+      GST_DEBUG_FUNCPTR (gst_audio_encoder_src_activate_mode));
   gst_pad_use_fixed_caps (enc->srcpad);
   gst_element_add_pad (GST_ELEMENT (enc), enc->srcpad);
   GST_DEBUG_OBJECT (enc, "src created");
@@ -436,6 +532,10 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
 
   g_rec_mutex_init (&enc->stream_lock);
 
+  gst_output_queue_init (&enc->priv->output_queue, GST_OBJECT (enc),
+      enc->srcpad, (GstOutputQueuePushFunc) gst_audio_encoder_push_timed,
+      GST_CAT_DEFAULT);
+
   /* property default */
   enc->priv->granule = DEFAULT_GRANULE;
   enc->priv->perfect_ts = DEFAULT_PERFECT_TS;
@@ -443,6 +543,8 @@ gst_audio_encoder_init (GstAudioEncoder * enc, GstAudioEncoderClass * bclass)
   enc->priv->tolerance = DEFAULT_TOLERANCE;
   enc->priv->hard_min = DEFAULT_HARD_MIN;
   enc->priv->drainable = DEFAULT_DRAINABLE;
+  enc->priv->output_queue_max_buffers = DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS;
+  enc->priv->output_queue_max_time = DEFAULT_OUTPUT_QUEUE_MAX_TIME;
 
   /* init state */
   enc->priv->ctx.min_latency = 0;
@@ -473,6 +575,10 @@ gst_audio_encoder_reset (GstAudioEncoder * enc, gboolean full)
     if (enc->priv->ctx.allocator)
       gst_object_unref (enc->priv->ctx.allocator);
     enc->priv->ctx.allocator = NULL;
+    if (enc->priv->ctx.pool) {
+      gst_buffer_pool_set_active (enc->priv->ctx.pool, FALSE);
+      gst_object_unref (enc->priv->ctx.pool);
+    }
 
     GST_OBJECT_LOCK (enc);
     gst_caps_replace (&enc->priv->ctx.input_caps, NULL);
@@ -521,6 +627,7 @@ gst_audio_encoder_finalize (GObject * object)
   g_object_unref (enc->priv->adapter);
 
   g_rec_mutex_clear (&enc->stream_lock);
+  gst_output_queue_clear (&enc->priv->output_queue);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -538,6 +645,17 @@ gst_audio_encoder_change_state (GstElement * element, GstStateChange transition)
         if (!klass->open (enc))
           goto open_failed;
       }
+      break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      GST_OBJECT_LOCK (enc);
+      enc->priv->output_queue_active =
+          enc->priv->output_queue_max_buffers != 0
+          || enc->priv->output_queue_max_time != 0;
+      gst_processing_stats_reset (&enc->priv->encode_stats);
+      enc->priv->push_time = 0;
+      enc->priv->buffers_pushed = 0;
+      GST_OBJECT_UNLOCK (enc);
+      break;
     default:
       break;
   }
@@ -588,6 +706,15 @@ gst_audio_encoder_push_event (GstAudioEncoder * enc, GstEvent * event)
       break;
   }
 
+  /* keep serialized events in order with the queued buffers */
+  if (enc->priv->output_queue_active && GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    GST_DEBUG_OBJECT (enc, "queueing event %s", GST_EVENT_TYPE_NAME (event));
+
+    return gst_audio_encoder_output_queue_push (enc,
+        GST_MINI_OBJECT_CAST (event)) != GST_FLOW_FLUSHING;
+  }
+
   return gst_pad_push_event (enc->srcpad, event);
 }
 
@@ -902,7 +1029,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
         priv->bytes_out += size;
         GST_OBJECT_UNLOCK (enc);
 
-        ret = gst_pad_push (enc->srcpad, tmpbuf);
+        ret = gst_audio_encoder_push_output (enc, tmpbuf);
         if (ret != GST_FLOW_OK) {
           GST_WARNING_OBJECT (enc, "pushing header returned %s",
               gst_flow_get_name (ret));
@@ -996,7 +1123,7 @@ gst_audio_encoder_finish_frame (GstAudioEncoder * enc, GstBuffer * buf,
         GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf)),
         GST_TIME_ARGS (GST_BUFFER_DURATION (buf)));
 
-    ret = gst_pad_push (enc->srcpad, buf);
+    ret = gst_audio_encoder_push_output (enc, buf);
     GST_LOG_OBJECT (enc, "buffer pushed: %s", gst_flow_get_name (ret));
   } else {
     /* merely advance samples, most work for that already done above */
@@ -1034,6 +1161,89 @@ overflow:
   }
 }
 
+/* pushes @buf downstream, accounting for the time it took */
+static GstFlowReturn
+gst_audio_encoder_push_timed (GstAudioEncoder * enc, GstBuffer * buf)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+  GstClockTime start, elapsed;
+  GstFlowReturn ret;
+
+  start = gst_util_get_timestamp ();
+  ret = gst_pad_push (enc->srcpad, buf);
+  elapsed = gst_util_get_timestamp () - start;
+
+  GST_OBJECT_LOCK (enc);
+  priv->push_time += elapsed;
+  priv->buffers_pushed++;
+  GST_OBJECT_UNLOCK (enc);
+
+  return ret;
+}
+
+/* pushes @buf downstream, or queues it for the output task */
+static GstFlowReturn
+gst_audio_encoder_push_output (GstAudioEncoder * enc, GstBuffer * buf)
+{
+  GstClockTime start;
+  GstFlowReturn ret;
+
+  start = gst_util_get_timestamp ();
+  if (enc->priv->output_queue_active)
+    ret = gst_audio_encoder_output_queue_push (enc,
+        GST_MINI_OBJECT_CAST (buf));
+  else
+    ret = gst_audio_encoder_push_timed (enc, buf);
+  enc->priv->output_time += gst_util_get_timestamp () - start;
+
+  return ret;
+}
+
+static void
+gst_audio_encoder_update_encode_time (GstAudioEncoder * enc,
+    GstClockTime elapsed)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+
+  GST_OBJECT_LOCK (enc);
+  gst_processing_stats_add (&priv->encode_stats, elapsed);
+  GST_OBJECT_UNLOCK (enc);
+}
+
+static GstFlowReturn
+gst_audio_encoder_output_queue_push (GstAudioEncoder * enc,
+    GstMiniObject * item)
+{
+  GstAudioEncoderPrivate *priv = enc->priv;
+  guint max_buffers;
+  GstClockTime max_time;
+
+  GST_OBJECT_LOCK (enc);
+  max_buffers = priv->output_queue_max_buffers;
+  max_time = priv->output_queue_max_time;
+  GST_OBJECT_UNLOCK (enc);
+
+  return gst_output_queue_push (&priv->output_queue, item, max_buffers,
+      max_time);
+}
+
+static gboolean
+gst_audio_encoder_src_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstAudioEncoder *enc = GST_AUDIO_ENCODER (parent);
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  if (active)
+    gst_output_queue_set_flushing (&enc->priv->output_queue, FALSE);
+  else
+    gst_output_queue_stop (&enc->priv->output_queue);
+
+  return TRUE;
+}
+
  /* adapter tracking idea:
   * - start of adapter corresponds with what has already been encoded
   * (i.e. really returned by encoder subclass)
@@ -1124,7 +1334,16 @@ gst_audio_encoder_push_buffers (GstAudioEncoder * enc, gboolean force)
       GST_DEBUG_OBJECT (enc, "bypassing subclass with leftover");
       ret = gst_audio_encoder_finish_frame (enc, NULL, -1);
     } else {
+      GstClockTime start, output_time, elapsed;
+
+      output_time = priv->output_time;
+      start = gst_util_get_timestamp ();
       ret = klass->handle_frame (enc, buf);
+      /* don't account for buffers finished and pushed from handle_frame */
+      elapsed = gst_util_get_timestamp () - start;
+      elapsed -= MIN (elapsed, priv->output_time - output_time);
+
+      gst_audio_encoder_update_encode_time (enc, elapsed);
     }
 
     if (G_LIKELY (buf)) {
@@ -1705,6 +1924,11 @@ gst_audio_encoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (enc, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* unblock the streaming thread if it waits for room in the output queue */
+  if (enc->priv->output_queue_active
+      && GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+    gst_output_queue_set_flushing (&enc->priv->output_queue, TRUE);
+
   if (klass->sink_event)
     ret = klass->sink_event (enc, event);
   else {
@@ -1712,6 +1936,15 @@ gst_audio_encoder_sink_event (GstPad * pad, GstObject * parent,
     ret = FALSE;
   }
 
+  /* FLUSH_START is forwarded now, so the output task can't be blocked
+   * downstream anymore */
+  if (enc->priv->output_queue_active) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+      gst_pad_pause_task (enc->srcpad);
+    else if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+      gst_output_queue_set_flushing (&enc->priv->output_queue, FALSE);
+  }
+
   GST_DEBUG_OBJECT (enc, "event result %d", ret);
 
   return ret;
@@ -1843,6 +2076,10 @@ gst_audio_encoder_decide_allocation_default (GstAudioEncoder * enc,
   GstAllocator *allocator = NULL;
   GstAllocationParams params;
   gboolean update_allocator;
+  GstBufferPool *pool = NULL;
+  guint size, min, max;
+  gboolean update_pool;
+  GstCaps *caps;
 
   /* we got configuration from our peer or the decide_allocation method,
    * parse them */
@@ -1856,6 +2093,40 @@ gst_audio_encoder_decide_allocation_default (GstAudioEncoder * enc,
     update_allocator = FALSE;
   }
 
+  if (gst_query_get_n_allocation_pools (query) > 0) {
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, &size, &min, &max);
+    update_pool = TRUE;
+  } else {
+    pool = NULL;
+    size = min = max = 0;
+    update_pool = FALSE;
+  }
+
+  if (pool == NULL) {
+    /* no pool, we can make our own; frame sizes are only known once
+     * encoding starts, so it gets configured by the first output buffer */
+    GST_DEBUG_OBJECT (enc, "no pool, making new pool");
+    pool = gst_buffer_pool_new ();
+    size = min = max = 0;
+  }
+
+  if (size > 0) {
+    GstStructure *config;
+
+    gst_query_parse_allocation (query, &caps, NULL);
+
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, caps, size, min, max);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_DEBUG_OBJECT (enc, "failed to configure downstream pool, "
+          "making new pool");
+      gst_object_unref (pool);
+      pool = gst_buffer_pool_new ();
+      size = 0;
+    }
+  }
+
   if (update_allocator)
     gst_query_set_nth_allocation_param (query, 0, allocator, &params);
   else
@@ -1863,6 +2134,12 @@ gst_audio_encoder_decide_allocation_default (GstAudioEncoder * enc,
   if (allocator)
     gst_object_unref (allocator);
 
+  if (update_pool)
+    gst_query_set_nth_allocation_pool (query, 0, pool, size, min, max);
+  else
+    gst_query_add_allocation_pool (query, pool, size, min, max);
+  gst_object_unref (pool);
+
   return TRUE;
 }
 
@@ -2042,6 +2319,16 @@ gst_audio_encoder_set_property (GObject * object, guint prop_id,
     case PROP_TOLERANCE:
       enc->priv->tolerance = g_value_get_int64 (value);
       break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (enc);
+      enc->priv->output_queue_max_buffers = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (enc);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (enc);
+      enc->priv->output_queue_max_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (enc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2069,6 +2356,31 @@ gst_audio_encoder_get_property (GObject * object, guint prop_id,
     case PROP_TOLERANCE:
       g_value_set_int64 (value, enc->priv->tolerance);
       break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (enc);
+      g_value_set_uint (value, enc->priv->output_queue_max_buffers);
+      GST_OBJECT_UNLOCK (enc);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (enc);
+      g_value_set_uint64 (value, enc->priv->output_queue_max_time);
+      GST_OBJECT_UNLOCK (enc);
+      break;
+    case PROP_STATS:{
+      GstAudioEncoderPrivate *priv = enc->priv;
+      GstStructure *s;
+
+      GST_OBJECT_LOCK (enc);
+      s = gst_structure_new ("application/x-gst-audio-encoder-stats",
+          "push-time", G_TYPE_UINT64, priv->push_time,
+          "pushed", G_TYPE_UINT64, priv->buffers_pushed, NULL);
+      gst_processing_stats_set_fields (&priv->encode_stats, s, "encode",
+          "encoded");
+      GST_OBJECT_UNLOCK (enc);
+
+      g_value_take_boxed (value, s);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2703,6 +3015,7 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
   GstQuery *query = NULL;
   GstAllocator *allocator;
   GstAllocationParams params;
+  GstBufferPool *pool;
   GstCaps *caps, *prevcaps;
 
   g_return_val_if_fail (GST_IS_AUDIO_ENCODER (enc), FALSE);
@@ -2737,6 +3050,11 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
     }
   }
 
+  /* caps are set directly on the pad, after everything still queued for
+   * output with the previous caps */
+  if (enc->priv->output_queue_active)
+    gst_output_queue_drain (&enc->priv->output_queue);
+
   prevcaps = gst_pad_get_current_caps (enc->srcpad);
   if (!prevcaps || !gst_caps_is_equal (prevcaps, caps))
     res = gst_pad_set_caps (enc->srcpad, caps);
@@ -2775,6 +3093,29 @@ gst_audio_encoder_negotiate_default (GstAudioEncoder * enc)
   enc->priv->ctx.allocator = allocator;
   enc->priv->ctx.params = params;
 
+  if (gst_query_get_n_allocation_pools (query) > 0)
+    gst_query_parse_nth_allocation_pool (query, 0, &pool, NULL, NULL, NULL);
+  else
+    pool = NULL;
+
+  if (enc->priv->ctx.pool) {
+    gst_buffer_pool_set_active (enc->priv->ctx.pool, FALSE);
+    gst_object_unref (enc->priv->ctx.pool);
+  }
+  enc->priv->ctx.pool = pool;
+  enc->priv->ctx.pool_size = 0;
+
+  if (pool) {
+    GstStructure *config;
+    guint size;
+
+    /* a pool left unconfigured is sized by the first output buffer */
+    config = gst_buffer_pool_get_config (pool);
+    if (gst_buffer_pool_config_get_params (config, NULL, &size, NULL, NULL))
+      enc->priv->ctx.pool_size = size;
+    gst_structure_free (config);
+  }
+
 done:
   if (query)
     gst_query_unref (query);
@@ -2879,6 +3220,58 @@ refuse_caps:
   }
 }
 
+/* Make sure ctx.pool hands out buffers of at least @size bytes. A pool
+ * that is too small is replaced by a larger one rather than reconfigured,
+ * as buffers of the old one may still be around downstream. A pool that
+ * was never configured is set up in place */
+static gboolean
+gst_audio_encoder_ensure_pool (GstAudioEncoder * enc, gsize size)
+{
+  GstAudioEncoderContext *ctx = &enc->priv->ctx;
+
+  if (size > ctx->pool_size) {
+    GstBufferPool *pool;
+    GstStructure *config;
+    gsize pool_size;
+
+    /* leave some room so that slowly growing frames don't cause a new pool
+     * for every buffer */
+    pool_size = MAX (size, ctx->pool_size + ctx->pool_size / 2);
+
+    if (ctx->pool_size == 0 && !gst_buffer_pool_is_active (ctx->pool))
+      pool = gst_object_ref (ctx->pool);
+    else
+      pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, ctx->caps, pool_size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, ctx->allocator,
+        &ctx->params);
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_INFO_OBJECT (enc, "failed to configure pool of %" G_GSIZE_FORMAT
+          " bytes", pool_size);
+      gst_object_unref (pool);
+      return FALSE;
+    }
+
+    GST_DEBUG_OBJECT (enc, "new output pool of %" G_GSIZE_FORMAT " bytes",
+        pool_size);
+
+    if (pool != ctx->pool)
+      gst_buffer_pool_set_active (ctx->pool, FALSE);
+    gst_object_unref (ctx->pool);
+    ctx->pool = pool;
+    ctx->pool_size = pool_size;
+  }
+
+  if (!gst_buffer_pool_is_active (ctx->pool)
+      && !gst_buffer_pool_set_active (ctx->pool, TRUE)) {
+    GST_INFO_OBJECT (enc, "failed to activate output pool");
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_audio_encoder_allocate_output_buffer:
  * @enc: a #GstAudioEncoder
@@ -2911,6 +3304,17 @@ gst_audio_encoder_allocate_output_buffer (GstAudioEncoder * enc, gsize size)
     }
   }
 
+  /* pool buffers are all the same size, smaller frames only use the
+   * start of one */
+  if (enc->priv->ctx.pool && gst_audio_encoder_ensure_pool (enc, size)
+      && gst_buffer_pool_acquire_buffer (enc->priv->ctx.pool, &buffer,
+          NULL) == GST_FLOW_OK) {
+    gst_buffer_resize (buffer, 0, size);
+    GST_AUDIO_ENCODER_STREAM_UNLOCK (enc);
+
+    return buffer;
+  }
+
   buffer =
       gst_buffer_new_allocate (enc->priv->ctx.allocator, size,
       &enc->priv->ctx.params);
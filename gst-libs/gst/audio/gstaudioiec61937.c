@@ -345,10 +345,19 @@ gst_audio_iec61937_payload (const guint8 * src, guint src_n, guint8 * dst,
     memcpy (dst + i, src, src_n);
   } else {
     /* Byte-swapped again */
-    /* FIXME: orc-ify this */
-    for (tmp = 1; tmp < src_n; tmp += 2) {
-      dst[i + tmp - 1] = src[tmp];
-      dst[i + tmp] = src[tmp - 1];
+    if (((guintptr) src) % 2 == 0 && ((guintptr) (dst + i)) % 2 == 0) {
+      const guint16 *s16 = (const guint16 *) src;
+      guint16 *d16 = (guint16 *) (dst + i);
+      guint n = src_n / 2;
+
+      /* swap whole words, the compiler can vectorise this */
+      for (tmp = 0; tmp < n; tmp++)
+        d16[tmp] = GUINT16_SWAP_LE_BE (s16[tmp]);
+    } else {
+      for (tmp = 1; tmp < src_n; tmp += 2) {
+        dst[i + tmp - 1] = src[tmp];
+        dst[i + tmp] = src[tmp - 1];
+      }
     }
     /* Do we have 1 byte remaining? */
     if (src_n % 2) {
@@ -1335,10 +1335,12 @@ gst_audio_ring_buffer_clear_all (GstAudioRingBuffer * buf)
 }
 
 
+/* Wait until the device has processed a segment after the caller saw
+ * @segments in segdone. The lock is only taken when we really have to
+ * sleep, the device thread only takes it to wake us up */
 static gboolean
-wait_segment (GstAudioRingBuffer * buf)
+wait_segment (GstAudioRingBuffer * buf, gint segments)
 {
-  gint segments;
   gboolean wait = TRUE;
 
   /* buffer must be started now or we deadlock since nobody is reading */
@@ -1349,15 +1351,18 @@ wait_segment (GstAudioRingBuffer * buf)
       goto no_start;
 
     GST_DEBUG_OBJECT (buf, "start!");
-    segments = g_atomic_int_get (&buf->segdone);
     gst_audio_ring_buffer_start (buf);
-
-    /* After starting, the writer may have wrote segments already and then we
-     * don't need to wait anymore */
-    if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
-      wait = FALSE;
   }
 
+  /* The device may have processed segments since the caller checked, or
+   * after starting, and then we don't need to wait anymore */
+  if (G_LIKELY (g_atomic_int_get (&buf->segdone) != segments))
+    wait = FALSE;
+
+  if (!wait && G_LIKELY (g_atomic_int_get (&buf->state) ==
+          GST_AUDIO_RING_BUFFER_STATE_STARTED))
+    return TRUE;
+
   /* take lock first, then update our waiting flag */
   GST_OBJECT_LOCK (buf);
   if (G_UNLIKELY (buf->flushing))
@@ -1369,6 +1374,15 @@ wait_segment (GstAudioRingBuffer * buf)
 
   if (G_LIKELY (wait)) {
     if (g_atomic_int_compare_and_exchange (&buf->waiting, 0, 1)) {
+      /* check again now that the flag is set, an advance that happened
+       * before it would not signal us and we'd sleep for a whole segment
+       * too long */
+      if (G_UNLIKELY (g_atomic_int_get (&buf->segdone) != segments)) {
+        g_atomic_int_compare_and_exchange (&buf->waiting, 1, 0);
+        GST_OBJECT_UNLOCK (buf);
+        return TRUE;
+      }
+
       GST_DEBUG_OBJECT (buf, "waiting..");
       GST_AUDIO_RING_BUFFER_WAIT (buf);
 
@@ -1597,7 +1611,7 @@ default_commit (GstAudioRingBuffer * buf, guint64 * sample,
       }
 
       /* else we need to wait for the segment to become writable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -1813,7 +1827,7 @@ gst_audio_ring_buffer_read (GstAudioRingBuffer * buf, guint64 sample,
         break;
 
       /* else we need to wait for the segment to become readable. */
-      if (!wait_segment (buf))
+      if (!wait_segment (buf, segdone + buf->segbase))
         goto not_started;
     }
 
@@ -67,6 +67,14 @@ struct _GstFFTF32
   void *cfg;
   gboolean inverse;
   gint len;
+
+  /* coefficients of the last window function applied, computed on first
+   * use so applying it again is a plain multiplication */
+  GstFFTWindow window;
+  gfloat *window_data;
+
+  /* one transform worth of deinterleaved samples */
+  gfloat *scratch;
 };
 
 /**
@@ -170,9 +178,65 @@ gst_fft_f32_inverse_fft (GstFFTF32 * self, const GstFFTF32Complex * freqdata,
 void
 gst_fft_f32_free (GstFFTF32 * self)
 {
+  g_free (self->window_data);
+  g_free (self->scratch);
   g_free (self);
 }
 
+/**
+ * gst_fft_f32_fft_interleaved:
+ * @self: #GstFFTF32 instance for this call
+ * @timedata: Buffer of the interleaved samples in the time domain
+ * @n_channels: Number of interleaved channels in @timedata
+ * @freqdata: Target buffer for the samples in the frequency domain
+ *
+ * This performs the FFT on each of the @n_channels interleaved channels of
+ * @timedata, for example an audio buffer, and puts the results one after
+ * the other in @freqdata. This avoids deinterleaving the samples and calling
+ * gst_fft_f32_fft() for each channel.
+ *
+ * @timedata must have @len * @n_channels samples, where @len is the
+ * parameter specified while allocating the #GstFFTF32 instance with
+ * gst_fft_f32_new(). For non-interleaved frames, just call gst_fft_f32_fft()
+ * on each of them.
+ *
+ * @freqdata must be large enough to hold @n_channels * (@len/2 + 1)
+ * #GstFFTF32Complex frequency domain samples. The result for channel c
+ * starts at @freqdata + c * (@len/2 + 1).
+ *
+ * Since: 1.18
+ */
+void
+gst_fft_f32_fft_interleaved (GstFFTF32 * self, const gfloat * timedata,
+    gint n_channels, GstFFTF32Complex * freqdata)
+{
+  gint c, i, len;
+
+  g_return_if_fail (self);
+  g_return_if_fail (!self->inverse);
+  g_return_if_fail (timedata);
+  g_return_if_fail (n_channels > 0);
+  g_return_if_fail (freqdata);
+
+  len = self->len;
+
+  if (n_channels == 1) {
+    kiss_fftr_f32 (self->cfg, timedata, (kiss_fft_f32_cpx *) freqdata);
+    return;
+  }
+
+  if (self->scratch == NULL)
+    self->scratch = g_new (gfloat, len);
+
+  for (c = 0; c < n_channels; c++) {
+    for (i = 0; i < len; i++)
+      self->scratch[i] = timedata[i * n_channels + c];
+
+    kiss_fftr_f32 (self->cfg, self->scratch,
+        (kiss_fft_f32_cpx *) freqdata + c * (len / 2 + 1));
+  }
+}
+
 /**
  * gst_fft_f32_window:
  * @self: #GstFFTF32 instance for this call
@@ -186,35 +250,48 @@ void
 gst_fft_f32_window (GstFFTF32 * self, gfloat * timedata, GstFFTWindow window)
 {
   gint i, len;
+  gfloat *w;
 
   g_return_if_fail (self);
   g_return_if_fail (timedata);
 
+  if (window == GST_FFT_WINDOW_RECTANGULAR)
+    return;
+
   len = self->len;
 
-  switch (window) {
-    case GST_FFT_WINDOW_RECTANGULAR:
-      /* do nothing */
-      break;
-    case GST_FFT_WINDOW_HAMMING:
-      for (i = 0; i < len; i++)
-        timedata[i] *= (0.53836 - 0.46164 * cos (2.0 * G_PI * i / len));
-      break;
-    case GST_FFT_WINDOW_HANN:
-      for (i = 0; i < len; i++)
-        timedata[i] *= (0.5 - 0.5 * cos (2.0 * G_PI * i / len));
-      break;
-    case GST_FFT_WINDOW_BARTLETT:
-      for (i = 0; i < len; i++)
-        timedata[i] *= (1.0 - fabs ((2.0 * i - len) / len));
-      break;
-    case GST_FFT_WINDOW_BLACKMAN:
-      for (i = 0; i < len; i++)
-        timedata[i] *= (0.42 - 0.5 * cos ((2.0 * i) / len) +
-            0.08 * cos ((4.0 * i) / len));
-      break;
-    default:
-      g_assert_not_reached ();
-      break;
+  if (self->window_data == NULL || self->window != window) {
+    if (self->window_data == NULL)
+      self->window_data = g_new (gfloat, len);
+    w = self->window_data;
+
+    switch (window) {
+      case GST_FFT_WINDOW_HAMMING:
+        for (i = 0; i < len; i++)
+          w[i] = 0.53836 - 0.46164 * cos (2.0 * G_PI * i / len);
+        break;
+      case GST_FFT_WINDOW_HANN:
+        for (i = 0; i < len; i++)
+          w[i] = 0.5 - 0.5 * cos (2.0 * G_PI * i / len);
+        break;
+      case GST_FFT_WINDOW_BARTLETT:
+        for (i = 0; i < len; i++)
+          w[i] = 1.0 - fabs ((2.0 * i - len) / len);
+        break;
+      case GST_FFT_WINDOW_BLACKMAN:
+        for (i = 0; i < len; i++)
+          w[i] = 0.42 - 0.5 * cos ((2.0 * i) / len) +
+              0.08 * cos ((4.0 * i) / len);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+    self->window = window;
   }
+
+  /* no dependencies between iterations, the compiler vectorizes this */
+  w = self->window_data;
+  for (i = 0; i < len; i++)
+    timedata[i] *= w[i];
 }
@@ -66,6 +66,10 @@ void          gst_fft_f32_inverse_fft   (GstFFTF32 *self, const GstFFTF32Complex
 GST_FFT_API
 void          gst_fft_f32_window        (GstFFTF32 *self, gfloat *timedata, GstFFTWindow window);
 
+GST_FFT_API
+void          gst_fft_f32_fft_interleaved (GstFFTF32 *self, const gfloat *timedata,
+                                           gint n_channels, GstFFTF32Complex *freqdata);
+
 G_END_DECLS
 
 #endif /* __GST_FFT_F32_H__ */
@@ -372,3 +372,30 @@ GST_GL_EXT_BEGIN (bind_frag_data,
 GST_GL_EXT_FUNCTION (void, BindFragDataLocation,
                      (GLuint program, GLuint index, const GLchar * name))
 GST_GL_EXT_END ()
+
+GST_GL_EXT_BEGIN (get_program_binary,
+                  GST_GL_API_OPENGL | GST_GL_API_OPENGL3 |
+                  GST_GL_API_GLES2,
+                  4, 1,
+                  3, 0,
+                  "ARB:\0OES\0",
+                  "get_program_binary\0")
+GST_GL_EXT_FUNCTION (void, GetProgramBinary,
+                     (GLuint program, GLsizei bufSize, GLsizei * length,
+                      GLenum * binaryFormat, void * binary))
+GST_GL_EXT_FUNCTION (void, ProgramBinary,
+                     (GLuint program, GLenum binaryFormat, const void * binary,
+                      GLsizei length))
+GST_GL_EXT_END ()
+
+/* Not part of GL_OES_get_program_binary */
+GST_GL_EXT_BEGIN (program_parameter,
+                  GST_GL_API_OPENGL | GST_GL_API_OPENGL3 |
+                  GST_GL_API_GLES2,
+                  4, 1,
+                  3, 0,
+                  "ARB:\0",
+                  "get_program_binary\0")
+GST_GL_EXT_FUNCTION (void, ProgramParameteri,
+                     (GLuint program, GLenum pname, GLint value))
+GST_GL_EXT_END ()
@@ -96,6 +96,7 @@ typedef struct _GstGLBaseSrcPrivate GstGLBaseSrcPrivate;
 
 typedef struct _GstGLFilter GstGLFilter;
 typedef struct _GstGLFilterClass GstGLFilterClass;
+typedef struct _GstGLFilterPrivate GstGLFilterPrivate;
 
 typedef struct _GstGLViewConvert GstGLViewConvert;
 typedef struct _GstGLViewConvertClass GstGLViewConvertClass;
@@ -37,24 +37,46 @@
  * context.  It also provided some wrappers around #GstBaseTransform's
  * `start()`, `stop()` and `set_caps()` virtual methods that ensure an OpenGL
  * context is available and current in the calling thread.
+ *
+ * Since 1.18, setting #GstGLBaseFilter:gpu-timing measures the GPU time
+ * spent between a buffer entering and leaving the element with timestamp
+ * queries. The results are read back asynchronously, a few frames later,
+ * and are available in #GstGLBaseFilter:gpu-stats.
  */
 
 #define GST_CAT_DEFAULT gst_gl_base_filter_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+/* number of frames that can be in flight on the GPU while timing */
+#define GPU_TIMER_RING_SIZE 4
+
 struct _GstGLBaseFilterPrivate
 {
   GstGLContext *other_context;
 
   gboolean gl_result;
   gboolean gl_started;
+
+  /* GPU timing, the queries are only accessed from the GL thread and the
+   * statistics with the object lock */
+  gint gpu_timing;
+  GstGLQuery *gpu_queries[GPU_TIMER_RING_SIZE][2];
+  guint gpu_head;
+  guint gpu_n_pending;
+  gboolean gpu_started;
+  guint64 gpu_frames;
+  guint64 gpu_last;
+  guint64 gpu_total;
+  guint64 gpu_max;
 };
 
 /* Properties */
 enum
 {
   PROP_0,
-  PROP_CONTEXT
+  PROP_CONTEXT,
+  PROP_GPU_TIMING,
+  PROP_GPU_STATS
 };
 
 #define gst_gl_base_filter_parent_class parent_class
@@ -120,17 +142,170 @@ gst_gl_base_filter_class_init (GstGLBaseFilterClass * klass)
           "Get OpenGL context",
           GST_TYPE_GL_CONTEXT, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstGLBaseFilter:gpu-timing:
+   *
+   * Measure the GPU time spent on each buffer. Requires timestamp query
+   * support in the OpenGL implementation.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_GPU_TIMING,
+      g_param_spec_boolean ("gpu-timing", "GPU timing",
+          "Measure the GPU time spent on each buffer", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGLBaseFilter:gpu-stats:
+   *
+   * Statistics of the GPU time measurements, as a structure named
+   * `application/x-gl-gpu-stats` with the #guint64 fields `frames`, and
+   * `last`, `average` and `max` in nanoseconds.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_GPU_STATS,
+      g_param_spec_boxed ("gpu-stats", "GPU statistics",
+          "Statistics of the GPU time measurements", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   klass->supported_gl_api = GST_GL_API_ANY;
   klass->gl_start = gst_gl_base_filter_default_gl_start;
   klass->gl_stop = gst_gl_base_filter_default_gl_stop;
 }
 
+static gboolean
+_gpu_timing_supported (GstGLContext * context)
+{
+  return context->gl_vtable->QueryCounter != NULL
+      && context->gl_vtable->GetQueryObjectuiv != NULL;
+}
+
+/* read back the results of all the finished frames, oldest first */
+static void
+_gpu_timer_collect (GstGLBaseFilter * filter)
+{
+  GstGLBaseFilterPrivate *priv = filter->priv;
+
+  while (priv->gpu_n_pending > 0) {
+    guint idx = (priv->gpu_head + GPU_TIMER_RING_SIZE - priv->gpu_n_pending)
+        % GPU_TIMER_RING_SIZE;
+    guint64 start, end, elapsed;
+
+    if (!gst_gl_query_result_available (priv->gpu_queries[idx][1]))
+      break;
+
+    start = gst_gl_query_result (priv->gpu_queries[idx][0]);
+    end = gst_gl_query_result (priv->gpu_queries[idx][1]);
+    elapsed = end > start ? end - start : 0;
+    priv->gpu_n_pending--;
+
+    GST_LOG_OBJECT (filter, "frame took %" GST_TIME_FORMAT " on the GPU",
+        GST_TIME_ARGS (elapsed));
+
+    GST_OBJECT_LOCK (filter);
+    priv->gpu_frames++;
+    priv->gpu_last = elapsed;
+    priv->gpu_total += elapsed;
+    priv->gpu_max = MAX (priv->gpu_max, elapsed);
+    GST_OBJECT_UNLOCK (filter);
+  }
+}
+
+static void
+_gpu_timer_start (GstGLContext * context, GstGLBaseFilter * filter)
+{
+  GstGLBaseFilterPrivate *priv = filter->priv;
+  guint i;
+
+  if (!_gpu_timing_supported (context))
+    return;
+
+  if (!priv->gpu_queries[0][0]) {
+    for (i = 0; i < GPU_TIMER_RING_SIZE; i++) {
+      priv->gpu_queries[i][0] =
+          gst_gl_query_new (context, GST_GL_QUERY_TIMESTAMP);
+      priv->gpu_queries[i][1] =
+          gst_gl_query_new (context, GST_GL_QUERY_TIMESTAMP);
+    }
+  }
+
+  _gpu_timer_collect (filter);
+
+  /* never wait for the GPU, skip the frame if all the queries are busy */
+  if (priv->gpu_n_pending == GPU_TIMER_RING_SIZE) {
+    priv->gpu_started = FALSE;
+    return;
+  }
+
+  gst_gl_query_counter (priv->gpu_queries[priv->gpu_head][0]);
+  priv->gpu_started = TRUE;
+}
+
+static void
+_gpu_timer_end (GstGLContext * context, GstGLBaseFilter * filter)
+{
+  GstGLBaseFilterPrivate *priv = filter->priv;
+
+  if (!priv->gpu_started)
+    return;
+
+  gst_gl_query_counter (priv->gpu_queries[priv->gpu_head][1]);
+  priv->gpu_head = (priv->gpu_head + 1) % GPU_TIMER_RING_SIZE;
+  priv->gpu_n_pending++;
+  priv->gpu_started = FALSE;
+}
+
+static void
+_gpu_timer_free (GstGLBaseFilter * filter)
+{
+  GstGLBaseFilterPrivate *priv = filter->priv;
+  guint i;
+
+  for (i = 0; i < GPU_TIMER_RING_SIZE; i++) {
+    if (priv->gpu_queries[i][0]) {
+      gst_gl_query_free (priv->gpu_queries[i][0]);
+      gst_gl_query_free (priv->gpu_queries[i][1]);
+      priv->gpu_queries[i][0] = priv->gpu_queries[i][1] = NULL;
+    }
+  }
+  priv->gpu_head = 0;
+  priv->gpu_n_pending = 0;
+  priv->gpu_started = FALSE;
+}
+
+static GstPadProbeReturn
+_gpu_timer_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstGLBaseFilter * filter)
+{
+  if (!g_atomic_int_get (&filter->priv->gpu_timing) || !filter->context)
+    return GST_PAD_PROBE_OK;
+
+  if (GST_PAD_DIRECTION (pad) == GST_PAD_SINK)
+    gst_gl_context_thread_add (filter->context,
+        (GstGLContextThreadFunc) _gpu_timer_start, filter);
+  else
+    gst_gl_context_thread_add (filter->context,
+        (GstGLContextThreadFunc) _gpu_timer_end, filter);
+
+  return GST_PAD_PROBE_OK;
+}
+
 static void
 gst_gl_base_filter_init (GstGLBaseFilter * filter)
 {
-  gst_base_transform_set_qos_enabled (GST_BASE_TRANSFORM (filter), TRUE);
+  GstBaseTransform *trans = GST_BASE_TRANSFORM (filter);
+
+  gst_base_transform_set_qos_enabled (trans, TRUE);
 
   filter->priv = gst_gl_base_filter_get_instance_private (filter);
+
+  gst_pad_add_probe (GST_BASE_TRANSFORM_SINK_PAD (trans),
+      GST_PAD_PROBE_TYPE_BUFFER, (GstPadProbeCallback) _gpu_timer_probe,
+      filter, NULL);
+  gst_pad_add_probe (GST_BASE_TRANSFORM_SRC_PAD (trans),
+      GST_PAD_PROBE_TYPE_BUFFER, (GstPadProbeCallback) _gpu_timer_probe,
+      filter, NULL);
 }
 
 static void
@@ -148,7 +323,12 @@ static void
 gst_gl_base_filter_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
+  GstGLBaseFilter *filter = GST_GL_BASE_FILTER (object);
+
   switch (prop_id) {
+    case PROP_GPU_TIMING:
+      g_atomic_int_set (&filter->priv->gpu_timing, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -165,6 +345,22 @@ gst_gl_base_filter_get_property (GObject * object, guint prop_id,
     case PROP_CONTEXT:
       g_value_set_object (value, filter->context);
       break;
+    case PROP_GPU_TIMING:
+      g_value_set_boolean (value, g_atomic_int_get (&filter->priv->gpu_timing));
+      break;
+    case PROP_GPU_STATS:{
+      GstGLBaseFilterPrivate *priv = filter->priv;
+
+      GST_OBJECT_LOCK (filter);
+      g_value_take_boxed (value, gst_structure_new ("application/x-gl-gpu-stats",
+              "frames", G_TYPE_UINT64, priv->gpu_frames,
+              "last", G_TYPE_UINT64, priv->gpu_last,
+              "average", G_TYPE_UINT64, priv->gpu_frames ?
+              priv->gpu_total / priv->gpu_frames : (guint64) 0,
+              "max", G_TYPE_UINT64, priv->gpu_max, NULL));
+      GST_OBJECT_UNLOCK (filter);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -255,6 +451,15 @@ gst_gl_base_filter_reset (GstGLBaseFilter * filter)
 static gboolean
 gst_gl_base_filter_start (GstBaseTransform * bt)
 {
+  GstGLBaseFilter *filter = GST_GL_BASE_FILTER (bt);
+
+  GST_OBJECT_LOCK (filter);
+  filter->priv->gpu_frames = 0;
+  filter->priv->gpu_last = 0;
+  filter->priv->gpu_total = 0;
+  filter->priv->gpu_max = 0;
+  GST_OBJECT_UNLOCK (filter);
+
   return TRUE;
 }
 
@@ -304,6 +509,8 @@ gst_gl_base_filter_gl_stop (GstGLContext * context, gpointer data)
     filter_class->gl_stop (filter);
 
   filter->priv->gl_started = FALSE;
+
+  _gpu_timer_free (filter);
 }
 
 static void
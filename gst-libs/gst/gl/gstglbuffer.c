@@ -45,6 +45,13 @@
 /* Implementation notes:
  *
  * Currently does not take into account GLES2 differences (no mapbuffer)
+ *
+ * Buffers created with a GL_STREAM_* usage are transferred every frame.  When
+ * GL_ARB_buffer_storage is available they are allocated as immutable storage
+ * that is persistently and coherently mapped, and that mapping is used as the
+ * data pointer, removing the map/memcpy/unmap of every transfer.  A fence is
+ * placed after each GL access so that CPU access only waits for the GPU
+ * commands that actually touch this buffer.
  */
 
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
@@ -66,12 +73,100 @@
 #ifndef GL_COPY_WRITE_BUFFER
 #define GL_COPY_WRITE_BUFFER 0x8F37
 #endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_STREAM_COPY
+#define GL_STREAM_COPY 0x88E2
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
 
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_GL_BUFFER);
 #define GST_CAT_DEFUALT GST_CAT_GL_BUFFER
 
 static GstAllocator *_gl_buffer_allocator;
 
+/* GstGLBuffer with the state of persistently mapped buffers */
+typedef struct
+{
+  GstGLBuffer buffer;
+
+  /* the persistent mapping, also used as mem.data */
+  gpointer persistent_data;
+  /* signalled once the last GL access has completed */
+  GLsync fence;
+} GstGLBufferImpl;
+
+#define GST_GL_BUFFER_IMPL(mem) ((GstGLBufferImpl *) (mem))
+
+static gboolean
+_gl_buffer_create_persistent (GstGLBuffer * gl_mem)
+{
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (gl_mem);
+  const GstGLFuncs *gl = gl_mem->mem.context->gl_vtable;
+  GstMemory *mem = GST_MEMORY_CAST (gl_mem);
+  guint flags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+      | GL_MAP_COHERENT_BIT;
+
+  if (!gl->BufferStorage || !gl->MapBufferRange || !gl->FenceSync)
+    return FALSE;
+
+  if (gl_mem->usage_hints != GL_STREAM_DRAW
+      && gl_mem->usage_hints != GL_STREAM_READ
+      && gl_mem->usage_hints != GL_STREAM_COPY)
+    return FALSE;
+
+  gl->BufferStorage (gl_mem->target, mem->maxsize, NULL, flags);
+  impl->persistent_data =
+      gl->MapBufferRange (gl_mem->target, 0, mem->maxsize, flags);
+
+  if (!impl->persistent_data) {
+    GST_CAT_WARNING (GST_CAT_GL_BUFFER, "failed to persistently map buffer "
+        "%u", gl_mem->id);
+    goto fallback;
+  }
+
+  if (((guintptr) impl->persistent_data & mem->align) != 0) {
+    GST_CAT_DEBUG (GST_CAT_GL_BUFFER, "persistent mapping of buffer %u is not "
+        "aligned to %" G_GSIZE_FORMAT, gl_mem->id, mem->align + 1);
+    impl->persistent_data = NULL;
+    goto fallback;
+  }
+
+  gl_mem->mem.data = impl->persistent_data;
+
+  GST_CAT_DEBUG (GST_CAT_GL_BUFFER, "persistently mapped buffer %u at %p",
+      gl_mem->id, impl->persistent_data);
+
+  return TRUE;
+
+fallback:
+  /* the storage is immutable now, start over with a new buffer */
+  gl->BindBuffer (gl_mem->target, 0);
+  gl->DeleteBuffers (1, &gl_mem->id);
+  gl->GenBuffers (1, &gl_mem->id);
+  gl->BindBuffer (gl_mem->target, gl_mem->id);
+
+  return FALSE;
+}
+
 static gboolean
 _gl_buffer_create (GstGLBuffer * gl_mem, GError ** error)
 {
@@ -79,13 +174,45 @@ _gl_buffer_create (GstGLBuffer * gl_mem, GError ** error)
 
   gl->GenBuffers (1, &gl_mem->id);
   gl->BindBuffer (gl_mem->target, gl_mem->id);
-  gl->BufferData (gl_mem->target, gl_mem->mem.mem.maxsize, NULL,
-      gl_mem->usage_hints);
+  if (!_gl_buffer_create_persistent (gl_mem))
+    gl->BufferData (gl_mem->target, gl_mem->mem.mem.maxsize, NULL,
+        gl_mem->usage_hints);
   gl->BindBuffer (gl_mem->target, 0);
 
   return TRUE;
 }
 
+/* wait for the GL commands using the buffer before the CPU touches it */
+static void
+_gl_buffer_wait_fence (GstGLBuffer * gl_mem)
+{
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (gl_mem);
+  const GstGLFuncs *gl = gl_mem->mem.context->gl_vtable;
+  GLenum res;
+
+  if (!impl->fence)
+    return;
+
+  do {
+    res = gl->ClientWaitSync (impl->fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+        1000000000 /* 1s */ );
+  } while (res == GL_TIMEOUT_EXPIRED);
+
+  gl->DeleteSync (impl->fence);
+  impl->fence = NULL;
+}
+
+static void
+_gl_buffer_set_fence (GstGLBuffer * gl_mem)
+{
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (gl_mem);
+  const GstGLFuncs *gl = gl_mem->mem.context->gl_vtable;
+
+  if (impl->fence)
+    gl->DeleteSync (impl->fence);
+  impl->fence = gl->FenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
 struct create_data
 {
   GstGLBuffer *mem;
@@ -112,7 +239,7 @@ _gl_buffer_new (GstAllocator * allocator, GstMemory * parent,
     GstGLContext * context, guint gl_target, guint gl_usage,
     GstAllocationParams * params, gsize size)
 {
-  GstGLBuffer *ret = g_new0 (GstGLBuffer, 1);
+  GstGLBuffer *ret = (GstGLBuffer *) g_new0 (GstGLBufferImpl, 1);
   _gl_buffer_init (ret, allocator, parent, context, gl_target, gl_usage,
       params, size);
 
@@ -133,6 +260,12 @@ gst_gl_buffer_cpu_access (GstGLBuffer * mem, GstMapInfo * info, gsize size)
   GST_CAT_LOG (GST_CAT_GL_BUFFER, "mapping id %d size %" G_GSIZE_FORMAT,
       mem->id, size);
 
+  if (GST_GL_BUFFER_IMPL (mem)->persistent_data) {
+    /* coherent, the CPU only has to wait for the GPU to be done with it */
+    _gl_buffer_wait_fence (mem);
+    return ret;
+  }
+
   /* The extra data pointer indirection/memcpy is needed for coherent across
    * concurrent map()'s in both GL and CPU */
   if (GST_MEMORY_FLAG_IS_SET (mem, GST_GL_BASE_MEMORY_TRANSFER_NEED_DOWNLOAD)
@@ -175,6 +308,10 @@ gst_gl_buffer_upload_cpu_write (GstGLBuffer * mem, GstMapInfo * info,
     /* no data pointer has been written */
     return;
 
+  if (GST_GL_BUFFER_IMPL (mem)->persistent_data)
+    /* CPU writes are already visible to GL */
+    return;
+
   /* The extra data pointer indirection/memcpy is needed for coherent across
    * concurrent map()'s in both GL and CPU */
   /* FIXME: uploading potentially half-written data for libav pushing READWRITE
@@ -227,6 +364,9 @@ _gl_buffer_unmap (GstGLBuffer * mem, GstMapInfo * info)
 
   if ((info->flags & GST_MAP_GL) != 0) {
     gl->BindBuffer (mem->target, 0);
+
+    if (GST_GL_BUFFER_IMPL (mem)->persistent_data)
+      _gl_buffer_set_fence (mem);
   }
   /* XXX: optimistically transfer data */
 }
@@ -325,9 +465,17 @@ _gl_buffer_alloc (GstAllocator * allocator, gsize size,
 static void
 _gl_buffer_destroy (GstGLBuffer * mem)
 {
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (mem);
   const GstGLFuncs *gl = mem->mem.context->gl_vtable;
 
+  if (impl->fence)
+    gl->DeleteSync (impl->fence);
+  impl->fence = NULL;
+
+  /* deleting the buffer also removes the persistent mapping */
   gl->DeleteBuffers (1, &mem->id);
+  impl->persistent_data = NULL;
+  mem->mem.data = NULL;
 }
 
 static void
@@ -42,6 +42,12 @@
  * %GST_BUFFER_POOL_OPTION_VIDEO_META, the VideoAligment buffer pool option
  * %GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT as well as the OpenGL specific
  * %GST_BUFFER_POOL_OPTION_GL_SYNC_META buffer pool option.
+ *
+ * Buffers freed when the pool is deactivated, for example to change its
+ * configuration, are kept around with their textures. They are reused when
+ * the pool is configured again with the same video layout and texture
+ * target, so a renegotiation which only changes the framerate or changes
+ * back to a previous size doesn't need to allocate new textures.
  */
 
 /* bufferpool */
@@ -52,8 +58,81 @@ struct _GstGLBufferPoolPrivate
   GstCaps *caps;
   gboolean add_videometa;
   gboolean add_glsyncmeta;
+
+  /* GstGLBufferPoolCached, protected by the object lock */
+  GQueue recycled;
 };
 
+/* the number of freed buffers kept for reuse after a reconfiguration */
+#define GL_BUFFER_POOL_RECYCLE_MAX 16
+
+typedef struct
+{
+  GstBuffer *buffer;
+  GstVideoInfo info;
+  GstGLTextureTarget target;
+  /* only used for pointer comparison */
+  gpointer allocator;
+} GstGLBufferPoolCached;
+
+/* the textures are only compatible if the memory layout is, the framerate
+ * and similar don't matter */
+static gboolean
+_video_layout_is_equal (const GstVideoInfo * a, const GstVideoInfo * b)
+{
+  gint i;
+
+  if (GST_VIDEO_INFO_FORMAT (a) != GST_VIDEO_INFO_FORMAT (b) ||
+      GST_VIDEO_INFO_WIDTH (a) != GST_VIDEO_INFO_WIDTH (b) ||
+      GST_VIDEO_INFO_HEIGHT (a) != GST_VIDEO_INFO_HEIGHT (b) ||
+      GST_VIDEO_INFO_SIZE (a) != GST_VIDEO_INFO_SIZE (b) ||
+      GST_VIDEO_INFO_VIEWS (a) != GST_VIDEO_INFO_VIEWS (b) ||
+      GST_VIDEO_INFO_MULTIVIEW_MODE (a) != GST_VIDEO_INFO_MULTIVIEW_MODE (b))
+    return FALSE;
+
+  for (i = 0; i < GST_VIDEO_INFO_N_PLANES (a); i++) {
+    if (GST_VIDEO_INFO_PLANE_STRIDE (a, i) !=
+        GST_VIDEO_INFO_PLANE_STRIDE (b, i) ||
+        GST_VIDEO_INFO_PLANE_OFFSET (a, i) !=
+        GST_VIDEO_INFO_PLANE_OFFSET (b, i))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+_cached_free (GstGLBufferPoolCached * cached)
+{
+  gst_buffer_unref (cached->buffer);
+  g_slice_free (GstGLBufferPoolCached, cached);
+}
+
+static GstBuffer *
+_take_recycled_buffer (GstGLBufferPool * glpool)
+{
+  GstGLBufferPoolPrivate *priv = glpool->priv;
+  GstBuffer *buf = NULL;
+  GList *l;
+
+  GST_OBJECT_LOCK (glpool);
+  for (l = priv->recycled.head; l; l = l->next) {
+    GstGLBufferPoolCached *cached = l->data;
+
+    if (cached->target == priv->gl_params->target &&
+        cached->allocator == (gpointer) priv->allocator &&
+        _video_layout_is_equal (&cached->info, priv->gl_params->v_info)) {
+      buf = gst_buffer_ref (cached->buffer);
+      _cached_free (cached);
+      g_queue_delete_link (&priv->recycled, l);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (glpool);
+
+  return buf;
+}
+
 static void gst_gl_buffer_pool_finalize (GObject * object);
 
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_GL_BUFFER_POOL);
@@ -273,6 +352,21 @@ gst_gl_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
   GstGLBufferPoolPrivate *priv = glpool->priv;
   GstBuffer *buf;
 
+  if ((buf = _take_recycled_buffer (glpool))) {
+    GstGLSyncMeta *sync_meta = gst_buffer_get_gl_sync_meta (buf);
+
+    GST_TRACE_OBJECT (pool, "reusing textures of buffer %p", buf);
+
+    /* the sync meta option might have changed */
+    if (priv->add_glsyncmeta && !sync_meta)
+      gst_buffer_add_gl_sync_meta (glpool->context, buf);
+    else if (!priv->add_glsyncmeta && sync_meta)
+      gst_buffer_remove_meta (buf, (GstMeta *) sync_meta);
+
+    *buffer = buf;
+    return GST_FLOW_OK;
+  }
+
   if (!(buf = gst_buffer_new ())) {
     goto no_buffer;
   }
@@ -301,6 +395,35 @@ mem_create_failed:
   }
 }
 
+static void
+gst_gl_buffer_pool_free_buffer (GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstGLBufferPool *glpool = GST_GL_BUFFER_POOL_CAST (pool);
+  GstGLBufferPoolPrivate *priv = glpool->priv;
+  GstGLBufferPoolCached *cached;
+
+  /* buffers with modified memory can't be reused */
+  if (!priv->gl_params || gst_buffer_n_memory (buffer) == 0 ||
+      GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_TAG_MEMORY) ||
+      !gst_is_gl_memory (gst_buffer_peek_memory (buffer, 0))) {
+    GST_BUFFER_POOL_CLASS (parent_class)->free_buffer (pool, buffer);
+    return;
+  }
+
+  /* keep the buffer and its textures for a later configuration */
+  cached = g_slice_new (GstGLBufferPoolCached);
+  cached->buffer = buffer;
+  cached->info = *priv->gl_params->v_info;
+  cached->target = priv->gl_params->target;
+  cached->allocator = priv->allocator;
+
+  GST_OBJECT_LOCK (glpool);
+  g_queue_push_head (&priv->recycled, cached);
+  while (priv->recycled.length > GL_BUFFER_POOL_RECYCLE_MAX)
+    _cached_free (g_queue_pop_tail (&priv->recycled));
+  GST_OBJECT_UNLOCK (glpool);
+}
+
 /**
  * gst_gl_buffer_pool_new:
  * @context: the #GstGLContext to use
@@ -333,6 +456,7 @@ gst_gl_buffer_pool_class_init (GstGLBufferPoolClass * klass)
   gstbufferpool_class->get_options = gst_gl_buffer_pool_get_options;
   gstbufferpool_class->set_config = gst_gl_buffer_pool_set_config;
   gstbufferpool_class->alloc_buffer = gst_gl_buffer_pool_alloc;
+  gstbufferpool_class->free_buffer = gst_gl_buffer_pool_free_buffer;
   gstbufferpool_class->start = gst_gl_buffer_pool_start;
 }
 
@@ -348,6 +472,7 @@ gst_gl_buffer_pool_init (GstGLBufferPool * pool)
   priv->caps = NULL;
   priv->add_videometa = TRUE;
   priv->add_glsyncmeta = FALSE;
+  g_queue_init (&priv->recycled);
 }
 
 static void
@@ -363,6 +488,9 @@ gst_gl_buffer_pool_finalize (GObject * object)
 
   G_OBJECT_CLASS (gst_gl_buffer_pool_parent_class)->finalize (object);
 
+  g_queue_foreach (&priv->recycled, (GFunc) _cached_free, NULL);
+  g_queue_clear (&priv->recycled);
+
   /* only release the context once all our memory have been deleted */
   if (pool->context) {
     gst_object_unref (pool->context);
@@ -1981,6 +1981,97 @@ _unbind_buffer (GstGLColorConvert * convert)
   gl->DisableVertexAttribArray (convert->priv->attr_texture);
 }
 
+/* Linked conversion shaders are shared between all the converters of a
+ * context, keyed by their sources. The cache only holds weak references so
+ * that shaders are released (in the GL thread) with the last converter
+ * using them. */
+struct ShaderCacheEntry
+{
+  GWeakRef shader;
+};
+
+static GMutex shader_cache_lock;
+
+static void
+_shader_cache_entry_free (struct ShaderCacheEntry *entry)
+{
+  g_weak_ref_clear (&entry->shader);
+  g_free (entry);
+}
+
+static GQuark
+_shader_cache_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (!quark)
+    quark = g_quark_from_static_string ("GstGLColorConvertShaderCache");
+
+  return quark;
+}
+
+static GHashTable *
+_get_shader_cache (GstGLContext * context)
+{
+  GHashTable *cache;
+
+  cache = g_object_get_qdata (G_OBJECT (context), _shader_cache_quark ());
+  if (!cache) {
+    cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) _shader_cache_entry_free);
+    g_object_set_qdata_full (G_OBJECT (context), _shader_cache_quark (), cache,
+        (GDestroyNotify) g_hash_table_unref);
+  }
+
+  return cache;
+}
+
+static GstGLShader *
+_shader_cache_lookup (GstGLContext * context, const gchar * key)
+{
+  struct ShaderCacheEntry *entry;
+  GstGLShader *shader = NULL;
+
+  g_mutex_lock (&shader_cache_lock);
+  entry = g_hash_table_lookup (_get_shader_cache (context), key);
+  if (entry)
+    shader = g_weak_ref_get (&entry->shader);
+  g_mutex_unlock (&shader_cache_lock);
+
+  return shader;
+}
+
+static void
+_shader_cache_insert (GstGLContext * context, const gchar * key,
+    GstGLShader * shader)
+{
+  struct ShaderCacheEntry *entry;
+  GHashTable *cache;
+  GHashTableIter iter;
+  gpointer value;
+
+  g_mutex_lock (&shader_cache_lock);
+  cache = _get_shader_cache (context);
+
+  /* drop the entries of the shaders that are gone meanwhile */
+  g_hash_table_iter_init (&iter, cache);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    GstGLShader *other;
+
+    entry = value;
+    other = g_weak_ref_get (&entry->shader);
+    if (other)
+      gst_object_unref (other);
+    else
+      g_hash_table_iter_remove (&iter);
+  }
+
+  entry = g_new0 (struct ShaderCacheEntry, 1);
+  g_weak_ref_init (&entry->shader, shader);
+  g_hash_table_insert (cache, g_strdup (key), entry);
+  g_mutex_unlock (&shader_cache_lock);
+}
+
 static GstGLShader *
 _create_shader (GstGLColorConvert * convert)
 {
@@ -1990,44 +2081,21 @@ _create_shader (GstGLColorConvert * convert)
   GstGLSLStage *stage;
   GstGLSLVersion version;
   GstGLSLProfile profile;
-  gchar *version_str, *tmp, *tmp1;
-  const gchar *strings[3];
+  gchar *version_str, *vert_prog, *tmp, *key;
+  const gchar *strings[2];
+  gint n_frag_data_locations = 0;
   GError *error = NULL;
   int i;
 
-  ret = gst_gl_shader_new (convert->context);
-
-  tmp =
+  vert_prog =
       _gst_glsl_mangle_shader (text_vertex_shader, GL_VERTEX_SHADER,
       info->templ->target, convert->priv->from_texture_target, convert->context,
       &version, &profile);
 
-  tmp1 = gst_glsl_version_profile_to_string (version, profile);
-  version_str = g_strdup_printf ("#version %s\n", tmp1);
-  g_free (tmp1);
-
-  strings[0] = version_str;
-  strings[1] = tmp;
-  if (!(stage = gst_glsl_stage_new_with_strings (convert->context,
-              GL_VERTEX_SHADER, version, profile, 2, strings))) {
-    GST_ERROR_OBJECT (convert, "Failed to create vertex stage");
-    g_free (version_str);
-    g_free (tmp);
-    gst_object_unref (ret);
-    return NULL;
-  }
+  tmp = gst_glsl_version_profile_to_string (version, profile);
+  version_str = g_strdup_printf ("#version %s\n", tmp);
   g_free (tmp);
 
-  if (!gst_gl_shader_compile_attach_stage (ret, stage, &error)) {
-    GST_ERROR_OBJECT (convert, "Failed to compile vertex shader %s",
-        error->message);
-    g_clear_error (&error);
-    g_free (version_str);
-    gst_object_unref (stage);
-    gst_object_unref (ret);
-    return NULL;
-  }
-
   if (info->templ->extensions)
     g_string_append (str, info->templ->extensions);
 
@@ -2063,15 +2131,12 @@ _create_shader (GstGLColorConvert * convert)
     if (info->out_n_textures > 1) {
       gint i;
 
-      for (i = 0; i < info->out_n_textures; i++) {
-        gchar *var_name = g_strdup_printf ("fragColor_%d", i);
-        g_string_append_printf (str, "out vec4 %s;\n", var_name);
-        gst_gl_shader_bind_frag_data_location (ret, i, var_name);
-        g_free (var_name);
-      }
+      for (i = 0; i < info->out_n_textures; i++)
+        g_string_append_printf (str, "out vec4 fragColor_%d;\n", i);
+      n_frag_data_locations = info->out_n_textures;
     } else {
       g_string_append (str, "out vec4 fragColor;\n");
-      gst_gl_shader_bind_frag_data_location (ret, 0, "fragColor");
+      n_frag_data_locations = 1;
     }
   }
 
@@ -2115,38 +2180,123 @@ _create_shader (GstGLColorConvert * convert)
       &version, &profile);
   g_free (tmp);
 
+  /* the frag data locations follow from the version and profile, which are
+   * part of the sources */
+  key = g_strconcat (version_str, vert_prog, "\n", info->frag_prog, NULL);
+  if ((ret = _shader_cache_lookup (convert->context, key))) {
+    GST_DEBUG_OBJECT (convert, "reusing conversion shader %" GST_PTR_FORMAT,
+        ret);
+    goto done;
+  }
+
+  ret = gst_gl_shader_new (convert->context);
+
+  strings[0] = version_str;
+  strings[1] = vert_prog;
+  if (!(stage = gst_glsl_stage_new_with_strings (convert->context,
+              GL_VERTEX_SHADER, version, profile, 2, strings))) {
+    GST_ERROR_OBJECT (convert, "Failed to create vertex stage");
+    goto error;
+  }
+
+  if (!gst_gl_shader_compile_attach_stage (ret, stage, &error)) {
+    GST_ERROR_OBJECT (convert, "Failed to compile vertex shader %s",
+        error->message);
+    gst_object_unref (stage);
+    goto error;
+  }
+
+  if (n_frag_data_locations == 1) {
+    gst_gl_shader_bind_frag_data_location (ret, 0, "fragColor");
+  } else {
+    for (i = 0; i < n_frag_data_locations; i++) {
+      gchar *var_name = g_strdup_printf ("fragColor_%d", i);
+      gst_gl_shader_bind_frag_data_location (ret, i, var_name);
+      g_free (var_name);
+    }
+  }
+
   strings[1] = info->frag_prog;
   if (!(stage = gst_glsl_stage_new_with_strings (convert->context,
               GL_FRAGMENT_SHADER, version, profile, 2, strings))) {
     GST_ERROR_OBJECT (convert, "Failed to create fragment stage");
-    g_free (info->frag_prog);
-    info->frag_prog = NULL;
-    g_free (version_str);
-    gst_object_unref (ret);
-    return NULL;
+    goto error;
   }
-  g_free (version_str);
   if (!gst_gl_shader_compile_attach_stage (ret, stage, &error)) {
     GST_ERROR_OBJECT (convert, "Failed to compile fragment shader %s",
         error->message);
-    g_clear_error (&error);
-    g_free (info->frag_prog);
-    info->frag_prog = NULL;
     gst_object_unref (stage);
-    gst_object_unref (ret);
-    return NULL;
+    goto error;
   }
 
   if (!gst_gl_shader_link (ret, &error)) {
     GST_ERROR_OBJECT (convert, "Failed to link shader %s", error->message);
-    g_clear_error (&error);
-    g_free (info->frag_prog);
-    info->frag_prog = NULL;
-    gst_object_unref (ret);
-    return NULL;
+    goto error;
   }
 
+  _shader_cache_insert (convert->context, key, ret);
+
+done:
+  g_free (key);
+  g_free (vert_prog);
+  g_free (version_str);
+
   return ret;
+
+error:
+  g_clear_error (&error);
+  g_free (info->frag_prog);
+  info->frag_prog = NULL;
+  gst_object_unref (ret);
+  ret = NULL;
+  goto done;
+}
+
+/* The shader may be shared with other converters, so everything specific to
+ * this converter is set right before drawing */
+static void
+_set_uniforms (GstGLColorConvert * convert)
+{
+  struct ConvertInfo *info = &convert->priv->convert_info;
+  gint i;
+
+  if (info->cms_offset && info->cms_coeff1
+      && info->cms_coeff2 && info->cms_coeff3) {
+    gst_gl_shader_set_uniform_3fv (convert->shader, "offset", 1,
+        info->cms_offset);
+    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff1", 1,
+        info->cms_coeff1);
+    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff2", 1,
+        info->cms_coeff2);
+    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff3", 1,
+        info->cms_coeff3);
+  }
+
+  for (i = info->in_n_textures; i >= 0; i--) {
+    if (info->shader_tex_names[i])
+      gst_gl_shader_set_uniform_1i (convert->shader, info->shader_tex_names[i],
+          i);
+  }
+
+  gst_gl_shader_set_uniform_1f (convert->shader, "width",
+      GST_VIDEO_INFO_WIDTH (&convert->in_info));
+  gst_gl_shader_set_uniform_1f (convert->shader, "height",
+      GST_VIDEO_INFO_HEIGHT (&convert->in_info));
+
+  if (convert->priv->from_texture_target == GST_GL_TEXTURE_TARGET_RECTANGLE) {
+    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_x", 1.);
+    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_y", 1.);
+  } else {
+    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_x",
+        1. / (gfloat) GST_VIDEO_INFO_WIDTH (&convert->in_info));
+    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_y",
+        1. / (gfloat) GST_VIDEO_INFO_HEIGHT (&convert->in_info));
+  }
+
+  if (info->chroma_sampling[0] > 0.0f && info->chroma_sampling[1] > 0.0f) {
+    gst_gl_shader_set_uniform_2fv (convert->shader, "chroma_sampling", 1,
+        info->chroma_sampling);
+  }
 }
 
 /* Called in the gl thread */
@@ -2155,7 +2305,6 @@ _init_convert (GstGLColorConvert * convert)
 {
   GstGLFuncs *gl;
   struct ConvertInfo *info = &convert->priv->convert_info;
-  gint i;
 
   gl = convert->context->gl_vtable;
 
@@ -2228,48 +2377,6 @@ _init_convert (GstGLColorConvert * convert)
   convert->priv->attr_texture =
       gst_gl_shader_get_attribute_location (convert->shader, "a_texcoord");
 
-  gst_gl_shader_use (convert->shader);
-
-  if (info->cms_offset && info->cms_coeff1
-      && info->cms_coeff2 && info->cms_coeff3) {
-    gst_gl_shader_set_uniform_3fv (convert->shader, "offset", 1,
-        info->cms_offset);
-    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff1", 1,
-        info->cms_coeff1);
-    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff2", 1,
-        info->cms_coeff2);
-    gst_gl_shader_set_uniform_3fv (convert->shader, "coeff3", 1,
-        info->cms_coeff3);
-  }
-
-  for (i = info->in_n_textures; i >= 0; i--) {
-    if (info->shader_tex_names[i])
-      gst_gl_shader_set_uniform_1i (convert->shader, info->shader_tex_names[i],
-          i);
-  }
-
-  gst_gl_shader_set_uniform_1f (convert->shader, "width",
-      GST_VIDEO_INFO_WIDTH (&convert->in_info));
-  gst_gl_shader_set_uniform_1f (convert->shader, "height",
-      GST_VIDEO_INFO_HEIGHT (&convert->in_info));
-
-  if (convert->priv->from_texture_target == GST_GL_TEXTURE_TARGET_RECTANGLE) {
-    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_x", 1.);
-    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_y", 1.);
-  } else {
-    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_x",
-        1. / (gfloat) GST_VIDEO_INFO_WIDTH (&convert->in_info));
-    gst_gl_shader_set_uniform_1f (convert->shader, "poffset_y",
-        1. / (gfloat) GST_VIDEO_INFO_HEIGHT (&convert->in_info));
-  }
-
-  if (info->chroma_sampling[0] > 0.0f && info->chroma_sampling[1] > 0.0f) {
-    gst_gl_shader_set_uniform_2fv (convert->shader, "chroma_sampling", 1,
-        info->chroma_sampling);
-  }
-
-  gst_gl_context_clear_shader (convert->context);
-
   if (convert->fbo == NULL && !_init_convert_fbo (convert)) {
     goto error;
   }
@@ -2691,6 +2798,7 @@ _do_convert_draw (GstGLContext * context, GstGLColorConvert * convert)
   gl->Viewport (0, 0, out_width, out_height);
 
   gst_gl_shader_use (convert->shader);
+  _set_uniforms (convert);
 
   if (gl->BindVertexArray)
     gl->BindVertexArray (convert->priv->vao);
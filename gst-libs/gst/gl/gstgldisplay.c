@@ -99,12 +99,16 @@ static gboolean gst_gl_display_default_get_foreign_display (GstGLDisplay *
     display);
 static GstGLWindow *gst_gl_display_default_create_window (GstGLDisplay *
     display);
+static GstGLContext *_get_gl_context_for_thread_unlocked (GstGLDisplay *
+    display, GThread * thread);
 
 struct _GstGLDisplayPrivate
 {
   GstGLAPI gl_api;
 
   GList *contexts;
+  guint context_pool_size;
+  guint next_pool_context;
 
   GThread *event_thread;
 
@@ -192,6 +196,16 @@ gst_gl_display_init (GstGLDisplay * display)
 
   display->type = GST_GL_DISPLAY_TYPE_ANY;
   display->priv->gl_api = GST_GL_API_ANY;
+  display->priv->context_pool_size = 1;
+
+  {
+    const gchar *pool_size = g_getenv ("GST_GL_CONTEXT_POOL_SIZE");
+
+    if (pool_size) {
+      guint64 size = g_ascii_strtoull (pool_size, NULL, 10);
+      display->priv->context_pool_size = CLAMP (size, 1, G_MAXUINT);
+    }
+  }
 
   g_mutex_init (&display->priv->thread_lock);
   g_cond_init (&display->priv->thread_cond);
@@ -544,25 +558,34 @@ gst_gl_display_create_context (GstGLDisplay * display,
     GstGLContext * other_context, GstGLContext ** p_context, GError ** error)
 {
   GstGLContext *context = NULL;
+  GstGLContext *pool_context = NULL;
   gboolean ret = FALSE;
 
   g_return_val_if_fail (display != NULL, FALSE);
   g_return_val_if_fail (p_context != NULL, FALSE);
   g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
+  /* contexts of a pool share resources so that textures can be passed
+   * between pipelines using different contexts */
+  if (!other_context && display->priv->context_pool_size > 1) {
+    pool_context = _get_gl_context_for_thread_unlocked (display, NULL);
+    other_context = pool_context;
+  }
+
   g_signal_emit (display, gst_gl_display_signals[CREATE_CONTEXT], 0,
       other_context, &context);
 
   if (context) {
     *p_context = context;
-    return TRUE;
+    ret = TRUE;
+    goto out;
   }
 
   context = gst_gl_context_new (display);
   if (!context) {
     g_set_error (error, GST_GL_CONTEXT_ERROR, GST_GL_CONTEXT_ERROR_FAILED,
         "Failed to create GL context");
-    return FALSE;
+    goto out;
   }
 
   GST_DEBUG_OBJECT (display,
@@ -574,9 +597,61 @@ gst_gl_display_create_context (GstGLDisplay * display,
   if (ret)
     *p_context = context;
 
+out:
+  if (pool_context)
+    gst_object_unref (pool_context);
+
   return ret;
 }
 
+/**
+ * gst_gl_display_set_context_pool_size:
+ * @display: a #GstGLDisplay
+ * @size: the number of #GstGLContext<!-- -->s to distribute work over
+ *
+ * Elements that don't find a #GstGLContext in their pipeline or from the
+ * application pick one of @display. By default they all end up with the
+ * same context and so render from the same GL thread. With a @size larger
+ * than 1, up to @size contexts are created and elements without another
+ * context are spread over them, which lets independent pipelines render
+ * in parallel. Contexts created for the pool share resources with each
+ * other.
+ *
+ * The initial value is taken from the GST_GL_CONTEXT_POOL_SIZE environment
+ * variable, or 1.
+ *
+ * Must be called with the object lock held.
+ *
+ * Since: 1.18
+ */
+void
+gst_gl_display_set_context_pool_size (GstGLDisplay * display, guint size)
+{
+  g_return_if_fail (GST_IS_GL_DISPLAY (display));
+  g_return_if_fail (size > 0);
+
+  display->priv->context_pool_size = size;
+}
+
+/**
+ * gst_gl_display_get_context_pool_size:
+ * @display: a #GstGLDisplay
+ *
+ * Must be called with the object lock held.
+ *
+ * Returns: the size of the context pool of @display, see
+ *     gst_gl_display_set_context_pool_size()
+ *
+ * Since: 1.18
+ */
+guint
+gst_gl_display_get_context_pool_size (GstGLDisplay * display)
+{
+  g_return_val_if_fail (GST_IS_GL_DISPLAY (display), 0);
+
+  return display->priv->context_pool_size;
+}
+
 /**
  * gst_gl_display_create_window:
  * @display: a #GstGLDisplay
@@ -753,11 +828,49 @@ _get_gl_context_for_thread_unlocked (GstGLDisplay * display, GThread * thread)
   return NULL;
 }
 
+static GstGLContext *
+_get_pool_context_unlocked (GstGLDisplay * display)
+{
+  GstGLContext *context = NULL;
+  GList *l, *alive = NULL;
+  guint n_alive;
+
+  for (l = display->priv->contexts; l; l = l->next) {
+    GstGLContext *tmp = g_weak_ref_get ((GWeakRef *) l->data);
+
+    if (tmp)
+      alive = g_list_prepend (alive, tmp);
+  }
+
+  /* let the caller create a new context until the pool is full, then hand
+   * out the existing ones in turn */
+  n_alive = g_list_length (alive);
+  if (n_alive >= display->priv->context_pool_size) {
+    guint idx = display->priv->next_pool_context++ % n_alive;
+
+    context = gst_object_ref (g_list_nth_data (alive, idx));
+    GST_DEBUG_OBJECT (display, "Returning pooled GL context %" GST_PTR_FORMAT
+        " (%u of %u)", context, idx, n_alive);
+  } else {
+    GST_DEBUG_OBJECT (display, "GL context pool has %u of %u contexts",
+        n_alive, display->priv->context_pool_size);
+  }
+
+  g_list_free_full (alive, gst_object_unref);
+
+  return context;
+}
+
 /**
  * gst_gl_display_get_gl_context_for_thread:
  * @display: a #GstGLDisplay
  * @thread: a #GThread
  *
+ * When @thread is %NULL, any #GstGLContext of @display is returned. If a
+ * context pool has been set up with gst_gl_display_set_context_pool_size(),
+ * %NULL is returned until the pool holds enough contexts and the contexts
+ * of the pool are returned in turn afterwards.
+ *
  * Returns: (transfer full): the #GstGLContext current on @thread or %NULL
  *
  * Must be called with the object lock held.
@@ -772,7 +885,10 @@ gst_gl_display_get_gl_context_for_thread (GstGLDisplay * display,
 
   g_return_val_if_fail (GST_IS_GL_DISPLAY (display), NULL);
 
-  context = _get_gl_context_for_thread_unlocked (display, thread);
+  if (thread == NULL && display->priv->context_pool_size > 1)
+    context = _get_pool_context_unlocked (display);
+  else
+    context = _get_gl_context_for_thread_unlocked (display, thread);
   GST_DEBUG_OBJECT (display, "returning context %" GST_PTR_FORMAT " for thread "
       "%p", context, thread);
 
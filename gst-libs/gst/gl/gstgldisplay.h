@@ -143,6 +143,11 @@ GstGLContext * gst_gl_display_get_gl_context_for_thread (GstGLDisplay * display,
 GST_GL_API
 gboolean gst_gl_display_add_context (GstGLDisplay * display,
     GstGLContext * context);
+GST_GL_API
+void     gst_gl_display_set_context_pool_size (GstGLDisplay * display,
+    guint size);
+GST_GL_API
+guint    gst_gl_display_get_context_pool_size (GstGLDisplay * display);
 
 GST_GL_API
 GstGLWindow *   gst_gl_display_create_window    (GstGLDisplay * display);
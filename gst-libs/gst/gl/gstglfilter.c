@@ -28,6 +28,13 @@
  *
  * #GstGLFilter helps to implement simple OpenGL filter elements taking a
  * single input and producing a single output with a #GstGLFramebuffer
+ *
+ * With #GstGLFilter:async-submit enabled, filters that only implement
+ * #GstGLFilterClass.filter_texture() queue the rendering of a frame in the
+ * OpenGL thread and push the output buffer without waiting for it. Elements
+ * using the same #GstGLContext are executed in order anyway and other
+ * contexts wait on the #GstGLSyncMeta of the buffer, which is set once the
+ * frame has been rendered.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -39,6 +46,7 @@
 #include "gstglfilter.h"
 
 #include "gstglfuncs.h"
+#include "gstglsyncmeta_private.h"
 
 #define GST_CAT_DEFAULT gst_gl_filter_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
@@ -81,14 +89,25 @@ GST_STATIC_PAD_TEMPLATE ("sink",
     ));
 /* *INDENT-ON* */
 
+#define DEFAULT_ASYNC_SUBMIT FALSE
+
 /* Properties */
 enum
 {
   PROP_0,
+  PROP_ASYNC_SUBMIT,
+};
+
+struct _GstGLFilterPrivate
+{
+  gboolean async_submit;
+  /* set from the GL thread when a queued frame failed to render */
+  gint async_error;
 };
 
 #define gst_gl_filter_parent_class parent_class
 G_DEFINE_TYPE_WITH_CODE (GstGLFilter, gst_gl_filter, GST_TYPE_GL_BASE_FILTER,
+    G_ADD_PRIVATE (GstGLFilter)
     GST_DEBUG_CATEGORY_INIT (gst_gl_filter_debug, "glfilter", 0,
         "glfilter element");
     );
@@ -140,6 +159,22 @@ gst_gl_filter_class_init (GstGLFilterClass * klass)
   gobject_class->set_property = gst_gl_filter_set_property;
   gobject_class->get_property = gst_gl_filter_get_property;
 
+  /**
+   * GstGLFilter:async-submit:
+   *
+   * Queue the rendering of each frame in the OpenGL thread and push the
+   * output buffer without waiting for the rendering to finish. Only used by
+   * filters that implement #GstGLFilterClass.filter_texture() and not
+   * #GstGLFilterClass.filter().
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_ASYNC_SUBMIT,
+      g_param_spec_boolean ("async-submit", "Asynchronous submission",
+          "Push output buffers without waiting for the OpenGL thread to "
+          "render them", DEFAULT_ASYNC_SUBMIT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   GST_BASE_TRANSFORM_CLASS (klass)->transform_caps =
       gst_gl_filter_transform_caps;
   GST_BASE_TRANSFORM_CLASS (klass)->fixate_caps = gst_gl_filter_fixate_caps;
@@ -161,6 +196,10 @@ gst_gl_filter_class_init (GstGLFilterClass * klass)
 static void
 gst_gl_filter_init (GstGLFilter * filter)
 {
+  GstGLFilterPrivate *priv = gst_gl_filter_get_instance_private (filter);
+
+  priv->async_submit = DEFAULT_ASYNC_SUBMIT;
+
   filter->draw_attr_position_loc = -1;
   filter->draw_attr_texture_loc = -1;
 }
@@ -169,7 +208,15 @@ static void
 gst_gl_filter_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
+  GstGLFilterPrivate *priv =
+      gst_gl_filter_get_instance_private (GST_GL_FILTER (object));
+
   switch (prop_id) {
+    case PROP_ASYNC_SUBMIT:
+      GST_OBJECT_LOCK (object);
+      priv->async_submit = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -180,7 +227,15 @@ static void
 gst_gl_filter_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
 {
+  GstGLFilterPrivate *priv =
+      gst_gl_filter_get_instance_private (GST_GL_FILTER (object));
+
   switch (prop_id) {
+    case PROP_ASYNC_SUBMIT:
+      GST_OBJECT_LOCK (object);
+      g_value_set_boolean (value, priv->async_submit);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -190,7 +245,25 @@ gst_gl_filter_get_property (GObject * object, guint prop_id,
 static void
 gst_gl_filter_reset (GstGLFilter * filter)
 {
+  GstGLFilterPrivate *priv = gst_gl_filter_get_instance_private (filter);
+
   gst_caps_replace (&filter->out_caps, NULL);
+  g_atomic_int_set (&priv->async_error, FALSE);
+}
+
+static void
+_drain_gl (GstGLContext * context, gpointer data)
+{
+}
+
+/* wait for all the frames queued with async-submit to be rendered */
+static void
+gst_gl_filter_drain (GstGLFilter * filter)
+{
+  GstGLContext *context = GST_GL_BASE_FILTER (filter)->context;
+
+  if (context)
+    gst_gl_context_thread_add (context, _drain_gl, NULL);
 }
 
 static gboolean
@@ -740,6 +813,9 @@ gst_gl_filter_set_caps (GstBaseTransform * bt, GstCaps * incaps,
   filter = GST_GL_FILTER (bt);
   filter_class = GST_GL_FILTER_GET_CLASS (filter);
 
+  /* frames still queued use the current state */
+  gst_gl_filter_drain (filter);
+
   if (!gst_video_info_from_caps (&filter->in_info, incaps))
     goto wrong_caps;
   if (!gst_video_info_from_caps (&filter->out_info, outcaps))
@@ -1002,6 +1078,119 @@ _filter_gl (GstGLContext * context, GstGLFilter * filter)
         gst_gl_filter_filter_texture (filter, filter->inbuf, filter->outbuf);
 }
 
+struct async_draw
+{
+  GstGLFilter *filter;
+  GstBuffer *inbuf;
+  GstMemory *in_tex;
+  GstMemory *out_tex;
+  GstGLSyncMeta *out_sync_meta;
+};
+
+static void
+_async_draw_free (struct async_draw *draw)
+{
+  gst_memory_unref (draw->out_tex);
+  gst_memory_unref (draw->in_tex);
+  gst_buffer_unref (draw->inbuf);
+  gst_object_unref (draw->filter);
+  g_free (draw);
+}
+
+static void
+_filter_gl_async (struct async_draw *draw)
+{
+  GstGLFilter *filter = draw->filter;
+  GstGLFilterClass *filter_class = GST_GL_FILTER_GET_CLASS (filter);
+  GstGLFilterPrivate *priv = gst_gl_filter_get_instance_private (filter);
+  GstGLContext *context = GST_GL_BASE_FILTER (filter)->context;
+  GstGLSyncMeta *in_sync_meta;
+  GstMapInfo in_map, out_map;
+  gboolean ret = FALSE;
+
+  gst_gl_insert_debug_marker (context,
+      "processing in element %s", GST_OBJECT_NAME (filter));
+
+  in_sync_meta = gst_buffer_get_gl_sync_meta (draw->inbuf);
+  if (in_sync_meta)
+    gst_gl_sync_meta_wait (in_sync_meta, context);
+
+  if (!gst_memory_map (draw->in_tex, &in_map, GST_MAP_READ | GST_MAP_GL))
+    goto done;
+
+  if (gst_memory_map (draw->out_tex, &out_map, GST_MAP_WRITE | GST_MAP_GL)) {
+    GST_DEBUG_OBJECT (filter, "calling filter_texture with textures in:%i "
+        "out:%i", GST_GL_MEMORY_CAST (draw->in_tex)->tex_id,
+        GST_GL_MEMORY_CAST (draw->out_tex)->tex_id);
+
+    ret = filter_class->filter_texture (filter,
+        GST_GL_MEMORY_CAST (draw->in_tex), GST_GL_MEMORY_CAST (draw->out_tex));
+    gst_memory_unmap (draw->out_tex, &out_map);
+  }
+  gst_memory_unmap (draw->in_tex, &in_map);
+
+done:
+  /* the output buffer is only released downstream after this ran: any
+   * other use of its memory or its sync meta is queued behind us */
+  if (draw->out_sync_meta) {
+    gst_gl_sync_meta_set_sync_point (draw->out_sync_meta, context);
+    _gst_gl_sync_meta_set_pending (draw->out_sync_meta, FALSE);
+  }
+
+  if (!ret)
+    g_atomic_int_set (&priv->async_error, TRUE);
+}
+
+/* Returns %FALSE if the frame has to be rendered synchronously */
+static gboolean
+gst_gl_filter_submit_async (GstGLFilter * filter, GstBuffer * inbuf,
+    GstBuffer * outbuf)
+{
+  GstGLFilterClass *filter_class = GST_GL_FILTER_GET_CLASS (filter);
+  GstGLFilterPrivate *priv = gst_gl_filter_get_instance_private (filter);
+  GstGLContext *context = GST_GL_BASE_FILTER (filter)->context;
+  GstMemory *in_tex, *out_tex;
+  struct async_draw *draw;
+  GstGLWindow *window;
+  gboolean async_submit;
+
+  GST_OBJECT_LOCK (filter);
+  async_submit = priv->async_submit;
+  GST_OBJECT_UNLOCK (filter);
+
+  if (!async_submit || filter_class->filter || !filter_class->filter_texture)
+    return FALSE;
+
+  /* the memories are rendered directly, which requires one texture each */
+  if (gst_buffer_n_memory (inbuf) != 1 || gst_buffer_n_memory (outbuf) != 1)
+    return FALSE;
+
+  in_tex = gst_buffer_peek_memory (inbuf, 0);
+  out_tex = gst_buffer_peek_memory (outbuf, 0);
+  if (!gst_is_gl_memory (in_tex) || !gst_is_gl_memory (out_tex))
+    return FALSE;
+
+  window = gst_gl_context_get_window (context);
+  if (!window)
+    return FALSE;
+
+  draw = g_new0 (struct async_draw, 1);
+  draw->filter = gst_object_ref (filter);
+  draw->inbuf = gst_buffer_ref (inbuf);
+  draw->in_tex = gst_memory_ref (in_tex);
+  draw->out_tex = gst_memory_ref (out_tex);
+  draw->out_sync_meta = gst_buffer_get_gl_sync_meta (outbuf);
+  if (draw->out_sync_meta)
+    _gst_gl_sync_meta_set_pending (draw->out_sync_meta, TRUE);
+
+  gst_gl_window_send_message_async (window,
+      (GstGLWindowCB) _filter_gl_async, draw,
+      (GDestroyNotify) _async_draw_free);
+  gst_object_unref (window);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_gl_filter_transform (GstBaseTransform * bt, GstBuffer * inbuf,
     GstBuffer * outbuf)
@@ -1010,6 +1199,7 @@ gst_gl_filter_transform (GstBaseTransform * bt, GstBuffer * inbuf,
   GstGLFilterClass *filter_class = GST_GL_FILTER_GET_CLASS (bt);
   GstGLDisplay *display = GST_GL_BASE_FILTER (bt)->display;
   GstGLContext *context = GST_GL_BASE_FILTER (bt)->context;
+  GstGLFilterPrivate *priv = gst_gl_filter_get_instance_private (filter);
   GstGLSyncMeta *out_sync_meta, *in_sync_meta;
   gboolean ret;
 
@@ -1018,6 +1208,15 @@ gst_gl_filter_transform (GstBaseTransform * bt, GstBuffer * inbuf,
 
   g_assert (filter_class->filter || filter_class->filter_texture);
 
+  if (g_atomic_int_get (&priv->async_error)) {
+    GST_ELEMENT_ERROR (filter, RESOURCE, FAILED, (NULL),
+        ("Failed to render a queued frame"));
+    return GST_FLOW_ERROR;
+  }
+
+  if (gst_gl_filter_submit_async (filter, inbuf, outbuf))
+    return GST_FLOW_OK;
+
   in_sync_meta = gst_buffer_get_gl_sync_meta (inbuf);
   if (in_sync_meta)
     gst_gl_sync_meta_wait (in_sync_meta, context);
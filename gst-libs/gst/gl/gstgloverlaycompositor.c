@@ -87,6 +87,18 @@ struct _GstGLCompositionOverlay
   GstVideoOverlayRectangle *rectangle;
 
   gboolean yinvert;
+
+  /* cache bookkeeping, owned by the GstGLOverlayCompositor */
+  guint seqnum;
+  gsize size;
+  GList *lru_link;
+  guint64 last_used;
+
+  /* geometry the vertex buffer was last computed for */
+  gint render_x, render_y;
+  guint render_width, render_height;
+  guint video_width, video_height;
+  gboolean geometry_yinvert;
 };
 
 struct _GstGLCompositionOverlayClass
@@ -214,6 +226,9 @@ gst_gl_composition_overlay_finalize (GObject * object)
   if (overlay->gl_memory)
     gst_memory_unref ((GstMemory *) overlay->gl_memory);
 
+  if (overlay->rectangle)
+    gst_video_overlay_rectangle_unref (overlay->rectangle);
+
   if (overlay->context) {
     gst_gl_context_thread_add (overlay->context,
         gst_gl_composition_overlay_free_vertex_buffer, overlay);
@@ -259,6 +274,14 @@ gst_gl_composition_overlay_add_transformation (GstGLCompositionOverlay *
   width = meta->width;
   height = meta->height;
 
+  overlay->render_x = comp_x;
+  overlay->render_y = comp_y;
+  overlay->render_width = comp_width;
+  overlay->render_height = comp_height;
+  overlay->video_width = width;
+  overlay->video_height = height;
+  overlay->geometry_yinvert = overlay->yinvert;
+
   /* calculate relative position */
   rel_x = (float) comp_x / (float) width;
   rel_y = (float) comp_y / (float) height;
@@ -304,6 +327,31 @@ gst_gl_composition_overlay_add_transformation (GstGLCompositionOverlay *
       comp_x, comp_y, comp_width, comp_height, meta->width, meta->height);
 }
 
+static gboolean
+gst_gl_composition_overlay_geometry_changed (GstGLCompositionOverlay *
+    overlay, GstBuffer * video_buffer)
+{
+  gint comp_x, comp_y;
+  guint comp_width, comp_height;
+  GstVideoMeta *meta;
+
+  meta = gst_buffer_get_video_meta (video_buffer);
+  if (!meta)
+    return FALSE;
+
+  /* the seqnum only tracks the pixel data, the render rectangle can be
+   * moved around without it changing */
+  gst_video_overlay_rectangle_get_render_rectangle (overlay->rectangle,
+      &comp_x, &comp_y, &comp_width, &comp_height);
+
+  return overlay->render_x != comp_x || overlay->render_y != comp_y
+      || overlay->render_width != comp_width
+      || overlay->render_height != comp_height
+      || overlay->video_width != meta->width
+      || overlay->video_height != meta->height
+      || overlay->geometry_yinvert != overlay->yinvert;
+}
+
 /* helper object API functions */
 
 static GstGLCompositionOverlay *
@@ -316,7 +364,8 @@ gst_gl_composition_overlay_new (GstGLContext * context,
 
   overlay->gl_memory = NULL;
   overlay->texture_id = -1;
-  overlay->rectangle = rectangle;
+  overlay->rectangle = gst_video_overlay_rectangle_ref (rectangle);
+  overlay->seqnum = gst_video_overlay_rectangle_get_seqnum (rectangle);
   overlay->context = gst_object_ref (context);
   overlay->vao = 0;
   overlay->position_attrib = position_attrib;
@@ -411,6 +460,7 @@ gst_gl_composition_overlay_upload (GstGLCompositionOverlay * overlay,
     gst_memory_ref ((GstMemory *) comp_gl_memory);
     overlay->gl_memory = comp_gl_memory;
     overlay->texture_id = comp_gl_memory->tex_id;
+    overlay->size = ((GstMemory *) comp_gl_memory)->size;
 
     gst_buffer_unref (overlay_buffer);
     gst_video_frame_unmap (&gl_frame);
@@ -439,12 +489,20 @@ gst_gl_composition_overlay_draw (GstGLCompositionOverlay * overlay,
 typedef struct
 {
   gboolean yinvert;
+
+  /* uploaded overlays by rectangle seqnum, most recently used first in lru */
+  GHashTable *cache;
+  GQueue lru;
+  gsize cache_size;
+  guint64 max_cache_size;
+  guint64 frame_count;
 } GstGLOverlayCompositorPrivate;
 
 enum
 {
   PROP_0,
   PROP_YINVERT,
+  PROP_MAX_CACHE_SIZE,
 };
 
 /********************************************************************
@@ -459,6 +517,7 @@ enum
 /* this matches what glimagesink does as this was publicized before being used
  * in other elements that draw in different orientations */
 #define DEFAULT_YINVERT                 FALSE
+#define DEFAULT_MAX_CACHE_SIZE          (32 * 1024 * 1024)
 
 G_DEFINE_TYPE_WITH_CODE (GstGLOverlayCompositor, gst_gl_overlay_compositor,
     GST_TYPE_OBJECT, G_ADD_PRIVATE (GstGLOverlayCompositor);
@@ -470,11 +529,6 @@ static void gst_gl_overlay_compositor_set_property (GObject * object,
 static void gst_gl_overlay_compositor_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec);
 
-static gboolean _is_rectangle_in_overlays (GList * overlays,
-    GstVideoOverlayRectangle * rectangle);
-static gboolean _is_overlay_in_rectangles (GstVideoOverlayComposition *
-    composition, GstGLCompositionOverlay * overlay);
-
 static void
 gst_gl_overlay_compositor_class_init (GstGLOverlayCompositorClass * klass)
 {
@@ -489,6 +543,23 @@ gst_gl_overlay_compositor_class_init (GstGLOverlayCompositorClass * klass)
           "Y-Invert",
           "Whether to invert the output across a horizintal axis",
           DEFAULT_YINVERT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstGLOverlayCompositor:max-cache-size:
+   *
+   * Maximum amount of texture memory in bytes kept around for overlay
+   * rectangles that are not part of the current composition.  Rectangles
+   * coming back with the same seqnum are then drawn without being uploaded
+   * again.  With 0 only the rectangles of the last composition are kept.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_CACHE_SIZE,
+      g_param_spec_uint64 ("max-cache-size",
+          "Maximum cache size",
+          "Maximum size in bytes of the uploaded overlay cache",
+          0, G_MAXUINT64, DEFAULT_MAX_CACHE_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -498,6 +569,9 @@ gst_gl_overlay_compositor_init (GstGLOverlayCompositor * compositor)
       gst_gl_overlay_compositor_get_instance_private (compositor);
 
   priv->yinvert = DEFAULT_YINVERT;
+  priv->max_cache_size = DEFAULT_MAX_CACHE_SIZE;
+  priv->cache = g_hash_table_new (g_direct_hash, g_direct_equal);
+  g_queue_init (&priv->lru);
 }
 
 static void
@@ -510,9 +584,15 @@ gst_gl_overlay_compositor_set_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case PROP_YINVERT:
-      /* XXX: invalidiate all current rectangles on a change */
+      /* the vertex buffers of cached overlays are recomputed when they are
+       * next used */
       priv->yinvert = g_value_get_boolean (value);
       break;
+    case PROP_MAX_CACHE_SIZE:
+      GST_OBJECT_LOCK (self);
+      priv->max_cache_size = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -531,6 +611,11 @@ gst_gl_overlay_compositor_get_property (GObject * object, guint prop_id,
     case PROP_YINVERT:
       g_value_set_boolean (value, priv->yinvert);
       break;
+    case PROP_MAX_CACHE_SIZE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint64 (value, priv->max_cache_size);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -592,10 +677,13 @@ static void
 gst_gl_overlay_compositor_finalize (GObject * object)
 {
   GstGLOverlayCompositor *compositor;
+  GstGLOverlayCompositorPrivate *priv;
 
   compositor = GST_GL_OVERLAY_COMPOSITOR (object);
+  priv = gst_gl_overlay_compositor_get_instance_private (compositor);
 
   gst_gl_overlay_compositor_free_overlays (compositor);
+  g_hash_table_unref (priv->cache);
 
   if (compositor->context)
     gst_object_unref (compositor->context);
@@ -608,50 +696,130 @@ gst_gl_overlay_compositor_finalize (GObject * object)
   G_OBJECT_CLASS (gst_gl_overlay_compositor_parent_class)->finalize (object);
 }
 
-static gboolean
-_is_rectangle_in_overlays (GList * overlays,
-    GstVideoOverlayRectangle * rectangle)
+static void
+_cache_remove (GstGLOverlayCompositor * compositor,
+    GstGLCompositionOverlay * overlay)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+
+  g_hash_table_remove (priv->cache, GUINT_TO_POINTER (overlay->seqnum));
+  g_queue_delete_link (&priv->lru, overlay->lru_link);
+  overlay->lru_link = NULL;
+  priv->cache_size -= overlay->size;
+  gst_object_unref (overlay);
+}
+
+/* drops the least recently used overlays that are not part of the current
+ * frame until the cache fits in max-cache-size again */
+static void
+_cache_trim (GstGLOverlayCompositor * compositor)
 {
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  guint64 max_cache_size;
   GList *l;
 
-  for (l = overlays; l != NULL; l = l->next) {
+  GST_OBJECT_LOCK (compositor);
+  max_cache_size = priv->max_cache_size;
+  GST_OBJECT_UNLOCK (compositor);
+
+  l = priv->lru.tail;
+  while (l != NULL && priv->cache_size > max_cache_size) {
+    GList *prev = l->prev;
     GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-    if (overlay->rectangle == rectangle)
-      return TRUE;
+
+    if (overlay->last_used != priv->frame_count) {
+      GST_LOG_OBJECT (compositor, "evicting overlay with seqnum %u (%"
+          G_GSIZE_FORMAT " bytes)", overlay->seqnum, overlay->size);
+      _cache_remove (compositor, overlay);
+    }
+    l = prev;
   }
-  return FALSE;
 }
 
-static gboolean
-_is_overlay_in_rectangles (GstVideoOverlayComposition * composition,
-    GstGLCompositionOverlay * overlay)
+static void
+_free_current_overlays (GstGLOverlayCompositor * compositor)
 {
-  guint i;
-
-  for (i = 0; i < gst_video_overlay_composition_n_rectangles (composition); i++) {
-    GstVideoOverlayRectangle *rectangle =
-        gst_video_overlay_composition_get_rectangle (composition, i);
-    if (overlay->rectangle == rectangle)
-      return TRUE;
-  }
-  return FALSE;
+  g_list_free_full (compositor->overlays, gst_object_unref);
+  compositor->overlays = NULL;
 }
 
+/**
+ * gst_gl_overlay_compositor_free_overlays:
+ * @compositor: a #GstGLOverlayCompositor
+ *
+ * Releases the overlays of the last uploaded composition together with all
+ * cached overlay textures.
+ */
 void
 gst_gl_overlay_compositor_free_overlays (GstGLOverlayCompositor * compositor)
 {
-  GList *l = compositor->overlays;
-  while (l != NULL) {
-    GList *next = l->next;
-    GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-    compositor->overlays = g_list_delete_link (compositor->overlays, l);
-    gst_object_unref (overlay);
-    l = next;
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+
+  _free_current_overlays (compositor);
+
+  while (priv->lru.head)
+    _cache_remove (compositor, priv->lru.head->data);
+  g_assert (priv->cache_size == 0);
+}
+
+static GstGLCompositionOverlay *
+_get_overlay (GstGLOverlayCompositor * compositor,
+    GstVideoOverlayRectangle * rectangle, GstBuffer * buf)
+{
+  GstGLOverlayCompositorPrivate *priv =
+      gst_gl_overlay_compositor_get_instance_private (compositor);
+  GstGLCompositionOverlay *overlay;
+  guint seqnum = gst_video_overlay_rectangle_get_seqnum (rectangle);
+
+  overlay = g_hash_table_lookup (priv->cache, GUINT_TO_POINTER (seqnum));
+  if (overlay) {
+    /* same pixels, possibly a fresh rectangle object or a new position */
+    if (overlay->rectangle != rectangle) {
+      gst_video_overlay_rectangle_unref (overlay->rectangle);
+      overlay->rectangle = gst_video_overlay_rectangle_ref (rectangle);
+    }
+    overlay->yinvert = priv->yinvert;
+    if (gst_gl_composition_overlay_geometry_changed (overlay, buf))
+      gst_gl_composition_overlay_add_transformation (overlay, buf);
+
+    g_queue_unlink (&priv->lru, overlay->lru_link);
+    g_queue_push_head_link (&priv->lru, overlay->lru_link);
+
+    GST_TRACE_OBJECT (compositor, "reusing overlay with seqnum %u", seqnum);
+    return gst_object_ref (overlay);
   }
-  g_list_free (compositor->overlays);
-  compositor->overlays = NULL;
+
+  overlay = gst_gl_composition_overlay_new (compositor->context, rectangle,
+      compositor->position_attrib, compositor->texcoord_attrib);
+  gst_object_ref_sink (overlay);
+  overlay->yinvert = priv->yinvert;
+
+  gst_gl_composition_overlay_upload (overlay, buf);
+
+  /* failed uploads are retried with the next composition */
+  if (overlay->texture_id != -1) {
+    g_hash_table_insert (priv->cache, GUINT_TO_POINTER (seqnum), overlay);
+    g_queue_push_head (&priv->lru, gst_object_ref (overlay));
+    overlay->lru_link = priv->lru.head;
+    priv->cache_size += overlay->size;
+  }
+
+  return overlay;
 }
 
+/**
+ * gst_gl_overlay_compositor_upload_overlays:
+ * @compositor: a #GstGLOverlayCompositor
+ * @buf: a #GstBuffer
+ *
+ * Uploads the rectangles of the #GstVideoOverlayCompositionMeta on @buf, if
+ * any, for the next gst_gl_overlay_compositor_draw_overlays().  Rectangles
+ * that have already been uploaded, as identified by their seqnum, are not
+ * uploaded again.
+ */
 void
 gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
     GstBuffer * buf)
@@ -660,48 +828,38 @@ gst_gl_overlay_compositor_upload_overlays (GstGLOverlayCompositor * compositor,
   GstGLOverlayCompositorPrivate *priv =
       gst_gl_overlay_compositor_get_instance_private (compositor);
 
+  _free_current_overlays (compositor);
+  priv->frame_count++;
+
   composition_meta = gst_buffer_get_video_overlay_composition_meta (buf);
   if (composition_meta) {
     GstVideoOverlayComposition *composition = NULL;
     guint num_overlays, i;
-    GList *l = compositor->overlays;
 
     GST_DEBUG ("GstVideoOverlayCompositionMeta found.");
 
     composition = composition_meta->overlay;
     num_overlays = gst_video_overlay_composition_n_rectangles (composition);
 
-    /* add new overlays to list */
     for (i = 0; i < num_overlays; i++) {
       GstVideoOverlayRectangle *rectangle =
           gst_video_overlay_composition_get_rectangle (composition, i);
+      GstGLCompositionOverlay *overlay;
 
-      if (!_is_rectangle_in_overlays (compositor->overlays, rectangle)) {
-        GstGLCompositionOverlay *overlay =
-            gst_gl_composition_overlay_new (compositor->context, rectangle,
-            compositor->position_attrib, compositor->texcoord_attrib);
-        gst_object_ref_sink (overlay);
-        overlay->yinvert = priv->yinvert;
-
-        gst_gl_composition_overlay_upload (overlay, buf);
-
-        compositor->overlays = g_list_append (compositor->overlays, overlay);
-      }
-    }
-
-    /* remove old overlays from list */
-    while (l != NULL) {
-      GList *next = l->next;
-      GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
-      if (!_is_overlay_in_rectangles (composition, overlay)) {
-        compositor->overlays = g_list_delete_link (compositor->overlays, l);
+      overlay = _get_overlay (compositor, rectangle, buf);
+      /* a rectangle may be part of the composition more than once */
+      if (overlay->last_used == priv->frame_count) {
         gst_object_unref (overlay);
+        continue;
       }
-      l = next;
+      overlay->last_used = priv->frame_count;
+
+      compositor->overlays = g_list_prepend (compositor->overlays, overlay);
     }
-  } else {
-    gst_gl_overlay_compositor_free_overlays (compositor);
+    compositor->overlays = g_list_reverse (compositor->overlays);
   }
+
+  _cache_trim (compositor);
 }
 
 void
@@ -709,6 +867,7 @@ gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
 {
   const GstGLFuncs *gl = compositor->context->gl_vtable;
   if (compositor->overlays != NULL) {
+    gint premultiplied = -1;
     GList *l;
 
     gl->Enable (GL_BLEND);
@@ -720,15 +879,22 @@ gst_gl_overlay_compositor_draw_overlays (GstGLOverlayCompositor * compositor)
     for (l = compositor->overlays; l != NULL; l = l->next) {
       GstGLCompositionOverlay *overlay = (GstGLCompositionOverlay *) l->data;
       GstVideoOverlayFormatFlags flags;
+      gboolean overlay_premultiplied;
 
       flags = gst_video_overlay_rectangle_get_flags (overlay->rectangle);
-
-      if (flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA
-          || !gl->BlendFuncSeparate) {
-        gl->BlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
-      } else {
-        gl->BlendFuncSeparate (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
-            GL_ONE_MINUS_SRC_ALPHA);
+      overlay_premultiplied =
+          (flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA)
+          || !gl->BlendFuncSeparate;
+
+      /* consecutive overlays usually share the same alpha mode */
+      if (overlay_premultiplied != premultiplied) {
+        if (overlay_premultiplied) {
+          gl->BlendFunc (GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        } else {
+          gl->BlendFuncSeparate (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+              GL_ONE_MINUS_SRC_ALPHA);
+        }
+        premultiplied = overlay_premultiplied;
       }
       gst_gl_composition_overlay_draw (overlay, compositor->shader);
     }
@@ -52,6 +52,10 @@
 #define GL_QUERY_RESULT 0x8866
 #endif
 
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
 #define GST_CAT_DEFAULT gst_gl_query_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
@@ -351,3 +355,34 @@ gst_gl_query_result (GstGLQuery * query)
 
   return ret;
 }
+
+/**
+ * gst_gl_query_result_available:
+ * @query: a #GstGLQuery
+ *
+ * Check whether the result of @query can be retrieved with
+ * gst_gl_query_result() without waiting for the GPU. Must be called from
+ * the GL thread.
+ *
+ * Returns: whether the result of @query is available
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_gl_query_result_available (GstGLQuery * query)
+{
+  const GstGLFuncs *gl;
+  guint available = 0;
+
+  g_return_val_if_fail (query != NULL, FALSE);
+  g_return_val_if_fail (!query->start_called, FALSE);
+
+  if (!query->supported)
+    return TRUE;
+
+  gl = query->context->gl_vtable;
+  gl->GetQueryObjectuiv (query->query_id, GL_QUERY_RESULT_AVAILABLE,
+      &available);
+
+  return available != 0;
+}
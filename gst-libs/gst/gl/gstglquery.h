@@ -78,6 +78,8 @@ GST_GL_API
 void                gst_gl_query_counter            (GstGLQuery * query);
 GST_GL_API
 guint64             gst_gl_query_result             (GstGLQuery * query);
+GST_GL_API
+gboolean            gst_gl_query_result_available   (GstGLQuery * query);
 
 #define gst_gl_query_start_log_valist(query,cat,level,object,format,varargs) \
   G_STMT_START {    \
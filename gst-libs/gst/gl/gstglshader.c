@@ -23,6 +23,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gl.h"
 #include "gstglshader.h"
 #include "gstglsl_private.h"
@@ -32,11 +34,31 @@
  * @title: GstGLShader
  * @short_description: object representing an OpenGL shader program
  * @see_also: #GstGLSLStage
+ *
+ * When the OpenGL implementation supports program binaries
+ * (GL_ARB_get_program_binary, GL_OES_get_program_binary, OpenGL 4.1 or
+ * OpenGL ES 3.0), linked programs are stored in
+ * `$XDG_CACHE_HOME/gstreamer-1.0/gl-programs`, keyed by the stage sources
+ * and the GL vendor, renderer and version strings, and later links of the
+ * same program load the stored binary instead of linking again. The
+ * `GST_GL_PROGRAM_CACHE_DIR` environment variable overrides the directory;
+ * setting it to an empty string disables the cache.
  */
 
 #ifndef GLhandleARB
 #define GLhandleARB GLuint
 #endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#define PROGRAM_CACHE_DIR_ENV "GST_GL_PROGRAM_CACHE_DIR"
 
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
 #define USING_OPENGL3(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL3, 3, 1))
@@ -79,6 +101,10 @@ struct _GstGLShaderPrivate
   gboolean linked;
   GHashTable *uniform_locations;
 
+  /* attribute and frag data locations bound before linking, they are part
+   * of the program cache key */
+  GString *bindings;
+
   GstGLSLFuncs vtable;
 };
 
@@ -128,6 +154,7 @@ gst_gl_shader_finalize (GObject * object)
 
   priv->program_handle = 0;
   g_hash_table_destroy (priv->uniform_locations);
+  g_string_free (priv->bindings, TRUE);
 
   if (shader->context) {
     gst_object_unref (shader->context);
@@ -195,6 +222,7 @@ gst_gl_shader_init (GstGLShader * self)
   priv->linked = FALSE;
   priv->uniform_locations =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->bindings = g_string_new (NULL);
 }
 
 static int
@@ -623,6 +651,164 @@ gst_gl_shader_compile_attach_stage (GstGLShader * shader, GstGLSLStage * stage,
   return TRUE;
 }
 
+static const gchar *
+_get_program_cache_dir (void)
+{
+  static gsize init = 0;
+  static gchar *cache_dir = NULL;
+
+  if (g_once_init_enter (&init)) {
+    const gchar *env = g_getenv (PROGRAM_CACHE_DIR_ENV);
+
+    if (env)
+      cache_dir = env[0] ? g_strdup (env) : NULL;
+    else
+      cache_dir = g_build_filename (g_get_user_cache_dir (), "gstreamer-1.0",
+          "gl-programs", NULL);
+
+    GST_INFO ("program binary cache directory: %s", GST_STR_NULL (cache_dir));
+    g_once_init_leave (&init, 1);
+  }
+
+  return cache_dir;
+}
+
+/* Returns the cache file for the current stages of @shader or %NULL if
+ * program binaries can't be used */
+static gchar *
+_get_program_cache_path (GstGLShader * shader)
+{
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  static const GLenum strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+  const gchar *cache_dir;
+  GChecksum *checksum;
+  gchar *filename, *path;
+  GLint n_formats = 0;
+  GList *elem;
+  guint i;
+
+  if (!gl->GetProgramBinary || !gl->ProgramBinary)
+    return NULL;
+
+  cache_dir = _get_program_cache_dir ();
+  if (!cache_dir)
+    return NULL;
+
+  /* some implementations expose the functions without supporting any
+   * binary format */
+  gl->GetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+  if (n_formats <= 0)
+    return NULL;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  for (i = 0; i < G_N_ELEMENTS (strings); i++) {
+    const gchar *str = (const gchar *) gl->GetString (strings[i]);
+
+    if (str)
+      g_checksum_update (checksum, (const guchar *) str, strlen (str));
+    g_checksum_update (checksum, (const guchar *) "", 1);
+  }
+
+  for (elem = shader->priv->stages; elem; elem = elem->next)
+    _gst_glsl_stage_update_checksum (elem->data, checksum);
+
+  g_checksum_update (checksum, (const guchar *) shader->priv->bindings->str,
+      shader->priv->bindings->len);
+
+  filename = g_strdup_printf ("%s.bin", g_checksum_get_string (checksum));
+  path = g_build_filename (cache_dir, filename, NULL);
+  g_free (filename);
+  g_checksum_free (checksum);
+
+  return path;
+}
+
+/* cache files are the binary format as a guint32 followed by the binary */
+static gboolean
+_load_program_binary (GstGLShader * shader, const gchar * path)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GLint status = GL_FALSE;
+  gchar *contents;
+  gsize length;
+  guint32 format;
+
+  if (!g_file_get_contents (path, &contents, &length, NULL))
+    return FALSE;
+
+  if (length <= sizeof (format) || length - sizeof (format) > G_MAXINT32) {
+    GST_WARNING_OBJECT (shader, "ignoring invalid program binary %s", path);
+    g_free (contents);
+    return FALSE;
+  }
+
+  memcpy (&format, contents, sizeof (format));
+  gl->ProgramBinary (priv->program_handle, format, contents + sizeof (format),
+      length - sizeof (format));
+  g_free (contents);
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_LINK_STATUS, &status);
+  if (status != GL_TRUE) {
+    /* e.g. after a driver update, clear the error and link normally */
+    GST_INFO_OBJECT (shader, "program binary %s was rejected", path);
+    while (gl->GetError () != GL_NO_ERROR);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (shader, "loaded program %u from %s", priv->program_handle,
+      path);
+
+  return TRUE;
+}
+
+static void
+_store_program_binary (GstGLShader * shader, const gchar * path)
+{
+  GstGLShaderPrivate *priv = shader->priv;
+  const GstGLFuncs *gl = shader->context->gl_vtable;
+  GError *error = NULL;
+  GLint binary_length = 0;
+  GLsizei length = 0;
+  GLenum format = 0;
+  guint32 format32;
+  gchar *contents, *dir;
+
+  priv->vtable.GetProgramiv (priv->program_handle, GL_PROGRAM_BINARY_LENGTH,
+      &binary_length);
+  if (binary_length <= 0)
+    return;
+
+  contents = g_malloc (sizeof (format32) + binary_length);
+  gl->GetProgramBinary (priv->program_handle, binary_length, &length, &format,
+      contents + sizeof (format32));
+  if (length <= 0) {
+    GST_DEBUG_OBJECT (shader, "failed to retrieve program binary");
+    g_free (contents);
+    return;
+  }
+
+  format32 = format;
+  memcpy (contents, &format32, sizeof (format32));
+
+  dir = g_path_get_dirname (path);
+  g_mkdir_with_parents (dir, 0755);
+  g_free (dir);
+
+  if (!g_file_set_contents (path, contents, sizeof (format32) + length,
+          &error)) {
+    GST_INFO_OBJECT (shader, "failed to store program binary: %s",
+        error->message);
+    g_clear_error (&error);
+  } else {
+    GST_DEBUG_OBJECT (shader, "stored program %u in %s", priv->program_handle,
+        path);
+  }
+
+  g_free (contents);
+}
+
 /**
  * gst_gl_shader_link:
  * @shader: a #GstGLShader
@@ -643,6 +829,7 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
   const GstGLFuncs *gl;
   gchar info_buffer[2048];
   GLint status = GL_FALSE;
+  gchar *cache_path;
   gint len = 0;
   gboolean ret;
   GList *elem;
@@ -692,6 +879,16 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
     }
   }
 
+  cache_path = _get_program_cache_path (shader);
+  if (cache_path && _load_program_binary (shader, cache_path)) {
+    g_free (cache_path);
+    goto linked;
+  }
+
+  if (cache_path && gl->ProgramParameteri)
+    gl->ProgramParameteri (priv->program_handle,
+        GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
   /* if nothing failed link shaders */
   gl->LinkProgram (priv->program_handle);
   status = GL_FALSE;
@@ -708,11 +905,18 @@ gst_gl_shader_link (GstGLShader * shader, GError ** error)
         "Shader Linking failed:\n%s", info_buffer);
     ret = priv->linked = FALSE;
     GST_OBJECT_UNLOCK (shader);
+    g_free (cache_path);
     return ret;
   } else if (len > 1) {
     GST_FIXME ("shader link log:\n%s", info_buffer);
   }
 
+  if (cache_path) {
+    _store_program_binary (shader, cache_path);
+    g_free (cache_path);
+  }
+
+linked:
   ret = priv->linked = TRUE;
   GST_OBJECT_UNLOCK (shader);
 
@@ -1304,6 +1508,8 @@ gst_gl_shader_bind_attribute_location (GstGLShader * shader, GLuint index,
   GST_TRACE_OBJECT (shader, "binding program %i attribute \'%s\' location %i",
       (int) shader->priv->program_handle, name, index);
 
+  g_string_append_printf (shader->priv->bindings, "a%u:%s;", index, name);
+
   shader->context->gl_vtable->BindAttribLocation (shader->priv->program_handle,
       index, name);
 }
@@ -1329,6 +1535,8 @@ gst_gl_shader_bind_frag_data_location (GstGLShader * shader,
   GST_TRACE_OBJECT (shader, "binding program %i frag data \'%s\' location %i",
       (int) shader->priv->program_handle, name, index);
 
+  g_string_append_printf (shader->priv->bindings, "f%u:%s;", index, name);
+
   shader->context->gl_vtable->BindFragDataLocation (shader->priv->
       program_handle, index, name);
 }
@@ -58,6 +58,7 @@ typedef struct _GstGLSLFuncs
 
 G_GNUC_INTERNAL gboolean _gst_glsl_funcs_fill (GstGLSLFuncs * vtable, GstGLContext * context);
 G_GNUC_INTERNAL const gchar * _gst_glsl_shader_string_find_version (const gchar * str);
+G_GNUC_INTERNAL void _gst_glsl_stage_update_checksum (GstGLSLStage * stage, GChecksum * checksum);
 
 G_GNUC_INTERNAL gchar *
 _gst_glsl_mangle_shader (const gchar * str, guint shader_type, GstGLTextureTarget from,
@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include "gstglslstage.h"
 
 #include "gl.h"
@@ -420,6 +422,25 @@ gst_glsl_stage_get_profile (GstGLSLStage * stage)
   return stage->priv->profile;
 }
 
+/* feeds everything the compiled result of @stage depends on into @checksum */
+void
+_gst_glsl_stage_update_checksum (GstGLSLStage * stage, GChecksum * checksum)
+{
+  guint32 header[3];
+  gint i;
+
+  header[0] = stage->priv->type;
+  header[1] = stage->priv->version;
+  header[2] = stage->priv->profile;
+  g_checksum_update (checksum, (const guchar *) header, sizeof (header));
+
+  /* include the terminators so that splitting the source differently
+   * results in a different key */
+  for (i = 0; i < stage->priv->n_strings; i++)
+    g_checksum_update (checksum, (const guchar *) stage->priv->strings[i],
+        strlen (stage->priv->strings[i]) + 1);
+}
+
 static void
 _maybe_prepend_version (GstGLSLStage * stage, gchar ** shader_str,
     gint * n_vertex_sources, const gchar *** vertex_sources)
@@ -33,6 +33,7 @@
 #endif
 
 #include "gstglsyncmeta.h"
+#include "gstglsyncmeta_private.h"
 
 #include "gstglcontext.h"
 #include "gstglfuncs.h"
@@ -198,6 +199,38 @@ _set_sync_point (GstGLContext * context, GstGLSyncMeta * sync_meta)
  *
  * Since: 1.6
  */
+void
+_gst_gl_sync_meta_set_pending (GstGLSyncMeta * sync_meta, gboolean pending)
+{
+  if (pending)
+    g_atomic_int_or ((guint *) & GST_META_FLAGS (sync_meta),
+        GST_GL_SYNC_META_FLAG_PENDING);
+  else
+    g_atomic_int_and ((guint *) & GST_META_FLAGS (sync_meta),
+        ~GST_GL_SYNC_META_FLAG_PENDING);
+}
+
+static void
+_drain (GstGLContext * context, gpointer data)
+{
+}
+
+/* Ensure that a sync point that is still queued in the meta's context has
+ * been set before waiting on it from another context */
+static void
+_ensure_sync_point (GstGLSyncMeta * sync_meta, GstGLContext * context)
+{
+  if (context == sync_meta->context)
+    return;
+
+  if (g_atomic_int_get ((guint *) & GST_META_FLAGS (sync_meta)) &
+      GST_GL_SYNC_META_FLAG_PENDING) {
+    GST_LOG ("draining %" GST_PTR_FORMAT " for pending sync point %p",
+        sync_meta->context, sync_meta);
+    gst_gl_context_thread_add (sync_meta->context, _drain, NULL);
+  }
+}
+
 void
 gst_gl_sync_meta_set_sync_point (GstGLSyncMeta * sync_meta,
     GstGLContext * context)
@@ -231,6 +264,8 @@ _wait (GstGLContext * context, GstGLSyncMeta * sync_meta)
 void
 gst_gl_sync_meta_wait (GstGLSyncMeta * sync_meta, GstGLContext * context)
 {
+  _ensure_sync_point (sync_meta, context);
+
   if (sync_meta->wait)
     sync_meta->wait (sync_meta, context);
   else
@@ -261,6 +296,8 @@ _wait_cpu (GstGLContext * context, GstGLSyncMeta * sync_meta)
 void
 gst_gl_sync_meta_wait_cpu (GstGLSyncMeta * sync_meta, GstGLContext * context)
 {
+  _ensure_sync_point (sync_meta, context);
+
   if (sync_meta->wait_cpu)
     sync_meta->wait_cpu (sync_meta, context);
   else
@@ -0,0 +1,37 @@
+/*
+ * GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_GL_SYNC_META_PRIVATE_H__
+#define __GST_GL_SYNC_META_PRIVATE_H__
+
+#include <gst/gl/gstglsyncmeta.h>
+
+G_BEGIN_DECLS
+
+/* set while the sync point of the meta is still queued in the thread of the
+ * meta's context, waits from other contexts have to drain that queue first */
+#define GST_GL_SYNC_META_FLAG_PENDING ((GstMetaFlags) (GST_META_FLAG_LAST << 0))
+
+G_GNUC_INTERNAL
+void                _gst_gl_sync_meta_set_pending               (GstGLSyncMeta * sync_meta,
+                                                                 gboolean pending);
+
+G_END_DECLS
+
+#endif /* __GST_GL_SYNC_META_PRIVATE_H__ */
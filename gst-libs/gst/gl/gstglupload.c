@@ -24,6 +24,7 @@
 #endif
 
 #include <stdio.h>
+#include <string.h>
 
 #include "gl.h"
 #include "gstglupload.h"
@@ -35,6 +36,8 @@
 #endif
 
 #if GST_GL_HAVE_DMABUF
+#include <unistd.h>
+#include <sys/stat.h>
 #include <gst/allocators/gstdmabuf.h>
 #endif
 
@@ -489,6 +492,7 @@ struct DmabufUpload
 
   GstEGLImage *eglimage[GST_VIDEO_MAX_PLANES];
   GstGLFormat formats[GST_VIDEO_MAX_PLANES];
+  GstBuffer *inbuf;
   GstBuffer *outbuf;
   GstGLVideoAllocationParams *params;
   guint n_mem;
@@ -497,8 +501,36 @@ struct DmabufUpload
   GstVideoInfo out_info;
   /* only used for pointer comparison */
   gpointer out_caps;
+
+  /* EGLImages of recently imported dmabufs, most recent first, valid for
+   * cache_info */
+  GQueue eglimage_cache;
+  GstVideoInfo cache_info;
 };
 
+/* Upstream pools often wrap the same dmabufs in new GstMemory objects for
+ * every buffer, which defeats caching the EGLImage on the memory. So also
+ * remember the images by the dmabufs they were created from. The fd is part
+ * of the key in addition to the inode, as older kernels give all dmabufs
+ * the same anonymous inode. */
+#define DMABUF_EGLIMAGE_CACHE_SIZE 32
+
+typedef struct
+{
+  gint cache_id;
+  guint n_fds;
+  gint fd[GST_VIDEO_MAX_PLANES];
+  gsize offset[GST_VIDEO_MAX_PLANES];
+  dev_t dev[GST_VIDEO_MAX_PLANES];
+  ino_t ino[GST_VIDEO_MAX_PLANES];
+} DmabufImageKey;
+
+typedef struct
+{
+  DmabufImageKey key;
+  GstEGLImage *eglimage;
+} DmabufCachedImage;
+
 static GstStaticCaps _dma_buf_upload_caps =
     GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
     (GST_CAPS_FEATURE_MEMORY_DMABUF,
@@ -510,6 +542,8 @@ _dma_buf_upload_new (GstGLUpload * upload)
 {
   struct DmabufUpload *dmabuf = g_new0 (struct DmabufUpload, 1);
   dmabuf->upload = upload;
+  g_queue_init (&dmabuf->eglimage_cache);
+  gst_video_info_init (&dmabuf->cache_info);
   return dmabuf;
 }
 
@@ -604,6 +638,80 @@ _set_cached_eglimage (GstMemory * mem, GstEGLImage * eglimage, gint plane)
       _eglimage_quark (plane), eglimage, (GDestroyNotify) gst_egl_image_unref);
 }
 
+static gboolean
+_dma_buf_image_key_init (DmabufImageKey * key, gint cache_id, guint n_fds,
+    const gint * fd, const gsize * offset)
+{
+  guint i;
+
+  /* zeroed so the keys can be compared with memcmp() */
+  memset (key, 0, sizeof (*key));
+  key->cache_id = cache_id;
+  key->n_fds = n_fds;
+
+  for (i = 0; i < n_fds; i++) {
+    struct stat st;
+
+    if (fstat (fd[i], &st) != 0)
+      return FALSE;
+
+    key->fd[i] = fd[i];
+    key->offset[i] = offset[i];
+    key->dev[i] = st.st_dev;
+    key->ino[i] = st.st_ino;
+  }
+
+  return TRUE;
+}
+
+static void
+_dma_buf_cached_image_free (DmabufCachedImage * cached)
+{
+  gst_egl_image_unref (cached->eglimage);
+  g_slice_free (DmabufCachedImage, cached);
+}
+
+static void
+_dma_buf_upload_flush_cache (struct DmabufUpload *dmabuf)
+{
+  g_queue_foreach (&dmabuf->eglimage_cache,
+      (GFunc) _dma_buf_cached_image_free, NULL);
+  g_queue_clear (&dmabuf->eglimage_cache);
+}
+
+static GstEGLImage *
+_dma_buf_upload_lookup_eglimage (struct DmabufUpload *dmabuf,
+    const DmabufImageKey * key)
+{
+  GList *l;
+
+  for (l = dmabuf->eglimage_cache.head; l; l = l->next) {
+    DmabufCachedImage *cached = l->data;
+
+    if (memcmp (&cached->key, key, sizeof (*key)) == 0) {
+      g_queue_unlink (&dmabuf->eglimage_cache, l);
+      g_queue_push_head_link (&dmabuf->eglimage_cache, l);
+      return cached->eglimage;
+    }
+  }
+
+  return NULL;
+}
+
+static void
+_dma_buf_upload_cache_eglimage (struct DmabufUpload *dmabuf,
+    const DmabufImageKey * key, GstEGLImage * eglimage)
+{
+  DmabufCachedImage *cached = g_slice_new (DmabufCachedImage);
+
+  cached->key = *key;
+  cached->eglimage = gst_egl_image_ref (eglimage);
+  g_queue_push_head (&dmabuf->eglimage_cache, cached);
+
+  while (dmabuf->eglimage_cache.length > DMABUF_EGLIMAGE_CACHE_SIZE)
+    _dma_buf_cached_image_free (g_queue_pop_tail (&dmabuf->eglimage_cache));
+}
+
 static gboolean
 _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
     GstCaps * out_caps)
@@ -656,6 +764,12 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
       return FALSE;
   }
 
+  /* images imported with a different layout can't be reused */
+  if (!gst_video_info_is_equal (in_info, &dmabuf->cache_info)) {
+    _dma_buf_upload_flush_cache (dmabuf);
+    dmabuf->cache_info = *in_info;
+  }
+
   if (dmabuf->params)
     gst_gl_allocation_params_free ((GstGLAllocationParams *) dmabuf->params);
   if (!(dmabuf->params =
@@ -699,6 +813,8 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
   /* Now create an EGLImage for each dmabufs */
   for (i = 0; i < dmabuf->n_mem; i++) {
     gint cache_id = dmabuf->direct ? 4 : i;
+    DmabufImageKey key;
+    gboolean have_key;
 
     /* check if one is cached */
     dmabuf->eglimage[i] = _get_cached_eglimage (mems[i], cache_id);
@@ -707,6 +823,24 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
       continue;
     }
 
+    /* or if the dmabuf was imported before through another memory */
+    if (dmabuf->direct)
+      have_key = _dma_buf_image_key_init (&key, cache_id, n_planes, fd,
+          offset);
+    else
+      have_key = _dma_buf_image_key_init (&key, cache_id, 1, &fd[i],
+          &offset[i]);
+
+    if (have_key)
+      dmabuf->eglimage[i] = _dma_buf_upload_lookup_eglimage (dmabuf, &key);
+    if (dmabuf->eglimage[i]) {
+      GST_TRACE_OBJECT (dmabuf->upload, "reusing EGLImage for fd %d", fd[i]);
+      _set_cached_eglimage (mems[i], gst_egl_image_ref (dmabuf->eglimage[i]),
+          cache_id);
+      dmabuf->formats[i] = dmabuf->eglimage[i]->format;
+      continue;
+    }
+
     /* otherwise create one and cache it */
     if (dmabuf->direct)
       dmabuf->eglimage[i] =
@@ -720,6 +854,8 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
       return FALSE;
 
     _set_cached_eglimage (mems[i], dmabuf->eglimage[i], cache_id);
+    if (have_key)
+      _dma_buf_upload_cache_eglimage (dmabuf, &key, dmabuf->eglimage[i]);
     dmabuf->formats[i] = dmabuf->eglimage[i]->format;
   }
 
@@ -733,12 +869,93 @@ _dma_buf_upload_propose_allocation (gpointer impl, GstQuery * decide_query,
   /* nothing to do for now. */
 }
 
+#ifndef EGL_SYNC_NATIVE_FENCE_ANDROID
+#define EGL_SYNC_NATIVE_FENCE_ANDROID 0x3144
+#endif
+#ifndef EGL_SYNC_NATIVE_FENCE_FD_ANDROID
+#define EGL_SYNC_NATIVE_FENCE_FD_ANDROID 0x3145
+#endif
+
+/* Make the GL command stream wait for the explicit fences producers attached
+ * to the dmabufs, so that neither we nor the producer have to block on the
+ * CPU. Falls back to waiting on the CPU without the needed EGL extensions. */
+static void
+_dma_buf_upload_wait_fences (GstGLContext * context, GstBuffer * buffer)
+{
+  gpointer (*gst_eglCreateSyncKHR) (EGLDisplay dpy, EGLenum type,
+      const EGLint * attrib_list) = NULL;
+  EGLint (*gst_eglWaitSyncKHR) (EGLDisplay dpy, gpointer sync,
+      EGLint flags) = NULL;
+  EGLBoolean (*gst_eglDestroySyncKHR) (EGLDisplay dpy, gpointer sync) = NULL;
+  EGLDisplay egl_display = EGL_NO_DISPLAY;
+  guint i, n_mem;
+
+  n_mem = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+    gint fence;
+
+    if (!gst_is_dmabuf_memory (mem))
+      continue;
+
+    fence = gst_dmabuf_memory_get_fence (mem);
+    if (fence < 0)
+      continue;
+
+    if (egl_display == EGL_NO_DISPLAY
+        && gst_gl_context_check_feature (context,
+            "EGL_ANDROID_native_fence_sync")
+        && gst_gl_context_check_feature (context, "EGL_KHR_wait_sync")) {
+      GstGLDisplayEGL *display_egl;
+
+      gst_eglCreateSyncKHR =
+          gst_gl_context_get_proc_address (context, "eglCreateSyncKHR");
+      gst_eglWaitSyncKHR =
+          gst_gl_context_get_proc_address (context, "eglWaitSyncKHR");
+      gst_eglDestroySyncKHR =
+          gst_gl_context_get_proc_address (context, "eglDestroySyncKHR");
+
+      display_egl = gst_gl_display_egl_from_gl_display (context->display);
+      if (display_egl) {
+        egl_display = (EGLDisplay)
+            gst_gl_display_get_handle (GST_GL_DISPLAY (display_egl));
+        gst_object_unref (display_egl);
+      }
+    }
+
+    if (egl_display != EGL_NO_DISPLAY && gst_eglCreateSyncKHR
+        && gst_eglWaitSyncKHR && gst_eglDestroySyncKHR) {
+      EGLint attribs[] = { EGL_SYNC_NATIVE_FENCE_FD_ANDROID, -1, EGL_NONE };
+      gpointer sync;
+
+      /* the EGL sync takes ownership of the fd */
+      attribs[1] = dup (fence);
+      sync = gst_eglCreateSyncKHR (egl_display, EGL_SYNC_NATIVE_FENCE_ANDROID,
+          attribs);
+      if (sync) {
+        GST_LOG ("waiting on dmabuf fence %d in the GL command stream", fence);
+        gst_eglWaitSyncKHR (egl_display, sync, 0);
+        gst_eglDestroySyncKHR (egl_display, sync);
+        continue;
+      }
+
+      if (attribs[1] >= 0)
+        close (attribs[1]);
+    }
+
+    GST_LOG ("waiting on dmabuf fence %d from the CPU", fence);
+    gst_dmabuf_memory_wait (mem, GST_MAP_READ, GST_CLOCK_TIME_NONE);
+  }
+}
+
 static void
 _dma_buf_upload_perform_gl_thread (GstGLContext * context,
     struct DmabufUpload *dmabuf)
 {
   GstGLMemoryAllocator *allocator;
 
+  _dma_buf_upload_wait_fences (context, dmabuf->inbuf);
+
   allocator =
       GST_GL_MEMORY_ALLOCATOR (gst_allocator_find
       (GST_GL_MEMORY_EGL_ALLOCATOR_NAME));
@@ -755,8 +972,10 @@ _dma_buf_upload_perform (gpointer impl, GstBuffer * buffer, GstBuffer ** outbuf)
 {
   struct DmabufUpload *dmabuf = impl;
 
+  dmabuf->inbuf = buffer;
   gst_gl_context_thread_add (dmabuf->upload->context,
       (GstGLContextThreadFunc) _dma_buf_upload_perform_gl_thread, dmabuf);
+  dmabuf->inbuf = NULL;
 
   if (!dmabuf->outbuf)
     return GST_GL_UPLOAD_ERROR;
@@ -777,6 +996,8 @@ _dma_buf_upload_free (gpointer impl)
   if (dmabuf->params)
     gst_gl_allocation_params_free ((GstGLAllocationParams *) dmabuf->params);
 
+  _dma_buf_upload_flush_cache (dmabuf);
+
   g_free (impl);
 }
 
@@ -1138,11 +1359,19 @@ struct RawUploadFrame
   GstVideoFrame frame;
 };
 
+/* textures kept around for uploading raw frames, at least two so that a
+ * frame is not written while the previous one may still be read */
+#define RAW_UPLOAD_MIN_TEXTURES 2
+
 struct RawUpload
 {
   GstGLUpload *upload;
   struct RawUploadFrame *in_frame;
   GstGLVideoAllocationParams *params;
+
+  /* pool of textures with the layout of pool_info */
+  GstBufferPool *pool;
+  GstVideoInfo pool_info;
 };
 
 static struct RawUploadFrame *
@@ -1244,6 +1473,141 @@ _raw_data_upload_transform_caps (gpointer impl, GstGLContext * context,
   return ret;
 }
 
+static void
+_raw_data_upload_clear_pool (struct RawUpload *raw)
+{
+  if (raw->pool) {
+    gst_buffer_pool_set_active (raw->pool, FALSE);
+    gst_object_unref (raw->pool);
+    raw->pool = NULL;
+  }
+}
+
+/* The textures are created with the strides of the input frames so that
+ * they can be uploaded directly with the matching unpack row length */
+static gboolean
+_raw_data_upload_ensure_pool (struct RawUpload *raw)
+{
+  GstVideoInfo *in_info = &raw->upload->priv->in_info;
+  GstGLVideoAllocationParams *params;
+  GstStructure *config;
+  GstCaps *caps;
+
+  if (raw->pool && gst_video_info_is_equal (&raw->pool_info, in_info)
+      && GST_GL_BUFFER_POOL (raw->pool)->context == raw->upload->context)
+    return TRUE;
+
+  _raw_data_upload_clear_pool (raw);
+
+  caps = gst_video_info_to_caps (in_info);
+  if (!caps)
+    return FALSE;
+
+  raw->pool = gst_gl_buffer_pool_new (raw->upload->context);
+  config = gst_buffer_pool_get_config (raw->pool);
+  gst_buffer_pool_config_set_params (config, caps, in_info->size,
+      RAW_UPLOAD_MIN_TEXTURES, 0);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_GL_SYNC_META);
+  gst_caps_unref (caps);
+
+  params = gst_gl_video_allocation_params_new (raw->upload->context, NULL,
+      in_info, -1, NULL, GST_GL_TEXTURE_TARGET_2D, 0);
+  gst_buffer_pool_config_set_gl_allocation_params (config,
+      (GstGLAllocationParams *) params);
+  gst_gl_allocation_params_free ((GstGLAllocationParams *) params);
+
+  if (!gst_buffer_pool_set_config (raw->pool, config)
+      || !gst_buffer_pool_set_active (raw->pool, TRUE)) {
+    GST_WARNING_OBJECT (raw->upload, "failed to set up texture pool");
+    _raw_data_upload_clear_pool (raw);
+    return FALSE;
+  }
+
+  raw->pool_info = *in_info;
+
+  return TRUE;
+}
+
+struct RawUploadTexImage
+{
+  struct RawUpload *raw;
+  GstBuffer *outbuf;
+  gboolean result;
+};
+
+static void
+_raw_data_upload_texsubimage (GstGLContext * context,
+    struct RawUploadTexImage *data)
+{
+  struct RawUpload *raw = data->raw;
+  GstVideoFrame *frame = &raw->in_frame->frame;
+  GstGLSyncMeta *sync_meta;
+  guint i, n_mem;
+
+  n_mem = gst_buffer_n_memory (data->outbuf);
+  g_assert (n_mem == GST_VIDEO_FRAME_N_PLANES (frame));
+
+  data->result = TRUE;
+  for (i = 0; i < n_mem; i++) {
+    GstGLMemory *gl_mem =
+        (GstGLMemory *) gst_buffer_peek_memory (data->outbuf, i);
+    GstMapInfo map_info;
+    gsize plane_start;
+
+    if (!gst_memory_map ((GstMemory *) gl_mem, &map_info,
+            GST_MAP_WRITE | GST_MAP_GL)) {
+      data->result = FALSE;
+      break;
+    }
+
+    /* gst_gl_memory_texsubimage() adds the plane start to the pointer */
+    plane_start = gst_gl_get_plane_start (&gl_mem->info, &gl_mem->valign,
+        gl_mem->plane) + gl_mem->mem.mem.offset;
+
+    GST_MINI_OBJECT_FLAG_SET (gl_mem, GST_GL_BASE_MEMORY_TRANSFER_NEED_UPLOAD);
+    gst_gl_memory_texsubimage (gl_mem,
+        (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, i) - plane_start);
+    GST_MINI_OBJECT_FLAG_UNSET (gl_mem,
+        GST_GL_BASE_MEMORY_TRANSFER_NEED_UPLOAD);
+
+    gst_memory_unmap ((GstMemory *) gl_mem, &map_info);
+  }
+
+  sync_meta = gst_buffer_get_gl_sync_meta (data->outbuf);
+  if (sync_meta)
+    gst_gl_sync_meta_set_sync_point (sync_meta, context);
+}
+
+/* upload into one of the textures of the pool, returns %FALSE if the frame
+ * has to be wrapped instead */
+static gboolean
+_raw_data_upload_to_pool (struct RawUpload *raw, GstBuffer ** outbuf)
+{
+  struct RawUploadTexImage data;
+
+  if (!_raw_data_upload_ensure_pool (raw))
+    return FALSE;
+
+  if (gst_buffer_pool_acquire_buffer (raw->pool, outbuf, NULL) != GST_FLOW_OK)
+    return FALSE;
+
+  data.raw = raw;
+  data.outbuf = *outbuf;
+  data.result = FALSE;
+  gst_gl_context_thread_add (raw->upload->context,
+      (GstGLContextThreadFunc) _raw_data_upload_texsubimage, &data);
+
+  if (!data.result) {
+    GST_WARNING_OBJECT (raw->upload, "failed to upload into pooled texture");
+    gst_buffer_unref (*outbuf);
+    *outbuf = NULL;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static gboolean
 _raw_data_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
     GstCaps * out_caps)
@@ -1288,11 +1652,17 @@ _raw_data_upload_perform (gpointer impl, GstBuffer * buffer,
   GstVideoInfo *in_info = &raw->upload->priv->in_info;
   guint n_mem = GST_VIDEO_INFO_N_PLANES (in_info);
 
+  if (_raw_data_upload_to_pool (raw, outbuf)) {
+    _raw_upload_frame_unref (raw->in_frame);
+    raw->in_frame = NULL;
+
+    return GST_GL_UPLOAD_DONE;
+  }
+
   allocator =
       GST_GL_BASE_MEMORY_ALLOCATOR (gst_gl_memory_allocator_get_default
       (raw->upload->context));
 
-  /* FIXME Use a buffer pool to cache the generated textures */
   *outbuf = gst_buffer_new ();
   raw->params->parent.context = raw->upload->context;
   if (gst_gl_memory_setup_buffer ((GstGLMemoryAllocator *) allocator, *outbuf,
@@ -1322,6 +1692,8 @@ _raw_data_upload_free (gpointer impl)
   if (raw->params)
     gst_gl_allocation_params_free ((GstGLAllocationParams *) raw->params);
 
+  _raw_data_upload_clear_pool (raw);
+
   g_free (raw);
 }
 
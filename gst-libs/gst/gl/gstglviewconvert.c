@@ -1914,8 +1914,12 @@ _do_view_convert_draw (GstGLContext * context, GstGLViewConvert * viewconvert)
   else if (gl->DrawBuffer)
     gl->DrawBuffer (GL_COLOR_ATTACHMENT0);
 
+  /* output textures may be padded beyond the video size, only render to the
+   * valid area so that all the views can be written directly in one pass */
   gst_gl_framebuffer_get_effective_dimensions (viewconvert->fbo, &out_width,
       &out_height);
+  out_width = MIN (out_width, GST_VIDEO_INFO_WIDTH (&viewconvert->out_info));
+  out_height = MIN (out_height, GST_VIDEO_INFO_HEIGHT (&viewconvert->out_info));
   gl->Viewport (0, 0, out_width, out_height);
 
   gst_gl_shader_use (viewconvert->shader);
@@ -2113,10 +2117,11 @@ _do_view_convert (GstGLContext * context, GstGLViewConvert * viewconvert)
         height);
     if (out_tex->tex_format == GST_GL_LUMINANCE
         || out_tex->tex_format == GST_GL_LUMINANCE_ALPHA
-        || out_width != width || out_height != height) {
+        || out_width > width || out_height > height) {
       /* Luminance formats are not color renderable */
       /* rendering to a framebuffer only renders the intersection of all
-       * the attachments i.e. the smallest attachment size */
+       * the attachments i.e. the smallest attachment size. Larger (padded)
+       * textures are rendered to directly with a clipped viewport */
       if (!priv->out_tex[j]) {
         GstGLVideoAllocationParams *params;
         GstGLBaseMemoryAllocator *base_mem_allocator;
@@ -2191,17 +2196,20 @@ out:
               &from_info, GST_MAP_READ | GST_MAP_GL)) {
         GST_ERROR_OBJECT (viewconvert, "Failed to map intermediate memory");
         res = FALSE;
-        continue;
-      }
-      if (!gst_memory_map ((GstMemory *) out_tex, &to_info,
-              GST_MAP_WRITE | GST_MAP_GL)) {
-        GST_ERROR_OBJECT (viewconvert, "Failed to map intermediate memory");
-        res = FALSE;
-        continue;
+      } else {
+        if (!gst_memory_map ((GstMemory *) out_tex, &to_info,
+                GST_MAP_WRITE | GST_MAP_GL)) {
+          GST_ERROR_OBJECT (viewconvert, "Failed to map intermediate memory");
+          res = FALSE;
+        } else {
+          gst_gl_memory_copy_into (priv->out_tex[j], out_tex->tex_id,
+              viewconvert->to_texture_target, out_tex->tex_format, width,
+              height);
+          gst_memory_unmap ((GstMemory *) out_tex, &to_info);
+        }
+        gst_memory_unmap ((GstMemory *) priv->out_tex[j], &from_info);
       }
-      gst_gl_memory_copy_into (priv->out_tex[j], out_tex->tex_id,
-          viewconvert->to_texture_target, out_tex->tex_format, width, height);
-      gst_memory_unmap ((GstMemory *) out_tex, &to_info);
+      gst_memory_unref ((GstMemory *) priv->out_tex[j]);
     }
 
     priv->out_tex[j] = NULL;
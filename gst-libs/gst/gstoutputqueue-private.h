@@ -0,0 +1,247 @@
+/* GStreamer
+ *
+ * gstoutputqueue-private.h: output queue of the codec base classes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_OUTPUT_QUEUE_PRIVATE_H__
+#define __GST_OUTPUT_QUEUE_PRIVATE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* A queue of buffers and serialized events in front of a source pad, pushed
+ * downstream by a task on that pad so that the streaming thread can carry on
+ * while downstream is busy. Used by the GstVideoDecoder, GstAudioDecoder and
+ * GstAudioEncoder base classes, which live in different libraries, hence all
+ * functions are inline. */
+
+typedef GstFlowReturn (*GstOutputQueuePushFunc) (GstObject * parent,
+    GstBuffer * buf);
+
+typedef struct
+{
+  GstObject *parent;
+  GstPad *srcpad;
+  GstOutputQueuePushFunc push;
+  GstDebugCategory *cat;
+
+  GMutex lock;
+  GCond cond;
+  /* of buffers and serialized events, lock */
+  GQueue items;
+  guint buffers;
+  GstClockTime duration;
+  gboolean flushing;
+  gboolean task_started;
+  GstFlowReturn ret;
+} GstOutputQueue;
+
+/* @push is called from the task to push the buffers, the events are pushed
+ * on @srcpad directly. Messages are logged in @cat. */
+static inline void
+gst_output_queue_init (GstOutputQueue * queue, GstObject * parent,
+    GstPad * srcpad, GstOutputQueuePushFunc push, GstDebugCategory * cat)
+{
+  queue->parent = parent;
+  queue->srcpad = srcpad;
+  queue->push = push;
+  queue->cat = cat;
+  g_mutex_init (&queue->lock);
+  g_cond_init (&queue->cond);
+  g_queue_init (&queue->items);
+  queue->flushing = FALSE;
+  queue->ret = GST_FLOW_OK;
+}
+
+/* with lock */
+static inline void
+gst_output_queue_flush_items (GstOutputQueue * queue)
+{
+  GstMiniObject *item;
+
+  while ((item = g_queue_pop_head (&queue->items))) {
+    /* sticky events are stored on the pad when pushed, keep them
+     * around so that they're sent again after a flush */
+    if (GST_IS_EVENT (item) && GST_EVENT_IS_STICKY (item)
+        && GST_EVENT_TYPE (item) != GST_EVENT_EOS
+        && GST_EVENT_TYPE (item) != GST_EVENT_SEGMENT)
+      gst_pad_store_sticky_event (queue->srcpad, GST_EVENT_CAST (item));
+    gst_mini_object_unref (item);
+  }
+  queue->buffers = 0;
+  queue->duration = 0;
+  g_cond_broadcast (&queue->cond);
+}
+
+static inline void
+gst_output_queue_clear (GstOutputQueue * queue)
+{
+  g_queue_clear_full (&queue->items, (GDestroyNotify) gst_mini_object_unref);
+  g_mutex_clear (&queue->lock);
+  g_cond_clear (&queue->cond);
+}
+
+static inline void
+gst_output_queue_loop (GstOutputQueue * queue)
+{
+  GstMiniObject *item;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&queue->lock);
+  while (g_queue_is_empty (&queue->items) && !queue->flushing)
+    g_cond_wait (&queue->cond, &queue->lock);
+
+  if (queue->flushing)
+    goto pause;
+
+  /* leave the item in the queue while pushing, so that draining waits for
+   * it too */
+  item = g_queue_peek_head (&queue->items);
+  g_mutex_unlock (&queue->lock);
+
+  if (GST_IS_BUFFER (item)) {
+    ret = queue->push (queue->parent, gst_buffer_ref (GST_BUFFER_CAST (item)));
+  } else {
+    GST_CAT_DEBUG_OBJECT (queue->cat, queue->parent, "pushing event %s",
+        GST_EVENT_TYPE_NAME (GST_EVENT_CAST (item)));
+    gst_pad_push_event (queue->srcpad, gst_event_ref (GST_EVENT_CAST (item)));
+  }
+
+  g_mutex_lock (&queue->lock);
+  /* a flush may have cleared the queue meanwhile */
+  if (!queue->flushing && g_queue_peek_head (&queue->items) == item) {
+    g_queue_pop_head (&queue->items);
+    if (GST_IS_BUFFER (item)) {
+      GstClockTime duration = GST_BUFFER_DURATION (item);
+
+      queue->buffers--;
+      if (GST_CLOCK_TIME_IS_VALID (duration))
+        queue->duration -= MIN (duration, queue->duration);
+    }
+    gst_mini_object_unref (item);
+  }
+  g_cond_broadcast (&queue->cond);
+
+  if (ret == GST_FLOW_OK || queue->flushing) {
+    g_mutex_unlock (&queue->lock);
+    return;
+  }
+
+  GST_CAT_DEBUG_OBJECT (queue->cat, queue->parent,
+      "pausing output task, reason %s", gst_flow_get_name (ret));
+  queue->ret = ret;
+  /* returned to the streaming thread on its next push */
+  gst_output_queue_flush_items (queue);
+
+pause:
+  queue->task_started = FALSE;
+  gst_pad_pause_task (queue->srcpad);
+  g_mutex_unlock (&queue->lock);
+}
+
+/* queues @item, waiting for room first if it is a buffer and the queue holds
+ * @max_buffers or @max_time already (0 meaning unlimited) */
+static inline GstFlowReturn
+gst_output_queue_push (GstOutputQueue * queue, GstMiniObject * item,
+    guint max_buffers, GstClockTime max_time)
+{
+  GstFlowReturn ret;
+
+  g_mutex_lock (&queue->lock);
+  if (GST_IS_BUFFER (item)) {
+    while (!queue->flushing && queue->ret == GST_FLOW_OK
+        && ((max_buffers && queue->buffers >= max_buffers)
+            || (max_time && queue->duration >= max_time)))
+      g_cond_wait (&queue->cond, &queue->lock);
+  }
+
+  if (queue->flushing)
+    ret = GST_FLOW_FLUSHING;
+  else
+    ret = queue->ret;
+
+  if (ret != GST_FLOW_OK) {
+    g_mutex_unlock (&queue->lock);
+    gst_mini_object_unref (item);
+    return ret;
+  }
+
+  g_queue_push_tail (&queue->items, item);
+  if (GST_IS_BUFFER (item)) {
+    GstClockTime duration = GST_BUFFER_DURATION (item);
+
+    queue->buffers++;
+    if (GST_CLOCK_TIME_IS_VALID (duration))
+      queue->duration += duration;
+  }
+  g_cond_broadcast (&queue->cond);
+
+  if (!queue->task_started) {
+    queue->task_started = gst_pad_start_task (queue->srcpad,
+        (GstTaskFunction) gst_output_queue_loop, queue, NULL);
+    if (!queue->task_started)
+      GST_CAT_ERROR_OBJECT (queue->cat, queue->parent,
+          "failed to start output task");
+  }
+  g_mutex_unlock (&queue->lock);
+
+  return ret;
+}
+
+/* waits until everything queued so far has been pushed */
+static inline void
+gst_output_queue_drain (GstOutputQueue * queue)
+{
+  g_mutex_lock (&queue->lock);
+  while (!g_queue_is_empty (&queue->items) && !queue->flushing)
+    g_cond_wait (&queue->cond, &queue->lock);
+  g_mutex_unlock (&queue->lock);
+}
+
+/* unblocks the streaming thread and the task when @flushing, resets the
+ * queue otherwise */
+static inline void
+gst_output_queue_set_flushing (GstOutputQueue * queue, gboolean flushing)
+{
+  g_mutex_lock (&queue->lock);
+  queue->flushing = flushing;
+  if (!flushing) {
+    gst_output_queue_flush_items (queue);
+    queue->ret = GST_FLOW_OK;
+  }
+  g_cond_broadcast (&queue->cond);
+  g_mutex_unlock (&queue->lock);
+}
+
+/* when deactivating the source pad */
+static inline void
+gst_output_queue_stop (GstOutputQueue * queue)
+{
+  gst_output_queue_set_flushing (queue, TRUE);
+  gst_pad_stop_task (queue->srcpad);
+
+  g_mutex_lock (&queue->lock);
+  gst_output_queue_flush_items (queue);
+  queue->task_started = FALSE;
+  g_mutex_unlock (&queue->lock);
+}
+
+G_END_DECLS
+
+#endif /* __GST_OUTPUT_QUEUE_PRIVATE_H__ */
@@ -0,0 +1,97 @@
+/* GStreamer
+ *
+ * gstprocessingstats-private.h: processing time statistics of the base
+ * classes
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_PROCESSING_STATS_PRIVATE_H__
+#define __GST_PROCESSING_STATS_PRIVATE_H__
+
+#include <gst/gst.h>
+#include <string.h>
+
+G_BEGIN_DECLS
+
+/* Total, maximum and histogram of the time spent processing, reported in
+ * the "stats" property of the decoder, encoder and aggregator base classes
+ * of libgstvideo and libgstaudio, hence all functions are inline. Callers
+ * provide the locking. */
+
+/* power of two microsecond buckets of the histogram */
+#define GST_PROCESSING_STATS_HISTOGRAM_SIZE 20
+
+typedef struct
+{
+  GstClockTime time;
+  GstClockTime time_max;
+  guint64 count;
+  guint64 histogram[GST_PROCESSING_STATS_HISTOGRAM_SIZE];
+} GstProcessingStats;
+
+static inline void
+gst_processing_stats_reset (GstProcessingStats * stats)
+{
+  memset (stats, 0, sizeof (GstProcessingStats));
+}
+
+static inline void
+gst_processing_stats_add (GstProcessingStats * stats, GstClockTime elapsed)
+{
+  stats->time += elapsed;
+  stats->time_max = MAX (stats->time_max, elapsed);
+  stats->count++;
+  stats->histogram[MIN (g_bit_storage (elapsed / GST_USECOND) - 1,
+          GST_PROCESSING_STATS_HISTOGRAM_SIZE - 1)]++;
+}
+
+/* sets the "@name-time", "@name-time-max" and "@name-time-histogram"
+ * fields and the count in the @count_field field of @s */
+static inline void
+gst_processing_stats_set_fields (const GstProcessingStats * stats,
+    GstStructure * s, const gchar * name, const gchar * count_field)
+{
+  GValue histogram = G_VALUE_INIT;
+  gchar *field;
+  guint i;
+
+  field = g_strdup_printf ("%s-time", name);
+  gst_structure_set (s, field, G_TYPE_UINT64, stats->time, NULL);
+  g_free (field);
+
+  field = g_strdup_printf ("%s-time-max", name);
+  gst_structure_set (s, field, G_TYPE_UINT64, stats->time_max, NULL);
+  g_free (field);
+
+  gst_structure_set (s, count_field, G_TYPE_UINT64, stats->count, NULL);
+
+  g_value_init (&histogram, GST_TYPE_ARRAY);
+  for (i = 0; i < GST_PROCESSING_STATS_HISTOGRAM_SIZE; i++) {
+    GValue v = G_VALUE_INIT;
+
+    g_value_init (&v, G_TYPE_UINT64);
+    g_value_set_uint64 (&v, stats->histogram[i]);
+    gst_value_array_append_and_take_value (&histogram, &v);
+  }
+  field = g_strdup_printf ("%s-time-histogram", name);
+  gst_structure_take_value (s, field, &histogram);
+  g_free (field);
+}
+
+G_END_DECLS
+
+#endif /* __GST_PROCESSING_STATS_PRIVATE_H__ */
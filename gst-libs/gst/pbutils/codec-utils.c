@@ -49,6 +49,25 @@
 #define GST_SIMPLE_CAPS_HAS_FIELD(caps,field) \
     gst_structure_has_field(gst_caps_get_structure((caps),0),(field))
 
+/* Sets field to one of the static profile/level strings of this file without
+ * copying it, and leaves the structure untouched if it already has that value,
+ * as parsers call the caps_set functions for every repeated SPS or config */
+static void
+codec_utils_structure_set_string (GstStructure * s, const gchar * field,
+    const gchar * value)
+{
+  const gchar *old;
+  GValue v = G_VALUE_INIT;
+
+  old = gst_structure_get_string (s, field);
+  if (old != NULL && strcmp (old, value) == 0)
+    return;
+
+  g_value_init (&v, G_TYPE_STRING);
+  g_value_set_static_string (&v, value);
+  gst_structure_take_value (s, field, &v);
+}
+
 static const guint aac_sample_rates[] = { 96000, 88200, 64000, 48000, 44100,
   32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350
 };
@@ -525,17 +544,14 @@ gst_codec_utils_aac_caps_set_level_and_profile (GstCaps * caps,
   level = gst_codec_utils_aac_get_level (audio_config, len);
 
   if (level != NULL)
-    gst_structure_set (s, "level", G_TYPE_STRING, level, NULL);
+    codec_utils_structure_set_string (s, "level", level);
 
   profile = gst_codec_utils_aac_get_profile (audio_config, len);
 
   if (profile != NULL) {
-    if (mpegversion == 4) {
-      gst_structure_set (s, "base-profile", G_TYPE_STRING, profile,
-          "profile", G_TYPE_STRING, profile, NULL);
-    } else {
-      gst_structure_set (s, "profile", G_TYPE_STRING, profile, NULL);
-    }
+    if (mpegversion == 4)
+      codec_utils_structure_set_string (s, "base-profile", profile);
+    codec_utils_structure_set_string (s, "profile", profile);
   }
 
   GST_LOG ("profile : %s", (profile) ? profile : "---");
@@ -795,12 +811,14 @@ gst_codec_utils_h264_caps_set_level_and_profile (GstCaps * caps,
   level = gst_codec_utils_h264_get_level (sps, len);
 
   if (level != NULL)
-    gst_caps_set_simple (caps, "level", G_TYPE_STRING, level, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "level", level);
 
   profile = gst_codec_utils_h264_get_profile (sps, len);
 
   if (profile != NULL)
-    gst_caps_set_simple (caps, "profile", G_TYPE_STRING, profile, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "profile", profile);
 
   GST_LOG ("profile : %s", (profile) ? profile : "---");
   GST_LOG ("level   : %s", (level) ? level : "---");
@@ -1341,15 +1359,18 @@ gst_codec_utils_h265_caps_set_level_tier_and_profile (GstCaps * caps,
 
   level = gst_codec_utils_h265_get_level (profile_tier_level, len);
   if (level != NULL)
-    gst_caps_set_simple (caps, "level", G_TYPE_STRING, level, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "level", level);
 
   tier = gst_codec_utils_h265_get_tier (profile_tier_level, len);
   if (tier != NULL)
-    gst_caps_set_simple (caps, "tier", G_TYPE_STRING, tier, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "tier", tier);
 
   profile = gst_codec_utils_h265_get_profile (profile_tier_level, len);
   if (profile != NULL)
-    gst_caps_set_simple (caps, "profile", G_TYPE_STRING, profile, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "profile", profile);
 
   GST_LOG ("profile : %s", (profile) ? profile : "---");
   GST_LOG ("tier    : %s", (tier) ? tier : "---");
@@ -1550,12 +1571,14 @@ gst_codec_utils_mpeg4video_caps_set_level_and_profile (GstCaps * caps,
   profile = gst_codec_utils_mpeg4video_get_profile (vis_obj_seq, len);
 
   if (profile != NULL)
-    gst_caps_set_simple (caps, "profile", G_TYPE_STRING, profile, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "profile", profile);
 
   level = gst_codec_utils_mpeg4video_get_level (vis_obj_seq, len);
 
   if (level != NULL)
-    gst_caps_set_simple (caps, "level", G_TYPE_STRING, level, NULL);
+    codec_utils_structure_set_string (gst_caps_get_structure (caps, 0),
+        "level", level);
 
   GST_LOG ("profile : %s", (profile) ? profile : "---");
   GST_LOG ("level   : %s", (level) ? level : "---");
@@ -2029,6 +2029,7 @@ gst_encoding_profile_copy (GstEncodingProfile * self)
 
   copy->enabled = self->enabled;
   copy->allow_dynamic_output = self->allow_dynamic_output;
+  copy->single_segment = self->single_segment;
   gst_encoding_profile_set_preset_name (copy, self->preset_name);
   gst_encoding_profile_set_description (copy, self->description);
 
@@ -83,6 +83,7 @@
 #include <locale.h>
 #include <errno.h>
 #include <string.h>
+#include <glib/gstdio.h>
 #include "encoding-target.h"
 #include "pbutils-private.h"
 
@@ -703,6 +704,108 @@ parse_keyfile (GKeyFile * in, gchar * targetname, gchar * categoryname,
   return res;
 }
 
+/* Process-wide cache of the targets loaded from files, keyed by file path.
+ * An entry is only used while the modification time and size of the file
+ * are unchanged, and callers always get a copy of the cached target as
+ * targets can be modified */
+typedef struct
+{
+  gint64 mtime;
+  goffset size;
+  GstEncodingTarget *target;
+} CachedTarget;
+
+static GMutex target_cache_lock;
+static GHashTable *target_cache = NULL;
+
+static void
+cached_target_free (CachedTarget * cached)
+{
+  gst_encoding_target_unref (cached->target);
+  g_slice_free (CachedTarget, cached);
+}
+
+static GstEncodingTarget *
+gst_encoding_target_copy (GstEncodingTarget * target)
+{
+  GstEncodingTarget *res;
+  GList *tmp;
+
+  res = (GstEncodingTarget *) g_object_new (GST_TYPE_ENCODING_TARGET, NULL);
+  res->name = g_strdup (target->name);
+  res->category = g_strdup (target->category);
+  res->description = g_strdup (target->description);
+
+  for (tmp = target->profiles; tmp; tmp = tmp->next)
+    res->profiles = g_list_prepend (res->profiles,
+        gst_encoding_profile_copy (tmp->data));
+  res->profiles = g_list_reverse (res->profiles);
+
+  return res;
+}
+
+static gboolean
+get_file_stamp (const gchar * path, gint64 * mtime, goffset * size)
+{
+  GStatBuf st;
+
+  if (g_stat (path, &st) != 0)
+    return FALSE;
+
+  *mtime = (gint64) st.st_mtime;
+  *size = st.st_size;
+
+  return TRUE;
+}
+
+static GstEncodingTarget *
+target_cache_lookup (const gchar * path, gint64 mtime, goffset size)
+{
+  GstEncodingTarget *res = NULL;
+  CachedTarget *cached;
+
+  g_mutex_lock (&target_cache_lock);
+  if (target_cache) {
+    cached = g_hash_table_lookup (target_cache, path);
+    if (cached && cached->mtime == mtime && cached->size == size)
+      res = gst_encoding_target_copy (cached->target);
+  }
+  g_mutex_unlock (&target_cache_lock);
+
+  if (res)
+    GST_DEBUG ("Using cached target for %s", path);
+
+  return res;
+}
+
+static void
+target_cache_store (const gchar * path, gint64 mtime, goffset size,
+    GstEncodingTarget * target)
+{
+  CachedTarget *cached;
+
+  cached = g_slice_new (CachedTarget);
+  cached->mtime = mtime;
+  cached->size = size;
+  cached->target = gst_encoding_target_copy (target);
+
+  g_mutex_lock (&target_cache_lock);
+  if (!target_cache)
+    target_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) cached_target_free);
+  g_hash_table_replace (target_cache, g_strdup (path), cached);
+  g_mutex_unlock (&target_cache_lock);
+}
+
+static void
+target_cache_remove (const gchar * path)
+{
+  g_mutex_lock (&target_cache_lock);
+  if (target_cache)
+    g_hash_table_remove (target_cache, path);
+  g_mutex_unlock (&target_cache_lock);
+}
+
 static GKeyFile *
 load_file_and_read_header (const gchar * path, gchar ** targetname,
     gchar ** categoryname, gchar ** description, GError ** error)
@@ -762,6 +865,10 @@ empty_name:
  *
  * Opens the provided file and returns the contained #GstEncodingTarget.
  *
+ * Parsed targets are cached for the lifetime of the process. The file is
+ * only parsed again if its modification time or size changed since it was
+ * last loaded.
+ *
  * Returns: (transfer full): The #GstEncodingTarget contained in the file, else
  * %NULL
  */
@@ -772,6 +879,18 @@ gst_encoding_target_load_from_file (const gchar * filepath, GError ** error)
   GKeyFile *in;
   gchar *targetname, *categoryname, *description;
   GstEncodingTarget *res = NULL;
+  gboolean have_stamp;
+  gint64 mtime;
+  goffset size;
+
+  g_return_val_if_fail (filepath != NULL, NULL);
+
+  have_stamp = get_file_stamp (filepath, &mtime, &size);
+  if (have_stamp) {
+    res = target_cache_lookup (filepath, mtime, size);
+    if (res)
+      goto beach;
+  }
 
   in = load_file_and_read_header (filepath, &targetname, &categoryname,
       &description, error);
@@ -782,6 +901,9 @@ gst_encoding_target_load_from_file (const gchar * filepath, GError ** error)
 
   g_key_file_free (in);
 
+  if (res && have_stamp)
+    target_cache_store (filepath, mtime, size, res);
+
 beach:
   return res;
 }
@@ -1007,6 +1129,10 @@ gst_encoding_target_save_to_file (GstEncodingTarget * target,
   if (!(data = g_key_file_to_data (out, &data_size, error)))
     goto convert_failed;
 
+  /* the modification time might not change if the file is saved again
+   * within its granularity */
+  target_cache_remove (filepath);
+
   if (!g_file_set_contents (filepath, data, data_size, error))
     goto write_failed;
 
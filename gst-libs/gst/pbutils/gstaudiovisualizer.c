@@ -138,52 +138,57 @@ struct _GstAudioVisualizerPrivate
 
 /* shading functions */
 
-/* we're only supporting GST_VIDEO_FORMAT_xRGB right now) */
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-
-#define SHADE(_d, _s, _i, _r, _g, _b)                     \
-G_STMT_START {                                            \
-    _d[_i * 4 + 0] = (_s[_i * 4 + 0] > _b) ? _s[_i * 4 + 0] - _b : 0; \
-    _d[_i * 4 + 1] = (_s[_i * 4 + 1] > _g) ? _s[_i * 4 + 1] - _g : 0; \
-    _d[_i * 4 + 2] = (_s[_i * 4 + 2] > _r) ? _s[_i * 4 + 2] - _r : 0; \
-    _d[_i * 4 + 3] = 0;                                       \
-} G_STMT_END
-
-#else /* G_BYTE_ORDER == G_LITTLE_ENDIAN */
-
-#define SHADE(_d, _s, _i, _r, _g, _b)                     \
-G_STMT_START {                                            \
-    _d[_i * 4 + 0] = 0;                                       \
-    _d[_i * 4 + 1] = (_s[_i * 4 + 1] > _r) ? _s[_i * 4 + 1] - _r : 0; \
-    _d[_i * 4 + 2] = (_s[_i * 4 + 2] > _g) ? _s[_i * 4 + 2] - _g : 0; \
-    _d[_i * 4 + 3] = (_s[_i * 4 + 3] > _b) ? _s[_i * 4 + 3] - _b : 0; \
-} G_STMT_END
+/* we're only supporting GST_VIDEO_FORMAT_xRGB right now). Pixels are handled
+ * as native endian 32 bit words, which for both xRGB and BGRx have the x
+ * component in the top byte.
+ *
+ * The saturating subtraction is done on the even and the odd bytes in two
+ * 16 bit lanes each: with 0x100 added to a lane, bit 8 stays set after the
+ * subtraction when the component was larger than the amount and is used to
+ * mask the result. The amount for x is 0xff so that it always ends up 0. */
+static inline void
+shade_line (guint32 * d, const guint32 * s, gint width, guint32 amount)
+{
+  guint32 ae = amount & 0x00ff00ff, ao = (amount >> 8) & 0x00ff00ff;
+  gint i;
 
-#endif
+  for (i = 0; i < width; i++) {
+    guint32 p = s[i], te, to;
+
+    te = ((p & 0x00ff00ff) | 0x01000100) - ae;
+    te &= ((te >> 8) & 0x00010001) * 0xff;
+    to = (((p >> 8) & 0x00ff00ff) | 0x01000100) - ao;
+    to &= ((to >> 8) & 0x00010001) * 0xff;
+
+    d[i] = te | (to << 8);
+  }
+}
+
+#define SHADE_LINE(_d, _s, _w) \
+    shade_line ((guint32 *) (_d), (const guint32 *) (_s), _w, amount)
+
+#define SHADER_SETUP                                                    \
+  guint32 amount = (scope->priv->shade_amount & 0xffffff) | 0xff000000; \
+  guint8 *s, *d;                                                        \
+  gint ss, ds, width, height;                                           \
+                                                                        \
+  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);                           \
+  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);                        \
+  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);                           \
+  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);                        \
+                                                                        \
+  width = GST_VIDEO_FRAME_WIDTH (sframe);                               \
+  height = GST_VIDEO_FRAME_HEIGHT (sframe)
 
 static void
 shader_fade (GstAudioVisualizer * scope, const GstVideoFrame * sframe,
     GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     s += ss;
     d += ds;
   }
@@ -193,26 +198,12 @@ static void
 shader_fade_and_move_up (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   for (j = 1; j < height; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     d += ds;
   }
 }
@@ -221,26 +212,12 @@ static void
 shader_fade_and_move_down (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   for (j = 1; j < height; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     s += ss;
   }
 }
@@ -249,29 +226,15 @@ static void
 shader_fade_and_move_left (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   width -= 1;
   s += 4;
 
   /* move to the left */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     d += ds;
     s += ss;
   }
@@ -281,29 +244,15 @@ static void
 shader_fade_and_move_right (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   width -= 1;
   d += 4;
 
   /* move to the right */
   for (j = 0; j < height; j++) {
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     d += ds;
     s += ss;
   }
@@ -313,35 +262,19 @@ static void
 shader_fade_and_move_horiz_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   /* move upper half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     d += ds;
   }
   /* move lower half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     s += ss;
   }
 }
@@ -350,35 +283,19 @@ static void
 shader_fade_and_move_horiz_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *d;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  gint j;
+  SHADER_SETUP;
 
   /* move upper half down */
   for (j = 0; j < height / 2; j++) {
     d += ds;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     s += ss;
   }
   /* move lower half up */
   for (j = 0; j < height / 2; j++) {
     s += ss;
-    for (i = 0; i < width; i++) {
-      SHADE (d, s, i, r, g, b);
-    }
+    SHADE_LINE (d, s, width);
     d += ds;
   }
 }
@@ -387,32 +304,16 @@ static void
 shader_fade_and_move_vert_out (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *s1, *d, *d1;
-  gint ss, ds, width, height;
+  gint j, half;
+  SHADER_SETUP;
 
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
-
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  half = width / 2;
 
   for (j = 0; j < height; j++) {
     /* move left half to the left */
-    s1 = s + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    SHADE_LINE (d, s + 4, half);
     /* move right half to the right */
-    d1 = d + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    SHADE_LINE (d + (half + 1) * 4, s + half * 4, width - half - 1);
     s += ss;
     d += ds;
   }
@@ -422,32 +323,16 @@ static void
 shader_fade_and_move_vert_in (GstAudioVisualizer * scope,
     const GstVideoFrame * sframe, GstVideoFrame * dframe)
 {
-  guint i, j;
-  guint r = (scope->priv->shade_amount >> 16) & 0xff;
-  guint g = (scope->priv->shade_amount >> 8) & 0xff;
-  guint b = (scope->priv->shade_amount >> 0) & 0xff;
-  guint8 *s, *s1, *d, *d1;
-  gint ss, ds, width, height;
-
-  s = GST_VIDEO_FRAME_PLANE_DATA (sframe, 0);
-  ss = GST_VIDEO_FRAME_PLANE_STRIDE (sframe, 0);
-  d = GST_VIDEO_FRAME_PLANE_DATA (dframe, 0);
-  ds = GST_VIDEO_FRAME_PLANE_STRIDE (dframe, 0);
+  gint j, half;
+  SHADER_SETUP;
 
-  width = GST_VIDEO_FRAME_WIDTH (sframe);
-  height = GST_VIDEO_FRAME_HEIGHT (sframe);
+  half = width / 2;
 
   for (j = 0; j < height; j++) {
     /* move left half to the right */
-    d1 = d + 1;
-    for (i = 0; i < width / 2; i++) {
-      SHADE (d1, s, i, r, g, b);
-    }
+    SHADE_LINE (d + 4, s, half);
     /* move right half to the left */
-    s1 = s + 1;
-    for (; i < width - 1; i++) {
-      SHADE (d, s1, i, r, g, b);
-    }
+    SHADE_LINE (d + half * 4, s + (half + 1) * 4, width - half - 1);
     s += ss;
     d += ds;
   }
@@ -59,6 +59,8 @@
 GST_DEBUG_CATEGORY_STATIC (discoverer_debug);
 #define GST_CAT_DEFAULT discoverer_debug
 #define CACHE_DIRNAME "discoverer"
+/* how much of the start of a file goes into its cache key */
+#define CACHE_HEAD_SIZE 4096
 
 static GQuark _CAPS_QUARK;
 static GQuark _TAGS_QUARK;
@@ -140,11 +142,29 @@ struct _GstDiscovererPrivate
   gulong no_more_pads_id;
   gulong source_chg_id;
   gulong element_added_id;
+  gulong autoplug_continue_id;
   gulong bus_cb_id;
 
   gboolean use_cache;
+  GstDiscovererMode mode;
+
+  /* number of URIs to discover at the same time in async mode */
+  guint max_parallel;
+  /* DiscovererWorker, when discovering more than one URI at a time */
+  GPtrArray *workers;
+  guint busy_workers;
 };
 
+/* In async mode with more than one URI at a time, the pending URIs are
+ * handed out to other discoverers, each reusing its own pipeline, and their
+ * results are forwarded */
+typedef struct
+{
+  GstDiscoverer *dc;
+  GstDiscoverer *parent;
+  gboolean busy;
+} DiscovererWorker;
+
 #define DISCO_LOCK(dc) g_mutex_lock (&dc->priv->lock);
 #define DISCO_UNLOCK(dc) g_mutex_unlock (&dc->priv->lock);
 
@@ -177,12 +197,16 @@ enum
 
 #define DEFAULT_PROP_TIMEOUT 15 * GST_SECOND
 #define DEFAULT_PROP_USE_CACHE FALSE
+#define DEFAULT_PROP_MAX_PARALLEL 1
+#define DEFAULT_PROP_MODE GST_DISCOVERER_MODE_FULL
 
 enum
 {
   PROP_0,
   PROP_TIMEOUT,
-  PROP_USE_CACHE
+  PROP_USE_CACHE,
+  PROP_MAX_PARALLEL,
+  PROP_MODE
 };
 
 static guint gst_discoverer_signals[LAST_SIGNAL] = { 0 };
@@ -199,6 +223,8 @@ static void uridecodebin_pad_removed_cb (GstElement * uridecodebin,
     GstPad * pad, GstDiscoverer * dc);
 static void uridecodebin_no_more_pads_cb (GstElement * uridecodebin,
     GstDiscoverer * dc);
+static gboolean uridecodebin_autoplug_continue_cb (GstElement * uridecodebin,
+    GstPad * pad, GstCaps * caps, GstDiscoverer * dc);
 static void uridecodebin_source_changed_cb (GstElement * uridecodebin,
     GParamSpec * pspec, GstDiscoverer * dc);
 
@@ -253,6 +279,8 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
    * serialized form.
    *
    * The cache files are saved in `$XDG_CACHE_DIR/gstreamer-1.0/discoverer/`.
+   * An entry is only used for a local file with the same location, size,
+   * modification time and first few kilobytes as when it was saved.
    *
    * Since: 1.16
    */
@@ -261,6 +289,38 @@ gst_discoverer_class_init (GstDiscovererClass * klass)
           DEFAULT_PROP_USE_CACHE,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDiscoverer:max-parallel:
+   *
+   * The number of URIs to discover at the same time in asynchronous mode,
+   * each with its own pipeline. 0 means one per processor.
+   *
+   * The #GstDiscoverer::discovered signal is emitted in the order in which
+   * the discoveries complete, which can differ from the order in which the
+   * URIs were added. The value is used by gst_discoverer_start().
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PARALLEL,
+      g_param_spec_uint ("max-parallel", "Max parallel",
+          "Maximum number of URIs to discover at the same time (0 = number "
+          "of processors)", 0, G_MAXINT, DEFAULT_PROP_MAX_PARALLEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstDiscoverer:mode:
+   *
+   * How far to analyze the streams. Anything but %GST_DISCOVERER_MODE_FULL
+   * avoids instantiating decoders, at the expense of only reporting the
+   * caps found in the container or parsed stream.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MODE,
+      g_param_spec_enum ("mode", "Mode", "How far to analyze the streams",
+          GST_TYPE_DISCOVERER_MODE, DEFAULT_PROP_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* signals */
   /**
    * GstDiscoverer::finished:
@@ -347,6 +407,8 @@ gst_discoverer_init (GstDiscoverer * dc)
 
   dc->priv->timeout = DEFAULT_PROP_TIMEOUT;
   dc->priv->use_cache = DEFAULT_PROP_USE_CACHE;
+  dc->priv->max_parallel = DEFAULT_PROP_MAX_PARALLEL;
+  dc->priv->mode = DEFAULT_PROP_MODE;
   dc->priv->async = FALSE;
 
   g_mutex_init (&dc->priv->lock);
@@ -381,6 +443,9 @@ gst_discoverer_init (GstDiscoverer * dc)
   dc->priv->source_chg_id =
       g_signal_connect_object (dc->priv->uridecodebin, "notify::source",
       G_CALLBACK (uridecodebin_source_changed_cb), dc, 0);
+  dc->priv->autoplug_continue_id =
+      g_signal_connect_object (dc->priv->uridecodebin, "autoplug-continue",
+      G_CALLBACK (uridecodebin_autoplug_continue_cb), dc, 0);
 
   GST_LOG_OBJECT (dc, "Getting pipeline bus");
   dc->priv->bus = gst_pipeline_get_bus ((GstPipeline *) dc->priv->pipeline);
@@ -442,6 +507,7 @@ gst_discoverer_dispose (GObject * obj)
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->no_more_pads_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->source_chg_id);
     DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->element_added_id);
+    DISCONNECT_SIGNAL (dc->priv->uridecodebin, dc->priv->autoplug_continue_id);
     DISCONNECT_SIGNAL (dc->priv->bus, dc->priv->bus_cb_id);
 
     /* pipeline was set to NULL in _reset */
@@ -489,6 +555,16 @@ gst_discoverer_set_property (GObject * object, guint prop_id,
       dc->priv->use_cache = g_value_get_boolean (value);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      dc->priv->max_parallel = g_value_get_uint (value);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_MODE:
+      DISCO_LOCK (dc);
+      dc->priv->mode = g_value_get_enum (value);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -512,6 +588,16 @@ gst_discoverer_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, dc->priv->use_cache);
       DISCO_UNLOCK (dc);
       break;
+    case PROP_MAX_PARALLEL:
+      DISCO_LOCK (dc);
+      g_value_set_uint (value, dc->priv->max_parallel);
+      DISCO_UNLOCK (dc);
+      break;
+    case PROP_MODE:
+      DISCO_LOCK (dc);
+      g_value_set_enum (value, dc->priv->mode);
+      DISCO_UNLOCK (dc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -645,6 +731,76 @@ got_subtitle_data (GstPad * pad, GstPadProbeInfo * info, GstDiscoverer * dc)
 
 }
 
+/* Whether @pad, an unplugged pad of decodebin, comes from a demuxer that
+ * isn't just stripping tags from its stream */
+static gboolean
+pad_is_from_demuxer (GstPad * pad)
+{
+  GstElementFactory *factory = NULL;
+  GstElement *element = NULL;
+  GstPad *target = NULL;
+  const gchar *klass;
+  gboolean res = FALSE;
+
+  if (GST_IS_GHOST_PAD (pad))
+    target = gst_ghost_pad_get_target (GST_GHOST_PAD (pad));
+  if (target)
+    element = gst_pad_get_parent_element (target);
+  if (element)
+    factory = gst_element_get_factory (element);
+
+  if (factory) {
+    klass = gst_element_factory_get_metadata (factory,
+        GST_ELEMENT_METADATA_KLASS);
+    res = klass && strstr (klass, "Demux") && !strstr (klass, "Metadata");
+  }
+
+  if (element)
+    gst_object_unref (element);
+  if (target)
+    gst_object_unref (target);
+
+  return res;
+}
+
+static gboolean
+uridecodebin_autoplug_continue_cb (GstElement * uridecodebin, GstPad * pad,
+    GstCaps * caps, GstDiscoverer * dc)
+{
+  GstDiscovererMode mode;
+  const GstStructure *s;
+  const gchar *name;
+  gboolean parsed;
+
+  /* not taking the lock, this can be called while setting the state */
+  mode = dc->priv->mode;
+  if (mode == GST_DISCOVERER_MODE_FULL || gst_caps_get_size (caps) == 0)
+    return TRUE;
+
+  s = gst_caps_get_structure (caps, 0);
+  name = gst_structure_get_name (s);
+
+  /* what a parser would output, or what still needs one */
+  if (gst_structure_get_boolean (s, "parsed", &parsed)
+      || gst_structure_get_boolean (s, "framed", &parsed))
+    return !parsed;
+
+  if ((g_str_has_prefix (name, "video/") || g_str_has_prefix (name, "image/"))
+      && gst_structure_has_field (s, "width")
+      && gst_structure_has_field (s, "height"))
+    return FALSE;
+
+  if (g_str_has_prefix (name, "audio/")
+      && gst_structure_has_field (s, "rate")
+      && gst_structure_has_field (s, "channels"))
+    return FALSE;
+
+  if (mode == GST_DISCOVERER_MODE_TAGS && pad_is_from_demuxer (pad))
+    return FALSE;
+
+  return TRUE;
+}
+
 static void
 uridecodebin_source_changed_cb (GstElement * uridecodebin,
     GParamSpec * pspec, GstDiscoverer * dc)
@@ -1799,8 +1955,37 @@ _serialized_info_get_path (GstDiscoverer * dc, gchar * uri)
 
   tmp = g_strdup_printf ("%s-%" G_GSIZE_FORMAT "-%" G_GINT64_FORMAT,
       location, (gsize) file_status.st_size, (gint64) file_status.st_mtime);
+  /* the information is less complete in the other modes */
+  if (dc->priv->mode != GST_DISCOVERER_MODE_FULL) {
+    gchar *mode_tmp = g_strdup_printf ("%s-%d", tmp, dc->priv->mode);
+
+    g_free (tmp);
+    tmp = mode_tmp;
+  }
   cs = g_checksum_new (G_CHECKSUM_SHA1);
   g_checksum_update (cs, (const guchar *) tmp, strlen (tmp));
+
+  /* mtime only has a resolution of a second, so a file rewritten in place
+   * right after being discovered could otherwise get the stale info. The
+   * start of the file is what typefinding and the demuxer headers depend on
+   * and is cheap to read compared to running the pipeline */
+  {
+    guint8 head[CACHE_HEAD_SIZE];
+    gsize head_size;
+    FILE *file;
+
+    file = g_fopen (location, "rb");
+    if (file == NULL) {
+      GST_DEBUG_OBJECT (dc, "Could not open file: %s", location);
+
+      goto done;
+    }
+    head_size = fread (head, 1, sizeof (head), file);
+    fclose (file);
+
+    g_checksum_update (cs, head, head_size);
+  }
+
   checksum = g_checksum_get_string (cs);
 
   hash_dirname[0] = checksum[0];
@@ -2224,6 +2409,68 @@ _maybe_get_string_from_tuple (GVariant * tuple, guint index)
   return ret;
 }
 
+/* Serialized results of many files usually repeat the same few caps, keep
+ * the recently parsed ones so that they are parsed only once and shared */
+#define CAPS_CACHE_SIZE 32
+
+typedef struct
+{
+  gchar *str;
+  GstCaps *caps;
+} CapsCacheEntry;
+
+static GMutex caps_cache_lock;
+static GQueue caps_cache = G_QUEUE_INIT;
+
+static GstCaps *
+_caps_from_string_cached (const gchar * str)
+{
+  CapsCacheEntry *entry = NULL, *old = NULL;
+  GstCaps *caps;
+  GList *l;
+
+  g_mutex_lock (&caps_cache_lock);
+  for (l = caps_cache.head; l; l = l->next) {
+    CapsCacheEntry *e = l->data;
+
+    if (strcmp (e->str, str) == 0) {
+      /* move to the front */
+      g_queue_unlink (&caps_cache, l);
+      g_queue_push_head_link (&caps_cache, l);
+      entry = e;
+      break;
+    }
+  }
+  if (entry) {
+    caps = gst_caps_ref (entry->caps);
+    g_mutex_unlock (&caps_cache_lock);
+    return caps;
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  caps = gst_caps_from_string (str);
+  if (caps == NULL)
+    return NULL;
+
+  entry = g_slice_new (CapsCacheEntry);
+  entry->str = g_strdup (str);
+  entry->caps = gst_caps_ref (caps);
+
+  g_mutex_lock (&caps_cache_lock);
+  g_queue_push_head (&caps_cache, entry);
+  if (g_queue_get_length (&caps_cache) > CAPS_CACHE_SIZE)
+    old = g_queue_pop_tail (&caps_cache);
+  g_mutex_unlock (&caps_cache_lock);
+
+  if (old) {
+    g_free (old->str);
+    gst_caps_unref (old->caps);
+    g_slice_free (CapsCacheEntry, old);
+  }
+
+  return caps;
+}
+
 static void
 _parse_info (GstDiscovererInfo * info, GVariant * info_variant)
 {
@@ -2255,7 +2502,7 @@ _parse_common_stream_info (GstDiscovererStreamInfo * sinfo, GVariant * common,
 
   str = _maybe_get_string_from_tuple (common, 1);
   if (str)
-    sinfo->caps = gst_caps_from_string (str);
+    sinfo->caps = _caps_from_string_cached (str);
 
   str = _maybe_get_string_from_tuple (common, 2);
   if (str)
@@ -2404,6 +2651,139 @@ out:
   return sinfo;
 }
 
+/* Hands pending URIs to idle workers */
+static void
+discoverer_dispatch (GstDiscoverer * dc)
+{
+  guint i;
+
+  for (i = 0; i < dc->priv->workers->len; i++) {
+    DiscovererWorker *worker = g_ptr_array_index (dc->priv->workers, i);
+    gboolean starting;
+    gchar *uri;
+
+    DISCO_LOCK (dc);
+    if (worker->busy) {
+      DISCO_UNLOCK (dc);
+      continue;
+    }
+    if (dc->priv->pending_uris == NULL) {
+      DISCO_UNLOCK (dc);
+      break;
+    }
+    uri = dc->priv->pending_uris->data;
+    dc->priv->pending_uris =
+        g_list_delete_link (dc->priv->pending_uris, dc->priv->pending_uris);
+    worker->busy = TRUE;
+    starting = (dc->priv->busy_workers++ == 0);
+    DISCO_UNLOCK (dc);
+
+    if (starting)
+      g_signal_emit (dc, gst_discoverer_signals[SIGNAL_STARTING], 0);
+
+    gst_discoverer_discover_uri_async (worker->dc, uri);
+    g_free (uri);
+  }
+}
+
+static void
+worker_discovered_cb (GstDiscoverer * dc, GstDiscovererInfo * info,
+    const GError * err, DiscovererWorker * worker)
+{
+  g_signal_emit (worker->parent, gst_discoverer_signals[SIGNAL_DISCOVERED], 0,
+      info, err);
+}
+
+static void
+worker_source_setup_cb (GstDiscoverer * dc, GstElement * source,
+    DiscovererWorker * worker)
+{
+  g_signal_emit (worker->parent, gst_discoverer_signals[SIGNAL_SOURCE_SETUP],
+      0, source);
+}
+
+/* Emitted by a worker once it has no more URIs of its own */
+static void
+worker_finished_cb (GstDiscoverer * dc, DiscovererWorker * worker)
+{
+  GstDiscoverer *parent = worker->parent;
+  gboolean finished = FALSE;
+  gchar *uri = NULL;
+
+  DISCO_LOCK (parent);
+  if (parent->priv->pending_uris) {
+    uri = parent->priv->pending_uris->data;
+    parent->priv->pending_uris =
+        g_list_delete_link (parent->priv->pending_uris,
+        parent->priv->pending_uris);
+  } else if (worker->busy) {
+    worker->busy = FALSE;
+    finished = (--parent->priv->busy_workers == 0);
+  }
+  DISCO_UNLOCK (parent);
+
+  if (uri) {
+    gst_discoverer_discover_uri_async (dc, uri);
+    g_free (uri);
+  } else if (finished) {
+    g_signal_emit (parent, gst_discoverer_signals[SIGNAL_FINISHED], 0);
+  }
+}
+
+static void
+discoverer_worker_free (DiscovererWorker * worker)
+{
+  g_signal_handlers_disconnect_by_data (worker->dc, worker);
+  gst_discoverer_stop (worker->dc);
+  gst_object_unref (worker->dc);
+  g_slice_free (DiscovererWorker, worker);
+}
+
+static gboolean
+discoverer_start_workers (GstDiscoverer * dc)
+{
+  guint i, n_workers;
+
+  n_workers = dc->priv->max_parallel;
+  if (n_workers == 0)
+    n_workers = g_get_num_processors ();
+  if (n_workers <= 1)
+    return FALSE;
+
+  GST_DEBUG_OBJECT (dc, "discovering %u URIs at a time", n_workers);
+
+  dc->priv->workers = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      discoverer_worker_free);
+  dc->priv->busy_workers = 0;
+
+  for (i = 0; i < n_workers; i++) {
+    DiscovererWorker *worker;
+    GstDiscoverer *worker_dc;
+
+    worker_dc = gst_discoverer_new (dc->priv->timeout, NULL);
+    if (worker_dc == NULL)
+      break;
+    g_object_set (worker_dc, "use-cache", dc->priv->use_cache, "mode",
+        dc->priv->mode, NULL);
+
+    worker = g_slice_new0 (DiscovererWorker);
+    worker->dc = worker_dc;
+    worker->parent = dc;
+
+    g_signal_connect (worker_dc, "discovered",
+        G_CALLBACK (worker_discovered_cb), worker);
+    g_signal_connect (worker_dc, "source-setup",
+        G_CALLBACK (worker_source_setup_cb), worker);
+    g_signal_connect (worker_dc, "finished",
+        G_CALLBACK (worker_finished_cb), worker);
+
+    gst_discoverer_start (worker_dc);
+    g_ptr_array_add (dc->priv->workers, worker);
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_discoverer_start:
  * @discoverer: A #GstDiscoverer
@@ -2443,7 +2823,10 @@ gst_discoverer_start (GstDiscoverer * discoverer)
   discoverer->priv->bus_source = source;
   discoverer->priv->ctx = g_main_context_ref (ctx);
 
-  start_discovering (discoverer);
+  if (discoverer_start_workers (discoverer))
+    discoverer_dispatch (discoverer);
+  else
+    start_discovering (discoverer);
   GST_DEBUG_OBJECT (discoverer, "Started");
 }
 
@@ -2481,6 +2864,12 @@ gst_discoverer_stop (GstDiscoverer * discoverer)
   discoverer->priv->running = FALSE;
   DISCO_UNLOCK (discoverer);
 
+  if (discoverer->priv->workers) {
+    g_ptr_array_unref (discoverer->priv->workers);
+    discoverer->priv->workers = NULL;
+    discoverer->priv->busy_workers = 0;
+  }
+
   /* Remove timeout handler */
   if (discoverer->priv->timeout_source) {
     g_source_destroy (discoverer->priv->timeout_source);
@@ -2536,7 +2925,9 @@ gst_discoverer_discover_uri_async (GstDiscoverer * discoverer,
       g_list_append (discoverer->priv->pending_uris, g_strdup (uri));
   DISCO_UNLOCK (discoverer);
 
-  if (can_run)
+  if (discoverer->priv->workers)
+    discoverer_dispatch (discoverer);
+  else if (can_run)
     start_discovering (discoverer);
 
   return TRUE;
@@ -258,6 +258,27 @@ typedef enum {
   GST_DISCOVERER_SERIALIZE_ALL   = GST_DISCOVERER_SERIALIZE_CAPS | GST_DISCOVERER_SERIALIZE_TAGS | GST_DISCOVERER_SERIALIZE_MISC
 } GstDiscovererSerializeFlags;
 
+/**
+ * GstDiscovererMode:
+ * @GST_DISCOVERER_MODE_FULL: Decode all streams, so the information reflects
+ * the decoded caps
+ * @GST_DISCOVERER_MODE_PARSED: Stop at streams whose caps already describe
+ * them, like video with a size or audio with a rate and channels, or at the
+ * output of parsers, without plugging any decoders for them
+ * @GST_DISCOVERER_MODE_TAGS: Like %GST_DISCOVERER_MODE_PARSED but also stop
+ * at every stream coming out of a demuxer, for when only the tags and the
+ * duration are needed
+ *
+ * How far the discoverer goes in analyzing each stream.
+ *
+ * Since: 1.18
+ */
+typedef enum {
+  GST_DISCOVERER_MODE_FULL   = 0,
+  GST_DISCOVERER_MODE_PARSED = 1,
+  GST_DISCOVERER_MODE_TAGS   = 2
+} GstDiscovererMode;
+
 /**
  * GstDiscovererInfo:
  *
@@ -0,0 +1,604 @@
+/* GStreamer RIFF I/O
+ *
+ * riff-index.c: AVI style chunk index parsing and lookup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstriffindex
+ * @title: GstRiffIndex
+ * @short_description: Seek index built from idx1, indx and ix## chunks
+ *
+ * #GstRiffIndex keeps the chunks of each stream of an AVI style file in
+ * one array per stream, in stream order, with the keyframes in a separate
+ * array. Looking up the chunk for a byte position or the keyframe before
+ * a frame is a binary search.
+ *
+ * The entries come from an AVI 1.0 idx1 chunk with gst_riff_parse_idx1() or
+ * from OpenDML indexes. For those, gst_riff_parse_indx() only reads the
+ * super index of a stream into pages, and gst_riff_parse_ix() adds the
+ * entries of one page. Pages have to be added in order, but a reader can
+ * stop after the pages it needs, which bounds the memory used for long
+ * files.
+ *
+ * Since: 1.18
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "riff-index.h"
+
+GST_DEBUG_CATEGORY_EXTERN (riff_debug);
+#define GST_CAT_DEFAULT riff_debug
+
+/* bIndexType of OpenDML indexes */
+#define AVI_INDEX_OF_INDEXES  0x00
+#define AVI_INDEX_OF_CHUNKS   0x01
+
+#define IDX1_ENTRY_SIZE       16
+#define ODML_HEADER_SIZE      24
+#define INDX_ENTRY_SIZE       16
+
+/* the size field of ix## entries has this set for non keyframes */
+#define IX_NOT_KEYFRAME       0x80000000
+
+typedef struct
+{
+  GArray *entries;              /* GstRiffIndexEntry */
+  GArray *keyframes;            /* guint, entry numbers */
+  GArray *pages;                /* GstRiffIndexPage */
+  guint64 total;
+} GstRiffIndexStream;
+
+struct _GstRiffIndex
+{
+  GPtrArray *streams;
+};
+
+static void
+gst_riff_index_stream_free (GstRiffIndexStream * s)
+{
+  if (s == NULL)
+    return;
+
+  g_array_free (s->entries, TRUE);
+  g_array_free (s->keyframes, TRUE);
+  g_array_free (s->pages, TRUE);
+  g_slice_free (GstRiffIndexStream, s);
+}
+
+static GstRiffIndexStream *
+gst_riff_index_get_stream (GstRiffIndex * index, guint stream, gboolean create)
+{
+  GstRiffIndexStream *s = NULL;
+
+  if (stream < index->streams->len)
+    s = g_ptr_array_index (index->streams, stream);
+
+  if (s == NULL && create) {
+    if (stream >= index->streams->len)
+      g_ptr_array_set_size (index->streams, stream + 1);
+
+    s = g_slice_new (GstRiffIndexStream);
+    s->entries = g_array_new (FALSE, FALSE, sizeof (GstRiffIndexEntry));
+    s->keyframes = g_array_new (FALSE, FALSE, sizeof (guint));
+    s->pages = g_array_new (FALSE, FALSE, sizeof (GstRiffIndexPage));
+    s->total = 0;
+    g_ptr_array_index (index->streams, stream) = s;
+  }
+  return s;
+}
+
+static void
+gst_riff_index_stream_add (GstRiffIndexStream * s, guint64 offset,
+    guint32 size, guint32 flags)
+{
+  GstRiffIndexEntry entry;
+
+  entry.offset = offset;
+  entry.size = size;
+  entry.flags = flags;
+  entry.total = s->total;
+
+  if (flags & GST_RIFF_IF_KEYFRAME)
+    g_array_append_val (s->keyframes, s->entries->len);
+  g_array_append_val (s->entries, entry);
+
+  s->total += size;
+}
+
+/**
+ * gst_riff_index_new:
+ *
+ * Returns: (transfer full): a new, empty #GstRiffIndex. Free with
+ *     gst_riff_index_free().
+ *
+ * Since: 1.18
+ */
+GstRiffIndex *
+gst_riff_index_new (void)
+{
+  GstRiffIndex *index;
+
+  index = g_slice_new (GstRiffIndex);
+  index->streams =
+      g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_riff_index_stream_free);
+
+  return index;
+}
+
+/**
+ * gst_riff_index_free:
+ * @index: a #GstRiffIndex
+ *
+ * Frees @index and all its entries.
+ *
+ * Since: 1.18
+ */
+void
+gst_riff_index_free (GstRiffIndex * index)
+{
+  g_return_if_fail (index != NULL);
+
+  g_ptr_array_free (index->streams, TRUE);
+  g_slice_free (GstRiffIndex, index);
+}
+
+/**
+ * gst_riff_parse_idx1:
+ * @element: caller element (used for debugging).
+ * @buf: data of the idx1 chunk, without the chunk header
+ * @offset_base: file offset the chunk offsets in the index are relative to,
+ *     the position of the 'movi' fourcc of the movi list or 0 if the offsets
+ *     are absolute
+ * @index: the #GstRiffIndex to add the entries to
+ *
+ * Adds the entries of the AVI 1.0 index in @buf to the streams of @index.
+ * The stream of each entry is taken from its chunk id, 'rec ' lists are
+ * skipped.
+ *
+ * Returns: %TRUE if @buf contained at least one entry
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_riff_parse_idx1 (GstElement * element, GstBuffer * buf,
+    guint64 offset_base, GstRiffIndex * index)
+{
+  GstMapInfo info;
+  const guint8 *ptr;
+  guint i, n;
+
+  g_return_val_if_fail (buf != NULL, FALSE);
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+
+  n = info.size / IDX1_ENTRY_SIZE;
+  GST_DEBUG_OBJECT (element, "parsing idx1 with %u entries", n);
+
+  for (i = 0, ptr = info.data; i < n; i++, ptr += IDX1_ENTRY_SIZE) {
+    GstRiffIndexStream *s;
+    guint32 flags;
+    guint stream;
+
+    flags = GST_READ_UINT32_LE (ptr + 4);
+    if (flags & GST_RIFF_IF_LIST)
+      continue;
+
+    /* chunk ids are ##dc, ##wb etc, with the stream number in decimal */
+    if (!g_ascii_isdigit (ptr[0]) || !g_ascii_isdigit (ptr[1])) {
+      GST_LOG_OBJECT (element, "skipping entry with id %" GST_FOURCC_FORMAT,
+          GST_FOURCC_ARGS (GST_READ_UINT32_LE (ptr)));
+      continue;
+    }
+    stream = (ptr[0] - '0') * 10 + (ptr[1] - '0');
+
+    s = gst_riff_index_get_stream (index, stream, TRUE);
+    gst_riff_index_stream_add (s,
+        offset_base + GST_READ_UINT32_LE (ptr + 8) + 8,
+        GST_READ_UINT32_LE (ptr + 12), flags);
+  }
+  gst_buffer_unmap (buf, &info);
+
+  return n > 0;
+}
+
+/**
+ * gst_riff_parse_indx:
+ * @element: caller element (used for debugging).
+ * @buf: data of the indx chunk, without the chunk header
+ * @stream: the stream the indx chunk belongs to
+ * @index: the #GstRiffIndex to add the pages to
+ *
+ * Reads the OpenDML super index of @stream in @buf into pages, without
+ * reading the standard index chunks it references. Use
+ * gst_riff_index_find_page() to find the page for a position and
+ * gst_riff_parse_ix() to add its entries.
+ *
+ * Returns: %TRUE if @buf is a valid super index
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_riff_parse_indx (GstElement * element, GstBuffer * buf, guint stream,
+    GstRiffIndex * index)
+{
+  GstRiffIndexStream *s;
+  GstMapInfo info;
+  const guint8 *ptr;
+  guint i, n, longs;
+  guint64 start = 0;
+
+  g_return_val_if_fail (buf != NULL, FALSE);
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+
+  if (info.size < ODML_HEADER_SIZE)
+    goto too_small;
+
+  longs = GST_READ_UINT16_LE (info.data);
+  if (longs != INDX_ENTRY_SIZE / 4 || info.data[3] != AVI_INDEX_OF_INDEXES)
+    goto wrong_type;
+
+  n = GST_READ_UINT32_LE (info.data + 4);
+  n = MIN (n, (info.size - ODML_HEADER_SIZE) / INDX_ENTRY_SIZE);
+  GST_DEBUG_OBJECT (element, "stream %u super index with %u pages", stream, n);
+
+  s = gst_riff_index_get_stream (index, stream, TRUE);
+  if (s->pages->len > 0) {
+    GstRiffIndexPage *last;
+
+    last = &g_array_index (s->pages, GstRiffIndexPage, s->pages->len - 1);
+    start = last->start + last->duration;
+  }
+
+  ptr = info.data + ODML_HEADER_SIZE;
+  for (i = 0; i < n; i++, ptr += INDX_ENTRY_SIZE) {
+    GstRiffIndexPage page;
+
+    page.offset = GST_READ_UINT64_LE (ptr);
+    page.size = GST_READ_UINT32_LE (ptr + 8);
+    page.duration = GST_READ_UINT32_LE (ptr + 12);
+    page.start = start;
+    page.loaded = FALSE;
+    start += page.duration;
+
+    g_array_append_val (s->pages, page);
+  }
+  gst_buffer_unmap (buf, &info);
+
+  return TRUE;
+
+  /* ERRORS */
+too_small:
+  {
+    GST_DEBUG_OBJECT (element, "too small indx chunk (%" G_GSIZE_FORMAT
+        " bytes)", info.size);
+    gst_buffer_unmap (buf, &info);
+    return FALSE;
+  }
+wrong_type:
+  {
+    GST_DEBUG_OBJECT (element, "unsupported indx, %u longs per entry, "
+        "type %u", longs, info.data[3]);
+    gst_buffer_unmap (buf, &info);
+    return FALSE;
+  }
+}
+
+/**
+ * gst_riff_parse_ix:
+ * @element: caller element (used for debugging).
+ * @buf: data of the ix## chunk, without the chunk header
+ * @stream: the stream the ix## chunk belongs to
+ * @index: the #GstRiffIndex to add the entries to
+ *
+ * Adds the entries of the OpenDML standard index in @buf to @stream, after
+ * the ones already there. If @stream has pages, the first page that wasn't
+ * loaded yet is marked as loaded.
+ *
+ * Returns: %TRUE if @buf is a valid standard index
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_riff_parse_ix (GstElement * element, GstBuffer * buf, guint stream,
+    GstRiffIndex * index)
+{
+  GstRiffIndexStream *s;
+  GstMapInfo info;
+  const guint8 *ptr;
+  guint i, n, longs;
+  guint64 base;
+
+  g_return_val_if_fail (buf != NULL, FALSE);
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+
+  if (info.size < ODML_HEADER_SIZE)
+    goto too_small;
+
+  /* 2 for frame indexes, 3 for field indexes */
+  longs = GST_READ_UINT16_LE (info.data);
+  if (longs < 2 || info.data[3] != AVI_INDEX_OF_CHUNKS)
+    goto wrong_type;
+
+  n = GST_READ_UINT32_LE (info.data + 4);
+  n = MIN (n, (info.size - ODML_HEADER_SIZE) / (longs * 4));
+  base = GST_READ_UINT64_LE (info.data + 12);
+  GST_DEBUG_OBJECT (element, "stream %u index with %u entries", stream, n);
+
+  s = gst_riff_index_get_stream (index, stream, TRUE);
+  for (i = 0; i < s->pages->len; i++) {
+    GstRiffIndexPage *page = &g_array_index (s->pages, GstRiffIndexPage, i);
+
+    if (!page->loaded) {
+      page->loaded = TRUE;
+      break;
+    }
+  }
+
+  ptr = info.data + ODML_HEADER_SIZE;
+  for (i = 0; i < n; i++, ptr += longs * 4) {
+    guint32 size = GST_READ_UINT32_LE (ptr + 4);
+
+    /* offsets point to the chunk data already */
+    gst_riff_index_stream_add (s, base + GST_READ_UINT32_LE (ptr),
+        size & ~IX_NOT_KEYFRAME,
+        (size & IX_NOT_KEYFRAME) ? 0 : GST_RIFF_IF_KEYFRAME);
+  }
+  gst_buffer_unmap (buf, &info);
+
+  return TRUE;
+
+  /* ERRORS */
+too_small:
+  {
+    GST_DEBUG_OBJECT (element, "too small ix chunk (%" G_GSIZE_FORMAT
+        " bytes)", info.size);
+    gst_buffer_unmap (buf, &info);
+    return FALSE;
+  }
+wrong_type:
+  {
+    GST_DEBUG_OBJECT (element, "unsupported ix, %u longs per entry, "
+        "type %u", longs, info.data[3]);
+    gst_buffer_unmap (buf, &info);
+    return FALSE;
+  }
+}
+
+/**
+ * gst_riff_index_get_n_entries:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ *
+ * Returns: the number of entries of @stream
+ *
+ * Since: 1.18
+ */
+guint
+gst_riff_index_get_n_entries (GstRiffIndex * index, guint stream)
+{
+  GstRiffIndexStream *s;
+
+  g_return_val_if_fail (index != NULL, 0);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+
+  return s ? s->entries->len : 0;
+}
+
+/**
+ * gst_riff_index_get_entry:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ * @n: an entry number
+ *
+ * Returns: (transfer none) (nullable): entry @n of @stream, valid until
+ *     entries are added to @stream, or %NULL if there is no such entry.
+ *
+ * Since: 1.18
+ */
+const GstRiffIndexEntry *
+gst_riff_index_get_entry (GstRiffIndex * index, guint stream, guint n)
+{
+  GstRiffIndexStream *s;
+
+  g_return_val_if_fail (index != NULL, NULL);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+  if (s == NULL || n >= s->entries->len)
+    return NULL;
+
+  return &g_array_index (s->entries, GstRiffIndexEntry, n);
+}
+
+/**
+ * gst_riff_index_find_keyframe:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ * @n: an entry number
+ *
+ * Returns: the number of the last keyframe entry of @stream at or before
+ *     entry @n, or -1 if there is none.
+ *
+ * Since: 1.18
+ */
+gint
+gst_riff_index_find_keyframe (GstRiffIndex * index, guint stream, guint n)
+{
+  GstRiffIndexStream *s;
+  guint lo, hi;
+
+  g_return_val_if_fail (index != NULL, -1);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+  if (s == NULL || s->keyframes->len == 0
+      || g_array_index (s->keyframes, guint, 0) > n)
+    return -1;
+
+  /* the last keyframe <= n is in [lo, hi) */
+  lo = 0;
+  hi = s->keyframes->len;
+  while (hi - lo > 1) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (s->keyframes, guint, mid) <= n)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return g_array_index (s->keyframes, guint, lo);
+}
+
+/**
+ * gst_riff_index_find_entry:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ * @total: a byte position in the stream
+ * @keyframe: find a keyframe
+ *
+ * Finds the entry of @stream that contains byte @total of the stream, or
+ * with @keyframe the last keyframe entry at or before it. For video streams
+ * the frame number is the entry number, use gst_riff_index_find_keyframe()
+ * for those.
+ *
+ * Returns: the entry number, or -1 if there is none.
+ *
+ * Since: 1.18
+ */
+gint
+gst_riff_index_find_entry (GstRiffIndex * index, guint stream,
+    guint64 total, gboolean keyframe)
+{
+  GstRiffIndexStream *s;
+  guint lo, hi;
+
+  g_return_val_if_fail (index != NULL, -1);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+  if (s == NULL || s->entries->len == 0)
+    return -1;
+
+  /* the last entry starting at or before total is in [lo, hi) */
+  lo = 0;
+  hi = s->entries->len;
+  while (hi - lo > 1) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (s->entries, GstRiffIndexEntry, mid).total <= total)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  if (keyframe)
+    return gst_riff_index_find_keyframe (index, stream, lo);
+
+  return lo;
+}
+
+/**
+ * gst_riff_index_get_n_pages:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ *
+ * Returns: the number of super index pages of @stream
+ *
+ * Since: 1.18
+ */
+guint
+gst_riff_index_get_n_pages (GstRiffIndex * index, guint stream)
+{
+  GstRiffIndexStream *s;
+
+  g_return_val_if_fail (index != NULL, 0);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+
+  return s ? s->pages->len : 0;
+}
+
+/**
+ * gst_riff_index_get_page:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ * @n: a page number
+ *
+ * Returns: (transfer none) (nullable): page @n of @stream, or %NULL if there
+ *     is no such page.
+ *
+ * Since: 1.18
+ */
+const GstRiffIndexPage *
+gst_riff_index_get_page (GstRiffIndex * index, guint stream, guint n)
+{
+  GstRiffIndexStream *s;
+
+  g_return_val_if_fail (index != NULL, NULL);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+  if (s == NULL || n >= s->pages->len)
+    return NULL;
+
+  return &g_array_index (s->pages, GstRiffIndexPage, n);
+}
+
+/**
+ * gst_riff_index_find_page:
+ * @index: a #GstRiffIndex
+ * @stream: a stream number
+ * @ticks: a position in the stream, in stream ticks
+ *
+ * Returns: the number of the super index page of @stream containing @ticks,
+ *     or -1 if @stream has no pages.
+ *
+ * Since: 1.18
+ */
+gint
+gst_riff_index_find_page (GstRiffIndex * index, guint stream, guint64 ticks)
+{
+  GstRiffIndexStream *s;
+  guint lo, hi;
+
+  g_return_val_if_fail (index != NULL, -1);
+
+  s = gst_riff_index_get_stream (index, stream, FALSE);
+  if (s == NULL || s->pages->len == 0)
+    return -1;
+
+  lo = 0;
+  hi = s->pages->len;
+  while (hi - lo > 1) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (s->pages, GstRiffIndexPage, mid).start <= ticks)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
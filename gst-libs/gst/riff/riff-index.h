@@ -0,0 +1,135 @@
+/* GStreamer RIFF I/O
+ *
+ * riff-index.h: AVI style chunk index parsing and lookup
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_RIFF_INDEX_H__
+#define __GST_RIFF_INDEX_H__
+
+#include <glib.h>
+#include <gst/gst.h>
+
+#include <gst/riff/riff-prelude.h>
+#include <gst/riff/riff-ids.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstRiffIndex GstRiffIndex;
+
+/**
+ * GstRiffIndexEntry:
+ * @offset: file offset of the chunk data, after the chunk header
+ * @size: size of the chunk data
+ * @flags: GST_RIFF_IF_* flags of the chunk
+ * @total: number of bytes of the stream before this chunk
+ *
+ * One chunk of a stream. The position of the entry in the stream is its
+ * frame number for video streams, @total its byte position for audio.
+ *
+ * Since: 1.18
+ */
+typedef struct {
+  guint64 offset;
+  guint32 size;
+  guint32 flags;
+  guint64 total;
+} GstRiffIndexEntry;
+
+/**
+ * GstRiffIndexPage:
+ * @offset: file offset of the ix## chunk, including its header
+ * @size: size of the ix## chunk
+ * @duration: duration of the chunks in the page, in stream ticks
+ * @start: sum of the durations of the pages before this one
+ * @loaded: whether gst_riff_parse_ix() has added the page's entries
+ *
+ * One standard index chunk referenced from an OpenDML super index.
+ *
+ * Since: 1.18
+ */
+typedef struct {
+  guint64 offset;
+  guint32 size;
+  guint32 duration;
+  guint64 start;
+  gboolean loaded;
+} GstRiffIndexPage;
+
+GST_RIFF_API
+GstRiffIndex * gst_riff_index_new           (void);
+
+GST_RIFF_API
+void           gst_riff_index_free          (GstRiffIndex * index);
+
+GST_RIFF_API
+gboolean       gst_riff_parse_idx1          (GstElement   * element,
+                                             GstBuffer    * buf,
+                                             guint64        offset_base,
+                                             GstRiffIndex * index);
+
+GST_RIFF_API
+gboolean       gst_riff_parse_indx          (GstElement   * element,
+                                             GstBuffer    * buf,
+                                             guint          stream,
+                                             GstRiffIndex * index);
+
+GST_RIFF_API
+gboolean       gst_riff_parse_ix            (GstElement   * element,
+                                             GstBuffer    * buf,
+                                             guint          stream,
+                                             GstRiffIndex * index);
+
+GST_RIFF_API
+guint          gst_riff_index_get_n_entries (GstRiffIndex * index,
+                                             guint          stream);
+
+GST_RIFF_API
+const GstRiffIndexEntry *
+               gst_riff_index_get_entry     (GstRiffIndex * index,
+                                             guint          stream,
+                                             guint          n);
+
+GST_RIFF_API
+gint           gst_riff_index_find_entry    (GstRiffIndex * index,
+                                             guint          stream,
+                                             guint64        total,
+                                             gboolean       keyframe);
+
+GST_RIFF_API
+gint           gst_riff_index_find_keyframe (GstRiffIndex * index,
+                                             guint          stream,
+                                             guint          n);
+
+GST_RIFF_API
+guint          gst_riff_index_get_n_pages   (GstRiffIndex * index,
+                                             guint          stream);
+
+GST_RIFF_API
+const GstRiffIndexPage *
+               gst_riff_index_get_page      (GstRiffIndex * index,
+                                             guint          stream,
+                                             guint          n);
+
+GST_RIFF_API
+gint           gst_riff_index_find_page     (GstRiffIndex * index,
+                                             guint          stream,
+                                             guint64        ticks);
+
+G_END_DECLS
+
+#endif /* __GST_RIFF_INDEX_H__ */
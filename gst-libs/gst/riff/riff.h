@@ -26,5 +26,6 @@
 #include <gst/riff/riff-ids.h>
 #include <gst/riff/riff-media.h>
 #include <gst/riff/riff-read.h>
+#include <gst/riff/riff-index.h>
 
 #endif /* __GST_RIFF_H__ */
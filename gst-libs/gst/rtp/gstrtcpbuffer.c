@@ -527,6 +527,44 @@ end:
   }
 }
 
+/**
+ * gst_rtcp_buffer_get_packets:
+ * @rtcp: a valid RTCP buffer
+ * @packets: (array length=n_packets) (out caller-allocates): array of
+ *     #GstRTCPPacket to fill
+ * @n_packets: the number of elements in @packets
+ *
+ * Walk the packets of @rtcp once and position one element of @packets on
+ * each of them, in order, so that they can then be accessed in any order
+ * without walking the headers again. At most @n_packets packets are stored.
+ *
+ * Returns: the number of packets stored in @packets
+ *
+ * Since: 1.18
+ */
+guint
+gst_rtcp_buffer_get_packets (GstRTCPBuffer * rtcp, GstRTCPPacket * packets,
+    guint n_packets)
+{
+  GstRTCPPacket packet;
+  guint count = 0;
+
+  g_return_val_if_fail (rtcp != NULL, 0);
+  g_return_val_if_fail (packets != NULL || n_packets == 0, 0);
+
+  if (n_packets == 0 || !gst_rtcp_buffer_get_first_packet (rtcp, &packet))
+    return 0;
+
+  do {
+    packets[count++] = packet;
+  } while (count < n_packets && gst_rtcp_packet_move_to_next (&packet));
+
+  return count;
+}
+
+static gboolean add_packet_at_offset (GstRTCPBuffer * rtcp, GstRTCPType type,
+    GstRTCPPacket * packet);
+
 /**
  * gst_rtcp_buffer_add_packet:
  * @rtcp: a valid RTCP buffer
@@ -543,11 +581,6 @@ gboolean
 gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
     GstRTCPPacket * packet)
 {
-  guint len;
-  gsize maxsize;
-  guint8 *data;
-  gboolean result;
-
   g_return_val_if_fail (rtcp != NULL, FALSE);
   g_return_val_if_fail (GST_IS_BUFFER (rtcp->buffer), FALSE);
   g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, FALSE);
@@ -558,6 +591,59 @@ gst_rtcp_buffer_add_packet (GstRTCPBuffer * rtcp, GstRTCPType type,
   if (gst_rtcp_buffer_get_first_packet (rtcp, packet))
     while (gst_rtcp_packet_move_to_next (packet));
 
+  return add_packet_at_offset (rtcp, type, packet);
+}
+
+/**
+ * gst_rtcp_packet_add_next:
+ * @packet: a #GstRTCPPacket pointing to the last packet of its buffer
+ * @type: the #GstRTCPType of the new packet
+ *
+ * Add a new packet of @type right after @packet and move @packet to it.
+ *
+ * This does the same as gst_rtcp_buffer_add_packet() but, when @packet is
+ * the last packet of the buffer, as it is right after adding it, the free
+ * space does not have to be searched for. Compound packets can so be built
+ * in a single pass with gst_rtcp_buffer_add_packet() for the first packet
+ * and this function for the following ones.
+ *
+ * Returns: %TRUE if the packet could be created. This function returns %FALSE
+ * if the max mtu is exceeded for the buffer.
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_rtcp_packet_add_next (GstRTCPPacket * packet, GstRTCPType type)
+{
+  GstRTCPBuffer *rtcp;
+
+  g_return_val_if_fail (packet != NULL, FALSE);
+  g_return_val_if_fail (packet->type != GST_RTCP_TYPE_INVALID, FALSE);
+  g_return_val_if_fail (packet->rtcp != NULL, FALSE);
+  g_return_val_if_fail (packet->rtcp->map.flags & GST_MAP_WRITE, FALSE);
+  g_return_val_if_fail (type != GST_RTCP_TYPE_INVALID, FALSE);
+
+  rtcp = packet->rtcp;
+
+  /* the packet is not the last one, look for the end the slow way */
+  if (packet->padding
+      || packet->offset + (packet->length << 2) + 4 != rtcp->map.size)
+    return gst_rtcp_buffer_add_packet (rtcp, type, packet);
+
+  packet->offset += (packet->length << 2) + 4;
+
+  return add_packet_at_offset (rtcp, type, packet);
+}
+
+static gboolean
+add_packet_at_offset (GstRTCPBuffer * rtcp, GstRTCPType type,
+    GstRTCPPacket * packet)
+{
+  guint len;
+  gsize maxsize;
+  guint8 *data;
+  gboolean result;
+
   maxsize = rtcp->map.maxsize;
 
   /* packet->offset is now pointing to the next free offset in the buffer to
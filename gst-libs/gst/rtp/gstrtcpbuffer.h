@@ -296,10 +296,17 @@ gboolean        gst_rtcp_buffer_get_first_packet  (GstRTCPBuffer *rtcp, GstRTCPP
 GST_RTP_API
 gboolean        gst_rtcp_packet_move_to_next      (GstRTCPPacket *packet);
 
+GST_RTP_API
+guint           gst_rtcp_buffer_get_packets       (GstRTCPBuffer *rtcp, GstRTCPPacket *packets,
+                                                   guint n_packets);
+
 GST_RTP_API
 gboolean        gst_rtcp_buffer_add_packet        (GstRTCPBuffer *rtcp, GstRTCPType type,
                                                    GstRTCPPacket *packet);
 
+GST_RTP_API
+gboolean        gst_rtcp_packet_add_next          (GstRTCPPacket *packet, GstRTCPType type);
+
 GST_RTP_API
 gboolean        gst_rtcp_packet_remove            (GstRTCPPacket *packet);
 
@@ -507,12 +507,11 @@ gst_rtp_base_audio_payload_push_buffer (GstRTPBaseAudioPayload *
     baseaudiopayload, GstBuffer * buffer, GstClockTime timestamp)
 {
   GstRTPBasePayload *basepayload;
-  GstRTPBaseAudioPayloadPrivate *priv;
   GstBuffer *outbuf;
   guint payload_len;
   GstFlowReturn ret;
+  CopyMetaData data;
 
-  priv = baseaudiopayload->priv;
   basepayload = GST_RTP_BASE_PAYLOAD (baseaudiopayload);
 
   payload_len = gst_buffer_get_size (buffer);
@@ -527,36 +526,70 @@ gst_rtp_base_audio_payload_push_buffer (GstRTPBaseAudioPayload *
   gst_rtp_base_audio_payload_set_meta (baseaudiopayload, outbuf, payload_len,
       timestamp);
 
-  if (priv->buffer_list) {
-    GstBufferList *list;
-    guint i, len;
+  /* the input becomes the payload, its memory is appended to the header */
+  data.pay = baseaudiopayload;
+  data.outbuf = outbuf;
+  gst_buffer_foreach_meta (buffer, foreach_metadata, &data);
+  outbuf = gst_buffer_append (outbuf, buffer);
 
-    list = gst_buffer_list_new ();
-    len = gst_buffer_list_length (list);
+  GST_DEBUG_OBJECT (baseaudiopayload, "Pushing buffer %p", outbuf);
+  ret = gst_rtp_base_payload_push (basepayload, outbuf);
 
-    for (i = 0; i < len; i++) {
-      /* FIXME */
-      g_warning ("bufferlist not implemented");
-      gst_buffer_list_add (list, outbuf);
-      gst_buffer_list_add (list, buffer);
-    }
+  return ret;
+}
 
-    GST_DEBUG_OBJECT (baseaudiopayload, "Pushing list %p", list);
-    ret = gst_rtp_base_payload_push_list (basepayload, list);
-  } else {
-    CopyMetaData data;
+/* Takes @payload_len bytes out of the adapter and puts them behind a new RTP
+ * header. The payload keeps the memory of the input buffers, a packet
+ * spanning several input buffers gets several memories instead of a merged
+ * copy. */
+static GstBuffer *
+gst_rtp_base_audio_payload_take_packet (GstRTPBaseAudioPayload *
+    baseaudiopayload, guint payload_len, GstClockTime timestamp)
+{
+  GstRTPBaseAudioPayloadPrivate *priv;
+  GstBuffer *outbuf, *paybuf;
+  GstAdapter *adapter;
+  CopyMetaData data;
+  guint64 distance;
 
-    /* copy payload */
-    data.pay = baseaudiopayload;
-    data.outbuf = outbuf;
-    gst_buffer_foreach_meta (buffer, foreach_metadata, &data);
-    outbuf = gst_buffer_append (outbuf, buffer);
+  priv = baseaudiopayload->priv;
+  adapter = priv->adapter;
+
+  if (timestamp == -1) {
+    /* calculate the timestamp */
+    timestamp = gst_adapter_prev_pts (adapter, &distance);
+
+    GST_LOG_OBJECT (baseaudiopayload,
+        "last timestamp %" GST_TIME_FORMAT ", distance %" G_GUINT64_FORMAT,
+        GST_TIME_ARGS (timestamp), distance);
 
-    GST_DEBUG_OBJECT (baseaudiopayload, "Pushing buffer %p", outbuf);
-    ret = gst_rtp_base_payload_push (basepayload, outbuf);
+    if (GST_CLOCK_TIME_IS_VALID (timestamp) && distance > 0) {
+      /* convert the number of bytes since the last timestamp to time and add to
+       * the last seen timestamp */
+      timestamp += priv->bytes_to_time (baseaudiopayload, distance);
+    }
   }
 
-  return ret;
+  GST_DEBUG_OBJECT (baseaudiopayload, "Pushing %d bytes ts %" GST_TIME_FORMAT,
+      payload_len, GST_TIME_ARGS (timestamp));
+
+  /* create the RTP header buffer */
+  outbuf =
+      gst_rtp_base_payload_allocate_output_buffer (GST_RTP_BASE_PAYLOAD
+      (baseaudiopayload), 0, 0, 0);
+
+  paybuf = gst_adapter_take_buffer_fast (adapter, payload_len);
+
+  data.pay = baseaudiopayload;
+  data.outbuf = outbuf;
+  gst_buffer_foreach_meta (paybuf, foreach_metadata, &data);
+  outbuf = gst_buffer_append (outbuf, paybuf);
+
+  /* set metadata */
+  gst_rtp_base_audio_payload_set_meta (baseaudiopayload, outbuf, payload_len,
+      timestamp);
+
+  return outbuf;
 }
 
 /**
@@ -579,74 +612,21 @@ gst_rtp_base_audio_payload_flush (GstRTPBaseAudioPayload * baseaudiopayload,
     guint payload_len, GstClockTime timestamp)
 {
   GstRTPBasePayload *basepayload;
-  GstRTPBaseAudioPayloadPrivate *priv;
   GstBuffer *outbuf;
-  GstFlowReturn ret;
-  GstAdapter *adapter;
-  guint64 distance;
-
-  priv = baseaudiopayload->priv;
-  adapter = priv->adapter;
 
   basepayload = GST_RTP_BASE_PAYLOAD (baseaudiopayload);
 
   if (payload_len == -1)
-    payload_len = gst_adapter_available (adapter);
+    payload_len = gst_adapter_available (baseaudiopayload->priv->adapter);
 
   /* nothing to do, just return */
   if (payload_len == 0)
     return GST_FLOW_OK;
 
-  if (timestamp == -1) {
-    /* calculate the timestamp */
-    timestamp = gst_adapter_prev_pts (adapter, &distance);
-
-    GST_LOG_OBJECT (baseaudiopayload,
-        "last timestamp %" GST_TIME_FORMAT ", distance %" G_GUINT64_FORMAT,
-        GST_TIME_ARGS (timestamp), distance);
-
-    if (GST_CLOCK_TIME_IS_VALID (timestamp) && distance > 0) {
-      /* convert the number of bytes since the last timestamp to time and add to
-       * the last seen timestamp */
-      timestamp += priv->bytes_to_time (baseaudiopayload, distance);
-    }
-  }
-
-  GST_DEBUG_OBJECT (baseaudiopayload, "Pushing %d bytes ts %" GST_TIME_FORMAT,
-      payload_len, GST_TIME_ARGS (timestamp));
-
-  if (priv->buffer_list && gst_adapter_available_fast (adapter) >= payload_len) {
-    GstBuffer *buffer;
-    /* we can quickly take a buffer out of the adapter without having to copy
-     * anything. */
-    buffer = gst_adapter_take_buffer (adapter, payload_len);
-
-    ret =
-        gst_rtp_base_audio_payload_push_buffer (baseaudiopayload, buffer,
-        timestamp);
-  } else {
-    GstBuffer *paybuf;
-    CopyMetaData data;
-
-
-    /* create buffer to hold the payload */
-    outbuf = gst_rtp_base_payload_allocate_output_buffer (basepayload, 0, 0, 0);
-
-    paybuf = gst_adapter_take_buffer_fast (adapter, payload_len);
+  outbuf = gst_rtp_base_audio_payload_take_packet (baseaudiopayload,
+      payload_len, timestamp);
 
-    data.pay = baseaudiopayload;
-    data.outbuf = outbuf;
-    gst_buffer_foreach_meta (paybuf, foreach_metadata, &data);
-    outbuf = gst_buffer_append (outbuf, paybuf);
-
-    /* set metadata */
-    gst_rtp_base_audio_payload_set_meta (baseaudiopayload, outbuf, payload_len,
-        timestamp);
-
-    ret = gst_rtp_base_payload_push (basepayload, outbuf);
-  }
-
-  return ret;
+  return gst_rtp_base_payload_push (basepayload, outbuf);
 }
 
 #define ALIGN_DOWN(val,len) ((val) - ((val) % (len)))
@@ -841,6 +821,7 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
   guint size;
   gboolean discont;
   GstClockTime timestamp;
+  GstBufferList *list = NULL;
 
   ret = GST_FLOW_OK;
 
@@ -912,8 +893,12 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
 
     GST_DEBUG_OBJECT (payload, "available now %u", available);
 
+    /* with buffer lists, all packets made from this input go out in one
+     * list */
+    if (priv->buffer_list && available >= min_payload_len)
+      list = gst_buffer_list_new_sized (available / MAX (min_payload_len, 1));
+
     /* as long as we have full frames */
-    /* TODO: Use buffer lists here */
     while (available >= min_payload_len) {
       /* get multiple of alignment */
       payload_len = MIN (max_payload_len, available);
@@ -921,11 +906,22 @@ gst_rtp_base_audio_payload_handle_buffer (GstRTPBasePayload *
 
       /* and flush out the bytes from the adapter, automatically set the
        * timestamp. */
-      ret = gst_rtp_base_audio_payload_flush (payload, payload_len, -1);
+      if (list) {
+        gst_buffer_list_add (list,
+            gst_rtp_base_audio_payload_take_packet (payload, payload_len, -1));
+      } else {
+        ret = gst_rtp_base_audio_payload_flush (payload, payload_len, -1);
+      }
 
       available -= payload_len;
       GST_DEBUG_OBJECT (payload, "available after push %u", available);
     }
+
+    if (list) {
+      GST_DEBUG_OBJECT (payload, "Pushing list of %u packets",
+          gst_buffer_list_length (list));
+      ret = gst_rtp_base_payload_push_list (basepayload, list);
+    }
   }
   return ret;
 
@@ -65,6 +65,9 @@ struct _GstRTPBaseDepayloadPrivate
   GstBuffer *input_buffer;
 
   GstFlowReturn process_flow_ret;
+
+  gboolean list_output;
+  GstBufferList *output_list;   /* output collected while handling a list */
 };
 
 /* Filter signals and args */
@@ -406,7 +409,10 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
   if (G_UNLIKELY (!priv->negotiated))
     goto not_negotiated;
 
-  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
+  /* only read the header for now, duplicates are dropped before the packet
+   * is mapped and validated */
+  if (G_UNLIKELY (!gst_rtp_buffer_peek_header (in, NULL, &seqnum, &rtptime,
+              &ssrc, NULL, NULL)))
     goto invalid_buffer;
 
   buf_discont = GST_BUFFER_IS_DISCONT (in);
@@ -415,10 +421,6 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
   priv->dts = GST_BUFFER_DTS (in);
   priv->duration = GST_BUFFER_DURATION (in);
 
-  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
-  seqnum = gst_rtp_buffer_get_seq (&rtp);
-  rtptime = gst_rtp_buffer_get_timestamp (&rtp);
-
   priv->last_seqnum = seqnum;
   priv->last_rtptime = rtptime;
 
@@ -474,24 +476,19 @@ gst_rtp_base_depayload_handle_buffer (GstRTPBaseDepayload * filter,
   if (G_UNLIKELY (discont)) {
     priv->discont = TRUE;
     if (!buf_discont) {
-      gpointer old_inbuf = in;
-
       /* we detected a seqnum discont but the buffer was not flagged with a discont,
        * set the discont flag so that the subclass can throw away old data. */
       GST_LOG_OBJECT (filter, "mark DISCONT on input buffer");
       in = gst_buffer_make_writable (in);
       GST_BUFFER_FLAG_SET (in, GST_BUFFER_FLAG_DISCONT);
-      /* depayloaders will check flag on rtpbuffer->buffer, so if the input
-       * buffer was not writable already we need to remap to make our
-       * newly-flagged buffer current on the rtpbuffer */
-      if (in != old_inbuf) {
-        gst_rtp_buffer_unmap (&rtp);
-        if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
-          goto invalid_buffer;
-      }
     }
   }
 
+  /* depayloaders check the flags on rtpbuffer->buffer, so map the buffer
+   * only now that it is flagged */
+  if (G_UNLIKELY (!gst_rtp_buffer_map (in, GST_MAP_READ, &rtp)))
+    goto invalid_buffer;
+
   /* prepare segment event if needed */
   if (filter->need_newsegment) {
     priv->segment_event = create_segment_event (filter, rtptime,
@@ -549,7 +546,6 @@ invalid_buffer:
   }
 dropping:
   {
-    gst_rtp_buffer_unmap (&rtp);
     GST_WARNING_OBJECT (filter, "%d <= %d, dropping old packet", gap,
         priv->max_reorder);
     gst_buffer_unref (in);
@@ -582,6 +578,28 @@ gst_rtp_base_depayload_chain (GstPad * pad, GstObject * parent, GstBuffer * in)
   return flow_ret;
 }
 
+/* push what was collected from the current input list */
+static GstFlowReturn
+gst_rtp_base_depayload_flush_output (GstRTPBaseDepayload * filter)
+{
+  GstBufferList *list = filter->priv->output_list;
+  GstFlowReturn res = GST_FLOW_OK;
+
+  filter->priv->output_list = NULL;
+  if (list == NULL)
+    return GST_FLOW_OK;
+
+  if (gst_buffer_list_length (list) > 0) {
+    res = gst_pad_push_list (filter->srcpad, list);
+    if (res != GST_FLOW_OK)
+      filter->priv->process_flow_ret = res;
+  } else {
+    gst_buffer_list_unref (list);
+  }
+
+  return res;
+}
+
 static GstFlowReturn
 gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * list)
@@ -604,6 +622,10 @@ gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
   if (len == 0)
     goto done;
 
+  /* collect the output of the whole list to push it at once */
+  if (basedepay->priv->list_output)
+    basedepay->priv->output_list = gst_buffer_list_new_sized (len);
+
   for (i = 0; i < len; i++) {
     buffer = gst_buffer_list_get (list, i);
 
@@ -619,6 +641,14 @@ gst_rtp_base_depayload_chain_list (GstPad * pad, GstObject * parent,
       break;
   }
 
+  if (basedepay->priv->output_list) {
+    GstFlowReturn push_ret;
+
+    push_ret = gst_rtp_base_depayload_flush_output (basedepay);
+    if (flow_ret == GST_FLOW_OK)
+      flow_ret = push_ret;
+  }
+
 done:
 
   gst_buffer_list_unref (list);
@@ -888,6 +918,11 @@ gst_rtp_base_depayload_prepare_push (GstRTPBaseDepayload * filter,
 
   /* if this is the first buffer send a NEWSEGMENT */
   if (G_UNLIKELY (filter->priv->segment_event)) {
+    /* the collected output belongs to the previous segment */
+    if (filter->priv->output_list) {
+      gst_rtp_base_depayload_flush_output (filter);
+      filter->priv->output_list = gst_buffer_list_new ();
+    }
     gst_pad_push_event (filter->srcpad, filter->priv->segment_event);
     filter->priv->segment_event = NULL;
     GST_DEBUG_OBJECT (filter, "Pushed newsegment event on this first buffer");
@@ -916,10 +951,15 @@ gst_rtp_base_depayload_push (GstRTPBaseDepayload * filter, GstBuffer * out_buf)
 
   res = gst_rtp_base_depayload_prepare_push (filter, FALSE, &out_buf);
 
-  if (G_LIKELY (res == GST_FLOW_OK))
+  if (G_LIKELY (res == GST_FLOW_OK)) {
+    if (filter->priv->output_list) {
+      gst_buffer_list_add (filter->priv->output_list, out_buf);
+      return filter->priv->process_flow_ret;
+    }
     res = gst_pad_push (filter->srcpad, out_buf);
-  else
+  } else {
     gst_buffer_unref (out_buf);
+  }
 
   if (res != GST_FLOW_OK)
     filter->priv->process_flow_ret = res;
@@ -945,10 +985,20 @@ gst_rtp_base_depayload_push_list (GstRTPBaseDepayload * filter,
 
   res = gst_rtp_base_depayload_prepare_push (filter, TRUE, &out_list);
 
-  if (G_LIKELY (res == GST_FLOW_OK))
+  if (G_LIKELY (res == GST_FLOW_OK)) {
+    if (filter->priv->output_list) {
+      guint i, len = gst_buffer_list_length (out_list);
+
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (filter->priv->output_list,
+            gst_buffer_ref (gst_buffer_list_get (out_list, i)));
+      gst_buffer_list_unref (out_list);
+      return filter->priv->process_flow_ret;
+    }
     res = gst_pad_push_list (filter->srcpad, out_list);
-  else
+  } else {
     gst_buffer_list_unref (out_list);
+  }
 
   if (res != GST_FLOW_OK)
     filter->priv->process_flow_ret = res;
@@ -1166,3 +1216,43 @@ gst_rtp_base_depayload_is_source_info_enabled (GstRTPBaseDepayload * depayload)
 {
   return depayload->priv->source_info;
 }
+
+/**
+ * gst_rtp_base_depayload_set_list_output_enabled:
+ * @depayload: a #GstRTPBaseDepayload
+ * @enable: whether to push the output of an input list as one list
+ *
+ * When enabled, the buffers produced while handling an input #GstBufferList
+ * are not pushed one by one, but collected and pushed downstream as a
+ * single #GstBufferList once the whole input list was handled. Sources
+ * receiving packets in batches can then keep that batching downstream.
+ *
+ * Only enable this in subclasses that don't push serialized events, like
+ * caps changes, themselves from the process functions, as those would
+ * overtake the collected buffers.
+ *
+ * Since: 1.18
+ **/
+void
+gst_rtp_base_depayload_set_list_output_enabled (GstRTPBaseDepayload *
+    depayload, gboolean enable)
+{
+  depayload->priv->list_output = enable;
+}
+
+/**
+ * gst_rtp_base_depayload_is_list_output_enabled:
+ * @depayload: a #GstRTPBaseDepayload
+ *
+ * Queries whether the output of input buffer lists is pushed as one list.
+ *
+ * Returns: %TRUE if list output is enabled.
+ *
+ * Since: 1.18
+ **/
+gboolean
+gst_rtp_base_depayload_is_list_output_enabled (GstRTPBaseDepayload *
+    depayload)
+{
+  return depayload->priv->list_output;
+}
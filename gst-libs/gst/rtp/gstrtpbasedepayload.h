@@ -127,6 +127,13 @@ GST_RTP_API
 void            gst_rtp_base_depayload_set_source_info_enabled (GstRTPBaseDepayload * depayload,
                                                                 gboolean enable);
 
+GST_RTP_API
+gboolean        gst_rtp_base_depayload_is_list_output_enabled  (GstRTPBaseDepayload * depayload);
+
+GST_RTP_API
+void            gst_rtp_base_depayload_set_list_output_enabled (GstRTPBaseDepayload * depayload,
+                                                                gboolean enable);
+
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTPBaseDepayload, gst_object_unref)
 
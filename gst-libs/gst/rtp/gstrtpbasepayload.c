@@ -34,6 +34,44 @@
 GST_DEBUG_CATEGORY_STATIC (rtpbasepayload_debug);
 #define GST_CAT_DEFAULT (rtpbasepayload_debug)
 
+/* fixed header with the maximum of 15 CSRCs */
+#define RTP_MAX_HEADER_LEN (12 + 15 * 4)
+
+/* Pool of buffers holding one RTP header memory. The payload is appended to
+ * them by reference, so when they come back the appended memory is dropped
+ * again to keep only the header. */
+typedef GstBufferPool GstRTPHeaderPool;
+typedef GstBufferPoolClass GstRTPHeaderPoolClass;
+
+static GType gst_rtp_header_pool_get_type (void);
+G_DEFINE_TYPE (GstRTPHeaderPool, gst_rtp_header_pool, GST_TYPE_BUFFER_POOL);
+
+static void
+gst_rtp_header_pool_reset_buffer (GstBufferPool * pool, GstBuffer * buffer)
+{
+  guint n_mem = gst_buffer_n_memory (buffer);
+
+  if (n_mem > 1)
+    gst_buffer_remove_memory_range (buffer, 1, n_mem - 1);
+  GST_BUFFER_FLAG_UNSET (buffer, GST_BUFFER_FLAG_TAG_MEMORY);
+  /* the pool only takes back buffers of its own size */
+  gst_buffer_set_size (buffer, RTP_MAX_HEADER_LEN);
+
+  GST_BUFFER_POOL_CLASS (gst_rtp_header_pool_parent_class)->reset_buffer
+      (pool, buffer);
+}
+
+static void
+gst_rtp_header_pool_class_init (GstRTPHeaderPoolClass * klass)
+{
+  klass->reset_buffer = gst_rtp_header_pool_reset_buffer;
+}
+
+static void
+gst_rtp_header_pool_init (GstRTPHeaderPool * pool)
+{
+}
+
 struct _GstRTPBasePayloadPrivate
 {
   gboolean ts_offset_random;
@@ -66,6 +104,8 @@ struct _GstRTPBasePayloadPrivate
 
   GstCaps *subclass_srccaps;
   GstCaps *sinkcaps;
+
+  GstBufferPool *header_pool;   /* header only output buffers */
 };
 
 /* RTPBasePayload signals and args */
@@ -433,6 +473,16 @@ gst_rtp_base_payload_init (GstRTPBasePayload * rtpbasepayload, gpointer g_class)
   rtpbasepayload->priv->prop_max_ptime = DEFAULT_MAX_PTIME;
 }
 
+static void
+gst_rtp_base_payload_clear_header_pool (GstRTPBasePayload * payload)
+{
+  if (payload->priv->header_pool) {
+    gst_buffer_pool_set_active (payload->priv->header_pool, FALSE);
+    gst_object_unref (payload->priv->header_pool);
+    payload->priv->header_pool = NULL;
+  }
+}
+
 static void
 gst_rtp_base_payload_finalize (GObject * object)
 {
@@ -447,6 +497,7 @@ gst_rtp_base_payload_finalize (GObject * object)
 
   gst_caps_replace (&rtpbasepayload->priv->subclass_srccaps, NULL);
   gst_caps_replace (&rtpbasepayload->priv->sinkcaps, NULL);
+  gst_rtp_base_payload_clear_header_pool (rtpbasepayload);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -1498,6 +1549,64 @@ gst_rtp_base_payload_push (GstRTPBasePayload * payload, GstBuffer * buffer)
  *
  * Since: 1.16
  */
+/* An output buffer with only a header for @csrc_count CSRCs, taken from the
+ * header pool. Returns NULL if the pool can't be used. */
+static GstBuffer *
+gst_rtp_base_payload_acquire_header (GstRTPBasePayload * payload,
+    guint8 csrc_count)
+{
+  GstRTPBasePayloadPrivate *priv = payload->priv;
+  GstBuffer *buffer = NULL;
+  GstMapInfo map;
+  guint len;
+
+  if (G_UNLIKELY (priv->header_pool == NULL)) {
+    GstStructure *config;
+
+    priv->header_pool = g_object_new (gst_rtp_header_pool_get_type (), NULL);
+    gst_object_ref_sink (priv->header_pool);
+    config = gst_buffer_pool_get_config (priv->header_pool);
+    gst_buffer_pool_config_set_params (config, NULL, RTP_MAX_HEADER_LEN, 0, 0);
+    if (!gst_buffer_pool_set_config (priv->header_pool, config)
+        || !gst_buffer_pool_set_active (priv->header_pool, TRUE)) {
+      GST_WARNING_OBJECT (payload, "failed to set up header pool");
+      gst_rtp_base_payload_clear_header_pool (payload);
+      return NULL;
+    }
+  }
+
+  if (gst_buffer_pool_acquire_buffer (priv->header_pool, &buffer,
+          NULL) != GST_FLOW_OK)
+    return NULL;
+
+  /* same fields as gst_rtp_buffer_allocate_data() */
+  len = 12 + csrc_count * 4;
+  gst_buffer_resize (buffer, 0, len);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  memset (map.data, 0, len);
+  map.data[0] = (GST_RTP_VERSION << 6) | csrc_count;
+  gst_buffer_unmap (buffer, &map);
+
+  return buffer;
+}
+
+static GstBuffer *
+gst_rtp_base_payload_new_output_buffer (GstRTPBasePayload * payload,
+    guint payload_len, guint8 pad_len, guint8 csrc_count)
+{
+  GstBuffer *buffer = NULL;
+
+  /* headers for a payload appended later come from a pool, which avoids
+   * allocating for every packet */
+  if (payload_len == 0 && pad_len == 0)
+    buffer = gst_rtp_base_payload_acquire_header (payload, csrc_count);
+
+  if (buffer == NULL)
+    buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len, csrc_count);
+
+  return buffer;
+}
+
 GstBuffer *
 gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload * payload,
     guint payload_len, guint8 pad_len, guint8 csrc_count)
@@ -1514,8 +1623,8 @@ gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload * payload,
       total_csrc_count = csrc_count + meta->csrc_count +
           (meta->ssrc_valid ? 1 : 0);
       total_csrc_count = MIN (total_csrc_count, 15);
-      buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len,
-          total_csrc_count);
+      buffer = gst_rtp_base_payload_new_output_buffer (payload, payload_len,
+          pad_len, total_csrc_count);
 
       gst_rtp_buffer_map (buffer, GST_MAP_READWRITE, &rtp);
 
@@ -1532,11 +1641,47 @@ gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload * payload,
   }
 
   if (buffer == NULL)
-    buffer = gst_rtp_buffer_new_allocate (payload_len, pad_len, csrc_count);
+    buffer = gst_rtp_base_payload_new_output_buffer (payload, payload_len,
+        pad_len, csrc_count);
 
   return buffer;
 }
 
+/**
+ * gst_rtp_base_payload_allocate_output_buffer_with_payload:
+ * @payload: a #GstRTPBasePayload
+ * @input: the buffer holding the payload data
+ * @offset: the offset of the payload in @input
+ * @size: the size of the payload, or -1 for everything after @offset
+ * @csrc_count: the minimum number of CSRC entries
+ *
+ * Like gst_rtp_base_payload_allocate_output_buffer(), but the payload is
+ * not copied into the new buffer. Instead the memory of @input in the given
+ * range is appended to the RTP header by reference. The header itself comes
+ * from a pool, so that payloaders producing many packets from the same input
+ * buffer don't allocate nor copy for each of them.
+ *
+ * Returns: (transfer full): a new RTP buffer with the payload of @input
+ *
+ * Since: 1.18
+ */
+GstBuffer *
+gst_rtp_base_payload_allocate_output_buffer_with_payload (GstRTPBasePayload *
+    payload, GstBuffer * input, gsize offset, gssize size, guint8 csrc_count)
+{
+  GstBuffer *buffer, *paybuf;
+
+  g_return_val_if_fail (GST_IS_RTP_BASE_PAYLOAD (payload), NULL);
+  g_return_val_if_fail (GST_IS_BUFFER (input), NULL);
+
+  buffer = gst_rtp_base_payload_allocate_output_buffer (payload, 0, 0,
+      csrc_count);
+  paybuf = gst_buffer_copy_region (input, GST_BUFFER_COPY_MEMORY, offset,
+      size);
+
+  return gst_buffer_append (buffer, paybuf);
+}
+
 static GstStructure *
 gst_rtp_base_payload_create_stats (GstRTPBasePayload * rtpbasepayload)
 {
@@ -1751,6 +1896,7 @@ gst_rtp_base_payload_change_state (GstElement * element,
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       gst_event_replace (&rtpbasepayload->priv->pending_segment, NULL);
+      gst_rtp_base_payload_clear_header_pool (rtpbasepayload);
       break;
     default:
       break;
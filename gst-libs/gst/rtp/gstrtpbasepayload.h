@@ -177,6 +177,12 @@ GstBuffer *     gst_rtp_base_payload_allocate_output_buffer (GstRTPBasePayload *
                                                              guint payload_len, guint8 pad_len,
                                                              guint8 csrc_count);
 
+GST_RTP_API
+GstBuffer *     gst_rtp_base_payload_allocate_output_buffer_with_payload (GstRTPBasePayload * payload,
+                                                                          GstBuffer * input,
+                                                                          gsize offset, gssize size,
+                                                                          guint8 csrc_count);
+
 GST_RTP_API
 void            gst_rtp_base_payload_set_source_info_enabled (GstRTPBasePayload * payload,
                                                               gboolean enable);
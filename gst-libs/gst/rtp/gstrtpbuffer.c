@@ -489,6 +489,92 @@ dump_packet:
   }
 }
 
+/**
+ * gst_rtp_buffer_peek_header:
+ * @buffer: a #GstBuffer
+ * @payload_type: (out) (optional): the payload type
+ * @seqnum: (out) (optional): the sequence number
+ * @timestamp: (out) (optional): the RTP timestamp
+ * @ssrc: (out) (optional): the SSRC
+ * @marker: (out) (optional): the marker bit
+ * @header_len: (out) (optional): the length of the fixed header, the CSRCs
+ *     and the header extension, in bytes
+ *
+ * Read the fixed RTP header of @buffer without mapping it as a
+ * #GstRTPBuffer. Only the first memory of @buffer is mapped and only the
+ * fixed header, the CSRCs and the length of the header extension are
+ * checked, the padding is not. This is much cheaper than
+ * gst_rtp_buffer_map() for code that only needs the sequence number or the
+ * timestamp of a packet, but use gst_rtp_buffer_map() to get at the payload.
+ *
+ * Returns: %TRUE if @buffer starts with a valid RTP header.
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_rtp_buffer_peek_header (GstBuffer * buffer, guint8 * payload_type,
+    guint16 * seqnum, guint32 * timestamp, guint32 * ssrc, gboolean * marker,
+    guint * header_len)
+{
+  GstMemory *mem;
+  GstMapInfo map;
+  const guint8 *data;
+  guint hlen;
+  gboolean ret = FALSE;
+
+  g_return_val_if_fail (GST_IS_BUFFER (buffer), FALSE);
+
+  if (gst_buffer_n_memory (buffer) < 1)
+    return FALSE;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_memory_map (mem, &map, GST_MAP_READ))
+    return FALSE;
+  data = map.data;
+
+  /* same checks as gst_rtp_buffer_map(), the header must be completely in
+   * the first memory */
+  if (G_UNLIKELY (map.size < GST_RTP_HEADER_LEN))
+    goto done;
+  if (G_UNLIKELY ((data[0] & 0xc0) != (GST_RTP_VERSION << 6)))
+    goto done;
+  if (G_UNLIKELY (data[1] >= 200 && data[1] <= 204))
+    goto done;
+
+  hlen = GST_RTP_HEADER_LEN + (data[0] & 0x0f) * sizeof (guint32);
+  if (G_UNLIKELY (map.size < hlen))
+    goto done;
+
+  if (data[0] & 0x10) {
+    /* the extension may be in a later memory, only read its length here */
+    guint8 extlen[2];
+
+    if (gst_buffer_extract (buffer, hlen + 2, extlen, 2) != 2)
+      goto done;
+    hlen += 4 + GST_READ_UINT16_BE (extlen) * sizeof (guint32);
+    if (G_UNLIKELY (gst_buffer_get_size (buffer) < hlen))
+      goto done;
+  }
+
+  if (payload_type)
+    *payload_type = data[1] & 0x7f;
+  if (marker)
+    *marker = (data[1] & 0x80) != 0;
+  if (seqnum)
+    *seqnum = GST_READ_UINT16_BE (data + 2);
+  if (timestamp)
+    *timestamp = GST_READ_UINT32_BE (data + 4);
+  if (ssrc)
+    *ssrc = GST_READ_UINT32_BE (data + 8);
+  if (header_len)
+    *header_len = hlen;
+  ret = TRUE;
+
+done:
+  gst_memory_unmap (mem, &map);
+  return ret;
+}
+
 /**
  * gst_rtp_buffer_unmap:
  * @rtp: a #GstRTPBuffer
@@ -1510,6 +1596,129 @@ gst_rtp_buffer_get_extension_twobytes_header (GstRTPBuffer * rtp,
   return FALSE;
 }
 
+/**
+ * gst_rtp_buffer_index_extensions:
+ * @rtp: the RTP packet
+ * @index: (out caller-allocates): a #GstRTPExtensionIndex to fill
+ *
+ * Parse the RFC 5285 style header extensions of @rtp, with a one byte or a
+ * two bytes header, once and store where the first extension with each ID
+ * is in @index. Code looking up several extensions of the same packet can
+ * then get each of them with gst_rtp_extension_index_get() without parsing
+ * the extension block again.
+ *
+ * @index points into the data of @rtp and becomes invalid when @rtp is
+ * unmapped or its extensions are modified.
+ *
+ * Returns: %TRUE if @rtp has one or two bytes header extensions
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_rtp_buffer_index_extensions (GstRTPBuffer * rtp,
+    GstRTPExtensionIndex * index)
+{
+  guint16 bits;
+  guint8 *pdata;
+  guint wordlen, bytelen;
+  gulong offset = 0;
+  gboolean twobytes;
+
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  memset (index->offset, 0, sizeof (index->offset));
+  index->data = NULL;
+
+  if (!gst_rtp_buffer_get_extension_data (rtp, &bits, (gpointer *) & pdata,
+          &wordlen))
+    return FALSE;
+
+  if (bits == 0xBEDE)
+    twobytes = FALSE;
+  else if (bits >> 4 == 0x100)
+    twobytes = TRUE;
+  else
+    return FALSE;
+
+  index->data = pdata;
+  bytelen = wordlen * 4;
+
+  /* same parsing as the _get_extension_*_header functions */
+  for (;;) {
+    guint8 read_id, read_len;
+
+    if (twobytes) {
+      if (offset + 2 >= bytelen)
+        break;
+
+      read_id = GST_READ_UINT8 (pdata + offset);
+      offset += 1;
+      if (read_id == 0)
+        continue;
+
+      read_len = GST_READ_UINT8 (pdata + offset);
+      offset += 1;
+    } else {
+      if (offset + 1 >= bytelen)
+        break;
+
+      read_id = GST_READ_UINT8 (pdata + offset) >> 4;
+      read_len = (GST_READ_UINT8 (pdata + offset) & 0x0F) + 1;
+      offset += 1;
+      if (read_id == 0)
+        continue;
+      if (read_id == 15)
+        break;
+    }
+
+    if (offset + read_len > bytelen)
+      break;
+
+    if (index->offset[read_id] == 0) {
+      index->offset[read_id] = offset + 1;
+      index->size[read_id] = read_len;
+    }
+    offset += read_len;
+  }
+
+  return TRUE;
+}
+
+/**
+ * gst_rtp_extension_index_get:
+ * @index: a #GstRTPExtensionIndex
+ * @id: The ID of the header extension to be read
+ * @data: (out) (optional) (array length=size) (element-type guint8)
+ *   (transfer none): location for data
+ * @size: (out) (optional): the size of the data in bytes
+ *
+ * Get the first header extension with @id from @index, filled by
+ * gst_rtp_buffer_index_extensions(). Use
+ * gst_rtp_buffer_get_extension_onebyte_header() or
+ * gst_rtp_buffer_get_extension_twobytes_header() for the next extensions
+ * with the same ID.
+ *
+ * Returns: %TRUE if the packet had a header extension with @id
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_rtp_extension_index_get (const GstRTPExtensionIndex * index, guint8 id,
+    gpointer * data, guint * size)
+{
+  g_return_val_if_fail (index != NULL, FALSE);
+
+  if (index->offset[id] == 0)
+    return FALSE;
+
+  if (data)
+    *data = (gpointer) (index->data + index->offset[id] - 1);
+  if (size)
+    *size = index->size[id];
+
+  return TRUE;
+}
+
 static guint
 get_onebyte_header_end_offset (guint8 * pdata, guint wordlen)
 {
@@ -59,6 +59,24 @@ struct _GstRTPBuffer
   GstMapInfo   map[4];
 };
 
+/**
+ * GstRTPExtensionIndex:
+ *
+ * The position of the first RFC 5285 header extension with each ID in an RTP
+ * packet, filled by gst_rtp_buffer_index_extensions(). The size of the
+ * structure is made public to allow stack allocations.
+ *
+ * Since: 1.18
+ */
+typedef struct {
+  /*< private >*/
+  const guint8 *data;
+  guint32       offset[256];    /* offset + 1 of each ID, 0 when absent */
+  guint8        size[256];
+
+  gpointer _gst_reserved[GST_PADDING];
+} GstRTPExtensionIndex;
+
 #define GST_RTP_BUFFER_INIT { NULL, 0, { NULL, NULL, NULL, NULL}, { 0, 0, 0, 0 }, \
   { GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT, GST_MAP_INFO_INIT} }
 
@@ -95,6 +113,12 @@ gboolean        gst_rtp_buffer_map                   (GstBuffer *buffer, GstMapF
 GST_RTP_API
 void            gst_rtp_buffer_unmap                 (GstRTPBuffer *rtp);
 
+GST_RTP_API
+gboolean        gst_rtp_buffer_peek_header           (GstBuffer *buffer, guint8 *payload_type,
+                                                      guint16 *seqnum, guint32 *timestamp,
+                                                      guint32 *ssrc, gboolean *marker,
+                                                      guint *header_len);
+
 GST_RTP_API
 void            gst_rtp_buffer_set_packet_len        (GstRTPBuffer *rtp, guint len);
 
@@ -228,6 +252,16 @@ gboolean       gst_rtp_buffer_add_extension_twobytes_header (GstRTPBuffer *rtp,
                                                              gconstpointer data,
                                                              guint size);
 
+GST_RTP_API
+gboolean       gst_rtp_buffer_index_extensions              (GstRTPBuffer *rtp,
+                                                             GstRTPExtensionIndex *index);
+
+GST_RTP_API
+gboolean       gst_rtp_extension_index_get                  (const GstRTPExtensionIndex *index,
+                                                             guint8 id,
+                                                             gpointer * data,
+                                                             guint * size);
+
 GST_RTP_API
 gboolean gst_rtp_buffer_get_extension_onebyte_header_from_bytes (GBytes * bytes,
                                                                  guint16 bit_pattern,
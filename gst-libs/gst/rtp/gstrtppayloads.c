@@ -177,6 +177,59 @@ static const GstRTPPayloadInfo info[] = {
   {G_MAXUINT8, NULL, NULL, 0, NULL, 0}
 };
 
+/* lookup tables over info[], built once. The first entry of info[] for a
+ * payload type or a media/encoding_name pair is the one that is found */
+static const GstRTPPayloadInfo *info_by_pt[G_MAXUINT8 + 1];
+static GHashTable *info_by_name;
+
+static guint
+payload_info_hash (gconstpointer key)
+{
+  const GstRTPPayloadInfo *pinfo = key;
+  const gchar *p;
+  guint hash;
+
+  hash = g_str_hash (pinfo->media);
+  for (p = pinfo->encoding_name; *p; p++)
+    hash = (hash << 5) - hash + g_ascii_tolower (*p);
+
+  return hash;
+}
+
+static gboolean
+payload_info_equal (gconstpointer a, gconstpointer b)
+{
+  const GstRTPPayloadInfo *pa = a, *pb = b;
+
+  return strcmp (pa->media, pb->media) == 0
+      && g_ascii_strcasecmp (pa->encoding_name, pb->encoding_name) == 0;
+}
+
+static void
+init_payload_info_tables (void)
+{
+  static gsize tables_init = 0;
+
+  if (g_once_init_enter (&tables_init)) {
+    GHashTable *by_name;
+    gint i;
+
+    by_name = g_hash_table_new (payload_info_hash, payload_info_equal);
+
+    for (i = 0; info[i].media; i++) {
+      /* G_MAXUINT8 marks entries without a payload type */
+      if (info[i].payload_type != G_MAXUINT8
+          && info_by_pt[info[i].payload_type] == NULL)
+        info_by_pt[info[i].payload_type] = &info[i];
+      if (!g_hash_table_contains (by_name, &info[i]))
+        g_hash_table_add (by_name, (gpointer) & info[i]);
+    }
+    info_by_name = by_name;
+
+    g_once_init_leave (&tables_init, 1);
+  }
+}
+
 /**
  * gst_rtp_payload_info_for_pt:
  * @payload_type: the payload_type to find
@@ -193,6 +246,11 @@ gst_rtp_payload_info_for_pt (guint8 payload_type)
   const GstRTPPayloadInfo *result = NULL;
   gint i;
 
+  if (payload_type != G_MAXUINT8) {
+    init_payload_info_tables ();
+    return info_by_pt[payload_type];
+  }
+
   for (i = 0; info[i].media; i++) {
     if (info[i].payload_type == payload_type) {
       result = &info[i];
@@ -218,15 +276,12 @@ gst_rtp_payload_info_for_pt (guint8 payload_type)
 const GstRTPPayloadInfo *
 gst_rtp_payload_info_for_name (const gchar * media, const gchar * encoding_name)
 {
-  const GstRTPPayloadInfo *result = NULL;
-  gint i;
+  GstRTPPayloadInfo key = { 0, };
 
-  for (i = 0; info[i].media; i++) {
-    if (strcmp (media, info[i].media) == 0
-        && g_ascii_strcasecmp (encoding_name, info[i].encoding_name) == 0) {
-      result = &info[i];
-      break;
-    }
-  }
-  return result;
+  init_payload_info_tables ();
+
+  key.media = media;
+  key.encoding_name = encoding_name;
+
+  return g_hash_table_lookup (info_by_name, &key);
 }
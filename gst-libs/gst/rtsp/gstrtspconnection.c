@@ -117,6 +117,9 @@ typedef struct
 
   /* ID of the message for notification */
   guint id;
+
+  /* monotonic time at which the message was queued */
+  gint64 queued_time;
 } GstRTSPSerializedMessage;
 
 static void
@@ -184,6 +187,12 @@ struct _GstRTSPConnection
   gchar *initial_buffer;
   gsize initial_buffer_offset;
 
+  /* data read from input_stream but not consumed yet, so that parsing the
+   * headers doesn't need a read for every byte */
+  guint8 *read_buffer;          /* READ_BUFFER_SIZE bytes, allocated on use */
+  guint read_buffer_offset;
+  guint read_buffer_size;
+
   gboolean remember_session_id; /* remember the session id or not */
 
   /* Session state */
@@ -1359,12 +1368,39 @@ writev_bytes (GOutputStream * stream, GOutputVector * vectors, gint n_vectors,
 }
 #endif
 
+#define READ_BUFFER_SIZE 4096
+
+#define HAS_READ_AHEAD(conn) ((conn)->initial_buffer != NULL || \
+    (conn)->read_buffer_offset < (conn)->read_buffer_size)
+
+static gssize
+read_input_stream (GstRTSPConnection * conn, guint8 * buffer, gsize count,
+    gboolean block, GError ** err)
+{
+  if (block)
+    return g_input_stream_read (conn->input_stream, (gchar *) buffer,
+        count, conn->may_cancel ? conn->cancellable : NULL, err);
+  else
+    return g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
+        (conn->input_stream), (gchar *) buffer, count,
+        conn->may_cancel ? conn->cancellable : NULL, err);
+}
+
 static gint
 fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
     gboolean block, GError ** err)
 {
   gint out = 0;
 
+  if (conn->read_buffer_offset < conn->read_buffer_size) {
+    out = MIN (conn->read_buffer_size - conn->read_buffer_offset, size);
+    memcpy (buffer, &conn->read_buffer[conn->read_buffer_offset], out);
+    conn->read_buffer_offset += out;
+
+    /* don't wait for more, the caller will ask again if needed */
+    return out;
+  }
+
   if (G_UNLIKELY (conn->initial_buffer != NULL)) {
     gsize left = strlen (&conn->initial_buffer[conn->initial_buffer_offset]);
 
@@ -1382,13 +1418,25 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
   if (G_LIKELY (size > (guint) out)) {
     gssize r;
     gsize count = size - out;
-    if (block)
-      r = g_input_stream_read (conn->input_stream, (gchar *) & buffer[out],
-          count, conn->may_cancel ? conn->cancellable : NULL, err);
-    else
-      r = g_pollable_input_stream_read_nonblocking (G_POLLABLE_INPUT_STREAM
-          (conn->input_stream), (gchar *) & buffer[out], count,
-          conn->may_cancel ? conn->cancellable : NULL, err);
+
+    if (count >= READ_BUFFER_SIZE) {
+      /* big reads, like message bodies, go straight to the caller */
+      r = read_input_stream (conn, &buffer[out], count, block, err);
+    } else {
+      /* small reads, like the header lines that are read one byte at a time,
+       * are served from what we read ahead */
+      if (conn->read_buffer == NULL)
+        conn->read_buffer = g_malloc (READ_BUFFER_SIZE);
+
+      r = read_input_stream (conn, conn->read_buffer, READ_BUFFER_SIZE, block,
+          err);
+      if (r > 0) {
+        conn->read_buffer_size = r;
+        conn->read_buffer_offset = MIN (r, count);
+        memcpy (&buffer[out], conn->read_buffer, conn->read_buffer_offset);
+        r = conn->read_buffer_offset;
+      }
+    }
 
     if (G_UNLIKELY (r < 0)) {
       if (out == 0) {
@@ -2796,6 +2844,10 @@ gst_rtsp_connection_close (GstRTSPConnection * conn)
   conn->initial_buffer = NULL;
   conn->initial_buffer_offset = 0;
 
+  g_free (conn->read_buffer);
+  conn->read_buffer = NULL;
+  conn->read_buffer_offset = conn->read_buffer_size = 0;
+
   conn->write_socket = NULL;
   conn->read_socket = NULL;
   conn->tunneled = FALSE;
@@ -2884,6 +2936,15 @@ gst_rtsp_connection_poll_usec (GstRTSPConnection * conn, GstRTSPEvent events,
   g_return_val_if_fail (conn->read_socket != NULL, GST_RTSP_EINVAL);
   g_return_val_if_fail (conn->write_socket != NULL, GST_RTSP_EINVAL);
 
+  /* data we read ahead can be read without waiting */
+  if ((events & GST_RTSP_EV_READ) && HAS_READ_AHEAD (conn)) {
+    *revents = GST_RTSP_EV_READ;
+    if ((events & GST_RTSP_EV_WRITE) &&
+        (g_socket_condition_check (conn->write_socket, G_IO_OUT) & G_IO_OUT))
+      *revents |= GST_RTSP_EV_WRITE;
+    return GST_RTSP_OK;
+  }
+
   ctx = g_main_context_new ();
 
   /* configure timeout if any */
@@ -3483,6 +3544,14 @@ gst_rtsp_connection_do_tunnel (GstRTSPConnection * conn,
       conn->input_stream = conn2->input_stream;
       conn->control_stream = g_io_stream_get_input_stream (conn->stream0);
       conn2->output_stream = NULL;
+
+      /* and what was already read from it */
+      g_free (conn->read_buffer);
+      conn->read_buffer = conn2->read_buffer;
+      conn->read_buffer_offset = conn2->read_buffer_offset;
+      conn->read_buffer_size = conn2->read_buffer_size;
+      conn2->read_buffer = NULL;
+      conn2->read_buffer_offset = conn2->read_buffer_size = 0;
     } else {
       /* conn2 is the HTTP GET channel. take its socket and set it as write
        * socket in conn */
@@ -3593,6 +3662,8 @@ struct _GstRTSPWatch
 
   gsize max_bytes;
   guint max_messages;
+  gint64 max_time;              /* in microseconds, 0 for no limit */
+  GstRTSPWatchBacklogPolicy backlog_policy;
   GCond queue_not_full;
   gboolean flushing;
 
@@ -3602,15 +3673,33 @@ struct _GstRTSPWatch
   GDestroyNotify notify;
 };
 
-#define IS_BACKLOG_FULL(w) (((w)->max_bytes != 0 && (w)->messages_bytes >= (w)->max_bytes) || \
-      ((w)->max_messages != 0 && (w)->messages_count >= (w)->max_messages))
+#define IS_BACKLOG_FULL(w) (is_backlog_full (w))
+
+static gboolean
+is_backlog_full (GstRTSPWatch * watch)
+{
+  GstRTSPSerializedMessage *msg;
+
+  if (watch->max_bytes != 0 && watch->messages_bytes >= watch->max_bytes)
+    return TRUE;
+  if (watch->max_messages != 0 && watch->messages_count >= watch->max_messages)
+    return TRUE;
+
+  /* the oldest message waited too long */
+  if (watch->max_time != 0 && watch->messages &&
+      (msg = gst_queue_array_peek_head_struct (watch->messages)) &&
+      g_get_monotonic_time () - msg->queued_time >= watch->max_time)
+    return TRUE;
+
+  return FALSE;
+}
 
 static gboolean
 gst_rtsp_source_prepare (GSource * source, gint * timeout)
 {
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
 
-  if (watch->conn->initial_buffer != NULL)
+  if (HAS_READ_AHEAD (watch->conn))
     return TRUE;
 
   *timeout = (watch->conn->timeout * 1000);
@@ -3834,7 +3923,7 @@ gst_rtsp_source_dispatch (GSource * source, GSourceFunc callback G_GNUC_UNUSED,
   GstRTSPWatch *watch = (GstRTSPWatch *) source;
   GstRTSPConnection *conn = watch->conn;
 
-  if (conn->initial_buffer != NULL) {
+  if (HAS_READ_AHEAD (conn)) {
     gst_rtsp_source_dispatch_read (G_POLLABLE_INPUT_STREAM (conn->input_stream),
         watch);
   }
@@ -4314,7 +4403,8 @@ gst_rtsp_watch_unref (GstRTSPWatch * watch)
  *
  * Set the maximum amount of bytes and messages that will be queued in @watch.
  * When the maximum amounts are exceeded, gst_rtsp_watch_write_data() and
- * gst_rtsp_watch_send_message() will return #GST_RTSP_ENOMEM.
+ * gst_rtsp_watch_send_message() will return #GST_RTSP_ENOMEM, unless another
+ * policy was set with gst_rtsp_watch_set_send_backlog_policy().
  *
  * A value of 0 for @bytes or @messages means no limits.
  *
@@ -4362,12 +4452,163 @@ gst_rtsp_watch_get_send_backlog (GstRTSPWatch * watch,
   g_mutex_unlock (&watch->mutex);
 }
 
+/**
+ * gst_rtsp_watch_set_send_backlog_time_usec:
+ * @watch: a #GstRTSPWatch
+ * @max_time: maximum time in microseconds
+ *
+ * Set the maximum time a message can stay queued in @watch. Once the oldest
+ * queued message waited longer than @max_time, the backlog is considered
+ * full in the same way as when the limits of gst_rtsp_watch_set_send_backlog()
+ * are exceeded.
+ *
+ * A value of 0 for @max_time means no limit.
+ *
+ * Since: 1.18
+ */
+void
+gst_rtsp_watch_set_send_backlog_time_usec (GstRTSPWatch * watch,
+    gint64 max_time)
+{
+  g_return_if_fail (watch != NULL);
+  g_return_if_fail (max_time >= 0);
+
+  g_mutex_lock (&watch->mutex);
+  watch->max_time = max_time;
+  if (!IS_BACKLOG_FULL (watch))
+    g_cond_signal (&watch->queue_not_full);
+  g_mutex_unlock (&watch->mutex);
+
+  GST_DEBUG ("set backlog time to %" G_GINT64_FORMAT " usec", max_time);
+}
+
+/**
+ * gst_rtsp_watch_get_send_backlog_time_usec:
+ * @watch: a #GstRTSPWatch
+ *
+ * Get the maximum time a message can stay queued in @watch. See
+ * gst_rtsp_watch_set_send_backlog_time_usec().
+ *
+ * Returns: the maximum time in microseconds, 0 if there is no limit
+ *
+ * Since: 1.18
+ */
+gint64
+gst_rtsp_watch_get_send_backlog_time_usec (GstRTSPWatch * watch)
+{
+  gint64 res;
+
+  g_return_val_if_fail (watch != NULL, 0);
+
+  g_mutex_lock (&watch->mutex);
+  res = watch->max_time;
+  g_mutex_unlock (&watch->mutex);
+
+  return res;
+}
+
+/**
+ * gst_rtsp_watch_set_send_backlog_policy:
+ * @watch: a #GstRTSPWatch
+ * @policy: a #GstRTSPWatchBacklogPolicy
+ *
+ * Set what @watch does with new messages when its backlog is full.
+ *
+ * Since: 1.18
+ */
+void
+gst_rtsp_watch_set_send_backlog_policy (GstRTSPWatch * watch,
+    GstRTSPWatchBacklogPolicy policy)
+{
+  g_return_if_fail (watch != NULL);
+
+  g_mutex_lock (&watch->mutex);
+  watch->backlog_policy = policy;
+  g_mutex_unlock (&watch->mutex);
+}
+
+/**
+ * gst_rtsp_watch_get_send_backlog_policy:
+ * @watch: a #GstRTSPWatch
+ *
+ * Get what @watch does with new messages when its backlog is full. See
+ * gst_rtsp_watch_set_send_backlog_policy().
+ *
+ * Returns: the #GstRTSPWatchBacklogPolicy of @watch
+ *
+ * Since: 1.18
+ */
+GstRTSPWatchBacklogPolicy
+gst_rtsp_watch_get_send_backlog_policy (GstRTSPWatch * watch)
+{
+  GstRTSPWatchBacklogPolicy res;
+
+  g_return_val_if_fail (watch != NULL, GST_RTSP_WATCH_BACKLOG_POLICY_FAIL);
+
+  g_mutex_lock (&watch->mutex);
+  res = watch->backlog_policy;
+  g_mutex_unlock (&watch->mutex);
+
+  return res;
+}
+
+/* call with watch->mutex. Drops queued data messages, oldest first, until
+ * the backlog is not full anymore and returns the ids of the dropped
+ * messages, if any */
+static GArray *
+drop_oldest_data (GstRTSPWatch * watch)
+{
+  GArray *ids = NULL;
+  guint i = 0;
+
+  while (IS_BACKLOG_FULL (watch)
+      && i < gst_queue_array_get_length (watch->messages)) {
+    GstRTSPSerializedMessage *msg, dropped;
+    gsize body_size;
+
+    msg = gst_queue_array_peek_nth_struct (watch->messages, i);
+
+    /* control messages are always kept and a message that was partially
+     * written has to be completed */
+    if (!msg->data_is_data_header || msg->data_offset > 0) {
+      i++;
+      continue;
+    }
+
+    if (msg->body_data)
+      body_size = msg->body_data_size;
+    else if (msg->body_buffer)
+      body_size = gst_buffer_get_size (msg->body_buffer);
+    else
+      body_size = 0;
+
+    g_assert (watch->messages_bytes >= msg->data_size + body_size);
+    watch->messages_bytes -= msg->data_size + body_size;
+
+    gst_queue_array_drop_struct (watch->messages, i, &dropped);
+    if (dropped.id) {
+      if (!ids)
+        ids = g_array_new (TRUE, FALSE, sizeof (guint));
+      g_array_append_val (ids, dropped.id);
+      watch->messages_count--;
+    }
+    gst_rtsp_serialized_message_clear (&dropped);
+  }
+
+  GST_DEBUG ("dropped %u data messages", ids ? ids->len : 0);
+
+  return ids;
+}
+
 static GstRTSPResult
 gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
     GstRTSPSerializedMessage * messages, guint n_messages, guint * id)
 {
   GstRTSPResult res;
   GMainContext *context = NULL;
+  GArray *dropped_ids = NULL;
+  gboolean backlog_full = FALSE;
+  gint64 now = 0;
   gint i;
 
   g_return_val_if_fail (watch != NULL, GST_RTSP_EINVAL);
@@ -4498,8 +4739,15 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
   }
 
   /* check limits */
-  if (IS_BACKLOG_FULL (watch))
-    goto too_much_backlog;
+  if (IS_BACKLOG_FULL (watch)) {
+    backlog_full = TRUE;
+    if (watch->backlog_policy != GST_RTSP_WATCH_BACKLOG_POLICY_DROP_OLDEST_DATA)
+      goto too_much_backlog;
+    dropped_ids = drop_oldest_data (watch);
+  }
+
+  if (watch->max_time != 0)
+    now = g_get_monotonic_time ();
 
   for (i = 0; i < n_messages; i++) {
     GstRTSPSerializedMessage local_message;
@@ -4508,14 +4756,19 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
     local_message = messages[i];
 
     /* copy the body data or take an additional reference to the body buffer
-     * we don't own them here */
+     * we don't own them here. Only the part of the body that could not be
+     * written synchronously is copied */
     if (local_message.body_data) {
+      local_message.body_data_size -= local_message.body_offset;
       local_message.body_data =
-          g_memdup (local_message.body_data, local_message.body_data_size);
+          g_memdup (local_message.body_data + local_message.body_offset,
+          local_message.body_data_size);
+      local_message.body_offset = 0;
     } else if (local_message.body_buffer) {
       gst_buffer_ref (local_message.body_buffer);
     }
     local_message.borrowed = FALSE;
+    local_message.queued_time = now;
 
     /* set an id for the very last message */
     if (i == n_messages - 1) {
@@ -4569,6 +4822,22 @@ gst_rtsp_watch_write_serialized_messages (GstRTSPWatch * watch,
 done:
   g_mutex_unlock (&watch->mutex);
 
+  if (backlog_full && watch->funcs.send_backlog_full)
+    watch->funcs.send_backlog_full (watch, watch->user_data);
+
+  /* dropped messages are notified like sent ones so that users can keep
+   * track of their messages by id */
+  if (dropped_ids) {
+    guint j;
+
+    for (j = 0; j < dropped_ids->len; j++) {
+      if (watch->funcs.message_sent)
+        watch->funcs.message_sent (watch, g_array_index (dropped_ids, guint,
+                j), watch->user_data);
+    }
+    g_array_free (dropped_ids, TRUE);
+  }
+
   if (context)
     g_main_context_wakeup (context);
 
@@ -4593,6 +4862,8 @@ too_much_backlog:
     for (i = 0; i < n_messages; i++) {
       gst_rtsp_serialized_message_clear (&messages[i]);
     }
+    if (watch->funcs.send_backlog_full)
+      watch->funcs.send_backlog_full (watch, watch->user_data);
     return GST_RTSP_ENOMEM;
   }
 
@@ -262,6 +262,8 @@ typedef struct _GstRTSPWatch GstRTSPWatch;
  * @tunnel_http_response: callback when an HTTP response to the GET request
  *   is about to be sent for a tunneled connection. The response can be
  *   modified in the callback. Since: 1.4.
+ * @send_backlog_full: callback when a message is sent while the send backlog
+ *   is full, after the #GstRTSPWatchBacklogPolicy was applied. Since: 1.18.
  *
  * Callback functions from a #GstRTSPWatch.
  */
@@ -283,11 +285,31 @@ typedef struct {
                                              GstRTSPMessage *request,
                                              GstRTSPMessage *response,
                                              gpointer user_data);
+  GstRTSPResult     (*send_backlog_full) (GstRTSPWatch *watch, gpointer user_data);
 
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING-1];
+  gpointer _gst_reserved[GST_PADDING-2];
 } GstRTSPWatchFuncs;
 
+/**
+ * GstRTSPWatchBacklogPolicy:
+ * @GST_RTSP_WATCH_BACKLOG_POLICY_FAIL: new messages are refused with
+ *   #GST_RTSP_ENOMEM
+ * @GST_RTSP_WATCH_BACKLOG_POLICY_DROP_OLDEST_DATA: queued data messages that
+ *   were not started are dropped, oldest first, until the backlog is not full
+ *   anymore, and new messages are always queued. Control messages are never
+ *   dropped. Dropped messages with an ID are reported with the message_sent
+ *   callback.
+ *
+ * What a #GstRTSPWatch does with new messages when its send backlog is full.
+ *
+ * Since: 1.18
+ */
+typedef enum {
+  GST_RTSP_WATCH_BACKLOG_POLICY_FAIL,
+  GST_RTSP_WATCH_BACKLOG_POLICY_DROP_OLDEST_DATA
+} GstRTSPWatchBacklogPolicy;
+
 GST_RTSP_API
 GstRTSPWatch *     gst_rtsp_watch_new                (GstRTSPConnection *conn,
                                                       GstRTSPWatchFuncs *funcs,
@@ -312,6 +334,20 @@ GST_RTSP_API
 void               gst_rtsp_watch_get_send_backlog  (GstRTSPWatch *watch,
                                                      gsize *bytes, guint *messages);
 
+GST_RTSP_API
+void               gst_rtsp_watch_set_send_backlog_time_usec (GstRTSPWatch *watch,
+                                                              gint64 max_time);
+
+GST_RTSP_API
+gint64             gst_rtsp_watch_get_send_backlog_time_usec (GstRTSPWatch *watch);
+
+GST_RTSP_API
+void               gst_rtsp_watch_set_send_backlog_policy (GstRTSPWatch *watch,
+                                                           GstRTSPWatchBacklogPolicy policy);
+
+GST_RTSP_API
+GstRTSPWatchBacklogPolicy gst_rtsp_watch_get_send_backlog_policy (GstRTSPWatch *watch);
+
 GST_RTSP_API
 GstRTSPResult      gst_rtsp_watch_write_data         (GstRTSPWatch *watch,
                                                       const guint8 *data,
@@ -442,7 +442,7 @@ rtsp_transport_ltrans_as_text (const GstRTSPTransport * transport)
 GstRTSPResult
 gst_rtsp_transport_parse (const gchar * str, GstRTSPTransport * transport)
 {
-  gchar **split, *down, **transp = NULL;
+  gchar *down, *field, *next, *transp[3] = { NULL, };
   guint transport_params = 0;
   gint i, count;
 
@@ -451,17 +451,19 @@ gst_rtsp_transport_parse (const gchar * str, GstRTSPTransport * transport)
 
   gst_rtsp_transport_init (transport);
 
-  /* case insensitive */
+  /* case insensitive, the fields are split in place in this copy */
   down = g_ascii_strdown (str, -1);
 
-  split = g_strsplit (down, ";", 0);
-  g_free (down);
-
   /* First field contains the transport/profile/lower_transport */
-  if (split[0] == NULL)
-    goto invalid_transport;
-
-  transp = g_strsplit (split[0], "/", 0);
+  field = down;
+  if ((next = strchr (field, ';')))
+    *next++ = '\0';
+
+  for (i = 0; i < G_N_ELEMENTS (transp) && field; i++) {
+    transp[i] = field;
+    if ((field = strchr (field, '/')))
+      *field++ = '\0';
+  }
 
   if (transp[0] == NULL || transp[1] == NULL)
     goto invalid_transport;
@@ -493,94 +495,92 @@ gst_rtsp_transport_parse (const gchar * str, GstRTSPTransport * transport)
     transport->lower_transport = get_default_lower_trans (transport);
   }
 
-  g_strfreev (transp);
-  transp = NULL;
-
   if (transport->trans == GST_RTSP_TRANS_UNKNOWN ||
       transport->profile == GST_RTSP_PROFILE_UNKNOWN ||
       transport->lower_transport == GST_RTSP_LOWER_TRANS_UNKNOWN)
     goto unsupported_transport;
 
-  i = 1;
-  while (split[i]) {
-    if (strcmp (split[i], "multicast") == 0) {
+  while (next) {
+    field = next;
+    if ((next = strchr (field, ';')))
+      *next++ = '\0';
+
+    if (strcmp (field, "multicast") == 0) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_DELIVERY);
       if (transport->lower_transport == GST_RTSP_LOWER_TRANS_TCP)
         goto invalid_transport;
       transport->lower_transport = GST_RTSP_LOWER_TRANS_UDP_MCAST;
-    } else if (strcmp (split[i], "unicast") == 0) {
+    } else if (strcmp (field, "unicast") == 0) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_DELIVERY);
       if (transport->lower_transport == GST_RTSP_LOWER_TRANS_UDP_MCAST)
         transport->lower_transport = GST_RTSP_LOWER_TRANS_UDP;
-    } else if (g_str_has_prefix (split[i], "destination=")) {
+    } else if (g_str_has_prefix (field, "destination=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_DESTINATION);
-      transport->destination = g_strdup (split[i] + 12);
-    } else if (g_str_has_prefix (split[i], "source=")) {
+      transport->destination = g_strdup (field + 12);
+    } else if (g_str_has_prefix (field, "source=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_SOURCE);
-      transport->source = g_strdup (split[i] + 7);
-    } else if (g_str_has_prefix (split[i], "layers=")) {
+      transport->source = g_strdup (field + 7);
+    } else if (g_str_has_prefix (field, "layers=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_LAYERS);
-      transport->layers = strtoul (split[i] + 7, NULL, 10);
-    } else if (g_str_has_prefix (split[i], "mode=")) {
+      transport->layers = strtoul (field + 7, NULL, 10);
+    } else if (g_str_has_prefix (field, "mode=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_MODE);
-      parse_mode (transport, split[i] + 5);
+      parse_mode (transport, field + 5);
       if (!transport->mode_play && !transport->mode_record)
         goto invalid_transport;
-    } else if (strcmp (split[i], "append") == 0) {
+    } else if (strcmp (field, "append") == 0) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_APPEND);
       transport->append = TRUE;
-    } else if (g_str_has_prefix (split[i], "interleaved=")) {
+    } else if (g_str_has_prefix (field, "interleaved=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_INTERLEAVED);
-      parse_range (split[i] + 12, &transport->interleaved);
+      parse_range (field + 12, &transport->interleaved);
       if (!IS_VALID_INTERLEAVE_RANGE (transport->interleaved))
         goto invalid_transport;
-    } else if (g_str_has_prefix (split[i], "ttl=")) {
+    } else if (g_str_has_prefix (field, "ttl=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_TTL);
-      transport->ttl = strtoul (split[i] + 4, NULL, 10);
+      transport->ttl = strtoul (field + 4, NULL, 10);
       if (transport->ttl >= 256)
         goto invalid_transport;
-    } else if (g_str_has_prefix (split[i], "port=")) {
+    } else if (g_str_has_prefix (field, "port=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_PORT);
-      if (parse_range (split[i] + 5, &transport->port)) {
+      if (parse_range (field + 5, &transport->port)) {
         if (!IS_VALID_PORT_RANGE (transport->port))
           goto invalid_transport;
       }
-    } else if (g_str_has_prefix (split[i], "client_port=")) {
+    } else if (g_str_has_prefix (field, "client_port=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_CLIENT_PORT);
-      if (parse_range (split[i] + 12, &transport->client_port)) {
+      if (parse_range (field + 12, &transport->client_port)) {
         if (!IS_VALID_PORT_RANGE (transport->client_port))
           goto invalid_transport;
       }
-    } else if (g_str_has_prefix (split[i], "server_port=")) {
+    } else if (g_str_has_prefix (field, "server_port=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_SERVER_PORT);
-      if (parse_range (split[i] + 12, &transport->server_port)) {
+      if (parse_range (field + 12, &transport->server_port)) {
         if (!IS_VALID_PORT_RANGE (transport->server_port))
           goto invalid_transport;
       }
-    } else if (g_str_has_prefix (split[i], "ssrc=")) {
+    } else if (g_str_has_prefix (field, "ssrc=")) {
       RTSP_TRANSPORT_PARAMETER_IS_UNIQUE (RTSP_TRANSPORT_SSRC);
-      transport->ssrc = strtoul (split[i] + 5, NULL, 16);
+      transport->ssrc = strtoul (field + 5, NULL, 16);
     } else {
       /* unknown field... */
-      if (strlen (split[i]) > 0) {
-        g_warning ("unknown transport field \"%s\"", split[i]);
+      if (strlen (field) > 0) {
+        g_warning ("unknown transport field \"%s\"", field);
       }
     }
-    i++;
   }
-  g_strfreev (split);
+  g_free (down);
 
   return GST_RTSP_OK;
 
 unsupported_transport:
   {
-    g_strfreev (split);
+    g_free (down);
     return GST_RTSP_ERROR;
   }
 invalid_transport:
   {
-    g_strfreev (transp);
-    g_strfreev (split);
+    g_free (down);
     return GST_RTSP_EINVAL;
   }
 }
@@ -482,6 +482,103 @@ gst_sdp_address_is_multicast (const gchar * nettype, const gchar * addrtype,
   return ret;
 }
 
+static void
+append_connection (GString * lines, const GstSDPConnection * conn)
+{
+  g_string_append (lines, "c=");
+  g_string_append (lines, conn->nettype);
+  g_string_append_c (lines, ' ');
+  g_string_append (lines, conn->addrtype);
+  g_string_append_c (lines, ' ');
+  g_string_append (lines, conn->address);
+  if (gst_sdp_address_is_multicast (conn->nettype, conn->addrtype,
+          conn->address)) {
+    /* only add TTL for IP4 multicast */
+    if (strcmp (conn->addrtype, "IP4") == 0)
+      g_string_append_printf (lines, "/%u", conn->ttl);
+    if (conn->addr_number > 1)
+      g_string_append_printf (lines, "/%u", conn->addr_number);
+  }
+  g_string_append (lines, "\r\n");
+}
+
+static void
+append_key (GString * lines, const GstSDPKey * key)
+{
+  g_string_append (lines, "k=");
+  g_string_append (lines, key->type);
+  if (key->data) {
+    g_string_append_c (lines, ':');
+    g_string_append (lines, key->data);
+  }
+  g_string_append (lines, "\r\n");
+}
+
+static void
+append_attribute (GString * lines, const GstSDPAttribute * attr)
+{
+  if (attr->key) {
+    g_string_append (lines, "a=");
+    g_string_append (lines, attr->key);
+    if (attr->value && attr->value[0] != '\0') {
+      g_string_append_c (lines, ':');
+      g_string_append (lines, attr->value);
+    }
+    g_string_append (lines, "\r\n");
+  }
+}
+
+/* appends the text of @media to @lines, shared with
+ * gst_sdp_message_as_text() so that medias don't need their own string */
+static void
+media_append_text (const GstSDPMedia * media, GString * lines)
+{
+  guint i;
+
+  if (media->media) {
+    g_string_append (lines, "m=");
+    g_string_append (lines, media->media);
+  }
+
+  g_string_append_printf (lines, " %u", media->port);
+
+  if (media->num_ports > 1)
+    g_string_append_printf (lines, "/%u", media->num_ports);
+
+  g_string_append_printf (lines, " %s", media->proto);
+
+  for (i = 0; i < gst_sdp_media_formats_len (media); i++) {
+    g_string_append_c (lines, ' ');
+    g_string_append (lines, gst_sdp_media_get_format (media, i));
+  }
+  g_string_append (lines, "\r\n");
+
+  if (media->information) {
+    g_string_append (lines, "i=");
+    g_string_append (lines, media->information);
+  }
+
+  for (i = 0; i < gst_sdp_media_connections_len (media); i++) {
+    const GstSDPConnection *conn = gst_sdp_media_get_connection (media, i);
+
+    if (conn->nettype && conn->addrtype && conn->address)
+      append_connection (lines, conn);
+  }
+
+  for (i = 0; i < gst_sdp_media_bandwidths_len (media); i++) {
+    const GstSDPBandwidth *bandwidth = gst_sdp_media_get_bandwidth (media, i);
+
+    g_string_append_printf (lines, "b=%s:%u\r\n", bandwidth->bwtype,
+        bandwidth->bandwidth);
+  }
+
+  if (media->key.type)
+    append_key (lines, &media->key);
+
+  for (i = 0; i < gst_sdp_media_attributes_len (media); i++)
+    append_attribute (lines, gst_sdp_media_get_attribute (media, i));
+}
+
 /**
  * gst_sdp_message_as_text:
  * @msg: a #GstSDPMessage
@@ -499,10 +596,13 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
 
   g_return_val_if_fail (msg != NULL, NULL);
 
-  lines = g_string_new ("");
+  lines = g_string_sized_new (1024);
 
-  if (msg->version)
-    g_string_append_printf (lines, "v=%s\r\n", msg->version);
+  if (msg->version) {
+    g_string_append (lines, "v=");
+    g_string_append (lines, msg->version);
+    g_string_append (lines, "\r\n");
+  }
 
   if (msg->origin.sess_id && msg->origin.sess_version && msg->origin.nettype &&
       msg->origin.addrtype && msg->origin.addr)
@@ -511,14 +611,23 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
         msg->origin.sess_version, msg->origin.nettype, msg->origin.addrtype,
         msg->origin.addr);
 
-  if (msg->session_name)
-    g_string_append_printf (lines, "s=%s\r\n", msg->session_name);
+  if (msg->session_name) {
+    g_string_append (lines, "s=");
+    g_string_append (lines, msg->session_name);
+    g_string_append (lines, "\r\n");
+  }
 
-  if (msg->information)
-    g_string_append_printf (lines, "i=%s\r\n", msg->information);
+  if (msg->information) {
+    g_string_append (lines, "i=");
+    g_string_append (lines, msg->information);
+    g_string_append (lines, "\r\n");
+  }
 
-  if (msg->uri)
-    g_string_append_printf (lines, "u=%s\r\n", msg->uri);
+  if (msg->uri) {
+    g_string_append (lines, "u=");
+    g_string_append (lines, msg->uri);
+    g_string_append (lines, "\r\n");
+  }
 
   for (i = 0; i < gst_sdp_message_emails_len (msg); i++)
     g_string_append_printf (lines, "e=%s\r\n",
@@ -529,19 +638,8 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
         gst_sdp_message_get_phone (msg, i));
 
   if (msg->connection.nettype && msg->connection.addrtype &&
-      msg->connection.address) {
-    g_string_append_printf (lines, "c=%s %s %s", msg->connection.nettype,
-        msg->connection.addrtype, msg->connection.address);
-    if (gst_sdp_address_is_multicast (msg->connection.nettype,
-            msg->connection.addrtype, msg->connection.address)) {
-      /* only add ttl for IP4 */
-      if (strcmp (msg->connection.addrtype, "IP4") == 0)
-        g_string_append_printf (lines, "/%u", msg->connection.ttl);
-      if (msg->connection.addr_number > 1)
-        g_string_append_printf (lines, "/%u", msg->connection.addr_number);
-    }
-    g_string_append_printf (lines, "\r\n");
-  }
+      msg->connection.address)
+    append_connection (lines, &msg->connection);
 
   for (i = 0; i < gst_sdp_message_bandwidths_len (msg); i++) {
     const GstSDPBandwidth *bandwidth = gst_sdp_message_get_bandwidth (msg, i);
@@ -582,32 +680,15 @@ gst_sdp_message_as_text (const GstSDPMessage * msg)
     g_string_append_printf (lines, "\r\n");
   }
 
-  if (msg->key.type) {
-    g_string_append_printf (lines, "k=%s", msg->key.type);
-    if (msg->key.data)
-      g_string_append_printf (lines, ":%s", msg->key.data);
-    g_string_append_printf (lines, "\r\n");
-  }
-
-  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++) {
-    const GstSDPAttribute *attr = gst_sdp_message_get_attribute (msg, i);
-
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
+  if (msg->key.type)
+    append_key (lines, &msg->key);
 
-  for (i = 0; i < gst_sdp_message_medias_len (msg); i++) {
-    const GstSDPMedia *media = gst_sdp_message_get_media (msg, i);
-    gchar *sdp_media_str;
+  for (i = 0; i < gst_sdp_message_attributes_len (msg); i++)
+    append_attribute (lines, gst_sdp_message_get_attribute (msg, i));
 
-    sdp_media_str = gst_sdp_media_as_text (media);
-    g_string_append_printf (lines, "%s", sdp_media_str);
-    g_free (sdp_media_str);
-  }
+  /* the medias are written straight into the same string */
+  for (i = 0; i < gst_sdp_message_medias_len (msg); i++)
+    media_append_text (gst_sdp_message_get_media (msg, i), lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -1971,71 +2052,11 @@ gchar *
 gst_sdp_media_as_text (const GstSDPMedia * media)
 {
   GString *lines;
-  guint i;
 
   g_return_val_if_fail (media != NULL, NULL);
 
-  lines = g_string_new ("");
-
-  if (media->media)
-    g_string_append_printf (lines, "m=%s", media->media);
-
-  g_string_append_printf (lines, " %u", media->port);
-
-  if (media->num_ports > 1)
-    g_string_append_printf (lines, "/%u", media->num_ports);
-
-  g_string_append_printf (lines, " %s", media->proto);
-
-  for (i = 0; i < gst_sdp_media_formats_len (media); i++)
-    g_string_append_printf (lines, " %s", gst_sdp_media_get_format (media, i));
-  g_string_append_printf (lines, "\r\n");
-
-  if (media->information)
-    g_string_append_printf (lines, "i=%s", media->information);
-
-  for (i = 0; i < gst_sdp_media_connections_len (media); i++) {
-    const GstSDPConnection *conn = gst_sdp_media_get_connection (media, i);
-
-    if (conn->nettype && conn->addrtype && conn->address) {
-      g_string_append_printf (lines, "c=%s %s %s", conn->nettype,
-          conn->addrtype, conn->address);
-      if (gst_sdp_address_is_multicast (conn->nettype, conn->addrtype,
-              conn->address)) {
-        /* only add TTL for IP4 multicast */
-        if (strcmp (conn->addrtype, "IP4") == 0)
-          g_string_append_printf (lines, "/%u", conn->ttl);
-        if (conn->addr_number > 1)
-          g_string_append_printf (lines, "/%u", conn->addr_number);
-      }
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
-
-  for (i = 0; i < gst_sdp_media_bandwidths_len (media); i++) {
-    const GstSDPBandwidth *bandwidth = gst_sdp_media_get_bandwidth (media, i);
-
-    g_string_append_printf (lines, "b=%s:%u\r\n", bandwidth->bwtype,
-        bandwidth->bandwidth);
-  }
-
-  if (media->key.type) {
-    g_string_append_printf (lines, "k=%s", media->key.type);
-    if (media->key.data)
-      g_string_append_printf (lines, ":%s", media->key.data);
-    g_string_append_printf (lines, "\r\n");
-  }
-
-  for (i = 0; i < gst_sdp_media_attributes_len (media); i++) {
-    const GstSDPAttribute *attr = gst_sdp_media_get_attribute (media, i);
-
-    if (attr->key) {
-      g_string_append_printf (lines, "a=%s", attr->key);
-      if (attr->value && attr->value[0] != '\0')
-        g_string_append_printf (lines, ":%s", attr->value);
-      g_string_append_printf (lines, "\r\n");
-    }
-  }
+  lines = g_string_sized_new (256);
+  media_append_text (media, lines);
 
   return g_string_free (lines, FALSE);
 }
@@ -3078,14 +3099,26 @@ gst_sdp_parse_line (SDPContext * c, gchar type, gchar * buffer)
         gst_sdp_media_set_key (c->media, str, p);
       break;
     case 'a':
-      read_string_del (str, sizeof (str), ':', &p);
-      if (*p != '\0')
+    {
+      gchar *key;
+
+      /* attributes are the most common lines, split them in place instead of
+       * copying the key */
+      while (g_ascii_isspace (*p))
         p++;
+      key = p;
+      p = strchr (key, ':');
+      if (p)
+        *p++ = '\0';
+      else
+        p = key + strlen (key);
+
       if (c->state == SDP_SESSION)
-        gst_sdp_message_add_attribute (c->msg, str, p);
+        gst_sdp_message_add_attribute (c->msg, key, p);
       else
-        gst_sdp_media_add_attribute (c->media, str, p);
+        gst_sdp_media_add_attribute (c->media, key, p);
       break;
+    }
     case 'm':
     {
       gchar *slash;
@@ -360,14 +360,28 @@ gboolean
 gst_tag_list_add_id3_image (GstTagList * tag_list, const guint8 * image_data,
     guint image_data_len, guint id3_picture_type)
 {
-  GstTagImageType tag_image_type;
-  const gchar *tag_name;
-  GstSample *image;
+  GstBuffer *image;
 
   g_return_val_if_fail (GST_IS_TAG_LIST (tag_list), FALSE);
   g_return_val_if_fail (image_data != NULL, FALSE);
   g_return_val_if_fail (image_data_len > 0, FALSE);
 
+  image = gst_buffer_new_and_alloc (image_data_len);
+  gst_buffer_fill (image, 0, image_data, image_data_len);
+
+  return __gst_tag_list_add_id3_image_buffer (tag_list, image,
+      id3_picture_type);
+}
+
+/* takes ownership of @image */
+gboolean
+__gst_tag_list_add_id3_image_buffer (GstTagList * tag_list, GstBuffer * image,
+    guint id3_picture_type)
+{
+  GstTagImageType tag_image_type;
+  const gchar *tag_name;
+  GstSample *sample;
+
   if (id3_picture_type == 0x01 || id3_picture_type == 0x02) {
     /* file icon for preview. Don't add image-type to caps, since there
      * is only supposed to be one of these, and the type is already indicated
@@ -384,13 +398,12 @@ gst_tag_list_add_id3_image (GstTagList * tag_list, const guint8 * image_data,
       tag_image_type = GST_TAG_IMAGE_TYPE_UNDEFINED;
   }
 
-  image = gst_tag_image_data_to_image_sample (image_data, image_data_len,
-      tag_image_type);
+  sample = __gst_tag_image_buffer_to_image_sample (image, tag_image_type);
 
-  if (image == NULL)
+  if (sample == NULL)
     return FALSE;
 
-  gst_tag_list_add (tag_list, GST_TAG_MERGE_APPEND, tag_name, image, NULL);
-  gst_sample_unref (image);
+  gst_tag_list_add (tag_list, GST_TAG_MERGE_APPEND, tag_name, sample, NULL);
+  gst_sample_unref (sample);
   return TRUE;
 }
@@ -68,6 +68,12 @@ const gchar * __exif_tag_capturing_metering_mode_from_exif_value (gint value);
 gint __exif_tag_capturing_source_to_exif_value (const gchar * str);
 const gchar * __exif_tag_capturing_source_from_exif_value (gint value);
 
+GstSample * __gst_tag_image_buffer_to_image_sample (GstBuffer * image,
+    GstTagImageType image_type);
+
+gboolean __gst_tag_list_add_id3_image_buffer (GstTagList * tag_list,
+    GstBuffer * image, guint id3_picture_type);
+
 #define ensure_exif_tags gst_tag_register_musicbrainz_tags
 
 G_END_DECLS
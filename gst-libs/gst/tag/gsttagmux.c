@@ -42,6 +42,13 @@
  *    GST_TAG_MUX_CLASS(mux_klass)->render_end_tag vfuncs and set up a render
  *    function.
  *
+ * The rendered tag buffer is pushed downstream as is and may consist of
+ * several memories. Render functions can put the tag headers into small
+ * memories of their own and append the memory of large payloads such as the
+ * buffers of image samples with gst_buffer_copy_into() and
+ * %GST_BUFFER_COPY_MEMORY, instead of copying them into one big memory.
+ * It can also be a (non-writable) buffer shared with others.
+ *
  */
 #ifdef HAVE_CONFIG_H
 #include <config.h>
@@ -273,6 +280,8 @@ gst_tag_mux_render_start_tag (GstTagMux * mux)
   event = gst_event_new_tag (gst_tag_list_ref (taglist));
   gst_pad_push_event (mux->priv->srcpad, event);
 
+  /* only copies the buffer metadata, the memory is shared */
+  buffer = gst_buffer_make_writable (buffer);
   GST_BUFFER_OFFSET (buffer) = 0;
   ret = gst_pad_push (mux->priv->srcpad, buffer);
 
@@ -324,6 +333,7 @@ gst_tag_mux_render_end_tag (GstTagMux * mux)
   segment.start = mux->priv->max_offset;
   gst_pad_push_event (mux->priv->srcpad, gst_event_new_segment (&segment));
 
+  buffer = gst_buffer_make_writable (buffer);
   GST_BUFFER_OFFSET (buffer) = mux->priv->max_offset;
   ret = gst_pad_push (mux->priv->srcpad, buffer);
 
@@ -402,9 +412,10 @@ gst_tag_mux_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
     mux->priv->render_start_tag = FALSE;
   }
 
-  buffer = gst_buffer_make_writable (buffer);
-
-  if (GST_BUFFER_OFFSET (buffer) != GST_BUFFER_OFFSET_NONE) {
+  /* only make the buffer writable when its offset changes */
+  if (GST_BUFFER_OFFSET (buffer) != GST_BUFFER_OFFSET_NONE &&
+      mux->priv->start_tag_size != 0) {
+    buffer = gst_buffer_make_writable (buffer);
     GST_LOG_OBJECT (mux, "Adjusting buffer offset from %" G_GINT64_FORMAT
         " to %" G_GINT64_FORMAT, GST_BUFFER_OFFSET (buffer),
         GST_BUFFER_OFFSET (buffer) + mux->priv->start_tag_size);
@@ -1694,6 +1694,29 @@ write_one_tag (const GstTagList * list, XmpTag * xmp_tag, gpointer user_data)
   string_close_tag (data, xmp_tag->tag_name);
 }
 
+/* the last serialized packet, pipelines usually write the same XMP for every
+ * frame or image */
+static GMutex xmp_cache_lock;
+static GstTagList *xmp_cache_list;
+static gboolean xmp_cache_read_only;
+static gchar **xmp_cache_schemas;
+static GstBuffer *xmp_cache_buffer;
+
+static gboolean
+xmp_schemas_equal (gchar ** a, const gchar ** b)
+{
+  gint i;
+
+  if (a == NULL || b == NULL)
+    return a == NULL && b == NULL;
+
+  for (i = 0; a[i] && b[i]; i++) {
+    if (strcmp (a[i], b[i]) != 0)
+      return FALSE;
+  }
+  return a[i] == NULL && b[i] == NULL;
+}
+
 /**
  * gst_tag_list_to_xmp_buffer:
  * @list: tags
@@ -1713,19 +1736,34 @@ gst_tag_list_to_xmp_buffer (const GstTagList * list, gboolean read_only,
 {
   GstBuffer *buffer = NULL;
   XmpSerializationData serialization_data;
+  const gchar **used_schemas = schemas;
   GString *data;
   guint i;
   gsize bsize;
   gpointer bdata;
 
-  serialization_data.data = g_string_sized_new (4096);
+  g_return_val_if_fail (GST_IS_TAG_LIST (list), NULL);
+
+  g_mutex_lock (&xmp_cache_lock);
+  if (xmp_cache_buffer && xmp_cache_read_only == read_only &&
+      xmp_schemas_equal (xmp_cache_schemas, schemas) &&
+      gst_tag_list_is_equal (xmp_cache_list, list)) {
+    /* shares the memory, which is copied if the caller writes to it */
+    buffer = gst_buffer_copy (xmp_cache_buffer);
+    g_mutex_unlock (&xmp_cache_lock);
+    GST_LOG ("reusing previous xmp packet");
+    return buffer;
+  }
+  g_mutex_unlock (&xmp_cache_lock);
+
+  /* room for the header, footer and padding of a packet with a few tags so
+   * it is allocated only once in the common case */
+  serialization_data.data = g_string_sized_new (read_only ? 4096 : 8192);
   serialization_data.schemas = schemas;
   data = serialization_data.data;
 
   xmp_tags_initialize ();
 
-  g_return_val_if_fail (GST_IS_TAG_LIST (list), NULL);
-
   /* xmp header */
   g_string_append (data,
       "<?xpacket begin=\"\xEF\xBB\xBF\" id=\"W5M0MpCehiHzreSzNTczkc9d\"?>\n");
@@ -1737,10 +1775,14 @@ gst_tag_list_to_xmp_buffer (const GstTagList * list, gboolean read_only,
   while (ns_match[i].ns_prefix) {
     if (xmp_serialization_data_use_schema (&serialization_data,
             ns_match[i].ns_prefix)) {
-      g_string_append_printf (data, " xmlns:%s=\"%s\"",
-          ns_match[i].ns_prefix, ns_match[i].ns_uri);
+      g_string_append (data, " xmlns:");
+      g_string_append (data, ns_match[i].ns_prefix);
+      g_string_append (data, "=\"");
+      g_string_append (data, ns_match[i].ns_uri);
+      g_string_append_c (data, '"');
       if (ns_match[i].extra_ns) {
-        g_string_append_printf (data, " %s", ns_match[i].extra_ns);
+        g_string_append_c (data, ' ');
+        g_string_append (data, ns_match[i].extra_ns);
       }
     }
     i++;
@@ -1782,14 +1824,28 @@ gst_tag_list_to_xmp_buffer (const GstTagList * list, gboolean read_only,
           "                " "                " "\n");
     }
   }
-  g_string_append_printf (data, "<?xpacket end=\"%c\"?>",
-      (read_only ? 'r' : 'w'));
+  g_string_append (data, read_only ? "<?xpacket end=\"r\"?>" :
+      "<?xpacket end=\"w\"?>");
 
   bsize = data->len;
   bdata = g_string_free (data, FALSE);
 
   buffer = gst_buffer_new_wrapped (bdata, bsize);
 
+  g_mutex_lock (&xmp_cache_lock);
+  if (xmp_cache_list)
+    gst_tag_list_unref (xmp_cache_list);
+  if (xmp_cache_buffer)
+    gst_buffer_unref (xmp_cache_buffer);
+  g_strfreev (xmp_cache_schemas);
+  /* a copy, a reference would make the caller's list read-only */
+  xmp_cache_list = gst_tag_list_copy (list);
+  xmp_cache_read_only = read_only;
+  xmp_cache_schemas = g_strdupv ((gchar **) used_schemas);
+  xmp_cache_buffer = buffer;
+  buffer = gst_buffer_copy (xmp_cache_buffer);
+  g_mutex_unlock (&xmp_cache_lock);
+
   return buffer;
 }
 
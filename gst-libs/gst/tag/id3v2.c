@@ -188,6 +188,29 @@ id3v2_ununsync_data (const guint8 * unsync_data, guint32 * size)
  */
 GstTagList *
 gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
+{
+  return gst_tag_list_from_id3v2_tag_filtered (buffer, NULL);
+}
+
+/**
+ * gst_tag_list_from_id3v2_tag_filtered:
+ * @buffer: buffer to convert
+ * @tags: (array zero-terminated=1) (nullable): the tags to extract, or %NULL
+ *     for all of them
+ *
+ * Like gst_tag_list_from_id3v2_tag(), but only extracts @tags. Frames that
+ * can't contain any of them are skipped without being decoded, which for
+ * example avoids copying attached pictures when only textual tags are
+ * needed.
+ *
+ * Returns: A new #GstTagList with those of @tags that could be extracted
+ *          from the given ID3 tag or NULL on error or if none were found.
+ *
+ * Since: 1.18
+ */
+GstTagList *
+gst_tag_list_from_id3v2_tag_filtered (GstBuffer * buffer,
+    const gchar * const *tags)
 {
   GstMapInfo info;
   guint8 *uu_data = NULL;
@@ -233,6 +256,9 @@ gst_tag_list_from_id3v2_tag (GstBuffer * buffer)
 
   memset (&work, 0, sizeof (ID3TagsWorking));
   work.buffer = buffer;
+  work.buffer_data = info.data;
+  work.buffer_size = info.size;
+  work.filter = tags;
   work.hdr.version = version;
   work.hdr.size = read_size;
   work.hdr.flags = flags;
@@ -285,6 +311,65 @@ not_enough_data:
   }
 }
 
+static gboolean
+id3v2_filter_has_tag (ID3TagsWorking * work, const gchar * tag)
+{
+  const gchar *const *t;
+
+  for (t = work->filter; *t; t++) {
+    if (strcmp (*t, tag) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/* frames that are not mapped to a single tag by gst_tag_from_id3_tag () */
+static const struct
+{
+  const gchar frame_id[5];
+  const gchar *tags[5];
+} frame_tags[] = {
+  {"APIC", {GST_TAG_IMAGE, GST_TAG_PREVIEW_IMAGE}},
+  {"COMM", {GST_TAG_COMMENT, GST_TAG_EXTENDED_COMMENT}},
+  {"PRIV", {GST_TAG_PRIVATE_DATA}},
+  {"RVA2", {GST_TAG_TRACK_GAIN, GST_TAG_TRACK_PEAK, GST_TAG_ALBUM_GAIN,
+          GST_TAG_ALBUM_PEAK}},
+  {"TDAT", {GST_TAG_DATE_TIME}}
+};
+
+/* whether a frame can produce any of the tags in the filter, decided from its
+ * id only so that unneeded frames are skipped by their size */
+static gboolean
+id3v2_frame_is_wanted (ID3TagsWorking * work, const gchar * frame_id)
+{
+  const gchar *tag;
+  gint i, j;
+
+  if (work->filter == NULL)
+    return TRUE;
+
+  /* the tag these map to depends on their content */
+  if (strcmp (frame_id, "TXXX") == 0 || strcmp (frame_id, "UFID") == 0)
+    return TRUE;
+
+  for (i = 0; i < G_N_ELEMENTS (frame_tags); i++) {
+    if (strcmp (frame_id, frame_tags[i].frame_id) != 0)
+      continue;
+    for (j = 0; j < G_N_ELEMENTS (frame_tags[i].tags) && frame_tags[i].tags[j];
+        j++) {
+      if (id3v2_filter_has_tag (work, frame_tags[i].tags[j]))
+        return TRUE;
+    }
+    return FALSE;
+  }
+
+  tag = gst_tag_from_id3_tag (frame_id);
+  if (tag == NULL)
+    tag = GST_TAG_ID3V2_FRAME;
+
+  return id3v2_filter_has_tag (work, tag);
+}
+
 static guint
 id3v2_frame_hdr_size (guint id3v2ver)
 {
@@ -588,7 +673,9 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
 #undef flag_str
 #endif
 
-    if (!obsolete_id) {
+    if (!obsolete_id && !id3v2_frame_is_wanted (work, frame_id)) {
+      GST_LOG ("Skipping unwanted frame with id %s", frame_id);
+    } else if (!obsolete_id) {
       /* Now, read, decompress etc the contents of the frame
        * into a TagList entry */
       work->cur_frame_size = frame_size;
@@ -600,8 +687,11 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
       } else {
         GST_LOG ("Failed to extract frame with id %s", frame_id);
         /* Rewind the frame data / size to pass the header too */
-        id3v2_add_id3v2_frame_blob_to_taglist (work,
-            work->hdr.frame_data - frame_hdr_size, frame_hdr_size + frame_size);
+        if (work->filter == NULL
+            || id3v2_filter_has_tag (work, GST_TAG_ID3V2_FRAME))
+          id3v2_add_id3v2_frame_blob_to_taglist (work,
+              work->hdr.frame_data - frame_hdr_size,
+              frame_hdr_size + frame_size);
       }
       work->frame_id = NULL;    /* clear ref to loop-local storage */
     }
@@ -610,6 +700,18 @@ id3v2_frames_to_tag_list (ID3TagsWorking * work, guint size)
     work->hdr.frame_data_size -= frame_size;
   }
 
+  /* user defined frames can still have produced other tags */
+  if (work->filter) {
+    gint i;
+
+    for (i = gst_tag_list_n_tags (work->tags) - 1; i >= 0; i--) {
+      const gchar *tag = gst_tag_list_nth_tag_name (work->tags, i);
+
+      if (!id3v2_filter_has_tag (work, tag))
+        gst_tag_list_remove_tag (work->tags, tag);
+    }
+  }
+
   if (gst_tag_list_n_tags (work->tags) == 0) {
     GST_DEBUG ("Could not extract any frames from tag. Broken or empty tag");
     gst_tag_list_unref (work->tags);
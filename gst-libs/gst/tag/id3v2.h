@@ -52,8 +52,14 @@ typedef struct {
   ID3v2Header hdr;
   
   GstBuffer *buffer;
+  /* mapped data of buffer, to find frames that can share its memory */
+  const guint8 *buffer_data;
+  gsize buffer_size;
   GstTagList *tags;
 
+  /* NULL-terminated tags to extract, or NULL for all */
+  const gchar * const *filter;
+
   /* Current frame decoding */
   guint cur_frame_size;
   gchar *frame_id;
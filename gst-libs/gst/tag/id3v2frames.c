@@ -34,6 +34,7 @@
 #endif
 
 #include "id3v2.h"
+#include "gsttageditingprivate.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT id3v2_ensure_debug_category()
@@ -634,8 +635,19 @@ parse_picture_frame (ID3TagsWorking * work)
   if (work->parse_size <= 0)
     goto not_enough_data;
 
-  if (!gst_tag_list_add_id3_image (work->tags, (guint8 *) work->parse_data,
-          work->parse_size, pic_type)) {
+  if (work->parse_data >= work->buffer_data &&
+      work->parse_data + work->parse_size <=
+      work->buffer_data + work->buffer_size) {
+    GstBuffer *image;
+
+    /* not unsynced or compressed, share the memory of the tag instead of
+     * copying what can be several MB of cover art */
+    image = gst_buffer_copy_region (work->buffer, GST_BUFFER_COPY_MEMORY,
+        work->parse_data - work->buffer_data, work->parse_size);
+    if (!__gst_tag_list_add_id3_image_buffer (work->tags, image, pic_type))
+      goto error;
+  } else if (!gst_tag_list_add_id3_image (work->tags,
+          (guint8 *) work->parse_data, work->parse_size, pic_type)) {
     goto error;
   }
 
@@ -27,6 +27,7 @@
 #include <gst/gst.h>
 #include "tag.h"
 #include "id3v2.h"
+#include "gsttageditingprivate.h"
 
 #include <string.h>
 
@@ -522,12 +523,7 @@ GstSample *
 gst_tag_image_data_to_image_sample (const guint8 * image_data,
     guint image_data_len, GstTagImageType image_type)
 {
-  const gchar *name;
   GstBuffer *image;
-  GstSample *sample;
-  GstCaps *caps;
-  GstMapInfo info;
-  GstStructure *image_info = NULL;
 
   g_return_val_if_fail (image_data != NULL, NULL);
   g_return_val_if_fail (image_data_len > 0, NULL);
@@ -535,15 +531,33 @@ gst_tag_image_data_to_image_sample (const guint8 * image_data,
 
   GST_DEBUG ("image data len: %u bytes", image_data_len);
 
-  /* allocate space for a NUL terminator for an uri too */
-  image = gst_buffer_new_and_alloc (image_data_len + 1);
+  image = gst_buffer_new_and_alloc (image_data_len);
   if (image == NULL)
     goto alloc_failed;
 
-  gst_buffer_map (image, &info, GST_MAP_WRITE);
-  memcpy (info.data, image_data, image_data_len);
-  info.data[image_data_len] = '\0';
-  gst_buffer_unmap (image, &info);
+  gst_buffer_fill (image, 0, image_data, image_data_len);
+
+  return __gst_tag_image_buffer_to_image_sample (image, image_type);
+
+  /* ERRORS */
+alloc_failed:
+  {
+    GST_WARNING ("failed to allocate buffer of %d for image", image_data_len);
+    return NULL;
+  }
+}
+
+/* Like gst_tag_image_data_to_image_sample(), but takes ownership of a buffer
+ * with the image data, which can share the memory of the tag it was found in
+ * instead of being a copy */
+GstSample *
+__gst_tag_image_buffer_to_image_sample (GstBuffer * image,
+    GstTagImageType image_type)
+{
+  const gchar *name;
+  GstSample *sample;
+  GstCaps *caps;
+  GstStructure *image_info = NULL;
 
   /* Find GStreamer media type, can't trust declared type */
   caps = gst_type_find_helper_for_buffer (NULL, image, NULL);
@@ -563,11 +577,14 @@ gst_tag_image_data_to_image_sample (const guint8 * image_data,
     goto error;
   }
 
-  /* Decrease size by 1 if we don't have an URI list
-   * to keep the original size of the image
-   */
-  if (!g_str_equal (name, "text/uri-list"))
-    gst_buffer_set_size (image, image_data_len);
+  /* add a NUL terminator for an uri, keep the original size of an image */
+  if (g_str_equal (name, "text/uri-list")) {
+    gsize size = gst_buffer_get_size (image);
+
+    image = gst_buffer_make_writable (image);
+    gst_buffer_append_memory (image, gst_allocator_alloc (NULL, 1, NULL));
+    gst_buffer_memset (image, size, 0, 1);
+  }
 
   if (image_type != GST_TAG_IMAGE_TYPE_NONE) {
     GST_LOG ("Setting image type: %d", image_type);
@@ -588,17 +605,9 @@ no_type:
   }
 error:
   {
-    if (image)
-      gst_buffer_unref (image);
+    gst_buffer_unref (image);
     if (caps)
       gst_caps_unref (caps);
     return NULL;
   }
-alloc_failed:
-  {
-    GST_WARNING ("failed to allocate buffer of %d for image", image_data_len);
-    gst_buffer_unref (image);
-    return NULL;
-  }
-
 }
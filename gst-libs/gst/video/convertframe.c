@@ -281,6 +281,213 @@ link_failed:
   }
 }
 
+/* Raw to raw conversions are done directly with a GstVideoConverter. The
+ * converters are kept around for the next conversion between the same
+ * formats, which is the common case when generating thumbnails. */
+#define CONVERTER_CACHE_SIZE 4
+
+typedef struct
+{
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstVideoConverter *convert;
+} ConverterCacheEntry;
+
+static GMutex converter_cache_lock;
+static GQueue converter_cache = G_QUEUE_INIT;
+
+static void
+converter_cache_entry_free (ConverterCacheEntry * entry)
+{
+  gst_video_converter_free (entry->convert);
+  g_slice_free (ConverterCacheEntry, entry);
+}
+
+/* takes a converter out of the cache, so that it is not used from multiple
+ * threads at the same time */
+static ConverterCacheEntry *
+converter_cache_take (const GstVideoInfo * in_info,
+    const GstVideoInfo * out_info)
+{
+  ConverterCacheEntry *entry = NULL;
+  GList *l;
+
+  g_mutex_lock (&converter_cache_lock);
+  for (l = converter_cache.head; l; l = l->next) {
+    ConverterCacheEntry *e = l->data;
+
+    if (gst_video_info_is_equal (&e->in_info, in_info) &&
+        gst_video_info_is_equal (&e->out_info, out_info)) {
+      g_queue_delete_link (&converter_cache, l);
+      entry = e;
+      break;
+    }
+  }
+  g_mutex_unlock (&converter_cache_lock);
+
+  if (entry == NULL) {
+    GstVideoConverter *convert;
+
+    convert = gst_video_converter_new ((GstVideoInfo *) in_info,
+        (GstVideoInfo *) out_info, NULL);
+    if (convert == NULL)
+      return NULL;
+
+    entry = g_slice_new (ConverterCacheEntry);
+    entry->in_info = *in_info;
+    entry->out_info = *out_info;
+    entry->convert = convert;
+  }
+
+  return entry;
+}
+
+static void
+converter_cache_put (ConverterCacheEntry * entry)
+{
+  ConverterCacheEntry *old = NULL;
+
+  g_mutex_lock (&converter_cache_lock);
+  g_queue_push_head (&converter_cache, entry);
+  if (g_queue_get_length (&converter_cache) > CONVERTER_CACHE_SIZE)
+    old = g_queue_pop_tail (&converter_cache);
+  g_mutex_unlock (&converter_cache_lock);
+
+  if (old)
+    converter_cache_entry_free (old);
+}
+
+/* Returns fixed raw caps if @to_caps can be satisfied without any of the
+ * caps negotiation done by the conversion pipeline, %NULL otherwise */
+static GstCaps *
+fixate_raw_caps (const GstVideoInfo * in_info, const GstCaps * to_caps)
+{
+  GstCapsFeatures *features;
+  GstStructure *s;
+  GstCaps *caps;
+  gboolean has_size, has_par;
+  gint width, height;
+
+  if (gst_caps_get_size (to_caps) != 1)
+    return NULL;
+
+  s = gst_caps_get_structure (to_caps, 0);
+  features = gst_caps_get_features (to_caps, 0);
+  if (!gst_structure_has_name (s, "video/x-raw") ||
+      (features && !gst_caps_features_is_equal (features,
+              GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY)))
+    return NULL;
+
+  has_size = gst_structure_has_field (s, "width");
+  if (has_size != gst_structure_has_field (s, "height"))
+    return NULL;
+  has_par = gst_structure_has_field (s, "pixel-aspect-ratio");
+
+  caps = gst_caps_copy (to_caps);
+  s = gst_caps_get_structure (caps, 0);
+
+  if (!has_size) {
+    gst_structure_set (s, "width", G_TYPE_INT, GST_VIDEO_INFO_WIDTH (in_info),
+        "height", G_TYPE_INT, GST_VIDEO_INFO_HEIGHT (in_info), NULL);
+  } else if (!has_par) {
+    /* videoscale would pick a pixel-aspect-ratio to keep the display aspect
+     * ratio, leave that to the pipeline */
+    if (!gst_structure_get_int (s, "width", &width) ||
+        !gst_structure_get_int (s, "height", &height) ||
+        width != GST_VIDEO_INFO_WIDTH (in_info) ||
+        height != GST_VIDEO_INFO_HEIGHT (in_info))
+      goto not_fixed;
+  }
+  if (!has_par)
+    gst_structure_set (s, "pixel-aspect-ratio", GST_TYPE_FRACTION,
+        GST_VIDEO_INFO_PAR_N (in_info), GST_VIDEO_INFO_PAR_D (in_info), NULL);
+
+  if (!gst_structure_has_field (s, "format"))
+    gst_structure_set (s, "format", G_TYPE_STRING,
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (in_info)), NULL);
+
+  if (!gst_caps_is_fixed (caps))
+    goto not_fixed;
+
+  return caps;
+
+not_fixed:
+  gst_caps_unref (caps);
+  return NULL;
+}
+
+/* converts raw video directly, returns %NULL if the pipeline needs to be
+ * used instead */
+static GstSample *
+convert_sample_raw (GstBuffer * buf, const GstCaps * from_caps,
+    const GstCaps * to_caps)
+{
+  GstVideoInfo in_info, out_info;
+  GstVideoFrame in_frame, out_frame;
+  ConverterCacheEntry *entry;
+  GstBuffer *out_buf;
+  GstSample *result;
+  GstCaps *caps;
+
+  if (gst_buffer_get_video_crop_meta (buf))
+    return NULL;
+
+  if (!gst_video_info_from_caps (&in_info, from_caps) ||
+      GST_VIDEO_INFO_FORMAT (&in_info) == GST_VIDEO_FORMAT_ENCODED ||
+      GST_VIDEO_INFO_IS_INTERLACED (&in_info))
+    return NULL;
+
+  caps = fixate_raw_caps (&in_info, to_caps);
+  if (caps == NULL)
+    return NULL;
+
+  if (!gst_video_info_from_caps (&out_info, caps) ||
+      GST_VIDEO_INFO_FORMAT (&out_info) == GST_VIDEO_FORMAT_ENCODED)
+    goto fallback;
+
+  /* the pipeline adds borders when the display aspect ratio changes */
+  if ((guint64) GST_VIDEO_INFO_WIDTH (&in_info) * GST_VIDEO_INFO_PAR_N (&in_info)
+      * GST_VIDEO_INFO_HEIGHT (&out_info) * GST_VIDEO_INFO_PAR_D (&out_info) !=
+      (guint64) GST_VIDEO_INFO_WIDTH (&out_info) *
+      GST_VIDEO_INFO_PAR_N (&out_info) * GST_VIDEO_INFO_HEIGHT (&in_info) *
+      GST_VIDEO_INFO_PAR_D (&in_info))
+    goto fallback;
+
+  if (!gst_video_frame_map (&in_frame, &in_info, buf, GST_MAP_READ))
+    goto fallback;
+
+  entry = converter_cache_take (&in_info, &out_info);
+  if (entry == NULL) {
+    gst_video_frame_unmap (&in_frame);
+    goto fallback;
+  }
+
+  out_buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&out_info),
+      NULL);
+  gst_video_frame_map (&out_frame, &out_info, out_buf, GST_MAP_WRITE);
+  gst_video_converter_frame (entry->convert, &in_frame, &out_frame);
+  gst_video_frame_unmap (&out_frame);
+  gst_video_frame_unmap (&in_frame);
+
+  converter_cache_put (entry);
+
+  gst_buffer_copy_into (out_buf, buf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  GST_DEBUG ("converted raw buffer %p directly to caps %" GST_PTR_FORMAT,
+      buf, caps);
+
+  result = gst_sample_new (out_buf, caps, NULL, NULL);
+  gst_buffer_unref (out_buf);
+  gst_caps_unref (caps);
+
+  return result;
+
+fallback:
+  gst_caps_unref (caps);
+  return NULL;
+}
+
 /**
  * gst_video_convert_sample:
  * @sample: a #GstSample
@@ -294,6 +501,9 @@ link_failed:
  *
  * The width, height and pixel-aspect-ratio can also be specified in the output caps.
  *
+ * Conversions between raw video formats are done directly without setting
+ * up a pipeline whenever the output caps do not need to be negotiated.
+ *
  * Returns: The converted #GstSample, or %NULL if an error happened (in which case @err
  * will point to the #GError).
  */
@@ -330,6 +540,11 @@ gst_video_convert_sample (GstSample * sample, const GstCaps * to_caps,
     gst_caps_append_structure (to_caps_copy, s);
   }
 
+  if ((result = convert_sample_raw (buf, from_caps, to_caps_copy))) {
+    gst_caps_unref (to_caps_copy);
+    return result;
+  }
+
   pipeline =
       build_convert_frame_pipeline (&src, &sink, from_caps,
       gst_buffer_get_video_crop_meta (buf), to_caps_copy, &err);
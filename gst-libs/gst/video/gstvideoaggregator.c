@@ -42,6 +42,8 @@
 #include <string.h>
 
 #include "gstvideoaggregator.h"
+#include "gstvideoutilsprivate.h"
+#include <gst/gstprocessingstats-private.h>
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_aggregator_debug);
 #define GST_CAT_DEFAULT gst_video_aggregator_debug
@@ -60,6 +62,7 @@ enum
   PROP_PAD_0,
   PROP_PAD_ZORDER,
   PROP_PAD_REPEAT_AFTER_EOS,
+  PROP_PAD_STATS,
 };
 
 
@@ -80,6 +83,11 @@ struct _GstVideoAggregatorPadPrivate
   GstClockTime end_time;
 
   GstVideoInfo pending_vinfo;
+
+  /* lateness statistics, protected by the pad's object lock */
+  guint64 late_outputs;
+  guint64 dropped_late;
+  GstClockTime max_lateness;
 };
 
 
@@ -99,6 +107,15 @@ gst_video_aggregator_pad_get_property (GObject * object, guint prop_id,
     case PROP_PAD_REPEAT_AFTER_EOS:
       g_value_set_boolean (value, pad->priv->repeat_after_eos);
       break;
+    case PROP_PAD_STATS:
+      GST_OBJECT_LOCK (pad);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-video-aggregator-pad-stats",
+              "late-outputs", G_TYPE_UINT64, pad->priv->late_outputs,
+              "dropped-late", G_TYPE_UINT64, pad->priv->dropped_late,
+              "max-lateness", G_TYPE_UINT64, pad->priv->max_lateness, NULL));
+      GST_OBJECT_UNLOCK (pad);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -171,6 +188,16 @@ gst_video_aggregator_pad_skip_buffer (GstAggregatorPad * aggpad,
         agg_segment->position);
 
     ret = end_time < output_start_running_time;
+
+    if (ret) {
+      GstVideoAggregatorPad *pad = GST_VIDEO_AGGREGATOR_PAD (aggpad);
+      GstClockTime lateness = output_start_running_time - end_time;
+
+      GST_OBJECT_LOCK (pad);
+      pad->priv->dropped_late++;
+      pad->priv->max_lateness = MAX (pad->priv->max_lateness, lateness);
+      GST_OBJECT_UNLOCK (pad);
+    }
   }
 
   return ret;
@@ -218,6 +245,26 @@ gst_video_aggregator_pad_class_init (GstVideoAggregatorPadClass * klass)
           DEFAULT_PAD_REPEAT_AFTER_EOS,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoAggregatorPad:stats:
+   *
+   * Lateness statistics of the pad, for live inputs in particular:
+   *
+   * - "late-outputs" (guint64): number of frames that were output at the
+   *   deadline while this pad had no data queued, the previous frame of the
+   *   pad was used instead
+   * - "dropped-late" (guint64): number of buffers that were dropped because
+   *   they arrived after their output time
+   * - "max-lateness" (guint64): the largest amount of time, in nanoseconds, by
+   *   which a dropped buffer was late
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Lateness statistics of the pad", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   aggpadclass->flush = GST_DEBUG_FUNCPTR (_flush_pad);
   aggpadclass->skip_buffer =
       GST_DEBUG_FUNCPTR (gst_video_aggregator_pad_skip_buffer);
@@ -345,6 +392,10 @@ struct _GstVideoAggregatorConvertPadPrivate
   /* caps used for conversion if needed */
   GstVideoInfo conversion_info;
   GstBuffer *converted_buffer;
+  /* input buffer that converted_buffer was converted from, the conversion is
+   * reused as long as the pad repeats the same input */
+  GstBuffer *converted_input;
+  GstBufferPool *converted_pool;
 
   GstStructure *converter_config;
   gboolean converter_config_changed;
@@ -353,6 +404,66 @@ struct _GstVideoAggregatorConvertPadPrivate
 G_DEFINE_TYPE_WITH_PRIVATE (GstVideoAggregatorConvertPad,
     gst_video_aggregator_convert_pad, GST_TYPE_VIDEO_AGGREGATOR_PAD);
 
+/* Drops the cached conversion and the pool it was allocated from */
+static void
+gst_video_aggregator_convert_pad_drop_converted (GstVideoAggregatorConvertPad *
+    pad)
+{
+  gst_buffer_replace (&pad->priv->converted_buffer, NULL);
+  gst_buffer_replace (&pad->priv->converted_input, NULL);
+
+  if (pad->priv->converted_pool) {
+    gst_buffer_pool_set_active (pad->priv->converted_pool, FALSE);
+    gst_object_unref (pad->priv->converted_pool);
+    pad->priv->converted_pool = NULL;
+  }
+}
+
+/* Returns a buffer of at least @size bytes for the converted frame */
+static GstBuffer *
+gst_video_aggregator_convert_pad_acquire_buffer (GstVideoAggregatorConvertPad *
+    pad, guint size)
+{
+  static GstAllocationParams params = { 0, 15, 0, 0, };
+  GstBuffer *buffer = NULL;
+
+  if (pad->priv->converted_pool) {
+    GstStructure *config =
+        gst_buffer_pool_get_config (pad->priv->converted_pool);
+    guint pool_size;
+
+    gst_buffer_pool_config_get_params (config, NULL, &pool_size, NULL, NULL);
+    gst_structure_free (config);
+
+    if (pool_size != size) {
+      gst_buffer_pool_set_active (pad->priv->converted_pool, FALSE);
+      gst_object_unref (pad->priv->converted_pool);
+      pad->priv->converted_pool = NULL;
+    }
+  }
+
+  if (!pad->priv->converted_pool) {
+    GstBufferPool *pool = gst_buffer_pool_new ();
+    GstStructure *config = gst_buffer_pool_get_config (pool);
+
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, NULL, &params);
+    if (!gst_buffer_pool_set_config (pool, config)
+        || !gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_WARNING_OBJECT (pad, "Could not set up pool for converted frames");
+      gst_object_unref (pool);
+      return gst_buffer_new_allocate (NULL, size, &params);
+    }
+    pad->priv->converted_pool = pool;
+  }
+
+  if (gst_buffer_pool_acquire_buffer (pad->priv->converted_pool, &buffer,
+          NULL) != GST_FLOW_OK)
+    return gst_buffer_new_allocate (NULL, size, &params);
+
+  return buffer;
+}
+
 static void
 gst_video_aggregator_convert_pad_finalize (GObject * o)
 {
@@ -366,6 +477,8 @@ gst_video_aggregator_convert_pad_finalize (GObject * o)
     gst_structure_free (vaggpad->priv->converter_config);
   vaggpad->priv->converter_config = NULL;
 
+  gst_video_aggregator_convert_pad_drop_converted (vaggpad);
+
   G_OBJECT_CLASS (gst_video_aggregator_pad_parent_class)->finalize (o);
 }
 
@@ -400,6 +513,9 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
 
     pad->priv->conversion_info = conversion_info;
 
+    /* the cached conversion is for the old parameters */
+    gst_video_aggregator_convert_pad_drop_converted (pad);
+
     if (pad->priv->convert)
       gst_video_converter_free (pad->priv->convert);
     pad->priv->convert = NULL;
@@ -422,6 +538,19 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
     }
   }
 
+  /* The pad repeats the input that was converted last time, the converted
+   * frame can be reused */
+  if (pad->priv->convert && pad->priv->converted_buffer
+      && pad->priv->converted_input == buffer) {
+    if (!gst_video_frame_map (prepared_frame, &pad->priv->conversion_info,
+            pad->priv->converted_buffer, GST_MAP_READ)) {
+      GST_WARNING_OBJECT (vagg, "Could not map converted frame");
+      return FALSE;
+    }
+    GST_LOG_OBJECT (pad, "Reusing converted frame");
+    return TRUE;
+  }
+
   if (!gst_video_frame_map (&frame, &vpad->info, buffer, GST_MAP_READ)) {
     GST_WARNING_OBJECT (vagg, "Could not map input buffer");
     return FALSE;
@@ -430,7 +559,6 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
   if (pad->priv->convert) {
     GstVideoFrame converted_frame;
     GstBuffer *converted_buf = NULL;
-    static GstAllocationParams params = { 0, 15, 0, 0, };
     gint converted_size;
     guint outsize;
 
@@ -438,18 +566,26 @@ gst_video_aggregator_convert_pad_prepare_frame (GstVideoAggregatorPad * vpad,
     converted_size = pad->priv->conversion_info.size;
     outsize = GST_VIDEO_INFO_SIZE (&vagg->info);
     converted_size = converted_size > outsize ? converted_size : outsize;
-    converted_buf = gst_buffer_new_allocate (NULL, converted_size, &params);
+
+    /* release the old conversion before acquiring the buffer for the new
+     * one, so that the pool can recycle it */
+    gst_buffer_replace (&pad->priv->converted_buffer, NULL);
+    gst_buffer_replace (&pad->priv->converted_input, NULL);
+    converted_buf =
+        gst_video_aggregator_convert_pad_acquire_buffer (pad, converted_size);
 
     if (!gst_video_frame_map (&converted_frame, &(pad->priv->conversion_info),
             converted_buf, GST_MAP_READWRITE)) {
       GST_WARNING_OBJECT (vagg, "Could not map converted frame");
 
+      gst_buffer_unref (converted_buf);
       gst_video_frame_unmap (&frame);
       return FALSE;
     }
 
     gst_video_converter_frame (pad->priv->convert, &frame, &converted_frame);
     pad->priv->converted_buffer = converted_buf;
+    pad->priv->converted_input = gst_buffer_ref (buffer);
     gst_video_frame_unmap (&frame);
     *prepared_frame = converted_frame;
   } else {
@@ -470,9 +606,11 @@ gst_video_aggregator_convert_pad_clean_frame (GstVideoAggregatorPad * vpad,
     memset (prepared_frame, 0, sizeof (GstVideoFrame));
   }
 
-  if (pad->priv->converted_buffer) {
-    gst_buffer_unref (pad->priv->converted_buffer);
-    pad->priv->converted_buffer = NULL;
+  /* the converted buffer is kept until the input changes, but we don't need
+   * to keep it if the pad has no input anymore */
+  if (pad->priv->converted_input && vpad->priv->buffer == NULL) {
+    gst_buffer_replace (&pad->priv->converted_buffer, NULL);
+    gst_buffer_replace (&pad->priv->converted_input, NULL);
   }
 }
 
@@ -614,6 +752,8 @@ gst_video_aggregator_convert_pad_init (GstVideoAggregatorConvertPad * vaggpad)
       gst_video_aggregator_convert_pad_get_instance_private (vaggpad);
 
   vaggpad->priv->converted_buffer = NULL;
+  vaggpad->priv->converted_input = NULL;
+  vaggpad->priv->converted_pool = NULL;
   vaggpad->priv->convert = NULL;
   vaggpad->priv->converter_config = NULL;
   vaggpad->priv->converter_config_changed = FALSE;
@@ -640,6 +780,12 @@ void gst_video_aggregator_convert_pad_update_conversion_info
  * GstVideoAggregator implementation  *
  **************************************/
 
+enum
+{
+  PROP_0,
+  PROP_STATS,
+};
+
 #define GST_VIDEO_AGGREGATOR_GET_LOCK(vagg) (&GST_VIDEO_AGGREGATOR(vagg)->priv->lock)
 
 #define GST_VIDEO_AGGREGATOR_LOCK(vagg)   G_STMT_START {       \
@@ -673,6 +819,10 @@ struct _GstVideoAggregatorPrivate
   GstClockTime earliest_time;
   guint64 qos_processed, qos_dropped;
 
+  /* statistics, OBJECT_LOCK */
+  GstProcessingStats aggregate_stats;
+  guint64 frames_dropped;
+
   /* current caps */
   GstCaps *current_caps;
 
@@ -1598,6 +1748,29 @@ gst_video_aggregator_fill_queues (GstVideoAggregator * vagg,
   return GST_FLOW_OK;
 }
 
+/* Called when outputting at the deadline without data from all pads */
+static void
+gst_video_aggregator_count_late_pads (GstVideoAggregator * vagg)
+{
+  GList *l;
+
+  GST_OBJECT_LOCK (vagg);
+  for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
+    GstVideoAggregatorPad *pad = l->data;
+    GstAggregatorPad *bpad = GST_AGGREGATOR_PAD (pad);
+
+    if (gst_aggregator_pad_is_eos (bpad)
+        || gst_aggregator_pad_has_buffer (bpad))
+      continue;
+
+    GST_LOG_OBJECT (pad, "no data at the deadline, reusing last frame");
+    GST_OBJECT_LOCK (pad);
+    pad->priv->late_outputs++;
+    GST_OBJECT_UNLOCK (pad);
+  }
+  GST_OBJECT_UNLOCK (vagg);
+}
+
 static gboolean
 sync_pad_values (GstElement * vagg, GstPad * pad, gpointer user_data)
 {
@@ -1633,6 +1806,57 @@ prepare_frames (GstElement * agg, GstPad * pad, gpointer user_data)
       vpad->priv->buffer, &vpad->priv->prepared_frame);
 }
 
+static void
+prepare_frames_task (gpointer user_data)
+{
+  GstPad *pad = user_data;
+
+  prepare_frames (GST_PAD_PARENT (pad), pad, NULL);
+}
+
+/* Prepares the frames of all pads. The frames of convert pads only depend on
+ * the state of their own pad, so those are converted in parallel when there
+ * are several of them. Other pads are prepared in order from the aggregator
+ * thread as their subclass might not expect anything else. */
+static void
+gst_video_aggregator_prepare_frames (GstVideoAggregator * vagg)
+{
+  GstElement *element = GST_ELEMENT_CAST (vagg);
+  GPtrArray *pads, *convert_pads;
+  GList *l;
+  guint i;
+
+  pads = g_ptr_array_new_with_free_func (gst_object_unref);
+  GST_OBJECT_LOCK (vagg);
+  for (l = element->sinkpads; l; l = l->next)
+    g_ptr_array_add (pads, gst_object_ref (l->data));
+  GST_OBJECT_UNLOCK (vagg);
+
+  convert_pads = g_ptr_array_new ();
+  for (i = 0; i < pads->len; i++) {
+    GstPad *pad = g_ptr_array_index (pads, i);
+
+    if (GST_IS_VIDEO_AGGREGATOR_CONVERT_PAD (pad))
+      g_ptr_array_add (convert_pads, pad);
+    else
+      prepare_frames (element, pad, NULL);
+  }
+
+  if (convert_pads->len > 1) {
+    GstParallelizedTaskRunner *runner;
+
+    runner = gst_parallelized_task_runner_new (convert_pads->len);
+    gst_parallelized_task_runner_run (runner, prepare_frames_task,
+        convert_pads->pdata);
+    gst_parallelized_task_runner_free (runner);
+  } else if (convert_pads->len == 1) {
+    prepare_frames (element, g_ptr_array_index (convert_pads, 0), NULL);
+  }
+
+  g_ptr_array_free (convert_pads, TRUE);
+  g_ptr_array_unref (pads);
+}
+
 static gboolean
 clean_pad (GstElement * agg, GstPad * pad, gpointer user_data)
 {
@@ -1687,7 +1911,7 @@ gst_video_aggregator_do_aggregate (GstVideoAggregator * vagg,
       &out_stream_time);
 
   /* Convert all the frames the subclass has before aggregating */
-  gst_element_foreach_sink_pad (GST_ELEMENT_CAST (vagg), prepare_frames, NULL);
+  gst_video_aggregator_prepare_frames (vagg);
 
   ret = vagg_klass->aggregate_frames (vagg, *outbuf);
 
@@ -1834,6 +2058,8 @@ gst_video_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
   if (flow_ret == GST_AGGREGATOR_FLOW_NEED_DATA && !timeout) {
     GST_DEBUG_OBJECT (vagg, "Need more data for decisions");
     goto unlock_and_return;
+  } else if (flow_ret == GST_AGGREGATOR_FLOW_NEED_DATA) {
+    gst_video_aggregator_count_late_pads (vagg);
   } else if (flow_ret == GST_FLOW_EOS) {
     GST_DEBUG_OBJECT (vagg, "All sinkpads are EOS -- forwarding");
     goto unlock_and_return;
@@ -1864,15 +2090,26 @@ gst_video_aggregator_aggregate (GstAggregator * agg, gboolean timeout)
 
   jitter = gst_video_aggregator_do_qos (vagg, output_start_time);
   if (jitter <= 0) {
+    GstClockTime start, elapsed;
+
+    start = gst_util_get_timestamp ();
     flow_ret = gst_video_aggregator_do_aggregate (vagg, output_start_time,
         output_end_time, &outbuf);
+    elapsed = gst_util_get_timestamp () - start;
     if (flow_ret != GST_FLOW_OK)
       goto done;
     vagg->priv->qos_processed++;
+
+    GST_OBJECT_LOCK (vagg);
+    gst_processing_stats_add (&vagg->priv->aggregate_stats, elapsed);
+    GST_OBJECT_UNLOCK (vagg);
   } else {
     GstMessage *msg;
 
     vagg->priv->qos_dropped++;
+    GST_OBJECT_LOCK (vagg);
+    vagg->priv->frames_dropped++;
+    GST_OBJECT_UNLOCK (vagg);
 
     msg =
         gst_message_new_qos (GST_OBJECT_CAST (vagg), vagg->priv->live,
@@ -2163,6 +2400,11 @@ gst_video_aggregator_start (GstAggregator * agg)
 
   gst_caps_replace (&vagg->priv->current_caps, NULL);
 
+  GST_OBJECT_LOCK (vagg);
+  gst_processing_stats_reset (&vagg->priv->aggregate_stats);
+  vagg->priv->frames_dropped = 0;
+  GST_OBJECT_UNLOCK (vagg);
+
   return TRUE;
 }
 
@@ -2509,7 +2751,23 @@ static void
 gst_video_aggregator_get_property (GObject * object,
     guint prop_id, GValue * value, GParamSpec * pspec)
 {
+  GstVideoAggregator *vagg = GST_VIDEO_AGGREGATOR (object);
+
   switch (prop_id) {
+    case PROP_STATS:{
+      GstVideoAggregatorPrivate *priv = vagg->priv;
+      GstStructure *s;
+
+      GST_OBJECT_LOCK (vagg);
+      s = gst_structure_new ("application/x-gst-video-aggregator-stats",
+          "dropped", G_TYPE_UINT64, priv->frames_dropped, NULL);
+      gst_processing_stats_set_fields (&priv->aggregate_stats, s, "aggregate",
+          "aggregated");
+      GST_OBJECT_UNLOCK (vagg);
+
+      g_value_take_boxed (value, s);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2550,6 +2808,31 @@ gst_video_aggregator_class_init (GstVideoAggregatorClass * klass)
   gobject_class->get_property = gst_video_aggregator_get_property;
   gobject_class->set_property = gst_video_aggregator_set_property;
 
+  /**
+   * GstVideoAggregator:stats:
+   *
+   * Various statistics, reset when starting. This property returns a
+   * #GstStructure with name `application/x-gst-video-aggregator-stats`
+   * with the following fields:
+   *
+   * - "aggregate-time" G_TYPE_UINT64: total time spent converting and
+   *   aggregating output frames
+   * - "aggregate-time-max" G_TYPE_UINT64: the longest time spent on a
+   *   single output frame
+   * - "aggregated" G_TYPE_UINT64: the number of output frames produced
+   * - "dropped" G_TYPE_UINT64: the number of output frames dropped because
+   *   of QoS
+   * - "aggregate-time-histogram" GST_TYPE_ARRAY of G_TYPE_UINT64: entry n
+   *   counts the output frames that took less than 2^(n+1) microseconds,
+   *   the last entry also counts all slower frames
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Aggregation statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_video_aggregator_request_new_pad);
   gstelement_class->release_pad =
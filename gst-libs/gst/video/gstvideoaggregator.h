@@ -132,6 +132,10 @@ typedef struct _GstVideoAggregatorConvertPadPrivate GstVideoAggregatorConvertPad
  *
  * An implementation of GstPad that can be used with #GstVideoAggregator.
  *
+ * If the pad converts its input, the converted frame is kept and reused for
+ * as long as the same input buffer is aggregated, so the prepared frame
+ * must not be modified.
+ *
  * See #GstVideoAggregator for more details.
  *
  * Since: 1.16
@@ -149,6 +153,10 @@ struct _GstVideoAggregatorConvertPad
 /**
  * GstVideoAggregatorConvertPadClass:
  *
+ * The #GstVideoAggregatorPadClass::prepare_frame of convert pads may be
+ * called from several threads at the same time for different pads, and
+ * must only modify the state of its own pad.
+ *
  * Since: 1.16
  */
 struct _GstVideoAggregatorConvertPadClass
@@ -282,6 +282,8 @@
 #include <gst/video/video-event.h>
 #include <gst/video/gstvideopool.h>
 #include <gst/video/gstvideometa.h>
+#include <gst/gstoutputqueue-private.h>
+#include <gst/gstprocessingstats-private.h>
 #include <string.h>
 
 GST_DEBUG_CATEGORY (videodecoder_debug);
@@ -289,11 +291,18 @@ GST_DEBUG_CATEGORY (videodecoder_debug);
 
 /* properties */
 #define DEFAULT_QOS                 TRUE
+#define DEFAULT_QOS_SKIP_MODE       GST_VIDEO_DECODER_QOS_SKIP_NONE
+#define DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS 0
+#define DEFAULT_OUTPUT_QUEUE_MAX_TIME 0
 
 enum
 {
   PROP_0,
   PROP_QOS,
+  PROP_QOS_SKIP_MODE,
+  PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+  PROP_OUTPUT_QUEUE_MAX_TIME,
+  PROP_STATS,
 };
 
 struct _GstVideoDecoderPrivate
@@ -373,7 +382,10 @@ struct _GstVideoDecoderPrivate
   guint32 system_frame_number;
   guint32 decode_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> frame of the frames above */
+  GHashTable *frames_by_number;
+  GstVideoCodecFramePool *frame_pool;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;     /* OBJECT_LOCK and STREAM_LOCK */
   gboolean output_state_changed;
@@ -383,6 +395,11 @@ struct _GstVideoDecoderPrivate
   gdouble proportion;           /* OBJECT_LOCK */
   GstClockTime earliest_time;   /* OBJECT_LOCK */
   GstClockTime qos_frame_duration;      /* OBJECT_LOCK */
+  GstVideoDecoderQosSkipMode qos_skip_mode;     /* OBJECT_LOCK */
+  /* moving average of the time handle_frame takes, OBJECT_LOCK */
+  GstClockTime avg_decode_time;
+  /* dropping input until the next keyframe in time */
+  gboolean qos_keyframe_only;
   gboolean discont;
   /* qos messages: frames dropped/processed */
   guint dropped;
@@ -407,6 +424,31 @@ struct _GstVideoDecoderPrivate
   /* flags */
   gboolean use_default_pad_acceptcaps;
 
+  /* frame threading */
+  guint frame_threads;
+  GThreadPool *frame_thread_pool;
+  /* FrameThreadEntry of dispatched frames in decoding order, STREAM_LOCK */
+  GQueue frame_thread_queue;
+  GstFlowReturn frame_thread_ret;       /* STREAM_LOCK */
+  gboolean frame_thread_outputting;     /* STREAM_LOCK */
+  GMutex frame_thread_lock;
+  GCond frame_thread_cond;
+  guint frame_threads_busy;     /* frame_thread_lock */
+
+  /* output queue */
+  guint output_queue_max_buffers;       /* OBJECT_LOCK */
+  GstClockTime output_queue_max_time;   /* OBJECT_LOCK */
+  gboolean output_queue_active;
+  GstOutputQueue output_queue;
+
+  /* statistics, OBJECT_LOCK */
+  GstProcessingStats decode_stats;
+  GstClockTime push_time;
+  guint64 buffers_pushed;
+  guint64 frames_dropped;
+  /* time spent outputting by the decoding thread, STREAM_LOCK */
+  GstClockTime output_time;
+
 #ifndef GST_DISABLE_DEBUG
   /* Diagnostic time for reporting the time
    * from flush to first output */
@@ -414,6 +456,23 @@ struct _GstVideoDecoderPrivate
 #endif
 };
 
+typedef enum
+{
+  FRAME_THREAD_PENDING,
+  FRAME_THREAD_FINISH,
+  FRAME_THREAD_DROP,
+  FRAME_THREAD_RELEASE,
+  FRAME_THREAD_KEPT
+} FrameThreadState;
+
+/* a frame handed to the frame thread pool, waiting for its turn to be
+ * output */
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  FrameThreadState state;
+} FrameThreadEntry;
+
 static GstElementClass *parent_class = NULL;
 static gint private_offset = 0;
 
@@ -446,6 +505,18 @@ static void gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
 
 static GstFlowReturn gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame);
+static void gst_video_decoder_wait_frame_threads (GstVideoDecoder * decoder,
+    guint max_busy);
+static void gst_video_decoder_update_decode_time (GstVideoDecoder * decoder,
+    GstClockTime elapsed);
+static gboolean gst_video_decoder_src_activate_mode (GstPad * pad,
+    GstObject * parent, GstPadMode mode, gboolean active);
+static GstFlowReturn gst_video_decoder_push_timed (GstVideoDecoder * decoder,
+    GstBuffer * buf);
+static GstFlowReturn gst_video_decoder_output_queue_push (GstVideoDecoder *
+    decoder, GstMiniObject * item);
+static gboolean gst_video_decoder_defer_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, FrameThreadState state);
 
 static void gst_video_decoder_push_event_list (GstVideoDecoder * decoder,
     GList * events);
@@ -566,6 +637,87 @@ gst_video_decoder_class_init (GstVideoDecoderClass * klass)
       g_param_spec_boolean ("qos", "Quality of Service",
           "Handle Quality-of-Service events from downstream",
           DEFAULT_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoDecoder:qos-skip-mode:
+   *
+   * How to avoid decoding frames predicted to be late, based on the QoS
+   * events received and on how long decoding the previous frames took.
+   * Without this, frames are only dropped after they are decoded.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_QOS_SKIP_MODE,
+      g_param_spec_enum ("qos-skip-mode", "QoS skip mode",
+          "How to skip decoding frames predicted to be late",
+          GST_TYPE_VIDEO_DECODER_QOS_SKIP_MODE, DEFAULT_QOS_SKIP_MODE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoDecoder:output-queue-max-buffers:
+   *
+   * If not 0, decoded buffers are pushed downstream from a separate thread,
+   * queueing up to this many buffers, so that decoding doesn't stall while
+   * downstream is busy.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_OUTPUT_QUEUE_MAX_BUFFERS,
+      g_param_spec_uint ("output-queue-max-buffers",
+          "Output queue max buffers",
+          "Number of buffers to queue for pushing from a separate thread "
+          "(0 = push from the decoding thread)", 0, G_MAXUINT,
+          DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoDecoder:output-queue-max-time:
+   *
+   * If not 0, decoded buffers are pushed downstream from a separate thread,
+   * queueing buffers up to this duration. Combined with
+   * #GstVideoDecoder:output-queue-max-buffers, whichever limit is hit first
+   * applies.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_OUTPUT_QUEUE_MAX_TIME,
+      g_param_spec_uint64 ("output-queue-max-time",
+          "Output queue max time",
+          "Duration of buffers to queue for pushing from a separate thread, "
+          "in nanoseconds (0 = push from the decoding thread)", 0,
+          G_MAXUINT64, DEFAULT_OUTPUT_QUEUE_MAX_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoDecoder:stats:
+   *
+   * Various decoder statistics. This property returns a #GstStructure
+   * with name `application/x-gst-video-decoder-stats` with the following
+   * fields:
+   *
+   * - "decode-time" G_TYPE_UINT64: total time spent decoding frames, not
+   *   counting the time spent pushing them
+   * - "push-time" G_TYPE_UINT64: total time spent pushing buffers downstream
+   * - "decoded" G_TYPE_UINT64: the number of frames handed to the subclass
+   * - "pushed" G_TYPE_UINT64: the number of buffers pushed downstream
+   * - "dropped" G_TYPE_UINT64: the number of frames dropped because of QoS
+   * - "frames-in-flight" G_TYPE_UINT: the number of frames currently held by
+   *   the decoder and the subclass
+   * - "decode-time-max" G_TYPE_UINT64: the longest time spent decoding a
+   *   single frame
+   * - "decode-time-histogram" GST_TYPE_ARRAY of G_TYPE_UINT64: entry n
+   *   counts the frames that took less than 2^(n+1) microseconds to decode,
+   *   the last entry also counts all slower frames
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Decoding and output statistics", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -601,6 +753,8 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_decoder_src_event));
   gst_pad_set_query_function (pad,
       GST_DEBUG_FUNCPTR (gst_video_decoder_src_query));
+  gst_pad_set_activatemode_function (pad,
+      GST_DEBUG_FUNCPTR (gst_video_decoder_src_activate_mode));
   gst_element_add_pad (GST_ELEMENT (decoder), decoder->srcpad);
 
   gst_segment_init (&decoder->input_segment, GST_FORMAT_TIME);
@@ -615,10 +769,25 @@ gst_video_decoder_init (GstVideoDecoder * decoder, GstVideoDecoderClass * klass)
 
   /* properties */
   decoder->priv->do_qos = DEFAULT_QOS;
+  decoder->priv->qos_skip_mode = DEFAULT_QOS_SKIP_MODE;
 
   decoder->priv->min_latency = 0;
   decoder->priv->max_latency = 0;
 
+  g_queue_init (&decoder->priv->frame_thread_queue);
+  g_mutex_init (&decoder->priv->frame_thread_lock);
+  g_cond_init (&decoder->priv->frame_thread_cond);
+
+  decoder->priv->output_queue_max_buffers = DEFAULT_OUTPUT_QUEUE_MAX_BUFFERS;
+  decoder->priv->output_queue_max_time = DEFAULT_OUTPUT_QUEUE_MAX_TIME;
+  gst_output_queue_init (&decoder->priv->output_queue, GST_OBJECT (decoder),
+      decoder->srcpad, (GstOutputQueuePushFunc) gst_video_decoder_push_timed,
+      GST_CAT_DEFAULT);
+
+  g_queue_init (&decoder->priv->frames);
+  decoder->priv->frames_by_number = g_hash_table_new (NULL, NULL);
+  decoder->priv->frame_pool = _gst_video_codec_frame_pool_new ();
+
   gst_video_decoder_reset (decoder, TRUE, TRUE);
 }
 
@@ -788,8 +957,18 @@ gst_video_decoder_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (object, "finalize");
 
+  if (decoder->priv->frame_thread_pool)
+    g_thread_pool_free (decoder->priv->frame_thread_pool, FALSE, TRUE);
+  g_mutex_clear (&decoder->priv->frame_thread_lock);
+  g_cond_clear (&decoder->priv->frame_thread_cond);
+  gst_output_queue_clear (&decoder->priv->output_queue);
+
   g_rec_mutex_clear (&decoder->stream_lock);
 
+  g_hash_table_unref (decoder->priv->frames_by_number);
+  /* frames still referenced elsewhere keep the pool alive */
+  _gst_video_codec_frame_pool_unref (decoder->priv->frame_pool);
+
   if (decoder->priv->input_adapter) {
     g_object_unref (decoder->priv->input_adapter);
     decoder->priv->input_adapter = NULL;
@@ -827,6 +1006,37 @@ gst_video_decoder_get_property (GObject * object, guint property_id,
     case PROP_QOS:
       g_value_set_boolean (value, priv->do_qos);
       break;
+    case PROP_QOS_SKIP_MODE:
+      GST_OBJECT_LOCK (object);
+      g_value_set_enum (value, priv->qos_skip_mode);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (object);
+      g_value_set_uint (value, priv->output_queue_max_buffers);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (object);
+      g_value_set_uint64 (value, priv->output_queue_max_time);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_STATS:{
+      GstStructure *s;
+
+      GST_OBJECT_LOCK (object);
+      s = gst_structure_new ("application/x-gst-video-decoder-stats",
+          "push-time", G_TYPE_UINT64, priv->push_time,
+          "pushed", G_TYPE_UINT64, priv->buffers_pushed,
+          "dropped", G_TYPE_UINT64, priv->frames_dropped,
+          "frames-in-flight", G_TYPE_UINT, priv->frames.length, NULL);
+      gst_processing_stats_set_fields (&priv->decode_stats, s, "decode",
+          "decoded");
+      GST_OBJECT_UNLOCK (object);
+
+      g_value_take_boxed (value, s);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -843,6 +1053,21 @@ gst_video_decoder_set_property (GObject * object, guint property_id,
     case PROP_QOS:
       priv->do_qos = g_value_get_boolean (value);
       break;
+    case PROP_QOS_SKIP_MODE:
+      GST_OBJECT_LOCK (object);
+      priv->qos_skip_mode = g_value_get_enum (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_BUFFERS:
+      GST_OBJECT_LOCK (object);
+      priv->output_queue_max_buffers = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_OUTPUT_QUEUE_MAX_TIME:
+      GST_OBJECT_LOCK (object);
+      priv->output_queue_max_time = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -929,6 +1154,16 @@ gst_video_decoder_push_event (GstVideoDecoder * decoder, GstEvent * event)
       break;
   }
 
+  /* keep serialized events in order with the queued buffers */
+  if (decoder->priv->output_queue_active && GST_EVENT_IS_SERIALIZED (event)
+      && GST_EVENT_TYPE (event) != GST_EVENT_FLUSH_STOP) {
+    GST_DEBUG_OBJECT (decoder, "queueing event %s",
+        gst_event_type_get_name (GST_EVENT_TYPE (event)));
+
+    return gst_video_decoder_output_queue_push (decoder,
+        GST_MINI_OBJECT_CAST (event)) != GST_FLOW_FLUSHING;
+  }
+
   GST_DEBUG_OBJECT (decoder, "pushing event %s",
       gst_event_type_get_name (GST_EVENT_TYPE (event)));
 
@@ -1342,7 +1577,7 @@ gst_video_decoder_sink_event_default (GstVideoDecoder * decoder,
       GList *l;
 
       GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-      for (l = priv->frames; l; l = l->next) {
+      for (l = priv->frames.head; l; l = l->next) {
         GstVideoCodecFrame *frame = l->data;
 
         frame->events = _flush_events (decoder->srcpad, frame->events);
@@ -1428,9 +1663,28 @@ gst_video_decoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (decoder, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* everything dispatched before a serialized event has to be output before
+   * it is handled */
+  if (GST_EVENT_IS_SERIALIZED (event))
+    gst_video_decoder_wait_frame_threads (decoder, 0);
+
+  /* unblock the streaming thread if it waits for room in the output queue */
+  if (decoder->priv->output_queue_active
+      && GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+    gst_output_queue_set_flushing (&decoder->priv->output_queue, TRUE);
+
   if (decoder_class->sink_event)
     ret = decoder_class->sink_event (decoder, event);
 
+  /* FLUSH_START is forwarded now, so the output task can't be blocked
+   * downstream anymore */
+  if (decoder->priv->output_queue_active) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START)
+      gst_pad_pause_task (decoder->srcpad);
+    else if (GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_STOP)
+      gst_output_queue_set_flushing (&decoder->priv->output_queue, FALSE);
+  }
+
   return ret;
 }
 
@@ -2033,8 +2287,9 @@ gst_video_decoder_clear_queues (GstVideoDecoder * dec)
   g_list_free_full (priv->parse_gather,
       (GDestroyNotify) gst_video_codec_frame_unref);
   priv->parse_gather = NULL;
-  g_list_free_full (priv->frames, (GDestroyNotify) gst_video_codec_frame_unref);
-  priv->frames = NULL;
+  g_hash_table_remove_all (priv->frames_by_number);
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
 }
 
 static void
@@ -2064,6 +2319,8 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     g_list_free_full (priv->pending_events, (GDestroyNotify) gst_event_unref);
     priv->pending_events = NULL;
 
+    priv->qos_keyframe_only = FALSE;
+
     priv->error_count = 0;
     priv->max_errors = GST_VIDEO_DECODER_MAX_ERRORS;
     priv->had_output_data = FALSE;
@@ -2085,6 +2342,7 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
     priv->output_state = NULL;
 
     priv->qos_frame_duration = 0;
+    priv->avg_decode_time = 0;
     GST_OBJECT_UNLOCK (decoder);
 
     if (priv->tags)
@@ -2119,6 +2377,9 @@ gst_video_decoder_reset (GstVideoDecoder * decoder, gboolean full,
   }
 
   priv->discont = TRUE;
+  /* serialized events wait for all workers, which output all their frames */
+  g_warn_if_fail (g_queue_is_empty (&priv->frame_thread_queue));
+  priv->frame_thread_ret = GST_FLOW_OK;
 
   priv->base_timestamp = GST_CLOCK_TIME_NONE;
   priv->last_timestamp_out = GST_CLOCK_TIME_NONE;
@@ -2475,6 +2736,12 @@ gst_video_decoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       GST_TIME_ARGS (GST_BUFFER_DURATION (buf)),
       gst_buffer_get_size (buf), GST_BUFFER_FLAGS (buf));
 
+  /* keep up to two frames per thread in flight, so that workers don't run
+   * dry while the output of the oldest frame is pending */
+  if (decoder->priv->frame_thread_pool)
+    gst_video_decoder_wait_frame_threads (decoder,
+        2 * decoder->priv->frame_threads - 1);
+
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
   /* NOTE:
@@ -2538,6 +2805,16 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
       gst_video_decoder_reset (decoder, TRUE, TRUE);
       GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
+      GST_OBJECT_LOCK (decoder);
+      decoder->priv->output_queue_active =
+          decoder->priv->output_queue_max_buffers != 0
+          || decoder->priv->output_queue_max_time != 0;
+      gst_processing_stats_reset (&decoder->priv->decode_stats);
+      decoder->priv->push_time = 0;
+      decoder->priv->buffers_pushed = 0;
+      decoder->priv->frames_dropped = 0;
+      GST_OBJECT_UNLOCK (decoder);
+
       /* Initialize device/library if needed */
       if (decoder_class->start && !decoder_class->start (decoder))
         goto start_failed;
@@ -2552,6 +2829,9 @@ gst_video_decoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      /* the streaming thread is stopped, let the workers finish */
+      gst_video_decoder_wait_frame_threads (decoder, 0);
+
       if (decoder_class->stop)
         stopped = decoder_class->stop (decoder);
 
@@ -2611,9 +2891,7 @@ gst_video_decoder_new_frame (GstVideoDecoder * decoder)
   GstVideoDecoderPrivate *priv = decoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = _gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -2658,7 +2936,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
 
 #ifndef GST_DISABLE_GST_DEBUG
   GST_LOG_OBJECT (decoder, "n %d in %" G_GSIZE_FORMAT " out %" G_GSIZE_FORMAT,
-      g_list_length (priv->frames),
+      priv->frames.length,
       gst_adapter_available (priv->input_adapter),
       gst_adapter_available (priv->output_adapter));
 #endif
@@ -2672,7 +2950,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
       sync, GST_TIME_ARGS (frame->pts), GST_TIME_ARGS (frame->dts));
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2732,7 +3010,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     gboolean seen_none = FALSE;
 
     /* some maintenance regardless */
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2766,7 +3044,7 @@ gst_video_decoder_prepare_finish_frame (GstVideoDecoder *
     /* some more maintenance, ts2 holds PTS */
     min_ts = GST_CLOCK_TIME_NONE;
     seen_none = FALSE;
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *tmp = l->data;
 
       if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts2)) {
@@ -2858,14 +3136,20 @@ void
 gst_video_decoder_release_frame (GstVideoDecoder * dec,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
-  link = g_list_find (dec->priv->frames, frame);
-  if (link) {
+  if (gst_video_decoder_defer_frame (dec, frame, FRAME_THREAD_RELEASE)) {
+    GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+    return;
+  }
+
+  if (g_hash_table_lookup (dec->priv->frames_by_number,
+          GUINT_TO_POINTER (frame->system_frame_number)) == frame) {
+    g_hash_table_remove (dec->priv->frames_by_number,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    /* frames are usually released oldest first, so this is quick */
+    g_queue_remove (&dec->priv->frames, frame);
     gst_video_codec_frame_unref (frame);
-    dec->priv->frames = g_list_delete_link (dec->priv->frames, link);
   }
   if (frame->events) {
     dec->priv->pending_events =
@@ -2890,6 +3174,7 @@ gst_video_decoder_post_qos_drop (GstVideoDecoder * dec, GstClockTime timestamp)
 
   /* post QoS message */
   GST_OBJECT_LOCK (dec);
+  dec->priv->frames_dropped++;
   proportion = dec->priv->proportion;
   earliest_time = dec->priv->earliest_time;
   GST_OBJECT_UNLOCK (dec);
@@ -2928,6 +3213,11 @@ gst_video_decoder_drop_frame (GstVideoDecoder * dec, GstVideoCodecFrame * frame)
 
   GST_VIDEO_DECODER_STREAM_LOCK (dec);
 
+  if (gst_video_decoder_defer_frame (dec, frame, FRAME_THREAD_DROP)) {
+    GST_VIDEO_DECODER_STREAM_UNLOCK (dec);
+    return GST_FLOW_OK;
+  }
+
   gst_video_decoder_prepare_finish_frame (dec, frame, TRUE);
 
   GST_DEBUG_OBJECT (dec, "dropping frame %" GST_TIME_FORMAT,
@@ -3029,6 +3319,12 @@ gst_video_decoder_finish_frame (GstVideoDecoder * decoder,
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
 
+  if (gst_video_decoder_defer_frame (decoder, frame, FRAME_THREAD_FINISH)) {
+    ret = priv->frame_thread_ret;
+    GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+    return ret;
+  }
+
   needs_reconfigure = gst_pad_check_reconfigure (decoder->srcpad);
   if (G_UNLIKELY (priv->output_state_changed || (priv->output_state
               && needs_reconfigure))) {
@@ -3120,6 +3416,60 @@ done:
   return ret;
 }
 
+/* pushes @buf downstream, accounting for the time it took */
+static GstFlowReturn
+gst_video_decoder_push_timed (GstVideoDecoder * decoder, GstBuffer * buf)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstClockTime start, elapsed;
+  GstFlowReturn ret;
+
+  start = gst_util_get_timestamp ();
+  ret = gst_pad_push (decoder->srcpad, buf);
+  elapsed = gst_util_get_timestamp () - start;
+
+  GST_OBJECT_LOCK (decoder);
+  priv->push_time += elapsed;
+  priv->buffers_pushed++;
+  GST_OBJECT_UNLOCK (decoder);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_decoder_output_queue_push (GstVideoDecoder * decoder,
+    GstMiniObject * item)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  guint max_buffers;
+  GstClockTime max_time;
+
+  GST_OBJECT_LOCK (decoder);
+  max_buffers = priv->output_queue_max_buffers;
+  max_time = priv->output_queue_max_time;
+  GST_OBJECT_UNLOCK (decoder);
+
+  return gst_output_queue_push (&priv->output_queue, item, max_buffers,
+      max_time);
+}
+
+static gboolean
+gst_video_decoder_src_activate_mode (GstPad * pad, GstObject * parent,
+    GstPadMode mode, gboolean active)
+{
+  GstVideoDecoder *decoder = GST_VIDEO_DECODER (parent);
+
+  if (mode != GST_PAD_MODE_PUSH)
+    return FALSE;
+
+  if (active)
+    gst_output_queue_set_flushing (&decoder->priv->output_queue, FALSE);
+  else
+    gst_output_queue_stop (&decoder->priv->output_queue);
+
+  return TRUE;
+}
+
 /* With stream lock, takes the frame reference */
 static GstFlowReturn
 gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
@@ -3129,7 +3479,7 @@ gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
   guint64 start, stop;
   guint64 cstart, cstop;
   GstSegment *segment;
-  GstClockTime duration;
+  GstClockTime duration, push_start;
 
   /* Check for clipping */
   start = GST_BUFFER_PTS (buf);
@@ -3259,8 +3609,14 @@ gst_video_decoder_clip_and_push_buf (GstVideoDecoder * decoder, GstBuffer * buf)
   /* release STREAM_LOCK not to block upstream 
    * while pushing buffer downstream */
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
-  ret = gst_pad_push (decoder->srcpad, buf);
+  push_start = gst_util_get_timestamp ();
+  if (priv->output_queue_active)
+    ret = gst_video_decoder_output_queue_push (decoder,
+        GST_MINI_OBJECT_CAST (buf));
+  else
+    ret = gst_video_decoder_push_timed (decoder, buf);
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  priv->output_time += gst_util_get_timestamp () - push_start;
 
 done:
   return ret;
@@ -3412,6 +3768,231 @@ gst_video_decoder_have_frame (GstVideoDecoder * decoder)
   return ret;
 }
 
+/* Frame threading
+ *
+ * With frame threads enabled, decode_frame() hands the frames to a thread pool
+ * instead of calling handle_frame() itself, and records them in
+ * frame_thread_queue in decoding order.  finish_frame(), drop_frame() and
+ * release_frame() on a queued frame only record what to do with it; the
+ * actual output happens in queue order as soon as all older frames are done,
+ * from whichever worker completes the oldest frame.
+ *
+ * Workers run handle_frame() without the stream lock, so anything waiting for
+ * them, like serialized events and the streaming thread for room in the
+ * queue, does so before taking the stream lock. */
+
+static void
+gst_video_decoder_wait_frame_threads (GstVideoDecoder * decoder,
+    guint max_busy)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  while (priv->frame_threads_busy > max_busy)
+    g_cond_wait (&priv->frame_thread_cond, &priv->frame_thread_lock);
+  g_mutex_unlock (&priv->frame_thread_lock);
+}
+
+/* with STREAM_LOCK */
+static gboolean
+gst_video_decoder_defer_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame, FrameThreadState state)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GList *l;
+
+  if (priv->frame_thread_outputting)
+    return FALSE;
+
+  for (l = priv->frame_thread_queue.head; l; l = l->next) {
+    FrameThreadEntry *entry = l->data;
+
+    if (entry->frame == frame && entry->state == FRAME_THREAD_PENDING) {
+      GST_LOG_OBJECT (decoder, "deferring output of frame %p (sfn:%d)", frame,
+          frame->system_frame_number);
+      entry->state = state;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/* with STREAM_LOCK */
+static void
+gst_video_decoder_output_threaded_frames (GstVideoDecoder * decoder)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameThreadEntry *entry;
+
+  priv->frame_thread_outputting = TRUE;
+
+  while ((entry = g_queue_peek_head (&priv->frame_thread_queue))
+      && entry->state != FRAME_THREAD_PENDING) {
+    GstFlowReturn ret = GST_FLOW_OK;
+
+    g_queue_pop_head (&priv->frame_thread_queue);
+
+    switch (entry->state) {
+      case FRAME_THREAD_FINISH:
+        ret = gst_video_decoder_finish_frame (decoder, entry->frame);
+        break;
+      case FRAME_THREAD_DROP:
+        ret = gst_video_decoder_drop_frame (decoder, entry->frame);
+        break;
+      case FRAME_THREAD_RELEASE:
+        gst_video_decoder_release_frame (decoder, entry->frame);
+        break;
+      default:
+        /* still owned by the subclass, output whenever it's done */
+        break;
+    }
+
+    if (ret != GST_FLOW_OK && priv->frame_thread_ret == GST_FLOW_OK)
+      priv->frame_thread_ret = ret;
+
+    g_slice_free (FrameThreadEntry, entry);
+  }
+
+  priv->frame_thread_outputting = FALSE;
+}
+
+static void
+gst_video_decoder_frame_thread_func (gpointer data, gpointer user_data)
+{
+  FrameThreadEntry *entry = data;
+  GstVideoDecoder *decoder = user_data;
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_GET_CLASS (decoder);
+  GstClockTime start, elapsed;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (decoder, "handling frame %p (sfn:%d)", entry->frame,
+      entry->frame->system_frame_number);
+
+  start = gst_util_get_timestamp ();
+  ret = decoder_class->handle_frame (decoder, entry->frame);
+  elapsed = gst_util_get_timestamp () - start;
+
+  /* finishing is deferred, so nothing got pushed meanwhile */
+  gst_video_decoder_update_decode_time (decoder, elapsed);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  /* once finished, another worker may already have output and freed it */
+  if (g_queue_find (&priv->frame_thread_queue, entry)
+      && entry->state == FRAME_THREAD_PENDING)
+    entry->state = FRAME_THREAD_KEPT;
+  if (ret != GST_FLOW_OK && priv->frame_thread_ret == GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
+    priv->frame_thread_ret = ret;
+  }
+  gst_video_decoder_output_threaded_frames (decoder);
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  priv->frame_threads_busy--;
+  g_cond_broadcast (&priv->frame_thread_cond);
+  g_mutex_unlock (&priv->frame_thread_lock);
+}
+
+/* with STREAM_LOCK, takes ownership of @frame */
+static GstFlowReturn
+gst_video_decoder_dispatch_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  FrameThreadEntry *entry;
+
+  /* report errors of earlier frames as soon as possible */
+  if (priv->frame_thread_ret != GST_FLOW_OK) {
+    gst_video_decoder_release_frame (decoder, frame);
+    return priv->frame_thread_ret;
+  }
+
+  entry = g_slice_new (FrameThreadEntry);
+  entry->frame = frame;
+  entry->state = FRAME_THREAD_PENDING;
+  g_queue_push_tail (&priv->frame_thread_queue, entry);
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  priv->frame_threads_busy++;
+  g_mutex_unlock (&priv->frame_thread_lock);
+
+  g_thread_pool_push (priv->frame_thread_pool, entry, NULL);
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_video_decoder_update_decode_time (GstVideoDecoder * decoder,
+    GstClockTime elapsed)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  GST_OBJECT_LOCK (decoder);
+  gst_processing_stats_add (&priv->decode_stats, elapsed);
+  if (priv->avg_decode_time == 0)
+    priv->avg_decode_time = elapsed;
+  else
+    priv->avg_decode_time = (7 * priv->avg_decode_time + elapsed) / 8;
+  GST_OBJECT_UNLOCK (decoder);
+}
+
+/* with STREAM_LOCK. Returns %TRUE if @frame should be dropped without
+ * decoding it, or flags it for the subclass to skip */
+static gboolean
+gst_video_decoder_qos_skip_frame (GstVideoDecoder * decoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+  GstVideoDecoderQosSkipMode mode;
+  GstClockTimeDiff max_decode_time;
+  GstClockTime avg_decode_time;
+
+  GST_OBJECT_LOCK (decoder);
+  mode = priv->qos_skip_mode;
+  avg_decode_time = priv->avg_decode_time;
+  GST_OBJECT_UNLOCK (decoder);
+
+  if (!priv->do_qos || mode == GST_VIDEO_DECODER_QOS_SKIP_NONE)
+    return FALSE;
+
+  max_decode_time = gst_video_decoder_get_max_decode_time (decoder, frame);
+  if (max_decode_time == G_MAXINT64) {
+    priv->qos_keyframe_only = FALSE;
+    return FALSE;
+  }
+
+  if (mode == GST_VIDEO_DECODER_QOS_SKIP_KEYFRAME) {
+    if (GST_VIDEO_CODEC_FRAME_IS_SYNC_POINT (frame)) {
+      /* keyframes are always decoded, everything after depends on them */
+      if (priv->qos_keyframe_only && max_decode_time >= avg_decode_time) {
+        GST_DEBUG_OBJECT (decoder, "caught up at keyframe, decoding all "
+            "frames again");
+        priv->qos_keyframe_only = FALSE;
+      }
+    } else if (priv->qos_keyframe_only) {
+      GST_LOG_OBJECT (decoder, "skipping frame until next keyframe");
+      return TRUE;
+    } else if (max_decode_time < 0) {
+      GST_DEBUG_OBJECT (decoder, "frame late by %" GST_STIME_FORMAT
+          " before decoding, decoding keyframes only",
+          GST_STIME_ARGS (-max_decode_time));
+      priv->qos_keyframe_only = TRUE;
+      return TRUE;
+    }
+  }
+
+  if (max_decode_time < (GstClockTimeDiff) avg_decode_time) {
+    GST_LOG_OBJECT (decoder, "frame predicted late, %" GST_STIME_FORMAT
+        " left for %" GST_TIME_FORMAT " of decoding",
+        GST_STIME_ARGS (max_decode_time), GST_TIME_ARGS (avg_decode_time));
+    GST_VIDEO_CODEC_FRAME_SET_SKIP_NON_REF (frame);
+  }
+
+  return FALSE;
+}
+
 /* Pass the frame in priv->current_frame through the
  * handle_frame() callback for decoding and passing to gvd_finish_frame(),
  * or dropping by passing to gvd_drop_frame() */
@@ -3458,19 +4039,39 @@ gst_video_decoder_decode_frame (GstVideoDecoder * decoder,
       frame->distance_from_sync);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_by_number,
+      GUINT_TO_POINTER (frame->system_frame_number), frame);
 
-  if (g_list_length (priv->frames) > 10) {
+  if (priv->frames.length > 10) {
     GST_DEBUG_OBJECT (decoder, "decoder frame list getting long: %d frames,"
-        "possible internal leaking?", g_list_length (priv->frames));
+        "possible internal leaking?", priv->frames.length);
   }
 
   frame->deadline =
       gst_segment_to_running_time (&decoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
+  if (decoder->input_segment.rate > 0.0
+      && gst_video_decoder_qos_skip_frame (decoder, frame)) {
+    return gst_video_decoder_drop_frame (decoder, frame);
+  }
+
   /* do something with frame */
-  ret = decoder_class->handle_frame (decoder, frame);
+  if (priv->frame_thread_pool && decoder->input_segment.rate > 0.0) {
+    ret = gst_video_decoder_dispatch_frame (decoder, frame);
+  } else {
+    GstClockTime start, output_time, elapsed;
+
+    output_time = priv->output_time;
+    start = gst_util_get_timestamp ();
+    ret = decoder_class->handle_frame (decoder, frame);
+    /* don't account for frames finished and pushed from handle_frame */
+    elapsed = gst_util_get_timestamp () - start;
+    elapsed -= MIN (elapsed, priv->output_time - output_time);
+
+    gst_video_decoder_update_decode_time (decoder, elapsed);
+  }
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (decoder, "flow error %s", gst_flow_get_name (ret));
 
@@ -3605,8 +4206,8 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  if (decoder->priv->frames)
-    frame = gst_video_codec_frame_ref (decoder->priv->frames->data);
+  if (decoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (decoder->priv->frames.head->data);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -3624,20 +4225,15 @@ gst_video_decoder_get_oldest_frame (GstVideoDecoder * decoder)
 GstVideoCodecFrame *
 gst_video_decoder_get_frame (GstVideoDecoder * decoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (decoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  for (g = decoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = g_hash_table_lookup (decoder->priv->frames_by_number,
+      GUINT_TO_POINTER (frame_number));
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
   return frame;
@@ -3657,7 +4253,7 @@ gst_video_decoder_get_frames (GstVideoDecoder * decoder)
   GList *frames;
 
   GST_VIDEO_DECODER_STREAM_LOCK (decoder);
-  frames = g_list_copy (decoder->priv->frames);
+  frames = g_list_copy (decoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
 
@@ -3924,7 +4520,7 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = decoder->priv->frames ? decoder->priv->frames->data : NULL;
+  frame = decoder->priv->frames.head ? decoder->priv->frames.head->data : NULL;
   if (frame || decoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -3949,6 +4545,11 @@ gst_video_decoder_negotiate_default (GstVideoDecoder * decoder)
     }
   }
 
+  /* caps are set directly on the pad, after everything still queued for
+   * output with the previous caps */
+  if (decoder->priv->output_queue_active)
+    gst_output_queue_drain (&decoder->priv->output_queue);
+
   prevcaps = gst_pad_get_current_caps (decoder->srcpad);
   if (!prevcaps || !gst_caps_is_equal (prevcaps, state->caps)) {
     if (!prevcaps) {
@@ -4541,3 +5142,76 @@ gst_video_decoder_set_use_default_pad_acceptcaps (GstVideoDecoder * decoder,
 {
   decoder->priv->use_default_pad_acceptcaps = use;
 }
+
+/**
+ * gst_video_decoder_set_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ * @n_threads: the number of frames that can be decoded in parallel
+ *
+ * Lets the base class call #GstVideoDecoderClass.handle_frame() for up to
+ * @n_threads frames at the same time, from a pool of worker threads, while
+ * the streaming thread keeps parsing input. Frames are still output in
+ * decoding order: gst_video_decoder_finish_frame() and
+ * gst_video_decoder_drop_frame() on a frame only push it once all the frames
+ * handed to the subclass before it are done.
+ *
+ * handle_frame() is then called without the stream lock held and must be
+ * reentrant. This is only suitable for subclasses whose frames can be decoded
+ * independently of each other, for instance intra-only codecs, or that
+ * synchronize the dependencies between frames themselves. Frames should be
+ * finished, dropped or released from handle_frame(); frames kept for later
+ * stop being ordered. Reverse playback always decodes frames one by one.
+ *
+ * Setting @n_threads to 0 or 1 disables frame threading, which is the
+ * default. This must not be called while the decoder is processing data;
+ * the #GstVideoDecoderClass.start() vfunc is a good place.
+ *
+ * Since: 1.18
+ */
+void
+gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+    guint n_threads)
+{
+  GstVideoDecoderPrivate *priv = decoder->priv;
+
+  g_return_if_fail (GST_IS_VIDEO_DECODER (decoder));
+
+  if (n_threads <= 1)
+    n_threads = 0;
+
+  gst_video_decoder_wait_frame_threads (decoder, 0);
+
+  GST_VIDEO_DECODER_STREAM_LOCK (decoder);
+  if (n_threads != priv->frame_threads) {
+    GST_DEBUG_OBJECT (decoder, "using %u frame threads", n_threads);
+
+    if (priv->frame_thread_pool)
+      g_thread_pool_free (priv->frame_thread_pool, FALSE, TRUE);
+    priv->frame_thread_pool = NULL;
+
+    if (n_threads > 0)
+      priv->frame_thread_pool =
+          g_thread_pool_new (gst_video_decoder_frame_thread_func, decoder,
+          n_threads, FALSE, NULL);
+
+    priv->frame_threads = n_threads;
+  }
+  GST_VIDEO_DECODER_STREAM_UNLOCK (decoder);
+}
+
+/**
+ * gst_video_decoder_get_frame_threads:
+ * @decoder: a #GstVideoDecoder
+ *
+ * Returns: the number of frames that can be decoded in parallel, or 0 if
+ *     frame threading is disabled
+ *
+ * Since: 1.18
+ */
+guint
+gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_DECODER (decoder), 0);
+
+  return decoder->priv->frame_threads;
+}
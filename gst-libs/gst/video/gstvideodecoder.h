@@ -163,6 +163,29 @@ G_STMT_START {                                                              \
  */
 #define GST_VIDEO_DECODER_MAX_ERRORS     10
 
+/**
+ * GstVideoDecoderQosSkipMode:
+ * @GST_VIDEO_DECODER_QOS_SKIP_NONE: only drop decoded frames that are late
+ * @GST_VIDEO_DECODER_QOS_SKIP_NON_REF: flag frames that are predicted to be
+ *   late with %GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF so that the subclass
+ *   skips decoding them if no other frame depends on them
+ * @GST_VIDEO_DECODER_QOS_SKIP_KEYFRAME: like
+ *   %GST_VIDEO_DECODER_QOS_SKIP_NON_REF, and once frames are late before
+ *   decoding even started, drop all input until the next keyframe that can
+ *   be decoded in time
+ *
+ * How the decoder avoids decoding frames that are going to be late,
+ * predicted from the QoS events received and the time decoding the previous
+ * frames took.
+ *
+ * Since: 1.18
+ */
+typedef enum {
+  GST_VIDEO_DECODER_QOS_SKIP_NONE,
+  GST_VIDEO_DECODER_QOS_SKIP_NON_REF,
+  GST_VIDEO_DECODER_QOS_SKIP_KEYFRAME
+} GstVideoDecoderQosSkipMode;
+
 
 /**
  * GstVideoDecoder:
@@ -477,6 +500,13 @@ GST_VIDEO_API
 void             gst_video_decoder_set_use_default_pad_acceptcaps (GstVideoDecoder * decoder,
                                                                    gboolean use);
 
+GST_VIDEO_API
+void             gst_video_decoder_set_frame_threads (GstVideoDecoder * decoder,
+                                                      guint n_threads);
+
+GST_VIDEO_API
+guint            gst_video_decoder_get_frame_threads (GstVideoDecoder * decoder);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoDecoder, gst_object_unref)
 
 G_END_DECLS
@@ -141,7 +141,10 @@ struct _GstVideoEncoderPrivate
 
   guint32 system_frame_number;
 
-  GList *frames;                /* Protected with OBJECT_LOCK */
+  GQueue frames;                /* Protected with OBJECT_LOCK */
+  /* system_frame_number -> frame of the frames above */
+  GHashTable *frames_by_number;
+  GstVideoCodecFramePool *frame_pool;
   GstVideoCodecState *input_state;
   GstVideoCodecState *output_state;
   gboolean output_state_changed;
@@ -174,8 +177,38 @@ struct _GstVideoEncoderPrivate
   /* qos messages: frames dropped/processed */
   guint dropped;
   guint processed;
+
+  /* frame threading */
+  guint frame_threads;
+  GThreadPool *frame_thread_pool;
+  /* FrameThreadEntry of dispatched frames in input order, STREAM_LOCK */
+  GQueue frame_thread_queue;
+  GstFlowReturn frame_thread_ret;       /* STREAM_LOCK */
+  gboolean frame_thread_outputting;     /* STREAM_LOCK */
+  GMutex frame_thread_lock;
+  GCond frame_thread_cond;
+  guint frame_threads_busy;     /* frame_thread_lock */
+  /* of the input, for the latency of frame threading */
+  GstClockTime frame_duration;  /* OBJECT_LOCK */
 };
 
+typedef enum
+{
+  FRAME_THREAD_PENDING,
+  FRAME_THREAD_FINISH,
+  FRAME_THREAD_KEPT
+} FrameThreadState;
+
+/* a frame handed to the frame thread pool, waiting for its turn to be
+ * output */
+typedef struct
+{
+  GstVideoCodecFrame *frame;
+  FrameThreadState state;
+  /* output buffers of finished subframes, in order */
+  GList *subframes;
+} FrameThreadEntry;
+
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
 struct _ForcedKeyUnitEvent
 {
@@ -224,6 +257,14 @@ static gboolean gst_video_encoder_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 static GstFlowReturn gst_video_encoder_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
+static void gst_video_encoder_wait_frame_threads (GstVideoEncoder * encoder,
+    guint max_busy);
+static gboolean gst_video_encoder_defer_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, gboolean subframe);
+static GstFlowReturn gst_video_encoder_dispatch_frame (GstVideoEncoder *
+    encoder, GstVideoCodecFrame * frame);
+static GstClockTime gst_video_encoder_get_frame_thread_latency (GstVideoEncoder
+    * encoder);
 static GstStateChangeReturn gst_video_encoder_change_state (GstElement *
     element, GstStateChange transition);
 static gboolean gst_video_encoder_sink_query (GstPad * pad, GstObject * parent,
@@ -410,6 +451,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   GST_OBJECT_UNLOCK (encoder);
 
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
+  priv->frame_thread_ret = GST_FLOW_OK;
 
   if (hard) {
     gst_segment_init (&encoder->input_segment, GST_FORMAT_TIME);
@@ -418,6 +460,9 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
     if (priv->input_state)
       gst_video_codec_state_unref (priv->input_state);
     priv->input_state = NULL;
+    GST_OBJECT_LOCK (encoder);
+    priv->frame_duration = GST_CLOCK_TIME_NONE;
+    GST_OBJECT_UNLOCK (encoder);
     if (priv->output_state)
       gst_video_codec_state_unref (priv->output_state);
     priv->output_state = NULL;
@@ -457,7 +502,7 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
   } else {
     GList *l;
 
-    for (l = priv->frames; l; l = l->next) {
+    for (l = priv->frames.head; l; l = l->next) {
       GstVideoCodecFrame *frame = l->data;
 
       frame->events = _flush_events (encoder->srcpad, frame->events);
@@ -466,9 +511,9 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
         encoder->priv->current_frame_events);
   }
 
-  g_list_foreach (priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
-  g_list_free (priv->frames);
-  priv->frames = NULL;
+  g_hash_table_remove_all (priv->frames_by_number);
+  g_queue_foreach (&priv->frames, (GFunc) gst_video_codec_frame_unref, NULL);
+  g_queue_clear (&priv->frames);
 
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -537,6 +582,14 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   priv->min_pts = GST_CLOCK_TIME_NONE;
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  g_queue_init (&priv->frames);
+  priv->frames_by_number = g_hash_table_new (NULL, NULL);
+  priv->frame_pool = _gst_video_codec_frame_pool_new ();
+
+  g_queue_init (&priv->frame_thread_queue);
+  g_mutex_init (&priv->frame_thread_lock);
+  g_cond_init (&priv->frame_thread_cond);
+
   gst_video_encoder_reset (encoder, TRUE);
 }
 
@@ -674,6 +727,14 @@ gst_video_encoder_setcaps (GstVideoEncoder * encoder, GstCaps * caps)
     if (encoder->priv->input_state)
       gst_video_codec_state_unref (encoder->priv->input_state);
     encoder->priv->input_state = state;
+
+    GST_OBJECT_LOCK (encoder);
+    if (state->info.fps_n > 0 && state->info.fps_d > 0)
+      encoder->priv->frame_duration = gst_util_uint64_scale (GST_SECOND,
+          state->info.fps_d, state->info.fps_n);
+    else
+      encoder->priv->frame_duration = GST_CLOCK_TIME_NONE;
+    GST_OBJECT_UNLOCK (encoder);
   } else {
     gst_video_codec_state_unref (state);
   }
@@ -915,6 +976,15 @@ gst_video_encoder_finalize (GObject * object)
   encoder = GST_VIDEO_ENCODER (object);
   g_rec_mutex_clear (&encoder->stream_lock);
 
+  if (encoder->priv->frame_thread_pool)
+    g_thread_pool_free (encoder->priv->frame_thread_pool, FALSE, TRUE);
+  g_mutex_clear (&encoder->priv->frame_thread_lock);
+  g_cond_clear (&encoder->priv->frame_thread_cond);
+
+  g_hash_table_unref (encoder->priv->frames_by_number);
+  /* frames still referenced elsewhere keep the pool alive */
+  _gst_video_codec_frame_pool_unref (encoder->priv->frame_pool);
+
   if (encoder->priv->allocator) {
     gst_object_unref (encoder->priv->allocator);
     encoder->priv->allocator = NULL;
@@ -1214,6 +1284,10 @@ gst_video_encoder_sink_event (GstPad * pad, GstObject * parent,
   GST_DEBUG_OBJECT (enc, "received event %d, %s", GST_EVENT_TYPE (event),
       GST_EVENT_TYPE_NAME (event));
 
+  /* serialized events apply after all frames received so far */
+  if (enc->priv->frame_thread_pool && GST_EVENT_IS_SERIALIZED (event))
+    gst_video_encoder_wait_frame_threads (enc, 0);
+
   if (klass->sink_event)
     ret = klass->sink_event (enc, event);
 
@@ -1366,6 +1440,8 @@ gst_video_encoder_src_query_default (GstVideoEncoder * enc, GstQuery * query)
           max_latency = GST_CLOCK_TIME_NONE;
         else
           max_latency += enc->priv->max_latency;
+        /* frames wait for the ones in flight before them to be output */
+        min_latency += gst_video_encoder_get_frame_thread_latency (enc);
         GST_OBJECT_UNLOCK (enc);
 
         gst_query_set_latency (query, live, min_latency, max_latency);
@@ -1408,9 +1484,7 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   GstVideoEncoderPrivate *priv = encoder->priv;
   GstVideoCodecFrame *frame;
 
-  frame = g_slice_new0 (GstVideoCodecFrame);
-
-  frame->ref_count = 1;
+  frame = _gst_video_codec_frame_pool_acquire (priv->frame_pool);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
   frame->system_frame_number = priv->system_frame_number;
@@ -1452,6 +1526,12 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   if (!encoder->priv->input_state)
     goto not_negotiated;
 
+  /* keep up to two frames per thread in flight, so that workers don't run
+   * dry while the output of the oldest frame is pending */
+  if (priv->frame_thread_pool)
+    gst_video_encoder_wait_frame_threads (encoder,
+        2 * priv->frame_threads - 1);
+
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
   pts = GST_BUFFER_PTS (buf);
@@ -1542,7 +1622,9 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GST_OBJECT_UNLOCK (encoder);
 
   gst_video_codec_frame_ref (frame);
-  priv->frames = g_list_append (priv->frames, frame);
+  g_queue_push_tail (&priv->frames, frame);
+  g_hash_table_insert (priv->frames_by_number,
+      GUINT_TO_POINTER (frame->system_frame_number), frame);
 
   /* new data, more finish needed */
   priv->drained = FALSE;
@@ -1554,7 +1636,10 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       gst_segment_to_running_time (&encoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
-  ret = klass->handle_frame (encoder, frame);
+  if (priv->frame_thread_pool)
+    ret = gst_video_encoder_dispatch_frame (encoder, frame);
+  else
+    ret = klass->handle_frame (encoder, frame);
 
 done:
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
@@ -1606,6 +1691,9 @@ gst_video_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      /* the pads are flushing now, so the last frames complete quickly */
+      gst_video_encoder_wait_frame_threads (encoder, 0);
+
       if (encoder_class->stop)
         stopped = encoder_class->stop (encoder);
 
@@ -1760,7 +1848,7 @@ gst_video_encoder_negotiate_default (GstVideoEncoder * encoder)
 
   /* Push all pending pre-caps events of the oldest frame before
    * setting caps */
-  frame = encoder->priv->frames ? encoder->priv->frames->data : NULL;
+  frame = encoder->priv->frames.head ? encoder->priv->frames.head->data : NULL;
   if (frame || encoder->priv->current_frame_events) {
     GList **events, *l;
 
@@ -1982,13 +2070,14 @@ static void
 gst_video_encoder_release_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
 {
-  GList *link;
-
   /* unref once from the list */
-  link = g_list_find (enc->priv->frames, frame);
-  if (link) {
+  if (g_hash_table_lookup (enc->priv->frames_by_number,
+          GUINT_TO_POINTER (frame->system_frame_number)) == frame) {
+    g_hash_table_remove (enc->priv->frames_by_number,
+        GUINT_TO_POINTER (frame->system_frame_number));
+    /* frames are usually released oldest first, so this is quick */
+    g_queue_remove (&enc->priv->frames, frame);
     gst_video_codec_frame_unref (frame);
-    enc->priv->frames = g_list_delete_link (enc->priv->frames, link);
   }
   /* unref because this function takes ownership */
   gst_video_codec_frame_unref (frame);
@@ -2123,7 +2212,7 @@ gst_video_encoder_push_pending_unlocked (GstVideoEncoder * encoder,
   GList *l;
 
   /* Push all pending events that arrived before this frame */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (tmp->events) {
@@ -2155,7 +2244,7 @@ gst_video_encoder_infer_dts_unlocked (GstVideoEncoder * encoder,
   gboolean seen_none = FALSE;
 
   /* some maintenance regardless */
-  for (l = priv->frames; l; l = l->next) {
+  for (l = priv->frames.head; l; l = l->next) {
     GstVideoCodecFrame *tmp = l->data;
 
     if (!GST_CLOCK_TIME_IS_VALID (tmp->abidata.ABI.ts)) {
@@ -2352,6 +2441,12 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
+  if (gst_video_encoder_defer_frame (encoder, frame, FALSE)) {
+    ret = priv->frame_thread_ret;
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return ret;
+  }
+
   ret = gst_video_encoder_can_push_unlocked (encoder);
   if (ret != GST_FLOW_OK)
     goto done;
@@ -2499,6 +2594,12 @@ gst_video_encoder_finish_subframe (GstVideoEncoder * encoder,
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
+  if (gst_video_encoder_defer_frame (encoder, frame, TRUE)) {
+    ret = priv->frame_thread_ret;
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return ret;
+  }
+
   ret = gst_video_encoder_can_push_unlocked (encoder);
   if (ret != GST_FLOW_OK)
     goto done;
@@ -2567,6 +2668,189 @@ done:
   return ret;
 }
 
+/* Frame threading
+ *
+ * With frame threads enabled, chain() hands the frames to a thread pool
+ * instead of calling handle_frame() itself, and records them in
+ * frame_thread_queue in input order.  finish_subframe() and finish_frame() on
+ * a queued frame only record what to push; the actual output happens in
+ * queue order as soon as all older frames are done, from whichever worker
+ * completes the oldest frame.  Force-key-unit handling, header insertion and
+ * DTS inference thus still see the frames in order.
+ *
+ * Workers run handle_frame() without the stream lock, so anything waiting for
+ * them, like serialized events and the streaming thread for room in the
+ * queue, does so before taking the stream lock. */
+
+static void
+gst_video_encoder_wait_frame_threads (GstVideoEncoder * encoder,
+    guint max_busy)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  while (priv->frame_threads_busy > max_busy)
+    g_cond_wait (&priv->frame_thread_cond, &priv->frame_thread_lock);
+  g_mutex_unlock (&priv->frame_thread_lock);
+}
+
+/* with STREAM_LOCK */
+static gboolean
+gst_video_encoder_defer_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame, gboolean subframe)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GList *l;
+
+  if (priv->frame_thread_outputting)
+    return FALSE;
+
+  for (l = priv->frame_thread_queue.head; l; l = l->next) {
+    FrameThreadEntry *entry = l->data;
+
+    if (entry->frame != frame || entry->state != FRAME_THREAD_PENDING)
+      continue;
+
+    if (subframe) {
+      GST_LOG_OBJECT (encoder, "deferring output of subframe %u of frame %p "
+          "(sfn:%d)", g_list_length (entry->subframes), frame,
+          frame->system_frame_number);
+      entry->subframes = g_list_append (entry->subframes,
+          frame->output_buffer);
+      frame->output_buffer = NULL;
+    } else {
+      GST_LOG_OBJECT (encoder, "deferring output of frame %p (sfn:%d)", frame,
+          frame->system_frame_number);
+      entry->state = FRAME_THREAD_FINISH;
+    }
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* with STREAM_LOCK */
+static void
+gst_video_encoder_output_threaded_frames (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameThreadEntry *entry;
+
+  priv->frame_thread_outputting = TRUE;
+
+  while ((entry = g_queue_peek_head (&priv->frame_thread_queue))
+      && entry->state != FRAME_THREAD_PENDING) {
+    GstFlowReturn ret = GST_FLOW_OK;
+
+    g_queue_pop_head (&priv->frame_thread_queue);
+
+    if (entry->subframes) {
+      GstBuffer *output_buffer = entry->frame->output_buffer;
+      GList *l;
+
+      for (l = entry->subframes; l; l = l->next) {
+        GstFlowReturn sub_ret;
+
+        entry->frame->output_buffer = l->data;
+        sub_ret = gst_video_encoder_finish_subframe (encoder, entry->frame);
+        if (sub_ret != GST_FLOW_OK && ret == GST_FLOW_OK)
+          ret = sub_ret;
+      }
+      g_list_free (entry->subframes);
+      entry->frame->output_buffer = output_buffer;
+    }
+
+    if (entry->state == FRAME_THREAD_FINISH) {
+      GstFlowReturn finish_ret;
+
+      finish_ret = gst_video_encoder_finish_frame (encoder, entry->frame);
+      if (ret == GST_FLOW_OK)
+        ret = finish_ret;
+    }
+    /* otherwise still owned by the subclass, output whenever it's done */
+
+    if (ret != GST_FLOW_OK && priv->frame_thread_ret == GST_FLOW_OK)
+      priv->frame_thread_ret = ret;
+
+    g_slice_free (FrameThreadEntry, entry);
+  }
+
+  priv->frame_thread_outputting = FALSE;
+}
+
+static void
+gst_video_encoder_frame_thread_func (gpointer data, gpointer user_data)
+{
+  FrameThreadEntry *entry = data;
+  GstVideoEncoder *encoder = user_data;
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstVideoEncoderClass *encoder_class = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (encoder, "handling frame %p (sfn:%d)", entry->frame,
+      entry->frame->system_frame_number);
+
+  ret = encoder_class->handle_frame (encoder, entry->frame);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  /* once finished, another worker may already have output and freed it */
+  if (g_queue_find (&priv->frame_thread_queue, entry)
+      && entry->state == FRAME_THREAD_PENDING)
+    entry->state = FRAME_THREAD_KEPT;
+  if (ret != GST_FLOW_OK && priv->frame_thread_ret == GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (encoder, "flow error %s", gst_flow_get_name (ret));
+    priv->frame_thread_ret = ret;
+  }
+  gst_video_encoder_output_threaded_frames (encoder);
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  priv->frame_threads_busy--;
+  g_cond_broadcast (&priv->frame_thread_cond);
+  g_mutex_unlock (&priv->frame_thread_lock);
+}
+
+/* with STREAM_LOCK, takes ownership of @frame */
+static GstFlowReturn
+gst_video_encoder_dispatch_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  FrameThreadEntry *entry;
+
+  /* report errors of earlier frames as soon as possible */
+  if (priv->frame_thread_ret != GST_FLOW_OK) {
+    gst_video_encoder_release_frame (encoder, frame);
+    return priv->frame_thread_ret;
+  }
+
+  entry = g_slice_new0 (FrameThreadEntry);
+  entry->frame = frame;
+  entry->state = FRAME_THREAD_PENDING;
+  g_queue_push_tail (&priv->frame_thread_queue, entry);
+
+  g_mutex_lock (&priv->frame_thread_lock);
+  priv->frame_threads_busy++;
+  g_mutex_unlock (&priv->frame_thread_lock);
+
+  g_thread_pool_push (priv->frame_thread_pool, entry, NULL);
+
+  return GST_FLOW_OK;
+}
+
+/* with OBJECT_LOCK */
+static GstClockTime
+gst_video_encoder_get_frame_thread_latency (GstVideoEncoder * encoder)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  if (priv->frame_threads <= 1
+      || !GST_CLOCK_TIME_IS_VALID (priv->frame_duration))
+    return 0;
+
+  return (priv->frame_threads - 1) * priv->frame_duration;
+}
+
 /**
  * gst_video_encoder_get_output_state:
  * @encoder: a #GstVideoEncoder
@@ -2707,8 +2991,8 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
   GstVideoCodecFrame *frame = NULL;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  if (encoder->priv->frames)
-    frame = gst_video_codec_frame_ref (encoder->priv->frames->data);
+  if (encoder->priv->frames.head)
+    frame = gst_video_codec_frame_ref (encoder->priv->frames.head->data);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return (GstVideoCodecFrame *) frame;
@@ -2726,20 +3010,15 @@ gst_video_encoder_get_oldest_frame (GstVideoEncoder * encoder)
 GstVideoCodecFrame *
 gst_video_encoder_get_frame (GstVideoEncoder * encoder, int frame_number)
 {
-  GList *g;
-  GstVideoCodecFrame *frame = NULL;
+  GstVideoCodecFrame *frame;
 
   GST_DEBUG_OBJECT (encoder, "frame_number : %d", frame_number);
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  for (g = encoder->priv->frames; g; g = g->next) {
-    GstVideoCodecFrame *tmp = g->data;
-
-    if (tmp->system_frame_number == frame_number) {
-      frame = gst_video_codec_frame_ref (tmp);
-      break;
-    }
-  }
+  frame = g_hash_table_lookup (encoder->priv->frames_by_number,
+      GUINT_TO_POINTER (frame_number));
+  if (frame)
+    gst_video_codec_frame_ref (frame);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
   return frame;
@@ -2759,7 +3038,7 @@ gst_video_encoder_get_frames (GstVideoEncoder * encoder)
   GList *frames;
 
   GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
-  frames = g_list_copy (encoder->priv->frames);
+  frames = g_list_copy (encoder->priv->frames.head);
   g_list_foreach (frames, (GFunc) gst_video_codec_frame_ref, NULL);
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
 
@@ -2937,3 +3216,78 @@ gst_video_encoder_is_qos_enabled (GstVideoEncoder * encoder)
 
   return res;
 }
+
+/**
+ * gst_video_encoder_set_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ * @n_threads: the number of frames that can be encoded in parallel
+ *
+ * Lets the base class call #GstVideoEncoderClass.handle_frame() for up to
+ * @n_threads frames at the same time, from a pool of worker threads, while
+ * the streaming thread keeps receiving input. Encoded data is still output
+ * in input order: gst_video_encoder_finish_subframe() and
+ * gst_video_encoder_finish_frame() on a frame only push it once all the
+ * frames handed to the subclass before it are done. The reported latency
+ * grows by one frame duration per additional thread.
+ *
+ * handle_frame() is then called without the stream lock held and must be
+ * reentrant. This is only suitable for subclasses whose frames can be encoded
+ * independently of each other, for instance intra-only codecs, or that
+ * synchronize the dependencies between frames themselves. Frames should be
+ * finished from handle_frame(); frames kept for later stop being ordered.
+ *
+ * Setting @n_threads to 0 or 1 disables frame threading, which is the
+ * default. This must not be called while the encoder is processing data;
+ * the #GstVideoEncoderClass.start() vfunc is a good place.
+ *
+ * Since: 1.18
+ */
+void
+gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder,
+    guint n_threads)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+
+  if (n_threads <= 1)
+    n_threads = 0;
+
+  gst_video_encoder_wait_frame_threads (encoder, 0);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  if (n_threads != priv->frame_threads) {
+    GST_DEBUG_OBJECT (encoder, "using %u frame threads", n_threads);
+
+    if (priv->frame_thread_pool)
+      g_thread_pool_free (priv->frame_thread_pool, FALSE, TRUE);
+    priv->frame_thread_pool = NULL;
+
+    if (n_threads > 0)
+      priv->frame_thread_pool =
+          g_thread_pool_new (gst_video_encoder_frame_thread_func, encoder,
+          n_threads, FALSE, NULL);
+
+    GST_OBJECT_LOCK (encoder);
+    priv->frame_threads = n_threads;
+    GST_OBJECT_UNLOCK (encoder);
+  }
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+}
+
+/**
+ * gst_video_encoder_get_frame_threads:
+ * @encoder: a #GstVideoEncoder
+ *
+ * Returns: the number of frames that can be encoded in parallel, or 0 if
+ *     frame threading is disabled
+ *
+ * Since: 1.18
+ */
+guint
+gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder)
+{
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), 0);
+
+  return encoder->priv->frame_threads;
+}
@@ -381,6 +381,12 @@ gboolean             gst_video_encoder_is_qos_enabled (GstVideoEncoder * encoder
 GST_VIDEO_API
 GstClockTimeDiff     gst_video_encoder_get_max_encode_time (GstVideoEncoder *encoder, GstVideoCodecFrame * frame);
 
+GST_VIDEO_API
+void                 gst_video_encoder_set_frame_threads (GstVideoEncoder * encoder, guint n_threads);
+
+GST_VIDEO_API
+guint                gst_video_encoder_get_frame_threads (GstVideoEncoder * encoder);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoEncoder, gst_object_unref)
 
 G_END_DECLS
@@ -21,6 +21,7 @@
 #endif
 
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
 
 #include <string.h>
 
@@ -259,6 +260,12 @@ default_unmap (GstVideoMeta * meta, guint plane, GstMapInfo * info)
   return TRUE;
 }
 
+gboolean
+__gst_video_meta_has_default_map (GstVideoMeta * meta)
+{
+  return meta->map == default_map && meta->unmap == default_unmap;
+}
+
 /**
  * gst_buffer_add_video_meta:
  * @buffer: a #GstBuffer
@@ -23,6 +23,17 @@
 #include "gst/video/gstvideometa.h"
 #include "gst/video/gstvideopool.h"
 
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#if defined (HAVE_SYS_SYSCALL_H) && defined (HAVE_LINUX_MEMPOLICY_H)
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
 
 GST_DEBUG_CATEGORY_STATIC (gst_video_pool_debug);
 #define GST_CAT_DEFAULT gst_video_pool_debug
@@ -94,6 +105,49 @@ gst_buffer_pool_config_get_video_alignment (GstStructure * config,
       "stride-align3", G_TYPE_UINT, &align->stride_align[3], NULL);
 }
 
+/**
+ * gst_buffer_pool_config_set_video_numa_node:
+ * @config: a #GstStructure
+ * @node: a NUMA node, or -1
+ *
+ * Bind the system memory of the buffers allocated by the pool to the NUMA
+ * node @node. With -1, the default, the memory is left to the kernel's
+ * allocation policy, which usually places it on the node of the thread that
+ * first writes to it.
+ *
+ * Since: 1.18
+ */
+void
+gst_buffer_pool_config_set_video_numa_node (GstStructure * config, gint node)
+{
+  g_return_if_fail (config != NULL);
+  g_return_if_fail (node >= -1);
+
+  gst_structure_set (config, "numa-node", G_TYPE_INT, node, NULL);
+}
+
+/**
+ * gst_buffer_pool_config_get_video_numa_node:
+ * @config: a #GstStructure
+ * @node: (out): the NUMA node
+ *
+ * Get the NUMA node set with gst_buffer_pool_config_set_video_numa_node()
+ * from the bufferpool configuration @config in @node.
+ *
+ * Returns: %TRUE if @config contains a NUMA node.
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_buffer_pool_config_get_video_numa_node (GstStructure * config,
+    gint * node)
+{
+  g_return_val_if_fail (config != NULL, FALSE);
+  g_return_val_if_fail (node != NULL, FALSE);
+
+  return gst_structure_get_int (config, "numa-node", node);
+}
+
 /* bufferpool */
 struct _GstVideoBufferPoolPrivate
 {
@@ -103,6 +157,10 @@ struct _GstVideoBufferPoolPrivate
   gboolean need_alignment;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  gboolean prefault;
+  gboolean huge_pages;
+  gint numa_node;
 };
 
 static void gst_video_buffer_pool_finalize (GObject * object);
@@ -115,7 +173,9 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT,
+    GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES, NULL
   };
   return options;
 }
@@ -196,6 +256,13 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
       gst_buffer_pool_config_set_allocator (config, allocator, &priv->params);
     }
   }
+  priv->prefault = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  priv->huge_pages = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  if (!gst_buffer_pool_config_get_video_numa_node (config, &priv->numa_node))
+    priv->numa_node = -1;
+
   info.size = MAX (size, info.size);
   priv->info = info;
 
@@ -235,6 +302,67 @@ failed_to_align:
   }
 }
 
+/* applies the memory placement options to the system memory of @buffer */
+static void
+video_buffer_pool_prepare_memory (GstVideoBufferPool * vpool,
+    GstBuffer * buffer)
+{
+  GstVideoBufferPoolPrivate *priv = vpool->priv;
+  gsize page_size = 4096;
+  guint i, n;
+
+#if defined (HAVE_UNISTD_H) && defined (_SC_PAGESIZE)
+  page_size = sysconf (_SC_PAGESIZE);
+#endif
+
+  n = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+    GstMapInfo map;
+    guint8 *start, *end;
+
+    if (!gst_memory_is_type (mem, GST_ALLOCATOR_SYSMEM))
+      continue;
+
+    if (!gst_memory_map (mem, &map, GST_MAP_WRITE))
+      continue;
+
+    /* the pages fully covered by the memory */
+    start = (guint8 *) GST_ROUND_UP_N ((guintptr) map.data, page_size);
+    end = (guint8 *) GST_ROUND_DOWN_N ((guintptr) map.data + map.size,
+        page_size);
+
+    if (start < end) {
+#if defined (HAVE_MADVISE) && defined (MADV_HUGEPAGE)
+      if (priv->huge_pages && madvise (start, end - start, MADV_HUGEPAGE) < 0)
+        GST_DEBUG_OBJECT (vpool, "could not enable huge pages");
+#endif
+
+#if defined (HAVE_LINUX_MEMPOLICY_H) && defined (SYS_mbind)
+      if (priv->numa_node >= 0 && priv->numa_node < 64) {
+        unsigned long nodemask = 1UL << priv->numa_node;
+
+        if (syscall (SYS_mbind, start, (unsigned long) (end - start),
+                MPOL_BIND, &nodemask, (unsigned long) 64, MPOL_MF_MOVE) < 0)
+          GST_DEBUG_OBJECT (vpool, "could not bind memory to NUMA node %d",
+              priv->numa_node);
+      }
+#endif
+    }
+
+    if (priv->prefault) {
+      volatile guint8 *p;
+
+      for (p = map.data; p < map.data + map.size; p += page_size)
+        *p = 0;
+      if (map.size > 0)
+        map.data[map.size - 1] = 0;
+    }
+
+    gst_memory_unmap (mem, &map);
+  }
+}
+
 static GstFlowReturn
 video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
@@ -252,6 +380,9 @@ video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
   if (*buffer == NULL)
     goto no_memory;
 
+  if (priv->prefault || priv->huge_pages || priv->numa_node >= 0)
+    video_buffer_pool_prepare_memory (vpool, *buffer);
+
   if (priv->add_videometa) {
     GST_DEBUG_OBJECT (pool, "adding GstVideoMeta");
 
@@ -312,6 +443,7 @@ static void
 gst_video_buffer_pool_init (GstVideoBufferPool * pool)
 {
   pool->priv = gst_video_buffer_pool_get_instance_private (pool);
+  pool->priv->numa_node = -1;
 }
 
 static void
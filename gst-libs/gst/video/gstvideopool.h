@@ -45,6 +45,27 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT:
+ *
+ * A bufferpool option to touch every page of system memory buffers when they
+ * are allocated, so that the page faults happen while the pool is activated
+ * instead of while the first frames are produced.
+ *
+ * Since: 1.18
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT "GstBufferPoolOptionVideoPrefault"
+
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES:
+ *
+ * A bufferpool option to ask for system memory buffers to be backed by
+ * transparent huge pages where the platform supports it.
+ *
+ * Since: 1.18
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES "GstBufferPoolOptionVideoHugePages"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
@@ -53,6 +74,12 @@ void             gst_buffer_pool_config_set_video_alignment  (GstStructure *conf
 GST_VIDEO_API
 gboolean         gst_buffer_pool_config_get_video_alignment  (GstStructure *config, GstVideoAlignment *align);
 
+GST_VIDEO_API
+void             gst_buffer_pool_config_set_video_numa_node  (GstStructure *config, gint node);
+
+GST_VIDEO_API
+gboolean         gst_buffer_pool_config_get_video_numa_node  (GstStructure *config, gint *node);
+
 /* video bufferpool */
 typedef struct _GstVideoBufferPool GstVideoBufferPool;
 typedef struct _GstVideoBufferPoolClass GstVideoBufferPoolClass;
@@ -36,17 +36,26 @@
 #endif
 
 #include "gstvideosink.h"
+#include "navigation.h"
 
 enum
 {
-  PROP_SHOW_PREROLL_FRAME = 1
+  PROP_SHOW_PREROLL_FRAME = 1,
+  PROP_MOTION_COALESCE_WINDOW
 };
 
 #define DEFAULT_SHOW_PREROLL_FRAME TRUE
+#define DEFAULT_MOTION_COALESCE_WINDOW 0
 
 struct _GstVideoSinkPrivate
 {
   gboolean show_preroll_frame;  /* ATOMIC */
+
+  /* mouse-move coalescing, OBJECT_LOCK */
+  GstClockTime motion_window;
+  gboolean motion_pending;
+  gdouble motion_x, motion_y;
+  gint64 last_motion_time;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GstVideoSink, gst_video_sink, GST_TYPE_BASE_SINK);
@@ -148,6 +157,7 @@ gst_video_sink_init (GstVideoSink * videosink)
   gst_base_sink_set_qos_enabled (GST_BASE_SINK (videosink), TRUE);
 
   videosink->priv = gst_video_sink_get_instance_private (videosink);
+  videosink->priv->motion_window = DEFAULT_MOTION_COALESCE_WINDOW;
 }
 
 static void
@@ -173,6 +183,24 @@ gst_video_sink_class_init (GstVideoSinkClass * klass)
           DEFAULT_SHOW_PREROLL_FRAME,
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoSink:motion-coalesce-window:
+   *
+   * Minimum time in nanoseconds between two "mouse-move" navigation events
+   * of sinks reporting pointer motion with gst_video_sink_send_mouse_move().
+   * Pointer motion inside the window only updates the position that is sent
+   * next, either with a later motion, on gst_video_sink_flush_mouse_move()
+   * or before the sink's next button or key event. With 0, every position
+   * is sent right away.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MOTION_COALESCE_WINDOW,
+      g_param_spec_uint64 ("motion-coalesce-window", "Motion coalesce window",
+          "Minimum time between two mouse-move events (0 = no limit)",
+          0, G_MAXUINT64, DEFAULT_MOTION_COALESCE_WINDOW,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   basesink_class->render = GST_DEBUG_FUNCPTR (gst_video_sink_show_frame);
   basesink_class->preroll =
       GST_DEBUG_FUNCPTR (gst_video_sink_show_preroll_frame);
@@ -242,6 +270,11 @@ gst_video_sink_set_property (GObject * object, guint prop_id,
       g_atomic_int_set (&vsink->priv->show_preroll_frame,
           g_value_get_boolean (value));
       break;
+    case PROP_MOTION_COALESCE_WINDOW:
+      GST_OBJECT_LOCK (vsink);
+      vsink->priv->motion_window = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (vsink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -261,8 +294,94 @@ gst_video_sink_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value,
           g_atomic_int_get (&vsink->priv->show_preroll_frame));
       break;
+    case PROP_MOTION_COALESCE_WINDOW:
+      GST_OBJECT_LOCK (vsink);
+      g_value_set_uint64 (value, vsink->priv->motion_window);
+      GST_OBJECT_UNLOCK (vsink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
   }
 }
+
+/**
+ * gst_video_sink_flush_mouse_move:
+ * @sink: a #GstVideoSink implementing #GstNavigation
+ * @force: send the pending position even inside the coalescing window
+ *
+ * Sends the pointer position held back by the
+ * #GstVideoSink:motion-coalesce-window as a "mouse-move" navigation event,
+ * if the previous one was sent at least the window ago or @force is %TRUE.
+ *
+ * Sinks call this with @force before sending other navigation events, so
+ * that the order of the events is kept, and regularly without @force, so
+ * that the last position goes out when the pointer stops moving.
+ *
+ * Must be called without any lock of @sink held.
+ *
+ * Since: 1.18
+ */
+void
+gst_video_sink_flush_mouse_move (GstVideoSink * sink, gboolean force)
+{
+  GstVideoSinkPrivate *priv;
+  gdouble x, y;
+  gint64 now;
+
+  g_return_if_fail (GST_IS_VIDEO_SINK (sink));
+  g_return_if_fail (GST_IS_NAVIGATION (sink));
+
+  priv = sink->priv;
+
+  GST_OBJECT_LOCK (sink);
+  if (!priv->motion_pending) {
+    GST_OBJECT_UNLOCK (sink);
+    return;
+  }
+
+  now = g_get_monotonic_time ();
+  if (!force && priv->motion_window > 0 &&
+      (now - priv->last_motion_time) * GST_USECOND < priv->motion_window) {
+    GST_OBJECT_UNLOCK (sink);
+    return;
+  }
+
+  priv->motion_pending = FALSE;
+  priv->last_motion_time = now;
+  x = priv->motion_x;
+  y = priv->motion_y;
+  GST_OBJECT_UNLOCK (sink);
+
+  GST_DEBUG_OBJECT (sink, "pointer moved over window at %g,%g", x, y);
+  gst_navigation_send_mouse_event (GST_NAVIGATION (sink), "mouse-move", 0,
+      x, y);
+}
+
+/**
+ * gst_video_sink_send_mouse_move:
+ * @sink: a #GstVideoSink implementing #GstNavigation
+ * @x: the pointer x position
+ * @y: the pointer y position
+ *
+ * Sends a "mouse-move" navigation event for a pointer motion on the sink's
+ * window, or only updates the position that is sent next if the previous
+ * one was sent less than the #GstVideoSink:motion-coalesce-window ago.
+ *
+ * Must be called without any lock of @sink held.
+ *
+ * Since: 1.18
+ */
+void
+gst_video_sink_send_mouse_move (GstVideoSink * sink, gdouble x, gdouble y)
+{
+  g_return_if_fail (GST_IS_VIDEO_SINK (sink));
+
+  GST_OBJECT_LOCK (sink);
+  sink->priv->motion_x = x;
+  sink->priv->motion_y = y;
+  sink->priv->motion_pending = TRUE;
+  GST_OBJECT_UNLOCK (sink);
+
+  gst_video_sink_flush_mouse_move (sink, FALSE);
+}
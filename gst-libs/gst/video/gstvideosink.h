@@ -128,6 +128,12 @@ GST_VIDEO_API
 void gst_video_sink_center_rect (GstVideoRectangle src, GstVideoRectangle dst,
                                  GstVideoRectangle *result, gboolean scaling);
 
+GST_VIDEO_API
+void gst_video_sink_send_mouse_move (GstVideoSink *sink, gdouble x, gdouble y);
+
+GST_VIDEO_API
+void gst_video_sink_flush_mouse_move (GstVideoSink *sink, gboolean force);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstVideoSink, gst_object_unref)
 
 G_END_DECLS
@@ -53,6 +53,46 @@ G_DEFINE_BOXED_TYPE_WITH_CODE (GstVideoTimeCode, gst_video_time_code,
     (GBoxedCopyFunc) gst_video_time_code_copy,
     (GBoxedFreeFunc) gst_video_time_code_free, _init (g_define_type_id));
 
+/* Frame counts of a (valid) time code configuration, computed with integer
+ * operations only so they are cheap enough to be derived for every frame */
+typedef struct
+{
+  /* nominal frames per second, minute and hour. ff_minutes and ff_hours are
+   * the truncated real frame counts, as used by the drop-frame formulas */
+  guint ff_nom;
+  guint ff_minutes;
+  guint ff_hours;
+  /* frames dropped at the start of every minute except every tenth minute,
+   * or 0 for non-drop-frame time codes */
+  guint dropframe_multiplier;
+} GstVideoTimeCodeRate;
+
+static inline void
+gst_video_time_code_get_rate (const GstVideoTimeCode * tc,
+    GstVideoTimeCodeRate * rate)
+{
+  guint fps_n = tc->config.fps_n;
+  guint fps_d = tc->config.fps_d;
+
+  if (fps_d == 1001)
+    rate->ff_nom = fps_n / 1000;
+  else
+    rate->ff_nom = fps_n / fps_d;
+
+  if (tc->config.flags & GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME) {
+    rate->ff_minutes = ((guint64) 60 * fps_n) / fps_d;
+    rate->ff_hours = ((guint64) 3600 * fps_n) / fps_d;
+    /* for 30000/1001 we drop the first 2 frames per minute, for 60000/1001 we
+     * drop the first 4 : so we use this number. The framerate was already
+     * checked by gst_video_time_code_is_valid() */
+    rate->dropframe_multiplier = fps_n == 60000 ? 4 : 2;
+  } else {
+    rate->ff_minutes = 60 * rate->ff_nom;
+    rate->ff_hours = 3600 * rate->ff_nom;
+    rate->dropframe_multiplier = 0;
+  }
+}
+
 /**
  * gst_video_time_code_is_valid:
  * @tc: #GstVideoTimeCode to check
@@ -148,9 +188,29 @@ gst_video_time_code_to_string (const GstVideoTimeCode * tc)
   else
     sep = top_dot_present ? ':' : '.';
 
-  ret =
-      g_strdup_printf ("%02d:%02d:%02d%c%02d", tc->hours, tc->minutes,
-      tc->seconds, sep, tc->frames);
+  /* the fields of a valid time code have at most two digits, format them
+   * without going through printf, this is called for every frame by
+   * elements that render or log time codes */
+  if (G_LIKELY (tc->hours < 100 && tc->minutes < 100 && tc->seconds < 100
+          && tc->frames < 100)) {
+    ret = g_malloc (12);
+    ret[0] = '0' + tc->hours / 10;
+    ret[1] = '0' + tc->hours % 10;
+    ret[2] = ':';
+    ret[3] = '0' + tc->minutes / 10;
+    ret[4] = '0' + tc->minutes % 10;
+    ret[5] = ':';
+    ret[6] = '0' + tc->seconds / 10;
+    ret[7] = '0' + tc->seconds % 10;
+    ret[8] = sep;
+    ret[9] = '0' + tc->frames / 10;
+    ret[10] = '0' + tc->frames % 10;
+    ret[11] = '\0';
+  } else {
+    ret =
+        g_strdup_printf ("%02d:%02d:%02d%c%02d", tc->hours, tc->minutes,
+        tc->seconds, sep, tc->frames);
+  }
 
   return ret;
 }
@@ -333,44 +393,17 @@ gst_video_time_code_nsec_since_daily_jam (const GstVideoTimeCode * tc)
 guint64
 gst_video_time_code_frames_since_daily_jam (const GstVideoTimeCode * tc)
 {
-  guint ff_nom;
-  gdouble ff;
+  GstVideoTimeCodeRate rate;
 
   g_return_val_if_fail (gst_video_time_code_is_valid (tc), -1);
 
-  gst_util_fraction_to_double (tc->config.fps_n, tc->config.fps_d, &ff);
-  if (tc->config.fps_d == 1001) {
-    ff_nom = tc->config.fps_n / 1000;
-  } else {
-    ff_nom = ff;
-  }
-  if (tc->config.flags & GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME) {
-    /* these need to be truncated to integer: side effect, code looks cleaner
-     * */
-    guint ff_minutes = 60 * ff;
-    guint ff_hours = 3600 * ff;
-    /* for 30000/1001 we drop the first 2 frames per minute, for 60000/1001 we
-     * drop the first 4 : so we use this number */
-    guint dropframe_multiplier;
-
-    if (tc->config.fps_n == 30000) {
-      dropframe_multiplier = 2;
-    } else if (tc->config.fps_n == 60000) {
-      dropframe_multiplier = 4;
-    } else {
-      /* already checked by gst_video_time_code_is_valid() */
-      g_assert_not_reached ();
-    }
-
-    return tc->frames + (ff_nom * tc->seconds) +
-        (ff_minutes * tc->minutes) +
-        dropframe_multiplier * ((gint) (tc->minutes / 10)) +
-        (ff_hours * tc->hours);
-  } else {
-    return tc->frames + (ff_nom * (tc->seconds + (60 * (tc->minutes +
-                    (60 * tc->hours)))));
-  }
+  gst_video_time_code_get_rate (tc, &rate);
 
+  /* dropframe_multiplier is 0 for non-drop-frame time codes */
+  return (guint64) tc->frames + ((guint64) rate.ff_nom * tc->seconds) +
+      ((guint64) rate.ff_minutes * tc->minutes) +
+      rate.dropframe_multiplier * (tc->minutes / 10) +
+      ((guint64) rate.ff_hours * tc->hours);
 }
 
 /**
@@ -403,7 +436,7 @@ gst_video_time_code_add_frames (GstVideoTimeCode * tc, gint64 frames)
   guint64 framecount;
   guint64 h_notmod24;
   guint64 h_new, min_new, sec_new, frames_new;
-  gdouble ff;
+  GstVideoTimeCodeRate rate;
   guint ff_nom;
   /* This allows for better readability than putting G_GUINT64_CONSTANT(60)
    * into a long calculation line */
@@ -413,33 +446,34 @@ gst_video_time_code_add_frames (GstVideoTimeCode * tc, gint64 frames)
 
   g_return_if_fail (gst_video_time_code_is_valid (tc));
 
-  gst_util_fraction_to_double (tc->config.fps_n, tc->config.fps_d, &ff);
-  if (tc->config.fps_d == 1001) {
-    ff_nom = tc->config.fps_n / 1000;
-  } else {
-    ff_nom = ff;
+  gst_video_time_code_get_rate (tc, &rate);
+  ff_nom = rate.ff_nom;
+
+  /* Fast path for the common case of advancing by less than a second
+   * without crossing a minute boundary. The frames dropped in drop-frame
+   * time codes are all at second 0, which can't be reached this way */
+  if (frames >= 0 && frames < ff_nom) {
+    guint f = tc->frames + frames;
+    guint s = tc->seconds;
+
+    if (f >= ff_nom) {
+      f -= ff_nom;
+      s++;
+    }
+    if (s < 60) {
+      tc->seconds = s;
+      tc->frames = f;
+      return;
+    }
   }
 
   if (tc->config.flags & GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME) {
-    /* these need to be truncated to integer: side effect, code looks cleaner
-     * */
-    guint ff_minutes = 60 * ff;
-    guint ff_hours = 3600 * ff;
+    guint ff_minutes = rate.ff_minutes;
+    guint ff_hours = rate.ff_hours;
     /* a bunch of intermediate variables, to avoid monster code with possible
      * integer overflows */
     guint64 min_new_tmp1, min_new_tmp2, min_new_tmp3, min_new_denom;
-    /* for 30000/1001 we drop the first 2 frames per minute, for 60000/1001 we
-     * drop the first 4 : so we use this number */
-    guint dropframe_multiplier;
-
-    if (tc->config.fps_n == 30000) {
-      dropframe_multiplier = 2;
-    } else if (tc->config.fps_n == 60000) {
-      dropframe_multiplier = 4;
-    } else {
-      /* already checked by gst_video_time_code_is_valid() */
-      g_assert_not_reached ();
-    }
+    guint dropframe_multiplier = rate.dropframe_multiplier;
 
     framecount =
         frames + tc->frames + (ff_nom * tc->seconds) +
@@ -524,16 +558,18 @@ gst_video_time_code_compare (const GstVideoTimeCode * tc1,
       || tc2->config.latest_daily_jam == NULL) {
     guint64 nsec1, nsec2;
 #ifndef GST_DISABLE_GST_DEBUG
-    gchar *str1, *str2;
-
-    str1 = gst_video_time_code_to_string (tc1);
-    str2 = gst_video_time_code_to_string (tc2);
-    GST_INFO
-        ("Comparing time codes %s and %s, but at least one of them has no "
-        "latest daily jam information. Assuming they started together",
-        str1, str2);
-    g_free (str1);
-    g_free (str2);
+    if (G_UNLIKELY (_gst_debug_min >= GST_LEVEL_INFO)) {
+      gchar *str1, *str2;
+
+      str1 = gst_video_time_code_to_string (tc1);
+      str2 = gst_video_time_code_to_string (tc2);
+      GST_INFO
+          ("Comparing time codes %s and %s, but at least one of them has no "
+          "latest daily jam information. Assuming they started together",
+          str1, str2);
+      g_free (str1);
+      g_free (str2);
+    }
 #endif
     if (tc1->hours > tc2->hours) {
       return 1;
@@ -573,6 +609,31 @@ gst_video_time_code_compare (const GstVideoTimeCode * tc1,
     GDateTime *dt1, *dt2;
     gint ret;
 
+    /* Time codes counted from the same daily jam at the same frame rate
+     * compare like their frame counts, no need to build date times */
+    if (tc1->config.fps_n == tc2->config.fps_n
+        && tc1->config.fps_d == tc2->config.fps_d
+        && tc1->config.flags == tc2->config.flags
+        && g_date_time_equal (tc1->config.latest_daily_jam,
+            tc2->config.latest_daily_jam)) {
+      guint64 frames1, frames2;
+
+      frames1 = gst_video_time_code_frames_since_daily_jam (tc1);
+      frames2 = gst_video_time_code_frames_since_daily_jam (tc2);
+      if (frames1 > frames2)
+        return 1;
+      else if (frames1 < frames2)
+        return -1;
+      /* field 1 is half a frame before field 2 */
+      if (tc1->config.flags & GST_VIDEO_TIME_CODE_FLAGS_INTERLACED) {
+        if (tc1->field_count > tc2->field_count)
+          return 1;
+        else if (tc1->field_count < tc2->field_count)
+          return -1;
+      }
+      return 0;
+    }
+
     dt1 = gst_video_time_code_to_date_time (tc1);
     dt2 = gst_video_time_code_to_date_time (tc2);
 
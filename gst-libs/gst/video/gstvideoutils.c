@@ -24,6 +24,7 @@
 
 #include <gst/video/video.h>
 #include "gstvideoutils.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:gstvideoutils
@@ -37,6 +38,94 @@ G_DEFINE_BOXED_TYPE (GstVideoCodecFrame, gst_video_codec_frame,
     (GBoxedCopyFunc) gst_video_codec_frame_ref,
     (GBoxedFreeFunc) gst_video_codec_frame_unref);
 
+/* number of freed frames kept around for reuse by each codec element */
+#define FRAME_POOL_MAX_FREE 16
+
+struct _GstVideoCodecFramePool
+{
+  gint ref_count;
+
+  GMutex lock;
+  /* linked through their user_data */
+  GstVideoCodecFrame *free_frames;
+  guint n_free;
+};
+
+GstVideoCodecFramePool *
+_gst_video_codec_frame_pool_new (void)
+{
+  GstVideoCodecFramePool *pool;
+
+  pool = g_slice_new0 (GstVideoCodecFramePool);
+  pool->ref_count = 1;
+  g_mutex_init (&pool->lock);
+
+  return pool;
+}
+
+void
+_gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame, *next;
+
+  if (!g_atomic_int_dec_and_test (&pool->ref_count))
+    return;
+
+  for (frame = pool->free_frames; frame; frame = next) {
+    next = frame->user_data;
+    g_slice_free (GstVideoCodecFrame, frame);
+  }
+
+  g_mutex_clear (&pool->lock);
+  g_slice_free (GstVideoCodecFramePool, pool);
+}
+
+/* Returns a cleared frame with a refcount of 1, that goes back to @pool when
+ * freed */
+GstVideoCodecFrame *
+_gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool)
+{
+  GstVideoCodecFrame *frame;
+
+  g_mutex_lock (&pool->lock);
+  frame = pool->free_frames;
+  if (frame) {
+    pool->free_frames = frame->user_data;
+    pool->n_free--;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    memset (frame, 0, sizeof (GstVideoCodecFrame));
+  else
+    frame = g_slice_new0 (GstVideoCodecFrame);
+
+  frame->ref_count = 1;
+  g_atomic_int_inc (&pool->ref_count);
+  frame->abidata.ABI.pool = pool;
+
+  return frame;
+}
+
+static void
+_gst_video_codec_frame_pool_release (GstVideoCodecFramePool * pool,
+    GstVideoCodecFrame * frame)
+{
+  g_mutex_lock (&pool->lock);
+  if (pool->n_free < FRAME_POOL_MAX_FREE) {
+    frame->user_data = pool->free_frames;
+    pool->free_frames = frame;
+    pool->n_free++;
+    frame = NULL;
+  }
+  g_mutex_unlock (&pool->lock);
+
+  if (frame)
+    g_slice_free (GstVideoCodecFrame, frame);
+
+  _gst_video_codec_frame_pool_unref (pool);
+}
+
 static void
 _gst_video_codec_frame_free (GstVideoCodecFrame * frame)
 {
@@ -58,7 +147,10 @@ _gst_video_codec_frame_free (GstVideoCodecFrame * frame)
   if (frame->user_data_destroy_notify)
     frame->user_data_destroy_notify (frame->user_data);
 
-  g_slice_free (GstVideoCodecFrame, frame);
+  if (frame->abidata.ABI.pool)
+    _gst_video_codec_frame_pool_release (frame->abidata.ABI.pool, frame);
+  else
+    g_slice_free (GstVideoCodecFrame, frame);
 }
 
 /**
@@ -82,6 +82,9 @@ struct _GstVideoCodecState
  * @GST_VIDEO_CODEC_FRAME_FLAG_SYNC_POINT: is the frame a synchronization point (keyframe)
  * @GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME: should the output frame be made a keyframe
  * @GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS: should the encoder output stream headers
+ * @GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF: the decoder is predicted to be
+ *     late for this frame, skip decoding it if no other frame refers to it
+ *     (Since: 1.18)
  *
  * Flags for #GstVideoCodecFrame
  */
@@ -90,7 +93,8 @@ typedef enum
   GST_VIDEO_CODEC_FRAME_FLAG_DECODE_ONLY            = (1<<0),
   GST_VIDEO_CODEC_FRAME_FLAG_SYNC_POINT             = (1<<1),
   GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME         = (1<<2),
-  GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS = (1<<3)
+  GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS = (1<<3),
+  GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF           = (1<<4)
 } GstVideoCodecFrameFlags;
 
 /**
@@ -199,6 +203,22 @@ typedef enum
 #define GST_VIDEO_CODEC_FRAME_SET_FORCE_KEYFRAME_HEADERS(frame)     (GST_VIDEO_CODEC_FRAME_FLAG_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS))
 #define GST_VIDEO_CODEC_FRAME_UNSET_FORCE_KEYFRAME_HEADERS(frame)   (GST_VIDEO_CODEC_FRAME_FLAG_UNSET(frame, GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS))
 
+/**
+ * GST_VIDEO_CODEC_FRAME_IS_SKIP_NON_REF:
+ * @frame: a #GstVideoCodecFrame
+ *
+ * Tests if the decoder asks for the frame not to be decoded if no other
+ * frame refers to it, because it is predicted to be late. Decoders
+ * skipping it should call gst_video_decoder_drop_frame().
+ *
+ * Applies only to frames provided to decoders.
+ *
+ * Since: 1.18
+ */
+#define GST_VIDEO_CODEC_FRAME_IS_SKIP_NON_REF(frame)      (GST_VIDEO_CODEC_FRAME_FLAG_IS_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF))
+#define GST_VIDEO_CODEC_FRAME_SET_SKIP_NON_REF(frame)     (GST_VIDEO_CODEC_FRAME_FLAG_SET(frame, GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF))
+#define GST_VIDEO_CODEC_FRAME_UNSET_SKIP_NON_REF(frame)   (GST_VIDEO_CODEC_FRAME_FLAG_UNSET(frame, GST_VIDEO_CODEC_FRAME_FLAG_SKIP_NON_REF))
+
 /**
  * GstVideoCodecFrame:
  * @pts: Presentation timestamp
@@ -262,6 +282,7 @@ struct _GstVideoCodecFrame
       GstClockTime ts;
       GstClockTime ts2;
       guint num_subframes;
+      gpointer pool;
     } ABI;
     gpointer padding[GST_PADDING_LARGE];
   } abidata;
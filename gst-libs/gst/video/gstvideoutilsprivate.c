@@ -259,3 +259,163 @@ __gst_video_encoded_video_convert (gint64 bytes, gint64 time,
 exit:
   return res;
 }
+
+/* Parallelized task runner
+ *
+ * All runners share a single, lazily created pool of worker threads instead
+ * of each one spawning its own set of threads. The pool is limited to the
+ * number of processors, or to the value of the
+ * GST_VIDEO_TASK_POOL_MAX_THREADS environment variable if set, no matter how
+ * many runners exist in the process.
+ *
+ * A job consists of runner->n_threads tasks that are handed out through an
+ * atomic counter. The thread calling run() queues helpers for the job in the
+ * shared pool and then starts taking tasks itself, so whichever thread is
+ * free first takes the next task and a job always makes progress even while
+ * the pool is busy with jobs of other runners.
+ */
+typedef struct
+{
+  gint refcount;
+
+  GstParallelizedTaskFunc func;
+  gpointer *task_data;
+  gint n_tasks;
+
+  gint next_task;
+  gint n_pending;
+} GstParallelizedJob;
+
+static GMutex task_pool_lock;
+static GCond task_pool_cond;
+static GThreadPool *task_pool;
+
+static void
+gst_parallelized_job_unref (GstParallelizedJob * job)
+{
+  if (g_atomic_int_dec_and_test (&job->refcount))
+    g_slice_free (GstParallelizedJob, job);
+}
+
+static gboolean
+gst_parallelized_job_run_next (GstParallelizedJob * job)
+{
+  gint idx;
+
+  idx = g_atomic_int_add (&job->next_task, 1);
+  if (idx >= job->n_tasks)
+    return FALSE;
+
+  job->func (job->task_data[idx]);
+
+  if (g_atomic_int_dec_and_test (&job->n_pending)) {
+    g_mutex_lock (&task_pool_lock);
+    g_cond_broadcast (&task_pool_cond);
+    g_mutex_unlock (&task_pool_lock);
+  }
+
+  return TRUE;
+}
+
+static void
+gst_parallelized_task_pool_func (gpointer data, gpointer user_data)
+{
+  GstParallelizedJob *job = data;
+
+  while (gst_parallelized_job_run_next (job));
+
+  gst_parallelized_job_unref (job);
+}
+
+static GThreadPool *
+gst_parallelized_task_pool_get (void)
+{
+  static gsize pool_once = 0;
+
+  if (g_once_init_enter (&pool_once)) {
+    const gchar *env;
+    guint max_threads;
+
+    max_threads = g_get_num_processors ();
+    env = g_getenv ("GST_VIDEO_TASK_POOL_MAX_THREADS");
+    if (env != NULL) {
+      guint64 val = g_ascii_strtoull (env, NULL, 10);
+
+      if (val > 0 && val <= G_MAXINT)
+        max_threads = val;
+    }
+
+    /* The thread calling run() always executes tasks too */
+    if (max_threads > 1) {
+      task_pool = g_thread_pool_new (gst_parallelized_task_pool_func, NULL,
+          max_threads - 1, FALSE, NULL);
+    }
+
+    GST_DEBUG ("using up to %u threads for parallelized tasks", max_threads);
+
+    g_once_init_leave (&pool_once, 1);
+  }
+
+  return task_pool;
+}
+
+GstParallelizedTaskRunner *
+gst_parallelized_task_runner_new (guint n_threads)
+{
+  GstParallelizedTaskRunner *self;
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstParallelizedTaskRunner, 1);
+  self->n_threads = n_threads;
+
+  return self;
+}
+
+void
+gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
+{
+  g_free (self);
+}
+
+void
+gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+    GstParallelizedTaskFunc func, gpointer * task_data)
+{
+  GstParallelizedJob *job;
+  GThreadPool *pool;
+  guint i;
+
+  pool = gst_parallelized_task_pool_get ();
+
+  if (self->n_threads == 1 || pool == NULL) {
+    for (i = 0; i < self->n_threads; i++)
+      func (task_data[i]);
+    return;
+  }
+
+  job = g_slice_new (GstParallelizedJob);
+  job->refcount = 1;
+  job->func = func;
+  job->task_data = task_data;
+  job->n_tasks = self->n_threads;
+  job->next_task = 0;
+  job->n_pending = self->n_threads;
+
+  /* One helper per task beside the one we run ourselves, helpers that find
+   * no task left just return */
+  for (i = 1; i < self->n_threads; i++) {
+    g_atomic_int_inc (&job->refcount);
+    g_thread_pool_push (pool, job, NULL);
+  }
+
+  while (gst_parallelized_job_run_next (job));
+
+  g_mutex_lock (&task_pool_lock);
+  while (g_atomic_int_get (&job->n_pending) > 0)
+    g_cond_wait (&task_pool_cond, &task_pool_lock);
+  g_mutex_unlock (&task_pool_lock);
+
+  gst_parallelized_job_unref (job);
+}
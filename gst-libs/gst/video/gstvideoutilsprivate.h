@@ -46,6 +46,44 @@ gboolean __gst_video_rawvideo_convert (GstVideoCodecState * state, GstFormat src
                                        gint64 src_value, GstFormat * dest_format,
                                        gint64 * dest_value);
 
+/* Whether gst_video_meta_map() of @meta maps the memory of the buffer
+ * directly, so a frame can map the buffer once for all planes */
+G_GNUC_INTERNAL
+gboolean __gst_video_meta_has_default_map (GstVideoMeta * meta);
+
+/* Recycling of codec frames, shared by the video decoder and encoder */
+typedef struct _GstVideoCodecFramePool GstVideoCodecFramePool;
+
+G_GNUC_INTERNAL
+GstVideoCodecFramePool * _gst_video_codec_frame_pool_new (void);
+
+G_GNUC_INTERNAL
+void _gst_video_codec_frame_pool_unref (GstVideoCodecFramePool * pool);
+
+G_GNUC_INTERNAL
+GstVideoCodecFrame * _gst_video_codec_frame_pool_acquire (GstVideoCodecFramePool * pool);
+
+/* Parallelized task execution, shared by the video converter and scaler */
+typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
+
+typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
+
+struct _GstParallelizedTaskRunner
+{
+  guint n_threads;
+};
+
+G_GNUC_INTERNAL
+GstParallelizedTaskRunner * gst_parallelized_task_runner_new (guint n_threads);
+
+G_GNUC_INTERNAL
+void gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self);
+
+G_GNUC_INTERNAL
+void gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
+                                       GstParallelizedTaskFunc func,
+                                       gpointer * task_data);
+
 G_END_DECLS
 
 #endif
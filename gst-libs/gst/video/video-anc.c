@@ -156,7 +156,7 @@ get_ancillary_16 (GstVideoVBIParser * parser, GstVideoAncillary * anc)
     anc->DID = DID;
     anc->SDID_block_number = SDID;
     anc->data_count = DC;
-    memset (anc->data, 0, 256);
+    memset (anc->data + DC, 0, 256 - DC);
 
     /* FIXME: We assume here the same data format for the user data as for the
      * DID/SDID: 10 bits with parity in the upper 2 bits. In theory some
@@ -261,7 +261,7 @@ get_ancillary_8 (GstVideoVBIParser * parser, GstVideoAncillary * anc)
     anc->DID = DID;
     anc->SDID_block_number = SDID;
     anc->data_count = DC;
-    memset (anc->data, 0, 256);
+    memset (anc->data + DC, 0, 256 - DC);
 
     /* i is at the beginning of the user data now */
     for (j = 0; j < anc->data_count; j++)
@@ -564,6 +564,65 @@ gst_video_vbi_parser_add_line (GstVideoVBIParser * parser, const guint8 * data)
   }
 }
 
+/**
+ * gst_video_vbi_parser_add_lines:
+ * @parser: a #GstVideoVBIParser
+ * @data: (array) (transfer none): The first line of data to parse
+ * @stride: distance in bytes between two lines in @data
+ * @n_lines: the number of lines to parse
+ * @ancillaries: (element-type GstVideoAncillary): a #GArray of
+ *     #GstVideoAncillary to store the ancillary data in
+ *
+ * Parse @n_lines lines of data starting at @data and store all ancillary
+ * data found in them in @ancillaries, in the order of the lines. This is
+ * equivalent to calling gst_video_vbi_parser_add_line() and
+ * gst_video_vbi_parser_get_ancillary() for every line, but in one call.
+ *
+ * @ancillaries is cleared first. Reusing the same array for every frame
+ * avoids allocating once its size is large enough. Lines with errors are
+ * skipped.
+ *
+ * Since: 1.18
+ *
+ * Returns: the number of #GstVideoAncillary stored in @ancillaries
+ */
+guint
+gst_video_vbi_parser_add_lines (GstVideoVBIParser * parser,
+    const guint8 * data, gsize stride, guint n_lines, GArray * ancillaries)
+{
+  guint i;
+
+  g_return_val_if_fail (parser != NULL, 0);
+  g_return_val_if_fail (data != NULL || n_lines == 0, 0);
+  g_return_val_if_fail (ancillaries != NULL, 0);
+  g_return_val_if_fail (g_array_get_element_size (ancillaries) ==
+      sizeof (GstVideoAncillary), 0);
+
+  g_array_set_size (ancillaries, 0);
+
+  for (i = 0; i < n_lines; i++) {
+    GstVideoVBIParserResult res;
+
+    gst_video_vbi_parser_add_line (parser, data + i * stride);
+
+    /* Parse straight into the array, the slot is only kept if an
+     * ancillary was found */
+    do {
+      GstVideoAncillary *anc;
+
+      g_array_set_size (ancillaries, ancillaries->len + 1);
+      anc = &g_array_index (ancillaries, GstVideoAncillary,
+          ancillaries->len - 1);
+
+      res = gst_video_vbi_parser_get_ancillary (parser, anc);
+      if (res != GST_VIDEO_VBI_PARSER_RESULT_OK)
+        g_array_set_size (ancillaries, ancillaries->len - 1);
+    } while (res == GST_VIDEO_VBI_PARSER_RESULT_OK);
+  }
+
+  return ancillaries->len;
+}
+
 struct _GstVideoVBIEncoder
 {
   GstVideoInfo info;            /* format of the lines provided */
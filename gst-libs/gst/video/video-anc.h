@@ -477,6 +477,10 @@ void               gst_video_vbi_parser_free (GstVideoVBIParser *parser);
 GST_VIDEO_API
 void		   gst_video_vbi_parser_add_line (GstVideoVBIParser *parser, const guint8 *data);
 
+GST_VIDEO_API
+guint              gst_video_vbi_parser_add_lines (GstVideoVBIParser *parser, const guint8 *data,
+						   gsize stride, guint n_lines, GArray *ancillaries);
+
 /**
  * GstVideoVBIEncoder:
  *
@@ -276,6 +276,91 @@ G_STMT_START { \
 } G_STMT_END
 
 
+/* Formats with 8 bits per component, no alpha and chroma taken from the even
+ * pixels of even lines on packing, which can be blended in place without
+ * going through unpack/pack of the whole destination line */
+static gboolean
+blend_direct_supported (GstVideoFrame * dest)
+{
+  if (GST_VIDEO_INFO_FLAGS (&dest->info) & GST_VIDEO_FLAG_PREMULTIPLIED_ALPHA)
+    return FALSE;
+
+  switch (GST_VIDEO_FRAME_FORMAT (dest)) {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_YV12:
+    case GST_VIDEO_FORMAT_NV12:
+    case GST_VIDEO_FORMAT_NV21:
+    case GST_VIDEO_FORMAT_Y444:
+    case GST_VIDEO_FORMAT_BGRx:
+    case GST_VIDEO_FORMAT_RGBx:
+    case GST_VIDEO_FORMAT_xRGB:
+    case GST_VIDEO_FORMAT_xBGR:
+    case GST_VIDEO_FORMAT_RGB:
+    case GST_VIDEO_FORMAT_BGR:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Blends @n pixels of channel @chan of the unpacked source line @src, taking
+ * every @src_step-th pixel, onto the components at @dest spaced @dest_step
+ * bytes apart. The destination is opaque, which makes the result of the
+ * generic OVER00/OVER10 blend with alphaB == alphaD == 255 */
+static void
+blend_component_direct (guint8 * dest, gint dest_step, const guint8 * src,
+    gint chan, gint src_step, gint n, gint alpha_val, gboolean premultiplied)
+{
+  gint k;
+
+  for (k = 0; k < n; k++, dest += dest_step, src += 4 * src_step) {
+    gint asrc, c;
+
+    asrc = src[0] * alpha_val / 255;
+    if (!asrc)
+      continue;
+
+    if (premultiplied)
+      c = (src[chan] * alpha_val + dest[0] * (255 - asrc)) / 255;
+    else
+      c = (src[chan] * asrc + dest[0] * (255 - asrc)) / 255;
+    dest[0] = MIN (c, 255);
+  }
+}
+
+static void
+blend_line_direct (GstVideoFrame * dest, const guint8 * srcline, gint x,
+    gint y, gint width, gint alpha_val, gboolean premultiplied)
+{
+  const GstVideoFormatInfo *finfo = dest->info.finfo;
+  gint c;
+
+  for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (dest); c++) {
+    gint wsub = GST_VIDEO_FORMAT_INFO_W_SUB (finfo, c);
+    gint hsub = GST_VIDEO_FORMAT_INFO_H_SUB (finfo, c);
+    gint first, n;
+    guint8 *d;
+
+    /* subsampled components only get the pixels of the first line and
+     * column of each block, like the pack functions do */
+    if (((y >> hsub) << hsub) != y)
+      continue;
+
+    first = GST_ROUND_UP_N (x, 1 << wsub);
+    if (first >= x + width)
+      continue;
+    n = (x + width - first + (1 << wsub) - 1) >> wsub;
+
+    d = GST_VIDEO_FRAME_COMP_DATA (dest, c);
+    d += (y >> hsub) * GST_VIDEO_FRAME_COMP_STRIDE (dest, c);
+    d += (first >> wsub) * GST_VIDEO_FRAME_COMP_PSTRIDE (dest, c);
+
+    blend_component_direct (d, GST_VIDEO_FRAME_COMP_PSTRIDE (dest, c),
+        srcline + (first - x) * 4, c + 1, 1 << wsub, n, alpha_val,
+        premultiplied);
+  }
+}
+
 /**
  * gst_video_blend:
  * @dest: The #GstVideoFrame where to blend @src in
@@ -383,6 +468,18 @@ gst_video_blend (GstVideoFrame * dest,
   if (y + src_height > dest_height)
     src_height = dest_height - y;
 
+  if (blend_direct_supported (dest)) {
+    for (i = y; i < y + src_height; i++, src_yoff++) {
+      sinfo->unpack_func (sinfo, 0, tmpsrcline, src->data, src->info.stride,
+          src_xoff, src_yoff, src_width);
+      matrix (tmpsrcline, src_width);
+
+      blend_line_direct (dest, tmpsrcline, x, i, src_width, global_alpha_val,
+          src_premultiplied_alpha);
+    }
+    goto done;
+  }
+
   /* Mainloop doing the needed conversions, and blending */
   for (i = y; i < y + src_height; i++, src_yoff++) {
 
@@ -457,6 +554,7 @@ gst_video_blend (GstVideoFrame * dest,
         dest->data, dest->info.stride, dest->info.chroma_site, i, dest_width);
   }
 
+done:
   g_free (tmpdestline);
   g_free (tmpsrcline);
 
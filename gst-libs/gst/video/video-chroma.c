@@ -127,8 +127,22 @@ struct _GstVideoChromaResample
       gint width);
   void (*v_resample) (GstVideoChromaResample * resample, gpointer lines[],
       gint width);
+  /* copy of the input line for resamplers that can't work in place */
+  gpointer tmpline;
+  gint tmpline_size;
 };
 
+static gpointer
+get_tmpline (GstVideoChromaResample * resample, gint size)
+{
+  if (resample->tmpline_size < size) {
+    g_free (resample->tmpline);
+    resample->tmpline = g_malloc (size);
+    resample->tmpline_size = size;
+  }
+  return resample->tmpline;
+}
+
 #define PR(i)          (p[2 + 4 * (i)])
 #define PB(i)          (p[3 + 4 * (i)])
 
@@ -191,6 +205,24 @@ video_chroma_up_h2_##name (GstVideoChromaResample *resample,            \
   }                                                                     \
 }
 
+/* the ORC version reads the even pixels from a copy of the line so that
+ * each pair of output pixels only depends on the input */
+#define MAKE_UPSAMPLE_H2_ORC(name,type)                                 \
+static void                                                             \
+video_chroma_up_h2_##name (GstVideoChromaResample *resample,            \
+    gpointer pixels, gint width)                                        \
+{                                                                       \
+  type *p = pixels;                                                     \
+  type *t;                                                              \
+                                                                        \
+  if (width < 3)                                                        \
+    return;                                                             \
+                                                                        \
+  t = get_tmpline (resample, width * 4 * sizeof (type));                \
+  memcpy (t, p, width * 4 * sizeof (type));                             \
+  video_orc_chroma_up_h2_##name (p + 4, t + 4, t, (width - 1) / 2);     \
+}
+
 /* 2x vertical upsampling without cositing
  *
  *   O--O--O-  <---- a
@@ -361,7 +393,7 @@ video_chroma_down_vi2_##name (GstVideoChromaResample *resample,         \
 }
 
 MAKE_UPSAMPLE_H2 (u16, guint16);
-MAKE_UPSAMPLE_H2 (u8, guint8);
+MAKE_UPSAMPLE_H2_ORC (u8, guint8);
 MAKE_UPSAMPLE_V2 (u16, guint16);
 MAKE_UPSAMPLE_V2 (u8, guint8);
 MAKE_UPSAMPLE_VI2 (u16, guint16);
@@ -995,6 +1027,8 @@ gst_video_chroma_resample_new (GstVideoChromaMethod method,
   result->v_resample = v_resamplers[v_index].resample;
   result->n_lines = v_resamplers[v_index].n_lines;
   result->offset = v_resamplers[v_index].offset;
+  result->tmpline = NULL;
+  result->tmpline_size = 0;
 
   GST_DEBUG ("resample %p, bits %d, n_lines %u, offset %d", result, bits,
       result->n_lines, result->offset);
@@ -1034,6 +1068,7 @@ gst_video_chroma_resample_free (GstVideoChromaResample * resample)
 {
   g_return_if_fail (resample != NULL);
 
+  g_free (resample->tmpline);
   g_slice_free (GstVideoChromaResample, resample);
 }
 
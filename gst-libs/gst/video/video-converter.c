@@ -22,13 +22,6 @@
 #include "config.h"
 #endif
 
-#if 0
-#ifdef HAVE_PTHREAD
-#define _GNU_SOURCE
-#include <pthread.h>
-#endif
-#endif
-
 #include "video-converter.h"
 
 #include <glib.h>
@@ -36,6 +29,7 @@
 #include <math.h>
 
 #include "video-orc.h"
+#include "gstvideoutilsprivate.h"
 
 /**
  * SECTION:videoconverter
@@ -115,205 +109,13 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedTaskThread GstParallelizedTaskThread;
-
-struct _GstParallelizedTaskThread
-{
-  GstParallelizedTaskRunner *runner;
-  guint idx;
-  GThread *thread;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  guint n_threads;
-
-  GstParallelizedTaskThread *threads;
-
-  GstParallelizedTaskFunc func;
-  gpointer *task_data;
-
-  GMutex lock;
-  GCond cond_todo, cond_done;
-  gint n_todo, n_done;
-  gboolean quit;
-};
-
-static gpointer
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskThread *self = data;
-
-#if 0
-#ifdef HAVE_PTHREAD
-  {
-    pthread_t thread = pthread_self ();
-    cpu_set_t cpuset;
-    int r;
-
-    CPU_ZERO (&cpuset);
-    CPU_SET (self->idx, &cpuset);
-    if ((r = pthread_setaffinity_np (thread, sizeof (cpuset), &cpuset)) != 0)
-      GST_ERROR ("Failed to set thread affinity for thread %d: %s", self->idx,
-          g_strerror (r));
-  }
-#endif
-#endif
-
-  g_mutex_lock (&self->runner->lock);
-  self->runner->n_done++;
-  if (self->runner->n_done == self->runner->n_threads - 1)
-    g_cond_signal (&self->runner->cond_done);
-
-  do {
-    gint idx;
-
-    while (self->runner->n_todo == -1 && !self->runner->quit)
-      g_cond_wait (&self->runner->cond_todo, &self->runner->lock);
-
-    if (self->runner->quit)
-      break;
-
-    idx = self->runner->n_todo--;
-    g_assert (self->runner->n_todo >= -1);
-    g_mutex_unlock (&self->runner->lock);
-
-    g_assert (self->runner->func != NULL);
-
-    self->runner->func (self->runner->task_data[idx]);
-
-    g_mutex_lock (&self->runner->lock);
-    self->runner->n_done++;
-    if (self->runner->n_done == self->runner->n_threads - 1)
-      g_cond_signal (&self->runner->cond_done);
-  } while (TRUE);
-
-  g_mutex_unlock (&self->runner->lock);
-
-  return NULL;
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  guint i;
-
-  g_mutex_lock (&self->lock);
-  self->quit = TRUE;
-  g_cond_broadcast (&self->cond_todo);
-  g_mutex_unlock (&self->lock);
-
-  for (i = 1; i < self->n_threads; i++) {
-    if (!self->threads[i].thread)
-      continue;
-
-    g_thread_join (self->threads[i].thread);
-  }
-
-  g_mutex_clear (&self->lock);
-  g_cond_clear (&self->cond_todo);
-  g_cond_clear (&self->cond_done);
-  g_free (self->threads);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads)
-{
-  GstParallelizedTaskRunner *self;
-  guint i;
-  GError *err = NULL;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-  self->n_threads = n_threads;
-  self->threads = g_new0 (GstParallelizedTaskThread, n_threads);
-
-  self->quit = FALSE;
-  self->n_todo = -1;
-  self->n_done = 0;
-  g_mutex_init (&self->lock);
-  g_cond_init (&self->cond_todo);
-  g_cond_init (&self->cond_done);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-
-  for (i = 0; i < n_threads; i++) {
-    self->threads[i].runner = self;
-    self->threads[i].idx = i;
-
-    /* First thread is the one calling run() */
-    if (i > 0) {
-      self->threads[i].thread =
-          g_thread_try_new ("videoconvert", gst_parallelized_task_thread_func,
-          &self->threads[i], &err);
-      if (!self->threads[i].thread)
-        goto error;
-    }
-  }
-
-  g_mutex_lock (&self->lock);
-  while (self->n_done < self->n_threads - 1)
-    g_cond_wait (&self->cond_done, &self->lock);
-  self->n_done = 0;
-  g_mutex_unlock (&self->lock);
-
-  return self;
-
-error:
-  {
-    GST_ERROR ("Failed to start thread %u: %s", i, err->message);
-    g_clear_error (&err);
-
-    gst_parallelized_task_runner_free (self);
-    return NULL;
-  }
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 2;
-    self->n_done = 0;
-    g_cond_broadcast (&self->cond_todo);
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func (self->task_data[self->n_threads - 1]);
-
-  if (n_threads > 1) {
-    g_mutex_lock (&self->lock);
-    while (self->n_done < self->n_threads - 1)
-      g_cond_wait (&self->cond_done, &self->lock);
-    self->n_done = 0;
-    g_mutex_unlock (&self->lock);
-  }
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
-
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
 #define SCALE_F  ((float) (1 << SCALE))
 
 typedef struct _MatrixData MatrixData;
+typedef struct _Lut3D Lut3D;
 
 struct _MatrixData
 {
@@ -328,9 +130,44 @@ struct _MatrixData
   gint64 *t_g;
   gint64 *t_b;
   gint64 t_c;
+  Lut3D *lut;
   void (*matrix_func) (MatrixData * data, gpointer pixels);
 };
 
+/* everything a 3D LUT is computed from, compared with memcmp () */
+typedef struct
+{
+  gdouble in[4][4];
+  gdouble primaries[4][4];
+  gdouble out[4][4];
+  GstVideoTransferFunction in_func;
+  GstVideoTransferFunction out_func;
+  gint in_scale;
+  gint out_scale;
+  gint bits;
+  guint size;
+} Lut3DKey;
+
+struct _Lut3D
+{
+  Lut3DKey key;
+  gint refcount;
+
+  /* size^3 nodes of 3 components, first component varies slowest */
+  guint16 *table;
+  /* for each input value the node below it and the weight of the node
+   * above it, 0..LUT_ONE */
+  guint16 *index;
+  guint16 *frac;
+};
+
+#define LUT_SHIFT  (12)
+#define LUT_ONE    (1 << LUT_SHIFT)
+#define LUT_MIN_SIZE 2
+#define LUT_MAX_SIZE 65
+/* number of unused LUTs kept around for the next converter */
+#define LUT_CACHE_SIZE 4
+
 typedef struct _GammaData GammaData;
 
 struct _GammaData
@@ -424,6 +261,9 @@ struct _GstVideoConverter
   MatrixData to_RGB_matrix;
   /* gamma decode */
   GammaData gamma_dec;
+  /* points per component of the 3D LUT that replaces the gamma and
+   * primaries conversions, 0 when not used */
+  guint lut_size;
 
   /* scaling */
   GstLineCache **hscale_lines;
@@ -807,6 +647,7 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
 #define DEFAULT_OPT_RESAMPLER_TAPS 0
 #define DEFAULT_OPT_DITHER_METHOD GST_VIDEO_DITHER_BAYER
 #define DEFAULT_OPT_DITHER_QUANTIZATION 1
+#define DEFAULT_OPT_LUT_SIZE 0
 
 #define GET_OPT_FILL_BORDER(c) get_opt_bool(c, \
     GST_VIDEO_CONVERTER_OPT_FILL_BORDER, DEFAULT_OPT_FILL_BORDER)
@@ -837,6 +678,8 @@ get_opt_enum (GstVideoConverter * convert, const gchar * opt, GType type,
     DEFAULT_OPT_DITHER_METHOD)
 #define GET_OPT_DITHER_QUANTIZATION(c) get_opt_uint(c, \
     GST_VIDEO_CONVERTER_OPT_DITHER_QUANTIZATION, DEFAULT_OPT_DITHER_QUANTIZATION)
+#define GET_OPT_LUT_SIZE(c) get_opt_uint(c, \
+    GST_VIDEO_CONVERTER_OPT_LUT_SIZE, DEFAULT_OPT_LUT_SIZE)
 
 #define CHECK_ALPHA_COPY(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_COPY)
 #define CHECK_ALPHA_SET(c) (GET_OPT_ALPHA_MODE(c) == GST_VIDEO_ALPHA_MODE_SET)
@@ -1569,13 +1412,226 @@ setup_gamma_encode (GstVideoConverter * convert, gint target_bits)
   }
 }
 
+static inline gdouble
+lut_apply_matrix (const gdouble m[4][4], const gdouble in[3], gint row)
+{
+  return m[row][0] * in[0] + m[row][1] * in[1] + m[row][2] * in[2] + m[row][3];
+}
+
+static void
+lut_3d_compute (Lut3D * lut)
+{
+  Lut3DKey *key = &lut->key;
+  guint n = key->size, i, j, k, c, maxval = (1 << key->bits) - 1;
+  guint16 *t;
+
+  lut->index = g_new (guint16, maxval + 1);
+  lut->frac = g_new (guint16, maxval + 1);
+  for (i = 0; i <= maxval; i++) {
+    gdouble pos = (gdouble) i * (n - 1) / maxval;
+    guint idx = MIN (floor (pos), n - 2);
+
+    lut->index[i] = idx;
+    lut->frac[i] = rint ((pos - idx) * LUT_ONE);
+  }
+
+  t = lut->table = g_new (guint16, n * n * n * 3);
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < n; j++) {
+      for (k = 0; k < n; k++) {
+        gdouble v[3], rgb[3];
+
+        /* node position in the units the input matrix expects */
+        v[0] = (gdouble) i * maxval / (n - 1) / key->in_scale;
+        v[1] = (gdouble) j * maxval / (n - 1) / key->in_scale;
+        v[2] = (gdouble) k * maxval / (n - 1) / key->in_scale;
+
+        /* to linear RGB */
+        for (c = 0; c < 3; c++) {
+          rgb[c] = CLAMP (lut_apply_matrix (key->in, v, c), 0.0, 1.0);
+          rgb[c] = gst_video_color_transfer_decode (key->in_func, rgb[c]);
+        }
+        /* to the output primaries and back to R'G'B' */
+        for (c = 0; c < 3; c++) {
+          v[c] = CLAMP (lut_apply_matrix (key->primaries, rgb, c), 0.0, 1.0);
+          v[c] = gst_video_color_transfer_encode (key->out_func, v[c]);
+        }
+        /* to the output components */
+        for (c = 0; c < 3; c++) {
+          gdouble o = lut_apply_matrix (key->out, v, c) * key->out_scale;
+
+          *t++ = CLAMP (rint (o), 0, maxval);
+        }
+      }
+    }
+  }
+}
+
+static void
+lut_3d_free (Lut3D * lut)
+{
+  g_free (lut->table);
+  g_free (lut->index);
+  g_free (lut->frac);
+  g_slice_free (Lut3D, lut);
+}
+
+/* LUTs are shared between converters for the same pair of colorimetries and
+ * a few unused ones are kept, so that renegotiating or creating a converter
+ * per thread or stream doesn't recompute them */
+static GMutex lut_lock;
+static GList *lut_cache;
+
+static Lut3D *
+lut_3d_acquire (const Lut3DKey * key)
+{
+  GList *walk;
+  Lut3D *lut;
+
+  g_mutex_lock (&lut_lock);
+  for (walk = lut_cache; walk; walk = walk->next) {
+    lut = walk->data;
+    if (memcmp (&lut->key, key, sizeof (Lut3DKey)) == 0) {
+      GST_DEBUG ("reusing 3D LUT %p", lut);
+      lut_cache = g_list_delete_link (lut_cache, walk);
+      goto done;
+    }
+  }
+  lut = g_slice_new0 (Lut3D);
+  lut->key = *key;
+  GST_DEBUG ("computing 3D LUT %p of size %u", lut, key->size);
+  lut_3d_compute (lut);
+
+done:
+  lut->refcount++;
+  lut_cache = g_list_prepend (lut_cache, lut);
+  g_mutex_unlock (&lut_lock);
+
+  return lut;
+}
+
+static void
+lut_3d_release (Lut3D * lut)
+{
+  GList *walk, *next;
+  guint unused = 0;
+
+  g_mutex_lock (&lut_lock);
+  lut->refcount--;
+  for (walk = lut_cache; walk; walk = next) {
+    Lut3D *l = walk->data;
+
+    next = walk->next;
+    if (l->refcount > 0)
+      continue;
+    if (++unused > LUT_CACHE_SIZE) {
+      lut_cache = g_list_delete_link (lut_cache, walk);
+      lut_3d_free (l);
+    }
+  }
+  g_mutex_unlock (&lut_lock);
+}
+
+/* tetrahedral interpolation between the 4 nodes on the path from the node
+ * below the pixel to the one above it, picked by the order of the weights */
+#define MAKE_LUT_FUNC(name,type)                                          \
+static void                                                               \
+video_converter_lut_##name (MatrixData * data, gpointer pixels)            \
+{                                                                         \
+  const Lut3D *lut = data->lut;                                           \
+  const guint16 *index = lut->index, *frac = lut->frac;                   \
+  gint s2 = 3, s1 = lut->key.size * 3, s0 = lut->key.size * s1;           \
+  type *p = pixels;                                                       \
+  gint i, k, width = data->width;                                         \
+                                                                          \
+  for (i = 0; i < width; i++, p += 4) {                                   \
+    const guint16 *n0, *n1, *n2, *n3;                                     \
+    gint f0 = frac[p[1]], f1 = frac[p[2]], f2 = frac[p[3]];               \
+    gint wa, wb, wc;                                                      \
+                                                                          \
+    n0 = lut->table + index[p[1]] * s0 + index[p[2]] * s1 +               \
+        index[p[3]] * s2;                                                 \
+    n3 = n0 + s0 + s1 + s2;                                               \
+    if (f0 >= f1) {                                                       \
+      if (f1 >= f2) {                                                     \
+        n1 = n0 + s0, n2 = n0 + s0 + s1, wa = f0, wb = f1, wc = f2;       \
+      } else if (f0 >= f2) {                                              \
+        n1 = n0 + s0, n2 = n0 + s0 + s2, wa = f0, wb = f2, wc = f1;       \
+      } else {                                                            \
+        n1 = n0 + s2, n2 = n0 + s0 + s2, wa = f2, wb = f0, wc = f1;       \
+      }                                                                   \
+    } else {                                                              \
+      if (f2 >= f1) {                                                     \
+        n1 = n0 + s2, n2 = n0 + s1 + s2, wa = f2, wb = f1, wc = f0;       \
+      } else if (f2 >= f0) {                                              \
+        n1 = n0 + s1, n2 = n0 + s1 + s2, wa = f1, wb = f2, wc = f0;       \
+      } else {                                                            \
+        n1 = n0 + s1, n2 = n0 + s0 + s1, wa = f1, wb = f0, wc = f2;       \
+      }                                                                   \
+    }                                                                     \
+    for (k = 0; k < 3; k++) {                                             \
+      p[k + 1] = ((LUT_ONE - wa) * n0[k] + (wa - wb) * n1[k] +            \
+          (wb - wc) * n2[k] + wc * n3[k] + (LUT_ONE >> 1)) >> LUT_SHIFT;  \
+    }                                                                     \
+  }                                                                       \
+}
+
+MAKE_LUT_FUNC (u8, guint8);
+MAKE_LUT_FUNC (u16, guint16);
+
+/* merges the to R'G'B' matrix, gamma decode, the primaries conversion in
+ * @data, gamma encode and the to Y'CbCr matrix into one 3D LUT */
+static void
+setup_lut (GstVideoConverter * convert, MatrixData * data)
+{
+  MatrixData m;
+  Lut3DKey key;
+  gint i, j;
+
+  memset (&key, 0, sizeof (Lut3DKey));
+  key.bits = convert->current_bits;
+  key.size = convert->lut_size;
+  key.in_func = convert->in_info.colorimetry.transfer;
+  key.out_func = convert->out_info.colorimetry.transfer;
+  /* the 8 <-> 16 bits conversion around the matrix just shifts */
+  key.in_scale = 1 << (key.bits - convert->in_bits);
+  key.out_scale = 1 << (key.bits - convert->out_bits);
+
+  color_matrix_set_identity (&m);
+  compute_matrix_to_RGB (convert, &m);
+  for (i = 0; i < 4; i++)
+    for (j = 0; j < 4; j++)
+      key.in[i][j] = m.dm[i][j];
+
+  for (i = 0; i < 4; i++)
+    for (j = 0; j < 4; j++)
+      key.primaries[i][j] = data->dm[i][j];
+
+  color_matrix_set_identity (&m);
+  compute_matrix_to_YUV (convert, &m, FALSE);
+  for (i = 0; i < 4; i++)
+    for (j = 0; j < 4; j++)
+      key.out[i][j] = m.dm[i][j];
+
+  /* the convert chain is set up once per thread, they share the LUT */
+  if (data->lut == NULL)
+    data->lut = lut_3d_acquire (&key);
+
+  data->width = convert->current_width;
+  if (key.bits == 8)
+    data->matrix_func = video_converter_lut_u8;
+  else
+    data->matrix_func = video_converter_lut_u16;
+}
+
 static GstLineCache *
 chain_convert_to_RGB (GstVideoConverter * convert, GstLineCache * prev,
     gint idx)
 {
   gboolean do_gamma;
 
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  /* the 3D LUT does all of it in chain_convert() */
+  do_gamma = CHECK_GAMMA_REMAP (convert) && convert->lut_size == 0;
 
   if (do_gamma) {
     gint scale;
@@ -1803,12 +1859,20 @@ chain_convert (GstVideoConverter * convert, GstLineCache * prev, gint idx)
   }
 
   do_gamma = CHECK_GAMMA_REMAP (convert);
-  if (!do_gamma) {
+  if (!do_gamma || convert->lut_size) {
 
     convert->in_bits = convert->unpack_bits;
     convert->out_bits = convert->pack_bits;
 
-    if (!same_bits || !same_matrix || !same_primaries) {
+    if (do_gamma) {
+      GST_DEBUG ("3D LUT of size %u", convert->lut_size);
+      convert->current_bits = MAX (convert->in_bits, convert->out_bits);
+      setup_lut (convert, &convert->convert_matrix);
+
+      do_conversion = TRUE;
+      if (convert->in_bits == convert->out_bits)
+        pass_alloc = TRUE;
+    } else if (!same_bits || !same_matrix || !same_primaries) {
       /* no gamma, combine all conversions into 1 */
       if (convert->in_bits < convert->out_bits) {
         gint scale = 1 << (convert->out_bits - convert->in_bits);
@@ -1958,7 +2022,7 @@ chain_convert_to_YUV (GstVideoConverter * convert, GstLineCache * prev,
 {
   gboolean do_gamma;
 
-  do_gamma = CHECK_GAMMA_REMAP (convert);
+  do_gamma = CHECK_GAMMA_REMAP (convert) && convert->lut_size == 0;
 
   if (do_gamma) {
     gint scale;
@@ -2398,6 +2462,10 @@ gst_video_converter_new (GstVideoInfo * in_info, GstVideoInfo * out_info,
     n_threads = (MAX (convert->out_height, convert->in_height) + 199) / 200;
   convert->conversion_runner = gst_parallelized_task_runner_new (n_threads);
 
+  convert->lut_size = GET_OPT_LUT_SIZE (convert);
+  if (convert->lut_size)
+    convert->lut_size = CLAMP (convert->lut_size, LUT_MIN_SIZE, LUT_MAX_SIZE);
+
   if (video_converter_lookup_fastpath (convert))
     goto done;
 
@@ -2488,6 +2556,8 @@ clear_matrix_data (MatrixData * data)
   g_free (data->t_r);
   g_free (data->t_g);
   g_free (data->t_b);
+  if (data->lut)
+    lut_3d_release (data->lut);
 }
 
 /**
@@ -2677,6 +2747,192 @@ gst_video_converter_frame (GstVideoConverter * convert,
   convert->convert (convert, src, dest);
 }
 
+/* conversions run by gst_video_converter_precompile() */
+static const GstVideoFormat precompile_formats[][2] = {
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_BGRx},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_RGBx},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_BGRA},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_RGBA},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_ARGB},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_YUY2},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_UYVY},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_AYUV},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_BGRx},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_BGRx},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_RGBA},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_YUY2, GST_VIDEO_FORMAT_BGRx},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_UYVY, GST_VIDEO_FORMAT_BGRx},
+  {GST_VIDEO_FORMAT_AYUV, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_BGRx, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_RGBA, GST_VIDEO_FORMAT_I420},
+  {GST_VIDEO_FORMAT_BGRA, GST_VIDEO_FORMAT_NV12},
+  {GST_VIDEO_FORMAT_RGB, GST_VIDEO_FORMAT_I420},
+};
+
+#define PRECOMPILE_WIDTH 64
+#define PRECOMPILE_HEIGHT 16
+
+static void
+precompile_convert (GstVideoFormat in_format, GstVideoFormat out_format,
+    gint out_width, gint out_height)
+{
+  GstVideoInfo in_info, out_info;
+  GstVideoFrame in_frame, out_frame;
+  GstBuffer *in_buf, *out_buf;
+  GstVideoConverter *convert;
+
+  gst_video_info_set_format (&in_info, in_format, PRECOMPILE_WIDTH,
+      PRECOMPILE_HEIGHT);
+  gst_video_info_set_format (&out_info, out_format, out_width, out_height);
+
+  in_buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&in_info), NULL);
+  out_buf =
+      gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&out_info), NULL);
+  gst_buffer_memset (in_buf, 0, 0x80, -1);
+
+  convert = gst_video_converter_new (&in_info, &out_info, NULL);
+  if (convert) {
+    if (gst_video_frame_map (&in_frame, &in_info, in_buf, GST_MAP_READ)) {
+      if (gst_video_frame_map (&out_frame, &out_info, out_buf, GST_MAP_WRITE)) {
+        gst_video_converter_frame (convert, &in_frame, &out_frame);
+        gst_video_frame_unmap (&out_frame);
+      }
+      gst_video_frame_unmap (&in_frame);
+    }
+    gst_video_converter_free (convert);
+  }
+
+  gst_buffer_unref (in_buf);
+  gst_buffer_unref (out_buf);
+}
+
+static gpointer
+precompile_func (gpointer data)
+{
+  GstClockTime start = gst_util_get_timestamp ();
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (precompile_formats); i++)
+    precompile_convert (precompile_formats[i][0], precompile_formats[i][1],
+        PRECOMPILE_WIDTH, PRECOMPILE_HEIGHT);
+
+  /* and the scalers */
+  precompile_convert (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_I420,
+      PRECOMPILE_WIDTH / 2, PRECOMPILE_HEIGHT / 2);
+  precompile_convert (GST_VIDEO_FORMAT_BGRx, GST_VIDEO_FORMAT_BGRx,
+      PRECOMPILE_WIDTH * 2, PRECOMPILE_HEIGHT * 2);
+
+  GST_DEBUG ("precompiled conversions in %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (gst_util_get_timestamp () - start));
+
+  return NULL;
+}
+
+/**
+ * gst_video_converter_precompile:
+ * @async: %TRUE to return immediately and do the work from a new thread
+ *
+ * Converts tiny frames between the most common video formats, and scales
+ * some, once. The Orc programs used by these conversions are compiled when
+ * they are first run, which otherwise happens on the streaming thread while
+ * converting the first frames of a pipeline.
+ *
+ * Only the first call does something, later calls return immediately.
+ *
+ * Since: 1.18
+ */
+void
+gst_video_converter_precompile (gboolean async)
+{
+  static gsize precompiled = 0;
+
+  if (g_once_init_enter (&precompiled)) {
+    if (async)
+      g_thread_unref (g_thread_new ("video-precompile", precompile_func, NULL));
+    else
+      precompile_func (NULL);
+    g_once_init_leave (&precompiled, 1);
+  }
+}
+
+/* a single plane without subsampling, where every output pixel only depends
+ * on the input pixel at the same position */
+static gboolean
+format_is_inplace_capable (const GstVideoFormatInfo * finfo)
+{
+  guint i;
+
+  if (GST_VIDEO_FORMAT_INFO_N_PLANES (finfo) != 1 ||
+      GST_VIDEO_FORMAT_INFO_IS_COMPLEX (finfo) ||
+      GST_VIDEO_FORMAT_INFO_HAS_PALETTE (finfo) ||
+      GST_VIDEO_FORMAT_INFO_IS_TILED (finfo) ||
+      GST_VIDEO_FORMAT_INFO_PSTRIDE (finfo, 0) <= 0)
+    return FALSE;
+
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    if (GST_VIDEO_FORMAT_INFO_W_SUB (finfo, i) != 0 ||
+        GST_VIDEO_FORMAT_INFO_H_SUB (finfo, i) != 0)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/**
+ * gst_video_converter_supports_inplace:
+ * @convert: a #GstVideoConverter
+ *
+ * Check if @convert can convert frames in place, that is, if the source and
+ * destination frames given to gst_video_converter_frame() can map the same
+ * memory. This is the case when no scaling or borders are needed and both
+ * formats are single plane 4:4:4 formats with the same pixel size, for
+ * example for range or matrix changes or RGBA to BGRA conversions.
+ *
+ * When converting in place, the destination frame has to use the strides and
+ * offsets of the source frame.
+ *
+ * Returns: %TRUE when the conversion can be done in place.
+ *
+ * Since: 1.18
+ */
+gboolean
+gst_video_converter_supports_inplace (GstVideoConverter * convert)
+{
+  const GstVideoFormatInfo *in_finfo, *out_finfo;
+
+  g_return_val_if_fail (convert != NULL, FALSE);
+
+  in_finfo = convert->in_info.finfo;
+  out_finfo = convert->out_info.finfo;
+
+  if (!format_is_inplace_capable (in_finfo) ||
+      !format_is_inplace_capable (out_finfo))
+    return FALSE;
+
+  if (GST_VIDEO_FORMAT_INFO_PSTRIDE (in_finfo, 0) !=
+      GST_VIDEO_FORMAT_INFO_PSTRIDE (out_finfo, 0))
+    return FALSE;
+
+  /* every output pixel has to come from the input pixel at the same place */
+  if (convert->in_x != convert->out_x || convert->in_y != convert->out_y ||
+      convert->in_width != convert->out_width ||
+      convert->in_height != convert->out_height)
+    return FALSE;
+
+  /* and no borders are filled around it */
+  if (convert->fill_border && (convert->out_width < convert->out_maxwidth ||
+          convert->out_height < convert->out_maxheight))
+    return FALSE;
+
+  if (GST_VIDEO_INFO_IS_INTERLACED (&convert->in_info))
+    return FALSE;
+
+  return TRUE;
+}
+
 static void
 video_converter_compute_matrix (GstVideoConverter * convert)
 {
@@ -5055,6 +5311,297 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   convert_fill_border (convert, dest);
 }
 
+static void
+convert_NV12_BGRA_task (FConvertTask * task)
+{
+  gint i, j;
+  gint width2 = (task->width + 1) / 2;
+  guint8 *tu, *tv;
+
+  /* chroma of one line is deinterleaved into the per-thread temp line, which
+   * stays in cache for the matrix pass right after */
+  tu = task->tmpline;
+  tv = tu + GST_ROUND_UP_8 (width2);
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *sy, *su, *sv, *d;
+
+    d = FRAME_GET_LINE (task->dest, i + task->out_y);
+    d += (task->out_x * 4);
+    sy = FRAME_GET_Y_LINE (task->src, i + task->in_y);
+    sy += task->in_x;
+    su = FRAME_GET_U_LINE (task->src, (i + task->in_y) >> 1);
+    su += (task->in_x >> 1) * 2;
+    sv = FRAME_GET_V_LINE (task->src, (i + task->in_y) >> 1);
+    sv += (task->in_x >> 1) * 2;
+
+    /* only deinterleave again when starting a new chroma line */
+    if (i == task->height_0 || ((i + task->in_y) & 1) == 0) {
+      for (j = 0; j < width2; j++) {
+        tu[j] = su[2 * j];
+        tv[j] = sv[2 * j];
+      }
+    }
+
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    video_orc_convert_I420_BGRA (d, sy, tu, tv,
+        task->data->im[0][0], task->data->im[0][2],
+        task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
+        task->width);
+#else
+    video_orc_convert_I420_ARGB (d, sy, tu, tv,
+        task->data->im[0][0], task->data->im[0][2],
+        task->data->im[2][1], task->data->im[1][1], task->data->im[1][2],
+        task->width);
+#endif
+  }
+}
+
+static void
+convert_NV12_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  MatrixData *data = &convert->convert_matrix;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FConvertTask, n_threads);
+  tasks_p = g_newa (FConvertTask *, n_threads);
+
+  lines_per_thread = (height + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+    tasks[i].data = data;
+    tasks[i].in_x = convert->in_x;
+    tasks[i].in_y = convert->in_y;
+    tasks[i].out_x = convert->out_x;
+    tasks[i].out_y = convert->out_y;
+    tasks[i].tmpline = convert->tmpline[i];
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_BGRA_task, (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_I420_NV12_task (FConvertTask * task)
+{
+  gint i, j;
+  gint width2 = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *su, *sv, *du, *dv;
+
+    memcpy (FRAME_GET_Y_LINE (task->dest, i),
+        FRAME_GET_Y_LINE (task->src, i), task->width);
+
+    if (i & 1)
+      continue;
+
+    su = FRAME_GET_U_LINE (task->src, i >> 1);
+    sv = FRAME_GET_V_LINE (task->src, i >> 1);
+    du = FRAME_GET_U_LINE (task->dest, i >> 1);
+    dv = FRAME_GET_V_LINE (task->dest, i >> 1);
+
+    for (j = 0; j < width2; j++) {
+      du[2 * j] = su[j];
+      dv[2 * j] = sv[j];
+    }
+  }
+}
+
+static void
+convert_NV12_I420_task (FConvertTask * task)
+{
+  gint i, j;
+  gint width2 = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++) {
+    guint8 *su, *sv, *du, *dv;
+
+    memcpy (FRAME_GET_Y_LINE (task->dest, i),
+        FRAME_GET_Y_LINE (task->src, i), task->width);
+
+    if (i & 1)
+      continue;
+
+    su = FRAME_GET_U_LINE (task->src, i >> 1);
+    sv = FRAME_GET_V_LINE (task->src, i >> 1);
+    du = FRAME_GET_U_LINE (task->dest, i >> 1);
+    dv = FRAME_GET_V_LINE (task->dest, i >> 1);
+
+    for (j = 0; j < width2; j++) {
+      du[j] = su[2 * j];
+      dv[j] = sv[2 * j];
+    }
+  }
+}
+
+static void
+convert_planar_semiplanar_420 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest,
+    GstParallelizedTaskFunc func)
+{
+  int i;
+  gint width = convert->in_width;
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FConvertTask, n_threads);
+  tasks_p = g_newa (FConvertTask *, n_threads);
+
+  /* keep luma line pairs, and thus chroma lines, in one task */
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = width;
+
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner, func,
+      (gpointer) tasks_p);
+}
+
+static void
+convert_I420_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_planar_semiplanar_420 (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_I420_NV12_task);
+}
+
+static void
+convert_NV12_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_planar_semiplanar_420 (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_NV12_I420_task);
+}
+
+/* copies a row of tiles, one tile at a time: the tiles are contiguous in
+ * memory so each of them is read sequentially instead of jumping between
+ * tiles for every output line */
+static void
+convert_NV12_64Z32_NV12_task (FConvertTask * task)
+{
+  const GstVideoFormatInfo *finfo = task->src->info.finfo;
+  gint ws = GST_VIDEO_FORMAT_INFO_TILE_WS (finfo);
+  gint hs = GST_VIDEO_FORMAT_INFO_TILE_HS (finfo);
+  gint ts = ws + hs;
+  gint tile_width = 1 << ws;
+  gint tile_height = 1 << hs;
+  gint sstride_y = FRAME_GET_PLANE_STRIDE (task->src, 0);
+  gint sstride_uv = FRAME_GET_PLANE_STRIDE (task->src, 1);
+  gint x_tiles = GST_VIDEO_TILE_X_TILES (sstride_y);
+  gint uv_width = GST_ROUND_UP_2 (task->width);
+  gint height = GST_VIDEO_FRAME_HEIGHT (task->dest);
+  gint uv_height = GST_ROUND_UP_2 (height) / 2;
+  gint tx, ty, i;
+
+  for (ty = task->height_0; ty < task->height_1; ty++) {
+    gint y = ty * tile_height;
+    gint uv_y = ty * (tile_height / 2);
+    gint n_lines = MIN (tile_height, height - y);
+    gint n_uv_lines = MIN (tile_height / 2, uv_height - uv_y);
+
+    for (tx = 0; tx < x_tiles && tx * tile_width < task->width; tx++) {
+      const guint8 *s;
+      gsize offset;
+      gint n_bytes;
+
+      offset = gst_video_tile_get_index (GST_VIDEO_TILE_MODE_ZFLIPZ_2X2,
+          tx, ty, x_tiles, GST_VIDEO_TILE_Y_TILES (sstride_y));
+      s = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (task->src, 0) +
+          (offset << ts);
+      n_bytes = MIN (tile_width, task->width - tx * tile_width);
+
+      for (i = 0; i < n_lines; i++)
+        memcpy (FRAME_GET_PLANE_LINE (task->dest, 0, y + i) + tx * tile_width,
+            s + i * tile_width, n_bytes);
+
+      /* two rows of tiles share one UV tile, the odd one using its second
+       * half */
+      offset = gst_video_tile_get_index (GST_VIDEO_TILE_MODE_ZFLIPZ_2X2,
+          tx, ty >> 1, GST_VIDEO_TILE_X_TILES (sstride_uv),
+          GST_VIDEO_TILE_Y_TILES (sstride_uv));
+      s = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (task->src, 1) +
+          ((offset << ts) | ((ty & 1) << (ts - 1)));
+      n_bytes = MIN (tile_width, uv_width - tx * tile_width);
+
+      for (i = 0; i < n_uv_lines; i++)
+        memcpy (FRAME_GET_PLANE_LINE (task->dest, 1, uv_y + i) +
+            tx * tile_width, s + i * tile_width, n_bytes);
+    }
+  }
+}
+
+static void
+convert_NV12_64Z32_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  int i;
+  gint tile_height = 1 << GST_VIDEO_FORMAT_INFO_TILE_HS (src->info.finfo);
+  gint n_rows = (convert->in_height + tile_height - 1) / tile_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint rows_per_thread;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = g_newa (FConvertTask, n_threads);
+  tasks_p = g_newa (FConvertTask *, n_threads);
+
+  rows_per_thread = (n_rows + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = convert->in_width;
+
+    /* the tasks work on whole rows of tiles */
+    tasks[i].height_0 = i * rows_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + rows_per_thread;
+    tasks[i].height_1 = MIN (n_rows, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      (GstParallelizedTaskFunc) convert_NV12_64Z32_NV12_task,
+      (gpointer) tasks_p);
+}
+
 static void
 convert_I420_ARGB_task (FConvertTask * task)
 {
@@ -6511,6 +7058,24 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YVU9, GST_VIDEO_FORMAT_YVU9, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* planar <-> semiplanar */
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV21, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+
+  /* tiled -> linear */
+  {GST_VIDEO_FORMAT_NV12_64Z32, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_64Z32_NV12},
+
   /* sempiplanar -> semiplanar */
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -6567,6 +7132,15 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_BGRA},
 
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_BGRA, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_BGRA},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_BGRA},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_BGRA, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_BGRA},
+  {GST_VIDEO_FORMAT_NV21, GST_VIDEO_FORMAT_BGRx, FALSE, TRUE, TRUE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_BGRA},
+
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_ARGB, FALSE, TRUE, TRUE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_I420_ARGB},
   {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_xRGB, FALSE, TRUE, TRUE, TRUE,
@@ -6750,7 +7324,10 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
         && (transforms[i].alpha_mult || !need_mult)) {
       guint j;
 
-      GST_DEBUG ("using fastpath");
+      GST_INFO ("using fastpath %u for %s -> %s%s", i,
+          gst_video_format_to_string (in_format),
+          gst_video_format_to_string (out_format),
+          transforms[i].keeps_size ? "" : " with scaling");
       if (transforms[i].needs_color_matrix)
         video_converter_compute_matrix (convert);
       convert->convert = transforms[i].convert;
@@ -6768,6 +7345,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       return TRUE;
     }
   }
-  GST_DEBUG ("no fastpath found");
+  GST_INFO ("no fastpath found for %s -> %s, using generic path",
+      gst_video_format_to_string (in_format),
+      gst_video_format_to_string (out_format));
   return FALSE;
 }
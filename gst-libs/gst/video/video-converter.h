@@ -265,11 +265,29 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_PRIMARIES_MODE   "GstVideoConverter.primaries-mode"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_LUT_SIZE:
+ *
+ * #G_TYPE_UINT, when not 0 and #GST_VIDEO_CONVERTER_OPT_GAMMA_MODE is
+ * #GST_VIDEO_GAMMA_MODE_REMAP, merge the matrix, gamma and primaries
+ * conversions into a 3D lookup table with this many points per component,
+ * between 2 and 65, that is interpolated for each pixel. This is much faster
+ * than converting through linear RGB but scaling is then done on the gamma
+ * encoded input. Default 0.
+ *
+ * Since: 1.18
+ */
+#define GST_VIDEO_CONVERTER_OPT_LUT_SIZE   "GstVideoConverter.lut-size"
+
 /**
  * GST_VIDEO_CONVERTER_OPT_THREADS:
  *
  * #G_TYPE_UINT, maximum number of threads to use. Default 1, 0 for the number
  * of cores.
+ *
+ * The threads are taken from a pool that is shared by all converters in the
+ * process. Its size defaults to the number of cores and can be limited with
+ * the `GST_VIDEO_TASK_POOL_MAX_THREADS` environment variable.
  */
 #define GST_VIDEO_CONVERTER_OPT_THREADS   "GstVideoConverter.threads"
 
@@ -293,6 +311,12 @@ GST_VIDEO_API
 void                 gst_video_converter_frame          (GstVideoConverter * convert,
                                                          const GstVideoFrame *src, GstVideoFrame *dest);
 
+GST_VIDEO_API
+gboolean             gst_video_converter_supports_inplace (GstVideoConverter * convert);
+
+GST_VIDEO_API
+void                 gst_video_converter_precompile     (gboolean async);
+
 
 G_END_DECLS
 
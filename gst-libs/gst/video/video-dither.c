@@ -52,6 +52,10 @@ struct _GstVideoDither
   guint32 orc_mask32;
 
   gpointer errors;
+  /* last line that was dithered and whether the errors of the previous
+   * line have to be discarded for the current one */
+  guint y;
+  gboolean restart;
 };
 
 static void
@@ -79,7 +83,7 @@ dither_verterr_u8 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
   guint8 *p = pixels;
   guint16 *e = dither->errors;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, width * 8);
 
   video_orc_dither_verterr_4u8_mask (p + (x * 4), e + (x * 4),
@@ -93,25 +97,11 @@ dither_verterr_u16 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
   guint16 *p = pixels;
   guint16 *e = dither->errors;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, width * 8);
 
-  {
-    gint i, end;
-    guint16 *m = dither->mask;
-    guint32 v, mp;
-
-    end = (width + x) * 4;
-    for (i = x * 4; i < end; i++) {
-      mp = m[i & 3];
-      v = p[i] + e[i];
-      /* take new error and store */
-      e[i] = v & mp;
-      /* quantize and store */
-      v &= ~mp;
-      p[i] = MIN (v, 65535);
-    }
-  }
+  video_orc_dither_verterr_4u16_mask (p + (x * 4), e + (x * 4),
+      dither->orc_mask64, width);
 }
 
 static void
@@ -121,7 +111,7 @@ dither_floyd_steinberg_u8 (GstVideoDither * dither, gpointer pixels, guint x,
   guint8 *p = pixels;
   guint16 *e = dither->errors;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, (width + 1) * 8);
 
   /* add and multiply errors from previous line */
@@ -157,7 +147,7 @@ dither_floyd_steinberg_u16 (GstVideoDither * dither, gpointer pixels, guint x,
   guint16 *p = pixels;
   guint16 *e = dither->errors;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, (width + 1) * 8);
 
   {
@@ -189,11 +179,11 @@ dither_sierra_lite_u8 (GstVideoDither * dither, gpointer pixels, guint x,
   guint16 *m = dither->mask, mp;
   guint16 v;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, (width + 4) * 8);
 
   end = (width + x) * 4;
-  for (i = x; i < end; i++) {
+  for (i = x * 4; i < end; i++) {
     mp = m[i & 3];
     /* apply previous errors to pixel */
     v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
@@ -215,11 +205,11 @@ dither_sierra_lite_u16 (GstVideoDither * dither, gpointer pixels, guint x,
   guint16 *m = dither->mask, mp;
   guint32 v;
 
-  if (y == 0)
+  if (dither->restart)
     memset (e + (x * 4), 0, (width + 4) * 8);
 
   end = (width + x) * 4;
-  for (i = x; i < end; i++) {
+  for (i = x * 4; i < end; i++) {
     mp = m[i & 3];
     /* apply previous errors to pixel */
     v = p[i] + ((2 * e[i] + e[i + 8] + e[i + 12]) >> 2);
@@ -257,7 +247,7 @@ dither_ordered_u8 (GstVideoDither * dither, gpointer pixels, guint x, guint y,
   guint8 *p = pixels;
   guint8 *c = (guint8 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_u8 (p, c, width * 4);
+  video_orc_dither_ordered_u8 (p + (x * 4), c, width * 4);
 }
 
 static void
@@ -267,7 +257,8 @@ dither_ordered_u8_mask (GstVideoDither * dither, gpointer pixels, guint x,
   guint8 *p = pixels;
   guint16 *c = (guint16 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_4u8_mask (p, c, dither->orc_mask64, width);
+  video_orc_dither_ordered_4u8_mask (p + (x * 4), c, dither->orc_mask64,
+      width);
 }
 
 static void
@@ -277,7 +268,8 @@ dither_ordered_u16_mask (GstVideoDither * dither, gpointer pixels, guint x,
   guint16 *p = pixels;
   guint16 *c = (guint16 *) dither->errors + ((y & 15) * width + (x & 15)) * 4;
 
-  video_orc_dither_ordered_4u16_mask (p, c, dither->orc_mask64, width);
+  video_orc_dither_ordered_4u16_mask (p + (x * 4), c, dither->orc_mask64,
+      width);
 }
 
 static void
@@ -484,6 +476,12 @@ gst_video_dither_free (GstVideoDither * dither)
  * Dither @width pixels starting from offset @x in @line using @dither.
  *
  * @y is the line number of @line in the output image.
+ *
+ * The error diffusing methods carry the quantization error over from line
+ * @y - 1. When @y is not the line after the previously dithered one, the
+ * error is reset so that a #GstVideoDither per thread can be used to dither
+ * separate bands of an image in parallel, and the result never depends on
+ * the lines of the previous frame.
  */
 void
 gst_video_dither_line (GstVideoDither * dither, gpointer line, guint x, guint y,
@@ -492,6 +490,9 @@ gst_video_dither_line (GstVideoDither * dither, gpointer line, guint x, guint y,
   g_return_if_fail (dither != NULL);
   g_return_if_fail (x + width <= dither->width);
 
-  if (dither->func)
+  if (dither->func) {
+    dither->restart = y == 0 || (y != dither->y && y != dither->y + 1);
     dither->func (dither, line, x, y, width);
+    dither->y = y;
+  }
 }
@@ -2492,6 +2492,12 @@ unpack_GBR_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   sb += x;
   sr += x;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sr, sg, sb, 6, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = GST_READ_UINT16_LE (sg + i) << 6;
     B = GST_READ_UINT16_LE (sb + i) << 6;
@@ -2523,6 +2529,11 @@ pack_GBR_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 G, B, R;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dr, dg, db, (const guint8 *) s, 6, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = (s[i * 4 + 2]) >> 6;
     B = (s[i * 4 + 3]) >> 6;
@@ -2550,6 +2561,12 @@ unpack_GBR_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   sb += x;
   sr += x;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sr, sg, sb, 6, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = GST_READ_UINT16_BE (sg + i) << 6;
     B = GST_READ_UINT16_BE (sb + i) << 6;
@@ -2581,6 +2598,11 @@ pack_GBR_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 G, B, R;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dr, dg, db, (const guint8 *) s, 6, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = s[i * 4 + 2] >> 6;
     B = s[i * 4 + 3] >> 6;
@@ -2738,6 +2760,12 @@ unpack_GBR_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   sb += x;
   sr += x;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sr, sg, sb, 4, 8, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = GST_READ_UINT16_LE (sg + i) << 4;
     B = GST_READ_UINT16_LE (sb + i) << 4;
@@ -2769,6 +2797,11 @@ pack_GBR_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 G, B, R;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dr, dg, db, (const guint8 *) s, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = (s[i * 4 + 2]) >> 4;
     B = (s[i * 4 + 3]) >> 4;
@@ -2796,6 +2829,12 @@ unpack_GBR_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   sb += x;
   sr += x;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sr, sg, sb, 4, 8, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = GST_READ_UINT16_BE (sg + i) << 4;
     B = GST_READ_UINT16_BE (sb + i) << 4;
@@ -2827,6 +2866,11 @@ pack_GBR_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 G, B, R;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dr, dg, db, (const guint8 *) s, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     G = s[i * 4 + 2] >> 4;
     B = s[i * 4 + 3] >> 4;
@@ -2984,6 +3028,12 @@ unpack_Y444_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   su += x;
   sv += x;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sy, su, sv, 6, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = GST_READ_UINT16_LE (sy + i) << 6;
     U = GST_READ_UINT16_LE (su + i) << 6;
@@ -3015,6 +3065,11 @@ pack_Y444_10LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y, U, V;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dy, du, dv, (const guint8 *) s, 6, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = (s[i * 4 + 1]) >> 6;
     U = (s[i * 4 + 2]) >> 6;
@@ -3042,6 +3097,12 @@ unpack_Y444_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   su += x;
   sv += x;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sy, su, sv, 6, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = GST_READ_UINT16_BE (sy + i) << 6;
     U = GST_READ_UINT16_BE (su + i) << 6;
@@ -3073,6 +3134,11 @@ pack_Y444_10BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y, U, V;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dy, du, dv, (const guint8 *) s, 6, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = s[i * 4 + 1] >> 6;
     U = s[i * 4 + 2] >> 6;
@@ -3418,6 +3484,12 @@ unpack_Y444_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   su += x;
   sv += x;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sy, su, sv, 4, 8, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = GST_READ_UINT16_LE (sy + i) << 4;
     U = GST_READ_UINT16_LE (su + i) << 4;
@@ -3449,6 +3521,11 @@ pack_Y444_12LE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y, U, V;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_LITTLE_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dy, du, dv, (const guint8 *) s, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = (s[i * 4 + 1]) >> 4;
     U = (s[i * 4 + 2]) >> 4;
@@ -3476,6 +3553,12 @@ unpack_Y444_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   su += x;
   sv += x;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN
+      && !(flags & GST_VIDEO_PACK_FLAG_TRUNCATE_RANGE) && IS_ALIGNED (d, 8)) {
+    video_orc_unpack_Y444_16 ((guint8 *) d, sy, su, sv, 4, 8, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = GST_READ_UINT16_BE (sy + i) << 4;
     U = GST_READ_UINT16_BE (su + i) << 4;
@@ -3507,6 +3590,11 @@ pack_Y444_12BE (const GstVideoFormatInfo * info, GstVideoPackFlags flags,
   guint16 Y, U, V;
   const guint16 *restrict s = src;
 
+  if (G_BYTE_ORDER == G_BIG_ENDIAN && IS_ALIGNED (s, 8)) {
+    video_orc_pack_Y444_16 (dy, du, dv, (const guint8 *) s, 4, width);
+    return;
+  }
+
   for (i = 0; i < width; i++) {
     Y = s[i * 4 + 1] >> 4;
     U = s[i * 4 + 2] >> 4;
@@ -30,6 +30,10 @@
 #include "video-frame.h"
 #include "video-tile.h"
 #include "gstvideometa.h"
+#include "gstvideoutilsprivate.h"
+
+/* set when all planes of the frame share the mapping in map[0] */
+#define FRAME_SINGLE_MAP(frame) ((frame)->_gst_reserved[0])
 
 #define CAT_PERFORMANCE video_frame_get_perf_category()
 
@@ -85,6 +89,7 @@ gst_video_frame_map_id (GstVideoFrame * frame, GstVideoInfo * info,
 
   /* copy the info */
   frame->info = *info;
+  FRAME_SINGLE_MAP (frame) = NULL;
 
   if (meta) {
     /* All these values must be consistent */
@@ -99,11 +104,31 @@ gst_video_frame_map_id (GstVideoFrame * frame, GstVideoInfo * info,
     frame->id = meta->id;
     frame->flags = meta->flags;
 
-    for (i = 0; i < meta->n_planes; i++) {
-      frame->info.offset[i] = meta->offset[i];
-      if (!gst_video_meta_map (meta, i, &frame->map[i], &frame->data[i],
-              &frame->info.stride[i], flags))
-        goto frame_map_failed;
+    if (gst_buffer_n_memory (buffer) == 1
+        && __gst_video_meta_has_default_map (meta)) {
+      /* all planes live in the same memory, map it once instead of once
+       * per plane and point the planes into that mapping */
+      if (!gst_buffer_map (buffer, &frame->map[0], flags))
+        goto map_failed;
+
+      for (i = 0; i < meta->n_planes; i++) {
+        if (meta->offset[i] >= frame->map[0].size)
+          goto invalid_plane_offset;
+
+        frame->info.offset[i] = meta->offset[i];
+        frame->info.stride[i] = meta->stride[i];
+        frame->data[i] = frame->map[0].data + meta->offset[i];
+        if (i > 0)
+          frame->map[i] = frame->map[0];
+      }
+      FRAME_SINGLE_MAP (frame) = GINT_TO_POINTER (TRUE);
+    } else {
+      for (i = 0; i < meta->n_planes; i++) {
+        frame->info.offset[i] = meta->offset[i];
+        if (!gst_video_meta_map (meta, i, &frame->map[i], &frame->data[i],
+                &frame->info.stride[i], flags))
+          goto frame_map_failed;
+      }
     }
   } else {
     /* no metadata, we really need to have the metadata when the id is
@@ -176,6 +201,14 @@ map_failed:
     GST_ERROR ("failed to map buffer");
     return FALSE;
   }
+invalid_plane_offset:
+  {
+    GST_ERROR ("plane %d offset %" G_GSIZE_FORMAT " outside of buffer of size %"
+        G_GSIZE_FORMAT, i, meta->offset[i], frame->map[0].size);
+    gst_buffer_unmap (buffer, &frame->map[0]);
+    memset (frame, 0, sizeof (GstVideoFrame));
+    return FALSE;
+  }
 invalid_size:
   {
     GST_ERROR ("invalid buffer size %" G_GSIZE_FORMAT " < %" G_GSIZE_FORMAT,
@@ -266,7 +299,7 @@ gst_video_frame_unmap (GstVideoFrame * frame)
   meta = frame->meta;
   flags = frame->map[0].flags;
 
-  if (meta) {
+  if (meta && !FRAME_SINGLE_MAP (frame)) {
     for (i = 0; i < frame->info.finfo->n_planes; i++) {
       gst_video_meta_unmap (meta, i, &frame->map[i]);
     }
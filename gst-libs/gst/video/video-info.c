@@ -383,17 +383,39 @@ gst_video_field_order_from_string (const gchar * order)
   return GST_VIDEO_FIELD_ORDER_UNKNOWN;
 }
 
-/**
- * gst_video_info_from_caps:
- * @info: a #GstVideoInfo
- * @caps: a #GstCaps
- *
- * Parse @caps and update @info.
- *
- * Returns: TRUE if @caps could be parsed
- */
-gboolean
-gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
+/* parsed #GstVideoInfo cached on shared caps, together with a copy of the
+ * caps it was parsed from. Caps that are shared now can become writable
+ * again when the other refs go away, and be modified in place, so the copy
+ * is compared before the cached info is used. */
+typedef struct
+{
+  GstCaps *caps;
+  GstVideoInfo info;
+} VideoInfoCache;
+
+static GMutex video_info_cache_lock;
+
+static void
+video_info_cache_free (VideoInfoCache * cache)
+{
+  gst_caps_unref (cache->caps);
+  g_slice_free (VideoInfoCache, cache);
+}
+
+static GQuark
+video_info_cache_quark (void)
+{
+  static gsize quark = 0;
+
+  if (g_once_init_enter (&quark)) {
+    gsize q = g_quark_from_static_string ("GstVideoInfoCache");
+    g_once_init_leave (&quark, q);
+  }
+  return (GQuark) quark;
+}
+
+static gboolean
+video_info_parse_caps (GstVideoInfo * info, const GstCaps * caps)
 {
   GstStructure *structure;
   const gchar *s;
@@ -403,10 +425,6 @@ gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
   gint par_n, par_d;
   guint multiview_flags;
 
-  g_return_val_if_fail (info != NULL, FALSE);
-  g_return_val_if_fail (caps != NULL, FALSE);
-  g_return_val_if_fail (gst_caps_is_fixed (caps), FALSE);
-
   GST_DEBUG ("parsing caps %" GST_PTR_FORMAT, caps);
 
   structure = gst_caps_get_structure (caps, 0);
@@ -573,6 +591,62 @@ alternate_no_feature:
   }
 }
 
+/**
+ * gst_video_info_from_caps:
+ * @info: a #GstVideoInfo
+ * @caps: a #GstCaps
+ *
+ * Parse @caps and update @info.
+ *
+ * Parsing results of caps that are not writable are cached on the caps, so
+ * repeated calls with the same unchanged shared caps are cheap.
+ *
+ * Returns: TRUE if @caps could be parsed
+ */
+gboolean
+gst_video_info_from_caps (GstVideoInfo * info, const GstCaps * caps)
+{
+  GstMiniObject *obj = GST_MINI_OBJECT_CAST (caps);
+  VideoInfoCache *cache;
+  gboolean cached = FALSE;
+  gboolean res;
+
+  g_return_val_if_fail (info != NULL, FALSE);
+  g_return_val_if_fail (caps != NULL, FALSE);
+  g_return_val_if_fail (gst_caps_is_fixed (caps), FALSE);
+
+  /* Writable caps are about to be modified by their owner, only shared caps
+   * keep the parsed info around for the next caller */
+  if (gst_mini_object_is_writable (obj))
+    return video_info_parse_caps (info, caps);
+
+  g_mutex_lock (&video_info_cache_lock);
+  cache = gst_mini_object_get_qdata (obj, video_info_cache_quark ());
+  if (cache && gst_caps_is_strictly_equal (cache->caps, caps)) {
+    *info = cache->info;
+    cached = TRUE;
+  }
+  g_mutex_unlock (&video_info_cache_lock);
+
+  if (cached)
+    return TRUE;
+
+  res = video_info_parse_caps (info, caps);
+  if (res) {
+    cache = g_slice_new (VideoInfoCache);
+    cache->caps = gst_caps_copy (caps);
+    cache->info = *info;
+
+    /* replaces, and frees, an outdated entry */
+    g_mutex_lock (&video_info_cache_lock);
+    gst_mini_object_set_qdata (obj, video_info_cache_quark (), cache,
+        (GDestroyNotify) video_info_cache_free);
+    g_mutex_unlock (&video_info_cache_lock);
+  }
+
+  return res;
+}
+
 /**
  * gst_video_info_is_equal:
  * @info: a #GstVideoInfo
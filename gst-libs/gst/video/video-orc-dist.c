@@ -135,6 +135,12 @@ void video_orc_unpack_Y444 (guint8 * ORC_RESTRICT d1,
     const guint8 * ORC_RESTRICT s3, int n);
 void video_orc_pack_Y444 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
     guint8 * ORC_RESTRICT d3, const guint8 * ORC_RESTRICT s1, int n);
+void video_orc_unpack_Y444_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, const guint16 * ORC_RESTRICT s2,
+    const guint16 * ORC_RESTRICT s3, int p1, int p2, int n);
+void video_orc_pack_Y444_16 (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, guint16 * ORC_RESTRICT d3,
+    const guint8 * ORC_RESTRICT s1, int p1, int n);
 void video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
     const guint8 * ORC_RESTRICT s1, int n);
 void video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1,
@@ -453,6 +459,8 @@ void video_orc_chroma_down_v2_u8 (guint8 * ORC_RESTRICT d1,
 void video_orc_chroma_up_v2_u8 (guint8 * ORC_RESTRICT d1,
     guint8 * ORC_RESTRICT d2, const guint8 * ORC_RESTRICT s1,
     const guint8 * ORC_RESTRICT s2, int n);
+void video_orc_chroma_up_h2_u8 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2, int n);
 void video_orc_chroma_up_v2_u16 (guint16 * ORC_RESTRICT d1,
     guint16 * ORC_RESTRICT d2, const guint16 * ORC_RESTRICT s1,
     const guint16 * ORC_RESTRICT s2, int n);
@@ -469,6 +477,8 @@ void video_orc_dither_none_4u16_mask (guint16 * ORC_RESTRICT d1, orc_int64 p1,
     int n);
 void video_orc_dither_verterr_4u8_mask (guint8 * ORC_RESTRICT d1,
     guint16 * ORC_RESTRICT d2, orc_int64 p1, int n);
+void video_orc_dither_verterr_4u16_mask (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, orc_int64 p1, int n);
 void video_orc_dither_fs_muladd_u8 (guint16 * ORC_RESTRICT d1, int n);
 void video_orc_dither_ordered_u8 (guint8 * ORC_RESTRICT d1,
     const guint8 * ORC_RESTRICT s1, int n);
@@ -4611,116 +4621,192 @@ video_orc_pack_Y444 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
 #endif
 
 
-/* video_orc_unpack_GRAY8 */
+/* video_orc_unpack_Y444_16 */
 #ifdef DISABLE_ORC
 void
-video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
-    const guint8 * ORC_RESTRICT s1, int n)
+video_orc_unpack_Y444_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, const guint16 * ORC_RESTRICT s2,
+    const guint16 * ORC_RESTRICT s3, int p1, int p2, int n)
 {
   int i;
-  orc_union32 *ORC_RESTRICT ptr0;
-  const orc_int8 *ORC_RESTRICT ptr4;
-#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
-  volatile orc_int8 var33;
-#else
-  orc_int8 var33;
-#endif
-  orc_int8 var34;
-#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
-  volatile orc_union16 var35;
-#else
-  orc_union16 var35;
-#endif
-  orc_union32 var36;
+  orc_union64 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  orc_union16 var36;
   orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+  orc_union32 var49;
+  orc_union64 var50;
 
-  ptr0 = (orc_union32 *) d1;
-  ptr4 = (orc_int8 *) s1;
+  ptr0 = (orc_union64 *) d1;
+  ptr4 = (orc_union16 *) s1;
+  ptr5 = (orc_union16 *) s2;
+  ptr6 = (orc_union16 *) s3;
 
-  /* 0: loadpb */
-  var33 = 0x000000ff;           /* 255 or 1.25987e-321f */
-  /* 3: loadpw */
-  var35.i = 0x00008080;         /* 32896 or 1.62528e-319f */
+  /* 0: loadpw */
+  var37.i = p1;
+  /* 1: loadpw */
+  var38.i = p2;
+  /* 9: loadpw */
+  var39.i = 0x0000ffff;         /* 65535 or 3.23786e-319f */
 
   for (i = 0; i < n; i++) {
-    /* 1: loadb */
-    var34 = ptr4[i];
-    /* 2: mergebw */
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 0: shlw */
+    var40.i = var36.i << var37.i;
+    /* 1: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 2: orw */
+    var42.i = var40.i | var41.i;
+    /* 3: loadw */
+    var36 = ptr5[i];
+    /* 3: shlw */
+    var40.i = var36.i << var37.i;
+    /* 4: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 5: orw */
+    var43.i = var40.i | var41.i;
+    /* 6: loadw */
+    var36 = ptr6[i];
+    /* 6: shlw */
+    var40.i = var36.i << var37.i;
+    /* 7: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 8: orw */
+    var44.i = var40.i | var41.i;
+    /* 9: mergewl */
     {
-      orc_union16 _dest;
-      _dest.x2[0] = var33;
-      _dest.x2[1] = var34;
-      var37.i = _dest.i;
+      orc_union32 _dest;
+      _dest.x2[0] = var39.i;
+      _dest.x2[1] = var42.i;
+      var48.i = _dest.i;
     }
-    /* 4: mergewl */
+    /* 10: mergewl */
     {
       orc_union32 _dest;
-      _dest.x2[0] = var37.i;
-      _dest.x2[1] = var35.i;
-      var36.i = _dest.i;
+      _dest.x2[0] = var43.i;
+      _dest.x2[1] = var44.i;
+      var49.i = _dest.i;
     }
-    /* 5: storel */
-    ptr0[i] = var36;
+    /* 11: mergelq */
+    {
+      orc_union64 _dest;
+      _dest.x2[0] = var48.i;
+      _dest.x2[1] = var49.i;
+      var50.i = _dest.i;
+    }
+    /* 12: storeq */
+    ptr0[i] = var50;
   }
 
 }
 
 #else
 static void
-_backup_video_orc_unpack_GRAY8 (OrcExecutor * ORC_RESTRICT ex)
+_backup_video_orc_unpack_Y444_16 (OrcExecutor * ORC_RESTRICT ex)
 {
   int i;
   int n = ex->n;
-  orc_union32 *ORC_RESTRICT ptr0;
-  const orc_int8 *ORC_RESTRICT ptr4;
-#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
-  volatile orc_int8 var33;
-#else
-  orc_int8 var33;
-#endif
-  orc_int8 var34;
-#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
-  volatile orc_union16 var35;
-#else
-  orc_union16 var35;
-#endif
-  orc_union32 var36;
+  orc_union64 *ORC_RESTRICT ptr0;
+  const orc_union16 *ORC_RESTRICT ptr4;
+  const orc_union16 *ORC_RESTRICT ptr5;
+  const orc_union16 *ORC_RESTRICT ptr6;
+  orc_union16 var36;
   orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union16 var41;
+  orc_union16 var42;
+  orc_union16 var43;
+  orc_union16 var44;
+  orc_union16 var45;
+  orc_union16 var46;
+  orc_union16 var47;
+  orc_union32 var48;
+  orc_union32 var49;
+  orc_union64 var50;
 
-  ptr0 = (orc_union32 *) ex->arrays[0];
-  ptr4 = (orc_int8 *) ex->arrays[4];
+  ptr0 = (orc_union64 *) ex->arrays[0];
+  ptr4 = (orc_union16 *) ex->arrays[4];
+  ptr5 = (orc_union16 *) ex->arrays[5];
+  ptr6 = (orc_union16 *) ex->arrays[6];
 
-  /* 0: loadpb */
-  var33 = 0x000000ff;           /* 255 or 1.25987e-321f */
-  /* 3: loadpw */
-  var35.i = 0x00008080;         /* 32896 or 1.62528e-319f */
+  /* 0: loadpw */
+  var37.i = ex->params[24];
+  /* 1: loadpw */
+  var38.i = ex->params[25];
+  /* 9: loadpw */
+  var39.i = 0x0000ffff;         /* 65535 or 3.23786e-319f */
 
   for (i = 0; i < n; i++) {
-    /* 1: loadb */
-    var34 = ptr4[i];
-    /* 2: mergebw */
+    /* 0: loadw */
+    var36 = ptr4[i];
+    /* 0: shlw */
+    var40.i = var36.i << var37.i;
+    /* 1: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 2: orw */
+    var42.i = var40.i | var41.i;
+    /* 3: loadw */
+    var36 = ptr5[i];
+    /* 3: shlw */
+    var40.i = var36.i << var37.i;
+    /* 4: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 5: orw */
+    var43.i = var40.i | var41.i;
+    /* 6: loadw */
+    var36 = ptr6[i];
+    /* 6: shlw */
+    var40.i = var36.i << var37.i;
+    /* 7: shruw */
+    var41.i = ((orc_uint16) var36.i) >> var38.i;
+    /* 8: orw */
+    var44.i = var40.i | var41.i;
+    /* 9: mergewl */
     {
-      orc_union16 _dest;
-      _dest.x2[0] = var33;
-      _dest.x2[1] = var34;
-      var37.i = _dest.i;
+      orc_union32 _dest;
+      _dest.x2[0] = var39.i;
+      _dest.x2[1] = var42.i;
+      var48.i = _dest.i;
     }
-    /* 4: mergewl */
+    /* 10: mergewl */
     {
       orc_union32 _dest;
-      _dest.x2[0] = var37.i;
-      _dest.x2[1] = var35.i;
-      var36.i = _dest.i;
+      _dest.x2[0] = var43.i;
+      _dest.x2[1] = var44.i;
+      var49.i = _dest.i;
     }
-    /* 5: storel */
-    ptr0[i] = var36;
+    /* 11: mergelq */
+    {
+      orc_union64 _dest;
+      _dest.x2[0] = var48.i;
+      _dest.x2[1] = var49.i;
+      var50.i = _dest.i;
+    }
+    /* 12: storeq */
+    ptr0[i] = var50;
   }
 
 }
 
 void
-video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
-    const guint8 * ORC_RESTRICT s1, int n)
+video_orc_unpack_Y444_16 (guint8 * ORC_RESTRICT d1,
+    const guint16 * ORC_RESTRICT s1, const guint16 * ORC_RESTRICT s2,
+    const guint16 * ORC_RESTRICT s3, int p1, int p2, int n)
 {
   OrcExecutor _ex, *ex = &_ex;
   static volatile int p_inited = 0;
@@ -4734,26 +4820,59 @@ video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
 
 #if 1
       static const orc_uint8 bc[] = {
-        1, 9, 22, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 117, 110, 112,
-        97, 99, 107, 95, 71, 82, 65, 89, 56, 11, 4, 4, 12, 1, 1, 14,
-        1, 255, 0, 0, 0, 14, 2, 128, 128, 0, 0, 20, 2, 196, 32, 16,
-        4, 195, 0, 32, 17, 2, 0,
+        1, 9, 24, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 117, 110, 112,
+        97, 99, 107, 95, 89, 52, 52, 52, 95, 49, 54, 11, 8, 8, 12, 2,
+        2, 12, 2, 2, 12, 2, 2, 14, 2, 255, 255, 0, 0, 16, 2, 16,
+        2, 20, 2, 20, 2, 20, 2, 20, 2, 20, 2, 20, 4, 20, 4, 93,
+        32, 4, 24, 95, 33, 4, 25, 92, 34, 32, 33, 93, 32, 5, 24, 95,
+        33, 5, 25, 92, 35, 32, 33, 93, 32, 6, 24, 95, 33, 6, 25, 92,
+        36, 32, 33, 195, 37, 16, 34, 195, 38, 35, 36, 194, 0, 37, 38, 2,
+        0,
       };
       p = orc_program_new_from_static_bytecode (bc);
-      orc_program_set_backup_function (p, _backup_video_orc_unpack_GRAY8);
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_Y444_16);
 #else
       p = orc_program_new ();
-      orc_program_set_name (p, "video_orc_unpack_GRAY8");
-      orc_program_set_backup_function (p, _backup_video_orc_unpack_GRAY8);
-      orc_program_add_destination (p, 4, "d1");
-      orc_program_add_source (p, 1, "s1");
-      orc_program_add_constant (p, 1, 0x000000ff, "c1");
-      orc_program_add_constant (p, 2, 0x00008080, "c2");
+      orc_program_set_name (p, "video_orc_unpack_Y444_16");
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_Y444_16);
+      orc_program_add_destination (p, 8, "d1");
+      orc_program_add_source (p, 2, "s1");
+      orc_program_add_source (p, 2, "s2");
+      orc_program_add_source (p, 2, "s3");
+      orc_program_add_constant (p, 2, 0x0000ffff, "c1");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_parameter (p, 2, "p2");
       orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 2, "t4");
+      orc_program_add_temporary (p, 2, "t5");
+      orc_program_add_temporary (p, 4, "t6");
+      orc_program_add_temporary (p, 4, "t7");
 
-      orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T1, ORC_VAR_C1, ORC_VAR_S1,
+      orc_program_append_2 (p, "shlw", 0, ORC_VAR_T1, ORC_VAR_S1, ORC_VAR_P1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_C2,
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_T2, ORC_VAR_S1, ORC_VAR_P2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 0, ORC_VAR_T1, ORC_VAR_S2, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_T2, ORC_VAR_S2, ORC_VAR_P2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T4, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shlw", 0, ORC_VAR_T1, ORC_VAR_S3, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_T2, ORC_VAR_S3, ORC_VAR_P2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "orw", 0, ORC_VAR_T5, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T6, ORC_VAR_C1, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T7, ORC_VAR_T4, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergelq", 0, ORC_VAR_D1, ORC_VAR_T6, ORC_VAR_T7,
           ORC_VAR_D1);
 #endif
 
@@ -4770,6 +4889,10 @@ video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
   ex->n = n;
   ex->arrays[ORC_VAR_D1] = d1;
   ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+  ex->arrays[ORC_VAR_S3] = (void *) s3;
+  ex->params[ORC_VAR_P1] = p1;
+  ex->params[ORC_VAR_P2] = p2;
 
   func = c->exec;
   func (ex);
@@ -4777,84 +4900,154 @@ video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
 #endif
 
 
-/* video_orc_pack_GRAY8 */
+/* video_orc_pack_Y444_16 */
 #ifdef DISABLE_ORC
 void
-video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
-    int n)
+video_orc_pack_Y444_16 (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, guint16 * ORC_RESTRICT d3,
+    const guint8 * ORC_RESTRICT s1, int p1, int n)
 {
   int i;
-  orc_int8 *ORC_RESTRICT ptr0;
-  const orc_union32 *ORC_RESTRICT ptr4;
-  orc_union32 var33;
-  orc_int8 var34;
-  orc_union16 var35;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union64 *ORC_RESTRICT ptr4;
+  orc_union64 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union16 var43;
 
-  ptr0 = (orc_int8 *) d1;
-  ptr4 = (orc_union32 *) s1;
+  ptr0 = (orc_union16 *) d1;
+  ptr1 = (orc_union16 *) d2;
+  ptr2 = (orc_union16 *) d3;
+  ptr4 = (orc_union64 *) s1;
 
+  /* 2: loadpw */
+  var37.i = p1;
 
   for (i = 0; i < n; i++) {
-    /* 0: loadl */
-    var33 = ptr4[i];
-    /* 1: select0lw */
+    /* 0: loadq */
+    var36 = ptr4[i];
+    /* 0: splitql */
+    {
+      orc_union64 _src;
+      _src.i = var36.i;
+      var42.i = _src.x2[1];
+      var41.i = _src.x2[0];
+    }
+    /* 1: select1lw */
     {
       orc_union32 _src;
-      _src.i = var33.i;
-      var35.i = _src.x2[0];
+      _src.i = var41.i;
+      var43.i = _src.x2[1];
     }
-    /* 2: select1wb */
+    /* 2: shruw */
+    var38.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 3: storew */
+    ptr0[i] = var38;
+    /* 3: select0lw */
     {
-      orc_union16 _src;
-      _src.i = var35.i;
-      var34 = _src.x2[1];
+      orc_union32 _src;
+      _src.i = var42.i;
+      var43.i = _src.x2[0];
     }
-    /* 3: storeb */
-    ptr0[i] = var34;
+    /* 4: shruw */
+    var39.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 5: storew */
+    ptr1[i] = var39;
+    /* 5: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var42.i;
+      var43.i = _src.x2[1];
+    }
+    /* 6: shruw */
+    var40.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 7: storew */
+    ptr2[i] = var40;
   }
 
 }
 
 #else
 static void
-_backup_video_orc_pack_GRAY8 (OrcExecutor * ORC_RESTRICT ex)
+_backup_video_orc_pack_Y444_16 (OrcExecutor * ORC_RESTRICT ex)
 {
   int i;
   int n = ex->n;
-  orc_int8 *ORC_RESTRICT ptr0;
-  const orc_union32 *ORC_RESTRICT ptr4;
-  orc_union32 var33;
-  orc_int8 var34;
-  orc_union16 var35;
+  orc_union16 *ORC_RESTRICT ptr0;
+  orc_union16 *ORC_RESTRICT ptr1;
+  orc_union16 *ORC_RESTRICT ptr2;
+  const orc_union64 *ORC_RESTRICT ptr4;
+  orc_union64 var36;
+  orc_union16 var37;
+  orc_union16 var38;
+  orc_union16 var39;
+  orc_union16 var40;
+  orc_union32 var41;
+  orc_union32 var42;
+  orc_union16 var43;
 
-  ptr0 = (orc_int8 *) ex->arrays[0];
-  ptr4 = (orc_union32 *) ex->arrays[4];
+  ptr0 = (orc_union16 *) ex->arrays[0];
+  ptr1 = (orc_union16 *) ex->arrays[1];
+  ptr2 = (orc_union16 *) ex->arrays[2];
+  ptr4 = (orc_union64 *) ex->arrays[4];
 
+  /* 2: loadpw */
+  var37.i = ex->params[24];
 
   for (i = 0; i < n; i++) {
-    /* 0: loadl */
-    var33 = ptr4[i];
-    /* 1: select0lw */
+    /* 0: loadq */
+    var36 = ptr4[i];
+    /* 0: splitql */
+    {
+      orc_union64 _src;
+      _src.i = var36.i;
+      var42.i = _src.x2[1];
+      var41.i = _src.x2[0];
+    }
+    /* 1: select1lw */
     {
       orc_union32 _src;
-      _src.i = var33.i;
-      var35.i = _src.x2[0];
+      _src.i = var41.i;
+      var43.i = _src.x2[1];
     }
-    /* 2: select1wb */
+    /* 2: shruw */
+    var38.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 3: storew */
+    ptr0[i] = var38;
+    /* 3: select0lw */
     {
-      orc_union16 _src;
-      _src.i = var35.i;
-      var34 = _src.x2[1];
+      orc_union32 _src;
+      _src.i = var42.i;
+      var43.i = _src.x2[0];
     }
-    /* 3: storeb */
-    ptr0[i] = var34;
+    /* 4: shruw */
+    var39.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 5: storew */
+    ptr1[i] = var39;
+    /* 5: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var42.i;
+      var43.i = _src.x2[1];
+    }
+    /* 6: shruw */
+    var40.i = ((orc_uint16) var43.i) >> var37.i;
+    /* 7: storew */
+    ptr2[i] = var40;
   }
 
 }
 
 void
-video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
-    int n)
+video_orc_pack_Y444_16 (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, guint16 * ORC_RESTRICT d3,
+    const guint8 * ORC_RESTRICT s1, int p1, int n)
 {
   OrcExecutor _ex, *ex = &_ex;
   static volatile int p_inited = 0;
@@ -4868,24 +5061,41 @@ video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
 
 #if 1
       static const orc_uint8 bc[] = {
-        1, 9, 20, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 112, 97, 99,
-        107, 95, 71, 82, 65, 89, 56, 11, 1, 1, 12, 4, 4, 20, 2, 190,
-        32, 4, 189, 0, 32, 2, 0,
+        1, 9, 22, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 112, 97, 99,
+        107, 95, 89, 52, 52, 52, 95, 49, 54, 11, 2, 2, 11, 2, 2, 11,
+        2, 2, 12, 8, 8, 16, 2, 20, 4, 20, 4, 20, 2, 197, 33, 32,
+        4, 191, 34, 32, 95, 0, 34, 24, 190, 34, 33, 95, 1, 34, 24, 191,
+        34, 33, 95, 2, 34, 24, 2, 0,
       };
       p = orc_program_new_from_static_bytecode (bc);
-      orc_program_set_backup_function (p, _backup_video_orc_pack_GRAY8);
+      orc_program_set_backup_function (p, _backup_video_orc_pack_Y444_16);
 #else
       p = orc_program_new ();
-      orc_program_set_name (p, "video_orc_pack_GRAY8");
-      orc_program_set_backup_function (p, _backup_video_orc_pack_GRAY8);
-      orc_program_add_destination (p, 1, "d1");
-      orc_program_add_source (p, 4, "s1");
-      orc_program_add_temporary (p, 2, "t1");
+      orc_program_set_name (p, "video_orc_pack_Y444_16");
+      orc_program_set_backup_function (p, _backup_video_orc_pack_Y444_16);
+      orc_program_add_destination (p, 2, "d1");
+      orc_program_add_destination (p, 2, "d2");
+      orc_program_add_destination (p, 2, "d3");
+      orc_program_add_source (p, 8, "s1");
+      orc_program_add_parameter (p, 2, "p1");
+      orc_program_add_temporary (p, 4, "t1");
+      orc_program_add_temporary (p, 4, "t2");
+      orc_program_add_temporary (p, 2, "t3");
 
-      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T1, ORC_VAR_S1,
+      orc_program_append_2 (p, "splitql", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_S1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T3, ORC_VAR_T1,
           ORC_VAR_D1, ORC_VAR_D1);
-      orc_program_append_2 (p, "select1wb", 0, ORC_VAR_D1, ORC_VAR_T1,
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_D1, ORC_VAR_T3, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T3, ORC_VAR_T2,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_D2, ORC_VAR_T3, ORC_VAR_P1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T3, ORC_VAR_T2,
           ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 0, ORC_VAR_D3, ORC_VAR_T3, ORC_VAR_P1,
+          ORC_VAR_D1);
 #endif
 
       orc_program_compile (p);
@@ -4900,7 +5110,10 @@ video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
 
   ex->n = n;
   ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_D3] = d3;
   ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->params[ORC_VAR_P1] = p1;
 
   func = c->exec;
   func (ex);
@@ -4908,62 +5121,116 @@ video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
 #endif
 
 
-/* video_orc_unpack_BGRA */
+/* video_orc_unpack_GRAY8 */
 #ifdef DISABLE_ORC
 void
-video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
-    int n)
+video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, int n)
 {
   int i;
   orc_union32 *ORC_RESTRICT ptr0;
-  const orc_union32 *ORC_RESTRICT ptr4;
-  orc_union32 var32;
-  orc_union32 var33;
+  const orc_int8 *ORC_RESTRICT ptr4;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_int8 var33;
+#else
+  orc_int8 var33;
+#endif
+  orc_int8 var34;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union16 var35;
+#else
+  orc_union16 var35;
+#endif
+  orc_union32 var36;
+  orc_union16 var37;
 
   ptr0 = (orc_union32 *) d1;
-  ptr4 = (orc_union32 *) s1;
+  ptr4 = (orc_int8 *) s1;
 
+  /* 0: loadpb */
+  var33 = 0x000000ff;           /* 255 or 1.25987e-321f */
+  /* 3: loadpw */
+  var35.i = 0x00008080;         /* 32896 or 1.62528e-319f */
 
   for (i = 0; i < n; i++) {
-    /* 0: loadl */
-    var32 = ptr4[i];
-    /* 1: swapl */
-    var33.i = ORC_SWAP_L (var32.i);
-    /* 2: storel */
-    ptr0[i] = var33;
+    /* 1: loadb */
+    var34 = ptr4[i];
+    /* 2: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var33;
+      _dest.x2[1] = var34;
+      var37.i = _dest.i;
+    }
+    /* 4: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var37.i;
+      _dest.x2[1] = var35.i;
+      var36.i = _dest.i;
+    }
+    /* 5: storel */
+    ptr0[i] = var36;
   }
 
 }
 
 #else
 static void
-_backup_video_orc_unpack_BGRA (OrcExecutor * ORC_RESTRICT ex)
+_backup_video_orc_unpack_GRAY8 (OrcExecutor * ORC_RESTRICT ex)
 {
   int i;
   int n = ex->n;
   orc_union32 *ORC_RESTRICT ptr0;
-  const orc_union32 *ORC_RESTRICT ptr4;
-  orc_union32 var32;
-  orc_union32 var33;
+  const orc_int8 *ORC_RESTRICT ptr4;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_int8 var33;
+#else
+  orc_int8 var33;
+#endif
+  orc_int8 var34;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union16 var35;
+#else
+  orc_union16 var35;
+#endif
+  orc_union32 var36;
+  orc_union16 var37;
 
   ptr0 = (orc_union32 *) ex->arrays[0];
-  ptr4 = (orc_union32 *) ex->arrays[4];
+  ptr4 = (orc_int8 *) ex->arrays[4];
 
+  /* 0: loadpb */
+  var33 = 0x000000ff;           /* 255 or 1.25987e-321f */
+  /* 3: loadpw */
+  var35.i = 0x00008080;         /* 32896 or 1.62528e-319f */
 
   for (i = 0; i < n; i++) {
-    /* 0: loadl */
-    var32 = ptr4[i];
-    /* 1: swapl */
-    var33.i = ORC_SWAP_L (var32.i);
-    /* 2: storel */
-    ptr0[i] = var33;
+    /* 1: loadb */
+    var34 = ptr4[i];
+    /* 2: mergebw */
+    {
+      orc_union16 _dest;
+      _dest.x2[0] = var33;
+      _dest.x2[1] = var34;
+      var37.i = _dest.i;
+    }
+    /* 4: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var37.i;
+      _dest.x2[1] = var35.i;
+      var36.i = _dest.i;
+    }
+    /* 5: storel */
+    ptr0[i] = var36;
   }
 
 }
 
 void
-video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
-    int n)
+video_orc_unpack_GRAY8 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, int n)
 {
   OrcExecutor _ex, *ex = &_ex;
   static volatile int p_inited = 0;
@@ -4977,20 +5244,26 @@ video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
 
 #if 1
       static const orc_uint8 bc[] = {
-        1, 9, 21, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 117, 110, 112,
-        97, 99, 107, 95, 66, 71, 82, 65, 11, 4, 4, 12, 4, 4, 184, 0,
-        4, 2, 0,
+        1, 9, 22, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 117, 110, 112,
+        97, 99, 107, 95, 71, 82, 65, 89, 56, 11, 4, 4, 12, 1, 1, 14,
+        1, 255, 0, 0, 0, 14, 2, 128, 128, 0, 0, 20, 2, 196, 32, 16,
+        4, 195, 0, 32, 17, 2, 0,
       };
       p = orc_program_new_from_static_bytecode (bc);
-      orc_program_set_backup_function (p, _backup_video_orc_unpack_BGRA);
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_GRAY8);
 #else
       p = orc_program_new ();
-      orc_program_set_name (p, "video_orc_unpack_BGRA");
-      orc_program_set_backup_function (p, _backup_video_orc_unpack_BGRA);
+      orc_program_set_name (p, "video_orc_unpack_GRAY8");
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_GRAY8);
       orc_program_add_destination (p, 4, "d1");
-      orc_program_add_source (p, 4, "s1");
+      orc_program_add_source (p, 1, "s1");
+      orc_program_add_constant (p, 1, 0x000000ff, "c1");
+      orc_program_add_constant (p, 2, 0x00008080, "c2");
+      orc_program_add_temporary (p, 2, "t1");
 
-      orc_program_append_2 (p, "swapl", 0, ORC_VAR_D1, ORC_VAR_S1, ORC_VAR_D1,
+      orc_program_append_2 (p, "mergebw", 0, ORC_VAR_T1, ORC_VAR_C1, ORC_VAR_S1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_C2,
           ORC_VAR_D1);
 #endif
 
@@ -5014,40 +5287,277 @@ video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
 #endif
 
 
-/* video_orc_pack_BGRA */
+/* video_orc_pack_GRAY8 */
 #ifdef DISABLE_ORC
 void
-video_orc_pack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
+video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
     int n)
 {
   int i;
-  orc_union32 *ORC_RESTRICT ptr0;
+  orc_int8 *ORC_RESTRICT ptr0;
   const orc_union32 *ORC_RESTRICT ptr4;
-  orc_union32 var32;
   orc_union32 var33;
+  orc_int8 var34;
+  orc_union16 var35;
 
-  ptr0 = (orc_union32 *) d1;
+  ptr0 = (orc_int8 *) d1;
   ptr4 = (orc_union32 *) s1;
 
 
   for (i = 0; i < n; i++) {
     /* 0: loadl */
-    var32 = ptr4[i];
-    /* 1: swapl */
-    var33.i = ORC_SWAP_L (var32.i);
-    /* 2: storel */
-    ptr0[i] = var33;
-  }
-
-}
-
-#else
-static void
-_backup_video_orc_pack_BGRA (OrcExecutor * ORC_RESTRICT ex)
-{
-  int i;
-  int n = ex->n;
-  orc_union32 *ORC_RESTRICT ptr0;
+    var33 = ptr4[i];
+    /* 1: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var33.i;
+      var35.i = _src.x2[0];
+    }
+    /* 2: select1wb */
+    {
+      orc_union16 _src;
+      _src.i = var35.i;
+      var34 = _src.x2[1];
+    }
+    /* 3: storeb */
+    ptr0[i] = var34;
+  }
+
+}
+
+#else
+static void
+_backup_video_orc_pack_GRAY8 (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var33;
+  orc_int8 var34;
+  orc_union16 var35;
+
+  ptr0 = (orc_int8 *) ex->arrays[0];
+  ptr4 = (orc_union32 *) ex->arrays[4];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var33 = ptr4[i];
+    /* 1: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var33.i;
+      var35.i = _src.x2[0];
+    }
+    /* 2: select1wb */
+    {
+      orc_union16 _src;
+      _src.i = var35.i;
+      var34 = _src.x2[1];
+    }
+    /* 3: storeb */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+video_orc_pack_GRAY8 (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+#if 1
+      static const orc_uint8 bc[] = {
+        1, 9, 20, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 112, 97, 99,
+        107, 95, 71, 82, 65, 89, 56, 11, 1, 1, 12, 4, 4, 20, 2, 190,
+        32, 4, 189, 0, 32, 2, 0,
+      };
+      p = orc_program_new_from_static_bytecode (bc);
+      orc_program_set_backup_function (p, _backup_video_orc_pack_GRAY8);
+#else
+      p = orc_program_new ();
+      orc_program_set_name (p, "video_orc_pack_GRAY8");
+      orc_program_set_backup_function (p, _backup_video_orc_pack_GRAY8);
+      orc_program_add_destination (p, 1, "d1");
+      orc_program_add_source (p, 4, "s1");
+      orc_program_add_temporary (p, 2, "t1");
+
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T1, ORC_VAR_S1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select1wb", 0, ORC_VAR_D1, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+#endif
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* video_orc_unpack_BGRA */
+#ifdef DISABLE_ORC
+void
+video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
+    int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union32 *) s1;
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: swapl */
+    var33.i = ORC_SWAP_L (var32.i);
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+#else
+static void
+_backup_video_orc_unpack_BGRA (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *) ex->arrays[0];
+  ptr4 = (orc_union32 *) ex->arrays[4];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: swapl */
+    var33.i = ORC_SWAP_L (var32.i);
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+video_orc_unpack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
+    int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+#if 1
+      static const orc_uint8 bc[] = {
+        1, 9, 21, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 117, 110, 112,
+        97, 99, 107, 95, 66, 71, 82, 65, 11, 4, 4, 12, 4, 4, 184, 0,
+        4, 2, 0,
+      };
+      p = orc_program_new_from_static_bytecode (bc);
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_BGRA);
+#else
+      p = orc_program_new ();
+      orc_program_set_name (p, "video_orc_unpack_BGRA");
+      orc_program_set_backup_function (p, _backup_video_orc_unpack_BGRA);
+      orc_program_add_destination (p, 4, "d1");
+      orc_program_add_source (p, 4, "s1");
+
+      orc_program_append_2 (p, "swapl", 0, ORC_VAR_D1, ORC_VAR_S1, ORC_VAR_D1,
+          ORC_VAR_D1);
+#endif
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* video_orc_pack_BGRA */
+#ifdef DISABLE_ORC
+void
+video_orc_pack_BGRA (guint8 * ORC_RESTRICT d1, const guint8 * ORC_RESTRICT s1,
+    int n)
+{
+  int i;
+  orc_union32 *ORC_RESTRICT ptr0;
+  const orc_union32 *ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *) d1;
+  ptr4 = (orc_union32 *) s1;
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: swapl */
+    var33.i = ORC_SWAP_L (var32.i);
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+#else
+static void
+_backup_video_orc_pack_BGRA (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0;
   const orc_union32 *ORC_RESTRICT ptr4;
   orc_union32 var32;
   orc_union32 var33;
@@ -30369,66 +30879,480 @@ _backup_video_orc_chroma_up_v2_u8 (OrcExecutor * ORC_RESTRICT ex)
       var47.i = _src.x2[1];
       var48.i = _src.x2[0];
     }
-    /* 4: convubw */
-    var49.x2[0] = (orc_uint8) var45.x2[0];
-    var49.x2[1] = (orc_uint8) var45.x2[1];
-    /* 5: convubw */
-    var50.x2[0] = (orc_uint8) var47.x2[0];
-    var50.x2[1] = (orc_uint8) var47.x2[1];
-    /* 7: mullw */
-    var51.x2[0] = (var49.x2[0] * var41.x2[0]) & 0xffff;
-    var51.x2[1] = (var49.x2[1] * var41.x2[1]) & 0xffff;
-    /* 8: addw */
-    var52.x2[0] = var51.x2[0] + var50.x2[0];
-    var52.x2[1] = var51.x2[1] + var50.x2[1];
-    /* 10: addw */
-    var53.x2[0] = var52.x2[0] + var42.x2[0];
-    var53.x2[1] = var52.x2[1] + var42.x2[1];
-    /* 11: shruw */
-    var54.x2[0] = ((orc_uint16) var53.x2[0]) >> 2;
-    var54.x2[1] = ((orc_uint16) var53.x2[1]) >> 2;
-    /* 12: convsuswb */
-    var55.x2[0] = ORC_CLAMP_UB (var54.x2[0]);
-    var55.x2[1] = ORC_CLAMP_UB (var54.x2[1]);
-    /* 13: mergewl */
+    /* 4: convubw */
+    var49.x2[0] = (orc_uint8) var45.x2[0];
+    var49.x2[1] = (orc_uint8) var45.x2[1];
+    /* 5: convubw */
+    var50.x2[0] = (orc_uint8) var47.x2[0];
+    var50.x2[1] = (orc_uint8) var47.x2[1];
+    /* 7: mullw */
+    var51.x2[0] = (var49.x2[0] * var41.x2[0]) & 0xffff;
+    var51.x2[1] = (var49.x2[1] * var41.x2[1]) & 0xffff;
+    /* 8: addw */
+    var52.x2[0] = var51.x2[0] + var50.x2[0];
+    var52.x2[1] = var51.x2[1] + var50.x2[1];
+    /* 10: addw */
+    var53.x2[0] = var52.x2[0] + var42.x2[0];
+    var53.x2[1] = var52.x2[1] + var42.x2[1];
+    /* 11: shruw */
+    var54.x2[0] = ((orc_uint16) var53.x2[0]) >> 2;
+    var54.x2[1] = ((orc_uint16) var53.x2[1]) >> 2;
+    /* 12: convsuswb */
+    var55.x2[0] = ORC_CLAMP_UB (var54.x2[0]);
+    var55.x2[1] = ORC_CLAMP_UB (var54.x2[1]);
+    /* 13: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var46.i;
+      _dest.x2[1] = var55.i;
+      var43.i = _dest.i;
+    }
+    /* 14: storel */
+    ptr0[i] = var43;
+    /* 15: mullw */
+    var56.x2[0] = (var50.x2[0] * var41.x2[0]) & 0xffff;
+    var56.x2[1] = (var50.x2[1] * var41.x2[1]) & 0xffff;
+    /* 16: addw */
+    var57.x2[0] = var56.x2[0] + var49.x2[0];
+    var57.x2[1] = var56.x2[1] + var49.x2[1];
+    /* 17: addw */
+    var58.x2[0] = var57.x2[0] + var42.x2[0];
+    var58.x2[1] = var57.x2[1] + var42.x2[1];
+    /* 18: shruw */
+    var59.x2[0] = ((orc_uint16) var58.x2[0]) >> 2;
+    var59.x2[1] = ((orc_uint16) var58.x2[1]) >> 2;
+    /* 19: convsuswb */
+    var60.x2[0] = ORC_CLAMP_UB (var59.x2[0]);
+    var60.x2[1] = ORC_CLAMP_UB (var59.x2[1]);
+    /* 20: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var48.i;
+      _dest.x2[1] = var60.i;
+      var44.i = _dest.i;
+    }
+    /* 21: storel */
+    ptr1[i] = var44;
+  }
+
+}
+
+void
+video_orc_chroma_up_v2_u8 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+#if 1
+      static const orc_uint8 bc[] = {
+        1, 9, 25, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 99, 104, 114,
+        111, 109, 97, 95, 117, 112, 95, 118, 50, 95, 117, 56, 11, 4, 4, 11,
+        4, 4, 12, 4, 4, 12, 4, 4, 14, 2, 3, 0, 0, 0, 14, 2,
+        2, 0, 0, 0, 20, 2, 20, 2, 20, 2, 20, 2, 20, 4, 20, 4,
+        20, 4, 198, 34, 32, 4, 198, 35, 33, 5, 21, 1, 150, 36, 34, 21,
+        1, 150, 37, 35, 21, 1, 89, 38, 36, 16, 21, 1, 70, 38, 38, 37,
+        21, 1, 70, 38, 38, 17, 21, 1, 95, 38, 38, 17, 21, 1, 160, 34,
+        38, 195, 0, 32, 34, 21, 1, 89, 38, 37, 16, 21, 1, 70, 38, 38,
+        36, 21, 1, 70, 38, 38, 17, 21, 1, 95, 38, 38, 17, 21, 1, 160,
+        35, 38, 195, 1, 33, 35, 2, 0,
+      };
+      p = orc_program_new_from_static_bytecode (bc);
+      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_v2_u8);
+#else
+      p = orc_program_new ();
+      orc_program_set_name (p, "video_orc_chroma_up_v2_u8");
+      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_v2_u8);
+      orc_program_add_destination (p, 4, "d1");
+      orc_program_add_destination (p, 4, "d2");
+      orc_program_add_source (p, 4, "s1");
+      orc_program_add_source (p, 4, "s2");
+      orc_program_add_constant (p, 2, 0x00000003, "c1");
+      orc_program_add_constant (p, 2, 0x00000002, "c2");
+      orc_program_add_temporary (p, 2, "t1");
+      orc_program_add_temporary (p, 2, "t2");
+      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 2, "t4");
+      orc_program_add_temporary (p, 4, "t5");
+      orc_program_add_temporary (p, 4, "t6");
+      orc_program_add_temporary (p, 4, "t7");
+
+      orc_program_append_2 (p, "splitlw", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_S1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "splitlw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_S2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_C1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T6,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T3, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T3,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_C1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T4, ORC_VAR_T7,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D2, ORC_VAR_T2, ORC_VAR_T4,
+          ORC_VAR_D1);
+#endif
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  ex->arrays[ORC_VAR_S1] = (void *) s1;
+  ex->arrays[ORC_VAR_S2] = (void *) s2;
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
+/* video_orc_chroma_up_h2_u8 */
+#ifdef DISABLE_ORC
+void
+video_orc_chroma_up_h2_u8 (guint8 * ORC_RESTRICT d1,
+    const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2, int n)
+{
+  int i;
+  orc_union64 *ORC_RESTRICT ptr0;
+  const orc_union64 *ORC_RESTRICT ptr4;
+  const orc_union64 *ORC_RESTRICT ptr5;
+  orc_union64 var39;
+  orc_union64 var40;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union32 var41;
+#else
+  orc_union32 var41;
+#endif
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union32 var42;
+#else
+  orc_union32 var42;
+#endif
+  orc_union64 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union32 var52;
+  orc_union32 var53;
+  orc_union32 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union32 var58;
+  orc_union32 var59;
+  orc_union32 var60;
+  orc_union32 var61;
+  orc_union32 var62;
+  orc_union16 var63;
+  orc_union32 var64;
+
+  ptr0 = (orc_union64 *) d1;
+  ptr4 = (orc_union64 *) s1;
+  ptr5 = (orc_union64 *) s2;
+
+  /* 9: loadpw */
+  var41.x2[0] = 0x00000003;     /* 3 or 1.4822e-323f */
+  var41.x2[1] = 0x00000003;     /* 3 or 1.4822e-323f */
+  /* 12: loadpw */
+  var42.x2[0] = 0x00000002;     /* 2 or 9.88131e-324f */
+  var42.x2[1] = 0x00000002;     /* 2 or 9.88131e-324f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var39 = ptr4[i];
+    /* 1: splitql */
+    {
+      orc_union64 _src;
+      _src.i = var39.i;
+      var44.i = _src.x2[1];
+      var45.i = _src.x2[0];
+    }
+    /* 2: loadq */
+    var40 = ptr5[i];
+    /* 3: select0ql */
+    {
+      orc_union64 _src;
+      _src.i = var40.i;
+      var46.i = _src.x2[0];
+    }
+    /* 4: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var45.i;
+      var47.i = _src.x2[0];
+    }
+    /* 5: splitlw */
+    {
+      orc_union32 _src;
+      _src.i = var44.i;
+      var48.i = _src.x2[1];
+      var49.i = _src.x2[0];
+    }
+    /* 6: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var46.i;
+      var50.i = _src.x2[1];
+    }
+    /* 7: convubw */
+    var51.x2[0] = (orc_uint8) var50.x2[0];
+    var51.x2[1] = (orc_uint8) var50.x2[1];
+    /* 8: convubw */
+    var52.x2[0] = (orc_uint8) var48.x2[0];
+    var52.x2[1] = (orc_uint8) var48.x2[1];
+    /* 10: mullw */
+    var53.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var53.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 11: addw */
+    var54.x2[0] = var53.x2[0] + var52.x2[0];
+    var54.x2[1] = var53.x2[1] + var52.x2[1];
+    /* 13: addw */
+    var55.x2[0] = var54.x2[0] + var42.x2[0];
+    var55.x2[1] = var54.x2[1] + var42.x2[1];
+    /* 14: shruw */
+    var56.x2[0] = ((orc_uint16) var55.x2[0]) >> 2;
+    var56.x2[1] = ((orc_uint16) var55.x2[1]) >> 2;
+    /* 15: convsuswb */
+    var57.x2[0] = ORC_CLAMP_UB (var56.x2[0]);
+    var57.x2[1] = ORC_CLAMP_UB (var56.x2[1]);
+    /* 16: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var47.i;
+      _dest.x2[1] = var57.i;
+      var58.i = _dest.i;
+    }
+    /* 17: mullw */
+    var59.x2[0] = (var52.x2[0] * var41.x2[0]) & 0xffff;
+    var59.x2[1] = (var52.x2[1] * var41.x2[1]) & 0xffff;
+    /* 18: addw */
+    var60.x2[0] = var59.x2[0] + var51.x2[0];
+    var60.x2[1] = var59.x2[1] + var51.x2[1];
+    /* 19: addw */
+    var61.x2[0] = var60.x2[0] + var42.x2[0];
+    var61.x2[1] = var60.x2[1] + var42.x2[1];
+    /* 20: shruw */
+    var62.x2[0] = ((orc_uint16) var61.x2[0]) >> 2;
+    var62.x2[1] = ((orc_uint16) var61.x2[1]) >> 2;
+    /* 21: convsuswb */
+    var63.x2[0] = ORC_CLAMP_UB (var62.x2[0]);
+    var63.x2[1] = ORC_CLAMP_UB (var62.x2[1]);
+    /* 22: mergewl */
+    {
+      orc_union32 _dest;
+      _dest.x2[0] = var49.i;
+      _dest.x2[1] = var63.i;
+      var64.i = _dest.i;
+    }
+    /* 23: mergelq */
+    {
+      orc_union64 _dest;
+      _dest.x2[0] = var58.i;
+      _dest.x2[1] = var64.i;
+      var43.i = _dest.i;
+    }
+    /* 24: storeq */
+    ptr0[i] = var43;
+  }
+
+}
+
+#else
+static void
+_backup_video_orc_chroma_up_h2_u8 (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union64 *ORC_RESTRICT ptr0;
+  const orc_union64 *ORC_RESTRICT ptr4;
+  const orc_union64 *ORC_RESTRICT ptr5;
+  orc_union64 var39;
+  orc_union64 var40;
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union32 var41;
+#else
+  orc_union32 var41;
+#endif
+#if defined(__APPLE__) && __GNUC__ == 4 && __GNUC_MINOR__ == 2 && defined (__i386__)
+  volatile orc_union32 var42;
+#else
+  orc_union32 var42;
+#endif
+  orc_union64 var43;
+  orc_union32 var44;
+  orc_union32 var45;
+  orc_union32 var46;
+  orc_union16 var47;
+  orc_union16 var48;
+  orc_union16 var49;
+  orc_union16 var50;
+  orc_union32 var51;
+  orc_union32 var52;
+  orc_union32 var53;
+  orc_union32 var54;
+  orc_union32 var55;
+  orc_union32 var56;
+  orc_union16 var57;
+  orc_union32 var58;
+  orc_union32 var59;
+  orc_union32 var60;
+  orc_union32 var61;
+  orc_union32 var62;
+  orc_union16 var63;
+  orc_union32 var64;
+
+  ptr0 = (orc_union64 *) ex->arrays[0];
+  ptr4 = (orc_union64 *) ex->arrays[4];
+  ptr5 = (orc_union64 *) ex->arrays[5];
+
+  /* 9: loadpw */
+  var41.x2[0] = 0x00000003;     /* 3 or 1.4822e-323f */
+  var41.x2[1] = 0x00000003;     /* 3 or 1.4822e-323f */
+  /* 12: loadpw */
+  var42.x2[0] = 0x00000002;     /* 2 or 9.88131e-324f */
+  var42.x2[1] = 0x00000002;     /* 2 or 9.88131e-324f */
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var39 = ptr4[i];
+    /* 1: splitql */
+    {
+      orc_union64 _src;
+      _src.i = var39.i;
+      var44.i = _src.x2[1];
+      var45.i = _src.x2[0];
+    }
+    /* 2: loadq */
+    var40 = ptr5[i];
+    /* 3: select0ql */
+    {
+      orc_union64 _src;
+      _src.i = var40.i;
+      var46.i = _src.x2[0];
+    }
+    /* 4: select0lw */
+    {
+      orc_union32 _src;
+      _src.i = var45.i;
+      var47.i = _src.x2[0];
+    }
+    /* 5: splitlw */
+    {
+      orc_union32 _src;
+      _src.i = var44.i;
+      var48.i = _src.x2[1];
+      var49.i = _src.x2[0];
+    }
+    /* 6: select1lw */
+    {
+      orc_union32 _src;
+      _src.i = var46.i;
+      var50.i = _src.x2[1];
+    }
+    /* 7: convubw */
+    var51.x2[0] = (orc_uint8) var50.x2[0];
+    var51.x2[1] = (orc_uint8) var50.x2[1];
+    /* 8: convubw */
+    var52.x2[0] = (orc_uint8) var48.x2[0];
+    var52.x2[1] = (orc_uint8) var48.x2[1];
+    /* 10: mullw */
+    var53.x2[0] = (var51.x2[0] * var41.x2[0]) & 0xffff;
+    var53.x2[1] = (var51.x2[1] * var41.x2[1]) & 0xffff;
+    /* 11: addw */
+    var54.x2[0] = var53.x2[0] + var52.x2[0];
+    var54.x2[1] = var53.x2[1] + var52.x2[1];
+    /* 13: addw */
+    var55.x2[0] = var54.x2[0] + var42.x2[0];
+    var55.x2[1] = var54.x2[1] + var42.x2[1];
+    /* 14: shruw */
+    var56.x2[0] = ((orc_uint16) var55.x2[0]) >> 2;
+    var56.x2[1] = ((orc_uint16) var55.x2[1]) >> 2;
+    /* 15: convsuswb */
+    var57.x2[0] = ORC_CLAMP_UB (var56.x2[0]);
+    var57.x2[1] = ORC_CLAMP_UB (var56.x2[1]);
+    /* 16: mergewl */
     {
       orc_union32 _dest;
-      _dest.x2[0] = var46.i;
-      _dest.x2[1] = var55.i;
-      var43.i = _dest.i;
+      _dest.x2[0] = var47.i;
+      _dest.x2[1] = var57.i;
+      var58.i = _dest.i;
     }
-    /* 14: storel */
-    ptr0[i] = var43;
-    /* 15: mullw */
-    var56.x2[0] = (var50.x2[0] * var41.x2[0]) & 0xffff;
-    var56.x2[1] = (var50.x2[1] * var41.x2[1]) & 0xffff;
-    /* 16: addw */
-    var57.x2[0] = var56.x2[0] + var49.x2[0];
-    var57.x2[1] = var56.x2[1] + var49.x2[1];
-    /* 17: addw */
-    var58.x2[0] = var57.x2[0] + var42.x2[0];
-    var58.x2[1] = var57.x2[1] + var42.x2[1];
-    /* 18: shruw */
-    var59.x2[0] = ((orc_uint16) var58.x2[0]) >> 2;
-    var59.x2[1] = ((orc_uint16) var58.x2[1]) >> 2;
-    /* 19: convsuswb */
-    var60.x2[0] = ORC_CLAMP_UB (var59.x2[0]);
-    var60.x2[1] = ORC_CLAMP_UB (var59.x2[1]);
-    /* 20: mergewl */
+    /* 17: mullw */
+    var59.x2[0] = (var52.x2[0] * var41.x2[0]) & 0xffff;
+    var59.x2[1] = (var52.x2[1] * var41.x2[1]) & 0xffff;
+    /* 18: addw */
+    var60.x2[0] = var59.x2[0] + var51.x2[0];
+    var60.x2[1] = var59.x2[1] + var51.x2[1];
+    /* 19: addw */
+    var61.x2[0] = var60.x2[0] + var42.x2[0];
+    var61.x2[1] = var60.x2[1] + var42.x2[1];
+    /* 20: shruw */
+    var62.x2[0] = ((orc_uint16) var61.x2[0]) >> 2;
+    var62.x2[1] = ((orc_uint16) var61.x2[1]) >> 2;
+    /* 21: convsuswb */
+    var63.x2[0] = ORC_CLAMP_UB (var62.x2[0]);
+    var63.x2[1] = ORC_CLAMP_UB (var62.x2[1]);
+    /* 22: mergewl */
     {
       orc_union32 _dest;
-      _dest.x2[0] = var48.i;
-      _dest.x2[1] = var60.i;
-      var44.i = _dest.i;
+      _dest.x2[0] = var49.i;
+      _dest.x2[1] = var63.i;
+      var64.i = _dest.i;
     }
-    /* 21: storel */
-    ptr1[i] = var44;
+    /* 23: mergelq */
+    {
+      orc_union64 _dest;
+      _dest.x2[0] = var58.i;
+      _dest.x2[1] = var64.i;
+      var43.i = _dest.i;
+    }
+    /* 24: storeq */
+    ptr0[i] = var43;
   }
 
 }
 
 void
-video_orc_chroma_up_v2_u8 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
+video_orc_chroma_up_h2_u8 (guint8 * ORC_RESTRICT d1,
     const guint8 * ORC_RESTRICT s1, const guint8 * ORC_RESTRICT s2, int n)
 {
   OrcExecutor _ex, *ex = &_ex;
@@ -30444,67 +31368,78 @@ video_orc_chroma_up_v2_u8 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
 #if 1
       static const orc_uint8 bc[] = {
         1, 9, 25, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 99, 104, 114,
-        111, 109, 97, 95, 117, 112, 95, 118, 50, 95, 117, 56, 11, 4, 4, 11,
-        4, 4, 12, 4, 4, 12, 4, 4, 14, 2, 3, 0, 0, 0, 14, 2,
-        2, 0, 0, 0, 20, 2, 20, 2, 20, 2, 20, 2, 20, 4, 20, 4,
-        20, 4, 198, 34, 32, 4, 198, 35, 33, 5, 21, 1, 150, 36, 34, 21,
-        1, 150, 37, 35, 21, 1, 89, 38, 36, 16, 21, 1, 70, 38, 38, 37,
-        21, 1, 70, 38, 38, 17, 21, 1, 95, 38, 38, 17, 21, 1, 160, 34,
-        38, 195, 0, 32, 34, 21, 1, 89, 38, 37, 16, 21, 1, 70, 38, 38,
-        36, 21, 1, 70, 38, 38, 17, 21, 1, 95, 38, 38, 17, 21, 1, 160,
-        35, 38, 195, 1, 33, 35, 2, 0,
+        111, 109, 97, 95, 117, 112, 95, 104, 50, 95, 117, 56, 11, 8, 8, 12,
+        8, 8, 12, 8, 8, 14, 2, 3, 0, 0, 0, 14, 2, 2, 0, 0,
+        0, 20, 4, 20, 4, 20, 4, 20, 2, 20, 2, 20, 2, 20, 2, 20,
+        4, 20, 4, 20, 4, 197, 33, 32, 4, 192, 34, 5, 190, 35, 32, 198,
+        38, 36, 33, 191, 37, 34, 21, 1, 150, 39, 37, 21, 1, 150, 40, 38,
+        21, 1, 89, 41, 39, 16, 21, 1, 70, 41, 41, 40, 21, 1, 70, 41,
+        41, 17, 21, 1, 95, 41, 41, 17, 21, 1, 160, 37, 41, 195, 32, 35,
+        37, 21, 1, 89, 41, 40, 16, 21, 1, 70, 41, 41, 39, 21, 1, 70,
+        41, 41, 17, 21, 1, 95, 41, 41, 17, 21, 1, 160, 38, 41, 195, 33,
+        36, 38, 194, 0, 32, 33, 2, 0,
       };
       p = orc_program_new_from_static_bytecode (bc);
-      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_v2_u8);
+      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_h2_u8);
 #else
       p = orc_program_new ();
-      orc_program_set_name (p, "video_orc_chroma_up_v2_u8");
-      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_v2_u8);
-      orc_program_add_destination (p, 4, "d1");
-      orc_program_add_destination (p, 4, "d2");
-      orc_program_add_source (p, 4, "s1");
-      orc_program_add_source (p, 4, "s2");
+      orc_program_set_name (p, "video_orc_chroma_up_h2_u8");
+      orc_program_set_backup_function (p, _backup_video_orc_chroma_up_h2_u8);
+      orc_program_add_destination (p, 8, "d1");
+      orc_program_add_source (p, 8, "s1");
+      orc_program_add_source (p, 8, "s2");
       orc_program_add_constant (p, 2, 0x00000003, "c1");
       orc_program_add_constant (p, 2, 0x00000002, "c2");
-      orc_program_add_temporary (p, 2, "t1");
-      orc_program_add_temporary (p, 2, "t2");
-      orc_program_add_temporary (p, 2, "t3");
+      orc_program_add_temporary (p, 4, "t1");
+      orc_program_add_temporary (p, 4, "t2");
+      orc_program_add_temporary (p, 4, "t3");
       orc_program_add_temporary (p, 2, "t4");
-      orc_program_add_temporary (p, 4, "t5");
-      orc_program_add_temporary (p, 4, "t6");
-      orc_program_add_temporary (p, 4, "t7");
+      orc_program_add_temporary (p, 2, "t5");
+      orc_program_add_temporary (p, 2, "t6");
+      orc_program_add_temporary (p, 2, "t7");
+      orc_program_add_temporary (p, 4, "t8");
+      orc_program_add_temporary (p, 4, "t9");
+      orc_program_add_temporary (p, 4, "t10");
 
-      orc_program_append_2 (p, "splitlw", 0, ORC_VAR_T3, ORC_VAR_T1, ORC_VAR_S1,
+      orc_program_append_2 (p, "splitql", 0, ORC_VAR_T2, ORC_VAR_T1, ORC_VAR_S1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "splitlw", 0, ORC_VAR_T4, ORC_VAR_T2, ORC_VAR_S2,
+      orc_program_append_2 (p, "select0ql", 0, ORC_VAR_T3, ORC_VAR_S2,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "select0lw", 0, ORC_VAR_T4, ORC_VAR_T1,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "splitlw", 0, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_T2,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T5, ORC_VAR_T3, ORC_VAR_D1,
+      orc_program_append_2 (p, "select1lw", 0, ORC_VAR_T6, ORC_VAR_T3,
+          ORC_VAR_D1, ORC_VAR_D1);
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T8, ORC_VAR_T6, ORC_VAR_D1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T6, ORC_VAR_T4, ORC_VAR_D1,
+      orc_program_append_2 (p, "convubw", 1, ORC_VAR_T9, ORC_VAR_T7, ORC_VAR_D1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T7, ORC_VAR_T5, ORC_VAR_C1,
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T10, ORC_VAR_T8, ORC_VAR_C1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T6,
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_T9,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_C2,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_C2,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T3, ORC_VAR_T7,
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T6, ORC_VAR_T10,
           ORC_VAR_D1, ORC_VAR_D1);
-      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T3,
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T1, ORC_VAR_T4, ORC_VAR_T6,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T7, ORC_VAR_T6, ORC_VAR_C1,
+      orc_program_append_2 (p, "mullw", 1, ORC_VAR_T10, ORC_VAR_T9, ORC_VAR_C1,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_T5,
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_T8,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "addw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+      orc_program_append_2 (p, "addw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_C2,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T7, ORC_VAR_T7, ORC_VAR_C2,
+      orc_program_append_2 (p, "shruw", 1, ORC_VAR_T10, ORC_VAR_T10, ORC_VAR_C2,
           ORC_VAR_D1);
-      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T4, ORC_VAR_T7,
+      orc_program_append_2 (p, "convsuswb", 1, ORC_VAR_T7, ORC_VAR_T10,
           ORC_VAR_D1, ORC_VAR_D1);
-      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_D2, ORC_VAR_T2, ORC_VAR_T4,
+      orc_program_append_2 (p, "mergewl", 0, ORC_VAR_T2, ORC_VAR_T5, ORC_VAR_T7,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "mergelq", 0, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T2,
           ORC_VAR_D1);
 #endif
 
@@ -30520,7 +31455,6 @@ video_orc_chroma_up_v2_u8 (guint8 * ORC_RESTRICT d1, guint8 * ORC_RESTRICT d2,
 
   ex->n = n;
   ex->arrays[ORC_VAR_D1] = d1;
-  ex->arrays[ORC_VAR_D2] = d2;
   ex->arrays[ORC_VAR_S1] = (void *) s1;
   ex->arrays[ORC_VAR_S2] = (void *) s2;
 
@@ -32281,6 +33215,187 @@ video_orc_dither_verterr_4u8_mask (guint8 * ORC_RESTRICT d1,
 #endif
 
 
+/* video_orc_dither_verterr_4u16_mask */
+#ifdef DISABLE_ORC
+void
+video_orc_dither_verterr_4u16_mask (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, orc_int64 p1, int n)
+{
+  int i;
+  orc_union64 *ORC_RESTRICT ptr0;
+  orc_union64 *ORC_RESTRICT ptr1;
+  orc_union64 var34;
+  orc_union64 var35;
+  orc_union64 var36;
+  orc_union64 var37;
+  orc_union64 var38;
+  orc_union64 var39;
+
+  ptr0 = (orc_union64 *) d1;
+  ptr1 = (orc_union64 *) d2;
+
+  /* 0: loadpq */
+  var38.i = p1;
+
+  for (i = 0; i < n; i++) {
+    /* 1: loadq */
+    var34 = ptr0[i];
+    /* 2: loadq */
+    var35 = ptr1[i];
+    /* 3: addusw */
+    var39.x4[0] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[0] + (orc_uint16) var34.x4[0]);
+    var39.x4[1] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[1] + (orc_uint16) var34.x4[1]);
+    var39.x4[2] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[2] + (orc_uint16) var34.x4[2]);
+    var39.x4[3] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[3] + (orc_uint16) var34.x4[3]);
+    /* 4: andw */
+    var37.x4[0] = var38.x4[0] & var39.x4[0];
+    var37.x4[1] = var38.x4[1] & var39.x4[1];
+    var37.x4[2] = var38.x4[2] & var39.x4[2];
+    var37.x4[3] = var38.x4[3] & var39.x4[3];
+    /* 5: storeq */
+    ptr1[i] = var37;
+    /* 6: andnw */
+    var36.x4[0] = (~var38.x4[0]) & var39.x4[0];
+    var36.x4[1] = (~var38.x4[1]) & var39.x4[1];
+    var36.x4[2] = (~var38.x4[2]) & var39.x4[2];
+    var36.x4[3] = (~var38.x4[3]) & var39.x4[3];
+    /* 7: storeq */
+    ptr0[i] = var36;
+  }
+
+}
+
+#else
+static void
+_backup_video_orc_dither_verterr_4u16_mask (OrcExecutor * ORC_RESTRICT ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union64 *ORC_RESTRICT ptr0;
+  orc_union64 *ORC_RESTRICT ptr1;
+  orc_union64 var34;
+  orc_union64 var35;
+  orc_union64 var36;
+  orc_union64 var37;
+  orc_union64 var38;
+  orc_union64 var39;
+
+  ptr0 = (orc_union64 *) ex->arrays[0];
+  ptr1 = (orc_union64 *) ex->arrays[1];
+
+  /* 0: loadpq */
+  var38.i =
+      (ex->params[24] & 0xffffffff) | ((orc_uint64) (ex->params[24 +
+              (ORC_VAR_T1 - ORC_VAR_P1)]) << 32);
+
+  for (i = 0; i < n; i++) {
+    /* 1: loadq */
+    var34 = ptr0[i];
+    /* 2: loadq */
+    var35 = ptr1[i];
+    /* 3: addusw */
+    var39.x4[0] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[0] + (orc_uint16) var34.x4[0]);
+    var39.x4[1] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[1] + (orc_uint16) var34.x4[1]);
+    var39.x4[2] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[2] + (orc_uint16) var34.x4[2]);
+    var39.x4[3] =
+        ORC_CLAMP_UW ((orc_uint16) var35.x4[3] + (orc_uint16) var34.x4[3]);
+    /* 4: andw */
+    var37.x4[0] = var38.x4[0] & var39.x4[0];
+    var37.x4[1] = var38.x4[1] & var39.x4[1];
+    var37.x4[2] = var38.x4[2] & var39.x4[2];
+    var37.x4[3] = var38.x4[3] & var39.x4[3];
+    /* 5: storeq */
+    ptr1[i] = var37;
+    /* 6: andnw */
+    var36.x4[0] = (~var38.x4[0]) & var39.x4[0];
+    var36.x4[1] = (~var38.x4[1]) & var39.x4[1];
+    var36.x4[2] = (~var38.x4[2]) & var39.x4[2];
+    var36.x4[3] = (~var38.x4[3]) & var39.x4[3];
+    /* 7: storeq */
+    ptr0[i] = var36;
+  }
+
+}
+
+void
+video_orc_dither_verterr_4u16_mask (guint16 * ORC_RESTRICT d1,
+    guint16 * ORC_RESTRICT d2, orc_int64 p1, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  static volatile int p_inited = 0;
+  static OrcCode *c = 0;
+  void (*func) (OrcExecutor *);
+
+  if (!p_inited) {
+    orc_once_mutex_lock ();
+    if (!p_inited) {
+      OrcProgram *p;
+
+#if 1
+      static const orc_uint8 bc[] = {
+        1, 9, 34, 118, 105, 100, 101, 111, 95, 111, 114, 99, 95, 100, 105, 116,
+        104, 101, 114, 95, 118, 101, 114, 116, 101, 114, 114, 95, 52, 117, 49, 54,
+        95, 109, 97, 115, 107, 11, 8, 8, 11, 8, 8, 18, 8, 20, 8, 20,
+        8, 134, 32, 24, 21, 2, 72, 33, 1, 0, 21, 2, 73, 1, 32, 33,
+        21, 2, 74, 0, 32, 33, 2, 0,
+      };
+      p = orc_program_new_from_static_bytecode (bc);
+      orc_program_set_backup_function (p,
+          _backup_video_orc_dither_verterr_4u16_mask);
+#else
+      p = orc_program_new ();
+      orc_program_set_name (p, "video_orc_dither_verterr_4u16_mask");
+      orc_program_set_backup_function (p,
+          _backup_video_orc_dither_verterr_4u16_mask);
+      orc_program_add_destination (p, 8, "d1");
+      orc_program_add_destination (p, 8, "d2");
+      orc_program_add_parameter_int64 (p, 8, "p1");
+      orc_program_add_temporary (p, 8, "t1");
+      orc_program_add_temporary (p, 8, "t2");
+
+      orc_program_append_2 (p, "loadpq", 0, ORC_VAR_T1, ORC_VAR_P1, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "addusw", 2, ORC_VAR_T2, ORC_VAR_D2, ORC_VAR_D1,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andw", 2, ORC_VAR_D2, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+      orc_program_append_2 (p, "andnw", 2, ORC_VAR_D1, ORC_VAR_T1, ORC_VAR_T2,
+          ORC_VAR_D1);
+#endif
+
+      orc_program_compile (p);
+      c = orc_program_take_code (p);
+      orc_program_free (p);
+    }
+    p_inited = TRUE;
+    orc_once_mutex_unlock ();
+  }
+  ex->arrays[ORC_VAR_A2] = c;
+  ex->program = 0;
+
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_D2] = d2;
+  {
+    orc_union64 tmp;
+    tmp.i = p1;
+    ex->params[ORC_VAR_P1] = ((orc_uint64) tmp.i) & 0xffffffff;
+    ex->params[ORC_VAR_T1] = ((orc_uint64) tmp.i) >> 32;
+  }
+
+  func = c->exec;
+  func (ex);
+}
+#endif
+
+
 /* video_orc_dither_fs_muladd_u8 */
 #ifdef DISABLE_ORC
 void
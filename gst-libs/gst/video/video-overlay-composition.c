@@ -171,6 +171,11 @@ ensure_debug_category (void)
 
 #endif /* GST_DISABLE_GST_DEBUG */
 
+static GstBuffer
+    * gst_video_overlay_rectangle_get_pixels_raw_internal
+    (GstVideoOverlayRectangle * rectangle, GstVideoOverlayFormatFlags flags,
+    gboolean unscaled, GstVideoFormat wanted_format);
+
 static guint
 gst_video_overlay_get_seqnum (void)
 {
@@ -505,8 +510,20 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
 
     needs_scaling = gst_video_overlay_rectangle_needs_scaling (rect);
     if (needs_scaling) {
-      gst_video_blend_scale_linear_RGBA (&rect->info, rect->pixels,
-          rect->render_height, rect->render_width, &scaled_info, &pixels);
+      /* scaled pixels are kept in the rectangle's cache, so rectangles that
+       * stay around for several frames are only scaled once. Global alpha is
+       * applied by gst_video_blend() */
+      pixels = gst_video_overlay_rectangle_get_pixels_raw_internal (rect,
+          (rect->flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA) |
+          GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA, FALSE,
+          GST_VIDEO_INFO_FORMAT (&rect->info));
+      gst_buffer_ref (pixels);
+
+      gst_video_info_init (&scaled_info);
+      gst_video_info_set_format (&scaled_info,
+          GST_VIDEO_INFO_FORMAT (&rect->info), rect->render_width,
+          rect->render_height);
+      scaled_info.flags = rect->info.flags;
       vinfo = &scaled_info;
     } else {
       pixels = gst_buffer_ref (rect->pixels);
@@ -522,7 +539,6 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
       GST_WARNING ("Could not blend overlay rectangle onto video buffer");
     }
 
-    /* FIXME: should cache scaled pixels in the rectangle struct */
     gst_buffer_unref (pixels);
   }
 
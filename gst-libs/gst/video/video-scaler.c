@@ -82,14 +82,22 @@ typedef void (*GstVideoScalerVFunc) (GstVideoScaler * scale,
     gpointer srcs[], gpointer dest, guint dest_offset, guint width,
     guint n_elems);
 
+typedef struct _ResamplerCacheEntry ResamplerCacheEntry;
+
 struct _GstVideoScaler
 {
   GstVideoResamplerMethod method;
   GstVideoScalerFlags flags;
 
   GstVideoResampler resampler;
+  /* the shared entry the tables of @resampler belong to, NULL when they are
+   * owned by this scaler */
+  ResamplerCacheEntry *cached;
 
   gboolean merged;
+  /* every output is the average of two neighbouring inputs, as for 2:1
+   * bilinear downscaling */
+  gboolean avg2;
   gint in_y_offset;
   gint out_y_offset;
 
@@ -192,6 +200,136 @@ scaler_dump (GstVideoScaler * scale)
 
 #define INTERLACE_SHIFT 0.5
 
+static gboolean
+resampler_is_avg2 (const GstVideoResampler * resampler)
+{
+  guint i;
+
+  if (resampler->max_taps != 2)
+    return FALSE;
+
+  for (i = 0; i < resampler->n_phases * 2; i++) {
+    if (fabs (resampler->taps[i] - 0.5) > 1e-6)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+/* Computing the filter taps is the expensive part of making a scaler and
+ * the same sizes come back on every renegotiation and for every plane of
+ * the same size, so keep the last few resamplers around. The tables are
+ * never modified after they are made, scalers with the same parameters
+ * share them and hold a reference on the entry */
+#define RESAMPLER_CACHE_SIZE 16
+
+typedef struct
+{
+  GstVideoResamplerMethod method;
+  GstVideoScalerFlags flags;
+  guint n_taps;
+  guint in_size;
+  guint out_size;
+  /* resampler options, -1 when not set */
+  gdouble opts[5];
+  gint max_taps;
+} ResamplerKey;
+
+struct _ResamplerCacheEntry
+{
+  ResamplerKey key;
+  gint ref_count;
+  GstVideoResampler resampler;
+};
+
+static const gchar *resampler_opts[] = {
+  GST_VIDEO_RESAMPLER_OPT_CUBIC_B, GST_VIDEO_RESAMPLER_OPT_CUBIC_C,
+  GST_VIDEO_RESAMPLER_OPT_ENVELOPE, GST_VIDEO_RESAMPLER_OPT_SHARPNESS,
+  GST_VIDEO_RESAMPLER_OPT_SHARPEN
+};
+
+G_LOCK_DEFINE_STATIC (resampler_cache);
+static GQueue resampler_cache = G_QUEUE_INIT;
+
+static void
+resampler_key_init (ResamplerKey * key, GstVideoResamplerMethod method,
+    GstVideoScalerFlags flags, guint n_taps, guint in_size, guint out_size,
+    GstStructure * options)
+{
+  guint i;
+
+  memset (key, 0, sizeof (ResamplerKey));
+  key->method = method;
+  key->flags = flags;
+  key->n_taps = n_taps;
+  key->in_size = in_size;
+  key->out_size = out_size;
+
+  for (i = 0; i < G_N_ELEMENTS (resampler_opts); i++) {
+    if (!options || !gst_structure_get_double (options, resampler_opts[i],
+            &key->opts[i]))
+      key->opts[i] = -1.0;
+  }
+  if (!options || !gst_structure_get_int (options,
+          GST_VIDEO_RESAMPLER_OPT_MAX_TAPS, &key->max_taps))
+    key->max_taps = -1;
+}
+
+static void
+resampler_cache_entry_unref (ResamplerCacheEntry * entry)
+{
+  if (g_atomic_int_dec_and_test (&entry->ref_count)) {
+    gst_video_resampler_clear (&entry->resampler);
+    g_slice_free (ResamplerCacheEntry, entry);
+  }
+}
+
+static ResamplerCacheEntry *
+resampler_cache_lookup (const ResamplerKey * key)
+{
+  GList *l;
+
+  G_LOCK (resampler_cache);
+  for (l = resampler_cache.head; l; l = l->next) {
+    ResamplerCacheEntry *entry = l->data;
+
+    if (memcmp (&entry->key, key, sizeof (ResamplerKey)) == 0) {
+      g_atomic_int_inc (&entry->ref_count);
+      /* move to the front, the tail is dropped first */
+      g_queue_unlink (&resampler_cache, l);
+      g_queue_push_head_link (&resampler_cache, l);
+      G_UNLOCK (resampler_cache);
+      return entry;
+    }
+  }
+  G_UNLOCK (resampler_cache);
+
+  return NULL;
+}
+
+/* takes the tables of @resampler, returns a reference on the new entry */
+static ResamplerCacheEntry *
+resampler_cache_insert (const ResamplerKey * key,
+    const GstVideoResampler * resampler)
+{
+  ResamplerCacheEntry *entry, *old = NULL;
+
+  entry = g_slice_new (ResamplerCacheEntry);
+  entry->key = *key;
+  entry->ref_count = 2;
+  entry->resampler = *resampler;
+
+  G_LOCK (resampler_cache);
+  g_queue_push_head (&resampler_cache, entry);
+  if (resampler_cache.length > RESAMPLER_CACHE_SIZE)
+    old = g_queue_pop_tail (&resampler_cache);
+  G_UNLOCK (resampler_cache);
+
+  if (old)
+    resampler_cache_entry_unref (old);
+
+  return entry;
+}
+
 /**
  * gst_video_scaler_new: (skip)
  * @method: a #GstVideoResamplerMethod
@@ -215,6 +353,8 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
     guint n_taps, guint in_size, guint out_size, GstStructure * options)
 {
   GstVideoScaler *scale;
+  GstVideoResampler resampler;
+  ResamplerKey key;
 
   g_return_val_if_fail (in_size != 0, NULL);
   g_return_val_if_fail (out_size != 0, NULL);
@@ -226,7 +366,11 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
   scale->method = method;
   scale->flags = flags;
 
-  if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
+  resampler_key_init (&key, method, flags, n_taps, in_size, out_size, options);
+
+  if ((scale->cached = resampler_cache_lookup (&key))) {
+    GST_DEBUG ("reusing cached resampler");
+  } else if (flags & GST_VIDEO_SCALER_FLAG_INTERLACED) {
     GstVideoResampler tresamp, bresamp;
     gdouble shift;
 
@@ -242,20 +386,26 @@ gst_video_scaler_new (GstVideoResamplerMethod method, GstVideoScalerFlags flags,
         n_taps, -shift, in_size - tresamp.in_size,
         out_size - tresamp.out_size, options);
 
-    resampler_zip (&scale->resampler, &tresamp, &bresamp);
+    resampler_zip (&resampler, &tresamp, &bresamp);
     gst_video_resampler_clear (&tresamp);
     gst_video_resampler_clear (&bresamp);
+    scale->cached = resampler_cache_insert (&key, &resampler);
   } else {
-    gst_video_resampler_init (&scale->resampler, method,
+    gst_video_resampler_init (&resampler, method,
         GST_VIDEO_RESAMPLER_FLAG_NONE, out_size, n_taps, 0.0, in_size, out_size,
         options);
+    scale->cached = resampler_cache_insert (&key, &resampler);
   }
+  scale->resampler = scale->cached->resampler;
 
   if (out_size == 1)
     scale->inc = 0;
   else
     scale->inc = ((in_size - 1) << 16) / (out_size - 1) - 1;
 
+  scale->avg2 = !(flags & GST_VIDEO_SCALER_FLAG_INTERLACED)
+      && resampler_is_avg2 (&scale->resampler);
+
   scaler_dump (scale);
   GST_DEBUG ("max_taps %d", scale->resampler.max_taps);
 
@@ -273,7 +423,10 @@ gst_video_scaler_free (GstVideoScaler * scale)
 {
   g_return_if_fail (scale != NULL);
 
-  gst_video_resampler_clear (&scale->resampler);
+  if (scale->cached)
+    resampler_cache_entry_unref (scale->cached);
+  else
+    gst_video_resampler_clear (&scale->resampler);
   g_free (scale->taps_s16);
   g_free (scale->taps_s16_4);
   g_free (scale->offset_n);
@@ -617,6 +770,50 @@ video_scale_h_2tap_4u8 (GstVideoScaler * scale,
   video_orc_resample_h_2tap_4u8_lq (d, s, 0, scale->inc, width);
 }
 
+/* Both taps are 1/2: this is what the generic code computes as well, without
+ * gathering the pixels and the taps first */
+static void
+video_scale_h_avg2_u8 (GstVideoScaler * scale,
+    gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
+{
+  guint8 *s, *d;
+  guint32 *offset;
+  gint i, j;
+
+  d = (guint8 *) dest + dest_offset * n_elems;
+  s = (guint8 *) src;
+  offset = scale->resampler.offset + dest_offset;
+
+  for (i = 0; i < width; i++) {
+    const guint8 *p = s + offset[i] * n_elems;
+
+    for (j = 0; j < n_elems; j++)
+      d[j] = (p[j] + p[n_elems + j] + 1) >> 1;
+    d += n_elems;
+  }
+}
+
+static void
+video_scale_h_avg2_u16 (GstVideoScaler * scale,
+    gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
+{
+  guint16 *s, *d;
+  guint32 *offset;
+  gint i, j;
+
+  d = (guint16 *) dest + dest_offset * n_elems;
+  s = (guint16 *) src;
+  offset = scale->resampler.offset + dest_offset;
+
+  for (i = 0; i < width; i++) {
+    const guint16 *p = s + offset[i] * n_elems;
+
+    for (j = 0; j < n_elems; j++)
+      d[j] = (p[j] + p[n_elems + j] + 1) >> 1;
+    d += n_elems;
+  }
+}
+
 static void
 video_scale_h_ntap_u8 (GstVideoScaler * scale,
     gpointer src, gpointer dest, guint dest_offset, guint width, guint n_elems)
@@ -1275,7 +1472,9 @@ get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
           *hfunc = video_scale_h_near_u32;
         break;
       case 2:
-        if (*n_elems == 1 && mono)
+        if (hscale->avg2)
+          *hfunc = video_scale_h_avg2_u8;
+        else if (*n_elems == 1 && mono)
           *hfunc = video_scale_h_2tap_1u8;
         else if (*n_elems == 4)
           *hfunc = video_scale_h_2tap_4u8;
@@ -1312,6 +1511,12 @@ get_functions (GstVideoScaler * hscale, GstVideoScaler * vscale,
         else
           *hfunc = video_scale_h_near_u64;
         break;
+      case 2:
+        if (hscale->avg2)
+          *hfunc = video_scale_h_avg2_u16;
+        else
+          *hfunc = video_scale_h_ntap_u16;
+        break;
       default:
         *hfunc = video_scale_h_ntap_u16;
         break;
@@ -923,6 +923,7 @@ gst_adder_dispose (GObject * object)
   }
   gst_caps_replace (&adder->filter_caps, NULL);
   gst_caps_replace (&adder->current_caps, NULL);
+  gst_buffer_replace (&adder->silence_buffer, NULL);
 
   if (adder->pending_events) {
     g_list_foreach (adder->pending_events, (GFunc) gst_event_unref, NULL);
@@ -1199,7 +1200,7 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
     GstAdderPad *pad;
     GstClockTime timestamp, stream_time;
 
-    /* take next to see if this is the last collectdata */
+    /* take next before the collectdata is handled */
     next = g_slist_next (collected);
 
     collect_data = (GstCollectData *) collected->data;
@@ -1242,13 +1243,12 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
 
     /* Try to make an output buffer */
     if (outbuf == NULL) {
-      /* if this is a gap buffer but we have some more pads to check, skip it.
-       * If we are at the last buffer, take it, regardless if it is a GAP
-       * buffer or not. */
-      if (is_gap && next) {
-        GST_DEBUG_OBJECT (adder, "skipping, non-last GAP buffer");
-        /* we keep the GAP buffer, if we don't have anymore buffers (all pads
-         * EOS, we can use this one as the output buffer. */
+      /* if this is a gap buffer, skip it. There is nothing to mix or apply
+       * the volume to, so also the last one is not mapped. */
+      if (is_gap) {
+        GST_DEBUG_OBJECT (adder, "skipping GAP buffer");
+        /* we keep the GAP buffer, if we don't have any other buffers we can
+         * use this one as the output buffer. */
         if (gapbuf == NULL)
           gapbuf = inbuf;
         else
@@ -1261,8 +1261,7 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
           collect_data, outsize);
 
       /* make data and metadata writable, can simply return the inbuf when we
-       * are the only one referencing this buffer. If this is the last (and
-       * only) GAP buffer, it will automatically copy the GAP flag. */
+       * are the only one referencing this buffer. */
       outbuf = gst_buffer_make_writable (inbuf);
       gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
 
@@ -1417,15 +1416,23 @@ gst_adder_collected (GstCollectPads * pads, gpointer user_data)
     /* no output buffer, reuse one of the GAP buffers then if we have one */
     if (gapbuf) {
       GST_LOG_OBJECT (adder, "reusing GAP buffer %p", gapbuf);
-      outbuf = gapbuf;
+      /* only the metadata is changed below, the memory stays shared */
+      outbuf = gst_buffer_make_writable (gapbuf);
     } else if (had_mute) {
-      GstMapInfo map;
-
-      /* Means we had all pads muted, create some silence */
-      outbuf = gst_buffer_new_allocate (NULL, outsize, NULL);
-      gst_buffer_map (outbuf, &map, GST_MAP_WRITE);
-      gst_audio_format_fill_silence (adder->info.finfo, map.data, outsize);
-      gst_buffer_unmap (outbuf, &map);
+      /* Means we had all pads muted, output some silence. All these buffers
+       * share the memory of one silence buffer. */
+      if (adder->silence_buffer == NULL
+          || gst_buffer_get_size (adder->silence_buffer) < outsize) {
+        GstMapInfo map;
+
+        gst_buffer_replace (&adder->silence_buffer, NULL);
+        adder->silence_buffer = gst_buffer_new_allocate (NULL, outsize, NULL);
+        gst_buffer_map (adder->silence_buffer, &map, GST_MAP_WRITE);
+        gst_audio_format_fill_silence (adder->info.finfo, map.data, outsize);
+        gst_buffer_unmap (adder->silence_buffer, &map);
+      }
+      outbuf = gst_buffer_copy_region (adder->silence_buffer,
+          GST_BUFFER_COPY_MEMORY, 0, outsize);
       GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
     } else {
       /* assume EOS otherwise, this should not happen, really */
@@ -1524,6 +1531,7 @@ gst_adder_change_state (GstElement * element, GstStateChange transition)
       adder->send_stream_start = TRUE;
       adder->send_caps = TRUE;
       gst_caps_replace (&adder->current_caps, NULL);
+      gst_buffer_replace (&adder->silence_buffer, NULL);
       gst_segment_init (&adder->segment, GST_FORMAT_TIME);
       gst_collect_pads_start (adder->collect);
       break;
@@ -73,6 +73,9 @@ struct _GstAdder {
 
   /* Pending inline events */
   GList *pending_events;
+
+  /* silence shared by the output buffers of all muted pads */
+  GstBuffer *silence_buffer;
   
   gboolean send_stream_start;
   gboolean send_caps;
@@ -25,9 +25,15 @@
 
 #include "plugin.h"
 
+#include <gst/audio/audio.h>
+
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
+  /* compile the common conversions now instead of on the first buffers */
+  if (g_getenv ("GST_ORC_PRECOMPILE"))
+    gst_audio_converter_precompile (TRUE);
+
   if (!gst_element_register (plugin, "audioconvert",
           GST_RANK_PRIMARY, gst_audio_convert_get_type ()))
     return FALSE;
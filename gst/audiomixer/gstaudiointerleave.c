@@ -347,13 +347,29 @@ gst_audio_interleave_get_channel_mask (GstAudioInterleave * self)
 }
 
 
+/* the output is only touched every stride samples, handle four frames per
+ * iteration so that the loads can be issued before the scattered stores */
 #define MAKE_FUNC(type) \
 static void interleave_##type (guint##type *out, guint##type *in, \
     guint stride, guint nframes) \
 { \
-  gint i; \
+  guint i; \
   \
-  for (i = 0; i < nframes; i++) { \
+  if (stride == 1) { \
+    memcpy (out, in, nframes * sizeof (guint##type)); \
+    return; \
+  } \
+  \
+  for (i = 0; i + 4 <= nframes; i += 4) { \
+    guint##type s0 = in[i], s1 = in[i + 1], s2 = in[i + 2], s3 = in[i + 3]; \
+    \
+    out[0] = s0; \
+    out[stride] = s1; \
+    out[2 * stride] = s2; \
+    out[3 * stride] = s3; \
+    out += 4 * stride; \
+  } \
+  for (; i < nframes; i++) { \
     *out = in[i]; \
     out += stride; \
   } \
@@ -367,11 +383,19 @@ MAKE_FUNC (64);
 static void
 interleave_24 (guint8 * out, guint8 * in, guint stride, guint nframes)
 {
-  gint i;
+  guint i;
+
+  if (stride == 1) {
+    memcpy (out, in, nframes * 3);
+    return;
+  }
 
+  stride *= 3;
   for (i = 0; i < nframes; i++) {
-    memcpy (out, in, 3);
-    out += stride * 3;
+    out[0] = in[0];
+    out[1] = in[1];
+    out[2] = in[2];
+    out += stride;
     in += 3;
   }
 }
@@ -817,7 +841,9 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
   GstMapInfo inmap;
   GstMapInfo outmap;
   gint out_width, in_bpf, out_bpf, out_channels, channel;
-  guint8 *outdata;
+  guint8 *outdata, *indata;
+  GstInterleaveFunc func;
+  GstAudioMeta *meta;
   GstAggregator *agg = GST_AGGREGATOR (aagg);
   GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
 
@@ -829,31 +855,39 @@ gst_audio_interleave_aggregate_one_buffer (GstAudioAggregator * aagg,
   out_bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
   out_channels = GST_AUDIO_INFO_CHANNELS (&srcpad->info);
 
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "interleaves %u frames on channel %d/%d at offset %u"
-      " from offset %u", num_frames, pad->channel, out_channels,
-      out_offset * out_bpf, in_offset * in_bpf);
-
   if (self->channels > 64) {
     channel = pad->channel;
   } else {
     channel = self->default_channels_ordering_map[pad->channel];
   }
+  func = self->func;
 
-  outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
+  GST_OBJECT_UNLOCK (aaggpad);
+  GST_OBJECT_UNLOCK (aagg);
 
+  /* the copy itself only touches this pad's channel, don't hold the locks so
+   * that disjoint parts of the output can be interleaved from several
+   * threads */
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  GST_LOG_OBJECT (pad, "interleaves %u frames on channel %d/%d at offset %u"
+      " from offset %u", num_frames, channel, out_channels,
+      out_offset * out_bpf, in_offset * in_bpf);
 
-  self->func (outdata, inmap.data + (in_offset * in_bpf), out_channels,
-      num_frames);
+  /* a mono non-interleaved buffer is a single plane, but that plane does
+   * not have to start at the beginning of the memory */
+  indata = inmap.data;
+  meta = gst_buffer_get_audio_meta (inbuf);
+  if (meta && meta->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    indata += meta->offsets[0];
 
+  outdata = outmap.data + (out_offset * out_bpf) + (out_width * channel);
+
+  func (outdata, indata + (in_offset * in_bpf), out_channels, num_frames);
 
   gst_buffer_unmap (inbuf, &inmap);
   gst_buffer_unmap (outbuf, &outmap);
 
-  GST_OBJECT_UNLOCK (aaggpad);
-  GST_OBJECT_UNLOCK (aagg);
-
   return TRUE;
 }
 
@@ -49,6 +49,21 @@
  * * "mute": Whether to mute the pad or not (#gboolean)
  * * "volume": The volume of the pad, between 0.0 and 10.0 (#gdouble)
  *
+ * ## Mix-minus outputs
+ *
+ * For every sink pad "sink_N" a source pad "src_N" can be requested, which
+ * outputs the mix of all other sink pads, for example to send each
+ * participant of a conference the mix of all others without an echo of
+ * itself. The full mix is computed only once and the contribution of the
+ * sink pad, with its volume applied, is subtracted from it. For integer
+ * formats the result can differ from mixing the other pads directly if the
+ * full mix was clipped. The mix-minus pads output the same format as the
+ * "src" pad and get the same events.
+ *
+ * |[
+ * gst-launch-1.0 audiomixer name=mix ! fakesink audiotestsrc wave=ticks ! mix.sink_0 audiotestsrc freq=500 ! mix.sink_1 mix.src_0 ! alsasink mix.src_1 ! fakesink
+ * ]| This pipeline plays only the 500Hz sine wave, the mix without sink_0.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 audiotestsrc freq=100 ! audiomixer name=mix ! audioconvert ! alsasink audiotestsrc freq=500 ! mix.
@@ -62,6 +77,7 @@
 
 #include "gstaudiomixer.h"
 #include <gst/audio/audio.h>
+#include <stdio.h>              /* sscanf */
 #include <string.h>             /* strcmp */
 #include "gstaudiomixerorc.h"
 
@@ -141,13 +157,40 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static GstFlowReturn
+gst_audiomixer_pad_flush (GstAggregatorPad * aggpad, GstAggregator * agg)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aggpad);
+
+  GST_OBJECT_LOCK (pad);
+  gst_buffer_replace (&pad->own_buffer, NULL);
+  GST_OBJECT_UNLOCK (pad);
+
+  return GST_AGGREGATOR_PAD_CLASS (gst_audiomixer_pad_parent_class)->flush
+      (aggpad, agg);
+}
+
+static void
+gst_audiomixer_pad_finalize (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  gst_buffer_replace (&pad->own_buffer, NULL);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
   GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstAggregatorPadClass *aggpad_class = (GstAggregatorPadClass *) klass;
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->finalize = gst_audiomixer_pad_finalize;
+
+  aggpad_class->flush = GST_DEBUG_FUNCPTR (gst_audiomixer_pad_flush);
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -190,6 +233,13 @@ GST_STATIC_PAD_TEMPLATE ("src",
     GST_STATIC_CAPS (CAPS)
     );
 
+static GstStaticPadTemplate gst_audiomixer_mix_minus_template =
+GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (CAPS)
+    );
+
 #define SINK_CAPS \
   GST_STATIC_CAPS (GST_AUDIO_CAPS_MAKE (GST_AUDIO_FORMATS_ALL) \
       ", layout=interleaved")
@@ -211,6 +261,8 @@ G_DEFINE_TYPE_WITH_CODE (GstAudioMixer, gst_audiomixer,
 static GstPad *gst_audiomixer_request_new_pad (GstElement * element,
     GstPadTemplate * temp, const gchar * req_name, const GstCaps * caps);
 static void gst_audiomixer_release_pad (GstElement * element, GstPad * pad);
+static GstPadProbeReturn gst_audiomixer_src_probe (GstPad * pad,
+    GstPadProbeInfo * info, gpointer user_data);
 
 static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
@@ -228,6 +280,8 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_sink_template, GST_TYPE_AUDIO_MIXER_PAD);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_audiomixer_mix_minus_template);
   gst_element_class_set_static_metadata (gstelement_class, "AudioMixer",
       "Generic/Audio", "Mixes multiple audio streams",
       "Sebastian Dröge <sebastian@centricular.com>");
@@ -243,6 +297,289 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  /* does nothing until mix-minus pads are requested */
+  gst_pad_add_probe (GST_AGGREGATOR_SRC_PAD (audiomixer),
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM |
+      GST_PAD_PROBE_TYPE_EVENT_FLUSH, gst_audiomixer_src_probe, audiomixer,
+      NULL);
+}
+
+/* Called with the object lock held */
+static GstPad *
+gst_audiomixer_find_pad (GList * pads, const gchar * format, guint serial)
+{
+  gchar *name = g_strdup_printf (format, serial);
+  GstPad *res = NULL;
+
+  for (; pads; pads = pads->next) {
+    if (strcmp (GST_OBJECT_NAME (pads->data), name) == 0) {
+      res = pads->data;
+      break;
+    }
+  }
+  g_free (name);
+
+  return res;
+}
+
+/* Called with the object lock held */
+static void
+gst_audiomixer_set_mix_minus_pad (GstAudioMixerPad * sinkpad, GstPad * srcpad)
+{
+  GST_OBJECT_LOCK (sinkpad);
+  sinkpad->mix_minus_srcpad = srcpad;
+  gst_buffer_replace (&sinkpad->own_buffer, NULL);
+  GST_OBJECT_UNLOCK (sinkpad);
+
+  if (srcpad)
+    srcpad->element_private = sinkpad;
+}
+
+typedef struct
+{
+  GstPad *srcpad;
+  GstBuffer *own_buffer;
+} MixMinusOutput;
+
+#define DEFINE_MIX_MINUS_INT(type,stype,name,min,max,sign)              \
+static void                                                               \
+mix_minus_##name (type * own, const type * total, guint n)                \
+{                                                                         \
+  guint i;                                                                \
+                                                                          \
+  for (i = 0; i < n; i++) {                                               \
+    gint64 v = (gint64) (stype) (total[i] ^ (sign)) -                     \
+        (gint64) (stype) (own[i] ^ (sign));                               \
+    own[i] = ((type) (stype) CLAMP (v, min, max)) ^ (sign);               \
+  }                                                                       \
+}
+
+#define DEFINE_MIX_MINUS_FLOAT(type,name)                                 \
+static void                                                               \
+mix_minus_##name (type * own, const type * total, guint n)                \
+{                                                                         \
+  guint i;                                                                \
+                                                                          \
+  for (i = 0; i < n; i++)                                                 \
+    own[i] = total[i] - own[i];                                           \
+}
+
+/* unsigned samples are converted to signed by flipping the sign bit, like
+ * the adding functions do */
+DEFINE_MIX_MINUS_INT (gint8, gint8, s8, G_MININT8, G_MAXINT8, 0);
+DEFINE_MIX_MINUS_INT (guint8, gint8, u8, G_MININT8, G_MAXINT8, 0x80);
+DEFINE_MIX_MINUS_INT (gint16, gint16, s16, G_MININT16, G_MAXINT16, 0);
+DEFINE_MIX_MINUS_INT (guint16, gint16, u16, G_MININT16, G_MAXINT16, 0x8000);
+DEFINE_MIX_MINUS_INT (gint32, gint32, s32, G_MININT32, G_MAXINT32, 0);
+DEFINE_MIX_MINUS_INT (guint32, gint32, u32, G_MININT32, G_MAXINT32,
+    0x80000000U);
+DEFINE_MIX_MINUS_FLOAT (gfloat, f32);
+DEFINE_MIX_MINUS_FLOAT (gdouble, f64);
+
+/* replaces the contribution of a pad in @own with the mix of all other
+ * pads, taken from the full mix in @total */
+static void
+gst_audiomixer_mix_minus (GstAudioMixer * audiomixer, GstBuffer * own,
+    GstBuffer * total)
+{
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (audiomixer));
+  GstMapInfo ownmap, totalmap;
+  guint n;
+
+  if (gst_buffer_get_size (own) > gst_buffer_get_size (total))
+    gst_buffer_resize (own, 0, gst_buffer_get_size (total));
+
+  gst_buffer_map (own, &ownmap, GST_MAP_READWRITE);
+  gst_buffer_map (total, &totalmap, GST_MAP_READ);
+
+  n = MIN (ownmap.size, totalmap.size) /
+      (GST_AUDIO_INFO_WIDTH (&srcpad->info) / 8);
+
+  switch (GST_AUDIO_INFO_FORMAT (&srcpad->info)) {
+    case GST_AUDIO_FORMAT_U8:
+      mix_minus_u8 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      mix_minus_s8 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      mix_minus_u16 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      mix_minus_s16 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      mix_minus_u32 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      mix_minus_s32 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      mix_minus_f32 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      mix_minus_f64 ((gpointer) ownmap.data, (gpointer) totalmap.data, n);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+
+  gst_buffer_unmap (total, &totalmap);
+  gst_buffer_unmap (own, &ownmap);
+
+  gst_buffer_copy_into (own, total, GST_BUFFER_COPY_FLAGS |
+      GST_BUFFER_COPY_TIMESTAMPS | GST_BUFFER_COPY_META, 0, -1);
+}
+
+static void
+gst_audiomixer_push_mix_minus (GstAudioMixer * audiomixer, GstBuffer * total)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstPad *main_srcpad = GST_AGGREGATOR_SRC_PAD (audiomixer);
+  MixMinusOutput *outputs;
+  guint i, n_outputs = 0;
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  outputs = g_newa (MixMinusOutput, element->numsrcpads);
+  for (l = element->srcpads; l; l = l->next) {
+    GstPad *srcpad = l->data;
+    GstAudioMixerPad *sinkpad = srcpad->element_private;
+
+    if (srcpad == main_srcpad)
+      continue;
+
+    outputs[n_outputs].srcpad = gst_object_ref (srcpad);
+    outputs[n_outputs].own_buffer = NULL;
+    if (sinkpad) {
+      GST_OBJECT_LOCK (sinkpad);
+      outputs[n_outputs].own_buffer = sinkpad->own_buffer;
+      sinkpad->own_buffer = NULL;
+      GST_OBJECT_UNLOCK (sinkpad);
+    }
+    n_outputs++;
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (i = 0; i < n_outputs; i++) {
+    GstBuffer *outbuf;
+    GstFlowReturn ret;
+
+    /* pads that did not add anything to the mix get the full mix */
+    if (outputs[i].own_buffer) {
+      outbuf = outputs[i].own_buffer;
+      gst_audiomixer_mix_minus (audiomixer, outbuf, total);
+    } else {
+      outbuf = gst_buffer_ref (total);
+    }
+
+    ret = gst_pad_push (outputs[i].srcpad, outbuf);
+    if (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED)
+      GST_DEBUG_OBJECT (outputs[i].srcpad, "pushing mix-minus buffer: %s",
+          gst_flow_get_name (ret));
+    gst_object_unref (outputs[i].srcpad);
+  }
+}
+
+static void
+gst_audiomixer_push_mix_minus_event (GstAudioMixer * audiomixer,
+    GstEvent * event)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstPad *main_srcpad = GST_AGGREGATOR_SRC_PAD (audiomixer);
+  GstPad **srcpads;
+  guint i, n_srcpads = 0;
+  GList *l;
+
+  GST_OBJECT_LOCK (audiomixer);
+  srcpads = g_newa (GstPad *, element->numsrcpads);
+  for (l = element->srcpads; l; l = l->next) {
+    if (l->data != main_srcpad)
+      srcpads[n_srcpads++] = gst_object_ref (l->data);
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  for (i = 0; i < n_srcpads; i++) {
+    gst_pad_push_event (srcpads[i], gst_event_ref (event));
+    gst_object_unref (srcpads[i]);
+  }
+}
+
+/* The mix-minus outputs follow everything that goes out of the main source
+ * pad, so that they get the same events and a buffer for each mixed
+ * buffer */
+static GstPadProbeReturn
+gst_audiomixer_src_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GstAudioMixer *audiomixer = user_data;
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER)
+    gst_audiomixer_push_mix_minus (audiomixer,
+        GST_PAD_PROBE_INFO_BUFFER (info));
+  else if (info->type & (GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM |
+          GST_PAD_PROBE_TYPE_EVENT_FLUSH))
+    gst_audiomixer_push_mix_minus_event (audiomixer,
+        GST_PAD_PROBE_INFO_EVENT (info));
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gboolean
+copy_sticky_event (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstPad *srcpad = user_data;
+
+  gst_pad_store_sticky_event (srcpad, *event);
+
+  return TRUE;
+}
+
+static GstPad *
+gst_audiomixer_request_mix_minus_pad (GstAudioMixer * audiomixer,
+    GstPadTemplate * templ, const gchar * req_name)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstPad *main_srcpad = GST_AGGREGATOR_SRC_PAD (audiomixer);
+  GstAudioMixerPad *sinkpad;
+  GstPad *srcpad;
+  guint serial;
+
+  if (req_name == NULL || sscanf (req_name, "src_%u", &serial) != 1) {
+    GST_WARNING_OBJECT (audiomixer, "mix-minus pads need to be requested "
+        "with the name of their sink pad, like src_0 for sink_0");
+    return NULL;
+  }
+
+  srcpad = gst_element_get_static_pad (element, req_name);
+  if (srcpad) {
+    GST_WARNING_OBJECT (audiomixer, "pad %s already exists", req_name);
+    gst_object_unref (srcpad);
+    return NULL;
+  }
+
+  srcpad = gst_pad_new_from_template (templ, req_name);
+  gst_pad_use_fixed_caps (srcpad);
+
+  if (GST_PAD_IS_ACTIVE (main_srcpad)) {
+    gst_pad_set_active (srcpad, TRUE);
+    gst_pad_sticky_events_foreach (main_srcpad, copy_sticky_event, srcpad);
+  }
+
+  gst_element_add_pad (element, srcpad);
+
+  GST_OBJECT_LOCK (audiomixer);
+  sinkpad = (GstAudioMixerPad *) gst_audiomixer_find_pad (element->sinkpads,
+      "sink_%u", serial);
+  if (sinkpad)
+    gst_audiomixer_set_mix_minus_pad (sinkpad, srcpad);
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  GST_DEBUG_OBJECT (audiomixer, "added mix-minus pad %s", req_name);
+
+  return srcpad;
 }
 
 static GstPad *
@@ -250,6 +587,12 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
     const gchar * req_name, const GstCaps * caps)
 {
   GstAudioMixerPad *newpad;
+  GstPad *srcpad;
+  guint serial;
+
+  if (GST_PAD_TEMPLATE_DIRECTION (templ) == GST_PAD_SRC)
+    return gst_audiomixer_request_mix_minus_pad (GST_AUDIO_MIXER (element),
+        templ, req_name);
 
   newpad = (GstAudioMixerPad *)
       GST_ELEMENT_CLASS (parent_class)->request_new_pad (element,
@@ -258,6 +601,14 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (newpad == NULL)
     goto could_not_create;
 
+  if (sscanf (GST_OBJECT_NAME (newpad), "sink_%u", &serial) == 1) {
+    GST_OBJECT_LOCK (element);
+    srcpad = gst_audiomixer_find_pad (element->srcpads, "src_%u", serial);
+    if (srcpad)
+      gst_audiomixer_set_mix_minus_pad (newpad, srcpad);
+    GST_OBJECT_UNLOCK (element);
+  }
+
   gst_child_proxy_child_added (GST_CHILD_PROXY (element), G_OBJECT (newpad),
       GST_OBJECT_NAME (newpad));
 
@@ -279,6 +630,24 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (audiomixer, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  if (GST_PAD_IS_SRC (pad)) {
+    GST_OBJECT_LOCK (audiomixer);
+    if (pad->element_private)
+      gst_audiomixer_set_mix_minus_pad (pad->element_private, NULL);
+    pad->element_private = NULL;
+    GST_OBJECT_UNLOCK (audiomixer);
+
+    gst_pad_set_active (pad, FALSE);
+    gst_element_remove_pad (element, pad);
+    return;
+  }
+
+  GST_OBJECT_LOCK (audiomixer);
+  if (GST_AUDIO_MIXER_PAD (pad)->mix_minus_srcpad)
+    GST_AUDIO_MIXER_PAD (pad)->mix_minus_srcpad->element_private = NULL;
+  gst_audiomixer_set_mix_minus_pad (GST_AUDIO_MIXER_PAD (pad), NULL);
+  GST_OBJECT_UNLOCK (audiomixer);
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (audiomixer), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
@@ -286,134 +655,156 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 }
 
 
-static gboolean
-gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
-    GstBuffer * outbuf, guint out_offset, guint num_frames)
+static void
+gst_audiomixer_add_samples (GstAudioFormat format, guint8 * out,
+    const guint8 * in, guint n_samples, gdouble volume, gint volume_i8,
+    gint volume_i16, gint volume_i32)
 {
-  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint bpf;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
-
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (aaggpad);
-
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
-    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
-    GST_OBJECT_UNLOCK (aaggpad);
-    GST_OBJECT_UNLOCK (aagg);
-    return FALSE;
-  }
-
-  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
-
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
-      num_frames * bpf, out_offset * bpf, in_offset * bpf);
-
-  /* further buffers, need to add them */
-  if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
+  if (volume == 1.0) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u8 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s8 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u16 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s16 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u32 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s32 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f32 ((gpointer) out, (gpointer) in, n_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f64 ((gpointer) out, (gpointer) in, n_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   } else {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u8 ((gpointer) out, (gpointer) in,
+            volume_i8, n_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s8 ((gpointer) out, (gpointer) in,
+            volume_i8, n_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u16 ((gpointer) out, (gpointer) in,
+            volume_i16, n_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s16 ((gpointer) out, (gpointer) in,
+            volume_i16, n_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u32 ((gpointer) out, (gpointer) in,
+            volume_i32, n_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s32 ((gpointer) out, (gpointer) in,
+            volume_i32, n_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f32 ((gpointer) out, (gpointer) in,
+            volume, n_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f64 ((gpointer) out, (gpointer) in,
+            volume, n_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
-  gst_buffer_unmap (inbuf, &inmap);
-  gst_buffer_unmap (outbuf, &outmap);
+}
+
+static gboolean
+gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
+  GstMapInfo inmap;
+  GstMapInfo outmap;
+  gint bpf;
+  gdouble volume;
+  gint volume_i8, volume_i16, volume_i32;
+  GstBuffer *own_buffer = NULL;
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
 
+  /* This can be called from several threads at once for different parts
+   * of the output buffer, so only keep the pad locked while taking a
+   * snapshot of its volume */
+  GST_OBJECT_LOCK (aaggpad);
+  if (pad->mute || pad->volume < G_MINDOUBLE) {
+    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
+    GST_OBJECT_UNLOCK (aaggpad);
+    return FALSE;
+  }
+  volume = pad->volume;
+  volume_i8 = pad->volume_i8;
+  volume_i16 = pad->volume_i16;
+  volume_i32 = pad->volume_i32;
+
+  if (pad->mix_minus_srcpad) {
+    gsize size = gst_buffer_get_size (outbuf);
+
+    if (pad->own_buffer == NULL
+        || gst_buffer_get_size (pad->own_buffer) != size) {
+      GstMapInfo ownmap;
+
+      gst_buffer_replace (&pad->own_buffer, NULL);
+      pad->own_buffer = gst_buffer_new_allocate (NULL, size, NULL);
+      gst_buffer_map (pad->own_buffer, &ownmap, GST_MAP_WRITE);
+      gst_audio_format_fill_silence (srcpad->info.finfo, ownmap.data,
+          ownmap.size);
+      gst_buffer_unmap (pad->own_buffer, &ownmap);
+    }
+    own_buffer = gst_buffer_ref (pad->own_buffer);
+  }
   GST_OBJECT_UNLOCK (aaggpad);
-  GST_OBJECT_UNLOCK (aagg);
+
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
+      num_frames * bpf, out_offset * bpf, in_offset * bpf);
+
+  gst_audiomixer_add_samples (GST_AUDIO_INFO_FORMAT (&srcpad->info),
+      outmap.data + out_offset * bpf, inmap.data + in_offset * bpf,
+      num_frames * srcpad->info.channels, volume, volume_i8, volume_i16,
+      volume_i32);
+
+  if (own_buffer) {
+    GstMapInfo ownmap;
+
+    /* remember what this pad added for its mix-minus output */
+    gst_buffer_map (own_buffer, &ownmap, GST_MAP_READWRITE);
+    gst_audiomixer_add_samples (GST_AUDIO_INFO_FORMAT (&srcpad->info),
+        ownmap.data + out_offset * bpf, inmap.data + in_offset * bpf,
+        num_frames * srcpad->info.channels, volume, volume_i8, volume_i16,
+        volume_i32);
+    gst_buffer_unmap (own_buffer, &ownmap);
+    gst_buffer_unref (own_buffer);
+  }
+
+  gst_buffer_unmap (inbuf, &inmap);
+  gst_buffer_unmap (outbuf, &outmap);
 
   return TRUE;
 }
@@ -73,6 +73,11 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /* mix-minus output of this pad and the contribution of this pad to the
+   * current output buffer, protected by the object lock */
+  GstPad *mix_minus_srcpad;
+  GstBuffer *own_buffer;
 };
 
 struct _GstAudioMixerPadClass {
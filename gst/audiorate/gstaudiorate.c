@@ -49,6 +49,11 @@
  * that the incoming data is then simply shifted (by less than the indicated
  * tolerance) to a perfect time.
  *
+ * With jittery sources, timestamps can briefly deviate by more than the
+ * tolerance without any samples actually missing or overlapping. Setting the
+ * #GstAudioRate:hysteresis property makes audiorate keep shifting buffers
+ * until a deviation has lasted that long, and only then add or drop samples.
+ *
  * ## Example pipelines
  * |[
  * gst-launch-1.0 -v autoaudiosrc ! audiorate ! audioconvert ! wavenc ! filesink location=alsa.wav
@@ -87,6 +92,7 @@ enum
 #define DEFAULT_SILENT     TRUE
 #define DEFAULT_TOLERANCE  (40 * GST_MSECOND)
 #define DEFAULT_SKIP_TO_FIRST FALSE
+#define DEFAULT_HYSTERESIS 0
 
 enum
 {
@@ -97,7 +103,8 @@ enum
   PROP_DROP,
   PROP_SILENT,
   PROP_TOLERANCE,
-  PROP_SKIP_TO_FIRST
+  PROP_SKIP_TO_FIRST,
+  PROP_HYSTERESIS
 };
 
 static GstStaticPadTemplate gst_audio_rate_src_template =
@@ -187,6 +194,22 @@ gst_audio_rate_class_init (GstAudioRateClass * klass)
           "Don't produce buffers before the first one we receive",
           DEFAULT_SKIP_TO_FIRST, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioRate:hysteresis:
+   *
+   * How long the timestamps must keep deviating by more than
+   * #GstAudioRate:tolerance before audiorate adds or drops samples. Shorter
+   * deviations are treated as jitter and the buffers are only shifted. 0
+   * acts on the first deviating buffer.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class, PROP_HYSTERESIS,
+      g_param_spec_uint64 ("hysteresis", "Hysteresis",
+          "Only act if timestamps deviate beyond the tolerance for this long (ns)",
+          0, G_MAXUINT64, DEFAULT_HYSTERESIS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Audio rate adjuster", "Filter/Effect/Audio",
       "Drops/duplicates/adjusts timestamps on audio samples to make a perfect stream",
@@ -206,6 +229,7 @@ gst_audio_rate_reset (GstAudioRate * audiorate)
   audiorate->next_offset = -1;
   audiorate->next_ts = -1;
   audiorate->discont = TRUE;
+  audiorate->deviation_start = GST_CLOCK_TIME_NONE;
   gst_segment_init (&audiorate->sink_segment, GST_FORMAT_UNDEFINED);
   gst_segment_init (&audiorate->src_segment, GST_FORMAT_TIME);
 
@@ -223,6 +247,7 @@ gst_audio_rate_setcaps (GstAudioRate * audiorate, GstCaps * caps)
 
   prev_rate = audiorate->info.rate;
   audiorate->info = info;
+  gst_buffer_replace (&audiorate->silence, NULL);
 
   if (audiorate->next_offset >= 0 && prev_rate > 0 && prev_rate != info.rate) {
     GST_DEBUG_OBJECT (audiorate,
@@ -266,6 +291,30 @@ gst_audio_rate_init (GstAudioRate * audiorate)
   audiorate->add = 0;
   audiorate->silent = DEFAULT_SILENT;
   audiorate->tolerance = DEFAULT_TOLERANCE;
+  audiorate->hysteresis = DEFAULT_HYSTERESIS;
+  audiorate->deviation_start = GST_CLOCK_TIME_NONE;
+}
+
+/* Returns a buffer with @samples samples of silence, sharing its memory
+ * with all other fill buffers */
+static GstBuffer *
+gst_audio_rate_get_silence (GstAudioRate * audiorate, guint64 samples)
+{
+  gint bpf = GST_AUDIO_INFO_BPF (&audiorate->info);
+
+  /* fill buffers are at most one second long */
+  if (audiorate->silence == NULL) {
+    GstMapInfo map;
+
+    audiorate->silence = gst_buffer_new_and_alloc (GST_AUDIO_INFO_RATE
+        (&audiorate->info) * bpf);
+    gst_buffer_map (audiorate->silence, &map, GST_MAP_WRITE);
+    gst_audio_format_fill_silence (audiorate->info.finfo, map.data, map.size);
+    gst_buffer_unmap (audiorate->silence, &map);
+  }
+
+  return gst_buffer_copy_region (audiorate->silence, GST_BUFFER_COPY_MEMORY, 0,
+      samples * bpf);
 }
 
 static void
@@ -450,6 +499,7 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   guint in_size;
   GstFlowReturn ret = GST_FLOW_OK;
   GstClockTimeDiff diff;
+  gboolean within_tolerance;
   gint rate, bpf;
   GstAudioMeta *meta;
 
@@ -524,8 +574,27 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       GST_TIME_ARGS (audiorate->next_ts));
 
   diff = in_time - audiorate->next_ts;
-  if (diff <= (GstClockTimeDiff) audiorate->tolerance &&
-      diff >= (GstClockTimeDiff) - audiorate->tolerance) {
+  within_tolerance = (diff <= (GstClockTimeDiff) audiorate->tolerance &&
+      diff >= (GstClockTimeDiff) - audiorate->tolerance);
+
+  if (within_tolerance) {
+    audiorate->deviation_start = GST_CLOCK_TIME_NONE;
+  } else if (audiorate->hysteresis > 0) {
+    if (!GST_CLOCK_TIME_IS_VALID (audiorate->deviation_start))
+      audiorate->deviation_start = in_time;
+
+    /* not persisting long enough yet, treat it as jitter */
+    if (ABS (GST_CLOCK_DIFF (audiorate->deviation_start, in_time)) <
+        (GstClockTimeDiff) audiorate->hysteresis) {
+      GST_LOG_OBJECT (audiorate, "deviation of %" GST_STIME_FORMAT
+          " within hysteresis", GST_STIME_ARGS (diff));
+      within_tolerance = TRUE;
+    } else {
+      audiorate->deviation_start = GST_CLOCK_TIME_NONE;
+    }
+  }
+
+  if (within_tolerance) {
     /* buffer time close enough to expected time,
      * so produce a perfect stream by simply 'shifting'
      * it to next ts and offset and sending */
@@ -541,7 +610,6 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   /* do we need to insert samples */
   if (in_offset > audiorate->next_offset) {
     GstBuffer *fill;
-    gint fillsize;
     guint64 fillsamples;
 
     /* We don't want to allocate a single unreasonably huge buffer - it might
@@ -551,17 +619,10 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
     while (fillsamples > 0) {
       guint64 cursamples = MIN (fillsamples, rate);
-      GstMapInfo fillmap;
 
       fillsamples -= cursamples;
-      fillsize = cursamples * bpf;
-
-      fill = gst_buffer_new_and_alloc (fillsize);
 
-      gst_buffer_map (fill, &fillmap, GST_MAP_WRITE);
-      gst_audio_format_fill_silence (audiorate->info.finfo, fillmap.data,
-          fillmap.size);
-      gst_buffer_unmap (fill, &fillmap);
+      fill = gst_audio_rate_get_silence (audiorate, cursamples);
 
       if (audiorate->info.layout == GST_AUDIO_LAYOUT_NON_INTERLEAVED) {
         gst_buffer_add_audio_meta (fill, &audiorate->info, cursamples, NULL);
@@ -598,14 +659,18 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
         ret = gst_pad_push (audiorate->srcpad, fill);
 
       if (ret != GST_FLOW_OK)
-        goto beach;
+        break;
       audiorate->out += cursamples;
       audiorate->add += cursamples;
-
-      if (!audiorate->silent)
-        gst_audio_rate_notify_add (audiorate);
     }
 
+    /* one notification for the whole gap */
+    if (!audiorate->silent)
+      gst_audio_rate_notify_add (audiorate);
+
+    if (ret != GST_FLOW_OK)
+      goto beach;
+
   } else if (in_offset < audiorate->next_offset) {
     /* need to remove samples */
     if (in_offset_end <= audiorate->next_offset) {
@@ -631,7 +696,12 @@ gst_audio_rate_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       truncsamples = audiorate->next_offset - in_offset;
       leftsamples = in_samples - truncsamples;
 
-      buf = gst_audio_buffer_truncate (buf, bpf, truncsamples, leftsamples);
+      if (meta == NULL && gst_buffer_is_writable (buf)) {
+        /* no need for a new buffer, trim this one */
+        gst_buffer_resize (buf, truncsamples * bpf, leftsamples * bpf);
+      } else {
+        buf = gst_audio_buffer_truncate (buf, bpf, truncsamples, leftsamples);
+      }
 
       audiorate->drop += truncsamples;
       audiorate->out += leftsamples;
@@ -716,6 +786,9 @@ gst_audio_rate_set_property (GObject * object,
     case PROP_SKIP_TO_FIRST:
       audiorate->skip_to_first = g_value_get_boolean (value);
       break;
+    case PROP_HYSTERESIS:
+      audiorate->hysteresis = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -750,6 +823,9 @@ gst_audio_rate_get_property (GObject * object,
     case PROP_SKIP_TO_FIRST:
       g_value_set_boolean (value, audiorate->skip_to_first);
       break;
+    case PROP_HYSTERESIS:
+      g_value_set_uint64 (value, audiorate->hysteresis);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -760,6 +836,7 @@ static GstStateChangeReturn
 gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
 {
   GstAudioRate *audiorate = GST_AUDIO_RATE (element);
+  GstStateChangeReturn ret;
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
@@ -776,7 +853,17 @@ gst_audio_rate_change_state (GstElement * element, GstStateChange transition)
       break;
   }
 
-  return GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_buffer_replace (&audiorate->silence, NULL);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
 }
 
 static gboolean
@@ -58,6 +58,7 @@ struct _GstAudioRate
   gboolean silent;
   guint64 tolerance;
   gboolean skip_to_first;
+  guint64 hysteresis;
 
   /* audio state */
   guint64 next_offset;
@@ -65,6 +66,12 @@ struct _GstAudioRate
 
   gboolean discont;
 
+  /* timestamp of the first buffer beyond tolerance, while within hysteresis */
+  GstClockTime deviation_start;
+
+  /* one second of silence, shared by all fill buffers */
+  GstBuffer *silence;
+
   gboolean new_segment;
   /* we accept all formats on the sink */
   GstSegment sink_segment;
@@ -42,6 +42,15 @@
  * To create the Ogg/Vorbis file refer to the documentation of vorbisenc.
  * This assumes there is an audio sink that will accept/handle 8kHz audio.
  *
+ * ## Clock drift compensation
+ *
+ * When bridging two unrelated clocks, for example a network receiver and a
+ * sound card, the #GstAudioResample:rate-ratio property can be updated
+ * continuously to absorb the drift between them. Changing it does not
+ * renegotiate caps and does not recompute the filter: the interpolated sinc
+ * table is used and only the resampling phase increment changes, with a
+ * resolution below one part per million.
+ *
  */
 
 /* TODO:
@@ -70,6 +79,12 @@ GST_DEBUG_CATEGORY (audio_resample_debug);
 #define DEFAULT_SINC_FILTER_MODE GST_AUDIO_RESAMPLER_FILTER_MODE_AUTO
 #define DEFAULT_SINC_FILTER_AUTO_THRESHOLD (1*1048576)
 #define DEFAULT_SINC_FILTER_INTERPOLATION GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC
+#define DEFAULT_RATE_RATIO 1.0
+
+/* upper bound for the rates handed to the resampler when a rate ratio is
+ * applied. It gives a ratio resolution of better than 0.25 ppm while
+ * keeping the phase times the largest oversampling factor in a gint. */
+#define RATE_RATIO_MAX_RATE (1 << 22)
 
 enum
 {
@@ -78,7 +93,8 @@ enum
   PROP_RESAMPLE_METHOD,
   PROP_SINC_FILTER_MODE,
   PROP_SINC_FILTER_AUTO_THRESHOLD,
-  PROP_SINC_FILTER_INTERPOLATION
+  PROP_SINC_FILTER_INTERPOLATION,
+  PROP_RATE_RATIO
 };
 
 #define SUPPORTED_CAPS \
@@ -174,6 +190,23 @@ gst_audio_resample_class_init (GstAudioResampleClass * klass)
           DEFAULT_SINC_FILTER_INTERPOLATION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioResample:rate-ratio:
+   *
+   * Factor applied to the negotiated output rate, a ratio of 1.000001 produces
+   * one extra sample per million. It can be changed while streaming, for
+   * example to compensate for clock drift, and takes effect on the next
+   * buffer without renegotiation or filter recomputation.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_RATE_RATIO,
+      g_param_spec_double ("rate-ratio", "Rate ratio",
+          "Factor applied to the output rate to compensate for clock drift",
+          0.9, 1.1, DEFAULT_RATE_RATIO,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_audio_resample_src_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -219,6 +252,8 @@ gst_audio_resample_init (GstAudioResample * resample)
   resample->sinc_filter_mode = DEFAULT_SINC_FILTER_MODE;
   resample->sinc_filter_auto_threshold = DEFAULT_SINC_FILTER_AUTO_THRESHOLD;
   resample->sinc_filter_interpolation = DEFAULT_SINC_FILTER_INTERPOLATION;
+  resample->rate_ratio = DEFAULT_RATE_RATIO;
+  resample->applied_rate_ratio = DEFAULT_RATE_RATIO;
 
   gst_base_transform_set_gap_aware (trans, TRUE);
   gst_pad_set_query_function (trans->srcpad, gst_audio_resample_query);
@@ -351,6 +386,26 @@ gst_audio_resample_fixate_caps (GstBaseTransform * base,
   return othercaps;
 }
 
+/* the rates to configure the resampler with for @ratio. A ratio other than
+ * 1.0 is expressed with rates scaled up to RATE_RATIO_MAX_RATE. */
+static void
+get_resampler_rates (const GstAudioInfo * in, const GstAudioInfo * out,
+    gdouble ratio, gint * in_rate, gint * out_rate)
+{
+  gint scale;
+
+  if (ratio == 1.0) {
+    *in_rate = in->rate;
+    *out_rate = out->rate;
+    return;
+  }
+
+  scale = RATE_RATIO_MAX_RATE / MAX (in->rate, out->rate + out->rate / 10);
+  scale = MAX (scale, 1);
+  *in_rate = in->rate * scale;
+  *out_rate = (gint) (out->rate * ratio * scale + 0.5);
+}
+
 static GstStructure *
 make_options (GstAudioResample * resample, GstAudioInfo * in,
     GstAudioInfo * out)
@@ -372,6 +427,21 @@ make_options (GstAudioResample * resample, GstAudioInfo * in,
       GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION,
       resample->sinc_filter_interpolation, NULL);
 
+  /* a full filter table would have one entry per phase of the scaled rates,
+   * always interpolate when a rate ratio is applied */
+  if (resample->applied_rate_ratio != 1.0) {
+    gst_structure_set (options,
+        GST_AUDIO_RESAMPLER_OPT_FILTER_MODE,
+        GST_TYPE_AUDIO_RESAMPLER_FILTER_MODE,
+        GST_AUDIO_RESAMPLER_FILTER_MODE_INTERPOLATED, NULL);
+    if (resample->sinc_filter_interpolation ==
+        GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_NONE)
+      gst_structure_set (options,
+          GST_AUDIO_RESAMPLER_OPT_FILTER_INTERPOLATION,
+          GST_TYPE_AUDIO_RESAMPLER_FILTER_INTERPOLATION,
+          GST_AUDIO_RESAMPLER_FILTER_INTERPOLATION_CUBIC, NULL);
+  }
+
   return options;
 }
 
@@ -382,10 +452,17 @@ gst_audio_resample_update_state (GstAudioResample * resample, GstAudioInfo * in,
   gboolean updated_latency = FALSE;
   gsize old_latency = -1;
   GstStructure *options;
+  gint in_rate, out_rate;
 
   if (resample->converter == NULL && in == NULL && out == NULL)
     return TRUE;
 
+  if (in != NULL && out != NULL) {
+    GST_OBJECT_LOCK (resample);
+    resample->applied_rate_ratio = resample->rate_ratio;
+    GST_OBJECT_UNLOCK (resample);
+  }
+
   options = make_options (resample, in, out);
 
   if (resample->converter)
@@ -404,12 +481,20 @@ gst_audio_resample_update_state (GstAudioResample * resample, GstAudioInfo * in,
         out, options);
     if (resample->converter == NULL)
       goto resampler_failed;
+    if (resample->applied_rate_ratio != 1.0) {
+      get_resampler_rates (in, out, resample->applied_rate_ratio, &in_rate,
+          &out_rate);
+      gst_audio_converter_update_config (resample->converter, in_rate,
+          out_rate, NULL);
+    }
   } else if (in && out) {
     gboolean ret;
 
+    get_resampler_rates (in, out, resample->applied_rate_ratio, &in_rate,
+        &out_rate);
     ret =
-        gst_audio_converter_update_config (resample->converter, in->rate,
-        out->rate, options);
+        gst_audio_converter_update_config (resample->converter, in_rate,
+        out_rate, options);
     if (!ret)
       goto update_failed;
   } else {
@@ -439,6 +524,35 @@ update_failed:
   }
 }
 
+/* pick up a new rate-ratio. Only the rates of the resampler change, the
+ * filter is reconfigured once when leaving or entering the ratio 1.0, to
+ * switch to the interpolated filter table. */
+static void
+gst_audio_resample_update_rate_ratio (GstAudioResample * resample)
+{
+  gdouble old_ratio = resample->applied_rate_ratio;
+  GstStructure *options = NULL;
+  gint in_rate, out_rate;
+
+  GST_OBJECT_LOCK (resample);
+  resample->applied_rate_ratio = resample->rate_ratio;
+  GST_OBJECT_UNLOCK (resample);
+
+  if (resample->applied_rate_ratio == old_ratio || !resample->converter)
+    return;
+
+  GST_LOG_OBJECT (resample, "rate ratio %.9f -> %.9f", old_ratio,
+      resample->applied_rate_ratio);
+
+  if (old_ratio == 1.0 || resample->applied_rate_ratio == 1.0)
+    options = make_options (resample, &resample->in, &resample->out);
+
+  get_resampler_rates (&resample->in, &resample->out,
+      resample->applied_rate_ratio, &in_rate, &out_rate);
+  gst_audio_converter_update_config (resample->converter, in_rate, out_rate,
+      options);
+}
+
 static void
 gst_audio_resample_reset_state (GstAudioResample * resample)
 {
@@ -503,6 +617,10 @@ gst_audio_resample_set_caps (GstBaseTransform * base, GstCaps * incaps,
   resample->in = in;
   resample->out = out;
 
+  /* a rate ratio needs resampling even between identical caps */
+  if (resample->applied_rate_ratio != 1.0)
+    gst_base_transform_set_passthrough (base, FALSE);
+
   return TRUE;
 
   /* ERROR */
@@ -850,6 +968,8 @@ gst_audio_resample_transform (GstBaseTransform * base, GstBuffer * inbuf,
       GST_TIME_ARGS (GST_BUFFER_DURATION (inbuf)),
       GST_BUFFER_OFFSET (inbuf), GST_BUFFER_OFFSET_END (inbuf));
 
+  gst_audio_resample_update_rate_ratio (resample);
+
   /* check for timestamp discontinuities;  flush/reset if needed, and set
    * flag to resync timestamp and offset counters and send event
    * downstream */
@@ -1041,6 +1161,18 @@ gst_audio_resample_set_property (GObject * object, guint prop_id,
       resample->sinc_filter_interpolation = g_value_get_enum (value);
       gst_audio_resample_update_state (resample, NULL, NULL);
       break;
+    case PROP_RATE_RATIO:{
+      gdouble ratio = g_value_get_double (value);
+
+      /* picked up by the streaming thread with the next buffer */
+      GST_OBJECT_LOCK (resample);
+      resample->rate_ratio = ratio;
+      GST_OBJECT_UNLOCK (resample);
+      if (ratio != 1.0)
+        gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (resample),
+            FALSE);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1071,6 +1203,11 @@ gst_audio_resample_get_property (GObject * object, guint prop_id,
     case PROP_SINC_FILTER_INTERPOLATION:
       g_value_set_enum (value, resample->sinc_filter_interpolation);
       break;
+    case PROP_RATE_RATIO:
+      GST_OBJECT_LOCK (resample);
+      g_value_set_double (value, resample->rate_ratio);
+      GST_OBJECT_UNLOCK (resample);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
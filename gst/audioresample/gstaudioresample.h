@@ -68,8 +68,10 @@ struct _GstAudioResample {
   GstAudioResamplerFilterMode sinc_filter_mode;
   guint32 sinc_filter_auto_threshold;
   GstAudioResamplerFilterInterpolation sinc_filter_interpolation;
+  gdouble rate_ratio;           /* protected by the object lock */
 
   /* state */
+  gdouble applied_rate_ratio;
   GstAudioInfo in;
   GstAudioInfo out;
   GstAudioConverter *converter;
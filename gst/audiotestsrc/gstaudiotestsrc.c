@@ -347,6 +347,8 @@ gst_audio_test_src_finalize (GObject * object)
   g_free (src->tmp);
   src->tmp = NULL;
   src->tmpsize = 0;
+  g_free (src->period_table);
+  src->period_table = NULL;
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -477,13 +479,34 @@ error:
   }
 }
 
+/* longest period, in samples, for which the sine is generated from a table */
+#define SINE_MAX_PERIOD 8192
+
+/* returns the period of the sine in samples when the rate is an integer
+ * multiple of the frequency, 0 otherwise */
+static gint
+gst_audio_test_src_get_sine_period (GstAudioTestSrc * src)
+{
+  gdouble period;
+
+  if (src->freq <= 0.0)
+    return 0;
+
+  period = GST_AUDIO_INFO_RATE (&src->info) / src->freq;
+  if (period < 1.0 || period > SINE_MAX_PERIOD
+      || fabs (period - rint (period)) > 1e-9 * period)
+    return 0;
+
+  return (gint) rint (period);
+}
+
 #define DEFINE_SINE(type,scale) \
 static void \
 gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples) \
 { \
-  gint i, c, channels, channel_step, sample_step; \
+  gint i, c, channels, channel_step, sample_step, period; \
   gdouble step, amp; \
-  g##type *ptr; \
+  g##type *ptr, val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   if (GST_AUDIO_INFO_LAYOUT (&src->info) == GST_AUDIO_LAYOUT_INTERLEAVED) { \
@@ -496,14 +519,53 @@ gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples)
   step = M_PI_M2 * src->freq / GST_AUDIO_INFO_RATE (&src->info); \
   amp = src->volume * scale; \
   \
+  period = gst_audio_test_src_get_sine_period (src); \
+  if (period > 0) { \
+    g##type *table; \
+    gint pos; \
+    \
+    /* one period of samples with the volume applied, rebuilt when the \
+     * frequency, volume or format change */ \
+    if (src->period_func != (ProcessFunc) gst_audio_test_src_create_sine_##type \
+        || src->period_len != period || src->period_amp != amp) { \
+      g_free (src->period_table); \
+      table = g_new (g##type, period); \
+      for (i = 0; i < period; i++) \
+        table[i] = (g##type) (sin (M_PI_M2 * i / period) * amp); \
+      src->period_table = table; \
+      src->period_func = (ProcessFunc) gst_audio_test_src_create_sine_##type; \
+      src->period_len = period; \
+      src->period_amp = amp; \
+    } \
+    table = src->period_table; \
+    \
+    /* continue from the current phase, rounded to the nearest sample */ \
+    pos = ((gint) rint (src->accumulator / step)) % period; \
+    for (i = 0; i < src->generate_samples_per_buffer; i++) { \
+      if (++pos == period) \
+        pos = 0; \
+      \
+      val = table[pos]; \
+      ptr = samples; \
+      for (c = 0; c < channels; ++c) { \
+        *ptr = val; \
+        ptr += channel_step; \
+      } \
+      samples += sample_step; \
+    } \
+    src->accumulator = pos * step; \
+    return; \
+  } \
+  \
   for (i = 0; i < src->generate_samples_per_buffer; i++) { \
     src->accumulator += step; \
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
+    val = (g##type) (sin (src->accumulator) * amp); \
     ptr = samples; \
     for (c = 0; c < channels; ++c) { \
-      *ptr = (g##type) (sin (src->accumulator) * amp); \
+      *ptr = val; \
       ptr += channel_step; \
     } \
     samples += sample_step; \
@@ -861,7 +923,7 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
 { \
   gint i, c, channels, channel_step, sample_step; \
   gdouble step, scl; \
-  g##type *ptr; \
+  g##type *ptr, val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   if (GST_AUDIO_INFO_LAYOUT (&src->info) == GST_AUDIO_LAYOUT_INTERLEAVED) { \
@@ -879,9 +941,10 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
+    val = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
     ptr = samples; \
     for (c = 0; c < channels; ++c) { \
-      *ptr = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
+      *ptr = val; \
       ptr += channel_step; \
     } \
     samples += sample_step; \
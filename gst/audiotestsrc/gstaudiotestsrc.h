@@ -137,6 +137,10 @@ struct _GstAudioTestSrc {
   GstPinkNoise pink;
   GstRedNoise red;
   gdouble wave_table[1024];
+  gpointer period_table;    /* one period of sine, volume applied */
+  ProcessFunc period_func;  /* sine function the table was built for */
+  gint period_len;
+  gdouble period_amp;
   guint sine_periods_per_tick;
   guint64 tick_interval;
   guint marker_tick_period;
@@ -42,7 +42,8 @@ GST_DEBUG_CATEGORY_STATIC (gst_compositor_blend_debug);
 #define BLEND_A32(name, method, LOOP)		\
 static void \
 method##_ ##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
-    gdouble src_alpha, GstVideoFrame * destframe, GstCompositorBlendMode mode) \
+    gdouble src_alpha, GstVideoFrame * destframe, gint dst_y_start, \
+    gint dst_y_end, GstCompositorBlendMode mode) \
 { \
   guint s_alpha; \
   gint src_stride, dest_stride; \
@@ -58,6 +59,7 @@ method##_ ##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   dest_stride = GST_VIDEO_FRAME_COMP_STRIDE (destframe, 0); \
   dest_width = GST_VIDEO_FRAME_COMP_WIDTH (destframe, 0); \
   dest_height = GST_VIDEO_FRAME_COMP_HEIGHT (destframe, 0); \
+  dst_y_end = MIN (dst_y_end, dest_height); \
   \
   s_alpha = CLAMP ((gint) (src_alpha * 255), 0, 255); \
   \
@@ -71,17 +73,17 @@ method##_ ##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
     src_width -= -xpos; \
     xpos = 0; \
   } \
-  if (ypos < 0) { \
-    src += -ypos * src_stride; \
-    src_height -= -ypos; \
-    ypos = 0; \
+  if (ypos < dst_y_start) { \
+    src += (dst_y_start - ypos) * src_stride; \
+    src_height -= dst_y_start - ypos; \
+    ypos = dst_y_start; \
   } \
   /* adjust width/height if the src is bigger than dest */ \
   if (xpos + src_width > dest_width) { \
     src_width = dest_width - xpos; \
   } \
-  if (ypos + src_height > dest_height) { \
-    src_height = dest_height - ypos; \
+  if (ypos + src_height > dst_y_end) { \
+    src_height = dst_y_end - ypos; \
   } \
   \
   if (src_height > 0 && src_width > 0) { \
@@ -291,7 +293,8 @@ _blend_##format_name (const guint8 * src, guint8 * dest, \
 \
 static void \
 blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
-    gdouble src_alpha, GstVideoFrame * destframe, GstCompositorBlendMode mode) \
+    gdouble src_alpha, GstVideoFrame * destframe, gint dst_y_start, \
+    gint dst_y_end, GstCompositorBlendMode mode) \
 { \
   const guint8 *b_src; \
   guint8 *b_dest; \
@@ -314,6 +317,7 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   info = srcframe->info.finfo; \
   dest_width = GST_VIDEO_FRAME_WIDTH (destframe); \
   dest_height = GST_VIDEO_FRAME_HEIGHT (destframe); \
+  dst_y_end = MIN (dst_y_end, dest_height); \
   \
   xpos = x_round (xpos); \
   ypos = y_round (ypos); \
@@ -327,10 +331,10 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
     b_src_width -= -xpos; \
     xpos = 0; \
   } \
-  if (ypos < 0) { \
-    yoffset = -ypos; \
-    b_src_height -= -ypos; \
-    ypos = 0; \
+  if (ypos < dst_y_start) { \
+    yoffset = dst_y_start - ypos; \
+    b_src_height -= dst_y_start - ypos; \
+    ypos = dst_y_start; \
   } \
   /* If x or y offset are larger then the source it's outside of the picture */ \
   if (xoffset >= src_width || yoffset >= src_height) { \
@@ -341,8 +345,8 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   if (xpos + b_src_width > dest_width) { \
     b_src_width = dest_width - xpos; \
   } \
-  if (ypos + b_src_height > dest_height) { \
-    b_src_height = dest_height - ypos; \
+  if (ypos + b_src_height > dst_y_end) { \
+    b_src_height = dst_y_end - ypos; \
   } \
   if (b_src_width <= 0 || b_src_height <= 0) { \
     return; \
@@ -541,7 +545,8 @@ _blend_##format_name (const guint8 * src, guint8 * dest, \
 \
 static void \
 blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
-    gdouble src_alpha, GstVideoFrame * destframe, GstCompositorBlendMode mode)                    \
+    gdouble src_alpha, GstVideoFrame * destframe, gint dst_y_start, \
+    gint dst_y_end, GstCompositorBlendMode mode) \
 { \
   const guint8 *b_src; \
   guint8 *b_dest; \
@@ -564,6 +569,7 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   info = srcframe->info.finfo; \
   dest_width = GST_VIDEO_FRAME_WIDTH (destframe); \
   dest_height = GST_VIDEO_FRAME_HEIGHT (destframe); \
+  dst_y_end = MIN (dst_y_end, dest_height); \
   \
   xpos = GST_ROUND_UP_2 (xpos); \
   ypos = GST_ROUND_UP_2 (ypos); \
@@ -577,10 +583,10 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
     b_src_width -= -xpos; \
     xpos = 0; \
   } \
-  if (ypos < 0) { \
-    yoffset += -ypos; \
-    b_src_height -= -ypos; \
-    ypos = 0; \
+  if (ypos < dst_y_start) { \
+    yoffset = dst_y_start - ypos; \
+    b_src_height -= dst_y_start - ypos; \
+    ypos = dst_y_start; \
   } \
   /* If x or y offset are larger then the source it's outside of the picture */ \
   if (xoffset > src_width || yoffset > src_height) { \
@@ -591,10 +597,10 @@ blend_##format_name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   if (xpos + src_width > dest_width) { \
     b_src_width = dest_width - xpos; \
   } \
-  if (ypos + src_height > dest_height) { \
-    b_src_height = dest_height - ypos; \
+  if (ypos + b_src_height > dst_y_end) { \
+    b_src_height = dst_y_end - ypos; \
   } \
-  if (b_src_width < 0 || b_src_height < 0) { \
+  if (b_src_width <= 0 || b_src_height <= 0) { \
     return; \
   } \
   \
@@ -712,7 +718,8 @@ NV_YUV_FILL_CHECKER (nv21, memset);
 #define RGB_BLEND(name, bpp, MEMCPY, BLENDLOOP) \
 static void \
 blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
-    gdouble src_alpha, GstVideoFrame * destframe, GstCompositorBlendMode mode) \
+    gdouble src_alpha, GstVideoFrame * destframe, gint dst_y_start, \
+    gint dst_y_end, GstCompositorBlendMode mode) \
 { \
   gint b_alpha; \
   gint i; \
@@ -729,6 +736,7 @@ blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   \
   dest_width = GST_VIDEO_FRAME_WIDTH (destframe); \
   dest_height = GST_VIDEO_FRAME_HEIGHT (destframe); \
+  dst_y_end = MIN (dst_y_end, dest_height); \
   \
   src_stride = GST_VIDEO_FRAME_COMP_STRIDE (srcframe, 0); \
   dest_stride = GST_VIDEO_FRAME_COMP_STRIDE (destframe, 0); \
@@ -741,19 +749,23 @@ blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
     src_width -= -xpos; \
     xpos = 0; \
   } \
-  if (ypos < 0) { \
-    src += -ypos * src_stride; \
-    src_height -= -ypos; \
-    ypos = 0; \
+  if (ypos < dst_y_start) { \
+    src += (dst_y_start - ypos) * src_stride; \
+    src_height -= dst_y_start - ypos; \
+    ypos = dst_y_start; \
   } \
   /* adjust width/height if the src is bigger than dest */ \
   if (xpos + src_width > dest_width) { \
     src_width = dest_width - xpos; \
   } \
-  if (ypos + src_height > dest_height) { \
-    src_height = dest_height - ypos; \
+  if (ypos + src_height > dst_y_end) { \
+    src_height = dst_y_end - ypos; \
   } \
   \
+  /* nothing to do if the source is outside of the destination rows */ \
+  if (src_height <= 0 || src_width <= 0) \
+    return; \
+  \
   dest = dest + bpp * xpos + (ypos * dest_stride); \
   \
   /* in source mode we just have to copy over things */ \
@@ -884,7 +896,8 @@ RGB_FILL_COLOR (bgrx, 4, _memset_bgrx);
 #define PACKED_422_BLEND(name, MEMCPY, BLENDLOOP) \
 static void \
 blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
-    gdouble src_alpha, GstVideoFrame * destframe, GstCompositorBlendMode mode) \
+    gdouble src_alpha, GstVideoFrame * destframe, gint dst_y_start, \
+    gint dst_y_end, GstCompositorBlendMode mode) \
 { \
   gint b_alpha; \
   gint i; \
@@ -898,6 +911,7 @@ blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
   \
   dest_width = GST_VIDEO_FRAME_WIDTH (destframe); \
   dest_height = GST_VIDEO_FRAME_HEIGHT (destframe); \
+  dst_y_end = MIN (dst_y_end, dest_height); \
   \
   src = GST_VIDEO_FRAME_PLANE_DATA (srcframe, 0); \
   dest = GST_VIDEO_FRAME_PLANE_DATA (destframe, 0); \
@@ -915,20 +929,24 @@ blend_##name (GstVideoFrame * srcframe, gint xpos, gint ypos, \
     src_width -= -xpos; \
     xpos = 0; \
   } \
-  if (ypos < 0) { \
-    src += -ypos * src_stride; \
-    src_height -= -ypos; \
-    ypos = 0; \
+  if (ypos < dst_y_start) { \
+    src += (dst_y_start - ypos) * src_stride; \
+    src_height -= dst_y_start - ypos; \
+    ypos = dst_y_start; \
   } \
   \
   /* adjust width/height if the src is bigger than dest */ \
   if (xpos + src_width > dest_width) { \
     src_width = dest_width - xpos; \
   } \
-  if (ypos + src_height > dest_height) { \
-    src_height = dest_height - ypos; \
+  if (ypos + src_height > dst_y_end) { \
+    src_height = dst_y_end - ypos; \
   } \
   \
+  /* nothing to do if the source is outside of the destination rows */ \
+  if (src_height <= 0 || src_width <= 0) \
+    return; \
+  \
   dest = dest + 2 * xpos + (ypos * dest_stride); \
   \
   /* in source mode we just have to copy over things */ \
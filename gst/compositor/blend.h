@@ -39,6 +39,7 @@ typedef enum
 } GstCompositorBlendMode;
 
 typedef void (*BlendFunction) (GstVideoFrame *srcframe, gint xpos, gint ypos, gdouble src_alpha, GstVideoFrame * destframe,
+    gint dst_y_start, gint dst_y_end,
     GstCompositorBlendMode mode);
 typedef void (*FillCheckerFunction) (GstVideoFrame * frame);
 typedef void (*FillColorFunction) (GstVideoFrame * frame, gint c1, gint c2, gint c3);
@@ -121,6 +121,7 @@ static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink_%u",
 
 static void gst_compositor_child_proxy_init (gpointer g_iface,
     gpointer iface_data);
+static void gst_compositor_finalize (GObject * object);
 
 #define GST_TYPE_COMPOSITOR_OPERATOR (gst_compositor_operator_get_type())
 static GType
@@ -459,6 +460,16 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *pad = GST_COMPOSITOR_PAD (object);
+
+  gst_buffer_replace (&pad->last_buffer, NULL);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -470,6 +481,7 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->finalize = gst_compositor_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -516,10 +528,12 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 
 /* GstCompositor */
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
+#define DEFAULT_MAX_THREADS 0
 enum
 {
   PROP_0,
   PROP_BACKGROUND,
+  PROP_MAX_THREADS,
 };
 
 #define GST_TYPE_COMPOSITOR_BACKGROUND (gst_compositor_background_get_type())
@@ -555,6 +569,11 @@ gst_compositor_get_property (GObject * object,
     case PROP_BACKGROUND:
       g_value_set_enum (value, self->background);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->max_threads);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -571,6 +590,11 @@ gst_compositor_set_property (GObject * object,
     case PROP_BACKGROUND:
       self->background = g_value_get_enum (value);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (self);
+      self->max_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -844,6 +868,11 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
     return FALSE;
   }
 
+  /* the last output can't be reused with a different format */
+  GST_OBJECT_LOCK (agg);
+  gst_buffer_replace (&GST_COMPOSITOR (agg)->last_outbuf, NULL);
+  GST_OBJECT_UNLOCK (agg);
+
   return GST_AGGREGATOR_CLASS (parent_class)->negotiated_src_caps (agg, caps);
 }
 
@@ -871,9 +900,10 @@ _should_draw_background (GstVideoAggregator * vagg, gboolean bg_transparent)
   return draw;
 }
 
+/* Decides if the background has to be drawn and which BlendFunction is used
+ * for compositing on top of it */
 static gboolean
-_draw_background (GstVideoAggregator * vagg, GstVideoFrame * outframe,
-    BlendFunction * composite)
+_draw_background (GstVideoAggregator * vagg, BlendFunction * composite)
 {
   GstCompositor *comp = GST_COMPOSITOR (vagg);
 
@@ -886,6 +916,16 @@ _draw_background (GstVideoAggregator * vagg, GstVideoFrame * outframe,
           comp->background == COMPOSITOR_BACKGROUND_TRANSPARENT))
     return FALSE;
 
+  /* use overlay to keep background transparent */
+  if (comp->background == COMPOSITOR_BACKGROUND_TRANSPARENT)
+    *composite = comp->overlay;
+
+  return TRUE;
+}
+
+static void
+_fill_background (GstCompositor * comp, GstVideoFrame * outframe)
+{
   switch (comp->background) {
     case COMPOSITOR_BACKGROUND_CHECKER:
       comp->fill_checker (outframe);
@@ -915,13 +955,9 @@ _draw_background (GstVideoAggregator * vagg, GstVideoFrame * outframe,
           pdata += plane_stride;
         }
       }
-      /* use overlay to keep background transparent */
-      *composite = comp->overlay;
       break;
     }
   }
-
-  return TRUE;
 }
 
 static gboolean
@@ -936,30 +972,327 @@ frames_can_copy (const GstVideoFrame * frame1, const GstVideoFrame * frame2)
   return TRUE;
 }
 
+/* Makes @view describe the rows @y_start to @y_end of @frame so that the
+ * functions working on whole frames can be used on a part of it. @y_start
+ * must be aligned to the vertical subsampling. */
+static void
+frame_rows_view (GstVideoFrame * view, const GstVideoFrame * frame,
+    gint y_start, gint y_end)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i;
+
+  *view = *frame;
+  view->info.height = y_end - y_start;
+  for (i = 0; i < GST_VIDEO_FORMAT_INFO_N_COMPONENTS (finfo); i++) {
+    guint plane = GST_VIDEO_FORMAT_INFO_PLANE (finfo, i);
+    gint y = GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, i, y_start);
+
+    view->data[plane] = (guint8 *) frame->data[plane] +
+        y * GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+  }
+}
+
+/* The output is handled in stripes of rows. Only the stripes in which some
+ * input changed since the last output are blended again, the others are
+ * copied from the last output. Must be a multiple of 16 rows, the period of
+ * the checker pattern and a multiple of the vertical chroma subsampling. */
+#define STRIPE_HEIGHT 64
+
+/* Outputs blending less than this many pixels in total are not worth the
+ * overhead of waking up other threads */
+#define PARALLEL_BLEND_MIN_PIXELS (1920 * 1080)
+
+typedef struct
+{
+  GstVideoFrame *frame;
+  gint xpos, ypos;
+  gdouble alpha;
+  GstCompositorBlendMode blend_mode;
+
+  /* output area the layer draws to, and the part of it that is surely
+   * covered if the layer hides what is below */
+  GstVideoRectangle rect;
+  gboolean opaque;
+  GstVideoRectangle opaque_rect;
+} CompositorLayer;
+
+typedef struct
+{
+  GstCompositor *comp;
+  BlendFunction composite;
+  GstVideoFrame *outframe;
+  /* the first pad, copied as-is instead of drawing the background */
+  GstVideoFrame *copy_frame;
+  /* the last output, or NULL if everything has to be drawn */
+  GstVideoFrame *last_frame;
+  gboolean draw_background;
+  /* one entry per stripe, TRUE if the stripe has to be drawn */
+  gboolean *dirty;
+} CompositorBlendContext;
+
+typedef struct
+{
+  CompositorBlendContext *ctx;
+  guint first_stripe, last_stripe;
+} CompositorBand;
+
+/* Is the part of @rect within @y_start and @y_end completely hidden by one of
+ * the layers from @first on? */
+static gboolean
+layers_obscure_rows (GArray * layers, guint first, GstVideoRectangle rect,
+    gint y_start, gint y_end)
+{
+  guint i;
+
+  rect.h = MIN (rect.y + rect.h, y_end);
+  rect.y = MAX (rect.y, y_start);
+  rect.h -= rect.y;
+  if (rect.w <= 0 || rect.h <= 0)
+    return TRUE;
+
+  for (i = first; i < layers->len; i++) {
+    CompositorLayer *layer = &g_array_index (layers, CompositorLayer, i);
+
+    if (layer->opaque && is_rectangle_contained (rect, layer->opaque_rect))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* draws the rows @y_start to @y_end of the output */
+static void
+blend_rows (CompositorBlendContext * ctx, gint y_start, gint y_end)
+{
+  GArray *layers = ctx->comp->blend_layers;
+  GstVideoFrame view, src_view;
+  GstVideoRectangle rows;
+  guint i;
+
+  rows.x = 0;
+  rows.y = y_start;
+  rows.w = GST_VIDEO_FRAME_WIDTH (ctx->outframe);
+  rows.h = y_end - y_start;
+
+  frame_rows_view (&view, ctx->outframe, y_start, y_end);
+  if (ctx->copy_frame) {
+    frame_rows_view (&src_view, ctx->copy_frame, y_start, y_end);
+    gst_video_frame_copy (&view, &src_view);
+  } else if (ctx->draw_background
+      && !layers_obscure_rows (layers, 0, rows, y_start, y_end)) {
+    _fill_background (ctx->comp, &view);
+  }
+
+  for (i = 0; i < layers->len; i++) {
+    CompositorLayer *layer = &g_array_index (layers, CompositorLayer, i);
+
+    /* skip the parts of layers that are hidden by opaque layers on top */
+    if (layers_obscure_rows (layers, i + 1, layer->rect, y_start, y_end))
+      continue;
+
+    ctx->composite (layer->frame, layer->xpos, layer->ypos, layer->alpha,
+        ctx->outframe, y_start, y_end, layer->blend_mode);
+  }
+}
+
+static void
+blend_band (CompositorBand * band)
+{
+  CompositorBlendContext *ctx = band->ctx;
+  gint height = GST_VIDEO_FRAME_HEIGHT (ctx->outframe);
+  guint i;
+
+  for (i = band->first_stripe; i < band->last_stripe; i++) {
+    gint y_start = i * STRIPE_HEIGHT;
+    gint y_end = MIN (y_start + STRIPE_HEIGHT, height);
+
+    if (ctx->dirty[i]) {
+      blend_rows (ctx, y_start, y_end);
+    } else {
+      GstVideoFrame view, last_view;
+
+      frame_rows_view (&view, ctx->outframe, y_start, y_end);
+      frame_rows_view (&last_view, ctx->last_frame, y_start, y_end);
+      gst_video_frame_copy (&view, &last_view);
+    }
+  }
+}
+
+static void
+blend_band_func (gpointer data, gpointer user_data)
+{
+  CompositorBand *band = data;
+  GstCompositor *comp = band->ctx->comp;
+
+  blend_band (band);
+
+  g_mutex_lock (&comp->blend_lock);
+  if (--comp->blend_pending == 0)
+    g_cond_signal (&comp->blend_cond);
+  g_mutex_unlock (&comp->blend_lock);
+}
+
+/* decide in how many horizontal bands the output is blended, based on the
+ * number of stripes and the number of pixels that are blended */
+static guint
+get_n_bands (GstCompositor * comp, guint n_stripes)
+{
+  guint64 pixels = 0;
+  guint max_threads, i;
+
+  max_threads = comp->max_threads;
+  if (max_threads == 0)
+    max_threads = g_get_num_processors ();
+  if (max_threads <= 1)
+    return 1;
+
+  for (i = 0; i < comp->blend_layers->len; i++) {
+    CompositorLayer *layer =
+        &g_array_index (comp->blend_layers, CompositorLayer, i);
+
+    pixels += (guint64) layer->rect.w * layer->rect.h;
+  }
+  if (pixels < PARALLEL_BLEND_MIN_PIXELS)
+    return 1;
+
+  return MIN (n_stripes, max_threads);
+}
+
+static void
+blend_layers (CompositorBlendContext * ctx, guint n_stripes)
+{
+  GstCompositor *comp = ctx->comp;
+  CompositorBand *bands;
+  guint n_bands, stripes_per_band, i;
+
+  n_bands = get_n_bands (comp, n_stripes);
+  stripes_per_band = (n_stripes + n_bands - 1) / n_bands;
+
+  bands = g_newa (CompositorBand, n_bands);
+  for (i = 0; i < n_bands; i++) {
+    bands[i].ctx = ctx;
+    bands[i].first_stripe = MIN (i * stripes_per_band, n_stripes);
+    bands[i].last_stripe = MIN ((i + 1) * stripes_per_band, n_stripes);
+  }
+
+  if (n_bands == 1) {
+    blend_band (&bands[0]);
+    return;
+  }
+
+  if (comp->blend_pool == NULL) {
+    comp->blend_pool = g_thread_pool_new (blend_band_func, NULL, -1, FALSE,
+        NULL);
+  }
+
+  comp->blend_pending = n_bands - 1;
+  for (i = 1; i < n_bands; i++)
+    g_thread_pool_push (comp->blend_pool, &bands[i], NULL);
+
+  /* blend the first band ourselves while the others are running */
+  blend_band (&bands[0]);
+
+  g_mutex_lock (&comp->blend_lock);
+  while (comp->blend_pending > 0)
+    g_cond_wait (&comp->blend_cond, &comp->blend_lock);
+  g_mutex_unlock (&comp->blend_lock);
+}
+
+static void
+mark_dirty_rows (CompositorBlendContext * ctx, GstVideoRectangle rect,
+    guint n_stripes)
+{
+  gint i, first, last;
+
+  if (rect.w <= 0 || rect.h <= 0)
+    return;
+
+  first = rect.y / STRIPE_HEIGHT;
+  last = MIN ((rect.y + rect.h - 1) / STRIPE_HEIGHT, n_stripes - 1);
+  for (i = first; i <= last; i++)
+    ctx->dirty[i] = TRUE;
+}
+
+/* Call this with the object lock. Compares the state of @pad with the one it
+ * had when the last output was produced and marks the stripes in which it
+ * changed */
+static void
+update_pad_dirty_rows (CompositorBlendContext * ctx, GstCompositorPad * cpad,
+    GstVideoFrame * prepared_frame, GstVideoRectangle rect, guint n_stripes)
+{
+  GstVideoAggregatorPad *pad = GST_VIDEO_AGGREGATOR_PAD (cpad);
+  GstBuffer *buffer = NULL;
+
+  /* the prepared frame can be a converted copy, the input buffer tells if
+   * the content changed */
+  if (prepared_frame)
+    buffer = gst_video_aggregator_pad_get_current_buffer (pad);
+
+  if (buffer != cpad->last_buffer || cpad->alpha != cpad->last_alpha ||
+      cpad->op != cpad->last_op ||
+      memcmp (&rect, &cpad->last_rect, sizeof (rect)) != 0) {
+    mark_dirty_rows (ctx, cpad->last_rect, n_stripes);
+    mark_dirty_rows (ctx, rect, n_stripes);
+  }
+
+  gst_buffer_replace (&cpad->last_buffer, buffer);
+  cpad->last_rect = rect;
+  cpad->last_alpha = cpad->alpha;
+  cpad->last_op = cpad->op;
+}
+
 static GstFlowReturn
 gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 {
+  GstCompositor *comp = GST_COMPOSITOR (vagg);
   GList *l;
-  BlendFunction composite;
-  GstVideoFrame out_frame, *outframe;
-  gboolean drew_background;
-  guint drawn_pads = 0;
+  GstVideoFrame out_frame, last_frame;
+  CompositorBlendContext ctx = { NULL, };
+  guint n_stripes, drawn_pads = 0, i;
+  gint width, height;
+  gboolean redraw;
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
     GST_WARNING_OBJECT (vagg, "Could not map output buffer");
     return GST_FLOW_ERROR;
   }
 
-  outframe = &out_frame;
-  drew_background = _draw_background (vagg, outframe, &composite);
+  width = GST_VIDEO_FRAME_WIDTH (&out_frame);
+  height = GST_VIDEO_FRAME_HEIGHT (&out_frame);
+  n_stripes = (height + STRIPE_HEIGHT - 1) / STRIPE_HEIGHT;
+
+  ctx.comp = comp;
+  ctx.outframe = &out_frame;
+  ctx.draw_background = _draw_background (vagg, &ctx.composite);
+  ctx.dirty = g_newa (gboolean, n_stripes);
 
   GST_OBJECT_LOCK (vagg);
+  /* Everything is drawn if there is no last output or if something changed
+   * that is not tracked per pad */
+  redraw = comp->last_outbuf == NULL
+      || comp->last_pads_cookie != GST_ELEMENT (vagg)->pads_cookie
+      || comp->last_background != comp->background
+      || comp->last_draw_background != ctx.draw_background;
+  if (!redraw && gst_video_frame_map (&last_frame, &vagg->info,
+          comp->last_outbuf, GST_MAP_READ)) {
+    ctx.last_frame = &last_frame;
+    memset (ctx.dirty, 0, n_stripes * sizeof (gboolean));
+  } else {
+    for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next)
+      gst_buffer_replace (&GST_COMPOSITOR_PAD (l->data)->last_buffer, NULL);
+    for (i = 0; i < n_stripes; i++)
+      ctx.dirty[i] = TRUE;
+  }
+
+  g_array_set_size (comp->blend_layers, 0);
   for (l = GST_ELEMENT (vagg)->sinkpads; l; l = l->next) {
     GstVideoAggregatorPad *pad = l->data;
     GstCompositorPad *compo_pad = GST_COMPOSITOR_PAD (pad);
     GstVideoFrame *prepared_frame =
         gst_video_aggregator_pad_get_prepared_frame (pad);
     GstCompositorBlendMode blend_mode = COMPOSITOR_BLEND_MODE_OVER;
+    GstVideoRectangle rect = { 0, };
 
     switch (compo_pad->op) {
       case COMPOSITOR_OPERATOR_SOURCE:
@@ -977,23 +1310,62 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     }
 
     if (prepared_frame != NULL) {
+      gint frame_width = GST_VIDEO_FRAME_WIDTH (prepared_frame);
+      gint frame_height = GST_VIDEO_FRAME_HEIGHT (prepared_frame);
+
+      /* the blend functions round the position up for subsampled formats,
+       * so the frame can end up one pixel further right or down */
+      rect = clamp_rectangle (compo_pad->xpos, compo_pad->ypos,
+          frame_width + 1, frame_height + 1, width, height);
+
       /* If this is the first pad we're drawing, and we didn't draw the
        * background, and @prepared_frame has the same format, height, and width
        * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
        * will be composited on top of it. */
-      if (drawn_pads == 0 && !drew_background &&
-          frames_can_copy (prepared_frame, outframe))
-        gst_video_frame_copy (outframe, prepared_frame);
-      else
-        composite (prepared_frame,
-            compo_pad->xpos,
-            compo_pad->ypos, compo_pad->alpha, outframe, blend_mode);
+      if (drawn_pads == 0 && !ctx.draw_background &&
+          frames_can_copy (prepared_frame, &out_frame)) {
+        ctx.copy_frame = prepared_frame;
+      } else {
+        CompositorLayer layer;
+
+        layer.frame = prepared_frame;
+        layer.xpos = compo_pad->xpos;
+        layer.ypos = compo_pad->ypos;
+        layer.alpha = compo_pad->alpha;
+        layer.blend_mode = blend_mode;
+        layer.rect = rect;
+        /* same rules as _pad_obscures_rectangle(), only the area that is
+         * covered no matter how the position is rounded counts */
+        layer.opaque = compo_pad->op == COMPOSITOR_OPERATOR_SOURCE ||
+            (compo_pad->alpha == 1.0 && !GST_VIDEO_INFO_HAS_ALPHA (&pad->info));
+        layer.opaque_rect = clamp_rectangle (compo_pad->xpos + 1,
+            compo_pad->ypos + 1, frame_width - 1, frame_height - 1, width,
+            height);
+        g_array_append_val (comp->blend_layers, layer);
+      }
       drawn_pads++;
     }
+
+    update_pad_dirty_rows (&ctx, compo_pad, prepared_frame, rect, n_stripes);
   }
+
+  /* The output is drawn in horizontal bands, each band blends all layers that
+   * overlap it in z-order and the bands can run in parallel as they write to
+   * different rows */
+  blend_layers (&ctx, n_stripes);
+
+  comp->last_pads_cookie = GST_ELEMENT (vagg)->pads_cookie;
+  comp->last_background = comp->background;
+  comp->last_draw_background = ctx.draw_background;
   GST_OBJECT_UNLOCK (vagg);
 
-  gst_video_frame_unmap (outframe);
+  if (ctx.last_frame)
+    gst_video_frame_unmap (ctx.last_frame);
+  gst_video_frame_unmap (&out_frame);
+
+  /* keep the output around to copy the unchanged parts from next time,
+   * downstream has to copy it before writing to it as long as we hold it */
+  gst_buffer_replace (&comp->last_outbuf, outbuf);
 
   return GST_FLOW_OK;
 }
@@ -1092,6 +1464,7 @@ gst_compositor_class_init (GstCompositorClass * klass)
 
   gobject_class->get_property = gst_compositor_get_property;
   gobject_class->set_property = gst_compositor_set_property;
+  gobject_class->finalize = gst_compositor_finalize;
 
   gstelement_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_compositor_request_new_pad);
@@ -1107,6 +1480,24 @@ gst_compositor_class_init (GstCompositorClass * klass)
           GST_TYPE_COMPOSITOR_BACKGROUND,
           DEFAULT_BACKGROUND, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstCompositor:max-threads:
+   *
+   * Maximum number of threads used for blending. The output frame is split
+   * into horizontal bands that are blended in parallel. Small outputs and
+   * outputs with few pixels to blend are always blended from a single
+   * thread.
+   *
+   * 0 uses as many threads as there are processors.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of blending threads (0 = number of processors)",
+          0, G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &src_factory, GST_TYPE_AGGREGATOR_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
@@ -1123,6 +1514,25 @@ gst_compositor_init (GstCompositor * self)
 {
   /* initialize variables */
   self->background = DEFAULT_BACKGROUND;
+  self->max_threads = DEFAULT_MAX_THREADS;
+  self->blend_layers = g_array_new (FALSE, FALSE, sizeof (CompositorLayer));
+  g_mutex_init (&self->blend_lock);
+  g_cond_init (&self->blend_cond);
+}
+
+static void
+gst_compositor_finalize (GObject * object)
+{
+  GstCompositor *self = GST_COMPOSITOR (object);
+
+  if (self->blend_pool)
+    g_thread_pool_free (self->blend_pool, FALSE, TRUE);
+  gst_buffer_replace (&self->last_outbuf, NULL);
+  g_array_free (self->blend_layers, TRUE);
+  g_mutex_clear (&self->blend_lock);
+  g_cond_clear (&self->blend_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 /* GstChildProxy implementation */
@@ -110,6 +110,21 @@ struct _GstCompositor
   BlendFunction blend, overlay;
   FillCheckerFunction fill_checker;
   FillColorFunction fill_color;
+
+  /* parallel blending of horizontal bands of the output */
+  guint max_threads;
+  GThreadPool *blend_pool;
+  GArray *blend_layers;
+  GMutex blend_lock;
+  GCond blend_cond;
+  guint blend_pending;
+
+  /* the last output and what it depended on besides the pads, the parts
+   * where no pad changed are copied from it */
+  GstBuffer *last_outbuf;
+  guint32 last_pads_cookie;
+  GstCompositorBackground last_background;
+  gboolean last_draw_background;
 };
 
 struct _GstCompositorClass
@@ -132,6 +147,12 @@ struct _GstCompositorPad
   gdouble alpha;
 
   GstCompositorOperator op;
+
+  /* state when the last output was produced */
+  GstBuffer *last_buffer;
+  GstVideoRectangle last_rect;
+  gdouble last_alpha;
+  GstCompositorOperator last_op;
 };
 
 struct _GstCompositorPadClass
@@ -157,12 +157,6 @@ struct _GstEncodeBin
   /* TRUE if in PAUSED/PLAYING */
   gboolean active;
 
-  /* available muxers, encoders and parsers */
-  GList *muxers;
-  GList *formatters;
-  GList *encoders;
-  GList *parsers;
-
   /* Increasing counter for unique pad name */
   guint last_pad_id;
 
@@ -177,6 +171,7 @@ struct _GstEncodeBin
 
   guint64 tolerance;
   gboolean avoid_reencoding;
+  guint64 audio_encoder_queue_time;
 
   GstEncodeBinFlags flags;
 };
@@ -222,6 +217,7 @@ struct _StreamGroup
 #define DEFAULT_QUEUE_TIME_MAX     GST_SECOND
 #define DEFAULT_AUDIO_JITTER_TOLERANCE 20 * GST_MSECOND
 #define DEFAULT_AVOID_REENCODING   FALSE
+#define DEFAULT_AUDIO_ENCODER_QUEUE_TIME 0
 #define DEFAULT_FLAGS              0
 
 #define DEFAULT_RAW_CAPS			\
@@ -241,7 +237,8 @@ enum
   PROP_QUEUE_TIME_MAX,
   PROP_AUDIO_JITTER_TOLERANCE,
   PROP_AVOID_REENCODING,
-  PROP_FLAGS
+  PROP_FLAGS,
+  PROP_AUDIO_ENCODER_QUEUE_TIME
 };
 
 /* Signals */
@@ -384,6 +381,26 @@ gst_encode_bin_class_init (GstEncodeBinClass * klass)
           GST_TYPE_ENCODEBIN_FLAGS, DEFAULT_FLAGS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstEncodeBin:audio-encoder-queue-time:
+   *
+   * If not 0, audio encoders push their output from a separate thread,
+   * queueing up to this amount of encoded data, so that encoding the next
+   * frames overlaps with pushing the previous ones. This sets
+   * #GstAudioEncoder:output-queue-max-time on the audio encoders created
+   * afterwards.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_klass,
+      PROP_AUDIO_ENCODER_QUEUE_TIME,
+      g_param_spec_uint64 ("audio-encoder-queue-time",
+          "Audio encoder queue time",
+          "Amount of encoded audio to queue for pushing from a separate "
+          "thread (in ns, 0=disable)", 0, G_MAXUINT64,
+          DEFAULT_AUDIO_ENCODER_QUEUE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* Signals */
   /**
    * GstEncodeBin::request-pad
@@ -452,22 +469,6 @@ gst_encode_bin_dispose (GObject * object)
 {
   GstEncodeBin *ebin = (GstEncodeBin *) object;
 
-  if (ebin->muxers)
-    gst_plugin_feature_list_free (ebin->muxers);
-  ebin->muxers = NULL;
-
-  if (ebin->formatters)
-    gst_plugin_feature_list_free (ebin->formatters);
-  ebin->formatters = NULL;
-
-  if (ebin->encoders)
-    gst_plugin_feature_list_free (ebin->encoders);
-  ebin->encoders = NULL;
-
-  if (ebin->parsers)
-    gst_plugin_feature_list_free (ebin->parsers);
-  ebin->parsers = NULL;
-
   gst_encode_bin_tear_down_profile (ebin);
 
   if (ebin->raw_video_caps)
@@ -487,22 +488,6 @@ gst_encode_bin_init (GstEncodeBin * encode_bin)
 {
   GstPadTemplate *tmpl;
 
-  encode_bin->muxers =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_MUXER,
-      GST_RANK_MARGINAL);
-
-  encode_bin->formatters =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_FORMATTER,
-      GST_RANK_SECONDARY);
-
-  encode_bin->encoders =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_ENCODER,
-      GST_RANK_MARGINAL);
-
-  encode_bin->parsers =
-      gst_element_factory_list_get_elements (GST_ELEMENT_FACTORY_TYPE_PARSER,
-      GST_RANK_MARGINAL);
-
   encode_bin->raw_video_caps = gst_caps_from_string ("video/x-raw");
   encode_bin->raw_audio_caps = gst_caps_from_string ("audio/x-raw");
   /* encode_bin->raw_text_caps = */
@@ -513,6 +498,7 @@ gst_encode_bin_init (GstEncodeBin * encode_bin)
   encode_bin->queue_time_max = DEFAULT_QUEUE_TIME_MAX;
   encode_bin->tolerance = DEFAULT_AUDIO_JITTER_TOLERANCE;
   encode_bin->avoid_reencoding = DEFAULT_AVOID_REENCODING;
+  encode_bin->audio_encoder_queue_time = DEFAULT_AUDIO_ENCODER_QUEUE_TIME;
   encode_bin->flags = DEFAULT_FLAGS;
 
   tmpl = gst_static_pad_template_get (&muxer_src_template);
@@ -551,6 +537,9 @@ gst_encode_bin_set_property (GObject * object, guint prop_id,
     case PROP_FLAGS:
       ebin->flags = g_value_get_flags (value);
       break;
+    case PROP_AUDIO_ENCODER_QUEUE_TIME:
+      ebin->audio_encoder_queue_time = g_value_get_uint64 (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -585,6 +574,9 @@ gst_encode_bin_get_property (GObject * object, guint prop_id,
     case PROP_FLAGS:
       g_value_set_flags (value, ebin->flags);
       break;
+    case PROP_AUDIO_ENCODER_QUEUE_TIME:
+      g_value_set_uint64 (value, ebin->audio_encoder_queue_time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -864,11 +856,111 @@ no_stream_group:
   }
 }
 
+/* Factory lists and their caps filter results, shared by all encodebin
+ * instances. Everything is dropped when the registry feature list cookie
+ * changes, i.e. when features were added or removed */
+typedef enum
+{
+  FACTORY_LIST_MUXERS,
+  FACTORY_LIST_FORMATTERS,
+  FACTORY_LIST_ENCODERS,
+  FACTORY_LIST_PARSERS,
+  N_FACTORY_LISTS
+} FactoryListType;
+
+static const struct
+{
+  GstElementFactoryListType type;
+  GstRank minrank;
+} factory_list_desc[N_FACTORY_LISTS] = {
+  {GST_ELEMENT_FACTORY_TYPE_MUXER, GST_RANK_MARGINAL},
+  {GST_ELEMENT_FACTORY_TYPE_FORMATTER, GST_RANK_SECONDARY},
+  {GST_ELEMENT_FACTORY_TYPE_ENCODER, GST_RANK_MARGINAL},
+  {GST_ELEMENT_FACTORY_TYPE_PARSER, GST_RANK_MARGINAL},
+};
+
+static GMutex factory_cache_lock;
+static guint32 factory_cache_cookie;
+static GList *factory_cache_lists[N_FACTORY_LISTS];
+/* "type:direction:subsetonly:caps" -> GList of GstElementFactory */
+static GHashTable *factory_cache_filtered = NULL;
+
+static void
+factory_cache_flush_unlocked (void)
+{
+  guint i;
+
+  for (i = 0; i < N_FACTORY_LISTS; i++) {
+    if (factory_cache_lists[i])
+      gst_plugin_feature_list_free (factory_cache_lists[i]);
+    factory_cache_lists[i] = NULL;
+  }
+  if (factory_cache_filtered)
+    g_hash_table_remove_all (factory_cache_filtered);
+}
+
+/* Returns the factories of @type that can handle @caps on their pads of
+ * @direction, or on both their source and sink pads if @direction is
+ * GST_PAD_UNKNOWN. Free the result with gst_plugin_feature_list_free() */
+static GList *
+gst_encode_bin_filter_factories (FactoryListType type, const GstCaps * caps,
+    GstPadDirection direction, gboolean subsetonly)
+{
+  guint32 cookie;
+  gchar *caps_str, *key;
+  GList *res;
+
+  caps_str = gst_caps_to_string (caps);
+  key = g_strdup_printf ("%d:%d:%d:%s", type, direction, subsetonly, caps_str);
+  g_free (caps_str);
+
+  g_mutex_lock (&factory_cache_lock);
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+  if (factory_cache_cookie != cookie) {
+    GST_DEBUG ("Registry changed, flushing factory cache");
+    factory_cache_flush_unlocked ();
+    factory_cache_cookie = cookie;
+  }
+
+  if (!factory_cache_filtered)
+    factory_cache_filtered = g_hash_table_new_full (g_str_hash, g_str_equal,
+        g_free, (GDestroyNotify) gst_plugin_feature_list_free);
+
+  if (g_hash_table_lookup_extended (factory_cache_filtered, key, NULL,
+          (gpointer *) & res)) {
+    GST_LOG ("Using cached factories for %s", key);
+    g_free (key);
+  } else {
+    if (!factory_cache_lists[type])
+      factory_cache_lists[type] =
+          gst_element_factory_list_get_elements (factory_list_desc[type].type,
+          factory_list_desc[type].minrank);
+
+    if (direction == GST_PAD_UNKNOWN) {
+      GList *tmp;
+
+      tmp = gst_element_factory_list_filter (factory_cache_lists[type], caps,
+          GST_PAD_SRC, subsetonly);
+      res = gst_element_factory_list_filter (tmp, caps, GST_PAD_SINK,
+          subsetonly);
+      gst_plugin_feature_list_free (tmp);
+    } else {
+      res = gst_element_factory_list_filter (factory_cache_lists[type], caps,
+          direction, subsetonly);
+    }
+    g_hash_table_insert (factory_cache_filtered, key, res);
+  }
+  res = gst_plugin_feature_list_copy (res);
+  g_mutex_unlock (&factory_cache_lock);
+
+  return res;
+}
+
 /* Create a parser for the given stream profile */
 static inline GstElement *
 _get_parser (GstEncodeBin * ebin, GstEncodingProfile * sprof)
 {
-  GList *parsers1, *parsers, *tmp;
+  GList *parsers, *tmp;
   GstElement *parser = NULL;
   GstElementFactory *parserfact = NULL;
   GstCaps *format;
@@ -877,14 +969,9 @@ _get_parser (GstEncodeBin * ebin, GstEncodingProfile * sprof)
 
   GST_DEBUG ("Getting list of parsers for format %" GST_PTR_FORMAT, format);
 
-  /* FIXME : requesting twice the parsers twice is a bit ugly, we should
-   * have a method to request on more than one condition */
-  parsers1 =
-      gst_element_factory_list_filter (ebin->parsers, format,
-      GST_PAD_SRC, FALSE);
   parsers =
-      gst_element_factory_list_filter (parsers1, format, GST_PAD_SINK, FALSE);
-  gst_plugin_feature_list_free (parsers1);
+      gst_encode_bin_filter_factories (FACTORY_LIST_PARSERS, format,
+      GST_PAD_UNKNOWN, FALSE);
 
   if (G_UNLIKELY (parsers == NULL)) {
     GST_DEBUG ("Couldn't find any compatible parsers");
@@ -970,14 +1057,14 @@ _get_encoder (GstEncodeBin * ebin, GstEncodingProfile * sprof)
   }
 
   encoders =
-      gst_element_factory_list_filter (ebin->encoders, format,
+      gst_encode_bin_filter_factories (FACTORY_LIST_ENCODERS, format,
       GST_PAD_SRC, FALSE);
 
   if (G_UNLIKELY (encoders == NULL) && sprof == ebin->profile) {
     /* Special case: if the top-level profile is an encoder,
      * it could be listed in our muxers (for example wavenc)
      */
-    encoders = gst_element_factory_list_filter (ebin->muxers, format,
+    encoders = gst_encode_bin_filter_factories (FACTORY_LIST_MUXERS, format,
         GST_PAD_SRC, FALSE);
   }
 
@@ -1419,6 +1506,13 @@ _create_stream_group (GstEncodeBin * ebin, GstEncodingProfile * sprof,
   GST_LOG ("Adding encoder");
   sgroup->encoder = _get_encoder (ebin, sprof);
   if (sgroup->encoder != NULL) {
+    /* only GstAudioEncoder subclasses have this property */
+    if (ebin->audio_encoder_queue_time
+        && g_object_class_find_property (G_OBJECT_GET_CLASS (sgroup->encoder),
+            "output-queue-max-time"))
+      g_object_set (sgroup->encoder, "output-queue-max-time",
+          ebin->audio_encoder_queue_time, NULL);
+
     gst_bin_add ((GstBin *) ebin, sgroup->encoder);
     tosync = g_list_append (tosync, sgroup->encoder);
 
@@ -1795,8 +1889,8 @@ _get_formatter (GstEncodeBin * ebin, GstEncodingProfile * sprof)
   GST_DEBUG ("Getting list of formatters for format %" GST_PTR_FORMAT, format);
 
   formatters =
-      gst_element_factory_list_filter (ebin->formatters, format, GST_PAD_SRC,
-      FALSE);
+      gst_encode_bin_filter_factories (FACTORY_LIST_FORMATTERS, format,
+      GST_PAD_SRC, FALSE);
 
   if (formatters == NULL)
     goto beach;
@@ -1864,11 +1958,12 @@ _get_muxer (GstEncodeBin * ebin)
   GST_DEBUG ("Getting list of muxers for format %" GST_PTR_FORMAT, format);
 
   muxers =
-      gst_element_factory_list_filter (ebin->muxers, format, GST_PAD_SRC, TRUE);
+      gst_encode_bin_filter_factories (FACTORY_LIST_MUXERS, format,
+      GST_PAD_SRC, TRUE);
 
   formatters =
-      gst_element_factory_list_filter (ebin->formatters, format, GST_PAD_SRC,
-      TRUE);
+      gst_encode_bin_filter_factories (FACTORY_LIST_FORMATTERS, format,
+      GST_PAD_SRC, TRUE);
 
   muxers = g_list_sort_with_data (muxers, compare_elements, (gpointer) format);
   formatters =
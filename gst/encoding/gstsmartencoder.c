@@ -59,12 +59,34 @@ enum
   LAST_SIGNAL
 };
 
+#define DEFAULT_PARALLEL_REENCODES 1
+
 enum
 {
-  PROP_0
-      /* FILL ME */
+  PROP_0,
+  PROP_PARALLEL_REENCODES
 };
 
+/* A GOP waiting to be output. GOPs that need re-encoding are handed to the
+ * reencode_pool, and replaced by their re-encoded version once done. */
+typedef struct
+{
+  GList *buffers;
+  GstEvent *segment;
+  gboolean done;
+} SmartEncoderGop;
+
+/* A decoder/encoder pair used by one reencode_pool thread at a time */
+typedef struct
+{
+  GstElement *decoder;
+  GstElement *encoder;
+  GstPad *internal_srcpad;
+  GstPad *internal_sinkpad;
+  /* re-encoded buffers, in reverse order */
+  GList *output;
+} SmartEncoderRecoder;
+
 static void
 _do_init (void)
 {
@@ -75,8 +97,18 @@ G_DEFINE_TYPE_EXTENDED (GstSmartEncoder, gst_smart_encoder, GST_TYPE_ELEMENT, 0,
     _do_init ());
 
 static void gst_smart_encoder_dispose (GObject * object);
+static void gst_smart_encoder_finalize (GObject * object);
+static void gst_smart_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_smart_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 
 static gboolean setup_recoder_pipeline (GstSmartEncoder * smart_encoder);
+static gboolean create_recoder (GstSmartEncoder * smart_encoder,
+    GstElement ** decoder, GstElement ** encoder, GstPad ** internal_srcpad,
+    GstPad ** internal_sinkpad, GstPadChainFunction chain, gpointer data);
+static void smart_encoder_recoder_free (SmartEncoderRecoder * recoder);
+static void smart_encoder_reencode_func (gpointer data, gpointer user_data);
 
 static GstFlowReturn gst_smart_encoder_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buf);
@@ -109,17 +141,62 @@ gst_smart_encoder_class_init (GstSmartEncoderClass * klass)
       "Edward Hervey <bilboed@gmail.com>");
 
   gobject_class->dispose = (GObjectFinalizeFunc) (gst_smart_encoder_dispose);
+  gobject_class->finalize = gst_smart_encoder_finalize;
+  gobject_class->set_property = gst_smart_encoder_set_property;
+  gobject_class->get_property = gst_smart_encoder_get_property;
   element_class->change_state = gst_smart_encoder_change_state;
 
+  /**
+   * GstSmartEncoder:parallel-reencodes:
+   *
+   * Number of GOPs that can be re-encoded at the same time, each with its
+   * own decoder and encoder. GOPs are still output in stream order, the
+   * ones following a GOP being re-encoded are held back until it is done.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL_REENCODES,
+      g_param_spec_uint ("parallel-reencodes", "Parallel re-encodes",
+          "Number of GOPs that can be re-encoded at the same time",
+          1, G_MAXUINT, DEFAULT_PARALLEL_REENCODES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   GST_DEBUG_CATEGORY_INIT (smart_encoder_debug, "smartencoder", 0,
       "Smart Encoder");
 }
 
+static void
+smart_encoder_gop_free (SmartEncoderGop * gop)
+{
+  g_list_free_full (gop->buffers, (GDestroyNotify) gst_buffer_unref);
+  if (gop->segment)
+    gst_event_unref (gop->segment);
+  g_slice_free (SmartEncoderGop, gop);
+}
+
+/* Wait until all queued GOPs are re-encoded and pushed */
+static void
+smart_encoder_wait_gops (GstSmartEncoder * smart_encoder)
+{
+  g_mutex_lock (&smart_encoder->output_lock);
+  while (smart_encoder->gops.length > 0 || smart_encoder->outputting)
+    g_cond_wait (&smart_encoder->output_cond, &smart_encoder->output_lock);
+  g_mutex_unlock (&smart_encoder->output_lock);
+}
+
 static void
 smart_encoder_reset (GstSmartEncoder * smart_encoder)
 {
+  SmartEncoderRecoder *recoder;
+
   gst_segment_init (smart_encoder->segment, GST_FORMAT_UNDEFINED);
 
+  smart_encoder_wait_gops (smart_encoder);
+  while ((recoder = g_queue_pop_head (&smart_encoder->idle_recoders)))
+    smart_encoder_recoder_free (recoder);
+  smart_encoder->output_ret = GST_FLOW_OK;
+
   if (smart_encoder->encoder) {
     /* Clean up/remove elements */
     gst_element_set_state (smart_encoder->encoder, GST_STATE_NULL);
@@ -163,6 +240,12 @@ gst_smart_encoder_init (GstSmartEncoder * smart_encoder)
 
   smart_encoder->segment = gst_segment_new ();
 
+  smart_encoder->parallel_reencodes = DEFAULT_PARALLEL_REENCODES;
+  g_mutex_init (&smart_encoder->output_lock);
+  g_cond_init (&smart_encoder->output_cond);
+  g_queue_init (&smart_encoder->gops);
+  g_queue_init (&smart_encoder->idle_recoders);
+
   smart_encoder_reset (smart_encoder);
 }
 
@@ -180,66 +263,282 @@ gst_smart_encoder_dispose (GObject * object)
   G_OBJECT_CLASS (gst_smart_encoder_parent_class)->dispose (object);
 }
 
+static void
+gst_smart_encoder_finalize (GObject * object)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  g_mutex_clear (&smart_encoder->output_lock);
+  g_cond_clear (&smart_encoder->output_cond);
+
+  G_OBJECT_CLASS (gst_smart_encoder_parent_class)->finalize (object);
+}
+
+static void
+gst_smart_encoder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  switch (prop_id) {
+    case PROP_PARALLEL_REENCODES:
+      smart_encoder->parallel_reencodes = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_smart_encoder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstSmartEncoder *smart_encoder = (GstSmartEncoder *) object;
+
+  switch (prop_id) {
+    case PROP_PARALLEL_REENCODES:
+      g_value_set_uint (value, smart_encoder->parallel_reencodes);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+/* Runs @buffers through @decoder and @encoder, consuming them */
 static GstFlowReturn
-gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
+smart_encoder_recode (GstSmartEncoder * smart_encoder, GstElement * decoder,
+    GstElement * encoder, GstPad * internal_srcpad, GstEvent * segment,
+    GList * buffers)
 {
   GstFlowReturn res = GST_FLOW_OK;
   GList *tmp;
 
-  if (smart_encoder->encoder == NULL) {
-    if (!setup_recoder_pipeline (smart_encoder))
-      return GST_FLOW_ERROR;
-  }
-
   /* Activate elements */
   /* Set elements to PAUSED */
-  gst_element_set_state (smart_encoder->encoder, GST_STATE_PAUSED);
-  gst_element_set_state (smart_encoder->decoder, GST_STATE_PAUSED);
+  gst_element_set_state (encoder, GST_STATE_PAUSED);
+  gst_element_set_state (decoder, GST_STATE_PAUSED);
 
   GST_INFO ("Pushing Flush start/stop to clean decoder/encoder");
-  gst_pad_push_event (smart_encoder->internal_srcpad,
-      gst_event_new_flush_start ());
-  gst_pad_push_event (smart_encoder->internal_srcpad,
-      gst_event_new_flush_stop (TRUE));
+  gst_pad_push_event (internal_srcpad, gst_event_new_flush_start ());
+  gst_pad_push_event (internal_srcpad, gst_event_new_flush_stop (TRUE));
 
   /* push newsegment */
-  GST_INFO ("Pushing newsegment %" GST_PTR_FORMAT, smart_encoder->newsegment);
-  gst_pad_push_event (smart_encoder->internal_srcpad,
-      gst_event_ref (smart_encoder->newsegment));
+  GST_INFO ("Pushing newsegment %" GST_PTR_FORMAT, segment);
+  gst_pad_push_event (internal_srcpad, gst_event_ref (segment));
 
   /* Push buffers through our pads */
   GST_DEBUG ("Pushing pending buffers");
 
-  for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
+  for (tmp = buffers; tmp; tmp = tmp->next) {
     GstBuffer *buf = (GstBuffer *) tmp->data;
 
-    res = gst_pad_push (smart_encoder->internal_srcpad, buf);
+    res = gst_pad_push (internal_srcpad, buf);
     if (G_UNLIKELY (res != GST_FLOW_OK))
       break;
   }
 
   if (G_UNLIKELY (res != GST_FLOW_OK)) {
     GST_WARNING ("Error pushing pending buffers : %s", gst_flow_get_name (res));
-    /* Remove pending bfufers */
-    for (tmp = smart_encoder->pending_gop; tmp; tmp = tmp->next) {
+    /* Remove pending buffers */
+    for (tmp = tmp->next; tmp; tmp = tmp->next) {
       gst_buffer_unref ((GstBuffer *) tmp->data);
     }
   } else {
     GST_INFO ("Pushing out EOS to flush out decoder/encoder");
-    gst_pad_push_event (smart_encoder->internal_srcpad, gst_event_new_eos ());
+    gst_pad_push_event (internal_srcpad, gst_event_new_eos ());
   }
 
   /* Activate elements */
   /* Set elements to PAUSED */
-  gst_element_set_state (smart_encoder->encoder, GST_STATE_NULL);
-  gst_element_set_state (smart_encoder->decoder, GST_STATE_NULL);
+  gst_element_set_state (encoder, GST_STATE_NULL);
+  gst_element_set_state (decoder, GST_STATE_NULL);
 
-  g_list_free (smart_encoder->pending_gop);
+  g_list_free (buffers);
+
+  return res;
+}
+
+static GstFlowReturn
+gst_smart_encoder_reencode_gop (GstSmartEncoder * smart_encoder)
+{
+  GstFlowReturn res;
+
+  if (smart_encoder->encoder == NULL) {
+    if (!setup_recoder_pipeline (smart_encoder))
+      return GST_FLOW_ERROR;
+  }
+
+  res = smart_encoder_recode (smart_encoder, smart_encoder->decoder,
+      smart_encoder->encoder, smart_encoder->internal_srcpad,
+      smart_encoder->newsegment, smart_encoder->pending_gop);
   smart_encoder->pending_gop = NULL;
 
   return res;
 }
 
+/* Push the GOPs at the head of the queue that are ready, in order. Only one
+ * thread outputs at a time, the others leave their GOPs to it. */
+static void
+smart_encoder_output_gops (GstSmartEncoder * smart_encoder)
+{
+  SmartEncoderGop *gop;
+
+  g_mutex_lock (&smart_encoder->output_lock);
+  if (smart_encoder->outputting) {
+    g_mutex_unlock (&smart_encoder->output_lock);
+    return;
+  }
+  smart_encoder->outputting = TRUE;
+
+  while ((gop = g_queue_peek_head (&smart_encoder->gops)) && gop->done) {
+    GstFlowReturn res = GST_FLOW_OK;
+    GList *tmp;
+
+    g_queue_pop_head (&smart_encoder->gops);
+    g_mutex_unlock (&smart_encoder->output_lock);
+
+    for (tmp = gop->buffers; tmp; tmp = tmp->next) {
+      GstBuffer *buf = (GstBuffer *) tmp->data;
+
+      tmp->data = NULL;
+      if (res == GST_FLOW_OK)
+        res = gst_pad_push (smart_encoder->srcpad, buf);
+      else
+        gst_buffer_unref (buf);
+    }
+    g_list_free (gop->buffers);
+    gop->buffers = NULL;
+    smart_encoder_gop_free (gop);
+
+    g_mutex_lock (&smart_encoder->output_lock);
+    if (res != GST_FLOW_OK && smart_encoder->output_ret == GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (smart_encoder, "flow %s", gst_flow_get_name (res));
+      smart_encoder->output_ret = res;
+    }
+  }
+
+  smart_encoder->outputting = FALSE;
+  g_cond_broadcast (&smart_encoder->output_cond);
+  g_mutex_unlock (&smart_encoder->output_lock);
+}
+
+static GstFlowReturn
+recoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
+{
+  SmartEncoderRecoder *recoder =
+      g_object_get_qdata ((GObject *) pad, INTERNAL_ELEMENT);
+
+  recoder->output = g_list_prepend (recoder->output, buf);
+
+  return GST_FLOW_OK;
+}
+
+static void
+smart_encoder_recoder_free (SmartEncoderRecoder * recoder)
+{
+  if (recoder->encoder) {
+    gst_element_set_state (recoder->encoder, GST_STATE_NULL);
+    gst_element_set_bus (recoder->encoder, NULL);
+    gst_object_unref (recoder->encoder);
+  }
+  if (recoder->decoder) {
+    gst_element_set_state (recoder->decoder, GST_STATE_NULL);
+    gst_element_set_bus (recoder->decoder, NULL);
+    gst_object_unref (recoder->decoder);
+  }
+  if (recoder->internal_srcpad) {
+    gst_pad_set_active (recoder->internal_srcpad, FALSE);
+    gst_object_unref (recoder->internal_srcpad);
+  }
+  if (recoder->internal_sinkpad) {
+    gst_pad_set_active (recoder->internal_sinkpad, FALSE);
+    gst_object_unref (recoder->internal_sinkpad);
+  }
+  g_slice_free (SmartEncoderRecoder, recoder);
+}
+
+static void
+smart_encoder_reencode_func (gpointer data, gpointer user_data)
+{
+  SmartEncoderGop *gop = data;
+  GstSmartEncoder *smart_encoder = user_data;
+  SmartEncoderRecoder *recoder;
+  GstFlowReturn res = GST_FLOW_ERROR;
+
+  g_mutex_lock (&smart_encoder->output_lock);
+  recoder = g_queue_pop_head (&smart_encoder->idle_recoders);
+  g_mutex_unlock (&smart_encoder->output_lock);
+
+  if (recoder == NULL) {
+    recoder = g_slice_new0 (SmartEncoderRecoder);
+    if (!create_recoder (smart_encoder, &recoder->decoder, &recoder->encoder,
+            &recoder->internal_srcpad, &recoder->internal_sinkpad,
+            recoder_chain, recoder)) {
+      smart_encoder_recoder_free (recoder);
+      recoder = NULL;
+    }
+  }
+
+  if (recoder) {
+    res = smart_encoder_recode (smart_encoder, recoder->decoder,
+        recoder->encoder, recoder->internal_srcpad, gop->segment,
+        gop->buffers);
+    gop->buffers = g_list_reverse (recoder->output);
+    recoder->output = NULL;
+  } else {
+    GST_ELEMENT_ERROR (smart_encoder, CORE, MISSING_PLUGIN, (NULL),
+        ("Couldn't create decoder and encoder to re-encode GOP"));
+  }
+
+  g_mutex_lock (&smart_encoder->output_lock);
+  if (recoder)
+    g_queue_push_tail (&smart_encoder->idle_recoders, recoder);
+  if (res != GST_FLOW_OK && smart_encoder->output_ret == GST_FLOW_OK)
+    smart_encoder->output_ret = res;
+  gop->done = TRUE;
+  smart_encoder->reencoding--;
+  g_cond_broadcast (&smart_encoder->output_cond);
+  g_mutex_unlock (&smart_encoder->output_lock);
+
+  smart_encoder_output_gops (smart_encoder);
+}
+
+/* Queue the pending GOP for output, handing it to the reencode_pool first
+ * if it needs re-encoding */
+static GstFlowReturn
+smart_encoder_queue_pending_gop (GstSmartEncoder * smart_encoder,
+    gboolean reencode)
+{
+  SmartEncoderGop *gop;
+  GstFlowReturn res;
+
+  gop = g_slice_new0 (SmartEncoderGop);
+  gop->buffers = smart_encoder->pending_gop;
+  smart_encoder->pending_gop = NULL;
+
+  g_mutex_lock (&smart_encoder->output_lock);
+  if (reencode) {
+    while (smart_encoder->reencoding >= smart_encoder->parallel_reencodes)
+      g_cond_wait (&smart_encoder->output_cond, &smart_encoder->output_lock);
+    smart_encoder->reencoding++;
+    gop->segment = gst_event_ref (smart_encoder->newsegment);
+  } else {
+    gop->done = TRUE;
+  }
+  g_queue_push_tail (&smart_encoder->gops, gop);
+  res = smart_encoder->output_ret;
+  g_mutex_unlock (&smart_encoder->output_lock);
+
+  if (reencode)
+    g_thread_pool_push (smart_encoder->reencode_pool, gop, NULL);
+  else
+    smart_encoder_output_gops (smart_encoder);
+
+  return res;
+}
+
 static GstFlowReturn
 gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
 {
@@ -258,7 +557,13 @@ gst_smart_encoder_push_pending_gop (GstSmartEncoder * smart_encoder)
         || (cstop != smart_encoder->gop_stop)) {
       GST_DEBUG ("GOP needs to be re-encoded from %" GST_TIME_FORMAT " to %"
           GST_TIME_FORMAT, GST_TIME_ARGS (cstart), GST_TIME_ARGS (cstop));
-      res = gst_smart_encoder_reencode_gop (smart_encoder);
+      if (smart_encoder->reencode_pool)
+        res = smart_encoder_queue_pending_gop (smart_encoder, TRUE);
+      else
+        res = gst_smart_encoder_reencode_gop (smart_encoder);
+    } else if (smart_encoder->reencode_pool) {
+      /* keep it behind the GOPs being re-encoded */
+      res = smart_encoder_queue_pending_gop (smart_encoder, FALSE);
     } else {
       /* The whole GOP is within the segment, push all pending buffers downstream */
       GST_DEBUG ("GOP doesn't need to be modified, pushing downstream");
@@ -378,6 +683,10 @@ smart_encoder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
       break;
   }
 
+  /* don't let serialized events overtake GOPs being re-encoded */
+  if (smart_encoder->reencode_pool && GST_EVENT_IS_SERIALIZED (event))
+    smart_encoder_wait_gops (smart_encoder);
+
   res = gst_pad_push_event (smart_encoder->srcpad, event);
 
   return res;
@@ -520,67 +829,64 @@ internal_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return gst_pad_push (smart_encoder->srcpad, buf);
 }
 
+/* Create a decoder and an encoder for the current caps, fed from
+ * @internal_srcpad and outputting to @internal_sinkpad, whose chain function
+ * is @chain. @data is set as INTERNAL_ELEMENT qdata on both pads. */
 static gboolean
-setup_recoder_pipeline (GstSmartEncoder * smart_encoder)
+create_recoder (GstSmartEncoder * smart_encoder, GstElement ** decoder,
+    GstElement ** encoder, GstPad ** internal_srcpad,
+    GstPad ** internal_sinkpad, GstPadChainFunction chain, gpointer data)
 {
   GstPad *tmppad;
   GstCaps *caps;
 
-  /* Fast path */
-  if (G_UNLIKELY (smart_encoder->encoder))
-    return TRUE;
-
   GST_DEBUG ("Creating internal decoder and encoder");
 
   /* Create decoder/encoder */
   caps = gst_pad_get_current_caps (smart_encoder->sinkpad);
-  smart_encoder->decoder = get_decoder (caps);
-  if (G_UNLIKELY (smart_encoder->decoder == NULL))
+  *decoder = get_decoder (caps);
+  if (G_UNLIKELY (*decoder == NULL))
     goto no_decoder;
   gst_caps_unref (caps);
-  gst_element_set_bus (smart_encoder->decoder, GST_ELEMENT_BUS (smart_encoder));
+  gst_element_set_bus (*decoder, GST_ELEMENT_BUS (smart_encoder));
 
   caps = gst_pad_get_current_caps (smart_encoder->sinkpad);
-  smart_encoder->encoder = get_encoder (caps);
-  if (G_UNLIKELY (smart_encoder->encoder == NULL))
+  *encoder = get_encoder (caps);
+  if (G_UNLIKELY (*encoder == NULL))
     goto no_encoder;
   gst_caps_unref (caps);
-  gst_element_set_bus (smart_encoder->encoder, GST_ELEMENT_BUS (smart_encoder));
+  gst_element_set_bus (*encoder, GST_ELEMENT_BUS (smart_encoder));
 
   GST_DEBUG ("Creating internal pads");
 
   /* Create internal pads */
 
   /* Source pad which we'll use to feed data to decoders */
-  smart_encoder->internal_srcpad = gst_pad_new ("internal_src", GST_PAD_SRC);
-  g_object_set_qdata ((GObject *) smart_encoder->internal_srcpad,
-      INTERNAL_ELEMENT, smart_encoder);
-  gst_pad_set_active (smart_encoder->internal_srcpad, TRUE);
+  *internal_srcpad = gst_pad_new ("internal_src", GST_PAD_SRC);
+  g_object_set_qdata ((GObject *) * internal_srcpad, INTERNAL_ELEMENT, data);
+  gst_pad_set_active (*internal_srcpad, TRUE);
 
   /* Sink pad which will get the buffers from the encoder.
    * Note: We don't need an event function since we'll be discarding all
    * of them. */
-  smart_encoder->internal_sinkpad = gst_pad_new ("internal_sink", GST_PAD_SINK);
-  g_object_set_qdata ((GObject *) smart_encoder->internal_sinkpad,
-      INTERNAL_ELEMENT, smart_encoder);
-  gst_pad_set_chain_function (smart_encoder->internal_sinkpad, internal_chain);
-  gst_pad_set_active (smart_encoder->internal_sinkpad, TRUE);
+  *internal_sinkpad = gst_pad_new ("internal_sink", GST_PAD_SINK);
+  g_object_set_qdata ((GObject *) * internal_sinkpad, INTERNAL_ELEMENT, data);
+  gst_pad_set_chain_function (*internal_sinkpad, chain);
+  gst_pad_set_active (*internal_sinkpad, TRUE);
 
   GST_DEBUG ("Linking pads to elements");
 
   /* Link everything */
-  tmppad = gst_element_get_static_pad (smart_encoder->encoder, "src");
-  if (GST_PAD_LINK_FAILED (gst_pad_link (tmppad,
-              smart_encoder->internal_sinkpad)))
+  tmppad = gst_element_get_static_pad (*encoder, "src");
+  if (GST_PAD_LINK_FAILED (gst_pad_link (tmppad, *internal_sinkpad)))
     goto sinkpad_link_fail;
   gst_object_unref (tmppad);
 
-  if (!gst_element_link (smart_encoder->decoder, smart_encoder->encoder))
+  if (!gst_element_link (*decoder, *encoder))
     goto encoder_decoder_link_fail;
 
-  tmppad = gst_element_get_static_pad (smart_encoder->decoder, "sink");
-  if (GST_PAD_LINK_FAILED (gst_pad_link (smart_encoder->internal_srcpad,
-              tmppad)))
+  tmppad = gst_element_get_static_pad (*decoder, "sink");
+  if (GST_PAD_LINK_FAILED (gst_pad_link (*internal_srcpad, tmppad)))
     goto srcpad_link_fail;
   gst_object_unref (tmppad);
 
@@ -623,6 +929,18 @@ encoder_decoder_link_fail:
   }
 }
 
+static gboolean
+setup_recoder_pipeline (GstSmartEncoder * smart_encoder)
+{
+  /* Fast path */
+  if (G_UNLIKELY (smart_encoder->encoder))
+    return TRUE;
+
+  return create_recoder (smart_encoder, &smart_encoder->decoder,
+      &smart_encoder->encoder, &smart_encoder->internal_srcpad,
+      &smart_encoder->internal_sinkpad, internal_chain, smart_encoder);
+}
+
 static GstStateChangeReturn
 gst_smart_encoder_find_elements (GstSmartEncoder * smart_encoder)
 {
@@ -696,6 +1014,12 @@ gst_smart_encoder_change_state (GstElement * element, GstStateChange transition)
           GST_STATE_CHANGE_FAILURE)
         goto beach;
       break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      if (smart_encoder->parallel_reencodes > 1)
+        smart_encoder->reencode_pool =
+            g_thread_pool_new (smart_encoder_reencode_func, smart_encoder,
+            smart_encoder->parallel_reencodes, FALSE, NULL);
+      break;
     default:
       break;
   }
@@ -706,6 +1030,10 @@ gst_smart_encoder_change_state (GstElement * element, GstStateChange transition)
 
   switch (transition) {
     case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* the pads are flushing now, so the queued GOPs get discarded */
+      if (smart_encoder->reencode_pool)
+        g_thread_pool_free (smart_encoder->reencode_pool, FALSE, TRUE);
+      smart_encoder->reencode_pool = NULL;
       smart_encoder_reset (smart_encoder);
       break;
     default:
@@ -58,6 +58,17 @@ struct _GstSmartEncoder {
 
   /* Available caps at runtime */
   GstCaps *available_caps;
+
+  /* Parallel re-encoding */
+  guint parallel_reencodes;
+  GThreadPool *reencode_pool;
+  GMutex output_lock;
+  GCond output_cond;
+  GQueue gops;			/* SmartEncoderGop in stream order, output_lock */
+  GQueue idle_recoders;		/* output_lock */
+  guint reencoding;		/* GOPs being re-encoded, output_lock */
+  gboolean outputting;		/* output_lock */
+  GstFlowReturn output_ret;	/* output_lock */
 };
 
 struct _GstSmartEncoderClass {
@@ -91,6 +91,8 @@ gst_stream_splitter_dispose (GObject * object)
   g_list_free (stream_splitter->pending_events);
   stream_splitter->pending_events = NULL;
 
+  gst_object_replace ((GstObject **) & stream_splitter->chain_pad, NULL);
+
   G_OBJECT_CLASS (gst_stream_splitter_parent_class)->dispose (object);
 }
 
@@ -123,14 +125,32 @@ static GstFlowReturn
 gst_stream_splitter_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 {
   GstStreamSplitter *stream_splitter = (GstStreamSplitter *) parent;
-  GstFlowReturn res;
-  GstPad *srcpad = NULL;
+  GstPad *srcpad;
 
-  STREAMS_LOCK (stream_splitter);
-  if (stream_splitter->current)
-    srcpad = gst_object_ref (stream_splitter->current);
-  STREAMS_UNLOCK (stream_splitter);
+  /* Downstream changed, pick the output for the current caps again */
+  if (G_UNLIKELY (g_atomic_int_compare_and_exchange (&stream_splitter->reroute,
+              1, 0))) {
+    GstCaps *caps = gst_pad_get_current_caps (pad);
+
+    if (caps) {
+      GST_DEBUG_OBJECT (stream_splitter, "Reconfiguring, routing again");
+      gst_stream_splitter_sink_setcaps (pad, caps);
+      gst_caps_unref (caps);
+    }
+  }
 
+  /* The routing is only decided on caps and reconfiguration, only take the
+   * lock to pick up the new pad when it changed */
+  if (G_UNLIKELY (g_atomic_int_get (&stream_splitter->current_cookie) !=
+          stream_splitter->chain_cookie)) {
+    STREAMS_LOCK (stream_splitter);
+    gst_object_replace ((GstObject **) & stream_splitter->chain_pad,
+        (GstObject *) stream_splitter->current);
+    stream_splitter->chain_cookie = stream_splitter->current_cookie;
+    STREAMS_UNLOCK (stream_splitter);
+  }
+
+  srcpad = stream_splitter->chain_pad;
   if (G_UNLIKELY (srcpad == NULL))
     goto nopad;
 
@@ -138,13 +158,11 @@ gst_stream_splitter_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     gst_stream_splitter_push_pending_events (stream_splitter, srcpad);
 
   /* Forward to currently activated stream */
-  res = gst_pad_push (srcpad, buf);
-  gst_object_unref (srcpad);
-
-  return res;
+  return gst_pad_push (srcpad, buf);
 
 nopad:
   GST_WARNING_OBJECT (stream_splitter, "No output pad was configured");
+  gst_buffer_unref (buf);
   return GST_FLOW_ERROR;
 }
 
@@ -454,7 +472,10 @@ resync:
     if (res) {
       /* FIXME : we need to switch properly */
       GST_DEBUG_OBJECT (srcpad, "Setting caps on this pad was successful");
-      stream_splitter->current = srcpad;
+      if (stream_splitter->current != srcpad) {
+        stream_splitter->current = srcpad;
+        g_atomic_int_inc (&stream_splitter->current_cookie);
+      }
       goto beach;
     }
     tmp = tmp->next;
@@ -483,6 +504,8 @@ gst_stream_splitter_src_event (GstPad * pad, GstObject * parent,
     }
     stream_splitter->keyunit_seqnum = seqnum;
     STREAMS_UNLOCK (stream_splitter);
+  } else if (GST_EVENT_TYPE (event) == GST_EVENT_RECONFIGURE) {
+    g_atomic_int_set (&stream_splitter->reroute, 1);
   }
 
   return gst_pad_event_default (pad, parent, event);
@@ -543,6 +566,7 @@ gst_stream_splitter_release_pad (GstElement * element, GstPad * pad)
       /* Deactivate current flow */
       GST_DEBUG_OBJECT (element, "Removed pad was the current one");
       stream_splitter->current = NULL;
+      g_atomic_int_inc (&stream_splitter->current_cookie);
     }
 
     gst_element_remove_pad (element, pad);
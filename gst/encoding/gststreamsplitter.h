@@ -47,6 +47,16 @@ struct _GstStreamSplitter {
   GList *srcpads;
   guint32 cookie;
 
+  /* Incremented atomically, with the lock taken, when current changes */
+  gint current_cookie;
+  /* streaming thread only: the srcpad buffers are pushed on, with a ref,
+   * and the current_cookie it was taken at */
+  GstPad *chain_pad;
+  gint chain_cookie;
+  /* Set atomically when downstream asked for a reconfiguration, the
+   * routing is redone with the current caps on the next buffer */
+  gint reroute;
+
   /* List of pending in-band events */
   GList *pending_events;
 
@@ -25,6 +25,8 @@
 
 #include "gstgiobasesink.h"
 
+#include <string.h>
+
 GST_DEBUG_CATEGORY_STATIC (gst_gio_base_sink_debug);
 #define GST_CAT_DEFAULT gst_gio_base_sink_debug
 
@@ -33,10 +35,22 @@ static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+#define DEFAULT_BUFFER_SIZE 0
+
+enum
+{
+  PROP_0,
+  PROP_BUFFER_SIZE
+};
+
 #define gst_gio_base_sink_parent_class parent_class
 G_DEFINE_TYPE (GstGioBaseSink, gst_gio_base_sink, GST_TYPE_BASE_SINK);
 
 static void gst_gio_base_sink_finalize (GObject * object);
+static void gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
 static gboolean gst_gio_base_sink_start (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_stop (GstBaseSink * base_sink);
 static gboolean gst_gio_base_sink_unlock (GstBaseSink * base_sink);
@@ -58,6 +72,24 @@ gst_gio_base_sink_class_init (GstGioBaseSinkClass * klass)
       "GIO base sink");
 
   gobject_class->finalize = gst_gio_base_sink_finalize;
+  gobject_class->set_property = gst_gio_base_sink_set_property;
+  gobject_class->get_property = gst_gio_base_sink_get_property;
+
+  /**
+   * GstGioBaseSink:buffer-size:
+   *
+   * Buffers smaller than this are collected and written to the stream in
+   * blocks of this size, which saves a write per buffer on streams where
+   * every write has a high latency, like network shares. 0 writes every
+   * buffer as it arrives.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_BUFFER_SIZE,
+      g_param_spec_uint ("buffer-size", "Buffer size",
+          "Size in bytes of the blocks small buffers are collected into "
+          "before writing them (0 = write every buffer)", 0, G_MAXINT,
+          DEFAULT_BUFFER_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
   gst_element_class_add_static_pad_template (gstelement_class, &sink_factory);
 
@@ -77,6 +109,7 @@ gst_gio_base_sink_init (GstGioBaseSink * sink)
   gst_base_sink_set_sync (GST_BASE_SINK (sink), FALSE);
 
   sink->cancel = g_cancellable_new ();
+  sink->buffer_size = DEFAULT_BUFFER_SIZE;
 }
 
 static void
@@ -94,9 +127,107 @@ gst_gio_base_sink_finalize (GObject * object)
     sink->stream = NULL;
   }
 
+  g_free (sink->block);
+
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
 }
 
+static void
+gst_gio_base_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_BUFFER_SIZE:
+      GST_OBJECT_LOCK (sink);
+      sink->buffer_size = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_gio_base_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstGioBaseSink *sink = GST_GIO_BASE_SINK (object);
+
+  switch (prop_id) {
+    case PROP_BUFFER_SIZE:
+      GST_OBJECT_LOCK (sink);
+      g_value_set_uint (value, sink->buffer_size);
+      GST_OBJECT_UNLOCK (sink);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstFlowReturn
+gst_gio_base_sink_write (GstGioBaseSink * sink, const guint8 * data,
+    gsize size)
+{
+  gssize written;
+  gboolean success;
+  GError *err = NULL;
+
+  GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes", size);
+
+  written = g_output_stream_write (sink->stream, data, size, sink->cancel,
+      &err);
+
+  success = (written >= 0);
+
+  if (G_UNLIKELY (success && written < size)) {
+    /* FIXME: Can this happen?  Should we handle it gracefully?  gnomevfssink
+     * doesn't... */
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+        ("Could not write to stream: (short write, only %"
+            G_GSSIZE_FORMAT " bytes of %" G_GSIZE_FORMAT " bytes written)",
+            written, size));
+    return GST_FLOW_ERROR;
+  }
+
+  if (success) {
+    return GST_FLOW_OK;
+  } else {
+    GstFlowReturn ret;
+
+    if (!gst_gio_error (sink, "g_output_stream_write", &err, &ret)) {
+      if (GST_GIO_ERROR_MATCHES (err, NO_SPACE)) {
+        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
+            ("Could not write to stream: %s", err->message));
+      } else {
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
+            ("Could not write to stream: %s", err->message));
+      }
+      g_clear_error (&err);
+    }
+
+    return ret;
+  }
+}
+
+/* writes out the collected small buffers */
+static GstFlowReturn
+gst_gio_base_sink_write_block (GstGioBaseSink * sink)
+{
+  GstFlowReturn ret;
+
+  if (sink->block_fill == 0)
+    return GST_FLOW_OK;
+
+  ret = gst_gio_base_sink_write (sink, sink->block, sink->block_fill);
+  sink->block_fill = 0;
+
+  return ret;
+}
+
 static gboolean
 gst_gio_base_sink_start (GstBaseSink * base_sink)
 {
@@ -105,6 +236,13 @@ gst_gio_base_sink_start (GstBaseSink * base_sink)
 
   sink->position = 0;
 
+  GST_OBJECT_LOCK (sink);
+  sink->block_size = sink->buffer_size;
+  GST_OBJECT_UNLOCK (sink);
+  sink->block_fill = 0;
+  if (sink->block_size > 0)
+    sink->block = g_realloc (sink->block, sink->block_size);
+
   /* FIXME: This will likely block */
   sink->stream = gbsink_class->get_stream (sink);
   if (G_UNLIKELY (!G_IS_OUTPUT_STREAM (sink->stream))) {
@@ -130,6 +268,13 @@ gst_gio_base_sink_stop (GstBaseSink * base_sink)
   gboolean success;
   GError *err = NULL;
 
+  if (G_IS_OUTPUT_STREAM (sink->stream)
+      && gst_gio_base_sink_write_block (sink) != GST_FLOW_OK)
+    GST_WARNING_OBJECT (sink, "failed to write the last buffered data");
+  sink->block_fill = 0;
+  g_clear_pointer (&sink->block, g_free);
+  sink->block_size = 0;
+
   if (klass->close_on_stop && G_IS_OUTPUT_STREAM (sink->stream)) {
     GST_DEBUG_OBJECT (sink, "closing stream");
 
@@ -218,6 +363,11 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
           break;
         }
 
+        /* the collected data belongs before the new position */
+        ret = gst_gio_base_sink_write_block (sink);
+        if (ret != GST_FLOW_OK)
+          break;
+
         if (GST_GIO_STREAM_IS_SEEKABLE (sink->stream)) {
           ret = gst_gio_seek (sink, G_SEEKABLE (sink->stream), segment->start,
               sink->cancel);
@@ -229,12 +379,24 @@ gst_gio_base_sink_event (GstBaseSink * base_sink, GstEvent * event)
       }
       break;
 
+    case GST_EVENT_FLUSH_STOP:
+      /* not done on FLUSH_START as render() might still be running */
+      if (G_IS_OUTPUT_STREAM (sink->stream))
+        ret = gst_gio_base_sink_write_block (sink);
+      break;
+
     case GST_EVENT_EOS:
     case GST_EVENT_FLUSH_START:
       if (G_IS_OUTPUT_STREAM (sink->stream)) {
         gboolean success;
         GError *err = NULL;
 
+        if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
+          ret = gst_gio_base_sink_write_block (sink);
+          if (ret != GST_FLOW_OK)
+            break;
+        }
+
         success = g_output_stream_flush (sink->stream, sink->cancel, &err);
 
         if (!success && !gst_gio_error (sink, "g_output_stream_flush", &err,
@@ -261,56 +423,38 @@ static GstFlowReturn
 gst_gio_base_sink_render (GstBaseSink * base_sink, GstBuffer * buffer)
 {
   GstGioBaseSink *sink = GST_GIO_BASE_SINK (base_sink);
-  gssize written;
+  GstFlowReturn ret = GST_FLOW_OK;
   GstMapInfo map;
-  gboolean success;
-  GError *err = NULL;
 
   g_return_val_if_fail (G_IS_OUTPUT_STREAM (sink->stream), GST_FLOW_ERROR);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
 
   GST_LOG_OBJECT (sink,
-      "writing %" G_GSIZE_FORMAT " bytes to offset %" G_GUINT64_FORMAT,
+      "rendering %" G_GSIZE_FORMAT " bytes at offset %" G_GUINT64_FORMAT,
       map.size, sink->position);
 
-  written =
-      g_output_stream_write (sink->stream, map.data, map.size, sink->cancel,
-      &err);
-  gst_buffer_unmap (buffer, &map);
+  if (map.size < sink->block_size) {
+    /* collect small buffers and write them out when the block is full */
+    if (sink->block_fill + map.size > sink->block_size)
+      ret = gst_gio_base_sink_write_block (sink);
 
-  success = (written >= 0);
-
-  if (G_UNLIKELY (success && written < map.size)) {
-    /* FIXME: Can this happen?  Should we handle it gracefully?  gnomevfssink
-     * doesn't... */
-    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
-        ("Could not write to stream: (short write, only %"
-            G_GSSIZE_FORMAT " bytes of %" G_GSIZE_FORMAT " bytes written)",
-            written, map.size));
-    return GST_FLOW_ERROR;
+    if (ret == GST_FLOW_OK) {
+      memcpy (sink->block + sink->block_fill, map.data, map.size);
+      sink->block_fill += map.size;
+    }
+  } else {
+    ret = gst_gio_base_sink_write_block (sink);
+    if (ret == GST_FLOW_OK)
+      ret = gst_gio_base_sink_write (sink, map.data, map.size);
   }
 
-  if (success) {
-    sink->position += written;
-    return GST_FLOW_OK;
-
-  } else {
-    GstFlowReturn ret;
+  if (ret == GST_FLOW_OK)
+    sink->position += map.size;
 
-    if (!gst_gio_error (sink, "g_output_stream_write", &err, &ret)) {
-      if (GST_GIO_ERROR_MATCHES (err, NO_SPACE)) {
-        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL),
-            ("Could not write to stream: %s", err->message));
-      } else {
-        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE, (NULL),
-            ("Could not write to stream: %s", err->message));
-      }
-      g_clear_error (&err);
-    }
+  gst_buffer_unmap (buffer, &map);
 
-    return ret;
-  }
+  return ret;
 }
 
 static gboolean
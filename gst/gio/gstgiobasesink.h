@@ -54,6 +54,11 @@ struct _GstGioBaseSink
 
   /* < private > */
   GOutputStream *stream;
+
+  guint buffer_size;
+  guint8 *block;                /* small buffers are collected here */
+  gsize block_size;
+  gsize block_fill;
 };
 
 struct _GstGioBaseSinkClass 
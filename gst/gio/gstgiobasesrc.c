@@ -35,6 +35,11 @@ static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
+/* reads start at MIN_READ_SIZE and double up to MAX_READ_SIZE while the
+ * stream is read sequentially */
+#define MIN_READ_SIZE 4096
+#define MAX_READ_SIZE (1024 * 1024)
+
 #define gst_gio_base_src_parent_class parent_class
 G_DEFINE_TYPE (GstGioBaseSrc, gst_gio_base_src, GST_TYPE_BASE_SRC);
 
@@ -114,6 +119,7 @@ gst_gio_base_src_start (GstBaseSrc * base_src)
   GstGioBaseSrcClass *gbsrc_class = GST_GIO_BASE_SRC_GET_CLASS (src);
 
   src->position = 0;
+  src->read_size = MIN_READ_SIZE;
 
   /* FIXME: This will likely block */
   src->stream = gbsrc_class->get_stream (src);
@@ -303,7 +309,10 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
 
   /* If we have the requested part in our cache take a subbuffer of that,
    * otherwise fill the cache again with at least 4096 bytes from the
-   * requested offset and return a subbuffer of that.
+   * requested offset and return a subbuffer of that. When the new data
+   * directly follows the cache, the stream is read sequentially and the
+   * cache is filled with bigger reads, up to 1MB, so that high bitrate
+   * files don't need a read for every block.
    *
    * We need caching because every read/seek operation will need to go
    * over DBus if our backend is GVfs and this is painfully slow. */
@@ -318,7 +327,7 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
     GST_BUFFER_OFFSET (buf) = offset;
     GST_BUFFER_OFFSET_END (buf) = offset + size;
   } else {
-    guint cachesize = MAX (4096, size);
+    guint cachesize;
     GstMapInfo map;
     gssize read, streamread, res;
     guint64 readoffset;
@@ -327,6 +336,12 @@ gst_gio_base_src_create (GstBaseSrc * base_src, guint64 offset, guint size,
     GstBuffer *newbuffer;
     GstMemory *mem;
 
+    if (src->cache && offset == GST_BUFFER_OFFSET_END (src->cache))
+      src->read_size = MIN (src->read_size * 2, MAX_READ_SIZE);
+    else
+      src->read_size = MIN_READ_SIZE;
+    cachesize = MAX (src->read_size, size);
+
     newbuffer = gst_buffer_new ();
 
     /* copy any overlapping data from the cached buffer */
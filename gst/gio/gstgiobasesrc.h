@@ -55,6 +55,7 @@ struct _GstGioBaseSrc
   /* < private > */
   GInputStream *stream;
   GstBuffer *cache;
+  guint read_size;              /* size of the next read into the cache */
 };
 
 struct _GstGioBaseSrcClass 
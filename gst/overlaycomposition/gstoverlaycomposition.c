@@ -44,10 +44,19 @@ GST_DEBUG_CATEGORY_STATIC (gst_overlay_composition_debug);
 #define ALL_CAPS OVERLAY_COMPOSITION_CAPS ";" \
     GST_VIDEO_CAPS_MAKE_WITH_FEATURES ("ANY", GST_VIDEO_FORMATS_ALL)
 
+#define DEFAULT_DRAW_ON_INVALIDATE FALSE
+
+enum
+{
+  PROP_0,
+  PROP_DRAW_ON_INVALIDATE
+};
+
 enum
 {
   SIGNAL_CAPS_CHANGED,
   SIGNAL_DRAW,
+  SIGNAL_INVALIDATE,
   LAST_SIGNAL
 };
 
@@ -97,11 +106,23 @@ static gboolean gst_overlay_composition_src_query (GstPad * pad,
 static GstStateChangeReturn gst_overlay_composition_change_state (GstElement *
     element, GstStateChange transition);
 
+static void gst_overlay_composition_finalize (GObject * object);
+static void gst_overlay_composition_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_overlay_composition_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec);
+static void gst_overlay_composition_invalidate (GstOverlayComposition * self);
+
 static void
 gst_overlay_composition_class_init (GstOverlayCompositionClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
 
+  gobject_class->finalize = gst_overlay_composition_finalize;
+  gobject_class->set_property = gst_overlay_composition_set_property;
+  gobject_class->get_property = gst_overlay_composition_get_property;
+
   GST_DEBUG_CATEGORY_INIT (gst_overlay_composition_debug, "overlaycomposition",
       0, "Overlay Composition");
 
@@ -116,6 +137,28 @@ gst_overlay_composition_class_init (GstOverlayCompositionClass * klass)
 
   gstelement_class->change_state = gst_overlay_composition_change_state;
 
+  klass->invalidate = gst_overlay_composition_invalidate;
+
+  /**
+   * GstOverlayComposition:draw-on-invalidate:
+   *
+   * If %TRUE, the #GstOverlayComposition::draw signal is only emitted for
+   * the first frame, after caps changes and after the application emitted
+   * #GstOverlayComposition::invalidate. The composition returned last is
+   * reused for all other frames.
+   *
+   * Reusing the same composition allows the rectangles to keep their
+   * scaled and converted pixels, and downstream elements rendering the
+   * attached #GstVideoOverlayCompositionMeta to only upload it once.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_DRAW_ON_INVALIDATE,
+      g_param_spec_boolean ("draw-on-invalidate", "Draw on invalidate",
+          "Only emit the draw signal when the overlay was invalidated and "
+          "reuse the previous overlay otherwise", DEFAULT_DRAW_ON_INVALIDATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstOverlayComposition::draw:
    * @overlay: Overlay element emitting the signal.
@@ -147,6 +190,23 @@ gst_overlay_composition_class_init (GstOverlayCompositionClass * klass)
       g_signal_new ("caps-changed",
       G_TYPE_FROM_CLASS (klass), 0, 0, NULL, NULL, NULL, G_TYPE_NONE, 3,
       GST_TYPE_CAPS, G_TYPE_UINT, G_TYPE_UINT);
+
+  /**
+   * GstOverlayComposition::invalidate:
+   * @overlay: Overlay element emitting the signal.
+   *
+   * Action signal to tell the element that the overlay changed. With
+   * #GstOverlayComposition:draw-on-invalidate the
+   * #GstOverlayComposition::draw signal is emitted again for the next
+   * frame.
+   *
+   * Since: 1.18
+   */
+  overlay_composition_signals[SIGNAL_INVALIDATE] =
+      g_signal_new ("invalidate", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstOverlayCompositionClass, invalidate), NULL, NULL,
+      NULL, G_TYPE_NONE, 0);
 }
 
 static void
@@ -166,6 +226,66 @@ gst_overlay_composition_init (GstOverlayComposition * self)
   gst_pad_set_query_function (self->srcpad,
       GST_DEBUG_FUNCPTR (gst_overlay_composition_src_query));
   gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
+
+  self->draw_on_invalidate = DEFAULT_DRAW_ON_INVALIDATE;
+}
+
+static void
+gst_overlay_composition_finalize (GObject * object)
+{
+  GstOverlayComposition *self = GST_OVERLAY_COMPOSITION (object);
+
+  if (self->last_compo)
+    gst_video_overlay_composition_unref (self->last_compo);
+  self->last_compo = NULL;
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_overlay_composition_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstOverlayComposition *self = GST_OVERLAY_COMPOSITION (object);
+
+  switch (prop_id) {
+    case PROP_DRAW_ON_INVALIDATE:
+      GST_OBJECT_LOCK (self);
+      self->draw_on_invalidate = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_overlay_composition_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstOverlayComposition *self = GST_OVERLAY_COMPOSITION (object);
+
+  switch (prop_id) {
+    case PROP_DRAW_ON_INVALIDATE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->draw_on_invalidate);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_overlay_composition_invalidate (GstOverlayComposition * self)
+{
+  GST_DEBUG_OBJECT (self, "Overlay invalidated");
+
+  GST_OBJECT_LOCK (self);
+  self->invalidated = TRUE;
+  GST_OBJECT_UNLOCK (self);
 }
 
 static GstStateChangeReturn
@@ -200,6 +320,12 @@ gst_overlay_composition_change_state (GstElement * element,
       }
       gst_caps_replace (&self->caps, NULL);
       gst_segment_init (&self->segment, GST_FORMAT_UNDEFINED);
+      GST_OBJECT_LOCK (self);
+      if (self->last_compo)
+        gst_video_overlay_composition_unref (self->last_compo);
+      self->last_compo = NULL;
+      self->have_last_compo = FALSE;
+      GST_OBJECT_UNLOCK (self);
       break;
     default:
       break;
@@ -349,6 +475,11 @@ gst_overlay_composition_negotiate (GstOverlayComposition * self, GstCaps * caps)
     gst_pad_mark_reconfigure (self->srcpad);
   }
 
+  /* The application has to draw again for the new caps */
+  GST_OBJECT_LOCK (self);
+  self->invalidated = TRUE;
+  GST_OBJECT_UNLOCK (self);
+
   g_signal_emit (self, overlay_composition_signals[SIGNAL_CAPS_CHANGED], 0,
       caps, self->window_width, self->window_height, NULL);
 
@@ -675,6 +806,7 @@ gst_overlay_composition_sink_chain (GstPad * pad, GstObject * parent,
   GstOverlayComposition *self = GST_OVERLAY_COMPOSITION (parent);
   GstVideoOverlayComposition *compo = NULL;
   GstVideoOverlayCompositionMeta *upstream_compo_meta;
+  gboolean need_draw;
 
   if (gst_pad_check_reconfigure (self->srcpad)) {
     if (!gst_overlay_composition_negotiate (self, NULL)) {
@@ -690,27 +822,46 @@ gst_overlay_composition_sink_chain (GstPad * pad, GstObject * parent,
     }
   }
 
-  if (!self->sample) {
-    self->sample = gst_sample_new (buffer, self->caps, &self->segment, NULL);
-  } else {
-    self->sample = gst_sample_make_writable (self->sample);
-    gst_sample_set_buffer (self->sample, buffer);
-    gst_sample_set_caps (self->sample, self->caps);
-    gst_sample_set_segment (self->sample, &self->segment);
-  }
+  GST_OBJECT_LOCK (self);
+  need_draw = !self->draw_on_invalidate || self->invalidated
+      || !self->have_last_compo;
+  if (!need_draw && self->last_compo)
+    compo = gst_video_overlay_composition_ref (self->last_compo);
+  self->invalidated = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (need_draw) {
+    if (!self->sample) {
+      self->sample = gst_sample_new (buffer, self->caps, &self->segment, NULL);
+    } else {
+      self->sample = gst_sample_make_writable (self->sample);
+      gst_sample_set_buffer (self->sample, buffer);
+      gst_sample_set_caps (self->sample, self->caps);
+      gst_sample_set_segment (self->sample, &self->segment);
+    }
 
-  g_signal_emit (self, overlay_composition_signals[SIGNAL_DRAW], 0,
-      self->sample, &compo);
+    g_signal_emit (self, overlay_composition_signals[SIGNAL_DRAW], 0,
+        self->sample, &compo);
 
-  /* Don't store the buffer in the sample any longer, otherwise it will not
-   * be writable below as we have one reference in the sample and one in
-   * this function.
-   *
-   * If the sample is not writable itself then the application kept an
-   * reference itself.
-   */
-  if (gst_sample_is_writable (self->sample)) {
-    gst_sample_set_buffer (self->sample, NULL);
+    /* Don't store the buffer in the sample any longer, otherwise it will not
+     * be writable below as we have one reference in the sample and one in
+     * this function.
+     *
+     * If the sample is not writable itself then the application kept an
+     * reference itself.
+     */
+    if (gst_sample_is_writable (self->sample)) {
+      gst_sample_set_buffer (self->sample, NULL);
+    }
+
+    GST_OBJECT_LOCK (self);
+    if (self->last_compo)
+      gst_video_overlay_composition_unref (self->last_compo);
+    self->last_compo = compo ? gst_video_overlay_composition_ref (compo) : NULL;
+    self->have_last_compo = TRUE;
+    GST_OBJECT_UNLOCK (self);
+  } else {
+    GST_LOG_OBJECT (self->sinkpad, "Reusing previous overlay composition");
   }
 
   if (!compo) {
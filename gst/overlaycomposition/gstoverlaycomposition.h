@@ -51,10 +51,19 @@ struct _GstOverlayComposition {
   GstVideoInfo info;
   guint window_width, window_height;
   gboolean attach_compo_to_buffer;
+
+  /* protected by the object lock */
+  gboolean draw_on_invalidate;
+  gboolean invalidated;
+  gboolean have_last_compo;
+  GstVideoOverlayComposition *last_compo;
 };
 
 struct _GstOverlayCompositionClass {
   GstElementClass parent_class;
+
+  /* actions */
+  void (*invalidate) (GstOverlayComposition * overlay);
 };
 
 GType gst_overlay_composition_get_type (void);
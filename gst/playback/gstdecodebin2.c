@@ -252,6 +252,13 @@ enum
 #define AUTO_PLAY_SIZE_BUFFERS      5
 #define AUTO_PLAY_SIZE_TIME         0
 
+/* once the bitrate of a group is known, keep about one second of data while
+ * playing, within the bounds below */
+#define AUTO_PLAY_BITRATE_TIME      GST_SECOND
+#define AUTO_PLAY_MAX_SIZE_BYTES    32 * 1024 * 1024
+/* amount of data, in stream time, used to estimate the bitrate */
+#define BITRATE_ESTIMATE_TIME       2 * GST_SECOND
+
 #define DEFAULT_SUBTITLE_ENCODING NULL
 #define DEFAULT_USE_BUFFERING     FALSE
 #define DEFAULT_FORCE_SW_DECODERS FALSE
@@ -296,9 +303,9 @@ static void type_found (GstElement * typefind, guint probability,
     GstCaps * caps, GstDecodeBin * decode_bin);
 
 static void decodebin_set_queue_size (GstDecodeBin * dbin,
-    GstElement * multiqueue, gboolean preroll, gboolean seekable);
+    GstDecodeGroup * group, gboolean preroll, gboolean seekable);
 static void decodebin_set_queue_size_full (GstDecodeBin * dbin,
-    GstElement * multiqueue, gboolean use_buffering, gboolean preroll,
+    GstDecodeGroup * group, gboolean use_buffering, gboolean preroll,
     gboolean seekable);
 
 static gboolean gst_decode_bin_autoplug_continue (GstElement * element,
@@ -425,6 +432,7 @@ struct _GstDemuxerPad
   GWeakRef weakPad;
   gulong event_probe_id;
   gulong query_probe_id;
+  gulong buffer_probe_id;
 };
 
 
@@ -453,6 +461,13 @@ struct _GstDecodeGroup
 
   GList *reqpads;               /* List of RequestPads for multiqueue, there is
                                  * exactly one RequestPad per child chain */
+
+  GMutex rate_lock;             /* Protects the bitrate estimation below */
+  GstClockTime rate_min_ts;     /* Lowest and highest timestamp seen */
+  GstClockTime rate_max_ts;
+  guint64 rate_bytes;           /* Number of bytes seen so far */
+  guint64 bitrate;              /* Estimated bitrate of all streams, or 0 */
+  gboolean playing;             /* TRUE when using the runtime queue limits */
 };
 
 struct _GstDecodeChain
@@ -3139,7 +3154,7 @@ no_more_pads_cb (GstElement * element, GstDecodeChain * chain)
    * we can probably set its buffering state to playing now */
   GST_DEBUG_OBJECT (group->dbin, "Setting group %p multiqueue to "
       "'playing' buffering mode", group);
-  decodebin_set_queue_size (group->dbin, group->multiqueue, FALSE,
+  decodebin_set_queue_size (group->dbin, group, FALSE,
       (group->parent ? group->parent->seekable : TRUE));
   CHAIN_MUTEX_UNLOCK (chain);
 
@@ -3588,7 +3603,7 @@ multi_queue_overrun_cb (GstElement * queue, GstDecodeGroup * group)
    * we can probably set its buffering state to playing now */
   GST_DEBUG_OBJECT (group->dbin, "Setting group %p multiqueue to "
       "'playing' buffering mode", group);
-  decodebin_set_queue_size (group->dbin, group->multiqueue, FALSE,
+  decodebin_set_queue_size (group->dbin, group, FALSE,
       (group->parent ? group->parent->seekable : TRUE));
 
   /* FIXME: We should make sure that everything gets exposed now
@@ -3623,6 +3638,7 @@ gst_decode_group_free_internal (GstDecodeGroup * group, gboolean hide)
       if (sinkpad != NULL) {
         gst_pad_remove_probe (sinkpad, demuxer_pad->event_probe_id);
         gst_pad_remove_probe (sinkpad, demuxer_pad->query_probe_id);
+        gst_pad_remove_probe (sinkpad, demuxer_pad->buffer_probe_id);
         g_weak_ref_clear (&demuxer_pad->weakPad);
         gst_object_unref (sinkpad);
       }
@@ -3673,8 +3689,10 @@ gst_decode_group_free_internal (GstDecodeGroup * group, gboolean hide)
 
   GST_DEBUG_OBJECT (group->dbin, "%s group %p", (hide ? "Hid" : "Freed"),
       group);
-  if (!hide)
+  if (!hide) {
+    g_mutex_clear (&group->rate_lock);
     g_slice_free (GstDecodeGroup, group);
+  }
 }
 
 /* gst_decode_group_free:
@@ -3784,24 +3802,45 @@ gst_decode_chain_start_free_hidden_groups_thread (GstDecodeChain * chain)
 }
 
 static void
-decodebin_set_queue_size (GstDecodeBin * dbin, GstElement * multiqueue,
+decodebin_set_queue_size (GstDecodeBin * dbin, GstDecodeGroup * group,
     gboolean preroll, gboolean seekable)
 {
   gboolean use_buffering;
 
   /* get the current config from the multiqueue */
-  g_object_get (multiqueue, "use-buffering", &use_buffering, NULL);
+  g_object_get (group->multiqueue, "use-buffering", &use_buffering, NULL);
 
-  decodebin_set_queue_size_full (dbin, multiqueue, use_buffering, preroll,
+  decodebin_set_queue_size_full (dbin, group, use_buffering, preroll,
       seekable);
 }
 
+/* runtime limit for the amount of queued bytes, depending on the bitrate of
+ * the group if it is known already */
+static guint
+decodebin_get_auto_play_size_bytes (GstDecodeGroup * group)
+{
+  guint64 bitrate, bytes;
+
+  g_mutex_lock (&group->rate_lock);
+  bitrate = group->bitrate;
+  g_mutex_unlock (&group->rate_lock);
+
+  if (bitrate == 0)
+    return AUTO_PLAY_SIZE_BYTES;
+
+  bytes = gst_util_uint64_scale (bitrate / 8, AUTO_PLAY_BITRATE_TIME,
+      GST_SECOND);
+
+  return CLAMP (bytes, AUTO_PLAY_SIZE_BYTES, AUTO_PLAY_MAX_SIZE_BYTES);
+}
+
 /* configure queue sizes, this depends on the buffering method and if we are
  * playing or prerolling. */
 static void
-decodebin_set_queue_size_full (GstDecodeBin * dbin, GstElement * multiqueue,
+decodebin_set_queue_size_full (GstDecodeBin * dbin, GstDecodeGroup * group,
     gboolean use_buffering, gboolean preroll, gboolean seekable)
 {
+  GstElement *multiqueue = group->multiqueue;
   guint max_bytes, max_buffers;
   guint64 max_time;
 
@@ -3827,7 +3866,7 @@ decodebin_set_queue_size_full (GstDecodeBin * dbin, GstElement * multiqueue,
     if (dbin->use_buffering)
       max_bytes = 0;
     else if ((max_bytes = dbin->max_size_bytes) == 0)
-      max_bytes = AUTO_PLAY_SIZE_BYTES;
+      max_bytes = decodebin_get_auto_play_size_bytes (group);
     if ((max_buffers = dbin->max_size_buffers) == 0)
       max_buffers = AUTO_PLAY_SIZE_BUFFERS;
     /* this is a multiqueue with disabled buffering, don't limit max_time */
@@ -3837,6 +3876,10 @@ decodebin_set_queue_size_full (GstDecodeBin * dbin, GstElement * multiqueue,
       max_time = AUTO_PLAY_SIZE_TIME;
   }
 
+  g_mutex_lock (&group->rate_lock);
+  group->playing = !preroll && !use_buffering;
+  g_mutex_unlock (&group->rate_lock);
+
   GST_DEBUG_OBJECT (multiqueue, "setting limits %u bytes, %u buffers, "
       "%" G_GUINT64_FORMAT " time", max_bytes, max_buffers, max_time);
   g_object_set (multiqueue,
@@ -3844,6 +3887,49 @@ decodebin_set_queue_size_full (GstDecodeBin * dbin, GstElement * multiqueue,
       "max-size-buffers", max_buffers, NULL);
 }
 
+/* Estimates the bitrate of all the streams of a group from the first
+ * BITRATE_ESTIMATE_TIME of data going into its multiqueue */
+static GstPadProbeReturn
+sink_pad_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GstDecodeGroup *group = (GstDecodeGroup *) user_data;
+  GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+  GstClockTime ts;
+  gboolean update = FALSE;
+
+  ts = GST_BUFFER_DTS_OR_PTS (buffer);
+  if (!GST_CLOCK_TIME_IS_VALID (ts))
+    return GST_PAD_PROBE_OK;
+
+  g_mutex_lock (&group->rate_lock);
+  if (group->bitrate != 0) {
+    g_mutex_unlock (&group->rate_lock);
+    return GST_PAD_PROBE_OK;
+  }
+
+  if (!GST_CLOCK_TIME_IS_VALID (group->rate_min_ts) || ts < group->rate_min_ts)
+    group->rate_min_ts = ts;
+  if (!GST_CLOCK_TIME_IS_VALID (group->rate_max_ts) || ts > group->rate_max_ts)
+    group->rate_max_ts = ts;
+  group->rate_bytes += gst_buffer_get_size (buffer);
+
+  if (group->rate_max_ts - group->rate_min_ts >= BITRATE_ESTIMATE_TIME) {
+    group->bitrate = gst_util_uint64_scale (group->rate_bytes * 8, GST_SECOND,
+        group->rate_max_ts - group->rate_min_ts);
+    update = group->playing && group->bitrate != 0;
+    GST_DEBUG_OBJECT (group->dbin, "group %p bitrate %" G_GUINT64_FORMAT,
+        group, group->bitrate);
+  }
+  g_mutex_unlock (&group->rate_lock);
+
+  if (update)
+    decodebin_set_queue_size (group->dbin, group, FALSE,
+        (group->parent ? group->parent->seekable : TRUE));
+
+  return GST_PAD_PROBE_OK;
+}
+
 /* gst_decode_group_new:
  * @dbin: Parent decodebin
  * @parent: Parent chain or %NULL
@@ -3863,6 +3949,9 @@ gst_decode_group_new (GstDecodeBin * dbin, GstDecodeChain * parent)
 
   group->dbin = dbin;
   group->parent = parent;
+  g_mutex_init (&group->rate_lock);
+  group->rate_min_ts = GST_CLOCK_TIME_NONE;
+  group->rate_max_ts = GST_CLOCK_TIME_NONE;
 
   mq = group->multiqueue = gst_element_factory_make ("multiqueue", NULL);
   if (G_UNLIKELY (!group->multiqueue))
@@ -3879,7 +3968,7 @@ gst_decode_group_new (GstDecodeBin * dbin, GstDecodeChain * parent)
       gst_object_unref (pad);
     }
   }
-  decodebin_set_queue_size_full (dbin, mq, FALSE, TRUE, seekable);
+  decodebin_set_queue_size_full (dbin, group, FALSE, TRUE, seekable);
 
   group->overrunsig = g_signal_connect (mq, "overrun",
       G_CALLBACK (multi_queue_overrun_cb), group);
@@ -3897,6 +3986,7 @@ missing_multiqueue:
         gst_missing_element_message_new (GST_ELEMENT_CAST (dbin),
             "multiqueue"));
     GST_ELEMENT_ERROR (dbin, CORE, MISSING_PLUGIN, (NULL), ("no multiqueue!"));
+    g_mutex_clear (&group->rate_lock);
     g_slice_free (GstDecodeGroup, group);
     return NULL;
   }
@@ -3957,6 +4047,8 @@ gst_decode_group_control_demuxer_pad (GstDecodeGroup * group, GstPad * pad)
       GST_PAD_PROBE_TYPE_EVENT_UPSTREAM, sink_pad_event_probe, group, NULL);
   demuxer_pad->query_probe_id = gst_pad_add_probe (sinkpad,
       GST_PAD_PROBE_TYPE_QUERY_UPSTREAM, sink_pad_query_probe, group, NULL);
+  demuxer_pad->buffer_probe_id = gst_pad_add_probe (sinkpad,
+      GST_PAD_PROBE_TYPE_BUFFER, sink_pad_buffer_probe, group, NULL);
 
   g_weak_ref_set (&demuxer_pad->weakPad, sinkpad);
   group->demuxer_pad_probe_ids =
@@ -4396,7 +4488,7 @@ gst_decode_group_reset_buffering (GstDecodeGroup * group)
     CHAIN_MUTEX_UNLOCK (chain);
   }
 
-  decodebin_set_queue_size_full (group->dbin, group->multiqueue, !ret,
+  decodebin_set_queue_size_full (group->dbin, group, !ret,
       FALSE, (group->parent ? group->parent->seekable : TRUE));
 
   if (ret) {
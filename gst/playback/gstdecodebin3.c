@@ -33,6 +33,7 @@
 #include "gstplayback.h"
 #include "gstplay-enum.h"
 #include "gstrawcaps.h"
+#include "gstplaybackutils.h"
 
 /**
  * SECTION:element-decodebin3
@@ -257,9 +258,16 @@ struct _GstDecodebin3
   GList *factories;
   /* Only DECODER factories */
   GList *decoder_factories;
+  /* whether hardware decoders were left out of decoder_factories */
+  gboolean decoder_factories_sw;
   /* DECODABLE but not DECODER factories */
   GList *decodable_factories;
 
+  /* Decoders of the previous streams, kept in READY when going back to
+   * READY so that they can be reused by the next streams.
+   * Protected by SELECTION_LOCK */
+  GList *idle_decoders;
+
   /* counters for pads */
   guint32 apadcount, vpadcount, tpadcount, opadcount;
 
@@ -328,6 +336,9 @@ typedef struct _MultiQueueSlot
   /* id of the MQ src_pad event probe */
   gulong probe_id;
 
+  /* id of the MQ sink_pad buffer probe */
+  gulong input_probe_id;
+
   gboolean is_drained;
 
   DecodebinOutputStream *output;
@@ -650,12 +661,31 @@ gst_decodebin3_init (GstDecodebin3 * dbin)
   GST_OBJECT_FLAG_SET (dbin, GST_BIN_FLAG_STREAMS_AWARE);
 }
 
+static void
+free_idle_decoders (GstDecodebin3 * dbin)
+{
+  GList *tmp;
+
+  for (tmp = dbin->idle_decoders; tmp; tmp = tmp->next) {
+    GstElement *decoder = tmp->data;
+
+    GST_DEBUG_OBJECT (dbin, "Releasing idle decoder %" GST_PTR_FORMAT,
+        decoder);
+    gst_element_set_state (decoder, GST_STATE_NULL);
+    gst_object_unref (decoder);
+  }
+  g_list_free (dbin->idle_decoders);
+  dbin->idle_decoders = NULL;
+}
+
 static void
 gst_decodebin3_dispose (GObject * object)
 {
   GstDecodebin3 *dbin = (GstDecodebin3 *) object;
   GList *walk, *next;
 
+  free_idle_decoders (dbin);
+
   if (dbin->factories)
     gst_plugin_feature_list_free (dbin->factories);
   if (dbin->decoder_factories)
@@ -1056,6 +1086,7 @@ gst_decode_bin_update_factories_list (GstDecodebin3 * dbin)
     dbin->factories =
         g_list_sort (dbin->factories, gst_plugin_feature_rank_compare_func);
     dbin->factories_cookie = cookie;
+    dbin->decoder_factories_sw = dbin->force_sw_decoders;
 
     /* Filter decoder and other decodables */
     dbin->decoder_factories = NULL;
@@ -1934,6 +1965,53 @@ multiqueue_src_probe (GstPad * pad, GstPadProbeInfo * info,
   return ret;
 }
 
+/* WITH SELECTION_LOCK TAKEN! */
+static gboolean
+stream_is_wanted (GstDecodebin3 * dbin, const gchar * sid)
+{
+  /* Nothing selected yet, any stream might end up being used */
+  if (dbin->requested_selection == NULL && dbin->active_selection == NULL
+      && dbin->to_activate == NULL && dbin->pending_select_streams == NULL)
+    return TRUE;
+
+  return stream_in_list (dbin->requested_selection, sid)
+      || stream_in_list (dbin->active_selection, sid)
+      || stream_in_list (dbin->to_activate, sid)
+      || stream_in_list (dbin->pending_select_streams, sid);
+}
+
+/* Drops the buffers of streams which are not selected before they get
+ * queued in multiqueue, they would be discarded by the unlinked slot anyway.
+ * Events still go through so that caps and tags of the stream are known and
+ * the slot can be activated by a later stream selection. */
+static GstPadProbeReturn
+multiqueue_sink_buffer_probe (GstPad * pad, GstPadProbeInfo * info,
+    MultiQueueSlot * slot)
+{
+  GstDecodebin3 *dbin = slot->dbin;
+  GstStream *stream;
+  gboolean drop = FALSE;
+
+  /* Fast path for slots being decoded */
+  if (slot->output)
+    return GST_PAD_PROBE_OK;
+
+  SELECTION_LOCK (dbin);
+  /* The input stream is only updated from this streaming thread */
+  stream = slot->input ? slot->input->active_stream : NULL;
+  if (slot->output == NULL && stream)
+    drop = !stream_is_wanted (dbin, gst_stream_get_stream_id (stream));
+  SELECTION_UNLOCK (dbin);
+
+  if (drop) {
+    GST_LOG_OBJECT (pad, "Dropping data of unselected stream %s",
+        gst_stream_get_stream_id (stream));
+    return GST_PAD_PROBE_DROP;
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
 /* Create a new multiqueue slot for the given type
  *
  * It is up to the caller to know whether that slot is needed or not
@@ -1974,6 +2052,10 @@ create_new_slot (GstDecodebin3 * dbin, GstStreamType type)
       gst_pad_add_probe (slot->src_pad,
       GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM,
       (GstPadProbeCallback) multiqueue_src_probe, slot, NULL);
+  slot->input_probe_id =
+      gst_pad_add_probe (slot->sink_pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) multiqueue_sink_buffer_probe, slot, NULL);
 
   GST_DEBUG ("Created new slot %u (%p) (%s:%s)", slot->id, slot,
       GST_DEBUG_PAD_NAME (slot->src_pad));
@@ -2108,12 +2190,13 @@ create_element (GstDecodebin3 * dbin, GstStream * stream,
   caps = gst_stream_get_caps (stream);
   if (ftype == GST_ELEMENT_FACTORY_TYPE_DECODER)
     res =
-        gst_element_factory_list_filter (dbin->decoder_factories,
-        caps, GST_PAD_SINK, TRUE);
+        gst_playback_utils_factory_list_filter (dbin->decoder_factories_sw ?
+        "decodebin3-sw-decoders" : "decodebin3-decoders",
+        dbin->decoder_factories, caps, GST_PAD_SINK, TRUE);
   else
     res =
-        gst_element_factory_list_filter (dbin->decodable_factories,
-        caps, GST_PAD_SINK, TRUE);
+        gst_playback_utils_factory_list_filter ("decodebin3-decodables",
+        dbin->decodable_factories, caps, GST_PAD_SINK, TRUE);
   g_mutex_unlock (&dbin->factories_lock);
 
   if (res) {
@@ -2136,6 +2219,60 @@ create_decoder (GstDecodebin3 * dbin, GstStream * stream)
   return create_element (dbin, stream, GST_ELEMENT_FACTORY_TYPE_DECODER);
 }
 
+/* Returns (transfer full) an idle decoder accepting the caps of @stream, if
+ * any. Must be called with SELECTION_LOCK taken */
+static GstElement *
+get_idle_decoder (GstDecodebin3 * dbin, GstStream * stream)
+{
+  GstElement *decoder = NULL;
+  GstCaps *caps;
+  GList *tmp;
+
+  if (dbin->idle_decoders == NULL)
+    return NULL;
+
+  caps = gst_stream_get_caps (stream);
+  for (tmp = dbin->idle_decoders; tmp; tmp = tmp->next) {
+    GstPad *sinkpad = gst_element_get_static_pad (tmp->data, "sink");
+    gboolean accepted = sinkpad && gst_pad_query_accept_caps (sinkpad, caps);
+
+    if (sinkpad)
+      gst_object_unref (sinkpad);
+    if (accepted) {
+      decoder = tmp->data;
+      dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, tmp);
+      gst_element_set_locked_state (decoder, FALSE);
+      GST_DEBUG_OBJECT (dbin, "Reusing idle decoder %" GST_PTR_FORMAT
+          " for caps %" GST_PTR_FORMAT, decoder, caps);
+      break;
+    }
+  }
+  gst_caps_unref (caps);
+
+  return decoder;
+}
+
+/* Take the decoder of @output out of the bin and keep it in READY for
+ * later reuse. Must be called with SELECTION_LOCK taken */
+static void
+park_decoder (GstDecodebin3 * dbin, DecodebinOutputStream * output)
+{
+  GstElement *decoder = output->decoder;
+
+  if (output->slot && output->decoder_sink)
+    gst_pad_unlink (output->slot->src_pad, output->decoder_sink);
+  gst_ghost_pad_set_target ((GstGhostPad *) output->src_pad, NULL);
+
+  gst_object_ref (decoder);
+  gst_element_set_locked_state (decoder, TRUE);
+  gst_element_set_state (decoder, GST_STATE_READY);
+  gst_bin_remove ((GstBin *) dbin, decoder);
+  output->decoder = NULL;
+
+  GST_DEBUG_OBJECT (dbin, "Keeping idle decoder %" GST_PTR_FORMAT, decoder);
+  dbin->idle_decoders = g_list_append (dbin->idle_decoders, decoder);
+}
+
 static GstPadProbeReturn
 keyframe_waiter_probe (GstPad * pad, GstPadProbeInfo * info,
     DecodebinOutputStream * output)
@@ -2235,8 +2372,14 @@ reconfigure_output_stream (DecodebinOutputStream * output,
 
   /* If a decoder is required, create one */
   if (needs_decoder) {
-    /* If we don't have a decoder yet, instantiate one */
-    output->decoder = create_decoder (dbin, slot->active_stream);
+    gboolean reused = FALSE;
+
+    /* If we don't have a decoder yet, reuse an idle one or instantiate one */
+    output->decoder = get_idle_decoder (dbin, slot->active_stream);
+    if (output->decoder)
+      reused = TRUE;
+    else
+      output->decoder = create_decoder (dbin, slot->active_stream);
     if (output->decoder == NULL) {
       GstCaps *caps;
 
@@ -2252,8 +2395,14 @@ reconfigure_output_stream (DecodebinOutputStream * output,
     }
     if (!gst_bin_add ((GstBin *) dbin, output->decoder)) {
       GST_ERROR_OBJECT (dbin, "could not add decoder to pipeline");
+      if (reused)
+        gst_object_unref (output->decoder);
+      output->decoder = NULL;
       goto cleanup;
     }
+    /* the bin took its own reference on the idle decoder */
+    if (reused)
+      gst_object_unref (output->decoder);
     output->decoder_sink = gst_element_get_static_pad (output->decoder, "sink");
     output->decoder_src = gst_element_get_static_pad (output->decoder, "src");
     if (output->type & GST_STREAM_TYPE_VIDEO) {
@@ -2791,6 +2940,8 @@ free_multiqueue_slot (GstDecodebin3 * dbin, MultiQueueSlot * slot)
 {
   if (slot->probe_id)
     gst_pad_remove_probe (slot->src_pad, slot->probe_id);
+  if (slot->input_probe_id)
+    gst_pad_remove_probe (slot->sink_pad, slot->input_probe_id);
   if (slot->input) {
     if (slot->input->srcpad)
       gst_pad_unlink (slot->input->srcpad, slot->sink_pad);
@@ -2913,9 +3064,20 @@ gst_decodebin3_change_state (GstElement * element, GstStateChange transition)
     {
       GList *tmp;
 
-      /* Free output streams */
+      /* Decoders that weren't reused by the streams that just stopped won't
+       * be by the next ones either */
+      SELECTION_LOCK (dbin);
+      free_idle_decoders (dbin);
+      SELECTION_UNLOCK (dbin);
+      /* Free output streams, keeping their decoders around so that the next
+       * streams don't have to create and set up new ones */
       for (tmp = dbin->output_streams; tmp; tmp = tmp->next) {
         DecodebinOutputStream *output = (DecodebinOutputStream *) tmp->data;
+        if (output->decoder) {
+          SELECTION_LOCK (dbin);
+          park_decoder (dbin, output);
+          SELECTION_UNLOCK (dbin);
+        }
         free_output_stream (dbin, output);
       }
       g_list_free (dbin->output_streams);
@@ -2933,6 +3095,11 @@ gst_decodebin3_change_state (GstElement * element, GstStateChange transition)
       dbin->main_input->group_id = GST_GROUP_ID_INVALID;
     }
       break;
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      SELECTION_LOCK (dbin);
+      free_idle_decoders (dbin);
+      SELECTION_UNLOCK (dbin);
+      break;
     default:
       break;
   }
@@ -1126,8 +1126,8 @@ gst_parse_bin_autoplug_factories (GstElement * element, GstPad * pad,
   g_mutex_lock (&parsebin->factories_lock);
   gst_parse_bin_update_factories_list (parsebin);
   list =
-      gst_element_factory_list_filter (parsebin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
+      gst_playback_utils_factory_list_filter ("parsebin", parsebin->factories,
+      caps, GST_PAD_SINK, gst_caps_is_fixed (caps));
   g_mutex_unlock (&parsebin->factories_lock);
 
   result = g_value_array_new (g_list_length (list));
@@ -162,3 +162,102 @@ gst_playback_utils_compare_factories_func (gconstpointer p1, gconstpointer p2)
    * and then by factory name */
   return gst_plugin_feature_rank_compare_func (p1, p2);
 }
+
+/* Results of gst_element_factory_list_filter() for the factory lists the
+ * autoplugging elements build from the registry, shared by all their
+ * instances. Looking up the factories for the same caps again, e.g. when
+ * switching between streams of the same kind, then doesn't intersect the
+ * caps with the templates of every factory again. */
+#define FILTER_CACHE_MAX_ENTRIES 256
+
+static GMutex filter_cache_lock;
+static GHashTable *filter_cache = NULL;
+static guint32 filter_cache_cookie;
+
+static gboolean
+remove_stream_data (GQuark field_id, GValue * value, gpointer user_data)
+{
+  /* these are specific to each stream but never restricted by pad templates,
+   * leave them out of the key so that streams of the same format share it */
+  return field_id != g_quark_from_static_string ("codec_data")
+      && field_id != g_quark_from_static_string ("streamheader");
+}
+
+static gchar *
+filter_cache_key (const gchar * list_name, const GstCaps * caps,
+    GstPadDirection direction, gboolean subsetonly)
+{
+  GstCaps *copy;
+  gchar *caps_str, *key;
+  guint i;
+
+  copy = gst_caps_copy (caps);
+  for (i = 0; i < gst_caps_get_size (copy); i++)
+    gst_structure_filter_and_map_in_place (gst_caps_get_structure (copy, i),
+        remove_stream_data, NULL);
+  caps_str = gst_caps_to_string (copy);
+  gst_caps_unref (copy);
+
+  key = g_strdup_printf ("%s:%d:%d:%s", list_name, direction, subsetonly,
+      caps_str);
+  g_free (caps_str);
+
+  return key;
+}
+
+static GList *
+factory_list_copy (GList * list)
+{
+  return g_list_copy_deep (list, (GCopyFunc) gst_object_ref, NULL);
+}
+
+/* Like gst_element_factory_list_filter(), but caches the result for the
+ * factory list named @list_name. That list must only depend on the
+ * registry. Use gst_plugin_feature_list_free() after usage. */
+GList *
+gst_playback_utils_factory_list_filter (const gchar * list_name,
+    GList * factories, const GstCaps * caps, GstPadDirection direction,
+    gboolean subsetonly)
+{
+  GList *result;
+  gchar *key;
+  guint32 cookie;
+
+  cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
+  key = filter_cache_key (list_name, caps, direction, subsetonly);
+
+  g_mutex_lock (&filter_cache_lock);
+  if (filter_cache == NULL) {
+    filter_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+        (GDestroyNotify) gst_plugin_feature_list_free);
+    filter_cache_cookie = cookie;
+  } else if (filter_cache_cookie != cookie) {
+    GST_DEBUG ("registry changed, clearing factory filter cache");
+    g_hash_table_remove_all (filter_cache);
+    filter_cache_cookie = cookie;
+  }
+
+  result = g_hash_table_lookup (filter_cache, key);
+  if (result || g_hash_table_contains (filter_cache, key)) {
+    result = factory_list_copy (result);
+    g_mutex_unlock (&filter_cache_lock);
+    g_free (key);
+    return result;
+  }
+  g_mutex_unlock (&filter_cache_lock);
+
+  result = gst_element_factory_list_filter (factories, caps, direction,
+      subsetonly);
+
+  g_mutex_lock (&filter_cache_lock);
+  if (filter_cache_cookie == cookie) {
+    if (g_hash_table_size (filter_cache) >= FILTER_CACHE_MAX_ENTRIES)
+      g_hash_table_remove_all (filter_cache);
+    g_hash_table_replace (filter_cache, key, factory_list_copy (result));
+    key = NULL;
+  }
+  g_mutex_unlock (&filter_cache_lock);
+  g_free (key);
+
+  return result;
+}
@@ -4696,7 +4696,11 @@ deactivate_group (GstPlayBin3 * playbin, GstSourceGroup * group)
     REMOVE_SIGNAL (group->uridecodebin, group->source_setup_id);
     REMOVE_SIGNAL (group->uridecodebin, group->about_to_finish_id);
 
-    gst_element_set_state (group->uridecodebin, GST_STATE_NULL);
+    /* Only go back to READY, decodebin3 then keeps the decoders of this
+     * group around and reuses them when the group is activated again for a
+     * later item, instead of creating and setting up new ones. It is set to
+     * NULL when playbin3 goes to NULL. */
+    gst_element_set_state (group->uridecodebin, GST_STATE_READY);
     gst_bin_remove (GST_BIN_CAST (playbin), group->uridecodebin);
 
     REMOVE_SIGNAL (group->uridecodebin, group->pad_added_id);
@@ -50,6 +50,9 @@ gst_play_sink_audio_convert_add_conversion_elements (GstPlaySinkAudioConvert *
 
   g_assert (cbin->conversion_elements == NULL);
 
+  /* without volume, the elements only convert and can be bypassed */
+  cbin->can_bypass = !(self->use_volume && self->volume);
+
   GST_DEBUG_OBJECT (self,
       "Building audio conversion with use-converters %d, use-volume %d",
       self->use_converters, self->use_volume);
@@ -186,7 +186,7 @@ pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   GstPlaySinkConvertBin *self = user_data;
   GstPad *peer;
   GstCaps *caps;
-  gboolean raw;
+  gboolean raw, bypass;
 
   if (GST_IS_EVENT (info->data) && !GST_EVENT_IS_SERIALIZED (info->data)) {
     GST_DEBUG_OBJECT (self, "Letting non-serialized event %s pass",
@@ -205,17 +205,26 @@ pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   gst_object_unref (peer);
 
   raw = is_raw_caps (caps, self->audio);
-  GST_DEBUG_OBJECT (self, "Caps %" GST_PTR_FORMAT " are raw: %d", caps, raw);
+  bypass = raw && self->can_bypass
+      && gst_pad_peer_query_accept_caps (self->srcpad, caps);
+  GST_DEBUG_OBJECT (self, "Caps %" GST_PTR_FORMAT " are raw: %d, bypass: %d",
+      caps, raw, bypass);
   gst_caps_unref (caps);
 
-  if (raw == self->raw)
+  if (raw == self->raw && bypass == self->bypass)
     goto unblock;
   self->raw = raw;
+  self->bypass = bypass;
 
   gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->sinkpad), NULL);
   gst_ghost_pad_set_target (GST_GHOST_PAD_CAST (self->srcpad), NULL);
 
-  if (raw) {
+  if (bypass) {
+    GST_DEBUG_OBJECT (self, "Downstream accepts the raw caps, bypassing "
+        "conversion");
+
+    gst_play_sink_convert_bin_on_element_added (self->identity, self);
+  } else if (raw) {
     GST_DEBUG_OBJECT (self, "Switching to raw conversion pipeline");
 
     if (self->conversion_elements)
@@ -228,7 +237,7 @@ pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
     gst_play_sink_convert_bin_on_element_added (self->identity, self);
   }
 
-  gst_play_sink_convert_bin_set_targets (self, !raw);
+  gst_play_sink_convert_bin_set_targets (self, !raw || bypass);
 
 unblock:
   self->sink_proxypad_block_id = 0;
@@ -290,11 +299,10 @@ gst_play_sink_convert_bin_sink_setcaps (GstPlaySinkConvertBin * self,
   GstStructure *s;
   const gchar *name;
   gboolean reconfigure = FALSE;
-  gboolean raw;
+  gboolean raw, bypass = FALSE;
 
   GST_DEBUG_OBJECT (self, "Setting sink caps %" GST_PTR_FORMAT, caps);
 
-  GST_PLAY_SINK_CONVERT_BIN_LOCK (self);
   s = gst_caps_get_structure (caps, 0);
   name = gst_structure_get_name (s);
 
@@ -304,16 +312,27 @@ gst_play_sink_convert_bin_sink_setcaps (GstPlaySinkConvertBin * self,
     raw = g_str_equal (name, "video/x-raw");
   }
 
-  GST_DEBUG_OBJECT (self, "raw %d, self->raw %d, blocked %d",
-      raw, self->raw, gst_pad_is_blocked (self->sink_proxypad));
+  /* Only plug the converters if downstream can't take the caps as is */
+  if (raw && self->can_bypass)
+    bypass = gst_pad_peer_query_accept_caps (self->srcpad, caps);
+
+  GST_PLAY_SINK_CONVERT_BIN_LOCK (self);
+  GST_DEBUG_OBJECT (self, "raw %d, self->raw %d, bypass %d, self->bypass %d, "
+      "blocked %d", raw, self->raw, bypass, self->bypass,
+      gst_pad_is_blocked (self->sink_proxypad));
 
   if (raw) {
     if (!gst_pad_is_blocked (self->sink_proxypad)) {
       GstPad *target = gst_ghost_pad_get_target (GST_GHOST_PAD (self->sinkpad));
 
-      if (!self->raw || (target && !gst_pad_query_accept_caps (target, caps))) {
+      if (!self->raw || bypass != self->bypass || (target
+              && !gst_pad_query_accept_caps (target, caps))) {
         if (!self->raw)
           GST_DEBUG_OBJECT (self, "Changing caps from non-raw to raw");
+        else if (bypass)
+          GST_DEBUG_OBJECT (self, "Downstream accepts the caps as is now");
+        else if (self->bypass)
+          GST_DEBUG_OBJECT (self, "Changing caps to ones needing conversion");
         else
           GST_DEBUG_OBJECT (self, "Changing caps in an incompatible way");
 
@@ -611,6 +630,7 @@ gst_play_sink_convert_bin_change_state (GstElement * element,
       GST_PLAY_SINK_CONVERT_BIN_LOCK (self);
       gst_play_sink_convert_bin_set_targets (self, TRUE);
       self->raw = FALSE;
+      self->bypass = FALSE;
       GST_PLAY_SINK_CONVERT_BIN_UNLOCK (self);
       break;
     default:
@@ -626,6 +646,7 @@ gst_play_sink_convert_bin_change_state (GstElement * element,
       GST_PLAY_SINK_CONVERT_BIN_LOCK (self);
       gst_play_sink_convert_bin_set_targets (self, TRUE);
       self->raw = FALSE;
+      self->bypass = FALSE;
       GST_PLAY_SINK_CONVERT_BIN_UNLOCK (self);
       break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
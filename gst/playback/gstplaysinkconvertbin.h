@@ -70,6 +70,7 @@ struct _GstPlaySinkConvertBin
   GstPad *srcpad;
 
   gboolean raw;
+  gboolean bypass;              /* raw caps going through identity */
   GList *conversion_elements;
   GstElement *identity;
 
@@ -77,6 +78,9 @@ struct _GstPlaySinkConvertBin
 
   /* configuration for derived classes */
   gboolean audio;
+  gboolean can_bypass;          /* conversion elements only convert formats
+                                   and can be skipped when downstream accepts
+                                   the caps as they are */
 };
 
 struct _GstPlaySinkConvertBinClass
@@ -50,6 +50,9 @@ gst_play_sink_video_convert_add_conversion_elements (GstPlaySinkVideoConvert *
 
   g_assert (cbin->conversion_elements == NULL);
 
+  /* without videobalance, the elements only convert and can be bypassed */
+  cbin->can_bypass = !(self->use_balance && self->balance);
+
   GST_DEBUG_OBJECT (self,
       "Building video conversion with use-converters %d, use-balance %d",
       self->use_converters, self->use_balance);
@@ -319,6 +319,23 @@ out:
   return ret;
 }
 
+/* must be called with the STREAM_SYNCHRONIZER_LOCK */
+static void
+gst_stream_synchronizer_update_eos_waiting (GstStreamSynchronizer * self)
+{
+  GList *l;
+  gint n_eos_waiting = 0;
+
+  for (l = self->streams; l; l = l->next) {
+    GstSyncStream *ostream = l->data;
+
+    if (ostream->is_eos && !ostream->eos_sent)
+      n_eos_waiting++;
+  }
+
+  g_atomic_int_set (&self->n_eos_waiting, n_eos_waiting);
+}
+
 /* must be called with the STREAM_SYNCHRONIZER_LOCK */
 static gboolean
 gst_stream_synchronizer_wait (GstStreamSynchronizer * self, GstPad * pad)
@@ -412,6 +429,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
               && stream->stream_start_seqnum != seqnum)) {
         stream->is_eos = FALSE;
         stream->eos_sent = FALSE;
+        gst_stream_synchronizer_update_eos_waiting (self);
         stream->flushing = FALSE;
         stream->stream_start_seqnum = seqnum;
         stream->group_id = group_id;
@@ -603,6 +621,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
 
       stream->is_eos = FALSE;
       stream->eos_sent = FALSE;
+      gst_stream_synchronizer_update_eos_waiting (self);
       stream->flushing = FALSE;
       stream->wait = FALSE;
       g_cond_broadcast (&stream->stream_finish_cond);
@@ -649,6 +668,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         stream = gst_streamsync_pad_get_stream (pad);
         stream->is_eos = FALSE;
         stream->eos_sent = FALSE;
+        gst_stream_synchronizer_update_eos_waiting (self);
         stream->wait = FALSE;
         g_cond_broadcast (&stream->stream_finish_cond);
         gst_syncstream_unref (stream);
@@ -671,6 +691,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
 
       GST_DEBUG_OBJECT (pad, "Have EOS for stream %d", stream->stream_number);
       stream->is_eos = TRUE;
+      gst_stream_synchronizer_update_eos_waiting (self);
 
       seen_data = stream->seen_data;
       srcpad = gst_object_ref (stream->srcpad);
@@ -745,6 +766,7 @@ gst_stream_synchronizer_sink_event (GstPad * pad, GstObject * parent,
         GST_STREAM_SYNCHRONIZER_LOCK (self);
         stream = gst_streamsync_pad_get_stream (pad);
         stream->eos_sent = TRUE;
+        gst_stream_synchronizer_update_eos_waiting (self);
         gst_syncstream_unref (stream);
       }
 
@@ -791,7 +813,10 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       && GST_CLOCK_TIME_IS_VALID (duration))
     timestamp_end = timestamp + duration;
 
-  GST_STREAM_SYNCHRONIZER_LOCK (self);
+  /* The segment of a stream is only changed from its own streaming thread,
+   * which is the one running here, so updating the position doesn't need
+   * the global lock. Streams that are EOS don't chain and are the only ones
+   * whose position other threads modify. */
   stream = gst_streamsync_pad_get_stream (pad);
 
   stream->seen_data = TRUE;
@@ -806,9 +831,6 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       stream->segment.position = timestamp_end;
   }
 
-  gst_syncstream_unref (stream);
-  GST_STREAM_SYNCHRONIZER_UNLOCK (self);
-
   opad = gst_stream_get_other_pad_from_pad (self, pad);
   if (opad) {
     ret = gst_pad_push (opad, buffer);
@@ -819,8 +841,6 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
   if (ret == GST_FLOW_OK) {
     GList *l;
 
-    GST_STREAM_SYNCHRONIZER_LOCK (self);
-    stream = gst_streamsync_pad_get_stream (pad);
     if (stream->segment.format == GST_FORMAT_TIME) {
       GstClockTime position;
 
@@ -837,6 +857,10 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       }
     }
 
+    /* Only take the lock when there are EOS streams to advance */
+    if (g_atomic_int_get (&self->n_eos_waiting) == 0)
+      goto done;
+
     /* Advance EOS streams if necessary. For non-EOS
      * streams the demuxers should already do this! */
     if (!GST_CLOCK_TIME_IS_VALID (timestamp_end) &&
@@ -844,6 +868,7 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
       timestamp_end = timestamp + GST_SECOND;
     }
 
+    GST_STREAM_SYNCHRONIZER_LOCK (self);
     for (l = self->streams; l; l = l->next) {
       GstSyncStream *ostream = l->data;
       gint64 position;
@@ -876,10 +901,12 @@ gst_stream_synchronizer_sink_chain (GstPad * pad, GstObject * parent,
         g_cond_broadcast (&ostream->stream_finish_cond);
       }
     }
-    gst_syncstream_unref (stream);
     GST_STREAM_SYNCHRONIZER_UNLOCK (self);
   }
 
+done:
+  gst_syncstream_unref (stream);
+
   return ret;
 }
 
@@ -1003,6 +1030,7 @@ gst_stream_synchronizer_release_stream (GstStreamSynchronizer * self,
     }
   }
   g_assert (l != NULL);
+  gst_stream_synchronizer_update_eos_waiting (self);
   if (self->streams == NULL) {
     self->have_group_id = TRUE;
     self->group_id = G_MAXUINT;
@@ -1135,6 +1163,7 @@ gst_stream_synchronizer_change_state (GstElement * element,
         stream->flushing = FALSE;
         stream->send_gap_event = FALSE;
       }
+      gst_stream_synchronizer_update_eos_waiting (self);
       GST_STREAM_SYNCHRONIZER_UNLOCK (self);
       break;
     }
@@ -52,6 +52,7 @@ struct _GstStreamSynchronizer
 
   GList *streams;
   guint current_stream_number;
+  gint n_eos_waiting;           /* atomic, EOS streams that didn't send EOS */
 
   GstClockTime group_start_time;
 
@@ -173,6 +173,20 @@ pad_supports_caps (GstPad * pad, GstCaps * caps)
   return ret;
 }
 
+typedef struct
+{
+  GstCaps *caps;
+  GList *factories;
+} FactoriesForCaps;
+
+static void
+factories_for_caps_free (FactoriesForCaps * entry)
+{
+  gst_caps_unref (entry->caps);
+  gst_plugin_feature_list_free (entry->factories);
+  g_slice_free (FactoriesForCaps, entry);
+}
+
 static void
 gst_subtitle_overlay_finalize (GObject * object)
 {
@@ -185,6 +199,9 @@ gst_subtitle_overlay_finalize (GObject * object)
     gst_plugin_feature_list_free (self->factories);
   self->factories = NULL;
   gst_caps_replace (&self->factory_caps, NULL);
+  g_list_free_full (self->factories_for_caps,
+      (GDestroyNotify) factories_for_caps_free);
+  self->factories_for_caps = NULL;
 
   if (self->font_desc) {
     g_free (self->font_desc);
@@ -407,6 +424,9 @@ gst_subtitle_overlay_update_factory_list (GstSubtitleOverlay * self)
       gst_plugin_feature_list_free (self->factories);
     self->factories = factories;
     self->factories_cookie = cookie;
+    g_list_free_full (self->factories_for_caps,
+        (GDestroyNotify) factories_for_caps_free);
+    self->factories_for_caps = NULL;
   }
 
   return (self->factories != NULL);
@@ -482,6 +502,40 @@ gst_subtitle_overlay_get_factories_for_caps (const GList * list,
   return result;
 }
 
+/* Call with factories_lock! Looks up the factories for @caps in
+ * self->factories, caching the result until the factory list changes.
+ * Free the result with gst_plugin_feature_list_free() */
+static GList *
+gst_subtitle_overlay_get_cached_factories_for_caps (GstSubtitleOverlay * self,
+    GstCaps * caps)
+{
+  FactoriesForCaps *entry = NULL;
+  GList *walk;
+
+  for (walk = self->factories_for_caps; walk; walk = walk->next) {
+    FactoriesForCaps *tmp = walk->data;
+
+    if (gst_caps_is_strictly_equal (tmp->caps, caps)) {
+      entry = tmp;
+      break;
+    }
+  }
+
+  if (entry) {
+    GST_DEBUG_OBJECT (self, "Using cached factories for caps %" GST_PTR_FORMAT,
+        caps);
+  } else {
+    entry = g_slice_new (FactoriesForCaps);
+    entry->caps = gst_caps_ref (caps);
+    entry->factories =
+        gst_subtitle_overlay_get_factories_for_caps (self->factories, caps);
+    self->factories_for_caps =
+        g_list_prepend (self->factories_for_caps, entry);
+  }
+
+  return gst_plugin_feature_list_copy (entry->factories);
+}
+
 static gint
 _sort_by_ranks (GstPluginFeature * f1, GstPluginFeature * f2)
 {
@@ -1133,7 +1187,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
   gst_subtitle_overlay_update_factory_list (self);
   if (subcaps) {
     factories =
-        gst_subtitle_overlay_get_factories_for_caps (self->factories, subcaps);
+        gst_subtitle_overlay_get_cached_factories_for_caps (self, subcaps);
     if (!factories) {
       GstMessage *msg;
 
@@ -1207,7 +1261,7 @@ _pad_blocked_cb (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
       GST_DEBUG_OBJECT (self,
           "Searching overlay factories for caps %" GST_PTR_FORMAT, parser_caps);
       overlay_factories =
-          gst_subtitle_overlay_get_factories_for_caps (self->factories,
+          gst_subtitle_overlay_get_cached_factories_for_caps (self,
           parser_caps);
       g_mutex_unlock (&self->factories_lock);
 
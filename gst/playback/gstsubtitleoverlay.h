@@ -88,6 +88,8 @@ struct _GstSubtitleOverlay
   GList *factories;
   guint32 factories_cookie;
   GstCaps *factory_caps;
+  /* FactoriesForCaps of previous lookups in factories */
+  GList *factories_for_caps;
 
   GMutex lock;
   GstCaps *subcaps;
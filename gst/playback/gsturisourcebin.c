@@ -156,12 +156,19 @@ struct _GstURISourceBin
 
   guint64 ring_buffer_max_size; /* 0 means disabled */
 
+  GStrv standby_uris;           /* URIs to keep sources prepared for */
+  GHashTable *standby_sources;  /* uri -> prepared source in READY, protected
+                                   by the object lock */
+
   GList *pending_pads;          /* Pads we have blocked pending assignment
                                    to an output source pad */
   GList *inactive_output_pads;  /* output pads that were unghosted */
 
   GList *buffering_status;      /* element currently buffering messages */
   gint last_buffering_pct;      /* Avoid sending buffering over and over */
+  gboolean adaptive_buffering;
+  guint64 adaptive_duration;    /* current target buffer duration (ns) */
+  guint rebuffer_count;         /* underruns since the last READY */
   GMutex buffering_lock;
   GMutex buffering_post_lock;
 };
@@ -208,6 +215,7 @@ enum
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_LOW_WATERMARK       0.01
 #define DEFAULT_HIGH_WATERMARK      0.99
+#define DEFAULT_ADAPTIVE_BUFFERING  FALSE
 
 #define ACTUAL_DEFAULT_BUFFER_SIZE  10 * 1024 * 1024    /* The value used for byte limits when buffer-size == -1 */
 #define ACTUAL_DEFAULT_BUFFER_DURATION  5 * GST_SECOND  /* The value used for time limits when buffer-duration == -1 */
@@ -215,6 +223,9 @@ enum
 #define GET_BUFFER_SIZE(u) ((u)->buffer_size == -1 ? ACTUAL_DEFAULT_BUFFER_SIZE : (u)->buffer_size)
 #define GET_BUFFER_DURATION(u) ((u)->buffer_duration == -1 ? ACTUAL_DEFAULT_BUFFER_DURATION : (u)->buffer_duration)
 
+#define ADAPTIVE_MIN_BUFFER_DURATION  (500 * GST_MSECOND)    /* Initial target with adaptive-buffering */
+#define ADAPTIVE_MIN_BUFFER_SIZE      (64 * 1024)    /* Lower bound of the byte limit derived from the bitrate */
+
 #define DEFAULT_CAPS (gst_static_caps_get (&default_raw_caps))
 enum
 {
@@ -230,6 +241,8 @@ enum
   PROP_LOW_WATERMARK,
   PROP_HIGH_WATERMARK,
   PROP_STATISTICS,
+  PROP_STANDBY_URIS,
+  PROP_ADAPTIVE_BUFFERING,
 };
 
 #define CUSTOM_EOS_QUARK _custom_eos_quark_get ()
@@ -280,6 +293,8 @@ static GstPad *create_output_pad (GstURISourceBin * urisrc, GstPad * pad);
 static void remove_buffering_msgs (GstURISourceBin * bin, GstObject * src);
 
 static void update_queue_values (GstURISourceBin * urisrc);
+static void update_standby_sources (GstURISourceBin * urisrc);
+static void clear_standby_sources (GstURISourceBin * urisrc);
 static GstStructure *get_queue_statistics (GstURISourceBin * urisrc);
 
 static void
@@ -405,6 +420,44 @@ gst_uri_source_bin_class_init (GstURISourceBinClass * klass)
           "this element", GST_TYPE_STRUCTURE,
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstURISourceBin:standby-uris:
+   *
+   * URIs that are likely to be set on #GstURISourceBin:uri next, such as
+   * the neighbouring channels of a live TV service. While the element is at
+   * least in READY, a source element is created and brought to READY for
+   * each of them, so that switching to one of these URIs reuses the
+   * prepared source instead of looking up, loading and opening a new one.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STANDBY_URIS,
+      g_param_spec_boxed ("standby-uris", "Standby URIs",
+          "URIs to prepare source elements for ahead of time", G_TYPE_STRV,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstURISourceBin:adaptive-buffering:
+   *
+   * Start with a small buffer target and only grow it when the buffering
+   * queues underrun. The target duration starts at 500ms and doubles after
+   * every rebuffering, up to #GstURISourceBin:buffer-duration. When the
+   * bitrate of the streams is known, the byte limits follow the target
+   * duration instead of #GstURISourceBin:buffer-size, which stays the upper
+   * bound.
+   *
+   * Every time the limits are recalculated, an element message called
+   * "adaptive-buffering" is posted with the "buffer-duration" (guint64),
+   * "bitrate" (guint64, 0 if unknown) and "rebuffer-count" (guint) fields.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_ADAPTIVE_BUFFERING,
+      g_param_spec_boolean ("adaptive-buffering", "Adaptive Buffering",
+          "Start with a minimal buffer and grow it on rebuffering",
+          DEFAULT_ADAPTIVE_BUFFERING,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstURISourceBin::drained:
    *
@@ -480,6 +533,11 @@ gst_uri_source_bin_init (GstURISourceBin * urisrc)
   urisrc->last_buffering_pct = -1;
   urisrc->low_watermark = DEFAULT_LOW_WATERMARK;
   urisrc->high_watermark = DEFAULT_HIGH_WATERMARK;
+  urisrc->adaptive_buffering = DEFAULT_ADAPTIVE_BUFFERING;
+  urisrc->adaptive_duration = ADAPTIVE_MIN_BUFFER_DURATION;
+
+  urisrc->standby_sources = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, gst_object_unref);
 
   GST_OBJECT_FLAG_SET (urisrc,
       GST_ELEMENT_FLAG_SOURCE | GST_BIN_FLAG_STREAMS_AWARE);
@@ -498,6 +556,9 @@ gst_uri_source_bin_finalize (GObject * obj)
   g_mutex_clear (&urisrc->buffering_lock);
   g_mutex_clear (&urisrc->buffering_post_lock);
   g_free (urisrc->uri);
+  clear_standby_sources (urisrc);
+  g_hash_table_unref (urisrc->standby_sources);
+  g_strfreev (urisrc->standby_uris);
   if (urisrc->factories)
     gst_plugin_feature_list_free (urisrc->factories);
 
@@ -547,6 +608,23 @@ gst_uri_source_bin_set_property (GObject * object, guint prop_id,
       urisrc->high_watermark = g_value_get_double (value);
       update_queue_values (urisrc);
       break;
+    case PROP_ADAPTIVE_BUFFERING:
+      urisrc->adaptive_buffering = g_value_get_boolean (value);
+      update_queue_values (urisrc);
+      break;
+    case PROP_STANDBY_URIS:{
+      gboolean prepare;
+
+      GST_OBJECT_LOCK (urisrc);
+      g_strfreev (urisrc->standby_uris);
+      urisrc->standby_uris = g_value_dup_boxed (value);
+      prepare = GST_STATE (urisrc) >= GST_STATE_READY;
+      GST_OBJECT_UNLOCK (urisrc);
+
+      if (prepare)
+        update_standby_sources (urisrc);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -603,6 +681,14 @@ gst_uri_source_bin_get_property (GObject * object, guint prop_id,
     case PROP_STATISTICS:
       g_value_take_boxed (value, get_queue_statistics (urisrc));
       break;
+    case PROP_ADAPTIVE_BUFFERING:
+      g_value_set_boolean (value, urisrc->adaptive_buffering);
+      break;
+    case PROP_STANDBY_URIS:
+      GST_OBJECT_LOCK (urisrc);
+      g_value_set_boxed (value, urisrc->standby_uris);
+      GST_OBJECT_UNLOCK (urisrc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -969,10 +1055,21 @@ update_queue_values (GstURISourceBin * urisrc)
   guint buffer_size;
   gdouble low_watermark, high_watermark;
   guint64 cumulative_bitrate = 0;
+  gboolean adaptive;
+  guint rebuffer_count;
   GSList *cur;
 
+  BUFFERING_LOCK (urisrc);
+  adaptive = urisrc->adaptive_buffering;
+  duration = urisrc->adaptive_duration;
+  rebuffer_count = urisrc->rebuffer_count;
+  BUFFERING_UNLOCK (urisrc);
+
   GST_URI_SOURCE_BIN_LOCK (urisrc);
-  duration = GET_BUFFER_DURATION (urisrc);
+  if (adaptive)
+    duration = MIN (duration, GET_BUFFER_DURATION (urisrc));
+  else
+    duration = GET_BUFFER_DURATION (urisrc);
   buffer_size = GET_BUFFER_SIZE (urisrc);
   low_watermark = urisrc->low_watermark;
   high_watermark = urisrc->high_watermark;
@@ -996,6 +1093,15 @@ update_queue_values (GstURISourceBin * urisrc)
     }
   }
 
+  /* size the queues for the target duration at the measured bitrate */
+  if (adaptive && cumulative_bitrate > 0) {
+    guint64 size = gst_util_uint64_scale (cumulative_bitrate, duration,
+        8 * GST_SECOND);
+
+    buffer_size = CLAMP (size, MIN (ADAPTIVE_MIN_BUFFER_SIZE, buffer_size),
+        buffer_size);
+  }
+
   GST_DEBUG_OBJECT (urisrc, "recalculating queue limits with cumulative "
       "bitrate %" G_GUINT64_FORMAT ", buffer size %u, buffer duration %"
       G_GINT64_FORMAT, cumulative_bitrate, buffer_size, duration);
@@ -1028,6 +1134,15 @@ update_queue_values (GstURISourceBin * urisrc)
         "high-watermark", high_watermark, NULL);
   }
   GST_URI_SOURCE_BIN_UNLOCK (urisrc);
+
+  if (adaptive) {
+    gst_element_post_message (GST_ELEMENT_CAST (urisrc),
+        gst_message_new_element (GST_OBJECT_CAST (urisrc),
+            gst_structure_new ("adaptive-buffering",
+                "buffer-duration", G_TYPE_UINT64, (guint64) duration,
+                "bitrate", G_TYPE_UINT64, cumulative_bitrate,
+                "rebuffer-count", G_TYPE_UINT, rebuffer_count, NULL)));
+  }
 }
 
 static void
@@ -1049,6 +1164,7 @@ get_output_slot (GstURISourceBin * urisrc, gboolean do_download,
   GstPad *srcpad;
   GstElement *queue;
   const gchar *elem_name;
+  guint64 duration;
 
   /* If we have caps, iterate the existing slots and look for an
    * unlinked one that can be used */
@@ -1137,8 +1253,13 @@ get_output_slot (GstURISourceBin * urisrc, gboolean do_download,
   }
 
   /* set the necessary limits on the queue-like elements */
+  duration = GET_BUFFER_DURATION (urisrc);
+  BUFFERING_LOCK (urisrc);
+  if (urisrc->adaptive_buffering)
+    duration = MIN (duration, urisrc->adaptive_duration);
+  BUFFERING_UNLOCK (urisrc);
   g_object_set (queue, "max-size-bytes", GET_BUFFER_SIZE (urisrc),
-      "max-size-time", (guint64) GET_BUFFER_DURATION (urisrc), NULL);
+      "max-size-time", duration, NULL);
 #if 0
   /* Disabled because this makes initial startup slower for radio streams */
   else {
@@ -1398,6 +1519,119 @@ static const gchar *adaptive_media[] = {
 #define IS_BLACKLISTED_URI(uri)     (array_has_uri_value (blacklisted_uris, uri))
 #define IS_ADAPTIVE_MEDIA(media)    (array_has_value (adaptive_media, media))
 
+static void
+release_standby_source (GstElement * source)
+{
+  gst_element_set_state (source, GST_STATE_NULL);
+  gst_object_unref (source);
+}
+
+/* Prepare a source in READY for each of the standby URIs and release the
+ * ones that are no longer wanted */
+static void
+update_standby_sources (GstURISourceBin * urisrc)
+{
+  GHashTableIter iter;
+  gpointer key, value;
+  GList *stale = NULL;
+  gchar **uris;
+  guint i;
+
+  GST_OBJECT_LOCK (urisrc);
+  g_hash_table_iter_init (&iter, urisrc->standby_sources);
+  while (g_hash_table_iter_next (&iter, &key, &value)) {
+    if (urisrc->standby_uris == NULL ||
+        !g_strv_contains ((const gchar * const *) urisrc->standby_uris, key)) {
+      stale = g_list_prepend (stale, value);
+      g_hash_table_iter_steal (&iter);
+      g_free (key);
+    }
+  }
+  uris = g_strdupv (urisrc->standby_uris);
+  GST_OBJECT_UNLOCK (urisrc);
+
+  g_list_free_full (stale, (GDestroyNotify) release_standby_source);
+
+  for (i = 0; uris && uris[i]; i++) {
+    GstElement *source;
+    gboolean known;
+
+    GST_OBJECT_LOCK (urisrc);
+    known = g_hash_table_contains (urisrc->standby_sources, uris[i]);
+    GST_OBJECT_UNLOCK (urisrc);
+    if (known)
+      continue;
+
+    if (!gst_uri_is_valid (uris[i]) || IS_BLACKLISTED_URI (uris[i]))
+      continue;
+
+    source = gst_element_make_from_uri (GST_URI_SRC, uris[i], "source", NULL);
+    if (source == NULL) {
+      GST_DEBUG_OBJECT (urisrc, "no source for standby uri %s", uris[i]);
+      continue;
+    }
+    gst_object_ref_sink (source);
+
+    if (gst_element_set_state (source,
+            GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+      GST_DEBUG_OBJECT (urisrc, "could not prepare source for %s", uris[i]);
+      release_standby_source (source);
+      continue;
+    }
+
+    GST_OBJECT_LOCK (urisrc);
+    known = g_hash_table_contains (urisrc->standby_sources, uris[i]);
+    if (!known)
+      g_hash_table_insert (urisrc->standby_sources, g_strdup (uris[i]),
+          source);
+    GST_OBJECT_UNLOCK (urisrc);
+
+    if (known)
+      release_standby_source (source);
+    else
+      GST_DEBUG_OBJECT (urisrc, "prepared %" GST_PTR_FORMAT " for %s", source,
+          uris[i]);
+  }
+  g_strfreev (uris);
+}
+
+static void
+clear_standby_sources (GstURISourceBin * urisrc)
+{
+  GHashTableIter iter;
+  gpointer value;
+  GList *sources = NULL;
+
+  GST_OBJECT_LOCK (urisrc);
+  g_hash_table_iter_init (&iter, urisrc->standby_sources);
+  while (g_hash_table_iter_next (&iter, NULL, &value)) {
+    sources = g_list_prepend (sources, gst_object_ref (value));
+    g_hash_table_iter_remove (&iter);
+  }
+  GST_OBJECT_UNLOCK (urisrc);
+
+  g_list_free_full (sources, (GDestroyNotify) release_standby_source);
+}
+
+/* Take the prepared source for @uri, if any */
+static GstElement *
+take_standby_source (GstURISourceBin * urisrc, const gchar * uri)
+{
+  GstElement *source = NULL;
+  gpointer key, value;
+
+  GST_OBJECT_LOCK (urisrc);
+  if (g_hash_table_lookup_extended (urisrc->standby_sources, uri, &key,
+          &value)) {
+    g_hash_table_steal (urisrc->standby_sources, uri);
+    g_free (key);
+    source = value;
+  }
+  GST_OBJECT_UNLOCK (urisrc);
+
+  return source;
+}
+
 /*
  * Generate and configure a source element.
  */
@@ -1422,9 +1656,15 @@ gen_source_element (GstURISourceBin * urisrc)
   if (IS_BLACKLISTED_URI (urisrc->uri))
     goto uri_blacklisted;
 
-  source = gst_element_make_from_uri (GST_URI_SRC, urisrc->uri, "source", &err);
-  if (!source)
-    goto no_source;
+  source = take_standby_source (urisrc, urisrc->uri);
+  if (source) {
+    GST_DEBUG_OBJECT (urisrc, "using prepared source for %s", urisrc->uri);
+  } else {
+    source = gst_element_make_from_uri (GST_URI_SRC, urisrc->uri, "source",
+        &err);
+    if (!source)
+      goto no_source;
+  }
 
   GST_LOG_OBJECT (urisrc, "found source type %s", G_OBJECT_TYPE_NAME (source));
 
@@ -2334,6 +2574,7 @@ handle_buffering_message (GstURISourceBin * urisrc, GstMessage * msg)
   GList *found = NULL;
   GList *iter;
   OutputSlotInfo *slot;
+  gboolean rebuffered = FALSE;
 
   /* buffering messages must be aggregated as there might be multiple
    * multiqueue in the pipeline and their independent buffering messages
@@ -2425,6 +2666,18 @@ handle_buffering_message (GstURISourceBin * urisrc, GstMessage * msg)
         g_list_prepend (urisrc->buffering_status, gst_message_ref (msg));
   }
 
+  /* Queues that had finished buffering ran dry again: grow the target */
+  if (urisrc->adaptive_buffering && urisrc->last_buffering_pct == 100
+      && smaller_perc < 100) {
+    urisrc->rebuffer_count++;
+    urisrc->adaptive_duration = MIN (urisrc->adaptive_duration * 2,
+        (guint64) GET_BUFFER_DURATION (urisrc));
+    rebuffered = TRUE;
+    GST_DEBUG_OBJECT (urisrc, "rebuffering #%u, target duration now %"
+        GST_TIME_FORMAT, urisrc->rebuffer_count,
+        GST_TIME_ARGS (urisrc->adaptive_duration));
+  }
+
   if (smaller_perc == urisrc->last_buffering_pct) {
     /* Don't repeat our last buffering status */
     gst_message_replace (&msg, NULL);
@@ -2441,6 +2694,10 @@ handle_buffering_message (GstURISourceBin * urisrc, GstMessage * msg)
   }
   BUFFERING_UNLOCK (urisrc);
 
+  if (rebuffered)
+    gst_element_call_async (GST_ELEMENT (urisrc),
+        (GstElementCallAsyncFunc) update_queue_values, NULL, NULL);
+
   if (msg) {
     GST_LOG_OBJECT (urisrc, "Sending buffering msg from %" GST_PTR_FORMAT
         " with %d%%", GST_MESSAGE_SRC (msg), smaller_perc);
@@ -2808,6 +3065,9 @@ gst_uri_source_bin_change_state (GstElement * element,
   GstURISourceBin *urisrc = GST_URI_SOURCE_BIN (element);
 
   switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      update_standby_sources (urisrc);
+      break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:
       GST_DEBUG ("ready to paused");
       if (!setup_source (urisrc))
@@ -2832,11 +3092,14 @@ gst_uri_source_bin_change_state (GstElement * element,
           (GDestroyNotify) gst_message_unref);
       urisrc->buffering_status = NULL;
       urisrc->last_buffering_pct = -1;
+      urisrc->adaptive_duration = ADAPTIVE_MIN_BUFFER_DURATION;
+      urisrc->rebuffer_count = 0;
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       GST_DEBUG ("ready to null");
       remove_demuxer (urisrc);
       remove_source (urisrc);
+      clear_standby_sources (urisrc);
       break;
     default:
       break;
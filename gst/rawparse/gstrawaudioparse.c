@@ -91,7 +91,8 @@ enum
   PROP_SAMPLE_RATE,
   PROP_NUM_CHANNELS,
   PROP_INTERLEAVED,
-  PROP_CHANNEL_POSITIONS
+  PROP_CHANNEL_POSITIONS,
+  PROP_FRAMES_PER_BUFFER
 };
 
 #define DEFAULT_FORMAT         GST_RAW_AUDIO_PARSE_FORMAT_PCM
@@ -99,6 +100,7 @@ enum
 #define DEFAULT_SAMPLE_RATE    44100
 #define DEFAULT_NUM_CHANNELS   2
 #define DEFAULT_INTERLEAVED    TRUE
+#define DEFAULT_FRAMES_PER_BUFFER 0
 
 #define GST_RAW_AUDIO_PARSE_CAPS \
   GST_AUDIO_CAPS_MAKE(GST_AUDIO_FORMATS_ALL) \
@@ -140,6 +142,8 @@ static gboolean gst_raw_audio_parse_get_caps_from_config (GstRawBaseParse *
     raw_base_parse, GstRawBaseParseConfig config, GstCaps ** caps);
 static gsize gst_raw_audio_parse_get_config_frame_size (GstRawBaseParse *
     raw_base_parse, GstRawBaseParseConfig config);
+static guint gst_raw_audio_parse_get_max_frames_per_buffer (GstRawBaseParse *
+    raw_base_parse, GstRawBaseParseConfig config);
 static gboolean gst_raw_audio_parse_is_config_ready (GstRawBaseParse *
     raw_base_parse, GstRawBaseParseConfig config);
 static gboolean gst_raw_audio_parse_process (GstRawBaseParse * raw_base_parse,
@@ -210,6 +214,8 @@ gst_raw_audio_parse_class_init (GstRawAudioParseClass * klass)
       GST_DEBUG_FUNCPTR (gst_raw_audio_parse_get_caps_from_config);
   rawbaseparse_class->get_config_frame_size =
       GST_DEBUG_FUNCPTR (gst_raw_audio_parse_get_config_frame_size);
+  rawbaseparse_class->get_max_frames_per_buffer =
+      GST_DEBUG_FUNCPTR (gst_raw_audio_parse_get_max_frames_per_buffer);
   rawbaseparse_class->is_config_ready =
       GST_DEBUG_FUNCPTR (gst_raw_audio_parse_is_config_ready);
   rawbaseparse_class->process = GST_DEBUG_FUNCPTR (gst_raw_audio_parse_process);
@@ -274,6 +280,24 @@ gst_raw_audio_parse_class_init (GstRawAudioParseClass * klass)
               G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS),
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
+  /**
+   * GstRawAudioParse:frames-per-buffer:
+   *
+   * Number of frames in each output buffer. The parser waits until that
+   * many frames are available, so the output has a fixed duration except
+   * for the last buffer when draining. 0 outputs as many complete frames
+   * as are available.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class,
+      PROP_FRAMES_PER_BUFFER,
+      g_param_spec_uint ("frames-per-buffer",
+          "Frames per buffer",
+          "Number of frames in each output buffer (0 = as many as available)",
+          0, G_MAXUINT,
+          DEFAULT_FRAMES_PER_BUFFER, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
 
   gst_element_class_set_static_metadata (element_class,
       "rawaudioparse",
@@ -292,6 +316,8 @@ gst_raw_audio_parse_init (GstRawAudioParse * raw_audio_parse)
    * is initially set to be the properties config */
   raw_audio_parse->current_config = &(raw_audio_parse->properties_config);
 
+  raw_audio_parse->frames_per_buffer = DEFAULT_FRAMES_PER_BUFFER;
+
   /* Properties config must be valid from the start, so set its ready value
    * to TRUE, and make sure its bpf value is valid. */
   raw_audio_parse->properties_config.ready = TRUE;
@@ -302,7 +328,6 @@ static void
 gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
     GValue const *value, GParamSpec * pspec)
 {
-  GstBaseParse *base_parse = GST_BASE_PARSE (object);
   GstRawBaseParse *raw_base_parse = GST_RAW_BASE_PARSE (object);
   GstRawAudioParse *raw_audio_parse = GST_RAW_AUDIO_PARSE (object);
 
@@ -313,9 +338,9 @@ gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
    *   invalidated to ensure that the code in handle_frame pushes a new CAPS
    *   event out
    * - properties that affect the bpf value call the function to update
-   *   the bpf and also call gst_base_parse_set_min_frame_size() to ensure
-   *   that the minimum frame size can hold 1 frame (= one sample for each
-   *   channel)
+   *   the bpf and also call gst_raw_base_parse_update_min_frame_size() to
+   *   ensure that the minimum frame size can hold 1 frame (= one sample for
+   *   each channel), or frames-per-buffer frames if that is set
    */
 
   switch (prop_id) {
@@ -332,8 +357,7 @@ gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
 
         if (!gst_raw_audio_parse_is_using_sink_caps (raw_audio_parse)) {
           gst_raw_base_parse_invalidate_src_caps (raw_base_parse);
-          gst_base_parse_set_min_frame_size (base_parse,
-              raw_audio_parse->properties_config.bpf);
+          gst_raw_base_parse_update_min_frame_size (raw_base_parse);
         }
       }
 
@@ -354,8 +378,7 @@ gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
 
         if (!gst_raw_audio_parse_is_using_sink_caps (raw_audio_parse)) {
           gst_raw_base_parse_invalidate_src_caps (raw_base_parse);
-          gst_base_parse_set_min_frame_size (base_parse,
-              raw_audio_parse->properties_config.bpf);
+          gst_raw_base_parse_update_min_frame_size (raw_base_parse);
         }
       }
 
@@ -396,8 +419,7 @@ gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
 
         if (!gst_raw_audio_parse_is_using_sink_caps (raw_audio_parse)) {
           gst_raw_base_parse_invalidate_src_caps (raw_base_parse);
-          gst_base_parse_set_min_frame_size (base_parse,
-              raw_audio_parse->properties_config.bpf);
+          gst_raw_base_parse_update_min_frame_size (raw_base_parse);
         }
       }
 
@@ -477,14 +499,28 @@ gst_raw_audio_parse_set_property (GObject * object, guint prop_id,
 
       if (!gst_raw_audio_parse_is_using_sink_caps (raw_audio_parse)) {
         gst_raw_base_parse_invalidate_src_caps (raw_base_parse);
-        gst_base_parse_set_min_frame_size (base_parse,
-            raw_audio_parse->properties_config.bpf);
+        gst_raw_base_parse_update_min_frame_size (raw_base_parse);
       }
 
       GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
       break;
     }
 
+    case PROP_FRAMES_PER_BUFFER:
+    {
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_LOCK (object);
+
+      raw_audio_parse->frames_per_buffer = g_value_get_uint (value);
+
+      /* This applies to both configs, so update the minimum frame size
+       * for whichever one is current, as long as it can be used */
+      if (raw_audio_parse->current_config->ready)
+        gst_raw_base_parse_update_min_frame_size (raw_base_parse);
+
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
+      break;
+    }
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -565,6 +601,12 @@ gst_raw_audio_parse_get_property (GObject * object, guint prop_id,
       break;
     }
 
+    case PROP_FRAMES_PER_BUFFER:
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_LOCK (object);
+      g_value_set_uint (value, raw_audio_parse->frames_per_buffer);
+      GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (object);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -642,6 +684,15 @@ gst_raw_audio_parse_get_config_frame_size (GstRawBaseParse * raw_base_parse,
   return gst_raw_audio_parse_get_config_ptr (raw_audio_parse, config)->bpf;
 }
 
+static guint
+gst_raw_audio_parse_get_max_frames_per_buffer (GstRawBaseParse *
+    raw_base_parse, G_GNUC_UNUSED GstRawBaseParseConfig config)
+{
+  GstRawAudioParse *raw_audio_parse = GST_RAW_AUDIO_PARSE (raw_base_parse);
+  return raw_audio_parse->frames_per_buffer ? raw_audio_parse->
+      frames_per_buffer : G_MAXUINT;
+}
+
 static gboolean
 gst_raw_audio_parse_is_config_ready (GstRawBaseParse * raw_base_parse,
     GstRawBaseParseConfig config)
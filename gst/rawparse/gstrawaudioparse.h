@@ -109,6 +109,10 @@ struct _GstRawAudioParse
   /* Currently active configuration. Points either to properties_config
    * or to sink_caps_config. This is never NULL. */
   GstRawAudioParseConfig *current_config;
+
+  /* Number of frames per output buffer, shared by both configurations.
+   * 0 means as many complete frames as available. */
+  guint frames_per_buffer;
 };
 
 struct _GstRawAudioParseClass
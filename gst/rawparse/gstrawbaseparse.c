@@ -205,7 +205,6 @@ static void
 gst_raw_base_parse_set_property (GObject * object, guint prop_id,
     GValue const *value, GParamSpec * pspec)
 {
-  GstBaseParse *base_parse = GST_BASE_PARSE (object);
   GstRawBaseParse *raw_base_parse = GST_RAW_BASE_PARSE (object);
   GstRawBaseParseClass *klass = GST_RAW_BASE_PARSE_GET_CLASS (object);
 
@@ -255,9 +254,7 @@ gst_raw_base_parse_set_property (GObject * object, guint prop_id,
        * well. */
       if (klass->is_config_ready (raw_base_parse,
               GST_RAW_BASE_PARSE_CONFIG_CURRENT)) {
-        gsize frame_size = klass->get_config_frame_size (raw_base_parse,
-            GST_RAW_BASE_PARSE_CONFIG_CURRENT);
-        gst_base_parse_set_min_frame_size (base_parse, frame_size);
+        gst_raw_base_parse_update_min_frame_size (raw_base_parse);
       }
 
       /* Since the current config was switched, the source caps change. Ensure the
@@ -299,7 +296,6 @@ gst_raw_base_parse_get_property (GObject * object, guint prop_id,
 static gboolean
 gst_raw_base_parse_start (GstBaseParse * parse)
 {
-  GstBaseParse *base_parse = GST_BASE_PARSE (parse);
   GstRawBaseParse *raw_base_parse = GST_RAW_BASE_PARSE (parse);
   GstRawBaseParseClass *klass = GST_RAW_BASE_PARSE_GET_CLASS (parse);
 
@@ -311,9 +307,7 @@ gst_raw_base_parse_start (GstBaseParse * parse)
    * (this will happen with the properties config) */
   if (klass->is_config_ready (raw_base_parse,
           GST_RAW_BASE_PARSE_CONFIG_CURRENT)) {
-    gsize frame_size = klass->get_config_frame_size (raw_base_parse,
-        GST_RAW_BASE_PARSE_CONFIG_CURRENT);
-    gst_base_parse_set_min_frame_size (base_parse, frame_size);
+    gst_raw_base_parse_update_min_frame_size (raw_base_parse);
   }
 
   GST_RAW_BASE_PARSE_CONFIG_MUTEX_UNLOCK (raw_base_parse);
@@ -365,7 +359,6 @@ gst_raw_base_parse_set_sink_caps (GstBaseParse * parse, GstCaps * caps)
    * that case, the caps will always be pushed downstream in handle_frame. */
   if (gst_raw_base_parse_is_using_sink_caps (raw_base_parse)) {
     GstCaps *new_src_caps;
-    gsize frame_size;
 
     GST_DEBUG_OBJECT (parse,
         "sink caps config is the current one; trying to push new caps downstream");
@@ -385,10 +378,7 @@ gst_raw_base_parse_set_sink_caps (GstBaseParse * parse, GstCaps * caps)
         "got new sink caps; updating src caps to %" GST_PTR_FORMAT,
         (gpointer) new_src_caps);
 
-    frame_size =
-        klass->get_config_frame_size (raw_base_parse,
-        GST_RAW_BASE_PARSE_CONFIG_CURRENT);
-    gst_base_parse_set_min_frame_size (parse, frame_size);
+    gst_raw_base_parse_update_min_frame_size (raw_base_parse);
 
     raw_base_parse->src_caps_set = TRUE;
 
@@ -410,42 +400,89 @@ done:
   return ret;
 }
 
-static GstBuffer *
-gst_raw_base_parse_align_buffer (GstRawBaseParse * raw_base_parse,
-    gsize alignment, GstBuffer * buffer, gsize out_size)
+static void
+gst_raw_base_parse_append_region (GstBuffer * dest, GstBuffer * src,
+    gsize offset, gsize size, gboolean copy, gsize alignment)
 {
+  GstAllocationParams params = { 0, alignment - 1, 0, 0, };
+  GstMemory *mem;
   GstMapInfo map;
 
-  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  if (size == 0)
+    return;
 
-  if (map.size < sizeof (guintptr)) {
-    gst_buffer_unmap (buffer, &map);
-    return NULL;
+  if (!copy) {
+    gst_buffer_copy_into (dest, src, GST_BUFFER_COPY_MEMORY, offset, size);
+    return;
   }
 
-  if (((guintptr) map.data) & (alignment - 1)) {
-    GstBuffer *new_buffer;
-    GstAllocationParams params = { 0, alignment - 1, 0, 0, };
-
-    new_buffer = gst_buffer_new_allocate (NULL, out_size, &params);
+  mem = gst_allocator_alloc (NULL, size, &params);
+  gst_memory_map (mem, &map, GST_MAP_WRITE);
+  gst_buffer_extract (src, offset, map.data, size);
+  gst_memory_unmap (mem, &map);
+  gst_buffer_append_memory (dest, mem);
+}
 
-    /* Copy data "by hand", so ensure alignment is kept: */
-    gst_buffer_fill (new_buffer, 0, map.data, out_size);
+/* Returns a buffer with the first out_size bytes of buffer in which every
+ * memory is aligned, or NULL if buffer already is. Memories that are aligned,
+ * start on a sample boundary and don't split a sample are shared and only the
+ * others are copied */
+static GstBuffer *
+gst_raw_base_parse_align_buffer (GstRawBaseParse * raw_base_parse,
+    gsize alignment, GstBuffer * buffer, gsize out_size)
+{
+  GstBuffer *new_buffer = NULL;
+  gsize offset = 0, pending_offset = 0;
+  gboolean pending_copy = FALSE;
+  guint i, n;
+
+  n = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n && offset < out_size; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+    GstMapInfo map;
+    gsize size;
+    gboolean aligned;
+
+    if (!gst_memory_map (mem, &map, GST_MAP_READ)) {
+      GST_WARNING_OBJECT (raw_base_parse, "failed to map memory %u", i);
+      if (new_buffer)
+        gst_buffer_unref (new_buffer);
+      return NULL;
+    }
+    size = MIN (map.size, out_size - offset);
+    aligned = !(((guintptr) map.data) & (alignment - 1))
+        && (offset % alignment) == 0
+        && ((size % alignment) == 0 || offset + size == out_size);
+    gst_memory_unmap (mem, &map);
+
+    if (aligned == pending_copy) {
+      /* the kind of region changes, output the pending one */
+      if (new_buffer == NULL)
+        new_buffer = gst_buffer_new ();
+      gst_raw_base_parse_append_region (new_buffer, buffer, pending_offset,
+          offset - pending_offset, pending_copy, alignment);
+      pending_offset = offset;
+      pending_copy = !aligned;
+    }
 
-    gst_buffer_copy_into (new_buffer, buffer, GST_BUFFER_COPY_METADATA, 0,
-        out_size);
-    GST_DEBUG_OBJECT (raw_base_parse,
-        "We want output aligned on %" G_GSIZE_FORMAT ", reallocated",
-        alignment);
+    offset += size;
+  }
 
-    gst_buffer_unmap (buffer, &map);
+  if (new_buffer == NULL && !pending_copy)
+    return NULL;
 
-    return new_buffer;
-  }
+  if (new_buffer == NULL)
+    new_buffer = gst_buffer_new ();
+  gst_raw_base_parse_append_region (new_buffer, buffer, pending_offset,
+      out_size - pending_offset, pending_copy, alignment);
 
-  gst_buffer_unmap (buffer, &map);
+  gst_buffer_copy_into (new_buffer, buffer, GST_BUFFER_COPY_METADATA, 0,
+      out_size);
+  GST_DEBUG_OBJECT (raw_base_parse,
+      "We want output aligned on %" G_GSIZE_FORMAT ", copied the misaligned "
+      "parts", alignment);
 
-  return NULL;
+  return new_buffer;
 }
 
 static GstFlowReturn
@@ -541,7 +578,7 @@ gst_raw_base_parse_handle_frame (GstBaseParse * parse,
     return gst_base_parse_finish_frame (parse, frame, in_size);
   }
 
-  /* gst_base_parse_set_min_frame_size() is called when the current
+  /* gst_raw_base_parse_update_min_frame_size() is called when the current
    * configuration changes and the change affects the frame size. This
    * means that a buffer must contain at least as many bytes as indicated
    * by the frame size. If there are fewer inside an error occurred;
@@ -763,6 +800,40 @@ gst_raw_base_parse_is_gstformat_supported (GstRawBaseParse * raw_base_parse,
   return klass->is_unit_format_supported (raw_base_parse, format);
 }
 
+/**
+ * gst_raw_base_parse_update_min_frame_size:
+ * @raw_base_parse: a #GstRawBaseParse instance
+ *
+ * Sets the minimum frame size of the base parser from the current
+ * configuration: the size of one frame, or of as many frames as
+ * @get_max_frames_per_buffer returns when that is not G_MAXUINT. This is
+ * used if for example the properties configuration is modified in the
+ * subclass in a way that changes the frame size.
+ *
+ * Note that this must be called with the parser lock held, and only when
+ * the current configuration is ready.
+ */
+void
+gst_raw_base_parse_update_min_frame_size (GstRawBaseParse * raw_base_parse)
+{
+  GstRawBaseParseClass *klass = GST_RAW_BASE_PARSE_GET_CLASS (raw_base_parse);
+  gsize min_size;
+
+  /* must be called with lock */
+  min_size = klass->get_config_frame_size (raw_base_parse,
+      GST_RAW_BASE_PARSE_CONFIG_CURRENT);
+
+  if (klass->get_max_frames_per_buffer) {
+    guint max_frames = klass->get_max_frames_per_buffer (raw_base_parse,
+        GST_RAW_BASE_PARSE_CONFIG_CURRENT);
+    if (max_frames != G_MAXUINT)
+      min_size *= max_frames;
+  }
+
+  gst_base_parse_set_min_frame_size (GST_BASE_PARSE (raw_base_parse),
+      min_size);
+}
+
 /**
  * gst_raw_base_parse_invalidate_src_caps:
  * @raw_base_parse: a #GstRawBaseParse instance
@@ -110,6 +110,10 @@ struct _GstRawBaseParse
  *                             several complete frames. If this vfunc is not set, then there
  *                             is no maximum number of frames per buffer - the parser reads
  *                             as many complete frames as possible from the input buffer.
+ *                             If it returns a value other than G_MAXUINT, the parser waits
+ *                             until that many frames are available before outputting a
+ *                             buffer, except when draining, so buffers are only split when
+ *                             the input does not line up with whole chunks.
  * @is_config_ready:           Returns TRUE if the specified configuration is ready, FALSE
  *                             otherwise.
  * @process:                   Optional.
@@ -195,6 +199,7 @@ struct _GstRawBaseParseClass
 };
 
 void gst_raw_base_parse_invalidate_src_caps (GstRawBaseParse * raw_base_parse);
+void gst_raw_base_parse_update_min_frame_size (GstRawBaseParse * raw_base_parse);
 
 GType gst_raw_base_parse_get_type (void);
 
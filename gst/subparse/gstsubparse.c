@@ -120,6 +120,11 @@ gst_sub_parse_dispose (GObject * object)
     subparse->textbuf = NULL;
   }
 
+  if (subparse->cue_index) {
+    g_array_free (subparse->cue_index, TRUE);
+    subparse->cue_index = NULL;
+  }
+
   GST_CALL_PARENT (G_OBJECT_CLASS, dispose, (object));
 }
 
@@ -185,6 +190,7 @@ gst_sub_parse_init (GstSubParse * subparse)
   subparse->encoding = g_strdup (DEFAULT_ENCODING);
   subparse->detected_encoding = NULL;
   subparse->adapter = gst_adapter_new ();
+  subparse->cue_index = g_array_new (FALSE, FALSE, sizeof (GstSubParseCue));
 
   subparse->fps_n = 24000;
   subparse->fps_d = 1001;
@@ -243,6 +249,64 @@ gst_sub_parse_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
   return ret;
 }
 
+/* Returns the offset of a cue starting before @position. One more cue is
+ * skipped back, in case the one before is still displayed at @position */
+static guint64
+gst_sub_parse_find_cue_offset (GstSubParse * self, GstClockTime position)
+{
+  guint64 offset = 0;
+  guint lo, hi;
+
+  GST_OBJECT_LOCK (self);
+  if (!self->cue_index_valid || self->cue_index->len == 0)
+    goto done;
+
+  /* find the first cue starting after position */
+  lo = 0;
+  hi = self->cue_index->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
+
+    if (g_array_index (self->cue_index, GstSubParseCue, mid).time <= position)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  if (lo >= 2)
+    offset = g_array_index (self->cue_index, GstSubParseCue, lo - 2).offset;
+
+done:
+  GST_OBJECT_UNLOCK (self);
+
+  GST_DEBUG_OBJECT (self, "cue before %" GST_TIME_FORMAT " at offset %"
+      G_GUINT64_FORMAT, GST_TIME_ARGS (position), offset);
+
+  return offset;
+}
+
+static void
+gst_sub_parse_add_cue (GstSubParse * self, guint64 offset, GstClockTime time)
+{
+  GstSubParseCue *last = NULL;
+
+  GST_OBJECT_LOCK (self);
+  if (self->cue_index->len > 0)
+    last = &g_array_index (self->cue_index, GstSubParseCue,
+        self->cue_index->len - 1);
+
+  /* cues seen again after a seek are already there, and out of order cues
+   * can't be searched for */
+  if (last == NULL || (offset > last->offset && time >= last->time)) {
+    GstSubParseCue cue = { offset, time };
+
+    GST_LOG_OBJECT (self, "cue at %" GST_TIME_FORMAT ", offset %"
+        G_GUINT64_FORMAT, GST_TIME_ARGS (time), offset);
+    g_array_append_val (self->cue_index, cue);
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
 static gboolean
 gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -258,6 +322,7 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GstSeekFlags flags;
       GstSeekType start_type, stop_type;
       gint64 start, stop;
+      guint64 byte_start;
       gdouble rate;
       gboolean update;
 
@@ -270,11 +335,25 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
         goto beach;
       }
 
-      /* Convert that seek to a seeking in bytes at position 0,
-         FIXME: could use an index */
+      /* Convert that seek to a seeking in bytes, at the start of a cue
+       * before the requested position if we know one, else at position 0.
+       * The text that's before the requested position is thrown away */
+      byte_start = 0;
+      if (rate > 0.0 && start_type == GST_SEEK_TYPE_SET)
+        byte_start = gst_sub_parse_find_cue_offset (self, start);
+
       ret = gst_pad_push_event (self->sinkpad,
           gst_event_new_seek (rate, GST_FORMAT_BYTES, flags,
-              GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, 0));
+              GST_SEEK_TYPE_SET, byte_start, GST_SEEK_TYPE_NONE, 0));
+
+      if (!ret && byte_start != 0) {
+        GST_DEBUG_OBJECT (self, "seek to %" G_GUINT64_FORMAT " bytes failed, "
+            "trying from the start", byte_start);
+        byte_start = 0;
+        ret = gst_pad_push_event (self->sinkpad,
+            gst_event_new_seek (rate, GST_FORMAT_BYTES, flags,
+                GST_SEEK_TYPE_SET, 0, GST_SEEK_TYPE_NONE, 0));
+      }
 
       if (ret) {
         /* Apply the seek to our segment */
@@ -288,7 +367,8 @@ gst_sub_parse_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
          * after FLUSH and all that has happened,
          * rather than racing with chain */
       } else {
-        GST_WARNING_OBJECT (self, "seek to 0 bytes failed");
+        GST_WARNING_OBJECT (self, "seek to %" G_GUINT64_FORMAT " bytes failed",
+            byte_start);
       }
 
       gst_event_unref (event);
@@ -530,6 +610,10 @@ get_next_line (GstSubParse * self)
   line = g_strndup (self->textbuf->str, line_len);
   self->textbuf = g_string_erase (self->textbuf, 0,
       line_len + (have_r ? 2 : 1));
+
+  self->line_offset = self->textbuf_offset;
+  self->textbuf_offset += line_len + (have_r ? 2 : 1);
+
   return line;
 }
 
@@ -1688,6 +1772,7 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
     parser_state_init (&self->state);
     g_string_truncate (self->textbuf, 0);
     gst_adapter_clear (self->adapter);
+    self->textbuf_offset = self->offset;
     if (self->parser_type == GST_SUB_PARSE_FORMAT_SAMI)
       sami_context_reset (&self->state);
     /* we could set a flag to make sure that the next buffer we push out also
@@ -1703,6 +1788,14 @@ feed_textbuf (GstSubParse * self, GstBuffer * buf)
   data = gst_adapter_map (self->adapter, avail);
   input = convert_encoding (self, (const gchar *) data, avail, &consumed);
 
+  /* offsets in textbuf are only the input offsets if nothing was converted */
+  if (self->cue_index_valid && (self->detected_encoding || !self->valid_utf8)) {
+    GST_DEBUG_OBJECT (self, "input is converted, not indexing cues");
+    GST_OBJECT_LOCK (self);
+    self->cue_index_valid = FALSE;
+    GST_OBJECT_UNLOCK (self);
+  }
+
   if (input && consumed > 0) {
     self->textbuf = g_string_append (self->textbuf, input);
     gst_adapter_unmap (self->adapter);
@@ -1770,6 +1863,7 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
 
   while (!self->flushing && (line = get_next_line (self))) {
     guint offset = 0;
+    gint prev_state = self->state.state;
 
     /* Set segment on our parser state machine */
     self->state.segment = &self->segment;
@@ -1779,6 +1873,18 @@ handle_buffer (GstSubParse * self, GstBuffer * buf)
     subtitle = self->parse_line (&self->state, line + offset);
     g_free (line);
 
+    /* subrip and webvtt cues start with the first line that gets the parser
+     * out of its initial state, and parsing can be resumed there after a
+     * seek. Their time is known when the timing line is reached */
+    if (self->cue_index_valid &&
+        (self->parser_type == GST_SUB_PARSE_FORMAT_SUBRIP ||
+            self->parser_type == GST_SUB_PARSE_FORMAT_VTT)) {
+      if (prev_state == 0 && self->state.state != 0)
+        self->cue_offset = self->line_offset;
+      if (prev_state != 2 && self->state.state == 2)
+        gst_sub_parse_add_cue (self, self->cue_offset, self->state.start_time);
+    }
+
     if (subtitle) {
       guint subtitle_len = strlen (subtitle);
 
@@ -1939,6 +2045,13 @@ gst_sub_parse_change_state (GstElement * element, GstStateChange transition)
       self->parser_type = GST_SUB_PARSE_FORMAT_UNKNOWN;
       self->valid_utf8 = TRUE;
       self->first_buffer = TRUE;
+      self->textbuf_offset = 0;
+      self->line_offset = 0;
+      self->cue_offset = 0;
+      GST_OBJECT_LOCK (self);
+      g_array_set_size (self->cue_index, 0);
+      self->cue_index_valid = TRUE;
+      GST_OBJECT_UNLOCK (self);
       g_free (self->detected_encoding);
       self->detected_encoding = NULL;
       g_string_truncate (self->textbuf, 0);
@@ -82,6 +82,12 @@ typedef struct {
 
 typedef gchar* (*Parser) (ParserState *state, const gchar *line);
 
+/* where a cue starts in the input, for seeking */
+typedef struct {
+  guint64      offset;
+  GstClockTime time;
+} GstSubParseCue;
+
 struct _GstSubParse {
   GstElement element;
 
@@ -101,7 +107,16 @@ struct _GstSubParse {
 
   /* seek */
   guint64 offset;
-  
+
+  /* cue start offsets and times seen so far, protected by the object lock.
+   * Only kept while the input doesn't need any conversion to UTF-8, so that
+   * offsets in textbuf map to input offsets */
+  GArray  *cue_index;
+  gboolean cue_index_valid;
+  guint64  textbuf_offset;
+  guint64  line_offset;
+  guint64  cue_offset;
+
   /* Segment */
   GstSegment    segment;
   gboolean      need_segment;
@@ -758,26 +758,35 @@ gst_multi_fd_sink_handle_client_write (GstMultiFdSink * sink,
 
       /* pick first buffer from list */
       head = GST_BUFFER (mhclient->sending->data);
+      maxsize = gst_buffer_get_size (head) - mhclient->bufoffset;
 
-      if (!gst_buffer_map (head, &info, GST_MAP_READ))
-        g_return_val_if_reached (FALSE);
+      /* file backed buffers go from the file to the fd without mapping.
+       * sendfile() can't take MSG_NOSIGNAL, so sockets use send() */
+      if (client->is_socket)
+        wrote = -2;
+      else
+        wrote = gst_multi_handle_sink_sendfile (head, fd, mhclient->bufoffset);
 
-      data = info.data;
-      maxsize = info.size - mhclient->bufoffset;
+      if (wrote == -2) {
+        if (!gst_buffer_map (head, &info, GST_MAP_READ))
+          g_return_val_if_reached (FALSE);
 
-      /* FIXME: specific */
-      /* try to write the complete buffer */
+        data = info.data;
+
+        /* FIXME: specific */
+        /* try to write the complete buffer */
 #ifdef MSG_NOSIGNAL
 #define FLAGS MSG_NOSIGNAL
 #else
 #define FLAGS 0
 #endif
-      if (client->is_socket) {
-        wrote = send (fd, data + mhclient->bufoffset, maxsize, FLAGS);
-      } else {
-        wrote = write (fd, data + mhclient->bufoffset, maxsize);
+        if (client->is_socket) {
+          wrote = send (fd, data + mhclient->bufoffset, maxsize, FLAGS);
+        } else {
+          wrote = write (fd, data + mhclient->bufoffset, maxsize);
+        }
+        gst_buffer_unmap (head, &info);
       }
-      gst_buffer_unmap (head, &info);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -104,6 +104,7 @@
 #endif
 
 #include <gst/gst-i18n-plugin.h>
+#include <gst/allocators/gstfdmemory.h>
 
 #include "gstmultihandlesink.h"
 
@@ -111,6 +112,12 @@
 #include <sys/socket.h>
 #endif
 
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <errno.h>
+#endif
+
 #ifndef G_OS_WIN32
 #include <netinet/in.h>
 #endif
@@ -197,7 +204,9 @@ enum
 
   PROP_RESEND_STREAMHEADER,
 
-  PROP_NUM_HANDLES
+  PROP_NUM_HANDLES,
+
+  PROP_STATS
 };
 
 GType
@@ -443,6 +452,30 @@ gst_multi_handle_sink_class_init (GstMultiHandleSinkClass * klass)
           "The current number of client handles",
           0, G_MAXUINT, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiHandleSink:stats:
+   *
+   * Statistics of all clients at once. Returns a #GstStructure named
+   * `multihandlesink-stats` with a "num-clients" field, the largest
+   * "max-queue-depth" (in buffers) and "max-time-behind" of all clients,
+   * and a "clients" #GST_TYPE_ARRAY holding one `multihandlesink-stats`
+   * structure per client. Those contain the fields of the get-stats signal
+   * plus "client" (a debug description), "queue-depth", "time-behind"
+   * (the running time between the newest queued buffer and the next
+   * buffer the client will be sent, or %GST_CLOCK_TIME_NONE) and
+   * "bytes-per-second".
+   *
+   * The client lock is only held while the counters are copied, so reading
+   * this property is cheaper for the streaming thread than emitting
+   * get-stats for every client.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of all clients", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstMultiHandleSink::clear:
    * @gstmultihandlesink: the multihandlesink element to emit this signal on
@@ -495,6 +528,7 @@ gst_multi_handle_sink_init (GstMultiHandleSink * this)
   this->clients = NULL;
 
   this->bufqueue = g_array_new (FALSE, TRUE, sizeof (GstBuffer *));
+  this->keyframes = g_array_new (FALSE, FALSE, sizeof (guint64));
   this->unit_format = DEFAULT_UNIT_FORMAT;
   this->units_max = DEFAULT_UNITS_MAX;
   this->units_soft_max = DEFAULT_UNITS_SOFT_MAX;
@@ -523,11 +557,53 @@ gst_multi_handle_sink_finalize (GObject * object)
 
   CLIENTS_LOCK_CLEAR (this);
   g_array_free (this->bufqueue, TRUE);
+  g_array_free (this->keyframes, TRUE);
   g_hash_table_destroy (this->handle_hash);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* Sends @buffer from @bufoffset on to @fd with sendfile() when all of it is
+ * a single GstFdMemory backed by a regular file, so that the data of file
+ * backed buffers never has to be mapped into user space. Returns the number
+ * of bytes written, -1 with errno set when the write failed or -2 when the
+ * buffer can't be sent this way and should be mapped and written instead. */
+gssize
+gst_multi_handle_sink_sendfile (GstBuffer * buffer, gint fd, gsize bufoffset)
+{
+#ifdef HAVE_SYS_SENDFILE_H
+  GstMemory *mem;
+  struct stat st;
+  off_t offset;
+  gssize wrote;
+  gint mem_fd;
+
+  if (gst_buffer_n_memory (buffer) != 1)
+    return -2;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_is_fd_memory (mem) || bufoffset >= mem->size)
+    return -2;
+
+  /* dmabuf and memfd exports are fd memory too but only regular files are
+   * guaranteed to work with sendfile() */
+  mem_fd = gst_fd_memory_get_fd (mem);
+  if (mem_fd < 0 || fstat (mem_fd, &st) < 0 || !S_ISREG (st.st_mode))
+    return -2;
+
+  /* fd memory maps the file from its start, the memory offset is the file
+   * offset */
+  offset = mem->offset + bufoffset;
+  wrote = sendfile (fd, mem_fd, &offset, mem->size - bufoffset);
+  if (wrote < 0 && (errno == EINVAL || errno == ENOSYS))
+    return -2;
+
+  return wrote;
+#else
+  return -2;
+#endif
+}
+
 gint
 gst_multi_handle_sink_setup_dscp_client (GstMultiHandleSink * sink,
     GstMultiHandleClient * client)
@@ -612,6 +688,7 @@ gst_multi_handle_sink_client_init (GstMultiHandleClient * client,
   client->new_connection = TRUE;
   client->sync_method = sync_method;
   client->currently_removing = FALSE;
+  client->refcount = 1;
 
   /* update start time */
   client->connect_time = g_get_real_time () * GST_USECOND;
@@ -908,6 +985,116 @@ noclient:
   return result;
 }
 
+/* the counters of one client, copied under the clientslock so the stats
+ * structures can be built without it */
+typedef struct
+{
+  gchar debug[30];
+  guint64 bytes_sent;
+  guint64 connect_time;
+  guint64 disconnect_time;
+  guint64 last_activity_time;
+  guint64 dropped_buffers;
+  guint64 first_buffer_ts;
+  guint64 last_buffer_ts;
+  gint queue_depth;
+  GstClockTime time_behind;
+} GstMultiHandleClientStats;
+
+static GstStructure *
+gst_multi_handle_sink_get_all_stats (GstMultiHandleSink * mhsink)
+{
+  GstMultiHandleClientStats *stats;
+  GstStructure *result;
+  GValue clients = G_VALUE_INIT;
+  GstClockTime now, newest_ts = GST_CLOCK_TIME_NONE;
+  GstClockTime max_time_behind = 0;
+  gint max_queue_depth = 0;
+  guint i, n_clients = 0;
+  GList *clients_link;
+
+  CLIENTS_LOCK (mhsink);
+  stats = g_new (GstMultiHandleClientStats, g_list_length (mhsink->clients));
+
+  if (mhsink->bufqueue->len > 0)
+    newest_ts = GST_BUFFER_TIMESTAMP (g_array_index (mhsink->bufqueue,
+            GstBuffer *, 0));
+
+  for (clients_link = mhsink->clients; clients_link;
+      clients_link = clients_link->next) {
+    GstMultiHandleClient *mhclient = clients_link->data;
+    GstMultiHandleClientStats *s = &stats[n_clients++];
+
+    memcpy (s->debug, mhclient->debug, sizeof (s->debug));
+    s->bytes_sent = mhclient->bytes_sent;
+    s->connect_time = mhclient->connect_time;
+    s->disconnect_time = mhclient->disconnect_time;
+    s->last_activity_time = mhclient->last_activity_time;
+    s->dropped_buffers = mhclient->dropped_buffers;
+    s->first_buffer_ts = mhclient->first_buffer_ts;
+    s->last_buffer_ts = mhclient->last_buffer_ts;
+    s->queue_depth = mhclient->bufpos + 1;
+    s->time_behind = GST_CLOCK_TIME_NONE;
+
+    if (mhclient->bufpos >= 0 && GST_CLOCK_TIME_IS_VALID (newest_ts)) {
+      GstClockTime ts = GST_BUFFER_TIMESTAMP (g_array_index (mhsink->bufqueue,
+              GstBuffer *, mhclient->bufpos));
+
+      if (GST_CLOCK_TIME_IS_VALID (ts) && newest_ts >= ts)
+        s->time_behind = newest_ts - ts;
+    }
+  }
+  CLIENTS_UNLOCK (mhsink);
+
+  now = g_get_real_time () * GST_USECOND;
+  g_value_init (&clients, GST_TYPE_ARRAY);
+
+  for (i = 0; i < n_clients; i++) {
+    GstMultiHandleClientStats *s = &stats[i];
+    GValue v = G_VALUE_INIT;
+    GstStructure *client;
+    guint64 interval;
+
+    if (s->disconnect_time == 0)
+      interval = now - s->connect_time;
+    else
+      interval = s->disconnect_time - s->connect_time;
+
+    client = gst_structure_new ("multihandlesink-stats",
+        "client", G_TYPE_STRING, s->debug,
+        "bytes-sent", G_TYPE_UINT64, s->bytes_sent,
+        "connect-time", G_TYPE_UINT64, s->connect_time,
+        "disconnect-time", G_TYPE_UINT64, s->disconnect_time,
+        "connect-duration", G_TYPE_UINT64, interval,
+        "last-activity-time", G_TYPE_UINT64, s->last_activity_time,
+        "buffers-dropped", G_TYPE_UINT64, s->dropped_buffers,
+        "first-buffer-ts", G_TYPE_UINT64, s->first_buffer_ts,
+        "last-buffer-ts", G_TYPE_UINT64, s->last_buffer_ts,
+        "queue-depth", G_TYPE_INT, s->queue_depth,
+        "time-behind", G_TYPE_UINT64, s->time_behind,
+        "bytes-per-second", G_TYPE_UINT64, interval > 0 ?
+        gst_util_uint64_scale (s->bytes_sent, GST_SECOND, interval) : 0,
+        NULL);
+
+    max_queue_depth = MAX (max_queue_depth, s->queue_depth);
+    if (GST_CLOCK_TIME_IS_VALID (s->time_behind))
+      max_time_behind = MAX (max_time_behind, s->time_behind);
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, client);
+    gst_value_array_append_and_take_value (&clients, &v);
+  }
+  g_free (stats);
+
+  result = gst_structure_new ("multihandlesink-stats",
+      "num-clients", G_TYPE_UINT, n_clients,
+      "max-queue-depth", G_TYPE_INT, max_queue_depth,
+      "max-time-behind", G_TYPE_UINT64, max_time_behind, NULL);
+  gst_structure_take_value (result, "clients", &clients);
+
+  return result;
+}
+
 /* should be called with the clientslock held.
  * Note that we don't close the fd as we didn't open it in the first
  * place. An application should connect to the client-fd-removed signal and
@@ -1002,15 +1189,39 @@ gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
 
   CLIENTS_UNLOCK (sink);
 
+  /* and the handle is really gone now, unless someone is still using the
+   * client outside of the lock, it will then be freed when done */
+  gst_multi_handle_sink_client_unref (sink, mhclient);
+
+  CLIENTS_LOCK (sink);
+}
+
+/* Keeps @client alive so that it can be used while the CLIENTS_LOCK is
+ * released. Must be called with the CLIENTS_LOCK */
+void
+gst_multi_handle_sink_client_ref (GstMultiHandleClient * client)
+{
+  g_atomic_int_inc (&client->refcount);
+}
+
+/* Releases a reference to @client and frees it when it was the last one.
+ * Must be called without the CLIENTS_LOCK because the subclass emits the
+ * client-$handle-removed signal from client_free */
+void
+gst_multi_handle_sink_client_unref (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client)
+{
+  GstMultiHandleSinkClass *mhsinkclass = GST_MULTI_HANDLE_SINK_GET_CLASS (sink);
+
+  if (!g_atomic_int_dec_and_test (&client->refcount))
+    return;
+
   /* sub-class must implement this to emit the client-$handle-removed signal */
   g_assert (mhsinkclass->client_free != NULL);
 
-  /* and the handle is really gone now */
-  mhsinkclass->client_free (sink, mhclient);
-
-  g_free (mhclient);
+  mhsinkclass->client_free (sink, client);
 
-  CLIENTS_LOCK (sink);
+  g_free (client);
 }
 
 static gboolean
@@ -1140,34 +1351,65 @@ is_sync_frame (GstMultiHandleSink * sink, GstBuffer * buffer)
   return TRUE;
 }
 
+/* the buffer with @seqnum is at this index in the bufqueue, the newest
+ * buffer has index 0 */
+#define SEQNUM_TO_INDEX(s,seqnum) ((gint) ((s)->bufqueue_seqnum - 1 - (seqnum)))
+
 /* find the keyframe in the list of buffers starting the
  * search from @idx. @direction as -1 will search backwards, 
  * 1 will search forwards.
  * Returns: the index or -1 if there is no keyframe after idx.
+ *
+ * This is a binary search in the keyframe index so that clients joining
+ * don't cost a scan of the whole queue.
  */
 gint
 find_syncframe (GstMultiHandleSink * sink, gint idx, gint direction)
 {
-  gint i, len, result;
+  GArray *keyframes = sink->keyframes;
+  guint64 seqnum, kf;
+  guint lo, hi;
+  gint result;
 
-  /* take length of queued buffers */
-  len = sink->bufqueue->len;
+  if (idx < 0 || idx >= (gint) sink->bufqueue->len || keyframes->len == 0)
+    return -1;
 
-  /* assume we don't find a keyframe */
-  result = -1;
+  seqnum = sink->bufqueue_seqnum - 1 - idx;
 
-  /* then loop over all buffers to find the first keyframe */
-  for (i = idx; i >= 0 && i < len; i += direction) {
-    GstBuffer *buf;
+  /* find the first keyframe that is not older than @idx */
+  lo = 0;
+  hi = keyframes->len;
+  while (lo < hi) {
+    guint mid = lo + (hi - lo) / 2;
 
-    buf = g_array_index (sink->bufqueue, GstBuffer *, i);
-    if (is_sync_frame (sink, buf)) {
-      GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
-          i, idx, direction);
-      result = i;
-      break;
+    if (g_array_index (keyframes, guint64, mid) < seqnum)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  result = -1;
+  if (direction < 0) {
+    /* towards the newer buffers */
+    if (lo < keyframes->len) {
+      kf = g_array_index (keyframes, guint64, lo);
+      result = SEQNUM_TO_INDEX (sink, kf);
+    }
+  } else {
+    /* towards the older buffers */
+    if (lo < keyframes->len
+        && g_array_index (keyframes, guint64, lo) == seqnum) {
+      result = idx;
+    } else if (lo > 0) {
+      kf = g_array_index (keyframes, guint64, lo - 1);
+      result = SEQNUM_TO_INDEX (sink, kf);
     }
   }
+
+  if (result >= 0)
+    GST_LOG_OBJECT (sink, "found keyframe at %d from %d, direction %d",
+        result, idx, direction);
+
   return result;
 }
 
@@ -1625,17 +1867,7 @@ gst_multi_handle_sink_recover_client (GstMultiHandleSink * sink,
        * closest keyframe relative to what this client already received. */
       newbufpos = MIN (sink->bufqueue->len - 1,
           get_buffers_max (sink, sink->units_soft_max) - 1);
-
-      while (newbufpos >= 0) {
-        GstBuffer *buf;
-
-        buf = g_array_index (sink->bufqueue, GstBuffer *, newbufpos);
-        if (is_sync_frame (sink, buf)) {
-          /* found a buffer that is not a delta unit */
-          break;
-        }
-        newbufpos--;
-      }
+      newbufpos = find_prev_syncframe (sink, newbufpos);
       break;
     default:
       /* unknown recovery procedure */
@@ -1683,6 +1915,9 @@ gst_multi_handle_sink_queue_buffer (GstMultiHandleSink * mhsink,
   /* add buffer to queue */
   g_array_prepend_val (mhsink->bufqueue, buffer);
   queuelen = mhsink->bufqueue->len;
+  if (is_sync_frame (mhsink, buffer))
+    g_array_append_val (mhsink->keyframes, mhsink->bufqueue_seqnum);
+  mhsink->bufqueue_seqnum++;
 
   if (mhsink->units_max > 0)
     max_buffers = get_buffers_max (mhsink, mhsink->units_max);
@@ -1794,7 +2029,6 @@ restart:
       mhsink->def_sync_method == GST_SYNC_METHOD_BURST_KEYFRAME) {
     /* no point in searching beyond the queue length */
     gint limit = queuelen;
-    GstBuffer *buf;
 
     /* no point in searching beyond the soft-max if any. */
     if (soft_max_buffers > 0) {
@@ -1803,14 +2037,11 @@ restart:
     GST_LOG_OBJECT (sink,
         "extending queue to include sync point, now at %d, limit is %d",
         max_buffer_usage, limit);
-    for (i = 0; i < limit; i++) {
-      buf = g_array_index (mhsink->bufqueue, GstBuffer *, i);
-      if (is_sync_frame (mhsink, buf)) {
-        /* found a sync frame, now extend the buffer usage to
-         * include at least this frame. */
-        max_buffer_usage = MAX (max_buffer_usage, i);
-        break;
-      }
+    i = find_next_syncframe (mhsink, 0);
+    if (i >= 0 && i < limit) {
+      /* found a sync frame, now extend the buffer usage to
+       * include at least this frame. */
+      max_buffer_usage = MAX (max_buffer_usage, i);
     }
     GST_LOG_OBJECT (sink, "max buffer usage is now %d", max_buffer_usage);
   }
@@ -1831,6 +2062,14 @@ restart:
     /* unref tail buffer */
     gst_buffer_unref (old);
   }
+  /* and forget about the keyframes that were removed with them */
+  for (i = 0; i < mhsink->keyframes->len; i++) {
+    if (SEQNUM_TO_INDEX (mhsink, g_array_index (mhsink->keyframes, guint64,
+                i)) < queuelen)
+      break;
+  }
+  if (i > 0)
+    g_array_remove_range (mhsink->keyframes, 0, i);
   /* save for stats */
   mhsink->buffers_queued = max_buffer_usage + 1;
   CLIENTS_UNLOCK (sink);
@@ -2122,6 +2361,10 @@ gst_multi_handle_sink_get_property (GObject * object, guint prop_id,
       g_value_set_uint (value,
           g_hash_table_size (multihandlesink->handle_hash));
       break;
+    case PROP_STATS:
+      g_value_take_boxed (value,
+          gst_multi_handle_sink_get_all_stats (multihandlesink));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2204,6 +2447,7 @@ gst_multi_handle_sink_stop (GstBaseSink * bsink)
       gst_buffer_unref (buf);
       mhsink->bufqueue = g_array_remove_index (mhsink->bufqueue, i);
     }
+    g_array_set_size (mhsink->keyframes, 0);
     /* freeing the array is done in _finalize */
   }
   GST_OBJECT_FLAG_UNSET (mhsink, GST_MULTI_HANDLE_SINK_OPEN);
@@ -150,6 +150,9 @@ typedef struct {
   gboolean new_connection;
   gboolean currently_removing;
 
+  /* keeps the client alive while it is used without the CLIENTS_LOCK */
+  gint refcount;
+
 
   /* method to sync client when connecting */
   GstSyncMethod sync_method;
@@ -180,6 +183,7 @@ gint gst_multi_handle_sink_setup_dscp_client (GstMultiHandleSink * sink, GstMult
 gint
 gst_multi_handle_sink_new_client_position (GstMultiHandleSink * sink,
     GstMultiHandleClient * client);
+gssize gst_multi_handle_sink_sendfile (GstBuffer * buffer, gint fd, gsize bufoffset);
 
 /**
  * GstMultiHandleSink:
@@ -205,6 +209,9 @@ struct _GstMultiHandleSink {
   gint qos_dscp;
 
   GArray *bufqueue;     /* global queue of buffers */
+  guint64 bufqueue_seqnum;  /* number of buffers ever added to bufqueue */
+  GArray *keyframes;    /* guint64 seqnums of the queued sync frames, oldest
+                         * first, so keyframe lookups don't scan bufqueue */
 
   gboolean running;     /* the thread state */
   GThread *thread;      /* the sender thread */
@@ -286,6 +293,9 @@ void gst_multi_handle_sink_remove_client_link (GstMultiHandleSink * sink,
     GList * link);
 
 void gst_multi_handle_sink_client_init (GstMultiHandleClient * client, GstSyncMethod sync_method);
+void gst_multi_handle_sink_client_ref (GstMultiHandleClient * client);
+void gst_multi_handle_sink_client_unref (GstMultiHandleSink * sink,
+    GstMultiHandleClient * client);
 
 #define GST_TYPE_RECOVER_POLICY (gst_multi_handle_sink_recover_policy_get_type())
 GType gst_multi_handle_sink_recover_policy_get_type (void);
@@ -107,6 +107,7 @@
 #include <gst/net/gstnetcontrolmessagemeta.h>
 
 #include <string.h>
+#include <errno.h>
 
 #include "gstmultisocketsink.h"
 
@@ -139,12 +140,16 @@ enum
 
 #define DEFAULT_SEND_DISPATCHED FALSE
 #define DEFAULT_SEND_MESSAGES   FALSE
+#define DEFAULT_MAX_MESSAGES    1
+#define DEFAULT_N_THREADS       1
 
 enum
 {
   PROP_0,
   PROP_SEND_DISPATCHED,
   PROP_SEND_MESSAGES,
+  PROP_MAX_MESSAGES,
+  PROP_N_THREADS,
   PROP_LAST
 };
 
@@ -261,6 +266,41 @@ gst_multi_socket_sink_class_init (GstMultiSocketSinkClass * klass)
           "If GstNetworkMessage events should be pushed", DEFAULT_SEND_MESSAGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiSocketSink:max-messages:
+   *
+   * The maximum number of queued buffers that are sent to a datagram client
+   * with a single g_socket_send_messages() call. Each buffer is sent as one
+   * datagram. A value of 1 sends every buffer with its own call.
+   *
+   * This has no effect on stream sockets.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_MESSAGES,
+      g_param_spec_uint ("max-messages", "Max Messages",
+          "Maximum number of datagrams to send to a client in one call",
+          1, 1024, DEFAULT_MAX_MESSAGES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstMultiSocketSink:n-threads:
+   *
+   * The number of threads that service the clients. Clients are distributed
+   * over the threads when they are added and all of them share the same
+   * buffer queue, stats and signals. Each thread waits for its clients in
+   * its own main context and the sockets are written to without holding the
+   * clients lock, so that many clients can be serviced in parallel.
+   *
+   * Changes take effect the next time the element is started.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Number of Threads",
+          "Number of threads that service the clients", 1, 64,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstMultiSocketSink::add:
    * @gstmultisocketsink: the multisocketsink element to emit this signal on
@@ -448,6 +488,8 @@ gst_multi_socket_sink_init (GstMultiSocketSink * this)
   this->cancellable = g_cancellable_new ();
   this->send_dispatched = DEFAULT_SEND_DISPATCHED;
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->max_messages = DEFAULT_MAX_MESSAGES;
+  this->n_threads = DEFAULT_N_THREADS;
 }
 
 static void
@@ -783,10 +825,37 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
-
   msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
 
+  /* file backed buffers without control messages go from the file to
+   * stream sockets without mapping. Datagram sockets keep one message per
+   * buffer with sendmsg(). GSocket ignores SIGPIPE, so a closed peer makes
+   * sendfile() fail with EPIPE */
+  if (msg_count == 0
+      && g_socket_get_socket_type (sock) == G_SOCKET_TYPE_STREAM) {
+    if (g_cancellable_set_error_if_cancelled (cancellable, err))
+      return -1;
+
+    wrote = gst_multi_handle_sink_sendfile (buffer, g_socket_get_fd (sock),
+        bufoffset);
+    if (wrote >= 0)
+      return wrote;
+
+    if (wrote == -1) {
+      gint errsv = errno;
+
+      if (errsv == EPIPE || errsv == ECONNRESET)
+        g_set_error (err, G_IO_ERROR, G_IO_ERROR_CLOSED, "%s",
+            g_strerror (errsv));
+      else
+        g_set_error (err, G_IO_ERROR, g_io_error_from_errno (errsv), "%s",
+            g_strerror (errsv));
+      return -1;
+    }
+  }
+
+  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
@@ -794,6 +863,163 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
   return wrote;
 }
 
+#define BATCH_VECTORS 8
+
+/* make sure the scratch arrays of @shard can hold @n_buffers datagrams */
+static void
+gst_multi_socket_sink_shard_ensure_scratch (GstMultiSocketSinkShard * shard,
+    guint n_buffers)
+{
+  if (shard->n_messages >= n_buffers)
+    return;
+
+  shard->messages = g_renew (GOutputMessage, shard->messages, n_buffers);
+  shard->vectors = g_renew (GOutputVector, shard->vectors,
+      n_buffers * BATCH_VECTORS);
+  shard->maps = g_renew (GstMapInfo, shard->maps, n_buffers * BATCH_VECTORS);
+  shard->buffers = g_renew (GstBuffer *, shard->buffers, n_buffers);
+  shard->n_messages = n_buffers;
+}
+
+/* Returns how many buffers at the start of @sending, at most @batch, can be
+ * sent with gst_multi_socket_sink_write_messages(). A datagram is mapped into
+ * at most BATCH_VECTORS vectors, buffers with more memories are sent on their
+ * own with gst_multi_socket_sink_write(). */
+static guint
+gst_multi_socket_sink_n_batchable (GSList * sending, guint batch)
+{
+  guint n = 0;
+
+  for (; sending != NULL && n < batch; sending = sending->next) {
+    if (gst_buffer_n_memory (GST_BUFFER (sending->data)) > BATCH_VECTORS)
+      break;
+    n++;
+  }
+
+  return n;
+}
+
+/* Sends the first @n_buffers buffers of @shard->buffers as one datagram each
+ * with a single call. The scratch arrays are only used by the thread of
+ * @shard so this can be called without the CLIENTS_LOCK. Returns the number
+ * of buffers that were sent or -1 on error. */
+static gint
+gst_multi_socket_sink_write_messages (GstMultiSocketSink * sink,
+    GstMultiSocketSinkShard * shard, GSocket * sock, guint n_buffers,
+    GCancellable * cancellable, GError ** err)
+{
+  GSocketControlMessage *cmsgs[CMSG_MAX];
+  guint i, n_maps = 0;
+  gsize msg_count = 0;
+  gint sent;
+
+  for (i = 0; i < n_buffers; i++) {
+    GstBuffer *buffer = shard->buffers[i];
+    GOutputMessage *msg = &shard->messages[i];
+    guint mapped;
+
+    mapped = map_n_memory_output_vector (buffer, 0, &shard->vectors[n_maps],
+        &shard->maps[n_maps], BATCH_VECTORS);
+
+    msg->address = NULL;
+    msg->vectors = &shard->vectors[n_maps];
+    msg->num_vectors = mapped;
+    msg->bytes_sent = 0;
+    /* control messages are collected into a shared array, they are only
+     * referenced until the call returns */
+    msg->control_messages = &cmsgs[msg_count];
+    msg->num_control_messages =
+        gst_buffer_get_cmsg_list (buffer, &cmsgs[msg_count],
+        CMSG_MAX - msg_count);
+    msg_count += msg->num_control_messages;
+
+    n_maps += mapped;
+  }
+
+  sent = g_socket_send_messages (sock, shard->messages, n_buffers, 0,
+      cancellable, err);
+
+  unmap_n_memorys (shard->maps, n_maps);
+
+  return sent;
+}
+
+/* take the next buffer from the global queue and queue it for sending to
+ * @client */
+static void
+gst_multi_socket_sink_client_take_buffer (GstMultiSocketSink * sink,
+    GstSocketClient * client)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+  GstMultiHandleSinkClass *mhsinkclass =
+      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
+  GstBuffer *buf;
+  GstClockTime timestamp;
+
+  /* grab buffer */
+  buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
+  mhclient->bufpos--;
+
+  /* update stats */
+  timestamp = GST_BUFFER_TIMESTAMP (buf);
+  if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
+    mhclient->first_buffer_ts = timestamp;
+  if (timestamp != -1)
+    mhclient->last_buffer_ts = timestamp;
+
+  /* decrease flushcount */
+  if (mhclient->flushcount != -1)
+    mhclient->flushcount--;
+
+  GST_LOG_OBJECT (sink, "%s client %p at position %d",
+      mhclient->debug, client, mhclient->bufpos);
+
+  /* queueing a buffer will ref it */
+  mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+
+  /* need to start from the first byte for this new buffer */
+  mhclient->bufoffset = 0;
+}
+
+/* @head, the first buffer of the sending queue of @client, was completely
+ * written */
+static void
+gst_multi_socket_sink_client_buffer_sent (GstMultiSocketSink * sink,
+    GstSocketClient * client, GstBuffer * head)
+{
+  GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
+  GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
+
+  if (sink->send_dispatched) {
+    gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
+        gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
+            gst_structure_new ("GstNetworkMessageDispatched",
+                "object", G_TYPE_OBJECT, mhclient->handle.socket,
+                "buffer", GST_TYPE_BUFFER, head, NULL)));
+  }
+  mhclient->sending = g_slist_remove (mhclient->sending, head);
+  gst_buffer_unref (head);
+  /* make sure we start from byte 0 for the next buffer */
+  mhclient->bufoffset = 0;
+}
+
+/* check that the first @n_buffers buffers that @mhclient is sending are
+ * still @buffers, after writing them without the CLIENTS_LOCK */
+static gboolean
+gst_multi_socket_sink_client_still_sending (GstMultiHandleClient * mhclient,
+    GstBuffer ** buffers, guint n_buffers)
+{
+  GSList *walk = mhclient->sending;
+  guint i;
+
+  for (i = 0; i < n_buffers; i++, walk = walk->next) {
+    if (walk == NULL || walk->data != buffers[i])
+      return FALSE;
+  }
+  return TRUE;
+}
+
 /* Handle a write on a client,
  * which indicates a read request from a client.
  *
@@ -814,6 +1040,12 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
  * When the sending returns a partial buffer we stop sending more data as
  * the next send operation could block.
  *
+ * With more than one shard, the CLIENTS_LOCK is released while writing to the
+ * socket so that the clients of other shards can be serviced at the same time.
+ * The caller must hold a ref on @client for that. The render thread can
+ * resync the client in the meantime, the result of the write is only applied
+ * when the client is still sending the same buffers afterwards.
+ *
  * This functions returns FALSE if some error occurred.
  */
 static gboolean
@@ -824,14 +1056,19 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   gboolean flushing;
   GstClockTime now;
   GError *err = NULL;
+  guint n_buffers;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleClient *mhclient = (GstMultiHandleClient *) client;
-  GstMultiHandleSinkClass *mhsinkclass =
-      GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
-
+  GstMultiSocketSinkShard *shard = &sink->shards[client->shard];
+  guint batch = 1;
+  gboolean unlock = sink->n_shards > 1;
 
   now = g_get_real_time () * GST_USECOND;
 
+  if (g_socket_get_socket_type (mhclient->handle.socket) ==
+      G_SOCKET_TYPE_DATAGRAM)
+    batch = g_atomic_int_get (&sink->max_messages);
+
   flushing = mhclient->status == GST_CLIENT_STATUS_FLUSHING;
 
   more = TRUE;
@@ -850,9 +1087,6 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         return TRUE;
       } else {
         /* client can pick a buffer from the global queue */
-        GstBuffer *buf;
-        GstClockTime timestamp;
-
         /* for new connections, we need to find a good spot in the
          * bufqueue to start streaming from */
         if (mhclient->new_connection && !flushing) {
@@ -874,44 +1108,127 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         if (mhclient->flushcount == 0)
           goto flushed;
 
-        /* grab buffer */
-        buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
-        mhclient->bufpos--;
+        gst_multi_socket_sink_client_take_buffer (sink, client);
 
-        /* update stats */
-        timestamp = GST_BUFFER_TIMESTAMP (buf);
-        if (mhclient->first_buffer_ts == GST_CLOCK_TIME_NONE)
-          mhclient->first_buffer_ts = timestamp;
-        if (timestamp != -1)
-          mhclient->last_buffer_ts = timestamp;
+        /* for datagrams, take more buffers to send them with one call */
+        if (batch > 1) {
+          while (g_slist_length (mhclient->sending) < batch &&
+              mhclient->bufpos >= 0 && mhclient->flushcount != 0)
+            gst_multi_socket_sink_client_take_buffer (sink, client);
+        }
+      }
+    }
 
-        /* decrease flushcount */
-        if (mhclient->flushcount != -1)
-          mhclient->flushcount--;
+    n_buffers = 0;
+    if (batch > 1 && mhclient->bufoffset == 0)
+      n_buffers = gst_multi_socket_sink_n_batchable (mhclient->sending, batch);
+
+    if (n_buffers > 0) {
+      GSList *walk;
+      gint sent;
+      guint i;
+
+      /* keep the buffers alive while we send without the lock, the client
+       * could be removed in the meantime */
+      gst_multi_socket_sink_shard_ensure_scratch (shard, n_buffers);
+      walk = mhclient->sending;
+      for (i = 0; i < n_buffers; i++, walk = walk->next)
+        shard->buffers[i] = gst_buffer_ref (walk->data);
+
+      if (unlock)
+        CLIENTS_UNLOCK (mhsink);
+      sent = gst_multi_socket_sink_write_messages (sink, shard,
+          mhclient->handle.socket, n_buffers, sink->cancellable, &err);
+      if (unlock)
+        CLIENTS_LOCK (mhsink);
+
+      if (mhclient->currently_removing) {
+        for (i = 0; i < n_buffers; i++)
+          gst_buffer_unref (shard->buffers[i]);
+        g_clear_error (&err);
+        goto removed;
+      }
 
-        GST_LOG_OBJECT (sink, "%s client %p at position %d",
-            mhclient->debug, client, mhclient->bufpos);
+      if (unlock && !gst_multi_socket_sink_client_still_sending (mhclient,
+              shard->buffers, n_buffers)) {
+        GST_DEBUG_OBJECT (sink, "%s was resynced while writing",
+            mhclient->debug);
+        for (i = 0; i < n_buffers; i++)
+          gst_buffer_unref (shard->buffers[i]);
+        g_clear_error (&err);
+        continue;
+      }
 
-        /* queueing a buffer will ref it */
-        mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
+      if (sent < 0) {
+        for (i = 0; i < n_buffers; i++)
+          gst_buffer_unref (shard->buffers[i]);
+        if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CLOSED)) {
+          goto connection_reset;
+        } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+          GST_LOG_OBJECT (sink, "write would block %p",
+              mhclient->handle.socket);
+          more = FALSE;
+          g_clear_error (&err);
+        } else {
+          goto write_error;
+        }
+      } else {
+        GST_LOG_OBJECT (sink, "sent %d of %u datagrams to %p", sent,
+            n_buffers, mhclient->handle.socket);
 
-        /* need to start from the first byte for this new buffer */
-        mhclient->bufoffset = 0;
-      }
-    }
+        /* datagrams are sent completely or not at all */
+        for (i = 0; i < (guint) sent; i++) {
+          GstBuffer *head = shard->buffers[i];
+          gsize size = gst_buffer_get_size (head);
+
+          gst_multi_socket_sink_client_buffer_sent (sink, client, head);
 
-    /* see if we need to send something */
-    if (mhclient->sending) {
+          mhclient->bytes_sent += size;
+          mhsink->bytes_served += size;
+        }
+        for (i = 0; i < n_buffers; i++)
+          gst_buffer_unref (shard->buffers[i]);
+        if (sent > 0)
+          mhclient->last_activity_time = now;
+        /* the socket did not take everything, it would block now */
+        if ((guint) sent < n_buffers)
+          more = FALSE;
+      }
+    } else if (mhclient->sending) {
+      /* see if we need to send something */
       gssize wrote;
       GstBuffer *head;
+      gsize bufoffset;
 
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
+      /* pick first buffer from list, we keep a ref while we write without the
+       * lock */
+      head = gst_buffer_ref (GST_BUFFER (mhclient->sending->data));
+      bufoffset = mhclient->bufoffset;
 
+      if (unlock)
+        CLIENTS_UNLOCK (mhsink);
       wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
+          bufoffset, sink->cancellable, &err);
+      if (unlock)
+        CLIENTS_LOCK (mhsink);
+
+      if (mhclient->currently_removing) {
+        gst_buffer_unref (head);
+        g_clear_error (&err);
+        goto removed;
+      }
+
+      if (unlock && (!gst_multi_socket_sink_client_still_sending (mhclient,
+                  &head, 1) || mhclient->bufoffset != bufoffset)) {
+        GST_DEBUG_OBJECT (sink, "%s was resynced while writing",
+            mhclient->debug);
+        gst_buffer_unref (head);
+        g_clear_error (&err);
+        continue;
+      }
 
       if (wrote < 0) {
+        gst_buffer_unref (head);
         /* hmm error.. */
         if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CLOSED)) {
           goto connection_reset;
@@ -925,26 +1242,17 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto write_error;
         }
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
+        if (wrote < (gst_buffer_get_size (head) - bufoffset)) {
           /* partial write, try again now */
           GST_LOG_OBJECT (sink,
               "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
               mhclient->handle.socket, wrote);
           mhclient->bufoffset += wrote;
         } else {
-          if (sink->send_dispatched) {
-            gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
-                gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
-                    gst_structure_new ("GstNetworkMessageDispatched",
-                        "object", G_TYPE_OBJECT, mhclient->handle.socket,
-                        "buffer", GST_TYPE_BUFFER, head, NULL)));
-          }
           /* complete buffer was written, we can proceed to the next one */
-          mhclient->sending = g_slist_remove (mhclient->sending, head);
-          gst_buffer_unref (head);
-          /* make sure we start from byte 0 for the next buffer */
-          mhclient->bufoffset = 0;
+          gst_multi_socket_sink_client_buffer_sent (sink, client, head);
         }
+        gst_buffer_unref (head);
         /* update stats */
         mhclient->bytes_sent += wrote;
         mhclient->last_activity_time = now;
@@ -956,6 +1264,12 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
   return TRUE;
 
   /* ERRORS */
+removed:
+  {
+    /* another thread removed the client while we were writing */
+    GST_DEBUG_OBJECT (sink, "%s was removed while writing", mhclient->debug);
+    return TRUE;
+  }
 flushed:
   {
     GST_DEBUG_OBJECT (sink, "%s flushed, removing", mhclient->debug);
@@ -994,13 +1308,13 @@ ensure_condition (GstMultiSocketSink * sink, GstSocketClient * client,
     g_source_destroy (client->source);
     g_source_unref (client->source);
   }
-  if (condition && sink->main_context) {
+  if (condition && sink->shards) {
     client->source = g_socket_create_source (mhclient->handle.socket,
         condition, sink->cancellable);
     g_source_set_callback (client->source,
         (GSourceFunc) gst_multi_socket_sink_socket_condition,
         gst_object_ref (sink), (GDestroyNotify) gst_object_unref);
-    g_source_attach (client->source, sink->main_context);
+    g_source_attach (client->source, sink->shards[client->shard].context);
   } else {
     client->source = NULL;
     condition = 0;
@@ -1015,6 +1329,13 @@ gst_multi_socket_sink_hash_adding (GstMultiHandleSink * mhsink,
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GstSocketClient *client = (GstSocketClient *) (mhclient);
 
+  /* distribute the clients over the shards, a client stays on its shard
+   * until it is removed */
+  if (sink->n_shards > 0) {
+    client->shard = sink->next_shard;
+    sink->next_shard = (sink->next_shard + 1) % sink->n_shards;
+  }
+
   ensure_condition (sink, client,
       G_IO_IN | G_IO_OUT | G_IO_PRI | G_IO_ERR | G_IO_HUP);
 }
@@ -1047,7 +1368,7 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
   GList *clink;
   GstSocketClient *client;
   gboolean ret = TRUE;
-  GstMultiHandleClient *mhclient;
+  GstMultiHandleClient *mhclient = NULL;
   GstMultiHandleSink *mhsink = GST_MULTI_HANDLE_SINK (sink);
   GstMultiHandleSinkClass *mhsinkclass =
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
@@ -1062,6 +1383,8 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
 
   client = clink->data;
   mhclient = (GstMultiHandleClient *) client;
+  /* the write below releases the lock, keep the client alive */
+  gst_multi_handle_sink_client_ref (mhclient);
 
   if (mhclient->status != GST_CLIENT_STATUS_FLUSHING
       && mhclient->status != GST_CLIENT_STATUS_OK) {
@@ -1093,7 +1416,10 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
   if ((condition & G_IO_OUT)) {
     /* handle client write */
     if (!gst_multi_socket_sink_handle_client_write (sink, client)) {
-      gst_multi_handle_sink_remove_client_link (mhsink, clink);
+      /* the link could have changed while the lock was released */
+      clink = g_list_find (mhsink->clients, client);
+      if (clink)
+        gst_multi_handle_sink_remove_client_link (mhsink, clink);
       ret = FALSE;
       goto done;
     }
@@ -1102,6 +1428,9 @@ gst_multi_socket_sink_socket_condition (GstMultiSinkHandle handle,
 done:
   CLIENTS_UNLOCK (mhsink);
 
+  if (mhclient)
+    gst_multi_handle_sink_client_unref (mhsink, mhclient);
+
   return ret;
 }
 
@@ -1132,6 +1461,18 @@ gst_multi_socket_sink_timeout (GstMultiSocketSink * sink)
   return FALSE;
 }
 
+/* services the clients of one of the additional shards */
+static gpointer
+gst_multi_socket_sink_shard_thread (GstMultiSocketSinkShard * shard)
+{
+  GstMultiHandleSink *mhsink = shard->sink;
+
+  while (mhsink->running)
+    g_main_context_iteration (shard->context, TRUE);
+
+  return NULL;
+}
+
 /* we handle the client communication in another thread so that we do not block
  * the gstreamer thread while we select() on the client fds */
 static gpointer
@@ -1139,6 +1480,16 @@ gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *sink = GST_MULTI_SOCKET_SINK (mhsink);
   GSource *timeout = NULL;
+  guint i;
+
+  /* this thread services the first shard, start the others */
+  for (i = 1; i < sink->n_shards; i++) {
+    gchar *name = g_strdup_printf ("%s-%u", GST_OBJECT_NAME (sink), i);
+
+    sink->shards[i].thread = g_thread_new (name,
+        (GThreadFunc) gst_multi_socket_sink_shard_thread, &sink->shards[i]);
+    g_free (name);
+  }
 
   while (mhsink->running) {
     if (mhsink->timeout > 0) {
@@ -1162,6 +1513,12 @@ gst_multi_socket_sink_thread (GstMultiHandleSink * mhsink)
     }
   }
 
+  /* stop_pre() woke up all shards */
+  for (i = 1; i < sink->n_shards; i++) {
+    g_thread_join (sink->shards[i].thread);
+    sink->shards[i].thread = NULL;
+  }
+
   return NULL;
 }
 
@@ -1178,6 +1535,12 @@ gst_multi_socket_sink_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       sink->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_MAX_MESSAGES:
+      g_atomic_int_set (&sink->max_messages, g_value_get_uint (value));
+      break;
+    case PROP_N_THREADS:
+      g_atomic_int_set (&sink->n_threads, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1197,6 +1560,12 @@ gst_multi_socket_sink_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, sink->send_messages);
       break;
+    case PROP_MAX_MESSAGES:
+      g_value_set_uint (value, g_atomic_int_get (&sink->max_messages));
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, g_atomic_int_get (&sink->n_threads));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1211,9 +1580,18 @@ gst_multi_socket_sink_start_pre (GstMultiHandleSink * mhsink)
       GST_MULTI_HANDLE_SINK_GET_CLASS (mhsink);
   GList *clients;
 
+  guint i;
+
   GST_INFO_OBJECT (mssink, "starting");
 
-  mssink->main_context = g_main_context_new ();
+  mssink->n_shards = MAX (g_atomic_int_get (&mssink->n_threads), 1);
+  mssink->next_shard = 0;
+  mssink->shards = g_new0 (GstMultiSocketSinkShard, mssink->n_shards);
+  for (i = 0; i < mssink->n_shards; i++) {
+    mssink->shards[i].sink = mhsink;
+    mssink->shards[i].context = g_main_context_new ();
+  }
+  mssink->main_context = mssink->shards[0].context;
 
   CLIENTS_LOCK (mhsink);
   for (clients = mhsink->clients; clients; clients = clients->next) {
@@ -1235,24 +1613,42 @@ multisocketsink_hash_remove (gpointer key, gpointer value, gpointer data)
   return TRUE;
 }
 
+static void
+gst_multi_socket_sink_wakeup (GstMultiSocketSink * sink)
+{
+  guint i;
+
+  for (i = 0; i < sink->n_shards; i++)
+    g_main_context_wakeup (sink->shards[i].context);
+}
+
 static void
 gst_multi_socket_sink_stop_pre (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
 
-  if (mssink->main_context)
-    g_main_context_wakeup (mssink->main_context);
+  gst_multi_socket_sink_wakeup (mssink);
 }
 
 static void
 gst_multi_socket_sink_stop_post (GstMultiHandleSink * mhsink)
 {
   GstMultiSocketSink *mssink = GST_MULTI_SOCKET_SINK (mhsink);
+  guint i;
+
+  for (i = 0; i < mssink->n_shards; i++) {
+    GstMultiSocketSinkShard *shard = &mssink->shards[i];
 
-  if (mssink->main_context) {
-    g_main_context_unref (mssink->main_context);
-    mssink->main_context = NULL;
+    g_main_context_unref (shard->context);
+    g_free (shard->messages);
+    g_free (shard->vectors);
+    g_free (shard->maps);
+    g_free (shard->buffers);
   }
+  g_free (mssink->shards);
+  mssink->shards = NULL;
+  mssink->n_shards = 0;
+  mssink->main_context = NULL;
 
   g_hash_table_foreach_remove (mhsink->handle_hash, multisocketsink_hash_remove,
       mssink);
@@ -1267,8 +1663,7 @@ gst_multi_socket_sink_unlock (GstBaseSink * bsink)
 
   GST_DEBUG_OBJECT (sink, "set to flushing");
   g_cancellable_cancel (sink->cancellable);
-  if (sink->main_context)
-    g_main_context_wakeup (sink->main_context);
+  gst_multi_socket_sink_wakeup (sink);
 
   return TRUE;
 }
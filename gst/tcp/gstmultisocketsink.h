@@ -55,8 +55,26 @@ typedef struct {
 
   GSource *source;
   GIOCondition condition;
+
+  /* index of the shard that services this client */
+  guint shard;
 } GstSocketClient;
 
+/* A worker thread with its own main context that services a subset of the
+ * clients */
+typedef struct {
+  GstMultiHandleSink *sink;
+  GMainContext *context;
+  GThread *thread;
+
+  /* scratch space for batched sends */
+  GOutputMessage *messages;
+  GOutputVector *vectors;
+  GstMapInfo *maps;
+  GstBuffer **buffers;
+  guint n_messages;
+} GstMultiSocketSinkShard;
+
 /**
  * GstMultiSocketSink:
  *
@@ -70,6 +88,14 @@ struct _GstMultiSocketSink {
   GCancellable *cancellable;
   gboolean send_messages;
   gboolean send_dispatched;
+  guint max_messages;
+  guint n_threads;
+
+  /* the first shard runs in the GstMultiHandleSink thread and uses
+   * main_context, the other shards run their own thread */
+  GstMultiSocketSinkShard *shards;
+  guint n_shards;
+  guint next_shard;
 };
 
 struct _GstMultiSocketSinkClass {
@@ -67,13 +67,15 @@ static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
 
 
 #define DEFAULT_SEND_MESSAGES FALSE
+#define DEFAULT_MAX_MESSAGES  1
 
 enum
 {
   PROP_0,
   PROP_SOCKET,
   PROP_CAPS,
-  PROP_SEND_MESSAGES
+  PROP_SEND_MESSAGES,
+  PROP_MAX_MESSAGES
 };
 
 enum
@@ -94,6 +96,8 @@ static GstCaps *gst_socketsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_socketsrc_event (GstBaseSrc * src, GstEvent * event);
 static GstFlowReturn gst_socket_src_fill (GstPushSrc * psrc,
     GstBuffer * outbuf);
+static GstFlowReturn gst_socket_src_create (GstPushSrc * psrc,
+    GstBuffer ** outbuf);
 static gboolean gst_socket_src_unlock (GstBaseSrc * bsrc);
 static gboolean gst_socket_src_unlock_stop (GstBaseSrc * bsrc);
 
@@ -149,6 +153,23 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
           "If GstNetworkMessage events should be handled",
           DEFAULT_SEND_MESSAGES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSocketSrc:max-messages:
+   *
+   * The maximum number of datagrams to read from a datagram socket with a
+   * single g_socket_receive_messages() call. When more than one datagram is
+   * read, they are pushed downstream as a #GstBufferList.
+   *
+   * This has no effect on stream sockets.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_MESSAGES,
+      g_param_spec_uint ("max-messages", "Max Messages",
+          "Maximum number of datagrams to read in one call",
+          1, 1024, DEFAULT_MAX_MESSAGES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_socket_src_signals[CONNECTION_CLOSED_BY_PEER] =
       g_signal_new ("connection-closed-by-peer", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_FIRST, G_STRUCT_OFFSET (GstSocketSrcClass,
@@ -167,6 +188,7 @@ gst_socket_src_class_init (GstSocketSrcClass * klass)
   gstbasesrc_class->unlock = gst_socket_src_unlock;
   gstbasesrc_class->unlock_stop = gst_socket_src_unlock_stop;
 
+  gstpush_src_class->create = gst_socket_src_create;
   gstpush_src_class->fill = gst_socket_src_fill;
 
   GST_DEBUG_CATEGORY_INIT (socketsrc_debug, "socketsrc", 0, "Socket Source");
@@ -178,6 +200,7 @@ gst_socket_src_init (GstSocketSrc * this)
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
   this->send_messages = DEFAULT_SEND_MESSAGES;
+  this->max_messages = DEFAULT_MAX_MESSAGES;
 }
 
 static void
@@ -383,6 +406,149 @@ no_socket:
   }
 }
 
+#if GLIB_CHECK_VERSION(2,48,0)
+/* read up to @max_messages datagrams with one call, a single datagram is
+ * returned in @outbuf, more are submitted as a buffer list */
+static GstFlowReturn
+gst_socket_src_receive_messages (GstSocketSrc * src, GSocket * socket,
+    guint max_messages, GstBuffer ** outbuf)
+{
+  GstBaseSrc *bsrc = GST_BASE_SRC (src);
+  GstBaseSrcClass *bclass = GST_BASE_SRC_GET_CLASS (src);
+  GstFlowReturn ret = GST_FLOW_OK;
+  GInputMessage *msgs;
+  GInputVector *ivecs;
+  GstBuffer **bufs;
+  GstMapInfo *maps;
+  GSocketControlMessage ***messages;
+  guint *num_messages;
+  GError *err = NULL;
+  guint blocksize, n_received, i, j;
+  gint received;
+
+  msgs = g_newa (GInputMessage, max_messages);
+  ivecs = g_newa (GInputVector, max_messages);
+  bufs = g_newa (GstBuffer *, max_messages);
+  maps = g_newa (GstMapInfo, max_messages);
+  messages = g_newa (GSocketControlMessage **, max_messages);
+  num_messages = g_newa (guint, max_messages);
+
+  blocksize = gst_base_src_get_blocksize (bsrc);
+
+  for (i = 0; i < max_messages; i++) {
+    ret = bclass->alloc (bsrc, -1, blocksize, &bufs[i]);
+    if (ret != GST_FLOW_OK) {
+      for (j = 0; j < i; j++)
+        gst_buffer_unmap (bufs[j], &maps[j]);
+      max_messages = i;
+      goto done;
+    }
+    gst_buffer_map (bufs[i], &maps[i], GST_MAP_READWRITE);
+    ivecs[i].buffer = maps[i].data;
+    ivecs[i].size = maps[i].size;
+
+    msgs[i].address = NULL;
+    msgs[i].vectors = &ivecs[i];
+    msgs[i].num_vectors = 1;
+    msgs[i].bytes_received = 0;
+    msgs[i].flags = 0;
+    msgs[i].control_messages = &messages[i];
+    msgs[i].num_control_messages = &num_messages[i];
+    messages[i] = NULL;
+    num_messages[i] = 0;
+  }
+
+  received = g_socket_receive_messages (socket, msgs, max_messages, 0,
+      src->cancellable, &err);
+
+  for (i = 0; i < max_messages; i++)
+    gst_buffer_unmap (bufs[i], &maps[i]);
+
+  if (received < 0) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      ret = GST_FLOW_FLUSHING;
+      GST_DEBUG_OBJECT (src, "Cancelled reading from socket");
+    } else {
+      ret = GST_FLOW_ERROR;
+      GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
+          ("Failed to read from socket: %s", err->message));
+    }
+    g_clear_error (&err);
+    goto done;
+  }
+
+  if (received == 0) {
+    GST_DEBUG_OBJECT (src, "No datagrams received, forwarding EOS");
+    ret = GST_FLOW_EOS;
+    goto done;
+  }
+
+  n_received = received;
+  GST_LOG_OBJECT (src, "received %u datagrams", n_received);
+
+  for (i = 0; i < n_received; i++) {
+    gst_buffer_resize (bufs[i], 0, msgs[i].bytes_received);
+
+    for (j = 0; j < num_messages[i]; j++) {
+      gst_buffer_add_net_control_message_meta (bufs[i], messages[i][j]);
+      g_object_unref (messages[i][j]);
+    }
+    g_free (messages[i]);
+  }
+
+  if (n_received == 1) {
+    *outbuf = bufs[0];
+  } else {
+    GstBufferList *list = gst_buffer_list_new_sized (n_received);
+
+    for (i = 0; i < n_received; i++)
+      gst_buffer_list_add (list, bufs[i]);
+    gst_base_src_submit_buffer_list (bsrc, list);
+    *outbuf = NULL;
+  }
+
+  /* drop the buffers that were not filled */
+  for (i = n_received; i < max_messages; i++)
+    gst_buffer_unref (bufs[i]);
+
+  return GST_FLOW_OK;
+
+done:
+  for (i = 0; i < max_messages; i++)
+    gst_buffer_unref (bufs[i]);
+
+  return ret;
+}
+#endif
+
+static GstFlowReturn
+gst_socket_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
+{
+#if GLIB_CHECK_VERSION(2,48,0)
+  GstSocketSrc *src = GST_SOCKET_SRC (psrc);
+  GSocket *socket = NULL;
+  guint max_messages;
+
+  GST_OBJECT_LOCK (src);
+  max_messages = src->max_messages;
+  if (max_messages > 1 && src->socket &&
+      g_socket_get_socket_type (src->socket) == G_SOCKET_TYPE_DATAGRAM)
+    socket = g_object_ref (src->socket);
+  GST_OBJECT_UNLOCK (src);
+
+  if (socket != NULL) {
+    GstFlowReturn ret;
+
+    ret = gst_socket_src_receive_messages (src, socket, max_messages, outbuf);
+    g_object_unref (socket);
+
+    return ret;
+  }
+#endif
+
+  return GST_PUSH_SRC_CLASS (parent_class)->create (psrc, outbuf);
+}
+
 static void
 gst_socket_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -424,6 +590,11 @@ gst_socket_src_set_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       socketsrc->send_messages = g_value_get_boolean (value);
       break;
+    case PROP_MAX_MESSAGES:
+      GST_OBJECT_LOCK (socketsrc);
+      socketsrc->max_messages = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (socketsrc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -448,6 +619,11 @@ gst_socket_src_get_property (GObject * object, guint prop_id,
     case PROP_SEND_MESSAGES:
       g_value_set_boolean (value, socketsrc->send_messages);
       break;
+    case PROP_MAX_MESSAGES:
+      GST_OBJECT_LOCK (socketsrc);
+      g_value_set_uint (value, socketsrc->max_messages);
+      GST_OBJECT_UNLOCK (socketsrc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -51,6 +51,7 @@ struct _GstSocketSrc {
   GstCaps *caps;
   GSocket *socket;
   gboolean send_messages;
+  guint max_messages;
   GCancellable *cancellable;
 };
 
@@ -36,6 +36,12 @@
  *  everything you type in the client is shown on the server (fd=1 means
  * standard input which is the command line input file descriptor)
  *
+ * Buffers and buffer lists are written with one vectored send each. With
+ * #GstTCPClientSink:coalesce-bytes set, consecutive buffers are gathered
+ * and sent together once that many bytes or
+ * #GstTCPClientSink:coalesce-time worth of data are pending, which saves a
+ * syscall per buffer for streams of many small buffers.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -61,9 +67,17 @@ enum
 {
   PROP_0,
   PROP_HOST,
-  PROP_PORT
+  PROP_PORT,
+  PROP_COALESCE_BYTES,
+  PROP_COALESCE_TIME
 };
 
+#define DEFAULT_COALESCE_BYTES 0
+#define DEFAULT_COALESCE_TIME (20 * GST_MSECOND)
+
+/* the most memories written with one send */
+#define MAX_VECTORS 64
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -75,6 +89,10 @@ static gboolean gst_tcp_client_sink_setcaps (GstBaseSink * bsink,
     GstCaps * caps);
 static GstFlowReturn gst_tcp_client_sink_render (GstBaseSink * bsink,
     GstBuffer * buf);
+static GstFlowReturn gst_tcp_client_sink_render_list (GstBaseSink * bsink,
+    GstBufferList * list);
+static gboolean gst_tcp_client_sink_event (GstBaseSink * bsink,
+    GstEvent * event);
 static gboolean gst_tcp_client_sink_start (GstBaseSink * bsink);
 static gboolean gst_tcp_client_sink_stop (GstBaseSink * bsink);
 static gboolean gst_tcp_client_sink_unlock (GstBaseSink * bsink);
@@ -116,6 +134,34 @@ gst_tcp_client_sink_class_init (GstTCPClientSinkClass * klass)
           0, TCP_HIGHEST_PORT, TCP_DEFAULT_PORT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTCPClientSink:coalesce-bytes:
+   *
+   * Gather consecutive buffers until this many bytes are pending and send
+   * them with a single call. 0 sends every buffer right away.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_COALESCE_BYTES,
+      g_param_spec_uint ("coalesce-bytes", "Coalesce bytes",
+          "Gather buffers until this many bytes are pending "
+          "(0 = send every buffer)", 0, G_MAXUINT, DEFAULT_COALESCE_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTCPClientSink:coalesce-time:
+   *
+   * When coalescing, also send the pending buffers once their timestamps
+   * span this much time. 0 only uses #GstTCPClientSink:coalesce-bytes.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_COALESCE_TIME,
+      g_param_spec_uint64 ("coalesce-time", "Coalesce time",
+          "Send gathered buffers once they span this much time in ns "
+          "(0 = unlimited)", 0, G_MAXUINT64, DEFAULT_COALESCE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -127,6 +173,8 @@ gst_tcp_client_sink_class_init (GstTCPClientSinkClass * klass)
   gstbasesink_class->stop = gst_tcp_client_sink_stop;
   gstbasesink_class->set_caps = gst_tcp_client_sink_setcaps;
   gstbasesink_class->render = gst_tcp_client_sink_render;
+  gstbasesink_class->render_list = gst_tcp_client_sink_render_list;
+  gstbasesink_class->event = gst_tcp_client_sink_event;
   gstbasesink_class->unlock = gst_tcp_client_sink_unlock;
   gstbasesink_class->unlock_stop = gst_tcp_client_sink_unlock_stop;
 
@@ -142,6 +190,13 @@ gst_tcp_client_sink_init (GstTCPClientSink * this)
   this->socket = NULL;
   this->cancellable = g_cancellable_new ();
 
+  this->pending = g_ptr_array_new_with_free_func (
+      (GDestroyNotify) gst_buffer_unref);
+  this->pending_size = 0;
+  this->pending_ts = GST_CLOCK_TIME_NONE;
+  this->coalesce_bytes = DEFAULT_COALESCE_BYTES;
+  this->coalesce_time = DEFAULT_COALESCE_TIME;
+
   GST_OBJECT_FLAG_UNSET (this, GST_TCP_CLIENT_SINK_OPEN);
 }
 
@@ -161,6 +216,8 @@ gst_tcp_client_sink_finalize (GObject * gobject)
   g_free (this->host);
   this->host = NULL;
 
+  g_ptr_array_unref (this->pending);
+
   G_OBJECT_CLASS (parent_class)->finalize (gobject);
 }
 
@@ -170,34 +227,103 @@ gst_tcp_client_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   return TRUE;
 }
 
-static GstFlowReturn
-gst_tcp_client_sink_render (GstBaseSink * bsink, GstBuffer * buf)
+/* Writes all memories of @buffers with as few vectored sends as possible.
+ * @written is set to the number of bytes that were sent, also when this
+ * fails. */
+static gboolean
+gst_tcp_client_sink_write_buffers (GstTCPClientSink * sink,
+    GstBuffer ** buffers, guint n_buffers, gsize * written, GError ** err)
 {
-  GstTCPClientSink *sink;
-  GstMapInfo map;
-  gsize written = 0;
-  gssize rret;
-  GError *err = NULL;
+  GOutputVector vecs[MAX_VECTORS];
+  GstMapInfo maps[MAX_VECTORS];
+  guint idx = 0, mem_idx = 0;
+  gsize mem_offset = 0;
+
+  *written = 0;
+
+  while (idx < n_buffers) {
+    guint n_vecs = 0, b = idx, m = mem_idx, i;
+    gsize skip = mem_offset;
+    gssize rret;
+
+    /* map as many memories as fit, starting where the last send stopped */
+    while (b < n_buffers && n_vecs < MAX_VECTORS) {
+      GstMemory *mem;
+
+      if (m >= gst_buffer_n_memory (buffers[b])) {
+        b++;
+        m = 0;
+        continue;
+      }
 
-  sink = GST_TCP_CLIENT_SINK (bsink);
+      mem = gst_buffer_peek_memory (buffers[b], m);
+      if (!gst_memory_map (mem, &maps[n_vecs], GST_MAP_READ)) {
+        for (i = 0; i < n_vecs; i++)
+          gst_memory_unmap (maps[i].memory, &maps[i]);
+        g_set_error (err, G_IO_ERROR, G_IO_ERROR_FAILED,
+            "Failed to map memory");
+        return FALSE;
+      }
+      vecs[n_vecs].buffer = maps[n_vecs].data + skip;
+      vecs[n_vecs].size = maps[n_vecs].size - skip;
+      skip = 0;
+      n_vecs++;
+      m++;
+    }
 
-  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
-      GST_FLOW_FLUSHING);
+    if (n_vecs == 0)
+      break;
 
-  gst_buffer_map (buf, &map, GST_MAP_READ);
-  GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes for buffer data",
-      map.size);
+    GST_LOG_OBJECT (sink, "writing %u memories", n_vecs);
+
+    rret = g_socket_send_message (sink->socket, NULL, vecs, n_vecs, NULL, 0,
+        0, sink->cancellable, err);
+
+    for (i = 0; i < n_vecs; i++)
+      gst_memory_unmap (maps[i].memory, &maps[i]);
 
-  /* write buffer data */
-  while (written < map.size) {
-    rret =
-        g_socket_send (sink->socket, (gchar *) map.data + written,
-        map.size - written, sink->cancellable, &err);
     if (rret < 0)
-      goto write_error;
-    written += rret;
+      return FALSE;
+
+    *written += rret;
+
+    /* skip over the bytes that were sent */
+    while (idx < n_buffers) {
+      gsize avail;
+
+      if (mem_idx >= gst_buffer_n_memory (buffers[idx])) {
+        idx++;
+        mem_idx = 0;
+        continue;
+      }
+
+      avail = gst_buffer_peek_memory (buffers[idx], mem_idx)->size - mem_offset;
+      if ((gsize) rret < avail) {
+        mem_offset += rret;
+        break;
+      }
+      rret -= avail;
+      mem_idx++;
+      mem_offset = 0;
+    }
   }
-  gst_buffer_unmap (buf, &map);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_tcp_client_sink_send (GstTCPClientSink * sink, GstBuffer ** buffers,
+    guint n_buffers, gsize size)
+{
+  gsize written;
+  GError *err = NULL;
+
+  if (n_buffers == 0)
+    return GST_FLOW_OK;
+
+  if (!gst_tcp_client_sink_write_buffers (sink, buffers, n_buffers, &written,
+          &err))
+    goto write_error;
 
   sink->data_written += written;
 
@@ -215,15 +341,134 @@ write_error:
       GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
           (_("Error while sending data to \"%s:%d\"."), sink->host, sink->port),
           ("Only %" G_GSIZE_FORMAT " of %" G_GSIZE_FORMAT " bytes written: %s",
-              written, map.size, err->message));
+              written, size, err->message));
       ret = GST_FLOW_ERROR;
     }
-    gst_buffer_unmap (buf, &map);
     g_clear_error (&err);
     return ret;
   }
 }
 
+/* sends and releases the gathered buffers */
+static GstFlowReturn
+gst_tcp_client_sink_send_pending (GstTCPClientSink * sink)
+{
+  GstFlowReturn ret;
+
+  ret = gst_tcp_client_sink_send (sink, (GstBuffer **) sink->pending->pdata,
+      sink->pending->len, sink->pending_size);
+
+  g_ptr_array_set_size (sink->pending, 0);
+  sink->pending_size = 0;
+  sink->pending_ts = GST_CLOCK_TIME_NONE;
+
+  return ret;
+}
+
+static void
+gst_tcp_client_sink_add_pending (GstTCPClientSink * sink, GstBuffer * buf)
+{
+  GstClockTime ts = GST_BUFFER_DTS_OR_PTS (buf);
+
+  if (!GST_CLOCK_TIME_IS_VALID (sink->pending_ts))
+    sink->pending_ts = ts;
+
+  g_ptr_array_add (sink->pending, gst_buffer_ref (buf));
+  sink->pending_size += gst_buffer_get_size (buf);
+}
+
+/* whether the gathered buffers exceed the byte or time budget */
+static gboolean
+gst_tcp_client_sink_pending_full (GstTCPClientSink * sink, GstBuffer * last)
+{
+  GstClockTime ts;
+
+  if (sink->pending_size >= sink->coalesce_bytes)
+    return TRUE;
+
+  ts = GST_BUFFER_DTS_OR_PTS (last);
+  if (sink->coalesce_time > 0 && GST_CLOCK_TIME_IS_VALID (ts) &&
+      GST_CLOCK_TIME_IS_VALID (sink->pending_ts) &&
+      ts >= sink->pending_ts + sink->coalesce_time)
+    return TRUE;
+
+  return FALSE;
+}
+
+static GstFlowReturn
+gst_tcp_client_sink_render (GstBaseSink * bsink, GstBuffer * buf)
+{
+  GstTCPClientSink *sink;
+
+  sink = GST_TCP_CLIENT_SINK (bsink);
+
+  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
+      GST_FLOW_FLUSHING);
+
+  if (sink->coalesce_bytes == 0 && sink->pending->len == 0) {
+    GST_LOG_OBJECT (sink, "writing %" G_GSIZE_FORMAT " bytes for buffer data",
+        gst_buffer_get_size (buf));
+    return gst_tcp_client_sink_send (sink, &buf, 1, gst_buffer_get_size (buf));
+  }
+
+  gst_tcp_client_sink_add_pending (sink, buf);
+  if (!gst_tcp_client_sink_pending_full (sink, buf))
+    return GST_FLOW_OK;
+
+  return gst_tcp_client_sink_send_pending (sink);
+}
+
+static GstFlowReturn
+gst_tcp_client_sink_render_list (GstBaseSink * bsink, GstBufferList * list)
+{
+  GstTCPClientSink *sink;
+  guint i, len;
+
+  sink = GST_TCP_CLIENT_SINK (bsink);
+
+  g_return_val_if_fail (GST_OBJECT_FLAG_IS_SET (sink, GST_TCP_CLIENT_SINK_OPEN),
+      GST_FLOW_FLUSHING);
+
+  len = gst_buffer_list_length (list);
+  if (len == 0)
+    return GST_FLOW_OK;
+
+  for (i = 0; i < len; i++)
+    gst_tcp_client_sink_add_pending (sink, gst_buffer_list_get (list, i));
+
+  /* without coalescing the whole list still goes out in one go */
+  if (sink->coalesce_bytes > 0 &&
+      !gst_tcp_client_sink_pending_full (sink,
+          gst_buffer_list_get (list, len - 1)))
+    return GST_FLOW_OK;
+
+  return gst_tcp_client_sink_send_pending (sink);
+}
+
+static gboolean
+gst_tcp_client_sink_event (GstBaseSink * bsink, GstEvent * event)
+{
+  GstTCPClientSink *sink = GST_TCP_CLIENT_SINK (bsink);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_EOS:
+      /* don't keep anything back at the end of the stream */
+      if (sink->pending->len > 0 &&
+          gst_tcp_client_sink_send_pending (sink) != GST_FLOW_OK)
+        GST_WARNING_OBJECT (sink, "failed to send pending buffers on EOS");
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      g_ptr_array_set_size (sink->pending, 0);
+      sink->pending_size = 0;
+      sink->pending_ts = GST_CLOCK_TIME_NONE;
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->event (bsink, event);
+}
+
 static void
 gst_tcp_client_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -245,6 +490,12 @@ gst_tcp_client_sink_set_property (GObject * object, guint prop_id,
     case PROP_PORT:
       tcpclientsink->port = g_value_get_int (value);
       break;
+    case PROP_COALESCE_BYTES:
+      tcpclientsink->coalesce_bytes = g_value_get_uint (value);
+      break;
+    case PROP_COALESCE_TIME:
+      tcpclientsink->coalesce_time = g_value_get_uint64 (value);
+      break;
 
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -268,6 +519,12 @@ gst_tcp_client_sink_get_property (GObject * object, guint prop_id,
     case PROP_PORT:
       g_value_set_int (value, tcpclientsink->port);
       break;
+    case PROP_COALESCE_BYTES:
+      g_value_set_uint (value, tcpclientsink->coalesce_bytes);
+      break;
+    case PROP_COALESCE_TIME:
+      g_value_set_uint64 (value, tcpclientsink->coalesce_time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -396,6 +653,10 @@ gst_tcp_client_sink_stop (GstBaseSink * bsink)
     this->socket = NULL;
   }
 
+  g_ptr_array_set_size (this->pending, 0);
+  this->pending_size = 0;
+  this->pending_ts = GST_CLOCK_TIME_NONE;
+
   GST_OBJECT_FLAG_UNSET (this, GST_TCP_CLIENT_SINK_OPEN);
 
   return TRUE;
@@ -63,6 +63,14 @@ struct _GstTCPClientSink {
   GCancellable *cancellable;
 
   size_t data_written; /* how much bytes have we written ? */
+
+  /* buffers gathered for the next send */
+  GPtrArray *pending;
+  gsize pending_size;
+  GstClockTime pending_ts;
+
+  guint coalesce_bytes;
+  GstClockTime coalesce_time;
 };
 
 struct _GstTCPClientSinkClass {
@@ -242,8 +242,14 @@ gst_tcp_client_src_create (GstPushSrc * psrc, GstBuffer ** outbuf)
 
   if (avail > 0) {
     read = MIN (avail, MAX_READ_SIZE);
-    *outbuf = gst_buffer_new_and_alloc (read);
+    /* this goes through the negotiated buffer pool if there is one, its
+     * buffers can be smaller than what is available */
+    ret = GST_BASE_SRC_GET_CLASS (src)->alloc (GST_BASE_SRC (src), -1, read,
+        outbuf);
+    if (ret != GST_FLOW_OK)
+      goto alloc_failed;
     gst_buffer_map (*outbuf, &map, GST_MAP_READWRITE);
+    read = MIN (read, map.size);
     rret =
         g_socket_receive (src->socket, (gchar *) map.data, read,
         src->cancellable, &err);
@@ -306,6 +312,13 @@ select_error:
     g_clear_error (&err);
     return ret;
   }
+alloc_failed:
+  {
+    GST_DEBUG_OBJECT (src, "failed to allocate buffer: %s",
+        gst_flow_get_name (ret));
+    *outbuf = NULL;
+    return ret;
+  }
 get_available_error:
   {
     GST_ELEMENT_ERROR (src, RESOURCE, READ, (NULL),
@@ -5845,6 +5845,102 @@ sw_data_destroy (GstTypeFindData * sw_data)
   g_slice_free (GstTypeFindData, sw_data);
 }
 
+/*** index of the fixed magics, dispatched on the first byte ***/
+
+/* Most start-with and riff types are certain as soon as their magic matches,
+ * but each of them is still its own factory, so the helper has to go through
+ * all the heavier scanners ranked above them before it gets to them. The
+ * certain ones are also added to this index and tried at once by a single
+ * finder ranked just above primary, which makes the helper stop early. The
+ * factories themselves stay registered for their extensions and caps. */
+typedef struct
+{
+  const guint8 *data;
+  guint size;
+  guint rank;
+  GstCaps *caps;
+}
+TypeFindMagic;
+
+#define MAGIC_TYPE_FIND_RANK (GST_RANK_PRIMARY + 1)
+
+static GArray *magic_index[256];
+static GArray *magic_riff_index;
+
+static void
+magic_index_add (GArray ** index, const GstTypeFindData * sw_data, guint rank)
+{
+  TypeFindMagic magic;
+
+  if (sw_data->probability < GST_TYPE_FIND_MAXIMUM
+      || rank < GST_RANK_SECONDARY || sw_data->size == 0)
+    return;
+
+  if (*index == NULL)
+    *index = g_array_new (FALSE, FALSE, sizeof (TypeFindMagic));
+
+  magic.data = sw_data->data;
+  magic.size = sw_data->size;
+  magic.rank = rank;
+  magic.caps = gst_caps_ref (sw_data->caps);
+  g_array_append_val (*index, magic);
+}
+
+/* higher rank first, then by name, which is the order in which the
+ * individual factories would have been tried */
+static gboolean
+magic_is_preferred (const TypeFindMagic * magic, const TypeFindMagic * best)
+{
+  if (best == NULL || magic->rank > best->rank)
+    return TRUE;
+  if (magic->rank < best->rank)
+    return FALSE;
+
+  return strcmp (gst_structure_get_name (gst_caps_get_structure (magic->caps,
+              0)), gst_structure_get_name (gst_caps_get_structure (best->caps,
+              0))) < 0;
+}
+
+static void
+magic_type_find (GstTypeFind * tf, gpointer unused)
+{
+  const TypeFindMagic *best = NULL;
+  const guint8 *data;
+  GArray *index;
+  guint i;
+
+  data = gst_type_find_peek (tf, 0, 1);
+  if (data == NULL)
+    return;
+
+  index = magic_index[data[0]];
+  for (i = 0; index != NULL && i < index->len; i++) {
+    const TypeFindMagic *magic = &g_array_index (index, TypeFindMagic, i);
+
+    if (!magic_is_preferred (magic, best))
+      continue;
+
+    data = gst_type_find_peek (tf, 0, magic->size);
+    if (data && memcmp (data, magic->data, magic->size) == 0)
+      best = magic;
+  }
+
+  if (magic_riff_index != NULL && (data = gst_type_find_peek (tf, 0, 12))
+      && (memcmp (data, "RIFF", 4) == 0 || memcmp (data, "AVF0", 4) == 0)) {
+    for (i = 0; i < magic_riff_index->len; i++) {
+      const TypeFindMagic *magic =
+          &g_array_index (magic_riff_index, TypeFindMagic, i);
+
+      if (magic_is_preferred (magic, best)
+          && memcmp (data + 8, magic->data, 4) == 0)
+        best = magic;
+    }
+  }
+
+  if (best != NULL)
+    gst_type_find_suggest (tf, GST_TYPE_FIND_MAXIMUM, best->caps);
+}
+
 #define TYPE_FIND_REGISTER_START_WITH(plugin,name,rank,ext,_data,_size,_probability)\
 G_BEGIN_DECLS{                                                          \
   GstTypeFindData *sw_data = g_slice_new (GstTypeFindData);             \
@@ -5856,6 +5952,8 @@ G_BEGIN_DECLS{                                                          \
                      ext, sw_data->caps, sw_data,                       \
                      (GDestroyNotify) (sw_data_destroy))) {             \
     sw_data_destroy (sw_data);                                          \
+  } else {                                                              \
+    magic_index_add (&magic_index[sw_data->data[0]], sw_data, rank);    \
   }                                                                     \
 }G_END_DECLS
 
@@ -5885,6 +5983,8 @@ G_BEGIN_DECLS{                                                          \
                       ext, sw_data->caps, sw_data,                      \
                       (GDestroyNotify) (sw_data_destroy))) {            \
     sw_data_destroy (sw_data);                                          \
+  } else {                                                              \
+    magic_index_add (&magic_riff_index, sw_data, rank);                 \
   }                                                                     \
 }G_END_DECLS
 
@@ -6239,6 +6339,10 @@ plugin_init (GstPlugin * plugin)
   TYPE_FIND_REGISTER_START_WITH (plugin, "audio/x-tap-dmp",
       GST_RANK_SECONDARY, "dmp", "DC2N-TAP-RAW", 12, GST_TYPE_FIND_LIKELY);
 
+  /* must come last, after all the magics have been indexed */
+  TYPE_FIND_REGISTER (plugin, "magic", MAGIC_TYPE_FIND_RANK,
+      magic_type_find, NULL, NULL, NULL, NULL);
+
   return TRUE;
 }
 
@@ -112,6 +112,8 @@ static gboolean gst_video_convert_set_info (GstVideoFilter * filter,
     GstVideoInfo * out_info);
 static GstFlowReturn gst_video_convert_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_video_convert_transform_frame_ip (GstVideoFilter *
+    filter, GstVideoFrame * frame);
 
 /* copies the given caps */
 static GstCaps *
@@ -479,6 +481,10 @@ gst_video_convert_set_info (GstVideoFilter * filter,
   if (space->convert == NULL)
     goto no_convert;
 
+  /* same geometry and pixel layout, write the result over the input */
+  gst_base_transform_set_in_place (GST_BASE_TRANSFORM (filter),
+      gst_video_converter_supports_inplace (space->convert));
+
   GST_DEBUG ("reconfigured %d %d", GST_VIDEO_INFO_FORMAT (in_info),
       GST_VIDEO_INFO_FORMAT (out_info));
 
@@ -542,11 +548,14 @@ gst_video_convert_class_init (GstVideoConvertClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_meta);
 
   gstbasetransform_class->passthrough_on_same_caps = TRUE;
+  gstbasetransform_class->transform_ip_on_passthrough = FALSE;
 
   gstvideofilter_class->set_info =
       GST_DEBUG_FUNCPTR (gst_video_convert_set_info);
   gstvideofilter_class->transform_frame =
       GST_DEBUG_FUNCPTR (gst_video_convert_transform_frame);
+  gstvideofilter_class->transform_frame_ip =
+      GST_DEBUG_FUNCPTR (gst_video_convert_transform_frame_ip);
 
   g_object_class_install_property (gobject_class, PROP_DITHER,
       g_param_spec_enum ("dither", "Dither", "Apply dithering while converting",
@@ -716,6 +725,37 @@ gst_video_convert_transform_frame (GstVideoFilter * filter,
   return GST_FLOW_OK;
 }
 
+static GstFlowReturn
+gst_video_convert_transform_frame_ip (GstVideoFilter * filter,
+    GstVideoFrame * frame)
+{
+  GstVideoConvert *space;
+  GstVideoFrame out_frame;
+  GstVideoMeta *meta;
+
+  space = GST_VIDEO_CONVERT_CAST (filter);
+
+  GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter,
+      "doing in-place colorspace conversion from %s -> to %s",
+      GST_VIDEO_INFO_NAME (&filter->in_info),
+      GST_VIDEO_INFO_NAME (&filter->out_info));
+
+  /* the output has the same layout as the input, it only needs the output
+   * format, keep the strides and offsets of the mapped input */
+  out_frame = *frame;
+  out_frame.info = filter->out_info;
+  out_frame.info.stride[0] = frame->info.stride[0];
+  out_frame.info.offset[0] = frame->info.offset[0];
+  out_frame.info.size = frame->info.size;
+
+  gst_video_converter_frame (space->convert, frame, &out_frame);
+
+  if ((meta = gst_buffer_get_video_meta (frame->buffer)))
+    meta->format = GST_VIDEO_INFO_FORMAT (&filter->out_info);
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
@@ -726,6 +766,10 @@ plugin_init (GstPlugin * plugin)
 
   _colorspace_quark = g_quark_from_static_string ("colorspace");
 
+  /* compile the common conversions now instead of on the first frames */
+  if (g_getenv ("GST_ORC_PRECOMPILE"))
+    gst_video_converter_precompile (TRUE);
+
   return gst_element_register (plugin, "videoconvert",
       GST_RANK_NONE, GST_TYPE_VIDEO_CONVERT);
 }
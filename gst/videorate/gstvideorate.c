@@ -100,6 +100,7 @@ enum
 #define DEFAULT_MAX_RATE        G_MAXINT
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
+#define DEFAULT_MARK_DUPLICATES TRUE
 
 enum
 {
@@ -115,7 +116,8 @@ enum
   PROP_AVERAGE_PERIOD,
   PROP_MAX_RATE,
   PROP_RATE,
-  PROP_MAX_DUPLICATION_TIME
+  PROP_MAX_DUPLICATION_TIME,
+  PROP_MARK_DUPLICATES
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -293,6 +295,23 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           0, G_MAXUINT64, DEFAULT_MAX_DUPLICATION_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:mark-duplicates:
+   *
+   * Set the %GST_BUFFER_FLAG_GAP flag on duplicated frames, so that
+   * downstream elements like encoders can recognize them as repeats of the
+   * previous frame and handle them cheaply, for instance as skipped frames.
+   *
+   * Duplicated frames always share their memory with the original frame,
+   * only their metadata is copied.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (object_class, PROP_MARK_DUPLICATES,
+      g_param_spec_boolean ("mark-duplicates", "Mark duplicates",
+          "Set the GAP flag on duplicated frames", DEFAULT_MARK_DUPLICATES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -634,6 +653,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->max_rate = DEFAULT_MAX_RATE;
   videorate->rate = DEFAULT_RATE;
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
+  videorate->mark_duplicates = DEFAULT_MARK_DUPLICATES;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -660,7 +680,7 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
   } else
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
 
-  if (duplicate)
+  if (duplicate && videorate->mark_duplicates)
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
   else
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
@@ -731,9 +751,11 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
   if (!videorate->prevbuf)
     goto eos_before_buffers;
 
-  outbuf = gst_buffer_ref (videorate->prevbuf);
-  /* make sure we can write to the metadata */
-  outbuf = gst_buffer_make_writable (outbuf);
+  /* We keep prevbuf for further duplicates, so the buffer we push needs its
+   * own metadata. Only copy that and share the memory, the frame data is
+   * never copied here. */
+  outbuf = gst_buffer_copy_region (videorate->prevbuf,
+      GST_BUFFER_COPY_METADATA | GST_BUFFER_COPY_MEMORY, 0, -1);
 
   return gst_video_rate_push_buffer (videorate, outbuf, duplicate, next_intime);
 
@@ -1718,6 +1740,9 @@ gst_video_rate_set_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       videorate->max_duplication_time = g_value_get_uint64 (value);
       break;
+    case PROP_MARK_DUPLICATES:
+      videorate->mark_duplicates = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1780,6 +1805,9 @@ gst_video_rate_get_property (GObject * object,
     case PROP_MAX_DUPLICATION_TIME:
       g_value_set_uint64 (value, videorate->max_duplication_time);
       break;
+    case PROP_MARK_DUPLICATES:
+      g_value_set_boolean (value, videorate->mark_duplicates);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
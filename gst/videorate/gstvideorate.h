@@ -66,6 +66,7 @@ struct _GstVideoRate
   gboolean force_variable_rate;
   gboolean updating_caps;
   guint64 max_duplication_time;
+  gboolean mark_duplicates;     /* set GAP on duplicated frames */
 
   /* segment handling */
   GstSegment segment;
@@ -79,6 +79,7 @@
 #include <gst/video/gstvideopool.h>
 
 #include "gstvideoscale.h"
+#include "gstvideoscaleladder.h"
 
 #define GST_CAT_DEFAULT video_scale_debug
 GST_DEBUG_CATEGORY_STATIC (video_scale_debug);
@@ -308,6 +309,8 @@ gst_video_scale_finalize (GstVideoScale * videoscale)
 {
   if (videoscale->convert)
     gst_video_converter_free (videoscale->convert);
+  if (videoscale->convert_options)
+    gst_structure_free (videoscale->convert_options);
 
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (videoscale));
 }
@@ -636,9 +639,24 @@ gst_video_scale_set_info (GstVideoFilter * filter, GstCaps * in,
           GST_VIDEO_GAMMA_MODE_REMAP, NULL);
     }
 
-    if (videoscale->convert)
-      gst_video_converter_free (videoscale->convert);
-    videoscale->convert = gst_video_converter_new (in_info, out_info, options);
+    /* renegotiating to the same formats and settings keeps the scalers */
+    if (videoscale->convert
+        && gst_video_info_is_equal (&videoscale->convert_in_info, in_info)
+        && gst_video_info_is_equal (&videoscale->convert_out_info, out_info)
+        && gst_structure_is_equal (videoscale->convert_options, options)) {
+      GST_DEBUG_OBJECT (videoscale, "reusing converter");
+      gst_structure_free (options);
+    } else {
+      if (videoscale->convert)
+        gst_video_converter_free (videoscale->convert);
+      if (videoscale->convert_options)
+        gst_structure_free (videoscale->convert_options);
+      videoscale->convert_options = gst_structure_copy (options);
+      videoscale->convert =
+          gst_video_converter_new (in_info, out_info, options);
+      videoscale->convert_in_info = *in_info;
+      videoscale->convert_out_info = *out_info;
+    }
   }
 
   GST_DEBUG_OBJECT (videoscale, "from=%dx%d (par=%d/%d dar=%d/%d), size %"
@@ -1158,6 +1176,10 @@ plugin_init (GstPlugin * plugin)
           GST_TYPE_VIDEO_SCALE))
     return FALSE;
 
+  if (!gst_element_register (plugin, "videoscaleladder", GST_RANK_NONE,
+          GST_TYPE_VIDEO_SCALE_LADDER))
+    return FALSE;
+
   GST_DEBUG_CATEGORY_INIT (video_scale_debug, "videoscale", 0,
       "videoscale element");
   GST_DEBUG_CATEGORY_GET (CAT_PERFORMANCE, "GST_PERFORMANCE");
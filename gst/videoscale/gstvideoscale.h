@@ -91,6 +91,9 @@ struct _GstVideoScale {
   gint n_threads;
 
   GstVideoConverter *convert;
+  GstVideoInfo convert_in_info;  /* formats and options convert was */
+  GstVideoInfo convert_out_info; /* created for */
+  GstStructure *convert_options;
 
   gint borders_h;
   gint borders_w;
@@ -0,0 +1,760 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-videoscaleladder
+ * @title: videoscaleladder
+ * @see_also: videoscale, tee
+ *
+ * This element scales one video stream to several sizes at once, one per
+ * requested source pad, as needed for adaptive streaming renditions. The
+ * size of each rendition is negotiated with the downstream peer of its pad,
+ * the format stays the one of the input.
+ *
+ * Instead of every rendition reading the full resolution input, as with a
+ * tee followed by one videoscale per rendition, each rendition is by
+ * default scaled from the next larger one, which is much less data to read
+ * for the small renditions.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 -v videotestsrc ! video/x-raw,width=1920,height=1080 ! videoscaleladder name=l \
+ *     l.src_0 ! video/x-raw,width=1280,height=720 ! fakesink \
+ *     l.src_1 ! video/x-raw,width=854,height=480 ! fakesink \
+ *     l.src_2 ! video/x-raw,width=640,height=360 ! fakesink
+ * ]|
+ *
+ * Since: 1.18
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include "gstvideoscaleladder.h"
+
+GST_DEBUG_CATEGORY_STATIC (video_scale_ladder_debug);
+#define GST_CAT_DEFAULT video_scale_ladder_debug
+
+#define DEFAULT_PROP_METHOD     GST_VIDEO_RESAMPLER_METHOD_CUBIC
+#define DEFAULT_PROP_CASCADE    TRUE
+#define DEFAULT_PROP_N_THREADS  1
+
+enum
+{
+  PROP_0,
+  PROP_METHOD,
+  PROP_CASCADE,
+  PROP_N_THREADS
+};
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_VIDEO_FORMATS_ALL))
+    );
+
+typedef struct _Rendition Rendition;
+
+struct _Rendition
+{
+  GstPad *srcpad;
+
+  gboolean need_negotiate;
+  gboolean negotiated;
+  GstVideoInfo info;
+
+  Rendition *source;            /* larger rendition scaled from, NULL for
+                                   the input */
+  GstVideoConverter *convert;
+
+  GstVideoFrame frame;          /* output while processing a buffer */
+  GstBuffer *outbuf;
+};
+
+#define parent_class gst_video_scale_ladder_parent_class
+G_DEFINE_TYPE (GstVideoScaleLadder, gst_video_scale_ladder, GST_TYPE_ELEMENT);
+
+static void
+rendition_clear_converter (Rendition * r)
+{
+  if (r->convert) {
+    gst_video_converter_free (r->convert);
+    r->convert = NULL;
+  }
+  r->source = NULL;
+}
+
+static void
+rendition_free (Rendition * r)
+{
+  rendition_clear_converter (r);
+  g_slice_free (Rendition, r);
+}
+
+static Rendition *
+find_rendition (GstVideoScaleLadder * self, GstPad * pad)
+{
+  GList *l;
+
+  for (l = self->renditions; l; l = l->next) {
+    Rendition *r = l->data;
+
+    if (r->srcpad == pad)
+      return r;
+  }
+  return NULL;
+}
+
+/* The caps a rendition can have: the input caps with any size */
+static GstCaps *
+gst_video_scale_ladder_get_rendition_caps (GstVideoScaleLadder * self)
+{
+  GstCaps *caps;
+
+  if (!self->have_info)
+    return gst_static_pad_template_get_caps (&src_template);
+
+  caps = gst_video_info_to_caps (&self->in_info);
+  gst_caps_set_simple (caps, "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
+      "height", GST_TYPE_INT_RANGE, 1, G_MAXINT, NULL);
+
+  return caps;
+}
+
+static gboolean
+copy_sticky_events (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstPad *srcpad = GST_PAD_CAST (user_data);
+
+  if (GST_EVENT_TYPE (*event) != GST_EVENT_CAPS)
+    gst_pad_store_sticky_event (srcpad, *event);
+
+  return TRUE;
+}
+
+/* Called without the lock, downstream may query us back */
+static void
+gst_video_scale_ladder_negotiate (GstVideoScaleLadder * self, GstPad * srcpad)
+{
+  GstCaps *templ, *caps;
+  GstStructure *s;
+  GstVideoInfo info;
+  gint in_width, in_height;
+  gboolean negotiated = FALSE;
+  Rendition *r;
+
+  gst_video_info_init (&info);
+
+  g_mutex_lock (&self->lock);
+  templ = gst_video_scale_ladder_get_rendition_caps (self);
+  in_width = GST_VIDEO_INFO_WIDTH (&self->in_info);
+  in_height = GST_VIDEO_INFO_HEIGHT (&self->in_info);
+  g_mutex_unlock (&self->lock);
+
+  caps = gst_pad_peer_query_caps (srcpad, templ);
+  gst_caps_unref (templ);
+
+  if (gst_caps_is_empty (caps)) {
+    GST_WARNING_OBJECT (srcpad, "downstream accepts no size");
+    gst_caps_unref (caps);
+    goto done;
+  }
+
+  /* prefer the sizes closest to the input */
+  caps = gst_caps_truncate (caps);
+  caps = gst_caps_make_writable (caps);
+  s = gst_caps_get_structure (caps, 0);
+  gst_structure_fixate_field_nearest_int (s, "width", in_width);
+  gst_structure_fixate_field_nearest_int (s, "height", in_height);
+  caps = gst_caps_fixate (caps);
+
+  if (!gst_video_info_from_caps (&info, caps)) {
+    GST_WARNING_OBJECT (srcpad, "invalid caps %" GST_PTR_FORMAT, caps);
+    gst_caps_unref (caps);
+    goto done;
+  }
+
+  GST_DEBUG_OBJECT (srcpad, "negotiated %" GST_PTR_FORMAT, caps);
+
+  gst_pad_sticky_events_foreach (self->sinkpad, copy_sticky_events, srcpad);
+  gst_pad_store_sticky_event (srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  negotiated = TRUE;
+
+done:
+  g_mutex_lock (&self->lock);
+  /* the pad may have been released meanwhile */
+  r = find_rendition (self, srcpad);
+  if (r) {
+    if (negotiated)
+      r->info = info;
+    r->negotiated = negotiated;
+    self->need_rebuild = TRUE;
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+static gint
+compare_rendition_size (const Rendition * a, const Rendition * b)
+{
+  guint64 area_a, area_b;
+
+  area_a = (guint64) GST_VIDEO_INFO_WIDTH (&a->info) *
+      GST_VIDEO_INFO_HEIGHT (&a->info);
+  area_b = (guint64) GST_VIDEO_INFO_WIDTH (&b->info) *
+      GST_VIDEO_INFO_HEIGHT (&b->info);
+
+  if (area_a > area_b)
+    return -1;
+  if (area_a < area_b)
+    return 1;
+  return 0;
+}
+
+/* Called with the lock. Order the renditions from the largest to the
+ * smallest and pick, for each of them, the smallest larger rendition to
+ * scale from. */
+static void
+gst_video_scale_ladder_rebuild (GstVideoScaleLadder * self)
+{
+  GList *l, *k;
+
+  self->need_rebuild = FALSE;
+  self->renditions = g_list_sort (self->renditions,
+      (GCompareFunc) compare_rendition_size);
+
+  for (l = self->renditions; l; l = l->next) {
+    Rendition *r = l->data;
+    const GstVideoInfo *src_info;
+
+    rendition_clear_converter (r);
+    if (!r->negotiated)
+      continue;
+
+    if (self->cascade) {
+      for (k = l->prev; k; k = k->prev) {
+        Rendition *o = k->data;
+
+        if (o->negotiated
+            && GST_VIDEO_INFO_WIDTH (&o->info) >= GST_VIDEO_INFO_WIDTH (&r->info)
+            && GST_VIDEO_INFO_HEIGHT (&o->info) >=
+            GST_VIDEO_INFO_HEIGHT (&r->info)) {
+          r->source = o;
+          break;
+        }
+      }
+    }
+    src_info = r->source ? &r->source->info : &self->in_info;
+
+    GST_DEBUG_OBJECT (r->srcpad, "scaling %dx%d -> %dx%d from %s",
+        GST_VIDEO_INFO_WIDTH (src_info), GST_VIDEO_INFO_HEIGHT (src_info),
+        GST_VIDEO_INFO_WIDTH (&r->info), GST_VIDEO_INFO_HEIGHT (&r->info),
+        r->source ? GST_PAD_NAME (r->source->srcpad) : "input");
+
+    r->convert = gst_video_converter_new ((GstVideoInfo *) src_info, &r->info,
+        gst_structure_new ("GstVideoScaleLadder",
+            GST_VIDEO_CONVERTER_OPT_RESAMPLER_METHOD,
+            GST_TYPE_VIDEO_RESAMPLER_METHOD, self->method,
+            GST_VIDEO_CONVERTER_OPT_MATRIX_MODE, GST_TYPE_VIDEO_MATRIX_MODE,
+            GST_VIDEO_MATRIX_MODE_NONE, GST_VIDEO_CONVERTER_OPT_DITHER_METHOD,
+            GST_TYPE_VIDEO_DITHER_METHOD, GST_VIDEO_DITHER_NONE,
+            GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+            GST_VIDEO_CHROMA_MODE_NONE,
+            GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, self->n_threads,
+            NULL));
+    if (r->convert == NULL) {
+      GST_WARNING_OBJECT (r->srcpad, "can't scale to this rendition");
+      r->negotiated = FALSE;
+    }
+  }
+}
+
+static GstFlowReturn
+gst_video_scale_ladder_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (parent);
+  GstVideoFrame in_frame;
+  GList *l, *pending = NULL, *outputs = NULL;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  g_mutex_lock (&self->lock);
+  if (!self->have_info)
+    goto not_negotiated;
+
+  for (l = self->renditions; l; l = l->next) {
+    Rendition *r = l->data;
+
+    if (r->need_negotiate) {
+      r->need_negotiate = FALSE;
+      pending = g_list_prepend (pending, gst_object_ref (r->srcpad));
+    }
+  }
+
+  if (pending) {
+    g_mutex_unlock (&self->lock);
+    for (l = pending; l; l = l->next)
+      gst_video_scale_ladder_negotiate (self, l->data);
+    g_list_free_full (pending, gst_object_unref);
+    g_mutex_lock (&self->lock);
+  }
+
+  if (self->need_rebuild)
+    gst_video_scale_ladder_rebuild (self);
+
+  if (!gst_video_frame_map (&in_frame, &self->in_info, buffer, GST_MAP_READ))
+    goto map_failed;
+
+  /* largest first, so that the sources of the cascaded ones are ready */
+  for (l = self->renditions; l; l = l->next) {
+    Rendition *r = l->data;
+    GstVideoFrame *src_frame;
+
+    if (r->convert == NULL)
+      continue;
+
+    if (r->source) {
+      /* an output that failed, skip what depends on it */
+      if (r->source->outbuf == NULL)
+        continue;
+      src_frame = &r->source->frame;
+    } else {
+      src_frame = &in_frame;
+    }
+
+    r->outbuf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&r->info),
+        NULL);
+    gst_buffer_copy_into (r->outbuf, buffer,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+    if (!gst_video_frame_map (&r->frame, &r->info, r->outbuf, GST_MAP_WRITE)) {
+      gst_buffer_unref (r->outbuf);
+      r->outbuf = NULL;
+      continue;
+    }
+
+    gst_video_converter_frame (r->convert, src_frame, &r->frame);
+  }
+
+  for (l = self->renditions; l; l = l->next) {
+    Rendition *r = l->data;
+
+    if (r->outbuf == NULL)
+      continue;
+
+    gst_video_frame_unmap (&r->frame);
+    outputs = g_list_prepend (outputs, gst_object_ref (r->srcpad));
+    outputs = g_list_prepend (outputs, r->outbuf);
+    r->outbuf = NULL;
+  }
+  gst_video_frame_unmap (&in_frame);
+  g_mutex_unlock (&self->lock);
+
+  gst_buffer_unref (buffer);
+
+  /* push the smallest renditions first, they are quickest to encode */
+  while (outputs) {
+    GstBuffer *outbuf = outputs->data;
+    GstPad *srcpad = outputs->next->data;
+    GstFlowReturn pad_ret;
+
+    outputs = g_list_delete_link (outputs, outputs);
+    outputs = g_list_delete_link (outputs, outputs);
+
+    pad_ret = gst_pad_push (srcpad, outbuf);
+
+    g_mutex_lock (&self->lock);
+    ret = gst_flow_combiner_update_pad_flow (self->flow_combiner, srcpad,
+        pad_ret);
+    g_mutex_unlock (&self->lock);
+
+    gst_object_unref (srcpad);
+  }
+
+  return ret;
+
+  /* ERRORS */
+not_negotiated:
+  {
+    g_mutex_unlock (&self->lock);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+map_failed:
+  {
+    g_mutex_unlock (&self->lock);
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Failed to map input buffer"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+}
+
+static gboolean
+gst_video_scale_ladder_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (parent);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:{
+      GstCaps *caps;
+      GstVideoInfo info;
+      GList *l;
+
+      gst_event_parse_caps (event, &caps);
+      if (!gst_video_info_from_caps (&info, caps)) {
+        gst_event_unref (event);
+        return FALSE;
+      }
+
+      g_mutex_lock (&self->lock);
+      if (!self->have_info || !gst_video_info_is_equal (&info,
+              &self->in_info)) {
+        self->in_info = info;
+        self->have_info = TRUE;
+        for (l = self->renditions; l; l = l->next)
+          ((Rendition *) l->data)->need_negotiate = TRUE;
+      }
+      g_mutex_unlock (&self->lock);
+
+      /* each rendition gets its own caps when negotiated */
+      gst_event_unref (event);
+      return TRUE;
+    }
+    case GST_EVENT_FLUSH_STOP:
+      g_mutex_lock (&self->lock);
+      gst_flow_combiner_reset (self->flow_combiner);
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static gboolean
+gst_video_scale_ladder_sink_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:{
+      GstCaps *filter, *caps;
+
+      /* each rendition can have any size, so accept any input size */
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_pad_template_caps (pad);
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    case GST_QUERY_ALLOCATION:
+      /* downstream allocates for the rendition sizes, not for ours */
+      return FALSE;
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+gst_video_scale_ladder_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CAPS:{
+      GstCaps *filter, *caps;
+
+      gst_query_parse_caps (query, &filter);
+      g_mutex_lock (&self->lock);
+      caps = gst_video_scale_ladder_get_rendition_caps (self);
+      g_mutex_unlock (&self->lock);
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    default:
+      return gst_pad_query_default (pad, parent, query);
+  }
+}
+
+static gboolean
+gst_video_scale_ladder_src_event (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (parent);
+
+  if (GST_EVENT_TYPE (event) == GST_EVENT_RECONFIGURE) {
+    Rendition *r;
+
+    g_mutex_lock (&self->lock);
+    r = find_rendition (self, pad);
+    if (r)
+      r->need_negotiate = TRUE;
+    g_mutex_unlock (&self->lock);
+    gst_event_unref (event);
+    return TRUE;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static GstPad *
+gst_video_scale_ladder_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (element);
+  Rendition *r;
+  GstPad *srcpad;
+  gchar *pad_name;
+  guint id;
+
+  g_mutex_lock (&self->lock);
+  if (name && sscanf (name, "src_%u", &id) == 1) {
+    self->next_pad_id = MAX (self->next_pad_id, id + 1);
+  } else {
+    id = self->next_pad_id++;
+  }
+  pad_name = g_strdup_printf ("src_%u", id);
+  g_mutex_unlock (&self->lock);
+
+  srcpad = gst_pad_new_from_template (templ, pad_name);
+  g_free (pad_name);
+
+  gst_pad_set_query_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_src_query));
+  gst_pad_set_event_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_src_event));
+
+  r = g_slice_new0 (Rendition);
+  r->srcpad = srcpad;
+  r->need_negotiate = TRUE;
+
+  g_mutex_lock (&self->lock);
+  self->renditions = g_list_append (self->renditions, r);
+  gst_flow_combiner_add_pad (self->flow_combiner, srcpad);
+  g_mutex_unlock (&self->lock);
+
+  gst_element_add_pad (element, srcpad);
+
+  return srcpad;
+}
+
+static void
+gst_video_scale_ladder_release_pad (GstElement * element, GstPad * pad)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (element);
+  Rendition *r;
+  GList *l;
+
+  g_mutex_lock (&self->lock);
+  r = find_rendition (self, pad);
+  if (r) {
+    self->renditions = g_list_remove (self->renditions, r);
+    /* renditions scaled from this one need another source */
+    for (l = self->renditions; l; l = l->next) {
+      if (((Rendition *) l->data)->source == r)
+        self->need_rebuild = TRUE;
+    }
+    rendition_free (r);
+  }
+  gst_flow_combiner_remove_pad (self->flow_combiner, pad);
+  g_mutex_unlock (&self->lock);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+}
+
+static GstStateChangeReturn
+gst_video_scale_ladder_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (element);
+  GstStateChangeReturn ret;
+  GList *l;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      g_mutex_lock (&self->lock);
+      self->have_info = FALSE;
+      for (l = self->renditions; l; l = l->next) {
+        Rendition *r = l->data;
+
+        rendition_clear_converter (r);
+        r->negotiated = FALSE;
+        r->need_negotiate = TRUE;
+      }
+      gst_flow_combiner_reset (self->flow_combiner);
+      g_mutex_unlock (&self->lock);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static void
+gst_video_scale_ladder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (object);
+
+  g_mutex_lock (&self->lock);
+  switch (prop_id) {
+    case PROP_METHOD:
+      self->method = g_value_get_enum (value);
+      break;
+    case PROP_CASCADE:
+      self->cascade = g_value_get_boolean (value);
+      break;
+    case PROP_N_THREADS:
+      self->n_threads = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  self->need_rebuild = TRUE;
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+gst_video_scale_ladder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (object);
+
+  g_mutex_lock (&self->lock);
+  switch (prop_id) {
+    case PROP_METHOD:
+      g_value_set_enum (value, self->method);
+      break;
+    case PROP_CASCADE:
+      g_value_set_boolean (value, self->cascade);
+      break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, self->n_threads);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&self->lock);
+}
+
+static void
+gst_video_scale_ladder_finalize (GObject * object)
+{
+  GstVideoScaleLadder *self = GST_VIDEO_SCALE_LADDER (object);
+
+  g_list_free_full (self->renditions, (GDestroyNotify) rendition_free);
+  gst_flow_combiner_free (self->flow_combiner);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_video_scale_ladder_class_init (GstVideoScaleLadderClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+  GstElementClass *element_class = (GstElementClass *) klass;
+
+  GST_DEBUG_CATEGORY_INIT (video_scale_ladder_debug, "videoscaleladder", 0,
+      "videoscaleladder element");
+
+  gobject_class->finalize = gst_video_scale_ladder_finalize;
+  gobject_class->set_property = gst_video_scale_ladder_set_property;
+  gobject_class->get_property = gst_video_scale_ladder_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_METHOD,
+      g_param_spec_enum ("method", "Method", "Resampling method",
+          GST_TYPE_VIDEO_RESAMPLER_METHOD, DEFAULT_PROP_METHOD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_CASCADE,
+      g_param_spec_boolean ("cascade", "Cascade",
+          "Scale each rendition from the next larger one instead of the input",
+          DEFAULT_PROP_CASCADE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use per rendition", 0, G_MAXUINT,
+          DEFAULT_PROP_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  gst_element_class_set_static_metadata (element_class,
+      "Video scaling ladder", "Filter/Converter/Video/Scaler",
+      "Scales video to several sizes at once", "GStreamer maintainers");
+
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_request_new_pad);
+  element_class->release_pad =
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_release_pad);
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_change_state);
+}
+
+static void
+gst_video_scale_ladder_init (GstVideoScaleLadder * self)
+{
+  g_mutex_init (&self->lock);
+
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_chain));
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_sink_event));
+  gst_pad_set_query_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_video_scale_ladder_sink_query));
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+
+  self->flow_combiner = gst_flow_combiner_new ();
+
+  self->method = DEFAULT_PROP_METHOD;
+  self->cascade = DEFAULT_PROP_CASCADE;
+  self->n_threads = DEFAULT_PROP_N_THREADS;
+}
@@ -0,0 +1,77 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_SCALE_LADDER_H__
+#define __GST_VIDEO_SCALE_LADDER_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstflowcombiner.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_VIDEO_SCALE_LADDER \
+  (gst_video_scale_ladder_get_type())
+#define GST_VIDEO_SCALE_LADDER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_VIDEO_SCALE_LADDER,GstVideoScaleLadder))
+#define GST_VIDEO_SCALE_LADDER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_VIDEO_SCALE_LADDER,GstVideoScaleLadderClass))
+#define GST_IS_VIDEO_SCALE_LADDER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_VIDEO_SCALE_LADDER))
+#define GST_IS_VIDEO_SCALE_LADDER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_VIDEO_SCALE_LADDER))
+
+typedef struct _GstVideoScaleLadder GstVideoScaleLadder;
+typedef struct _GstVideoScaleLadderClass GstVideoScaleLadderClass;
+
+/**
+ * GstVideoScaleLadder:
+ *
+ * Opaque data structure
+ */
+struct _GstVideoScaleLadder {
+  GstElement element;
+
+  GstPad *sinkpad;
+
+  /* protects everything below, held while scaling but not while pushing */
+  GMutex lock;
+
+  GstVideoInfo in_info;
+  gboolean have_info;
+
+  GList *renditions;            /* Rendition, largest first once built */
+  gboolean need_rebuild;        /* converters have to be recreated */
+  guint next_pad_id;
+  GstFlowCombiner *flow_combiner;
+
+  /* properties */
+  GstVideoResamplerMethod method;
+  gboolean cascade;
+  guint n_threads;
+};
+
+struct _GstVideoScaleLadderClass {
+  GstElementClass parent_class;
+};
+
+GType gst_video_scale_ladder_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_SCALE_LADDER_H__ */
@@ -61,6 +61,7 @@ GST_DEBUG_CATEGORY_STATIC (video_test_src_debug);
 #define DEFAULT_FOREGROUND_COLOR   0xffffffff
 #define DEFAULT_BACKGROUND_COLOR   0xff000000
 #define DEFAULT_HORIZONTAL_SPEED   0
+#define DEFAULT_N_THREADS          1
 
 enum
 {
@@ -86,6 +87,7 @@ enum
   PROP_ANIMATION_MODE,
   PROP_MOTION_TYPE,
   PROP_FLIP,
+  PROP_N_THREADS,
   PROP_LAST
 };
 
@@ -130,6 +132,8 @@ static void gst_video_test_src_get_times (GstBaseSrc * basesrc,
     GstBuffer * buffer, GstClockTime * start, GstClockTime * end);
 static gboolean gst_video_test_src_decide_allocation (GstBaseSrc * bsrc,
     GstQuery * query);
+static GstFlowReturn gst_video_test_src_create (GstBaseSrc * bsrc,
+    guint64 offset, guint size, GstBuffer ** buffer);
 static GstFlowReturn gst_video_test_src_fill (GstPushSrc * psrc,
     GstBuffer * buffer);
 static gboolean gst_video_test_src_start (GstBaseSrc * basesrc);
@@ -265,6 +269,19 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
           "For pattern=ball, invert colors every second.",
           DEFAULT_FLIP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoTestSrc:n-threads:
+   *
+   * Maximum number of threads painting bands of the frame in parallel, 0
+   * uses as many as there are processors. Takes effect on the next caps.
+   *
+   * Since: 1.18
+   */
+  g_object_class_install_property (gobject_class, PROP_N_THREADS,
+      g_param_spec_uint ("n-threads", "Threads",
+          "Maximum number of threads to use", 0, G_MAXUINT,
+          DEFAULT_N_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (gobject_class, PROP_TIMESTAMP_OFFSET,
       g_param_spec_int64 ("timestamp-offset", "Timestamp offset",
           "An offset added to timestamps set on buffers (in ns)", 0,
@@ -374,6 +391,7 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
   gstbasesrc_class->start = gst_video_test_src_start;
   gstbasesrc_class->stop = gst_video_test_src_stop;
   gstbasesrc_class->decide_allocation = gst_video_test_src_decide_allocation;
+  gstbasesrc_class->create = gst_video_test_src_create;
 
   gstpushsrc_class->fill = gst_video_test_src_fill;
 }
@@ -387,6 +405,7 @@ gst_video_test_src_init (GstVideoTestSrc * src)
   src->foreground_color = DEFAULT_FOREGROUND_COLOR;
   src->background_color = DEFAULT_BACKGROUND_COLOR;
   src->horizontal_speed = DEFAULT_HORIZONTAL_SPEED;
+  src->n_threads = DEFAULT_N_THREADS;
   src->random_state = 0;
 
   /* we operate in time */
@@ -520,6 +539,33 @@ gst_video_test_src_set_pattern (GstVideoTestSrc * videotestsrc,
 
   GST_DEBUG_OBJECT (videotestsrc, "setting pattern to %d", pattern_type);
 
+  /* patterns that look the same in every frame, apart from the horizontal
+   * scrolling, are only rendered once per caps */
+  switch (pattern_type) {
+    case GST_VIDEO_TEST_SRC_BLACK:
+    case GST_VIDEO_TEST_SRC_WHITE:
+    case GST_VIDEO_TEST_SRC_RED:
+    case GST_VIDEO_TEST_SRC_GREEN:
+    case GST_VIDEO_TEST_SRC_BLUE:
+    case GST_VIDEO_TEST_SRC_CHECKERS1:
+    case GST_VIDEO_TEST_SRC_CHECKERS2:
+    case GST_VIDEO_TEST_SRC_CHECKERS4:
+    case GST_VIDEO_TEST_SRC_CHECKERS8:
+    case GST_VIDEO_TEST_SRC_CIRCULAR:
+    case GST_VIDEO_TEST_SRC_SMPTE75:
+    case GST_VIDEO_TEST_SRC_GAMUT:
+    case GST_VIDEO_TEST_SRC_SOLID:
+    case GST_VIDEO_TEST_SRC_SMPTE100:
+    case GST_VIDEO_TEST_SRC_BAR:
+    case GST_VIDEO_TEST_SRC_GRADIENT:
+    case GST_VIDEO_TEST_SRC_COLORS:
+      videotestsrc->have_static_pattern = TRUE;
+      break;
+    default:
+      videotestsrc->have_static_pattern = FALSE;
+      break;
+  }
+
   switch (pattern_type) {
     case GST_VIDEO_TEST_SRC_SMPTE:
       videotestsrc->make_image = gst_video_test_src_smpte;
@@ -601,12 +647,32 @@ gst_video_test_src_set_pattern (GstVideoTestSrc * videotestsrc,
   }
 }
 
+static void
+gst_video_test_src_clear_cached (GstVideoTestSrc * src)
+{
+  GstBuffer *cached;
+
+  GST_OBJECT_LOCK (src);
+  cached = src->cached;
+  src->cached = NULL;
+  GST_OBJECT_UNLOCK (src);
+
+  if (cached)
+    gst_buffer_unref (cached);
+}
+
 static void
 gst_video_test_src_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
 {
   GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (object);
 
+  /* all properties but a few only used for timestamping can change the
+   * rendered pattern, drop the cached frame */
+  if (prop_id != PROP_TIMESTAMP_OFFSET && prop_id != PROP_IS_LIVE
+      && prop_id != PROP_HORIZONTAL_SPEED && prop_id != PROP_N_THREADS)
+    gst_video_test_src_clear_cached (src);
+
   switch (prop_id) {
     case PROP_PATTERN:
       gst_video_test_src_set_pattern (src, g_value_get_enum (value));
@@ -671,6 +737,9 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       src->flip = g_value_get_boolean (value);
       break;
+    case PROP_N_THREADS:
+      src->n_threads = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -746,6 +815,9 @@ gst_video_test_src_get_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       g_value_set_boolean (value, src->flip);
       break;
+    case PROP_N_THREADS:
+      g_value_set_uint (value, src->n_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -833,6 +905,11 @@ gst_video_test_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
     update = FALSE;
   }
 
+  /* Buffers from our own pool are only handed to downstream, which does
+   * not care where they come from. Then the cached frame of static
+   * patterns can be pushed as is instead of being copied into them. */
+  videotestsrc->own_pool = (pool == NULL);
+
   /* no downstream pool, make our own */
   if (pool == NULL) {
     if (videotestsrc->bayer)
@@ -864,6 +941,33 @@ gst_video_test_src_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
   return GST_BASE_SRC_CLASS (parent_class)->decide_allocation (bsrc, query);
 }
 
+static void
+gst_video_test_src_free_scratch (GstVideoTestSrc * videotestsrc)
+{
+  guint i, j;
+
+  /* the pool is created for the number of bands, which might change */
+  if (videotestsrc->paint_pool) {
+    g_thread_pool_free (videotestsrc->paint_pool, FALSE, TRUE);
+    videotestsrc->paint_pool = NULL;
+  }
+
+  for (i = 0; i < videotestsrc->n_scratch; i++) {
+    GstVideoTestSrcScratch *scratch = &videotestsrc->scratch[i];
+
+    for (j = 0; j < videotestsrc->n_lines; j++)
+      g_free (scratch->lines[j]);
+    g_free (scratch->lines);
+    g_free (scratch->tmpline_u8);
+    g_free (scratch->tmpline);
+    g_free (scratch->tmpline2);
+    g_free (scratch->tmpline_u16);
+  }
+  g_free (videotestsrc->scratch);
+  videotestsrc->scratch = NULL;
+  videotestsrc->n_scratch = 0;
+}
+
 static gboolean
 gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
 {
@@ -913,9 +1017,7 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
       info.chroma_site, 0, info.finfo->unpack_format, -info.finfo->w_sub[2],
       -info.finfo->h_sub[2]);
 
-  for (i = 0; i < videotestsrc->n_lines; i++)
-    g_free (videotestsrc->lines[i]);
-  g_free (videotestsrc->lines);
+  gst_video_test_src_free_scratch (videotestsrc);
 
   if (videotestsrc->subsample != NULL) {
     gst_video_chroma_resample_get_info (videotestsrc->subsample,
@@ -925,27 +1027,49 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
     offset = 0;
   }
 
-  videotestsrc->lines = g_malloc (sizeof (gpointer) * n_lines);
-  for (i = 0; i < n_lines; i++)
-    videotestsrc->lines[i] = g_malloc ((info.width + 16) * 8);
   videotestsrc->n_lines = n_lines;
   videotestsrc->offset = offset;
 
+  /* one set of scanlines for each band that can be painted in parallel */
+  videotestsrc->n_scratch = videotestsrc->n_threads ? videotestsrc->n_threads :
+      g_get_num_processors ();
+  videotestsrc->scratch =
+      g_new0 (GstVideoTestSrcScratch, videotestsrc->n_scratch);
+  for (i = 0; i < videotestsrc->n_scratch; i++) {
+    GstVideoTestSrcScratch *scratch = &videotestsrc->scratch[i];
+    guint j;
+
+    scratch->lines = g_malloc (sizeof (gpointer) * n_lines);
+    for (j = 0; j < n_lines; j++)
+      scratch->lines[j] = g_malloc ((info.width + 16) * 8);
+    scratch->tmpline_u8 = g_malloc (info.width + 8);
+    scratch->tmpline = g_malloc ((info.width + 8) * 4);
+    scratch->tmpline2 = g_malloc ((info.width + 8) * 4);
+    scratch->tmpline_u16 = g_malloc ((info.width + 16) * 8);
+  }
+
   /* looks ok here */
   videotestsrc->info = info;
 
+  /* Scrolling a cached frame only gives the same result as painting the
+   * scrolled lines when each pixel is converted on its own, so no chroma
+   * subsampling, palette or pixel groups */
+  videotestsrc->can_shift = !videotestsrc->bayer
+      && videotestsrc->subsample == NULL
+      && !GST_VIDEO_FORMAT_INFO_HAS_PALETTE (info.finfo)
+      && !GST_VIDEO_FORMAT_INFO_IS_TILED (info.finfo)
+      && !GST_VIDEO_FORMAT_INFO_IS_COMPLEX (info.finfo);
+  for (i = 0; i < GST_VIDEO_INFO_N_COMPONENTS (&info); i++) {
+    if (GST_VIDEO_FORMAT_INFO_W_SUB (info.finfo, i) != 0
+        || GST_VIDEO_FORMAT_INFO_PSTRIDE (info.finfo, i) <= 0)
+      videotestsrc->can_shift = FALSE;
+  }
+
+  gst_buffer_replace (&videotestsrc->cached, NULL);
+
   GST_DEBUG_OBJECT (videotestsrc, "size %dx%d, %d/%d fps",
       info.width, info.height, info.fps_n, info.fps_d);
 
-  g_free (videotestsrc->tmpline);
-  g_free (videotestsrc->tmpline2);
-  g_free (videotestsrc->tmpline_u8);
-  g_free (videotestsrc->tmpline_u16);
-  videotestsrc->tmpline_u8 = g_malloc (info.width + 8);
-  videotestsrc->tmpline = g_malloc ((info.width + 8) * 4);
-  videotestsrc->tmpline2 = g_malloc ((info.width + 8) * 4);
-  videotestsrc->tmpline_u16 = g_malloc ((info.width + 16) * 8);
-
   videotestsrc->accum_rtime += videotestsrc->running_time;
   videotestsrc->accum_frames += videotestsrc->n_frames;
 
@@ -1117,12 +1241,137 @@ gst_video_test_src_is_seekable (GstBaseSrc * psrc)
   return TRUE;
 }
 
+/* Returns a ref to the frame of the static pattern for the current caps,
+ * rendering it first if needed. It is always rendered without horizontal
+ * scrolling, which is applied when copying it. */
+static GstBuffer *
+gst_video_test_src_get_cached (GstVideoTestSrc * src)
+{
+  GstBuffer *cached = NULL;
+  GstVideoFrame frame;
+  gconstpointer pal;
+  gsize palsize;
+  gint64 n_frames;
+
+  GST_OBJECT_LOCK (src);
+  if (src->cached)
+    cached = gst_buffer_ref (src->cached);
+  GST_OBJECT_UNLOCK (src);
+
+  if (cached)
+    return cached;
+
+  cached = gst_buffer_new_allocate (NULL, src->info.size, NULL);
+  if (!gst_video_frame_map (&frame, &src->info, cached, GST_MAP_WRITE)) {
+    gst_buffer_unref (cached);
+    return NULL;
+  }
+
+  GST_DEBUG_OBJECT (src, "rendering static pattern");
+
+  /* the horizontal scrolling offset is derived from the frame count */
+  n_frames = src->n_frames;
+  src->n_frames = 0;
+  src->make_image (src, GST_CLOCK_TIME_NONE, &frame);
+  src->n_frames = n_frames;
+
+  if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
+              &palsize))) {
+    memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+  }
+
+  gst_video_frame_unmap (&frame);
+
+  GST_OBJECT_LOCK (src);
+  gst_buffer_replace (&src->cached, cached);
+  GST_OBJECT_UNLOCK (src);
+
+  return cached;
+}
+
+/* Copies the cached frame into @frame, scrolled by the horizontal speed
+ * like videotestsrc_convert_tmpline() does for painted lines */
+static void
+gst_video_test_src_copy_cached (GstVideoTestSrc * src, GstBuffer * cached,
+    GstVideoFrame * frame)
+{
+  GstVideoFrame sframe;
+  gint width, x, plane, comp, line;
+
+  if (!gst_video_frame_map (&sframe, &src->info, cached, GST_MAP_READ))
+    return;
+
+  width = GST_VIDEO_FRAME_WIDTH (frame);
+  x = (src->horizontal_speed * src->n_frames) % width;
+  if (x < 0)
+    x += width;
+
+  if (x == 0) {
+    gst_video_frame_copy (frame, &sframe);
+    gst_video_frame_unmap (&sframe);
+    return;
+  }
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (frame); plane++) {
+    const guint8 *sp = GST_VIDEO_FRAME_PLANE_DATA (&sframe, plane);
+    guint8 *dp = GST_VIDEO_FRAME_PLANE_DATA (frame, plane);
+    gint sstride = GST_VIDEO_FRAME_PLANE_STRIDE (&sframe, plane);
+    gint dstride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, plane);
+    gint pstride = 0, height = 0;
+
+    for (comp = 0; comp < GST_VIDEO_FRAME_N_COMPONENTS (frame); comp++) {
+      if (GST_VIDEO_FRAME_COMP_PLANE (frame, comp) == plane) {
+        pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, comp);
+        height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, comp);
+        break;
+      }
+    }
+
+    for (line = 0; line < height; line++) {
+      memcpy (dp, sp + x * pstride, (width - x) * pstride);
+      memcpy (dp + (width - x) * pstride, sp, x * pstride);
+      sp += sstride;
+      dp += dstride;
+    }
+  }
+
+  gst_video_frame_unmap (&sframe);
+}
+
+static GstFlowReturn
+gst_video_test_src_create (GstBaseSrc * bsrc, guint64 offset, guint size,
+    GstBuffer ** buffer)
+{
+  GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (bsrc);
+  GstBuffer *outbuf;
+  GstFlowReturn ret;
+
+  /* Static patterns without scrolling are pushed as buffers sharing the
+   * memory of the cached frame, unless downstream wants its own buffers */
+  if (*buffer != NULL || !src->own_pool || !src->have_static_pattern
+      || src->horizontal_speed != 0)
+    return GST_BASE_SRC_CLASS (parent_class)->create (bsrc, offset, size,
+        buffer);
+
+  outbuf = gst_buffer_new ();
+  ret = gst_video_test_src_fill (GST_PUSH_SRC (bsrc), outbuf);
+  if (ret != GST_FLOW_OK || gst_buffer_n_memory (outbuf) == 0) {
+    gst_buffer_unref (outbuf);
+    return ret == GST_FLOW_OK ? GST_FLOW_ERROR : ret;
+  }
+
+  *buffer = outbuf;
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 {
   GstVideoTestSrc *src;
-  GstClockTime next_time;
+  GstClockTime next_time, pts;
   GstVideoFrame frame;
+  GstBuffer *cached = NULL;
   gconstpointer pal;
   gsize palsize;
 
@@ -1144,23 +1393,43 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
   GST_LOG_OBJECT (src,
       "creating buffer from pool for frame %" G_GINT64_FORMAT, src->n_frames);
 
-  if (!gst_video_frame_map (&frame, &src->info, buffer, GST_MAP_WRITE))
-    goto invalid_frame;
+  pts = src->accum_rtime + src->timestamp_offset + src->running_time;
 
-  GST_BUFFER_PTS (buffer) =
-      src->accum_rtime + src->timestamp_offset + src->running_time;
-  GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
+  gst_object_sync_values (GST_OBJECT (psrc), pts);
+
+  if (src->have_static_pattern
+      && (src->horizontal_speed == 0 || src->can_shift))
+    cached = gst_video_test_src_get_cached (src);
 
-  gst_object_sync_values (GST_OBJECT (psrc), GST_BUFFER_PTS (buffer));
+  if (cached && gst_buffer_n_memory (buffer) == 0) {
+    /* empty buffer from create(), share the memory of the cached frame */
+    gst_buffer_copy_into (buffer, cached, GST_BUFFER_COPY_MEMORY, 0, -1);
+  } else {
+    if (!gst_video_frame_map (&frame, &src->info, buffer, GST_MAP_WRITE)) {
+      if (cached)
+        gst_buffer_unref (cached);
+      goto invalid_frame;
+    }
 
-  src->make_image (src, GST_BUFFER_PTS (buffer), &frame);
+    if (cached) {
+      gst_video_test_src_copy_cached (src, cached, &frame);
+    } else {
+      src->make_image (src, pts, &frame);
 
-  if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
-              &palsize))) {
-    memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+      if ((pal = gst_video_format_get_palette (GST_VIDEO_FRAME_FORMAT (&frame),
+                  &palsize))) {
+        memcpy (GST_VIDEO_FRAME_PLANE_DATA (&frame, 1), pal, palsize);
+      }
+    }
+
+    gst_video_frame_unmap (&frame);
   }
 
-  gst_video_frame_unmap (&frame);
+  if (cached)
+    gst_buffer_unref (cached);
+
+  GST_BUFFER_PTS (buffer) = pts;
+  GST_BUFFER_DTS (buffer) = GST_CLOCK_TIME_NONE;
 
   GST_DEBUG_OBJECT (src, "Timestamp: %" GST_TIME_FORMAT " = accumulated %"
       GST_TIME_FORMAT " + offset: %"
@@ -1230,25 +1499,14 @@ static gboolean
 gst_video_test_src_stop (GstBaseSrc * basesrc)
 {
   GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (basesrc);
-  guint i;
 
-  g_free (src->tmpline);
-  src->tmpline = NULL;
-  g_free (src->tmpline2);
-  src->tmpline2 = NULL;
-  g_free (src->tmpline_u8);
-  src->tmpline_u8 = NULL;
-  g_free (src->tmpline_u16);
-  src->tmpline_u16 = NULL;
+  gst_video_test_src_clear_cached (src);
+
+  gst_video_test_src_free_scratch (src);
   if (src->subsample)
     gst_video_chroma_resample_free (src->subsample);
   src->subsample = NULL;
-
-  for (i = 0; i < src->n_lines; i++)
-    g_free (src->lines[i]);
-  g_free (src->lines);
   src->n_lines = 0;
-  src->lines = NULL;
 
   return TRUE;
 }
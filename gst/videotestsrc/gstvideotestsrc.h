@@ -132,6 +132,15 @@ typedef enum {
 typedef struct _GstVideoTestSrc GstVideoTestSrc;
 typedef struct _GstVideoTestSrcClass GstVideoTestSrcClass;
 
+/* temporary AYUV/ARGB scanlines, one set per band painted in parallel */
+typedef struct {
+  guint8 *tmpline_u8;
+  guint8 *tmpline;
+  guint8 *tmpline2;
+  guint16 *tmpline_u16;
+  gpointer *lines;
+} GstVideoTestSrcScratch;
+
 /**
  * GstVideoTestSrc:
  *
@@ -197,15 +206,21 @@ struct _GstVideoTestSrc {
 
   void (*make_image) (GstVideoTestSrc *v, GstClockTime pts, GstVideoFrame *frame);
 
-  /* temporary AYUV/ARGB scanline */
-  guint8 *tmpline_u8;
-  guint8 *tmpline;
-  guint8 *tmpline2;
-  guint16 *tmpline_u16;
+  /* static patterns */
+  gboolean have_static_pattern;         /* pattern only depends on the caps */
+  gboolean can_shift;                   /* scrolling can be done on the output */
+  gboolean own_pool;                    /* buffers are not from downstream */
+  GstBuffer *cached;                    /* rendered frame, protected by object lock */
+
+  GstVideoTestSrcScratch *scratch;
+  guint n_scratch;
 
   guint n_lines;
   gint offset;
-  gpointer *lines;
+
+  /* painting on several threads */
+  guint n_threads;
+  GThreadPool *paint_pool;
 };
 
 struct _GstVideoTestSrcClass {
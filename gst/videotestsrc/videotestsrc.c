@@ -191,13 +191,13 @@ videotestsrc_setup_paintinfo (GstVideoTestSrc * v, paintinfo * p, int w, int h)
       p->paint_tmpline = paint_tmpline_AYUV;
     }
   }
-  p->tmpline = v->tmpline;
-  p->tmpline2 = v->tmpline2;
-  p->tmpline_u8 = v->tmpline_u8;
-  p->tmpline_u16 = v->tmpline_u16;
+  p->tmpline = v->scratch[0].tmpline;
+  p->tmpline2 = v->scratch[0].tmpline2;
+  p->tmpline_u8 = v->scratch[0].tmpline_u8;
+  p->tmpline_u16 = v->scratch[0].tmpline_u16;
   p->n_lines = v->n_lines;
   p->offset = v->offset;
-  p->lines = v->lines;
+  p->lines = v->scratch[0].lines;
   p->x_offset = (v->horizontal_speed * v->n_frames) % width;
   if (p->x_offset < 0)
     p->x_offset += width;
@@ -323,6 +323,159 @@ videotestsrc_blend_line (GstVideoTestSrc * v, guint8 * dest, guint8 * src,
 #undef BLEND
 }
 
+/* Painting in bands.
+ *
+ * Patterns where each line only depends on its line number paint it with a
+ * PaintLineFunc. The frame is then split into bands of lines painted in
+ * parallel, each with its own scanlines. Bands start where a group of lines
+ * that are chroma subsampled together starts, so they are independent. */
+typedef void (*PaintLineFunc) (GstVideoTestSrc * v, paintinfo * p,
+    GstVideoFrame * frame, gconstpointer data, int j);
+
+typedef struct
+{
+  gint refcount;
+
+  GstVideoTestSrc *v;
+  GstVideoFrame *frame;
+  const paintinfo *p;
+  PaintLineFunc paint_line;
+  gconstpointer data;
+
+  gint band_height;
+  gint band_start;              /* first line of the second band */
+  gint n_bands;
+
+  gint next_band;
+  gint n_pending;
+} PaintJob;
+
+static GMutex paint_job_lock;
+static GCond paint_job_cond;
+
+static void
+paint_job_unref (PaintJob * job)
+{
+  if (g_atomic_int_dec_and_test (&job->refcount))
+    g_slice_free (PaintJob, job);
+}
+
+static gboolean
+paint_job_run_next (PaintJob * job)
+{
+  GstVideoTestSrcScratch *scratch;
+  paintinfo pi;
+  gint band, j, y0, y1;
+
+  band = g_atomic_int_add (&job->next_band, 1);
+  if (band >= job->n_bands)
+    return FALSE;
+
+  /* same setup, own scanlines */
+  pi = *job->p;
+  scratch = &job->v->scratch[band];
+  pi.tmpline = scratch->tmpline;
+  pi.tmpline2 = scratch->tmpline2;
+  pi.tmpline_u8 = scratch->tmpline_u8;
+  pi.tmpline_u16 = scratch->tmpline_u16;
+  pi.lines = scratch->lines;
+
+  y0 = band == 0 ? 0 : job->band_start + (band - 1) * job->band_height;
+  y1 = MIN (job->band_start + band * job->band_height,
+      job->frame->info.height);
+  if (band == job->n_bands - 1)
+    y1 = job->frame->info.height;
+
+  for (j = y0; j < y1; j++)
+    job->paint_line (job->v, &pi, job->frame, job->data, j);
+
+  if (g_atomic_int_dec_and_test (&job->n_pending)) {
+    g_mutex_lock (&paint_job_lock);
+    g_cond_broadcast (&paint_job_cond);
+    g_mutex_unlock (&paint_job_lock);
+  }
+
+  return TRUE;
+}
+
+static void
+paint_job_pool_func (gpointer data, gpointer user_data)
+{
+  PaintJob *job = data;
+
+  while (paint_job_run_next (job));
+
+  paint_job_unref (job);
+}
+
+/* Paints all lines of @frame with @paint_line, using the setup of @p */
+static void
+videotestsrc_paint_lines (GstVideoTestSrc * v, paintinfo * p,
+    GstVideoFrame * frame, PaintLineFunc paint_line, gconstpointer data)
+{
+  PaintJob *job;
+  gint h = frame->info.height, n = p->n_lines;
+  gint n_bands, band_height, band_start;
+  gint i;
+
+  /* bands of whole chroma line groups, of a few lines at least */
+  n_bands = MIN (v->n_scratch, h / MAX (n, 16));
+  if (n_bands > 1) {
+    band_height = (h + n_bands - 1) / n_bands;
+    band_height = ((band_height + n - 1) / n) * n;
+    band_start = band_height + ((p->offset % n) + n) % n;
+    n_bands = 1 + (h - band_start + band_height - 1) / band_height;
+  }
+
+  if (n_bands <= 1) {
+    gint j;
+
+    for (j = 0; j < h; j++)
+      paint_line (v, p, frame, data, j);
+    return;
+  }
+
+  if (v->paint_pool == NULL) {
+    v->paint_pool = g_thread_pool_new (paint_job_pool_func, NULL,
+        v->n_scratch - 1, FALSE, NULL);
+    if (v->paint_pool == NULL) {
+      gint j;
+
+      for (j = 0; j < h; j++)
+        paint_line (v, p, frame, data, j);
+      return;
+    }
+  }
+
+  job = g_slice_new (PaintJob);
+  job->refcount = 1;
+  job->v = v;
+  job->frame = frame;
+  job->p = p;
+  job->paint_line = paint_line;
+  job->data = data;
+  job->band_height = band_height;
+  job->band_start = band_start;
+  job->n_bands = n_bands;
+  job->next_band = 0;
+  job->n_pending = n_bands;
+
+  /* helpers that find no band left just return */
+  for (i = 1; i < n_bands; i++) {
+    g_atomic_int_inc (&job->refcount);
+    g_thread_pool_push (v->paint_pool, job, NULL);
+  }
+
+  while (paint_job_run_next (job));
+
+  g_mutex_lock (&paint_job_lock);
+  while (g_atomic_int_get (&job->n_pending) > 0)
+    g_cond_wait (&paint_job_cond, &paint_job_lock);
+  g_mutex_unlock (&paint_job_lock);
+
+  paint_job_unref (job);
+}
+
 void
 gst_video_test_src_smpte (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
@@ -502,31 +655,42 @@ gst_video_test_src_bar (GstVideoTestSrc * v, GstClockTime pts,
   }
 }
 
+static void
+paint_snow_line (GstVideoTestSrc * v, paintinfo * p, GstVideoFrame * frame,
+    gconstpointer data, int j)
+{
+  /* each line has its own random sequence so that lines can be painted in
+   * any order */
+  guint state = *(const guint *) data + (guint) j * 2654435761u;
+  int i, w = frame->info.width;
+
+  for (i = 0; i < w; i++)
+    p->tmpline_u8[i] = random_char (&state);
+
+  videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
+      &p->foreground_color, &p->background_color, w);
+  videotestsrc_convert_tmpline (p, frame, j);
+}
+
 void
 gst_video_test_src_snow (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int i;
-  int j;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
+  guint seed;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++) {
-      int y = random_char (&v->random_state);
-      p->tmpline_u8[i] = y;
-    }
-    videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
-        &p->foreground_color, &p->background_color, w);
-    videotestsrc_convert_tmpline (p, frame, j);
-  }
+  seed = v->random_state;
+  random_char (&v->random_state);
+
+  videotestsrc_paint_lines (v, p, frame, paint_snow_line, &seed);
 }
 
 static void
@@ -769,214 +933,149 @@ static const guint8 sine_table[256] = {
 };
 
 
+/* Zoneplate equation:
+ *
+ * phase = k0 + kx*x + ky*y + kt*t
+ *       + kxt*x*t + kyt*y*t + kxy*x*y
+ *       + kx2*x*x + ky2*y*y + Kt2*t*t
+ */
+typedef struct
+{
+  int t;
+  int xreset;                   /* starting values for x^2 and y^2, centering the ellipse */
+  int yreset;
+  int kt;
+  int kt2;
+  int delta_kxt;
+  int scale_kxy;
+  int scale_kx2;
+} ZonePlateParams;
+
+static void
+zoneplate_setup_params (GstVideoTestSrc * v, GstVideoFrame * frame,
+    ZonePlateParams * zp)
+{
+  int w = frame->info.width, h = frame->info.height;
+
+  zp->t = v->n_frames;
+  zp->xreset = -(w / 2) - v->xoffset;
+  zp->yreset = -(h / 2) - v->yoffset;
+  zp->kt = v->kt * zp->t;
+  zp->kt2 = v->kt2 * zp->t * zp->t;
+  zp->delta_kxt = v->kxt * zp->t;
+  zp->scale_kxy = 0xffff / (w / 2);
+  zp->scale_kx2 = 0xffff / w;
+}
+
+/* Writes the zoneplate values of line @j to @dest. This used to accumulate
+ * the x terms pixel by pixel; they are computed from x directly now, which
+ * gives the same result and leaves no dependency between pixels, so the
+ * loop can be vectorized. */
+static void
+zoneplate_paint_values (GstVideoTestSrc * v, const ZonePlateParams * zp,
+    guint8 * dest, int w, int h, int j)
+{
+  int i;
+  int y = zp->yreset + j;
+  int delta_kxy = v->kxy * y * zp->scale_kxy;
+  int delta_kx = v->kx + zp->delta_kxt;
+  int phase_y;
+
+  /* phase = k0 + (ky * j) + (kt * t) + (kyt * j * t)
+   *       + ((ky2 * y * y) / h) + ((kt2 * t * t) >> 1) */
+  phase_y = v->k0 + v->ky * (j + 1) + zp->kt + v->kyt * zp->t * (j + 1) +
+      (v->ky2 * y * y) / h + (zp->kt2 >> 1);
+
+  for (i = 0; i < w; i++) {
+    int x = zp->xreset + i;
+    int phase = phase_y;
+
+    /* phase = phase + (kx * i) + (kxt * i * t) */
+    phase += delta_kx * (i + 1);
+
+    /* phase = phase + (kxy * x * y) / (w/2) */
+    phase += (delta_kxy * (x + 1)) >> 16;
+
+    /* normalise x terms to rate of change of phase at the picture edge
+     * phase = phase + ((kx2 * x * x)/w) */
+    phase += (v->kx2 * x * x * zp->scale_kx2) >> 16;
+
+    dest[i] = sine_table[phase & 0xff];
+  }
+}
+
+static void
+paint_zoneplate_line (GstVideoTestSrc * v, paintinfo * p,
+    GstVideoFrame * frame, gconstpointer data, int j)
+{
+  int w = frame->info.width, h = frame->info.height;
+
+  zoneplate_paint_values (v, data, p->tmpline_u8, w, h, j);
+
+  videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
+      &p->foreground_color, &p->background_color, w);
+  videotestsrc_convert_tmpline (p, frame, j);
+}
+
 void
 gst_video_test_src_zoneplate (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int i;
-  int j;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   struct vts_color_struct color;
-  int t = v->n_frames;
   int w = frame->info.width, h = frame->info.height;
-  int xreset = -(w / 2) - v->xoffset;   /* starting values for x^2 and y^2, centering the ellipse */
-  int yreset = -(h / 2) - v->yoffset;
-
-  int x, y;
-  int accum_kx;
-  int accum_kxt;
-  int accum_ky;
-  int accum_kyt;
-  int accum_kxy;
-  int kt;
-  int kt2;
-  int ky2;
-  int delta_kxt = v->kxt * t;
-  int delta_kxy;
-  int scale_kxy = 0xffff / (w / 2);
-  int scale_kx2 = 0xffff / w;
+  ZonePlateParams zp;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
   color = p->colors[COLOR_BLACK];
   p->color = &color;
 
-  /* Zoneplate equation:
-   *
-   * phase = k0 + kx*x + ky*y + kt*t
-   *       + kxt*x*t + kyt*y*t + kxy*x*y
-   *       + kx2*x*x + ky2*y*y + Kt2*t*t
-   */
-
-#if 0
-  for (j = 0, y = yreset; j < h; j++, y++) {
-    for (i = 0, x = xreset; i < w; i++, x++) {
-
-      /* zero order */
-      int phase = v->k0;
+  zoneplate_setup_params (v, frame, &zp);
 
-      /* first order */
-      phase = phase + (v->kx * i) + (v->ky * j) + (v->kt * t);
-
-      /* cross term */
-      /* phase = phase + (v->kxt * i * t) + (v->kyt * j * t); */
-      /* phase = phase + (v->kxy * x * y) / (w/2); */
+  videotestsrc_paint_lines (v, p, frame, paint_zoneplate_line, &zp);
+}
 
-      /*second order */
-      /*normalise x/y terms to rate of change of phase at the picture edge */
-      phase =
-          phase + ((v->kx2 * x * x) / w) + ((v->ky2 * y * y) / h) +
-          ((v->kt2 * t * t) >> 1);
+static void
+paint_chromazoneplate_line (GstVideoTestSrc * v, paintinfo * p,
+    GstVideoFrame * frame, gconstpointer data, int j)
+{
+  struct vts_color_struct color;
+  int i, w = frame->info.width, h = frame->info.height;
 
-      color.Y = sine_table[phase & 0xff];
+  zoneplate_paint_values (v, data, p->tmpline_u8, w, h, j);
 
-      color.R = color.Y;
-      color.G = color.Y;
-      color.B = color.Y;
-      p->paint_tmpline (p, i, 1);
-    }
-  }
-#endif
+  color = p->colors[COLOR_BLACK];
+  color.Y = 128;
+  color.R = 128;
+  color.G = 128;
+  color.gray = color.Y << 8;
+  p->color = &color;
 
-  /* optimised version, with original code shown in comments */
-  accum_ky = 0;
-  accum_kyt = 0;
-  kt = v->kt * t;
-  kt2 = v->kt2 * t * t;
-  for (j = 0, y = yreset; j < h; j++, y++) {
-    accum_kx = 0;
-    accum_kxt = 0;
-    accum_ky += v->ky;
-    accum_kyt += v->kyt * t;
-    delta_kxy = v->kxy * y * scale_kxy;
-    accum_kxy = delta_kxy * xreset;
-    ky2 = (v->ky2 * y * y) / h;
-    for (i = 0, x = xreset; i < w; i++, x++) {
-
-      /* zero order */
-      int phase = v->k0;
-
-      /* first order */
-      accum_kx += v->kx;
-      /* phase = phase + (v->kx * i) + (v->ky * j) + (v->kt * t); */
-      phase = phase + accum_kx + accum_ky + kt;
-
-      /* cross term */
-      accum_kxt += delta_kxt;
-      accum_kxy += delta_kxy;
-      /* phase = phase + (v->kxt * i * t) + (v->kyt * j * t); */
-      phase = phase + accum_kxt + accum_kyt;
-
-      /* phase = phase + (v->kxy * x * y) / (w/2); */
-      /* phase = phase + accum_kxy / (w/2); */
-      phase = phase + (accum_kxy >> 16);
-
-      /*second order */
-      /*normalise x/y terms to rate of change of phase at the picture edge */
-      /*phase = phase + ((v->kx2 * x * x)/w) + ((v->ky2 * y * y)/h) + ((v->kt2 * t * t)>>1); */
-      phase = phase + ((v->kx2 * x * x * scale_kx2) >> 16) + ky2 + (kt2 >> 1);
-
-      p->tmpline_u8[i] = sine_table[phase & 0xff];
-    }
-    videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
-        &p->foreground_color, &p->background_color, w);
-    videotestsrc_convert_tmpline (p, frame, j);
+  for (i = 0; i < w; i++) {
+    color.U = p->tmpline_u8[i];
+    color.V = p->tmpline_u8[i];
+    color.B = color.V;
+    p->paint_tmpline (p, i, 1);
   }
+  videotestsrc_convert_tmpline (p, frame, j);
 }
 
 void
 gst_video_test_src_chromazoneplate (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int i;
-  int j;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
-  struct vts_color_struct color;
-  int t = v->n_frames;
   int w = frame->info.width, h = frame->info.height;
-
-  int xreset = -(w / 2) - v->xoffset;   /* starting values for x^2 and y^2, centering the ellipse */
-  int yreset = -(h / 2) - v->yoffset;
-
-  int x, y;
-  int accum_kx;
-  int accum_kxt;
-  int accum_ky;
-  int accum_kyt;
-  int accum_kxy;
-  int kt;
-  int kt2;
-  int ky2;
-  int delta_kxt = v->kxt * t;
-  int delta_kxy;
-  int scale_kxy = 0xffff / (w / 2);
-  int scale_kx2 = 0xffff / w;
+  ZonePlateParams zp;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
-  color = p->colors[COLOR_BLACK];
-  p->color = &color;
+  zoneplate_setup_params (v, frame, &zp);
 
-  /* Zoneplate equation:
-   *
-   * phase = k0 + kx*x + ky*y + kt*t
-   *       + kxt*x*t + kyt*y*t + kxy*x*y
-   *       + kx2*x*x + ky2*y*y + Kt2*t*t
-   */
-
-  /* optimised version, with original code shown in comments */
-  accum_ky = 0;
-  accum_kyt = 0;
-  kt = v->kt * t;
-  kt2 = v->kt2 * t * t;
-  for (j = 0, y = yreset; j < h; j++, y++) {
-    accum_kx = 0;
-    accum_kxt = 0;
-    accum_ky += v->ky;
-    accum_kyt += v->kyt * t;
-    delta_kxy = v->kxy * y * scale_kxy;
-    accum_kxy = delta_kxy * xreset;
-    ky2 = (v->ky2 * y * y) / h;
-    for (i = 0, x = xreset; i < w; i++, x++) {
-
-      /* zero order */
-      int phase = v->k0;
-
-      /* first order */
-      accum_kx += v->kx;
-      /* phase = phase + (v->kx * i) + (v->ky * j) + (v->kt * t); */
-      phase = phase + accum_kx + accum_ky + kt;
-
-      /* cross term */
-      accum_kxt += delta_kxt;
-      accum_kxy += delta_kxy;
-      /* phase = phase + (v->kxt * i * t) + (v->kyt * j * t); */
-      phase = phase + accum_kxt + accum_kyt;
-
-      /* phase = phase + (v->kxy * x * y) / (w/2); */
-      /* phase = phase + accum_kxy / (w/2); */
-      phase = phase + (accum_kxy >> 16);
-
-      /*second order */
-      /*normalise x/y terms to rate of change of phase at the picture edge */
-      /*phase = phase + ((v->kx2 * x * x)/w) + ((v->ky2 * y * y)/h) + ((v->kt2 * t * t)>>1); */
-      phase = phase + ((v->kx2 * x * x * scale_kx2) >> 16) + ky2 + (kt2 >> 1);
-
-      color.Y = 128;
-      color.U = sine_table[phase & 0xff];
-      color.V = sine_table[phase & 0xff];
-
-      color.R = 128;
-      color.G = 128;
-      color.B = color.V;
-
-      color.gray = color.Y << 8;
-      p->paint_tmpline (p, i, 1);
-    }
-    videotestsrc_convert_tmpline (p, frame, j);
-  }
+  videotestsrc_paint_lines (v, p, frame, paint_chromazoneplate_line, &zp);
 }
 
 #undef SCALE_AMPLITUDE
@@ -1021,57 +1120,123 @@ gst_video_test_src_circular (GstVideoTestSrc * v, GstClockTime pts,
   }
 }
 
+static void
+paint_gamut_line (GstVideoTestSrc * v, paintinfo * p, GstVideoFrame * frame,
+    gconstpointer data, int y)
+{
+  int x;
+  struct vts_color_struct yuv_primary;
+  struct vts_color_struct yuv_secondary;
+  int w = frame->info.width, h = frame->info.height;
+  int region = (y * 4) / h;
+
+  switch (region) {
+    case 0:                    /* black */
+      yuv_primary = p->colors[COLOR_BLACK];
+      yuv_secondary = p->colors[COLOR_BLACK];
+      yuv_secondary.Y = 0;
+      break;
+    case 1:
+      yuv_primary = p->colors[COLOR_WHITE];
+      yuv_secondary = p->colors[COLOR_WHITE];
+      yuv_secondary.Y = 255;
+      break;
+    case 2:
+      yuv_primary = p->colors[COLOR_RED];
+      yuv_secondary = p->colors[COLOR_RED];
+      yuv_secondary.V = 255;
+      break;
+    case 3:
+    default:
+      yuv_primary = p->colors[COLOR_BLUE];
+      yuv_secondary = p->colors[COLOR_BLUE];
+      yuv_secondary.U = 255;
+      break;
+  }
+
+  for (x = 0; x < w; x += 8) {
+    int len = MIN (8, w - x);
+
+    if ((x ^ y) & (1 << 4)) {
+      p->color = &yuv_primary;
+    } else {
+      p->color = &yuv_secondary;
+    }
+    p->paint_tmpline (p, x, len);
+  }
+  videotestsrc_convert_tmpline (p, frame, y);
+}
+
 void
 gst_video_test_src_gamut (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int x, y;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
-  struct vts_color_struct yuv_primary;
-  struct vts_color_struct yuv_secondary;
   int w = frame->info.width, h = frame->info.height;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
-  for (y = 0; y < h; y++) {
-    int region = (y * 4) / h;
+  videotestsrc_paint_lines (v, p, frame, paint_gamut_line, NULL);
+}
 
-    switch (region) {
-      case 0:                  /* black */
-        yuv_primary = p->colors[COLOR_BLACK];
-        yuv_secondary = p->colors[COLOR_BLACK];
-        yuv_secondary.Y = 0;
-        break;
-      case 1:
-        yuv_primary = p->colors[COLOR_WHITE];
-        yuv_secondary = p->colors[COLOR_WHITE];
-        yuv_secondary.Y = 255;
-        break;
-      case 2:
-        yuv_primary = p->colors[COLOR_RED];
-        yuv_secondary = p->colors[COLOR_RED];
-        yuv_secondary.V = 255;
-        break;
-      case 3:
-        yuv_primary = p->colors[COLOR_BLUE];
-        yuv_secondary = p->colors[COLOR_BLUE];
-        yuv_secondary.U = 255;
-        break;
+typedef struct
+{
+  double x, y;
+  int radius;
+  struct vts_color_struct *foreground_color;
+  struct vts_color_struct *background_color;
+} BallParams;
+
+static void
+paint_ball_line (GstVideoTestSrc * v, paintinfo * p, GstVideoFrame * frame,
+    gconstpointer data, int i)
+{
+  const BallParams *bp = data;
+  double x = bp->x, y = bp->y;
+  int radius = bp->radius;
+  int w = frame->info.width;
+
+  if (i < y - radius || i > y + radius) {
+    memset (p->tmpline_u8, 0, w);
+  } else {
+    double o = MAX (0, (radius * radius - (i - y) * (i - y)));
+    int r = rint (sqrt (o));
+    int x1, x2;
+    int j;
+
+    x1 = 0;
+    x2 = MAX (0, x - r);
+    for (j = x1; j < x2; j++) {
+      p->tmpline_u8[j] = 0;
     }
 
-    for (x = 0; x < w; x += 8) {
-      int len = MIN (8, w - x);
+    x1 = MAX (0, x - r);
+    x2 = MIN (w, x + r + 1);
+    for (j = x1; j < x2; j++) {
+      double rr = radius - sqrt ((j - x) * (j - x) + (i - y) * (i - y));
 
-      if ((x ^ y) & (1 << 4)) {
-        p->color = &yuv_primary;
-      } else {
-        p->color = &yuv_secondary;
-      }
-      p->paint_tmpline (p, x, len);
+      rr *= 0.5;
+      p->tmpline_u8[j] = CLAMP ((int) floor (256 * rr), 0, 255);
     }
-    videotestsrc_convert_tmpline (p, frame, y);
+
+    x1 = MIN (w, x + r + 1);
+    x2 = w;
+    for (j = x1; j < x2; j++) {
+      p->tmpline_u8[j] = 0;
+    }
+  }
+
+  if ((v->motion_type == GST_VIDEO_TEST_SRC_SWEEP) ||
+      (v->motion_type == GST_VIDEO_TEST_SRC_HSWEEP)) {
+    /* dot in the middle (to draw a line down the center) */
+    p->tmpline_u8[w / 2] = 255;
+    p->tmpline_u8[(int) x] = 255;
   }
+
+  videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
+      bp->foreground_color, bp->background_color, w);
+  videotestsrc_convert_tmpline (p, frame, i);
 }
 
 void
@@ -1085,6 +1250,7 @@ gst_video_test_src_ball (GstVideoTestSrc * v, GstClockTime pts,
   gdouble rad = 0;
   double x, y;
   int flipit = 0;
+  BallParams bp;
 
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
@@ -1142,48 +1308,12 @@ gst_video_test_src_ball (GstVideoTestSrc * v, GstClockTime pts,
 
   /* draw ball on frame */
   videotestsrc_setup_paintinfo (v, p, w, h);
-  for (i = 0; i < h; i++) {
-    if (i < y - radius || i > y + radius) {
-      memset (p->tmpline_u8, 0, w);
-    } else {
-      double o = MAX (0, (radius * radius - (i - y) * (i - y)));
-      int r = rint (sqrt (o));
-      int x1, x2;
-      int j;
-
-      x1 = 0;
-      x2 = MAX (0, x - r);
-      for (j = x1; j < x2; j++) {
-        p->tmpline_u8[j] = 0;
-      }
-
-      x1 = MAX (0, x - r);
-      x2 = MIN (w, x + r + 1);
-      for (j = x1; j < x2; j++) {
-        double rr = radius - sqrt ((j - x) * (j - x) + (i - y) * (i - y));
-
-        rr *= 0.5;
-        p->tmpline_u8[j] = CLAMP ((int) floor (256 * rr), 0, 255);
-      }
-
-      x1 = MIN (w, x + r + 1);
-      x2 = w;
-      for (j = x1; j < x2; j++) {
-        p->tmpline_u8[j] = 0;
-      }
-    }
-
-    if ((v->motion_type == GST_VIDEO_TEST_SRC_SWEEP) ||
-        (v->motion_type == GST_VIDEO_TEST_SRC_HSWEEP)) {
-      /* dot in the middle (to draw a line down the center) */
-      p->tmpline_u8[w / 2] = 255;
-      p->tmpline_u8[(int) x] = 255;
-    }
-
-    videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
-        foreground_color, background_color, w);
-    videotestsrc_convert_tmpline (p, frame, i);
-  }
+  bp.x = x;
+  bp.y = y;
+  bp.radius = radius;
+  bp.foreground_color = foreground_color;
+  bp.background_color = background_color;
+  videotestsrc_paint_lines (v, p, frame, paint_ball_line, &bp);
 
   if ((v->motion_type == GST_VIDEO_TEST_SRC_SWEEP) ||
       (v->motion_type == GST_VIDEO_TEST_SRC_HSWEEP)) {
@@ -1323,20 +1453,55 @@ convert_hline_bayer (paintinfo * p, GstVideoFrame * frame, int y)
   }
 }
 
+/* angles of the 19 lines of the pinwheel and spokes patterns */
+typedef struct
+{
+  double c[20];
+  double s[20];
+} RotationParams;
+
+static void
+paint_pinwheel_line (GstVideoTestSrc * v, paintinfo * p, GstVideoFrame * frame,
+    gconstpointer data, int j)
+{
+  const RotationParams *rp = data;
+  int i, k;
+  int w = frame->info.width, h = frame->info.height;
+
+  for (i = 0; i < w; i++) {
+    double v;
+    v = 0;
+    for (k = 0; k < 19; k++) {
+      double x, y;
+
+      x = rp->c[k] * (i - 0.5 * w) + rp->s[k] * (j - 0.5 * h);
+      x *= 1.0;
+
+      y = CLAMP (x, -1, 1);
+      if (k & 1)
+        y = -y;
+
+      v += y;
+    }
+
+    p->tmpline_u8[i] = CLAMP (rint (v * 128 + 128), 0, 255);
+  }
+  videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
+      &p->foreground_color, &p->background_color, w);
+  videotestsrc_convert_tmpline (p, frame, j);
+}
+
 void
 gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int i;
-  int j;
   int k;
   int t = v->n_frames;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
-  double c[20];
-  double s[20];
+  RotationParams rp;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
@@ -1345,49 +1510,56 @@ gst_video_test_src_pinwheel (GstVideoTestSrc * v, GstClockTime pts,
 
   for (k = 0; k < 19; k++) {
     double theta = M_PI / 19 * k + 0.001 * v->kt * t;
-    c[k] = cos (theta);
-    s[k] = sin (theta);
+    rp.c[k] = cos (theta);
+    rp.s[k] = sin (theta);
   }
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++) {
-      double v;
-      v = 0;
-      for (k = 0; k < 19; k++) {
-        double x, y;
+  videotestsrc_paint_lines (v, p, frame, paint_pinwheel_line, &rp);
+}
 
-        x = c[k] * (i - 0.5 * w) + s[k] * (j - 0.5 * h);
-        x *= 1.0;
+static void
+paint_spokes_line (GstVideoTestSrc * v, paintinfo * p, GstVideoFrame * frame,
+    gconstpointer data, int j)
+{
+  const RotationParams *rp = data;
+  int i, k;
+  int w = frame->info.width, h = frame->info.height;
 
-        y = CLAMP (x, -1, 1);
-        if (k & 1)
-          y = -y;
+  for (i = 0; i < w; i++) {
+    double v;
+    v = 0;
+    for (k = 0; k < 19; k++) {
+      double x, y;
+      double sharpness = 1.0;
+      double linewidth = 2.0;
 
-        v += y;
-      }
+      x = rp->c[k] * (i - 0.5 * w) + rp->s[k] * (j - 0.5 * h);
+      x = linewidth * 0.5 - fabs (x);
+      x *= sharpness;
 
-      p->tmpline_u8[i] = CLAMP (rint (v * 128 + 128), 0, 255);
+      y = CLAMP (x + 0.5, 0.0, 1.0);
+
+      v += y;
     }
-    videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
-        &p->foreground_color, &p->background_color, w);
-    videotestsrc_convert_tmpline (p, frame, j);
+
+    p->tmpline_u8[i] = CLAMP (rint (v * 255), 0, 255);
   }
+  videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
+      &p->foreground_color, &p->background_color, w);
+  videotestsrc_convert_tmpline (p, frame, j);
 }
 
 void
 gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
     GstVideoFrame * frame)
 {
-  int i;
-  int j;
   int k;
   int t = v->n_frames;
   paintinfo pi = PAINT_INFO_INIT;
   paintinfo *p = &pi;
   struct vts_color_struct color;
   int w = frame->info.width, h = frame->info.height;
-  double c[20];
-  double s[20];
+  RotationParams rp;
 
   videotestsrc_setup_paintinfo (v, p, w, h);
 
@@ -1396,34 +1568,11 @@ gst_video_test_src_spokes (GstVideoTestSrc * v, GstClockTime pts,
 
   for (k = 0; k < 19; k++) {
     double theta = M_PI / 19 * k + 0.001 * v->kt * t;
-    c[k] = cos (theta);
-    s[k] = sin (theta);
+    rp.c[k] = cos (theta);
+    rp.s[k] = sin (theta);
   }
 
-  for (j = 0; j < h; j++) {
-    for (i = 0; i < w; i++) {
-      double v;
-      v = 0;
-      for (k = 0; k < 19; k++) {
-        double x, y;
-        double sharpness = 1.0;
-        double linewidth = 2.0;
-
-        x = c[k] * (i - 0.5 * w) + s[k] * (j - 0.5 * h);
-        x = linewidth * 0.5 - fabs (x);
-        x *= sharpness;
-
-        y = CLAMP (x + 0.5, 0.0, 1.0);
-
-        v += y;
-      }
-
-      p->tmpline_u8[i] = CLAMP (rint (v * 255), 0, 255);
-    }
-    videotestsrc_blend_line (v, p->tmpline, p->tmpline_u8,
-        &p->foreground_color, &p->background_color, w);
-    videotestsrc_convert_tmpline (p, frame, j);
-  }
+  videotestsrc_paint_lines (v, p, frame, paint_spokes_line, &rp);
 }
 
 void
@@ -47,6 +47,8 @@
 #include <gst/base/gstbasetransform.h>
 #include <gst/audio/audio.h>
 #include <gst/audio/gstaudiofilter.h>
+#include <gst/controller/gstdirectcontrolbinding.h>
+#include <gst/controller/gstinterpolationcontrolsource.h>
 
 #ifdef HAVE_ORC
 #include <orc/orcfunctions.h>
@@ -79,6 +81,9 @@
 #define VOLUME_MAX_INT32             G_MAXINT32
 #define VOLUME_MIN_INT32             G_MININT32
 
+/* number of volumes generated at once when applying a linear ramp */
+#define VOLUME_RAMP_CHUNK            256
+
 #define GST_CAT_DEFAULT gst_volume_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
@@ -102,7 +107,7 @@ enum
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
 #define ALLOWED_CAPS \
     GST_AUDIO_CAPS_MAKE ("{ F32LE, F64LE, S8, S16LE, S24LE, S32LE }") \
-    ", layout = (string) interleaved"
+    ", layout = (string) { interleaved, non-interleaved }"
 #else
 #define ALLOWED_CAPS \
     GST_AUDIO_CAPS_MAKE ("{ F32BE, F64BE, S8, S16BE, S24BE, S32BE }") \
@@ -292,6 +297,11 @@ gst_volume_dispose (GObject * object)
     volume->tracklist = NULL;
   }
 
+  if (volume->silence) {
+    gst_memory_unref (volume->silence);
+    volume->silence = NULL;
+  }
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -351,6 +361,63 @@ gst_volume_init (GstVolume * self)
   gst_base_transform_set_gap_aware (GST_BASE_TRANSFORM (self), TRUE);
 }
 
+/* Per-frame loops for the layouts without ORC functions. They are inlined
+ * with a constant channel count for the common 5.1 and 7.1 layouts, which
+ * lets the compiler unroll and vectorize the inner loop. */
+#define DEFINE_PROCESS_CONTROLLED_NCH_FLOAT(name,type)                      \
+static inline void                                                          \
+volume_process_controlled_##name##_nch (type * data, const gdouble * volume, \
+    guint channels, guint num_samples)                                      \
+{                                                                           \
+  guint i, j;                                                               \
+                                                                            \
+  for (i = 0; i < num_samples; i++) {                                       \
+    type vol = volume[i];                                                   \
+                                                                            \
+    for (j = 0; j < channels; j++)                                          \
+      data[j] *= vol;                                                       \
+    data += channels;                                                       \
+  }                                                                         \
+}
+
+#define DEFINE_PROCESS_CONTROLLED_NCH_INT(name,type,min,max)                \
+static inline void                                                          \
+volume_process_controlled_##name##_nch (type * data, const gdouble * volume, \
+    guint channels, guint num_samples)                                      \
+{                                                                           \
+  guint i, j;                                                               \
+                                                                            \
+  for (i = 0; i < num_samples; i++) {                                       \
+    gdouble vol = volume[i];                                                \
+                                                                            \
+    for (j = 0; j < channels; j++) {                                        \
+      gdouble val = data[j] * vol;                                          \
+      data[j] = (type) CLAMP (val, min, max);                               \
+    }                                                                       \
+    data += channels;                                                       \
+  }                                                                         \
+}
+
+DEFINE_PROCESS_CONTROLLED_NCH_FLOAT (f64, gdouble);
+DEFINE_PROCESS_CONTROLLED_NCH_FLOAT (f32, gfloat);
+DEFINE_PROCESS_CONTROLLED_NCH_INT (int32, gint32, VOLUME_MIN_INT32,
+    VOLUME_MAX_INT32);
+DEFINE_PROCESS_CONTROLLED_NCH_INT (int16, gint16, VOLUME_MIN_INT16,
+    VOLUME_MAX_INT16);
+DEFINE_PROCESS_CONTROLLED_NCH_INT (int8, gint8, VOLUME_MIN_INT8,
+    VOLUME_MAX_INT8);
+
+#define PROCESS_CONTROLLED_NCH(name,data,volume,channels,num_samples)       \
+G_STMT_START {                                                              \
+  if (channels == 6)                                                        \
+    volume_process_controlled_##name##_nch (data, volume, 6, num_samples);  \
+  else if (channels == 8)                                                   \
+    volume_process_controlled_##name##_nch (data, volume, 8, num_samples);  \
+  else                                                                      \
+    volume_process_controlled_##name##_nch (data, volume, channels,         \
+        num_samples);                                                       \
+} G_STMT_END
+
 static void
 volume_process_double (GstVolume * self, gpointer bytes, guint n_bytes)
 {
@@ -366,18 +433,11 @@ volume_process_controlled_double (GstVolume * self, gpointer bytes,
 {
   gdouble *data = (gdouble *) bytes;
   guint num_samples = n_bytes / (sizeof (gdouble) * channels);
-  guint i, j;
-  gdouble vol;
 
   if (channels == 1) {
     volume_orc_process_controlled_f64_1ch (data, volume, num_samples);
   } else {
-    for (i = 0; i < num_samples; i++) {
-      vol = *volume++;
-      for (j = 0; j < channels; j++) {
-        *data++ *= vol;
-      }
-    }
+    PROCESS_CONTROLLED_NCH (f64, data, volume, channels, num_samples);
   }
 }
 
@@ -396,20 +456,13 @@ volume_process_controlled_float (GstVolume * self, gpointer bytes,
 {
   gfloat *data = (gfloat *) bytes;
   guint num_samples = n_bytes / (sizeof (gfloat) * channels);
-  guint i, j;
-  gdouble vol;
 
   if (channels == 1) {
     volume_orc_process_controlled_f32_1ch (data, volume, num_samples);
   } else if (channels == 2) {
     volume_orc_process_controlled_f32_2ch (data, volume, num_samples);
   } else {
-    for (i = 0; i < num_samples; i++) {
-      vol = *volume++;
-      for (j = 0; j < channels; j++) {
-        *data++ *= vol;
-      }
-    }
+    PROCESS_CONTROLLED_NCH (f32, data, volume, channels, num_samples);
   }
 }
 
@@ -441,20 +494,12 @@ volume_process_controlled_int32_clamp (GstVolume * self, gpointer bytes,
     gdouble * volume, guint channels, guint n_bytes)
 {
   gint32 *data = (gint32 *) bytes;
-  guint i, j;
   guint num_samples = n_bytes / (sizeof (gint32) * channels);
-  gdouble vol, val;
 
   if (channels == 1) {
     volume_orc_process_controlled_int32_1ch (data, volume, num_samples);
   } else {
-    for (i = 0; i < num_samples; i++) {
-      vol = *volume++;
-      for (j = 0; j < channels; j++) {
-        val = *data * vol;
-        *data++ = (gint32) CLAMP (val, VOLUME_MIN_INT32, VOLUME_MAX_INT32);
-      }
-    }
+    PROCESS_CONTROLLED_NCH (int32, data, volume, channels, num_samples);
   }
 }
 
@@ -572,22 +617,14 @@ volume_process_controlled_int16_clamp (GstVolume * self, gpointer bytes,
     gdouble * volume, guint channels, guint n_bytes)
 {
   gint16 *data = (gint16 *) bytes;
-  guint i, j;
   guint num_samples = n_bytes / (sizeof (gint16) * channels);
-  gdouble vol, val;
 
   if (channels == 1) {
     volume_orc_process_controlled_int16_1ch (data, volume, num_samples);
   } else if (channels == 2) {
     volume_orc_process_controlled_int16_2ch (data, volume, num_samples);
   } else {
-    for (i = 0; i < num_samples; i++) {
-      vol = *volume++;
-      for (j = 0; j < channels; j++) {
-        val = *data * vol;
-        *data++ = (gint16) CLAMP (val, VOLUME_MIN_INT16, VOLUME_MAX_INT16);
-      }
-    }
+    PROCESS_CONTROLLED_NCH (int16, data, volume, channels, num_samples);
   }
 }
 
@@ -620,22 +657,14 @@ volume_process_controlled_int8_clamp (GstVolume * self, gpointer bytes,
     gdouble * volume, guint channels, guint n_bytes)
 {
   gint8 *data = (gint8 *) bytes;
-  guint i, j;
   guint num_samples = n_bytes / (sizeof (gint8) * channels);
-  gdouble val, vol;
 
   if (channels == 1) {
     volume_orc_process_controlled_int8_1ch (data, volume, num_samples);
   } else if (channels == 2) {
     volume_orc_process_controlled_int8_2ch (data, volume, num_samples);
   } else {
-    for (i = 0; i < num_samples; i++) {
-      vol = *volume++;
-      for (j = 0; j < channels; j++) {
-        val = *data * vol;
-        *data++ = (gint8) CLAMP (val, VOLUME_MIN_INT8, VOLUME_MAX_INT8);
-      }
-    }
+    PROCESS_CONTROLLED_NCH (int8, data, volume, channels, num_samples);
   }
 }
 
@@ -678,6 +707,11 @@ volume_stop (GstBaseTransform * base)
   self->mutes = NULL;
   self->mutes_count = 0;
 
+  if (self->silence) {
+    gst_memory_unref (self->silence);
+    self->silence = NULL;
+  }
+
   return GST_CALL_PARENT_WITH_DEFAULT (GST_BASE_TRANSFORM_CLASS, stop, (base),
       TRUE);
 }
@@ -713,6 +747,122 @@ volume_before_transform (GstBaseTransform * base, GstBuffer * buffer)
   }
 }
 
+/* Checks if @binding changes the volume linearly over the @nsamples samples
+ * starting at @ts. This is the case for linear and step interpolation when
+ * no control point lies in between, and then gives the volume of the first
+ * sample and by how much it changes from one sample to the next. */
+static gboolean
+volume_get_ramp (GstVolume * self, GstControlBinding * binding,
+    GstClockTime ts, GstClockTime interval, guint nsamples, gdouble * start,
+    gdouble * step)
+{
+  GstControlSource *cs = NULL;
+  GstTimedValueControlSource *tvcs;
+  GstInterpolationMode mode;
+  GstClockTime end = ts + (nsamples - 1) * interval;
+  GSequenceIter *iter;
+  GValue *first, *last;
+  gboolean res = FALSE;
+
+  if (nsamples < 2 || !GST_IS_DIRECT_CONTROL_BINDING (binding))
+    return FALSE;
+
+  g_object_get (binding, "control-source", &cs, NULL);
+  if (!GST_IS_INTERPOLATION_CONTROL_SOURCE (cs))
+    goto done;
+
+  g_object_get (cs, "mode", &mode, NULL);
+  if (mode != GST_INTERPOLATION_MODE_NONE
+      && mode != GST_INTERPOLATION_MODE_LINEAR)
+    goto done;
+
+  tvcs = GST_TIMED_VALUE_CONTROL_SOURCE (cs);
+  g_mutex_lock (&tvcs->lock);
+  /* before the first control point there are no values at all */
+  iter = gst_timed_value_control_source_find_control_point_iter (tvcs, ts);
+  if (iter) {
+    iter = g_sequence_iter_next (iter);
+    res = g_sequence_iter_is_end (iter)
+        || ((GstControlPoint *) g_sequence_get (iter))->timestamp > end;
+  }
+  g_mutex_unlock (&tvcs->lock);
+
+  if (!res)
+    goto done;
+
+  first = gst_control_binding_get_value (binding, ts);
+  last = gst_control_binding_get_value (binding, end);
+  if (first && last) {
+    *start = g_value_get_double (first);
+    *step = (g_value_get_double (last) - *start) / (nsamples - 1);
+  } else {
+    res = FALSE;
+  }
+
+  if (first) {
+    g_value_unset (first);
+    g_free (first);
+  }
+  if (last) {
+    g_value_unset (last);
+    g_free (last);
+  }
+
+done:
+  if (cs)
+    gst_object_unref (cs);
+
+  return res;
+}
+
+/* Replaces the memory of @buffer with silence shared by all muted buffers,
+ * instead of writing zeroes over all of it */
+static void
+volume_fill_silence (GstVolume * self, GstBuffer * buffer)
+{
+  gsize size = gst_buffer_get_size (buffer);
+
+  if (self->silence == NULL || self->silence->size < size) {
+    GstMapInfo map;
+
+    if (self->silence)
+      gst_memory_unref (self->silence);
+
+    /* all supported formats are signed, their silence is all zeroes */
+    self->silence = gst_allocator_alloc (NULL, size, NULL);
+    gst_memory_map (self->silence, &map, GST_MAP_WRITE);
+    orc_memset (map.data, 0, map.size);
+    gst_memory_unmap (self->silence, &map);
+  }
+
+  gst_buffer_replace_all_memory (buffer,
+      gst_memory_share (self->silence, 0, size));
+  GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_GAP);
+}
+
+/* apply @volumes to @n_frames frames of @abuf, starting at frame @offset.
+ * The planes of non-interleaved audio are processed as mono streams, which
+ * also keeps the per-channel data contiguous for the ORC 1-channel paths. */
+static void
+volume_process_controlled_frames (GstVolume * self, GstAudioBuffer * abuf,
+    gdouble * volumes, guint offset, guint n_frames)
+{
+  gint bps = GST_AUDIO_INFO_BPS (&abuf->info);
+  gint channels = GST_AUDIO_INFO_CHANNELS (&abuf->info);
+  gint i;
+
+  if (GST_AUDIO_INFO_LAYOUT (&abuf->info) == GST_AUDIO_LAYOUT_INTERLEAVED) {
+    self->process_controlled (self,
+        (guint8 *) abuf->planes[0] + offset * bps * channels, volumes,
+        channels, n_frames * bps * channels);
+  } else {
+    for (i = 0; i < abuf->n_planes; i++)
+      self->process_controlled (self,
+          (guint8 *) abuf->planes[i] + offset * bps, volumes, 1,
+          n_frames * bps);
+  }
+}
+
 /* call the plugged-in process function for this instance
  * needs to be done with this indirection since volume_transform is
  * a class-global method
@@ -722,6 +872,7 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
 {
   GstAudioFilter *filter = GST_AUDIO_FILTER_CAST (base);
   GstVolume *self = GST_VOLUME (base);
+  GstAudioBuffer abuf;
   GstMapInfo map;
   GstClockTime ts;
 
@@ -732,7 +883,6 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
   if (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_GAP))
     return GST_FLOW_OK;
 
-  gst_buffer_map (outbuf, &map, GST_MAP_READWRITE);
   ts = GST_BUFFER_TIMESTAMP (outbuf);
   ts = gst_segment_to_stream_time (&base->segment, GST_FORMAT_TIME, ts);
 
@@ -744,12 +894,41 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
 
     if (mute_cb || (volume_cb && !self->current_mute)) {
       gint rate = GST_AUDIO_INFO_RATE (&filter->info);
-      gint width = GST_AUDIO_FORMAT_INFO_WIDTH (filter->info.finfo) / 8;
-      gint channels = GST_AUDIO_INFO_CHANNELS (&filter->info);
-      guint nsamples = map.size / (width * channels);
+      GstAudioMeta *meta = gst_buffer_get_audio_meta (outbuf);
+      guint nsamples = meta ? meta->samples :
+          gst_buffer_get_size (outbuf) / GST_AUDIO_INFO_BPF (&filter->info);
       GstClockTime interval = gst_util_uint64_scale_int (1, GST_SECOND, rate);
       gboolean have_mutes = FALSE;
       gboolean have_volumes = FALSE;
+      gdouble start, step;
+
+      if (!mute_cb && volume_get_ramp (self, volume_cb, ts, interval,
+              nsamples, &start, &step)) {
+        gdouble volumes[VOLUME_RAMP_CHUNK];
+        guint i, j, n;
+
+        gst_object_unref (volume_cb);
+
+        /* the property was already synced to a constant volume */
+        if (step == 0.0)
+          goto process;
+
+        GST_LOG_OBJECT (self, "applying ramp from %f by %g per sample", start,
+            step);
+
+        if (!gst_audio_buffer_map (&abuf, &filter->info, outbuf,
+                GST_MAP_READWRITE))
+          goto map_failed;
+        for (i = 0; i < nsamples; i += n) {
+          n = MIN (nsamples - i, VOLUME_RAMP_CHUNK);
+          for (j = 0; j < n; j++)
+            volumes[j] = start + (i + j) * step;
+          volume_process_controlled_frames (self, &abuf, volumes, i, n);
+        }
+        gst_audio_buffer_unmap (&abuf);
+
+        return GST_FLOW_OK;
+      }
 
       if (self->mutes_count < nsamples && mute_cb) {
         self->mutes = g_realloc (self->mutes, sizeof (gboolean) * nsamples);
@@ -784,23 +963,32 @@ volume_transform_ip (GstBaseTransform * base, GstBuffer * outbuf)
         self->mutes_count = 0;
       }
 
-      self->process_controlled (self, map.data, self->volumes, channels,
-          map.size);
+      if (!gst_audio_buffer_map (&abuf, &filter->info, outbuf,
+              GST_MAP_READWRITE))
+        goto map_failed;
+      volume_process_controlled_frames (self, &abuf, self->volumes, 0,
+          nsamples);
+      gst_audio_buffer_unmap (&abuf);
 
-      goto done;
+      return GST_FLOW_OK;
     } else if (volume_cb) {
       gst_object_unref (volume_cb);
     }
   }
 
+process:
   if (self->current_volume == 0.0 || self->current_mute) {
-    orc_memset (map.data, 0, map.size);
-    GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  } else if (self->current_volume != 1.0) {
-    self->process (self, map.data, map.size);
+    volume_fill_silence (self, outbuf);
+    return GST_FLOW_OK;
+  } else if (self->current_volume == 1.0) {
+    /* unity volume with a controller, nothing to do */
+    return GST_FLOW_OK;
   }
 
-done:
+  /* a constant volume does not depend on the channel, so the samples of all
+   * planes can be processed in one go whatever the layout */
+  gst_buffer_map (outbuf, &map, GST_MAP_READWRITE);
+  self->process (self, map.data, map.size);
   gst_buffer_unmap (outbuf, &map);
 
   return GST_FLOW_OK;
@@ -812,6 +1000,12 @@ not_negotiated:
         ("No format was negotiated"), (NULL));
     return GST_FLOW_NOT_NEGOTIATED;
   }
+map_failed:
+  {
+    GST_ELEMENT_ERROR (self, STREAM, FAILED, (NULL),
+        ("Failed to map audio buffer"));
+    return GST_FLOW_ERROR;
+  }
 }
 
 static void
@@ -75,6 +75,9 @@ struct _GstVolume {
   guint mutes_count;
   gdouble *volumes;
   guint volumes_count;
+
+  /* shared by all muted buffers */
+  GstMemory *silence;
 };
 
 struct _GstVolumeClass {
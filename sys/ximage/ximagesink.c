@@ -136,6 +136,8 @@ static void gst_x_image_sink_xwindow_update_geometry (GstXImageSink *
     ximagesink);
 static void gst_x_image_sink_expose (GstVideoOverlay * overlay);
 
+#define YUV_FORMATS "I420, YV12, NV12, YUY2, UYVY"
+
 static GstStaticPadTemplate gst_x_image_sink_sink_template_factory =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -223,6 +225,75 @@ gst_x_image_sink_xwindow_draw_borders (GstXImageSink * ximagesink,
   }
 }
 
+/* number of images the X server can still be reading from when a put
+ * returns. One lets the server read the last image while upstream prepares
+ * the next one, without holding more buffers than the last image we keep
+ * for expose anyway. */
+#define MAX_PENDING_IMAGES 1
+
+#ifdef HAVE_XSHM
+/* Moves the pending images up to the one completed by @event to @done. Must
+ * be called with the flow_lock and the x_lock held. */
+static void
+gst_x_image_sink_image_completed (GstXImageSink * ximagesink,
+    XEvent * event, GQueue * done)
+{
+  XShmCompletionEvent *completion = (XShmCompletionEvent *) event;
+  GList *l;
+  gboolean last;
+
+  for (l = ximagesink->pending_images.head; l; l = l->next) {
+    GstXImageMemory *mem =
+        (GstXImageMemory *) gst_buffer_peek_memory (l->data, 0);
+
+    if (mem->SHMInfo.shmseg == completion->shmseg)
+      break;
+  }
+
+  /* already released */
+  if (l == NULL)
+    return;
+
+  /* puts complete in order, so all images before this one are done too */
+  do {
+    last = ximagesink->pending_images.head == l;
+    g_queue_push_tail (done, g_queue_pop_head (&ximagesink->pending_images));
+  } while (!last);
+}
+
+/* Releases the images the X server is done with, or all of them when @all is
+ * TRUE. Must be called with the flow_lock held. */
+static void
+gst_x_image_sink_release_images (GstXImageSink * ximagesink, gboolean all)
+{
+  GstXContext *xcontext = ximagesink->xcontext;
+  GQueue done = G_QUEUE_INIT;
+  GstBuffer *buf;
+  XEvent e;
+
+  g_mutex_lock (&ximagesink->x_lock);
+  while (XCheckTypedEvent (xcontext->disp, xcontext->shm_completion, &e))
+    gst_x_image_sink_image_completed (ximagesink, &e, &done);
+
+  /* when the server falls behind, or an event got lost because the put
+   * failed, wait for it to process everything instead of piling up images */
+  if (all || ximagesink->pending_images.length > MAX_PENDING_IMAGES) {
+    GST_LOG_OBJECT (ximagesink, "waiting for %u pending images",
+        ximagesink->pending_images.length);
+    XSync (xcontext->disp, FALSE);
+    while (XCheckTypedEvent (xcontext->disp, xcontext->shm_completion, &e))
+      continue;
+    while ((buf = g_queue_pop_head (&ximagesink->pending_images)))
+      g_queue_push_tail (&done, buf);
+  }
+  g_mutex_unlock (&ximagesink->x_lock);
+
+  /* this can free the images, which takes the x_lock */
+  while ((buf = g_queue_pop_head (&done)))
+    gst_buffer_unref (buf);
+}
+#endif /* HAVE_XSHM */
+
 /* This function puts a GstXImageBuffer on a GstXImageSink's window */
 static gboolean
 gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
@@ -233,6 +304,7 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
   GstVideoRectangle dst = { 0, };
   GstVideoRectangle result;
   gboolean draw_border = FALSE;
+  gboolean async = FALSE;
 
   /* We take the flow_lock. If expose is in there we don't want to run
      concurrently from the data flow thread */
@@ -300,13 +372,15 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
   }
 #ifdef HAVE_XSHM
   if (ximagesink->xcontext->use_xshm) {
+    async = ximagesink->xcontext->shm_completion != 0;
+
     GST_LOG_OBJECT (ximagesink,
         "XShmPutImage on %p, src: %d, %d - dest: %d, %d, dim: %dx%d, win %dx%d",
         ximage, 0, 0, result.x, result.y, result.w, result.h,
         ximagesink->xwindow->width, ximagesink->xwindow->height);
     XShmPutImage (ximagesink->xcontext->disp, ximagesink->xwindow->win,
         ximagesink->xwindow->gc, mem->ximage, src.x, src.y, result.x, result.y,
-        result.w, result.h, FALSE);
+        result.w, result.h, async);
   } else
 #endif /* HAVE_XSHM */
   {
@@ -319,10 +393,22 @@ gst_x_image_sink_ximage_put (GstXImageSink * ximagesink, GstBuffer * ximage)
         result.w, result.h);
   }
 
-  XSync (ximagesink->xcontext->disp, FALSE);
+  /* with a completion event coming there is no need to wait for the server,
+   * we keep the image alive until then */
+  if (async)
+    XFlush (ximagesink->xcontext->disp);
+  else
+    XSync (ximagesink->xcontext->disp, FALSE);
 
   g_mutex_unlock (&ximagesink->x_lock);
 
+#ifdef HAVE_XSHM
+  if (async) {
+    g_queue_push_tail (&ximagesink->pending_images, gst_buffer_ref (ximage));
+    gst_x_image_sink_release_images (ximagesink, FALSE);
+  }
+#endif /* HAVE_XSHM */
+
   g_mutex_unlock (&ximagesink->flow_lock);
 
   return TRUE;
@@ -561,9 +647,14 @@ gst_x_image_sink_handle_xevents (GstXImageSink * ximagesink)
   gint pointer_x = 0, pointer_y = 0;
   gboolean pointer_moved = FALSE;
   gboolean exposed = FALSE, configured = FALSE;
+  GQueue completed = G_QUEUE_INIT;
+  GstBuffer *buf;
 
   g_return_if_fail (GST_IS_X_IMAGE_SINK (ximagesink));
 
+  /* pointer motion held back by the coalescing window */
+  gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (ximagesink), FALSE);
+
   /* Then we get all pointer motion events, only the last position is
      interesting. */
   g_mutex_lock (&ximagesink->flow_lock);
@@ -590,10 +681,8 @@ gst_x_image_sink_handle_xevents (GstXImageSink * ximagesink)
     g_mutex_unlock (&ximagesink->x_lock);
     g_mutex_unlock (&ximagesink->flow_lock);
 
-    GST_DEBUG ("ximagesink pointer moved over window at %d,%d",
-        pointer_x, pointer_y);
-    gst_navigation_send_mouse_event (GST_NAVIGATION (ximagesink),
-        "mouse-move", 0, pointer_x, pointer_y);
+    gst_video_sink_send_mouse_move (GST_VIDEO_SINK (ximagesink), pointer_x,
+        pointer_y);
 
     g_mutex_lock (&ximagesink->flow_lock);
     g_mutex_lock (&ximagesink->x_lock);
@@ -611,6 +700,9 @@ gst_x_image_sink_handle_xevents (GstXImageSink * ximagesink)
     g_mutex_unlock (&ximagesink->x_lock);
     g_mutex_unlock (&ximagesink->flow_lock);
 
+    /* keep the order of pointer motion and other events */
+    gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (ximagesink), TRUE);
+
     switch (e.type) {
       case ButtonPress:
         /* Mouse button pressed/released over our window. We send upstream
@@ -709,11 +801,20 @@ gst_x_image_sink_handle_xevents (GstXImageSink * ximagesink)
         break;
       }
       default:
+#ifdef HAVE_XSHM
+        if (e.type == ximagesink->xcontext->shm_completion &&
+            ximagesink->xcontext->shm_completion != 0)
+          gst_x_image_sink_image_completed (ximagesink, &e, &completed);
+#endif /* HAVE_XSHM */
         break;
     }
   }
 
   g_mutex_unlock (&ximagesink->x_lock);
+
+  while ((buf = g_queue_pop_head (&completed)))
+    gst_buffer_unref (buf);
+
   g_mutex_unlock (&ximagesink->flow_lock);
 }
 
@@ -916,6 +1017,7 @@ gst_x_image_sink_xcontext_get (GstXImageSink * ximagesink)
   if (XShmQueryExtension (xcontext->disp) &&
       gst_x_image_sink_check_xshm_calls (ximagesink, xcontext)) {
     xcontext->use_xshm = TRUE;
+    xcontext->shm_completion = XShmGetEventBase (xcontext->disp) + ShmCompletion;
     GST_DEBUG ("ximagesink is using XShm extension");
   } else
 #endif /* HAVE_XSHM */
@@ -947,6 +1049,8 @@ gst_x_image_sink_xcontext_get (GstXImageSink * ximagesink)
   if (vformat == GST_VIDEO_FORMAT_UNKNOWN)
     goto unknown_format;
 
+  xcontext->format = vformat;
+
   /* update object's par with calculated one if not set yet */
   if (!ximagesink->par) {
     ximagesink->par = g_new0 (GValue, 1);
@@ -958,6 +1062,11 @@ gst_x_image_sink_xcontext_get (GstXImageSink * ximagesink)
       "width", GST_TYPE_INT_RANGE, 1, G_MAXINT,
       "height", GST_TYPE_INT_RANGE, 1, G_MAXINT,
       "framerate", GST_TYPE_FRACTION_RANGE, 0, 1, G_MAXINT, 1, NULL);
+  /* common YUV formats are converted straight into the images */
+  gst_caps_append (xcontext->caps, gst_caps_from_string ("video/x-raw, "
+          "format = (string) { " YUV_FORMATS " }, "
+          "width = (int) [ 1, MAX ], height = (int) [ 1, MAX ], "
+          "framerate = (fraction) [ 0, MAX ]"));
   if (ximagesink->par) {
     int nom, den;
 
@@ -1051,18 +1160,15 @@ gst_x_image_sink_getcaps (GstBaseSink * bsink, GstCaps * filter)
     }
 
     if (ximagesink->xwindow && ximagesink->xwindow->width) {
-      GstStructure *s0, *s1;
-
-      caps = gst_caps_make_writable (caps);
-
-      /* There can only be a single structure because the xcontext
-       * caps only have a single structure */
-      s0 = gst_caps_get_structure (caps, 0);
-      s1 = gst_structure_copy (gst_caps_get_structure (caps, 0));
+      GstCaps *sized;
 
-      gst_structure_set (s0, "width", G_TYPE_INT, ximagesink->xwindow->width,
-          "height", G_TYPE_INT, ximagesink->xwindow->height, NULL);
-      gst_caps_append_structure (caps, s1);
+      /* prefer the window size, in the same order of formats */
+      sized = gst_caps_copy (caps);
+      gst_caps_set_simple (sized, "width", G_TYPE_INT,
+          ximagesink->xwindow->width, "height", G_TYPE_INT,
+          ximagesink->xwindow->height, NULL);
+      gst_caps_append (sized, caps);
+      caps = sized;
 
       /* This will not change the order but will remove the
        * fixed width/height caps again if not possible
@@ -1142,8 +1248,10 @@ gst_x_image_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
 {
   GstXImageSink *ximagesink;
   GstStructure *structure;
-  GstVideoInfo info;
+  GstVideoInfo info, ximage_info;
+  GstVideoConverter *convert = NULL, *oldconvert;
   GstBufferPool *newpool, *oldpool;
+  GstCaps *pool_caps;
   const GValue *par;
 
   ximagesink = GST_X_IMAGE_SINK (bsink);
@@ -1208,8 +1316,35 @@ gst_x_image_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   /* Remember to draw borders for next frame */
   ximagesink->draw_border = TRUE;
 
+  /* frames in another format than the display one are converted into the
+   * images of the internal pool when they are shown */
+  if (GST_VIDEO_INFO_FORMAT (&info) != ximagesink->xcontext->format) {
+    gst_video_info_set_format (&ximage_info, ximagesink->xcontext->format,
+        info.width, info.height);
+    ximage_info.par_n = info.par_n;
+    ximage_info.par_d = info.par_d;
+    ximage_info.fps_n = info.fps_n;
+    ximage_info.fps_d = info.fps_d;
+
+    GST_DEBUG_OBJECT (ximagesink, "converting %s to %s",
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&info)),
+        gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&ximage_info)));
+
+    convert = gst_video_converter_new (&info, &ximage_info, NULL);
+    pool_caps = gst_video_info_to_caps (&ximage_info);
+  } else {
+    ximage_info = info;
+    pool_caps = gst_caps_ref (caps);
+  }
+
+  ximagesink->ximage_info = ximage_info;
+  oldconvert = ximagesink->convert;
+  ximagesink->convert = convert;
+
   /* create a new internal pool for the new configuration */
-  newpool = gst_x_image_sink_create_pool (ximagesink, caps, info.size, 2);
+  newpool = gst_x_image_sink_create_pool (ximagesink, pool_caps,
+      ximage_info.size, 2);
+  gst_caps_unref (pool_caps);
 
   /* we don't activate the internal pool yet as it may not be needed */
   oldpool = ximagesink->pool;
@@ -1221,6 +1356,8 @@ gst_x_image_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
     gst_buffer_pool_set_active (oldpool, FALSE);
     gst_object_unref (oldpool);
   }
+  if (oldconvert)
+    gst_video_converter_free (oldconvert);
 
   return TRUE;
 
@@ -1350,7 +1487,7 @@ gst_x_image_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
 
   ximagesink = GST_X_IMAGE_SINK (vsink);
 
-  if (gst_buffer_n_memory (buf) == 1
+  if (ximagesink->convert == NULL && gst_buffer_n_memory (buf) == 1
       && (mem = (GstXImageMemory *) gst_buffer_peek_memory (buf, 0))
       && g_strcmp0 (mem->parent.allocator->mem_type, "ximage") == 0
       && mem->sink == ximagesink) {
@@ -1388,12 +1525,17 @@ gst_x_image_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
     if (!gst_video_frame_map (&src, &ximagesink->info, buf, GST_MAP_READ))
       goto invalid_buffer;
 
-    if (!gst_video_frame_map (&dest, &ximagesink->info, to_put, GST_MAP_WRITE)) {
+    if (!gst_video_frame_map (&dest, &ximagesink->ximage_info, to_put,
+            GST_MAP_WRITE)) {
       gst_video_frame_unmap (&src);
       goto invalid_buffer;
     }
 
-    gst_video_frame_copy (&dest, &src);
+    /* convert straight into the image instead of copying */
+    if (ximagesink->convert)
+      gst_video_converter_frame (ximagesink->convert, &src, &dest);
+    else
+      gst_video_frame_copy (&dest, &src);
 
     gst_video_frame_unmap (&dest);
     gst_video_frame_unmap (&src);
@@ -1493,6 +1635,12 @@ gst_x_image_sink_propose_allocation (GstBaseSink * bsink, GstQuery * query)
   /* the normal size of a frame */
   size = info.size;
 
+  /* our images are in the display format, other formats are converted into
+   * them in show_frame */
+  if (ximagesink->xcontext
+      && GST_VIDEO_INFO_FORMAT (&info) != ximagesink->xcontext->format)
+    need_pool = FALSE;
+
   if (need_pool) {
     pool = gst_x_image_sink_create_pool (ximagesink, caps, info.size, 0);
 
@@ -1842,6 +1990,13 @@ gst_x_image_sink_reset (GstXImageSink * ximagesink)
   if (thread)
     g_thread_join (thread);
 
+#ifdef HAVE_XSHM
+  g_mutex_lock (&ximagesink->flow_lock);
+  if (!g_queue_is_empty (&ximagesink->pending_images))
+    gst_x_image_sink_release_images (ximagesink, TRUE);
+  g_mutex_unlock (&ximagesink->flow_lock);
+#endif /* HAVE_XSHM */
+
   if (ximagesink->cur_image) {
     gst_buffer_unref (ximagesink->cur_image);
     ximagesink->cur_image = NULL;
@@ -1854,6 +2009,11 @@ gst_x_image_sink_reset (GstXImageSink * ximagesink)
     ximagesink->pool = NULL;
   }
 
+  if (ximagesink->convert) {
+    gst_video_converter_free (ximagesink->convert);
+    ximagesink->convert = NULL;
+  }
+
   if (ximagesink->xwindow) {
     gst_x_image_sink_xwindow_clear (ximagesink, ximagesink->xwindow);
     gst_x_image_sink_xwindow_destroy (ximagesink, ximagesink->xwindow);
@@ -1896,6 +2056,7 @@ gst_x_image_sink_init (GstXImageSink * ximagesink)
   ximagesink->xcontext = NULL;
   ximagesink->xwindow = NULL;
   ximagesink->cur_image = NULL;
+  g_queue_init (&ximagesink->pending_images);
 
   ximagesink->event_thread = NULL;
   ximagesink->running = FALSE;
@@ -81,8 +81,10 @@ typedef struct _GstXImageSinkClass GstXImageSinkClass;
  * @heightmm ratio
  * @use_xshm: used to known whether of not XShm extension is usable or not even
  * if the Extension is present
+ * @shm_completion: the type of XShmCompletionEvent, 0 when XShm is not used
  * @use_xkb: used to known wether of not Xkb extension is usable or not even
  * if the Extension is present
+ * @format: the #GstVideoFormat of the images of Display @disp
  * @caps: the #GstCaps that Display @disp can accept
  *
  * Structure used to store various information collected/calculated for a
@@ -109,8 +111,10 @@ struct _GstXContext
   GValue *par;                  /* calculated pixel aspect ratio */
 
   gboolean use_xshm;
+  gint shm_completion;
   gboolean use_xkb;
 
+  GstVideoFormat format;
   GstCaps *caps;
   GstCaps *last_caps;
 };
@@ -143,6 +147,8 @@ struct _GstXWindow
  * not using the buffer_alloc optimization mechanism
  * @cur_image: a reference to the last #GstXImage that was put to @xwindow. It
  * is used when Expose events are received to redraw the latest video frame
+ * @pending_images: images put with XShm that the X server has not finished
+ * reading yet, released when their XShmCompletionEvent arrives
  * @event_thread: a thread listening for events on @xwindow and handling them
  * @running: used to inform @event_thread if it should run/shutdown
  * @fps_n: the framerate fraction numerator
@@ -173,12 +179,18 @@ struct _GstXImageSink
   GstXContext *xcontext;
   GstXWindow *xwindow;
   GstBuffer *cur_image;
+  GQueue pending_images;
 
   GThread *event_thread;
   gboolean running;
 
   GstVideoInfo info;
 
+  /* info of the images of the internal pool, and the converter from @info
+   * when the negotiated format is not the one of the display */
+  GstVideoInfo ximage_info;
+  GstVideoConverter *convert;
+
   /* Framerate numerator and denominator */
   gint fps_n;
   gint fps_d;
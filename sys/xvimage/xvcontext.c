@@ -714,6 +714,7 @@ gst_xvcontext_new (GstXvContextConfig * config, GError ** error)
   if (XShmQueryExtension (context->disp) &&
       gst_xvcontext_check_xshm_calls (context)) {
     context->use_xshm = TRUE;
+    context->shm_completion = XShmGetEventBase (context->disp) + ShmCompletion;
     GST_DEBUG ("xvimagesink is using XShm extension");
   } else
 #endif /* HAVE_XSHM */
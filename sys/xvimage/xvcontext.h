@@ -110,6 +110,7 @@ struct _GstXvImageFormat
  * @heightmm ratio
  * @use_xshm: used to known whether of not XShm extension is usable or not even
  * if the Extension is present
+ * @shm_completion: the type of XShmCompletionEvent, 0 when XShm is not used
  * @use_xkb: used to known wether of not Xkb extension is usable or not even
  * if the Extension is present
  * @xv_port_id: the XVideo port ID
@@ -147,6 +148,7 @@ struct _GstXvContext
   GValue *par;                  /* calculated pixel aspect ratio */
 
   gboolean use_xshm;
+  gint shm_completion;
   gboolean use_xkb;
 
   XvPortID xv_port_id;
@@ -121,6 +121,19 @@ gst_xvimage_memory_get_crop (GstXvImageMemory * xvmem, GstVideoRectangle * crop)
   return TRUE;
 }
 
+/* check if @event is the XShmCompletionEvent of a put of @xvmem */
+gboolean
+gst_xvimage_memory_is_completed_by (GstXvImageMemory * xvmem, XEvent * event)
+{
+  g_return_val_if_fail (xvmem != NULL, FALSE);
+
+#ifdef HAVE_XSHM
+  return ((XShmCompletionEvent *) event)->shmseg == xvmem->SHMInfo.shmseg;
+#else
+  return FALSE;
+#endif /* HAVE_XSHM */
+}
+
 
 /* X11 stuff */
 static gboolean error_caught = FALSE;
@@ -626,12 +639,15 @@ gst_xwindow_draw_borders (GstXWindow * window, GstVideoRectangle * rect)
   }
 }
 
-void
+/* Returns TRUE when the X server will send an XShmCompletionEvent once it is
+ * done reading @mem, FALSE when it was already read when this returns */
+gboolean
 gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
     GstXWindow * window, GstVideoRectangle * dst_crop, gboolean draw_border)
 {
   GstXvContext *context;
   XvImage *xvimage;
+  gboolean async = FALSE;
 
   context = window->context;
 
@@ -643,6 +659,8 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
   }
 #ifdef HAVE_XSHM
   if (context->use_xshm) {
+    async = context->shm_completion != 0;
+
     GST_LOG ("XvShmPutImage with image %dx%d and window %dx%d, from xvimage %p",
         src_crop->w, src_crop->h, window->render_rect.w, window->render_rect.h,
         mem);
@@ -652,7 +670,7 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         window->win,
         window->gc, xvimage,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
-        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, FALSE);
+        dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h, async);
   } else
 #endif /* HAVE_XSHM */
   {
@@ -663,7 +681,15 @@ gst_xvimage_memory_render (GstXvImageMemory * mem, GstVideoRectangle * src_crop,
         src_crop->x, src_crop->y, src_crop->w, src_crop->h,
         dst_crop->x, dst_crop->y, dst_crop->w, dst_crop->h);
   }
-  XSync (context->disp, FALSE);
+
+  /* with a completion event coming there is no need to wait for the server,
+   * the caller keeps the image alive until then */
+  if (async)
+    XFlush (context->disp);
+  else
+    XSync (context->disp, FALSE);
 
   g_mutex_unlock (&context->lock);
+
+  return async;
 }
@@ -58,8 +58,10 @@ gint                  gst_xvimage_memory_get_format     (GstXvImageMemory *mem);
 XvImage *             gst_xvimage_memory_get_xvimage    (GstXvImageMemory *mem);
 gboolean              gst_xvimage_memory_get_crop       (GstXvImageMemory *mem,
                                                          GstVideoRectangle *crop);
+gboolean              gst_xvimage_memory_is_completed_by (GstXvImageMemory *mem,
+                                                          XEvent *event);
 
-void                  gst_xvimage_memory_render         (GstXvImageMemory *mem,
+gboolean              gst_xvimage_memory_render         (GstXvImageMemory *mem,
                                                          GstVideoRectangle *src_crop,
                                                          GstXWindow *window,
                                                          GstVideoRectangle *dst_crop,
@@ -222,6 +222,72 @@ G_DEFINE_TYPE_WITH_CODE (GstXvImageSink, gst_xv_image_sink, GST_TYPE_VIDEO_SINK,
 /* ============================================================= */
 
 
+/* number of images the X server can still be reading from when a put
+ * returns. One lets the server read the last image while upstream prepares
+ * the next one, without holding more buffers than the last image we keep
+ * for expose anyway. */
+#define MAX_PENDING_IMAGES 1
+
+/* Moves the pending images up to the one completed by @event to @done. Must
+ * be called with the flow_lock and the context lock held. */
+static void
+gst_xv_image_sink_image_completed (GstXvImageSink * xvimagesink,
+    XEvent * event, GQueue * done)
+{
+  GList *l;
+  gboolean last;
+
+  for (l = xvimagesink->pending_images.head; l; l = l->next) {
+    GstXvImageMemory *mem =
+        (GstXvImageMemory *) gst_buffer_peek_memory (l->data, 0);
+
+    if (gst_xvimage_memory_is_completed_by (mem, event))
+      break;
+  }
+
+  /* already released */
+  if (l == NULL)
+    return;
+
+  /* puts complete in order, so all images before this one are done too */
+  do {
+    last = xvimagesink->pending_images.head == l;
+    g_queue_push_tail (done, g_queue_pop_head (&xvimagesink->pending_images));
+  } while (!last);
+}
+
+/* Releases the images the X server is done with, or all of them when @all is
+ * TRUE. Must be called with the flow_lock held. */
+static void
+gst_xv_image_sink_release_images (GstXvImageSink * xvimagesink, gboolean all)
+{
+  GstXvContext *context = xvimagesink->context;
+  GQueue done = G_QUEUE_INIT;
+  GstBuffer *buf;
+  XEvent e;
+
+  g_mutex_lock (&context->lock);
+  while (XCheckTypedEvent (context->disp, context->shm_completion, &e))
+    gst_xv_image_sink_image_completed (xvimagesink, &e, &done);
+
+  /* when the server falls behind, or an event got lost because the put
+   * failed, wait for it to process everything instead of piling up images */
+  if (all || xvimagesink->pending_images.length > MAX_PENDING_IMAGES) {
+    GST_LOG_OBJECT (xvimagesink, "waiting for %u pending images",
+        xvimagesink->pending_images.length);
+    XSync (context->disp, FALSE);
+    while (XCheckTypedEvent (context->disp, context->shm_completion, &e))
+      continue;
+    while ((buf = g_queue_pop_head (&xvimagesink->pending_images)))
+      g_queue_push_tail (&done, buf);
+  }
+  g_mutex_unlock (&context->lock);
+
+  /* this can free the images, which takes the context lock */
+  while ((buf = g_queue_pop_head (&done)))
+    gst_buffer_unref (buf);
+}
+
 /* This function puts a GstXvImage on a GstXvImageSink's window. Returns FALSE
  * if no window was available  */
 static gboolean
@@ -308,7 +374,10 @@ gst_xv_image_sink_xvimage_put (GstXvImageSink * xvimagesink,
     memcpy (&result, &xwindow->render_rect, sizeof (GstVideoRectangle));
   }
 
-  gst_xvimage_memory_render (mem, &src, xwindow, &result, draw_border);
+  if (gst_xvimage_memory_render (mem, &src, xwindow, &result, draw_border)) {
+    g_queue_push_tail (&xvimagesink->pending_images, gst_buffer_ref (xvimage));
+    gst_xv_image_sink_release_images (xvimagesink, FALSE);
+  }
 
   g_mutex_unlock (&xvimagesink->flow_lock);
 
@@ -411,9 +480,14 @@ gst_xv_image_sink_handle_xevents (GstXvImageSink * xvimagesink)
   gint pointer_x = 0, pointer_y = 0;
   gboolean pointer_moved = FALSE;
   gboolean exposed = FALSE, configured = FALSE;
+  GQueue completed = G_QUEUE_INIT;
+  GstBuffer *buf;
 
   g_return_if_fail (GST_IS_XV_IMAGE_SINK (xvimagesink));
 
+  /* pointer motion held back by the coalescing window */
+  gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (xvimagesink), FALSE);
+
   /* Handle Interaction, produces navigation events */
 
   /* We get all pointer motion events, only the last position is
@@ -442,10 +516,8 @@ gst_xv_image_sink_handle_xevents (GstXvImageSink * xvimagesink)
     g_mutex_unlock (&xvimagesink->context->lock);
     g_mutex_unlock (&xvimagesink->flow_lock);
 
-    GST_DEBUG ("xvimagesink pointer moved over window at %d,%d",
-        pointer_x, pointer_y);
-    gst_navigation_send_mouse_event (GST_NAVIGATION (xvimagesink),
-        "mouse-move", 0, e.xbutton.x, e.xbutton.y);
+    gst_video_sink_send_mouse_move (GST_VIDEO_SINK (xvimagesink), pointer_x,
+        pointer_y);
 
     g_mutex_lock (&xvimagesink->flow_lock);
     g_mutex_lock (&xvimagesink->context->lock);
@@ -463,6 +535,9 @@ gst_xv_image_sink_handle_xevents (GstXvImageSink * xvimagesink)
     g_mutex_unlock (&xvimagesink->context->lock);
     g_mutex_unlock (&xvimagesink->flow_lock);
 
+    /* keep the order of pointer motion and other events */
+    gst_video_sink_flush_mouse_move (GST_VIDEO_SINK (xvimagesink), TRUE);
+
     switch (e.type) {
       case ButtonPress:
         /* Mouse button pressed over our window. We send upstream
@@ -567,11 +642,18 @@ gst_xv_image_sink_handle_xevents (GstXvImageSink * xvimagesink)
         break;
       }
       default:
+        if (e.type == xvimagesink->context->shm_completion &&
+            xvimagesink->context->shm_completion != 0)
+          gst_xv_image_sink_image_completed (xvimagesink, &e, &completed);
         break;
     }
   }
 
   g_mutex_unlock (&xvimagesink->context->lock);
+
+  while ((buf = g_queue_pop_head (&completed)))
+    gst_buffer_unref (buf);
+
   g_mutex_unlock (&xvimagesink->flow_lock);
 }
 
@@ -1798,6 +1880,11 @@ gst_xv_image_sink_close (GstXvImageSink * xvimagesink)
   if (thread)
     g_thread_join (thread);
 
+  g_mutex_lock (&xvimagesink->flow_lock);
+  if (!g_queue_is_empty (&xvimagesink->pending_images))
+    gst_xv_image_sink_release_images (xvimagesink, TRUE);
+  g_mutex_unlock (&xvimagesink->flow_lock);
+
   if (xvimagesink->cur_image) {
     gst_buffer_unref (xvimagesink->cur_image);
     xvimagesink->cur_image = NULL;
@@ -1874,6 +1961,7 @@ gst_xv_image_sink_init (GstXvImageSink * xvimagesink)
   xvimagesink->context = NULL;
   xvimagesink->xwindow = NULL;
   xvimagesink->cur_image = NULL;
+  g_queue_init (&xvimagesink->pending_images);
 
   xvimagesink->fps_n = 0;
   xvimagesink->fps_d = 0;
@@ -51,6 +51,8 @@ typedef struct _GstXvImageSinkClass GstXvImageSinkClass;
  * @xwindow: the #GstXWindow we are rendering to
  * @cur_image: a reference to the last #GstXvImage that was put to @xwindow. It
  * is used when Expose events are received to redraw the latest video frame
+ * @pending_images: images put with XShm that the X server has not finished
+ * reading yet, released when their XShmCompletionEvent arrives
  * @event_thread: a thread listening for events on @xwindow and handling them
  * @running: used to inform @event_thread if it should run/shutdown
  * @fps_n: the framerate fraction numerator
@@ -88,6 +90,7 @@ struct _GstXvImageSink
   GstXvImageAllocator *allocator;
   GstXWindow *xwindow;
   GstBuffer *cur_image;
+  GQueue pending_images;
 
   GThread *event_thread;
   gboolean running;
@@ -714,6 +714,57 @@ GST_START_TEST (test_pull_sample_refcounts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_samples)
+{
+  GstElement *sink;
+  GstSample *samples[4];
+  guint i, n;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  /* nothing queued yet */
+  fail_unless_equals_int (gst_app_sink_try_pull_samples (GST_APP_SINK (sink),
+          samples, 4, 0), 0);
+
+  for (i = 0; i < 3; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (i + 1)) == GST_FLOW_OK);
+  }
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 4, 0);
+  fail_unless_equals_int (n, 3);
+  for (i = 0; i < n; i++) {
+    fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+            (samples[i])), i + 1);
+    gst_sample_unref (samples[i]);
+  }
+
+  /* at most n_samples are returned, the rest stays queued */
+  for (i = 0; i < 3; i++) {
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (i + 1)) == GST_FLOW_OK);
+  }
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 2, 0);
+  fail_unless_equals_int (n, 2);
+  gst_sample_unref (samples[0]);
+  gst_sample_unref (samples[1]);
+
+  n = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), samples, 2,
+      GST_SECOND);
+  fail_unless_equals_int (n, 1);
+  fail_unless_equals_int (gst_buffer_get_size (gst_sample_get_buffer
+          (samples[0])), 3);
+  gst_sample_unref (samples[0]);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsink_suite (void)
 {
@@ -735,6 +786,7 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_pull_preroll);
   tcase_add_test (tc_chain, test_do_not_care_preroll);
   tcase_add_test (tc_chain, test_pull_sample_refcounts);
+  tcase_add_test (tc_chain, test_pull_samples);
 
   return s;
 }
@@ -606,6 +606,282 @@ GST_START_TEST (test_appsrc_push_buffer_list)
 
 GST_END_TEST;
 
+GST_START_TEST (test_appsrc_leaky)
+{
+  GstAppLeakyType leaky_type = __i__ ? GST_APP_LEAKY_TYPE_DOWNSTREAM :
+      GST_APP_LEAKY_TYPE_UPSTREAM;
+  GstElement *src;
+  guint64 dropped;
+  guint i;
+
+  src = setup_appsrc ();
+
+  g_object_set (src, "max-buffers", (guint64) 2, "leaky-type", leaky_type,
+      "format", GST_FORMAT_TIME, NULL);
+
+  for (i = 0; i < 5; i++) {
+    GstBuffer *buf = gst_buffer_new ();
+
+    GST_BUFFER_PTS (buf) = i * GST_SECOND;
+    GST_BUFFER_OFFSET (buf) = i;
+    fail_unless_equals_int (gst_app_src_push_buffer (GST_APP_SRC (src), buf),
+        GST_FLOW_OK);
+  }
+
+  g_object_get (src, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (dropped, 3);
+
+  ASSERT_SET_STATE (src, GST_STATE_PLAYING, GST_STATE_CHANGE_SUCCESS);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 2)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  /* upstream keeps the oldest buffers, downstream the newest */
+  if (leaky_type == GST_APP_LEAKY_TYPE_UPSTREAM) {
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffers->data), 0);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffers->next->data), 1);
+  } else {
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffers->data), 3);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffers->next->data), 4);
+  }
+
+  ASSERT_SET_STATE (src, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsrc (src);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_appsrc_max_time)
+{
+  GstElement *src;
+  guint64 dropped;
+  guint i;
+
+  src = gst_element_factory_make ("appsrc", NULL);
+
+  g_object_set (src, "max-bytes", (guint64) 0, "max-time",
+      (guint64) 2 * GST_SECOND, "leaky-type", GST_APP_LEAKY_TYPE_DOWNSTREAM,
+      NULL);
+
+  for (i = 0; i < 10; i++) {
+    GstBuffer *buf = gst_buffer_new ();
+
+    GST_BUFFER_PTS (buf) = i * GST_SECOND;
+    fail_unless_equals_int (gst_app_src_push_buffer (GST_APP_SRC (src), buf),
+        GST_FLOW_OK);
+  }
+
+  /* never more than 2 seconds plus the new buffer are queued */
+  g_object_get (src, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (dropped, 7);
+
+  gst_object_unref (src);
+}
+
+GST_END_TEST;
+
+static void
+wrapped_memory_released (gpointer user_data)
+{
+  gint *released = user_data;
+
+  (*released)++;
+}
+
+GST_START_TEST (test_appsrc_wrap_memory)
+{
+  GstElement *src;
+  GstBuffer *buf, *sub;
+  GstMapInfo info;
+  guint8 data[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+  gint released = 0;
+  gpointer last;
+
+  src = gst_element_factory_make ("appsrc", NULL);
+
+  buf = gst_app_src_wrap_memory (GST_APP_SRC (src), data, sizeof (data),
+      &released, wrapped_memory_released);
+  fail_unless (buf != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buf), sizeof (data));
+  fail_unless (gst_buffer_map (buf, &info, GST_MAP_READ));
+  fail_unless (info.data == data);
+  gst_buffer_unmap (buf, &info);
+
+  /* a sub-buffer keeps the memory alive */
+  sub = gst_buffer_copy_region (buf, GST_BUFFER_COPY_ALL, 4, 8);
+  GST_BUFFER_PTS (buf) = GST_SECOND;
+  last = buf;
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (released, 0);
+  fail_unless (gst_buffer_map (sub, &info, GST_MAP_READ));
+  fail_unless (info.data == data + 4);
+  fail_unless_equals_int (info.size, 8);
+  gst_buffer_unmap (sub, &info);
+  gst_buffer_unref (sub);
+  fail_unless_equals_int (released, 1);
+
+  /* the buffer is recycled and reset */
+  buf = gst_app_src_wrap_memory (GST_APP_SRC (src), data, 8,
+      &released, wrapped_memory_released);
+  fail_unless (buf == last);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 8);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), GST_CLOCK_TIME_NONE);
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (released, 2);
+
+  /* buffers that are still out when appsrc goes away are released too */
+  buf = gst_app_src_wrap_memory (GST_APP_SRC (src), data, sizeof (data),
+      &released, wrapped_memory_released);
+  gst_object_unref (src);
+  fail_unless_equals_int (released, 2);
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (released, 3);
+}
+
+GST_END_TEST;
+
+static void
+region_released (guint index, gpointer user_data)
+{
+  guint *released = user_data;
+
+  released[index]++;
+}
+
+GST_START_TEST (test_appsrc_memory_regions)
+{
+  GstElement *src;
+  GstBuffer *buf, *buf2;
+  GstMapInfo info;
+  guint8 ring[2][32];
+  const gpointer regions[2] = { ring[0], ring[1] };
+  const gsize sizes[2] = { sizeof (ring[0]), sizeof (ring[1]) };
+  guint released[2] = { 0, 0 };
+
+  src = gst_element_factory_make ("appsrc", NULL);
+
+  fail_unless (gst_app_src_set_memory_regions (GST_APP_SRC (src), 2, regions,
+          sizes, region_released, released, NULL));
+
+  buf = gst_app_src_acquire_region_buffer (GST_APP_SRC (src), 1, 8, -1);
+  fail_unless (buf != NULL);
+  fail_unless (gst_buffer_map (buf, &info, GST_MAP_READ));
+  fail_unless (info.data == ring[1] + 8);
+  fail_unless_equals_int (info.size, 24);
+  gst_buffer_unmap (buf, &info);
+
+  /* busy until released */
+  fail_if (gst_app_src_acquire_region_buffer (GST_APP_SRC (src), 1, 0, -1));
+  fail_if (gst_app_src_set_memory_regions (GST_APP_SRC (src), 0, NULL,
+          NULL, NULL, NULL, NULL));
+
+  buf2 = gst_app_src_acquire_region_buffer (GST_APP_SRC (src), 0, 0, 16);
+  fail_unless (buf2 != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buf2), 16);
+  gst_buffer_unref (buf2);
+  fail_unless_equals_int (released[0], 1);
+  fail_unless_equals_int (released[1], 0);
+
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (released[1], 1);
+
+  buf = gst_app_src_acquire_region_buffer (GST_APP_SRC (src), 1, 0, -1);
+  fail_unless (buf != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buf), 32);
+  gst_buffer_unref (buf);
+  fail_unless_equals_int (released[1], 2);
+
+  gst_object_unref (src);
+}
+
+GST_END_TEST;
+
+#define RANGE_STREAM_SIZE (200 * 1024)
+
+static GstFlowReturn
+get_range_cb (GstAppSrc * src, guint64 offset, guint size, GstBuffer ** buffer,
+    gpointer user_data)
+{
+  guint *calls = user_data;
+  GstMapInfo info;
+  guint i;
+
+  (*calls)++;
+
+  fail_unless (offset + size <= RANGE_STREAM_SIZE);
+
+  *buffer = gst_buffer_new_allocate (NULL, size, NULL);
+  gst_buffer_map (*buffer, &info, GST_MAP_WRITE);
+  for (i = 0; i < size; i++)
+    info.data[i] = (offset + i) & 0xff;
+  gst_buffer_unmap (*buffer, &info);
+
+  return GST_FLOW_OK;
+}
+
+static void
+check_range (GstPad * pad, guint64 offset, guint size, guint expected_size)
+{
+  GstBuffer *buf = NULL;
+  GstMapInfo info;
+
+  fail_unless_equals_int (gst_pad_get_range (pad, offset, size, &buf),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buf), expected_size);
+  fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buf), offset);
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  fail_unless_equals_int (info.data[0], offset & 0xff);
+  fail_unless_equals_int (info.data[expected_size - 1],
+      (offset + expected_size - 1) & 0xff);
+  gst_buffer_unmap (buf, &info);
+  gst_buffer_unref (buf);
+}
+
+GST_START_TEST (test_appsrc_get_range)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstBuffer *buf = NULL;
+  GstAppSrcCallbacks cb = { 0 };
+  guint calls = 0;
+
+  src = gst_element_factory_make ("appsrc", NULL);
+  g_object_set (src, "stream-type", GST_APP_STREAM_TYPE_RANDOM_ACCESS,
+      "size", (gint64) RANGE_STREAM_SIZE, NULL);
+  cb.get_range = get_range_cb;
+  gst_app_src_set_callbacks (GST_APP_SRC (src), &cb, &calls, NULL);
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+
+  /* small reads close to each other only call the application once */
+  check_range (pad, 0, 8, 8);
+  check_range (pad, 8, 100, 100);
+  check_range (pad, 1000, 4096, 4096);
+  fail_unless_equals_int (calls, 1);
+
+  /* a read past the prefetched range calls it again */
+  check_range (pad, 100 * 1024, 16, 16);
+  fail_unless_equals_int (calls, 2);
+  check_range (pad, 4, 4, 4);
+  fail_unless_equals_int (calls, 2);
+
+  /* short read at the end of the stream, then EOS */
+  check_range (pad, RANGE_STREAM_SIZE - 10, 4096, 10);
+  check_range (pad, RANGE_STREAM_SIZE - 5, 4096, 5);
+  fail_unless_equals_int (calls, 3);
+  fail_unless_equals_int (gst_pad_get_range (pad, RANGE_STREAM_SIZE, 16,
+          &buf), GST_FLOW_EOS);
+
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, FALSE));
+  gst_object_unref (pad);
+  gst_object_unref (src);
+}
+
+GST_END_TEST;
+
 static Suite *
 appsrc_suite (void)
 {
@@ -617,6 +893,11 @@ appsrc_suite (void)
   tcase_add_test (tc_chain, test_appsrc_caps_in_push_modes);
   tcase_add_test (tc_chain, test_appsrc_blocked_on_caps);
   tcase_add_test (tc_chain, test_appsrc_push_buffer_list);
+  tcase_add_loop_test (tc_chain, test_appsrc_leaky, 0, 2);
+  tcase_add_test (tc_chain, test_appsrc_max_time);
+  tcase_add_test (tc_chain, test_appsrc_wrap_memory);
+  tcase_add_test (tc_chain, test_appsrc_memory_regions);
+  tcase_add_test (tc_chain, test_appsrc_get_range);
 
   if (RUNNING_ON_VALGRIND)
     tcase_add_loop_test (tc_chain, test_appsrc_block_deadlock, 0, 5);
@@ -1947,6 +1947,327 @@ GST_START_TEST (test_change_output_caps_mid_output_buffer)
 }
 
 GST_END_TEST;
+#define N_PARALLEL_PADS 16
+
+/* Mix enough pads and samples that the mixing is split over several
+ * threads and check that every frame of the output got all pads added
+ * exactly once, except for the muted one */
+GST_START_TEST (test_parallel_mix)
+{
+  GstSegment segment;
+  GstElement *bin, *audiomixer, *sink;
+  GstBus *bus;
+  GstPad *sinkpads[N_PARALLEL_PADS];
+  gboolean res;
+  GstStateChangeReturn state_res;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstQuery *drain = gst_query_new_drain ();
+  GstMapInfo outmap;
+  gsize i;
+
+  bin = gst_pipeline_new ("pipeline");
+  bus = gst_element_get_bus (bin);
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+
+  g_signal_connect (bus, "message::error", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::warning", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::eos", (GCallback) message_received, bin);
+
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", GST_SECOND,
+      "max-threads", 4, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+
+  res = gst_element_link (audiomixer, sink);
+  fail_unless (res == TRUE, NULL);
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, "S8",
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 8192, "channels", G_TYPE_INT, 1, NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < N_PARALLEL_PADS; i++) {
+    sinkpads[i] = gst_element_get_request_pad (audiomixer, "sink_%u");
+    fail_if (sinkpads[i] == NULL, NULL);
+
+    gst_pad_send_event (sinkpads[i], gst_event_new_stream_start ("test"));
+    gst_pad_set_caps (sinkpads[i], caps);
+    gst_pad_send_event (sinkpads[i], gst_event_new_segment (&segment));
+  }
+  gst_caps_unref (caps);
+
+  g_object_set (sinkpads[0], "mute", TRUE, NULL);
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  for (i = 0; i < N_PARALLEL_PADS; i++) {
+    buffer = new_buffer (8192, 1, 0, GST_SECOND, 0);
+    ret = gst_pad_chain (sinkpads[i], buffer);
+    ck_assert_int_eq (ret, GST_FLOW_OK);
+  }
+  gst_pad_query (sinkpads[N_PARALLEL_PADS - 1], drain);
+  fail_unless (handoff_buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (handoff_buffer), 8192);
+
+  gst_buffer_map (handoff_buffer, &outmap, GST_MAP_READ);
+  for (i = 0; i < outmap.size; i++)
+    fail_unless_equals_int (((gint8 *) outmap.data)[i], N_PARALLEL_PADS - 1);
+  gst_buffer_unmap (handoff_buffer, &outmap);
+  gst_clear_buffer (&handoff_buffer);
+
+  for (i = 0; i < N_PARALLEL_PADS; i++) {
+    gst_element_release_request_pad (audiomixer, sinkpads[i]);
+    gst_object_unref (sinkpads[i]);
+  }
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+  gst_query_unref (drain);
+}
+
+GST_END_TEST;
+
+/* An output buffer only made of GAP inputs must be a GAP buffer filled
+ * with silence, and mixing any real data into it must clear the flag */
+GST_START_TEST (test_gap_propagation)
+{
+  GstSegment segment;
+  GstElement *bin, *audiomixer, *sink;
+  GstBus *bus;
+  GstPad *sinkpads[2];
+  gboolean res;
+  GstStateChangeReturn state_res;
+  GstFlowReturn ret;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstQuery *drain = gst_query_new_drain ();
+  GstMapInfo outmap;
+  gsize i;
+
+  bin = gst_pipeline_new ("pipeline");
+  bus = gst_element_get_bus (bin);
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+
+  g_signal_connect (bus, "message::error", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::warning", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::eos", (GCallback) message_received, bin);
+
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", GST_SECOND, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+
+  res = gst_element_link (audiomixer, sink);
+  fail_unless (res == TRUE, NULL);
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, "S8",
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 8192, "channels", G_TYPE_INT, 1, NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < G_N_ELEMENTS (sinkpads); i++) {
+    sinkpads[i] = gst_element_get_request_pad (audiomixer, "sink_%u");
+    fail_if (sinkpads[i] == NULL, NULL);
+
+    gst_pad_send_event (sinkpads[i], gst_event_new_stream_start ("test"));
+    gst_pad_set_caps (sinkpads[i], caps);
+    gst_pad_send_event (sinkpads[i], gst_event_new_segment (&segment));
+  }
+  gst_caps_unref (caps);
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  /* only GAP buffers, with garbage that must not end up in the output */
+  for (i = 0; i < G_N_ELEMENTS (sinkpads); i++) {
+    buffer = new_buffer (8192, 7, 0, GST_SECOND, GST_BUFFER_FLAG_GAP);
+    ret = gst_pad_chain (sinkpads[i], buffer);
+    ck_assert_int_eq (ret, GST_FLOW_OK);
+  }
+  gst_pad_query (sinkpads[1], drain);
+  fail_unless (handoff_buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (handoff_buffer), 8192);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (handoff_buffer, GST_BUFFER_FLAG_GAP));
+
+  gst_buffer_map (handoff_buffer, &outmap, GST_MAP_READ);
+  for (i = 0; i < outmap.size; i++)
+    fail_unless_equals_int (((gint8 *) outmap.data)[i], 0);
+  gst_buffer_unmap (handoff_buffer, &outmap);
+  gst_clear_buffer (&handoff_buffer);
+
+  /* one pad with data */
+  buffer = new_buffer (8192, 1, GST_SECOND, GST_SECOND, 0);
+  ret = gst_pad_chain (sinkpads[0], buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+  buffer = new_buffer (8192, 7, GST_SECOND, GST_SECOND, GST_BUFFER_FLAG_GAP);
+  ret = gst_pad_chain (sinkpads[1], buffer);
+  ck_assert_int_eq (ret, GST_FLOW_OK);
+  gst_pad_query (sinkpads[1], drain);
+  fail_unless (handoff_buffer != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (handoff_buffer), 8192);
+  fail_if (GST_BUFFER_FLAG_IS_SET (handoff_buffer, GST_BUFFER_FLAG_GAP));
+
+  gst_buffer_map (handoff_buffer, &outmap, GST_MAP_READ);
+  for (i = 0; i < outmap.size; i++)
+    fail_unless_equals_int (((gint8 *) outmap.data)[i], 1);
+  gst_buffer_unmap (handoff_buffer, &outmap);
+  gst_clear_buffer (&handoff_buffer);
+
+  for (i = 0; i < G_N_ELEMENTS (sinkpads); i++) {
+    gst_element_release_request_pad (audiomixer, sinkpads[i]);
+    gst_object_unref (sinkpads[i]);
+  }
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+  gst_query_unref (drain);
+}
+
+GST_END_TEST;
+
+#define N_MIX_MINUS_PADS 3
+
+static void
+handoff_mix_minus_cb (GstElement * fakesink, GstBuffer * buffer, GstPad * pad,
+    GstBuffer ** slot)
+{
+  gst_buffer_replace (slot, buffer);
+}
+
+/* Each src_N pad must output the mix of all sink pads except sink_N, with
+ * the volumes of the other pads applied */
+GST_START_TEST (test_mix_minus)
+{
+  GstSegment segment;
+  GstElement *bin, *audiomixer, *sink, *mm_sinks[N_MIX_MINUS_PADS];
+  GstBus *bus;
+  GstPad *sinkpads[N_MIX_MINUS_PADS];
+  GstBuffer *mm_buffers[N_MIX_MINUS_PADS] = { NULL, };
+  const gint values[N_MIX_MINUS_PADS] = { 1, 2, 4 };
+  /* sink_2 has a volume of 0.5 */
+  const gint expected[N_MIX_MINUS_PADS] = { 2 + 2, 1 + 2, 1 + 2 };
+  gboolean res;
+  GstStateChangeReturn state_res;
+  GstFlowReturn ret;
+  GstCaps *caps;
+  GstQuery *drain = gst_query_new_drain ();
+  GstMapInfo map;
+  gsize i, j;
+
+  bin = gst_pipeline_new ("pipeline");
+  bus = gst_element_get_bus (bin);
+  gst_bus_add_signal_watch_full (bus, G_PRIORITY_HIGH);
+
+  g_signal_connect (bus, "message::error", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::warning", (GCallback) message_received, bin);
+  g_signal_connect (bus, "message::eos", (GCallback) message_received, bin);
+
+  audiomixer = gst_element_factory_make ("audiomixer", "audiomixer");
+  g_object_set (audiomixer, "output-buffer-duration", GST_SECOND, NULL);
+  sink = gst_element_factory_make ("fakesink", "sink");
+  g_object_set (sink, "signal-handoffs", TRUE, NULL);
+  g_signal_connect (sink, "handoff", (GCallback) handoff_buffer_cb, NULL);
+  gst_bin_add_many (GST_BIN (bin), audiomixer, sink, NULL);
+
+  res = gst_element_link (audiomixer, sink);
+  fail_unless (res == TRUE, NULL);
+
+  for (i = 0; i < N_MIX_MINUS_PADS; i++) {
+    gchar *name = g_strdup_printf ("src_%" G_GSIZE_FORMAT, i);
+
+    mm_sinks[i] = gst_element_factory_make ("fakesink", NULL);
+    g_object_set (mm_sinks[i], "signal-handoffs", TRUE, "async", FALSE, NULL);
+    g_signal_connect (mm_sinks[i], "handoff",
+        (GCallback) handoff_mix_minus_cb, &mm_buffers[i]);
+    gst_bin_add (GST_BIN (bin), mm_sinks[i]);
+
+    res = gst_element_link_pads (audiomixer, name, mm_sinks[i], "sink");
+    fail_unless (res == TRUE, NULL);
+    g_free (name);
+  }
+
+  /* requesting a mix-minus pad without sink pad number fails */
+  fail_unless (gst_element_get_request_pad (audiomixer, "src_%u") == NULL);
+
+  state_res = gst_element_set_state (bin, GST_STATE_PLAYING);
+  ck_assert_int_ne (state_res, GST_STATE_CHANGE_FAILURE);
+
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, "S8",
+      "layout", G_TYPE_STRING, "interleaved",
+      "rate", G_TYPE_INT, 10, "channels", G_TYPE_INT, 1, NULL);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < N_MIX_MINUS_PADS; i++) {
+    sinkpads[i] = gst_element_get_request_pad (audiomixer, "sink_%u");
+    fail_if (sinkpads[i] == NULL, NULL);
+
+    gst_pad_send_event (sinkpads[i], gst_event_new_stream_start ("test"));
+    gst_pad_set_caps (sinkpads[i], caps);
+    gst_pad_send_event (sinkpads[i], gst_event_new_segment (&segment));
+  }
+  gst_caps_unref (caps);
+
+  g_object_set (sinkpads[2], "volume", 0.5, NULL);
+
+  gst_buffer_replace (&handoff_buffer, NULL);
+
+  for (i = 0; i < N_MIX_MINUS_PADS; i++) {
+    ret = gst_pad_chain (sinkpads[i], new_buffer (10, values[i], 0,
+            GST_SECOND, 0));
+    ck_assert_int_eq (ret, GST_FLOW_OK);
+  }
+  gst_pad_query (sinkpads[N_MIX_MINUS_PADS - 1], drain);
+
+  fail_unless (handoff_buffer != NULL);
+  gst_buffer_map (handoff_buffer, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10);
+  for (j = 0; j < map.size; j++)
+    fail_unless_equals_int (((gint8 *) map.data)[j], 1 + 2 + 2);
+  gst_buffer_unmap (handoff_buffer, &map);
+
+  for (i = 0; i < N_MIX_MINUS_PADS; i++) {
+    fail_unless (mm_buffers[i] != NULL);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (mm_buffers[i]),
+        GST_BUFFER_PTS (handoff_buffer));
+    gst_buffer_map (mm_buffers[i], &map, GST_MAP_READ);
+    fail_unless_equals_int (map.size, 10);
+    for (j = 0; j < map.size; j++)
+      fail_unless_equals_int (((gint8 *) map.data)[j], expected[i]);
+    gst_buffer_unmap (mm_buffers[i], &map);
+    gst_buffer_replace (&mm_buffers[i], NULL);
+  }
+  gst_clear_buffer (&handoff_buffer);
+
+  for (i = 0; i < N_MIX_MINUS_PADS; i++) {
+    gst_element_release_request_pad (audiomixer, sinkpads[i]);
+    gst_object_unref (sinkpads[i]);
+  }
+  gst_element_set_state (bin, GST_STATE_NULL);
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_object_unref (bin);
+  gst_query_unref (drain);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -1975,6 +2296,9 @@ audiomixer_suite (void)
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
+  tcase_add_test (tc_chain, test_parallel_mix);
+  tcase_add_test (tc_chain, test_mix_minus);
+  tcase_add_test (tc_chain, test_gap_propagation);
 
   /* Use a longer timeout */
 #ifdef HAVE_VALGRIND
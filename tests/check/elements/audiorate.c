@@ -452,6 +452,89 @@ GST_START_TEST (test_large_discont)
 
 GST_END_TEST;
 
+static void
+push_hysteresis_buffer (GstPad * srcpad, GstClockTime ts)
+{
+  GstBuffer *buf;
+
+  /* 10ms at 44100 Hz */
+  buf = gst_buffer_new_and_alloc (441 * sizeof (gfloat));
+  gst_buffer_memset (buf, 0, 1, gst_buffer_get_size (buf));
+  GST_BUFFER_TIMESTAMP (buf) = ts;
+  GST_BUFFER_DURATION (buf) = 10 * GST_MSECOND;
+  fail_unless_equals_int (gst_pad_push (srcpad, buf), GST_FLOW_OK);
+}
+
+GST_START_TEST (test_hysteresis)
+{
+  GstElement *audiorate;
+  GstCaps *caps;
+  GstPad *srcpad, *sinkpad;
+  GstBuffer *fill;
+  GstMapInfo map;
+  guint64 add;
+  gsize i;
+
+  audiorate = gst_check_setup_element ("audiorate");
+  g_object_set (audiorate, "tolerance", 40 * GST_MSECOND,
+      "hysteresis", 15 * GST_MSECOND, NULL);
+  caps = gst_caps_new_simple ("audio/x-raw",
+      "format", G_TYPE_STRING, GST_AUDIO_NE (F32),
+      "layout", G_TYPE_STRING, "interleaved",
+      "channels", G_TYPE_INT, 1, "rate", G_TYPE_INT, 44100, NULL);
+
+  srcpad = gst_check_setup_src_pad (audiorate, &srctemplate);
+  sinkpad = gst_check_setup_sink_pad (audiorate, &sinktemplate);
+
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_check_setup_events (srcpad, audiorate, caps, GST_FORMAT_TIME);
+
+  gst_pad_set_active (sinkpad, TRUE);
+
+  fail_unless (gst_element_set_state (audiorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "failed to set audiorate playing");
+
+  /* a single buffer 50ms late is jitter and only shifted */
+  push_hysteresis_buffer (srcpad, 0);
+  push_hysteresis_buffer (srcpad, 60 * GST_MSECOND);
+  push_hysteresis_buffer (srcpad, 20 * GST_MSECOND);
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  g_object_get (audiorate, "add", &add, NULL);
+  fail_unless_equals_uint64 (add, 0);
+
+  /* a gap of 100ms that persists for longer than 15ms is filled */
+  push_hysteresis_buffer (srcpad, 130 * GST_MSECOND);
+  push_hysteresis_buffer (srcpad, 140 * GST_MSECOND);
+  fail_unless_equals_int (g_list_length (buffers), 5);
+  g_object_get (audiorate, "add", &add, NULL);
+  fail_unless_equals_uint64 (add, 0);
+
+  push_hysteresis_buffer (srcpad, 150 * GST_MSECOND);
+  fail_unless_equals_int (g_list_length (buffers), 7);
+  g_object_get (audiorate, "add", &add, NULL);
+  fail_unless_equals_uint64 (add, 4410);
+
+  fill = g_list_nth_data (buffers, 5);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (fill, GST_BUFFER_FLAG_GAP));
+  fail_unless_equals_int (gst_buffer_get_size (fill), 4410 * sizeof (gfloat));
+  gst_buffer_map (fill, &map, GST_MAP_READ);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 0);
+  gst_buffer_unmap (fill, &map);
+
+  gst_element_set_state (audiorate, GST_STATE_NULL);
+  gst_caps_unref (caps);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_sink_pad (audiorate);
+  gst_check_teardown_src_pad (audiorate);
+
+  gst_object_unref (audiorate);
+}
+
+GST_END_TEST;
 
 #define FIRST_CAPS \
   "audio/x-raw,format=S16LE,layout=interleaved,rate=48000,channels=1"
@@ -580,6 +663,7 @@ audiorate_suite (void)
   tcase_add_test (tc_chain, test_perfect_stream_inject90);
   tcase_add_test (tc_chain, test_perfect_stream_drop45_inject25);
   tcase_add_test (tc_chain, test_large_discont);
+  tcase_add_test (tc_chain, test_hysteresis);
   tcase_add_test (tc_chain, test_rate_change_down);
 
   return s;
@@ -890,6 +890,61 @@ GST_START_TEST (test_timestamp_drift)
 
 } GST_END_TEST;
 
+static void
+count_bytes_handoff_cb (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    gsize * bytes)
+{
+  *bytes += gst_buffer_get_size (buffer);
+}
+
+GST_START_TEST (test_rate_ratio)
+{
+  GstElement *pipeline, *resample, *sink;
+  GstMessage *msg;
+  GstBus *bus;
+  gsize bytes = 0;
+  guint64 samples, expected;
+
+  /* 10 seconds of audio at identical rates, resampled 1000 ppm faster */
+  pipeline = gst_parse_launch ("audiotestsrc num-buffers=100 "
+      "samplesperbuffer=4800 ! audio/x-raw, format=" GST_AUDIO_NE (F32)
+      ", channels=1, rate=48000 ! audioresample name=resample rate-ratio=1.001 "
+      "! audio/x-raw, rate=48000 ! fakesink name=sink sync=false "
+      "signal-handoffs=true", NULL);
+  fail_unless (pipeline != NULL);
+
+  resample = gst_bin_get_by_name (GST_BIN (pipeline), "resample");
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "handoff", (GCallback) count_bytes_handoff_cb,
+      &bytes);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  /* allow for the filter latency at the start */
+  samples = bytes / sizeof (gfloat);
+  expected = 480000 * 1.001;
+  fail_unless (samples + 256 > expected && samples < expected + 256,
+      "expected around %" G_GUINT64_FORMAT " samples, got %" G_GUINT64_FORMAT,
+      expected, samples);
+
+  gst_object_unref (resample);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 #define FFT_HELPERS(type,ffttag,ffttag2,scale);                                                 \
 static gdouble magnitude##ffttag (const GstFFT##ffttag##Complex *c)                             \
 {                                                                                               \
@@ -1100,6 +1155,7 @@ audioresample_suite (void)
   tcase_add_test (tc_chain, test_shutdown);
   tcase_add_test (tc_chain, test_live_switch);
   tcase_add_test (tc_chain, test_timestamp_drift);
+  tcase_add_test (tc_chain, test_rate_ratio);
   tcase_add_test (tc_chain, test_fft);
 
 #ifndef GST_DISABLE_PARSE
@@ -24,6 +24,8 @@
 #include "config.h"
 #endif
 
+#include <math.h>
+
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
 #include <gst/audio/audio.h>
@@ -297,6 +299,64 @@ GST_START_TEST (test_layout)
 
 GST_END_TEST;
 
+static void
+check_sine (GstHarness * h, gdouble freq, gint64 * sample)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  gint16 *data;
+  gsize i, n;
+
+  buf = gst_harness_pull (h);
+  fail_unless (buf != NULL);
+  fail_unless (gst_buffer_map (buf, &map, GST_MAP_READ));
+  data = (gint16 *) map.data;
+  n = map.size / sizeof (gint16);
+
+  /* the phase is carried over from the previous buffer */
+  for (i = 0; i < n; i++) {
+    gdouble expected = sin (2 * G_PI * freq * (*sample + i + 1) / 48000.0);
+
+    fail_unless (ABS (data[i] - expected * 0.8 * 32767.0) <= 2.0,
+        "sample %" G_GINT64_FORMAT ": %d != %f", *sample + i, data[i],
+        expected * 0.8 * 32767.0);
+  }
+  *sample += n;
+
+  gst_buffer_unmap (buf, &map);
+  gst_buffer_unref (buf);
+}
+
+static void
+run_sine (gdouble freq)
+{
+  GstHarness *h;
+  gint64 sample = 0;
+
+  h = gst_harness_new_with_templates ("audiotestsrc", NULL, &sinktemplate);
+  gst_harness_set_sink_caps_str (h, "audio/x-raw, format = (string) "
+      GST_AUDIO_NE (S16) ", channels = (int) 1, rate = (int) 48000, "
+      "layout = (string) interleaved");
+  g_object_set (h->element, "freq", freq, "samples-per-buffer", 1000, NULL);
+  gst_harness_play (h);
+
+  check_sine (h, freq, &sample);
+  check_sine (h, freq, &sample);
+  check_sine (h, freq, &sample);
+
+  gst_harness_teardown (h);
+}
+
+GST_START_TEST (test_sine_period)
+{
+  /* a period of exactly 100 samples, generated from the period table */
+  run_sine (480.0);
+  /* no integer period, computed sample by sample */
+  run_sine (441.0);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiotestsrc_suite (void)
 {
@@ -306,6 +366,7 @@ audiotestsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_all_waves);
   tcase_add_test (tc_chain, test_layout);
+  tcase_add_test (tc_chain, test_sine_period);
 
   return s;
 }
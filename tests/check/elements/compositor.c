@@ -2166,6 +2166,184 @@ GST_START_TEST (test_gap_events)
 
 GST_END_TEST;
 
+/* runs @desc and pulls @n_buffers buffers from the appsink called "sink" */
+static void
+_pull_buffers (const gchar * desc, GstBuffer ** buffers, guint n_buffers)
+{
+  GstElement *pipeline, *sink;
+  guint i;
+
+  pipeline = gst_parse_launch (desc, NULL);
+  fail_unless (pipeline != NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+  for (i = 0; i < n_buffers; i++) {
+    GstSample *sample = NULL;
+
+    g_signal_emit_by_name (sink, "pull-sample", &sample);
+    fail_unless (sample != NULL);
+    buffers[i] = gst_buffer_ref (gst_sample_get_buffer (sample));
+    gst_sample_unref (sample);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+}
+
+static void
+_assert_buffers_equal (GstBuffer * buffer1, GstBuffer * buffer2)
+{
+  GstMapInfo map;
+
+  fail_unless_equals_int (gst_buffer_get_size (buffer1),
+      gst_buffer_get_size (buffer2));
+  gst_buffer_map (buffer1, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (buffer2, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (buffer1, &map);
+}
+
+static GstBuffer *
+_render_frame (const gchar * format, guint max_threads)
+{
+  GstBuffer *buffer;
+  gchar *desc;
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=1 ! "
+      "video/x-raw,format=%s,width=1920,height=1080 ! "
+      "compositor name=c max-threads=%u background=black "
+      "sink_1::xpos=101 sink_1::ypos=-33 sink_1::alpha=0.5 "
+      "sink_2::xpos=1000 sink_2::ypos=677 ! appsink name=sink "
+      "videotestsrc num-buffers=1 pattern=ball ! "
+      "video/x-raw,format=%s,width=1280,height=720 ! c. "
+      "videotestsrc num-buffers=1 pattern=snow ! "
+      "video/x-raw,format=%s,width=1280,height=720 ! c.", format,
+      max_threads, format, format);
+  _pull_buffers (desc, &buffer, 1);
+  g_free (desc);
+
+  return buffer;
+}
+
+/* blending in parallel bands gives the same result as blending from a
+ * single thread */
+GST_START_TEST (test_parallel_blend)
+{
+  const gchar *formats[] = { "I420", "NV12", "BGRA", "YUY2", "RGB" };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    GstBuffer *single, *parallel;
+
+    GST_INFO ("testing %s", formats[i]);
+    single = _render_frame (formats[i], 1);
+    parallel = _render_frame (formats[i], 4);
+
+    _assert_buffers_equal (single, parallel);
+
+    gst_buffer_unref (single);
+    gst_buffer_unref (parallel);
+  }
+}
+
+GST_END_TEST;
+
+#define N_DIRTY_BUFFERS 5
+
+static void
+_render_frames (const gchar * in_format, const gchar * out_format,
+    gboolean repeat, GstBuffer ** buffers)
+{
+  gchar *desc;
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=%d ! "
+      "video/x-raw,format=%s,width=640,height=480,framerate=30/1 ! "
+      "compositor name=c background=black sink_0::repeat-after-eos=true "
+      "sink_1::xpos=200 sink_1::ypos=131 "
+      "sink_2::xpos=-40 sink_2::ypos=-20 sink_2::alpha=0.7 "
+      "sink_2::repeat-after-eos=true ! video/x-raw,format=%s ! "
+      "appsink name=sink "
+      "videotestsrc num-buffers=%d pattern=ball ! "
+      "video/x-raw,format=%s,width=160,height=120,framerate=30/1 ! c. "
+      "videotestsrc num-buffers=%d pattern=smpte75 ! "
+      "video/x-raw,format=%s,width=320,height=240,framerate=30/1 ! c.",
+      repeat ? 1 : N_DIRTY_BUFFERS, in_format, out_format, N_DIRTY_BUFFERS,
+      in_format, repeat ? 1 : N_DIRTY_BUFFERS, in_format);
+  _pull_buffers (desc, buffers, N_DIRTY_BUFFERS);
+  g_free (desc);
+}
+
+static void
+_check_repeated_frames (const gchar * in_format, const gchar * out_format)
+{
+  GstBuffer *repeated[N_DIRTY_BUFFERS], *fresh[N_DIRTY_BUFFERS];
+  guint i;
+
+  GST_INFO ("testing %s to %s", in_format, out_format);
+  _render_frames (in_format, out_format, TRUE, repeated);
+  _render_frames (in_format, out_format, FALSE, fresh);
+
+  for (i = 0; i < N_DIRTY_BUFFERS; i++) {
+    _assert_buffers_equal (repeated[i], fresh[i]);
+    gst_buffer_unref (repeated[i]);
+    gst_buffer_unref (fresh[i]);
+  }
+}
+
+/* only redrawing the parts of the output where a pad changed gives the same
+ * result as redrawing everything */
+GST_START_TEST (test_dirty_stripes)
+{
+  const gchar *formats[] = { "I420", "NV12", "BGRA", "YUY2", "RGB" };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++)
+    _check_repeated_frames (formats[i], formats[i]);
+}
+
+GST_END_TEST;
+
+/* converted frames of repeated input buffers are reused */
+GST_START_TEST (test_repeated_conversion)
+{
+  _check_repeated_frames ("I420", "BGRA");
+  _check_repeated_frames ("BGRA", "I420");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pad_stats)
+{
+  GstElement *compositor;
+  GstPad *pad;
+  GstStructure *stats = NULL;
+  guint64 val;
+
+  compositor = gst_element_factory_make ("compositor", NULL);
+  pad = gst_element_get_request_pad (compositor, "sink_%u");
+  fail_unless (pad != NULL);
+
+  g_object_get (pad, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_has_name (stats,
+          "application/x-video-aggregator-pad-stats"));
+  fail_unless (gst_structure_get_uint64 (stats, "late-outputs", &val));
+  fail_unless_equals_uint64 (val, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "dropped-late", &val));
+  fail_unless_equals_uint64 (val, 0);
+  fail_unless (gst_structure_get_uint64 (stats, "max-lateness", &val));
+  fail_unless_equals_uint64 (val, 0);
+  gst_structure_free (stats);
+
+  gst_element_release_request_pad (compositor, pad);
+  gst_object_unref (pad);
+  gst_object_unref (compositor);
+}
+
+GST_END_TEST;
+
 static Suite *
 compositor_suite (void)
 {
@@ -2205,6 +2383,10 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
+  tcase_add_test (tc_chain, test_parallel_blend);
+  tcase_add_test (tc_chain, test_dirty_stripes);
+  tcase_add_test (tc_chain, test_repeated_conversion);
+  tcase_add_test (tc_chain, test_pad_stats);
 
   return s;
 }
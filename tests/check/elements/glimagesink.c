@@ -257,11 +257,50 @@ GST_START_TEST (test_query_drain)
 
 GST_END_TEST;
 
+static gboolean
+_client_draw (GstElement * sink, gpointer context, GstSample * sample,
+    gpointer user_data)
+{
+  return FALSE;
+}
+
+GST_START_TEST (test_yuv_caps)
+{
+  GstElement *sink;
+  GstPad *pad;
+  GstCaps *caps, *yuv;
+
+  sink = gst_element_factory_make ("glimagesinkelement", NULL);
+  fail_unless (sink != NULL);
+  pad = gst_element_get_static_pad (sink, "sink");
+
+  yuv = gst_caps_from_string ("video/x-raw(memory:GLMemory), format=NV12, "
+      "width=320, height=240, framerate=30/1, texture-target=2D");
+
+  /* YUV planes are sampled directly by the sink */
+  caps = gst_pad_query_caps (pad, NULL);
+  fail_unless (gst_caps_can_intersect (caps, yuv));
+  gst_caps_unref (caps);
+
+  /* applications drawing themselves get RGBA */
+  g_signal_connect (sink, "client-draw", G_CALLBACK (_client_draw), NULL);
+  caps = gst_pad_query_caps (pad, NULL);
+  fail_if (gst_caps_can_intersect (caps, yuv));
+  gst_caps_unref (caps);
+
+  gst_caps_unref (yuv);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+}
+
+GST_END_TEST;
+
 static Suite *
 glimagesink_suite (void)
 {
   Suite *s = suite_create ("glimagesink");
   TCase *tc = tcase_create ("general");
+  TCase *tc_caps = tcase_create ("caps");
 
   tcase_set_timeout (tc, 5);
 
@@ -269,6 +308,9 @@ glimagesink_suite (void)
   tcase_add_test (tc, test_query_drain);
   suite_add_tcase (s, tc);
 
+  tcase_add_test (tc_caps, test_yuv_caps);
+  suite_add_tcase (s, tc_caps);
+
   return s;
 }
 
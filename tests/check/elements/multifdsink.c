@@ -138,6 +138,64 @@ GST_START_TEST (test_add_client)
 
 GST_END_TEST;
 
+GST_START_TEST (test_stats)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  GstStructure *stats;
+  const GstStructure *client;
+  const GValue *clients;
+  guint num_clients;
+  guint64 bytes_sent;
+  int pfd1[2], pfd2[2];
+  gchar data[4];
+
+  sink = setup_multifdsink ();
+
+  fail_if (pipe (pfd1) == -1);
+  fail_if (pipe (pfd2) == -1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  g_object_get (sink, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint (stats, "num-clients", &num_clients));
+  fail_unless_equals_int (num_clients, 0);
+  gst_structure_free (stats);
+
+  g_signal_emit_by_name (sink, "add", pfd1[1]);
+  g_signal_emit_by_name (sink, "add", pfd2[1]);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+  gst_caps_unref (caps);
+  gst_buffer_fill (buffer, 0, "dead", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  fail_if (read (pfd1[0], data, 4) < 4);
+  fail_if (read (pfd2[0], data, 4) < 4);
+  wait_bytes_served (sink, 8);
+
+  g_object_get (sink, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint (stats, "num-clients", &num_clients));
+  fail_unless_equals_int (num_clients, 2);
+  clients = gst_structure_get_value (stats, "clients");
+  fail_unless (clients != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (clients), 2);
+  client = gst_value_get_structure (gst_value_array_get_value (clients, 0));
+  fail_unless (gst_structure_get_uint64 (client, "bytes-sent", &bytes_sent));
+  fail_unless_equals_uint64 (bytes_sent, 4);
+  fail_unless (gst_structure_has_field (client, "queue-depth"));
+  fail_unless (gst_structure_has_field (client, "time-behind"));
+  gst_structure_free (stats);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multifdsink (sink);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_add_client_in_null_state)
 {
   GstElement *sink;
@@ -959,6 +1017,7 @@ multifdsink_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_no_clients);
   tcase_add_test (tc_chain, test_add_client);
+  tcase_add_test (tc_chain, test_stats);
   tcase_add_test (tc_chain, test_add_client_in_null_state);
   tcase_add_test (tc_chain, test_streamheader);
   tcase_add_test (tc_chain, test_change_streamheader);
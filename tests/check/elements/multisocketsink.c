@@ -972,6 +972,104 @@ GST_END_TEST;
  * an old client still needs to read from before the new streamheaders
  * a new client gets the new streamheaders
  */
+/* queued buffers are sent to datagram clients in one call, every buffer is
+ * still one datagram */
+GST_START_TEST (test_datagram_max_messages)
+{
+  GstElement *sink;
+  GstCaps *caps;
+  GError *error = NULL;
+  GSocket *sinksocket, *srcsocket;
+  gint sv[2];
+  gchar data[32];
+  gint i, n_read = 0;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "max-messages", 8, NULL);
+  g_object_set (sink, "buffers-min", 5, NULL);
+  g_object_set (sink, "sync-method", 3, NULL);  /* 3 = burst */
+  g_object_set (sink, "burst-format", GST_FORMAT_BUFFERS, NULL);
+  g_object_set (sink, "burst-value", (guint64) 4, NULL);
+
+  fail_if (socketpair (PF_UNIX, SOCK_DGRAM, 0, sv));
+  sinksocket = g_socket_new_from_fd (sv[1], &error);
+  fail_if (error);
+  srcsocket = g_socket_new_from_fd (sv[0], &error);
+  fail_if (error);
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+
+  for (i = 0; i < 5; i++)
+    fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (i)) == GST_FLOW_OK);
+
+  g_signal_emit_by_name (sink, "add", sinksocket);
+  fail_unless (gst_pad_push (mysrcpad, gst_new_buffer (5)) == GST_FLOW_OK);
+
+  /* read the burst and the last buffer, one datagram per buffer */
+  do {
+    fail_unless_equals_int (read_handle (srcsocket, data, sizeof (data)), 16);
+    n_read++;
+  } while (memcmp (data, "deadbee00000005", 16) != 0);
+  fail_unless (n_read > 1);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+
+  gst_caps_unref (caps);
+  g_object_unref (srcsocket);
+  g_object_unref (sinksocket);
+}
+
+GST_END_TEST;
+
+/* clients serviced by different threads all get the data */
+GST_START_TEST (test_n_threads)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstCaps *caps;
+  gchar data[4];
+  GSocket *sinksocket[3], *srcsocket[3];
+  gint i;
+
+  sink = setup_multisocketsink ();
+  g_object_set (sink, "n-threads", 2, NULL);
+  for (i = 0; i < 3; i++)
+    fail_unless (setup_handles (&sinksocket[i], &srcsocket[i]));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 3; i++)
+    g_signal_emit_by_name (sink, "add", sinksocket[i]);
+  fail_unless_num_handles (sink, 3);
+
+  caps = gst_caps_from_string ("application/x-gst-check");
+  gst_check_setup_events (mysrcpad, sink, caps, GST_FORMAT_BYTES);
+  buffer = gst_buffer_new_and_alloc (4);
+  gst_buffer_fill (buffer, 0, "dead", 4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  for (i = 0; i < 3; i++) {
+    fail_if (read_handle (srcsocket[i], data, 4) < 4);
+    fail_unless (strncmp (data, "dead", 4) == 0);
+  }
+  wait_bytes_served (sink, 12);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_multisocketsink (sink);
+  gst_caps_unref (caps);
+
+  for (i = 0; i < 3; i++) {
+    g_object_unref (srcsocket[i]);
+    g_object_unref (sinksocket[i]);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 multisocketsink_suite (void)
 {
@@ -988,6 +1086,8 @@ multisocketsink_suite (void)
   tcase_add_test (tc_chain, test_burst_client_bytes_keyframe);
   tcase_add_test (tc_chain, test_burst_client_bytes_with_keyframe);
   tcase_add_test (tc_chain, test_client_next_keyframe);
+  tcase_add_test (tc_chain, test_datagram_max_messages);
+  tcase_add_test (tc_chain, test_n_threads);
 
   return s;
 }
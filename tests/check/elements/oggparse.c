@@ -0,0 +1,310 @@
+/* GStreamer
+ *
+ * unit tests for oggparse
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+/* theora-vorbis.ogg has 19 pages, the first 4 are the headers of the two
+ * streams */
+#define N_PAGES 19
+#define N_HEADERS 4
+
+static guint8 *
+load_file (gsize * size)
+{
+  GError *err = NULL;
+  gchar *path, *data;
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  fail_unless (g_file_get_contents (path, &data, size, &err), "%s",
+      err ? err->message : "");
+  g_free (path);
+
+  return (guint8 *) data;
+}
+
+/* size of the page at the start of @data */
+static gsize
+page_size (const guint8 * data)
+{
+  gsize size = 27 + data[26];
+  guint i;
+
+  fail_unless (memcmp (data, "OggS", 4) == 0);
+  for (i = 0; i < data[26]; i++)
+    size += data[27 + i];
+
+  return size;
+}
+
+static GstHarness *
+setup_oggparse (void)
+{
+  GstHarness *h;
+
+  h = gst_harness_new ("oggparse");
+  gst_harness_set_src_caps_str (h, "application/ogg");
+
+  return h;
+}
+
+/* pulls all output and checks that each page is the data of the input at its
+ * offset. Returns the number of pages. */
+static guint
+check_output (GstHarness * h, const guint8 * input, gsize input_size)
+{
+  GstBuffer *buf;
+  guint n = 0;
+
+  while ((buf = gst_harness_try_pull (h))) {
+    guint64 offset = GST_BUFFER_OFFSET (buf);
+    gsize size = gst_buffer_get_size (buf);
+
+    fail_unless (offset + size <= input_size);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET_END (buf), offset + size);
+    fail_unless_equals_int (size, page_size (input + offset));
+    fail_unless (gst_buffer_memcmp (buf, 0, input + offset, size) == 0);
+
+    if (n < N_HEADERS)
+      fail_unless (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_HEADER));
+    else
+      fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_HEADER));
+
+    gst_buffer_unref (buf);
+    n++;
+  }
+
+  return n;
+}
+
+GST_START_TEST (test_parse_whole_file)
+{
+  GstHarness *h = setup_oggparse ();
+  const GValue *streamheader;
+  GstStructure *s;
+  GstCaps *caps;
+  guint8 *data;
+  gsize size;
+
+  data = load_file (&size);
+
+  fail_unless_equals_int (gst_harness_push (h,
+          gst_buffer_new_wrapped (g_memdup (data, size), size)), GST_FLOW_OK);
+  fail_unless_equals_int (check_output (h, data, size), N_PAGES);
+
+  caps = gst_pad_get_current_caps (h->sinkpad);
+  fail_unless (caps != NULL);
+  s = gst_caps_get_structure (caps, 0);
+  streamheader = gst_structure_get_value (s, "streamheader");
+  fail_unless (streamheader != NULL);
+  fail_unless (GST_VALUE_HOLDS_ARRAY (streamheader));
+  fail_unless_equals_int (gst_value_array_get_size (streamheader), N_HEADERS);
+  gst_caps_unref (caps);
+
+  g_free (data);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_split_pages)
+{
+  static const gsize chunk_sizes[] = { 1, 7, 27, 1000 };
+  guint8 *data;
+  gsize size;
+  guint i;
+
+  data = load_file (&size);
+
+  /* pages, and page headers, split across input buffers */
+  for (i = 0; i < G_N_ELEMENTS (chunk_sizes); i++) {
+    GstHarness *h = setup_oggparse ();
+    gsize pos;
+
+    for (pos = 0; pos < size; pos += chunk_sizes[i]) {
+      gsize len = MIN (chunk_sizes[i], size - pos);
+
+      fail_unless_equals_int (gst_harness_push (h,
+              gst_buffer_new_wrapped (g_memdup (data + pos, len), len)),
+          GST_FLOW_OK);
+    }
+    fail_unless_equals_int (check_output (h, data, size), N_PAGES);
+
+    gst_harness_teardown (h);
+  }
+
+  g_free (data);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_resync)
+{
+  GstHarness *h = setup_oggparse ();
+  guint8 *data, *input;
+  gsize size, garbage_size, pos;
+
+  data = load_file (&size);
+
+  /* garbage with a capture pattern that starts an empty page with a wrong
+   * checksum, the parser has to skip it and find the real first page */
+  garbage_size = 100;
+  input = g_malloc0 (garbage_size + size);
+  memcpy (input, "garbage", 7);
+  memcpy (input + 20, "OggS", 4);
+  memcpy (input + garbage_size, data, size);
+
+  /* also put garbage between two pages */
+  pos = garbage_size + page_size (data) + page_size (data + page_size (data));
+  fail_unless_equals_int (gst_harness_push (h,
+          gst_buffer_new_wrapped (g_memdup (input, pos), pos)), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h,
+          gst_buffer_new_wrapped (g_strdup ("more garbage"), 12)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h,
+          gst_buffer_new_wrapped (g_memdup (input + pos,
+                  garbage_size + size - pos), garbage_size + size - pos)),
+      GST_FLOW_OK);
+
+  /* offsets count the garbage, rebuild the input as it was received */
+  {
+    gsize total = garbage_size + size + 12;
+    guint8 *received = g_malloc (total);
+
+    memcpy (received, input, pos);
+    memcpy (received + pos, "more garbage", 12);
+    memcpy (received + pos + 12, input + pos, garbage_size + size - pos);
+
+    fail_unless_equals_int (check_output (h, received, total), N_PAGES);
+    g_free (received);
+  }
+
+  g_free (input);
+  g_free (data);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_crc_mismatch)
+{
+  GstHarness *h = setup_oggparse ();
+  GstBuffer *buf;
+  guint8 *data;
+  gsize size, pos, corrupt_size;
+  guint i, n = 0;
+
+  data = load_file (&size);
+
+  /* corrupt the body of page 10, a data page */
+  for (i = 0, pos = 0; i < 10; i++)
+    pos += page_size (data + pos);
+  corrupt_size = page_size (data + pos);
+  data[pos + corrupt_size - 1] ^= 0xff;
+
+  fail_unless_equals_int (gst_harness_push (h,
+          gst_buffer_new_wrapped (g_memdup (data, size), size)), GST_FLOW_OK);
+
+  while ((buf = gst_harness_try_pull (h))) {
+    fail_if (GST_BUFFER_OFFSET (buf) == pos);
+    fail_unless (gst_buffer_memcmp (buf, 0, data + GST_BUFFER_OFFSET (buf),
+            gst_buffer_get_size (buf)) == 0);
+    gst_buffer_unref (buf);
+    n++;
+  }
+  fail_unless_equals_int (n, N_PAGES - 1);
+
+  g_free (data);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_parse_page_buffers)
+{
+  GstHarness *h = setup_oggparse ();
+  GstBuffer *inbufs[N_PAGES];
+  GstBuffer *buf;
+  guint8 *data;
+  gsize size, pos;
+  guint i;
+
+  data = load_file (&size);
+
+  /* one input buffer per page, like after oggmux. The output shares the
+   * memory, but upstream's buffers are not modified */
+  for (i = 0, pos = 0; i < N_PAGES; i++) {
+    gsize len = page_size (data + pos);
+
+    inbufs[i] = gst_buffer_new_wrapped (g_memdup (data + pos, len), len);
+    GST_BUFFER_PTS (inbufs[i]) = 42 * GST_SECOND;
+    GST_BUFFER_OFFSET (inbufs[i]) = 42;
+    GST_BUFFER_FLAG_SET (inbufs[i], GST_BUFFER_FLAG_DISCONT);
+
+    fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (inbufs[i])),
+        GST_FLOW_OK);
+    pos += len;
+  }
+  fail_unless_equals_int (pos, size);
+
+  for (i = 0; i < N_PAGES; i++) {
+    buf = gst_harness_pull (h);
+    fail_unless (buf != inbufs[i]);
+    fail_unless (gst_buffer_peek_memory (buf, 0) ==
+        gst_buffer_peek_memory (inbufs[i], 0));
+    fail_if (GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DISCONT));
+    gst_buffer_unref (buf);
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (inbufs[i]), 42 * GST_SECOND);
+    fail_unless_equals_uint64 (GST_BUFFER_OFFSET (inbufs[i]), 42);
+    fail_unless (GST_BUFFER_FLAG_IS_SET (inbufs[i], GST_BUFFER_FLAG_DISCONT));
+    fail_if (GST_BUFFER_FLAG_IS_SET (inbufs[i], GST_BUFFER_FLAG_HEADER));
+    gst_buffer_unref (inbufs[i]);
+  }
+
+  g_free (data);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+oggparse_suite (void)
+{
+  Suite *s = suite_create ("oggparse");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_parse_whole_file);
+  tcase_add_test (tc_chain, test_parse_split_pages);
+  tcase_add_test (tc_chain, test_parse_resync);
+  tcase_add_test (tc_chain, test_parse_crc_mismatch);
+  tcase_add_test (tc_chain, test_parse_page_buffers);
+
+  return s;
+}
+
+GST_CHECK_MAIN (oggparse);
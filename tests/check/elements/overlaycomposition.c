@@ -97,6 +97,7 @@ typedef struct
   guint expected_window_width, expected_window_height;
 
   GstVideoOverlayComposition *comp;
+  guint n_draws;
 } State;
 
 static void
@@ -116,6 +117,8 @@ on_draw (GstElement * element, GstSample * sample, State * s)
   fail_unless (s->valid);
   fail_unless (GST_IS_SAMPLE (sample));
 
+  s->n_draws++;
+
   return gst_video_overlay_composition_ref (s->comp);
 }
 
@@ -321,6 +324,63 @@ GST_START_TEST (render_meta)
 
 GST_END_TEST;
 
+GST_START_TEST (render_meta_draw_on_invalidate)
+{
+  GstHarness *h;
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstBuffer *buffer, *overlay;
+  State s = { 0, };
+  GstVideoOverlayCompositionMeta *meta;
+  guint i;
+
+  h = gst_harness_new ("overlaycomposition");
+  g_object_set (h->element, "draw-on-invalidate", TRUE, NULL);
+
+  g_signal_connect (h->element, "draw", G_CALLBACK (on_draw), &s);
+  g_signal_connect (h->element, "caps-changed", G_CALLBACK (on_caps_changed),
+      &s);
+
+  overlay = create_overlay_frame (0xffff0000);
+  rect =
+      gst_video_overlay_rectangle_new_raw (overlay, 32, 32, OVERLAY_WIDTH,
+      OVERLAY_HEIGHT, GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (overlay);
+  comp = gst_video_overlay_composition_new (rect);
+  gst_video_overlay_rectangle_unref (rect);
+
+  s.comp = comp;
+  s.expected_window_width = VIDEO_WIDTH;
+  s.expected_window_height = VIDEO_HEIGHT;
+
+  gst_harness_add_propose_allocation_meta (h,
+      GST_VIDEO_OVERLAY_COMPOSITION_META_API_TYPE, NULL);
+  gst_harness_set_src_caps_str (h, VIDEO_CAPS);
+
+  /* Only the first frame is drawn, the others reuse the composition */
+  for (i = 0; i < 3; i++) {
+    buffer = gst_harness_push_and_pull (h, create_video_frame ());
+    meta = gst_buffer_get_video_overlay_composition_meta (buffer);
+    fail_unless (meta);
+    fail_unless (meta->overlay == s.comp);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless_equals_int (s.n_draws, 1);
+
+  /* Invalidating draws again for the next frame only */
+  g_signal_emit_by_name (h->element, "invalidate");
+  for (i = 0; i < 2; i++) {
+    buffer = gst_harness_push_and_pull (h, create_video_frame ());
+    gst_buffer_unref (buffer);
+  }
+  fail_unless_equals_int (s.n_draws, 2);
+
+  gst_video_overlay_composition_unref (s.comp);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 overlaycomposition_suite (void)
 {
@@ -332,6 +392,7 @@ overlaycomposition_suite (void)
   tcase_add_test (tc, render_fallback);
   tcase_add_test (tc, render_fallback_2);
   tcase_add_test (tc, render_meta);
+  tcase_add_test (tc, render_meta_draw_on_invalidate);
 
   return s;
 }
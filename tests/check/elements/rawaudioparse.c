@@ -378,6 +378,47 @@ GST_START_TEST (test_change_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_frames_per_buffer)
+{
+  RawAudParseTestCtx testctx;
+  GstBuffer *inbuf, *outbuf;
+  GList *l;
+
+  setup_rawaudioparse (&testctx, FALSE, TRUE, NULL, GST_FORMAT_BYTES);
+
+  /* 64 frames of 4 bytes each, so 256 bytes per output buffer */
+  g_object_set (G_OBJECT (testctx.rawaudioparse), "frames-per-buffer", 64,
+      NULL);
+
+  /* Not enough for one chunk yet, nothing must be output */
+  inbuf = gst_adapter_take_buffer (testctx.test_data_adapter, 200);
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 0);
+
+  /* 600 bytes are queued now, which makes two complete chunks */
+  inbuf = gst_adapter_take_buffer (testctx.test_data_adapter, 400);
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+
+  for (l = buffers; l; l = l->next) {
+    outbuf = l->data;
+    fail_unless_equals_uint64 (gst_buffer_get_size (outbuf), 256);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (outbuf),
+        GST_USECOND * 1600);
+  }
+
+  /* The remaining 88 bytes are only output when draining */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  outbuf = g_list_last (buffers)->data;
+  fail_unless_equals_uint64 (gst_buffer_get_size (outbuf), 88);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (outbuf), GST_USECOND * 3200);
+
+  cleanup_rawaudioparse (&testctx);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 rawaudioparse_suite (void)
@@ -391,6 +432,7 @@ rawaudioparse_suite (void)
   tcase_add_test (tc_chain, test_push_swapped_channels);
   tcase_add_test (tc_chain, test_config_switch);
   tcase_add_test (tc_chain, test_change_caps);
+  tcase_add_test (tc_chain, test_frames_per_buffer);
 
   return s;
 }
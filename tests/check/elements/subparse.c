@@ -406,6 +406,61 @@ GST_START_TEST (test_srt)
 GST_END_TEST;
 
 
+static gint64 seek_byte_start;
+
+static gboolean
+seek_byte_start_event_func (GstPad * pad, GstObject * parent,
+    GstEvent * event)
+{
+  if (GST_EVENT_TYPE (event) == GST_EVENT_SEEK) {
+    GstFormat format;
+
+    gst_event_parse_seek (event, NULL, &format, NULL, NULL, &seek_byte_start,
+        NULL, NULL);
+    fail_unless_equals_int (format, GST_FORMAT_BYTES);
+    gst_event_unref (event);
+    return TRUE;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+GST_START_TEST (test_srt_seek_index)
+{
+  guint64 cue3_offset;
+  guint n;
+
+  setup_subparse ();
+  gst_pad_set_event_function (mysrcpad, seek_byte_start_event_func);
+
+  for (n = 0; n < 5; ++n) {
+    GstBuffer *buf = buffer_from_static_string (srt_input[n].in);
+
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buf), GST_FLOW_OK);
+  }
+
+  cue3_offset = strlen (srt_input[0].in) + strlen (srt_input[1].in);
+
+  /* in the middle of cue 4: seek to the cue before, in case it's still
+   * displayed */
+  seek_byte_start = -1;
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_event_new_seek (1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH,
+              GST_SEEK_TYPE_SET, 4500 * GST_MSECOND, GST_SEEK_TYPE_NONE, 0)));
+  fail_unless_equals_int64 (seek_byte_start, cue3_offset);
+
+  /* nothing known before the second cue, start from the beginning */
+  seek_byte_start = -1;
+  fail_unless (gst_pad_push_event (mysinkpad,
+          gst_event_new_seek (1.0, GST_FORMAT_TIME, GST_SEEK_FLAG_FLUSH,
+              GST_SEEK_TYPE_SET, 1500 * GST_MSECOND, GST_SEEK_TYPE_NONE, 0)));
+  fail_unless_equals_int64 (seek_byte_start, 0);
+
+  teardown_subparse ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_webvtt)
 {
   SubParseInputChunk webvtt_input[] = {
@@ -1050,6 +1105,7 @@ subparse_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_srt);
+  tcase_add_test (tc_chain, test_srt_seek_index);
   tcase_add_test (tc_chain, test_webvtt);
   tcase_add_test (tc_chain, test_tmplayer_multiline);
   tcase_add_test (tc_chain, test_tmplayer_multiline_with_bogus_lines);
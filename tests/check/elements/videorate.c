@@ -1536,6 +1536,59 @@ GST_START_TEST (test_query_position)
 
 GST_END_TEST;
 
+static void
+check_duplicates (gboolean mark_duplicates)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second;
+  GstMemory *mem;
+  GstCaps *caps;
+  GList *l;
+
+  videorate = setup_videorate ();
+  g_object_set (videorate, "mark-duplicates", mark_duplicates, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  gst_buffer_memset (first, 0, 1, 4);
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+  fail_unless (gst_pad_push (mysrcpad, first) == GST_FLOW_OK);
+
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = GST_SECOND / 5;
+  gst_buffer_memset (second, 0, 2, 4);
+  fail_unless (gst_pad_push (mysrcpad, second) == GST_FLOW_OK);
+
+  /* the first frame for 0, 40 and 80ms, the second one is closer to 120ms */
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  assert_videorate_stats (videorate, "second", 2, 3, 0, 2);
+
+  mem = gst_buffer_peek_memory (buffers->data, 0);
+  fail_if (GST_BUFFER_FLAG_IS_SET (buffers->data, GST_BUFFER_FLAG_GAP));
+  for (l = buffers->next; l; l = l->next) {
+    /* duplicates share the memory of the original frame */
+    fail_unless_equals_int (gst_buffer_n_memory (l->data), 1);
+    fail_unless (gst_buffer_peek_memory (l->data, 0) == mem);
+    fail_unless_equals_int (GST_BUFFER_FLAG_IS_SET (l->data,
+            GST_BUFFER_FLAG_GAP), mark_duplicates);
+  }
+
+  cleanup_videorate (videorate);
+}
+
+GST_START_TEST (test_duplicates)
+{
+  check_duplicates (TRUE);
+  check_duplicates (FALSE);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1559,6 +1612,7 @@ videorate_suite (void)
   tcase_add_loop_test (tc_chain, test_rate, 0, G_N_ELEMENTS (rate_tests));
   tcase_add_test (tc_chain, test_query_duration);
   tcase_add_test (tc_chain, test_max_duplication_time);
+  tcase_add_test (tc_chain, test_duplicates);
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
 
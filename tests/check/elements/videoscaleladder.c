@@ -0,0 +1,178 @@
+/* GStreamer
+ *
+ * unit test for videoscaleladder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/video/video.h>
+#include <gst/check/gstcheck.h>
+
+#define N_BUFFERS 5
+
+static const struct
+{
+  gint width, height;
+} renditions[] = {
+  {160, 120}, {80, 60}, {320, 240}
+};
+
+#define N_RENDITIONS G_N_ELEMENTS (renditions)
+
+typedef struct
+{
+  gint index;
+  guint n_buffers;
+} SinkData;
+
+static void
+on_handoff (GstElement * sink, GstBuffer * buffer, GstPad * pad,
+    SinkData * data)
+{
+  GstCaps *caps;
+  GstVideoInfo info;
+
+  caps = gst_pad_get_current_caps (pad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_caps_unref (caps);
+
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&info),
+      renditions[data->index].width);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&info),
+      renditions[data->index].height);
+  fail_unless (GST_VIDEO_INFO_FORMAT (&info) == GST_VIDEO_FORMAT_I420);
+  fail_unless_equals_int (gst_buffer_get_size (buffer),
+      GST_VIDEO_INFO_SIZE (&info));
+  fail_unless (GST_BUFFER_PTS_IS_VALID (buffer));
+
+  data->n_buffers++;
+}
+
+static void
+run_ladder (gboolean cascade)
+{
+  GstElement *pipeline, *ladder;
+  GString *desc;
+  GstMessage *msg;
+  GstBus *bus;
+  SinkData data[N_RENDITIONS];
+  guint i;
+
+  desc = g_string_new (NULL);
+  g_string_append_printf (desc, "videotestsrc num-buffers=%d ! "
+      "video/x-raw,format=I420,width=320,height=240 ! "
+      "videoscaleladder name=ladder", N_BUFFERS);
+  for (i = 0; i < N_RENDITIONS; i++) {
+    g_string_append_printf (desc, " ladder.src_%u ! "
+        "video/x-raw,width=%d,height=%d ! "
+        "fakesink name=sink%u signal-handoffs=true", i, renditions[i].width,
+        renditions[i].height, i);
+  }
+
+  pipeline = gst_parse_launch (desc->str, NULL);
+  g_string_free (desc, TRUE);
+  fail_unless (pipeline != NULL);
+
+  ladder = gst_bin_get_by_name (GST_BIN (pipeline), "ladder");
+  g_object_set (ladder, "cascade", cascade, NULL);
+  gst_object_unref (ladder);
+
+  for (i = 0; i < N_RENDITIONS; i++) {
+    gchar *name = g_strdup_printf ("sink%u", i);
+    GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+
+    data[i].index = i;
+    data[i].n_buffers = 0;
+    g_signal_connect (sink, "handoff", G_CALLBACK (on_handoff), &data[i]);
+    gst_object_unref (sink);
+    g_free (name);
+  }
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  for (i = 0; i < N_RENDITIONS; i++)
+    fail_unless_equals_int (data[i].n_buffers, N_BUFFERS);
+
+  fail_unless (gst_element_set_state (pipeline,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_cascade)
+{
+  run_ladder (TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_no_cascade)
+{
+  run_ladder (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_request_release)
+{
+  GstElement *ladder;
+  GstPad *pad1, *pad2;
+
+  ladder = gst_element_factory_make ("videoscaleladder", NULL);
+  fail_unless (ladder != NULL);
+
+  pad1 = gst_element_get_request_pad (ladder, "src_%u");
+  pad2 = gst_element_get_request_pad (ladder, "src_%u");
+  fail_unless (pad1 != NULL && pad2 != NULL);
+  fail_if (g_str_equal (GST_PAD_NAME (pad1), GST_PAD_NAME (pad2)));
+
+  gst_element_release_request_pad (ladder, pad1);
+  gst_object_unref (pad1);
+  gst_element_release_request_pad (ladder, pad2);
+  gst_object_unref (pad2);
+
+  gst_object_unref (ladder);
+}
+
+GST_END_TEST;
+
+static Suite *
+videoscaleladder_suite (void)
+{
+  Suite *s = suite_create ("videoscaleladder");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_cascade);
+  tcase_add_test (tc_chain, test_no_cascade);
+  tcase_add_test (tc_chain, test_request_release);
+
+  return s;
+}
+
+GST_CHECK_MAIN (videoscaleladder);
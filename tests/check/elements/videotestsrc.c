@@ -29,6 +29,8 @@
 # include <valgrind/valgrind.h>
 #endif
 
+#include <string.h>
+
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
 
@@ -594,6 +596,123 @@ GST_START_TEST (test_patterns_are_deterministic)
 
 GST_END_TEST;
 
+GST_START_TEST (test_threaded_patterns)
+{
+  const gchar *patterns[] = { "snow", "zone-plate", "chroma-zone-plate",
+    "gamut", "ball", "pinwheel", "spokes"
+  };
+  const gchar *formats[] = { "I420", "BGRA" };
+  GstHarness *h[2];
+  guint n_threads[] = { 1, 4 };
+  gint pattern, format, i, frame;
+
+  /* Painting in bands must give the same frames as painting them whole, also
+   * with chroma subsampling and an odd height */
+  for (pattern = 0; pattern < G_N_ELEMENTS (patterns); pattern++) {
+    for (format = 0; format < G_N_ELEMENTS (formats); format++) {
+      gchar *caps = g_strdup_printf ("video/x-raw,format=%s,width=160,"
+          "height=125,framerate=30/1", formats[format]);
+
+      for (i = 0; i < G_N_ELEMENTS (h); i++) {
+        h[i] = gst_harness_new ("videotestsrc");
+        gst_util_set_object_arg (G_OBJECT (h[i]->element), "pattern",
+            patterns[pattern]);
+        g_object_set (h[i]->element, "n-threads", n_threads[i], NULL);
+        gst_harness_set_caps_str (h[i], NULL, caps);
+        gst_harness_set_blocking_push_mode (h[i]);
+        gst_harness_play (h[i]);
+      }
+      g_free (caps);
+
+      for (frame = 0; frame < 2; frame++) {
+        GstBuffer *buf0 = gst_harness_pull (h[0]);
+        GstBuffer *buf1 = gst_harness_pull (h[1]);
+        gchar *checksum0 = get_buffer_checksum (buf0);
+        gchar *checksum1 = get_buffer_checksum (buf1);
+
+        fail_unless_equals_string (checksum0, checksum1);
+
+        g_free (checksum0);
+        g_free (checksum1);
+        gst_buffer_unref (buf0);
+        gst_buffer_unref (buf1);
+      }
+
+      for (i = 0; i < G_N_ELEMENTS (h); i++)
+        gst_harness_teardown (h[i]);
+    }
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_static_pattern_shared)
+{
+  GstHarness *h;
+  GstBuffer *buf1, *buf2;
+
+  h = gst_harness_new ("videotestsrc");
+  gst_util_set_object_arg (G_OBJECT (h->element), "pattern", "checkers-1");
+  gst_harness_set_caps_str (h, NULL,
+      "video/x-raw,format=I420,width=64,height=32,framerate=30/1");
+  gst_harness_set_blocking_push_mode (h);
+  gst_harness_play (h);
+
+  buf1 = gst_harness_pull (h);
+  buf2 = gst_harness_pull (h);
+
+  /* the pattern is only rendered once and both frames share it */
+  fail_unless (gst_buffer_peek_memory (buf1, 0) ==
+      gst_buffer_peek_memory (buf2, 0));
+  fail_unless (GST_BUFFER_PTS (buf2) > GST_BUFFER_PTS (buf1));
+  fail_unless_equals_int (GST_BUFFER_OFFSET (buf2),
+      GST_BUFFER_OFFSET (buf1) + 1);
+
+  gst_buffer_unref (buf1);
+  gst_buffer_unref (buf2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_static_pattern_scrolling)
+{
+  GstHarness *h;
+  GstBuffer *buf1, *buf2;
+  GstMapInfo map1, map2;
+  const gint width = 64, height = 16, speed = 3;
+  gint y;
+
+  h = gst_harness_new ("videotestsrc");
+  gst_util_set_object_arg (G_OBJECT (h->element), "pattern", "bar");
+  g_object_set (h->element, "horizontal-speed", speed, NULL);
+  gst_harness_set_caps_str (h, NULL,
+      "video/x-raw,format=BGRx,width=64,height=16,framerate=30/1");
+  gst_harness_set_blocking_push_mode (h);
+  gst_harness_play (h);
+
+  buf1 = gst_harness_pull (h);
+  buf2 = gst_harness_pull (h);
+
+  /* the second frame is the first one scrolled left by speed pixels */
+  gst_buffer_map (buf1, &map1, GST_MAP_READ);
+  gst_buffer_map (buf2, &map2, GST_MAP_READ);
+  for (y = 0; y < height; y++) {
+    const guint8 *l1 = map1.data + y * width * 4;
+    const guint8 *l2 = map2.data + y * width * 4;
+
+    fail_unless (memcmp (l2, l1 + speed * 4, (width - speed) * 4) == 0);
+    fail_unless (memcmp (l2 + (width - speed) * 4, l1, speed * 4) == 0);
+  }
+  gst_buffer_unmap (buf1, &map1);
+  gst_buffer_unmap (buf2, &map2);
+
+  gst_buffer_unref (buf1);
+  gst_buffer_unref (buf2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
 
 
 /* FIXME: add tests for YUV formats */
@@ -618,6 +737,9 @@ videotestsrc_suite (void)
   tcase_add_test (tc_chain, test_backward_playback);
   tcase_add_test (tc_chain, test_duration_query);
   tcase_add_test (tc_chain, test_patterns_are_deterministic);
+  tcase_add_test (tc_chain, test_threaded_patterns);
+  tcase_add_test (tc_chain, test_static_pattern_shared);
+  tcase_add_test (tc_chain, test_static_pattern_scrolling);
 
   return s;
 }
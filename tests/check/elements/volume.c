@@ -24,8 +24,11 @@
 #include "config.h"
 #endif
 
+#include <math.h>
+
 #include <gst/base/gstbasetransform.h>
 #include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
 #include <gst/audio/streamvolume.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
 #include <gst/controller/gstdirectcontrolbinding.h>
@@ -60,7 +63,7 @@ static GstPad *mysrcpad, *mysinkpad;
     "format = (string) "FORMATS1", "    \
     "channels = (int) [ 1, MAX ], "     \
     "rate = (int) [ 1,  MAX ], "        \
-    "layout = (string) interleaved"
+    "layout = (string) { interleaved, non-interleaved }"
 
 #define VOLUME_CAPS_STRING_S8           \
     "audio/x-raw, "                     \
@@ -1816,6 +1819,156 @@ GST_START_TEST (test_controller_processing)
 
 GST_END_TEST;
 
+#define RAMP_FRAMES 1000
+#define RAMP_CHANNELS 6
+
+/* a linear control curve must give every frame of all channels the volume
+ * at its timestamp */
+GST_START_TEST (test_controller_ramp)
+{
+  GstControlSource *cs;
+  GstTimedValueControlSource *tvcs;
+  GstElement *volume;
+  GstBuffer *inbuffer, *outbuffer;
+  GstCaps *caps;
+  gfloat *data;
+  GstMapInfo map;
+  GstSegment seg;
+  GstClockTime interval = gst_util_uint64_scale_int (1, GST_SECOND, 44100);
+  gint i, j;
+
+  volume = setup_volume ();
+
+  cs = gst_interpolation_control_source_new ();
+  g_object_set (cs, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  gst_object_add_control_binding (GST_OBJECT_CAST (volume),
+      gst_direct_control_binding_new (GST_OBJECT_CAST (volume), "volume", cs));
+
+  /* the value range for volume is 0.0 ... 10.0, so this ramps from 0.0 to
+   * 1.0 over one second */
+  tvcs = (GstTimedValueControlSource *) cs;
+  gst_timed_value_control_source_set (tvcs, 0 * GST_SECOND, 0.0);
+  gst_timed_value_control_source_set (tvcs, 1 * GST_SECOND, 0.1);
+
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  inbuffer = gst_buffer_new_and_alloc (RAMP_FRAMES * RAMP_CHANNELS *
+      sizeof (gfloat));
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  data = (gfloat *) map.data;
+  for (i = 0; i < RAMP_FRAMES * RAMP_CHANNELS; i++)
+    data[i] = 1.0;
+  gst_buffer_unmap (inbuffer, &map);
+
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_F32);
+  gst_caps_set_simple (caps, "channels", G_TYPE_INT, RAMP_CHANNELS,
+      "channel-mask", GST_TYPE_BITMASK, G_GUINT64_CONSTANT (0x3f), NULL);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  GST_BUFFER_TIMESTAMP (inbuffer) = 0;
+  gst_caps_unref (caps);
+
+  gst_segment_init (&seg, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_segment (&seg)) == TRUE);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  gst_buffer_map (outbuffer, &map, GST_MAP_READ);
+  data = (gfloat *) map.data;
+  for (i = 0; i < RAMP_FRAMES; i++) {
+    gdouble expected = (gdouble) (i * interval) / GST_SECOND;
+
+    for (j = 0; j < RAMP_CHANNELS; j++)
+      fail_unless (fabs (data[i * RAMP_CHANNELS + j] - expected) < 1e-6,
+          "frame %d channel %d: expected %f, got %f", i, j, expected,
+          data[i * RAMP_CHANNELS + j]);
+  }
+  gst_buffer_unmap (outbuffer, &map);
+
+  gst_object_unref (cs);
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_controller_ramp_non_interleaved)
+{
+  GstControlSource *cs;
+  GstTimedValueControlSource *tvcs;
+  GstElement *volume;
+  GstBuffer *inbuffer, *outbuffer;
+  GstAudioBuffer abuf;
+  GstAudioInfo info;
+  GstCaps *caps;
+  gfloat *data;
+  GstMapInfo map;
+  GstSegment seg;
+  GstClockTime interval = gst_util_uint64_scale_int (1, GST_SECOND, 44100);
+  gint i, j;
+
+  volume = setup_volume ();
+
+  cs = gst_interpolation_control_source_new ();
+  g_object_set (cs, "mode", GST_INTERPOLATION_MODE_LINEAR, NULL);
+  gst_object_add_control_binding (GST_OBJECT_CAST (volume),
+      gst_direct_control_binding_new (GST_OBJECT_CAST (volume), "volume", cs));
+
+  tvcs = (GstTimedValueControlSource *) cs;
+  gst_timed_value_control_source_set (tvcs, 0 * GST_SECOND, 0.0);
+  gst_timed_value_control_source_set (tvcs, 1 * GST_SECOND, 0.1);
+
+  fail_unless (gst_element_set_state (volume,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  /* every channel in its own plane, in channel order */
+  inbuffer = gst_buffer_new_and_alloc (RAMP_FRAMES * RAMP_CHANNELS *
+      sizeof (gfloat));
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  data = (gfloat *) map.data;
+  for (i = 0; i < RAMP_FRAMES * RAMP_CHANNELS; i++)
+    data[i] = 1.0;
+  gst_buffer_unmap (inbuffer, &map);
+
+  caps = gst_caps_from_string (VOLUME_CAPS_STRING_F32);
+  gst_caps_set_simple (caps, "channels", G_TYPE_INT, RAMP_CHANNELS,
+      "channel-mask", GST_TYPE_BITMASK, G_GUINT64_CONSTANT (0x3f),
+      "layout", G_TYPE_STRING, "non-interleaved", NULL);
+  fail_unless (gst_audio_info_from_caps (&info, caps));
+  gst_buffer_add_audio_meta (inbuffer, &info, RAMP_FRAMES, NULL);
+  gst_check_setup_events (mysrcpad, volume, caps, GST_FORMAT_TIME);
+  GST_BUFFER_TIMESTAMP (inbuffer) = 0;
+  gst_caps_unref (caps);
+
+  gst_segment_init (&seg, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_segment (&seg)) == TRUE);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_if ((outbuffer = (GstBuffer *) buffers->data) == NULL);
+  fail_unless (gst_audio_buffer_map (&abuf, &info, outbuffer, GST_MAP_READ));
+  for (j = 0; j < RAMP_CHANNELS; j++) {
+    data = (gfloat *) abuf.planes[j];
+
+    for (i = 0; i < RAMP_FRAMES; i++) {
+      gdouble expected = (gdouble) (i * interval) / GST_SECOND;
+
+      fail_unless (fabs (data[i] - expected) < 1e-6,
+          "frame %d channel %d: expected %f, got %f", i, j, expected, data[i]);
+    }
+  }
+  gst_audio_buffer_unmap (&abuf);
+
+  gst_object_unref (cs);
+  cleanup_volume (volume);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_controller_defaults_at_ts0)
 {
   GstControlSource *cs;
@@ -1908,6 +2061,8 @@ volume_suite (void)
   tcase_add_test (tc_chain, test_controller_usability);
   tcase_add_test (tc_chain, test_controller_processing);
   tcase_add_test (tc_chain, test_controller_defaults_at_ts0);
+  tcase_add_test (tc_chain, test_controller_ramp);
+  tcase_add_test (tc_chain, test_controller_ramp_non_interleaved);
 
   return s;
 }
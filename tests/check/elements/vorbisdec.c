@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/audio/audio.h>
 
 #include <vorbis/codec.h>
 #include <vorbis/vorbisenc.h>
@@ -62,13 +63,18 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
+static GstStaticPadTemplate sinktemplate_planar =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/x-raw, layout = (string) non-interleaved"));
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
     GST_STATIC_CAPS_ANY);
 
 static GstElement *
-setup_vorbisdec (void)
+setup_vorbisdec_full (GstStaticPadTemplate * sinktempl)
 {
   GstElement *vorbisdec;
   GstCaps *caps;
@@ -76,7 +82,7 @@ setup_vorbisdec (void)
   GST_DEBUG ("setup_vorbisdec");
   vorbisdec = gst_check_setup_element ("vorbisdec");
   mysrcpad = gst_check_setup_src_pad (vorbisdec, &srctemplate);
-  mysinkpad = gst_check_setup_sink_pad (vorbisdec, &sinktemplate);
+  mysinkpad = gst_check_setup_sink_pad (vorbisdec, sinktempl);
   gst_pad_set_active (mysrcpad, TRUE);
 
   caps = gst_caps_new_empty_simple ("audio/x-vorbis");
@@ -88,6 +94,12 @@ setup_vorbisdec (void)
   return vorbisdec;
 }
 
+static GstElement *
+setup_vorbisdec (void)
+{
+  return setup_vorbisdec_full (&sinktemplate);
+}
+
 static void
 cleanup_vorbisdec (GstElement * vorbisdec)
 {
@@ -302,6 +314,103 @@ GST_START_TEST (test_empty_vorbis_packet)
 
 GST_END_TEST;
 
+static void
+_push_packet (ogg_packet * packet)
+{
+  GstBuffer *buffer;
+
+  buffer = gst_buffer_new_and_alloc (packet->bytes);
+  gst_buffer_fill (buffer, 0, packet->packet, packet->bytes);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+}
+
+GST_START_TEST (test_non_interleaved_output)
+{
+  GstElement *vorbisdec;
+  vorbis_info enc_vi;
+  vorbis_dsp_state enc_vd;
+  vorbis_block enc_vb;
+  vorbis_comment enc_vc;
+  ogg_packet header, header_comm, header_code, packet;
+  GstCaps *caps;
+  GList *l;
+  float **pcm;
+  gdouble sum[2] = { 0.0, 0.0 };
+  gint i;
+
+  vorbisdec = setup_vorbisdec_full (&sinktemplate_planar);
+  fail_unless_equals_int (gst_element_set_state (vorbisdec, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_SUCCESS);
+
+  vorbis_info_init (&enc_vi);
+  fail_unless (vorbis_encode_init_vbr (&enc_vi, 2, 44100, 0.5) == 0);
+  vorbis_analysis_init (&enc_vd, &enc_vi);
+  vorbis_block_init (&enc_vd, &enc_vb);
+  vorbis_comment_init (&enc_vc);
+  vorbis_analysis_headerout (&enc_vd, &enc_vc, &header, &header_comm,
+      &header_code);
+  _push_packet (&header);
+  _push_packet (&header_comm);
+  _push_packet (&header_code);
+
+  /* a positive left and a negative right channel */
+  pcm = vorbis_analysis_buffer (&enc_vd, 8192);
+  for (i = 0; i < 8192; i++) {
+    pcm[0][i] = 0.25;
+    pcm[1][i] = -0.25;
+  }
+  vorbis_analysis_wrote (&enc_vd, 8192);
+  vorbis_analysis_wrote (&enc_vd, 0);
+
+  while (vorbis_analysis_blockout (&enc_vd, &enc_vb) == 1) {
+    vorbis_analysis (&enc_vb, NULL);
+    vorbis_bitrate_addblock (&enc_vb);
+    while (vorbis_bitrate_flushpacket (&enc_vd, &packet))
+      _push_packet (&packet);
+  }
+
+  caps = gst_pad_get_current_caps (mysinkpad);
+  fail_unless (caps != NULL);
+  fail_unless_equals_string (gst_structure_get_string (gst_caps_get_structure
+          (caps, 0), "layout"), "non-interleaved");
+  gst_caps_unref (caps);
+
+  fail_unless (buffers != NULL);
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *buffer = l->data;
+    GstAudioMeta *meta = gst_buffer_get_audio_meta (buffer);
+    GstMapInfo map;
+    const gfloat *data;
+    gsize j;
+
+    fail_unless (meta != NULL);
+    fail_unless_equals_int (meta->info.layout,
+        GST_AUDIO_LAYOUT_NON_INTERLEAVED);
+    fail_unless_equals_int (meta->info.channels, 2);
+    fail_unless_equals_int (meta->samples * 2 * sizeof (gfloat),
+        gst_buffer_get_size (buffer));
+
+    fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+    data = (const gfloat *) map.data;
+    for (j = 0; j < meta->samples; j++) {
+      sum[0] += data[j];
+      sum[1] += data[meta->samples + j];
+    }
+    gst_buffer_unmap (buffer, &map);
+  }
+  fail_unless (sum[0] > 0.0);
+  fail_unless (sum[1] < 0.0);
+
+  vorbis_comment_clear (&enc_vc);
+  vorbis_block_clear (&enc_vb);
+  vorbis_dsp_clear (&enc_vd);
+  vorbis_info_clear (&enc_vi);
+
+  cleanup_vorbisdec (vorbisdec);
+}
+
+GST_END_TEST;
+
 static Suite *
 vorbisdec_suite (void)
 {
@@ -311,6 +420,7 @@ vorbisdec_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_identification_header);
   tcase_add_test (tc_chain, test_empty_vorbis_packet);
+  tcase_add_test (tc_chain, test_non_interleaved_output);
 
   return s;
 }
@@ -477,6 +477,43 @@ GST_START_TEST (test_manifest_typefinding)
 
 GST_END_TEST;
 
+static void
+check_magic (const guint8 * header, gsize header_size, const gchar * type)
+{
+  GstTypeFindProbability prob;
+  const gchar *media_type;
+  guint8 data[1024];
+  GstCaps *caps;
+
+  /* the rest of the data looks like nothing in particular */
+  memset (data, 0x55, sizeof (data));
+  memcpy (data, header, header_size);
+
+  prob = 0;
+  caps = typefind_data (data, sizeof (data), &prob);
+
+  fail_unless (caps != NULL);
+  media_type = gst_structure_get_name (gst_caps_get_structure (caps, 0));
+  fail_unless_equals_string (media_type, type);
+  fail_unless_equals_int (prob, GST_TYPE_FIND_MAXIMUM);
+  gst_caps_unref (caps);
+}
+
+GST_START_TEST (test_magic)
+{
+  const guint8 asf[] = { 0x30, 0x26, 0xb2, 0x75, 0x8e, 0x66, 0xcf, 0x11,
+    0xa6, 0xd9, 0x00, 0xaa, 0x00, 0x62, 0xce, 0x6c
+  };
+  const guint8 wav[] = "RIFF\x24\x08\x00\x00WAVEfmt ";
+  const guint8 xi[] = "Extended Instrument: ";
+
+  check_magic (asf, sizeof (asf), "video/x-ms-asf");
+  check_magic (wav, sizeof (wav) - 1, "audio/x-wav");
+  check_magic (xi, sizeof (xi) - 1, "audio/x-xi");
+}
+
+GST_END_TEST;
+
 static Suite *
 typefindfunctions_suite (void)
 {
@@ -494,6 +531,7 @@ typefindfunctions_suite (void)
   tcase_add_test (tc_chain, test_random_data);
   tcase_add_test (tc_chain, test_hls_m3u8);
   tcase_add_test (tc_chain, test_manifest_typefinding);
+  tcase_add_test (tc_chain, test_magic);
 
   return s;
 }
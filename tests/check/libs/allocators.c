@@ -26,7 +26,9 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/allocators/gstdmabuf.h>
+#include <gst/allocators/gstdmabufheap.h>
 #include <string.h>
+#include <unistd.h>
 
 #define FILE_SIZE 4096
 
@@ -60,6 +62,104 @@ GST_START_TEST (test_dmabuf)
 
 GST_END_TEST;
 
+GST_START_TEST (test_dmabuf_fence)
+{
+  char tmpfilename[] = "/tmp/dmabuf-test.XXXXXX";
+  int fd, fence[2];
+  GstMemory *mem, *sub;
+  GstAllocator *alloc;
+  GstMapInfo info;
+
+  fd = mkstemp (tmpfilename);
+  fail_unless (fd > 0);
+  fail_unless (g_unlink (tmpfilename) == 0);
+  fail_unless (ftruncate (fd, FILE_SIZE) == 0);
+
+  alloc = gst_dmabuf_allocator_new ();
+  mem = gst_dmabuf_allocator_alloc (alloc, fd, FILE_SIZE);
+  fail_unless (gst_dmabuf_memory_get_fence (mem) == -1);
+  fail_unless (gst_dmabuf_memory_wait (mem, GST_MAP_READ, 0));
+
+  /* a pipe behaves like a sync_file: readable once signalled */
+  fail_unless (pipe (fence) == 0);
+  gst_dmabuf_memory_set_fence (mem, fence[0]);
+  fail_unless (gst_dmabuf_memory_get_fence (mem) == fence[0]);
+
+  /* shared memory sees the fence of its parent */
+  sub = gst_memory_share (mem, 16, 16);
+  fail_unless (gst_dmabuf_memory_get_fence (sub) == fence[0]);
+  fail_if (gst_dmabuf_memory_wait (sub, GST_MAP_READ, 0));
+  fail_if (gst_dmabuf_memory_wait (mem, GST_MAP_READ, GST_MSECOND));
+
+  fail_unless (write (fence[1], "s", 1) == 1);
+  fail_unless (gst_dmabuf_memory_wait (sub, GST_MAP_READ, 0));
+  fail_unless (gst_dmabuf_memory_get_fence (mem) == -1);
+  gst_memory_unref (sub);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READWRITE));
+  gst_memory_unmap (mem, &info);
+
+  close (fence[1]);
+  gst_memory_unref (mem);
+  g_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_dmabuf_heap)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstBuffer *buf;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint i;
+
+  alloc = gst_dmabuf_heap_allocator_new (NULL);
+  if (alloc == NULL) {
+    GST_INFO ("no dmabuf heap or udmabuf available, skipping");
+    return;
+  }
+
+  gst_allocation_params_init (&params);
+  params.prefix = 16;
+  mem = gst_allocator_alloc (alloc, FILE_SIZE, &params);
+  fail_unless (mem != NULL);
+  fail_unless (gst_is_dmabuf_memory (mem));
+  fail_unless (gst_dmabuf_memory_get_fd (mem) >= 0);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READWRITE));
+  fail_unless (info.size == FILE_SIZE);
+  fail_unless (info.maxsize >= FILE_SIZE + 16);
+  for (i = 0; i < info.size; i++)
+    fail_unless (info.data[i] == 0);
+  memset (info.data, 0xaa, info.size);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+
+  /* buffer pools hand out dmabufs once the allocator is configured */
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, NULL, FILE_SIZE, 2, 0);
+  gst_buffer_pool_config_set_allocator (config, alloc, NULL);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_n_memory (buf) == 1);
+  fail_unless (gst_is_dmabuf_memory (gst_buffer_peek_memory (buf, 0)));
+  gst_buffer_unref (buf);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -68,6 +168,8 @@ allocators_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
+  tcase_add_test (tc_chain, test_dmabuf_fence);
+  tcase_add_test (tc_chain, test_dmabuf_heap);
 
   return s;
 }
@@ -29,6 +29,7 @@
 
 #include <gst/audio/audio.h>
 #include <string.h>
+#include <math.h>
 
 static GstBuffer *
 make_buffer (guint8 ** _data)
@@ -896,6 +897,57 @@ GST_START_TEST (test_multichannel_reorder)
 
 GST_END_TEST;
 
+GST_START_TEST (test_multichannel_reorder_widths)
+{
+  const GstAudioChannelPosition from[6] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_LFE1,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT
+  };
+  const GstAudioChannelPosition to[6] = {
+    GST_AUDIO_CHANNEL_POSITION_FRONT_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_CENTER,
+    GST_AUDIO_CHANNEL_POSITION_FRONT_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_LEFT,
+    GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT,
+    GST_AUDIO_CHANNEL_POSITION_LFE1
+  };
+  const gint out_order[6] = { 0, 2, 1, 4, 5, 3 };
+  const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_U8, GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S24,
+    GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F64
+  };
+  guint64 data64[2 * 6];
+  guint8 *data = (guint8 *) data64;
+  gint f, i, j, k;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+    gint bps = finfo->width / 8;
+
+    /* every byte of a sample holds the channel index, every frame the
+     * frame number in the upper nibble */
+    for (i = 0; i < 2; i++)
+      for (j = 0; j < 6; j++)
+        for (k = 0; k < bps; k++)
+          data[(i * 6 + j) * bps + k] = (i << 4) | j;
+
+    fail_unless (gst_audio_reorder_channels (data, 2 * 6 * bps, formats[f],
+            6, from, to));
+
+    for (i = 0; i < 2; i++)
+      for (j = 0; j < 6; j++)
+        for (k = 0; k < bps; k++)
+          fail_unless_equals_int (data[(i * 6 + j) * bps + k],
+              (i << 4) | out_order[j]);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_audio_format_s8)
 {
   GstAudioFormat fmt;
@@ -1491,6 +1543,262 @@ GST_START_TEST (test_audio_info_from_caps)
 
 GST_END_TEST;
 
+#define N_STREAMS 4
+#define N_IN_FRAMES 480
+
+GST_START_TEST (test_audio_resampler_multi_stream)
+{
+  GstAudioResampler *multi, *mono;
+  gfloat *in[N_STREAMS], *out[N_STREAMS], *mono_out;
+  gsize out_frames;
+  gint i, j;
+
+  /* N mono streams resampled as N non-interleaved channels must give the
+   * same result as N independent mono resamplers */
+  multi = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_IN |
+      GST_AUDIO_RESAMPLER_FLAG_NON_INTERLEAVED_OUT, GST_AUDIO_FORMAT_F32,
+      N_STREAMS, 48000, 16000, NULL);
+  fail_unless (multi != NULL);
+
+  out_frames = gst_audio_resampler_get_out_frames (multi, N_IN_FRAMES);
+  fail_unless (out_frames > 0);
+
+  for (i = 0; i < N_STREAMS; i++) {
+    in[i] = g_new (gfloat, N_IN_FRAMES);
+    out[i] = g_new0 (gfloat, out_frames);
+    for (j = 0; j < N_IN_FRAMES; j++)
+      in[i][j] = sin (2.0 * G_PI * (i + 1) * 440.0 * j / 48000.0);
+  }
+
+  gst_audio_resampler_resample (multi, (gpointer *) in, N_IN_FRAMES,
+      (gpointer *) out, out_frames);
+
+  mono_out = g_new0 (gfloat, out_frames);
+  for (i = 0; i < N_STREAMS; i++) {
+    mono = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_FLAG_NONE, GST_AUDIO_FORMAT_F32, 1, 48000, 16000,
+        NULL);
+    fail_unless_equals_int (gst_audio_resampler_get_out_frames (mono,
+            N_IN_FRAMES), out_frames);
+
+    gst_audio_resampler_resample (mono, (gpointer *) & in[i], N_IN_FRAMES,
+        (gpointer *) & mono_out, out_frames);
+    fail_unless (memcmp (mono_out, out[i], out_frames * sizeof (gfloat)) == 0);
+
+    gst_audio_resampler_free (mono);
+  }
+  g_free (mono_out);
+
+  for (i = 0; i < N_STREAMS; i++) {
+    g_free (in[i]);
+    g_free (out[i]);
+  }
+  gst_audio_resampler_free (multi);
+}
+
+GST_END_TEST;
+
+#undef N_STREAMS
+#undef N_IN_FRAMES
+
+static gfloat **
+new_mix_matrix (gint in_channels, gint out_channels, const gfloat * values)
+{
+  gfloat **matrix = g_new (gfloat *, in_channels);
+  gint i;
+
+  for (i = 0; i < in_channels; i++)
+    matrix[i] = g_memdup (values + i * out_channels,
+        out_channels * sizeof (gfloat));
+
+  return matrix;
+}
+
+GST_START_TEST (test_audio_channel_mixer_reorder)
+{
+  static const gfloat swap[] = { 0.0, 1.0, 1.0, 0.0 };
+  static const gfloat drop[] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+  GstAudioChannelMixer *mix;
+  gfloat in_f[] = { 1.0, 2.0, 3.0, 4.0 }, out_f[4];
+  gint16 in_l[] = { 1, 2 }, in_r[] = { 3, 4 }, in_c[] = { 5, 6 }, out_s[4];
+  gpointer in[3], out[1];
+
+  /* swapping channels, interleaved */
+  mix = gst_audio_channel_mixer_new_with_matrix (0, GST_AUDIO_FORMAT_F32, 2, 2,
+      new_mix_matrix (2, 2, swap));
+  in[0] = in_f;
+  out[0] = out_f;
+  gst_audio_channel_mixer_samples (mix, in, out, 2);
+  fail_unless_equals_float (out_f[0], 2.0);
+  fail_unless_equals_float (out_f[1], 1.0);
+  fail_unless_equals_float (out_f[2], 4.0);
+  fail_unless_equals_float (out_f[3], 3.0);
+  gst_audio_channel_mixer_free (mix);
+
+  /* dropping the last channel, planar to interleaved */
+  mix = gst_audio_channel_mixer_new_with_matrix
+      (GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN, GST_AUDIO_FORMAT_S16,
+      3, 2, new_mix_matrix (3, 2, drop));
+  in[0] = in_l;
+  in[1] = in_r;
+  in[2] = in_c;
+  out[0] = out_s;
+  gst_audio_channel_mixer_samples (mix, in, out, 2);
+  fail_unless_equals_int (out_s[0], 1);
+  fail_unless_equals_int (out_s[1], 3);
+  fail_unless_equals_int (out_s[2], 2);
+  fail_unless_equals_int (out_s[3], 4);
+  gst_audio_channel_mixer_free (mix);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_audio_channel_mixer_sparse)
+{
+  /* stereo to left, right and their average */
+  static const gfloat upmix[] = { 1.0, 0.0, 0.5, 0.0, 1.0, 0.5 };
+  GstAudioChannelMixer *mix;
+  gint16 in_s[] = { 100, 200, -100, 300 }, out_s[6];
+  gfloat in_f[] = { 1.0, 2.0, -1.0, 3.0 }, out_f[6];
+  gpointer in[1], out[1];
+
+  mix = gst_audio_channel_mixer_new_with_matrix (0, GST_AUDIO_FORMAT_S16, 2, 3,
+      new_mix_matrix (2, 3, upmix));
+  in[0] = in_s;
+  out[0] = out_s;
+  gst_audio_channel_mixer_samples (mix, in, out, 2);
+  fail_unless_equals_int (out_s[0], 100);
+  fail_unless_equals_int (out_s[1], 200);
+  fail_unless_equals_int (out_s[2], 150);
+  fail_unless_equals_int (out_s[3], -100);
+  fail_unless_equals_int (out_s[4], 300);
+  fail_unless_equals_int (out_s[5], 100);
+  gst_audio_channel_mixer_free (mix);
+
+  mix = gst_audio_channel_mixer_new_with_matrix (0, GST_AUDIO_FORMAT_F32, 2, 3,
+      new_mix_matrix (2, 3, upmix));
+  in[0] = in_f;
+  out[0] = out_f;
+  gst_audio_channel_mixer_samples (mix, in, out, 2);
+  fail_unless_equals_float (out_f[0], 1.0);
+  fail_unless_equals_float (out_f[1], 2.0);
+  fail_unless_equals_float (out_f[2], 1.5);
+  fail_unless_equals_float (out_f[3], -1.0);
+  fail_unless_equals_float (out_f[4], 3.0);
+  fail_unless_equals_float (out_f[5], 1.0);
+  gst_audio_channel_mixer_free (mix);
+}
+
+GST_END_TEST;
+
+#define N_FRAMES 10000
+#define N_PIECE 100
+
+GST_START_TEST (test_audio_converter_chunked)
+{
+  GstAudioConverter *whole, *pieces;
+  GstAudioInfo in_info, out_info;
+  gint16 *in;
+  gfloat *out_whole, *out_pieces;
+  gsize out_frames, done, i;
+  gpointer in_p[1], out_p[1];
+
+  /* converting everything at once goes through the chain block by block,
+   * which must be the same as converting small pieces */
+  gst_audio_info_set_format (&in_info, GST_AUDIO_FORMAT_S16, 44100, 2, NULL);
+  gst_audio_info_set_format (&out_info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+
+  whole = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+  pieces = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+  fail_unless (whole != NULL && pieces != NULL);
+
+  in = g_new (gint16, N_FRAMES * 2);
+  for (i = 0; i < N_FRAMES * 2; i++)
+    in[i] = 10000 * sin (2.0 * G_PI * 440.0 * (i / 2) / 44100.0);
+
+  out_frames = gst_audio_converter_get_out_frames (whole, N_FRAMES);
+  out_whole = g_new0 (gfloat, out_frames * 2);
+  out_pieces = g_new0 (gfloat, out_frames * 2);
+
+  in_p[0] = in;
+  out_p[0] = out_whole;
+  fail_unless (gst_audio_converter_samples (whole, 0, in_p, N_FRAMES, out_p,
+          out_frames));
+
+  for (i = 0, done = 0; i < N_FRAMES; i += N_PIECE) {
+    gsize piece_out = gst_audio_converter_get_out_frames (pieces, N_PIECE);
+
+    fail_unless (done + piece_out <= out_frames);
+    in_p[0] = in + i * 2;
+    out_p[0] = out_pieces + done * 2;
+    fail_unless (gst_audio_converter_samples (pieces, 0, in_p, N_PIECE, out_p,
+            piece_out));
+    done += piece_out;
+  }
+  fail_unless_equals_int (done, out_frames);
+
+  for (i = 0; i < out_frames * 2; i++)
+    fail_unless (fabs (out_whole[i] - out_pieces[i]) < 1e-6);
+
+  g_free (in);
+  g_free (out_whole);
+  g_free (out_pieces);
+  gst_audio_converter_free (whole);
+  gst_audio_converter_free (pieces);
+}
+
+GST_END_TEST;
+
+#undef N_FRAMES
+#undef N_PIECE
+
+static GstClockTime
+audio_clock_count_func (GstClock * clock, gpointer user_data)
+{
+  guint *calls = user_data;
+
+  *calls += 1;
+
+  return *calls * GST_MSECOND;
+}
+
+GST_START_TEST (test_audio_clock_refresh_interval)
+{
+  GstClock *clock;
+  GstClockTime t1, t2, t3;
+  guint calls = 0;
+
+  clock = gst_audio_clock_new ("test", audio_clock_count_func, &calls, NULL);
+
+  /* the time function is called on every read by default */
+  gst_clock_get_internal_time (clock);
+  gst_clock_get_internal_time (clock);
+  fail_unless_equals_int (calls, 2);
+
+  /* after the time function reported increasing times twice, reads in
+   * the refresh interval are interpolated */
+  g_object_set (clock, "refresh-interval", (guint64) (10 * GST_SECOND), NULL);
+  calls = 0;
+  t1 = gst_clock_get_internal_time (clock);
+  t2 = gst_clock_get_internal_time (clock);
+  fail_unless_equals_int (calls, 2);
+  t3 = gst_clock_get_internal_time (clock);
+  fail_unless_equals_int (calls, 2);
+  fail_unless (t2 >= t1);
+  fail_unless (t3 >= t2);
+  fail_unless (t3 - t2 < 10 * GST_SECOND);
+
+  /* a reset forgets the last sample */
+  gst_audio_clock_reset (GST_AUDIO_CLOCK (clock), 0);
+  gst_clock_get_internal_time (clock);
+  fail_unless_equals_int (calls, 3);
+
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1519,6 +1827,7 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_buffer_clip_samples_no_timestamp);
   tcase_add_test (tc_chain, test_multichannel_checks);
   tcase_add_test (tc_chain, test_multichannel_reorder);
+  tcase_add_test (tc_chain, test_multichannel_reorder_widths);
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
@@ -1526,6 +1835,11 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_stream_align_reverse);
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
+  tcase_add_test (tc_chain, test_audio_resampler_multi_stream);
+  tcase_add_test (tc_chain, test_audio_channel_mixer_reorder);
+  tcase_add_test (tc_chain, test_audio_channel_mixer_sparse);
+  tcase_add_test (tc_chain, test_audio_converter_chunked);
+  tcase_add_test (tc_chain, test_audio_clock_refresh_interval);
 
   return s;
 }
@@ -314,6 +314,172 @@ GST_START_TEST (audiodecoder_playback)
 GST_END_TEST;
 
 
+static GstPadProbeReturn
+_not_live_latency_probe (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  GstQuery *query = GST_PAD_PROBE_INFO_QUERY (info);
+
+  if (GST_QUERY_TYPE (query) != GST_QUERY_LATENCY)
+    return GST_PAD_PROBE_OK;
+
+  gst_query_set_latency (query, FALSE, 0, GST_CLOCK_TIME_NONE);
+  return GST_PAD_PROBE_HANDLED;
+}
+
+GST_START_TEST (audiodecoder_playback_aggregated)
+{
+  GstHarness *h;
+  GstElement *dec;
+  GstPad *sinkpad;
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint64 i, j;
+
+  /* collect output for more than 4 samples, so 5 samples per buffer */
+  dec = g_object_new (GST_AUDIO_DECODER_TESTER_TYPE, "min-latency",
+      gst_util_uint64_scale (9, GST_SECOND, 2 * 44100), NULL);
+  /* output is only aggregated when not live */
+  sinkpad = gst_element_get_static_pad (dec, "sink");
+  gst_pad_add_probe (sinkpad, GST_PAD_PROBE_TYPE_QUERY_UPSTREAM,
+      _not_live_latency_probe, NULL, NULL);
+  gst_object_unref (sinkpad);
+
+  h = gst_harness_new_full (dec, &srctemplate_default, "sink",
+      &sinktemplate_default, "src");
+  gst_harness_set_src_caps (h,
+      gst_caps_new_simple ("audio/x-test-custom",
+          "channels", G_TYPE_INT, 2, "rate", G_TYPE_INT, 44100, NULL));
+
+  for (i = 0; i < NUM_BUFFERS; i++)
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h), NUM_BUFFERS / 5);
+  for (i = 0; i < NUM_BUFFERS / 5; i++) {
+    buffer = gst_harness_pull (h);
+
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i * 5, GST_SECOND,
+            TEST_MSECS_PER_SAMPLE));
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buffer),
+        gst_util_uint64_scale_round (i * 5 + 5, GST_SECOND,
+            TEST_MSECS_PER_SAMPLE) - GST_BUFFER_PTS (buffer));
+
+    /* the decoded samples, in order */
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.size, 5 * 8);
+    for (j = 0; j < 5; j++)
+      fail_unless_equals_uint64 (((guint64 *) map.data)[j], i * 5 + j);
+    gst_buffer_unmap (buffer, &map);
+
+    gst_buffer_unref (buffer);
+  }
+
+  gst_object_unref (dec);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_allocate_output_buffer_pool)
+{
+  GstAudioDecoder *dec;
+  GstBufferPool *pool;
+  GstBuffer *buffer;
+
+  GstHarness *h = setup_audiodecodertester (NULL, NULL);
+
+  dec = GST_AUDIO_DECODER (h->element);
+
+  /* negotiate */
+  fail_unless (gst_harness_push (h, create_test_buffer (0)) == GST_FLOW_OK);
+  gst_buffer_unref (gst_harness_pull (h));
+
+  /* output buffers come from the base class pool, with the requested size */
+  buffer = gst_audio_decoder_allocate_output_buffer (dec, 8);
+  fail_unless (buffer->pool != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8);
+  pool = gst_object_ref (buffer->pool);
+  gst_buffer_unref (buffer);
+
+  /* smaller frames reuse the pool */
+  buffer = gst_audio_decoder_allocate_output_buffer (dec, 8 / 2);
+  fail_unless (buffer->pool == pool);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8 / 2);
+  gst_buffer_unref (buffer);
+
+  /* larger frames need a new pool */
+  buffer = gst_audio_decoder_allocate_output_buffer (dec, 8 * 8);
+  fail_unless (buffer->pool != NULL);
+  fail_unless (buffer->pool != pool);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8 * 8);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (pool);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audiodecoder_playback_output_queue)
+{
+  GstHarness *h;
+  GstElement *dec;
+  GstBuffer *buffer;
+  GstEvent *event;
+  GstStructure *stats;
+  guint64 i, decoded, pushed;
+
+  dec = g_object_new (GST_AUDIO_DECODER_TESTER_TYPE,
+      "output-queue-max-buffers", 2, NULL);
+  h = gst_harness_new_full (dec, &srctemplate_default, "sink",
+      &sinktemplate_default, "src");
+  gst_harness_set_src_caps (h,
+      gst_caps_new_simple ("audio/x-test-custom",
+          "channels", G_TYPE_INT, 2, "rate", G_TYPE_INT, 44100, NULL));
+
+  for (i = 0; i < NUM_BUFFERS; i++)
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* buffers come out of the output thread in order */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    GstMapInfo map;
+
+    buffer = gst_harness_pull (h);
+    fail_unless (buffer != NULL);
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (i, *(guint64 *) map.data);
+    gst_buffer_unmap (buffer, &map);
+
+    gst_buffer_unref (buffer);
+  }
+
+  /* followed by EOS */
+  do {
+    event = gst_harness_pull_event (h);
+    fail_unless (event != NULL);
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
+      gst_event_unref (event);
+      break;
+    }
+    gst_event_unref (event);
+  } while (TRUE);
+
+  g_object_get (dec, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "decoded", &decoded));
+  fail_unless (gst_structure_get_uint64 (stats, "pushed", &pushed));
+  fail_unless (decoded >= NUM_BUFFERS);
+  fail_unless_equals_uint64 (pushed, NUM_BUFFERS);
+  gst_structure_free (stats);
+
+  gst_object_unref (dec);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static void
 check_audiodecoder_negotiation (GstHarness * h)
 {
@@ -1144,6 +1310,9 @@ gst_audiodecoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, audiodecoder_playback);
+  tcase_add_test (tc, audiodecoder_playback_aggregated);
+  tcase_add_test (tc, audiodecoder_playback_output_queue);
+  tcase_add_test (tc, audiodecoder_allocate_output_buffer_pool);
   tcase_add_test (tc, audiodecoder_negotiation_with_buffer);
 
   tcase_add_test (tc, audiodecoder_negotiation_with_gap_event);
@@ -229,6 +229,110 @@ GST_START_TEST (audioencoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (audioencoder_allocate_output_buffer_pool)
+{
+  GstAudioEncoder *enc;
+  GstBufferPool *pool;
+  GstBuffer *buffer;
+
+  GstHarness *h = setup_audioencodertester ();
+
+  enc = GST_AUDIO_ENCODER (h->element);
+
+  /* negotiate */
+  fail_unless (gst_harness_push (h, create_test_buffer (0)) == GST_FLOW_OK);
+  gst_buffer_unref (gst_harness_pull (h));
+
+  /* output buffers come from the base class pool, with the requested size */
+  buffer = gst_audio_encoder_allocate_output_buffer (enc, 8);
+  fail_unless (buffer->pool != NULL);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8);
+  pool = gst_object_ref (buffer->pool);
+  gst_buffer_unref (buffer);
+
+  /* smaller frames reuse the pool */
+  buffer = gst_audio_encoder_allocate_output_buffer (enc, 8 / 2);
+  fail_unless (buffer->pool == pool);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8 / 2);
+  gst_buffer_unref (buffer);
+
+  /* larger frames need a new pool */
+  buffer = gst_audio_encoder_allocate_output_buffer (enc, 8 * 8);
+  fail_unless (buffer->pool != NULL);
+  fail_unless (buffer->pool != pool);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 8 * 8);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (pool);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (audioencoder_playback_output_queue)
+{
+  static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
+      GST_PAD_SINK,
+      GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("audio/x-test-custom")
+      );
+  static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC,
+      GST_PAD_ALWAYS,
+      GST_STATIC_CAPS ("audio/x-raw")
+      );
+  GstHarness *h;
+  GstElement *enc;
+  GstBuffer *buffer;
+  GstEvent *event;
+  guint64 i;
+
+  enc = g_object_new (GST_AUDIO_ENCODER_TESTER_TYPE,
+      "output-queue-max-time", 2 * GST_SECOND, NULL);
+  h = gst_harness_new_full (enc, &srctemplate, "sink", &sinktemplate, "src");
+  gst_harness_set_src_caps (h,
+      gst_caps_new_simple ("audio/x-raw",
+          "rate", G_TYPE_INT, TEST_AUDIO_RATE,
+          "channels", G_TYPE_INT, TEST_AUDIO_CHANNELS,
+          "format", G_TYPE_STRING, TEST_AUDIO_FORMAT,
+          "layout", G_TYPE_STRING, "interleaved", NULL));
+
+  for (i = 0; i < NUM_BUFFERS; i++)
+    fail_unless (gst_harness_push (h, create_test_buffer (i)) == GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* buffers come out of the output thread in order */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    GstMapInfo map;
+
+    buffer = gst_harness_pull (h);
+    fail_unless (buffer != NULL);
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (i, *(guint64 *) map.data);
+    fail_unless (GST_BUFFER_PTS (buffer) == i * GST_SECOND);
+    gst_buffer_unmap (buffer, &map);
+
+    gst_buffer_unref (buffer);
+  }
+
+  /* followed by EOS */
+  do {
+    event = gst_harness_pull_event (h);
+    fail_unless (event != NULL);
+    if (GST_EVENT_TYPE (event) == GST_EVENT_EOS) {
+      gst_event_unref (event);
+      break;
+    }
+    gst_event_unref (event);
+  } while (TRUE);
+
+  gst_object_unref (enc);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (audioencoder_flush_events)
 {
   guint i;
@@ -403,6 +507,8 @@ gst_audioencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, audioencoder_playback);
+  tcase_add_test (tc, audioencoder_playback_output_queue);
+  tcase_add_test (tc, audioencoder_allocate_output_buffer_pool);
 
   tcase_add_test (tc, audioencoder_tags_before_eos);
   tcase_add_test (tc, audioencoder_events_before_eos);
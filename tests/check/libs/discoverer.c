@@ -203,6 +203,54 @@ GST_START_TEST (test_disco_sync_reuse_timeout)
 
 GST_END_TEST;
 
+GST_START_TEST (test_disco_mode_tags)
+{
+  GError *err = NULL;
+  GstDiscoverer *dc;
+  GstDiscovererInfo *info;
+  GList *streams, *l;
+  gchar *uri, *path;
+
+  if (!have_ogg)
+    return;
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+  g_object_set (dc, "mode", GST_DISCOVERER_MODE_TAGS, NULL);
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  info = gst_discoverer_discover_uri (dc, uri, &err);
+  fail_unless (info != NULL);
+  fail_unless_equals_int (gst_discoverer_info_get_result (info),
+      GST_DISCOVERER_OK);
+  fail_unless (gst_discoverer_info_get_duration (info) > 0);
+
+  /* the streams are reported as they come out of the demuxer, without
+   * needing any decoder */
+  streams = gst_discoverer_info_get_stream_list (info);
+  fail_unless (streams != NULL);
+  for (l = streams; l; l = l->next) {
+    GstCaps *caps = gst_discoverer_stream_info_get_caps (l->data);
+    const gchar *name =
+        gst_structure_get_name (gst_caps_get_structure (caps, 0));
+
+    fail_if (g_str_has_suffix (name, "/x-raw"));
+    gst_caps_unref (caps);
+  }
+  gst_discoverer_stream_info_list_free (streams);
+
+  gst_discoverer_info_unref (info);
+  g_free (uri);
+  g_object_unref (dc);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_disco_missing_plugins)
 {
   const gchar *files[] = { "test.mkv", "test.mp3", "partialframe.mjpeg" };
@@ -321,6 +369,77 @@ GST_START_TEST (test_disco_async)
 
 GST_END_TEST;
 
+typedef struct _ParallelTestData
+{
+  GMainLoop *loop;
+  guint n_discovered;
+  gboolean finished;
+} ParallelTestData;
+
+static void
+parallel_discovered_cb (GstDiscoverer * discoverer,
+    GstDiscovererInfo * info, GError * err, ParallelTestData * data)
+{
+  fail_if (data->finished);
+  fail_unless (gst_discoverer_info_get_uri (info) != NULL);
+  data->n_discovered++;
+}
+
+static void
+parallel_finished_cb (GstDiscoverer * discoverer, ParallelTestData * data)
+{
+  data->finished = TRUE;
+  g_main_loop_quit (data->loop);
+}
+
+GST_START_TEST (test_disco_async_parallel)
+{
+  const gchar *files[] = { "theora-vorbis.ogg", "test.mp3",
+    "theora-vorbis.ogg", "test.mp3", "theora-vorbis.ogg"
+  };
+  ParallelTestData data = { 0, };
+  GstDiscoverer *dc;
+  GError *err = NULL;
+  guint i, max_parallel;
+
+  data.loop = g_main_loop_new (NULL, FALSE);
+
+  dc = gst_discoverer_new (30 * GST_SECOND, &err);
+  fail_unless (dc != NULL);
+  fail_unless (err == NULL);
+
+  g_object_set (dc, "max-parallel", 3, NULL);
+  g_object_get (dc, "max-parallel", &max_parallel, NULL);
+  fail_unless_equals_int (max_parallel, 3);
+
+  g_signal_connect (dc, "discovered", G_CALLBACK (parallel_discovered_cb),
+      &data);
+  g_signal_connect (dc, "finished", G_CALLBACK (parallel_finished_cb), &data);
+
+  gst_discoverer_start (dc);
+  for (i = 0; i < G_N_ELEMENTS (files); i++) {
+    gchar *path, *uri;
+
+    path = g_build_filename (GST_TEST_FILES_PATH, files[i], NULL);
+    uri = gst_filename_to_uri (path, &err);
+    fail_unless (err == NULL);
+    fail_unless (gst_discoverer_discover_uri_async (dc, uri) == TRUE);
+    g_free (uri);
+    g_free (path);
+  }
+
+  g_main_loop_run (data.loop);
+
+  fail_unless (data.finished);
+  fail_unless_equals_int (data.n_discovered, G_N_ELEMENTS (files));
+
+  gst_discoverer_stop (dc);
+  g_object_unref (dc);
+  g_main_loop_unref (data.loop);
+}
+
+GST_END_TEST;
+
 typedef struct _CustomContextData
 {
   GMutex lock;
@@ -390,10 +509,12 @@ discoverer_suite (void)
   tcase_add_test (tc_chain, test_disco_sync_reuse_ogg);
   tcase_add_test (tc_chain, test_disco_sync_reuse_mp3);
   tcase_add_test (tc_chain, test_disco_sync_reuse_timeout);
+  tcase_add_test (tc_chain, test_disco_mode_tags);
   tcase_add_test (tc_chain, test_disco_missing_plugins);
   tcase_add_test (tc_chain, test_disco_serializing);
   tcase_add_test (tc_chain, test_disco_async);
   tcase_add_test (tc_chain, test_disco_async_custom_context);
+  tcase_add_test (tc_chain, test_disco_async_parallel);
   return s;
 }
 
@@ -401,6 +401,47 @@ GST_START_TEST (test_f32_22050hz)
 
 GST_END_TEST;
 
+GST_START_TEST (test_f32_interleaved)
+{
+  gint i, c;
+  gfloat *in, *chan;
+  GstFFTF32Complex *out, *ref;
+  GstFFTF32 *ctx;
+
+  in = g_new (gfloat, 2048 * 3);
+  chan = g_new (gfloat, 2048);
+  out = g_new (GstFFTF32Complex, 1025 * 3);
+  ref = g_new (GstFFTF32Complex, 1025);
+  ctx = gst_fft_f32_new (2048, FALSE);
+
+  for (i = 0; i < 2048; i++) {
+    in[i * 3 + 0] = 1.0;
+    in[i * 3 + 1] = (i % 2) ? -1.0 : 1.0;
+    in[i * 3 + 2] = sin (2.0 * G_PI * i / 64.0);
+  }
+
+  gst_fft_f32_fft_interleaved (ctx, in, 3, out);
+
+  for (c = 0; c < 3; c++) {
+    for (i = 0; i < 2048; i++)
+      chan[i] = in[i * 3 + c];
+    gst_fft_f32_fft (ctx, chan, ref);
+
+    for (i = 0; i < 1025; i++) {
+      fail_unless_equals_float (out[c * 1025 + i].r, ref[i].r);
+      fail_unless_equals_float (out[c * 1025 + i].i, ref[i].i);
+    }
+  }
+
+  gst_fft_f32_free (ctx);
+  g_free (in);
+  g_free (chan);
+  g_free (out);
+  g_free (ref);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_f64_0hz)
 {
   gint i;
@@ -538,6 +579,7 @@ fft_suite (void)
   tcase_add_test (tc_chain, test_f32_0hz);
   tcase_add_test (tc_chain, test_f32_11025hz);
   tcase_add_test (tc_chain, test_f32_22050hz);
+  tcase_add_test (tc_chain, test_f32_interleaved);
   tcase_add_test (tc_chain, test_f64_0hz);
   tcase_add_test (tc_chain, test_f64_11025hz);
   tcase_add_test (tc_chain, test_f64_22050hz);
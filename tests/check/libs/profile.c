@@ -434,9 +434,28 @@ GST_START_TEST (test_loading_profile)
 
   GST_DEBUG ("Loading target from '%s'", profile_file_name);
   target = gst_encoding_target_load_from_file (profile_file_name, NULL);
-  g_free (profile_file_name);
   fail_unless (target != NULL);
   test_individual_target (target);
+
+  /* Loading again gives a separate copy, modifying one target doesn't
+   * change further loads */
+  {
+    GstEncodingTarget *target2;
+    GstCaps *extracaps;
+
+    extracaps = gst_caps_new_empty_simple ("audio/x-extra");
+    fail_unless (gst_encoding_target_add_profile (target, (GstEncodingProfile *)
+            gst_encoding_audio_profile_new (extracaps, NULL, NULL, 0)));
+    gst_caps_unref (extracaps);
+    target2 = gst_encoding_target_load_from_file (profile_file_name, NULL);
+    fail_unless (target2 != NULL);
+    fail_unless (target2 != target);
+    fail_if (gst_encoding_target_get_profiles (target2)->data ==
+        gst_encoding_target_get_profiles (target)->data);
+    test_individual_target (target2);
+    gst_encoding_target_unref (target2);
+  }
+  g_free (profile_file_name);
   gst_encoding_target_unref (target);
 
   /* Test getting the profiles directly
@@ -201,6 +201,120 @@ GST_START_TEST (test_rtp_buffer_validate_padding)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtp_buffer_index_extensions)
+{
+  GstBuffer *buf;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstRTPExtensionIndex index;
+  guint8 misc_data[4] = { 1, 2, 3, 4 };
+  gpointer pointer;
+  guint size;
+
+  /* one byte headers */
+  buf = gst_rtp_buffer_new_allocate (20, 0, 0);
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+
+  fail_if (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_if (gst_rtp_extension_index_get (&index, 5, &pointer, &size));
+
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 5,
+          misc_data, 2));
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 5,
+          misc_data, 4));
+  fail_unless (gst_rtp_buffer_add_extension_onebyte_header (&rtp, 6,
+          misc_data + 1, 3));
+
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_unless (gst_rtp_extension_index_get (&index, 5, &pointer, &size));
+  fail_unless_equals_int (size, 2);
+  fail_unless (memcmp (pointer, misc_data, 2) == 0);
+  fail_unless (gst_rtp_extension_index_get (&index, 6, &pointer, &size));
+  fail_unless_equals_int (size, 3);
+  fail_unless (memcmp (pointer, misc_data + 1, 3) == 0);
+  fail_if (gst_rtp_extension_index_get (&index, 2, NULL, NULL));
+
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+
+  /* two bytes headers */
+  buf = gst_rtp_buffer_new_allocate (20, 0, 0);
+  gst_rtp_buffer_map (buf, GST_MAP_READWRITE, &rtp);
+
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 0, 5,
+          misc_data, 2));
+  fail_unless (gst_rtp_buffer_add_extension_twobytes_header (&rtp, 0, 200,
+          misc_data, 4));
+
+  fail_unless (gst_rtp_buffer_index_extensions (&rtp, &index));
+  fail_unless (gst_rtp_extension_index_get (&index, 5, &pointer, &size));
+  fail_unless_equals_int (size, 2);
+  fail_unless (memcmp (pointer, misc_data, 2) == 0);
+  fail_unless (gst_rtp_extension_index_get (&index, 200, &pointer, &size));
+  fail_unless_equals_int (size, 4);
+  fail_unless (memcmp (pointer, misc_data, 4) == 0);
+  fail_if (gst_rtp_extension_index_get (&index, 6, NULL, NULL));
+
+  gst_rtp_buffer_unmap (&rtp);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtp_buffer_peek_header)
+{
+  GstBuffer *buf;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint8 pt;
+  guint16 seqnum;
+  guint32 timestamp, ssrc;
+  gboolean marker;
+  guint header_len;
+  guint8 corrupt_rtp_packet[16] = {
+    0x90, 0x7a, 0xbf, 0x28, 0x3a, 0x8a, 0x0a, 0xf4, 0x69, 0x6b, 0x76, 0xc0,
+    0x21, 0xe0, 0xe0, 0x60
+  };
+
+  buf = gst_rtp_buffer_new_allocate (16, 0, 2);
+  fail_unless (gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp));
+  gst_rtp_buffer_set_payload_type (&rtp, 96);
+  gst_rtp_buffer_set_seq (&rtp, 0xabcd);
+  gst_rtp_buffer_set_timestamp (&rtp, 0x12345678);
+  gst_rtp_buffer_set_ssrc (&rtp, 0xdeadbeef);
+  gst_rtp_buffer_set_marker (&rtp, TRUE);
+  fail_unless (gst_rtp_buffer_set_extension_data (&rtp, 0xbede, 1));
+  gst_rtp_buffer_unmap (&rtp);
+
+  fail_unless (gst_rtp_buffer_peek_header (buf, &pt, &seqnum, &timestamp,
+          &ssrc, &marker, &header_len));
+  fail_unless_equals_int (pt, 96);
+  fail_unless_equals_int (seqnum, 0xabcd);
+  fail_unless_equals_uint64 (timestamp, 0x12345678);
+  fail_unless_equals_uint64 (ssrc, 0xdeadbeef);
+  fail_unless (marker);
+  fail_unless_equals_int (header_len, 12 + 2 * 4 + 4 + 4);
+
+  /* all the fields are optional */
+  fail_unless (gst_rtp_buffer_peek_header (buf, NULL, NULL, NULL, NULL, NULL,
+          NULL));
+  gst_buffer_unref (buf);
+
+  /* an extension longer than the packet */
+  buf = gst_buffer_new_and_alloc (sizeof (corrupt_rtp_packet));
+  gst_buffer_fill (buf, 0, corrupt_rtp_packet, sizeof (corrupt_rtp_packet));
+  fail_if (gst_rtp_buffer_peek_header (buf, NULL, &seqnum, NULL, NULL, NULL,
+          NULL));
+  gst_buffer_unref (buf);
+
+  /* too short */
+  buf = gst_buffer_new_and_alloc (8);
+  gst_buffer_fill (buf, 0, corrupt_rtp_packet, 8);
+  fail_if (gst_rtp_buffer_peek_header (buf, NULL, &seqnum, NULL, NULL, NULL,
+          NULL));
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 #if 0
 GST_START_TEST (test_rtp_buffer_list)
 {
@@ -793,6 +907,59 @@ GST_START_TEST (test_rtcp_buffer)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtcp_buffer_add_next)
+{
+  guint8 data[84];
+  GstBuffer *buf;
+  GstRTCPPacket packet, packets[4];
+  GstRTCPBuffer rtcp = { NULL, };
+
+  /* build into memory we provide, starting empty */
+  buf = gst_buffer_new_wrapped_full (0, data, sizeof (data), 0, 0, NULL,
+      NULL);
+  gst_rtcp_buffer_map (buf, GST_MAP_READWRITE, &rtcp);
+
+  fail_unless (gst_rtcp_buffer_add_packet (&rtcp, GST_RTCP_TYPE_RR, &packet));
+  gst_rtcp_packet_rr_set_ssrc (&packet, 0x44556677);
+  fail_unless (gst_rtcp_packet_add_rb (&packet, 0x11111111, 0, 0, 0, 0, 0,
+          0));
+  fail_unless_equals_int (gst_rtcp_packet_get_length (&packet), 7);
+
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_SDES));
+  fail_unless (gst_rtcp_packet_sdes_add_item (&packet, 0x44556677));
+  fail_unless (gst_rtcp_packet_sdes_add_entry (&packet, GST_RTCP_SDES_CNAME,
+          sizeof ("test@foo.bar"), (guint8 *) "test@foo.bar"));
+
+  fail_unless (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_BYE));
+  fail_unless (gst_rtcp_packet_bye_add_ssrc (&packet, 0x44556677));
+
+  /* not enough room left for an SR */
+  fail_if (gst_rtcp_packet_add_next (&packet, GST_RTCP_TYPE_SR));
+
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets,
+          G_N_ELEMENTS (packets)), 3);
+  fail_unless (gst_rtcp_packet_get_type (&packets[0]) == GST_RTCP_TYPE_RR);
+  fail_unless (gst_rtcp_packet_get_type (&packets[1]) == GST_RTCP_TYPE_SDES);
+  fail_unless (gst_rtcp_packet_get_type (&packets[2]) == GST_RTCP_TYPE_BYE);
+  fail_unless_equals_int (gst_rtcp_packet_get_rb_count (&packets[0]), 1);
+  fail_unless_equals_int (gst_rtcp_packet_bye_get_nth_ssrc (&packets[2], 0),
+      0x44556677);
+
+  /* starting from a packet that is not the last one still appends */
+  fail_unless (gst_rtcp_packet_add_next (&packets[0], GST_RTCP_TYPE_BYE));
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets, 2), 2);
+  fail_unless_equals_int (gst_rtcp_buffer_get_packets (&rtcp, packets,
+          G_N_ELEMENTS (packets)), 4);
+  fail_unless (gst_rtcp_packet_get_type (&packets[3]) == GST_RTCP_TYPE_BYE);
+
+  gst_rtcp_buffer_unmap (&rtcp);
+  fail_unless (gst_buffer_get_size (buf) <= sizeof (data));
+  fail_unless (gst_rtcp_buffer_validate (buf));
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtcp_reduced_buffer)
 {
   GstBuffer *buf;
@@ -1908,11 +2075,14 @@ rtp_suite (void)
   tcase_add_test (tc_chain, test_rtp_buffer);
   tcase_add_test (tc_chain, test_rtp_buffer_validate_corrupt);
   tcase_add_test (tc_chain, test_rtp_buffer_validate_padding);
+  tcase_add_test (tc_chain, test_rtp_buffer_peek_header);
+  tcase_add_test (tc_chain, test_rtp_buffer_index_extensions);
   tcase_add_test (tc_chain, test_rtp_buffer_set_extension_data);
   //tcase_add_test (tc_chain, test_rtp_buffer_list_set_extension);
   tcase_add_test (tc_chain, test_rtp_seqnum_compare);
 
   tcase_add_test (tc_chain, test_rtcp_buffer);
+  tcase_add_test (tc_chain, test_rtcp_buffer_add_next);
   tcase_add_test (tc_chain, test_rtcp_reduced_buffer);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding);
   tcase_add_test (tc_chain, test_rtcp_validate_with_padding_wrong_padlength);
@@ -1540,6 +1540,79 @@ GST_START_TEST (rtp_base_depayload_flow_return_push_list_func)
 
 GST_END_TEST;
 
+static guint n_lists;
+
+static GstFlowReturn
+count_list_chain (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  guint i;
+
+  n_lists++;
+  for (i = 0; i < gst_buffer_list_length (list); i++)
+    buffers = g_list_append (buffers,
+        gst_buffer_ref (gst_buffer_list_get (list, i)));
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+static void
+push_rtp_buffer_list (State * state, guint n, guint16 seq)
+{
+  GstBufferList *list = gst_buffer_list_new ();
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    GstBuffer *buf = gst_rtp_buffer_new_allocate (0, 0, 0);
+
+    rtp_buffer_set (buf, "pts", i * GST_SECOND, "rtptime",
+        G_GUINT64_CONSTANT (0x1234) + i * DEFAULT_CLOCK_RATE, "seq", seq + i,
+        NULL);
+    gst_buffer_list_add (list, buf);
+  }
+
+  fail_unless_equals_int (gst_pad_push_list (state->srcpad, list),
+      GST_FLOW_OK);
+}
+
+GST_START_TEST (rtp_base_depayload_list_output_test)
+{
+  State *state;
+
+  state = create_depayloader ("application/x-rtp", NULL);
+  gst_pad_set_chain_list_function (state->sinkpad, count_list_chain);
+  n_lists = 0;
+
+  set_state (state, GST_STATE_PLAYING);
+
+  /* by default every output buffer is pushed by itself */
+  push_rtp_buffer_list (state, 3, 0x4242);
+  validate_buffers_received (3);
+  fail_unless_equals_int (n_lists, 0);
+
+  /* all the output of the list is pushed at once */
+  gst_rtp_base_depayload_set_list_output_enabled (GST_RTP_BASE_DEPAYLOAD
+      (state->element), TRUE);
+  push_rtp_buffer_list (state, 3, 0x4245);
+  validate_buffers_received (6);
+  fail_unless_equals_int (n_lists, 1);
+  validate_buffer (3, "pts", 0 * GST_SECOND, NULL);
+  validate_buffer (5, "pts", 2 * GST_SECOND, NULL);
+
+  /* GstRtpDummyDepay pushes lists itself */
+  GST_RTP_DUMMY_DEPAY (state->element)->push_method =
+      GST_RTP_DUMMY_USE_PUSH_LIST_FUNC;
+  push_rtp_buffer_list (state, 3, 0x4248);
+  validate_buffers_received (9);
+  fail_unless_equals_int (n_lists, 2);
+
+  set_state (state, GST_STATE_NULL);
+
+  destroy_depayloader (state);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtp_basepayloading_suite (void)
 {
@@ -1577,6 +1650,8 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_depayload_flow_return_push_func);
   tcase_add_test (tc_chain, rtp_base_depayload_flow_return_push_list_func);
 
+  tcase_add_test (tc_chain, rtp_base_depayload_list_output_test);
+
   return s;
 }
 
@@ -21,6 +21,8 @@
 #include "config.h"
 #endif
 
+#include <string.h>
+
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/check/gstharness.h>
@@ -2016,6 +2018,56 @@ GST_START_TEST (rtp_base_payload_property_twcc_ext_id_test)
 GST_END_TEST;
 
 
+GST_START_TEST (rtp_base_payload_output_buffer_with_payload_test)
+{
+  GstRtpDummyPay *pay;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *input, *buffer, *header;
+  GstMemory *mem;
+  guint8 data[100];
+  guint i;
+
+  pay = rtp_dummy_pay_new ();
+
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = i;
+  input = gst_buffer_new_wrapped (g_memdup (data, sizeof (data)),
+      sizeof (data));
+
+  buffer =
+      gst_rtp_base_payload_allocate_output_buffer_with_payload
+      (GST_RTP_BASE_PAYLOAD (pay), input, 10, 50, 2);
+
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+  fail_unless_equals_int (gst_rtp_buffer_get_version (&rtp), 2);
+  fail_unless_equals_int (gst_rtp_buffer_get_csrc_count (&rtp), 2);
+  fail_unless_equals_int (gst_rtp_buffer_get_payload_len (&rtp), 50);
+  fail_unless (memcmp (gst_rtp_buffer_get_payload (&rtp), data + 10, 50) == 0);
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* the payload is not copied */
+  mem = gst_buffer_peek_memory (input, 0);
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 2);
+  fail_unless (gst_buffer_peek_memory (buffer, 1)->parent == mem ||
+      gst_buffer_peek_memory (buffer, 1) == mem);
+
+  /* the header comes back to the pool without the payload */
+  header = buffer;
+  gst_buffer_unref (buffer);
+  buffer =
+      gst_rtp_base_payload_allocate_output_buffer (GST_RTP_BASE_PAYLOAD
+      (pay), 0, 0, 0);
+  fail_unless (buffer == header);
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 1);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 12);
+  gst_buffer_unref (buffer);
+
+  gst_buffer_unref (input);
+  g_object_unref (pay);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtp_basepayloading_suite (void)
 {
@@ -2027,6 +2079,7 @@ rtp_basepayloading_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, rtp_base_payload_buffer_test);
   tcase_add_test (tc_chain, rtp_base_payload_buffer_list_test);
+  tcase_add_test (tc_chain, rtp_base_payload_output_buffer_with_payload_test);
 
   tcase_add_test (tc_chain, rtp_base_payload_normal_rtptime_test);
   tcase_add_test (tc_chain, rtp_base_payload_perfect_rtptime_test);
@@ -1000,6 +1000,57 @@ GST_START_TEST (test_rtsp_message_auth_credentials_boxed)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtsp_transport_parse)
+{
+  GstRTSPTransport *transport;
+  GstRTSPResult res;
+
+  gst_rtsp_transport_new (&transport);
+
+  res = gst_rtsp_transport_parse ("RTP/AVP/TCP;unicast;interleaved=2-3;"
+      "mode=\"PLAY\";ssrc=1a2B3c4D;", transport);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_int (transport->trans, GST_RTSP_TRANS_RTP);
+  fail_unless_equals_int (transport->profile, GST_RTSP_PROFILE_AVP);
+  fail_unless_equals_int (transport->lower_transport,
+      GST_RTSP_LOWER_TRANS_TCP);
+  fail_unless_equals_int (transport->interleaved.min, 2);
+  fail_unless_equals_int (transport->interleaved.max, 3);
+  fail_unless (transport->mode_play);
+  fail_unless_equals_int (transport->ssrc, 0x1a2b3c4d);
+
+  res = gst_rtsp_transport_parse ("RTP/AVP;multicast;destination=224.1.2.3;"
+      "port=5000-5001;ttl=16", transport);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_int (transport->lower_transport,
+      GST_RTSP_LOWER_TRANS_UDP_MCAST);
+  fail_unless_equals_string (transport->destination, "224.1.2.3");
+  fail_unless_equals_int (transport->port.min, 5000);
+  fail_unless_equals_int (transport->port.max, 5001);
+  fail_unless_equals_int (transport->ttl, 16);
+
+  res = gst_rtsp_transport_parse ("x-real-rdt/udp;client_port=6970",
+      transport);
+  fail_unless_equals_int (res, GST_RTSP_OK);
+  fail_unless_equals_int (transport->trans, GST_RTSP_TRANS_RDT);
+  fail_unless_equals_int (transport->lower_transport,
+      GST_RTSP_LOWER_TRANS_UDP);
+  fail_unless_equals_int (transport->client_port.min, 6970);
+
+  res = gst_rtsp_transport_parse ("", transport);
+  fail_unless_equals_int (res, GST_RTSP_EINVAL);
+  res = gst_rtsp_transport_parse ("RTP;unicast", transport);
+  fail_unless_equals_int (res, GST_RTSP_EINVAL);
+  res = gst_rtsp_transport_parse ("RTP/AVP;ttl=1;ttl=2", transport);
+  fail_unless_equals_int (res, GST_RTSP_EINVAL);
+  res = gst_rtsp_transport_parse ("FOO/AVP", transport);
+  fail_unless_equals_int (res, GST_RTSP_ERROR);
+
+  gst_rtsp_transport_free (transport);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtsp_suite (void)
 {
@@ -1019,6 +1070,7 @@ rtsp_suite (void)
   tcase_add_test (tc_chain, test_rtsp_message);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials);
   tcase_add_test (tc_chain, test_rtsp_message_auth_credentials_boxed);
+  tcase_add_test (tc_chain, test_rtsp_transport_parse);
 
   return s;
 }
@@ -839,6 +839,93 @@ GST_START_TEST (test_rtspconnection_backlog)
 
 GST_END_TEST;
 
+static guint backlog_full_count;
+
+static GstRTSPResult
+send_backlog_full (GstRTSPWatch * watch, gpointer user_data)
+{
+  backlog_full_count++;
+  return GST_RTSP_OK;
+}
+
+GST_START_TEST (test_rtspconnection_backlog_drop_oldest)
+{
+  GSocketConnection *conn1 = NULL;
+  GSocketConnection *conn2 = NULL;
+  GSocket *sock;
+  GstRTSPConnection *rtsp_conn = NULL;
+  GstRTSPWatch *watch;
+  GstRTSPWatchFuncs funcs = watch_funcs;
+  GstRTSPMessage message = { 0 };
+  guint i;
+
+  create_connection (&conn1, &conn2);
+  sock = g_socket_connection_get_socket (conn1);
+  fail_unless (sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (sock, "127.0.0.1",
+          4444, NULL, &rtsp_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_conn != NULL);
+
+  funcs.send_backlog_full = send_backlog_full;
+  watch = gst_rtsp_watch_new (rtsp_conn, &funcs, NULL, NULL);
+  fail_unless (watch != NULL);
+  fail_unless (gst_rtsp_watch_attach (watch, NULL) > 0);
+  g_source_unref ((GSource *) watch);
+
+  gst_rtsp_watch_set_send_backlog (watch, 4096, 0);
+  gst_rtsp_watch_set_send_backlog_policy (watch,
+      GST_RTSP_WATCH_BACKLOG_POLICY_DROP_OLDEST_DATA);
+  fail_unless (gst_rtsp_watch_get_send_backlog_policy (watch) ==
+      GST_RTSP_WATCH_BACKLOG_POLICY_DROP_OLDEST_DATA);
+
+  message_sent_count = 0;
+  backlog_full_count = 0;
+
+  /* nobody reads the other end: once the tcp window is full, data gets
+   * queued and then the oldest queued data gets dropped instead of
+   * failing */
+  for (i = 0; i < 4096; i++) {
+    guint id = 0;
+
+    fail_unless (gst_rtsp_message_init_data (&message, 0) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_take_body (&message, g_malloc0 (1024),
+            1024) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_watch_send_message (watch, &message,
+            &id) == GST_RTSP_OK);
+    gst_rtsp_message_unset (&message);
+  }
+
+  fail_unless (backlog_full_count > 0);
+  /* dropped messages are reported as sent */
+  fail_unless (message_sent_count > 0);
+
+  /* control messages are still queued */
+  fail_unless (gst_rtsp_message_init_response (&message, GST_RTSP_STS_OK,
+          NULL, NULL) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_watch_send_message (watch, &message,
+          NULL) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&message);
+
+  /* and refused with the default policy */
+  gst_rtsp_watch_set_send_backlog_policy (watch,
+      GST_RTSP_WATCH_BACKLOG_POLICY_FAIL);
+  fail_unless (gst_rtsp_message_init_data (&message, 0) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_take_body (&message, g_malloc0 (1024),
+          1024) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_watch_send_message (watch, &message,
+          NULL) == GST_RTSP_ENOMEM);
+  gst_rtsp_message_unset (&message);
+
+  g_source_destroy ((GSource *) watch);
+  fail_unless (gst_rtsp_connection_close (rtsp_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_conn) == GST_RTSP_OK);
+  g_object_unref (conn1);
+  g_object_unref (conn2);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_rtspconnection_ip)
 {
   GstRTSPConnection *conn = NULL;
@@ -928,6 +1015,89 @@ GST_START_TEST (test_rtspconnection_send_receive_content_length)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtspconnection_receive_pipelined)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GSocket *output_sock;
+  GstRTSPConnection *rtsp_output_conn;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPMessage messages[3] = { {0}, };
+  GstRTSPMessage *msg;
+  GstRTSPEvent event;
+  guint8 *data;
+  guint size;
+  gchar *value;
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+  output_sock = g_socket_connection_get_socket (output_conn);
+  fail_unless (output_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_create_from_socket (output_sock, "127.0.0.1",
+          4444, NULL, &rtsp_output_conn) == GST_RTSP_OK);
+
+  /* send several messages in one write so that they are received together */
+  fail_unless (gst_rtsp_message_init_request (&messages[0],
+          GST_RTSP_GET_PARAMETER, "rtsp://example.com/") == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_init_data (&messages[1], 1) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_take_body (&messages[1],
+          (guint8 *) g_strdup ("data"), 4) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_init_request (&messages[2],
+          GST_RTSP_OPTIONS, "rtsp://example.com/") == GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_add_header (&messages[2],
+          GST_RTSP_HDR_USER_AGENT, "test") == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_send_messages_usec (rtsp_output_conn,
+          messages, 3, 0) == GST_RTSP_OK);
+  gst_rtsp_message_unset (&messages[0]);
+  gst_rtsp_message_unset (&messages[1]);
+  gst_rtsp_message_unset (&messages[2]);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_REQUEST);
+  fail_unless (msg->type_data.request.method == GST_RTSP_GET_PARAMETER);
+  fail_unless (gst_rtsp_message_unset (msg) == GST_RTSP_OK);
+
+  /* what was already read counts as readable */
+  fail_unless (gst_rtsp_connection_poll_usec (rtsp_input_conn,
+          GST_RTSP_EV_READ, &event, G_USEC_PER_SEC) == GST_RTSP_OK);
+  fail_unless (event & GST_RTSP_EV_READ);
+
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+  fail_unless (gst_rtsp_message_get_body (msg, &data, &size) == GST_RTSP_OK);
+  /* the received body has a trailing '\0' */
+  fail_unless_equals_int (size, 5);
+  fail_unless_equals_string ((gchar *) data, "data");
+  fail_unless (gst_rtsp_message_unset (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_REQUEST);
+  fail_unless (msg->type_data.request.method == GST_RTSP_OPTIONS);
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_USER_AGENT,
+          &value, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (value, "test");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_close (rtsp_output_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_output_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspconnection_suite (void)
 {
@@ -942,8 +1112,10 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_connect);
   tcase_add_test (tc_chain, test_rtspconnection_poll);
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
+  tcase_add_test (tc_chain, test_rtspconnection_backlog_drop_oldest);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_content_length);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_pipelined);
 
   return s;
 }
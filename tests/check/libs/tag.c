@@ -858,6 +858,53 @@ GST_START_TEST (test_id3v2_string_list_utf16)
 
 GST_END_TEST;
 
+GST_START_TEST (test_id3v2_filtered)
+{
+  const guint8 id3v2[] = {
+    0x49, 0x44, 0x33, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x31,
+    0x54, 0x49, 0x54, 0x32, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00,
+    0x00, 0x54, 0x69, 0x74, 0x6c, 0x65,
+    0x54, 0x50, 0x45, 0x31, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00,
+    0x00, 0x47, 0x65, 0x6f, 0x72, 0x67, 0x65,
+    0x54, 0x41, 0x4c, 0x42, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00,
+    0x00, 0x41, 0x6c, 0x62, 0x75, 0x6d
+  };
+  const gchar *wanted[] = { GST_TAG_TITLE, GST_TAG_ARTIST, NULL };
+  const gchar *images[] = { GST_TAG_IMAGE, NULL };
+  GstTagList *tags;
+  GstBuffer *buf;
+  gchar *str = NULL;
+
+  buf = gst_buffer_new_allocate (NULL, sizeof (id3v2), NULL);
+  gst_buffer_fill (buf, 0, id3v2, sizeof (id3v2));
+
+  tags = gst_tag_list_from_id3v2_tag (buf);
+  fail_if (tags == NULL, "Failed to parse ID3 tag");
+  fail_unless_equals_int (gst_tag_list_n_tags (tags), 3);
+  gst_tag_list_unref (tags);
+
+  tags = gst_tag_list_from_id3v2_tag_filtered (buf, wanted);
+  fail_if (tags == NULL, "Failed to parse ID3 tag");
+  GST_LOG ("tags: %" GST_PTR_FORMAT, tags);
+  fail_unless_equals_int (gst_tag_list_n_tags (tags), 2);
+  fail_unless (gst_tag_list_get_string (tags, GST_TAG_TITLE, &str));
+  fail_unless_equals_string (str, "Title");
+  g_free (str);
+  fail_unless (gst_tag_list_get_string (tags, GST_TAG_ARTIST, &str));
+  fail_unless_equals_string (str, "George");
+  g_free (str);
+  fail_if (gst_tag_list_get_tag_size (tags, GST_TAG_ALBUM) > 0);
+  gst_tag_list_unref (tags);
+
+  /* nothing wanted is in there */
+  tags = gst_tag_list_from_id3v2_tag_filtered (buf, images);
+  fail_unless (tags == NULL);
+
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_language_utils)
 {
   gchar **lang_codes, **c;
@@ -1979,6 +2026,7 @@ tag_suite (void)
   tcase_add_test (tc_chain, test_id3v2_priv_tag);
   tcase_add_test (tc_chain, test_id3v2_extended_header);
   tcase_add_test (tc_chain, test_id3v2_string_list_utf16);
+  tcase_add_test (tc_chain, test_id3v2_filtered);
   tcase_add_test (tc_chain, test_language_utils);
   tcase_add_test (tc_chain, test_license_utils);
   tcase_add_test (tc_chain, test_xmp_formatting);
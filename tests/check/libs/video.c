@@ -1084,6 +1084,59 @@ GST_START_TEST (test_convert_frame)
 
 GST_END_TEST;
 
+GST_START_TEST (test_convert_frame_raw)
+{
+  GstVideoInfo vinfo, out_info;
+  GstCaps *from_caps, *to_caps;
+  GstBuffer *from_buffer;
+  GstSample *from_sample, *to_sample;
+  GError *error = NULL;
+  GstMapInfo map;
+  gint i;
+
+  fail_unless (gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_xRGB, 640,
+          480));
+  from_buffer = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&vinfo));
+  gst_buffer_memset (from_buffer, 0, 0x80, GST_VIDEO_INFO_SIZE (&vinfo));
+  GST_BUFFER_PTS (from_buffer) = 5 * GST_SECOND;
+  from_caps = gst_video_info_to_caps (&vinfo);
+  from_sample = gst_sample_new (from_buffer, from_caps, NULL, NULL);
+
+  /* only the format and size, the rest is taken from the input */
+  to_caps = gst_caps_from_string ("video/x-raw, format=(string)I420, "
+      "width=(int)320, height=(int)240");
+
+  /* twice, the second conversion reuses the converter */
+  for (i = 0; i < 2; i++) {
+    to_sample = gst_video_convert_sample (from_sample, to_caps,
+        GST_CLOCK_TIME_NONE, &error);
+    fail_unless (to_sample != NULL);
+    fail_unless (error == NULL);
+
+    fail_unless (gst_video_info_from_caps (&out_info,
+            gst_sample_get_caps (to_sample)));
+    fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&out_info),
+        GST_VIDEO_FORMAT_I420);
+    fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&out_info), 320);
+    fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&out_info), 240);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (gst_sample_get_buffer
+            (to_sample)), 5 * GST_SECOND);
+
+    gst_buffer_map (gst_sample_get_buffer (to_sample), &map, GST_MAP_READ);
+    fail_unless (map.size >= GST_VIDEO_INFO_SIZE (&out_info));
+    gst_buffer_unmap (gst_sample_get_buffer (to_sample), &map);
+
+    gst_sample_unref (to_sample);
+  }
+
+  gst_caps_unref (to_caps);
+  gst_sample_unref (from_sample);
+  gst_caps_unref (from_caps);
+  gst_buffer_unref (from_buffer);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GMainLoop *loop;
@@ -1247,6 +1300,60 @@ GST_START_TEST (test_video_size_from_caps)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_info_from_shared_caps)
+{
+  GstVideoInfo vinfo, vinfo2;
+  GstCaps *caps, *ref;
+
+  caps = gst_caps_new_simple ("video/x-raw",
+      "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, 320,
+      "height", G_TYPE_INT, 240, "framerate", GST_TYPE_FRACTION, 30, 1, NULL);
+
+  /* writable caps are parsed every time */
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  gst_caps_set_simple (caps, "width", G_TYPE_INT, 640, NULL);
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&vinfo), 640);
+
+  /* shared caps give the same result on repeated calls */
+  ref = gst_caps_ref (caps);
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  fail_unless (gst_video_info_from_caps (&vinfo2, caps));
+  fail_unless (gst_video_info_is_equal (&vinfo, &vinfo2));
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&vinfo2), 640);
+  fail_unless_equals_int (GST_VIDEO_INFO_HEIGHT (&vinfo2), 240);
+  fail_unless_equals_int (GST_VIDEO_INFO_FPS_N (&vinfo2), 30);
+  gst_caps_unref (ref);
+
+  /* once the other ref is gone the same caps can be modified in place,
+   * the info cached while they were shared must not be used anymore */
+  caps = gst_caps_make_writable (caps);
+  gst_caps_set_simple (caps, "width", G_TYPE_INT, 800,
+      "format", G_TYPE_STRING, "RGBA", NULL);
+  ref = gst_caps_ref (caps);
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  fail_unless_equals_int (GST_VIDEO_INFO_WIDTH (&vinfo), 800);
+  fail_unless_equals_int (GST_VIDEO_INFO_FORMAT (&vinfo),
+      GST_VIDEO_FORMAT_RGBA);
+  gst_caps_unref (ref);
+
+  /* and the same goes for caps features */
+  gst_caps_set_features (caps, 0,
+      gst_caps_features_new (GST_CAPS_FEATURE_FORMAT_INTERLACED, NULL));
+  gst_caps_set_simple (caps, "interlace-mode", G_TYPE_STRING, "alternate",
+      NULL);
+  ref = gst_caps_ref (caps);
+  fail_unless (gst_video_info_from_caps (&vinfo, caps));
+  fail_unless_equals_int (GST_VIDEO_INFO_INTERLACE_MODE (&vinfo),
+      GST_VIDEO_INTERLACE_MODE_ALTERNATE);
+  gst_caps_unref (ref);
+
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_interlace_mode)
 {
   GstVideoInfo vinfo;
@@ -2413,6 +2520,141 @@ GST_START_TEST (test_video_scaler)
 
 GST_END_TEST;
 
+static gboolean
+scaler_coeffs_equal (GstVideoScaler * a, GstVideoScaler * b, guint out_size)
+{
+  guint i, max_taps;
+
+  max_taps = gst_video_scaler_get_max_taps (a);
+  if (max_taps != gst_video_scaler_get_max_taps (b))
+    return FALSE;
+
+  for (i = 0; i < out_size; i++) {
+    const gdouble *ca, *cb;
+    guint in_a, in_b, taps_a, taps_b;
+
+    ca = gst_video_scaler_get_coeff (a, i, &in_a, &taps_a);
+    cb = gst_video_scaler_get_coeff (b, i, &in_b, &taps_b);
+    if (in_a != in_b || taps_a != taps_b)
+      return FALSE;
+    if (memcmp (ca, cb, sizeof (gdouble) * max_taps) != 0)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+GST_START_TEST (test_video_scaler_avg2)
+{
+  GstVideoScaler *scale;
+  guint8 src8[64 * 4], dest8[16 * 4];
+  guint16 src16[64], dest16[16];
+  guint i, j, in_offset, out_size;
+
+  for (i = 0; i < G_N_ELEMENTS (src8); i++)
+    src8[i] = (i * 37) & 0xff;
+  for (i = 0; i < G_N_ELEMENTS (src16); i++)
+    src16[i] = (i * 4099) & 0xffff;
+
+  /* 2 tap linear downscaling by 2 and 4 averages two input pixels */
+  for (out_size = 16; out_size >= 8; out_size /= 2) {
+    guint in_size = 32;
+    const gdouble *taps;
+    guint n_taps;
+
+    scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+        GST_VIDEO_SCALER_FLAG_NONE, 2, in_size, out_size, NULL);
+
+    gst_video_scaler_horizontal (scale, GST_VIDEO_FORMAT_GRAY8, src8, dest8,
+        0, out_size);
+    for (i = 0; i < out_size; i++) {
+      taps = gst_video_scaler_get_coeff (scale, i, &in_offset, &n_taps);
+      fail_unless_equals_int (n_taps, 2);
+      fail_unless_equals_float (taps[0], 0.5);
+      fail_unless_equals_int (dest8[i],
+          (src8[in_offset] + src8[in_offset + 1] + 1) >> 1);
+    }
+
+    gst_video_scaler_horizontal (scale, GST_VIDEO_FORMAT_ARGB, src8, dest8,
+        0, out_size);
+    for (i = 0; i < out_size; i++) {
+      gst_video_scaler_get_coeff (scale, i, &in_offset, NULL);
+      for (j = 0; j < 4; j++)
+        fail_unless_equals_int (dest8[i * 4 + j],
+            (src8[in_offset * 4 + j] + src8[(in_offset + 1) * 4 + j] +
+                1) >> 1);
+    }
+
+    /* and the other half of the line */
+    gst_video_scaler_horizontal (scale, GST_VIDEO_FORMAT_GRAY16_LE, src16,
+        dest16, out_size / 2, out_size / 2);
+    for (i = out_size / 2; i < out_size; i++) {
+      gst_video_scaler_get_coeff (scale, i, &in_offset, NULL);
+      fail_unless_equals_int (dest16[i],
+          (src16[in_offset] + src16[in_offset + 1] + 1) >> 1);
+    }
+
+    gst_video_scaler_free (scale);
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_scaler_reuse)
+{
+  GstVideoScaler *scale, *scale2;
+  GstStructure *options;
+  guint i;
+
+  options = gst_structure_new ("options",
+      GST_VIDEO_RESAMPLER_OPT_SHARPNESS, G_TYPE_DOUBLE, 1.2, NULL);
+
+  /* the second scaler comes from the cached resampler and must be the same */
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_SINC,
+      GST_VIDEO_SCALER_FLAG_NONE, 4, 100, 37, options);
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_SINC,
+      GST_VIDEO_SCALER_FLAG_NONE, 4, 100, 37, options);
+  fail_unless (scaler_coeffs_equal (scale, scale2, 37));
+  /* the tables are shared, not copied */
+  fail_unless (gst_video_scaler_get_coeff (scale, 0, NULL, NULL) ==
+      gst_video_scaler_get_coeff (scale2, 0, NULL, NULL));
+  gst_video_scaler_free (scale2);
+
+  /* other options must not hit the cache */
+  gst_structure_set (options,
+      GST_VIDEO_RESAMPLER_OPT_SHARPNESS, G_TYPE_DOUBLE, 0.6, NULL);
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_SINC,
+      GST_VIDEO_SCALER_FLAG_NONE, 4, 100, 37, options);
+  fail_if (scaler_coeffs_equal (scale, scale2, 37));
+  gst_video_scaler_free (scale2);
+  gst_video_scaler_free (scale);
+
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+      GST_VIDEO_SCALER_FLAG_INTERLACED, 0, 480, 1080, NULL);
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+      GST_VIDEO_SCALER_FLAG_INTERLACED, 0, 480, 1080, NULL);
+  fail_unless (scaler_coeffs_equal (scale, scale2, 1080));
+  gst_video_scaler_free (scale2);
+  gst_video_scaler_free (scale);
+
+  /* shared tables stay valid while the cache drops its own entries */
+  scale = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 333, 77, NULL);
+  for (i = 0; i < 40; i++) {
+    scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_LINEAR,
+        GST_VIDEO_SCALER_FLAG_NONE, 0, 200 + i, 100, NULL);
+    gst_video_scaler_free (scale2);
+  }
+  scale2 = gst_video_scaler_new (GST_VIDEO_RESAMPLER_METHOD_CUBIC,
+      GST_VIDEO_SCALER_FLAG_NONE, 0, 333, 77, NULL);
+  fail_unless (scaler_coeffs_equal (scale, scale2, 77));
+  gst_video_scaler_free (scale2);
+  gst_video_scaler_free (scale);
+
+  gst_structure_free (options);
+}
+
+GST_END_TEST;
+
 typedef enum
 {
   RGB,
@@ -2694,6 +2936,130 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_convert_inplace)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *buffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  gsize i;
+
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_RGBA, 64,
+          48));
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_BGRA, 64,
+          48));
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  fail_unless (gst_video_converter_supports_inplace (convert));
+
+  buffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (buffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i & 3;
+  gst_buffer_unmap (buffer, &map);
+
+  /* both frames map the same memory */
+  gst_video_frame_map (&inframe, &ininfo, buffer, GST_MAP_READWRITE);
+  outframe = inframe;
+  outframe.info = outinfo;
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_frame_unmap (&inframe);
+  gst_video_converter_free (convert);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (i = 0; i < map.size; i += 4) {
+    fail_unless_equals_int (map.data[i], 2);
+    fail_unless_equals_int (map.data[i + 1], 1);
+    fail_unless_equals_int (map.data[i + 2], 0);
+    fail_unless_equals_int (map.data[i + 3], 3);
+  }
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  /* borders around a smaller destination */
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_DEST_WIDTH, G_TYPE_INT, 32,
+          GST_VIDEO_CONVERTER_OPT_DEST_HEIGHT, G_TYPE_INT, 24, NULL));
+  fail_if (gst_video_converter_supports_inplace (convert));
+  gst_video_converter_free (convert);
+
+  /* subsampled input */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_I420, 64,
+          48));
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  fail_if (gst_video_converter_supports_inplace (convert));
+  gst_video_converter_free (convert);
+
+  /* different pixel size */
+  fail_unless (gst_video_info_set_format (&ininfo, GST_VIDEO_FORMAT_RGB, 64,
+          48));
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  fail_if (gst_video_converter_supports_inplace (convert));
+  gst_video_converter_free (convert);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_convert_detile)
+{
+  GstVideoInfo ininfo, outinfo;
+  GstVideoFrame inframe, outframe;
+  GstBuffer *inbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  guint8 *line;
+  gint x, y, width = 200, height = 100;
+  gsize i;
+
+  /* not a multiple of the tile size in either direction */
+  fail_unless (gst_video_info_set_format (&ininfo,
+          GST_VIDEO_FORMAT_NV12_64Z32, width, height));
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = (i * 7) ^ (i >> 11);
+  gst_buffer_unmap (inbuffer, &map);
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+
+  fail_unless (gst_video_info_set_format (&outinfo, GST_VIDEO_FORMAT_NV12,
+          width, height));
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  /* compare with what the tiled unpack function returns */
+  line = g_malloc (width * 4);
+  for (y = 0; y < height; y++) {
+    const guint8 *dy = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe, 0) +
+        y * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 0);
+    const guint8 *duv = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe, 1) +
+        (y >> 1) * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, 1);
+
+    ininfo.finfo->unpack_func (ininfo.finfo, GST_VIDEO_PACK_FLAG_NONE, line,
+        inframe.data, inframe.info.stride, 0, y, width);
+
+    for (x = 0; x < width; x++) {
+      fail_unless_equals_int (dy[x], line[x * 4 + 1]);
+      if ((x & 1) == 0) {
+        fail_unless_equals_int (duv[x], line[x * 4 + 2]);
+        fail_unless_equals_int (duv[x + 1], line[x * 4 + 3]);
+      }
+    }
+  }
+  g_free (line);
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_transfer)
 {
   gint i, j;
@@ -2943,6 +3309,92 @@ GST_START_TEST (test_overlay_blend)
 
 GST_END_TEST;
 
+static void
+blend_scaled_yuv_rectangle (GstVideoFormat format,
+    GstVideoOverlayComposition * comp, GstVideoFrame * frame)
+{
+  GstVideoInfo vinfo;
+  GstBuffer *buf;
+  guint8 *data;
+  gint i, j;
+
+  gst_video_info_set_format (&vinfo, format, 64, 48);
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&vinfo));
+  fail_unless (gst_video_frame_map (frame, &vinfo, buf, GST_MAP_READWRITE));
+  gst_buffer_unref (buf);
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_COMPONENTS (frame); i++) {
+    for (j = 0; j < GST_VIDEO_FRAME_COMP_HEIGHT (frame, i); j++) {
+      gint k;
+
+      data = GST_VIDEO_FRAME_COMP_DATA (frame, i);
+      data += j * GST_VIDEO_FRAME_COMP_STRIDE (frame, i);
+      for (k = 0; k < GST_VIDEO_FRAME_COMP_WIDTH (frame, i); k++)
+        data[k * GST_VIDEO_FRAME_COMP_PSTRIDE (frame, i)] = i == 0 ? 16 : 128;
+    }
+  }
+
+  fail_unless (gst_video_overlay_composition_blend (comp, frame));
+}
+
+GST_START_TEST (test_overlay_blend_scaled_planar)
+{
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstVideoFrame i420, nv12;
+  GstBuffer *pix, *scaled;
+  guint8 *y1, *y2;
+  gint i;
+
+  /* 10x10 half transparent white, rendered at 20x20 */
+  pix = gst_buffer_new_and_alloc (10 * 10 * 4);
+  for (i = 0; i < 10 * 10; i++) {
+    guint8 ayuv[4] = { 0x80, 235, 128, 128 };
+
+    gst_buffer_fill (pix, i * 4, ayuv, 4);
+  }
+  gst_buffer_add_video_meta (pix, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_YUV, 10, 10);
+  rect = gst_video_overlay_rectangle_new_raw (pix, 3, 5, 20, 20,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  gst_buffer_unref (pix);
+  comp = gst_video_overlay_composition_new (rect);
+
+  blend_scaled_yuv_rectangle (GST_VIDEO_FORMAT_I420, comp, &i420);
+
+  /* the scaled pixels are cached in the rectangle and reused */
+  scaled = gst_video_overlay_rectangle_get_pixels_raw (rect,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE);
+  blend_scaled_yuv_rectangle (GST_VIDEO_FORMAT_NV12, comp, &nv12);
+  fail_unless (gst_video_overlay_rectangle_get_pixels_raw (rect,
+          GST_VIDEO_OVERLAY_FORMAT_FLAG_NONE) == scaled);
+
+  y1 = GST_VIDEO_FRAME_COMP_DATA (&i420, 0);
+  y2 = GST_VIDEO_FRAME_COMP_DATA (&nv12, 0);
+
+  /* (235 * 128 + 16 * 127) / 255 */
+  fail_unless_equals_int (y1[5 * 64 + 3], 125);
+  fail_unless_equals_int (y1[24 * 64 + 22], 125);
+  fail_unless_equals_int (y1[5 * 64 + 2], 16);
+  fail_unless_equals_int (y1[5 * 64 + 23], 16);
+  fail_unless_equals_int (y1[4 * 64 + 3], 16);
+  fail_unless_equals_int (y1[25 * 64 + 3], 16);
+  for (i = 0; i < 64 * 48; i++)
+    fail_unless_equals_int (y1[i], y2[i]);
+
+  fail_unless_equals_int (((guint8 *) GST_VIDEO_FRAME_COMP_DATA (&i420,
+              1))[3 * 32 + 2], 128);
+  fail_unless_equals_int (((guint8 *) GST_VIDEO_FRAME_COMP_DATA (&nv12,
+              1))[3 * 64 + 4], 128);
+
+  gst_video_frame_unmap (&i420);
+  gst_video_frame_unmap (&nv12);
+  gst_video_overlay_composition_unref (comp);
+  gst_video_overlay_rectangle_unref (rect);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_overlay_composition_over_transparency)
 {
   GstVideoOverlayComposition *comp1;
@@ -2996,6 +3448,98 @@ GST_START_TEST (test_overlay_composition_over_transparency)
 
 GST_END_TEST;
 
+GST_START_TEST (test_video_pool_memory_options)
+{
+  GstBufferPool *pool;
+  GstStructure *config;
+  GstBuffer *buffer = NULL;
+  GstVideoInfo info;
+  GstCaps *caps;
+  GstMapInfo map;
+  gint node;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 1920, 1080);
+  caps = gst_video_info_to_caps (&info);
+
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, info.size, 2, 0);
+  fail_if (gst_buffer_pool_config_get_video_numa_node (config, &node));
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_HUGE_PAGES);
+  gst_buffer_pool_config_set_video_numa_node (config, 0);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+
+  config = gst_buffer_pool_get_config (pool);
+  fail_unless (gst_buffer_pool_config_get_video_numa_node (config, &node));
+  fail_unless_equals_int (node, 0);
+  gst_structure_free (config);
+
+  /* the placement options are best effort, allocation works regardless */
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buffer,
+          NULL), GST_FLOW_OK);
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READWRITE));
+  fail_unless (map.size >= info.size);
+  memset (map.data, 0x80, map.size);
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_frame_map_meta_single_memory)
+{
+  GstVideoFrame frame1, frame2;
+  GstVideoInfo info;
+  GstVideoMeta *meta;
+  GstBuffer *buf;
+  gsize offset[GST_VIDEO_MAX_PLANES] = { 0, };
+  gint stride[GST_VIDEO_MAX_PLANES] = { 0, };
+  guint i;
+
+  gst_video_info_set_format (&info, GST_VIDEO_FORMAT_I420, 320, 240);
+
+  /* padded planes at custom offsets in a single memory */
+  for (i = 0; i < 3; i++) {
+    stride[i] = GST_VIDEO_INFO_PLANE_STRIDE (&info, i) + 64;
+    offset[i] = i * 128 * 1024;
+  }
+  buf = gst_buffer_new_and_alloc (3 * 128 * 1024);
+  meta = gst_buffer_add_video_meta_full (buf, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_I420, 320, 240, 3, offset, stride);
+  fail_unless (meta != NULL);
+
+  fail_unless (gst_video_frame_map (&frame1, &info, buf, GST_MAP_READ));
+  fail_unless (gst_video_frame_map (&frame2, &info, buf, GST_MAP_READ));
+  for (i = 0; i < 3; i++) {
+    fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame1, i) ==
+        (guint8 *) frame1.map[0].data + offset[i]);
+    fail_unless_equals_int (GST_VIDEO_FRAME_PLANE_STRIDE (&frame1, i),
+        stride[i]);
+    fail_unless (GST_VIDEO_FRAME_PLANE_DATA (&frame1, i) ==
+        GST_VIDEO_FRAME_PLANE_DATA (&frame2, i));
+  }
+  gst_video_frame_unmap (&frame2);
+  gst_video_frame_unmap (&frame1);
+
+  /* all mappings were released, so the buffer can be mapped for writing */
+  fail_unless (gst_video_frame_map (&frame1, &info, buf, GST_MAP_WRITE));
+  memset (GST_VIDEO_FRAME_PLANE_DATA (&frame1, 2), 0x80,
+      GST_VIDEO_FRAME_PLANE_STRIDE (&frame1, 2));
+  gst_video_frame_unmap (&frame1);
+
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_format_enum_stability)
 {
   /* When adding new formats, adding a format in the middle of the enum will
@@ -3769,9 +4313,11 @@ video_suite (void)
   tcase_add_test (tc_chain, test_parse_colorimetry);
   tcase_add_test (tc_chain, test_events);
   tcase_add_test (tc_chain, test_convert_frame);
+  tcase_add_test (tc_chain, test_convert_frame_raw);
   tcase_add_test (tc_chain, test_convert_frame_async);
   tcase_add_test (tc_chain, test_convert_frame_async_error);
   tcase_add_test (tc_chain, test_video_size_from_caps);
+  tcase_add_test (tc_chain, test_video_info_from_shared_caps);
   tcase_add_test (tc_chain, test_interlace_mode);
   tcase_add_test (tc_chain, test_overlay_composition);
   tcase_add_test (tc_chain, test_overlay_composition_premultiplied_alpha);
@@ -3779,6 +4325,8 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_pack_unpack2);
   tcase_add_test (tc_chain, test_video_chroma);
   tcase_add_test (tc_chain, test_video_scaler);
+  tcase_add_test (tc_chain, test_video_scaler_reuse);
+  tcase_add_test (tc_chain, test_video_scaler_avg2);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_rgb);
   tcase_add_test (tc_chain, test_video_color_convert_rgb_yuv);
   tcase_add_test (tc_chain, test_video_color_convert_yuv_yuv);
@@ -3786,11 +4334,16 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_color_convert_other);
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
+  tcase_add_test (tc_chain, test_video_convert_inplace);
+  tcase_add_test (tc_chain, test_video_convert_detile);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
+  tcase_add_test (tc_chain, test_overlay_blend_scaled_planar);
   tcase_add_test (tc_chain, test_video_center_rect);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
   tcase_add_test (tc_chain, test_video_format_enum_stability);
+  tcase_add_test (tc_chain, test_video_pool_memory_options);
+  tcase_add_test (tc_chain, test_video_frame_map_meta_single_memory);
   tcase_add_test (tc_chain, test_video_formats_pstrides);
   tcase_add_test (tc_chain, test_hdr);
   tcase_add_test (tc_chain, test_video_color_from_to_iso);
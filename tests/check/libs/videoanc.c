@@ -278,6 +278,68 @@ GST_START_TEST (encode_8bit)
 GST_END_TEST;
 
 
+GST_START_TEST (parse_lines_8bit)
+{
+  GstVideoVBIParser *parser;
+  GstVideoVBIEncoder *encoder;
+  guint8 lines[3][2560] = { {0,}, };
+  const guint8 data1[] = { 0x01, 0x02, 0x03, 0x04, 0x50, 0x60, 0x70, 0x80 };
+  const guint8 data2[] = { 0x04, 0x03, 0x02, 0x01 };
+  GstVideoAncillary *vanc;
+  GArray *ancillaries;
+
+  parser = gst_video_vbi_parser_new (GST_VIDEO_FORMAT_UYVY, 1280);
+  fail_unless (parser != NULL);
+
+  encoder = gst_video_vbi_encoder_new (GST_VIDEO_FORMAT_UYVY, 1280);
+  fail_unless (encoder != NULL);
+
+  /* One packet on the first line, none on the second and two on the third */
+  fail_unless (gst_video_vbi_encoder_add_ancillary (encoder, FALSE, 0x23, 0x24,
+          data1, sizeof (data1)));
+  gst_video_vbi_encoder_write_line (encoder, lines[0]);
+  gst_video_vbi_encoder_write_line (encoder, lines[1]);
+  fail_unless (gst_video_vbi_encoder_add_ancillary (encoder, FALSE, 0x33, 0x34,
+          data2, sizeof (data2)));
+  fail_unless (gst_video_vbi_encoder_add_ancillary (encoder, FALSE, 0x23, 0x24,
+          data1, sizeof (data1)));
+  gst_video_vbi_encoder_write_line (encoder, lines[2]);
+
+  ancillaries = g_array_new (FALSE, FALSE, sizeof (GstVideoAncillary));
+
+  /* The array is cleared on every call */
+  fail_unless_equals_int (gst_video_vbi_parser_add_lines (parser,
+          (const guint8 *) lines, sizeof (lines[0]), 3, ancillaries), 3);
+  fail_unless_equals_int (gst_video_vbi_parser_add_lines (parser,
+          (const guint8 *) lines, sizeof (lines[0]), 3, ancillaries), 3);
+  fail_unless_equals_int (ancillaries->len, 3);
+
+  vanc = &g_array_index (ancillaries, GstVideoAncillary, 0);
+  fail_unless_equals_int (GST_VIDEO_ANCILLARY_DID16 (vanc), 0x2324);
+  fail_unless_equals_int (vanc->data_count, 8);
+  fail_unless (memcmp (vanc->data, data1, sizeof (data1)) == 0);
+
+  vanc = &g_array_index (ancillaries, GstVideoAncillary, 1);
+  fail_unless_equals_int (GST_VIDEO_ANCILLARY_DID16 (vanc), 0x3334);
+  fail_unless_equals_int (vanc->data_count, 4);
+  fail_unless (memcmp (vanc->data, data2, sizeof (data2)) == 0);
+
+  vanc = &g_array_index (ancillaries, GstVideoAncillary, 2);
+  fail_unless_equals_int (GST_VIDEO_ANCILLARY_DID16 (vanc), 0x2324);
+  fail_unless_equals_int (vanc->data_count, 8);
+  fail_unless (memcmp (vanc->data, data1, sizeof (data1)) == 0);
+
+  /* The second line contains no packets */
+  fail_unless_equals_int (gst_video_vbi_parser_add_lines (parser,
+          lines[1], sizeof (lines[0]), 1, ancillaries), 0);
+
+  g_array_unref (ancillaries);
+  gst_video_vbi_encoder_free (encoder);
+  gst_video_vbi_parser_free (parser);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (encode_10bit)
 {
   GstVideoVBIParser *parser;
@@ -349,6 +411,7 @@ gst_videoanc_suite (void)
 
   tcase_add_test (tc, parse_8bit);
   tcase_add_test (tc, parse_10bit);
+  tcase_add_test (tc, parse_lines_8bit);
 
   tcase_add_test (tc, encode_8bit);
   tcase_add_test (tc, encode_10bit);
@@ -82,6 +82,9 @@ struct _GstVideoDecoderTester
   guint64 last_buf_num;
   guint64 last_kf_num;
   gboolean set_output_state;
+
+  /* handle_frame() fails for this input buffer */
+  guint64 error_buf_num;
 };
 
 struct _GstVideoDecoderTesterClass
@@ -150,6 +153,16 @@ gst_video_decoder_tester_handle_frame (GstVideoDecoder * dec,
 
   input_num = *((guint64 *) map.data);
 
+  if (input_num == dectester->error_buf_num) {
+    gst_buffer_unmap (frame->input_buffer, &map);
+    gst_video_decoder_release_frame (dec, frame);
+    return GST_FLOW_ERROR;
+  }
+
+  /* make frames complete out of order when decoded in parallel */
+  if (gst_video_decoder_get_frame_threads (dec) > 1)
+    g_usleep ((3 - input_num % 4) * 200);
+
   if ((input_num == dectester->last_buf_num + 1
           && dectester->last_buf_num != -1)
       || !GST_BUFFER_FLAG_IS_SET (frame->input_buffer,
@@ -208,12 +221,16 @@ gst_video_decoder_tester_class_init (GstVideoDecoderTesterClass * klass)
 static void
 gst_video_decoder_tester_init (GstVideoDecoderTester * tester)
 {
+  tester->error_buf_num = G_MAXUINT64;
 }
 
 static gboolean
 _mysinkpad_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
+  g_mutex_lock (&check_mutex);
   events = g_list_append (events, event);
+  g_cond_broadcast (&check_cond);
+  g_mutex_unlock (&check_mutex);
   return TRUE;
 }
 
@@ -345,6 +362,265 @@ GST_START_TEST (videodecoder_playback)
 GST_END_TEST;
 
 
+GST_START_TEST (videodecoder_playback_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+  fail_unless_equals_int (gst_video_decoder_get_frame_threads
+      (GST_VIDEO_DECODER (dec)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS / 10; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all frames are output, in order, before EOS */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS / 10);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer),
+        gst_util_uint64_scale_round (i, GST_SECOND * TEST_VIDEO_FPS_D,
+            TEST_VIDEO_FPS_N));
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+  fail_unless (GST_EVENT_TYPE (g_list_last (events)->data) == GST_EVENT_EOS);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_frame_threads_error_flush)
+{
+  GstVideoDecoderTester *dectester;
+  GstSegment segment;
+  GstBuffer *buffer;
+  GList *frames, *iter;
+  guint64 i;
+
+  setup_videodecodertester (NULL, NULL);
+  dectester = (GstVideoDecoderTester *) dec;
+  gst_video_decoder_set_frame_threads (GST_VIDEO_DECODER (dec), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* a worker fails in the middle of the stream, later frames may or may not
+   * be accepted depending on when the error shows up */
+  dectester->error_buf_num = 5;
+  for (i = 0; i < 10; i++)
+    gst_pad_push (mysrcpad, create_test_buffer (i));
+
+  /* serialized events wait for the workers, the error is reported for the
+   * next frame for sure */
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_tag (gst_tag_list_new_empty ())));
+  fail_unless_equals_int (gst_pad_push (mysrcpad, create_test_buffer (10)),
+      GST_FLOW_ERROR);
+
+  /* the frames before the error were output in order */
+  fail_unless (g_list_length (buffers) >= 5);
+  i = 0;
+  for (iter = buffers; iter && i < 5; iter = g_list_next (iter), i++) {
+    GstMapInfo map;
+
+    gst_buffer_map (iter->data, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (iter->data, &map);
+  }
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  /* flushing resets the error and leaves no frames behind, resetting the
+   * base class warns if frames are still queued for the workers */
+  dectester->error_buf_num = G_MAXUINT64;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_start ()));
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_flush_stop (TRUE)));
+
+  frames = gst_video_decoder_get_frames (GST_VIDEO_DECODER (dec));
+  fail_unless (frames == NULL);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  for (i = 0; i < 20; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+  }
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  fail_unless_equals_int (g_list_length (buffers), 20);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter), i++) {
+    GstMapInfo map;
+
+    gst_buffer_map (iter->data, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (iter->data, &map);
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_playback_output_queue)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  GstStructure *stats;
+  guint64 i, decoded, pushed;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  g_object_set (dec, "output-queue-max-buffers", 4, NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS / 10; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* EOS is pushed from the output thread, after all the buffers */
+  g_mutex_lock (&check_mutex);
+  while (events == NULL
+      || GST_EVENT_TYPE (g_list_last (events)->data) != GST_EVENT_EOS)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS / 10);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_object_get (dec, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "decoded", &decoded));
+  fail_unless (gst_structure_get_uint64 (stats, "pushed", &pushed));
+  fail_unless_equals_uint64 (decoded, NUM_BUFFERS / 10);
+  fail_unless_equals_uint64 (pushed, NUM_BUFFERS / 10);
+  fail_unless (gst_structure_has_field (stats, "decode-time"));
+  fail_unless (gst_structure_has_field (stats, "push-time"));
+  gst_structure_free (stats);
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
+GST_START_TEST (videodecoder_qos_skip_keyframe)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videodecodertester (NULL, NULL);
+  g_object_set (dec, "qos-skip-mode", GST_VIDEO_DECODER_QOS_SKIP_KEYFRAME,
+      NULL);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (dec, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* a keyframe every 10 frames */
+  for (i = 0; i < 30; i++) {
+    buffer = create_test_buffer (i);
+    if (i % 10 != 0)
+      GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+    /* downstream is suddenly at frame 15 */
+    if (i == 0)
+      gst_pad_push_event (mysinkpad, gst_event_new_qos (GST_QOS_TYPE_UNDERFLOW,
+              1.0, 0, gst_util_uint64_scale_round (15,
+                  GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N)));
+  }
+
+  /* frames 1 to 19 are skipped until keyframe 20, which is in time again */
+  fail_unless_equals_int (g_list_length (buffers), 11);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    fail_unless_equals_uint64 (*(guint64 *) map.data, i);
+    gst_buffer_unmap (buffer, &map);
+    i = (i == 0) ? 20 : i + 1;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videodecodertest ();
+}
+
+GST_END_TEST;
+
 GST_START_TEST (videodecoder_playback_with_events)
 {
   GstSegment segment;
@@ -1267,6 +1543,10 @@ gst_videodecoder_suite (void)
   tcase_add_test (tc, videodecoder_query_caps_with_custom_getcaps);
 
   tcase_add_test (tc, videodecoder_playback);
+  tcase_add_test (tc, videodecoder_playback_frame_threads);
+  tcase_add_test (tc, videodecoder_frame_threads_error_flush);
+  tcase_add_test (tc, videodecoder_playback_output_queue);
+  tcase_add_test (tc, videodecoder_qos_skip_keyframe);
   tcase_add_test (tc, videodecoder_playback_with_events);
   tcase_add_test (tc, videodecoder_playback_first_frames_not_decoded);
   tcase_add_test (tc, videodecoder_buffer_after_segment);
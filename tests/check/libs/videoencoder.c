@@ -153,6 +153,44 @@ gst_video_encoder_tester_output_step_by_step (GstVideoEncoder * enc,
   return ret;
 }
 
+/* called from several threads at once, so doesn't touch the tester state */
+static GstFlowReturn
+gst_video_encoder_tester_handle_frame_threaded (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderTester *enc_tester = GST_VIDEO_ENCODER_TESTER (enc);
+  GstFlowReturn ret = GST_FLOW_OK;
+  GstMapInfo map;
+  guint64 input_num;
+  gint i;
+
+  gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
+  input_num = *((guint64 *) map.data);
+  gst_buffer_unmap (frame->input_buffer, &map);
+
+  /* make frames complete out of order */
+  g_usleep ((3 - input_num % 4) * 200);
+
+  if (input_num == 0)
+    GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+  frame->pts = GST_BUFFER_PTS (frame->input_buffer);
+  frame->duration = GST_BUFFER_DURATION (frame->input_buffer);
+
+  for (i = 0; i < enc_tester->num_subframes; i++) {
+    guint64 *data = g_malloc (sizeof (guint64));
+
+    *data = input_num;
+    frame->output_buffer = gst_buffer_new_wrapped (data, sizeof (guint64));
+
+    if (i < enc_tester->num_subframes - 1)
+      ret = gst_video_encoder_finish_subframe (enc, frame);
+    else
+      ret = gst_video_encoder_finish_frame (enc, frame);
+  }
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame)
@@ -160,6 +198,9 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
   GstClockTimeDiff deadline;
   GstVideoEncoderTester *enc_tester = GST_VIDEO_ENCODER_TESTER (enc);
 
+  if (gst_video_encoder_get_frame_threads (enc) > 1)
+    return gst_video_encoder_tester_handle_frame_threaded (enc, frame);
+
   deadline = gst_video_encoder_get_max_encode_time (enc, frame);
   if (deadline < 0) {
     /* Calling finish_frame() with frame->output_buffer == NULL means to drop it */
@@ -375,6 +416,74 @@ GST_START_TEST (videoencoder_playback)
 
 GST_END_TEST;
 
+GST_START_TEST (videoencoder_playback_frame_threads)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+  gint subframes = 2;
+
+  setup_videoencodertester ();
+  GST_VIDEO_ENCODER_TESTER (enc)->num_subframes = subframes;
+
+  gst_video_encoder_set_frame_threads (GST_VIDEO_ENCODER (enc), 4);
+  fail_unless_equals_int (gst_video_encoder_get_frame_threads
+      (GST_VIDEO_ENCODER (enc)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  /* push a new segment */
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* push buffers, the data is actually a number so we can track them */
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* all subframes of all frames come out in input order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS * subframes);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+
+    num = *(guint64 *) map.data;
+    fail_unless_equals_uint64 (num, i / subframes);
+    fail_unless (GST_BUFFER_PTS (buffer) ==
+        gst_util_uint64_scale_round (i / subframes,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+    if (i == 0)
+      fail_if (GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT));
+    else
+      fail_unless (GST_BUFFER_FLAG_IS_SET (buffer,
+              GST_BUFFER_FLAG_DELTA_UNIT));
+
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
 /* make sure tags sent right before eos are pushed */
 GST_START_TEST (videoencoder_tags_before_eos)
 {
@@ -920,6 +1029,7 @@ gst_videoencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, videoencoder_playback);
+  tcase_add_test (tc, videoencoder_playback_frame_threads);
 
   tcase_add_test (tc, videoencoder_tags_before_eos);
   tcase_add_test (tc, videoencoder_events_before_eos);
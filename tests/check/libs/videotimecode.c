@@ -309,6 +309,38 @@ GST_START_TEST (videotimecode_addframe_loop)
 
 GST_END_TEST;
 
+GST_START_TEST (videotimecode_addframe_frame_count)
+{
+  GstVideoTimeCode *tc1, *tc2;
+  GDateTime *dt;
+  guint64 i;
+
+  /* Stepping one frame at a time must agree with adding all frames at once
+   * and with the frame count, across dropped frames and minute boundaries */
+  dt = g_date_time_new_utc (2016, 7, 29, 10, 32, 50);
+  tc1 =
+      gst_video_time_code_new (30000, 1001, dt,
+      GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME, 0, 0, 0, 0, 0);
+  tc2 = gst_video_time_code_copy (tc1);
+  for (i = 1; i < 25000; i++) {
+    gst_video_time_code_increment_frame (tc1);
+    fail_unless (gst_video_time_code_is_valid (tc1));
+    fail_unless_equals_uint64 (gst_video_time_code_frames_since_daily_jam
+        (tc1), i);
+    fail_unless (gst_video_time_code_compare (tc1, tc2) > 0);
+    gst_video_time_code_init (tc2, 30000, 1001, dt,
+        GST_VIDEO_TIME_CODE_FLAGS_DROP_FRAME, 0, 0, 0, 0, 0);
+    gst_video_time_code_add_frames (tc2, i);
+    fail_unless_equals_int (gst_video_time_code_compare (tc1, tc2), 0);
+  }
+
+  gst_video_time_code_free (tc1);
+  gst_video_time_code_free (tc2);
+  g_date_time_unref (dt);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (videotimecode_dailyjam_todatetime)
 {
   GstVideoTimeCode *tc1;
@@ -741,6 +773,7 @@ gst_videotimecode_suite (void)
   tcase_add_test (tc, videotimecode_addframe_60drop_framedropped);
   tcase_add_test (tc, videotimecode_addframe_60drop_wrapover);
   tcase_add_test (tc, videotimecode_addframe_loop);
+  tcase_add_test (tc, videotimecode_addframe_frame_count);
 
   tcase_add_test (tc, videotimecode_dailyjam_todatetime);
   tcase_add_test (tc, videotimecode_dailyjam_compare);
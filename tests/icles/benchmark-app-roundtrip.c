@@ -0,0 +1,405 @@
+/* GStreamer appsrc/appsink round-trip benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Pushes buffers into appsrc ! <chain> ! appsink and measures the time
+ * every buffer takes to come out again, for a number of buffer sizes and
+ * appsrc queue limits, with one or more of these pipelines running at
+ * the same time. */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gst/gst.h>
+#include <gst/app/app.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#define DEFAULT_NUM_BUFFERS 100000
+#define DEFAULT_CHAIN "queue"
+
+static gint num_buffers = DEFAULT_NUM_BUFFERS;
+static gchar *chain = NULL;
+static gboolean pin_threads = FALSE;
+static gboolean json_output = FALSE;
+static guint n_results = 0;
+
+typedef struct
+{
+  guint index;
+  gsize buffer_size;
+  guint64 max_bytes;
+
+  GstElement *pipeline;
+  GstAppSrc *src;
+  GstAppSink *sink;
+
+  /* latency of every buffer in microseconds, in arrival order */
+  gint64 *latencies;
+  guint n_latencies;
+
+  gdouble elapsed;
+} RoundTrip;
+
+static gint
+compare_gint64 (gconstpointer a, gconstpointer b)
+{
+  gint64 va = *(const gint64 *) a, vb = *(const gint64 *) b;
+
+  return va < vb ? -1 : (va > vb ? 1 : 0);
+}
+
+static void
+pin_current_thread (guint cpu)
+{
+#ifdef __linux__
+  cpu_set_t set;
+
+  CPU_ZERO (&set);
+  CPU_SET (cpu % CPU_SETSIZE, &set);
+  if (sched_setaffinity (0, sizeof (set), &set) < 0)
+    g_printerr ("Failed to pin thread to CPU %u\n", cpu);
+#endif
+}
+
+static GstFlowReturn
+on_new_sample (GstAppSink * sink, gpointer user_data)
+{
+  RoundTrip *rt = user_data;
+  GstSample *sample;
+  GstBuffer *buf;
+
+  sample = gst_app_sink_pull_sample (sink);
+  if (sample == NULL)
+    return GST_FLOW_EOS;
+
+  /* appsrc doesn't touch the offset, it carries the push time */
+  buf = gst_sample_get_buffer (sample);
+  if (rt->n_latencies < (guint) num_buffers)
+    rt->latencies[rt->n_latencies++] =
+        g_get_monotonic_time () - (gint64) GST_BUFFER_OFFSET (buf);
+  gst_sample_unref (sample);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+round_trip_setup (RoundTrip * rt)
+{
+  GstAppSinkCallbacks callbacks = { NULL, };
+  GstElement *src, *sink;
+  GError *err = NULL;
+  gchar *desc;
+
+  desc = g_strdup_printf ("appsrc name=src ! %s ! appsink name=sink "
+      "sync=false", chain);
+  rt->pipeline = gst_parse_launch (desc, &err);
+  g_free (desc);
+  if (rt->pipeline == NULL) {
+    g_printerr ("Failed to create pipeline: %s\n", err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  src = gst_bin_get_by_name (GST_BIN (rt->pipeline), "src");
+  sink = gst_bin_get_by_name (GST_BIN (rt->pipeline), "sink");
+  rt->src = GST_APP_SRC (src);
+  rt->sink = GST_APP_SINK (sink);
+
+  /* push blocks when the queue is full so that the limit takes effect */
+  g_object_set (src, "block", TRUE, "max-bytes", rt->max_bytes,
+      "format", GST_FORMAT_TIME, NULL);
+
+  callbacks.new_sample = on_new_sample;
+  gst_app_sink_set_callbacks (rt->sink, &callbacks, rt, NULL);
+
+  rt->latencies = g_new (gint64, num_buffers);
+  rt->n_latencies = 0;
+
+  return TRUE;
+}
+
+static void
+round_trip_clear (RoundTrip * rt)
+{
+  gst_element_set_state (rt->pipeline, GST_STATE_NULL);
+  gst_object_unref (rt->src);
+  gst_object_unref (rt->sink);
+  gst_object_unref (rt->pipeline);
+  g_free (rt->latencies);
+}
+
+static gpointer
+round_trip_run (RoundTrip * rt)
+{
+  GstMessage *msg;
+  GstBus *bus;
+  GTimer *timer;
+  gint i;
+
+  if (pin_threads)
+    pin_current_thread (rt->index);
+
+  gst_element_set_state (rt->pipeline, GST_STATE_PLAYING);
+
+  timer = g_timer_new ();
+  for (i = 0; i < num_buffers; i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, rt->buffer_size, NULL);
+
+    GST_BUFFER_PTS (buf) = i * GST_MSECOND;
+    GST_BUFFER_OFFSET (buf) = g_get_monotonic_time ();
+    if (gst_app_src_push_buffer (rt->src, buf) != GST_FLOW_OK)
+      break;
+  }
+  gst_app_src_end_of_stream (rt->src);
+
+  bus = gst_element_get_bus (rt->pipeline);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  rt->elapsed = g_timer_elapsed (timer, NULL);
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    g_printerr ("Pipeline %u posted an error\n", rt->index);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  g_timer_destroy (timer);
+
+  return NULL;
+}
+
+static gint64
+percentile (gint64 * sorted, guint n, gdouble p)
+{
+  guint idx;
+
+  if (n == 0)
+    return 0;
+
+  idx = MIN ((guint) (p * n), n - 1);
+  return sorted[idx];
+}
+
+static void
+print_result (gsize buffer_size, guint64 max_bytes, guint n_pipelines,
+    RoundTrip * rts, glong context_switches)
+{
+  gint64 *all;
+  guint i, n = 0;
+  gdouble elapsed = 0.0, buffers_sec, mbytes_sec;
+  gint64 p50, p99, p999, max;
+
+  for (i = 0; i < n_pipelines; i++)
+    n += rts[i].n_latencies;
+
+  all = g_new (gint64, MAX (n, 1));
+  n = 0;
+  for (i = 0; i < n_pipelines; i++) {
+    memcpy (all + n, rts[i].latencies, rts[i].n_latencies * sizeof (gint64));
+    n += rts[i].n_latencies;
+    elapsed = MAX (elapsed, rts[i].elapsed);
+  }
+  qsort (all, n, sizeof (gint64), compare_gint64);
+
+  p50 = percentile (all, n, 0.50);
+  p99 = percentile (all, n, 0.99);
+  p999 = percentile (all, n, 0.999);
+  max = n > 0 ? all[n - 1] : 0;
+  buffers_sec = elapsed > 0 ? n / elapsed : 0;
+  mbytes_sec = buffers_sec * buffer_size / (1024.0 * 1024.0);
+
+  if (json_output) {
+    gst_println ("%s  {\"chain\": \"%s\", \"buffer-size\": %" G_GSIZE_FORMAT
+        ", \"max-bytes\": %" G_GUINT64_FORMAT ", \"pipelines\": %u, "
+        "\"buffers\": %u, \"elapsed\": %.5f, \"buffers-per-sec\": %.0f, "
+        "\"mbytes-per-sec\": %.2f, \"latency-p50-us\": %" G_GINT64_FORMAT
+        ", \"latency-p99-us\": %" G_GINT64_FORMAT ", \"latency-p999-us\": %"
+        G_GINT64_FORMAT ", \"latency-max-us\": %" G_GINT64_FORMAT
+        ", \"context-switches\": %ld}", n_results > 0 ? "," : "", chain,
+        buffer_size, max_bytes, n_pipelines, n, elapsed, buffers_sec,
+        mbytes_sec, p50, p99, p999, max, context_switches);
+  } else {
+    gst_println ("%10.0f buffers/sec %8.2f MB/s, size %" G_GSIZE_FORMAT
+        ", max-bytes %" G_GUINT64_FORMAT ", %u pipelines, latency us "
+        "p50 %" G_GINT64_FORMAT " p99 %" G_GINT64_FORMAT " p999 %"
+        G_GINT64_FORMAT " max %" G_GINT64_FORMAT ", %ld context switches",
+        buffers_sec, mbytes_sec, buffer_size, max_bytes, n_pipelines, p50,
+        p99, p999, max, context_switches);
+  }
+  n_results++;
+
+  g_free (all);
+}
+
+static glong
+get_context_switches (void)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+#endif
+  return -1;
+}
+
+static void
+do_benchmark (gsize buffer_size, guint64 max_bytes, guint n_pipelines)
+{
+  RoundTrip *rts;
+  GThread **threads;
+  glong csw_start, csw;
+  guint i;
+
+  rts = g_new0 (RoundTrip, n_pipelines);
+  threads = g_new0 (GThread *, n_pipelines);
+
+  for (i = 0; i < n_pipelines; i++) {
+    rts[i].index = i;
+    rts[i].buffer_size = buffer_size;
+    rts[i].max_bytes = max_bytes;
+    if (!round_trip_setup (&rts[i]))
+      goto done;
+  }
+
+  csw_start = get_context_switches ();
+  for (i = 0; i < n_pipelines; i++)
+    threads[i] = g_thread_new ("roundtrip", (GThreadFunc) round_trip_run,
+        &rts[i]);
+  for (i = 0; i < n_pipelines; i++)
+    g_thread_join (threads[i]);
+  csw = csw_start >= 0 ? get_context_switches () - csw_start : -1;
+
+  print_result (buffer_size, max_bytes, n_pipelines, rts, csw);
+
+done:
+  for (i = 0; i < n_pipelines; i++) {
+    if (rts[i].pipeline)
+      round_trip_clear (&rts[i]);
+  }
+  g_free (threads);
+  g_free (rts);
+}
+
+/* parses a comma separated list of integers, NULL means @def only */
+static GArray *
+parse_list (const gchar * str, guint64 def)
+{
+  GArray *res = g_array_new (FALSE, FALSE, sizeof (guint64));
+  gchar **vals;
+  guint i;
+
+  if (str == NULL) {
+    g_array_append_val (res, def);
+    return res;
+  }
+
+  vals = g_strsplit (str, ",", -1);
+  for (i = 0; vals[i]; i++) {
+    guint64 v = g_ascii_strtoull (vals[i], NULL, 10);
+
+    g_array_append_val (res, v);
+  }
+  g_strfreev (vals);
+
+  return res;
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gchar *sizes_str = NULL;
+  gchar *max_bytes_str = NULL;
+  gchar *pipelines_str = NULL;
+  GArray *sizes, *max_bytes, *pipelines;
+  guint s, m, p;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"chain", 'c', 0, G_OPTION_ARG_STRING, &chain,
+        "Elements between appsrc and appsink (default: " DEFAULT_CHAIN ")",
+        "DESCRIPTION"},
+    {"num-buffers", 'n', 0, G_OPTION_ARG_INT, &num_buffers,
+        "Buffers pushed per run and pipeline", NULL},
+    {"sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+        "Comma separated buffer sizes in bytes (default: 1024)", "N,..."},
+    {"max-bytes", 'm', 0, G_OPTION_ARG_STRING, &max_bytes_str,
+        "Comma separated appsrc max-bytes limits (default: 200000)", "N,..."},
+    {"pipelines", 'p', 0, G_OPTION_ARG_STRING, &pipelines_str,
+        "Comma separated numbers of pipelines running at once (default: 1)",
+        "N,..."},
+    {"pin-threads", 0, 0, G_OPTION_ARG_NONE, &pin_threads,
+        "Pin the thread pushing into each pipeline to its own CPU", NULL},
+    {"json", 'j', 0, G_OPTION_ARG_NONE, &json_output,
+        "Print the results as a JSON array", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  if (chain == NULL)
+    chain = g_strdup (DEFAULT_CHAIN);
+  num_buffers = MAX (num_buffers, 1);
+
+  sizes = parse_list (sizes_str, 1024);
+  max_bytes = parse_list (max_bytes_str, 200000);
+  pipelines = parse_list (pipelines_str, 1);
+
+  if (json_output)
+    gst_println ("[");
+
+  for (s = 0; s < sizes->len; s++) {
+    for (m = 0; m < max_bytes->len; m++) {
+      for (p = 0; p < pipelines->len; p++) {
+        do_benchmark (g_array_index (sizes, guint64, s),
+            g_array_index (max_bytes, guint64, m),
+            MAX (g_array_index (pipelines, guint64, p), 1));
+      }
+    }
+  }
+
+  if (json_output)
+    gst_println ("]");
+
+  g_array_free (sizes, TRUE);
+  g_array_free (max_bytes, TRUE);
+  g_array_free (pipelines, TRUE);
+  g_free (chain);
+
+  return 0;
+}
@@ -0,0 +1,389 @@
+/* GStreamer audio conversion benchmark
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the throughput of GstAudioResampler, GstAudioChannelMixer,
+ * GstAudioQuantize and the complete GstAudioConverter over a sweep of
+ * formats, channel counts, rates and quality settings.
+ *
+ * Run with ORC_CODE=backup to compare against the non-SIMD code paths of
+ * the ORC functions.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#define DEFAULT_DURATION 1.0
+#define DEFAULT_BLOCK_FRAMES 4096
+
+static gdouble max_duration = DEFAULT_DURATION;
+static gint block_frames = DEFAULT_BLOCK_FRAMES;
+static gboolean json_output = FALSE;
+static guint n_results = 0;
+
+typedef void (*ProcessFunc) (gpointer data, gpointer in[], gpointer out[]);
+
+static void
+print_result (const gchar * what, const gchar * params, guint channels,
+    gint count, gdouble elapsed)
+{
+  gdouble frames_sec = (gdouble) count * block_frames / elapsed;
+
+  if (json_output) {
+    gst_println ("%s  {\"element\": \"%s\", %s, \"channels\": %u, "
+        "\"count\": %d, \"elapsed\": %.5f, \"frames-per-sec\": %.0f, "
+        "\"samples-per-sec\": %.0f}", n_results > 0 ? "," : "", what,
+        params, channels, count, elapsed, frames_sec, frames_sec * channels);
+  } else {
+    gst_println ("%12.0f samples/sec %s %s, %u channels, %d/%.5f",
+        frames_sec * channels, what, params, channels, count, elapsed);
+  }
+  n_results++;
+}
+
+/* runs @func on blocks of block_frames frames for max_duration seconds and
+ * prints the result */
+static void
+run_benchmark (const gchar * what, const gchar * params, guint channels,
+    ProcessFunc func, gpointer data, gsize in_bpf, gsize out_bpf)
+{
+  GTimer *timer;
+  gpointer in[1], out[1];
+  gdouble elapsed;
+  gint count;
+
+  in[0] = g_malloc0 (in_bpf * block_frames);
+  /* the resampler can produce slightly more than one block per block */
+  out[0] = g_malloc0 (out_bpf * (block_frames * 8 + 64));
+
+  /* warmup */
+  func (data, in, out);
+
+  timer = g_timer_new ();
+  count = 0;
+  while (TRUE) {
+    func (data, in, out);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+  g_timer_destroy (timer);
+
+  print_result (what, params, channels, count, elapsed);
+
+  g_free (in[0]);
+  g_free (out[0]);
+}
+
+static void
+process_resampler (gpointer data, gpointer in[], gpointer out[])
+{
+  GstAudioResampler *resampler = data;
+  gsize out_frames;
+
+  out_frames = gst_audio_resampler_get_out_frames (resampler, block_frames);
+  gst_audio_resampler_resample (resampler, in, block_frames, out, out_frames);
+}
+
+static void
+process_mixer (gpointer data, gpointer in[], gpointer out[])
+{
+  gst_audio_channel_mixer_samples (data, in, out, block_frames);
+}
+
+static void
+process_quantize (gpointer data, gpointer in[], gpointer out[])
+{
+  gst_audio_quantize_samples (data, in, out, block_frames);
+}
+
+static void
+process_converter (gpointer data, gpointer in[], gpointer out[])
+{
+  GstAudioConverter *convert = data;
+  gsize out_frames;
+
+  out_frames = gst_audio_converter_get_out_frames (convert, block_frames);
+  gst_audio_converter_samples (convert, 0, in, block_frames, out, out_frames);
+}
+
+static const GstAudioFormat formats[] = {
+  GST_AUDIO_FORMAT_S16, GST_AUDIO_FORMAT_S32, GST_AUDIO_FORMAT_F32,
+  GST_AUDIO_FORMAT_F64
+};
+
+static const guint channel_counts[] = { 1, 2, 6 };
+
+static const struct
+{
+  gint in_rate, out_rate;
+} rates[] = {
+  {44100, 48000}, {48000, 44100}, {48000, 16000}, {8000, 48000}
+};
+
+static const GstAudioDitherMethod dithers[] = {
+  GST_AUDIO_DITHER_NONE, GST_AUDIO_DITHER_TPDF, GST_AUDIO_DITHER_TPDF_HF
+};
+
+static const GstAudioNoiseShapingMethod noise_shapings[] = {
+  GST_AUDIO_NOISE_SHAPING_NONE, GST_AUDIO_NOISE_SHAPING_SIMPLE,
+  GST_AUDIO_NOISE_SHAPING_HIGH
+};
+
+static void
+benchmark_resampler (guint min_quality, guint max_quality)
+{
+  guint f, c, r, q;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+
+    for (c = 0; c < G_N_ELEMENTS (channel_counts); c++) {
+      for (r = 0; r < G_N_ELEMENTS (rates); r++) {
+        for (q = min_quality; q <= max_quality; q++) {
+          GstAudioResampler *resampler;
+          GstStructure *options;
+          gchar *params;
+          gsize bpf;
+
+          options = gst_structure_new_empty ("options");
+          gst_audio_resampler_options_set_quality
+              (GST_AUDIO_RESAMPLER_METHOD_KAISER, q, rates[r].in_rate,
+              rates[r].out_rate, options);
+
+          resampler = gst_audio_resampler_new
+              (GST_AUDIO_RESAMPLER_METHOD_KAISER, 0, formats[f],
+              channel_counts[c], rates[r].in_rate, rates[r].out_rate, options);
+          gst_structure_free (options);
+
+          if (resampler == NULL)
+            continue;
+
+          params = g_strdup_printf ("\"format\": \"%s\", \"in-rate\": %d, "
+              "\"out-rate\": %d, \"quality\": %u", finfo->name,
+              rates[r].in_rate, rates[r].out_rate, q);
+          bpf = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8 * channel_counts[c];
+
+          run_benchmark ("resampler", params, channel_counts[c],
+              process_resampler, resampler, bpf, bpf);
+
+          g_free (params);
+          gst_audio_resampler_free (resampler);
+        }
+      }
+    }
+  }
+}
+
+static void
+benchmark_mixer (void)
+{
+  static const struct
+  {
+    guint in_channels, out_channels;
+  } layouts[] = {
+    {1, 2}, {2, 1}, {6, 2}, {2, 6}
+  };
+  guint f, l;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+
+    for (l = 0; l < G_N_ELEMENTS (layouts); l++) {
+      GstAudioChannelMixer *mix;
+      GstAudioInfo in_info, out_info;
+      gchar *params;
+      gsize width = GST_AUDIO_FORMAT_INFO_WIDTH (finfo) / 8;
+
+      gst_audio_info_set_format (&in_info, formats[f], 48000,
+          layouts[l].in_channels, NULL);
+      gst_audio_info_set_format (&out_info, formats[f], 48000,
+          layouts[l].out_channels, NULL);
+
+      mix = gst_audio_channel_mixer_new (0, formats[f],
+          layouts[l].in_channels, in_info.position, layouts[l].out_channels,
+          out_info.position);
+      if (mix == NULL)
+        continue;
+
+      params = g_strdup_printf ("\"format\": \"%s\", \"in-channels\": %u, "
+          "\"out-channels\": %u", finfo->name, layouts[l].in_channels,
+          layouts[l].out_channels);
+
+      run_benchmark ("channel-mixer", params, layouts[l].in_channels,
+          process_mixer, mix, width * layouts[l].in_channels,
+          width * layouts[l].out_channels);
+
+      g_free (params);
+      gst_audio_channel_mixer_free (mix);
+    }
+  }
+}
+
+static void
+benchmark_quantize (void)
+{
+  guint c, d, n;
+
+  for (c = 0; c < G_N_ELEMENTS (channel_counts); c++) {
+    for (d = 0; d < G_N_ELEMENTS (dithers); d++) {
+      for (n = 0; n < G_N_ELEMENTS (noise_shapings); n++) {
+        GstAudioQuantize *quant;
+        gchar *params;
+        GEnumClass *dither_class, *ns_class;
+
+        /* quantize S32 to 16 bits like the converter does for S16 output */
+        quant = gst_audio_quantize_new (dithers[d], noise_shapings[n], 0,
+            GST_AUDIO_FORMAT_S32, channel_counts[c], 1 << 16);
+        if (quant == NULL)
+          continue;
+
+        dither_class = g_type_class_ref (GST_TYPE_AUDIO_DITHER_METHOD);
+        ns_class = g_type_class_ref (GST_TYPE_AUDIO_NOISE_SHAPING_METHOD);
+        params = g_strdup_printf ("\"dither\": \"%s\", "
+            "\"noise-shaping\": \"%s\"",
+            g_enum_get_value (dither_class, dithers[d])->value_nick,
+            g_enum_get_value (ns_class, noise_shapings[n])->value_nick);
+        g_type_class_unref (dither_class);
+        g_type_class_unref (ns_class);
+
+        run_benchmark ("quantize", params, channel_counts[c],
+            process_quantize, quant, 4 * channel_counts[c],
+            4 * channel_counts[c]);
+
+        g_free (params);
+        gst_audio_quantize_free (quant);
+      }
+    }
+  }
+}
+
+static void
+benchmark_converter (void)
+{
+  guint i, o, c, r;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (o = 0; o < G_N_ELEMENTS (formats); o++) {
+      for (c = 0; c < G_N_ELEMENTS (channel_counts); c++) {
+        /* one run without resampling, then the rate pairs */
+        for (r = 0; r <= G_N_ELEMENTS (rates); r++) {
+          GstAudioConverter *convert;
+          GstAudioInfo in_info, out_info;
+          gint in_rate, out_rate;
+          gchar *params;
+
+          in_rate = r == 0 ? 48000 : rates[r - 1].in_rate;
+          out_rate = r == 0 ? 48000 : rates[r - 1].out_rate;
+
+          gst_audio_info_set_format (&in_info, formats[i], in_rate,
+              channel_counts[c], NULL);
+          gst_audio_info_set_format (&out_info, formats[o], out_rate,
+              channel_counts[c], NULL);
+
+          convert = gst_audio_converter_new (0, &in_info, &out_info, NULL);
+          if (convert == NULL)
+            continue;
+
+          params = g_strdup_printf ("\"in-format\": \"%s\", "
+              "\"out-format\": \"%s\", \"in-rate\": %d, \"out-rate\": %d",
+              gst_audio_format_to_string (formats[i]),
+              gst_audio_format_to_string (formats[o]), in_rate, out_rate);
+
+          run_benchmark ("converter", params, channel_counts[c],
+              process_converter, convert, GST_AUDIO_INFO_BPF (&in_info),
+              GST_AUDIO_INFO_BPF (&out_info));
+
+          g_free (params);
+          gst_audio_converter_free (convert);
+        }
+      }
+    }
+  }
+}
+
+int
+main (int argc, char **argv)
+{
+  GError *err = NULL;
+  gchar *what = NULL;
+  gint min_quality = GST_AUDIO_RESAMPLER_QUALITY_DEFAULT;
+  gint max_quality = GST_AUDIO_RESAMPLER_QUALITY_DEFAULT;
+  GOptionContext *ctx;
+  GOptionEntry options[] = {
+    {"benchmark", 'b', 0, G_OPTION_ARG_STRING, &what,
+        "What to benchmark: resampler, channel-mixer, quantize, converter "
+          "or all (default: all)", "NAME"},
+    {"min-quality", 0, 0, G_OPTION_ARG_INT, &min_quality,
+        "Lowest resampler quality to measure", NULL},
+    {"max-quality", 0, 0, G_OPTION_ARG_INT, &max_quality,
+        "Highest resampler quality to measure", NULL},
+    {"block-frames", 'n', 0, G_OPTION_ARG_INT, &block_frames,
+        "Frames processed per call", NULL},
+    {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_duration,
+        "Benchmark duration for each run (in seconds)", NULL},
+    {"json", 'j', 0, G_OPTION_ARG_NONE, &json_output,
+        "Print the results as a JSON array", NULL},
+    {NULL}
+  };
+
+  ctx = g_option_context_new ("");
+  g_option_context_add_main_entries (ctx, options, NULL);
+  g_option_context_add_group (ctx, gst_init_get_option_group ());
+  if (!g_option_context_parse (ctx, &argc, &argv, &err)) {
+    g_print ("Error initializing: %s\n", GST_STR_NULL (err->message));
+    g_option_context_free (ctx);
+    g_clear_error (&err);
+    return 1;
+  }
+  g_option_context_free (ctx);
+
+  min_quality = CLAMP (min_quality, GST_AUDIO_RESAMPLER_QUALITY_MIN,
+      GST_AUDIO_RESAMPLER_QUALITY_MAX);
+  max_quality = CLAMP (max_quality, min_quality,
+      GST_AUDIO_RESAMPLER_QUALITY_MAX);
+  block_frames = MAX (block_frames, 1);
+
+  if (json_output)
+    gst_println ("[");
+
+  if (what == NULL || g_str_equal (what, "all")
+      || g_str_equal (what, "resampler"))
+    benchmark_resampler (min_quality, max_quality);
+  if (what == NULL || g_str_equal (what, "all")
+      || g_str_equal (what, "channel-mixer"))
+    benchmark_mixer ();
+  if (what == NULL || g_str_equal (what, "all")
+      || g_str_equal (what, "quantize"))
+    benchmark_quantize ();
+  if (what == NULL || g_str_equal (what, "all")
+      || g_str_equal (what, "converter"))
+    benchmark_converter ();
+
+  if (json_output)
+    gst_println ("]");
+
+  g_free (what);
+
+  return 0;
+}
@@ -22,6 +22,8 @@
 #include "config.h"
 #endif
 
+#include <stdio.h>
+
 #include <gst/gst.h>
 #include <gst/video/video.h>
 
@@ -41,9 +43,220 @@ get_num_formats (void)
   return num_formats + 1;
 }
 
+/* one point of the option matrix, set from the comma separated lists given
+ * on the command line */
+typedef struct
+{
+  guint out_width, out_height;
+  guint threads;
+  GstVideoDitherMethod dither;
+  GstVideoChromaMode chroma_mode;
+  GstVideoMatrixMode matrix_mode;
+} ConvertConfig;
+
+static gboolean json_output = FALSE;
+static guint n_results = 0;
+
+static const gchar *
+enum_nick (GType type, gint value)
+{
+  GEnumClass *klass = g_type_class_ref (type);
+  GEnumValue *val = g_enum_get_value (klass, value);
+  const gchar *nick = val ? val->value_nick : "unknown";
+
+  g_type_class_unref (klass);
+  return nick;
+}
+
+/* parses a comma separated list of nicks of @type, NULL means @def only */
+static GArray *
+parse_enum_list (GType type, const gchar * str, gint def)
+{
+  GArray *res = g_array_new (FALSE, FALSE, sizeof (gint));
+  GEnumClass *klass;
+  gchar **nicks;
+  guint i;
+
+  if (str == NULL) {
+    g_array_append_val (res, def);
+    return res;
+  }
+
+  klass = g_type_class_ref (type);
+  nicks = g_strsplit (str, ",", -1);
+  for (i = 0; nicks[i]; i++) {
+    GEnumValue *val;
+
+    if (g_str_equal (nicks[i], "all")) {
+      guint j;
+
+      for (j = 0; j < klass->n_values; j++)
+        g_array_append_val (res, klass->values[j].value);
+      continue;
+    }
+
+    val = g_enum_get_value_by_nick (klass, nicks[i]);
+    if (val == NULL) {
+      g_printerr ("Unknown %s '%s'\n", g_type_name (type), nicks[i]);
+      continue;
+    }
+    g_array_append_val (res, val->value);
+  }
+  g_strfreev (nicks);
+  g_type_class_unref (klass);
+
+  return res;
+}
+
+/* parses a comma separated list of integers, NULL means @def only */
+static GArray *
+parse_uint_list (const gchar * str, guint def)
+{
+  GArray *res = g_array_new (FALSE, FALSE, sizeof (guint));
+  gchar **vals;
+  guint i;
+
+  if (str == NULL) {
+    g_array_append_val (res, def);
+    return res;
+  }
+
+  vals = g_strsplit (str, ",", -1);
+  for (i = 0; vals[i]; i++) {
+    guint v = g_ascii_strtoull (vals[i], NULL, 10);
+
+    g_array_append_val (res, v);
+  }
+  g_strfreev (vals);
+
+  return res;
+}
+
+/* parses a comma separated list of WxH sizes, NULL means @w x @h only */
+static GArray *
+parse_size_list (const gchar * str, guint w, guint h)
+{
+  GArray *res = g_array_new (FALSE, FALSE, sizeof (guint) * 2);
+  gchar **sizes;
+  guint i;
+
+  if (str == NULL) {
+    guint size[2] = { w, h };
+
+    g_array_append_val (res, size);
+    return res;
+  }
+
+  sizes = g_strsplit (str, ",", -1);
+  for (i = 0; sizes[i]; i++) {
+    guint size[2];
+
+    if (sscanf (sizes[i], "%ux%u", &size[0], &size[1]) != 2) {
+      g_printerr ("Invalid size '%s', expected WxH\n", sizes[i]);
+      continue;
+    }
+    g_array_append_val (res, size);
+  }
+  g_strfreev (sizes);
+
+  return res;
+}
+
+static void
+print_result (GstVideoFormat infmt, guint width, guint height,
+    GstVideoFormat outfmt, const ConvertConfig * config, gint count,
+    gdouble elapsed)
+{
+  const gchar *infmt_str = gst_video_format_to_string (infmt);
+  const gchar *outfmt_str = gst_video_format_to_string (outfmt);
+  const gchar *dither, *chroma, *matrix;
+  gdouble convert_sec = count / elapsed;
+  /* time per output pixel, this is what comparisons between runs and
+   * machines care about */
+  gdouble ns_per_pixel = elapsed * 1e9 / ((gdouble) count *
+      config->out_width * config->out_height);
+
+  dither = enum_nick (GST_TYPE_VIDEO_DITHER_METHOD, config->dither);
+  chroma = enum_nick (GST_TYPE_VIDEO_CHROMA_MODE, config->chroma_mode);
+  matrix = enum_nick (GST_TYPE_VIDEO_MATRIX_MODE, config->matrix_mode);
+
+  if (json_output) {
+    gst_println ("%s  {\"in-format\": \"%s\", \"in-width\": %u, "
+        "\"in-height\": %u, \"out-format\": \"%s\", \"out-width\": %u, "
+        "\"out-height\": %u, \"threads\": %u, \"dither\": \"%s\", "
+        "\"chroma-mode\": \"%s\", \"matrix-mode\": \"%s\", "
+        "\"count\": %d, \"elapsed\": %.5f, \"conversions-per-sec\": %.2f, "
+        "\"ns-per-pixel\": %.4f}", n_results > 0 ? "," : "", infmt_str,
+        width, height, outfmt_str, config->out_width, config->out_height,
+        config->threads, dither, chroma, matrix, count, elapsed, convert_sec,
+        ns_per_pixel);
+  } else {
+    gst_println ("%8.1f conversions/sec %s -> %s @ %ux%u -> %ux%u, "
+        "threads %u, dither %s, chroma %s, matrix %s, %.3f ns/pixel, "
+        "%d/%.5f", convert_sec, infmt_str, outfmt_str, width, height,
+        config->out_width, config->out_height, config->threads, dither,
+        chroma, matrix, ns_per_pixel, count, elapsed);
+  }
+  n_results++;
+}
+
+static void
+do_benchmark_conversion (GstVideoFrame * inframe, const ConvertConfig * config,
+    GstVideoFormat outfmt, GTimer * timer, gdouble max_duration)
+{
+  GstVideoInfo outinfo;
+  GstVideoFrame outframe;
+  GstBuffer *outbuffer;
+  GstVideoConverter *convert;
+  GstStructure *options;
+  gdouble elapsed;
+  gint count;
+
+  /* Or maybe we should allocate more buffers to minimise cache effects? */
+  gst_video_info_set_format (&outinfo, outfmt, config->out_width,
+      config->out_height);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  options = gst_structure_new ("GstVideoConvertConfig",
+      GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, config->threads,
+      GST_VIDEO_CONVERTER_OPT_DITHER_METHOD, GST_TYPE_VIDEO_DITHER_METHOD,
+      config->dither,
+      GST_VIDEO_CONVERTER_OPT_CHROMA_MODE, GST_TYPE_VIDEO_CHROMA_MODE,
+      config->chroma_mode,
+      GST_VIDEO_CONVERTER_OPT_MATRIX_MODE, GST_TYPE_VIDEO_MATRIX_MODE,
+      config->matrix_mode, NULL);
+
+  convert = gst_video_converter_new (&inframe->info, &outinfo, options);
+  /* warmup */
+  gst_video_converter_frame (convert, inframe, &outframe);
+
+  count = 0;
+  g_timer_start (timer);
+  while (TRUE) {
+    gst_video_converter_frame (convert, inframe, &outframe);
+
+    count++;
+    elapsed = g_timer_elapsed (timer, NULL);
+    if (elapsed >= max_duration)
+      break;
+  }
+
+  print_result (GST_VIDEO_FRAME_FORMAT (inframe),
+      GST_VIDEO_FRAME_WIDTH (inframe), GST_VIDEO_FRAME_HEIGHT (inframe),
+      outfmt, config, count, elapsed);
+
+  gst_video_converter_free (convert);
+
+  gst_video_frame_unmap (&outframe);
+  gst_buffer_unref (outbuffer);
+}
+
 static void
 do_benchmark_conversions (guint width, guint height, const gchar * in_format,
-    const gchar * out_format, gdouble max_duration)
+    const gchar * out_format, GArray * sizes, GArray * threads,
+    GArray * dithers, GArray * chroma_modes, GArray * matrix_modes,
+    gdouble max_duration)
 {
   const gchar *infmt_str, *outfmt_str;
   GstVideoFormat infmt, outfmt;
@@ -69,46 +282,34 @@ do_benchmark_conversions (guint width, guint height, const gchar * in_format,
     gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
 
     for (outfmt = GST_VIDEO_FORMAT_I420; outfmt < num_formats; outfmt++) {
-      GstVideoInfo outinfo;
-      GstVideoFrame outframe;
-      GstBuffer *outbuffer;
-      GstVideoConverter *convert;
-      gdouble elapsed, convert_sec;
-      gint count;
+      guint s, t, d, c, m;
 
       outfmt_str = gst_video_format_to_string (outfmt);
       if (out_format != NULL && !g_str_equal (out_format, outfmt_str))
         continue;
 
-      /* Or maybe we should allocate more buffers to minimise cache effects? */
-      gst_video_info_set_format (&outinfo, outfmt, width, height);
-      outbuffer = gst_buffer_new_and_alloc (outinfo.size);
-      gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
-
-      convert = gst_video_converter_new (&ininfo, &outinfo, NULL);
-      /* warmup */
-      gst_video_converter_frame (convert, &inframe, &outframe);
+      for (s = 0; s < sizes->len; s++) {
+        for (t = 0; t < threads->len; t++) {
+          for (d = 0; d < dithers->len; d++) {
+            for (c = 0; c < chroma_modes->len; c++) {
+              for (m = 0; m < matrix_modes->len; m++) {
+                ConvertConfig config;
+                guint *size = &g_array_index (sizes, guint, s * 2);
 
-      count = 0;
-      g_timer_start (timer);
-      while (TRUE) {
-        gst_video_converter_frame (convert, &inframe, &outframe);
+                config.out_width = size[0];
+                config.out_height = size[1];
+                config.threads = g_array_index (threads, guint, t);
+                config.dither = g_array_index (dithers, gint, d);
+                config.chroma_mode = g_array_index (chroma_modes, gint, c);
+                config.matrix_mode = g_array_index (matrix_modes, gint, m);
 
-        count++;
-        elapsed = g_timer_elapsed (timer, NULL);
-        if (elapsed >= max_duration)
-          break;
+                do_benchmark_conversion (&inframe, &config, outfmt, timer,
+                    max_duration);
+              }
+            }
+          }
+        }
       }
-
-      convert_sec = count / elapsed;
-
-      gst_println ("%8.1f conversions/sec %s -> %s @ %ux%u, %d/%.5f",
-          convert_sec, infmt_str, outfmt_str, width, height, count, elapsed);
-
-      gst_video_converter_free (convert);
-
-      gst_video_frame_unmap (&outframe);
-      gst_buffer_unref (outbuffer);
     }
     gst_video_frame_unmap (&inframe);
     gst_buffer_unref (inbuffer);
@@ -126,6 +327,12 @@ main (int argc, char **argv)
   gdouble max_dur = DEFAULT_DURATION;
   gchar *from_fmt = NULL;
   gchar *to_fmt = NULL;
+  gchar *sizes_str = NULL;
+  gchar *threads_str = NULL;
+  gchar *dither_str = NULL;
+  gchar *chroma_str = NULL;
+  gchar *matrix_str = NULL;
+  GArray *sizes, *threads, *dithers, *chroma_modes, *matrix_modes;
   GOptionContext *ctx;
   GOptionEntry options[] = {
     {"width", 'w', 0, G_OPTION_ARG_INT, &width, "Width", NULL},
@@ -135,6 +342,19 @@ main (int argc, char **argv)
     {"to-format", 't', 0, G_OPTION_ARG_STRING, &to_fmt, "To Format", NULL},
     {"duration", 'd', 0, G_OPTION_ARG_DOUBLE, &max_dur,
         "Benchmark duration for each run (in seconds)", NULL},
+    {"out-sizes", 's', 0, G_OPTION_ARG_STRING, &sizes_str,
+        "Comma separated output sizes, e.g. 1280x720,640x360 "
+          "(default: input size)", "WxH,..."},
+    {"threads", 'n', 0, G_OPTION_ARG_STRING, &threads_str,
+        "Comma separated thread counts (default: 1)", "N,..."},
+    {"dither", 0, 0, G_OPTION_ARG_STRING, &dither_str,
+        "Comma separated dither methods or 'all' (default: bayer)", "NICK,..."},
+    {"chroma-mode", 0, 0, G_OPTION_ARG_STRING, &chroma_str,
+        "Comma separated chroma modes or 'all' (default: full)", "NICK,..."},
+    {"matrix-mode", 0, 0, G_OPTION_ARG_STRING, &matrix_str,
+        "Comma separated matrix modes or 'all' (default: full)", "NICK,..."},
+    {"json", 'j', 0, G_OPTION_ARG_NONE, &json_output,
+        "Print the results as a JSON array", NULL},
     {NULL}
   };
 
@@ -149,6 +369,27 @@ main (int argc, char **argv)
   }
   g_option_context_free (ctx);
 
-  do_benchmark_conversions (width, height, from_fmt, to_fmt, max_dur);
+  sizes = parse_size_list (sizes_str, width, height);
+  threads = parse_uint_list (threads_str, 1);
+  dithers = parse_enum_list (GST_TYPE_VIDEO_DITHER_METHOD, dither_str,
+      GST_VIDEO_DITHER_BAYER);
+  chroma_modes = parse_enum_list (GST_TYPE_VIDEO_CHROMA_MODE, chroma_str,
+      GST_VIDEO_CHROMA_MODE_FULL);
+  matrix_modes = parse_enum_list (GST_TYPE_VIDEO_MATRIX_MODE, matrix_str,
+      GST_VIDEO_MATRIX_MODE_FULL);
+
+  if (json_output)
+    gst_println ("[");
+  do_benchmark_conversions (width, height, from_fmt, to_fmt, sizes, threads,
+      dithers, chroma_modes, matrix_modes, max_dur);
+  if (json_output)
+    gst_println ("]");
+
+  g_array_free (sizes, TRUE);
+  g_array_free (threads, TRUE);
+  g_array_free (dithers, TRUE);
+  g_array_free (chroma_modes, TRUE);
+  g_array_free (matrix_modes, TRUE);
+
   return 0;
 }